@@ -11,11 +11,13 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QEventLoop>
+#include <QtCore/QJsonObject>
 #include <QtCore/QStandardPaths>
 #include <QtNetwork/QNetworkDiskCache>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
 
+#include <AudioInjectorManager.h>
 #include <AvatarHashMap.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
@@ -45,6 +47,7 @@ Agent::Agent(NLPacket& packet) :
 
     DependencyManager::set<ResourceCacheSharedItems>();
     DependencyManager::set<SoundCache>();
+    DependencyManager::set<AudioInjectorManager>();
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     
@@ -67,7 +70,7 @@ void Agent::handleOctreePacket(QSharedPointer<NLPacket> packet, SharedNodePointe
             // pull out the piggybacked packet and create a new QSharedPointer<NLPacket> for it
             int piggyBackedSizeWithHeader = packet->getPayloadSize() - statsMessageLength;
             
-            auto buffer = std::unique_ptr<char[]>(new char[piggyBackedSizeWithHeader]);
+            auto buffer = udt::PacketBufferPool::allocate(piggyBackedSizeWithHeader);
             memcpy(buffer.get(), packet->getPayload() + statsMessageLength, piggyBackedSizeWithHeader);
 
             auto newPacket = NLPacket::fromReceivedPacket(std::move(buffer), piggyBackedSizeWithHeader, packet->getSenderSockAddr());
@@ -284,18 +287,22 @@ void Agent::processAgentAvatarAndAudio(float deltaTime) {
 
             int16_t numAvailableSamples = SCRIPT_AUDIO_BUFFER_SAMPLES;
             const int16_t* nextSoundOutput = NULL;
+            QByteArray soundOutput;
 
             if (_avatarSound) {
 
-                const QByteArray& soundByteArray = _avatarSound->getByteArray();
-                nextSoundOutput = reinterpret_cast<const int16_t*>(soundByteArray.data()
-                    + _numAvatarSoundSentBytes);
+                // only the samples sent now are decoded, long sounds stay compressed
+                const SoundData& soundData = _avatarSound->getAudioData();
 
-                int numAvailableBytes = (soundByteArray.size() - _numAvatarSoundSentBytes) > SCRIPT_AUDIO_BUFFER_BYTES
+                int numAvailableBytes = (soundData.getNumBytes() - _numAvatarSoundSentBytes) > SCRIPT_AUDIO_BUFFER_BYTES
                     ? SCRIPT_AUDIO_BUFFER_BYTES
-                    : soundByteArray.size() - _numAvatarSoundSentBytes;
+                    : soundData.getNumBytes() - _numAvatarSoundSentBytes;
                 numAvailableSamples = numAvailableBytes / sizeof(int16_t);
 
+                soundOutput.resize(numAvailableBytes);
+                soundData.read(_numAvatarSoundSentBytes, numAvailableBytes, soundOutput.data());
+                nextSoundOutput = reinterpret_cast<const int16_t*>(soundOutput.constData());
+
 
                 // check if the all of the _numAvatarAudioBufferSamples to be sent are silence
                 for (int i = 0; i < numAvailableSamples; ++i) {
@@ -306,7 +313,7 @@ void Agent::processAgentAvatarAndAudio(float deltaTime) {
                 }
 
                 _numAvatarSoundSentBytes += numAvailableBytes;
-                if (_numAvatarSoundSentBytes == soundByteArray.size()) {
+                if (_numAvatarSoundSentBytes == soundData.getNumBytes()) {
                     // we're done with this sound object - so set our pointer back to NULL
                     // and our sent bytes back to zero
                     _avatarSound = NULL;
@@ -366,6 +373,14 @@ void Agent::processAgentAvatarAndAudio(float deltaTime) {
     }
 }
 
+void Agent::sendStatsPacket() {
+    QJsonObject statsObject;
+    if (_scriptEngine) {
+        statsObject["script"] = QJsonObject::fromVariantMap(_scriptEngine->getProfileStats());
+    }
+    addPacketStatsAndSendStatsPacket(statsObject);
+}
+
 void Agent::aboutToFinish() {
     setIsAvatar(false);// will stop timers for sending billboards and identity packets
     if (_scriptEngine) {
@@ -53,6 +53,7 @@ public:
 public slots:
     void run();
     void playAvatarSound(Sound* avatarSound) { setAvatarSound(avatarSound); }
+    void sendStatsPacket();
 
 private slots:
     void handleAudioPacket(QSharedPointer<NLPacket> packet);
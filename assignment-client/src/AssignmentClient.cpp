@@ -22,9 +22,11 @@
 #include <Assignment.h>
 #include <AvatarHashMap.h>
 #include <EntityScriptingInterface.h>
+#include <HTTPConnection.h>
 #include <LogHandler.h>
 #include <LogUtils.h>
 #include <LimitedNodeList.h>
+#include <Metrics.h>
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
@@ -41,7 +43,8 @@ const long long ASSIGNMENT_REQUEST_INTERVAL_MSECS = 1 * 1000;
 
 AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QString assignmentPool,
                                    quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                                   quint16 assignmentServerPort, quint16 assignmentMonitorPort) :
+                                   quint16 assignmentServerPort, quint16 assignmentMonitorPort,
+                                   quint16 metricsPort) :
     _assignmentServerHostname(DEFAULT_ASSIGNMENT_SERVER_HOSTNAME)
 {
     LogUtils::init();
@@ -125,9 +128,20 @@ AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QStri
         // Hook up a timer to send this child's status to the Monitor once per second
         setUpStatusToMonitor();
     }
+
+    if (metricsPort > 0) {
+        QString documentRoot = QString("%1/resources/web").arg(QCoreApplication::applicationDirPath());
+        _metricsHTTPManager = new HTTPManager(metricsPort, documentRoot, this, this);
+        qDebug() << "Serving metrics on port" << metricsPort;
+    }
+
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::CreateAssignment, this, "handleCreateAssignmentPacket");
     packetReceiver.registerListener(PacketType::StopNode, this, "handleStopNodePacket");
+
+    // time how long an assignment takes from its handoff to being part of its domain, for the monitor
+    connect(&nodeList->getDomainHandler(), &DomainHandler::connectedToDomain,
+            this, &AssignmentClient::handleConnectedToDomain);
 }
 
 void AssignmentClient::stopAssignmentClient() {
@@ -173,6 +187,16 @@ void AssignmentClient::aboutToQuit() {
     qInstallMessageHandler(0);
 }
 
+bool AssignmentClient::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
+    if (connection->requestOperation() == QNetworkAccessManager::GetOperation && url.path() == "/metrics") {
+        connection->respond(HTTPConnection::StatusCode200, MetricsRegistry::toPrometheusText(),
+                            "text/plain; version=0.0.4");
+        return true;
+    }
+
+    return false;
+}
+
 void AssignmentClient::setUpStatusToMonitor() {
     // send a stats packet every 1 seconds
     connect(&_statsTimerACM, &QTimer::timeout, this, &AssignmentClient::sendStatusPacketToACM);
@@ -189,10 +213,12 @@ void AssignmentClient::sendStatusPacketToACM() {
         assignmentType = _currentAssignment->getType();
     }
 
-    auto statusPacket = NLPacket::create(PacketType::AssignmentClientStatus, sizeof(assignmentType) + NUM_BYTES_RFC4122_UUID);
+    auto statusPacket = NLPacket::create(PacketType::AssignmentClientStatus,
+                                         sizeof(assignmentType) + NUM_BYTES_RFC4122_UUID + sizeof(_assignmentStartupMsecs));
 
     statusPacket->write(_childAssignmentUUID.toRfc4122());
     statusPacket->writePrimitive(assignmentType);
+    statusPacket->writePrimitive(_assignmentStartupMsecs);
     
     nodeList->sendPacket(std::move(statusPacket), _assignmentClientMonitorSocket);
 }
@@ -232,6 +258,8 @@ void AssignmentClient::handleCreateAssignmentPacket(QSharedPointer<NLPacket> pac
     if (_currentAssignment) {
         qDebug() << "Received an assignment -" << *_currentAssignment;
 
+        _assignmentStartTimer.start();
+
         auto nodeList = DependencyManager::get<NodeList>();
 
         // switch our DomainHandler hostname and port to whoever sent us the assignment
@@ -284,6 +312,20 @@ void AssignmentClient::handleStopNodePacket(QSharedPointer<NLPacket> packet) {
     }
 }
 
+void AssignmentClient::handleConnectedToDomain() {
+    if (_currentAssignment && _assignmentStartTimer.isValid()) {
+        _assignmentStartupMsecs = (quint32)_assignmentStartTimer.elapsed();
+        _assignmentStartTimer.invalidate();
+
+        qDebug() << "Assignment connected to its domain" << _assignmentStartupMsecs << "msecs after it was handed off.";
+
+        // let the monitor know right away
+        if (!_assignmentClientMonitorSocket.isNull()) {
+            sendStatusPacketToACM();
+        }
+    }
+}
+
 void AssignmentClient::handleAuthenticationRequest() {
     const QString DATA_SERVER_USERNAME_ENV = "HIFI_AC_USERNAME";
     const QString DATA_SERVER_PASSWORD_ENV = "HIFI_AC_PASSWORD";
@@ -13,20 +13,26 @@
 #define hifi_AssignmentClient_h
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QPointer>
 
+#include <HTTPManager.h>
+
 #include "ThreadedAssignment.h"
 
 class QSharedMemory;
 
-class AssignmentClient : public QObject {
+class AssignmentClient : public QObject, public HTTPRequestHandler {
     Q_OBJECT
 public:
     AssignmentClient(Assignment::Type requestAssignmentType, QString assignmentPool,
                      quint16 listenPort,
                      QUuid walletUUID, QString assignmentServerHostname, quint16 assignmentServerPort,
-                     quint16 assignmentMonitorPort);
+                     quint16 assignmentMonitorPort, quint16 metricsPort = 0);
     ~AssignmentClient();
+
+    /// serves the metrics of the assignments this client ran on /metrics, in the Prometheus text format
+    bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false);
 private slots:
     void sendAssignmentRequest();
     void assignmentCompleted();
@@ -40,6 +46,7 @@ public slots:
 private slots:
     void handleCreateAssignmentPacket(QSharedPointer<NLPacket> packet);
     void handleStopNodePacket(QSharedPointer<NLPacket> packet);
+    void handleConnectedToDomain();
 
 private:
     void setUpStatusToMonitor();
@@ -51,6 +58,9 @@ private:
     QTimer _requestTimer; // timer for requesting and assignment
     QTimer _statsTimerACM; // timer for sending stats to assignment client monitor
     QUuid _childAssignmentUUID = QUuid::createUuid();
+    QElapsedTimer _assignmentStartTimer; // from the handoff of the current assignment, until it is in the domain
+    quint32 _assignmentStartupMsecs = 0; // how long the last assignment took to get into its domain
+    HTTPManager* _metricsHTTPManager = nullptr;
 
  protected:
     HifiSockAddr _assignmentClientMonitorSocket;
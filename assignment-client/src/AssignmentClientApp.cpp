@@ -89,9 +89,18 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
     const QCommandLineOption maxChildsOption(ASSIGNMENT_MAX_FORKS_OPTION, "maximum number of children", "child-count");
     parser.addOption(maxChildsOption);
 
+    const QCommandLineOption numSparesOption(ASSIGNMENT_NUM_SPARES_OPTION,
+                                             "number of idle children kept ready for an assignment", "child-count");
+    parser.addOption(numSparesOption);
+
     const QCommandLineOption monitorPortOption(ASSIGNMENT_CLIENT_MONITOR_PORT_OPTION, "assignment-client monitor port", "port");
     parser.addOption(monitorPortOption);
 
+    const QCommandLineOption metricsPortOption(ASSIGNMENT_METRICS_PORT_OPTION,
+                                               "port to serve /metrics on, children of a monitor use the ports after it",
+                                               "port");
+    parser.addOption(metricsPortOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -120,11 +129,21 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
         maxForks = parser.value(maxChildsOption).toInt();
     }
 
+    unsigned int numSpares = 1;
+    if (parser.isSet(numSparesOption)) {
+        numSpares = parser.value(numSparesOption).toUInt();
+    }
+
     unsigned short monitorPort = 0;
     if (parser.isSet(monitorPortOption)) {
         monitorPort = parser.value(monitorPortOption).toUShort();
     }
 
+    unsigned short metricsPort = 0;
+    if (parser.isSet(metricsPortOption)) {
+        metricsPort = parser.value(metricsPortOption).toUShort();
+    }
+
     if (!numForks && minForks) {
         // if the user specified --min but not -n, set -n to --min
         numForks = minForks;
@@ -197,16 +216,16 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
     DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
 
     if (numForks || minForks || maxForks) {
-        AssignmentClientMonitor* monitor =  new AssignmentClientMonitor(numForks, minForks, maxForks,
+        AssignmentClientMonitor* monitor =  new AssignmentClientMonitor(numForks, minForks, maxForks, numSpares,
                                                                         requestAssignmentType, assignmentPool,
                                                                         listenPort, walletUUID, assignmentServerHostname,
-                                                                        assignmentServerPort);
+                                                                        assignmentServerPort, metricsPort);
         monitor->setParent(this);
         connect(this, &QCoreApplication::aboutToQuit, monitor, &AssignmentClientMonitor::aboutToQuit);
     } else {
         AssignmentClient* client = new AssignmentClient(requestAssignmentType, assignmentPool, listenPort,
                                                         walletUUID, assignmentServerHostname,
-                                                        assignmentServerPort, monitorPort);
+                                                        assignmentServerPort, monitorPort, metricsPort);
         client->setParent(this);
         connect(this, &QCoreApplication::aboutToQuit, client, &AssignmentClient::aboutToQuit);
     }
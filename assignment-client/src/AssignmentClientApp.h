@@ -24,7 +24,9 @@ const QString CUSTOM_ASSIGNMENT_SERVER_PORT_OPTION = "server-port";
 const QString ASSIGNMENT_NUM_FORKS_OPTION = "n";
 const QString ASSIGNMENT_MIN_FORKS_OPTION = "min";
 const QString ASSIGNMENT_MAX_FORKS_OPTION = "max";
+const QString ASSIGNMENT_NUM_SPARES_OPTION = "spares";
 const QString ASSIGNMENT_CLIENT_MONITOR_PORT_OPTION = "monitor-port";
+const QString ASSIGNMENT_METRICS_PORT_OPTION = "metrics-port";
 
 class AssignmentClientApp : public QCoreApplication {
     Q_OBJECT
@@ -22,8 +22,13 @@ public:
     Assignment::Type getChildType() { return _childType; }
     void setChildType(Assignment::Type childType) { _childType = childType; }
 
+    // how long the child's last assignment took from its handoff to being part of its domain
+    quint32 getAssignmentStartupMsecs() const { return _assignmentStartupMsecs; }
+    void setAssignmentStartupMsecs(quint32 assignmentStartupMsecs) { _assignmentStartupMsecs = assignmentStartupMsecs; }
+
 private:
     Assignment::Type _childType;
+    quint32 _assignmentStartupMsecs = 0;
 };
 
 #endif // hifi_AssignmentClientChildData_h
@@ -26,17 +26,20 @@ const int WAIT_FOR_CHILD_MSECS = 1000;
 AssignmentClientMonitor::AssignmentClientMonitor(const unsigned int numAssignmentClientForks,
                                                  const unsigned int minAssignmentClientForks,
                                                  const unsigned int maxAssignmentClientForks,
+                                                 const unsigned int numAssignmentClientSpares,
                                                  Assignment::Type requestAssignmentType, QString assignmentPool,
                                                  quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                                                 quint16 assignmentServerPort) :
+                                                 quint16 assignmentServerPort, quint16 metricsPort) :
     _numAssignmentClientForks(numAssignmentClientForks),
     _minAssignmentClientForks(minAssignmentClientForks),
     _maxAssignmentClientForks(maxAssignmentClientForks),
+    _numAssignmentClientSpares(numAssignmentClientSpares),
     _requestAssignmentType(requestAssignmentType),
     _assignmentPool(assignmentPool),
     _walletUUID(walletUUID),
     _assignmentServerHostname(assignmentServerHostname),
-    _assignmentServerPort(assignmentServerPort)
+    _assignmentServerPort(assignmentServerPort),
+    _metricsPort(metricsPort)
 {
     qDebug() << "_requestAssignmentType =" << _requestAssignmentType;
 
@@ -86,6 +89,10 @@ void AssignmentClientMonitor::childProcessFinished() {
     if (processID > 0) {
         qDebug() << "Child process" << processID << "has finished. Removing from internal map.";
         _childProcesses.remove(processID);
+        _childMetricsPorts.remove(processID);
+
+        // start a replacement now rather than at the next check, in case it was a spare
+        checkSpares();
     }
 }
 
@@ -154,6 +161,17 @@ void AssignmentClientMonitor::spawnChildClient() {
     _childArguments.append("--" + ASSIGNMENT_CLIENT_MONITOR_PORT_OPTION);
     _childArguments.append(QString::number(DependencyManager::get<NodeList>()->getLocalSockAddr().getPort()));
 
+    // give each child the first metrics port after ours that no other child has, so replacements reuse the ports
+    quint16 childMetricsPort = 0;
+    if (_metricsPort > 0) {
+        childMetricsPort = _metricsPort + 1;
+        while (_childMetricsPorts.values().contains(childMetricsPort)) {
+            ++childMetricsPort;
+        }
+        _childArguments.append("--" + ASSIGNMENT_METRICS_PORT_OPTION);
+        _childArguments.append(QString::number(childMetricsPort));
+    }
+
     // make sure that the output from the child process appears in our output
     assignmentClient->setProcessChannelMode(QProcess::ForwardedChannels);
 
@@ -165,6 +183,9 @@ void AssignmentClientMonitor::spawnChildClient() {
         
         qDebug() << "Spawned a child client with PID" << assignmentClient->processId();
         _childProcesses.insert(assignmentClient->processId(), assignmentClient);
+        if (childMetricsPort > 0) {
+            _childMetricsPorts.insert(assignmentClient->processId(), childMetricsPort);
+        }
     }    
 }
 
@@ -185,15 +206,24 @@ void AssignmentClientMonitor::checkSpares() {
         }
     });
 
+    // children still starting up haven't reported yet, but will be spares once they do
+    unsigned int childCount = _childProcesses.size();
+    unsigned int startingCount = childCount > totalCount ? childCount - totalCount : 0;
+    spareCount += startingCount;
+    totalCount += startingCount;
+
     // Spawn or kill children, as needed.  If --min or --max weren't specified, allow the child count
     // to drift up or down as far as needed.
-    if (spareCount < 1 || totalCount < _minAssignmentClientForks) {
-        if (!_maxAssignmentClientForks || totalCount < _maxAssignmentClientForks) {
-            spawnChildClient();
+    while (spareCount < _numAssignmentClientSpares || totalCount < _minAssignmentClientForks) {
+        if (_maxAssignmentClientForks && totalCount >= _maxAssignmentClientForks) {
+            break;
         }
+        spawnChildClient();
+        ++spareCount;
+        ++totalCount;
     }
 
-    if (spareCount > 1) {
+    if (spareCount > _numAssignmentClientSpares && !aSpareId.isNull()) {
         if (!_minAssignmentClientForks || totalCount > _minAssignmentClientForks) {
             // kill aSpareId
             qDebug() << "asking child" << aSpareId << "to exit.";
@@ -250,10 +280,30 @@ void AssignmentClientMonitor::handleChildStatusPacket(QSharedPointer<NLPacket> p
         // get child's assignment type out of the packet
         quint8 assignmentType;
         packet->readPrimitive(&assignmentType);
+
+        // children from before the startup time was added don't send it
+        quint32 assignmentStartupMsecs = 0;
+        if (packet->bytesLeftToRead() >= (qint64)sizeof(assignmentStartupMsecs)) {
+            packet->readPrimitive(&assignmentStartupMsecs);
+        }
+
+        bool tookAssignment = childData->getChildType() == Assignment::Type::AllTypes
+            && (Assignment::Type) assignmentType != Assignment::Type::AllTypes;
         
         childData->setChildType((Assignment::Type) assignmentType);
+
+        if (assignmentStartupMsecs != childData->getAssignmentStartupMsecs()) {
+            childData->setAssignmentStartupMsecs(assignmentStartupMsecs);
+            qDebug() << "Child" << senderID << "was in its domain" << assignmentStartupMsecs
+                << "msecs after it was handed its assignment.";
+        }
         
         // note when this child talked
         matchingNode->setLastHeardMicrostamp(usecTimestampNow());
+
+        if (tookAssignment) {
+            // a spare was used up, so start its replacement now rather than at the next check
+            checkSpares();
+        }
     }
 }
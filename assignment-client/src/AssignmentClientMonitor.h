@@ -27,9 +27,10 @@ class AssignmentClientMonitor : public QObject {
     Q_OBJECT
 public:
     AssignmentClientMonitor(const unsigned int numAssignmentClientForks, const unsigned int minAssignmentClientForks,
-                            const unsigned int maxAssignmentClientForks, Assignment::Type requestAssignmentType,
+                            const unsigned int maxAssignmentClientForks, const unsigned int numAssignmentClientSpares,
+                            Assignment::Type requestAssignmentType,
                             QString assignmentPool, quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                            quint16 assignmentServerPort);
+                            quint16 assignmentServerPort, quint16 metricsPort = 0);
     ~AssignmentClientMonitor();
 
     void stopChildProcesses();
@@ -50,14 +51,17 @@ private:
     const unsigned int _numAssignmentClientForks;
     const unsigned int _minAssignmentClientForks;
     const unsigned int _maxAssignmentClientForks;
+    const unsigned int _numAssignmentClientSpares; // idle children kept started up and asking for an assignment
 
     Assignment::Type _requestAssignmentType;
     QString _assignmentPool;
     QUuid _walletUUID;
     QString _assignmentServerHostname;
     quint16 _assignmentServerPort;
+    quint16 _metricsPort; // the children serve their metrics on the ports after this one, if it is set
 
     QMap<qint64, QProcess*> _childProcesses;
+    QMap<qint64, quint16> _childMetricsPorts;
 };
 
 #endif // hifi_AssignmentClientMonitor_h
@@ -17,6 +17,7 @@
 #include "avatars/AvatarMixer.h"
 #include "entities/EntityServer.h"
 #include "assets/AssetServer.h"
+#include "physics/PhysicsSimulator.h"
 
 ThreadedAssignment* AssignmentFactory::unpackAssignment(NLPacket& packet) {
 
@@ -36,6 +37,8 @@ ThreadedAssignment* AssignmentFactory::unpackAssignment(NLPacket& packet) {
             return new EntityServer(packet);
         case Assignment::AssetServerType:
             return new AssetServer(packet);
+        case Assignment::PhysicsSimulatorType:
+            return new PhysicsSimulator(packet);
         default:
             return NULL;
     }
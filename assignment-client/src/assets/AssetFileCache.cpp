@@ -0,0 +1,92 @@
+//
+//  AssetFileCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetFileCache.h"
+
+MappedAssetFile::MappedAssetFile(const QString& path) :
+    _file(path)
+{
+    // empty files can't be mapped, they are read as before
+    if (_file.open(QIODevice::ReadOnly) && _file.size() > 0) {
+        _size = _file.size();
+        _data = _file.map(0, _size);
+    }
+    if (!_data) {
+        _size = 0;
+        _file.close();
+    }
+}
+
+MappedAssetFile::~MappedAssetFile() {
+    if (_data) {
+        _file.unmap(_data);
+    }
+}
+
+AssetFileCache::AssetFileCache(qint64 maximumSize, int maximumFiles) :
+    _maximumSize(maximumSize),
+    _maximumFiles(maximumFiles)
+{
+}
+
+MappedAssetFilePointer AssetFileCache::getFile(const QString& path) {
+    {
+        QMutexLocker locker(&_lock);
+        auto it = _entries.find(path);
+        if (it != _entries.end()) {
+            _lru.splice(_lru.begin(), _lru, it->lruPosition);
+            ++_hits;
+            return it->file;
+        }
+    }
+    ++_misses;
+
+    // the file is mapped outside of the lock, the other requests don't wait on the disk
+    auto file = std::make_shared<MappedAssetFile>(path);
+    if (!file->isMapped() || file->getSize() > _maximumSize) {
+        return MappedAssetFilePointer();
+    }
+
+    QMutexLocker locker(&_lock);
+    auto it = _entries.find(path);
+    if (it != _entries.end()) {
+        // mapped by another request in the meantime
+        _lru.splice(_lru.begin(), _lru, it->lruPosition);
+        return it->file;
+    }
+    _lru.push_front(path);
+    _entries.insert(path, { file, _lru.begin() });
+    _mappedBytes += file->getSize();
+    evict();
+
+    return file;
+}
+
+AssetFileCache::Stats AssetFileCache::getStats() {
+    Stats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.bytesServed = _bytesServed;
+
+    QMutexLocker locker(&_lock);
+    stats.mappedBytes = _mappedBytes;
+    stats.numFiles = _entries.size();
+    return stats;
+}
+
+void AssetFileCache::evict() {
+    // the one just added is at the front, it always stays
+    while ((_mappedBytes > _maximumSize || _entries.size() > _maximumFiles) && _lru.size() > 1) {
+        auto it = _entries.find(_lru.back());
+        _mappedBytes -= it->file->getSize();
+        _entries.erase(it);
+        _lru.pop_back();
+    }
+}
@@ -0,0 +1,86 @@
+//
+//  AssetFileCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetFileCache_h
+#define hifi_AssetFileCache_h
+
+#include <atomic>
+#include <list>
+#include <memory>
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+/// An asset file mapped in memory, it stays mapped for as long as a reply reads from it, even once evicted
+class MappedAssetFile {
+public:
+    MappedAssetFile(const QString& path);
+    ~MappedAssetFile();
+
+    bool isMapped() const { return _data != nullptr; }
+    const char* getData() const { return reinterpret_cast<const char*>(_data); }
+    qint64 getSize() const { return _size; }
+
+private:
+    QFile _file;
+    uchar* _data { nullptr };
+    qint64 _size { 0 };
+};
+
+using MappedAssetFilePointer = std::shared_ptr<const MappedAssetFile>;
+
+/// The assets requested the most recently, kept mapped so that the replies are built straight from their pages.
+/// The assets are named by their hash and never change once written, the mappings don't need to be invalidated.
+class AssetFileCache {
+public:
+    struct Stats {
+        quint64 hits { 0 }; // requests served by a mapping already there
+        quint64 misses { 0 }; // requests that had to map their file
+        quint64 bytesServed { 0 }; // bytes read from the mappings
+        qint64 mappedBytes { 0 };
+        int numFiles { 0 };
+    };
+
+    AssetFileCache(qint64 maximumSize, int maximumFiles);
+
+    /// \return the mapping of the file, null if it can't be mapped or doesn't fit in the cache
+    MappedAssetFilePointer getFile(const QString& path);
+
+    /// Counted in the stats, for the bytes the replies read from a mapping.
+    void addBytesServed(qint64 bytes) { _bytesServed += bytes; }
+
+    Stats getStats();
+
+private:
+    using LRUList = std::list<QString>;
+
+    struct Entry {
+        MappedAssetFilePointer file;
+        LRUList::iterator lruPosition;
+    };
+
+    void evict();
+
+    const qint64 _maximumSize;
+    const int _maximumFiles;
+
+    QMutex _lock;
+    QHash<QString, Entry> _entries;
+    LRUList _lru; // the most recently used first
+    qint64 _mappedBytes { 0 };
+
+    std::atomic<quint64> _hits { 0 };
+    std::atomic<quint64> _misses { 0 };
+    std::atomic<quint64> _bytesServed { 0 };
+};
+
+#endif // hifi_AssetFileCache_h
@@ -12,6 +12,8 @@
 
 #include "AssetServer.h"
 
+#include <algorithm>
+
 #include <QCoreApplication>
 #include <QCryptographicHash>
 #include <QDateTime>
@@ -19,28 +21,48 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QString>
+#include <QThread>
 
+#include "DecomposeAssetTask.h"
+#include "Metrics.h"
 #include "NetworkLogging.h"
 #include "NodeType.h"
 #include "SendAssetTask.h"
-#include "UploadAssetTask.h"
 
 const QString ASSET_SERVER_LOGGING_TARGET_NAME = "asset-server";
 
+// the hot assets stay mapped, the total is bounded in bytes and in open files
+static const qint64 MAX_MAPPED_BYTES = 1024 * 1024 * 1024;
+static const int MAX_MAPPED_FILES = 256;
+
+static const auto assetGetsMetric = MetricsRegistry::counter("hifi_asset_server_gets_total",
+                                                             "Asset requests queued for sending.");
+static const auto assetDecompositionsMetric = MetricsRegistry::counter("hifi_asset_server_decompositions_total",
+                                                                       "Model decompositions into hulls queued.");
+static const auto assetUploadsMetric = MetricsRegistry::counter("hifi_asset_server_uploads_total",
+                                                                "Asset uploads started.");
+
 AssetServer::AssetServer(NLPacket& packet) :
     ThreadedAssignment(packet),
-    _taskPool(this)
+    _fileCache(MAX_MAPPED_BYTES, MAX_MAPPED_FILES),
+    _taskPool(this),
+    _decompositionPool(this)
 {
 
     // Most of the work will be I/O bound, reading from disk and constructing packet objects,
     // so the ideal is greater than the number of cores on the system.
     static const int TASK_POOL_THREAD_COUNT = 50;
     _taskPool.setMaxThreadCount(TASK_POOL_THREAD_COUNT);
+    
+    // leave a core for the sends and the packets
+    _decompositionPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AssetGet, this, "handleAssetGet");
     packetReceiver.registerListener(PacketType::AssetGetInfo, this, "handleAssetGetInfo");
-    packetReceiver.registerMessageListener(PacketType::AssetUpload, this, "handleAssetUpload");
+    packetReceiver.registerMessageStreamListener(PacketType::AssetUpload, this, "handleAssetUpload");
+    
+    connect(DependencyManager::get<NodeList>().data(), &LimitedNodeList::nodeKilled, this, &AssetServer::handleNodeKilled);
 }
 
 void AssetServer::run() {
@@ -82,6 +104,28 @@ void AssetServer::run() {
             file.rename(_resourcesDirectory.absoluteFilePath(hexHash) + "." + fileInfo.suffix());
         }
     }
+
+    // the models from before the hulls were made, or whose decomposition was cut short
+    for (const auto& fileInfo : _resourcesDirectory.entryInfoList(QDir::Files)) {
+        decomposeAsset(fileInfo.absoluteFilePath());
+    }
+}
+
+void AssetServer::decomposeAsset(const QString& assetPath) {
+    QFileInfo fileInfo { assetPath };
+    auto hexHash = fileInfo.baseName();
+    if (hexHash.length() != SHA256_HASH_HEX_LENGTH || !isHullSourceExtension(fileInfo.completeSuffix())) {
+        return;
+    }
+
+    QString hullPath = _resourcesDirectory.filePath(hexHash + "." + HULL_ASSET_EXTENSION);
+    if (QFile::exists(hullPath) || _queuedDecompositions.contains(hexHash)) {
+        return;
+    }
+    _queuedDecompositions.insert(hexHash);
+
+    assetDecompositionsMetric->increment();
+    _decompositionPool.start(new DecomposeAssetTask(assetPath, hullPath));
 }
 
 void AssetServer::handleAssetGetInfo(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
@@ -131,38 +175,41 @@ void AssetServer::handleAssetGet(QSharedPointer<NLPacket> packet, SharedNodePoin
         return;
     }
 
+    assetGetsMetric->increment();
+
     // Queue task
-    auto task = new SendAssetTask(packet, senderNode, _resourcesDirectory);
+    auto task = new SendAssetTask(packet, senderNode, _resourcesDirectory, _fileCache);
     _taskPool.start(task);
 }
 
-void AssetServer::handleAssetUpload(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode) {
+void AssetServer::handleAssetUpload(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
+    auto& nodeUploads = _pendingUploads[senderNode];
+    auto& task = nodeUploads[packet->getMessageNumber()];
     
-    if (senderNode->getCanRez()) {
+    if (!task) {
         qDebug() << "Starting an UploadAssetTask for upload from" << uuidStringWithoutCurlyBraces(senderNode->getUUID());
+        task.reset(new UploadAssetTask(senderNode, _resourcesDirectory));
+        assetUploadsMetric->increment();
+    }
+    
+    if (task->processPacket(*packet)) {
+        if (!task->getAssetPath().isEmpty()) {
+            decomposeAsset(task->getAssetPath());
+        }
         
-        auto task = new UploadAssetTask(packetList, senderNode, _resourcesDirectory);
-        _taskPool.start(task);
-    } else {
-        // this is a node the domain told us is not allowed to rez entities
-        // for now this also means it isn't allowed to add assets
-        // so return a packet with error that indicates that
-        
-        auto permissionErrorPacket = NLPacket::create(PacketType::AssetUploadReply, sizeof(MessageID) + sizeof(AssetServerError));
-        
-        MessageID messageID;
-        packetList->readPrimitive(&messageID);
-        
-        // write the message ID and a permission denied error
-        permissionErrorPacket->writePrimitive(messageID);
-        permissionErrorPacket->writePrimitive(AssetServerError::PermissionDenied);
+        nodeUploads.erase(packet->getMessageNumber());
         
-        // send off the packet
-        auto nodeList = DependencyManager::get<NodeList>();
-        nodeList->sendPacket(std::move(permissionErrorPacket), *senderNode);
+        if (nodeUploads.empty()) {
+            _pendingUploads.erase(senderNode);
+        }
     }
 }
 
+void AssetServer::handleNodeKilled(SharedNodePointer node) {
+    // the rest of these uploads is never coming, this removes their temporary files
+    _pendingUploads.erase(node);
+}
+
 void AssetServer::sendStatsPacket() {
     QJsonObject serverStats;
     
@@ -214,6 +261,23 @@ void AssetServer::sendStatsPacket() {
         downstreamStats["8. Duplicates"] = events[Events::Duplicate];
         nodeStats["Downstream Stats"] = downstreamStats;
         
+        // percentiles of the latencies sampled since the last stats packet
+        static const double MEDIAN_PERCENTILE = 50.0;
+        static const double ALERT_PERCENTILE = 99.0;
+        const auto& sendQueueLatency = stat.second.sendQueueLatency;
+        const auto& rttLatency = stat.second.rttLatency;
+        const auto& receiveLatency = stat.second.receiveLatency;
+        
+        QJsonObject latencyStats;
+        latencyStats["1. Send Queue p50 (us)"] = (double)sendQueueLatency.getPercentile(MEDIAN_PERCENTILE);
+        latencyStats["2. Send Queue p99 (us)"] = (double)sendQueueLatency.getPercentile(ALERT_PERCENTILE);
+        latencyStats["3. RTT p50 (us)"] = (double)rttLatency.getPercentile(MEDIAN_PERCENTILE);
+        latencyStats["4. RTT p99 (us)"] = (double)rttLatency.getPercentile(ALERT_PERCENTILE);
+        latencyStats["5. Receive p50 (us)"] = (double)receiveLatency.getPercentile(MEDIAN_PERCENTILE);
+        latencyStats["6. Receive p99 (us)"] = (double)receiveLatency.getPercentile(ALERT_PERCENTILE);
+        latencyStats["7. Receive Max (us)"] = (double)receiveLatency.getMax();
+        nodeStats["Latency Stats"] = latencyStats;
+        
         QString uuid;
         auto nodelist = DependencyManager::get<NodeList>();
         if (stat.first == nodelist->getDomainHandler().getSockAddr()) {
@@ -227,6 +291,17 @@ void AssetServer::sendStatsPacket() {
         
         serverStats[uuid] = nodeStats;
     }
+
+    auto cacheStats = _fileCache.getStats();
+    auto numRequests = cacheStats.hits + cacheStats.misses;
+    QJsonObject cacheObject;
+    cacheObject["hits"] = (double)cacheStats.hits;
+    cacheObject["misses"] = (double)cacheStats.misses;
+    cacheObject["hit_rate"] = numRequests > 0 ? (double)cacheStats.hits / numRequests : 0.0;
+    cacheObject["bytes_served"] = (double)cacheStats.bytesServed;
+    cacheObject["mapped_bytes"] = (double)cacheStats.mappedBytes;
+    cacheObject["num_files"] = cacheStats.numFiles;
+    serverStats["asset_file_cache"] = cacheObject;
     
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
@@ -12,12 +12,20 @@
 #ifndef hifi_AssetServer_h
 #define hifi_AssetServer_h
 
+#include <memory>
+#include <unordered_map>
+
 #include <QDir>
+#include <QSet>
 
+#include <NLPacket.h>
+#include <Node.h>
 #include <ThreadedAssignment.h>
 #include <QThreadPool>
 
+#include "AssetFileCache.h"
 #include "AssetUtils.h"
+#include "UploadAssetTask.h"
 
 class AssetServer : public ThreadedAssignment {
     Q_OBJECT
@@ -30,14 +38,30 @@ public slots:
 private slots:
     void handleAssetGetInfo(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
     void handleAssetGet(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
-    void handleAssetUpload(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode);
+    void handleAssetUpload(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
+    void handleNodeKilled(SharedNodePointer node);
     
     void sendStatsPacket();
     
 private:
     static void writeError(NLPacketList* packetList, AssetServerError error);
+    
+    // queues the decomposition of a model into hulls, once per run, unless its hulls are already cached
+    void decomposeAsset(const QString& assetPath);
+    
     QDir _resourcesDirectory;
+
+    // before the pool, the tasks still running when it's destroyed read from the cache
+    AssetFileCache _fileCache;
     QThreadPool _taskPool;
+    
+    // decompositions are bound by the CPU and take seconds, they have a pool of their own to not hold up the sends
+    QThreadPool _decompositionPool;
+    QSet<QString> _queuedDecompositions;
+    
+    // uploads are written out as their packets arrive, keyed by the sender and the number of their upload message
+    using UploadTaskMap = std::unordered_map<udt::Packet::MessageNumber, std::unique_ptr<UploadAssetTask>>;
+    std::unordered_map<SharedNodePointer, UploadTaskMap> _pendingUploads;
 };
 
 inline void writeError(NLPacketList* packetList, AssetServerError error) {
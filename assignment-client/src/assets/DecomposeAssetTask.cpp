@@ -0,0 +1,165 @@
+//
+//  DecomposeAssetTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DecomposeAssetTask.h"
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
+
+#include <FBXReader.h>
+#include <NumericalConstants.h>
+#include <OBJReader.h>
+#include <SharedUtil.h>
+#include <VHACD.h>
+
+DecomposeAssetTask::DecomposeAssetTask(const QString& modelPath, const QString& hullPath) :
+    _modelPath(modelPath),
+    _hullPath(hullPath)
+{
+
+}
+
+static FBXGeometry* readGeometry(const QString& modelPath) {
+    QFile file { modelPath };
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    QByteArray data = file.readAll();
+
+    try {
+        if (modelPath.toLower().endsWith(".obj")) {
+            return OBJReader().readOBJ(data, QVariantHash());
+        }
+        return readFBX(data, QVariantHash(), modelPath, false);
+    } catch (const QString& error) {
+        qDebug() << "[ERROR] Could not read" << modelPath << "for its hulls -" << error;
+        return nullptr;
+    }
+}
+
+static void appendTriangles(const FBXMeshPart& meshPart, std::vector<int>& triangles) {
+    triangles.insert(triangles.end(), meshPart.triangleIndices.begin(), meshPart.triangleIndices.end());
+
+    // split each quad into two triangles
+    for (int i = 0; i + 3 < meshPart.quadIndices.size(); i += 4) {
+        triangles.push_back(meshPart.quadIndices[i]);
+        triangles.push_back(meshPart.quadIndices[i + 1]);
+        triangles.push_back(meshPart.quadIndices[i + 2]);
+        triangles.push_back(meshPart.quadIndices[i]);
+        triangles.push_back(meshPart.quadIndices[i + 2]);
+        triangles.push_back(meshPart.quadIndices[i + 3]);
+    }
+}
+
+void DecomposeAssetTask::run() {
+    if (QFile::exists(_hullPath)) {
+        return;
+    }
+
+    std::unique_ptr<FBXGeometry> geometry { readGeometry(_modelPath) };
+    if (!geometry) {
+        qDebug() << "[ERROR] Could not load" << _modelPath << "to decompose it";
+        return;
+    }
+
+    auto start = usecTimestampNow();
+
+    // the defaults of vhacd-util
+    VHACD::IVHACD::Parameters params;
+    params.m_resolution = 100000;
+    params.m_depth = 20;
+    params.m_concavity = 0.0025;
+    params.m_delta = 0.05;
+    params.m_planeDownsampling = 4;
+    params.m_convexhullDownsampling = 4;
+    params.m_alpha = 0.05;
+    params.m_beta = 0.05;
+    params.m_gamma = 0.00125;
+    params.m_pca = 0;
+    params.m_mode = 0;
+    params.m_maxNumVerticesPerCH = 64;
+    params.m_minVolumePerCH = 0.0001;
+    params.m_callback = nullptr;
+    params.m_logger = nullptr;
+    params.m_convexhullApproximation = true;
+    params.m_oclAcceleration = false; // the servers have no OpenCL devices to speak of
+
+    VHACD::IVHACD* decomposer = VHACD::CreateVHACD();
+
+    QByteArray obj;
+    QTextStream out(&obj);
+    int hullCount = 0;
+    int vertexCount = 0;
+
+    foreach (const FBXMesh& mesh, geometry->meshes) {
+        // the hulls are in the space of the model, like its meshes once they are moved by their transforms
+        std::vector<glm::vec3> vertices;
+        vertices.reserve(mesh.vertices.size());
+        foreach (const glm::vec3& vertex, mesh.vertices) {
+            vertices.push_back(glm::vec3(mesh.modelTransform * glm::vec4(vertex, 1.0f)));
+        }
+
+        foreach (const FBXMeshPart& meshPart, mesh.parts) {
+            std::vector<int> triangles;
+            appendTriangles(meshPart, triangles);
+            if (triangles.empty()) {
+                continue;
+            }
+
+            if (!decomposer->Compute(&vertices[0].x, 3, (unsigned int)vertices.size(),
+                                     &triangles[0], 3, (unsigned int)triangles.size() / 3, params)) {
+                continue;
+            }
+
+            for (unsigned int i = 0; i < decomposer->GetNConvexHulls(); i++) {
+                VHACD::IVHACD::ConvexHull hull;
+                decomposer->GetConvexHull(i, hull);
+
+                out << "g hull-" << hullCount++ << "\n";
+                for (unsigned int j = 0; j < hull.m_nPoints; j++) {
+                    out << "v " << hull.m_points[j * 3] << " " << hull.m_points[j * 3 + 1] << " "
+                        << hull.m_points[j * 3 + 2] << "\n";
+                }
+                // the indices of obj files start at one and span the whole file
+                for (unsigned int j = 0; j < hull.m_nTriangles; j++) {
+                    out << "f " << vertexCount + hull.m_triangles[j * 3] + 1 << " "
+                        << vertexCount + hull.m_triangles[j * 3 + 1] + 1 << " "
+                        << vertexCount + hull.m_triangles[j * 3 + 2] + 1 << "\n";
+                }
+                vertexCount += hull.m_nPoints;
+            }
+        }
+    }
+
+    decomposer->Clean();
+    decomposer->Release();
+    out.flush();
+
+    if (hullCount == 0) {
+        qDebug() << "[WARNING] No hulls could be made for" << _modelPath;
+        return;
+    }
+
+    // written whole or not at all, since the asset-server may be serving this path as soon as it exists
+    QSaveFile file { _hullPath };
+    if (!file.open(QIODevice::WriteOnly) || file.write(obj) != obj.size() || !file.commit()) {
+        qDebug() << "[ERROR] Could not write the hulls of" << _modelPath << "to" << _hullPath << "-" << file.errorString();
+        return;
+    }
+
+    qDebug() << "Decomposed" << QFileInfo(_modelPath).fileName() << "into" << hullCount << "hulls in"
+        << (usecTimestampNow() - start) / USECS_PER_MSEC << "ms";
+}
@@ -0,0 +1,31 @@
+//
+//  DecomposeAssetTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DecomposeAssetTask_h
+#define hifi_DecomposeAssetTask_h
+
+#include <QtCore/QRunnable>
+#include <QtCore/QString>
+
+// Decomposes a model asset into convex hulls with V-HACD, the way vhacd-util does with its default parameters, and
+// writes them beside it as an OBJ named after the hash of the model. The clients fetch that file for the collisions of
+// models without a compound shape of their own, so nobody has to run vhacd-util and host the result by hand.
+class DecomposeAssetTask : public QRunnable {
+public:
+    DecomposeAssetTask(const QString& modelPath, const QString& hullPath);
+
+    void run();
+
+private:
+    QString _modelPath;
+    QString _hullPath;
+};
+
+#endif // hifi_DecomposeAssetTask_h
@@ -11,6 +11,8 @@
 
 #include "SendAssetTask.h"
 
+#include <algorithm>
+
 #include <QFile>
 
 #include <DependencyManager.h>
@@ -22,11 +24,15 @@
 
 #include "AssetUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<NLPacket> packet, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+static const DataOffset READ_BLOCK_SIZE = 64 * 1024;
+
+SendAssetTask::SendAssetTask(QSharedPointer<NLPacket> packet, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             AssetFileCache& fileCache) :
     QRunnable(),
     _packet(packet),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _fileCache(fileCache)
 {
     
 }
@@ -53,6 +59,7 @@ void SendAssetTask::run() {
     
     qDebug() << "Starting task to send asset: " << hexHash << " for messageID " << messageID;
     auto replyPacketList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    replyPacketList->setPriority(udt::PacketList::Priority::Bulk);
 
     replyPacketList->write(assetHash);
 
@@ -63,9 +70,23 @@ void SendAssetTask::run() {
     } else {
         QString filePath = _resourcesDir.filePath(QString(hexHash) + "." + QString(extension));
         
+        // the hot files are mapped, the reply is written straight from their pages
+        auto mappedFile = _fileCache.getFile(filePath);
         QFile file { filePath };
 
-        if (file.open(QIODevice::ReadOnly)) {
+        if (mappedFile) {
+            if (mappedFile->getSize() < end) {
+                writeError(replyPacketList.get(), AssetServerError::InvalidByteRange);
+                qCDebug(networking) << "Bad byte range: " << hexHash << " " << start << ":" << end;
+            } else {
+                auto size = end - start;
+                replyPacketList->writePrimitive(AssetServerError::NoError);
+                replyPacketList->writePrimitive(size);
+                replyPacketList->write(mappedFile->getData() + start, size);
+                _fileCache.addBytesServed(size);
+                qCDebug(networking) << "Sending asset: " << hexHash;
+            }
+        } else if (file.open(QIODevice::ReadOnly)) {
             if (file.size() < end) {
                 writeError(replyPacketList.get(), AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " " << start << ":" << end;
@@ -74,7 +95,19 @@ void SendAssetTask::run() {
                 file.seek(start);
                 replyPacketList->writePrimitive(AssetServerError::NoError);
                 replyPacketList->writePrimitive(size);
-                replyPacketList->write(file.read(size));
+
+                // the range goes through a buffer of bounded size instead of being read at once
+                QByteArray buffer(READ_BLOCK_SIZE, Qt::Uninitialized);
+                DataOffset remaining = size;
+                while (remaining > 0) {
+                    qint64 numRead = file.read(buffer.data(), std::min(remaining, READ_BLOCK_SIZE));
+                    if (numRead <= 0) {
+                        qCWarning(networking) << "Failed reading asset: " << hexHash << " at " << end - remaining;
+                        break;
+                    }
+                    replyPacketList->write(buffer.constData(), numRead);
+                    remaining -= numRead;
+                }
                 qCDebug(networking) << "Sending asset: " << hexHash;
             }
             file.close();
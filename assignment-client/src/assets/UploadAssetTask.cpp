@@ -11,67 +11,137 @@
 
 #include "UploadAssetTask.h"
 
-#include <QtCore/QBuffer>
+#include <algorithm>
+
 #include <QtCore/QFile>
 
-#include <AssetUtils.h>
 #include <NodeList.h>
-#include <NLPacketList.h>
+#include <NLPacket.h>
 
+// uploads in progress are kept out of the resources directory itself, which is scanned for new files on startup
+const QString UPLOADS_DIRECTORY = "uploads";
 
-UploadAssetTask::UploadAssetTask(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode,
-                                 const QDir& resourcesDir) :
-    _packetList(packetList),
+UploadAssetTask::UploadAssetTask(QSharedPointer<Node> senderNode, const QDir& resourcesDir) :
     _senderNode(senderNode),
     _resourcesDir(resourcesDir)
 {
     
 }
 
-void UploadAssetTask::run() {
-    auto data = _packetList->getMessage();
+bool UploadAssetTask::processPacket(NLPacket& packet) {
+    bool isLastPacket = packet.getPacketPosition() == NLPacket::PacketPosition::LAST
+        || packet.getPacketPosition() == NLPacket::PacketPosition::ONLY;
+    
+    if (packet.getMessagePartNumber() == 0 && !readHeader(packet)) {
+        _isRefused = true;
+    }
+    
+    if (_isRefused) {
+        // the reply already went out, let the rest of the message go by
+        return isLastPacket;
+    }
     
-    QBuffer buffer { &data };
-    buffer.open(QIODevice::ReadOnly);
+    auto data = packet.readWithoutCopy(std::min((uint64_t)packet.bytesLeftToRead(), _fileSize - _bytesReceived));
     
-    MessageID messageID;
-    buffer.read(reinterpret_cast<char*>(&messageID), sizeof(messageID));
+    if (_file->write(data) != data.size()) {
+        qDebug() << "[ERROR] Could not write upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
+            << "to" << _file->fileName() << "-" << _file->errorString();
+        
+        // we don't have a dedicated error for this, the asset is as good as too large for us to take
+        sendReply(AssetServerError::AssetTooLarge);
+        _isRefused = true;
+        _file.reset();
+        
+        return isLastPacket;
+    }
+    
+    _hash.addData(data);
+    _bytesReceived += data.size();
+    
+    if (isLastPacket) {
+        finish();
+    }
+    
+    return isLastPacket;
+}
+
+bool UploadAssetTask::readHeader(NLPacket& packet) {
+    packet.readPrimitive(&_messageID);
     
     uint8_t extensionLength;
-    buffer.read(reinterpret_cast<char*>(&extensionLength), sizeof(extensionLength));
+    packet.readPrimitive(&extensionLength);
     
-    QByteArray extension = buffer.read(extensionLength);
+    _extension = packet.read(extensionLength);
     
-    uint64_t fileSize;
-    buffer.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+    packet.readPrimitive(&_fileSize);
     
-    qDebug() << "UploadAssetTask reading a file of " << fileSize << "bytes and extension" << extension << "from"
+    if (!_senderNode->getCanRez()) {
+        // this is a node the domain told us is not allowed to rez entities
+        // for now this also means it isn't allowed to add assets
+        sendReply(AssetServerError::PermissionDenied);
+        return false;
+    }
+    
+    qDebug() << "UploadAssetTask reading a file of " << _fileSize << "bytes and extension" << _extension << "from"
         << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
     
-    auto replyPacket = NLPacket::create(PacketType::AssetUploadReply);
-    replyPacket->writePrimitive(messageID);
+    if (_fileSize > MAX_UPLOAD_SIZE) {
+        // we can refuse this before the rest of it arrives
+        sendReply(AssetServerError::AssetTooLarge);
+        return false;
+    }
     
-    if (fileSize > MAX_UPLOAD_SIZE) {
-        replyPacket->writePrimitive(AssetServerError::AssetTooLarge);
-    } else {
-        QByteArray fileData = buffer.read(fileSize);
-        
-        auto hash = hashData(fileData);
-        auto hexHash = hash.toHex();
-        
-        qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
-            << "is: (" << hexHash << ") ";
+    _resourcesDir.mkpath(UPLOADS_DIRECTORY);
+    
+    _file.reset(new QTemporaryFile(_resourcesDir.filePath(UPLOADS_DIRECTORY + "/upload-XXXXXX")));
+    
+    if (!_file->open()) {
+        qDebug() << "[ERROR] Could not create a file for upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
+            << "-" << _file->errorString();
         
-        QFile file { _resourcesDir.filePath(QString(hexHash)) + "." + QString(extension) };
+        sendReply(AssetServerError::AssetTooLarge);
+        _file.reset();
+        return false;
+    }
+    
+    return true;
+}
+
+void UploadAssetTask::finish() {
+    auto hash = _hash.result();
+    auto hexHash = hash.toHex();
+    
+    qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
+        << "is: (" << hexHash << ") ";
+    
+    QString filePath = _resourcesDir.filePath(QString(hexHash)) + "." + QString(_extension);
+    
+    if (QFile::exists(filePath)) {
+        qDebug() << "[WARNING] This file already exists: " << hexHash;
+        _assetPath = filePath;
+    } else {
+        _file->close();
         
-        if (file.exists()) {
-            qDebug() << "[WARNING] This file already exists: " << hexHash;
+        if (_file->rename(filePath)) {
+            _file->setAutoRemove(false);
+            _assetPath = filePath;
         } else {
-            file.open(QIODevice::WriteOnly);
-            file.write(fileData);
-            file.close();
+            qDebug() << "[ERROR] Could not move uploaded file to" << filePath << "-" << _file->errorString();
         }
-        replyPacket->writePrimitive(AssetServerError::NoError);
+    }
+    
+    // the temporary file is removed with the task if it was not moved
+    _file.reset();
+    
+    sendReply(AssetServerError::NoError, hash);
+}
+
+void UploadAssetTask::sendReply(AssetServerError error, const QByteArray& hash) {
+    auto replyPacket = NLPacket::create(PacketType::AssetUploadReply);
+    replyPacket->writePrimitive(_messageID);
+    replyPacket->writePrimitive(error);
+    
+    if (error == AssetServerError::NoError) {
         replyPacket->write(hash);
     }
     
@@ -14,24 +14,47 @@
 #ifndef hifi_UploadAssetTask_h
 #define hifi_UploadAssetTask_h
 
+#include <memory>
+
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDir>
-#include <QtCore/QObject>
-#include <QtCore/QRunnable>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QTemporaryFile>
+
+#include <AssetUtils.h>
 
-class NLPacketList;
+class NLPacket;
 class Node;
 
-class UploadAssetTask : public QRunnable {
+// Writes an upload to a temporary file as its packets arrive, hashing it along the way, so that the whole asset is
+// never held in memory. Once the last packet is in, the file is renamed after its hash and the uploader gets its reply.
+class UploadAssetTask {
 public:
-    UploadAssetTask(QSharedPointer<NLPacketList> packetList, QSharedPointer<Node> senderNode, const QDir& resourcesDir);
+    UploadAssetTask(QSharedPointer<Node> senderNode, const QDir& resourcesDir);
+    
+    // takes the next packet of the upload message, returns true once the upload is done (or was refused)
+    bool processPacket(NLPacket& packet);
     
-    void run();
+    // the file the asset is stored in once the upload is done, empty if it was refused or could not be stored
+    const QString& getAssetPath() const { return _assetPath; }
     
 private:
-    QSharedPointer<NLPacketList> _packetList;
+    bool readHeader(NLPacket& packet);
+    void finish();
+    void sendReply(AssetServerError error, const QByteArray& hash = QByteArray());
+    
     QSharedPointer<Node> _senderNode;
     QDir _resourcesDir;
+    
+    MessageID _messageID { 0 };
+    QByteArray _extension;
+    uint64_t _fileSize { 0 };
+    uint64_t _bytesReceived { 0 };
+    bool _isRefused { false };
+    QString _assetPath;
+    
+    QCryptographicHash _hash { QCryptographicHash::Sha256 };
+    std::unique_ptr<QTemporaryFile> _file;
 };
 
 #endif // hifi_UploadAssetTask_h
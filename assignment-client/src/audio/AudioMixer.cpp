@@ -32,25 +32,32 @@
 #include <glm/gtx/vector_angle.hpp>
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonValue>
+#include <QtCore/QRunnable>
 #include <QtCore/QThread>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
 
+#include <AudioMixKernels.h>
 #include <LogHandler.h>
+#include <Metrics.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
 #include <Node.h>
 #include <OctreeConstants.h>
+#include <plugins/CodecPlugins.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 #include <StDev.h>
+#include <Trace.h>
 #include <UUID.h>
 
 #include "AudioRingBuffer.h"
+#include "AudioRingBufferPool.h"
 #include "AudioMixerClientData.h"
 #include "AvatarAudioStream.h"
 #include "InjectedAudioStream.h"
@@ -63,6 +70,17 @@ const float DEFAULT_NOISE_MUTING_THRESHOLD = 0.003f;
 const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
+const int DEFAULT_NUM_MIX_WORKERS = 1;
+const int MAX_NUM_MIX_WORKERS = 32;
+const float DEFAULT_FAR_SOURCE_CLUSTER_SIZE = 8.0f;
+
+static const auto mixFramesMetric = MetricsRegistry::counter("hifi_audio_mixer_frames_total",
+                                                             "Frames the audio mixer has mixed.");
+static const auto mixListenersMetric = MetricsRegistry::gauge("hifi_audio_mixer_listeners",
+                                                              "Listeners sent a mix in the last frame.");
+static const auto mixMsecsMetric = MetricsRegistry::histogram("hifi_audio_mixer_frame_msecs",
+                                                              "Time taken to mix and send a frame, in msecs.",
+                                                              { 0.5, 1.0, 2.0, 5.0, 10.0, 20.0 });
 
 InboundAudioStream::Settings AudioMixer::_streamSettings;
 
@@ -74,6 +92,18 @@ bool AudioMixer::shouldMute(float quietestFrame) {
     return (quietestFrame > _noiseMutingThreshold);
 }
 
+/// Runs the mixes of one worker's share of listeners on a thread of the AudioMixer's pool
+class AudioMixerJob : public QRunnable {
+public:
+    AudioMixerJob(AudioMixer* mixer, int workerIndex) : _mixer(mixer), _workerIndex(workerIndex) {}
+
+    void run() { _mixer->mixListenersForWorker(_workerIndex); }
+
+private:
+    AudioMixer* _mixer;
+    int _workerIndex;
+};
+
 AudioMixer::AudioMixer(NLPacket& packet) :
     ThreadedAssignment(packet),
     _trailingSleepRatio(1.0f),
@@ -81,9 +111,14 @@ AudioMixer::AudioMixer(NLPacket& packet) :
     _performanceThrottlingRatio(0.0f),
     _attenuationPerDoublingInDistance(DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE),
     _noiseMutingThreshold(DEFAULT_NOISE_MUTING_THRESHOLD),
+    _farSourceDistance(0.0f),
+    _farSourceClusterSize(DEFAULT_FAR_SOURCE_CLUSTER_SIZE),
     _numStatFrames(0),
     _sumListeners(0),
     _sumMixes(0),
+    _sumClusterMixes(0),
+    _isMixerReverbEnabled(false),
+    _isHRTFEnabled(false),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
     _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
@@ -91,57 +126,100 @@ AudioMixer::AudioMixer(NLPacket& packet) :
     _timeSpentPerHashMatchCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _readPendingCallsPerSecondStats(1, READ_DATAGRAMS_STATS_WINDOW_SECONDS)
 {
+    setNumMixWorkers(DEFAULT_NUM_MIX_WORKERS);
+
     // constant defined in AudioMixer.h.  However, we don't want to include this here
     // we will soon find a better common home for these audio-related constants
     // SOON
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
 
-    packetReceiver.registerListenerForTypes({ PacketType::MicrophoneAudioNoEcho, PacketType::MicrophoneAudioWithEcho,
-                                              PacketType::InjectAudio, PacketType::SilentAudioFrame,
-                                              PacketType::AudioStreamStats },
-                                            this, "handleNodeAudioPacket");
+    packetReceiver.registerDirectHandlerForTypes({ PacketType::MicrophoneAudioNoEcho, PacketType::MicrophoneAudioWithEcho,
+                                                   PacketType::InjectAudio, PacketType::SilentAudioFrame,
+                                                   PacketType::AudioStreamStats },
+                                                 this, &AudioMixer::handleNodeAudioPacket);
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
+    packetReceiver.registerListener(PacketType::NegotiateAudioFormat, this, "handleNegotiateAudioFormat");
+
+    _codecPreferenceOrder = getCodecPluginNames();
 }
 
 const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
 const float RADIUS_OF_HEAD = 0.076f;
 
-int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
-                                                         const QUuid& streamUUID,
-                                                         PositionalAudioStream* streamToAdd,
-                                                         AvatarAudioStream* listeningNodeStream) {
-    // If repetition with fade is enabled:
-    // If streamToAdd could not provide a frame (it was starved), then we'll mix its previously-mixed frame
-    // This is preferable to not mixing it at all since that's equivalent to inserting silence.
-    // Basically, we'll repeat that last frame until it has a frame to mix.  Depending on how many times
-    // we've repeated that frame in a row, we'll gradually fade that repeated frame into silence.
-    // This improves the perceived quality of the audio slightly.
+// off-axis attenuation of avatar streams ranges from MAX_OFF_AXIS_ATTENUATION (facing away) to 1.0 (facing the listener)
+const float MAX_OFF_AXIS_ATTENUATION = 0.2f;
 
-    bool showDebug = false;  // (randFloat() < 0.05f);
+// shared far mixes can't face every listener, they use the middle of that range
+const float AVERAGE_OFF_AXIS_ATTENUATION = (MAX_OFF_AXIS_ATTENUATION + 1.0f) / 2.0f;
 
+const float PHASE_AMPLITUDE_RATIO_AT_90 = 0.5f;
+
+float AudioMixer::calculateFadeFactorForMix(PositionalAudioStream* stream) const {
+    // a return of zero means the stream has nothing to add to a mix this frame
     float repeatedFrameFadeFactor = 1.0f;
 
-    if (!streamToAdd->lastPopSucceeded()) {
-        if (_streamSettings._repetitionWithFade && !streamToAdd->getLastPopOutput().isNull()) {
+    if (!stream->lastPopSucceeded()) {
+        if (_streamSettings._repetitionWithFade && !stream->getLastPopOutput().isNull()) {
             // reptition with fade is enabled, and we do have a valid previous frame to repeat.
             // calculate its fade factor, which depends on how many times it's already been repeated.
-            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(streamToAdd->getConsecutiveNotMixedCount() - 1);
-            if (repeatedFrameFadeFactor == 0.0f) {
-                return 0;
-            }
+            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(stream->getConsecutiveNotMixedCount() - 1);
         } else {
-            return 0;
+            return 0.0f;
         }
     }
 
-    // at this point, we know streamToAdd's last pop output is valid
+    // if the frame we're about to mix is silent, there is nothing to fade
+    if (stream->getLastPopOutputLoudness() == 0.0f) {
+        return 0.0f;
+    }
+
+    return repeatedFrameFadeFactor;
+}
+
+float AudioMixer::calculateDistanceCoefficient(const glm::vec3& sourcePosition, const glm::vec3& listenerPosition,
+                                               float distance) const {
+    if (distance < ATTENUATION_BEGINS_AT_DISTANCE) {
+        return 1.0f;
+    }
+
+    float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
+    for (int i = 0; i < _zonesSettings.length(); ++i) {
+        if (_audioZones.value(_zonesSettings[i].source).contains(sourcePosition) &&
+            _audioZones.value(_zonesSettings[i].listener).contains(listenerPosition)) {
+            attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
+            break;
+        }
+    }
+
+    float distanceCoefficient = 1 - (logf(distance / ATTENUATION_BEGINS_AT_DISTANCE) / logf(2.0f)
+                                     * attenuationPerDoublingInDistance);
+
+    return glm::max(distanceCoefficient, 0.0f);
+}
+
+int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerWorkerData& worker,
+                                                         AudioMixerClientData* listenerNodeData,
+                                                         const QUuid& streamUUID,
+                                                         PositionalAudioStream* streamToAdd,
+                                                         AvatarAudioStream* listeningNodeStream,
+                                                         int hrtfInputIndex) {
+    // If repetition with fade is enabled:
+    // If streamToAdd could not provide a frame (it was starved), then we'll mix its previously-mixed frame
+    // This is preferable to not mixing it at all since that's equivalent to inserting silence.
+    // Basically, we'll repeat that last frame until it has a frame to mix.  Depending on how many times
+    // we've repeated that frame in a row, we'll gradually fade that repeated frame into silence.
+    // This improves the perceived quality of the audio slightly.
+
+    bool showDebug = false;  // (randFloat() < 0.05f);
 
-    // if the frame we're about to mix is silent, bail
-    if (streamToAdd->getLastPopOutputLoudness() == 0.0f) {
+    float repeatedFrameFadeFactor = calculateFadeFactorForMix(streamToAdd);
+    if (repeatedFrameFadeFactor == 0.0f) {
         return 0;
     }
 
+    // at this point, we know streamToAdd's last pop output is valid and not silent
+
     float bearingRelativeAngleToSource = 0.0f;
     float attenuationCoefficient = 1.0f;
     int numSamplesDelay = 0;
@@ -164,7 +242,7 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         return 0;
     }
 
-    ++_sumMixes;
+    ++worker.sumMixes;
 
     if (streamToAdd->getType() == PositionalAudioStream::Injector) {
         attenuationCoefficient *= reinterpret_cast<InjectedAudioStream*>(streamToAdd)->getAttenuationRatio();
@@ -186,7 +264,6 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         float angleOfDelivery = glm::angle(glm::vec3(0.0f, 0.0f, -1.0f),
                                            glm::normalize(rotatedListenerPosition));
 
-        const float MAX_OFF_AXIS_ATTENUATION = 0.2f;
         const float OFF_AXIS_ATTENUATION_FORMULA_STEP = (1 - MAX_OFF_AXIS_ATTENUATION) / 2.0f;
 
         float offAxisCoefficient = MAX_OFF_AXIS_ATTENUATION +
@@ -201,23 +278,10 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         attenuationCoefficient *= offAxisCoefficient;
     }
 
-    float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
-    for (int i = 0; i < _zonesSettings.length(); ++i) {
-        if (_audioZones[_zonesSettings[i].source].contains(streamToAdd->getPosition()) &&
-            _audioZones[_zonesSettings[i].listener].contains(listeningNodeStream->getPosition())) {
-            attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
-            break;
-        }
-    }
-
     if (distanceBetween >= ATTENUATION_BEGINS_AT_DISTANCE) {
         // calculate the distance coefficient using the distance to this node
-        float distanceCoefficient = 1 - (logf(distanceBetween / ATTENUATION_BEGINS_AT_DISTANCE) / logf(2.0f)
-                                         * attenuationPerDoublingInDistance);
-
-        if (distanceCoefficient < 0) {
-            distanceCoefficient = 0;
-        }
+        float distanceCoefficient = calculateDistanceCoefficient(streamToAdd->getPosition(),
+                                                                 listeningNodeStream->getPosition(), distanceBetween);
 
         // multiply the current attenuation coefficient by the distance coefficient
         attenuationCoefficient *= distanceCoefficient;
@@ -226,6 +290,19 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         }
     }
 
+    if (!sourceIsSelf && hrtfInputIndex >= 0) {
+        // the HRTFs take the place of the phase delay, the amplitude panning and the penumbra filter
+        glm::vec3 rotatedSourcePosition = inverseOrientation * relativePosition;
+        glm::vec3 direction = (glm::length(rotatedSourcePosition) > EPSILON) ?
+            glm::normalize(rotatedSourcePosition) : glm::vec3(0.0f, 0.0f, -1.0f);
+        float nearness = glm::min(distanceBetween / RADIUS_OF_HEAD, 1.0f);
+
+        AudioHRTFFilter& hrtfFilter = listenerNodeData->getListenerSourcePairData(streamUUID)->getHRTFFilter();
+        worker.hrtfMix.addSource(*_hrtfTable, &_frameHRTFInputs[hrtfInputIndex * AudioHRTFConstants::NUM_BINS],
+                                 hrtfFilter, direction, nearness, attenuationCoefficient * repeatedFrameFadeFactor);
+        return 1;
+    }
+
     if (!sourceIsSelf) {
         //  Compute sample delay for the two ears to create phase panning
         glm::vec3 rotatedSourcePosition = inverseOrientation * relativePosition;
@@ -238,8 +315,6 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
                                                           glm::normalize(rotatedSourcePosition),
                                                           glm::vec3(0.0f, 1.0f, 0.0f));
 
-        const float PHASE_AMPLITUDE_RATIO_AT_90 = 0.5;
-
         // figure out the number of samples of delay and the ratio of the amplitude
         // in the weak channel for audio spatialization
         float sinRatio = fabsf(sinf(bearingRelativeAngleToSource));
@@ -260,6 +335,9 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
 
     AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd->getLastPopOutput();
 
+    // the pre-mix holds only this stream, so that the penumbra filter below is run on this stream alone
+    memset(worker.preMixSamples, 0, sizeof(worker.preMixSamples));
+
     if (!streamToAdd->isStereo()) {
         // this is a mono stream, which means it gets full attenuation and spatialization
 
@@ -323,7 +401,7 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
             for (int i = 0; i < numSamplesDelay; i++) {
                 int16_t originalHistoricalSample = *delayStreamSourceSamples;
 
-                _preMixSamples[delayedChannelHistoricalAudioOutputIndex] += originalHistoricalSample
+                worker.preMixSamples[delayedChannelHistoricalAudioOutputIndex] += originalHistoricalSample
                                                                                  * attenuationAndWeakChannelRatioAndFade;
                 ++delayStreamSourceSamples; // move our input pointer
                 delayedChannelHistoricalAudioOutputIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE; // move our output sample
@@ -338,10 +416,10 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
 
             // since we might be delayed, don't write beyond our maxOutputIndex
             if (leftDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[leftDestinationIndex] += leftSideSample;
+                worker.preMixSamples[leftDestinationIndex] += leftSideSample;
             }
             if (rightDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[rightDestinationIndex] += rightSideSample;
+                worker.preMixSamples[rightDestinationIndex] += rightSideSample;
             }
 
             leftDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
@@ -349,15 +427,10 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         }
 
     } else {
-        int stereoDivider = streamToAdd->isStereo() ? 1 : 2;
-
-       float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+        float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
 
-        for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-            _preMixSamples[s] = glm::clamp(_preMixSamples[s] + (int)(streamPopOutput[s / stereoDivider] * attenuationAndFade),
-                                            AudioConstants::MIN_SAMPLE_VALUE,
-                                           AudioConstants::MAX_SAMPLE_VALUE);
-        }
+        streamPopOutput.readSamples(worker.preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+        AudioMixKernels::applyGain(worker.preMixSamples, attenuationAndFade, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
     }
 
     if (!sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter()) {
@@ -420,81 +493,390 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         // set the gain on both filter channels
         penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainL, penumbraFilterSlope);
         penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainR, penumbraFilterSlope);
-        penumbraFilter.render(_preMixSamples, _preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
+        penumbraFilter.render(worker.preMixSamples, worker.preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
+    }
+
+    // Actually mix the preMixSamples into the mixSamples here, saturation is applied once the whole mix is done
+    AudioMixKernels::accumulate(worker.mixSamples, worker.preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+
+    return 1;
+}
+
+int AudioMixer::addClusterToMixForListeningNode(AudioMixerWorkerData& worker, const AudioSourceCluster& cluster,
+                                                AvatarAudioStream* listeningNodeStream) {
+    glm::vec3 relativePosition = cluster.position - listeningNodeStream->getPosition();
+
+    float distanceBetween = glm::max(glm::length(relativePosition), EPSILON);
+
+    if (cluster.trailingLoudness / distanceBetween <= _minAudibilityThreshold) {
+        return 0;
+    }
+
+    float attenuationCoefficient = calculateDistanceCoefficient(cluster.position, listeningNodeStream->getPosition(),
+                                                                distanceBetween);
+    if (attenuationCoefficient == 0.0f) {
+        return 0;
     }
 
-    // Actually mix the _preMixSamples into the _mixSamples here.
-    for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-        _mixSamples[s] = glm::clamp(_mixSamples[s] + _preMixSamples[s], AudioConstants::MIN_SAMPLE_VALUE,
-                                    AudioConstants::MAX_SAMPLE_VALUE);
+    ++worker.sumMixes;
+    ++worker.sumClusterMixes;
+
+    // keep the amplitude panning of addStreamToMixForListeningNodeWithStream, the phase delay and
+    // penumbra filter are not worth their cost this far away
+    glm::vec3 rotatedSourcePosition = glm::inverse(listeningNodeStream->getOrientation()) * relativePosition;
+    rotatedSourcePosition.y = 0.0f;
+
+    float leftGain = attenuationCoefficient;
+    float rightGain = attenuationCoefficient;
+
+    if (glm::length(rotatedSourcePosition) > EPSILON) {
+        float bearingRelativeAngleToSource = glm::orientedAngle(glm::vec3(0.0f, 0.0f, -1.0f),
+                                                                glm::normalize(rotatedSourcePosition),
+                                                                glm::vec3(0.0f, 1.0f, 0.0f));
+
+        float weakChannelAmplitudeRatio = 1 - (PHASE_AMPLITUDE_RATIO_AT_90 * fabsf(sinf(bearingRelativeAngleToSource)));
+
+        if (bearingRelativeAngleToSource > 0.0f) {
+            rightGain *= weakChannelAmplitudeRatio;
+        } else {
+            leftGain *= weakChannelAmplitudeRatio;
+        }
     }
 
+    AudioMixKernels::accumulateMonoToStereo(worker.mixSamples, cluster.samples, leftGain, rightGain,
+                                            AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
     return 1;
 }
 
-int AudioMixer::prepareMixForListeningNode(Node* node) {
+int AudioMixer::addZoneReverbToMixForListeningNode(AudioMixerWorkerData& worker, AvatarAudioStream* listeningNodeStream) {
+    float reverbTime, wetLevel;
+    int zone = findReverbZone(listeningNodeStream->getPosition(), reverbTime, wetLevel);
+    if (zone < 0 || !_frameZoneReverbsHeard[zone]) {
+        return 0;
+    }
+
+    // the same dry and wet balance as the reverb of the clients, the wet level is in dB
+    float wetFraction = powf(10.0f, wetLevel / 20.0f);
+    float dryFraction = 1.0f - wetFraction;
+
+    const int16_t* wetSamples = _zoneReverbs[zone]->getWetSamples();
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
+        worker.mixSamples[i] = (int32_t)(worker.mixSamples[i] * dryFraction + wetSamples[i] * wetFraction);
+    }
+
+    return 1;
+}
+
+int AudioMixer::prepareMixForListeningNode(AudioMixerWorkerData& worker, Node* node) {
     AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
     AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
 
     // zero out the client mix for this node
-    memset(_preMixSamples, 0, sizeof(_preMixSamples));
-    memset(_mixSamples, 0, sizeof(_mixSamples));
+    memset(worker.mixSamples, 0, sizeof(worker.mixSamples));
+    worker.hrtfMix.begin();
 
-    // loop through all other nodes that have sufficient audio to mix
     int streamsMixed = 0;
 
-    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
-        if (otherNode->getLinkedData()) {
-            AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
+    // use the shared mix of every cluster that is entirely beyond the far source distance
+    if (!_frameClusters.isEmpty()) {
+        worker.clustersMixed.fill(false, _frameClusters.size());
 
-            // enumerate the ARBs attached to the otherNode and add all that should be added to mix
+        for (int i = 0; i < _frameClusters.size(); ++i) {
+            const AudioSourceCluster& cluster = _frameClusters[i];
 
-            const QHash<QUuid, PositionalAudioStream*>& otherNodeAudioStreams = otherNodeClientData->getAudioStreams();
-            QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
-            for (i = otherNodeAudioStreams.constBegin(); i != otherNodeAudioStreams.constEnd(); i++) {
-                PositionalAudioStream* otherNodeStream = i.value();
-                QUuid streamUUID = i.key();
+            // a cluster of one gains nothing from being shared, its stream is mixed on its own
+            if (cluster.numStreams > 1
+                && glm::distance(cluster.position, nodeAudioStream->getPosition()) - cluster.radius > _farSourceDistance) {
+                worker.clustersMixed[i] = true;
+                streamsMixed += addClusterToMixForListeningNode(worker, cluster, nodeAudioStream);
+            }
+        }
+    }
 
-                if (otherNodeStream->getType() == PositionalAudioStream::Microphone) {
-                    streamUUID = otherNode->getUUID();
-                }
+    // only visit the streams that can possibly be heard from where this node is listening
+    _frameSourceGrid.forEachSourceAudibleAt(nodeAudioStream->getPosition(), [&](const AudioSourceGrid::Source& source) {
+        if (source.clusterIndex >= 0 && worker.clustersMixed[source.clusterIndex]) {
+            return;
+        }
 
-                if (*otherNode != *node || otherNodeStream->shouldLoopbackForNode()) {
-                    streamsMixed += addStreamToMixForListeningNodeWithStream(listenerNodeData, streamUUID,
-                                                                             otherNodeStream, nodeAudioStream);
-                }
-            }
+        if (*source.node != *node || source.stream->shouldLoopbackForNode()) {
+            streamsMixed += addStreamToMixForListeningNodeWithStream(worker, listenerNodeData, source.streamUUID,
+                                                                     source.stream, nodeAudioStream,
+                                                                     source.hrtfInputIndex);
         }
     });
 
+    if (worker.hrtfMix.hasSources()) {
+        worker.hrtfMix.render(*_hrtfTable, worker.mixSamples);
+    }
+
+    if (_isMixerReverbEnabled) {
+        streamsMixed += addZoneReverbToMixForListeningNode(worker, nodeAudioStream);
+    }
+
     return streamsMixed;
 }
 
-void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
-    // Send stream properties
-    bool hasReverb = false;
-    float reverbTime, wetLevel;
-    // find reverb properties
+void AudioMixer::mixListenersForWorker(int workerIndex) {
+    TRACE_ZONE("AudioMixer::mixListenersForWorker");
+    AudioMixerWorkerData& worker = _mixWorkers[workerIndex];
+    int numWorkers = _mixWorkers.size();
+
+    quint64 mixStart = usecTimestampNow();
+
+    // listeners are interleaved across workers so that each worker gets a similar share of nearby and distant nodes
+    for (int i = workerIndex; i < _frameListeners.size(); i += numWorkers) {
+        Node* node = _frameListeners[i].data();
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+
+        int streamsMixed = prepareMixForListeningNode(worker, node);
+        nodeData->setStreamsMixed(streamsMixed);
+
+        if (streamsMixed > 0) {
+            AudioMixKernels::saturate(worker.mixSamples, nodeData->getMixedSamples(),
+                                      AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+        }
+
+        ++worker.sumListeners;
+    }
+
+    quint64 mixUsecs = usecTimestampNow() - mixStart;
+    worker.sumMixUsecs += mixUsecs;
+    worker.maxMixUsecs = qMax(worker.maxMixUsecs, mixUsecs);
+    ++worker.numFrames;
+}
+
+float AudioMixer::calculateSilentDistance() const {
+    // distance coefficients reach zero once log2(distance / ATTENUATION_BEGINS_AT_DISTANCE) * attenuation >= 1,
+    // the smallest attenuation in use (zones may override the default) reaches the furthest
+    float smallestAttenuation = _attenuationPerDoublingInDistance;
+    for (int i = 0; i < _zonesSettings.length(); ++i) {
+        smallestAttenuation = glm::min(smallestAttenuation, _zonesSettings[i].coefficient);
+    }
+
+    if (smallestAttenuation <= 0.0f) {
+        return -1.0f;
+    }
+
+    return ATTENUATION_BEGINS_AT_DISTANCE * powf(2.0f, 1.0f / smallestAttenuation);
+}
+
+int AudioMixer::addStreamToSourceCluster(QHash<quint64, int>& clusterIndices, PositionalAudioStream* stream,
+                                         float fadeFactor) {
+    const glm::vec3& position = stream->getPosition();
+    quint64 key = ((quint64)(quint32)(int)glm::floor(position.x / _farSourceClusterSize) << 32)
+        | (quint32)(int)glm::floor(position.z / _farSourceClusterSize);
+
+    int index = clusterIndices.value(key, -1);
+    if (index < 0) {
+        index = _frameClusters.size();
+        clusterIndices.insert(key, index);
+
+        _frameClusters.resize(index + 1);
+        AudioSourceCluster& newCluster = _frameClusters[index];
+        newCluster.position = glm::vec3(0.0f);
+        newCluster.radius = 0.0f;
+        newCluster.trailingLoudness = 0.0f;
+        newCluster.numStreams = 0;
+        memset(newCluster.accumulatedSamples, 0, sizeof(newCluster.accumulatedSamples));
+    }
+
+    AudioSourceCluster& cluster = _frameClusters[index];
+
+    // positions are summed here, buildSourceGrid turns them into the centroid once every stream is in
+    cluster.position += position;
+    cluster.trailingLoudness += stream->getLastPopOutputTrailingLoudness();
+    ++cluster.numStreams;
+
+    float gain = fadeFactor * AVERAGE_OFF_AXIS_ATTENUATION;
+    AudioRingBuffer::ConstIterator streamPopOutput = stream->getLastPopOutput();
+
+    if (!stream->isStereo()) {
+        // the cluster's samples are only filled in once it is complete, use them as scratch until then
+        streamPopOutput.readSamples(cluster.samples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        AudioMixKernels::accumulateWithGain(cluster.accumulatedSamples, cluster.samples, gain,
+                                            AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    } else {
+        int16_t stereoSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        streamPopOutput.readSamples(stereoSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+
+        float downmixGain = gain * 0.5f;
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+            cluster.accumulatedSamples[i] += (int32_t)((stereoSamples[2 * i] + stereoSamples[2 * i + 1]) * downmixGain);
+        }
+    }
+
+    return index;
+}
+
+void AudioMixer::buildSourceGrid() {
+    TRACE_ZONE("AudioMixer::buildSourceGrid");
+    _frameSourceGrid.clear();
+    _frameClusters.resize(0);
+    _frameHRTFInputs.resize(0);
+    int numHRTFInputs = 0;
+
+    float silentDistance = calculateSilentDistance();
+
+    // only avatar streams are clustered - a node never hears its own injectors unless they loop back,
+    // which a shared mix could not honour
+    bool clusterFarSources = _farSourceDistance > 0.0f;
+    QHash<quint64, int> clusterIndices;
+
+    foreach (const SharedNodePointer& node, _frameSources) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+
+        const QHash<QUuid, PositionalAudioStream*>& audioStreams = nodeData->getAudioStreams();
+        QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
+        for (i = audioStreams.constBegin(); i != audioStreams.constEnd(); i++) {
+            PositionalAudioStream* stream = i.value();
+
+            // addStreamToMixForListeningNodeWithStream rejects the stream once loudness / distance <= threshold
+            float audibleRadius = stream->getLastPopOutputTrailingLoudness() / _minAudibilityThreshold;
+            if (audibleRadius <= 0.0f) {
+                continue;
+            }
+
+            if (silentDistance >= 0.0f) {
+                audibleRadius = glm::min(audibleRadius, silentDistance);
+            }
+
+            AudioSourceGrid::Source source;
+            source.node = node.data();
+            source.stream = stream;
+            source.streamUUID = (stream->getType() == PositionalAudioStream::Microphone) ? node->getUUID() : i.key();
+            source.position = stream->getPosition();
+            source.audibleRadius = audibleRadius;
+            source.clusterIndex = -1;
+            source.hrtfInputIndex = -1;
+
+            if (_hrtfTable && !stream->isStereo()) {
+                // the HRTFs run by overlap-save, on the previous frame followed by the one just popped
+                int16_t inputSamples[AudioHRTFConstants::FFT_SIZE];
+                (stream->getLastPopOutput() - AudioHRTFConstants::FRAME_SAMPLES).readSamples(inputSamples,
+                                                                                          AudioHRTFConstants::FFT_SIZE);
+
+                source.hrtfInputIndex = numHRTFInputs++;
+                _frameHRTFInputs.resize(numHRTFInputs * AudioHRTFConstants::NUM_BINS);
+                _hrtfTable->transformInput(inputSamples, &_frameHRTFInputs[source.hrtfInputIndex * AudioHRTFConstants::NUM_BINS]);
+            }
+
+            if (clusterFarSources && stream->getType() == PositionalAudioStream::Microphone) {
+                float fadeFactor = calculateFadeFactorForMix(stream);
+                if (fadeFactor > 0.0f) {
+                    source.clusterIndex = addStreamToSourceCluster(clusterIndices, stream, fadeFactor);
+                }
+            }
+
+            _frameSourceGrid.addSource(source);
+        }
+    }
+
+    _frameSourceGrid.build();
+
+    // finish the shared far mixes now that all of their streams are in
+    for (int i = 0; i < _frameClusters.size(); ++i) {
+        AudioSourceCluster& cluster = _frameClusters[i];
+        cluster.position /= (float)cluster.numStreams;
+        AudioMixKernels::saturate(cluster.accumulatedSamples, cluster.samples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+
+    foreach (const AudioSourceGrid::Source& source, _frameSourceGrid.getSources()) {
+        if (source.clusterIndex >= 0) {
+            AudioSourceCluster& cluster = _frameClusters[source.clusterIndex];
+            cluster.radius = glm::max(cluster.radius, glm::distance(source.position, cluster.position));
+        }
+    }
+}
+
+void AudioMixer::mixZoneReverbs() {
+    TRACE_ZONE("AudioMixer::mixZoneReverbs");
+    _frameZoneReverbsHeard.fill(false, (int)_zoneReverbs.size());
+    if (!_isMixerReverbEnabled) {
+        return;
+    }
+
+    // a zone is only worth its reverb while someone is in it to hear it
+    bool isAnyZoneHeard = false;
+    foreach (const SharedNodePointer& node, _frameListeners) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        float reverbTime, wetLevel;
+        int zone = findReverbZone(nodeData->getAvatarAudioStream()->getPosition(), reverbTime, wetLevel);
+        if (zone >= 0) {
+            _frameZoneReverbsHeard[zone] = true;
+            isAnyZoneHeard = true;
+        }
+    }
+
+    for (int i = 0; i < (int)_zoneReverbs.size(); ++i) {
+        if (_frameZoneReverbsHeard[i]) {
+            _zoneReverbs[i]->beginFrame();
+        } else {
+            _zoneReverbs[i]->flush();
+        }
+    }
+    if (!isAnyZoneHeard) {
+        return;
+    }
+
+    // every stream goes in the reverb of the zone it is in, at the level it left its source
+    foreach (const AudioSourceGrid::Source& source, _frameSourceGrid.getSources()) {
+        float reverbTime, wetLevel;
+        int zone = findReverbZone(source.position, reverbTime, wetLevel);
+        if (zone < 0 || !_frameZoneReverbsHeard[zone]) {
+            continue;
+        }
+
+        float fadeFactor = calculateFadeFactorForMix(source.stream);
+        if (fadeFactor > 0.0f) {
+            _zoneReverbs[zone]->addStream(source.stream->getLastPopOutput(), source.stream->isStereo(), fadeFactor);
+        }
+    }
+
+    for (int i = 0; i < (int)_zoneReverbs.size(); ++i) {
+        if (_frameZoneReverbsHeard[i]) {
+            _zoneReverbs[i]->process();
+        }
+    }
+}
+
+int AudioMixer::findReverbZone(const glm::vec3& position, float& reverbTime, float& wetLevel) const {
     for (int i = 0; i < _zoneReverbSettings.size(); ++i) {
-        AudioMixerClientData* data = static_cast<AudioMixerClientData*>(node->getLinkedData());
-        glm::vec3 streamPosition = data->getAvatarAudioStream()->getPosition();
         AABox box = _audioZones[_zoneReverbSettings[i].zone];
-        if (box.contains(streamPosition)) {
-            hasReverb = true;
+        if (box.contains(position)) {
             reverbTime = _zoneReverbSettings[i].reverbTime;
             wetLevel = _zoneReverbSettings[i].wetLevel;
 
             // Modulate wet level with distance to wall
             float MIN_ATTENUATION_DISTANCE = 2.0f;
             float MAX_ATTENUATION = -12; // dB
-            glm::vec3 distanceToWalls = (box.getDimensions() / 2.0f) - glm::abs(streamPosition - box.calcCenter());
+            glm::vec3 distanceToWalls = (box.getDimensions() / 2.0f) - glm::abs(position - box.calcCenter());
             float distanceToClosestWall = glm::min(distanceToWalls.x, distanceToWalls.z);
             if (distanceToClosestWall < MIN_ATTENUATION_DISTANCE) {
                 wetLevel += MAX_ATTENUATION * (1.0f - distanceToClosestWall / MIN_ATTENUATION_DISTANCE);
             }
-            break;
+            return i;
         }
     }
+    return -1;
+}
+
+void AudioMixer::setNumMixWorkers(int numMixWorkers) {
+    numMixWorkers = glm::clamp(numMixWorkers, 1, MAX_NUM_MIX_WORKERS);
+
+    _mixWorkers.resize(numMixWorkers);
+
+    // worker 0 runs on the mixer thread, the pool only needs threads for the others
+    _mixThreadPool.setMaxThreadCount(qMax(numMixWorkers - 1, 1));
+}
+
+void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
+    // Send stream properties
+    float reverbTime, wetLevel;
+    // find reverb properties
+    AudioMixerClientData* data = static_cast<AudioMixerClientData*>(node->getLinkedData());
+    bool hasReverb = findReverbZone(data->getAvatarAudioStream()->getPosition(), reverbTime, wetLevel) >= 0;
     
     AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
     AvatarAudioStream* stream = nodeData->getAvatarAudioStream();
@@ -515,25 +897,30 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
     bool sendData = dataChanged || (randFloat() < CHANCE_OF_SEND);
 
     if (sendData) {
-        auto nodeList = DependencyManager::get<NodeList>();
+        auto nodeList = DependencyManager::getRaw<NodeList>();
 
         unsigned char bitset = 0;
 
         int packetSize = sizeof(bitset);
 
-        if (hasReverb) {
+        // the reverb is already in the mix, the client is only told not to add its own
+        bool hasClientReverb = hasReverb && !_isMixerReverbEnabled;
+
+        if (hasClientReverb) {
             packetSize += sizeof(reverbTime) + sizeof(wetLevel);
         }
 
         auto envPacket = NLPacket::create(PacketType::AudioEnvironment, packetSize);
 
-        if (hasReverb) {
+        if (hasClientReverb) {
             setAtBit(bitset, HAS_REVERB_BIT);
+        } else if (hasReverb) {
+            setAtBit(bitset, HAS_MIXER_REVERB_BIT);
         }
 
         envPacket->writePrimitive(bitset);
 
-        if (hasReverb) {
+        if (hasClientReverb) {
             envPacket->writePrimitive(reverbTime);
             envPacket->writePrimitive(wetLevel);
         }
@@ -542,7 +929,7 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
 }
 
 void AudioMixer::handleNodeAudioPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
-    DependencyManager::get<NodeList>()->updateNodeWithDataFromPacket(packet, sendingNode);
+    DependencyManager::getRaw<NodeList>()->updateNodeWithDataFromPacket(packet, sendingNode);
 }
 
 void AudioMixer::handleMuteEnvironmentPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
@@ -562,6 +949,40 @@ void AudioMixer::handleMuteEnvironmentPacket(QSharedPointer<NLPacket> packet, Sh
     }
 }
 
+void AudioMixer::handleNegotiateAudioFormat(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
+    QStringList availableCodecs;
+    QDataStream packetStream(packet.data());
+    packetStream >> availableCodecs;
+
+    // pick the codec we prefer most among the ones the client offered - if nothing matches we stay on raw PCM
+    QString selectedCodecName;
+    foreach (const QString& codecName, _codecPreferenceOrder) {
+        if (availableCodecs.contains(codecName)) {
+            selectedCodecName = codecName;
+            break;
+        }
+    }
+
+    CodecPluginPointer selectedCodec = getCodecPlugin(selectedCodecName);
+    if (!selectedCodec) {
+        selectedCodecName = QString();
+    }
+
+    AudioMixerClientData* clientData = static_cast<AudioMixerClientData*>(sendingNode->getLinkedData());
+    if (clientData) {
+        clientData->setupCodec(selectedCodec, selectedCodecName);
+    }
+
+    qDebug() << "Selected audio codec" << (selectedCodecName.isEmpty() ? "(none)" : selectedCodecName)
+             << "for" << uuidStringWithoutCurlyBraces(sendingNode->getUUID());
+
+    auto replyPacket = NLPacket::create(PacketType::SelectedAudioFormat);
+    QDataStream replyStream(replyPacket.get());
+    replyStream << selectedCodecName;
+
+    DependencyManager::get<NodeList>()->sendPacket(std::move(replyPacket), *sendingNode);
+}
+
 void AudioMixer::sendStatsPacket() {
     static QJsonObject statsObject;
 
@@ -571,16 +992,60 @@ void AudioMixer::sendStatsPacket() {
 
     statsObject["average_listeners_per_frame"] = (float) _sumListeners / (float) _numStatFrames;
 
+    QJsonObject mixWorkersStats;
+
+    for (int i = 0; i < _mixWorkers.size(); ++i) {
+        AudioMixerWorkerData& worker = _mixWorkers[i];
+        QJsonObject workerStats;
+
+        if (worker.numFrames > 0) {
+            workerStats["average_mix_usecs_per_frame"] = (float) worker.sumMixUsecs / (float) worker.numFrames;
+            workerStats["average_listeners_per_frame"] = (float) worker.sumListeners / (float) worker.numFrames;
+        } else {
+            workerStats["average_mix_usecs_per_frame"] = 0.0;
+            workerStats["average_listeners_per_frame"] = 0.0;
+        }
+        workerStats["max_mix_usecs_per_frame"] = (double) worker.maxMixUsecs;
+
+        mixWorkersStats[QString("worker_%1").arg(i)] = workerStats;
+
+        _sumMixes += worker.sumMixes;
+        _sumClusterMixes += worker.sumClusterMixes;
+
+        worker.sumMixes = 0;
+        worker.sumClusterMixes = 0;
+        worker.sumListeners = 0;
+        worker.numFrames = 0;
+        worker.sumMixUsecs = 0;
+        worker.maxMixUsecs = 0;
+    }
+
+    statsObject["mix_workers"] = mixWorkersStats;
+    statsObject["frame_scheduler"] = _frameScheduler.takeStatsObject();
+
     if (_sumListeners > 0) {
         statsObject["average_mixes_per_listener"] = (float) _sumMixes / (float) _sumListeners;
+        statsObject["average_far_cluster_mixes_per_listener"] = (float) _sumClusterMixes / (float) _sumListeners;
     } else {
         statsObject["average_mixes_per_listener"] = 0.0;
+        statsObject["average_far_cluster_mixes_per_listener"] = 0.0;
     }
 
     _sumListeners = 0;
     _sumMixes = 0;
+    _sumClusterMixes = 0;
     _numStatFrames = 0;
 
+    auto ringBufferPoolStats = AudioRingBufferPool::getStats();
+    QJsonObject ringBufferPoolObject;
+    ringBufferPoolObject["num_buffers"] = ringBufferPoolStats.numBuffers;
+    ringBufferPoolObject["num_free_buffers"] = ringBufferPoolStats.numFreeBuffers;
+    ringBufferPoolObject["bytes_in_use"] = (double) ringBufferPoolStats.bytesInUse;
+    ringBufferPoolObject["bytes_free"] = (double) ringBufferPoolStats.bytesFree;
+    ringBufferPoolObject["hits"] = (double) ringBufferPoolStats.hits;
+    ringBufferPoolObject["misses"] = (double) ringBufferPoolStats.misses;
+    statsObject["ring_buffer_pool"] = ringBufferPoolObject;
+
     QJsonObject readPendingDatagramStats;
 
     QJsonObject rpdCallsStats;
@@ -678,11 +1143,16 @@ void AudioMixer::run() {
     // check the settings object to see if we have anything we can parse out
     parseSettingsObject(settingsObject);
 
-    int nextFrame = 0;
-    QElapsedTimer timer;
-    timer.start();
+    // the mixer thread also handles the packets, so a realtime priority covers both
+    if (_frameThreadRealtime) {
+        FrameScheduler::setCurrentThreadRealtime();
+    }
+    if (_frameThreadCPU >= 0) {
+        FrameScheduler::setCurrentThreadCPU(_frameThreadCPU);
+    }
 
-    int usecToSleep = AudioConstants::NETWORK_FRAME_USECS;
+    _frameScheduler.setFrameUsecs(AudioConstants::NETWORK_FRAME_USECS);
+    _frameScheduler.start();
 
     const int TRAILING_AVERAGE_FRAMES = 100;
     int framesSinceCutoffEvent = TRAILING_AVERAGE_FRAMES;
@@ -693,15 +1163,7 @@ void AudioMixer::run() {
 
         const float RATIO_BACK_OFF = 0.02f;
 
-        const float CURRENT_FRAME_RATIO = 1.0f / TRAILING_AVERAGE_FRAMES;
-        const float PREVIOUS_FRAMES_RATIO = 1.0f - CURRENT_FRAME_RATIO;
-
-        if (usecToSleep < 0) {
-            usecToSleep = 0;
-        }
-
-        _trailingSleepRatio = (PREVIOUS_FRAMES_RATIO * _trailingSleepRatio)
-            + (usecToSleep * CURRENT_FRAME_RATIO / (float) AudioConstants::NETWORK_FRAME_USECS);
+        _trailingSleepRatio = _frameScheduler.getTrailingSleepRatio();
 
         float lastCutoffRatio = _performanceThrottlingRatio;
         bool hasRatioChanged = false;
@@ -746,7 +1208,14 @@ void AudioMixer::run() {
             _lastPerSecondCallbackTime = now;
         }
 
-        nodeList->eachNode([&](const SharedNodePointer& node) {
+        _frameListeners.resize(0);
+        _frameSources.resize(0);
+
+        quint64 mixStart = usecTimestampNow();
+
+        // grab the node snapshot once for the frame, no node list lock is taken while we go through it
+        NodeSnapshotPointer nodes = nodeList->getNodeSnapshot();
+        for (const SharedNodePointer& node : *nodes) {
 
             if (node->getLinkedData()) {
                 AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
@@ -763,54 +1232,84 @@ void AudioMixer::run() {
                     nodeList->sendPacket(std::move(mutePacket), *node);
                 }
 
+                _frameSources.append(node);
+
                 if (node->getType() == NodeType::Agent && node->getActiveSocket()
                     && nodeData->getAvatarAudioStream()) {
+                    _frameListeners.append(node);
+                }
+            }
+        }
 
-                    int streamsMixed = prepareMixForListeningNode(node.data());
+        buildSourceGrid();
+        mixZoneReverbs();
 
-                    std::unique_ptr<NLPacket> mixPacket;
+        // the streams of every source have been popped for this frame, so the mixes can now run in parallel
+        for (int i = 1; i < _mixWorkers.size(); ++i) {
+            _mixThreadPool.start(new AudioMixerJob(this, i));
+        }
+        mixListenersForWorker(0);
 
-                    if (streamsMixed > 0) {
-                        int mixPacketBytes = sizeof(quint16) + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
-                        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
+        // barrier - every mix must be ready before any of this frame's packets go out
+        _mixThreadPool.waitForDone();
 
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
+        foreach (const SharedNodePointer& node, _frameListeners) {
+            AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
 
-                        // pack mixed audio samples
-                        mixPacket->write(reinterpret_cast<char*>(_mixSamples),
-                                         AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                    } else {
-                        int silentPacketBytes = sizeof(quint16) + sizeof(quint16);
-                        mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
+            std::unique_ptr<NLPacket> mixPacket;
 
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
+            if (nodeData->getStreamsMixed() > 0) {
+                QByteArray decodedBuffer = QByteArray::fromRawData(reinterpret_cast<char*>(nodeData->getMixedSamples()),
+                                                                   AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+                QByteArray encodedBuffer;
+                nodeData->encode(decodedBuffer, encodedBuffer);
 
-                        // pack number of silent audio samples
-                        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-                        mixPacket->writePrimitive(numSilentSamples);
-                    }
+                int mixPacketBytes = sizeof(quint16) + encodedBuffer.size();
+                mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
 
-                    // Send audio environment
-                    sendAudioEnvironmentPacket(node);
+                // pack sequence number
+                quint16 sequence = nodeData->getOutgoingSequenceNumber();
+                mixPacket->writePrimitive(sequence);
 
-                    // send mixed audio packet
-                    nodeList->sendPacket(std::move(mixPacket), *node);
-                    nodeData->incrementOutgoingMixedAudioSequenceNumber();
+                // pack mixed audio samples, encoded with the codec negotiated with this listener
+                mixPacket->write(encodedBuffer.constData(), encodedBuffer.size());
+            } else {
+                int silentPacketBytes = sizeof(quint16) + sizeof(quint16);
+                mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
 
-                    // send an audio stream stats packet if it's time
-                    if (_sendAudioStreamStats) {
-                        nodeData->sendAudioStreamStatsPackets(node);
-                        _sendAudioStreamStats = false;
-                    }
+                // pack sequence number
+                quint16 sequence = nodeData->getOutgoingSequenceNumber();
+                mixPacket->writePrimitive(sequence);
 
-                    ++_sumListeners;
-                }
+                // pack number of silent audio samples
+                quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+                mixPacket->writePrimitive(numSilentSamples);
             }
-        });
+
+            // Send audio environment
+            sendAudioEnvironmentPacket(node);
+
+            // send mixed audio packet
+            nodeList->sendPacket(std::move(mixPacket), *node);
+            nodeData->incrementOutgoingMixedAudioSequenceNumber();
+
+            // send an audio stream stats packet if it's time
+            if (_sendAudioStreamStats) {
+                nodeData->sendAudioStreamStatsPackets(node);
+                _sendAudioStreamStats = false;
+            }
+
+            ++_sumListeners;
+        }
+
+        mixFramesMetric->increment();
+        mixListenersMetric->set(_frameListeners.size());
+        mixMsecsMetric->observe((double)(usecTimestampNow() - mixStart) / USECS_PER_MSEC);
+
+        // don't hold on to nodes that may be killed before the next frame
+        _frameListeners.resize(0);
+        _frameSources.resize(0);
+        _frameSourceGrid.clear();
 
         ++_numStatFrames;
 
@@ -824,11 +1323,7 @@ void AudioMixer::run() {
             break;
         }
 
-        usecToSleep = (++nextFrame * AudioConstants::NETWORK_FRAME_USECS) - timer.nsecsElapsed() / 1000; // ns to us
-
-        if (usecToSleep > 0) {
-            usleep(usecToSleep);
-        }
+        _frameScheduler.waitForNextFrame();
     }
 }
 
@@ -955,6 +1450,28 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             qDebug() << "Repetition with fade disabled";
         }
 
+        const QString MIX_WORKER_THREADS_JSON_KEY = "mix_worker_threads";
+        int numMixWorkers = audioBufferGroupObject[MIX_WORKER_THREADS_JSON_KEY].toString().toInt(&ok);
+        if (!ok) {
+            numMixWorkers = DEFAULT_NUM_MIX_WORKERS;
+        }
+        setNumMixWorkers(numMixWorkers);
+        qDebug() << "Mix worker threads:" << _mixWorkers.size();
+
+        const QString FRAME_THREAD_REALTIME_JSON_KEY = "frame_thread_realtime";
+        _frameThreadRealtime = audioBufferGroupObject[FRAME_THREAD_REALTIME_JSON_KEY].toBool();
+        if (_frameThreadRealtime) {
+            qDebug() << "The mixer thread will run with a realtime priority";
+        }
+
+        const QString FRAME_THREAD_CPU_JSON_KEY = "frame_thread_cpu";
+        _frameThreadCPU = audioBufferGroupObject[FRAME_THREAD_CPU_JSON_KEY].toString().toInt(&ok);
+        if (!ok) {
+            _frameThreadCPU = -1;
+        } else if (_frameThreadCPU >= 0) {
+            qDebug() << "The mixer thread will run on CPU" << _frameThreadCPU;
+        }
+
         const QString PRINT_STREAM_STATS_JSON_KEY = "print_stream_stats";
         _printStreamStats = audioBufferGroupObject[PRINT_STREAM_STATS_JSON_KEY].toBool();
         if (_printStreamStats) {
@@ -993,6 +1510,61 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             qDebug() << "Filter enabled";
         }
 
+        const QString FAR_SOURCE_MIX_DISTANCE = "far_source_mix_distance";
+        if (audioEnvGroupObject[FAR_SOURCE_MIX_DISTANCE].isString()) {
+            bool ok = false;
+            float farSourceDistance = audioEnvGroupObject[FAR_SOURCE_MIX_DISTANCE].toString().toFloat(&ok);
+            if (ok) {
+                _farSourceDistance = glm::max(farSourceDistance, 0.0f);
+                qDebug() << "Far source mix distance changed to" << _farSourceDistance;
+            }
+        }
+
+        const QString FAR_SOURCE_CLUSTER_SIZE = "far_source_cluster_size";
+        if (audioEnvGroupObject[FAR_SOURCE_CLUSTER_SIZE].isString()) {
+            bool ok = false;
+            float clusterSize = audioEnvGroupObject[FAR_SOURCE_CLUSTER_SIZE].toString().toFloat(&ok);
+            if (ok && clusterSize > 0.0f) {
+                _farSourceClusterSize = clusterSize;
+                qDebug() << "Far source cluster size changed to" << _farSourceClusterSize;
+            }
+        }
+
+        const QString FEC_GROUP_SIZE = "fec_group_size";
+        const QString FEC_PARITY_PACKETS = "fec_parity_packets";
+        int fecGroupSize = 0;
+        int fecParityPackets = 1;
+        if (audioEnvGroupObject[FEC_GROUP_SIZE].isString()) {
+            bool ok = false;
+            int groupSize = audioEnvGroupObject[FEC_GROUP_SIZE].toString().toInt(&ok);
+            if (ok && groupSize > 0) {
+                fecGroupSize = groupSize;
+            }
+        }
+        if (audioEnvGroupObject[FEC_PARITY_PACKETS].isString()) {
+            bool ok = false;
+            int parityPackets = audioEnvGroupObject[FEC_PARITY_PACKETS].toString().toInt(&ok);
+            if (ok && parityPackets > 0) {
+                fecParityPackets = parityPackets;
+            }
+        }
+        DependencyManager::get<NodeList>()->setForwardErrorCorrection({ PacketType::MixedAudio, PacketType::SilentAudioFrame },
+                                                                      fecGroupSize, fecParityPackets);
+
+        const QString CODEC_PREFERENCE_ORDER = "codec_preference_order";
+        if (audioEnvGroupObject[CODEC_PREFERENCE_ORDER].isString()) {
+            QStringList codecPreferenceOrder = audioEnvGroupObject[CODEC_PREFERENCE_ORDER].toString()
+                .split(",", QString::SkipEmptyParts);
+
+            _codecPreferenceOrder.clear();
+            foreach (const QString& codecName, codecPreferenceOrder) {
+                if (getCodecPlugin(codecName.trimmed())) {
+                    _codecPreferenceOrder << codecName.trimmed();
+                }
+            }
+            qDebug() << "Codec preference order changed to" << _codecPreferenceOrder;
+        }
+
         const QString AUDIO_ZONES = "zones";
         if (audioEnvGroupObject[AUDIO_ZONES].isObject()) {
             const QJsonObject& zones = audioEnvGroupObject[AUDIO_ZONES].toObject();
@@ -1099,6 +1671,31 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
                 }
             }
         }
+
+        const QString MIXER_REVERB = "enable_mixer_reverb";
+        if (audioEnvGroupObject[MIXER_REVERB].isBool()) {
+            _isMixerReverbEnabled = audioEnvGroupObject[MIXER_REVERB].toBool();
+        }
+        _zoneReverbs.clear();
+        if (_isMixerReverbEnabled) {
+            for (int i = 0; i < _zoneReverbSettings.size(); ++i) {
+                _zoneReverbs.emplace_back(new AudioZoneReverb(_zoneReverbSettings[i].reverbTime));
+            }
+            qDebug() << "Reverb of the zones mixed in the mixer";
+        }
+
+        const QString HRTF_KEY = "enable_hrtf";
+        if (audioEnvGroupObject[HRTF_KEY].isBool()) {
+            _isHRTFEnabled = audioEnvGroupObject[HRTF_KEY].toBool();
+        }
+        if (_isHRTFEnabled) {
+            if (!_hrtfTable) {
+                _hrtfTable.reset(new AudioHRTFTable());
+            }
+            qDebug() << "HRTF spatialization enabled";
+        } else {
+            _hrtfTable.reset();
+        }
     }
 }
 
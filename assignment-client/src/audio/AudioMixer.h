@@ -12,10 +12,21 @@
 #ifndef hifi_AudioMixer_h
 #define hifi_AudioMixer_h
 
+#include <memory>
+#include <vector>
+
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
 #include <AABox.h>
+#include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
+#include <FrameScheduler.h>
 #include <ThreadedAssignment.h>
 
+#include "AudioSourceGrid.h"
+#include "AudioZoneReverb.h"
+
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioMixerClientData;
@@ -24,9 +35,49 @@ const int SAMPLE_PHASE_DELAY_AT_90 = 20;
 
 const int READ_DATAGRAMS_STATS_WINDOW_SECONDS = 30;
 
+const int MIX_SAMPLES_CAPACITY = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2);
+
+/// Scratch buffers and stats for one mix worker. Each worker owns one of these so listeners can be mixed in parallel.
+class AudioMixerWorkerData {
+public:
+    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
+    // data from a phase delay as well as an entire network buffer
+    int16_t preMixSamples[MIX_SAMPLES_CAPACITY];
+
+    // streams are accumulated here without clamping, the mix is saturated to int16 once it is complete
+    int32_t mixSamples[MIX_SAMPLES_CAPACITY];
+
+    // shared far mixes already mixed for the current listener, their member streams are skipped
+    QVector<bool> clustersMixed;
+
+    // the mono streams the current listener hears through HRTFs, added to mixSamples once they are all in
+    AudioHRTFMix hrtfMix;
+
+    int sumMixes { 0 };
+    int sumClusterMixes { 0 };
+    int sumListeners { 0 };
+    int numFrames { 0 };
+    quint64 sumMixUsecs { 0 };
+    quint64 maxMixUsecs { 0 };
+};
+
+/// Mono mix of the far-away avatar streams that share one coarse cell. It is built once per frame and reused for
+/// every listener that is further than the far source distance from all of its members.
+class AudioSourceCluster {
+public:
+    glm::vec3 position;         // centroid of the member streams
+    float radius;               // distance from the centroid to the furthest member
+    float trailingLoudness;     // sum of the members' trailing loudness
+    int numStreams;
+
+    int32_t accumulatedSamples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+};
+
 /// Handles assignments of type AudioMixer - mixing streams of audio and re-distributing to various clients.
 class AudioMixer : public ThreadedAssignment {
     Q_OBJECT
+    friend class AudioMixerJob;
 public:
     AudioMixer(NLPacket& packet);
 
@@ -40,29 +91,60 @@ public slots:
     static const InboundAudioStream::Settings& getStreamSettings() { return _streamSettings; }
 
 private slots:
-    void handleNodeAudioPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
     void handleMuteEnvironmentPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
+    void handleNegotiateAudioFormat(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
 
 private:
+    /// called directly from the thread receiving packets, it only parses into the sending node's locked data
+    void handleNodeAudioPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
+
     /// adds one stream to the mix for a listening node
-    int addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
+    int addStreamToMixForListeningNodeWithStream(AudioMixerWorkerData& worker,
+                                                    AudioMixerClientData* listenerNodeData,
                                                     const QUuid& streamUUID,
                                                     PositionalAudioStream* streamToAdd,
-                                                    AvatarAudioStream* listeningNodeStream);
+                                                    AvatarAudioStream* listeningNodeStream,
+                                                    int hrtfInputIndex);
 
-    /// prepares and sends a mix to one Node
-    int prepareMixForListeningNode(Node* node);
+    /// adds a shared far mix to the mix for a listening node, panned but without phase delay or filtering
+    int addClusterToMixForListeningNode(AudioMixerWorkerData& worker, const AudioSourceCluster& cluster,
+                                        AvatarAudioStream* listeningNodeStream);
+
+    /// adds the shared reverb of the listener's zone to its mix, scaled by the listener's wet level
+    int addZoneReverbToMixForListeningNode(AudioMixerWorkerData& worker, AvatarAudioStream* listeningNodeStream);
+
+    /// prepares a mix for one Node in the scratch buffers of the given worker
+    int prepareMixForListeningNode(AudioMixerWorkerData& worker, Node* node);
+
+    /// mixes every listener of this frame assigned to the given worker, then stores each mix with its listener
+    void mixListenersForWorker(int workerIndex);
+
+    /// indexes the streams of this frame's sources by position and audible radius
+    void buildSourceGrid();
+
+    /// runs the reverb of each zone that has a listener in it, on the streams in the zone
+    void mixZoneReverbs();
+
+    /// index of the reverb settings of the zone the position is in, or -1, with the wet level near its walls
+    int findReverbZone(const glm::vec3& position, float& reverbTime, float& wetLevel) const;
+
+    /// distance beyond which no attenuation setting leaves any gain, or a negative value if there is none
+    float calculateSilentDistance() const;
+
+    /// mixes the stream into the shared far mix for its coarse cell, returns the index of that cluster
+    int addStreamToSourceCluster(QHash<quint64, int>& clusterIndices, PositionalAudioStream* stream, float fadeFactor);
+
+    /// fade to apply to the stream's last popped frame, zero if the stream has nothing to mix this frame
+    float calculateFadeFactorForMix(PositionalAudioStream* stream) const;
+
+    /// gain for the distance between a source and a listener, using the attenuation of the zones they are in
+    float calculateDistanceCoefficient(const glm::vec3& sourcePosition, const glm::vec3& listenerPosition,
+                                       float distance) const;
 
     /// Send Audio Environment packet for a single node
     void sendAudioEnvironmentPacket(SharedNodePointer node);
 
-    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
-    // data from a phase delay as well as an entire network buffer
-    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
-
-    // client samples capacity is larger than what will be sent to optimize mixing
-    // we are MMX adding 4 samples at a time so we need client samples to have an extra 4
-    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    void setNumMixWorkers(int numMixWorkers);
 
     void perSecondActions();
 
@@ -75,9 +157,26 @@ private:
     float _performanceThrottlingRatio;
     float _attenuationPerDoublingInDistance;
     float _noiseMutingThreshold;
+    float _farSourceDistance; // zero disables the shared far mixes
+    float _farSourceClusterSize;
     int _numStatFrames;
     int _sumListeners;
     int _sumMixes;
+    int _sumClusterMixes;
+
+    FrameScheduler _frameScheduler;
+    bool _frameThreadRealtime = false;
+    int _frameThreadCPU = -1; // negative lets the mixer thread run on any CPU
+
+    // per-listener mixes are split across these workers, worker 0 runs on the mixer thread itself
+    QVector<AudioMixerWorkerData> _mixWorkers;
+    QThreadPool _mixThreadPool;
+
+    // the nodes that are mixed for and mixed from during the current frame, fixed before the mix workers start
+    QVector<SharedNodePointer> _frameListeners;
+    QVector<SharedNodePointer> _frameSources;
+    AudioSourceGrid _frameSourceGrid;
+    QVector<AudioSourceCluster> _frameClusters;
 
     QHash<QString, AABox> _audioZones;
     struct ZonesSettings {
@@ -93,6 +192,20 @@ private:
     };
     QVector<ReverbSettings> _zoneReverbSettings;
 
+    // when set, the reverb of the zones is mixed here once per zone and the clients don't run their own
+    bool _isMixerReverbEnabled;
+    std::vector<std::unique_ptr<AudioZoneReverb>> _zoneReverbs;
+    QVector<bool> _frameZoneReverbsHeard;
+
+    // when set, mono streams are spatialized through HRTFs - the spectrum of each is taken once per frame and
+    // shared by all of its listeners
+    bool _isHRTFEnabled;
+    std::unique_ptr<AudioHRTFTable> _hrtfTable;
+    QVector<AudioHRTFTable::Complex> _frameHRTFInputs;
+
+    // codec names in the order we prefer them, only codecs that are also supported locally are kept
+    QStringList _codecPreferenceOrder;
+
     static InboundAudioStream::Settings _streamSettings;
 
     static bool _printStreamStats;
@@ -24,11 +24,14 @@
 AudioMixerClientData::AudioMixerClientData() :
     _audioStreams(),
     _outgoingMixedAudioSequenceNumber(0),
+    _streamsMixed(0),
     _downstreamAudioStreamStats()
 {
 }
 
 AudioMixerClientData::~AudioMixerClientData() {
+    cleanupCodec();
+
     QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
     for (i = _audioStreams.constBegin(); i != _audioStreams.constEnd(); i++) {
         // delete this attached InboundAudioStream
@@ -81,7 +84,9 @@ int AudioMixerClientData::parseData(NLPacket& packet) {
 
                 bool isStereo = channelFlag == 1;
 
-                _audioStreams.insert(nullUUID, matchingStream = new AvatarAudioStream(isStereo, AudioMixer::getStreamSettings()));
+                auto avatarAudioStream = new AvatarAudioStream(isStereo, AudioMixer::getStreamSettings());
+                avatarAudioStream->setupCodec(_codec, _selectedCodecName, isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
+                _audioStreams.insert(nullUUID, matchingStream = avatarAudioStream);
             } else {
                 matchingStream = _audioStreams.value(nullUUID);
             }
@@ -112,6 +117,40 @@ int AudioMixerClientData::parseData(NLPacket& packet) {
     return 0;
 }
 
+void AudioMixerClientData::setupCodec(CodecPluginPointer codec, const QString& codecName) {
+    cleanupCodec();
+
+    _codec = codec;
+    _selectedCodecName = codecName;
+
+    if (_codec) {
+        // the mix we send is always stereo
+        _encoder = _codec->createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    }
+
+    auto avatarAudioStream = getAvatarAudioStream();
+    if (avatarAudioStream) {
+        avatarAudioStream->setupCodec(_codec, _selectedCodecName, avatarAudioStream->isStereo() ? AudioConstants::STEREO : AudioConstants::MONO);
+    }
+}
+
+void AudioMixerClientData::cleanupCodec() {
+    if (_codec && _encoder) {
+        _codec->releaseEncoder(_encoder);
+    }
+    _encoder = nullptr;
+    _codec.reset();
+    _selectedCodecName = QString();
+}
+
+void AudioMixerClientData::encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
+    if (_encoder) {
+        _encoder->encode(decodedBuffer, encodedBuffer);
+    } else {
+        encodedBuffer = decodedBuffer;
+    }
+}
+
 void AudioMixerClientData::checkBuffersBeforeFrameSend() {
     QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
     for (i = _audioStreams.constBegin(); i != _audioStreams.constEnd(); i++) {
@@ -207,6 +246,11 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() const {
     downstreamStats["starves"] = (double) streamStats._starveCount;
     downstreamStats["not_mixed"] = (double) streamStats._consecutiveNotMixedCount;
     downstreamStats["overflows"] = (double) streamStats._overflowCount;
+    downstreamStats["latency_ms"] = streamStats._latencyMsecs;
+    downstreamStats["jitter_ms"] = streamStats._jitterMsecs;
+    downstreamStats["starved_ms"] = (double) streamStats._starvedMsecs;
+    downstreamStats["frames_sped_up"] = (double) streamStats._framesAccelerated;
+    downstreamStats["frames_slowed_down"] = (double) streamStats._framesExpanded;
     downstreamStats["lost%"] = streamStats._packetStreamStats.getLostRate() * 100.0f;
     downstreamStats["lost%_30s"] = streamStats._packetStreamWindowStats.getLostRate() * 100.0f;
     downstreamStats["min_gap"] = formatUsecTime(streamStats._timeGapMin);
@@ -231,6 +275,11 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() const {
         upstreamStats["starves"] = (double) streamStats._starveCount;
         upstreamStats["not_mixed"] = (double) streamStats._consecutiveNotMixedCount;
         upstreamStats["overflows"] = (double) streamStats._overflowCount;
+        upstreamStats["latency_ms"] = streamStats._latencyMsecs;
+        upstreamStats["jitter_ms"] = streamStats._jitterMsecs;
+        upstreamStats["starved_ms"] = (double) streamStats._starvedMsecs;
+        upstreamStats["frames_sped_up"] = (double) streamStats._framesAccelerated;
+        upstreamStats["frames_slowed_down"] = (double) streamStats._framesExpanded;
         upstreamStats["silents_dropped"] = (double) streamStats._framesDropped;
         upstreamStats["lost%"] = streamStats._packetStreamStats.getLostRate() * 100.0f;
         upstreamStats["lost%_30s"] = streamStats._packetStreamWindowStats.getLostRate() * 100.0f;
@@ -260,6 +309,11 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() const {
             upstreamStats["starves"] = (double) streamStats._starveCount;
             upstreamStats["not_mixed"] = (double) streamStats._consecutiveNotMixedCount;
             upstreamStats["overflows"] = (double) streamStats._overflowCount;
+            upstreamStats["latency_ms"] = streamStats._latencyMsecs;
+            upstreamStats["jitter_ms"] = streamStats._jitterMsecs;
+            upstreamStats["starved_ms"] = (double) streamStats._starvedMsecs;
+            upstreamStats["frames_sped_up"] = (double) streamStats._framesAccelerated;
+            upstreamStats["frames_slowed_down"] = (double) streamStats._framesExpanded;
             upstreamStats["silents_dropped"] = (double) streamStats._framesDropped;
             upstreamStats["lost%"] = streamStats._packetStreamStats.getLostRate() * 100.0f;
             upstreamStats["lost%_30s"] = streamStats._packetStreamWindowStats.getLostRate() * 100.0f;
@@ -15,10 +15,13 @@
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
+#include <AudioConstants.h>
 #include <AudioFormat.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioBuffer.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioFilter.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioFilterBank.h> // For AudioFilterHSF1s and _penumbraFilter
+#include <AudioHRTF.h>
+#include <plugins/CodecPlugin.h>
 
 #include "PositionalAudioStream.h"
 #include "AvatarAudioStream.h"
@@ -29,9 +32,11 @@ public:
         _penumbraFilter.initialize(AudioConstants::SAMPLE_RATE, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
     };
     AudioFilterHSF1s& getPenumbraFilter() { return _penumbraFilter; }
+    AudioHRTFFilter& getHRTFFilter() { return _hrtfFilter; }
 
 private:
     AudioFilterHSF1s _penumbraFilter;
+    AudioHRTFFilter _hrtfFilter;
 };
 
 class AudioMixerClientData : public NodeData {
@@ -58,6 +63,18 @@ public:
     void printUpstreamDownstreamStats() const;
 
     PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID);
+
+    // the mix prepared for this listener in the current frame, written by one AudioMixer worker before it is sent
+    int16_t* getMixedSamples() { return _mixedSamples; }
+    int getStreamsMixed() const { return _streamsMixed; }
+    void setStreamsMixed(int streamsMixed) { _streamsMixed = streamsMixed; }
+
+    // the codec negotiated with this node, used to decode its mic stream and to encode the mix we send it
+    void setupCodec(CodecPluginPointer codec, const QString& codecName);
+    void cleanupCodec();
+    const QString& getSelectedCodecName() const { return _selectedCodecName; }
+    bool hasEncoder() const { return _encoder != nullptr; }
+    void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer);
 private:
     void printAudioStreamStats(const AudioStreamStats& streamStats) const;
 
@@ -69,6 +86,13 @@ private:
 
     quint16 _outgoingMixedAudioSequenceNumber;
 
+    int16_t _mixedSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    int _streamsMixed;
+
+    CodecPluginPointer _codec;
+    QString _selectedCodecName;
+    Encoder* _encoder { nullptr };
+
     AudioStreamStats _downstreamAudioStreamStats;
 };
 
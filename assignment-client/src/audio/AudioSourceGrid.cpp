@@ -0,0 +1,47 @@
+//
+//  AudioSourceGrid.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSourceGrid.h"
+
+// cells never get smaller than this, so that quiet frames don't split the domain into tiny buckets
+const float MIN_CELL_SIZE = 4.0f;
+
+// sources heard further than this are not bucketed, every listener visits them
+const float MAX_CELL_SIZE = 128.0f;
+
+void AudioSourceGrid::clear() {
+    _sources.resize(0);
+    _cells.clear();
+    _unboundedSources.resize(0);
+}
+
+void AudioSourceGrid::build() {
+    _cells.clear();
+    _unboundedSources.resize(0);
+
+    // the cells are as large as the furthest reaching bucketed source, which lets a listener stop at its neighbours
+    float largestRadius = 0.0f;
+    foreach (const Source& source, _sources) {
+        if (source.audibleRadius <= MAX_CELL_SIZE) {
+            largestRadius = glm::max(largestRadius, source.audibleRadius);
+        }
+    }
+    _cellSize = glm::clamp(largestRadius, MIN_CELL_SIZE, MAX_CELL_SIZE);
+
+    for (int i = 0; i < _sources.size(); ++i) {
+        const Source& source = _sources[i];
+
+        if (source.audibleRadius > _cellSize) {
+            _unboundedSources.append(i);
+        } else {
+            _cells[cellKey(cellCoordinate(source.position.x), cellCoordinate(source.position.z))].append(i);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+//
+//  AudioSourceGrid.h
+//  assignment-client/src/audio
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSourceGrid_h
+#define hifi_AudioSourceGrid_h
+
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+class Node;
+class PositionalAudioStream;
+
+/// Per-frame spatial index of the audio streams that can be mixed, bucketed on the horizontal (XZ) plane.
+/// Each source carries the radius beyond which it cannot be heard, so a listener only has to visit the
+/// sources of the cells around it instead of every stream in the domain.
+class AudioSourceGrid {
+public:
+    struct Source {
+        Node* node;
+        PositionalAudioStream* stream;
+        QUuid streamUUID;
+        glm::vec3 position;
+        float audibleRadius;
+        int clusterIndex; // shared far mix this stream is part of, or -1
+        int hrtfInputIndex; // spectrum of this stream in the frame's HRTF inputs, or -1
+    };
+
+    /// drops the sources of the previous frame
+    void clear();
+
+    /// sources are collected first, build() then sizes the cells to fit them
+    void addSource(const Source& source) { _sources.append(source); }
+
+    /// buckets every added source, call once all sources of the frame have been added
+    void build();
+
+    /// calls the visitor with each source that may be audible at the given position.
+    /// sources are not filtered by distance here, the visitor is still expected to run its own audibility test.
+    template<typename Visitor>
+    void forEachSourceAudibleAt(const glm::vec3& position, Visitor visitor) const;
+
+    const QVector<Source>& getSources() const { return _sources; }
+    int getNumSources() const { return _sources.size(); }
+    float getCellSize() const { return _cellSize; }
+
+private:
+    quint64 cellKey(int x, int z) const { return ((quint64)(quint32)x << 32) | (quint32)z; }
+    int cellCoordinate(float value) const { return (int)glm::floor(value / _cellSize); }
+
+    QVector<Source> _sources;
+
+    // indices into _sources, by cell
+    QHash<quint64, QVector<int>> _cells;
+
+    // sources that are heard further than the largest cell we are willing to use, visited for every listener
+    QVector<int> _unboundedSources;
+
+    float _cellSize { 1.0f };
+};
+
+template<typename Visitor>
+void AudioSourceGrid::forEachSourceAudibleAt(const glm::vec3& position, Visitor visitor) const {
+    foreach (int index, _unboundedSources) {
+        visitor(_sources[index]);
+    }
+
+    // every bucketed source has an audible radius no larger than a cell, so the neighbouring cells cover them all
+    int centerX = cellCoordinate(position.x);
+    int centerZ = cellCoordinate(position.z);
+
+    for (int x = centerX - 1; x <= centerX + 1; ++x) {
+        for (int z = centerZ - 1; z <= centerZ + 1; ++z) {
+            auto cell = _cells.constFind(cellKey(x, z));
+            if (cell != _cells.constEnd()) {
+                foreach (int index, cell.value()) {
+                    visitor(_sources[index]);
+                }
+            }
+        }
+    }
+}
+
+#endif // hifi_AudioSourceGrid_h
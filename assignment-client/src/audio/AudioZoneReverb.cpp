@@ -0,0 +1,87 @@
+//
+//  AudioZoneReverb.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioZoneReverb.h"
+
+#include <string.h>
+
+#include <glm/glm.hpp>
+
+#include <AudioEffectOptions.h>
+
+#ifdef WIN32
+#pragma warning (push)
+#pragma warning (disable: 4273 4305)
+#endif
+
+extern "C" {
+    #include <gverb/gverb.h>
+    #include <gverb/gverbdsp.h>
+}
+
+#ifdef WIN32
+#pragma warning (pop)
+#endif
+
+AudioZoneReverb::AudioZoneReverb(float reverbTime) {
+    // the same room as the zone reverb of the clients, only the decay time comes from the zone
+    AudioEffectOptions options;
+    options.setReverbTime(reverbTime);
+
+    _gverb = gverb_new(AudioConstants::SAMPLE_RATE, options.getMaxRoomSize(), options.getRoomSize(),
+                       options.getReverbTime(), options.getDamping(), options.getSpread(),
+                       options.getInputBandwidth(), options.getEarlyLevel(), options.getTailLevel());
+    gverb_set_earlylevel(_gverb, DB_CO(options.getEarlyLevel()));
+    gverb_set_taillevel(_gverb, DB_CO(options.getTailLevel()));
+
+    beginFrame();
+    memset(_wetSamples, 0, sizeof(_wetSamples));
+}
+
+AudioZoneReverb::~AudioZoneReverb() {
+    gverb_free(_gverb);
+}
+
+void AudioZoneReverb::beginFrame() {
+    memset(_input, 0, sizeof(_input));
+}
+
+void AudioZoneReverb::addStream(AudioRingBuffer::ConstIterator samples, bool isStereo, float gain) {
+    if (!isStereo) {
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+            _input[i] += *samples * gain;
+            ++samples;
+        }
+    } else {
+        float downmixGain = gain * 0.5f;
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+            float left = *samples;
+            ++samples;
+            _input[i] += (left + *samples) * downmixGain;
+            ++samples;
+        }
+    }
+}
+
+void AudioZoneReverb::process() {
+    float left, right;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+        gverb_do(_gverb, _input[i], &left, &right);
+        _wetSamples[2 * i] = (int16_t)glm::clamp((int)left, AudioConstants::MIN_SAMPLE_VALUE,
+                                                 AudioConstants::MAX_SAMPLE_VALUE);
+        _wetSamples[2 * i + 1] = (int16_t)glm::clamp((int)right, AudioConstants::MIN_SAMPLE_VALUE,
+                                                     AudioConstants::MAX_SAMPLE_VALUE);
+    }
+}
+
+void AudioZoneReverb::flush() {
+    gverb_flush(_gverb);
+    memset(_wetSamples, 0, sizeof(_wetSamples));
+}
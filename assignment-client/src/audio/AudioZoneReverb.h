@@ -0,0 +1,50 @@
+//
+//  AudioZoneReverb.h
+//  assignment-client/src/audio
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioZoneReverb_h
+#define hifi_AudioZoneReverb_h
+
+#include <AudioConstants.h>
+#include <AudioRingBuffer.h>
+
+typedef struct ty_gverb ty_gverb;
+
+/// The reverb of one audio zone, run once per frame on the streams inside the zone. The wet output is the same for
+/// every listener in the zone, each of them only scales it by its own wet level.
+class AudioZoneReverb {
+public:
+    AudioZoneReverb(float reverbTime);
+    ~AudioZoneReverb();
+
+    /// zeroes the input of the reverb for a new frame
+    void beginFrame();
+
+    /// adds the frame of a stream to the input, downmixed to mono
+    void addStream(AudioRingBuffer::ConstIterator samples, bool isStereo, float gain);
+
+    /// runs the reverb on the input, then the wet samples are ready
+    void process();
+
+    /// drops the tail once no one is left in the zone to hear it
+    void flush();
+
+    const int16_t* getWetSamples() const { return _wetSamples; }
+
+private:
+    // the gverb instance keeps pointers into itself, it can't be copied
+    AudioZoneReverb(const AudioZoneReverb&);
+    AudioZoneReverb& operator=(const AudioZoneReverb&);
+
+    ty_gverb* _gverb;
+    float _input[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    int16_t _wetSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+};
+
+#endif // hifi_AudioZoneReverb_h
@@ -44,6 +44,11 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
                                            ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
                                            : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
             _isStereo = isStereo;
+
+            // the decoder is built for a channel count, so it has to follow the stream
+            if (_codec) {
+                setupCodec(_codec, _selectedCodecName, isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
+            }
         }
 
         // read the positional data
@@ -51,7 +56,7 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         
         // calculate how many samples are in this packet
         int numAudioBytes = packetAfterSeqNum.size() - readBytes;
-        numAudioSamples = numAudioBytes / sizeof(int16_t);
+        numAudioSamples = networkSamplesForAudioBytes(numAudioBytes);
     }
 
     return readBytes;
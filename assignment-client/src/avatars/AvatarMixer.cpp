@@ -9,19 +9,22 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cfloat>
 #include <random>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
-#include <QtCore/QTimer>
 #include <QtCore/QThread>
 
+#include <GLMHelpers.h>
 #include <LogHandler.h>
+#include <Metrics.h>
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
+#include <Trace.h>
 #include <UUID.h>
 #include <TryLocker.h>
 
@@ -30,8 +33,33 @@
 
 const QString AVATAR_MIXER_LOGGING_NAME = "avatar-mixer";
 
-const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 60;
-const unsigned int AVATAR_DATA_SEND_INTERVAL_MSECS = (1.0f / (float) AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) * 1000;
+// clients play avatars back through a buffer of their poses, so a lower rate costs smoothness only past its delay
+const int DEFAULT_AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 60;
+const int MIN_AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 10;
+const int MAX_AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 90;
+
+const int DEFAULT_NUM_BROADCAST_WORKERS = 1;
+const int MAX_NUM_BROADCAST_WORKERS = 32;
+
+static const auto broadcastFramesMetric = MetricsRegistry::counter("hifi_avatar_mixer_frames_total",
+                                                                   "Frames the avatar mixer has broadcast.");
+static const auto broadcastListenersMetric = MetricsRegistry::gauge("hifi_avatar_mixer_listeners",
+                                                                    "Listeners sent avatar data in the last frame.");
+static const auto broadcastMsecsMetric = MetricsRegistry::histogram("hifi_avatar_mixer_frame_msecs",
+                                                                    "Time taken to broadcast a frame, in msecs.",
+                                                                    { 0.5, 1.0, 2.0, 5.0, 10.0, 20.0 });
+
+/// Builds the packets of one worker's share of listeners on a thread of the AvatarMixer's pool
+class AvatarMixerJob : public QRunnable {
+public:
+    AvatarMixerJob(AvatarMixer* mixer, int workerIndex) : _mixer(mixer), _workerIndex(workerIndex) {}
+
+    void run() { _mixer->broadcastToListenersForWorker(_workerIndex); }
+
+private:
+    AvatarMixer* _mixer;
+    int _workerIndex;
+};
 
 AvatarMixer::AvatarMixer(NLPacket& packet) :
     ThreadedAssignment(packet),
@@ -44,6 +72,8 @@ AvatarMixer::AvatarMixer(NLPacket& packet) :
     _sumBillboardPackets(0),
     _sumIdentityPackets(0)
 {
+    setNumBroadcastWorkers(DEFAULT_NUM_BROADCAST_WORKERS);
+
     // make sure we hear about node kills so we can tell the other nodes
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::nodeKilled);
 
@@ -55,9 +85,7 @@ AvatarMixer::AvatarMixer(NLPacket& packet) :
 }
 
 AvatarMixer::~AvatarMixer() {
-    if (_broadcastTimer) {
-        _broadcastTimer->deleteLater();
-    }
+    _isBroadcasting = false;
 
     _broadcastThread.quit();
     _broadcastThread.wait();
@@ -70,10 +98,26 @@ const float BILLBOARD_AND_IDENTITY_SEND_PROBABILITY = 1.0f / 187.0f;
 // NOTE: some additional optimizations to consider.
 //    1) use the view frustum to cull those avatars that are out of view. Since avatar data doesn't need to be present
 //       if the avatar is not in view or in the keyhole.
-void AvatarMixer::broadcastAvatarData() {
+void AvatarMixer::runBroadcastFrames() {
+    if (_frameThreadRealtime) {
+        FrameScheduler::setCurrentThreadRealtime();
+    }
+    if (_frameThreadCPU >= 0) {
+        FrameScheduler::setCurrentThreadCPU(_frameThreadCPU);
+    }
 
-    int idleTime = QDateTime::currentMSecsSinceEpoch() - _lastFrameTimestamp;
+    _frameScheduler.setFrameUsecs(USECS_PER_SECOND / _broadcastFramesPerSecond);
+    _frameScheduler.start();
 
+    while (_isBroadcasting) {
+        broadcastAvatarData();
+        _frameScheduler.waitForNextFrame();
+    }
+}
+
+void AvatarMixer::broadcastAvatarData() {
+    TRACE_ZONE("AvatarMixer::broadcastAvatarData");
+    quint64 broadcastStart = usecTimestampNow();
     ++_numStatFrames;
 
     const float STRUGGLE_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.10f;
@@ -84,16 +128,12 @@ void AvatarMixer::broadcastAvatarData() {
     const int TRAILING_AVERAGE_FRAMES = 100;
     int framesSinceCutoffEvent = TRAILING_AVERAGE_FRAMES;
 
-    const float CURRENT_FRAME_RATIO = 1.0f / TRAILING_AVERAGE_FRAMES;
-    const float PREVIOUS_FRAMES_RATIO = 1.0f - CURRENT_FRAME_RATIO;
-
     // NOTE: The following code calculates the _performanceThrottlingRatio based on how much the avatar-mixer was
     // able to sleep. This will eventually be used to ask for an additional avatar-mixer to help out. Currently the value
     // is unused as it is assumed this should not be hit before the avatar-mixer hits the desired bandwidth limit per client.
     // It is reported in the domain-server stats for the avatar-mixer.
 
-    _trailingSleepRatio = (PREVIOUS_FRAMES_RATIO * _trailingSleepRatio)
-        + (idleTime * CURRENT_FRAME_RATIO / (float) AVATAR_DATA_SEND_INTERVAL_MSECS);
+    _trailingSleepRatio = _frameScheduler.getTrailingSleepRatio();
 
     float lastCutoffRatio = _performanceThrottlingRatio;
     bool hasRatioChanged = false;
@@ -130,263 +170,335 @@ void AvatarMixer::broadcastAvatarData() {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
-    // setup for distributed random floating point values
-    std::random_device randomDevice;
-    std::mt19937 generator(randomDevice());
-    std::uniform_real_distribution<float> distribution;
+    _frameSources.resize(0);
+    _frameListeners.resize(0);
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-            if (!node->getLinkedData()) {
-                return false;
-            }
-            if (node->getType() != NodeType::Agent) {
-                return false;
-            }
-            if (!node->getActiveSocket()) {
-                return false;
-            }
-            return true;
-        },
-        [&](const SharedNodePointer& node) {
-            AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
-            MutexTryLocker lock(nodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
-            }
-            ++_sumListeners;
+    // grab the node snapshot once for the frame, no node list lock is taken while we go through it. The data of each node
+    // stays locked until the frame is done so that the workers can read every avatar without locking it again for each listener.
+    NodeSnapshotPointer nodes = nodeList->getNodeSnapshot();
+    for (const SharedNodePointer& node : *nodes) {
+        AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+        if (!nodeData || !nodeData->getMutex().tryLock()) {
+            continue;
+        }
 
-            AvatarData& avatar = nodeData->getAvatar();
-            glm::vec3 myPosition = avatar.getPosition();
+        _frameSources.append(node);
 
-            // reset the internal state for correct random number distribution
-            distribution.reset();
+        if (node->getType() == NodeType::Agent && node->getActiveSocket()) {
+            _frameListeners.append(node);
+        }
+    }
 
-            // reset the max distance for this frame
-            float maxAvatarDistanceThisFrame = 0.0f;
+    // pack each avatar once for the frame, the workers only copy these encodings into their packet lists
+    AvatarDataDetail lowestDetail = getDataDetailForDistance(FLT_MAX);
+    foreach (const SharedNodePointer& node, _frameSources) {
+        AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+        nodeData->encodeFrameAvatarData(node->getUUID(), lowestDetail);
+    }
 
-            // reset the number of sent avatars
-            nodeData->resetNumAvatarsSentLastFrame();
+    _frameListenerPackets.clear();
+    _frameListenerPackets.resize(_frameListeners.size());
 
-            // keep a counter of the number of considered avatars
-            int numOtherAvatars = 0;
+    for (int i = 1; i < _broadcastWorkers.size(); ++i) {
+        _broadcastThreadPool.start(new AvatarMixerJob(this, i));
+    }
+    broadcastToListenersForWorker(0);
 
-            // keep track of outbound data rate specifically for avatar data
-            int numAvatarDataBytes = 0;
+    // barrier - every worker must be done before the packets go out and the avatars are unlocked
+    _broadcastThreadPool.waitForDone();
 
-            // keep track of the number of other avatars held back in this frame
-            int numAvatarsHeldBack = 0;
+    for (int i = 0; i < _frameListeners.size(); ++i) {
+        const SharedNodePointer& node = _frameListeners[i];
+        AvatarMixerListenerPackets& listenerPackets = _frameListenerPackets[i];
 
-            // keep track of the number of other avatar frames skipped
-            int numAvatarsWithSkippedFrames = 0;
+        for (auto& packet : listenerPackets.packets) {
+            nodeList->sendPacket(std::move(packet), *node);
+        }
 
-            // use the data rate specifically for avatar data for FRD adjustment checks
-            float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
+        // send the avatar data PacketList
+        nodeList->sendPacketList(std::move(listenerPackets.avatarPacketList), *node);
+    }
 
-            // Check if it is time to adjust what we send this client based on the observed
-            // bandwidth to this node. We do this once a second, which is also the window for
-            // the bandwidth reported by node->getOutboundBandwidth();
-            if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
+    for (int i = 0; i < _broadcastWorkers.size(); ++i) {
+        AvatarMixerWorkerData& worker = _broadcastWorkers[i];
 
-                const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
-                const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
-                const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
+        _sumListeners += worker.sumListeners;
+        _sumBillboardPackets += worker.sumBillboardPackets;
+        _sumIdentityPackets += worker.sumIdentityPackets;
 
-                // get the current full rate distance so we can work with it
-                float currentFullRateDistance = nodeData->getFullRateDistance();
+        worker.sumListeners = 0;
+        worker.sumBillboardPackets = 0;
+        worker.sumIdentityPackets = 0;
+    }
 
-                if (avatarDataRateLastSecond > _maxKbpsPerNode) {
+    // We're done encoding this version of the otherAvatars.  Update their "lastSent" joint-states so
+    // that we can notice differences, next time around.
+    foreach (const SharedNodePointer& otherNode, _frameSources) {
+        AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
 
-                    // is the FRD greater than the farthest avatar?
-                    // if so, before we calculate anything, set it to that distance
-                    currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
+        if (otherNode->getType() == NodeType::Agent && otherNode->getActiveSocket()) {
+            otherNodeData->getAvatar().doneEncoding(false);
+        }
 
-                    // we're adjusting the full rate distance to target a bandwidth in the middle
-                    // of the hysterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+        otherNodeData->getMutex().unlock();
+    }
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
-                           && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
-                    // we are constrained AND we've recovered to below the acceptable ratio
-                    // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+    broadcastFramesMetric->increment();
+    broadcastListenersMetric->set(_frameListeners.size());
+    broadcastMsecsMetric->observe((double)(usecTimestampNow() - broadcastStart) / USECS_PER_MSEC);
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                }
-            } else {
-                nodeData->incrementNumFramesSinceFRDAdjustment();
-            }
+    // don't hold on to nodes that may be killed before the next frame
+    _frameSources.resize(0);
+    _frameListeners.resize(0);
+    _frameListenerPackets.clear();
 
-            // setup a PacketList for the avatarPackets
-            auto avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
+    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
 
-            // this is an AGENT we have received head data from
-            // send back a packet with other active node data to this node
-            nodeList->eachMatchingNode(
-                [&](const SharedNodePointer& otherNode)->bool {
-                    if (!otherNode->getLinkedData()) {
-                        return false;
-                    }
-                    if (otherNode->getUUID() == node->getUUID()) {
-                        return false;
-                    }
+void AvatarMixer::broadcastToListenersForWorker(int workerIndex) {
+    AvatarMixerWorkerData& worker = _broadcastWorkers[workerIndex];
+    int numWorkers = _broadcastWorkers.size();
 
-                    return true;
-                },
-                [&](const SharedNodePointer& otherNode) {
-                    ++numOtherAvatars;
+    for (int i = workerIndex; i < _frameListeners.size(); i += numWorkers) {
+        prepareAvatarDataForListener(worker, _frameListeners[i], _frameListenerPackets[i]);
+    }
+}
 
-                    AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-                    MutexTryLocker lock(otherNodeData->getMutex());
-                    if (!lock.isLocked()) {
-                        return;
-                    }
+AvatarDataDetail AvatarMixer::getDataDetailForDistance(float distanceToAvatar) const {
+    if (_transformOnlyDistance > 0.0f && distanceToAvatar > _transformOnlyDistance) {
+        return TRANSFORM_ONLY_DATA;
+    } else if (_rootAndHeadDistance > 0.0f && distanceToAvatar > _rootAndHeadDistance) {
+        return ROOT_AND_HEAD_JOINTS_DATA;
+    } else if (_majorJointsDistance > 0.0f && distanceToAvatar > _majorJointsDistance) {
+        return MAJOR_JOINTS_DATA;
+    } else {
+        return CHANGED_JOINTS_DATA;
+    }
+}
 
-                    // if an avatar has just connected make sure we send out the mesh and billboard
-                    bool forceSend = !nodeData->checkAndSetHasReceivedFirstPackets()
-                        || !otherNodeData->checkAndSetHasReceivedFirstPacketsFrom(node->getUUID());
+float AvatarMixer::calculateSendPriority(const glm::vec3& listenerPosition, const glm::vec3& listenerForward,
+                                         const glm::vec3& avatarPosition, quint64 timeSinceLastSend) const {
+    // avatars within this distance are scored as if they were at it, so that the nearest ones don't starve the rest
+    const float MIN_PRIORITY_DISTANCE = 1.0f;
 
-                    // we will also force a send of billboard or identity packet
-                    // if either has changed in the last frame
-                    if (otherNodeData->getBillboardChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
-                            || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+    // avatars outside of the listener's view are sent less often, they still need updates for audio and turning around
+    const float OUT_OF_VIEW_PRIORITY_RATIO = 0.25f;
+    const float VIEW_CONE_HALF_ANGLE = PI / 3.0f;
+    static const float VIEW_CONE_COS_HALF_ANGLE = cosf(VIEW_CONE_HALF_ANGLE);
 
-                        QByteArray rfcUUID = otherNode->getUUID().toRfc4122();
-                        QByteArray billboard = otherNodeData->getAvatar().getBillboard();
+    glm::vec3 offset = avatarPosition - listenerPosition;
+    float distance = glm::length(offset);
 
-                        auto billboardPacket = NLPacket::create(PacketType::AvatarBillboard, rfcUUID.size() + billboard.size());
-                        billboardPacket->write(rfcUUID);
-                        billboardPacket->write(billboard);
+    // the priority grows with the time the listener has been waiting for this avatar, so every avatar gets its turn
+    float priority = ((float) timeSinceLastSend / (float) USECS_PER_SECOND) / glm::max(distance, MIN_PRIORITY_DISTANCE);
 
-                        nodeList->sendPacket(std::move(billboardPacket), *node);
+    if (distance > MIN_PRIORITY_DISTANCE && glm::dot(offset / distance, listenerForward) < VIEW_CONE_COS_HALF_ANGLE) {
+        priority *= OUT_OF_VIEW_PRIORITY_RATIO;
+    }
 
-                        ++_sumBillboardPackets;
-                    }
+    return priority;
+}
 
-                    if (otherNodeData->getIdentityChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
-                            || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+void AvatarMixer::prepareAvatarDataForListener(AvatarMixerWorkerData& worker, const SharedNodePointer& node,
+                                               AvatarMixerListenerPackets& listenerPackets) {
+    AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+    ++worker.sumListeners;
 
-                        QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
+    AvatarData& avatar = nodeData->getAvatar();
+    glm::vec3 myPosition = avatar.getPosition();
+    glm::vec3 myForward = avatar.getHeadOrientation() * IDENTITY_FRONT;
 
-                        auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size());
+    quint64 now = usecTimestampNow();
 
-                        individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
+    // setup for distributed random floating point values
+    std::uniform_real_distribution<float> distribution;
 
-                        identityPacket->write(individualData);
+    // reset the max distance for this frame
+    float maxAvatarDistanceThisFrame = 0.0f;
 
-                        nodeList->sendPacket(std::move(identityPacket), *node);
+    // reset the number of sent avatars
+    nodeData->resetNumAvatarsSentLastFrame();
 
-                        ++_sumIdentityPackets;
-                    }
+    // keep a counter of the number of considered avatars
+    int numOtherAvatars = 0;
 
-                    AvatarData& otherAvatar = otherNodeData->getAvatar();
-                    //  Decide whether to send this avatar's data based on it's distance from us
+    // keep track of outbound data rate specifically for avatar data
+    int numAvatarDataBytes = 0;
 
-                    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
-                    //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
-                    glm::vec3 otherPosition = otherAvatar.getPosition();
-                    float distanceToAvatar = glm::length(myPosition - otherPosition);
+    // keep track of the number of other avatars held back in this frame
+    int numAvatarsHeldBack = 0;
 
-                    // potentially update the max full rate distance for this frame
-                    maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+    // keep track of the number of other avatar frames skipped
+    int numAvatarsWithSkippedFrames = 0;
 
-                    if (distanceToAvatar != 0.0f
-                        && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
-                        return;
-                    }
+    // keep track of the avatars that had new data but did not fit in the budget of this frame
+    int numAvatarsOverBudget = 0;
 
-                    AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
-                    AvatarDataSequenceNumber lastSeqFromSender = otherNodeData->getLastReceivedSequenceNumber();
+    // the share of the per node bandwidth that this frame can spend on avatar data
+    int maxAvatarDataBytes = (int) (_maxKbpsPerNode * BYTES_PER_KILOBIT / _broadcastFramesPerSecond);
 
-                    if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
-                        // we got out out of order packets from the sender, track it
-                        otherNodeData->incrementNumOutOfOrderSends();
-                    }
+    std::vector<AvatarMixerSendCandidate>& sendCandidates = worker.sendCandidates;
+    sendCandidates.clear();
 
-                    // make sure we haven't already sent this data from this sender to this receiver
-                    // or that somehow we haven't sent
-                    if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
-                        ++numAvatarsHeldBack;
-                        return;
-                    } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
-                        // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
-                        ++numAvatarsWithSkippedFrames;
-                    }
+    // this is an AGENT we have received head data from
+    // send back a packet with other active node data to this node
+    // (broadcastAvatarData holds the lock of every source for the whole frame)
+    for (int sourceIndex = 0; sourceIndex < _frameSources.size(); ++sourceIndex) {
+        const SharedNodePointer& otherNode = _frameSources[sourceIndex];
+        if (otherNode->getUUID() == node->getUUID()) {
+            continue;
+        }
 
-                    // we're going to send this avatar
+        ++numOtherAvatars;
 
-                    // increment the number of avatars sent to this reciever
-                    nodeData->incrementNumAvatarsSentLastFrame();
+        AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
 
-                    // set the last sent sequence number for this sender on the receiver
-                    nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(),
-                                                             otherNodeData->getLastReceivedSequenceNumber());
+        // if an avatar has just connected make sure we send out the mesh and billboard
+        bool forceSend = !nodeData->checkAndSetHasReceivedFirstPackets()
+            || !nodeData->checkAndSetHasReceivedFirstPacketsFrom(otherNode->getUUID());
 
-                    // start a new segment in the PacketList for this avatar
-                    avatarPacketList->startSegment();
+        // we will also force a send of billboard or identity packet
+        // if either has changed in the last frame
+        if (otherNodeData->getBillboardChangeTimestamp() > 0
+            && (forceSend
+                || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
+                || distribution(worker.generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
 
-                    numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
-                    numAvatarDataBytes +=
-                        avatarPacketList->write(otherAvatar.toByteArray(false, distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO));
+            QByteArray rfcUUID = otherNode->getUUID().toRfc4122();
+            QByteArray billboard = otherNodeData->getAvatar().getBillboard();
 
-                    avatarPacketList->endSegment();
-            });
+            auto billboardPacket = NLPacket::create(PacketType::AvatarBillboard, rfcUUID.size() + billboard.size());
+            billboardPacket->write(rfcUUID);
+            billboardPacket->write(billboard);
 
-            // close the current packet so that we're always sending something
-            avatarPacketList->closeCurrentPacket(true);
+            listenerPackets.packets.push_back(std::move(billboardPacket));
 
-            // send the avatar data PacketList
-            nodeList->sendPacketList(std::move(avatarPacketList), *node);
+            ++worker.sumBillboardPackets;
+        }
 
-            // record the bytes sent for other avatar data in the AvatarMixerClientData
-            nodeData->recordSentAvatarData(numAvatarDataBytes);
+        if (otherNodeData->getIdentityChangeTimestamp() > 0
+            && (forceSend
+                || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
+                || distribution(worker.generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
 
-            // record the number of avatars held back this frame
-            nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
-            nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+            QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
 
-            if (numOtherAvatars == 0) {
-                // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
-                nodeData->setMaxAvatarDistance(FLT_MAX);
-            } else {
-                nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
-            }
+            auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size());
+
+            individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
+
+            identityPacket->write(individualData);
+
+            listenerPackets.packets.push_back(std::move(identityPacket));
+
+            ++worker.sumIdentityPackets;
         }
-    );
 
-    // We're done encoding this version of the otherAvatars.  Update their "lastSent" joint-states so
-    // that we can notice differences, next time around.
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& otherNode)->bool {
-            if (!otherNode->getLinkedData()) {
-                return false;
-            }
-            if (otherNode->getType() != NodeType::Agent) {
-                return false;
-            }
-            if (!otherNode->getActiveSocket()) {
-                return false;
-            }
-            return true;
-        },
-        [&](const SharedNodePointer& otherNode) {
-            AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-            MutexTryLocker lock(otherNodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
-            }
-            AvatarData& otherAvatar = otherNodeData->getAvatar();
-            otherAvatar.doneEncoding(false);
-        });
+        glm::vec3 otherPosition = otherNodeData->getAvatar().getPosition();
+        float distanceToAvatar = glm::length(myPosition - otherPosition);
 
-    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+        // potentially update the max distance for this frame
+        maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+
+        AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
+        AvatarDataSequenceNumber lastSeqFromSender = otherNodeData->getLastReceivedSequenceNumber();
+
+        if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
+            // we got out out of order packets from the sender, track it
+            otherNodeData->incrementNumOutOfOrderSends();
+        }
+
+        // make sure we haven't already sent this data from this sender to this receiver
+        // or that somehow we haven't sent
+        if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
+            ++numAvatarsHeldBack;
+            continue;
+        }
+
+        // this avatar has new data for the listener, score it so the budget goes to the avatars that need it most
+        quint64 lastBroadcastTime = nodeData->getLastBroadcastTime(otherNode->getUUID());
+        float priority = (forceSend || lastBroadcastTime == 0)
+            ? FLT_MAX
+            : calculateSendPriority(myPosition, myForward, otherPosition, now - lastBroadcastTime);
+
+        sendCandidates.push_back({ sourceIndex, distanceToAvatar, priority });
+    }
+
+    std::sort(sendCandidates.begin(), sendCandidates.end());
+
+    // setup a PacketList for the avatarPackets
+    auto avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
+
+    for (const AvatarMixerSendCandidate& candidate : sendCandidates) {
+        const SharedNodePointer& otherNode = _frameSources[candidate.sourceIndex];
+        AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
+
+        // far away avatars only get their joints with the occasional full update
+        bool sendFullUpdate = distribution(worker.generator) < AVATAR_SEND_FULL_UPDATE_RATIO;
+        AvatarDataDetail dataDetail = sendFullUpdate ? ALL_JOINTS_DATA : getDataDetailForDistance(candidate.distance);
+
+        // the UUID and avatar data were packed once for this frame, this is only a copy
+        const QByteArray& avatarData = otherNodeData->getFrameAvatarData(dataDetail);
+
+        // the most urgent avatar always goes out, the others only while they fit in this frame's budget
+        // (a smaller encoding further down the queue may still fit after a large one didn't)
+        if (numAvatarDataBytes > 0 && numAvatarDataBytes + avatarData.size() > maxAvatarDataBytes) {
+            ++numAvatarsOverBudget;
+            continue;
+        }
+
+        AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
+        AvatarDataSequenceNumber lastSeqFromSender = otherNodeData->getLastReceivedSequenceNumber();
+        if (lastSeqFromSender - lastSeqToReceiver > 1) {
+            // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
+            ++numAvatarsWithSkippedFrames;
+        }
+
+        // we're going to send this avatar
+
+        // increment the number of avatars sent to this reciever
+        nodeData->incrementNumAvatarsSentLastFrame();
+
+        // set the last sent sequence number and time for this sender on the receiver
+        nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(), lastSeqFromSender);
+        nodeData->setLastBroadcastTime(otherNode->getUUID(), now);
+
+        // start a new segment in the PacketList for this avatar
+        avatarPacketList->startSegment();
+        numAvatarDataBytes += avatarPacketList->write(avatarData);
+        avatarPacketList->endSegment();
+    }
+
+    // close the current packet so that we're always sending something
+    avatarPacketList->closeCurrentPacket(true);
+
+    // the broadcast thread sends the avatar data PacketList once every worker is done
+    listenerPackets.avatarPacketList = std::move(avatarPacketList);
+
+    // record the bytes sent for other avatar data in the AvatarMixerClientData
+    nodeData->recordSentAvatarData(numAvatarDataBytes);
+
+    // record the number of avatars held back this frame
+    nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
+    nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+    nodeData->recordNumAvatarsOverBudget(numAvatarsOverBudget);
+    nodeData->recordAvatarSends(nodeData->getNumAvatarsSentLastFrame(), numOtherAvatars);
+
+    if (numOtherAvatars == 0) {
+        // update the max distance to FLOAT_MAX since we didn't have any other avatars to send
+        nodeData->setMaxAvatarDistance(FLT_MAX);
+    } else {
+        nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
+    }
+}
+
+void AvatarMixer::setNumBroadcastWorkers(int numBroadcastWorkers) {
+    numBroadcastWorkers = glm::clamp(numBroadcastWorkers, 1, MAX_NUM_BROADCAST_WORKERS);
+
+    _broadcastWorkers.resize(numBroadcastWorkers);
+
+    // worker 0 runs on the broadcast thread, the pool only needs threads for the others
+    _broadcastThreadPool.setMaxThreadCount(qMax(numBroadcastWorkers - 1, 1));
 }
 
 void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
@@ -426,8 +538,7 @@ void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
 }
 
 void AvatarMixer::handleAvatarDataPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
-    auto nodeList = DependencyManager::get<NodeList>();
-    nodeList->updateNodeWithDataFromPacket(packet, senderNode);
+    DependencyManager::getRaw<NodeList>()->updateNodeWithDataFromPacket(packet, senderNode);
 }
 
 void AvatarMixer::handleAvatarIdentityPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
@@ -472,6 +583,7 @@ void AvatarMixer::sendStatsPacket() {
 
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
+    statsObject["frame_scheduler"] = _frameScheduler.takeStatsObject();
 
     QJsonObject avatarsObject;
 
@@ -523,14 +635,8 @@ void AvatarMixer::run() {
         node->setLinkedData(new AvatarMixerClientData());
     };
 
-    // setup the timer that will be fired on the broadcast thread
-    _broadcastTimer = new QTimer;
-    _broadcastTimer->setInterval(AVATAR_DATA_SEND_INTERVAL_MSECS);
-    _broadcastTimer->moveToThread(&_broadcastThread);
-
-    // connect appropriate signals and slots
-    connect(_broadcastTimer, &QTimer::timeout, this, &AvatarMixer::broadcastAvatarData, Qt::DirectConnection);
-    connect(&_broadcastThread, SIGNAL(started()), _broadcastTimer, SLOT(start()));
+    // the broadcast frames run on their own thread, from when it starts until the mixer is destroyed
+    connect(&_broadcastThread, &QThread::started, this, &AvatarMixer::runBroadcastFrames, Qt::DirectConnection);
 
     // wait until we have the domain-server settings, otherwise we bail
     DomainHandler& domainHandler = nodeList->getDomainHandler();
@@ -555,6 +661,7 @@ void AvatarMixer::run() {
     parseDomainServerSettings(domainHandler.getSettingsObject());
 
     // start the broadcastThread
+    _isBroadcasting = true;
     _broadcastThread.start();
 }
 
@@ -570,4 +677,61 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
 
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qDebug() << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps.";
+
+    const QString MAJOR_JOINTS_DISTANCE_KEY = "major_joints_distance";
+    QJsonValue majorJointsDistanceValue = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[MAJOR_JOINTS_DISTANCE_KEY];
+    if (majorJointsDistanceValue.isDouble()) {
+        _majorJointsDistance = glm::max((float) majorJointsDistanceValue.toDouble(), 0.0f);
+        qDebug() << "Avatars further than" << _majorJointsDistance << "meters are sent with their major joints only.";
+    }
+
+    const QString ROOT_AND_HEAD_DISTANCE_KEY = "root_and_head_distance";
+    QJsonValue rootAndHeadDistanceValue = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[ROOT_AND_HEAD_DISTANCE_KEY];
+    if (rootAndHeadDistanceValue.isDouble()) {
+        _rootAndHeadDistance = glm::max((float) rootAndHeadDistanceValue.toDouble(), 0.0f);
+        qDebug() << "Avatars further than" << _rootAndHeadDistance << "meters are sent with their root and head joints only.";
+    }
+
+    const QString TRANSFORM_ONLY_DISTANCE_KEY = "transform_only_distance";
+    QJsonValue transformOnlyDistanceValue = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[TRANSFORM_ONLY_DISTANCE_KEY];
+    if (transformOnlyDistanceValue.isDouble()) {
+        _transformOnlyDistance = glm::max((float) transformOnlyDistanceValue.toDouble(), 0.0f);
+        qDebug() << "Avatars further than" << _transformOnlyDistance << "meters are sent without joints between full updates.";
+    }
+
+    const QString BROADCAST_RATE_KEY = "broadcast_rate";
+    QJsonValue broadcastRateValue = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[BROADCAST_RATE_KEY];
+    if (broadcastRateValue.isDouble()) {
+        _broadcastFramesPerSecond = glm::clamp(broadcastRateValue.toInt(DEFAULT_AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND),
+                                               MIN_AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND,
+                                               MAX_AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND);
+    }
+    qDebug() << "Avatar data is broadcast" << _broadcastFramesPerSecond << "times per second.";
+
+    const QString BROADCAST_WORKER_THREADS_KEY = "broadcast_worker_threads";
+    QJsonValue broadcastWorkersValue = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[BROADCAST_WORKER_THREADS_KEY];
+    if (broadcastWorkersValue.isDouble()) {
+        setNumBroadcastWorkers(broadcastWorkersValue.toInt(DEFAULT_NUM_BROADCAST_WORKERS));
+    }
+    qDebug() << "Using" << _broadcastWorkers.size() << "broadcast worker threads.";
+
+    const QString FRAME_THREAD_REALTIME_KEY = "frame_thread_realtime";
+    _frameThreadRealtime = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[FRAME_THREAD_REALTIME_KEY].toBool();
+    if (_frameThreadRealtime) {
+        qDebug() << "The broadcast thread will run with a realtime priority.";
+    }
+
+    const QString FRAME_THREAD_CPU_KEY = "frame_thread_cpu";
+    _frameThreadCPU = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[FRAME_THREAD_CPU_KEY].toInt(-1);
+    if (_frameThreadCPU >= 0) {
+        qDebug() << "The broadcast thread will run on CPU" << _frameThreadCPU;
+    }
+
+    // avatar packets close to the MTU have no room left for the parity header and go out unprotected
+    const QString FEC_GROUP_SIZE_KEY = "fec_group_size";
+    const QString FEC_PARITY_PACKETS_KEY = "fec_parity_packets";
+    int fecGroupSize = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[FEC_GROUP_SIZE_KEY].toInt(0);
+    int fecParityPackets = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[FEC_PARITY_PACKETS_KEY].toInt(1);
+    DependencyManager::get<NodeList>()->setForwardErrorCorrection({ PacketType::BulkAvatarData },
+                                                                  glm::max(fecGroupSize, 0), glm::max(fecParityPackets, 1));
 }
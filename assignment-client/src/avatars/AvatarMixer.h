@@ -15,11 +15,53 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include <AvatarData.h>
+#include <FrameScheduler.h>
+#include <NLPacketList.h>
 #include <ThreadedAssignment.h>
 
+/// An avatar with new data for a listener this frame, listeners are sent their candidates by descending priority
+class AvatarMixerSendCandidate {
+public:
+    int sourceIndex;
+    float distance;
+    float priority;
+
+    bool operator<(const AvatarMixerSendCandidate& other) const { return priority > other.priority; }
+};
+
+/// Random state and stats for one broadcast worker. Each worker owns one of these so listeners can be handled in parallel.
+class AvatarMixerWorkerData {
+public:
+    std::mt19937 generator { std::random_device()() };
+
+    // reused by every listener of the worker to avoid an allocation per listener
+    std::vector<AvatarMixerSendCandidate> sendCandidates;
+
+    int sumListeners { 0 };
+    int sumBillboardPackets { 0 };
+    int sumIdentityPackets { 0 };
+};
+
+/// The packets built for one listener by a broadcast worker, sent from the broadcast thread once every worker is done
+class AvatarMixerListenerPackets {
+public:
+    std::unique_ptr<NLPacketList> avatarPacketList;
+    std::vector<std::unique_ptr<NLPacket>> packets;
+};
+
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
     Q_OBJECT
+    friend class AvatarMixerJob;
 public:
     AvatarMixer(NLPacket& packet);
     ~AvatarMixer();
@@ -38,7 +80,24 @@ private slots:
     void handleKillAvatarPacket(QSharedPointer<NLPacket> packet);
     
 private:
+    /// broadcasts the avatar data at the broadcast rate until the mixer is destroyed, runs on the broadcast thread
+    void runBroadcastFrames();
     void broadcastAvatarData();
+
+    /// builds the packets for every listener of this frame assigned to the given worker
+    void broadcastToListenersForWorker(int workerIndex);
+
+    /// builds the avatar data, billboard and identity packets that one listener should receive this frame
+    void prepareAvatarDataForListener(AvatarMixerWorkerData& worker, const SharedNodePointer& node,
+                                      AvatarMixerListenerPackets& listenerPackets);
+    AvatarDataDetail getDataDetailForDistance(float distanceToAvatar) const;
+
+    /// scores an avatar that has new data for a listener, higher priorities are sent first
+    float calculateSendPriority(const glm::vec3& listenerPosition, const glm::vec3& listenerForward,
+                                const glm::vec3& avatarPosition, quint64 timeSinceLastSend) const;
+
+    void setNumBroadcastWorkers(int numBroadcastWorkers);
+
     void parseDomainServerSettings(const QJsonObject& domainSettings);
     
     QThread _broadcastThread;
@@ -53,9 +112,27 @@ private:
     int _sumBillboardPackets;
     int _sumIdentityPackets;
 
+
+    int _broadcastFramesPerSecond = 60; // frames a second, from the domain settings
     float _maxKbpsPerNode = 0.0f;
+    // past these distances avatars are sent with fewer joints between full updates, zero disables a tier
+    float _majorJointsDistance = 0.0f;
+    float _rootAndHeadDistance = 0.0f;
+    float _transformOnlyDistance = 0.0f;
+
+    // listeners are split across these workers, worker 0 runs on the broadcast thread itself
+    QVector<AvatarMixerWorkerData> _broadcastWorkers;
+    QThreadPool _broadcastThreadPool;
+
+    // the nodes whose data was locked for this frame, and the ones among them that are sent to
+    QVector<SharedNodePointer> _frameSources;
+    QVector<SharedNodePointer> _frameListeners;
+    std::vector<AvatarMixerListenerPackets> _frameListenerPackets;
 
-    QTimer* _broadcastTimer = nullptr;
+    FrameScheduler _frameScheduler;
+    std::atomic<bool> _isBroadcasting { false };
+    bool _frameThreadRealtime = false;
+    int _frameThreadCPU = -1; // negative lets the broadcast thread run on any CPU
 };
 
 #endif // hifi_AvatarMixer_h
@@ -45,14 +45,38 @@ uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& node
     }
 }
 
+quint64 AvatarMixerClientData::getLastBroadcastTime(const QUuid& nodeUUID) const {
+    auto nodeMatch = _lastBroadcastTimes.find(nodeUUID);
+    if (nodeMatch != _lastBroadcastTimes.end()) {
+        return nodeMatch->second;
+    } else {
+        return 0;
+    }
+}
+
+void AvatarMixerClientData::encodeFrameAvatarData(const QUuid& nodeUUID, AvatarDataDetail lowestDetail) {
+    QByteArray rfcUUID = nodeUUID.toRfc4122();
+
+    for (int i = 0; i < NUM_AVATAR_DATA_DETAILS; ++i) {
+        AvatarDataDetail dataDetail = (AvatarDataDetail) i;
+
+        if (dataDetail < lowestDetail) {
+            _frameAvatarData[i].clear();
+        } else {
+            _frameAvatarData[i] = rfcUUID + _avatar.toByteArray(dataDetail, false);
+        }
+    }
+}
+
 void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["display_name"] = _avatar.getDisplayName();
-    jsonObject["full_rate_distance"] = _fullRateDistance;
     jsonObject["max_av_distance"] = _maxAvatarDistance;
     jsonObject["num_avs_sent_last_frame"] = _numAvatarsSentLastFrame;
+    jsonObject["num_avs_over_budget_last_frame"] = _numAvatarsOverBudgetLastFrame;
+    jsonObject["avg_sends_per_av_per_second"] = getAvgSendsPerAvatarPerSecond();
     jsonObject["avg_other_av_starves_per_second"] = getAvgNumOtherAvatarStarvesPerSecond();
     jsonObject["avg_other_av_skips_per_second"] = getAvgNumOtherAvatarSkipsPerSecond();
-    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends;
+    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends.load();
 
     jsonObject[OUTBOUND_AVATAR_DATA_STATS_KEY] = getOutboundAvatarDataKbps();
     jsonObject[INBOUND_AVATAR_DATA_STATS_KEY] = _avatar.getAverageBytesReceivedPerSecond() / (float) BYTES_PER_KILOBIT;
@@ -13,6 +13,7 @@
 #define hifi_AvatarMixerClientData_h
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <unordered_map>
 #include <unordered_set>
@@ -42,7 +43,12 @@ public:
     uint16_t getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const;
     void setLastBroadcastSequenceNumber(const QUuid& nodeUUID, uint16_t sequenceNumber)
         { _lastBroadcastSequenceNumbers[nodeUUID] = sequenceNumber; }
-    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) { _lastBroadcastSequenceNumbers.erase(nodeUUID); }
+    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID)
+        { _lastBroadcastSequenceNumbers.erase(nodeUUID); _lastBroadcastTimes.erase(nodeUUID); }
+
+    /// \return the usecTimestampNow() of the last send of the given avatar to this node, 0 if it was never sent
+    quint64 getLastBroadcastTime(const QUuid& nodeUUID) const;
+    void setLastBroadcastTime(const QUuid& nodeUUID, quint64 broadcastTime) { _lastBroadcastTimes[nodeUUID] = broadcastTime; }
 
     uint16_t getLastReceivedSequenceNumber() const { return _lastReceivedSequenceNumber; }
 
@@ -52,9 +58,6 @@ public:
     quint64 getIdentityChangeTimestamp() const { return _identityChangeTimestamp; }
     void setIdentityChangeTimestamp(quint64 identityChangeTimestamp) { _identityChangeTimestamp = identityChangeTimestamp; }
 
-    void setFullRateDistance(float fullRateDistance) { _fullRateDistance = fullRateDistance; }
-    float getFullRateDistance() const { return _fullRateDistance; }
-
     void setMaxAvatarDistance(float maxAvatarDistance) { _maxAvatarDistance = maxAvatarDistance; }
     float getMaxAvatarDistance() const { return _maxAvatarDistance; }
 
@@ -70,36 +73,46 @@ public:
 
     void incrementNumOutOfOrderSends() { ++_numOutOfOrderSends; }
 
-    int getNumFramesSinceFRDAdjustment() const { return _numFramesSinceAdjustment; }
-    void incrementNumFramesSinceFRDAdjustment() { ++_numFramesSinceAdjustment; }
-    void resetNumFramesSinceFRDAdjustment() { _numFramesSinceAdjustment = 0; }
+    /// records the fraction of the other avatars that were sent to this node in a frame
+    void recordAvatarSends(int numAvatarsSent, int numOtherAvatars)
+        { _avatarSendRatio.updateAverage(numOtherAvatars > 0 ? (float) numAvatarsSent / (float) numOtherAvatars : 0.0f); }
+    float getAvgSendsPerAvatarPerSecond() const { return _avatarSendRatio.getAverageSampleValuePerSecond(); }
+
+    void recordNumAvatarsOverBudget(int numAvatarsOverBudget) { _numAvatarsOverBudgetLastFrame = numAvatarsOverBudget; }
 
     void recordSentAvatarData(int numBytes) { _avgOtherAvatarDataRate.updateAverage((float) numBytes); }
 
     float getOutboundAvatarDataKbps() const
         { return _avgOtherAvatarDataRate.getAverageSampleValuePerSecond() / (float) BYTES_PER_KILOBIT; }
 
+    /// packs the avatar, prefixed with its node's UUID, once for each detail level from lowestDetail up so that
+    /// every listener this frame can copy the encoding it needs instead of packing the avatar again
+    void encodeFrameAvatarData(const QUuid& nodeUUID, AvatarDataDetail lowestDetail);
+    const QByteArray& getFrameAvatarData(AvatarDataDetail dataDetail) const { return _frameAvatarData[dataDetail]; }
+
     void loadJSONStats(QJsonObject& jsonObject) const;
 private:
     AvatarData _avatar;
+    QByteArray _frameAvatarData[NUM_AVATAR_DATA_DETAILS];
 
     uint16_t _lastReceivedSequenceNumber { 0 };
     std::unordered_map<QUuid, uint16_t> _lastBroadcastSequenceNumbers;
+    std::unordered_map<QUuid, quint64> _lastBroadcastTimes;
     std::unordered_set<QUuid> _hasReceivedFirstPacketsFrom;
 
     bool _hasReceivedFirstPackets = false;
     quint64 _billboardChangeTimestamp = 0;
     quint64 _identityChangeTimestamp = 0;
 
-    float _fullRateDistance = FLT_MAX;
     float _maxAvatarDistance = FLT_MAX;
 
     int _numAvatarsSentLastFrame = 0;
-    int _numFramesSinceAdjustment = 0;
+    int _numAvatarsOverBudgetLastFrame = 0;
+    SimpleMovingAverage _avatarSendRatio;
 
     SimpleMovingAverage _otherAvatarStarves;
     SimpleMovingAverage _otherAvatarSkips;
-    int _numOutOfOrderSends = 0;
+    std::atomic<int> _numOutOfOrderSends { 0 }; // incremented by every broadcast worker that sends this avatar
 
     SimpleMovingAverage _avgOtherAvatarDataRate;
 };
@@ -9,9 +9,16 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <QTimer>
+#include <EntityFindQuery.h>
 #include <EntityTree.h>
+#include <Metrics.h>
+#include <NLPacketList.h>
+#include <NumericalConstants.h>
 #include <SimpleEntitySimulation.h>
+#include <SimulatorLoad.h>
 
 #include "EntityServer.h"
 #include "EntityServerConsts.h"
@@ -21,13 +28,26 @@ const char* MODEL_SERVER_NAME = "Entity";
 const char* MODEL_SERVER_LOGGING_TARGET_NAME = "entity-server";
 const char* LOCAL_MODELS_PERSIST_FILE = "resources/models.svo";
 
+// how long the deleted entities are remembered after every client was told, for the clients that come back with the
+// entities they kept from an earlier visit
+static const quint64 DELETED_ENTITIES_HISTORY_USECS = 60 * 60 * USECS_PER_SECOND;
+// and how many at most, the clients away longer than the oldest of them are sent the whole scene again
+static const int MAX_DELETED_ENTITIES_HISTORY = 10000;
+
+static const auto entityFindsMetric = MetricsRegistry::counter("hifi_entity_server_finds_total",
+                                                               "Entity searches run for clients without a copy of the tree.");
+
 EntityServer::EntityServer(NLPacket& packet) :
     OctreeServer(packet),
     _entitySimulation(NULL)
 {
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListenerForTypes({ PacketType::EntityAdd, PacketType::EntityEdit, PacketType::EntityErase },
+    packetReceiver.registerListenerForTypes({ PacketType::EntityAdd, PacketType::EntityEdit,
+                                              PacketType::EntitySimulationUpdate, PacketType::EntityErase },
                                             this, "handleEntityPacket");
+    packetReceiver.registerListener(PacketType::Jurisdiction, this, "handleJurisdictionPacket");
+    packetReceiver.registerListener(PacketType::EntityFind, this, "handleEntityFindPacket");
+    packetReceiver.registerListener(PacketType::SimulatorLoad, this, "handleSimulatorLoadPacket");
 }
 
 EntityServer::~EntityServer() {
@@ -35,6 +55,22 @@ EntityServer::~EntityServer() {
         _pruneDeletedEntitiesTimer->stop();
         _pruneDeletedEntitiesTimer->deleteLater();
     }
+    if (_handOffEntitiesTimer) {
+        _handOffEntitiesTimer->stop();
+        _handOffEntitiesTimer->deleteLater();
+    }
+    if (_suggestJurisdictionsTimer) {
+        _suggestJurisdictionsTimer->stop();
+        _suggestJurisdictionsTimer->deleteLater();
+    }
+    if (_handOffPacketSender) {
+        _handOffPacketSender->terminate();
+        _handOffPacketSender->deleteLater();
+    }
+    if (_jurisdictionListener) {
+        _jurisdictionListener->terminate();
+        _jurisdictionListener->deleteLater();
+    }
 
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     tree->removeNewlyCreatedHook(this);
@@ -46,6 +82,64 @@ void EntityServer::handleEntityPacket(QSharedPointer<NLPacket> packet, SharedNod
     }
 }
 
+void EntityServer::handleJurisdictionPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
+    NodeType_t nodeType;
+    packet->peekPrimitive(&nodeType);
+
+    // PacketType_JURISDICTION, first byte is the node type...
+    if (nodeType == NodeType::EntityServer && _jurisdictionListener) {
+        _jurisdictionListener->queueReceivedPacket(packet, senderNode);
+    }
+}
+
+void EntityServer::handleEntityFindPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
+    QDataStream packetStream(packet->readWithoutCopy(packet->bytesLeftToRead()));
+    EntityFindQuery query;
+    packetStream >> query;
+    if (packetStream.status() != QDataStream::Ok) {
+        qDebug() << "Dropping an EntityFind packet from" << senderNode->getUUID() << "that could not be read";
+        return;
+    }
+
+    // the results are taken while the tree is locked, the entities could change as soon as it is not
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    QVector<EntityFindResult> results;
+    tree->withReadLock([&] {
+        QVector<EntityItemPointer> entities;
+        if (query.shape == EntityFindQuery::Box) {
+            tree->findEntities(AABox(query.position, query.dimensions), entities);
+        } else {
+            tree->findEntities(query.position, query.radius, entities);
+        }
+
+        foreach (const EntityItemPointer& entity, entities) {
+            if (query.passesFilter(*entity)) {
+                results << EntityFindResult(*entity);
+            }
+        }
+    });
+    entityFindsMetric->increment();
+
+    QByteArray reply;
+    QDataStream replyStream(&reply, QIODevice::WriteOnly);
+    replyStream << query.requestID << results;
+
+    auto replyPacketList = NLPacketList::create(PacketType::EntityFindReply, QByteArray(), true, true);
+    replyPacketList->write(reply);
+    DependencyManager::get<NodeList>()->sendPacketList(std::move(replyPacketList), *senderNode);
+}
+
+void EntityServer::handleSimulatorLoadPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
+    QDataStream packetStream(packet->readWithoutCopy(packet->bytesLeftToRead()));
+    SimulatorLoad load;
+    packetStream >> load;
+    if (packetStream.status() != QDataStream::Ok || !_entitySimulation) {
+        return;
+    }
+    bool isPreferred = _preferAgentSimulators && senderNode->getType() == NodeType::Agent;
+    _entitySimulation->setSimulatorLoad(senderNode->getUUID(), load, isPreferred);
+}
+
 OctreeQueryNode* EntityServer::createOctreeQueryNode() {
     return new EntityNodeData();
 }
@@ -54,6 +148,7 @@ OctreePointer EntityServer::createTree() {
     EntityTreePointer tree = EntityTreePointer(new EntityTree(true));
     tree->createRootElement();
     tree->addNewlyCreatedHook(this);
+    tree->enableEncodeCache();
     if (!_entitySimulation) {
         SimpleEntitySimulation* simpleSimulation = new SimpleEntitySimulation();
         simpleSimulation->setEntityTree(tree);
@@ -64,10 +159,50 @@ OctreePointer EntityServer::createTree() {
 }
 
 void EntityServer::beforeRun() {
+    // the physics-simulator of the domain queries and edits the entities like an agent does
+    DependencyManager::get<NodeList>()->addNodeTypeToInterestSet(NodeType::PhysicsSimulator);
+
     _pruneDeletedEntitiesTimer = new QTimer();
     connect(_pruneDeletedEntitiesTimer, SIGNAL(timeout()), this, SLOT(pruneDeletedEntities()));
     const int PRUNE_DELETED_MODELS_INTERVAL_MSECS = 1 * 1000; // once every second
     _pruneDeletedEntitiesTimer->start(PRUNE_DELETED_MODELS_INTERVAL_MSECS);
+
+    // a server with a jurisdiction shares the domain with other entity servers, it follows their jurisdictions
+    // so that the entities that move out of its own, or that it had before its jurisdiction changed, go to them
+    if (getJurisdiction()) {
+        _jurisdictionListener = new JurisdictionListener(NodeType::EntityServer);
+        _jurisdictionListener->initialize(true);
+
+        _handOffPacketSender = new EntityEditPacketSender();
+        _handOffPacketSender->setServerJurisdictions(_jurisdictionListener->getJurisdictions());
+        _handOffPacketSender->initialize(true);
+
+        _handOffEntitiesTimer = new QTimer();
+        connect(_handOffEntitiesTimer, SIGNAL(timeout()), this, SLOT(handOffEntities()));
+        const int HAND_OFF_ENTITIES_INTERVAL_MSECS = 1 * 1000; // once every second
+        _handOffEntitiesTimer->start(HAND_OFF_ENTITIES_INTERVAL_MSECS);
+    }
+
+    if (_suggestJurisdictionsMaxEntities > 0) {
+        _suggestJurisdictionsTimer = new QTimer();
+        connect(_suggestJurisdictionsTimer, SIGNAL(timeout()), this, SLOT(suggestJurisdictions()));
+        const int SUGGEST_JURISDICTIONS_INTERVAL_MSECS = 60 * 1000; // once every minute
+        _suggestJurisdictionsTimer->start(SUGGEST_JURISDICTIONS_INTERVAL_MSECS);
+    }
+}
+
+void EntityServer::aboutToFinish() {
+    if (_handOffEntitiesTimer) {
+        _handOffEntitiesTimer->stop();
+    }
+    if (_handOffPacketSender) {
+        _handOffPacketSender->terminating();
+    }
+    if (_jurisdictionListener) {
+        _jurisdictionListener->terminating();
+    }
+
+    OctreeServer::aboutToFinish();
 }
 
 void EntityServer::entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
@@ -111,7 +246,6 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
 
         quint64 deletePacketSentAt = usecTimestampNow();
         EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
-        auto recentlyDeleted = tree->getRecentlyDeletedEntityIDs();
         bool hasMoreToSend = true;
 
         packetsSent = 0;
@@ -136,76 +270,60 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
         qint64 numberOfIDsPos = deletesPacket->pos();
         deletesPacket->writePrimitive(numberOfIDs);
 
-        // we keep a multi map of entity IDs to timestamps, we only want to include the entity IDs that have been
+        // the log of the deletions is ordered by their times, we only want to include the entity IDs that have been
         // deleted since we last sent to this node
-        auto it = recentlyDeleted.constBegin();
-        while (it != recentlyDeleted.constEnd()) {
-
-            // if the timestamp is more recent then out last sent time, include it
-            if (it.key() > considerEntitiesSince) {
-
-                // get all the IDs for this timestamp
-                const auto& entityIDsFromTime = recentlyDeleted.values(it.key());
-
-                for (const auto& entityID : entityIDsFromTime) {
-
-                    // check to make sure we have room for one more ID, if we don't have more
-                    // room, then send out this packet and create another one
-                    if (NUM_BYTES_RFC4122_UUID > deletesPacket->bytesAvailableForWrite()) {
+        tree->eachEntityDeletedSince(considerEntitiesSince, [&](const QUuid& entityID) {
+            // check to make sure we have room for one more ID, if we don't have more
+            // room, then send out this packet and create another one
+            if (NUM_BYTES_RFC4122_UUID > deletesPacket->bytesAvailableForWrite()) {
 
-                        // replace the count for the number of included IDs
-                        deletesPacket->seek(numberOfIDsPos);
-                        deletesPacket->writePrimitive(numberOfIDs);
+                // replace the count for the number of included IDs
+                deletesPacket->seek(numberOfIDsPos);
+                deletesPacket->writePrimitive(numberOfIDs);
 
-                        // Send the current packet
-                        queryNode->packetSent(*deletesPacket);
-                        auto thisPacketSize = deletesPacket->getDataSize();
-                        totalBytes += thisPacketSize;
-                        packetsSent++;
-                        DependencyManager::get<NodeList>()->sendPacket(std::move(deletesPacket), *node);
+                // Send the current packet
+                queryNode->packetSent(*deletesPacket);
+                auto thisPacketSize = deletesPacket->getDataSize();
+                totalBytes += thisPacketSize;
+                packetsSent++;
+                DependencyManager::get<NodeList>()->sendPacket(std::move(deletesPacket), *node);
 
-                        #ifdef EXTRA_ERASE_DEBUGGING
-                            qDebug() << "EntityServer::sendSpecialPackets() sending packet packetsSent[" << packetsSent << "] size:" << thisPacketSize;
-                        #endif
+                #ifdef EXTRA_ERASE_DEBUGGING
+                    qDebug() << "EntityServer::sendSpecialPackets() sending packet packetsSent[" << packetsSent << "] size:" << thisPacketSize;
+                #endif
 
 
-                        // create another packet
-                        deletesPacket = NLPacket::create(PacketType::EntityErase);
+                // create another packet
+                deletesPacket = NLPacket::create(PacketType::EntityErase);
 
-                        // pack in flags
-                        deletesPacket->writePrimitive(flags);
+                // pack in flags
+                deletesPacket->writePrimitive(flags);
 
-                        // pack in sequence number
-                        sequenceNumber = queryNode->getSequenceNumber();
-                        deletesPacket->writePrimitive(sequenceNumber);
+                // pack in sequence number
+                sequenceNumber = queryNode->getSequenceNumber();
+                deletesPacket->writePrimitive(sequenceNumber);
 
-                        // pack in timestamp
-                        deletesPacket->writePrimitive(now);
-
-                        // figure out where we are now and pack a temporary number of IDs
-                        numberOfIDs = 0;
-                        numberOfIDsPos = deletesPacket->pos();
-                        deletesPacket->writePrimitive(numberOfIDs);
-                    }
-
-                    // FIXME - we still seem to see cases where incorrect EntityIDs get sent from the server
-                    // to the client. These were causing "lost" entities like flashlights and laser pointers
-                    // now that we keep around some additional history of the erased entities and resend that
-                    // history for a longer time window, these entities are not "lost". But we haven't yet
-                    // found/fixed the underlying issue that caused bad UUIDs to be sent to some users.
-                    deletesPacket->write(entityID.toRfc4122());
-                    ++numberOfIDs;
-
-                    #ifdef EXTRA_ERASE_DEBUGGING
-                        qDebug() << "EntityTree::encodeEntitiesDeletedSince() including:" << entityID;
-                    #endif
-                } // end for (ids)
-
-            } // end if (it.val > sinceLast)
+                // pack in timestamp
+                deletesPacket->writePrimitive(now);
 
+                // figure out where we are now and pack a temporary number of IDs
+                numberOfIDs = 0;
+                numberOfIDsPos = deletesPacket->pos();
+                deletesPacket->writePrimitive(numberOfIDs);
+            }
 
-            ++it;
-        } // end while
+            // FIXME - we still seem to see cases where incorrect EntityIDs get sent from the server
+            // to the client. These were causing "lost" entities like flashlights and laser pointers
+            // now that we keep around some additional history of the erased entities and resend that
+            // history for a longer time window, these entities are not "lost". But we haven't yet
+            // found/fixed the underlying issue that caused bad UUIDs to be sent to some users.
+            deletesPacket->write(entityID.toRfc4122());
+            ++numberOfIDs;
+
+            #ifdef EXTRA_ERASE_DEBUGGING
+                qDebug() << "EntityTree::encodeEntitiesDeletedSince() including:" << entityID;
+            #endif
+        });
 
         // replace the count for the number of included IDs
         deletesPacket->seek(numberOfIDsPos);
@@ -235,6 +353,23 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
     return totalBytes;
 }
 
+QSet<PacketType> EntityServer::getMyReplayedPacketTypes() const {
+    auto types = OctreeServer::getMyReplayedPacketTypes();
+    types << PacketType::EntityAdd << PacketType::EntityEdit << PacketType::EntitySimulationUpdate
+        << PacketType::EntityErase;
+    return types;
+}
+
+bool EntityServer::resumeCachedScene(OctreeQueryNode* queryNode, quint64 cachedSceneTime) {
+    // the client can only drop the entities deleted while it was away if all of them are still known
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    if (!tree->hasAllEntitiesDeletedSince(cachedSceneTime)) {
+        return false;
+    }
+    EntityNodeData* nodeData = static_cast<EntityNodeData*>(queryNode);
+    nodeData->setLastDeletedEntitiesSentAt(cachedSceneTime);
+    return true;
+}
 
 void EntityServer::pruneDeletedEntities() {
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
@@ -250,7 +385,38 @@ void EntityServer::pruneDeletedEntities() {
                 }
             }
         });
-        tree->forgetEntitiesDeletedBefore(earliestLastDeletedEntitiesSent);
+        // the history past the deletions a client was not sent yet is bounded, for the domains that delete many
+        quint64 historyStart = std::max(usecTimestampNow() - DELETED_ENTITIES_HISTORY_USECS,
+                                        tree->getEntityDeletedAt(MAX_DELETED_ENTITIES_HISTORY));
+        tree->forgetEntitiesDeletedBefore(std::min(earliestLastDeletedEntitiesSent, historyStart));
+    }
+}
+
+void EntityServer::handOffEntities() {
+    JurisdictionMap* jurisdiction = getJurisdiction();
+    if (!jurisdiction || !_handOffPacketSender || !_handOffPacketSender->serversExist()) {
+        return;
+    }
+
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    int handedOff = 0;
+    tree->withWriteLock([&] {
+        handedOff = tree->handOffEntities(*jurisdiction, *_jurisdictionListener->getJurisdictions(),
+                                          _handOffPacketSender);
+    });
+    if (handedOff > 0) {
+        _handOffPacketSender->releaseQueuedMessages();
+        qDebug() << "Handed off" << handedOff << "entities outside of our jurisdiction to other entity servers";
+    }
+}
+
+void EntityServer::suggestJurisdictions() {
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    QStringList roots = tree->suggestJurisdictionRoots(_suggestJurisdictionsMaxEntities);
+    if (roots.size() > 1) {
+        // each root is the jurisdictionRoot of a server, and one of the jurisdictionEndNodes of the server of the root
+        qDebug() << "Entity servers of at most" << _suggestJurisdictionsMaxEntities << "entities would have the"
+            << "jurisdiction roots" << roots.join(",");
     }
 }
 
@@ -263,6 +429,12 @@ bool EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
     readOptionBool(QString("wantTerseEditLogging"), settingsSectionObject, wantTerseEditLogging);
     qDebug("wantTerseEditLogging=%s", debug::valueOf(wantTerseEditLogging));
 
+    readOptionInt(QString("suggestJurisdictionsMaxEntities"), settingsSectionObject, _suggestJurisdictionsMaxEntities);
+    qDebug("suggestJurisdictionsMaxEntities=%d", _suggestJurisdictionsMaxEntities);
+
+    readOptionBool(QString("preferAgentSimulators"), settingsSectionObject, _preferAgentSimulators);
+    qDebug("preferAgentSimulators=%s", debug::valueOf(_preferAgentSimulators));
+
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     tree->setWantEditLogging(wantEditLogging);
     tree->setWantTerseEditLogging(wantTerseEditLogging);
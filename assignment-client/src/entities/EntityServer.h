@@ -14,9 +14,13 @@
 
 #include "../octree/OctreeServer.h"
 
+#include <JurisdictionListener.h>
+
+#include "EntityEditPacketSender.h"
 #include "EntityItem.h"
 #include "EntityServerConsts.h"
 #include "EntityTree.h"
+#include "SimpleEntitySimulation.h"
 
 /// Handles assignments of type EntityServer - sending entities to various clients.
 class EntityServer : public OctreeServer, public NewlyCreatedEntityHook {
@@ -39,22 +43,40 @@ public:
     virtual void beforeRun() override;
     virtual bool hasSpecialPacketsToSend(const SharedNodePointer& node) override;
     virtual int sendSpecialPackets(const SharedNodePointer& node, OctreeQueryNode* queryNode, int& packetsSent) override;
+    virtual QSet<PacketType> getMyReplayedPacketTypes() const override;
+    virtual bool resumeCachedScene(OctreeQueryNode* queryNode, quint64 cachedSceneTime) override;
 
     virtual void entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) override;
     virtual bool readAdditionalConfiguration(const QJsonObject& settingsSectionObject) override;
 
+    virtual void aboutToFinish() override;
+
 public slots:
     void pruneDeletedEntities();
+    void handOffEntities();
+    void suggestJurisdictions();
 
 protected:
     virtual OctreePointer createTree() override;
 
 private slots:
     void handleEntityPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
+    void handleEntityFindPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
+    void handleSimulatorLoadPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
+    void handleJurisdictionPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
 
 private:
-    EntitySimulation* _entitySimulation;
+    SimpleEntitySimulation* _entitySimulation;
+    bool _preferAgentSimulators = false; // the agents that run physics are given objects before the interfaces
     QTimer* _pruneDeletedEntitiesTimer = nullptr;
+
+    // with a jurisdiction, the entities that leave it go to the servers of the other jurisdictions
+    JurisdictionListener* _jurisdictionListener = nullptr;
+    EntityEditPacketSender* _handOffPacketSender = nullptr;
+    QTimer* _handOffEntitiesTimer = nullptr;
+
+    int _suggestJurisdictionsMaxEntities = 0; // logs a partition of the tree in jurisdictions of this size when set
+    QTimer* _suggestJurisdictionsTimer = nullptr;
 };
 
 #endif // hifi_EntityServer_h
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <limits>
 
 #include <NumericalConstants.h>
@@ -31,6 +32,7 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
     _totalElementsInPacket(0),
     _totalPackets(0),
     _lastNackTime(usecTimestampNow()),
+    _lastEditPublishTime(usecTimestampNow()),
     _shuttingDown(false)
 {
 }
@@ -47,13 +49,16 @@ void OctreeInboundPacketProcessor::resetStats() {
 }
 
 unsigned long OctreeInboundPacketProcessor::getMaxWait() const {
-    // calculate time until next sendNackPackets()
-    quint64 nextNackTime = _lastNackTime + TOO_LONG_SINCE_LAST_NACK;
+    // calculate time until next sendNackPackets(), or the next publish of the edits we are holding
+    quint64 nextWakeTime = _lastNackTime + TOO_LONG_SINCE_LAST_NACK;
+    if (!_pendingEdits.empty()) {
+        nextWakeTime = std::min(nextWakeTime, _lastEditPublishTime + _myServer->getEditPublishInterval());
+    }
     quint64 now = usecTimestampNow();
-    if (now >= nextNackTime) {
+    if (now >= nextWakeTime) {
         return 0;
     }
-    return (nextNackTime - now) / USECS_PER_MSEC + 1;
+    return (nextWakeTime - now) / USECS_PER_MSEC + 1;
 }
 
 void OctreeInboundPacketProcessor::preProcess() {
@@ -63,6 +68,10 @@ void OctreeInboundPacketProcessor::preProcess() {
         _lastNackTime = now;
         sendNackPackets();
     }
+
+    if (now - _lastEditPublishTime >= _myServer->getEditPublishInterval()) {
+        publishPendingEdits();
+    }
 }
 
 void OctreeInboundPacketProcessor::midProcess() {
@@ -72,6 +81,35 @@ void OctreeInboundPacketProcessor::midProcess() {
         _lastNackTime = now;
         sendNackPackets();
     }
+
+    if (now - _lastEditPublishTime >= _myServer->getEditPublishInterval()) {
+        publishPendingEdits();
+    }
+}
+
+void OctreeInboundPacketProcessor::publishPendingEdits() {
+    if (_pendingEdits.empty()) {
+        return;
+    }
+
+    // apply the whole batch under a single write lock, so that the send threads only ever see the tree change
+    // once per publish interval instead of once per edit
+    quint64 startProcess, startLock = usecTimestampNow();
+    _myServer->getOctree()->withWriteLock([&] {
+        startProcess = usecTimestampNow();
+        _myServer->getOctree()->startEditBatch();
+        for (auto& applyEdit : _pendingEdits) {
+            applyEdit();
+        }
+        _myServer->getOctree()->finishEditBatch();
+    });
+    quint64 endProcess = usecTimestampNow();
+
+    _totalProcessTime += endProcess - startProcess;
+    _totalLockWaitTime += startProcess - startLock;
+
+    _pendingEdits.clear();
+    _lastEditPublishTime = endProcess;
 }
 
 void OctreeInboundPacketProcessor::processPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
@@ -156,13 +194,26 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<NLPacket> packet
                         packet->pos(), maxSize);
             }
 
+            // decode the edit while the send threads can still read the tree, it is published with the next batch
             quint64 startProcess, startLock = usecTimestampNow();
-            int editDataBytesRead;
-            _myServer->getOctree()->withWriteLock([&] {
-                startProcess = usecTimestampNow();
-                editDataBytesRead =
-                    _myServer->getOctree()->processEditPacketData(*packet, editData, maxSize, sendingNode);
-            });
+            std::function<void()> applyEdit;
+            int editDataBytesRead =
+                _myServer->getOctree()->decodeEditPacketData(*packet, editData, maxSize, sendingNode, applyEdit);
+
+            if (applyEdit) {
+                startProcess = startLock;
+                _pendingEdits.push_back(applyEdit);
+            } else {
+                // this edit can't be staged, publish the ones before it so they keep their order
+                publishPendingEdits();
+
+                startLock = usecTimestampNow();
+                _myServer->getOctree()->withWriteLock([&] {
+                    startProcess = usecTimestampNow();
+                    editDataBytesRead =
+                        _myServer->getOctree()->processEditPacketData(*packet, editData, maxSize, sendingNode);
+                });
+            }
             quint64 endProcess = usecTimestampNow();
 
             if (debugProcessPacket) {
@@ -14,6 +14,9 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <functional>
+#include <vector>
+
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
@@ -65,6 +68,7 @@ public:
     quint64 getAverageLockWaitTimePerPacket() const { return _totalPackets == 0 ? 0 : _totalLockWaitTime / _totalPackets; }
     quint64 getTotalElementsProcessed() const { return _totalElementsInPacket; }
     quint64 getTotalPacketsProcessed() const { return _totalPackets; }
+    quint64 getTotalProcessTime() const { return _totalProcessTime; }
     quint64 getAverageProcessTimePerElement() const
                 { return _totalElementsInPacket == 0 ? 0 : _totalProcessTime / _totalElementsInPacket; }
     quint64 getAverageLockWaitTimePerElement() const
@@ -86,6 +90,7 @@ protected:
 
 private:
     int sendNackPackets();
+    void publishPendingEdits();
 
 private:
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
@@ -103,6 +108,11 @@ private:
     NodeToSenderStatsMap _singleSenderStats;
 
     quint64 _lastNackTime;
+
+    // decoded edits waiting for the next publish
+    std::vector<std::function<void()>> _pendingEdits;
+    quint64 _lastEditPublishTime;
+
     bool _shuttingDown;
 };
 #endif // hifi_OctreeInboundPacketProcessor_h
@@ -19,6 +19,8 @@
 #include <UUID.h>
 
 #include "OctreeSendThread.h"
+#include "OctreeSendThreadPool.h"
+#include "OctreeServer.h"
 
 OctreeQueryNode::OctreeQueryNode() :
     _viewSent(false),
@@ -46,6 +48,8 @@ OctreeQueryNode::OctreeQueryNode() :
     _isShuttingDown(false),
     _sentPacketHistory()
 {
+    // send the biggest looking parts of the scene first
+    elementBag.setPriorityView(&_currentViewFrustum);
 }
 
 OctreeQueryNode::~OctreeQueryNode() {
@@ -71,12 +75,11 @@ void OctreeQueryNode::forceNodeShutdown() {
     _isShuttingDown = true;
     elementBag.unhookNotifications(); // if our node is shutting down, then we no longer need octree element notifications
     if (_octreeSendThread) {
-        // we really need to force our thread to shutdown, this is synchronous, we will block while the thread actually
-        // shuts down because we really need it to shutdown, and it's ok if we wait for it to complete
+        // we really need to force our thread to shutdown, this is synchronous, deleting it will block while a send
+        // worker is still running it, and it's ok if we wait for it to complete
         OctreeSendThread* sendThread = _octreeSendThread;
         _octreeSendThread = NULL;
         sendThread->setIsShuttingDown();
-        sendThread->terminate();
         delete sendThread;
     }
 }
@@ -97,7 +100,7 @@ void OctreeQueryNode::initializeOctreeSendThread(OctreeServer* myServer, const S
 
     // we want to be notified when the thread finishes
     connect(_octreeSendThread, &GenericThread::finished, this, &OctreeQueryNode::sendThreadFinished);
-    _octreeSendThread->initialize(true);
+    myServer->getSendThreadPool()->addSender(_octreeSendThread);
 }
 
 bool OctreeQueryNode::packetIsDuplicate() const {
@@ -219,11 +222,62 @@ void OctreeQueryNode::writeToPacket(const unsigned char* buffer, unsigned int by
         _octreePacket->writePrimitive(sectionSize);
     }
     if (bytes <= _octreePacket->bytesAvailableForWrite()) {
-        _octreePacket->write(reinterpret_cast<const char*>(buffer), bytes);
+        char* writePosition = _octreePacket->getPayload() + _octreePacket->pos();
+
+        if (reinterpret_cast<const char*>(buffer) == writePosition) {
+            // the data was encoded straight into our packet, we only need to take it
+            _octreePacket->setPayloadSize(_octreePacket->pos() + bytes);
+            _octreePacket->seek(_octreePacket->pos() + bytes);
+        } else {
+            _octreePacket->write(reinterpret_cast<const char*>(buffer), bytes);
+        }
         _octreePacketWaiting = true;
     }
 }
 
+// the view frustum the server sends for a camera of the client, wider than the camera
+static ViewFrustum sentViewFrustum(const glm::vec3& position, const glm::quat& orientation, float fov, float aspectRatio,
+                                   float nearClip, float farClip) {
+    ViewFrustum viewFrustum;
+    // get position and orientation details from the camera
+    viewFrustum.setPosition(position);
+    viewFrustum.setOrientation(orientation);
+
+    // Also make sure it's got the correct lens details from the camera
+    float wideFOV = fov + VIEW_FRUSTUM_FOV_OVERSEND;
+
+    if (0.0f != aspectRatio &&
+        0.0f != nearClip &&
+        0.0f != farClip &&
+        nearClip != farClip) {
+        viewFrustum.setProjection(glm::perspective(
+            glm::radians(wideFOV), // hack
+            aspectRatio,
+            nearClip,
+            farClip));
+    }
+    return viewFrustum;
+}
+
+void OctreeQueryNode::resumeCachedScene(quint64 cachedSceneTime) {
+    // the elements in the cached view are skipped as if they were sent in the last scene, unless they changed since,
+    // and the first scene is sent as a full scene so that all the entities of the elements it does send are sent
+    const ViewFrustum& cachedView = getCachedSceneView();
+    _lastKnownViewFrustum = sentViewFrustum(cachedView.getPosition(), cachedView.getOrientation(),
+                                            cachedView.getFieldOfView(), cachedView.getAspectRatio(),
+                                            cachedView.getNearClip(), cachedView.getFarClip());
+    _lastKnownViewFrustum.calculate();
+    _lastTimeBagEmpty = cachedSceneTime;
+    _isResumingCachedScene = true;
+    stats.setResumedSceneTime(cachedSceneTime);
+}
+
+void OctreeQueryNode::cachedSceneResumed() {
+    // from now on the view the first scene was sent for is known to the delta sending, as for any client
+    _lastTimeBagEmpty = 0;
+    _isResumingCachedScene = false;
+}
+
 bool OctreeQueryNode::updateCurrentViewFrustum() {
     // if shutting down, return immediately
     if (_isShuttingDown) {
@@ -231,27 +285,15 @@ bool OctreeQueryNode::updateCurrentViewFrustum() {
     }
 
     bool currentViewFrustumChanged = false;
-    ViewFrustum newestViewFrustum;
-    // get position and orientation details from the camera
-    newestViewFrustum.setPosition(getCameraPosition());
-    newestViewFrustum.setOrientation(getCameraOrientation());
+    ViewFrustum newestViewFrustum = sentViewFrustum(getCameraPosition(), getCameraOrientation(), getCameraFov(),
+                                                    getCameraAspectRatio(), getCameraNearClip(), getCameraFarClip());
 
-    // Also make sure it's got the correct lens details from the camera
-    float originalFOV = getCameraFov();
-    float wideFOV = originalFOV + VIEW_FRUSTUM_FOV_OVERSEND;
-
-    if (0.0f != getCameraAspectRatio() &&
-        0.0f != getCameraNearClip() &&
-        0.0f != getCameraFarClip() &&
-        getCameraNearClip() != getCameraFarClip()) {
-        newestViewFrustum.setProjection(glm::perspective(
-            glm::radians(wideFOV), // hack
-            getCameraAspectRatio(),
-            getCameraNearClip(),
-            getCameraFarClip()));
+    // and the volumes the client wants in addition to its view, which parseData() replaces under the node data mutex
+    {
+        QMutexLocker locker(&getMutex());
+        newestViewFrustum.setInterestVolumes(getInterestVolumes());
     }
 
-
     // if there has been a change, then recalculate
     if (!newestViewFrustum.isVerySimilar(_currentViewFrustum)) {
         _currentViewFrustum = newestViewFrustum;
@@ -383,3 +425,25 @@ void OctreeQueryNode::parseNackPacket(NLPacket& packet) {
         _nackedSequenceNumbers.enqueue(sequenceNumber);
     }
 }
+
+void OctreeQueryNode::sceneProgress(quint64 elementsSent) {
+    if (_sceneProgress.empty() || _sceneProgress.back().elementsSent != elementsSent) {
+        _sceneProgress.push_back({ usecTimestampNow(), elementsSent });
+    }
+}
+
+quint64 OctreeQueryNode::getSceneNinetyPercentTime() const {
+    if (_sceneProgress.empty() || _sceneProgress.back().elementsSent == 0) {
+        return 0;
+    }
+
+    const quint64 NINETY_PERCENT = 90;
+    quint64 target = (_sceneProgress.back().elementsSent * NINETY_PERCENT + 99) / 100;
+
+    for (auto& progress : _sceneProgress) {
+        if (progress.elementsSent >= target) {
+            return progress.time > _sceneSendStartTime ? progress.time - _sceneSendStartTime : 0;
+        }
+    }
+    return 0;
+}
@@ -13,6 +13,7 @@
 #define hifi_OctreeQueryNode_h
 
 #include <iostream>
+#include <vector>
 
 #include <CoverageMap.h>
 #include <NodeData.h>
@@ -76,6 +77,11 @@ public:
 
     quint64 getLastTimeBagEmpty() const { return _lastTimeBagEmpty; }
     void setLastTimeBagEmpty() { _lastTimeBagEmpty = _sceneSendStartTime; }
+    /// the client kept what was sent for its cached view up to then, so the first scene skips what did not change since
+    void resumeCachedScene(quint64 cachedSceneTime);
+    bool isResumingCachedScene() const { return _isResumingCachedScene; }
+    /// called once the first scene was sent, the scenes after it are sent as they are to any client
+    void cachedSceneResumed();
 
     bool getCurrentPacketIsColor() const { return _currentPacketIsColor; }
     bool getCurrentPacketIsCompressed() const { return _currentPacketIsCompressed; }
@@ -97,7 +103,12 @@ public:
     unsigned int getlastOctreePacketLength() const { return _lastOctreePacketLength; }
     int getDuplicatePacketCount() const { return _duplicatePacketCount; }
 
-    void sceneStart(quint64 sceneSendStartTime) { _sceneSendStartTime = sceneSendStartTime; }
+    void sceneStart(quint64 sceneSendStartTime) { _sceneSendStartTime = sceneSendStartTime; _sceneProgress.clear(); }
+
+    /// records how many elements with data the current scene had sent by now
+    void sceneProgress(quint64 elementsSent);
+    /// usecs from the scene start until 90% of its elements with data were sent, or 0 if it sent none
+    quint64 getSceneNinetyPercentTime() const;
 
     void nodeKilled();
     void forceNodeShutdown();
@@ -133,6 +144,7 @@ private:
     ViewFrustum _currentViewFrustum;
     ViewFrustum _lastKnownViewFrustum;
     quint64 _lastTimeBagEmpty;
+    bool _isResumingCachedScene { false };
     bool _viewFrustumChanging;
     bool _viewFrustumJustStoppedChanging;
     bool _currentPacketIsColor;
@@ -157,6 +169,12 @@ private:
     QQueue<OCTREE_PACKET_SEQUENCE> _nackedSequenceNumbers;
 
     quint64 _sceneSendStartTime = 0;
+
+    struct SceneProgress {
+        quint64 time;
+        quint64 elementsSent;
+    };
+    std::vector<SceneProgress> _sceneProgress;
 };
 
 #endif // hifi_OctreeQueryNode_h
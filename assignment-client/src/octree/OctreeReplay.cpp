@@ -0,0 +1,230 @@
+//
+//  OctreeReplay.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeReplay.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QDebug>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+#include <Metrics.h>
+#include <NLPacket.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <udt/PacketBufferPool.h>
+
+#include "OctreeInboundPacketProcessor.h"
+#include "OctreeSendThread.h"
+
+// registered by OctreeSendThread as well, the registry gives both the same histogram
+static const auto octreeEncodeUsecsMetric = MetricsRegistry::histogram("hifi_octree_encode_usecs",
+                                                                       "Time taken to encode the octree for a viewer, in usecs.",
+                                                                       { 100.0, 500.0, 1000.0, 5000.0, 10000.0, 100000.0 });
+
+// how many datagrams to hand over at once when there is no pace to keep, so the event loop still gets to run
+const int MAX_DATAGRAMS_PER_BATCH = 100;
+const int PROCESSED_CHECK_INTERVAL_MSECS = 100;
+
+OctreeReplay::OctreeReplay(const QSet<PacketType>& replayedTypes, OctreeInboundPacketProcessor* inboundPacketProcessor,
+                           QObject* parent) :
+    QObject(parent),
+    _replayedTypes(replayedTypes),
+    _inboundPacketProcessor(inboundPacketProcessor)
+{
+    _timer.setSingleShot(true);
+    _timer.setTimerType(Qt::PreciseTimer);
+    connect(&_timer, &QTimer::timeout, this, &OctreeReplay::replayDueDatagrams);
+}
+
+bool OctreeReplay::start(const QString& capturePath, float speed, const QString& reportPath) {
+    if (!_reader.open(capturePath)) {
+        return false;
+    }
+
+    if (!_sinkSocket.bind(QHostAddress::LocalHost, 0)) {
+        qDebug() << "[ERROR] Could not bind a socket for the replayed agents -" << _sinkSocket.errorString();
+        return false;
+    }
+
+    _speed = std::max(speed, 0.0f);
+    _reportPath = reportPath;
+    _hasNextDatagram = _reader.readNext(_nextDatagram);
+
+    _startTime = usecTimestampNow();
+    _startBytesSent = OctreeSendThread::_totalBytes;
+    _startPacketsSent = OctreeSendThread::_totalPackets;
+    _startPacketsProcessed = _inboundPacketProcessor->getTotalPacketsProcessed();
+    _startProcessUsecs = _inboundPacketProcessor->getTotalProcessTime();
+    _startEncodes = octreeEncodeUsecsMetric->getCount();
+    _startEncodeUsecs = octreeEncodeUsecsMetric->getSum();
+
+    qDebug() << "Replaying" << capturePath << (_speed > 0.0f ? QString("at %1x").arg(_speed) : QString("unpaced"));
+
+    _timer.start(0);
+    return true;
+}
+
+void OctreeReplay::replayDueDatagrams() {
+    quint64 elapsed = usecTimestampNow() - _startTime;
+    int numReplayed = 0;
+
+    while (_hasNextDatagram) {
+        if (_speed > 0.0f) {
+            quint64 dueTime = (quint64)(_nextDatagram.timeUsecs / _speed);
+            if (dueTime > elapsed) {
+                _timer.start((int)((dueTime - elapsed) / USECS_PER_MSEC));
+                return;
+            }
+        } else if (numReplayed == MAX_DATAGRAMS_PER_BATCH) {
+            _timer.start(0);
+            return;
+        }
+
+        replayDatagram(_nextDatagram);
+        numReplayed++;
+        _hasNextDatagram = _reader.readNext(_nextDatagram);
+    }
+
+    // the edits may still be queued for the inbound processor, the report waits until it has caught up
+    connect(&_timer, &QTimer::timeout, this, &OctreeReplay::checkProcessed);
+    disconnect(&_timer, &QTimer::timeout, this, &OctreeReplay::replayDueDatagrams);
+    _timer.start(PROCESSED_CHECK_INTERVAL_MSECS);
+}
+
+void OctreeReplay::replayDatagram(const udt::PacketCaptureReader::Datagram& datagram) {
+    _numDatagrams++;
+
+    qint64 size = datagram.data.size();
+    uint32_t firstWord = 0;
+    if (size < (qint64)sizeof(firstWord)) {
+        _numSkippedDatagrams++;
+        return;
+    }
+
+    // the control packets were for the connections of the session, not for the server
+    memcpy(&firstWord, datagram.data.constData(), sizeof(firstWord));
+    if (firstWord & udt::CONTROL_BIT_MASK) {
+        _numSkippedDatagrams++;
+        return;
+    }
+
+    auto buffer = udt::PacketBufferPool::allocate(size);
+    memcpy(buffer.get(), datagram.data.constData(), size);
+    auto packet = udt::Packet::fromReceivedPacket(std::move(buffer), size, datagram.senderSockAddr);
+
+    // the parts of messages would need the connections to put them back together
+    if (packet->isPartOfMessage() && packet->getPacketPosition() != udt::Packet::ONLY) {
+        _numSkippedDatagrams++;
+        return;
+    }
+
+    PacketType type = NLPacket::typeInHeader(*packet);
+    if (!_replayedTypes.contains(type) || NLPacket::versionInHeader(*packet) != versionForPacketType(type)) {
+        _numSkippedDatagrams++;
+        return;
+    }
+
+    QUuid sourceID = NLPacket::sourceIDInHeader(*packet);
+    if (sourceID.isNull()) {
+        _numSkippedDatagrams++;
+        return;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer node = nodeList->nodeWithUUID(sourceID);
+    if (!node) {
+        HifiSockAddr sinkSockAddr { QHostAddress::LocalHost, _sinkSocket.localPort() };
+        node = nodeList->addOrUpdateNode(sourceID, NodeType::Agent, sinkSockAddr, sinkSockAddr, false, true);
+        node->activatePublicSocket();
+        _replayedNodes.insert(sourceID);
+    }
+    // an agent that was quiet in the capture should not be timed out while it is replayed
+    node->setLastHeardMicrostamp(usecTimestampNow());
+
+    quint64 start = usecTimestampNow();
+    nodeList->getPacketReceiver().handleVerifiedPacket(std::move(packet));
+    quint64 handlingUsecs = usecTimestampNow() - start;
+
+    HandlingStats& stats = _handlingStats[type];
+    stats.count++;
+    stats.totalUsecs += handlingUsecs;
+    stats.maxUsecs = std::max(stats.maxUsecs, handlingUsecs);
+}
+
+void OctreeReplay::checkProcessed() {
+    if (_inboundPacketProcessor->packetsToProcessCount() > 0) {
+        _timer.start(PROCESSED_CHECK_INTERVAL_MSECS);
+        return;
+    }
+    finish();
+}
+
+void OctreeReplay::finish() {
+    quint64 elapsedUsecs = usecTimestampNow() - _startTime;
+    quint64 bytesSent = OctreeSendThread::_totalBytes - _startBytesSent;
+    quint64 packetsSent = OctreeSendThread::_totalPackets - _startPacketsSent;
+    quint64 packetsProcessed = _inboundPacketProcessor->getTotalPacketsProcessed() - _startPacketsProcessed;
+    quint64 processUsecs = _inboundPacketProcessor->getTotalProcessTime() - _startProcessUsecs;
+    quint64 encodes = octreeEncodeUsecsMetric->getCount() - _startEncodes;
+    double encodeUsecs = octreeEncodeUsecsMetric->getSum() - _startEncodeUsecs;
+
+    QJsonObject handling;
+    for (auto it = _handlingStats.constBegin(); it != _handlingStats.constEnd(); ++it) {
+        const HandlingStats& stats = it.value();
+        QJsonObject typeStats;
+        typeStats["count"] = (double)stats.count;
+        typeStats["total_usecs"] = (double)stats.totalUsecs;
+        typeStats["average_usecs"] = stats.count == 0 ? 0.0 : (double)stats.totalUsecs / stats.count;
+        typeStats["max_usecs"] = (double)stats.maxUsecs;
+        handling[nameForPacketType(it.key())] = typeStats;
+    }
+
+    QJsonObject report;
+    report["speed"] = _speed;
+    report["elapsed_usecs"] = (double)elapsedUsecs;
+    report["datagrams"] = (double)_numDatagrams;
+    report["skipped_datagrams"] = (double)_numSkippedDatagrams;
+    report["agents"] = _replayedNodes.size();
+    report["handling"] = handling;
+    report["edits_processed"] = (double)packetsProcessed;
+    report["edit_process_usecs"] = (double)processUsecs;
+    report["encodes"] = (double)encodes;
+    report["encode_usecs"] = encodeUsecs;
+    report["average_encode_usecs"] = encodes == 0 ? 0.0 : encodeUsecs / encodes;
+    report["bytes_sent"] = (double)bytesSent;
+    report["packets_sent"] = (double)packetsSent;
+
+    qDebug() << "Replayed" << _numDatagrams - _numSkippedDatagrams << "of" << _numDatagrams << "datagrams from"
+        << _replayedNodes.size() << "agents in" << elapsedUsecs / USECS_PER_MSEC << "ms -"
+        << packetsProcessed << "edits processed in" << processUsecs << "usecs," << encodes << "encodes in"
+        << (quint64)encodeUsecs << "usecs," << bytesSent << "bytes sent in" << packetsSent << "packets";
+
+    QSaveFile file { _reportPath };
+    QByteArray json = QJsonDocument(report).toJson();
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit()) {
+        qDebug() << "[ERROR] Could not write the replay report to" << _reportPath << "-" << file.errorString();
+    } else {
+        qDebug() << "Wrote the replay report to" << _reportPath;
+    }
+
+    // the replayed agents would otherwise keep their send threads encoding for a socket nobody reads
+    auto nodeList = DependencyManager::get<NodeList>();
+    foreach (const QUuid& nodeID, _replayedNodes) {
+        nodeList->killNodeWithUUID(nodeID);
+    }
+    _replayedNodes.clear();
+
+    emit finished();
+}
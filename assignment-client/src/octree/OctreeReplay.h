@@ -0,0 +1,89 @@
+//
+//  OctreeReplay.h
+//  assignment-client/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeReplay_h
+#define hifi_OctreeReplay_h
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+#include <QtCore/QUuid>
+#include <QtNetwork/QUdpSocket>
+
+#include <udt/PacketCapture.h>
+#include <udt/PacketHeaders.h>
+
+class OctreeInboundPacketProcessor;
+
+// set these in the environment of an octree server to replay a capture into it once it runs, at the speed given
+const QString OCTREE_REPLAY_FILE_ENV = "HIFI_OCTREE_SERVER_REPLAY_FILE";
+const QString OCTREE_REPLAY_SPEED_ENV = "HIFI_OCTREE_SERVER_REPLAY_SPEED";
+// the report goes beside the capture unless this says otherwise
+const QString OCTREE_REPLAY_REPORT_ENV = "HIFI_OCTREE_SERVER_REPLAY_REPORT";
+
+// Hands the datagrams of a capture (see udt::PacketCaptureWriter) to the packet receiver of the server, as if the
+// clients that sent them were back, and reports what handling them cost. The senders become agents only the replay
+// knows about, whose octree goes to a socket that drops it, so the same production traffic can be run against every
+// build of the server without a client or a domain of its own.
+class OctreeReplay : public QObject {
+    Q_OBJECT
+public:
+    OctreeReplay(const QSet<PacketType>& replayedTypes, OctreeInboundPacketProcessor* inboundPacketProcessor,
+                 QObject* parent = nullptr);
+
+    /// speed scales the pace of the capture, 2 replays it twice as fast and 0 as fast as it can be handled
+    bool start(const QString& capturePath, float speed, const QString& reportPath);
+
+signals:
+    void finished();
+
+private slots:
+    void replayDueDatagrams();
+    void checkProcessed();
+
+private:
+    struct HandlingStats {
+        quint64 count { 0 };
+        quint64 totalUsecs { 0 };
+        quint64 maxUsecs { 0 };
+    };
+
+    void replayDatagram(const udt::PacketCaptureReader::Datagram& datagram);
+    void finish();
+
+    QSet<PacketType> _replayedTypes;
+    OctreeInboundPacketProcessor* _inboundPacketProcessor;
+
+    udt::PacketCaptureReader _reader;
+    udt::PacketCaptureReader::Datagram _nextDatagram;
+    bool _hasNextDatagram { false };
+    float _speed { 1.0f };
+    QString _reportPath;
+    QTimer _timer;
+
+    QUdpSocket _sinkSocket; // where the replayed agents are sent their octree
+    QSet<QUuid> _replayedNodes;
+
+    quint64 _startTime { 0 };
+    quint64 _numDatagrams { 0 };
+    quint64 _numSkippedDatagrams { 0 };
+    QHash<PacketType, HandlingStats> _handlingStats;
+
+    // the totals of the server when the replay started
+    quint64 _startBytesSent { 0 };
+    quint64 _startPacketsSent { 0 };
+    quint64 _startPacketsProcessed { 0 };
+    quint64 _startProcessUsecs { 0 };
+    quint64 _startEncodes { 0 };
+    double _startEncodeUsecs { 0.0 };
+};
+
+#endif // hifi_OctreeReplay_h
@@ -9,18 +9,27 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <Metrics.h>
 #include <NodeList.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <PerfStat.h>
+#include <Trace.h>
 
 #include "OctreeSendThread.h"
+#include "OctreeSendThreadPool.h"
 #include "OctreeServer.h"
 #include "OctreeServerConsts.h"
 
 quint64 startSceneSleepTime = 0;
 quint64 endSceneSleepTime = 0;
 
+static const auto octreePacketsSentMetric = MetricsRegistry::counter("hifi_octree_packets_sent_total",
+                                                                     "Octree packets sent to viewers.");
+static const auto octreeEncodeUsecsMetric = MetricsRegistry::histogram("hifi_octree_encode_usecs",
+                                                                       "Time taken to encode the octree for a viewer, in usecs.",
+                                                                       { 100.0, 500.0, 1000.0, 5000.0, 10000.0, 100000.0 });
+
 OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node) :
     _myServer(myServer),
     _node(node),
@@ -48,6 +57,9 @@ OctreeSendThread::~OctreeSendThread() {
     QString safeServerName("Octree");
     if (_myServer) {
         safeServerName = _myServer->getMyServerName();
+
+        // make sure no send worker is still running us
+        _myServer->getSendThreadPool()->removeSender(this);
     }
 
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client disconnected "
@@ -71,8 +83,6 @@ bool OctreeSendThread::process() {
 
     OctreeServer::didProcess(this);
 
-    quint64  start = usecTimestampNow();
-
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
 
@@ -85,7 +95,7 @@ bool OctreeSendThread::process() {
             // Sometimes the node data has not yet been linked, in which case we can't really do anything
             if (nodeData && !nodeData->isShuttingDown()) {
                 bool viewFrustumChanged = nodeData->updateCurrentViewFrustum();
-                packetDistributor(nodeData, viewFrustumChanged);
+                octreePacketsSentMetric->increment(packetDistributor(nodeData, viewFrustumChanged));
             }
         }
     }
@@ -94,21 +104,7 @@ bool OctreeSendThread::process() {
         return false; // exit early if we're shutting down
     }
 
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
-
-        if (usecToSleep > 0) {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            usleep(usecToSleep);
-        } else {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usleep(MIN_USEC_TO_SLEEP);
-        }
-    }
-
+    // the pool schedules our next interval
     return isStillRunning();  // keep running till they terminate us
 }
 
@@ -281,6 +277,7 @@ int OctreeSendThread::handlePacketSend(OctreeQueryNode* nodeData, int& trueBytes
     // remember to track our stats
     if (packetSent) {
         nodeData->stats.packetSent(nodeData->getPacket().getPayloadSize());
+        nodeData->sceneProgress(nodeData->stats.getColorSent());
         trueBytesSent += nodeData->getPacket().getPayloadSize();
         truePacketsSent++;
         packetsSent++;
@@ -293,6 +290,7 @@ int OctreeSendThread::handlePacketSend(OctreeQueryNode* nodeData, int& trueBytes
 
 /// Version of octree element distributor that sends the deepest LOD level at once
 int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrustumChanged) {
+    TRACE_ZONE("OctreeSendThread::packetDistributor");
 
     OctreeServer::didPacketDistributor(this);
 
@@ -309,7 +307,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
     int trueBytesSent = 0;
     int packetsSentThisInterval = 0;
     bool isFullScene = ((!viewFrustumChanged || !nodeData->getWantDelta()) && nodeData->getViewFrustumJustStoppedChanging())
-                                || nodeData->hasLodChanged();
+                                || nodeData->hasLodChanged() || nodeData->isResumingCachedScene();
 
     bool somethingToSend = true; // assume we have something
 
@@ -323,6 +321,9 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
     bool wantColor = nodeData->getWantColor();
     bool wantCompression = nodeData->getWantCompression();
 
+    // uncompressed content is encoded straight into the node packet, from the next changeSettings on
+    _packetData.setTargetPacket(&nodeData->getPacket());
+
     // If we have a packet waiting, and our desired want color, doesn't match the current waiting packets color
     // then let's just send that waiting packet.
     if (!nodeData->getCurrentPacketFormatMatches()) {
@@ -344,6 +345,9 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
     // the current view frustum for things to send.
     if (viewFrustumChanged || nodeData->elementBag.isEmpty()) {
 
+        // a scene cut short by a view change doesn't tell us how fast a scene gets out
+        bool sceneCompleted = nodeData->elementBag.isEmpty();
+
         // if our view has changed, we need to reset these things...
         if (viewFrustumChanged) {
             if (nodeData->moveShouldDump() || nodeData->hasLodChanged()) {
@@ -371,6 +375,11 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         int packetsJustSent = handlePacketSend(nodeData, trueBytesSent, truePacketsSent);
         packetsSentThisInterval += packetsJustSent;
 
+        quint64 sceneNinetyPercentTime = nodeData->getSceneNinetyPercentTime();
+        if (sceneCompleted && sceneNinetyPercentTime > 0) {
+            OctreeServer::trackSceneNinetyPercentTime((float)sceneNinetyPercentTime);
+        }
+
         // If we're starting a full scene, then definitely we want to empty the elementBag
         if (isFullScene) {
             nodeData->elementBag.deleteAll();
@@ -564,6 +573,9 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
             }
             OctreeServer::trackTreeWaitTime(lockWaitElapsedUsec);
             OctreeServer::trackEncodeTime(encodeElapsedUsec);
+            if (encodeElapsedUsec != OctreeServer::SKIP_TIME) {
+                octreeEncodeUsecsMetric->observe(encodeElapsedUsec);
+            }
             OctreeServer::trackCompressAndWriteTime(compressAndWriteElapsedUsec);
             OctreeServer::trackPacketSendingTime(packetSendingElapsedUsec);
 
@@ -626,6 +638,9 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         if (nodeData->elementBag.isEmpty()) {
             nodeData->updateLastKnownViewFrustum();
             nodeData->setViewSent(true);
+            if (nodeData->isResumingCachedScene()) {
+                nodeData->cachedSceneResumed();
+            }
             nodeData->map.erase(); // It would be nice if we could save this, and only reset it when the view frustum changes
         }
 
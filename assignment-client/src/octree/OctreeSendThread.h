@@ -25,7 +25,8 @@ class OctreeServer;
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
-/// Threaded processor for sending octree packets to a single client
+/// Processor for sending octree packets to a single client, run once per send interval by the OctreeSendThreadPool.
+/// Emits finished() once it stops sending.
 class OctreeSendThread : public GenericThread {
     Q_OBJECT
 public:
@@ -34,6 +35,9 @@ public:
 
     void setIsShuttingDown();
 
+    /// Sends this interval's packets, returns false once we're done with this client.
+    virtual bool process();
+
     static AtomicUIntStat _totalBytes;
     static AtomicUIntStat _totalWastedBytes;
     static AtomicUIntStat _totalPackets;
@@ -44,10 +48,6 @@ public:
     static AtomicUIntStat _usleepTime;
     static AtomicUIntStat _usleepCalls;
 
-protected:
-    /// Implements generic processing behavior for this thread.
-    virtual bool process();
-
 private:
     OctreeServer* _myServer;
     SharedNodePointer _node;
@@ -0,0 +1,137 @@
+//
+//  OctreeSendThreadPool.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeSendThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <GenericThread.h>
+#include <PerfStat.h>
+#include <SharedUtil.h>
+
+#include "OctreeSendThread.h"
+#include "OctreeServerConsts.h"
+
+class OctreeSendWorker : public GenericThread {
+public:
+    OctreeSendWorker(OctreeSendThreadPool* pool) : _pool(pool) { }
+
+    virtual bool process() { return _pool->runNextSender(); }
+
+private:
+    OctreeSendThreadPool* _pool;
+};
+
+OctreeSendThreadPool::OctreeSendThreadPool(int numWorkers) {
+    numWorkers = std::max(1, numWorkers);
+
+    for (int i = 0; i < numWorkers; ++i) {
+        GenericThread* worker = new OctreeSendWorker(this);
+
+        // set our QThread object name so we can identify this thread while debugging
+        worker->setObjectName(QString("Octree Send Worker %1").arg(i));
+        worker->initialize(true);
+
+        _workers.push_back(worker);
+    }
+}
+
+OctreeSendThreadPool::~OctreeSendThreadPool() {
+    {
+        std::lock_guard<std::mutex> locker(_mutex);
+        _isStopping = true;
+    }
+    _condition.notify_all();
+
+    for (auto worker : _workers) {
+        worker->terminate();
+        worker->deleteLater();
+    }
+}
+
+void OctreeSendThreadPool::addSender(OctreeSendThread* sender) {
+    {
+        std::lock_guard<std::mutex> locker(_mutex);
+
+        quint64 token = ++_nextToken;
+        _senderTokens[sender] = token;
+        _schedule.push({ usecTimestampNow(), token, sender });
+    }
+    _condition.notify_all();
+}
+
+void OctreeSendThreadPool::removeSender(OctreeSendThread* sender) {
+    std::unique_lock<std::mutex> locker(_mutex);
+
+    // its entry in the schedule becomes stale and is dropped when it comes up
+    _senderTokens.erase(sender);
+
+    _condition.wait(locker, [&]{ return _runningSenders.count(sender) == 0; });
+}
+
+bool OctreeSendThreadPool::runNextSender() {
+    std::unique_lock<std::mutex> locker(_mutex);
+
+    while (!_isStopping) {
+        if (_schedule.empty()) {
+            _condition.wait(locker);
+            continue;
+        }
+
+        ScheduledSender next = _schedule.top();
+
+        auto it = _senderTokens.find(next.sender);
+        if (it == _senderTokens.end() || it->second != next.token) {
+            _schedule.pop();
+            continue;
+        }
+
+        quint64 now = usecTimestampNow();
+        if (next.sendTime > now) {
+            // sleep until the next interval is due, unless a sooner sender is added in the meantime
+            PerformanceWarning warn(false, "OctreeSendThreadPool... wait()", false,
+                                    &OctreeSendThread::_usleepTime, &OctreeSendThread::_usleepCalls);
+            _condition.wait_for(locker, std::chrono::microseconds(next.sendTime - now));
+            continue;
+        }
+
+        _schedule.pop();
+        _runningSenders.insert(next.sender);
+        locker.unlock();
+
+        bool keepSending = next.sender->process();
+
+        locker.lock();
+        _runningSenders.erase(next.sender);
+
+        it = _senderTokens.find(next.sender);
+        bool isScheduled = (it != _senderTokens.end() && it->second == next.token);
+
+        if (isScheduled && keepSending) {
+            quint64 sendTime = std::max(now + OCTREE_SEND_INTERVAL_USECS, usecTimestampNow());
+            _schedule.push({ sendTime, next.token, next.sender });
+        } else if (isScheduled) {
+            _senderTokens.erase(it);
+        }
+
+        locker.unlock();
+        _condition.notify_all();
+
+        if (isScheduled && !keepSending) {
+            // let the owner clean up, like it did when the sender ran on a thread of its own
+            emit next.sender->finished();
+        }
+
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,69 @@
+//
+//  OctreeSendThreadPool.h
+//  assignment-client/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Fixed set of worker threads that run the OctreeSendThread of every client
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendThreadPool_h
+#define hifi_OctreeSendThreadPool_h
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <QtCore/QtGlobal>
+
+class GenericThread;
+class OctreeSendThread;
+
+/// Runs every client's OctreeSendThread once per send interval on a fixed number of workers, instead of giving each
+/// client a thread of its own. Senders are picked in the order their interval comes due, so that an overloaded pool
+/// goes round robin over its clients, and a sender is never run by two workers at the same time.
+class OctreeSendThreadPool {
+public:
+    OctreeSendThreadPool(int numWorkers);
+    ~OctreeSendThreadPool();
+
+    /// schedules the sender to run right away, and then once per send interval until it asks to stop
+    void addSender(OctreeSendThread* sender);
+
+    /// unschedules the sender, blocks until no worker is running it anymore
+    void removeSender(OctreeSendThread* sender);
+
+    int getNumWorkers() const { return (int)_workers.size(); }
+
+    /// waits for the next sender that is due and runs it, returns false once the pool is stopping
+    bool runNextSender();
+
+private:
+    struct ScheduledSender {
+        quint64 sendTime;
+        quint64 token; // tells this schedule apart from the one of a later sender at the same address
+        OctreeSendThread* sender;
+
+        bool operator>(const ScheduledSender& other) const { return sendTime > other.sendTime; }
+    };
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+
+    std::priority_queue<ScheduledSender, std::vector<ScheduledSender>, std::greater<ScheduledSender>> _schedule;
+    std::unordered_map<OctreeSendThread*, quint64> _senderTokens;
+    std::unordered_set<OctreeSendThread*> _runningSenders;
+    quint64 _nextToken { 0 };
+    bool _isStopping { false };
+
+    std::vector<GenericThread*> _workers;
+};
+
+#endif // hifi_OctreeSendThreadPool_h
@@ -12,6 +12,7 @@
 #include "OctreeServer.h"
 
 #include <QJsonObject>
+#include <QProcessEnvironment>
 #include <QTimer>
 
 #include <time.h>
@@ -25,6 +26,7 @@
 
 #include "../AssignmentClient.h"
 
+#include "OctreeReplay.h"
 #include "OctreeServerConsts.h"
 
 OctreeServer* OctreeServer::_instance = NULL;
@@ -77,6 +79,8 @@ int OctreeServer::_longProcessWait = 0;
 int OctreeServer::_shortProcessWait = 0;
 int OctreeServer::_noProcessWait = 0;
 
+SimpleMovingAverage OctreeServer::_averageSceneNinetyPercentTime(MOVING_AVERAGE_SAMPLE_COUNTS);
+
 
 void OctreeServer::resetSendingStats() {
     _averageLoopTime.reset();
@@ -228,6 +232,9 @@ OctreeServer::OctreeServer(NLPacket& packet) :
     _jurisdictionSender(NULL),
     _octreeInboundPacketProcessor(NULL),
     _persistThread(NULL),
+    _sendThreadPool(NULL),
+    _numSendThreads(0),
+    _editPublishInterval(DEFAULT_EDIT_PUBLISH_INTERVAL_MSECS * USECS_PER_MSEC),
     _started(time(0)),
     _startedUSecs(usecTimestampNow())
 {
@@ -273,6 +280,9 @@ OctreeServer::~OctreeServer() {
         _persistThread->deleteLater();
     }
 
+    delete _sendThreadPool;
+    _sendThreadPool = NULL;
+
     delete _jurisdiction;
     _jurisdiction = NULL;
 
@@ -439,9 +449,15 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
         float averageInsideTime = getAverageInsideTime();
         statsString += QString().sprintf("               Average 'inside' time:    %9.2f usecs"
-                                         "                 samples: %12d \r\n\r\n",
+                                         "                 samples: %12d \r\n",
                                          (double)averageInsideTime, _averageInsideTime.getSampleCount());
 
+        float averageSceneNinetyPercentTime = getAverageSceneNinetyPercentTime();
+        statsString += QString().sprintf("      Average time to 90%% of a scene:    %9.2f usecs"
+                                         "                 samples: %12d \r\n\r\n",
+                                         (double)averageSceneNinetyPercentTime,
+                                         _averageSceneNinetyPercentTime.getSampleCount());
+
 
         // Process Wait
         {
@@ -863,6 +879,11 @@ void OctreeServer::handleOctreeQueryPacket(QSharedPointer<NLPacket> packet, Shar
         
         OctreeQueryNode* nodeData = dynamic_cast<OctreeQueryNode*>(senderNode->getLinkedData());
         if (nodeData && !nodeData->isOctreeSendThreadInitalized()) {
+            // a client back with the scene it kept from an earlier visit is only sent what changed since
+            quint64 cachedSceneTime = nodeData->getCachedSceneTime();
+            if (cachedSceneTime > 0 && nodeData->getWantDelta() && resumeCachedScene(nodeData, cachedSceneTime)) {
+                nodeData->resumeCachedScene(cachedSceneTime);
+            }
             nodeData->initializeOctreeSendThread(this, senderNode);
         }
     }
@@ -1016,7 +1037,10 @@ bool OctreeServer::readConfiguration() {
         strcpy(_persistFilename, qPrintable(persistFilename));
         qDebug("persistFilename=%s", _persistFilename);
 
+        // json.gz or the faster to load binary "entities" format
         _persistAsFileType = "json.gz";
+        readOptionString(QString("persistFileType"), settingsSectionObject, _persistAsFileType);
+        qDebug() << "persistFileType=" << _persistAsFileType;
 
         _persistInterval = OctreePersistThread::DEFAULT_PERSIST_INTERVAL;
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
@@ -1064,6 +1088,19 @@ bool OctreeServer::readConfiguration() {
     qDebug("packetsPerSecondTotalMax=%d _packetsTotalPerInterval=%d",
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
 
+    // Check to see if the user passed in a command line option for the number of send threads shared by all clients
+    readOptionInt(QString("sendThreads"), settingsSectionObject, _numSendThreads);
+    if (_numSendThreads < 1) {
+        _numSendThreads = QThread::idealThreadCount();
+    }
+    qDebug("sendThreads=%d", _numSendThreads);
+
+    // Check to see if the user passed in a command line option for how often inbound edits are applied to the tree
+    int editPublishInterval = DEFAULT_EDIT_PUBLISH_INTERVAL_MSECS;
+    readOptionInt(QString("editPublishInterval"), settingsSectionObject, editPublishInterval);
+    _editPublishInterval = std::max(0, editPublishInterval) * USECS_PER_MSEC;
+    qDebug("editPublishInterval=%d", editPublishInterval);
+
 
     return readAdditionalConfiguration(settingsSectionObject);
 }
@@ -1108,6 +1145,9 @@ void OctreeServer::run() {
     setvbuf(stdout, NULL, _IOLBF, 0);
 #endif
 
+    // set up the send threads before we have any clients to send to
+    _sendThreadPool = new OctreeSendThreadPool(_numSendThreads);
+
     nodeList->linkedDataCreateCallback = [] (Node* node) {
         OctreeQueryNode* newQueryNodeData = _instance->createOctreeQueryNode();
         newQueryNodeData->init();
@@ -1138,6 +1178,19 @@ void OctreeServer::run() {
     _octreeInboundPacketProcessor = new OctreeInboundPacketProcessor(this);
     _octreeInboundPacketProcessor->initialize(true);
 
+    // replay a capture of client traffic into the server, to measure it without live clients
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    QString replayPath = environment.value(OCTREE_REPLAY_FILE_ENV);
+    if (!replayPath.isEmpty()) {
+        float replaySpeed = environment.value(OCTREE_REPLAY_SPEED_ENV, "1").toFloat();
+        QString reportPath = environment.value(OCTREE_REPLAY_REPORT_ENV, replayPath + ".replay.json");
+        auto replay = new OctreeReplay(getMyReplayedPacketTypes(), _octreeInboundPacketProcessor, this);
+        connect(replay, &OctreeReplay::finished, replay, &QObject::deleteLater);
+        if (!replay->start(replayPath, replaySpeed, reportPath)) {
+            replay->deleteLater();
+        }
+    }
+
     // Convert now to tm struct for local timezone
     tm* localtm = localtime(&_started);
     const int MAX_TIME_LENGTH = 128;
@@ -1347,6 +1400,8 @@ void OctreeServer::sendStatsPacket() {
     threadsStats["2. packetDistributor"] = (double)howManyThreadsDidPacketDistributor(oneSecondAgo);
     threadsStats["3. handlePacektSend"] = (double)howManyThreadsDidHandlePacketSend(oneSecondAgo);
     threadsStats["4. writeDatagram"] = (double)howManyThreadsDidCallWriteDatagram(oneSecondAgo);
+    threadsStats["5. sendWorkers"] = (double)(_sendThreadPool ? _sendThreadPool->getNumWorkers() : 0);
+    threadsStats["6. sendWorkersIdleTime"] = (double)OctreeSendThread::_usleepTime;
     
     QJsonObject statsArray1;
     statsArray1["1. configuration"] = getConfiguration();
@@ -1379,6 +1434,7 @@ void OctreeServer::sendStatsPacket() {
     timingArray1["5. avgCompressAndWriteTime"] = getAverageCompressAndWriteTime();
     timingArray1["6. avgSendTime"] = getAveragePacketSendingTime();
     timingArray1["7. nodeWaitTime"] = getAverageNodeWaitTime();
+    timingArray1["8. avgSceneNinetyPercentTime"] = getAverageSceneNinetyPercentTime();
     
     QJsonObject statsObject2;
     statsObject2["data"] = dataObject1;
@@ -23,6 +23,7 @@
 
 #include "OctreePersistThread.h"
 #include "OctreeSendThread.h"
+#include "OctreeSendThreadPool.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
 
@@ -58,6 +59,10 @@ public:
 
     bool isInitialLoadComplete() const { return (_persistThread) ? _persistThread->isInitialLoadComplete() : true; }
     bool isPersistEnabled() const { return (_persistThread) ? true : false; }
+
+    OctreeSendThreadPool* getSendThreadPool() const { return _sendThreadPool; }
+
+    quint64 getEditPublishInterval() const { return _editPublishInterval; } /// in usecs
     quint64 getLoadElapsedTime() const { return (_persistThread) ? _persistThread->getLoadElapsedTime() : 0; }
 
     // Subclasses must implement these methods
@@ -74,6 +79,13 @@ public:
     virtual void beforeRun() { }
     virtual bool hasSpecialPacketsToSend(const SharedNodePointer& node) { return false; }
     virtual int sendSpecialPackets(const SharedNodePointer& node, OctreeQueryNode* queryNode, int& packetsSent) { return 0; }
+    /// the types a replay of captured traffic hands to this server, the rest of a capture is for the other assignments
+    virtual QSet<PacketType> getMyReplayedPacketTypes() const {
+        return { getMyQueryMessageType(), PacketType::OctreeDataNack };
+    }
+    /// whether a new client that kept the scene it was sent up to the cached scene time can be sent just the changes
+    /// since, and sets it up for them if it can
+    virtual bool resumeCachedScene(OctreeQueryNode* queryNode, quint64 cachedSceneTime) { return false; }
 
     static float SKIP_TIME; // use this for trackXXXTime() calls for non-times
 
@@ -101,6 +113,10 @@ public:
     static void trackProcessWaitTime(float time);
     static float getAverageProcessWaitTime() { return _averageProcessWaitTime.getAverage(); }
 
+    // usecs from the start of a completed scene until 90% of its elements with data went out
+    static void trackSceneNinetyPercentTime(float time) { _averageSceneNinetyPercentTime.updateAverage(time); }
+    static float getAverageSceneNinetyPercentTime() { return _averageSceneNinetyPercentTime.getAverage(); }
+
     // these methods allow us to track which threads got to various states
     static void didProcess(OctreeSendThread* thread);
     static void didPacketDistributor(OctreeSendThread* thread);
@@ -170,6 +186,9 @@ protected:
     JurisdictionSender* _jurisdictionSender;
     OctreeInboundPacketProcessor* _octreeInboundPacketProcessor;
     OctreePersistThread* _persistThread;
+    OctreeSendThreadPool* _sendThreadPool;
+    int _numSendThreads;
+    quint64 _editPublishInterval;
 
     int _persistInterval;
     bool _wantBackup;
@@ -229,6 +248,8 @@ protected:
     static int _shortProcessWait;
     static int _noProcessWait;
 
+    static SimpleMovingAverage _averageSceneNinetyPercentTime;
+
     static QMap<OctreeSendThread*, quint64> _threadsDidProcess;
     static QMap<OctreeSendThread*, quint64> _threadsDidPacketDistributor;
     static QMap<OctreeSendThread*, quint64> _threadsDidHandlePacketSend;
@@ -27,4 +27,8 @@ const int MAX_FILENAME_LENGTH = 1024;
 const int INTERVALS_PER_SECOND = 90;
 const int OCTREE_SEND_INTERVAL_USECS = (1000 * 1000)/INTERVALS_PER_SECOND;
 
+/// Inbound edits are decoded as they arrive but applied to the tree in batches, at most this often, so that a burst of
+/// edits takes the tree write lock once per batch instead of once per edit.
+const int DEFAULT_EDIT_PUBLISH_INTERVAL_MSECS = 10;
+
 #endif // hifi_OctreeServerConsts_h
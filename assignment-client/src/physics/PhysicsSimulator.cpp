@@ -0,0 +1,215 @@
+//
+//  PhysicsSimulator.cpp
+//  assignment-client/src/physics
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QEventLoop>
+#include <QtCore/QJsonObject>
+
+#include <GLMHelpers.h>
+#include <NodeList.h>
+#include <OctreeConstants.h>
+#include <PerfStat.h>
+#include <PhysicsHelpers.h>
+#include <udt/PacketHeaders.h>
+
+#include "PhysicsSimulator.h"
+
+static const QString PHYSICS_SIMULATOR_LOGGING_NAME = "physics-simulator";
+static const QString PHYSICS_SIMULATOR_SETTINGS_KEY = "physics_simulator";
+static const QString UPDATES_PER_SECOND_OPTION = "updates_per_second";
+
+static const int DEFAULT_UPDATES_PER_SECOND = 20;
+static const int QUERY_INTERVAL_MSECS = 1000;
+
+PhysicsSimulator::PhysicsSimulator(NLPacket& packet) :
+    ThreadedAssignment(packet),
+    _physicsEngine(new PhysicsEngine(Vectors::ZERO)),
+    _updatesPerSecond(DEFAULT_UPDATES_PER_SECOND)
+{
+    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+    packetReceiver.registerListenerForTypes(
+        { PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase },
+        this, "handleOctreePacket");
+    packetReceiver.registerListener(PacketType::Jurisdiction, this, "handleJurisdictionPacket");
+}
+
+void PhysicsSimulator::handleOctreePacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
+    auto packetType = packet->getType();
+
+    if (packetType == PacketType::OctreeStats) {
+
+        int statsMessageLength = OctreeHeadlessViewer::parseOctreeStats(packet, senderNode);
+        if (packet->getPayloadSize() > statsMessageLength) {
+            // pull out the piggybacked packet and create a new QSharedPointer<NLPacket> for it
+            int piggyBackedSizeWithHeader = packet->getPayloadSize() - statsMessageLength;
+
+            auto buffer = udt::PacketBufferPool::allocate(piggyBackedSizeWithHeader);
+            memcpy(buffer.get(), packet->getPayload() + statsMessageLength, piggyBackedSizeWithHeader);
+
+            auto newPacket = NLPacket::fromReceivedPacket(std::move(buffer), piggyBackedSizeWithHeader,
+                                                          packet->getSenderSockAddr());
+            packet = QSharedPointer<NLPacket>(newPacket.release());
+        } else {
+            return; // bail since no piggyback data
+        }
+
+        packetType = packet->getType();
+    } // fall through to piggyback message
+
+    if (packetType == PacketType::EntityData || packetType == PacketType::EntityErase) {
+        _entityViewer.processDatagram(*packet, senderNode);
+    }
+}
+
+void PhysicsSimulator::handleJurisdictionPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
+    NodeType_t nodeType;
+    packet->peekPrimitive(&nodeType);
+
+    // PacketType_JURISDICTION, first byte is the node type...
+    if (nodeType == NodeType::EntityServer && _jurisdictionListener) {
+        _jurisdictionListener->queueReceivedPacket(packet, senderNode);
+    }
+}
+
+void PhysicsSimulator::run() {
+    ThreadedAssignment::commonInit(PHYSICS_SIMULATOR_LOGGING_NAME, NodeType::PhysicsSimulator);
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->addNodeTypeToInterestSet(NodeType::EntityServer);
+
+    // wait until we have the domain-server settings, otherwise we bail
+    DomainHandler& domainHandler = nodeList->getDomainHandler();
+
+    qDebug() << "Waiting for domain settings from domain-server.";
+
+    // block until we get the settingsRequestComplete signal
+    QEventLoop loop;
+    connect(&domainHandler, &DomainHandler::settingsReceived, &loop, &QEventLoop::quit);
+    connect(&domainHandler, &DomainHandler::settingsReceiveFail, &loop, &QEventLoop::quit);
+    domainHandler.requestDomainSettings();
+    loop.exec();
+
+    if (domainHandler.getSettingsObject().isEmpty()) {
+        qDebug() << "Failed to retreive settings object from domain-server. Bailing on assignment.";
+        setFinished(true);
+        return;
+    }
+
+    parseDomainServerSettings(domainHandler.getSettingsObject());
+
+    _jurisdictionListener = new JurisdictionListener(NodeType::EntityServer);
+    _jurisdictionListener->initialize(true);
+
+    _entityEditSender.setServerJurisdictions(_jurisdictionListener->getJurisdictions());
+    _entityEditSender.initialize(true);
+
+    // the simulator needs every entity of the domain, not just those in view of some camera
+    _entityViewer.setJurisdictionListener(_jurisdictionListener);
+    _entityViewer.init();
+    _entityViewer.addInterestBox(glm::vec3(-HALF_TREE_SCALE), glm::vec3(TREE_SCALE));
+    _entityViewer.setVoxelSizeScale(DEFAULT_OCTREE_SIZE_SCALE * TREE_SCALE);
+
+    ObjectMotionState::setShapeManager(&_shapeManager);
+    _physicsEngine->init();
+    _physicsEngine->setAuthoritativeSimulation(true);
+    connect(nodeList.data(), &NodeList::uuidChanged, this, &PhysicsSimulator::updateSessionUUID);
+    updateSessionUUID(nodeList->getSessionUUID());
+
+    EntityTreePointer tree = _entityViewer.getTree();
+    _entitySimulation.init(tree, _physicsEngine, &_entityEditSender);
+    _entitySimulation.setSubstepsBetweenUpdates((uint32_t)glm::max(1, (int)glm::round(
+        1.0f / (PHYSICS_ENGINE_FIXED_SUBSTEP * _updatesPerSecond))));
+    tree->setSimulation(&_entitySimulation);
+
+    _queryTimer = new QTimer(this);
+    connect(_queryTimer, &QTimer::timeout, &_entityViewer, &EntityTreeHeadlessViewer::queryOctree);
+    _queryTimer->start(QUERY_INTERVAL_MSECS);
+
+    _stepTimer = new QTimer(this);
+    _stepTimer->setTimerType(Qt::PreciseTimer);
+    connect(_stepTimer, &QTimer::timeout, this, &PhysicsSimulator::step);
+    _stepTimer->start((int)(PHYSICS_ENGINE_FIXED_SUBSTEP * MSECS_PER_SECOND));
+}
+
+void PhysicsSimulator::parseDomainServerSettings(const QJsonObject& domainSettings) {
+    QJsonObject simulatorSettings = domainSettings[PHYSICS_SIMULATOR_SETTINGS_KEY].toObject();
+    if (simulatorSettings.contains(UPDATES_PER_SECOND_OPTION)) {
+        _updatesPerSecond = glm::clamp(simulatorSettings[UPDATES_PER_SECOND_OPTION].toInt(), 1,
+                                       (int)(1.0f / PHYSICS_ENGINE_FIXED_SUBSTEP));
+    }
+    qDebug() << "Sending the updates of the simulated entities" << _updatesPerSecond << "times per second.";
+}
+
+void PhysicsSimulator::updateSessionUUID(const QUuid& sessionUUID) {
+    _physicsEngine->setSessionUUID(sessionUUID);
+}
+
+void PhysicsSimulator::step() {
+    PerformanceTimer perfTimer("physics");
+    EntityTreePointer tree = _entityViewer.getTree();
+
+    // the same order of operations as the physics of the interface, without an avatar
+    static VectorOfMotionStates motionStates;
+    _entitySimulation.getObjectsToDelete(motionStates);
+    _physicsEngine->deleteObjects(motionStates);
+
+    tree->withWriteLock([&] {
+        _entitySimulation.getObjectsToAdd(motionStates);
+        _physicsEngine->addObjects(motionStates);
+    });
+    tree->withWriteLock([&] {
+        _entitySimulation.getObjectsToChange(motionStates);
+        VectorOfMotionStates stillNeedChange = _physicsEngine->changeObjects(motionStates);
+        _entitySimulation.setObjectsToChange(stillNeedChange);
+    });
+
+    _entitySimulation.applyActionChanges();
+
+    quint64 stepStart = usecTimestampNow();
+    tree->withWriteLock([&] {
+        _physicsEngine->stepSimulation();
+    });
+    _totalStepUsecs += usecTimestampNow() - stepStart;
+    _numSteps++;
+
+    if (_physicsEngine->hasOutgoingChanges()) {
+        tree->withWriteLock([&] {
+            _entitySimulation.handleOutgoingChanges(_physicsEngine->getOutgoingChanges(), _physicsEngine->getSessionID());
+        });
+        _entitySimulation.handleCollisionEvents(_physicsEngine->getCollisionEvents());
+        _entityViewer.update();
+    }
+}
+
+void PhysicsSimulator::sendStatsPacket() {
+    QJsonObject statsObject;
+    statsObject["octree_elements"] = (int)_entityViewer.getOctreeElementsCount();
+    statsObject["average_step_usecs"] = _numSteps > 0 ? (double)_totalStepUsecs / _numSteps : 0.0;
+    _totalStepUsecs = 0;
+    _numSteps = 0;
+    addPacketStatsAndSendStatsPacket(statsObject);
+}
+
+void PhysicsSimulator::aboutToFinish() {
+    if (_stepTimer) {
+        _stepTimer->stop();
+    }
+    if (_queryTimer) {
+        _queryTimer->stop();
+    }
+
+    _entityViewer.getTree()->setSimulation(nullptr);
+
+    _entityEditSender.terminate();
+    if (_jurisdictionListener) {
+        _jurisdictionListener->terminate();
+        _jurisdictionListener->deleteLater();
+        _jurisdictionListener = nullptr;
+    }
+}
@@ -0,0 +1,61 @@
+//
+//  PhysicsSimulator.h
+//  assignment-client/src/physics
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsSimulator_h
+#define hifi_PhysicsSimulator_h
+
+#include <QtCore/QTimer>
+
+#include <EntityEditPacketSender.h>
+#include <EntityTreeHeadlessViewer.h>
+#include <JurisdictionListener.h>
+#include <PhysicalEntitySimulation.h>
+#include <PhysicsEngine.h>
+#include <ShapeManager.h>
+#include <ThreadedAssignment.h>
+
+// Runs the physics of the domain on the server side. It follows the whole entity tree like a headless viewer, claims
+// every moving entity at AUTHORITATIVE priority and sends their updates to the entity servers, which the clients then
+// follow kinematically. The entities that are held or driven by actions stay with the client that drives them.
+class PhysicsSimulator : public ThreadedAssignment {
+    Q_OBJECT
+public:
+    PhysicsSimulator(NLPacket& packet);
+
+    virtual void aboutToFinish() override;
+
+public slots:
+    void run();
+    virtual void sendStatsPacket() override;
+
+private slots:
+    void handleOctreePacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
+    void handleJurisdictionPacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
+    void updateSessionUUID(const QUuid& sessionUUID);
+    void step();
+
+private:
+    void parseDomainServerSettings(const QJsonObject& domainSettings);
+
+    JurisdictionListener* _jurisdictionListener { nullptr };
+    EntityEditPacketSender _entityEditSender;
+    EntityTreeHeadlessViewer _entityViewer;
+    ShapeManager _shapeManager;
+    PhysicsEnginePointer _physicsEngine;
+    PhysicalEntitySimulation _entitySimulation;
+
+    QTimer* _queryTimer { nullptr };
+    QTimer* _stepTimer { nullptr };
+    int _updatesPerSecond;
+    quint64 _totalStepUsecs { 0 };
+    int _numSteps { 0 };
+};
+
+#endif // hifi_PhysicsSimulator_h
@@ -33,7 +33,8 @@
 #
 # setup_hifi_testcase(Network etc)
 #
-# Additionally, all .cpp files in the src dir (eg tests/my-foo-test/src) must:
+# Additionally, all .cpp files in the src dir (eg tests/my-foo-test/src) must be named *Test[s].cpp or
+# *Benchmark[s].cpp, and:
 # - Contain exactly one test class (any supporting code must be either external or inline in a .hpp file)
 #   - Be built against QtTestLib (test class should be a QObject, with test methods defined as private slots)
 #   - Contain a QTEST_MAIN declaration at the end of the file (or at least be a standalone executable)
@@ -62,9 +63,10 @@ macro(SETUP_HIFI_TESTCASE)
     endforeach()
 
     # Find test classes to build into test executables.
-    # Warn about any .cpp files that are *not* test classes (*Test[s].cpp), since those files will not be used.
+    # Warn about any .cpp files that are *not* test classes (*Test[s].cpp or *Benchmark[s].cpp), since those files
+    # will not be used.
     foreach (SRC_FILE ${TEST_PROJ_SRC_FILES})   
-      string(REGEX MATCH ".+Tests?\\.cpp$"   TEST_CPP_FILE ${SRC_FILE})
+      string(REGEX MATCH ".+(Tests?|Benchmarks?)\\.cpp$"   TEST_CPP_FILE ${SRC_FILE})
       string(REGEX MATCH ".+\\.cpp$"     NON_TEST_CPP_FILE ${SRC_FILE}) 
       if (TEST_CPP_FILE)
         list(APPEND TEST_CASE_FILES ${TEST_CPP_FILE})
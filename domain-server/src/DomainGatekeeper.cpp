@@ -48,7 +48,7 @@ QUuid DomainGatekeeper::assignmentUUIDForPendingAssignment(const QUuid& tempUUID
 
 const NodeSet STATICALLY_ASSIGNED_NODES = NodeSet() << NodeType::AudioMixer
     << NodeType::AvatarMixer << NodeType::EntityServer
-    << NodeType::AssetServer;
+    << NodeType::AssetServer << NodeType::PhysicsSimulator;
 
 void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<NLPacket> packet) {
     if (packet->getPayloadSize() == 0) {
@@ -66,7 +66,8 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<NLPacket> pack
     }
     
     static const NodeSet VALID_NODE_TYPES {
-        NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::AssetServer, NodeType::EntityServer, NodeType::Agent
+        NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::AssetServer, NodeType::EntityServer, NodeType::Agent,
+        NodeType::PhysicsSimulator
     };
     
     if (!VALID_NODE_TYPES.contains(nodeConnection.nodeType)) {
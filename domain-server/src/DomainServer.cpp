@@ -11,10 +11,14 @@
 
 #include "DomainServer.h"
 
+#include <openssl/rand.h>
+
+#include <QCryptographicHash>
 #include <QDir>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QMessageAuthenticationCode>
 #include <QProcess>
 #include <QSharedMemory>
 #include <QStandardPaths>
@@ -90,6 +94,14 @@ DomainServer::DomainServer(int argc, char* argv[]) :
 
     qRegisterMetaType<DomainServerWebSessionData>("DomainServerWebSessionData");
     qRegisterMetaTypeStreamOperators<DomainServerWebSessionData>("DomainServerWebSessionData");
+
+    // the key the connection secrets are derived from, new every time the domain-server starts since the nodes
+    // get new session UUIDs and secrets when it does
+    _connectionSecretKey.resize(CONNECTION_SECRET_KEY_BYTES);
+    if (RAND_bytes(reinterpret_cast<unsigned char*>(_connectionSecretKey.data()), CONNECTION_SECRET_KEY_BYTES) != 1) {
+        qWarning() << "Could not generate a random connection secret key, falling back to random UUIDs.";
+        _connectionSecretKey = QUuid::createUuid().toRfc4122() + QUuid::createUuid().toRfc4122();
+    }
     
     // make sure we hear about newly connected nodes from our gatekeeper
     connect(&_gatekeeper, &DomainGatekeeper::connectedNode, this, &DomainServer::handleConnectedNode);
@@ -553,7 +565,6 @@ void DomainServer::populateDefaultStaticAssignmentsExcludingTypes(const QSet<Ass
          defaultedType != Assignment::AllTypes;
          defaultedType =  static_cast<Assignment::Type>(static_cast<int>(defaultedType) + 1)) {
         if (!excludedTypes.contains(defaultedType)
-            && defaultedType != Assignment::UNUSED_0
             && defaultedType != Assignment::UNUSED_1
             && defaultedType != Assignment::AgentType) {
             
@@ -567,6 +578,15 @@ void DomainServer::populateDefaultStaticAssignmentsExcludingTypes(const QSet<Ass
                     continue;
                 }
             }
+
+            if (defaultedType == Assignment::PhysicsSimulatorType) {
+                // the physics of the domain runs on the interfaces unless a simulator is asked for
+                static const QString PHYSICS_SIMULATOR_ENABLED_KEYPATH = "physics_simulator.enabled";
+
+                if (!_settingsManager.valueOrDefaultValueForKeyPath(PHYSICS_SIMULATOR_ENABLED_KEYPATH).toBool()) {
+                    continue;
+                }
+            }
             
             // type has not been set from a command line or config file config, use the default
             // by clearing whatever exists and writing a single default assignment with no payload
@@ -581,15 +601,28 @@ void DomainServer::processListRequestPacket(QSharedPointer<NLPacket> packet, Sha
     QDataStream packetStream(packet.data());
     NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, packet->getSenderSockAddr(), false);
 
-    // update this node's sockets in case they have changed
-    sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
-    sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    // the version of the domain list the node has, zero if it has none
+    quint32 knownListVersion = 0;
+    packetStream >> knownListVersion;
+
+    // update this node's sockets in case they have changed, the other nodes get them with their next list
+    if (sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr
+        || sendingNode->getLocalSocket() != nodeRequestData.localSockAddr) {
+        sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
+        sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+        recordNodeListChange(sendingNode, false);
+    }
     
     // update the NodeInterestSet in case there have been any changes
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
-    nodeData->setNodeInterestSet(nodeRequestData.interestList.toSet());
+    NodeSet nodeInterestSet = nodeRequestData.interestList.toSet();
+    if (nodeInterestSet != nodeData->getNodeInterestSet()) {
+        // the changes since the node's list don't have the nodes of the types it wasn't interested in
+        nodeData->setNodeInterestSet(nodeInterestSet);
+        knownListVersion = 0;
+    }
 
-    sendDomainListToNode(sendingNode, packet->getSenderSockAddr());
+    sendDomainListToNode(sendingNode, packet->getSenderSockAddr(), knownListVersion);
 }
 
 unsigned int DomainServer::countConnectedUsers() {
@@ -641,6 +674,8 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(newNode->getLinkedData());
     
+    recordNodeListChange(newNode, false);
+
     // reply back to the user with a PacketType::DomainList
     sendDomainListToNode(newNode, nodeData->getSendingSockAddr());
     
@@ -648,8 +683,38 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     broadcastNewNode(newNode);
 }
 
-void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
-    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2;
+// the changes kept for the nodes checking in, a node with an older list gets a full one
+const size_t MAX_NODE_LIST_CHANGES = 1024;
+
+// a packet of an incremental list can be lost like any other, so every so often a node gets a full list instead
+const int MAX_INCREMENTAL_DOMAIN_LISTS = 30;
+
+void DomainServer::recordNodeListChange(const SharedNodePointer& node, bool isRemoved) {
+    _nodeListChanges.push_back({ ++_nodeListVersion, node->getUUID(), node->getType(), isRemoved });
+    if (_nodeListChanges.size() > MAX_NODE_LIST_CHANGES) {
+        _nodeListChanges.pop_front();
+    }
+}
+
+bool DomainServer::hasNodeListChangesSince(quint32 listVersion) const {
+    if (listVersion == 0 || listVersion > _nodeListVersion) {
+        // the node has no list, or one from before this domain-server started
+        return false;
+    }
+    return listVersion == _nodeListVersion || (!_nodeListChanges.empty() && _nodeListChanges.front().version <= listVersion + 1);
+}
+
+void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
+                                        quint32 knownListVersion) {
+    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2
+        + sizeof(quint32) + sizeof(quint32);
+
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+
+    // a node that has a list we still have the changes since only gets those changes
+    bool isIncremental = hasNodeListChangesSince(knownListVersion)
+        && nodeData->getIncrementalListCount() < MAX_INCREMENTAL_DOMAIN_LISTS;
+    nodeData->setIncrementalListCount(isIncremental ? nodeData->getIncrementalListCount() + 1 : 0);
     
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
@@ -663,37 +728,66 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     extendedHeaderStream << (quint8) node->getCanAdjustLocks();
     extendedHeaderStream << (quint8) node->getCanRez();
 
+    // the version of this list, and the one an incremental list applies to
+    extendedHeaderStream << _nodeListVersion;
+    extendedHeaderStream << (isIncremental ? knownListVersion : (quint32) 0);
+
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
-
     // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
     auto& nodeInterestSet = nodeData->getNodeInterestSet();
 
+    auto addNodeToList = [&](const SharedNodePointer& otherNode) {
+        // since we're about to add a node to the packet we start a segment
+        domainListPackets->startSegment();
+
+        domainListStream << DomainListEntry::AddedNode;
+
+        // don't send avatar nodes to other avatars, that will come from avatar mixer
+        domainListStream << *otherNode.data();
+
+        // pack the secret that these two nodes will use to communicate with each other
+        domainListStream << connectionSecretForNodes(node, otherNode);
+
+        // we've added the node we wanted so end the segment now
+        domainListPackets->endSegment();
+    };
+
     if (nodeInterestSet.size() > 0) {
 
         // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
         if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
-                if (otherNode->getUUID() != node->getUUID() && nodeInterestSet.contains(otherNode->getType())) {
-                    
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
-
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
-
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+            if (isIncremental) {
+                // only the last change to each node matters
+                QHash<QUuid, bool> changedNodes;
+                for (const auto& change : _nodeListChanges) {
+                    if (change.version > knownListVersion && change.nodeUUID != node->getUUID()
+                        && nodeInterestSet.contains(change.nodeType)) {
+                        changedNodes[change.nodeUUID] = change.isRemoved;
+                    }
+                }
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
+                for (auto it = changedNodes.constBegin(); it != changedNodes.constEnd(); ++it) {
+                    SharedNodePointer otherNode = it.value() ? SharedNodePointer() : limitedNodeList->nodeWithUUID(it.key());
+                    if (otherNode) {
+                        addNodeToList(otherNode);
+                    } else {
+                        domainListPackets->startSegment();
+                        domainListStream << DomainListEntry::RemovedNode << it.key();
+                        domainListPackets->endSegment();
+                    }
                 }
-            });
+            } else {
+                // if this authenticated node has any interest types, send back those nodes as well
+                limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
+                    if (otherNode->getUUID() != node->getUUID() && nodeInterestSet.contains(otherNode->getType())) {
+                        addNodeToList(otherNode);
+                    }
+                });
+            }
         }
     }
     
@@ -705,24 +799,16 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
 }
 
 QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
-    DomainServerNodeData* nodeAData = dynamic_cast<DomainServerNodeData*>(nodeA->getLinkedData());
-    DomainServerNodeData* nodeBData = dynamic_cast<DomainServerNodeData*>(nodeB->getLinkedData());
-
-    if (nodeAData && nodeBData) {
-        QUuid& secretUUID = nodeAData->getSessionSecretHash()[nodeB->getUUID()];
+    // the secret of a pair is derived from the key and their UUIDs rather than stored, so that it costs nothing for
+    // the pairs that never hear of each other, and both nodes get the same one whichever asks first
+    const QUuid& firstUUID = nodeA->getUUID() < nodeB->getUUID() ? nodeA->getUUID() : nodeB->getUUID();
+    const QUuid& secondUUID = nodeA->getUUID() < nodeB->getUUID() ? nodeB->getUUID() : nodeA->getUUID();
 
-        if (secretUUID.isNull()) {
-            // generate a new secret UUID these two nodes can use
-            secretUUID = QUuid::createUuid();
+    QMessageAuthenticationCode secretCode(QCryptographicHash::Sha256, _connectionSecretKey);
+    secretCode.addData(firstUUID.toRfc4122());
+    secretCode.addData(secondUUID.toRfc4122());
 
-            // set it on the other Node's sessionSecretHash
-            reinterpret_cast<DomainServerNodeData*>(nodeBData)->getSessionSecretHash().insert(nodeA->getUUID(), secretUUID);
-        }
-
-        return secretUUID;
-    }
-
-    return QUuid();
+    return QUuid::fromRfc4122(secretCode.result().left(NUM_BYTES_RFC4122_UUID));
 }
 
 void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
@@ -1211,13 +1297,25 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             QJsonObject rootJSON;
             QJsonArray nodesJSONArray;
 
+            // a monitor that polls can pass the timestamp of its last response as since, to only get the nodes that
+            // connected or sent stats after it
+            const QString SINCE_QUERY_KEY = "since";
+            qint64 sinceMsecs = QUrlQuery(url).queryItemValue(SINCE_QUERY_KEY).toLongLong();
+            qint64 nowMsecs = QDateTime::currentMSecsSinceEpoch();
+
             // enumerate the NodeList to find the assigned nodes
-            nodeList->eachNode([this, &nodesJSONArray](const SharedNodePointer& node){
+            nodeList->eachNode([this, &nodesJSONArray, sinceMsecs](const SharedNodePointer& node){
+                DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+                if (sinceMsecs > 0 && node->getWakeTimestamp() < (quint64)sinceMsecs
+                    && nodeData->getStatsTimestamp() < sinceMsecs) {
+                    return;
+                }
                 // add the node using the UUID as the key
                 nodesJSONArray.append(jsonObjectForNode(node));
             });
 
             rootJSON["nodes"] = nodesJSONArray;
+            rootJSON["timestamp"] = QString::number(nowMsecs);
 
             // print out the created JSON
             QJsonDocument nodesDocument(rootJSON);
@@ -1237,17 +1335,13 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                 // see if we have a node that matches this ID
                 SharedNodePointer matchingNode = nodeList->nodeWithUUID(matchingUUID);
                 if (matchingNode) {
-                    // create a QJsonDocument with the stats QJsonObject
-                    QJsonObject statsObject =
-                        reinterpret_cast<DomainServerNodeData*>(matchingNode->getLinkedData())->getStatsJSONObject();
-
-                    // add the node type to the JSON data for output purposes
-                    statsObject["node_type"] = NodeType::getNodeTypeName(matchingNode->getType()).toLower().replace(' ', '-');
-
-                    QJsonDocument statsDocument(statsObject);
+                    // the rendered stats are kept until the node sends new ones
+                    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(matchingNode->getLinkedData());
+                    QString nodeTypeName = NodeType::getNodeTypeName(matchingNode->getType()).toLower().replace(' ', '-');
 
                     // send the response
-                    connection->respond(HTTPConnection::StatusCode200, statsDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+                    connection->respond(HTTPConnection::StatusCode200, nodeData->getStatsJSON(nodeTypeName),
+                                        qPrintable(JSON_MIME_TYPE));
 
                     // tell the caller we processed the request
                     return true;
@@ -1645,6 +1739,8 @@ void DomainServer::nodeAdded(SharedNodePointer node) {
 
 void DomainServer::nodeKilled(SharedNodePointer node) {
 
+    recordNodeListChange(node, true);
+
     // if this peer connected via ICE then remove them from our ICE peers hash
     _gatekeeper.removeICEPeer(node->getUUID());
 
@@ -1663,14 +1759,6 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
         // If this node was an Agent ask DomainServerNodeData to potentially remove the interpolation we stored
         nodeData->removeOverrideForKey(USERNAME_UUID_REPLACEMENT_STATS_KEY,
                                        uuidStringWithoutCurlyBraces(node->getUUID()));
-
-        // cleanup the connection secrets that we set up for this node (on the other nodes)
-        foreach (const QUuid& otherNodeSessionUUID, nodeData->getSessionSecretHash().keys()) {
-            SharedNodePointer otherNode = DependencyManager::get<LimitedNodeList>()->nodeWithUUID(otherNodeSessionUUID);
-            if (otherNode) {
-                reinterpret_cast<DomainServerNodeData*>(otherNode->getLinkedData())->getSessionSecretHash().remove(node->getUUID());
-            }
-        }
     }
 }
 
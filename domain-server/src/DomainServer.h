@@ -12,6 +12,8 @@
 #ifndef hifi_DomainServer_h
 #define hifi_DomainServer_h
 
+#include <deque>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QHash>
 #include <QtCore/QJsonObject>
@@ -88,7 +90,11 @@ private:
 
     unsigned int countConnectedUsers();
 
-    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
+    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
+                              quint32 knownListVersion = 0);
+
+    void recordNodeListChange(const SharedNodePointer& node, bool isRemoved);
+    bool hasNodeListChangesSince(quint32 listVersion) const;
 
     QUuid connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
     void broadcastNewNode(const SharedNodePointer& node);
@@ -143,6 +149,19 @@ private:
     DomainServerSettingsManager _settingsManager;
 
     HifiSockAddr _iceServerSocket;
+
+    // the nodes that connected, moved or left, so that the nodes checking in get the changes since their last list
+    struct NodeListChange {
+        quint32 version;
+        QUuid nodeUUID;
+        NodeType_t nodeType;
+        bool isRemoved;
+    };
+    quint32 _nodeListVersion { 0 };
+    std::deque<NodeListChange> _nodeListChanges;
+
+    static const int CONNECTION_SECRET_KEY_BYTES = 32;
+    QByteArray _connectionSecretKey;
     
     friend class DomainGatekeeper;
 };
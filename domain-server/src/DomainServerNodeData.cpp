@@ -10,6 +10,7 @@
 //
 
 #include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -20,15 +21,45 @@
 #include "DomainServerNodeData.h"
 
 DomainServerNodeData::StringPairHash DomainServerNodeData::_overrideHash;
+int DomainServerNodeData::_overrideGeneration = 0;
 
 DomainServerNodeData::DomainServerNodeData() {
     _paymentIntervalTimer.start();
 }
 
 void DomainServerNodeData::updateJSONStats(QByteArray statsByteArray) {
-    auto document = QJsonDocument::fromBinaryData(statsByteArray);
-    Q_ASSERT(document.isObject());
-    _statsJSONObject = overrideValuesIfNeeded(document.object());
+    _statsByteArray = statsByteArray;
+    _statsTimestamp = QDateTime::currentMSecsSinceEpoch();
+    _isStatsJSONObjectStale = true;
+    _isStatsJSONStale = true;
+}
+
+const QJsonObject& DomainServerNodeData::getStatsJSONObject() {
+    if (_statsOverrideGeneration != _overrideGeneration) {
+        _statsOverrideGeneration = _overrideGeneration;
+        _isStatsJSONObjectStale = !_statsByteArray.isEmpty();
+        _isStatsJSONStale = true;
+    }
+    if (_isStatsJSONObjectStale) {
+        auto document = QJsonDocument::fromBinaryData(_statsByteArray);
+        Q_ASSERT(document.isObject());
+        _statsJSONObject = overrideValuesIfNeeded(document.object());
+        _isStatsJSONObjectStale = false;
+    }
+    return _statsJSONObject;
+}
+
+const QByteArray& DomainServerNodeData::getStatsJSON(const QString& nodeTypeName) {
+    const QJsonObject& statsJSONObject = getStatsJSONObject();
+    if (_isStatsJSONStale || _statsJSON.isEmpty()) {
+        QJsonObject statsObject = statsJSONObject;
+
+        // add the node type to the JSON data for output purposes
+        statsObject["node_type"] = nodeTypeName;
+        _statsJSON = QJsonDocument(statsObject).toJson();
+        _isStatsJSONStale = false;
+    }
+    return _statsJSON;
 }
 
 QJsonObject DomainServerNodeData::overrideValuesIfNeeded(const QJsonObject& newStats) {
@@ -70,9 +101,12 @@ void DomainServerNodeData::addOverrideForKey(const QString& key, const QString&
                                              const QString& overrideValue) {
     // Insert override value
     _overrideHash.insert({key, value}, overrideValue);
+    ++_overrideGeneration;
 }
 
 void DomainServerNodeData::removeOverrideForKey(const QString& key, const QString& value) {
     // Remove override value
-    _overrideHash.remove({key, value});
+    if (_overrideHash.remove({key, value}) > 0) {
+        ++_overrideGeneration;
+    }
 }
@@ -25,10 +25,17 @@ class DomainServerNodeData : public NodeData {
 public:
     DomainServerNodeData();
 
-    const QJsonObject& getStatsJSONObject() const { return _statsJSONObject; }
+    // the stats are only parsed and rendered when they are asked for, since most are replaced before anyone does
+    const QJsonObject& getStatsJSONObject();
+
+    // the stats with the node type added as node_type, rendered once per update
+    const QByteArray& getStatsJSON(const QString& nodeTypeName);
 
     void updateJSONStats(QByteArray statsByteArray);
 
+    // the time of the last stats, in msecs since the epoch, zero if the node hasn't sent any
+    qint64 getStatsTimestamp() const { return _statsTimestamp; }
+
     void setAssignmentUUID(const QUuid& assignmentUUID) { _assignmentUUID = assignmentUUID; }
     const QUuid& getAssignmentUUID() const { return _assignmentUUID; }
 
@@ -46,11 +53,13 @@ public:
     void setIsAuthenticated(bool isAuthenticated) { _isAuthenticated = isAuthenticated; }
     bool isAuthenticated() const { return _isAuthenticated; }
 
-    QHash<QUuid, QUuid>& getSessionSecretHash() { return _sessionSecretHash; }
-
     const NodeSet& getNodeInterestSet() const { return _nodeInterestSet; }
     void setNodeInterestSet(const NodeSet& nodeInterestSet) { _nodeInterestSet = nodeInterestSet; }
     
+    // the incremental domain lists sent since the last full one
+    int getIncrementalListCount() const { return _incrementalListCount; }
+    void setIncrementalListCount(int incrementalListCount) { _incrementalListCount = incrementalListCount; }
+
     void setNodeVersion(const QString& nodeVersion) { _nodeVersion = nodeVersion; }
     const QString& getNodeVersion() { return _nodeVersion; }
     
@@ -61,19 +70,26 @@ private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
     QJsonArray overrideValuesIfNeeded(const QJsonArray& newStats);
     
-    QHash<QUuid, QUuid> _sessionSecretHash;
     QUuid _assignmentUUID;
     QUuid _walletUUID;
     QString _username;
     QElapsedTimer _paymentIntervalTimer;
     
     using StringPairHash = QHash<QPair<QString, QString>, QString>;
+    QByteArray _statsByteArray;
+    qint64 _statsTimestamp = 0;
     QJsonObject _statsJSONObject;
+    QByteArray _statsJSON;
+    bool _isStatsJSONObjectStale = false;
+    bool _isStatsJSONStale = false;
+    int _statsOverrideGeneration = 0;
     static StringPairHash _overrideHash;
+    static int _overrideGeneration; // bumped when the overrides change, so that the rendered stats get them
     
     HifiSockAddr _sendingSockAddr;
     bool _isAuthenticated = true;
     NodeSet _nodeInterestSet;
+    int _incrementalListCount = 0;
     QString _nodeVersion;
 };
 
@@ -72,8 +72,6 @@ var MSEC_PER_SEC = 1000.0;
 var LIFETIME = 10;
 var ACTION_TTL = 15; // seconds
 var ACTION_TTL_REFRESH = 5;
-var PICKS_PER_SECOND_PER_HAND = 5;
-var MSECS_PER_SEC = 1000.0;
 var GRABBABLE_PROPERTIES = ["position",
                             "rotation",
                             "gravity",
@@ -163,6 +161,7 @@ function entityIsGrabbedByOther(entityID) {
 
 function MyController(hand) {
     this.hand = hand;
+    this.rayPick = Entities.createRayPick({ precisionPicking: true });
     if (this.hand === RIGHT_HAND) {
         this.getHandPosition = MyAvatar.getRightPalmPosition;
         this.getHandRotation = MyAvatar.getRightPalmRotation;
@@ -307,7 +306,6 @@ function MyController(hand) {
 
     this.off = function() {
         if (this.triggerSmoothedSqueezed()) {
-            this.lastPickTime = 0;
             this.setState(STATE_SEARCHING);
             return;
         }
@@ -336,13 +334,8 @@ function MyController(hand) {
 
         this.lineOn(distantPickRay.origin, Vec3.multiply(distantPickRay.direction, LINE_LENGTH), NO_INTERSECT_COLOR);
 
-        // don't pick 60x per second.
-        var pickRays = [];
-        var now = Date.now();
-        if (now - this.lastPickTime > MSECS_PER_SEC / PICKS_PER_SECOND_PER_HAND) {
-            pickRays = [distantPickRay];
-            this.lastPickTime = now;
-        }
+        // the picks of both hands are cast together with the mouse once a frame, so they can be read every frame
+        var pickRays = [distantPickRay];
 
         for (var index=0; index < pickRays.length; ++index) {
             var pickRay = pickRays[index];
@@ -361,7 +354,9 @@ function MyController(hand) {
                 })
             }
 
-            var intersection = Entities.findRayIntersection(pickRayBacked, true);
+            // what the ray of the last frame hit, this one is cast with the next frame's picks
+            var intersection = Entities.getRayPickResult(this.rayPick);
+            Entities.setRayPickRay(this.rayPick, pickRayBacked);
 
             if (intersection.intersects) {
                 // the ray is intersecting something we can move.
@@ -794,15 +789,12 @@ function MyController(hand) {
             direction: Quat.getUp(this.getHandRotation())
         };
 
-        var now = Date.now();
-        if (now - this.lastPickTime > MSECS_PER_SEC / PICKS_PER_SECOND_PER_HAND) {
-            var intersection = Entities.findRayIntersection(pickRay, true);
-            this.lastPickTime = now;
-            if (intersection.entityID != this.grabbedEntity) {
-                this.setState(STATE_RELEASE);
-                Entities.callEntityMethod(this.grabbedEntity, "stopFarTrigger");
-                return;
-            }
+        var intersection = Entities.getRayPickResult(this.rayPick);
+        Entities.setRayPickRay(this.rayPick, pickRay);
+        if (intersection.entityID != this.grabbedEntity) {
+            this.setState(STATE_RELEASE);
+            Entities.callEntityMethod(this.grabbedEntity, "stopFarTrigger");
+            return;
         }
 
         this.lineOn(pickRay.origin, Vec3.multiply(pickRay.direction, LINE_LENGTH), NO_INTERSECT_COLOR);
@@ -883,6 +875,8 @@ function MyController(hand) {
             disabledHand = 'none';
         }
         this.lineOff();
+        // so that the next search does not start from what this hand pointed at before
+        Entities.stopRayPick(this.rayPick);
 
         if (this.grabbedEntity !== null) {
             if (this.actionID !== null) {
@@ -899,6 +893,7 @@ function MyController(hand) {
 
     this.cleanup = function() {
         this.release();
+        Entities.removeRayPick(this.rayPick);
     };
 
     this.activateEntity = function(entityID, grabbedProperties) {
@@ -68,6 +68,18 @@ panel.newCheckbox("Display status",
     function(value) { return (value); }
 );
 
+panel.newSlider("Occlusion resolution level", 0, 2,
+    function(value) { Scene.setEngineOcclusionResolutionLevel(Math.round(value)); },
+    function() { return Scene.getEngineOcclusionResolutionLevel(); },
+    function(value) { return Math.round(value); }
+);
+
+panel.newCheckbox("Temporal occlusion",
+    function(value) { Scene.setEngineOcclusionTemporal(value); },
+    function() { return Scene.doEngineOcclusionTemporal(); },
+    function(value) { return (value); }
+);
+
 var tickTackPeriod = 500;
 
 function updateCounters() {
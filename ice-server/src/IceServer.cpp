@@ -9,9 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QTimer>
 
 #include <LimitedNodeList.h>
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 
@@ -20,6 +23,9 @@
 const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
 const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
 
+// a peer is removed once its last heartbeat is this many expiry buckets old, the buckets are one clear interval long
+const int PEER_SILENCE_THRESHOLD_BUCKETS = PEER_SILENCE_THRESHOLD_MSECS / CLEAR_INACTIVE_PEERS_INTERVAL_MSECS;
+
 const quint16 ICE_SERVER_MONITORING_PORT = 40110;
 
 IceServer::IceServer(int argc, char* argv[]) :
@@ -27,7 +33,9 @@ IceServer::IceServer(int argc, char* argv[]) :
     _id(QUuid::createUuid()),
     _serverSocket(),
     _activePeers(),
-    _httpManager(ICE_SERVER_MONITORING_PORT, QString("%1/web/").arg(QCoreApplication::applicationDirPath()), this)
+    _httpManager(ICE_SERVER_MONITORING_PORT, QString("%1/web/").arg(QCoreApplication::applicationDirPath()), this),
+    _expiryBuckets(PEER_SILENCE_THRESHOLD_BUCKETS + 1),
+    _lastRatesUpdate(usecTimestampNow())
 {
     // start the ice-server socket
     qDebug() << "ice-server socket is listening on" << ICE_SERVER_DEFAULT_PORT;
@@ -70,11 +78,13 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     if (nlPacket->getPayloadSize() >= NLPacket::localHeaderSize(PacketType::ICEServerHeartbeat)) {
         
         if (nlPacket->getType() == PacketType::ICEServerHeartbeat) {
+            ++_heartbeatCount;
             SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(*nlPacket);
             
             // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
             peer->activateMatchingOrNewSymmetricSocket(nlPacket->getSenderSockAddr());
         } else if (nlPacket->getType() == PacketType::ICEServerQuery) {
+            ++_queryCount;
             QDataStream heartbeatStream(nlPacket.get());
             
             // this is a node hoping to connect to a heartbeating peer - do we have the heartbeating peer?
@@ -139,6 +149,13 @@ SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
     // update our last heard microstamp for this network peer to now
     matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
 
+    // put the peer in the bucket of this second, once
+    quint64& expirySecond = _peerExpirySeconds[senderUUID];
+    if (expirySecond != _expirySecond) {
+        expirySecond = _expirySecond;
+        _expiryBuckets[_expirySecond % _expiryBuckets.size()].push_back(senderUUID);
+    }
+
     return matchingPeer;
 }
 
@@ -153,19 +170,34 @@ void IceServer::sendPeerInformationPacket(const NetworkPeer& peer, const HifiSoc
 }
 
 void IceServer::clearInactivePeers() {
-    NetworkPeerHash::iterator peerItem = _activePeers.begin();
-
-    while (peerItem != _activePeers.end()) {
-        SharedNetworkPeer peer = peerItem.value();
+    // move on to the next second, its bucket is the oldest one and its peers haven't been heard since
+    ++_expirySecond;
+    std::vector<QUuid>& expiredBucket = _expiryBuckets[_expirySecond % _expiryBuckets.size()];
+
+    for (const QUuid& peerUUID : expiredBucket) {
+        auto expirySecond = _peerExpirySeconds.find(peerUUID);
+        if (expirySecond == _peerExpirySeconds.end() || expirySecond.value() + _expiryBuckets.size() != _expirySecond) {
+            // the peer was heard in a later second, and is in a later bucket too
+            continue;
+        }
+        _peerExpirySeconds.erase(expirySecond);
 
-        if ((usecTimestampNow() - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
+        SharedNetworkPeer peer = _activePeers.take(peerUUID);
+        if (peer) {
             qDebug() << "Removing peer from memory for inactivity -" << *peer;
-            peerItem = _activePeers.erase(peerItem);
-        } else {
-            // we didn't kill this peer, push the iterator forwards
-            ++peerItem;
         }
     }
+    expiredBucket.clear();
+
+    quint64 now = usecTimestampNow();
+    float elapsedSeconds = (float)(now - _lastRatesUpdate) / USECS_PER_SECOND;
+    if (elapsedSeconds > 0.0f) {
+        _heartbeatsPerSecond = _heartbeatCount / elapsedSeconds;
+        _queriesPerSecond = _queryCount / elapsedSeconds;
+    }
+    _heartbeatCount = 0;
+    _queryCount = 0;
+    _lastRatesUpdate = now;
 }
 
 bool IceServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
@@ -175,6 +207,14 @@ bool IceServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, b
     if (connection->requestOperation() == QNetworkAccessManager::GetOperation) {
         if (url.path() == "/status") {
             connection->respond(HTTPConnection::StatusCode200, QByteArray::number(_activePeers.size()));
+        } else if (url.path() == "/stats.json") {
+            QJsonObject statsObject;
+            statsObject["peer_count"] = _activePeers.size();
+            statsObject["heartbeats_per_second"] = _heartbeatsPerSecond;
+            statsObject["queries_per_second"] = _queriesPerSecond;
+            statsObject["packets_per_second"] = _heartbeatsPerSecond + _queriesPerSecond;
+
+            connection->respond(HTTPConnection::StatusCode200, QJsonDocument(statsObject).toJson(), "application/json");
         }
     }
     return true;
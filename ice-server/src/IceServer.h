@@ -12,6 +12,8 @@
 #ifndef hifi_IceServer_h
 #define hifi_IceServer_h
 
+#include <vector>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSharedPointer>
 #include <QUdpSocket>
@@ -42,6 +44,20 @@ private:
     udt::Socket _serverSocket;
     NetworkPeerHash _activePeers;
     HTTPManager _httpManager;
+
+    // the peers by the second they were last heard in, so that clearing the inactive peers only looks at the ones
+    // heard in the second that just went past the silence threshold, a peer is in the bucket of each second it was
+    // heard in until that bucket expires and is only removed from the last
+    std::vector<std::vector<QUuid>> _expiryBuckets;
+    quint64 _expirySecond { 1 }; // the second the next heartbeats go in, a peer that was never in one has zero
+    QHash<QUuid, quint64> _peerExpirySeconds;
+
+    // the packets handled since the last time the rates were updated, and the rates, for the stats endpoint
+    int _heartbeatCount { 0 };
+    int _queryCount { 0 };
+    float _heartbeatsPerSecond { 0.0f };
+    float _queriesPerSecond { 0.0f };
+    quint64 _lastRatesUpdate { 0 };
 };
 
 #endif // hifi_IceServer_h
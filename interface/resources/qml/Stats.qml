@@ -57,6 +57,11 @@ Item {
                         font.pixelSize: root.fontSize
                         text: "Avatar Simrate: " + root.avatarSimrate
                     }
+                    Text {
+                        color: root.fontColor;
+                        font.pixelSize: root.fontSize
+                        text: "Update/Render ms: " + root.updateTime.toFixed(2) + "/" + root.renderTime.toFixed(2)
+                    }
                     Text {
                         color: root.fontColor;
                         font.pixelSize: root.fontSize
@@ -67,6 +72,12 @@ Item {
                         font.pixelSize: root.fontSize
                         text: "Mbps In/Out: " + root.mbpsIn.toFixed(2) + "/" + root.mbpsOut.toFixed(2)
                     }
+                    Text {
+                        color: root.fontColor;
+                        font.pixelSize: root.fontSize
+                        visible: root.expanded && root.joinTimeline.length > 0
+                        text: "Join ms: " + root.joinTimeline
+                    }
                 }
             }
 
@@ -177,6 +188,17 @@ Item {
                         text: "Triangles: " + root.triangles +
                             " / Material Switches: " + root.materialSwitches
                     }
+                    Text {
+                        color: root.fontColor;
+                        font.pixelSize: root.fontSize
+                        text: "Texture Memory: " + root.textureGPUMemory +
+                            " / Budget: " + root.textureGPUMemoryBudget + " MB"
+                    }
+                    Text {
+                        color: root.fontColor;
+                        font.pixelSize: root.fontSize
+                        text: "Buffer Uploads: " + root.bufferGPUUploads + " KB / frame"
+                    }
                     Text {
                         color: root.fontColor;
                         font.pixelSize: root.fontSize
@@ -191,7 +213,8 @@ Item {
                         visible: root.expanded;
                         text: "\tOpaque considered: " + root.opaqueConsidered +
                             " / Out of view: " + root.opaqueOutOfView + 
-                            " / Too small: " + root.opaqueTooSmall;
+                            " / Too small: " + root.opaqueTooSmall +
+                            " / Occluded: " + root.opaqueOccluded;
                     }
                     Text {
                         color: root.fontColor;
@@ -49,6 +49,7 @@
 #include <ApplicationVersion.h>
 #include <AssetClient.h>
 #include <AssetUpload.h>
+#include <AudioInjectorManager.h>
 #include <AutoUpdater.h>
 #include <CursorManager.h>
 #include <DeferredLightingEffect.h>
@@ -85,8 +86,10 @@
 #include <RenderableWebEntityItem.h>
 #include <RenderDeferredTask.h>
 #include <ResourceCache.h>
+#include <ResourceDiskCache.h>
 #include <SceneScriptingInterface.h>
 #include <ScriptCache.h>
+#include <SimulatorLoad.h>
 #include <SoundCache.h>
 #include <TextureCache.h>
 #include <Tooltip.h>
@@ -195,6 +198,12 @@ static const QString DESKTOP_LOCATION = QStandardPaths::writableLocation(QStanda
 
 const QString DEFAULT_SCRIPTS_JS_URL = "http://s3.amazonaws.com/hifi-public/scripts/defaultScripts.js";
 Setting::Handle<int> maxOctreePacketsPerSecond("maxOctreePPS", DEFAULT_MAX_OCTREE_PPS);
+// the threads that update the physics contacts, one keeps them all on the main thread
+Setting::Handle<int> physicsThreads("physicsThreads", 1);
+// when true the entities other simulators own only join the physics solver near the bodies simulated here
+Setting::Handle<bool> kinematicRemoteBodies("kinematicRemoteBodies", false);
+// the time each frame the physics step may take before the entity servers move the objects it simulates to others
+Setting::Handle<int> physicsStepBudgetUsecs("physicsStepBudgetUsecs", 4000);
 
 const QHash<QString, Application::AcceptURLMethod> Application::_acceptedExtensions {
     { SNAPSHOT_EXTENSION, &Application::acceptSnapshot },
@@ -301,6 +310,7 @@ bool setupEssentials(int& argc, char** argv) {
     DependencyManager::set<ModelCache>();
     DependencyManager::set<ScriptCache>();
     DependencyManager::set<SoundCache>();
+    DependencyManager::set<AudioInjectorManager>();
     DependencyManager::set<Faceshift>();
     DependencyManager::set<DdeFaceTracker>();
     DependencyManager::set<EyeTracker>();
@@ -500,6 +510,7 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer) :
         discoverabilityManager.data(), &DiscoverabilityManager::updateLocation);
 
     connect(nodeList.data(), &NodeList::nodeAdded, this, &Application::nodeAdded);
+    connect(nodeList.data(), &NodeList::nodeActivated, this, &Application::nodeActivated);
     connect(nodeList.data(), &NodeList::nodeKilled, this, &Application::nodeKilled);
     connect(nodeList.data(), &NodeList::uuidChanged, getMyAvatar(), &MyAvatar::setSessionUUID);
     connect(nodeList.data(), &NodeList::uuidChanged, this, &Application::setSessionUUID);
@@ -563,7 +574,11 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer) :
     cache->setCacheDirectory(!cachePath.isEmpty() ? cachePath : "interfaceCache");
     networkAccessManager.setCache(cache);
 
-    ResourceCache::setRequestLimit(3);
+    // the resources of every thread share their own cache, revalidated with the servers once stale
+    ResourceDiskCache::setMaximumSize(MAXIMUM_CACHE_SIZE);
+    ResourceDiskCache::setCacheDirectory((!cachePath.isEmpty() ? cachePath : "interfaceCache") + "/resources");
+
+    ResourceCache::setHostRequestLimit(3);
 
     _glWidget = new GLCanvas();
     _window->setCentralWidget(_glWidget);
@@ -829,6 +844,7 @@ void Application::cleanupBeforeQuit() {
     }
     _keyboardFocusHighlight = nullptr;
 
+    _entitySceneCache.leaveDomain(_entities.getTree());
     _entities.clear(); // this will allow entity scripts to properly shutdown
     
     // tell the packet receiver we're shutting down, so it can drop packets
@@ -914,6 +930,7 @@ Application::~Application() {
     DependencyManager::destroy<GeometryCache>();
     DependencyManager::destroy<ScriptCache>();
     DependencyManager::destroy<SoundCache>();
+    DependencyManager::destroy<AudioInjectorManager>();
     
     // cleanup the AssetClient thread
     QThread* assetThread = DependencyManager::get<AssetClient>()->thread();
@@ -1078,13 +1095,16 @@ void Application::paintGL() {
     _inPaint = true;
     Finally clearFlagLambda([this] { _inPaint = false; });
 
+    DependencyManager::get<GeometryCache>()->beginFrame();
+
+    // the render time leaves out idle(), which is counted as simulation
+    quint64 renderStart = usecTimestampNow();
+    Finally updateRenderTime([this, renderStart] { _renderUsecs.updateAverage(usecTimestampNow() - renderStart); });
+
     auto displayPlugin = getActiveDisplayPlugin();
     displayPlugin->preRender();
     _offscreenContext->makeCurrent();
 
-    // update the avatar with a fresh HMD pose
-    getMyAvatar()->updateFromHMDSensorMatrix(getHMDSensorPose());
-
     auto lodManager = DependencyManager::get<LODManager>();
 
 
@@ -1140,6 +1160,11 @@ void Application::paintGL() {
         PerformanceTimer perfTimer("CameraUpdates");
         
         auto myAvatar = getMyAvatar();
+
+        // update the avatar with a fresh HMD pose, latched after the mirror and overlay are rendered so that the
+        // camera is as close as possible to where the head will be when the frame is displayed
+        displayPlugin->updateHeadPose();
+        myAvatar->updateFromHMDSensorMatrix(getHMDSensorPose());
         
         myAvatar->startCapture();
         if (_myCamera.getMode() == CAMERA_MODE_FIRST_PERSON || _myCamera.getMode() == CAMERA_MODE_THIRD_PERSON) {
@@ -1229,6 +1254,8 @@ void Application::paintGL() {
             // right eye.  There are FIXMEs in the relevant plugins
             _myCamera.setProjection(displayPlugin->getProjection(Mono, _myCamera.getProjection()));
             renderArgs._context->enableStereo(true);
+            // the headsets draw both eyes in one pass over each batch where its shaders allow it
+            renderArgs._context->enableInstancedStereo(displayPlugin->isHmd());
             mat4 eyeOffsets[2];
             mat4 eyeProjections[2];
             auto baseProjection = renderArgs._viewFrustum->getProjection();
@@ -1263,6 +1290,7 @@ void Application::paintGL() {
         }
         displaySide(&renderArgs, _myCamera);
         renderArgs._context->enableStereo(false);
+        renderArgs._context->enableInstancedStereo(false);
         gpu::doInBatch(renderArgs._context, [](gpu::Batch& batch) {
             batch.setFramebuffer(nullptr);
         });
@@ -2162,7 +2190,9 @@ void Application::idle(uint64_t now) {
         PerformanceTimer perfTimer("update");
         PerformanceWarning warn(showWarnings, "Application::idle()... update()");
         static const float BIGGEST_DELTA_TIME_SECS = 0.25f;
+        quint64 updateStart = usecTimestampNow();
         update(glm::clamp(secondsSinceLastUpdate, 0.0f, BIGGEST_DELTA_TIME_SECS));
+        _updateUsecs.updateAverage(usecTimestampNow() - updateStart);
     }
     {
         PerformanceTimer perfTimer("pluginIdle");
@@ -2205,6 +2235,14 @@ float Application::getAverageSimsPerSecond() {
     }
     return _simsPerSecondReport;
 }
+
+float Application::getAverageUpdateMsecs() const {
+    return _updateUsecs.getAverage() / (float)USECS_PER_MSEC;
+}
+
+float Application::getAverageRenderMsecs() const {
+    return _renderUsecs.getAverage() / (float)USECS_PER_MSEC;
+}
 void Application::setAvatarSimrateSample(float sample) {
     _avatarSimsPerSecond.updateAverage(sample);
 }
@@ -2453,8 +2491,14 @@ void Application::init() {
     _entities.init();
     _entities.setViewFrustum(getViewFrustum());
 
+    QString shapeCachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+    if (!shapeCachePath.isEmpty()) {
+        _shapeManager.setCacheDirectory(shapeCachePath + "/hulls");
+    }
     ObjectMotionState::setShapeManager(&_shapeManager);
     _physicsEngine->init();
+    _physicsEngine->setNumThreads(physicsThreads.get());
+    _physicsEngine->setKinematicRemoteBodies(kinematicRemoteBodies.get());
 
     EntityTreePointer tree = _entities.getTree();
     _entitySimulation.init(tree, _physicsEngine, &_entityEditSender);
@@ -2520,7 +2564,7 @@ void Application::updateLOD() {
     PerformanceTimer perfTimer("LOD");
     // adjust it unless we were asked to disable this feature, or if we're currently in throttleRendering mode
     if (!isThrottleRendering()) {
-        DependencyManager::get<LODManager>()->autoAdjustLOD(_fps);
+        DependencyManager::get<LODManager>()->autoAdjustLOD(_fps, getAverageUpdateMsecs() + getAverageRenderMsecs());
     } else {
         DependencyManager::get<LODManager>()->resetLODAdjust();
     }
@@ -2853,9 +2897,11 @@ void Application::update(float deltaTime) {
 
         myAvatar->prepareForPhysicsSimulation();
 
+        quint64 stepStart = usecTimestampNow();
         _entities.getTree()->withWriteLock([&] {
             _physicsEngine->stepSimulation();
         });
+        _physicsStepUsecs.updateAverage(usecTimestampNow() - stepStart);
         
         if (_physicsEngine->hasOutgoingChanges()) {
             _entities.getTree()->withWriteLock([&] {
@@ -2934,6 +2980,15 @@ void Application::update(float deltaTime) {
         }
     }
 
+    // tell the entity servers how busy our physics is, so that they only give us the objects we have time for
+    {
+        const quint64 SIMULATOR_LOAD_INTERVAL = 1 * USECS_PER_SECOND;
+        if (now - _lastSimulatorLoadSent > SIMULATOR_LOAD_INTERVAL) {
+            _lastSimulatorLoadSent = now;
+            sendSimulatorLoadPackets();
+        }
+    }
+
     // send packet containing downstream audio stats to the AudioMixer
     {
         quint64 sinceLastNack = now - _lastSendDownstreamAudioStats;
@@ -2949,6 +3004,25 @@ void Application::update(float deltaTime) {
 }
 
 
+void Application::sendSimulatorLoadPackets() {
+    SimulatorLoad load;
+    load.stepBudgetUsecs = (quint32)std::max(physicsStepBudgetUsecs.get(), 0);
+    load.stepUsecs = (quint32)_physicsStepUsecs.getAverage();
+
+    QByteArray loadData;
+    QDataStream loadStream(&loadData, QIODevice::WriteOnly);
+    loadStream << load;
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->eachNode([&](const SharedNodePointer& node) {
+        if (node->getActiveSocket() && node->getType() == NodeType::EntityServer) {
+            auto loadPacket = NLPacket::create(PacketType::SimulatorLoad, loadData.size());
+            loadPacket->write(loadData);
+            nodeList->sendPacket(std::move(loadPacket), *node);
+        }
+    });
+}
+
 int Application::sendNackPackets() {
 
     if (Menu::getInstance()->isOptionChecked(MenuOption::DisableNackPackets)) {
@@ -2970,7 +3044,7 @@ int Application::sendNackPackets() {
 
             // if there are octree packets from this node that are waiting to be processed,
             // don't send a NACK since the missing packets may be among those waiting packets.
-            if (_octreeProcessor.hasPacketsToProcessFrom(nodeUUID)) {
+            if (_octreeProcessor.hasPacketsToProcessFrom(nodeUUID) || _octreeProcessor.hasPendingPackets()) {
                 return;
             }
 
@@ -3027,6 +3101,13 @@ void Application::queryOctree(NodeType_t serverType, PacketType packetType, Node
     _octreeQuery.setOctreeSizeScale(lodManager->getOctreeSizeScale());
     _octreeQuery.setBoundaryLevelAdjust(lodManager->getBoundaryLevelAdjust());
 
+    // until the entity server answered, it may only have to send what changed since the scene kept from the last visit
+    quint64 cachedSceneTime = 0;
+    ViewFrustum cachedSceneView;
+    _entitySceneCache.getResumedScene(cachedSceneTime, cachedSceneView);
+    _octreeQuery.setCachedScene(cachedSceneTime, cachedSceneView);
+    _entitySceneCache.setQueriedView(_viewFrustum);
+
     // Iterate all of the nodes, and get a count of how many octree servers we have...
     int totalServers = 0;
     int inViewServers = 0;
@@ -3565,6 +3646,8 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
         renderContext._drawHitEffect = sceneInterface->doEngineDisplayHitEffect();
 
         renderContext._occlusionStatus = Menu::getInstance()->isOptionChecked(MenuOption::DebugAmbientOcclusion);
+        renderContext._occlusionResolutionLevel = sceneInterface->getEngineOcclusionResolutionLevel();
+        renderContext._occlusionTemporal = sceneInterface->doEngineOcclusionTemporal();
         renderContext._fxaaStatus = Menu::getInstance()->isOptionChecked(MenuOption::Antialiasing);
 
         renderArgs->_shouldRender = LODManager::shouldRender;
@@ -3580,9 +3663,11 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
 
         auto engineRC = _renderEngine->getRenderContext();
         sceneInterface->setEngineFeedOpaqueItems(engineRC->_numFeedOpaqueItems);
+        sceneInterface->setEngineTestedOpaqueItems(engineRC->_numTestedOpaqueItems);
         sceneInterface->setEngineDrawnOpaqueItems(engineRC->_numDrawnOpaqueItems);
 
         sceneInterface->setEngineFeedTransparentItems(engineRC->_numFeedTransparentItems);
+        sceneInterface->setEngineTestedTransparentItems(engineRC->_numTestedTransparentItems);
         sceneInterface->setEngineDrawnTransparentItems(engineRC->_numDrawnTransparentItems);
 
         sceneInterface->setEngineFeedOverlay3DItems(engineRC->_numFeedOverlay3DItems);
@@ -3707,7 +3792,8 @@ void Application::clearDomainOctreeDetails() {
         _octreeServerSceneStats.clear();
     });
 
-    // reset the model renderer
+    // reset the model renderer, once its entities were kept for the next visit
+    _entitySceneCache.leaveDomain(_entities.getTree());
     _entities.clear();
 }
 
@@ -3744,18 +3830,33 @@ void Application::connectedToDomain(const QString& hostname) {
     if (accountManager.isLoggedIn() && !domainID.isNull()) {
         _notifiedPacketVersionMismatchThisDomain = false;
     }
+
+    // show the entities kept from the last visit right away
+    _entitySceneCache.enterDomain(domainID.isNull() ? hostname : uuidStringWithoutCurlyBraces(domainID),
+                                  _entities.getTree());
 }
 
 void Application::nodeAdded(SharedNodePointer node) {
-    if (node->getType() == NodeType::AvatarMixer) {
-        // new avatar mixer, send off our identity packet right away
-        getMyAvatar()->sendIdentityPacket();
-    } else if (node->getType() == NodeType::AssetServer) {
+    if (node->getType() == NodeType::AssetServer) {
         // the addition of an asset-server always re-enables the upload to asset server menu option
         Menu::getInstance()->getActionForOption(MenuOption::UploadAsset)->setEnabled(true);
     }
 }
 
+void Application::nodeActivated(SharedNodePointer node) {
+    // the servers are punched to all at once, each gets its first packets as soon as it can be reached
+    if (node->getType() == NodeType::AudioMixer) {
+        // we have a socket to the audio mixer, agree on the codec for our streams
+        QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "negotiateAudioFormat");
+    } else if (node->getType() == NodeType::AvatarMixer) {
+        // new avatar mixer, send off our identity packet right away
+        getMyAvatar()->sendIdentityPacket();
+    } else if (node->getType() == NodeType::EntityServer) {
+        // the queries sent before we could reach it were dropped, don't wait for the view to change to send the next
+        _lastQueriedTime = 0;
+    }
+}
+
 void Application::nodeKilled(SharedNodePointer node) {
 
     // These are here because connecting NodeList::nodeKilled to OctreePacketProcessor::nodeKilled doesn't work:
@@ -3799,6 +3900,7 @@ void Application::nodeKilled(SharedNodePointer node) {
                 _octreeServerSceneStats.erase(nodeUUID);
             }
         });
+        _entitySceneCache.serverKilled(nodeUUID);
     } else if (node->getType() == NodeType::AvatarMixer) {
         // our avatar mixer has gone away - clear the hash of avatars
         DependencyManager::get<AvatarManager>()->clearOtherAvatars();
@@ -3833,11 +3935,17 @@ int Application::processOctreeStats(NLPacket& packet, SharedNodePointer sendingN
     int statsMessageLength = 0;
 
     const QUuid& nodeUUID = sendingNode->getUUID();
-    
+    quint64 sceneStartTime = 0;
+    bool sceneIsMoving = false;
+    quint64 resumedSceneTime = 0;
+
     // now that we know the node ID, let's add these stats to the stats for that node...
     _octreeServerSceneStats.withWriteLock([&] {
         OctreeSceneStats& octreeStats = _octreeServerSceneStats[nodeUUID];
         statsMessageLength = octreeStats.unpackFromPacket(packet);
+        sceneStartTime = octreeStats.getStartTime();
+        sceneIsMoving = octreeStats.isMoving();
+        resumedSceneTime = octreeStats.getResumedSceneTime();
 
         // see if this is the first we've heard of this node...
         NodeToJurisdictionMap* jurisdiction = NULL;
@@ -3870,6 +3978,11 @@ int Application::processOctreeStats(NLPacket& packet, SharedNodePointer sendingN
         });
     });
 
+    // outside of the stats lock, the scene cache may drop entities from the tree
+    if (sendingNode->getType() == NodeType::EntityServer) {
+        _entitySceneCache.sceneSent(nodeUUID, sceneStartTime, sceneIsMoving, resumedSceneTime, _entities.getTree());
+    }
+
 
 
     return statsMessageLength;
@@ -47,6 +47,7 @@
 #include "FileLogger.h"
 #include "gpu/Context.h"
 #include "Menu.h"
+#include "octree/EntitySceneCache.h"
 #include "octree/OctreePacketProcessor.h"
 #include "render/Engine.h"
 #include "scripting/ControllerScriptingInterface.h"
@@ -235,6 +236,8 @@ public:
     void setAvatarSimrateSample(float sample);
 
     float getAverageSimsPerSecond();
+    float getAverageUpdateMsecs() const;
+    float getAverageRenderMsecs() const;
 
 signals:
     void scriptLocationChanged(const QString& newPath);
@@ -342,6 +345,7 @@ private slots:
     void domainChanged(const QString& domainHostname);
     void updateWindowTitle();
     void nodeAdded(SharedNodePointer node);
+    void nodeActivated(SharedNodePointer node);
     void nodeKilled(SharedNodePointer node);
     void packetSent(quint64 length);
     void updateDisplayMode();
@@ -373,6 +377,7 @@ private:
     void renderRearViewMirror(RenderArgs* renderArgs, const QRect& region, bool billboard = false);
 
     int sendNackPackets();
+    void sendSimulatorLoadPackets();
     
     void takeSnapshot();
     
@@ -446,6 +451,7 @@ private:
     quint64 _lastQueriedTime;
 
     OctreeQuery _octreeQuery; // NodeData derived class for querying octee cells from octree servers
+    EntitySceneCache _entitySceneCache; // the entities of the domain, kept for the next visit
 
     std::shared_ptr<controller::StateController> _applicationStateDevice; // Default ApplicationDevice reflecting the state of different properties of the session
     std::shared_ptr<KeyboardMouseDevice> _keyboardMouseDevice;   // Default input device, the good old keyboard mouse and maybe touchpad
@@ -497,6 +503,7 @@ private:
 
     quint64 _lastNackTime;
     quint64 _lastSendDownstreamAudioStats;
+    quint64 _lastSimulatorLoadSent { 0 };
     
     bool _aboutToQuit;
 
@@ -546,6 +553,9 @@ private:
     SimpleMovingAverage _simsPerSecond{10};
     int _simsPerSecondReport = 0;
     quint64 _lastSimsPerSecondUpdate = 0;
+    SimpleMovingAverage _updateUsecs{10}; // the time spent simulating in each frame
+    SimpleMovingAverage _renderUsecs{10}; // the time spent rendering in each frame
+    SimpleMovingAverage _physicsStepUsecs{10}; // the time spent stepping the physics in each frame
     bool _isForeground = true; // starts out assumed to be in foreground
     bool _inPaint = false;
     bool _isGLInitialized { false };
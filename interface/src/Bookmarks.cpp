@@ -149,6 +149,13 @@ void Bookmarks::teleportToBookmark() {
     DependencyManager::get<AddressManager>()->handleLookupString(address);
 }
 
+void Bookmarks::prefetchBookmark() {
+    // the user is likely to go there next - have the place looked up and its domain resolved before they pick it
+    QAction* action = qobject_cast<QAction*>(sender());
+    QString address = action->data().toString();
+    DependencyManager::get<AddressManager>()->prefetchLookupString(address);
+}
+
 void Bookmarks::deleteBookmark() {
     
     QStringList bookmarkList;
@@ -195,6 +202,7 @@ void Bookmarks::addLocationToMenu(Menu* menubar, QString& name, QString& address
     QAction* teleportAction = _bookmarksMenu->newAction();
     teleportAction->setData(address);
     connect(teleportAction, SIGNAL(triggered()), this, SLOT(teleportToBookmark()));
+    connect(teleportAction, SIGNAL(hovered()), this, SLOT(prefetchBookmark()));
     
     menubar->addActionToQMenuAndActionHash(_bookmarksMenu, teleportAction,
                                            name, 0, QAction::NoRole);
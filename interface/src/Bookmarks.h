@@ -32,6 +32,7 @@ public:
 private slots:
     void bookmarkLocation();
     void teleportToBookmark();
+    void prefetchBookmark();
     void deleteBookmark();
     
 private:
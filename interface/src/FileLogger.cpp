@@ -44,7 +44,7 @@ const QString& getLogFilename() {
 }
 
 
-class FilePersistThread : public GenericQueueThread < QString > {    
+class FilePersistThread : public LockFreeQueueThread<QString> {    
 public:
     FilePersistThread(const FileLogger& logger) : _logger(logger) {
         setObjectName("LogFileWriter");
@@ -40,7 +40,7 @@ float LODManager::getLODIncreaseFPS() {
 }
 
 
-void LODManager::autoAdjustLOD(float currentFPS) {
+void LODManager::autoAdjustLOD(float currentFPS, float frameWorkMsecs) {
     
     // NOTE: our first ~100 samples at app startup are completely all over the place, and we don't
     // really want to count them in our average, so we will ignore the real frame rates and stuff
@@ -48,12 +48,14 @@ void LODManager::autoAdjustLOD(float currentFPS) {
     const int IGNORE_THESE_SAMPLES = 100;
     if (_fpsAverageUpWindow.getSampleCount() < IGNORE_THESE_SAMPLES) {
         currentFPS = ASSUMED_FPS;
+        frameWorkMsecs = 0.0f;
         _lastStable = _lastUpShift = _lastDownShift = usecTimestampNow();
     }
     
     _fpsAverageStartWindow.updateAverage(currentFPS);
     _fpsAverageDownWindow.updateAverage(currentFPS);
     _fpsAverageUpWindow.updateAverage(currentFPS);
+    _workMsecsAverageUpWindow.updateAverage(frameWorkMsecs);
     
     quint64 now = usecTimestampNow();
 
@@ -129,7 +131,9 @@ void LODManager::autoAdjustLOD(float currentFPS) {
             // LOD Upward adjustment
             if (elapsedSinceUpShift > UP_SHIFT_ELPASED) {
             
-                if (_fpsAverageUpWindow.getAverage() > getLODIncreaseFPS()) {
+                float workBudgetMsecs = INCREASE_LOD_WORK_HEADROOM * MSECS_PER_SECOND / getLODIncreaseFPS();
+                if (_fpsAverageUpWindow.getAverage() > getLODIncreaseFPS() &&
+                    _workMsecsAverageUpWindow.getAverage() < workBudgetMsecs) {
 
                     // Octee items... stepwise adjustment
                     if (_octreeSizeScale < ADJUST_LOD_MAX_SIZE_SCALE) {
@@ -149,6 +153,7 @@ void LODManager::autoAdjustLOD(float currentFPS) {
                     qCDebug(interfaceapp) << "adjusting LOD UP... average fps for last "<< UP_SHIFT_WINDOW_IN_SECS <<"seconds was " 
                                 << _fpsAverageUpWindow.getAverage()
                                 << "upshift point is:" << getLODIncreaseFPS() 
+                                << "average frame work msecs:" << _workMsecsAverageUpWindow.getAverage()
                                 << "elapsedSinceUpShift:" << elapsedSinceUpShift
                                 << " NEW _octreeSizeScale=" << _octreeSizeScale;
 
@@ -175,6 +180,7 @@ void LODManager::resetLODAdjust() {
     _fpsAverageStartWindow.reset();
     _fpsAverageDownWindow.reset();
     _fpsAverageUpWindow.reset();
+    _workMsecsAverageUpWindow.reset();
     _lastUpShift = _lastDownShift = usecTimestampNow();
     _isDownshifting = false;
 }
@@ -217,6 +223,24 @@ QString LODManager::getLODFeedbackText() {
     return result;
 }
 
+static QMap<float, float> buildShouldRenderTable() {
+    const float maxScale = (float)TREE_SCALE;
+    QMap<float, float> shouldRenderTable;
+    float SMALLEST_SCALE_IN_TABLE = 0.001f; // 1mm is plenty small
+    float scale = maxScale;
+    float factor = 1.0f;
+
+    while (scale > SMALLEST_SCALE_IN_TABLE) {
+        scale /= 2.0f;
+        factor /= 2.0f;
+        shouldRenderTable[scale] = factor;
+    }
+    return shouldRenderTable;
+}
+
+// built up front rather than on the first call, since the render jobs culling the scene call shouldRender concurrently
+static const QMap<float, float> SHOULD_RENDER_TABLE = buildShouldRenderTable();
+
 bool LODManager::shouldRender(const RenderArgs* args, const AABox& bounds) {
     const float maxScale = (float)TREE_SCALE;
     const float octreeToMeshRatio = 4.0f; // must be this many times closer to a mesh than a voxel to see it.
@@ -226,26 +250,10 @@ bool LODManager::shouldRender(const RenderArgs* args, const AABox& bounds) {
     float distanceToCamera = glm::length(bounds.calcCenter() - args->_viewFrustum->getPosition());
     float largestDimension = bounds.getLargestDimension();
     
-    static bool shouldRenderTableNeedsBuilding = true;
-    static QMap<float, float> shouldRenderTable;
-    if (shouldRenderTableNeedsBuilding) {
-        float SMALLEST_SCALE_IN_TABLE = 0.001f; // 1mm is plenty small
-        float scale = maxScale;
-        float factor = 1.0f;
-        
-        while (scale > SMALLEST_SCALE_IN_TABLE) {
-            scale /= 2.0f;
-            factor /= 2.0f;
-            shouldRenderTable[scale] = factor;
-        }
-        
-        shouldRenderTableNeedsBuilding = false;
-    }
-    
     float closestScale = maxScale;
     float visibleDistanceAtClosestScale = visibleDistanceAtMaxScale;
-    QMap<float, float>::const_iterator lowerBound = shouldRenderTable.lowerBound(largestDimension);
-    if (lowerBound != shouldRenderTable.constEnd()) {
+    QMap<float, float>::const_iterator lowerBound = SHOULD_RENDER_TABLE.lowerBound(largestDimension);
+    if (lowerBound != SHOULD_RENDER_TABLE.constEnd()) {
         closestScale = lowerBound.key();
         visibleDistanceAtClosestScale = visibleDistanceAtMaxScale * lowerBound.value();
     }
@@ -306,6 +314,18 @@ void LODManager::calculateAvatarLODDistanceMultiplier() {
     _avatarLODDistanceMultiplier = AVATAR_TO_ENTITY_RATIO / (_octreeSizeScale / DEFAULT_OCTREE_SIZE_SCALE);
 }
 
+void LODManager::getAvatarAnimationLOD(float lodDistance, float& updatePeriod, bool& isIKEnabled) const {
+    // the LOD distance already follows the octree size scale, so the automatic LOD adjustment moves these as well
+    if (lodDistance <= AVATAR_ANIMATION_FULL_RATE_LOD_DISTANCE) {
+        updatePeriod = 0.0f;
+    } else {
+        // an avatar twice as far is half as big on screen, and gets half the updates
+        float updateRate = AVATAR_ANIMATION_FULL_UPDATE_RATE * AVATAR_ANIMATION_FULL_RATE_LOD_DISTANCE / lodDistance;
+        updatePeriod = 1.0f / glm::max(updateRate, AVATAR_ANIMATION_MIN_UPDATE_RATE);
+    }
+    isIKEnabled = lodDistance <= AVATAR_ANIMATION_IK_LOD_DISTANCE;
+}
+
 void LODManager::setBoundaryLevelAdjust(int boundaryLevelAdjust) {
     _boundaryLevelAdjust = boundaryLevelAdjust;
     _shouldRenderTableNeedsRebuilding = true;
@@ -39,6 +39,11 @@ const int UP_SHIFT_SAMPLES_OF_FRAMES = ASSUMED_FPS * UP_SHIFT_WINDOW_IN_SECS;
 const float ADJUST_LOD_DOWN_BY = 0.9f;
 const float ADJUST_LOD_UP_BY = 1.1f;
 
+// The LOD is only raised when the work of a frame, its update and render, takes less than this share of the frame time
+// at the increase FPS. The frame rate alone can't tell, it is capped by v-sync, so without this headroom a raise can use
+// up the time there was and get taken back by the next lower.
+const float INCREASE_LOD_WORK_HEADROOM = 0.75f;
+
 // This controls how low the auto-adjust LOD will go a value of 1 means it will adjust to a point where you must be 0.25
 // meters away from an object of TREE_SCALE before you can see it (which is effectively completely blind). The default value
 // DEFAULT_OCTREE_SIZE_SCALE means you can be 400 meters away from a 1 meter object in order to see it (which is ~20:20 vision).
@@ -49,6 +54,13 @@ const float ADJUST_LOD_MAX_SIZE_SCALE = DEFAULT_OCTREE_SIZE_SCALE;
 // do. But both are still culled using the same angular size logic.
 const float AVATAR_TO_ENTITY_RATIO = 2.0f;
 
+// The animation LOD of avatars, by their LOD distance. Closer than the full rate distance they animate every frame, then
+// their update rate falls with distance down to the minimum, and past the IK distance their IK is skipped.
+const float AVATAR_ANIMATION_FULL_RATE_LOD_DISTANCE = 8.0f;
+const float AVATAR_ANIMATION_IK_LOD_DISTANCE = 16.0f;
+const float AVATAR_ANIMATION_FULL_UPDATE_RATE = 60.0f; // Hz
+const float AVATAR_ANIMATION_MIN_UPDATE_RATE = 10.0f; // Hz
+
 class RenderArgs;
 class AABox;
 
@@ -69,6 +81,9 @@ public:
     Q_INVOKABLE float getHMDLODIncreaseFPS() const { return glm::min(_hmdLODDecreaseFPS + INCREASE_LOD_GAP, MAX_LIKELY_HMD_FPS); }
 
     Q_INVOKABLE float getAvatarLODDistanceMultiplier() const { return _avatarLODDistanceMultiplier; }
+
+    // the time between the animation updates of an avatar at the LOD distance (0 for every frame), and whether it runs IK
+    void getAvatarAnimationLOD(float lodDistance, float& updatePeriod, bool& isIKEnabled) const;
     
     // User Tweakable LOD Items
     Q_INVOKABLE QString getLODFeedbackText();
@@ -83,7 +98,7 @@ public:
     
     static bool shouldRender(const RenderArgs* args, const AABox& bounds);
     bool shouldRenderMesh(float largestDimension, float distanceToCamera);
-    void autoAdjustLOD(float currentFPS);
+    void autoAdjustLOD(float currentFPS, float frameWorkMsecs);
     
     void loadSettings();
     void saveSettings();
@@ -113,6 +128,7 @@ private:
     SimpleMovingAverage _fpsAverageStartWindow = START_DELAY_SAMPLES_OF_FRAMES;
     SimpleMovingAverage _fpsAverageDownWindow = DOWN_SHIFT_SAMPLES_OF_FRAMES;
     SimpleMovingAverage _fpsAverageUpWindow = UP_SHIFT_SAMPLES_OF_FRAMES;
+    SimpleMovingAverage _workMsecsAverageUpWindow = UP_SHIFT_SAMPLES_OF_FRAMES;
     
     bool _shouldRenderTableNeedsRebuilding = true;
     QMap<float, float> _shouldRenderTable;
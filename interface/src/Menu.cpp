@@ -522,6 +522,9 @@ Menu::Menu() {
                                            audioIO.data(), SLOT(toggleServerEcho()));
     addCheckableActionToQMenuAndActionHash(audioDebugMenu, MenuOption::EchoLocalAudio, 0, false,
                                            audioIO.data(), SLOT(toggleLocalEcho()));
+    addCheckableActionToQMenuAndActionHash(audioDebugMenu, MenuOption::LowLatencyAudioOutput, 0,
+                                           audioIO->isLowLatencyOutputEnabled(),
+                                           audioIO.data(), SLOT(toggleLowLatencyOutput()));
     addCheckableActionToQMenuAndActionHash(audioDebugMenu, MenuOption::MuteAudio,
                                            Qt::CTRL | Qt::Key_M,
                                            false,
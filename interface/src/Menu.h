@@ -217,6 +217,7 @@ namespace MenuOption {
     const QString Login = "Login";
     const QString Log = "Log";
     const QString LogExtraTimings = "Log Extra Timing Details";
+    const QString LowLatencyAudioOutput = "Low Latency Audio Output";
     const QString LowVelocityFilter = "Low Velocity Filter";
     const QString MeshVisible = "Draw Mesh";
     const QString Mirror = "Mirror";
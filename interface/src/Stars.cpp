@@ -122,6 +122,7 @@ void Stars::render(RenderArgs* renderArgs, float alpha) {
     static gpu::Element positionElement, colorElement;
     static gpu::PipelinePointer _gridPipeline;
     static gpu::PipelinePointer _starsPipeline;
+    static std::shared_ptr<gpu::Batch> _starsBatch;
     static int32_t _timeSlot{ -1 };
     static std::once_flag once;
 
@@ -188,6 +189,20 @@ void Stars::render(RenderArgs* renderArgs, float alpha) {
         streamFormat->setAttribute(gpu::Stream::COLOR, COLOR_SLOT, gpu::Element(gpu::VEC4, gpu::FLOAT, gpu::RGBA));
         positionElement = streamFormat->getAttributes().at(gpu::Stream::POSITION)._element;
         colorElement = streamFormat->getAttributes().at(gpu::Stream::COLOR)._element;
+
+        // the stars never change, their commands are recorded once and run in the transforms of the grid
+        static const size_t VERTEX_STRIDE = sizeof(StarVertex);
+        size_t offset = offsetof(StarVertex, position);
+        gpu::BufferView posView(vertexBuffer, offset, vertexBuffer->getSize(), VERTEX_STRIDE, positionElement);
+        offset = offsetof(StarVertex, colorAndSize);
+        gpu::BufferView colView(vertexBuffer, offset, vertexBuffer->getSize(), VERTEX_STRIDE, colorElement);
+
+        _starsBatch = std::make_shared<gpu::Batch>();
+        _starsBatch->setPipeline(_starsPipeline);
+        _starsBatch->setInputFormat(streamFormat);
+        _starsBatch->setInputBuffer(VERTICES_SLOT, posView);
+        _starsBatch->setInputBuffer(COLOR_SLOT, colView);
+        _starsBatch->draw(gpu::Primitive::POINTS, STARFIELD_NUM_STARS);
     });
 
     auto modelCache = DependencyManager::get<ModelCache>();
@@ -210,17 +225,6 @@ void Stars::render(RenderArgs* renderArgs, float alpha) {
     batch._glUniform1f(_timeSlot, secs);
     geometryCache->renderCube(batch);
 
-    static const size_t VERTEX_STRIDE = sizeof(StarVertex);
-    size_t offset = offsetof(StarVertex, position);
-    gpu::BufferView posView(vertexBuffer, offset, vertexBuffer->getSize(), VERTEX_STRIDE, positionElement);
-    offset = offsetof(StarVertex, colorAndSize);
-    gpu::BufferView colView(vertexBuffer, offset, vertexBuffer->getSize(), VERTEX_STRIDE, colorElement);
-    
     // Render the stars
-    batch.setPipeline(_starsPipeline);
-
-    batch.setInputFormat(streamFormat);
-    batch.setInputBuffer(VERTICES_SLOT, posView);
-    batch.setInputBuffer(COLOR_SLOT, colView);
-    batch.draw(gpu::Primitive::POINTS, STARFIELD_NUM_STARS);
+    batch.executeBatch(_starsBatch);
 }
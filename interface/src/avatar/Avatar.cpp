@@ -105,6 +105,9 @@ Avatar::Avatar(RigPointer rig) :
     // give the pointer to our head to inherited _headData variable from AvatarData
     _headData = static_cast<HeadData*>(new Head(this));
     _handData = static_cast<HandData*>(new Hand(this));
+
+    // the poses that arrive from the avatar mixer are played back smoothly by simulate
+    _isSnapshotPlaybackEnabled = true;
 }
 
 Avatar::~Avatar() {
@@ -151,6 +154,13 @@ float Avatar::getLODDistance() const {
 void Avatar::simulate(float deltaTime) {
     PerformanceTimer perfTimer("simulate");
 
+    if (beginSimulate(deltaTime)) {
+        simulatePose(deltaTime);
+    }
+    endSimulate(deltaTime);
+}
+
+bool Avatar::beginSimulate(float deltaTime) {
     // update the avatar's position according to its referential
     if (_referential) {
         if (_referential->hasExtraData()) {
@@ -199,16 +209,43 @@ void Avatar::simulate(float deltaTime) {
         getHand()->simulate(deltaTime, false);
     }
 
-    if (!_shouldRenderBillboard && inViewFrustum) {
+    // move between the poses received from the mixer, a little while after they arrived
+    playbackSnapshots(usecTimestampNow());
+
+    // ease in the joints that distant updates left out, so they don't pop when they finally arrive
+    interpolateHeldJoints(deltaTime);
+
+    _isSkeletonSimulated = !_shouldRenderBillboard && inViewFrustum;
+    _isPoseSimulated = false;
+    if (_isSkeletonSimulated) {
+        PerformanceTimer perfTimer("skeleton");
+        float animationUpdatePeriod;
+        bool isAnimationIKEnabled;
+        DependencyManager::get<LODManager>()->getAvatarAnimationLOD(getLODDistance(), animationUpdatePeriod,
+                                                                     isAnimationIKEnabled);
+        _skeletonModel.getRig()->setAnimationLOD(animationUpdatePeriod, isAnimationIKEnabled);
+
+        for (int i = 0; i < _jointData.size(); i++) {
+            const JointData& data = _jointData.at(i);
+            _skeletonModel.setJointRotation(i, data.rotationSet, data.rotation, 1.0f);
+            _skeletonModel.setJointTranslation(i, data.translationSet, data.translation, 1.0f);
+        }
+
+        _isPoseSimulated = _skeletonModel.beginSimulate(_hasNewJointRotations || _hasNewJointTranslations);
+    }
+    return _isPoseSimulated;
+}
+
+void Avatar::simulatePose(float deltaTime) {
+    PerformanceTimer perfTimer("pose");
+    _skeletonModel.simulatePose(deltaTime);
+}
+
+void Avatar::endSimulate(float deltaTime) {
+    if (_isSkeletonSimulated) {
         {
             PerformanceTimer perfTimer("skeleton");
-            for (int i = 0; i < _jointData.size(); i++) {
-                const JointData& data = _jointData.at(i);
-                _skeletonModel.setJointRotation(i, data.rotationSet, data.rotation, 1.0f);
-                _skeletonModel.setJointTranslation(i, data.translationSet, data.translation, 1.0f);
-            }
-
-            _skeletonModel.simulate(deltaTime, _hasNewJointRotations || _hasNewJointTranslations);
+            _skeletonModel.endSimulate(_isPoseSimulated);
             simulateAttachments(deltaTime);
             _hasNewJointRotations = false;
             _hasNewJointTranslations = false;
@@ -245,6 +282,35 @@ void Avatar::simulate(float deltaTime) {
     // until velocity is included in AvatarData update message.
     //_position += _velocity * deltaTime;
     measureMotionDerivatives(deltaTime);
+
+    publishJointSnapshot();
+}
+
+void Avatar::publishJointSnapshot() {
+    if (!_isJointSnapshotWanted) {
+        return;
+    }
+    auto snapshot = std::make_shared<AvatarJointSnapshot>();
+    int jointCount = _skeletonModel.getJointStateCount();
+    snapshot->rotations.resize(jointCount);
+    snapshot->translations.resize(jointCount);
+    snapshot->positions.resize(jointCount);
+    for (int i = 0; i < jointCount; i++) {
+        _skeletonModel.getJointRotation(i, snapshot->rotations[i]);
+        _skeletonModel.getJointTranslation(i, snapshot->translations[i]);
+        _skeletonModel.getJointPositionInWorldFrame(i, snapshot->positions[i]);
+    }
+    if (_skeletonModel.isActive()) {
+        snapshot->jointIndices = _skeletonModel.getGeometry()->getFBXGeometry().jointIndices;
+    }
+
+    // readers holding the previous snapshot keep it alive until they are done with it
+    std::atomic_store(&_jointSnapshot, AvatarJointSnapshotPointer(std::move(snapshot)));
+}
+
+AvatarJointSnapshotPointer Avatar::getJointSnapshot() const {
+    _isJointSnapshotWanted = true;
+    return std::atomic_load(&_jointSnapshot);
 }
 
 bool Avatar::isLookingAtMe(AvatarSharedPointer avatar) {
@@ -618,6 +684,10 @@ void Avatar::renderBody(RenderArgs* renderArgs, ViewFrustum* renderFrustum, floa
     fixupModelsInScene();
     
     {
+        // past the billboard distance the billboard is drawn instead of the models, which are not posed either
+        bool isImpostor = _shouldRenderBillboard && isBillboardLoaded();
+        setModelsVisible(!isImpostor);
+
         if (_shouldRenderBillboard || !(_skeletonModel.isRenderable() && getHead()->getFaceModel().isRenderable())) {
             // render the billboard until both models are loaded
             renderBillboard(renderArgs);
@@ -660,12 +730,9 @@ void Avatar::updateJointMappings() {
     // no-op; joint mappings come from skeleton model
 }
 
-void Avatar::renderBillboard(RenderArgs* renderArgs) {
-    // FIXME disabling the billboard because it doesn't appear to work reliably
-    // the billboard is ending up with a random texture and position.
-    return;
+bool Avatar::isBillboardLoaded() {
     if (_billboard.isEmpty()) {
-        return;
+        return false;
     }
     if (!_billboardTexture) {
         // Using a unique URL ensures we don't get another avatar's texture from TextureCache
@@ -673,7 +740,20 @@ void Avatar::renderBillboard(RenderArgs* renderArgs) {
         _billboardTexture = DependencyManager::get<TextureCache>()->getTexture(
             uniqueUrl, DEFAULT_TEXTURE, _billboard);
     }
-    if (!_billboardTexture || !_billboardTexture->isLoaded()) {
+    return _billboardTexture && _billboardTexture->isLoaded();
+}
+
+void Avatar::setModelsVisible(bool visible) {
+    render::ScenePointer scene = qApp->getMain3DScene();
+    _skeletonModel.setVisibleInScene(visible, scene);
+    getHead()->getFaceModel().setVisibleInScene(visible, scene);
+    for (auto attachmentModel : _attachmentModels) {
+        attachmentModel->setVisibleInScene(visible, scene);
+    }
+}
+
+void Avatar::renderBillboard(RenderArgs* renderArgs) {
+    if (!isBillboardLoaded()) {
         return;
     }
     // rotate about vertical to face the camera
@@ -696,8 +776,9 @@ void Avatar::renderBillboard(RenderArgs* renderArgs) {
     
     gpu::Batch& batch = *renderArgs->_batch;
     PROFILE_RANGE_BATCH(batch, __FUNCTION__);
-    batch.setResourceTexture(0, _billboardTexture->getGPUTexture());
+    batch.setModelTransform(transform);
     DependencyManager::get<DeferredLightingEffect>()->bindSimpleProgram(batch, true);
+    batch.setResourceTexture(0, _billboardTexture->getGPUTexture());
     DependencyManager::get<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, texCoordTopLeft, texCoordBottomRight,
                                                         glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
 }
@@ -870,7 +951,8 @@ glm::vec3 Avatar::getSkeletonPosition() const {
 
 QVector<glm::quat> Avatar::getJointRotations() const {
     if (QThread::currentThread() != thread()) {
-        return AvatarData::getJointRotations();
+        AvatarJointSnapshotPointer snapshot = getJointSnapshot();
+        return snapshot ? snapshot->rotations : AvatarData::getJointRotations();
     }
     QVector<glm::quat> jointRotations(_skeletonModel.getJointStateCount());
     for (int i = 0; i < _skeletonModel.getJointStateCount(); ++i) {
@@ -881,6 +963,10 @@ QVector<glm::quat> Avatar::getJointRotations() const {
 
 glm::quat Avatar::getJointRotation(int index) const {
     if (QThread::currentThread() != thread()) {
+        AvatarJointSnapshotPointer snapshot = getJointSnapshot();
+        if (snapshot) {
+            return index >= 0 && index < snapshot->rotations.size() ? snapshot->rotations[index] : glm::quat();
+        }
         return AvatarData::getJointRotation(index);
     }
     glm::quat rotation;
@@ -890,6 +976,10 @@ glm::quat Avatar::getJointRotation(int index) const {
 
 glm::vec3 Avatar::getJointTranslation(int index) const {
     if (QThread::currentThread() != thread()) {
+        AvatarJointSnapshotPointer snapshot = getJointSnapshot();
+        if (snapshot) {
+            return index >= 0 && index < snapshot->translations.size() ? snapshot->translations[index] : glm::vec3();
+        }
         return AvatarData::getJointTranslation(index);
     }
     glm::vec3 translation;
@@ -900,6 +990,10 @@ glm::vec3 Avatar::getJointTranslation(int index) const {
 
 int Avatar::getJointIndex(const QString& name) const {
     if (QThread::currentThread() != thread()) {
+        AvatarJointSnapshotPointer snapshot = getJointSnapshot();
+        if (snapshot) {
+            return snapshot->jointIndices.value(name) - 1;
+        }
         int result;
         QMetaObject::invokeMethod(const_cast<Avatar*>(this), "getJointIndex", Qt::BlockingQueuedConnection,
             Q_RETURN_ARG(int, result), Q_ARG(const QString&, name));
@@ -920,6 +1014,10 @@ QStringList Avatar::getJointNames() const {
 
 glm::vec3 Avatar::getJointPosition(int index) const {
     if (QThread::currentThread() != thread()) {
+        AvatarJointSnapshotPointer snapshot = getJointSnapshot();
+        if (snapshot) {
+            return index >= 0 && index < snapshot->positions.size() ? snapshot->positions[index] : glm::vec3();
+        }
         glm::vec3 position;
         QMetaObject::invokeMethod(const_cast<Avatar*>(this), "getJointPosition", Qt::BlockingQueuedConnection,
                                   Q_RETURN_ARG(glm::vec3, position), Q_ARG(const int, index));
@@ -932,6 +1030,9 @@ glm::vec3 Avatar::getJointPosition(int index) const {
 
 glm::vec3 Avatar::getJointPosition(const QString& name) const {
     if (QThread::currentThread() != thread()) {
+        if (getJointSnapshot()) {
+            return getJointPosition(getJointIndex(name));
+        }
         glm::vec3 position;
         QMetaObject::invokeMethod(const_cast<Avatar*>(this), "getJointPosition", Qt::BlockingQueuedConnection,
                                   Q_RETURN_ARG(glm::vec3, position), Q_ARG(const QString&, name));
@@ -11,6 +11,9 @@
 #ifndef hifi_Avatar_h
 #define hifi_Avatar_h
 
+#include <atomic>
+#include <memory>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
@@ -55,6 +58,16 @@ enum ScreenTintLayer {
 class AvatarMotionState;
 class Texture;
 
+// the joints of an avatar as of its last simulation, for the scripts that read them from their own threads
+class AvatarJointSnapshot {
+public:
+    QVector<glm::quat> rotations;
+    QVector<glm::vec3> translations;
+    QVector<glm::vec3> positions; // in the world frame
+    QHash<QString, int> jointIndices; // 1-based, as in FBXGeometry
+};
+typedef std::shared_ptr<const AvatarJointSnapshot> AvatarJointSnapshotPointer;
+
 class Avatar : public AvatarData {
     Q_OBJECT
     Q_PROPERTY(glm::vec3 skeletonOffset READ getSkeletonOffset WRITE setSkeletonOffset)
@@ -69,6 +82,13 @@ public:
     void init();
     void simulate(float deltaTime);
 
+    /// simulate() in three parts, so that the poses of the other avatars can be computed in parallel: beginSimulate()
+    /// and endSimulate() run on the main thread, simulatePose() on any thread in between when beginSimulate() returns
+    /// true - the pose only touches this avatar's skeleton
+    bool beginSimulate(float deltaTime);
+    void simulatePose(float deltaTime);
+    void endSimulate(float deltaTime);
+
     virtual void render(RenderArgs* renderArgs, const glm::vec3& cameraPosition);
 
     bool addToScene(AvatarSharedPointer self, std::shared_ptr<render::Scene> scene,
@@ -218,6 +238,9 @@ protected:
 
     void simulateAttachments(float deltaTime);
 
+    // publishes the joints for other threads, once they asked for them
+    void publishJointSnapshot();
+
     virtual void updateJointMappings();
 
     render::ItemID _renderItemID;
@@ -227,9 +250,17 @@ private:
     NetworkTexturePointer _billboardTexture;
     bool _shouldRenderBillboard;
     bool _isLookAtTarget;
+    bool _isSkeletonSimulated { false };   // in view and not a billboard, for the frame being simulated
+    bool _isPoseSimulated { false };       // the rig was evaluated again for the frame being simulated
 
     void renderBillboard(RenderArgs* renderArgs);
 
+    /// Requests the texture of the billboard the first time, true once it can be drawn.
+    bool isBillboardLoaded();
+
+    /// Shows or hides the skeleton, face and attachment models, hidden while the billboard stands in for them.
+    void setModelsVisible(bool visible);
+
     float getBillboardSize() const;
 
     static int _jointConesID;
@@ -237,6 +268,12 @@ private:
     int _voiceSphereID;
 
     AvatarMotionState* _motionState = nullptr;
+
+    // null until another thread asked for the joints, which then read it instead of waiting on the main thread
+    AvatarJointSnapshotPointer getJointSnapshot() const;
+
+    AvatarJointSnapshotPointer _jointSnapshot; // only accessed with std::atomic_load/store
+    mutable std::atomic<bool> _isJointSnapshotWanted { false };
 };
 
 #endif // hifi_Avatar_h
@@ -11,6 +11,9 @@
 
 #include <string>
 
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+
 #include <QScriptEngine>
 
 #if defined(__GNUC__) && !defined(__clang__)
@@ -61,9 +64,31 @@ void AvatarManager::registerMetaTypes(QScriptEngine* engine) {
     qScriptRegisterSequenceMetaType<QVector<AvatarManager::LocalLight> >(engine);
 }
 
+/// Computes the poses of a share of the other avatars on a thread of the AvatarManager's pose pool
+class AvatarPoseJob : public QRunnable {
+public:
+    AvatarPoseJob(const QVector<Avatar*>& avatars, int firstIndex, int indexStep, float deltaTime) :
+        _avatars(avatars), _firstIndex(firstIndex), _indexStep(indexStep), _deltaTime(deltaTime) {}
+
+    void run() {
+        for (int i = _firstIndex; i < _avatars.size(); i += _indexStep) {
+            _avatars[i]->simulatePose(_deltaTime);
+        }
+    }
+
+private:
+    const QVector<Avatar*>& _avatars;
+    int _firstIndex;
+    int _indexStep;
+    float _deltaTime;
+};
+
 AvatarManager::AvatarManager(QObject* parent) :
     _avatarFades()
 {
+    // this thread takes a share of the poses too
+    _poseThreadPool.setMaxThreadCount(qMax(QThread::idealThreadCount() - 1, 1));
+
     // register a meta type for the weak pointer we'll use for the owning avatar mixer for each avatar
     qRegisterMetaType<QWeakPointer<Node> >("NodeWeakPointer");
     _myAvatar = std::make_shared<MyAvatar>(std::make_shared<AvatarRig>());
@@ -118,7 +143,10 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
 
     PerformanceTimer perfTimer("otherAvatars");
 
-    // simulate avatars
+    // simulate avatars - what touches the scene, the entities or other avatars runs here, the pose of each avatar
+    // only touches that avatar and is computed in parallel, before any of them goes on
+    QVector<std::shared_ptr<Avatar>> simulatedAvatars;
+    QVector<Avatar*> posedAvatars;
     AvatarHash::iterator avatarIterator = _avatarHash.begin();
     while (avatarIterator != _avatarHash.end()) {
         auto avatar = std::dynamic_pointer_cast<Avatar>(avatarIterator.value());
@@ -134,16 +162,38 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             avatarIterator = _avatarHash.erase(avatarIterator);
         } else {
             avatar->startUpdate();
-            avatar->simulate(deltaTime);
-            avatar->endUpdate();
+            if (avatar->beginSimulate(deltaTime)) {
+                posedAvatars.push_back(avatar.get());
+            }
+            simulatedAvatars.push_back(avatar);
             ++avatarIterator;
         }
     }
 
+    simulateAvatarPoses(posedAvatars, deltaTime);
+
+    foreach (const std::shared_ptr<Avatar>& avatar, simulatedAvatars) {
+        avatar->endSimulate(deltaTime);
+        avatar->endUpdate();
+    }
+
     // simulate avatar fades
     simulateAvatarFades(deltaTime);
 }
 
+void AvatarManager::simulateAvatarPoses(const QVector<Avatar*>& avatars, float deltaTime) {
+    PerformanceTimer perfTimer("poses");
+
+    int numJobs = qMin(_poseThreadPool.maxThreadCount() + 1, avatars.size());
+    for (int i = 1; i < numJobs; i++) {
+        _poseThreadPool.start(new AvatarPoseJob(avatars, i, numJobs, deltaTime));
+    }
+    if (numJobs > 0) {
+        AvatarPoseJob(avatars, 0, numJobs, deltaTime).run();
+    }
+    _poseThreadPool.waitForDone();
+}
+
 void AvatarManager::simulateAvatarFades(float deltaTime) {
     QVector<AvatarSharedPointer>::iterator fadingIterator = _avatarFades.begin();
 
@@ -15,6 +15,7 @@
 #include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 
 #include <AvatarHashMap.h>
 #include <PhysicsEngine.h>
@@ -74,6 +75,9 @@ private:
     AvatarManager(const AvatarManager& other);
 
     void simulateAvatarFades(float deltaTime);
+
+    /// computes the poses of the avatars, spread across the pose threads and this one, returns once all are done
+    void simulateAvatarPoses(const QVector<Avatar*>& avatars, float deltaTime);
     
     // virtual overrides
     virtual AvatarSharedPointer newSharedAvatar();
@@ -92,6 +96,9 @@ private:
     SetOfAvatarMotionStates _avatarMotionStates;
     SetOfMotionStates _motionStatesToAdd;
     VectorOfMotionStates _motionStatesToDelete;
+
+    // the poses of the other avatars are independent of each other, they are computed here in parallel
+    QThreadPool _poseThreadPool;
 };
 
 Q_DECLARE_METATYPE(AvatarManager::LocalLight)
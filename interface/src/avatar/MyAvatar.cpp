@@ -312,6 +312,7 @@ void MyAvatar::simulate(float deltaTime) {
             data.rotationSet |= _rig->getJointStateRotation(i, data.rotation);
             data.translationSet |= _rig->getJointStateTranslation(i, data.translation);
         }
+        publishJointSnapshot();
     }
 
     {
@@ -1158,8 +1159,8 @@ void MyAvatar::setJointRotations(QVector<glm::quat> jointRotations) {
 
 void MyAvatar::setJointData(int index, const glm::quat& rotation, const glm::vec3& translation) {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setJointData", Q_ARG(int, index), Q_ARG(const glm::quat&, rotation),
-            Q_ARG(const glm::vec3&, translation));
+        queueJointRotation(index, rotation);
+        queueJointTranslation(index, translation);
         return;
     }
     // HACK: ATM only JS scripts call setJointData() on MyAvatar so we hardcode the priority
@@ -1168,7 +1169,7 @@ void MyAvatar::setJointData(int index, const glm::quat& rotation, const glm::vec
 
 void MyAvatar::setJointRotation(int index, const glm::quat& rotation) {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setJointRotation", Q_ARG(int, index), Q_ARG(const glm::quat&, rotation));
+        queueJointRotation(index, rotation);
         return;
     }
     // HACK: ATM only JS scripts call setJointData() on MyAvatar so we hardcode the priority
@@ -1177,7 +1178,7 @@ void MyAvatar::setJointRotation(int index, const glm::quat& rotation) {
 
 void MyAvatar::setJointTranslation(int index, const glm::vec3& translation) {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setJointTranslation", Q_ARG(int, index), Q_ARG(const glm::vec3&, translation));
+        queueJointTranslation(index, translation);
         return;
     }
     // HACK: ATM only JS scripts call setJointData() on MyAvatar so we hardcode the priority
@@ -1186,7 +1187,7 @@ void MyAvatar::setJointTranslation(int index, const glm::vec3& translation) {
 
 void MyAvatar::clearJointData(int index) {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "clearJointData", Q_ARG(int, index));
+        queueJointClear(index);
         return;
     }
     // HACK: ATM only JS scripts call clearJointData() on MyAvatar so we hardcode the priority
@@ -230,18 +230,37 @@ void SkeletonModel::updateAttitude() {
 
 // Called by Avatar::simulate after it has set the joint states (fullUpdate true if changed),
 // but just before head has been simulated.
-void SkeletonModel::simulate(float deltaTime, bool fullUpdate) {
+bool SkeletonModel::beginSimulate(bool fullUpdate) {
     updateAttitude();
     setBlendshapeCoefficients(_owningAvatar->getHead()->getBlendshapeCoefficients());
 
-    Model::simulate(deltaTime, fullUpdate);
+    return prepareSimulate(fullUpdate);
+}
 
+void SkeletonModel::simulatePose(float deltaTime) {
+    // the rig and the skinning only touch this model and its avatar
+    simulateInternal(deltaTime);
+    computeClusterMatrices();
+}
+
+void SkeletonModel::endSimulate(bool isPoseSimulated) {
     // let rig compute the model offset
     glm::vec3 modelOffset;
     if (_rig->getModelOffset(modelOffset)) {
         setOffset(modelOffset);
     }
 
+    if (isPoseSimulated) {
+        requestBlend();
+    }
+}
+
+void SkeletonModel::simulate(float deltaTime, bool fullUpdate) {
+    if (beginSimulate(fullUpdate)) {
+        simulateInternal(deltaTime);
+    }
+    endSimulate(false);
+
     if (!isActive() || !_owningAvatar->isMyAvatar()) {
         return; // only simulate for own avatar
     }
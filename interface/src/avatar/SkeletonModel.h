@@ -31,6 +31,13 @@ public:
 
     virtual void simulate(float deltaTime, bool fullUpdate = true) override;
     virtual void updateRig(float deltaTime, glm::mat4 parentTransform) override;
+
+    /// simulate() of the other avatars, in three parts so that their poses can be computed in parallel:
+    /// beginSimulate() and endSimulate() run on the main thread, simulatePose() on any thread in between
+    /// when beginSimulate() returns true
+    bool beginSimulate(bool fullUpdate);
+    void simulatePose(float deltaTime);
+    void endSimulate(bool isPoseSimulated);
     void updateAttitude();
 
     void renderIKConstraints(gpu::Batch& batch);
@@ -0,0 +1,178 @@
+//
+//  EntitySceneCache.cpp
+//  interface/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySceneCache.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStandardPaths>
+
+#include <StreamUtils.h>
+
+#include "InterfaceLogging.h"
+
+static const quint32 SCENE_FILE_VERSION = 1;
+
+// every entity of the tree
+static QVector<EntityItemPointer> findAllEntities(EntityTreePointer tree) {
+    QVector<EntityItemPointer> entities;
+    tree->findEntities(AACube(glm::vec3(-HALF_TREE_SCALE), TREE_SCALE), entities);
+    return entities;
+}
+
+void EntitySceneCache::enterDomain(const QString& domainKey, EntityTreePointer tree) {
+    QMutexLocker locker(&_mutex);
+    if (domainKey == _domainKey) {
+        return; // still in it
+    }
+    _domainKey = domainKey;
+    _sentScenes.clear();
+    _loadedScene = Scene();
+
+    QFile sceneFile(getScenePath());
+    if (_domainKey.isEmpty() || !sceneFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDataStream sceneStream(&sceneFile);
+    quint32 version = 0;
+    quint64 sceneTime = 0;
+    glm::vec3 position;
+    glm::quat orientation;
+    float fov, aspectRatio, nearClip, farClip;
+    sceneStream >> version >> sceneTime >> position >> orientation >> fov >> aspectRatio >> nearClip >> farClip;
+    if (sceneStream.status() != QDataStream::Ok || version != SCENE_FILE_VERSION || sceneTime == 0) {
+        return;
+    }
+
+    QFile entitiesFile(getEntitiesPath());
+    if (!entitiesFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDataStream entitiesStream(&entitiesFile);
+    bool success = false;
+    tree->withWriteLock([&] {
+        // the tree was cleared when the last domain was left, all its entities come from the cache
+        success = tree->readFromStream(entitiesFile.size(), entitiesStream);
+        foreach (const EntityItemPointer& entity, findAllEntities(tree)) {
+            entity->setIsFromCache(true);
+        }
+    });
+    if (!success) {
+        qCDebug(interfaceapp) << "Unable to load the entities kept for the domain from" << entitiesFile.fileName();
+        return;
+    }
+
+    _loadedScene.time = sceneTime;
+    _loadedScene.view.setPosition(position);
+    _loadedScene.view.setOrientation(orientation);
+    _loadedScene.view.setProjection(glm::perspective(glm::radians(fov), aspectRatio, nearClip, farClip));
+    _loadedScene.view.calculate();
+}
+
+void EntitySceneCache::leaveDomain(EntityTreePointer tree) {
+    QMutexLocker locker(&_mutex);
+    if (_domainKey.isEmpty()) {
+        return;
+    }
+
+    // with more than one entity server their scenes do not share a time, the entities kept are left as they were
+    if (_sentScenes.size() == 1 && _sentScenes.begin()->time > 0) {
+        const Scene& scene = *_sentScenes.begin();
+        QDir().mkpath(QFileInfo(getScenePath()).absolutePath());
+
+        // the scene goes last, so that entities without it are never loaded
+        QFile::remove(getScenePath());
+        tree->writeToSVOFile(qPrintable(getEntitiesPath()));
+
+        QFile sceneFile(getScenePath());
+        if (sceneFile.open(QIODevice::WriteOnly)) {
+            QDataStream sceneStream(&sceneFile);
+            sceneStream << SCENE_FILE_VERSION << scene.time << scene.view.getPosition() << scene.view.getOrientation()
+                << scene.view.getFieldOfView() << scene.view.getAspectRatio() << scene.view.getNearClip()
+                << scene.view.getFarClip();
+        }
+    }
+
+    _domainKey.clear();
+    _sentScenes.clear();
+    _loadedScene = Scene();
+}
+
+void EntitySceneCache::setQueriedView(const ViewFrustum& view) {
+    QMutexLocker locker(&_mutex);
+    _queriedView = view;
+}
+
+bool EntitySceneCache::getResumedScene(quint64& sceneTime, ViewFrustum& view) const {
+    QMutexLocker locker(&_mutex);
+    if (_loadedScene.time == 0) {
+        return false;
+    }
+    sceneTime = _loadedScene.time;
+    view = _loadedScene.view;
+    return true;
+}
+
+void EntitySceneCache::sceneSent(const QUuid& serverID, quint64 startTime, bool isMoving, quint64 resumedSceneTime,
+                                 EntityTreePointer tree) {
+    QMutexLocker locker(&_mutex);
+    if (_domainKey.isEmpty()) {
+        return;
+    }
+
+    bool isNewServer = !_sentScenes.contains(serverID);
+    Scene& scene = _sentScenes[serverID];
+
+    // the first stats of the server tell whether it only sent what changed since the loaded scene
+    if (isNewServer && _loadedScene.time > 0) {
+        if (resumedSceneTime == _loadedScene.time) {
+            scene = _loadedScene;
+        } else {
+            // some of the entities it did not send again may have been deleted while we were away
+            qCDebug(interfaceapp) << "The entity server did not resume the scene kept for the domain";
+            tree->withWriteLock([&] {
+                QSet<EntityItemID> notSentAgain;
+                foreach (const EntityItemPointer& entity, findAllEntities(tree)) {
+                    if (entity->isFromCache()) {
+                        notSentAgain << entity->getEntityItemID();
+                    }
+                }
+                tree->deleteEntities(notSentAgain, true, true);
+            });
+        }
+        _loadedScene = Scene();
+    }
+
+    // the entities in the view are up to date with a scene sent while the view held still
+    if (!isMoving && _queriedView.isVerySimilar(_lastSceneView)) {
+        scene.time = startTime;
+        scene.view = _queriedView;
+    }
+    _lastSceneView = _queriedView;
+}
+
+void EntitySceneCache::serverKilled(const QUuid& serverID) {
+    QMutexLocker locker(&_mutex);
+    _sentScenes.remove(serverID);
+}
+
+QString EntitySceneCache::getScenePath() const {
+    return getEntitiesPath() + ".scene";
+}
+
+QString EntitySceneCache::getEntitiesPath() const {
+    QString fileName = QCryptographicHash::hash(_domainKey.toUtf8(), QCryptographicHash::Md5).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/entities/" + fileName + ".svo";
+}
@@ -0,0 +1,65 @@
+//
+//  EntitySceneCache.h
+//  interface/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySceneCache_h
+#define hifi_EntitySceneCache_h
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include <EntityTree.h>
+#include <ViewFrustum.h>
+
+/// Keeps the entities of a domain on disk between visits. They are saved with the start of the last scene the entity
+/// server sent while the view held still, in the server's time, and the view it was sent for. On the next visit they
+/// are shown right away, and the entity server is asked to send only what changed and was deleted since that scene.
+/// The server tells in its scene stats whether it could; if it could not, the saved entities it did not send again are
+/// dropped. Only domains with a single entity server are saved.
+/// The scenes are reported from the octree packet processor thread, the rest is called from the main thread.
+class EntitySceneCache {
+public:
+    /// the domain entered, with its ID or its hostname for the domains without one; the saved entities of the domain are
+    /// loaded into the tree
+    void enterDomain(const QString& domainKey, EntityTreePointer tree);
+    /// saves the entities of the domain before they are cleared, the domain is left
+    void leaveDomain(EntityTreePointer tree);
+
+    /// the view the last query was sent for
+    void setQueriedView(const ViewFrustum& view);
+    /// the scene an entity server asks to resume from in the query, false when there is none
+    bool getResumedScene(quint64& sceneTime, ViewFrustum& view) const;
+
+    /// from the stats an entity server sent at the end of a scene, see OctreeSceneStats
+    void sceneSent(const QUuid& serverID, quint64 startTime, bool isMoving, quint64 resumedSceneTime,
+                   EntityTreePointer tree);
+    void serverKilled(const QUuid& serverID);
+
+private:
+    QString getScenePath() const;
+    QString getEntitiesPath() const;
+
+    struct Scene {
+        quint64 time { 0 };
+        ViewFrustum view;
+    };
+
+    mutable QMutex _mutex;
+    QString _domainKey;
+
+    ViewFrustum _queriedView;
+    ViewFrustum _lastSceneView; // the view queried when the last scene ended, for the scenes sent for a still view
+    QHash<QUuid, Scene> _sentScenes; // the last scene sent for a still view, for each entity server of the domain
+
+    Scene _loadedScene; // the scene asked to resume from, until the entity server answered
+};
+
+#endif // hifi_EntitySceneCache_h
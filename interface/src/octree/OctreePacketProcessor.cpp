@@ -9,6 +9,11 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
+#include <QRunnable>
+#include <QThread>
+
 #include <PerfStat.h>
 
 #include "Application.h"
@@ -16,11 +21,96 @@
 #include "OctreePacketProcessor.h"
 #include "SceneScriptingInterface.h"
 
+// the longest the entity tree is write locked at a time while decoded packets are read into it, a slice of a frame
+static const quint64 APPLY_BATCH_USECS = 2 * USECS_PER_MSEC;
+
+// how long the processing thread waits for packets while others are still being decoded
+static const unsigned long PENDING_PACKETS_MAX_WAIT_MSECS = 1;
+
+class PendingOctreePacket {
+public:
+    QSharedPointer<NLPacket> packet;
+    SharedNodePointer sendingNode;
+    bool isErase { false };
+    std::shared_ptr<DecodedOctreePacket> decodedPacket;
+    std::atomic<bool> isDecoded { false };
+};
+
+class OctreePacketDecoder : public QRunnable {
+public:
+    OctreePacketDecoder(const std::shared_ptr<PendingOctreePacket>& pendingPacket) : _pendingPacket(pendingPacket) { }
+
+    virtual void run() {
+        _pendingPacket->decodedPacket = qApp->getEntities()->decodeDatagram(*_pendingPacket->packet,
+                                                                            _pendingPacket->sendingNode);
+        _pendingPacket->isDecoded.store(true, std::memory_order_release);
+    }
+
+private:
+    std::shared_ptr<PendingOctreePacket> _pendingPacket;
+};
+
 OctreePacketProcessor::OctreePacketProcessor() {
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     
     packetReceiver.registerDirectListenerForTypes({ PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase },
                                                   this, "handleOctreePacket");
+
+    // leave cores for the render and the other threads
+    _decodeThreads.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+OctreePacketProcessor::~OctreePacketProcessor() {
+    _decodeThreads.waitForDone();
+}
+
+void OctreePacketProcessor::terminating() {
+    ReceivedPacketProcessor::terminating();
+    _decodeThreads.waitForDone();
+}
+
+unsigned long OctreePacketProcessor::getMaxWait() const {
+    return hasPendingPackets() ? PENDING_PACKETS_MAX_WAIT_MSECS : ReceivedPacketProcessor::getMaxWait();
+}
+
+void OctreePacketProcessor::preProcess() {
+    applyDecodedPackets();
+}
+
+void OctreePacketProcessor::postProcess() {
+    applyDecodedPackets();
+}
+
+void OctreePacketProcessor::applyDecodedPackets() {
+    EntityTreeRenderer* entities = qApp->getEntities();
+    while (!_pendingPackets.empty() && _pendingPackets.front()->isDecoded.load(std::memory_order_acquire)) {
+        if (_pendingPackets.front()->isErase) {
+            auto pendingPacket = _pendingPackets.front();
+            _pendingPackets.pop_front();
+            _pendingPacketCount--;
+            entities->processEraseMessage(*pendingPacket->packet, pendingPacket->sendingNode);
+            continue;
+        }
+
+        quint64 startLock = usecTimestampNow();
+        entities->getTree()->withWriteLock([&] {
+            quint64 startBatch = usecTimestampNow();
+            quint64 waitedForLock = startBatch - startLock;
+            while (!_pendingPackets.empty() && _pendingPackets.front()->isDecoded.load(std::memory_order_acquire) &&
+                   !_pendingPackets.front()->isErase && usecTimestampNow() - startBatch < APPLY_BATCH_USECS) {
+                auto pendingPacket = _pendingPackets.front();
+                _pendingPackets.pop_front();
+                _pendingPacketCount--;
+                if (pendingPacket->decodedPacket) {
+                    entities->applyDecodedPacket(*pendingPacket->decodedPacket, waitedForLock);
+                    waitedForLock = 0;
+                }
+            }
+        });
+
+        // let the render and the update take the lock between batches
+        QThread::yieldCurrentThread();
+    }
 }
 
 void OctreePacketProcessor::handleOctreePacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
@@ -52,7 +142,7 @@ void OctreePacketProcessor::processPacket(QSharedPointer<NLPacket> packet, Share
         
         if (piggybackBytes) {
             // construct a new packet from the piggybacked one
-            auto buffer = std::unique_ptr<char[]>(new char[piggybackBytes]);
+            auto buffer = udt::PacketBufferPool::allocate(piggybackBytes);
             memcpy(buffer.get(), packet->getPayload() + statsMessageLength, piggybackBytes);
             
             auto newPacket = NLPacket::fromReceivedPacket(std::move(buffer), piggybackBytes, packet->getSenderSockAddr());
@@ -91,13 +181,29 @@ void OctreePacketProcessor::processPacket(QSharedPointer<NLPacket> packet, Share
     switch(packetType) {
         case PacketType::EntityErase: {
             if (DependencyManager::get<SceneScriptingInterface>()->shouldRenderEntities()) {
-                qApp->getEntities()->processEraseMessage(*packet, sendingNode);
+                // erased after the data packets before it are read into the tree
+                auto pendingPacket = std::make_shared<PendingOctreePacket>();
+                pendingPacket->packet = packet;
+                pendingPacket->sendingNode = sendingNode;
+                pendingPacket->isErase = true;
+                pendingPacket->isDecoded = true;
+                _pendingPackets.push_back(pendingPacket);
+                _pendingPacketCount++;
             }
         } break;
 
         case PacketType::EntityData: {
             if (DependencyManager::get<SceneScriptingInterface>()->shouldRenderEntities()) {
-                qApp->getEntities()->processDatagram(*packet, sendingNode);
+                if (!qApp->getEntities()->getTree()) {
+                    qApp->getEntities()->processDatagram(*packet, sendingNode);
+                    break;
+                }
+                auto pendingPacket = std::make_shared<PendingOctreePacket>();
+                pendingPacket->packet = packet;
+                pendingPacket->sendingNode = sendingNode;
+                _pendingPackets.push_back(pendingPacket);
+                _pendingPacketCount++;
+                _decodeThreads.start(new OctreePacketDecoder(pendingPacket));
             }
         } break;
 
@@ -105,4 +211,6 @@ void OctreePacketProcessor::processPacket(QSharedPointer<NLPacket> packet, Share
             // nothing to do
         } break;
     }
+
+    applyDecodedPackets();
 }
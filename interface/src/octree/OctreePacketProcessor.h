@@ -12,14 +12,31 @@
 #ifndef hifi_OctreePacketProcessor_h
 #define hifi_OctreePacketProcessor_h
 
+#include <atomic>
+#include <deque>
+#include <memory>
+
+#include <QThreadPool>
+
 #include <ReceivedPacketProcessor.h>
 
+class PendingOctreePacket;
+
 /// Handles processing of incoming voxel packets for the interface application. As with other ReceivedPacketProcessor classes
 /// the user is responsible for reading inbound packets and adding them to the processing queue by calling queueReceivedPacket()
+///
+/// Entity data packets are decoded on worker threads without the tree lock, and then read into the tree in their order,
+/// in batches that hold the write lock for a short time each.
 class OctreePacketProcessor : public ReceivedPacketProcessor {
     Q_OBJECT
 public:
     OctreePacketProcessor();
+    virtual ~OctreePacketProcessor();
+
+    /// Are there entity packets being decoded or waiting to be read into the tree
+    bool hasPendingPackets() const { return _pendingPacketCount.load() > 0; }
+
+    virtual void terminating();
 
 signals:
     void packetVersionMismatch();
@@ -27,7 +44,19 @@ signals:
 protected:
     virtual void processPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
 
+    virtual unsigned long getMaxWait() const;
+    virtual void preProcess();
+    virtual void postProcess();
+
 private slots:
     void handleOctreePacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
+
+private:
+    // reads the decoded packets at the front of the queue into the tree, in batches of up to APPLY_BATCH_USECS
+    void applyDecodedPackets();
+
+    QThreadPool _decodeThreads;
+    std::deque<std::shared_ptr<PendingOctreePacket>> _pendingPackets; // only touched by the processing thread
+    std::atomic<int> _pendingPacketCount { 0 };
 };
 #endif // hifi_OctreePacketProcessor_h
@@ -147,6 +147,14 @@ void AudioStatsDialog::renderStats() {
                                                                        QString::number(outputRingBufferLatency,'f', 2)) + QString("  - avg msecs of samples in output ring buffer in last 10s"));
     _audioMixerStats.push_back(QString("Audio output buffer: %1ms").arg(
                                                                         QString::number(mixerRingBufferLatency,'f', 2)) + QString("  - avg msecs of samples in audio output buffer in last 10s"));
+    // the rows of the dialog are made once, the line is there for the Qt output too
+    QString outputBackendName = DependencyManager::get<AudioClient>()->getOutputBackendName();
+    if (outputBackendName.isEmpty()) {
+        _audioMixerStats.push_back(QString("Audio device (Qt): not measured"));
+    } else {
+        _audioMixerStats.push_back(QString("Audio device (%1): %2ms").arg(outputBackendName).arg(
+                                                                          QString::number(audioOutputBufferLatency, 'f', 2)) + QString("  - avg msecs from the samples being pulled to being played, measured by the device"));
+    }
     _audioMixerStats.push_back(QString("TOTAL: %1ms").arg(
                                                           QString::number(totalLatency, 'f', 2)) +QString("  - avg msecs of samples in audio output buffer in last 10s"));
     
@@ -202,6 +210,8 @@ void AudioStatsDialog::renderAudioStreamStats(const AudioStreamStats* streamStat
     
     audioStreamStats->push_back(
                                 QString("Ringbuffer stats | starves: %1, prev_starve_lasted: %2, frames_dropped: %3, overflows: %4").arg(QString::number(streamStats->_starveCount)).arg(QString::number(streamStats->_consecutiveNotMixedCount)).arg(QString::number(streamStats->_framesDropped)).arg(QString::number(streamStats->_overflowCount)));
+    audioStreamStats->push_back(
+                                QString("Jitter buffer | latency: %1ms, jitter: %2ms, starved: %3ms, frames_sped_up: %4, frames_slowed_down: %5").arg(QString::number(streamStats->_latencyMsecs, 'f', 1)).arg(QString::number(streamStats->_jitterMsecs, 'f', 1)).arg(QString::number(streamStats->_starvedMsecs)).arg(QString::number(streamStats->_framesAccelerated)).arg(QString::number(streamStats->_framesExpanded)));
     audioStreamStats->push_back(
                                 QString("Inter-packet timegaps (overall) | min: %1, max: %2, avg: %3").arg(formatUsecTime(streamStats->_timeGapMin).toLatin1().data()).arg(formatUsecTime(streamStats->_timeGapMax).toLatin1().data()).arg(formatUsecTime(streamStats->_timeGapAverage).toLatin1().data()));
     audioStreamStats->push_back(
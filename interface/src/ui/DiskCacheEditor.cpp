@@ -20,6 +20,7 @@
 #include <QMessageBox>
 
 #include <NetworkAccessManager.h>
+#include <ResourceDiskCache.h>
 
 #include "DiskCacheEditor.h"
 
@@ -127,10 +128,10 @@ void DiskCacheEditor::refresh() {
         _path->setText(cache->cacheDirectory());
     }
     if (_size) {
-        _size->setText(stringify(cache->cacheSize()));
+        _size->setText(stringify(cache->cacheSize() + ResourceDiskCache::getSize()));
     }
     if (_maxSize) {
-        _maxSize->setText(stringify(cache->maximumCacheSize()));
+        _maxSize->setText(stringify(cache->maximumCacheSize() + ResourceDiskCache::getMaximumSize()));
     }
 }
 
@@ -144,6 +145,7 @@ void DiskCacheEditor::clear() {
             qDebug() << "DiskCacheEditor::clear(): Clearing disk cache.";
             cache->clear();
         }
+        ResourceDiskCache::clear();
     }
     refresh();
 }
@@ -234,6 +234,11 @@ QVariantList RunningScriptsWidget::getRunning() {
         // The path contains the exact path/URL of the script, which also is used in the stopScript function.
         resultNode.insert("path", runningScript);
         resultNode.insert("local", runningScriptURL.isLocalFile());
+        // where the script spends its time, as of the last second
+        ScriptEngine* scriptEngine = qApp->getScriptEngine(runningScript);
+        if (scriptEngine) {
+            resultNode.insert("profile", scriptEngine->getProfileStats());
+        }
         result.append(resultNode);
     }
     return result;
@@ -20,6 +20,7 @@
 #include <Application.h>
 #include <AudioClient.h>
 #include <GeometryCache.h>
+#include <gpu/Texture.h>
 #include <LODManager.h>
 #include <OffscreenUi.h>
 #include <PerfStat.h>
@@ -119,6 +120,8 @@ void Stats::updateStats(bool force) {
     STAT_UPDATE(framerate, (int)qApp->getFps());
     STAT_UPDATE(simrate, (int)qApp->getAverageSimsPerSecond());
     STAT_UPDATE(avatarSimrate, (int)qApp->getAvatarSimrate());
+    STAT_UPDATE_FLOAT(updateTime, qApp->getAverageUpdateMsecs(), 0.01f);
+    STAT_UPDATE_FLOAT(renderTime, qApp->getAverageRenderMsecs(), 0.01f);
 
     auto bandwidthRecorder = DependencyManager::get<BandwidthRecorder>();
     STAT_UPDATE(packetInCount, bandwidthRecorder->getCachedTotalAverageInputPacketsPerSecond());
@@ -126,6 +129,32 @@ void Stats::updateStats(bool force) {
     STAT_UPDATE_FLOAT(mbpsIn, (float)bandwidthRecorder->getCachedTotalAverageInputKilobitsPerSecond() / 1000.0f, 0.01f);
     STAT_UPDATE_FLOAT(mbpsOut, (float)bandwidthRecorder->getCachedTotalAverageOutputKilobitsPerSecond() / 1000.0f, 0.01f);
 
+    // the time each step of joining the domain was first reached at, since the address lookup
+    {
+        using ConnectionStep = LimitedNodeList::ConnectionStep;
+        static const std::pair<ConnectionStep, const char*> JOIN_PHASES[] = {
+            { ConnectionStep::ReceiveDSList, "DS" },
+            { ConnectionStep::SetAudioMixerSocket, "audio" },
+            { ConnectionStep::SetAvatarMixerSocket, "avatar" },
+            { ConnectionStep::SetEntityServerSocket, "entities" },
+            { ConnectionStep::SetAssetServerSocket, "assets" },
+            { ConnectionStep::ReceiveFirstAudioPacket, "first audio" }
+        };
+
+        QMap<quint64, ConnectionStep> times = nodeList->getLastConnectionTimes();
+        QStringList phases;
+        if (!times.isEmpty()) {
+            quint64 lookupTime = times.firstKey();
+            for (const auto& phase : JOIN_PHASES) {
+                quint64 phaseTime = times.key(phase.first);
+                if (phaseTime != 0) {
+                    phases << QString("%1 %2").arg(phase.second).arg((phaseTime - lookupTime) / USECS_PER_MSEC);
+                }
+            }
+        }
+        STAT_UPDATE(joinTimeline, phases.join(", "));
+    }
+
     // Second column: ping
     if (Menu::getInstance()->isOptionChecked(MenuOption::TestPing)) {
         SharedNodePointer audioMixerNode = nodeList->soloNodeOfType(NodeType::AudioMixer);
@@ -341,10 +370,21 @@ void Stats::updateStats(bool force) {
 void Stats::setRenderDetails(const RenderDetails& details) {
     STAT_UPDATE(triangles, details._trianglesRendered);
     STAT_UPDATE(materialSwitches, details._materialSwitches);
+
+    const int64_t BYTES_PER_MEGABYTE = 1024 * 1024;
+    STAT_UPDATE(textureGPUMemory, (int)(gpu::Texture::getTextureGPUMemoryUsage() / BYTES_PER_MEGABYTE));
+    STAT_UPDATE(textureGPUMemoryBudget, (int)(gpu::Texture::getTextureGPUMemoryBudget() / BYTES_PER_MEGABYTE));
+
+    // the bytes of the buffers uploaded since the last frame
+    const int64_t BYTES_PER_KILOBYTE = 1024;
+    int64_t bufferBytesUploaded = gpu::Buffer::getBufferGPUBytesUploaded();
+    STAT_UPDATE(bufferGPUUploads, (int)((bufferBytesUploaded - _lastBufferGPUBytesUploaded) / BYTES_PER_KILOBYTE));
+    _lastBufferGPUBytesUploaded = bufferBytesUploaded;
     if (_expanded) {
         STAT_UPDATE(opaqueConsidered, details._opaque._considered);
         STAT_UPDATE(opaqueOutOfView, details._opaque._outOfView);
         STAT_UPDATE(opaqueTooSmall, details._opaque._tooSmall);
+        STAT_UPDATE(opaqueOccluded, details._opaque._occluded);
         STAT_UPDATE(opaqueRendered, details._opaque._rendered);
         STAT_UPDATE(translucentConsidered, details._translucent._considered);
         STAT_UPDATE(translucentOutOfView, details._translucent._outOfView);
@@ -35,6 +35,8 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, framerate, 0)
     STATS_PROPERTY(int, simrate, 0)
     STATS_PROPERTY(int, avatarSimrate, 0)
+    STATS_PROPERTY(float, updateTime, 0)
+    STATS_PROPERTY(float, renderTime, 0)
     STATS_PROPERTY(int, avatarCount, 0)
     STATS_PROPERTY(int, packetInCount, 0)
     STATS_PROPERTY(int, packetOutCount, 0)
@@ -44,6 +46,7 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, avatarPing, 0)
     STATS_PROPERTY(int, entitiesPing, 0)
     STATS_PROPERTY(int, assetPing, 0)
+    STATS_PROPERTY(QString, joinTimeline, QString())
     STATS_PROPERTY(QVector3D, position, QVector3D(0, 0, 0) )
     STATS_PROPERTY(float, velocity, 0)
     STATS_PROPERTY(float, yaw, 0)
@@ -58,9 +61,13 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, triangles, 0)
     STATS_PROPERTY(int, quads, 0)
     STATS_PROPERTY(int, materialSwitches, 0)
+    STATS_PROPERTY(int, textureGPUMemory, 0)
+    STATS_PROPERTY(int, textureGPUMemoryBudget, 0)
+    STATS_PROPERTY(int, bufferGPUUploads, 0)
     STATS_PROPERTY(int, opaqueConsidered, 0)
     STATS_PROPERTY(int, opaqueOutOfView, 0)
     STATS_PROPERTY(int, opaqueTooSmall, 0)
+    STATS_PROPERTY(int, opaqueOccluded, 0)
     STATS_PROPERTY(int, opaqueRendered, 0)
     STATS_PROPERTY(int, translucentConsidered, 0)
     STATS_PROPERTY(int, translucentOutOfView, 0)
@@ -116,6 +123,8 @@ signals:
     void framerateChanged();
     void simrateChanged();
     void avatarSimrateChanged();
+    void updateTimeChanged();
+    void renderTimeChanged();
     void avatarCountChanged();
     void packetInCountChanged();
     void packetOutCountChanged();
@@ -139,9 +148,13 @@ signals:
     void trianglesChanged();
     void quadsChanged();
     void materialSwitchesChanged();
+    void textureGPUMemoryChanged();
+    void textureGPUMemoryBudgetChanged();
+    void bufferGPUUploadsChanged();
     void opaqueConsideredChanged();
     void opaqueOutOfViewChanged();
     void opaqueTooSmallChanged();
+    void opaqueOccludedChanged();
     void opaqueRenderedChanged();
     void translucentConsideredChanged();
     void translucentOutOfViewChanged();
@@ -169,6 +182,7 @@ private:
     bool _timingExpanded{ false };
     QString _monospaceFont;
     const AudioIOStats* _audioStats;
+    int64_t _lastBufferGPUBytesUploaded { 0 };
 };
 
 #endif // hifi_Stats_h
@@ -174,3 +174,10 @@ bool Base3DOverlay::findRayIntersection(const glm::vec3& origin, const glm::vec3
                                                         float& distance, BoxFace& face, glm::vec3& surfaceNormal) {
     return false;
 }
+
+bool Base3DOverlay::getRayPickSphere(glm::vec3& center, float& radius) const {
+    AABox bounds = getBounds();
+    center = bounds.calcCenter();
+    radius = glm::length(bounds.getDimensions()) / 2.0f;
+    return true;
+}
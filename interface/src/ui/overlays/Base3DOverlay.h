@@ -65,6 +65,10 @@ public:
         return findRayIntersection(origin, direction, distance, face, surfaceNormal);
     }
 
+    // a sphere around everything findRayIntersection can hit, whichever way the overlay faces, so that picks can skip
+    // the overlays the ray misses; false if the overlay can't tell
+    virtual bool getRayPickSphere(glm::vec3& center, float& radius) const;
+
 protected:
     Transform _transform;
     
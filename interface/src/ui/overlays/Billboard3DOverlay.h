@@ -28,6 +28,9 @@ public:
 
 protected:
     virtual void applyTransformTo(Transform& transform, bool force = false);
+
+    // the transform is only brought up to date with the camera and panel when the overlay is drawn or picked
+    virtual bool getRayPickSphere(glm::vec3& center, float& radius) const { return false; }
 };
 
 #endif // hifi_Billboard3DOverlay_h
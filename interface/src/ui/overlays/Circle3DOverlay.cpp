@@ -96,7 +96,7 @@ void Circle3DOverlay::render(RenderArgs* args) {
     bool colorChanged = colorX.red != _lastColor.red || colorX.green != _lastColor.green || colorX.blue != _lastColor.blue;
     _lastColor = colorX;
 
-    auto geometryCache = DependencyManager::get<GeometryCache>();
+    auto geometryCache = DependencyManager::getRaw<GeometryCache>();
     
     Q_ASSERT(args->_batch);
     auto& batch = *args->_batch;
@@ -106,7 +106,7 @@ void Circle3DOverlay::render(RenderArgs* args) {
     auto transform = _transform;
     transform.postScale(glm::vec3(getDimensions(), 1.0f));
     batch.setModelTransform(transform);
-    DependencyManager::get<DeferredLightingEffect>()->bindSimpleProgram(batch, false, false);
+    DependencyManager::getRaw<DeferredLightingEffect>()->bindSimpleProgram(batch, false, false);
     
     // for our overlay, is solid means we draw a ring between the inner and outer radius of the circle, otherwise
     // we just draw a line...
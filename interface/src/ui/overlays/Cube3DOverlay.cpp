@@ -57,11 +57,11 @@ void Cube3DOverlay::render(RenderArgs* args) {
             //     // enough for the use-case.
             //     transform.setScale(dimensions * _borderSize);
             //     batch->setModelTransform(transform);
-            //     DependencyManager::get<GeometryCache>()->renderSolidCube(*batch, 1.0f, glm::vec4(1.0f, 1.0f, 1.0f, alpha));
+            //     DependencyManager::getRaw<GeometryCache>()->renderSolidCube(*batch, 1.0f, glm::vec4(1.0f, 1.0f, 1.0f, alpha));
             // }
 
             transform.setScale(dimensions);
-            DependencyManager::get<DeferredLightingEffect>()->renderSolidCubeInstance(*batch, transform, cubeColor);
+            DependencyManager::getRaw<DeferredLightingEffect>()->renderSolidCubeInstance(*batch, transform, cubeColor);
         } else {
 
             if (getIsDashedLine()) {
@@ -79,7 +79,7 @@ void Cube3DOverlay::render(RenderArgs* args) {
                 glm::vec3 topLeftFar(-halfDimensions.x, halfDimensions.y, halfDimensions.z);
                 glm::vec3 topRightFar(halfDimensions.x, halfDimensions.y, halfDimensions.z);
 
-                auto geometryCache = DependencyManager::get<GeometryCache>();
+                auto geometryCache = DependencyManager::getRaw<GeometryCache>();
 
                 geometryCache->renderDashedLine(*batch, bottomLeftNear, bottomRightNear, cubeColor);
                 geometryCache->renderDashedLine(*batch, bottomRightNear, bottomRightFar, cubeColor);
@@ -99,7 +99,7 @@ void Cube3DOverlay::render(RenderArgs* args) {
             } else {
                 batch->setModelTransform(Transform());
                 transform.setScale(dimensions);
-                DependencyManager::get<DeferredLightingEffect>()->renderWireCubeInstance(*batch, transform, cubeColor);
+                DependencyManager::getRaw<DeferredLightingEffect>()->renderWireCubeInstance(*batch, transform, cubeColor);
             }
         }
     }
@@ -70,7 +70,7 @@ void Grid3DOverlay::render(RenderArgs* args) {
 
             batch->setModelTransform(transform);
 
-            DependencyManager::get<GeometryCache>()->renderGrid(*batch, MINOR_GRID_DIVISIONS, MINOR_GRID_DIVISIONS, gridColor);
+            DependencyManager::getRaw<GeometryCache>()->renderGrid(*batch, MINOR_GRID_DIVISIONS, MINOR_GRID_DIVISIONS, gridColor);
         }
 
         // Major grid
@@ -88,7 +88,7 @@ void Grid3DOverlay::render(RenderArgs* args) {
 
             batch->setModelTransform(transform);
 
-            DependencyManager::get<GeometryCache>()->renderGrid(*batch, MAJOR_GRID_DIVISIONS, MAJOR_GRID_DIVISIONS, gridColor);
+            DependencyManager::getRaw<GeometryCache>()->renderGrid(*batch, MAJOR_GRID_DIVISIONS, MAJOR_GRID_DIVISIONS, gridColor);
         }
     }
 }
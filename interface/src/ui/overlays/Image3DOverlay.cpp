@@ -94,8 +94,8 @@ void Image3DOverlay::render(RenderArgs* args) {
     batch->setModelTransform(transform);
     batch->setResourceTexture(0, _texture->getGPUTexture());
     
-    DependencyManager::get<DeferredLightingEffect>()->bindSimpleProgram(*batch, true, false, false, true);
-    DependencyManager::get<GeometryCache>()->renderQuad(
+    DependencyManager::getRaw<DeferredLightingEffect>()->bindSimpleProgram(*batch, true, false, false, true);
+    DependencyManager::getRaw<GeometryCache>()->renderQuad(
         *batch, topLeft, bottomRight, texCoordTopLeft, texCoordBottomRight,
         glm::vec4(color.red / MAX_COLOR, color.green / MAX_COLOR, color.blue / MAX_COLOR, alpha)
     );
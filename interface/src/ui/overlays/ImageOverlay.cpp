@@ -61,7 +61,7 @@ void ImageOverlay::render(RenderArgs* args) {
         return;
     }
 
-    auto geometryCache = DependencyManager::get<GeometryCache>();
+    auto geometryCache = DependencyManager::getRaw<GeometryCache>();
     gpu::Batch& batch = *args->_batch;
     geometryCache->useSimpleDrawPipeline(batch);
     if (_renderImage) {
@@ -116,12 +116,12 @@ void ImageOverlay::render(RenderArgs* args) {
             glm::vec2 texCoordBottomRight(x + w, y + h);
             glm::vec4 texcoordRect(texCoordTopLeft, w, h);
 
-            DependencyManager::get<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, texCoordTopLeft, texCoordBottomRight, quadColor);
+            DependencyManager::getRaw<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, texCoordTopLeft, texCoordBottomRight, quadColor);
         } else {
-            DependencyManager::get<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, quadColor);
+            DependencyManager::getRaw<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, quadColor);
         }
     } else {
-        DependencyManager::get<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, quadColor);
+        DependencyManager::getRaw<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, quadColor);
     }
 }
 
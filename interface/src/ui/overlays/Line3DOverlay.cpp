@@ -56,9 +56,9 @@ void Line3DOverlay::render(RenderArgs* args) {
 
         if (getIsDashedLine()) {
             // TODO: add support for color to renderDashedLine()
-            DependencyManager::get<GeometryCache>()->renderDashedLine(*batch, _start, _end, colorv4, _geometryCacheID);
+            DependencyManager::getRaw<GeometryCache>()->renderDashedLine(*batch, _start, _end, colorv4, _geometryCacheID);
         } else {
-            DependencyManager::get<GeometryCache>()->renderLine(*batch, _start, _end, colorv4, _geometryCacheID);
+            DependencyManager::getRaw<GeometryCache>()->renderLine(*batch, _start, _end, colorv4, _geometryCacheID);
         }
     }
 }
@@ -34,6 +34,9 @@ public:
     virtual bool findRayIntersectionExtraInfo(const glm::vec3& origin, const glm::vec3& direction, 
                                         float& distance, BoxFace& face, glm::vec3& surfaceNormal, QString& extraInfo);
 
+    // the model is scaled to fit its dimensions as it loads, until then its meshes can be anywhere
+    virtual bool getRayPickSphere(glm::vec3& center, float& radius) const { return false; }
+
     virtual ModelOverlay* createClone() const;
 
     virtual bool addToScene(Overlay::Pointer overlay, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges);
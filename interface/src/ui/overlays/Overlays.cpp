@@ -14,6 +14,7 @@
 
 #include <QtScript/QScriptValueIterator>
 
+#include <GeometryUtil.h>
 #include <OffscreenUi.h>
 #include <render/Scene.h>
 #include <RegisteredMetaTypes.h>
@@ -420,6 +421,16 @@ RayToOverlayIntersectionResult Overlays::findRayIntersection(const PickRay& ray)
         unsigned int thisID = i.key();
         auto thisOverlay = std::dynamic_pointer_cast<Base3DOverlay>(i.value());
         if (thisOverlay && thisOverlay->getVisible() && !thisOverlay->getIgnoreRayIntersection() && thisOverlay->isLoaded()) {
+            // only overlays hit closer than the best one so far can replace it
+            glm::vec3 sphereCenter;
+            float sphereRadius;
+            float sphereDistance;
+            if (thisOverlay->getRayPickSphere(sphereCenter, sphereRadius) &&
+                (!findRaySphereIntersection(ray.origin, ray.direction, sphereCenter, sphereRadius, sphereDistance) ||
+                 sphereDistance >= bestDistance)) {
+                continue;
+            }
+
             float thisDistance;
             BoxFace thisFace;
             glm::vec3 thisSurfaceNormal;
@@ -57,9 +57,9 @@ void Rectangle3DOverlay::render(RenderArgs* args) {
         if (getIsSolid()) {
             glm::vec3 topLeft(-halfDimensions.x, -halfDimensions.y, 0.0f);
             glm::vec3 bottomRight(halfDimensions.x, halfDimensions.y, 0.0f);
-            DependencyManager::get<GeometryCache>()->renderQuad(*batch, topLeft, bottomRight, rectangleColor);
+            DependencyManager::getRaw<GeometryCache>()->renderQuad(*batch, topLeft, bottomRight, rectangleColor);
         } else {
-            auto geometryCache = DependencyManager::get<GeometryCache>();
+            auto geometryCache = DependencyManager::getRaw<GeometryCache>();
             if (getIsDashedLine()) {
                 glm::vec3 point1(-halfDimensions.x, -halfDimensions.y, 0.0f);
                 glm::vec3 point2(halfDimensions.x, -halfDimensions.y, 0.0f);
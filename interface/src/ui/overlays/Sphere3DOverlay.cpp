@@ -45,9 +45,9 @@ void Sphere3DOverlay::render(RenderArgs* args) {
         Transform transform = _transform;
         transform.postScale(getDimensions() * SPHERE_OVERLAY_SCALE);
         if (_isSolid) {
-            DependencyManager::get<DeferredLightingEffect>()->renderSolidSphereInstance(*batch, transform, sphereColor);
+            DependencyManager::getRaw<DeferredLightingEffect>()->renderSolidSphereInstance(*batch, transform, sphereColor);
         } else {
-            DependencyManager::get<DeferredLightingEffect>()->renderWireSphereInstance(*batch, transform, sphereColor);
+            DependencyManager::getRaw<DeferredLightingEffect>()->renderWireSphereInstance(*batch, transform, sphereColor);
         }
     }
 
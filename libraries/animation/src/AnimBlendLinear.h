@@ -32,7 +32,7 @@ public:
 
     virtual const AnimPoseVec& evaluate(const AnimVariantMap& animVars, float dt, Triggers& triggersOut) override;
 
-    void setAlphaVar(const QString& alphaVar) { _alphaVar = alphaVar; }
+    void setAlphaVar(const QString& alphaVar) { _alphaVar = AnimVariantKey(alphaVar); }
 
 protected:
     // for AnimDebugDraw rendering
@@ -45,7 +45,7 @@ protected:
 
     float _alpha;
 
-    QString _alphaVar;
+    AnimVariantKey _alphaVar;
 
     // no copies
     AnimBlendLinear(const AnimBlendLinear&) = delete;
@@ -41,8 +41,8 @@ public:
 
     virtual const AnimPoseVec& evaluate(const AnimVariantMap& animVars, float dt, Triggers& triggersOut) override;
 
-    void setAlphaVar(const QString& alphaVar) { _alphaVar = alphaVar; }
-    void setDesiredSpeedVar(const QString& desiredSpeedVar) { _desiredSpeedVar = desiredSpeedVar; }
+    void setAlphaVar(const QString& alphaVar) { _alphaVar = AnimVariantKey(alphaVar); }
+    void setDesiredSpeedVar(const QString& desiredSpeedVar) { _desiredSpeedVar = AnimVariantKey(desiredSpeedVar); }
 
 protected:
     // for AnimDebugDraw rendering
@@ -64,8 +64,8 @@ protected:
 
     float _phase = 0.0f;
 
-    QString _alphaVar;
-    QString _desiredSpeedVar;
+    AnimVariantKey _alphaVar;
+    AnimVariantKey _desiredSpeedVar;
 
     std::vector<float> _characteristicSpeeds;
 
@@ -41,12 +41,12 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, float dt,
 
     // poll network anim to see if it's finished loading yet.
     if (_networkAnim && _networkAnim->isLoaded() && _skeleton) {
-        // loading is complete, copy animation frames from network animation, then throw it away.
+        // loading is complete, get the retargeted frames of the network animation, then throw it away.
         copyFromNetworkAnim();
         _networkAnim.reset();
     }
 
-    if (_anim.size()) {
+    if (_clipData && _clipData->getFrameCount() > 0) {
         int prevIndex = (int)glm::floor(_frame);
         int nextIndex;
         if (_loopFlag && _frame >= _endFrame) {
@@ -57,15 +57,19 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, float dt,
 
         // It can be quite possible for the user to set _startFrame and _endFrame to
         // values before or past valid ranges.  We clamp the frames here.
-        int frameCount = _anim.size();
+        int frameCount = _clipData->getFrameCount();
         prevIndex = std::min(std::max(0, prevIndex), frameCount - 1);
         nextIndex = std::min(std::max(0, nextIndex), frameCount - 1);
 
-        const AnimPoseVec& prevFrame = _anim[prevIndex];
-        const AnimPoseVec& nextFrame = _anim[nextIndex];
+        _clipData->sampleFrame(prevIndex, &_prevFrame[0]);
+        if (nextIndex != prevIndex) {
+            _clipData->sampleFrame(nextIndex, &_nextFrame[0]);
+        } else {
+            _nextFrame = _prevFrame;
+        }
         float alpha = glm::fract(_frame);
 
-        ::blend(_poses.size(), &prevFrame[0], &nextFrame[0], alpha, &_poses[0]);
+        ::blend(_poses.size(), &_prevFrame[0], &_nextFrame[0], alpha, &_poses[0]);
     }
 
     return _poses;
@@ -86,66 +90,13 @@ void AnimClip::setCurrentFrameInternal(float frame) {
 
 void AnimClip::copyFromNetworkAnim() {
     assert(_networkAnim && _networkAnim->isLoaded() && _skeleton);
-    _anim.clear();
-
-    // build a mapping from animation joint indices to skeleton joint indices.
-    // by matching joints with the same name.
-    const FBXGeometry& geom = _networkAnim->getGeometry();
-    const QVector<FBXJoint>& animJoints = geom.joints;
-    std::vector<int> jointMap;
-    const int animJointCount = animJoints.count();
-    jointMap.reserve(animJointCount);
-    for (int i = 0; i < animJointCount; i++) {
-        int skeletonJoint = _skeleton->nameToJointIndex(animJoints.at(i).name);
-        if (skeletonJoint == -1) {
-            qCWarning(animation) << "animation contains joint =" << animJoints.at(i).name << " which is not in the skeleton, url =" << _url;
-        }
-        jointMap.push_back(skeletonJoint);
-    }
-
-    const int frameCount = geom.animationFrames.size();
-    const int skeletonJointCount = _skeleton->getNumJoints();
-    _anim.resize(frameCount);
-
-    const glm::vec3 offsetScale = extractScale(geom.offset);
-
-    for (int frame = 0; frame < frameCount; frame++) {
-
-        // init all joints in animation to bind pose
-        // this will give us a resonable result for bones in the skeleton but not in the animation.
-        _anim[frame].reserve(skeletonJointCount);
-        for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
-            _anim[frame].push_back(_skeleton->getRelativeBindPose(skeletonJoint));
-        }
 
-        for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
-
-            int skeletonJoint = jointMap[animJoint];
-
-            // skip joints that are in the animation but not in the skeleton.
-            if (skeletonJoint >= 0 && skeletonJoint < skeletonJointCount) {
-
-                const glm::vec3& fbxZeroTrans = geom.animationFrames[0].translations[animJoint] * offsetScale;
-                const AnimPose& relBindPose = _skeleton->getRelativeBindPose(skeletonJoint);
-
-                // used to adjust translation offsets, so large translation animatons on the reference skeleton
-                // will be adjusted when played on a skeleton with short limbs.
-                float limbLengthScale = fabsf(glm::length(fbxZeroTrans)) <= 0.0001f ? 1.0f : (glm::length(relBindPose.trans) / glm::length(fbxZeroTrans));
-
-                AnimPose& pose = _anim[frame][skeletonJoint];
-                const FBXAnimationFrame& fbxAnimFrame = geom.animationFrames[frame];
-
-                // rotation in fbxAnimationFrame is a delta from a reference skeleton bind pose.
-                pose.rot = relBindPose.rot * fbxAnimFrame.rotations[animJoint];
-
-                // translation in fbxAnimationFrame is not a delta.
-                // convert it into a delta by subtracting from the first frame.
-                const glm::vec3& fbxTrans = fbxAnimFrame.translations[animJoint] * offsetScale;
-                pose.trans = relBindPose.trans + limbLengthScale * (fbxTrans - fbxZeroTrans);
-            }
-        }
-    }
+    // the retargeting happens once for all the clips of the url on skeletons with the same joints
+    _clipData = AnimClipData::get(_url, _networkAnim->getGeometry(), *_skeleton);
 
+    const int skeletonJointCount = _skeleton->getNumJoints();
+    _prevFrame.resize(skeletonJointCount);
+    _nextFrame.resize(skeletonJointCount);
     _poses.resize(skeletonJointCount);
 }
 
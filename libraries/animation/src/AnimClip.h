@@ -13,6 +13,7 @@
 
 #include <string>
 #include "AnimationCache.h"
+#include "AnimClipData.h"
 #include "AnimNode.h"
 
 // Playback a single animation timeline.
@@ -30,11 +31,11 @@ public:
 
     virtual const AnimPoseVec& evaluate(const AnimVariantMap& animVars, float dt, Triggers& triggersOut) override;
 
-    void setStartFrameVar(const QString& startFrameVar) { _startFrameVar = startFrameVar; }
-    void setEndFrameVar(const QString& endFrameVar) { _endFrameVar = endFrameVar; }
-    void setTimeScaleVar(const QString& timeScaleVar) { _timeScaleVar = timeScaleVar; }
-    void setLoopFlagVar(const QString& loopFlagVar) { _loopFlagVar = loopFlagVar; }
-    void setFrameVar(const QString& frameVar) { _frameVar = frameVar; }
+    void setStartFrameVar(const QString& startFrameVar) { _startFrameVar = AnimVariantKey(startFrameVar); }
+    void setEndFrameVar(const QString& endFrameVar) { _endFrameVar = AnimVariantKey(endFrameVar); }
+    void setTimeScaleVar(const QString& timeScaleVar) { _timeScaleVar = AnimVariantKey(timeScaleVar); }
+    void setLoopFlagVar(const QString& loopFlagVar) { _loopFlagVar = AnimVariantKey(loopFlagVar); }
+    void setFrameVar(const QString& frameVar) { _frameVar = AnimVariantKey(frameVar); }
 
     float getStartFrame() const { return _startFrame; }
     float getEndFrame() const { return _endFrame; }
@@ -55,8 +56,10 @@ protected:
     AnimationPointer _networkAnim;
     AnimPoseVec _poses;
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
+    // shared with the other clips of the url on the same skeleton, decompressed into the frames around _frame
+    AnimClipData::Pointer _clipData;
+    AnimPoseVec _prevFrame;
+    AnimPoseVec _nextFrame;
 
     QString _url;
     float _startFrame;
@@ -65,11 +68,11 @@ protected:
     bool _loopFlag;
     float _frame;
 
-    QString _startFrameVar;
-    QString _endFrameVar;
-    QString _timeScaleVar;
-    QString _loopFlagVar;
-    QString _frameVar;
+    AnimVariantKey _startFrameVar;
+    AnimVariantKey _endFrameVar;
+    AnimVariantKey _timeScaleVar;
+    AnimVariantKey _loopFlagVar;
+    AnimVariantKey _frameVar;
 
     // no copies
     AnimClip(const AnimClip&) = delete;
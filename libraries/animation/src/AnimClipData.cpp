@@ -0,0 +1,266 @@
+//
+//  AnimClipData.cpp
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimClipData.h"
+
+#include <algorithm>
+
+#include <QHash>
+#include <QMutex>
+
+#include "AnimationLogging.h"
+#include "GLMHelpers.h"
+
+// how far a keyframe may be from what interpolating its neighbours gives back before it is kept
+const float ROTATION_TOLERANCE = 0.0005f; // in quaternion components
+const float TRANSLATION_TOLERANCE = 0.0001f; // meters
+
+// a gap between keys is never longer than this, which bounds the time spent looking for the longest gaps
+const int MAX_KEY_GAP = 256;
+
+const float QUANTIZED_ONE = 32767.0f;
+
+// the data of the clips that are playing, by url, for every skeleton they were retargeted to
+static QMutex clipDataMutex;
+static QHash<QString, std::vector<std::weak_ptr<const AnimClipData>>> clipDataByURL;
+
+AnimClipData::Pointer AnimClipData::get(const QString& url, const FBXGeometry& animationGeometry,
+                                        const AnimSkeleton& skeleton) {
+    QMutexLocker locker(&clipDataMutex);
+    std::vector<std::weak_ptr<const AnimClipData>>& clipDatas = clipDataByURL[url];
+
+    clipDatas.erase(std::remove_if(clipDatas.begin(), clipDatas.end(),
+        [](const std::weak_ptr<const AnimClipData>& clipData) { return clipData.expired(); }), clipDatas.end());
+    for (auto& weakClipData : clipDatas) {
+        Pointer clipData = weakClipData.lock();
+        if (clipData && clipData->hasSameJoints(skeleton)) {
+            return clipData;
+        }
+    }
+
+    Pointer clipData = std::make_shared<const AnimClipData>(url, animationGeometry, skeleton);
+    clipDatas.push_back(clipData);
+    return clipData;
+}
+
+AnimClipData::AnimClipData(const QString& url, const FBXGeometry& animationGeometry, const AnimSkeleton& skeleton) :
+    _url(url),
+    _frameCount(animationGeometry.animationFrames.size())
+{
+    const int skeletonJointCount = skeleton.getNumJoints();
+    _jointNames.reserve(skeletonJointCount);
+    _relativeBindPoses.reserve(skeletonJointCount);
+    for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
+        _jointNames.push_back(skeleton.getJointName(skeletonJoint));
+        _relativeBindPoses.push_back(skeleton.getRelativeBindPose(skeletonJoint));
+    }
+
+    // build a mapping from skeleton joint indices to animation joint indices.
+    // by matching joints with the same name.
+    const QVector<FBXJoint>& animJoints = animationGeometry.joints;
+    const int animJointCount = animJoints.count();
+    std::vector<int> animJointMap(skeletonJointCount, -1);
+    for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
+        int skeletonJoint = skeleton.nameToJointIndex(animJoints.at(animJoint).name);
+        if (skeletonJoint == -1) {
+            qCWarning(animation) << "animation contains joint =" << animJoints.at(animJoint).name << " which is not in the skeleton, url =" << _url;
+        } else if (skeletonJoint < skeletonJointCount) {
+            animJointMap[skeletonJoint] = animJoint;
+        }
+    }
+
+    const glm::vec3 offsetScale = extractScale(animationGeometry.offset);
+    const QVector<FBXAnimationFrame>& animFrames = animationGeometry.animationFrames;
+
+    // one joint is retargeted at a time, so that the whole clip is never uncompressed
+    _tracks.resize(skeletonJointCount);
+    std::vector<glm::quat> rotations(_frameCount);
+    std::vector<glm::vec3> translations(_frameCount);
+    for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
+        const AnimPose& relBindPose = _relativeBindPoses[skeletonJoint];
+        int animJoint = animJointMap[skeletonJoint];
+
+        if (animJoint < 0 || _frameCount == 0) {
+            // bones in the skeleton but not in the animation hold their bind pose.
+            std::fill(rotations.begin(), rotations.end(), relBindPose.rot);
+            std::fill(translations.begin(), translations.end(), relBindPose.trans);
+        } else {
+            const glm::vec3 fbxZeroTrans = animFrames[0].translations[animJoint] * offsetScale;
+
+            // used to adjust translation offsets, so large translation animatons on the reference skeleton
+            // will be adjusted when played on a skeleton with short limbs.
+            float limbLengthScale = fabsf(glm::length(fbxZeroTrans)) <= 0.0001f ? 1.0f : (glm::length(relBindPose.trans) / glm::length(fbxZeroTrans));
+
+            for (int frame = 0; frame < _frameCount; frame++) {
+                const FBXAnimationFrame& fbxAnimFrame = animFrames[frame];
+
+                // rotation in fbxAnimationFrame is a delta from a reference skeleton bind pose.
+                rotations[frame] = relBindPose.rot * fbxAnimFrame.rotations[animJoint];
+
+                // translation in fbxAnimationFrame is not a delta.
+                // convert it into a delta by subtracting from the first frame.
+                const glm::vec3 fbxTrans = fbxAnimFrame.translations[animJoint] * offsetScale;
+                translations[frame] = relBindPose.trans + limbLengthScale * (fbxTrans - fbxZeroTrans);
+            }
+        }
+
+        _tracks[skeletonJoint].scale = relBindPose.scale;
+        compressTrack(_tracks[skeletonJoint], rotations, translations);
+    }
+}
+
+AnimClipData::QuantizedQuat AnimClipData::quantize(const glm::quat& rotation) {
+    QuantizedQuat quantized;
+    quantized.x = (int16_t)glm::round(glm::clamp(rotation.x, -1.0f, 1.0f) * QUANTIZED_ONE);
+    quantized.y = (int16_t)glm::round(glm::clamp(rotation.y, -1.0f, 1.0f) * QUANTIZED_ONE);
+    quantized.z = (int16_t)glm::round(glm::clamp(rotation.z, -1.0f, 1.0f) * QUANTIZED_ONE);
+    quantized.w = (int16_t)glm::round(glm::clamp(rotation.w, -1.0f, 1.0f) * QUANTIZED_ONE);
+    return quantized;
+}
+
+glm::quat AnimClipData::dequantize(const QuantizedQuat& rotation) {
+    const float SCALE = 1.0f / QUANTIZED_ONE;
+    return glm::normalize(glm::quat(rotation.w * SCALE, rotation.x * SCALE, rotation.y * SCALE, rotation.z * SCALE));
+}
+
+static float getError(const glm::quat& a, const glm::quat& b) {
+    return glm::max(glm::max(fabsf(a.x - b.x), fabsf(a.y - b.y)), glm::max(fabsf(a.z - b.z), fabsf(a.w - b.w)));
+}
+
+static float getError(const glm::vec3& a, const glm::vec3& b) {
+    return glm::max(fabsf(a.x - b.x), glm::max(fabsf(a.y - b.y), fabsf(a.z - b.z)));
+}
+
+static glm::quat interpolate(const glm::quat& a, const glm::quat& b, float alpha) {
+    return glm::normalize(glm::lerp(a, b, alpha));
+}
+
+static glm::vec3 interpolate(const glm::vec3& a, const glm::vec3& b, float alpha) {
+    return lerp(a, b, alpha);
+}
+
+// the frames to keep, from the first to the last, such that every frame left out is within the tolerance of the
+// interpolation between the keys around it
+template <typename T>
+static std::vector<int> findKeyFrames(const std::vector<T>& values, float tolerance) {
+    std::vector<int> keyFrames;
+    int frameCount = (int)values.size();
+    if (frameCount == 0) {
+        return keyFrames;
+    }
+    keyFrames.push_back(0);
+
+    int start = 0;
+    while (start < frameCount - 1) {
+        int end = start + 1;
+        while (end + 1 < frameCount && end + 1 - start <= MAX_KEY_GAP) {
+            // try to leave out end as well
+            int candidate = end + 1;
+            bool fits = true;
+            for (int frame = start + 1; frame < candidate && fits; frame++) {
+                float alpha = (float)(frame - start) / (float)(candidate - start);
+                fits = getError(interpolate(values[start], values[candidate], alpha), values[frame]) <= tolerance;
+            }
+            if (!fits) {
+                break;
+            }
+            end = candidate;
+        }
+        keyFrames.push_back(end);
+        start = end;
+    }
+    return keyFrames;
+}
+
+void AnimClipData::compressTrack(Track& track, const std::vector<glm::quat>& rotations,
+                                 const std::vector<glm::vec3>& translations) {
+    // keep the rotations in the same hemisphere as the previous frame, so that interpolating them takes the short way
+    std::vector<glm::quat> alignedRotations = rotations;
+    for (size_t frame = 1; frame < alignedRotations.size(); frame++) {
+        if (glm::dot(alignedRotations[frame - 1], alignedRotations[frame]) < 0.0f) {
+            alignedRotations[frame] = -alignedRotations[frame];
+        }
+    }
+
+    track.rotationFrames = findKeyFrames(alignedRotations, ROTATION_TOLERANCE);
+    track.rotations.reserve(track.rotationFrames.size());
+    for (int frame : track.rotationFrames) {
+        track.rotations.push_back(quantize(alignedRotations[frame]));
+    }
+
+    track.translationFrames = findKeyFrames(translations, TRANSLATION_TOLERANCE);
+    track.translations.reserve(track.translationFrames.size());
+    for (int frame : track.translationFrames) {
+        track.translations.push_back(translations[frame]);
+    }
+}
+
+// the keys around the frame and how far the frame is between them
+static void findKeys(const std::vector<int>& keyFrames, int frame, int& prevKey, int& nextKey, float& alpha) {
+    auto next = std::upper_bound(keyFrames.begin(), keyFrames.end(), frame);
+    if (next == keyFrames.end()) {
+        prevKey = nextKey = (int)keyFrames.size() - 1;
+        alpha = 0.0f;
+    } else if (next == keyFrames.begin()) {
+        prevKey = nextKey = 0;
+        alpha = 0.0f;
+    } else {
+        nextKey = (int)(next - keyFrames.begin());
+        prevKey = nextKey - 1;
+        alpha = (float)(frame - keyFrames[prevKey]) / (float)(keyFrames[nextKey] - keyFrames[prevKey]);
+    }
+}
+
+void AnimClipData::sampleFrame(int frame, AnimPose* posesOut) const {
+    for (size_t i = 0; i < _tracks.size(); i++) {
+        const Track& track = _tracks[i];
+        AnimPose& pose = posesOut[i];
+        pose.scale = track.scale;
+
+        int prevKey, nextKey;
+        float alpha;
+        findKeys(track.rotationFrames, frame, prevKey, nextKey, alpha);
+        if (prevKey == nextKey) {
+            pose.rot = dequantize(track.rotations[prevKey]);
+        } else {
+            pose.rot = interpolate(dequantize(track.rotations[prevKey]), dequantize(track.rotations[nextKey]), alpha);
+        }
+
+        findKeys(track.translationFrames, frame, prevKey, nextKey, alpha);
+        if (prevKey == nextKey) {
+            pose.trans = track.translations[prevKey];
+        } else {
+            pose.trans = interpolate(track.translations[prevKey], track.translations[nextKey], alpha);
+        }
+    }
+}
+
+bool AnimClipData::hasSameJoints(const AnimSkeleton& skeleton) const {
+    if (skeleton.getNumJoints() != (int)_jointNames.size()) {
+        return false;
+    }
+    for (int i = 0; i < skeleton.getNumJoints(); i++) {
+        const AnimPose& bindPose = skeleton.getRelativeBindPose(i);
+        const AnimPose& ourBindPose = _relativeBindPoses[i];
+        if (skeleton.getJointName(i) != _jointNames[i] || bindPose.rot != ourBindPose.rot ||
+            bindPose.trans != ourBindPose.trans || bindPose.scale != ourBindPose.scale) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t AnimClipData::getKeysSize() const {
+    size_t size = 0;
+    for (auto& track : _tracks) {
+        size += track.rotationFrames.size() * (sizeof(int) + sizeof(QuantizedQuat));
+        size += track.translationFrames.size() * (sizeof(int) + sizeof(glm::vec3));
+    }
+    return size;
+}
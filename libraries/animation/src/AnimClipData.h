@@ -0,0 +1,72 @@
+//
+//  AnimClipData.h
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimClipData_h
+#define hifi_AnimClipData_h
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#include <FBXReader.h>
+
+#include "AnimSkeleton.h"
+
+// The frames of an animation retargeted to a skeleton, compressed: each joint only keeps the keyframes that linear
+// interpolation can't rebuild from their neighbours, and its rotations are quantized to 16 bits per component.
+// Clips of the same url on skeletons with the same joints share the data, which is never written again once built.
+
+class AnimClipData {
+public:
+    using Pointer = std::shared_ptr<const AnimClipData>;
+
+    // the data of the url's animation retargeted to the skeleton, built by the first clip that asks for it
+    static Pointer get(const QString& url, const FBXGeometry& animationGeometry, const AnimSkeleton& skeleton);
+
+    AnimClipData(const QString& url, const FBXGeometry& animationGeometry, const AnimSkeleton& skeleton);
+
+    int getFrameCount() const { return _frameCount; }
+    int getJointCount() const { return (int)_tracks.size(); }
+
+    // decompresses the relative poses of all the joints at the frame, posesOut has room for getJointCount() poses
+    void sampleFrame(int frame, AnimPose* posesOut) const;
+
+    // whether the data was retargeted to a skeleton with these joints and bind poses
+    bool hasSameJoints(const AnimSkeleton& skeleton) const;
+
+    // the bytes taken by the keys
+    size_t getKeysSize() const;
+
+protected:
+    struct QuantizedQuat {
+        int16_t x, y, z, w;
+    };
+
+    struct Track {
+        glm::vec3 scale;
+        std::vector<int> rotationFrames;
+        std::vector<QuantizedQuat> rotations;
+        std::vector<int> translationFrames;
+        std::vector<glm::vec3> translations;
+    };
+
+    static QuantizedQuat quantize(const glm::quat& rotation);
+    static glm::quat dequantize(const QuantizedQuat& rotation);
+
+    void compressTrack(Track& track, const std::vector<glm::quat>& rotations, const std::vector<glm::vec3>& translations);
+
+    QString _url;
+    int _frameCount { 0 };
+    std::vector<Track> _tracks; // by skeleton joint
+
+    std::vector<QString> _jointNames;
+    AnimPoseVec _relativeBindPoses;
+};
+
+#endif // hifi_AnimClipData_h
@@ -9,6 +9,8 @@
 
 #include "AnimInverseKinematics.h"
 
+#include <algorithm>
+
 #include <GeometryUtil.h>
 #include <GLMHelpers.h>
 #include <NumericalConstants.h>
@@ -18,7 +20,9 @@
 #include "SwingTwistConstraint.h"
 #include "AnimationLogging.h"
 
-AnimInverseKinematics::AnimInverseKinematics(const QString& id) : AnimNode(AnimNode::Type::InverseKinematics, id) {
+AnimInverseKinematics::AnimInverseKinematics(const QString& id) :
+    AnimNode(AnimNode::Type::InverseKinematics, id),
+    _isEnabledVar("isIKEnabled") {
 }
 
 AnimInverseKinematics::~AnimInverseKinematics() {
@@ -65,9 +69,9 @@ void AnimInverseKinematics::setTargetVars(
     for (auto& targetVar: _targetVarVec) {
         if (targetVar.jointName == jointName) {
             // update existing targetVar
-            targetVar.positionVar = positionVar;
-            targetVar.rotationVar = rotationVar;
-            targetVar.typeVar = typeVar;
+            targetVar.positionVar = AnimVariantKey(positionVar);
+            targetVar.rotationVar = AnimVariantKey(rotationVar);
+            targetVar.typeVar = AnimVariantKey(typeVar);
             found = true;
             break;
         }
@@ -82,6 +86,7 @@ void AnimInverseKinematics::computeTargets(const AnimVariantMap& animVars, std::
     // build a list of valid targets from _targetVarVec and animVars
     _maxTargetIndex = -1;
     bool removeUnfoundJoints = false;
+    bool hasAbsoluteUnderPoses = false;
     for (auto& targetVar : _targetVarVec) {
         if (targetVar.jointIndex == -1) {
             // this targetVar hasn't been validated yet...
@@ -97,7 +102,12 @@ void AnimInverseKinematics::computeTargets(const AnimVariantMap& animVars, std::
             IKTarget target;
             target.setType(animVars.lookup(targetVar.typeVar, (int)IKTarget::Type::RotationAndPosition));
             if (target.getType() != IKTarget::Type::Unknown) {
-                AnimPose defaultPose = _skeleton->getAbsolutePose(targetVar.jointIndex, underPoses);
+                if (!hasAbsoluteUnderPoses) {
+                    _skeleton->getAbsolutePoses(underPoses, _absoluteUnderPoses);
+                    hasAbsoluteUnderPoses = true;
+                }
+                AnimPose defaultPose = (targetVar.jointIndex < (int)_absoluteUnderPoses.size()) ?
+                    _absoluteUnderPoses[targetVar.jointIndex] : _skeleton->getAbsolutePose(targetVar.jointIndex, underPoses);
                 glm::quat rotation = animVars.lookup(targetVar.rotationVar, defaultPose.rot);
                 glm::vec3 translation = animVars.lookup(targetVar.positionVar, defaultPose.trans);
                 if (target.getType() == IKTarget::Type::HipsRelativeRotationAndPosition) {
@@ -131,6 +141,21 @@ void AnimInverseKinematics::computeTargets(const AnimVariantMap& animVars, std::
     }
 }
 
+void AnimInverseKinematics::solve(const std::vector<IKTarget>& targets) {
+    // both solvers start from the solution of the last frame, relaxed toward the underPoses
+    bool hasHmdHeadTarget = false;
+    for (auto& target: targets) {
+        if (target.getType() == IKTarget::Type::HmdHead) {
+            hasHmdHeadTarget = true;
+        }
+    }
+    if (_solver == Solver::FABRIK && !hasHmdHeadTarget) {
+        solveWithFABRIK(targets);
+    } else {
+        solveWithCyclicCoordinateDescent(targets);
+    }
+}
+
 void AnimInverseKinematics::solveWithCyclicCoordinateDescent(const std::vector<IKTarget>& targets) {
     // compute absolute poses that correspond to relative target poses
     AnimPoseVec absolutePoses;
@@ -273,24 +298,167 @@ void AnimInverseKinematics::solveWithCyclicCoordinateDescent(const std::vector<I
         }
         ++numLoops;
 
-        // harvest accumulated rotations and apply the average
-        const int numJoints = (int)_accumulators.size();
-        for (int i = 0; i < numJoints; ++i) {
-            if (_accumulators[i].size() > 0) {
-                _relativePoses[i].rot = _accumulators[i].getAverage();
-                _accumulators[i].clear();
+        applyAccumulators(lowestMovedIndex, absolutePoses);
+    } while (numLoops < MAX_IK_LOOPS && !hasConverged(targets, absolutePoses));
+    _numSolverLoops = numLoops;
+
+    enforceTipRotations(targets, absolutePoses);
+}
+
+void AnimInverseKinematics::solveWithFABRIK(const std::vector<IKTarget>& targets) {
+    // compute absolute poses that correspond to relative target poses
+    AnimPoseVec absolutePoses;
+    absolutePoses.resize(_relativePoses.size());
+    computeAbsolutePoses(absolutePoses);
+
+    // clear the accumulators before we start the IK solver
+    for (auto& accumulator: _accumulators) {
+        accumulator.clearAndClean();
+    }
+
+    std::vector<int> chain;
+    std::vector<glm::vec3> positions;
+    std::vector<float> lengths;
+
+    int numLoops = 0;
+    const int MAX_FABRIK_LOOPS = 8;
+    do {
+        int lowestMovedIndex = _relativePoses.size();
+        for (auto& target: targets) {
+            IKTarget::Type targetType = target.getType();
+            if (targetType != IKTarget::Type::RotationAndPosition &&
+                    targetType != IKTarget::Type::HipsRelativeRotationAndPosition) {
+                // the final rotation will be enforced after the iterations
+                continue;
             }
-        }
 
-        // only update the absolutePoses that need it: those between lowestMovedIndex and _maxTargetIndex
-        for (int i = lowestMovedIndex; i <= _maxTargetIndex; ++i) {
-            int parentIndex = _skeleton->getParentIndex(i);
-            if (parentIndex != -1) {
-                absolutePoses[i] = absolutePoses[parentIndex] * _relativePoses[i];
+            // the chain goes from the tip up to the last joint CCD would pivot, whose position stays put
+            int tipIndex = target.getIndex();
+            chain.clear();
+            chain.push_back(tipIndex);
+            int pivotIndex = _skeleton->getParentIndex(tipIndex);
+            while (pivotIndex != -1 && pivotIndex != _hipsIndex && _skeleton->getParentIndex(pivotIndex) != -1) {
+                chain.push_back(pivotIndex);
+                pivotIndex = _skeleton->getParentIndex(pivotIndex);
+            }
+            if (chain.size() < 2) {
+                continue;
+            }
+            std::reverse(chain.begin(), chain.end());
+
+            int numPositions = (int)chain.size();
+            positions.resize(numPositions);
+            lengths.resize(numPositions - 1);
+            for (int i = 0; i < numPositions; ++i) {
+                positions[i] = absolutePoses[chain[i]].trans;
             }
+            for (int i = 0; i < numPositions - 1; ++i) {
+                lengths[i] = glm::distance(positions[i], positions[i + 1]);
+            }
+
+            // reach from the target to the base, then back from the base, keeping the lengths of the bones
+            const float MIN_BONE_LENGTH = 1.0e-4f;
+            glm::vec3 basePosition = positions[0];
+            positions[numPositions - 1] = target.getTranslation();
+            for (int i = numPositions - 2; i >= 0; --i) {
+                glm::vec3 bone = positions[i] - positions[i + 1];
+                float boneLength = glm::length(bone);
+                if (boneLength > MIN_BONE_LENGTH) {
+                    positions[i] = positions[i + 1] + (lengths[i] / boneLength) * bone;
+                }
+            }
+            positions[0] = basePosition;
+            for (int i = 0; i < numPositions - 1; ++i) {
+                glm::vec3 bone = positions[i + 1] - positions[i];
+                float boneLength = glm::length(bone);
+                if (boneLength > MIN_BONE_LENGTH) {
+                    positions[i + 1] = positions[i] + (lengths[i] / boneLength) * bone;
+                }
+            }
+
+            // turn each joint from the base down so its child lands on the new position, within its constraint
+            AnimPose parentPose = absolutePoses[_skeleton->getParentIndex(chain[0])];
+            for (int i = 0; i < numPositions - 1; ++i) {
+                int jointIndex = chain[i];
+                AnimPose jointPose = parentPose * _relativePoses[jointIndex];
+                glm::vec3 childPosition = (jointPose * _relativePoses[chain[i + 1]]).trans;
+                glm::vec3 leverArm = childPosition - jointPose.trans;
+                glm::vec3 targetLine = positions[i + 1] - jointPose.trans;
+
+                glm::quat newRot = _relativePoses[jointIndex].rot;
+                if (glm::length(leverArm) > MIN_BONE_LENGTH && glm::length(targetLine) > MIN_BONE_LENGTH) {
+                    glm::quat deltaRotation = rotationBetween(leverArm, targetLine);
+
+                    // Q' = dQ * Q   and   Q = Qp * q   -->   q' = Qp^ * dQ * Q
+                    newRot = glm::normalize(glm::inverse(parentPose.rot) * deltaRotation * jointPose.rot);
+                    RotationConstraint* constraint = getConstraint(jointIndex);
+                    if (constraint) {
+                        constraint->apply(newRot);
+                    }
+                }
+                _accumulators[jointIndex].add(newRot, target.getWeight());
+
+                if (jointIndex < lowestMovedIndex) {
+                    lowestMovedIndex = jointIndex;
+                }
+
+                parentPose = parentPose * AnimPose(_relativePoses[jointIndex].scale, newRot, _relativePoses[jointIndex].trans);
+            }
+        }
+        ++numLoops;
+
+        applyAccumulators(lowestMovedIndex, absolutePoses);
+    } while (numLoops < MAX_FABRIK_LOOPS && !hasConverged(targets, absolutePoses));
+    _numSolverLoops = numLoops;
+
+    enforceTipRotations(targets, absolutePoses);
+}
+
+void AnimInverseKinematics::applyAccumulators(int lowestMovedIndex, AnimPoseVec& absolutePoses) {
+    // harvest accumulated rotations and apply the average
+    const int numJoints = (int)_accumulators.size();
+    for (int i = 0; i < numJoints; ++i) {
+        if (_accumulators[i].size() > 0) {
+            _relativePoses[i].rot = _accumulators[i].getAverage();
+            _accumulators[i].clear();
+        }
+    }
+
+    // only update the absolutePoses that need it: those between lowestMovedIndex and _maxTargetIndex
+    for (int i = lowestMovedIndex; i <= _maxTargetIndex; ++i) {
+        int parentIndex = _skeleton->getParentIndex(i);
+        if (parentIndex != -1) {
+            absolutePoses[i] = absolutePoses[parentIndex] * _relativePoses[i];
         }
-    } while (numLoops < MAX_IK_LOOPS);
+    }
+}
 
+bool AnimInverseKinematics::hasConverged(const std::vector<IKTarget>& targets, const AnimPoseVec& absolutePoses) const {
+    // a solve stops early once every tip is this close to its target, the rotations of the tips come after
+    const float CONVERGED_DISTANCE = 0.001f; // meters
+    const float CONVERGED_ROTATION_DOT = 0.9999875f; // cos(a half of 0.01 radians)
+    for (auto& target: targets) {
+        const AnimPose& tipPose = absolutePoses[target.getIndex()];
+        switch (target.getType()) {
+            case IKTarget::Type::RotationAndPosition:
+            case IKTarget::Type::HipsRelativeRotationAndPosition:
+                if (glm::distance(tipPose.trans, target.getTranslation()) > CONVERGED_DISTANCE) {
+                    return false;
+                }
+                break;
+            case IKTarget::Type::HmdHead:
+                if (fabsf(glm::dot(target.getRotation(), tipPose.rot)) < CONVERGED_ROTATION_DOT) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+void AnimInverseKinematics::enforceTipRotations(const std::vector<IKTarget>& targets, AnimPoseVec& absolutePoses) {
     // finally set the relative rotation of each tip to agree with absolute target rotation
     for (auto& target: targets) {
         int tipIndex = target.getIndex();
@@ -322,6 +490,12 @@ const AnimPoseVec& AnimInverseKinematics::evaluate(const AnimVariantMap& animVar
 
 //virtual
 const AnimPoseVec& AnimInverseKinematics::overlay(const AnimVariantMap& animVars, float dt, Triggers& triggersOut, const AnimPoseVec& underPoses) {
+    if (!animVars.lookup(_isEnabledVar, true)) {
+        // the animation LOD of the rig skips IK, and its constraints, for distant avatars
+        loadPoses(underPoses);
+        return _relativePoses;
+    }
+
     if (_relativePoses.size() != underPoses.size()) {
         loadPoses(underPoses);
     } else {
@@ -369,7 +543,7 @@ const AnimPoseVec& AnimInverseKinematics::overlay(const AnimVariantMap& animVars
                 _relativePoses[_hipsIndex].trans = underPoses[_hipsIndex].trans + scaleFactor * _hipsOffset;
             }
 
-            solveWithCyclicCoordinateDescent(targets);
+            solve(targets);
 
             // compute the new target hips offset (for next frame)
             // by looking for discrepancies between where a targeted endEffector is
@@ -25,6 +25,14 @@ class RotationConstraint;
 class AnimInverseKinematics : public AnimNode {
 public:
 
+    // CCD pivots each joint of a chain in turn toward its target, FABRIK moves the joint positions of the whole chain
+    // to reach the target and back to the base, then turns the joints to match. FABRIK only solves position targets,
+    // a frame with an HmdHead target is solved with CCD.
+    enum class Solver {
+        CyclicCoordinateDescent = 0,
+        FABRIK
+    };
+
     AnimInverseKinematics(const QString& id);
     virtual ~AnimInverseKinematics() override;
 
@@ -37,9 +45,20 @@ public:
     virtual const AnimPoseVec& evaluate(const AnimVariantMap& animVars, float dt, AnimNode::Triggers& triggersOut) override;
     virtual const AnimPoseVec& overlay(const AnimVariantMap& animVars, float dt, Triggers& triggersOut, const AnimPoseVec& underPoses) override;
 
+    void setSolver(Solver solver) { _solver = solver; }
+    Solver getSolver() const { return _solver; }
+
+    // the iterations the last solve took, it stops early once every target is reached
+    int getNumSolverLoops() const { return _numSolverLoops; }
+
 protected:
     void computeTargets(const AnimVariantMap& animVars, std::vector<IKTarget>& targets, const AnimPoseVec& underPoses);
+    void solve(const std::vector<IKTarget>& targets);
     void solveWithCyclicCoordinateDescent(const std::vector<IKTarget>& targets);
+    void solveWithFABRIK(const std::vector<IKTarget>& targets);
+    void applyAccumulators(int lowestMovedIndex, AnimPoseVec& absolutePoses);
+    bool hasConverged(const std::vector<IKTarget>& targets, const AnimPoseVec& absolutePoses) const;
+    void enforceTipRotations(const std::vector<IKTarget>& targets, AnimPoseVec& absolutePoses);
     virtual void setSkeletonInternal(AnimSkeleton::ConstPointer skeleton) override;
 
     // for AnimDebugDraw rendering
@@ -65,9 +84,9 @@ protected:
             jointIndex(-1)
         {}
 
-        QString positionVar;
-        QString rotationVar;
-        QString typeVar;
+        AnimVariantKey positionVar;
+        AnimVariantKey rotationVar;
+        AnimVariantKey typeVar;
         QString jointName;
         int jointIndex; // cached joint index
     };
@@ -75,12 +94,16 @@ protected:
     std::map<int, RotationConstraint*> _constraints;
     std::vector<RotationAccumulator> _accumulators;
     std::vector<IKTargetVar> _targetVarVec;
+    AnimVariantKey _isEnabledVar; // set by the Rig from its animation LOD
     AnimPoseVec _defaultRelativePoses; // poses of the relaxed state
     AnimPoseVec _relativePoses; // current relative poses
+    AnimPoseVec _absoluteUnderPoses; // absolute underPoses, for the defaults of the targets
 
     // experimental data for moving hips during IK
     int _headIndex = -1;
     int _hipsIndex = -1;
+    Solver _solver = Solver::CyclicCoordinateDescent;
+    int _numSolverLoops = 0;
     glm::vec3 _hipsOffset = Vectors::ZERO;
 
     // _maxTargetIndex is tracked to help optimize the recalculation of absolute poses
@@ -35,6 +35,7 @@ const AnimPoseVec& AnimManipulator::overlay(const AnimVariantMap& animVars, floa
         return _poses;
     }
 
+    bool hasAbsoluteUnderPoses = false;
     for (auto& jointVar : _jointVars) {
         if (!jointVar.hasPerformedJointLookup) {
             jointVar.jointIndex = _skeleton->nameToJointIndex(jointVar.jointName);
@@ -51,15 +52,21 @@ const AnimPoseVec& AnimManipulator::overlay(const AnimVariantMap& animVars, floa
             AnimPose parentAbsPose = AnimPose::identity;
             if (jointVar.jointIndex <= (int)underPoses.size()) {
 
+                // the absolute underPoses are computed once for all the jointVars
+                if (!hasAbsoluteUnderPoses) {
+                    _skeleton->getAbsolutePoses(underPoses, _absoluteUnderPoses);
+                    hasAbsoluteUnderPoses = true;
+                }
+
                 // jointVar is an absolute rotation, if it is not set we will use the underPose as our default value
                 defaultRelPose = underPoses[jointVar.jointIndex];
-                defaultAbsPose = _skeleton->getAbsolutePose(jointVar.jointIndex, underPoses);
+                defaultAbsPose = _absoluteUnderPoses[jointVar.jointIndex];
                 defaultAbsPose.rot = animVars.lookup(jointVar.var, defaultAbsPose.rot);
 
                 // because jointVar is absolute, we must use an absolute parent frame to convert into a relative pose.
                 int parentIndex = _skeleton->getParentIndex(jointVar.jointIndex);
                 if (parentIndex >= 0) {
-                    parentAbsPose = _skeleton->getAbsolutePose(parentIndex, underPoses);
+                    parentAbsPose = _absoluteUnderPoses[parentIndex];
                 }
 
             } else {
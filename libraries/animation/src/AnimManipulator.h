@@ -25,13 +25,13 @@ public:
     virtual const AnimPoseVec& evaluate(const AnimVariantMap& animVars, float dt, Triggers& triggersOut) override;
     virtual const AnimPoseVec& overlay(const AnimVariantMap& animVars, float dt, Triggers& triggersOut, const AnimPoseVec& underPoses) override;
 
-    void setAlphaVar(const QString& alphaVar) { _alphaVar = alphaVar; }
+    void setAlphaVar(const QString& alphaVar) { _alphaVar = AnimVariantKey(alphaVar); }
 
     virtual void setSkeletonInternal(AnimSkeleton::ConstPointer skeleton) override;
 
     struct JointVar {
         JointVar(const QString& varIn, const QString& jointNameIn) : var(varIn), jointName(jointNameIn), jointIndex(-1), hasPerformedJointLookup(false) {}
-        QString var = "";
+        AnimVariantKey var;
         QString jointName = "";
         int jointIndex = -1;
         bool hasPerformedJointLookup = false;
@@ -44,8 +44,9 @@ protected:
     virtual const AnimPoseVec& getPosesInternal() const override;
 
     AnimPoseVec _poses;
+    AnimPoseVec _absoluteUnderPoses;
     float _alpha;
-    QString _alphaVar;
+    AnimVariantKey _alphaVar;
 
     std::vector<JointVar> _jointVars;
 
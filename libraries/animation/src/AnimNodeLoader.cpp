@@ -368,6 +368,13 @@ static AnimNode::Pointer loadManipulatorNode(const QJsonObject& jsonObj, const Q
 AnimNode::Pointer loadInverseKinematicsNode(const QJsonObject& jsonObj, const QString& id, const QUrl& jsonUrl) {
     auto node = std::make_shared<AnimInverseKinematics>(id);
 
+    READ_OPTIONAL_STRING(solver, jsonObj);
+    if (solver == "fabrik") {
+        node->setSolver(AnimInverseKinematics::Solver::FABRIK);
+    } else if (!solver.isEmpty() && solver != "ccd") {
+        qCCritical(animation) << "AnimNodeLoader, unknown solver =" << solver << ", defaulting to \"ccd\", url =" << jsonUrl.toDisplayString();
+    }
+
     auto targetsValue = jsonObj.value("targets");
     if (!targetsValue.isArray()) {
         qCCritical(animation) << "AnimNodeLoader, bad array \"targets\" in inverseKinematics node, id =" << id << ", url =" << jsonUrl.toDisplayString();
@@ -10,6 +10,7 @@
 
 #include "AnimSkeleton.h"
 
+#include <algorithm>
 #include <glm/gtx/transform.hpp>
 
 #include <GLMHelpers.h>
@@ -86,6 +87,23 @@ AnimPose AnimSkeleton::getAbsolutePose(int jointIndex, const AnimPoseVec& poses)
     }
 }
 
+void AnimSkeleton::getAbsolutePoses(const AnimPoseVec& relativePoses, AnimPoseVec& absolutePosesOut) const {
+    int numPoses = std::min((int)relativePoses.size(), (int)_joints.size());
+    absolutePosesOut.resize(numPoses);
+
+    // the joints come parents first, like the bind poses are built
+    for (int i = 0; i < numPoses; i++) {
+        int parentIndex = _joints[i].parentIndex;
+        if (parentIndex < 0) {
+            absolutePosesOut[i] = relativePoses[i];
+        } else if (parentIndex < i) {
+            absolutePosesOut[i] = absolutePosesOut[parentIndex] * relativePoses[i];
+        } else {
+            absolutePosesOut[i] = getAbsolutePose(i, relativePoses);
+        }
+    }
+}
+
 void AnimSkeleton::buildSkeletonFromJoints(const std::vector<FBXJoint>& joints, const AnimPose& geometryOffset) {
     _joints = joints;
 
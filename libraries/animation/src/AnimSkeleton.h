@@ -41,6 +41,9 @@ public:
 
     AnimPose getAbsolutePose(int jointIndex, const AnimPoseVec& poses) const;
 
+    // the absolute poses of all the joints in one pass from the root down, rather than a walk up the parents per joint
+    void getAbsolutePoses(const AnimPoseVec& relativePoses, AnimPoseVec& absolutePosesOut) const;
+
 #ifndef NDEBUG
     void dump() const;
     void dump(const AnimPoseVec& poses) const;
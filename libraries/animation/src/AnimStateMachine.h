@@ -51,7 +51,7 @@ protected:
             friend AnimStateMachine;
             Transition(const QString& var, State::Pointer state) : _var(var), _state(state) {}
         protected:
-            QString _var;
+            AnimVariantKey _var;
             State::Pointer _state;
         };
 
@@ -61,8 +61,8 @@ protected:
             _interpTarget(interpTarget),
             _interpDuration(interpDuration) {}
 
-        void setInterpTargetVar(const QString& interpTargetVar) { _interpTargetVar = interpTargetVar; }
-        void setInterpDurationVar(const QString& interpDurationVar) { _interpDurationVar = interpDurationVar; }
+        void setInterpTargetVar(const QString& interpTargetVar) { _interpTargetVar = AnimVariantKey(interpTargetVar); }
+        void setInterpDurationVar(const QString& interpDurationVar) { _interpDurationVar = AnimVariantKey(interpDurationVar); }
 
         AnimNode::Pointer getNode() const { return _node; }
         const QString& getID() const { return _id; }
@@ -79,8 +79,8 @@ protected:
         float _interpTarget;  // frames
         float _interpDuration; // frames
 
-        QString _interpTargetVar;
-        QString _interpDurationVar;
+        AnimVariantKey _interpTargetVar;
+        AnimVariantKey _interpDurationVar;
 
         std::vector<Transition> _transitions;
 
@@ -97,7 +97,7 @@ public:
 
     virtual const AnimPoseVec& evaluate(const AnimVariantMap& animVars, float dt, Triggers& triggersOut) override;
 
-    void setCurrentStateVar(QString& currentStateVar) { _currentStateVar = currentStateVar; }
+    void setCurrentStateVar(QString& currentStateVar) { _currentStateVar = AnimVariantKey(currentStateVar); }
 
 protected:
 
@@ -123,7 +123,7 @@ protected:
     State::Pointer _currentState;
     std::vector<State::Pointer> _states;
 
-    QString _currentStateVar;
+    AnimVariantKey _currentStateVar;
 
 private:
     // no copies
@@ -11,19 +11,90 @@
 #include "AnimUtil.h"
 #include "GLMHelpers.h"
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
+static inline void blendInto(const AnimPose& aPose, const AnimPose& bPose, float alpha, AnimPose& result) {
+    result.scale = lerp(aPose.scale, bPose.scale, alpha);
+    result.rot = glm::normalize(glm::lerp(aPose.rot, bPose.rot, alpha));
+    result.trans = lerp(aPose.trans, bPose.trans, alpha);
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// a pose is a packed scale, rotation and translation, so four poses are ten vectors of floats
+const int FLOATS_PER_POSE = 10;
+static_assert(sizeof(AnimPose) == FLOATS_PER_POSE * sizeof(float), "AnimPose must be packed floats");
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    const float* aFloats = reinterpret_cast<const float*>(a);
+    const float* bFloats = reinterpret_cast<const float*>(b);
+    float* resultFloats = reinterpret_cast<float*>(result);
+    __m128 alpha4 = _mm_set1_ps(alpha);
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 zero = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= numPoses; i += 4) {
+        // scales, rotations and translations are all lerped alike, a vector is read before its result is written
+        // so the result may be one of the inputs
+        size_t offset = i * FLOATS_PER_POSE;
+        for (int j = 0; j < FLOATS_PER_POSE; j++) {
+            __m128 x = _mm_loadu_ps(&aFloats[offset + 4 * j]);
+            __m128 y = _mm_loadu_ps(&bFloats[offset + 4 * j]);
+            _mm_storeu_ps(&resultFloats[offset + 4 * j], _mm_add_ps(x, _mm_mul_ps(_mm_sub_ps(y, x), alpha4)));
+        }
+
+        // then the four rotations are transposed into one vector per component to be normalized together
+        float* rot0 = reinterpret_cast<float*>(&result[i].rot);
+        float* rot1 = reinterpret_cast<float*>(&result[i + 1].rot);
+        float* rot2 = reinterpret_cast<float*>(&result[i + 2].rot);
+        float* rot3 = reinterpret_cast<float*>(&result[i + 3].rot);
+        __m128 c0 = _mm_loadu_ps(rot0);
+        __m128 c1 = _mm_loadu_ps(rot1);
+        __m128 c2 = _mm_loadu_ps(rot2);
+        __m128 c3 = _mm_loadu_ps(rot3);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, c0), _mm_mul_ps(c1, c1)),
+                                          _mm_add_ps(_mm_mul_ps(c2, c2), _mm_mul_ps(c3, c3)));
+        if (_mm_movemask_ps(_mm_cmpgt_ps(lengthSquared, zero)) != 0xf) {
+            // opposite rotations lerped to nothing, glm::normalize knows what to answer
+            for (size_t k = i; k < i + 4; k++) {
+                result[k].rot = glm::normalize(result[k].rot);
+            }
+            continue;
+        }
+        __m128 inverseLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+        c0 = _mm_mul_ps(c0, inverseLength);
+        c1 = _mm_mul_ps(c1, inverseLength);
+        c2 = _mm_mul_ps(c2, inverseLength);
+        c3 = _mm_mul_ps(c3, inverseLength);
+
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(rot0, c0);
+        _mm_storeu_ps(rot1, c1);
+        _mm_storeu_ps(rot2, c2);
+        _mm_storeu_ps(rot3, c3);
+    }
+
+    for (; i < numPoses; i++) {
+        blendInto(a[i], b[i], alpha, result[i]);
+    }
+}
+
+#else
 
 void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
     for (size_t i = 0; i < numPoses; i++) {
-        const AnimPose& aPose = a[i];
-        const AnimPose& bPose = b[i];
-        result[i].scale = lerp(aPose.scale, bPose.scale, alpha);
-        result[i].rot = glm::normalize(glm::lerp(aPose.rot, bPose.rot, alpha));
-        result[i].trans = lerp(aPose.trans, bPose.trans, alpha);
+        blendInto(a[i], b[i], alpha, result[i]);
     }
 }
 
+#endif
+
 float accumulateTime(float startFrame, float endFrame, float timeScale, float currentFrame, float dt, bool loopFlag,
                      const QString& id, AnimNode::Triggers& triggersOut) {
 
@@ -9,12 +9,91 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QHash>
+#include <QReadWriteLock>
 #include <QScriptEngine>
 #include <QScriptValueIterator>
 #include <QThread>
+#include <QVector>
 #include <RegisteredMetaTypes.h>
 #include "AnimVariant.h" // which has AnimVariant/AnimVariantMap
 
+// the names are interned once, by the loader or the first set(), then every map and every thread shares the slots
+static QReadWriteLock keySlotsLock;
+static QHash<QString, int> keySlots;
+static QVector<QString> keyNames;
+
+AnimVariantKey::AnimVariantKey(const QString& name) : _name(name) {
+    if (name.isEmpty()) {
+        return;
+    }
+    {
+        QReadLocker locker(&keySlotsLock);
+        auto iter = keySlots.constFind(name);
+        if (iter != keySlots.constEnd()) {
+            _slot = iter.value();
+            return;
+        }
+    }
+    QWriteLocker locker(&keySlotsLock);
+    auto iter = keySlots.constFind(name);
+    if (iter != keySlots.constEnd()) {
+        _slot = iter.value();
+    } else {
+        _slot = keyNames.size();
+        keyNames.append(name);
+        keySlots.insert(name, _slot);
+    }
+}
+
+AnimVariantKey AnimVariantKey::find(const QString& name) {
+    AnimVariantKey key;
+    QReadLocker locker(&keySlotsLock);
+    auto iter = keySlots.constFind(name);
+    if (iter != keySlots.constEnd()) {
+        key._name = name;
+        key._slot = iter.value();
+    }
+    return key;
+}
+
+QString AnimVariantKey::getNameOfSlot(int slot) {
+    QReadLocker locker(&keySlotsLock);
+    return keyNames.value(slot);
+}
+
+void AnimVariantMap::setVariant(const AnimVariantKey& key, const AnimVariant& value) {
+    if (key.isEmpty()) {
+        return;
+    }
+    int slot = key.getSlot();
+    if (slot >= (int)_values.size()) {
+        _values.resize(slot + 1);
+        _isSet.resize(slot + 1, false);
+    }
+    _values[slot] = value;
+    _isSet[slot] = true;
+}
+
+void AnimVariantMap::unset(const AnimVariantKey& key) {
+    int slot = key.getSlot();
+    if (slot >= 0 && slot < (int)_values.size()) {
+        _values[slot] = AnimVariant();
+        _isSet[slot] = false;
+    }
+}
+
+void AnimVariantMap::setTrigger(const AnimVariantKey& key) {
+    if (key.isEmpty()) {
+        return;
+    }
+    int slot = key.getSlot();
+    if (slot >= (int)_isTrigger.size()) {
+        _isTrigger.resize(slot + 1, false);
+    }
+    _isTrigger[slot] = true;
+}
+
 QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine, const QStringList& names, bool useNames) const {
     if (QThread::currentThread() != engine->thread()) {
         qCWarning(animation) << "Cannot create Javacript object from non-script thread" << QThread::currentThread();
@@ -49,22 +128,31 @@ QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine,
     };
     if (useNames) { // copy only the requested names
         for (const QString& name : names) {
-            auto search = _map.find(name);
-            if (search != _map.end()) { // scripts are allowed to request names that do not exist
-                setOne(name, search->second);
+            const AnimVariant* value = find(AnimVariantKey::find(name).getSlot());
+            if (value) { // scripts are allowed to request names that do not exist
+                setOne(name, *value);
             }
         }
 
     } else {  // copy all of them
-        for (auto& pair : _map) {
-            setOne(pair.first, pair.second);
+        for (int slot = 0; slot < (int)_values.size(); slot++) {
+            if (_isSet[slot]) {
+                setOne(AnimVariantKey::getNameOfSlot(slot), _values[slot]);
+            }
         }
     }
     return target;
 }
 void AnimVariantMap::copyVariantsFrom(const AnimVariantMap& other) {
-    for (auto& pair : other._map) {
-        _map[pair.first] = pair.second;
+    if (other._values.size() > _values.size()) {
+        _values.resize(other._values.size());
+        _isSet.resize(other._isSet.size(), false);
+    }
+    for (int slot = 0; slot < (int)other._values.size(); slot++) {
+        if (other._isSet[slot]) {
+            _values[slot] = other._values[slot];
+            _isSet[slot] = true;
+        }
     }
 }
 
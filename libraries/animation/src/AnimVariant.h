@@ -11,12 +11,12 @@
 #ifndef hifi_AnimVariant_h
 #define hifi_AnimVariant_h
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
-#include <map>
-#include <set>
+#include <vector>
 #include <QScriptValue>
 #include "AnimationLogging.h"
 #include "StreamUtils.h"
@@ -79,89 +79,116 @@ protected:
     } _val;
 };
 
+/// A variable name interned to a slot, the same slot in every AnimVariantMap, so that the nodes of a graph look their
+/// variables up by index rather than by name. AnimNodeLoader interns the names of a graph when it loads it.
+class AnimVariantKey {
+public:
+    AnimVariantKey() {}
+    explicit AnimVariantKey(const QString& name); // interns the name, an empty name stays an empty key
+
+    /// the key of a name that was already interned, or an empty key - lookups of unknown names don't grow the slots
+    static AnimVariantKey find(const QString& name);
+
+    /// the name that was interned to the slot
+    static QString getNameOfSlot(int slot);
+
+    bool isEmpty() const { return _slot < 0; }
+    int getSlot() const { return _slot; }
+    const QString& getName() const { return _name; }
+
+private:
+    QString _name;
+    int _slot { -1 };
+};
+
 class AnimVariantMap {
 public:
 
-    bool lookup(const QString& key, bool defaultValue) const {
+    bool lookup(const AnimVariantKey& key, bool defaultValue) const {
         // check triggers first, then map
         if (key.isEmpty()) {
             return defaultValue;
-        } else if (_triggers.find(key) != _triggers.end()) {
+        } else if (isTrigger(key.getSlot())) {
             return true;
         } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getBool() : defaultValue;
+            const AnimVariant* value = find(key.getSlot());
+            return value ? value->getBool() : defaultValue;
         }
     }
 
-    int lookup(const QString& key, int defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getInt() : defaultValue;
-        }
+    int lookup(const AnimVariantKey& key, int defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getInt() : defaultValue;
     }
 
-    float lookup(const QString& key, float defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getFloat() : defaultValue;
-        }
+    float lookup(const AnimVariantKey& key, float defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getFloat() : defaultValue;
     }
 
-    const glm::vec3& lookup(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getVec3() : defaultValue;
-        }
+    const glm::vec3& lookup(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getVec3() : defaultValue;
     }
 
-    const glm::quat& lookup(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getQuat() : defaultValue;
-        }
+    const glm::quat& lookup(const AnimVariantKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getQuat() : defaultValue;
     }
 
-    const glm::mat4& lookup(const QString& key, const glm::mat4& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getMat4() : defaultValue;
-        }
+    const glm::mat4& lookup(const AnimVariantKey& key, const glm::mat4& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getMat4() : defaultValue;
     }
 
-    const QString& lookup(const QString& key, const QString& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getString() : defaultValue;
-        }
+    const QString& lookup(const AnimVariantKey& key, const QString& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getString() : defaultValue;
     }
 
-    void set(const QString& key, bool value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, int value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, float value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::vec3& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::quat& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::mat4& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const QString& value) { _map[key] = AnimVariant(value); }
-    void unset(const QString& key) { _map.erase(key); }
-
-    void setTrigger(const QString& key) { _triggers.insert(key); }
-    void clearTriggers() { _triggers.clear(); }
+    // by name, for the scripts and the Rig - each call finds the slot of the name first
+    bool lookup(const QString& key, bool defaultValue) const { return lookup(AnimVariantKey::find(key), defaultValue); }
+    int lookup(const QString& key, int defaultValue) const { return lookup(AnimVariantKey::find(key), defaultValue); }
+    float lookup(const QString& key, float defaultValue) const { return lookup(AnimVariantKey::find(key), defaultValue); }
+    const glm::vec3& lookup(const QString& key, const glm::vec3& defaultValue) const {
+        return lookup(AnimVariantKey::find(key), defaultValue);
+    }
+    const glm::quat& lookup(const QString& key, const glm::quat& defaultValue) const {
+        return lookup(AnimVariantKey::find(key), defaultValue);
+    }
+    const glm::mat4& lookup(const QString& key, const glm::mat4& defaultValue) const {
+        return lookup(AnimVariantKey::find(key), defaultValue);
+    }
+    const QString& lookup(const QString& key, const QString& defaultValue) const {
+        return lookup(AnimVariantKey::find(key), defaultValue);
+    }
 
-    void clearMap() { _map.clear(); }
-    bool hasKey(const QString& key) const { return _map.find(key) != _map.end(); }
+    void set(const AnimVariantKey& key, bool value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, int value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, float value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::vec3& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::quat& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::mat4& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const QString& value) { setVariant(key, AnimVariant(value)); }
+
+    void set(const QString& key, bool value) { setVariant(AnimVariantKey(key), AnimVariant(value)); }
+    void set(const QString& key, int value) { setVariant(AnimVariantKey(key), AnimVariant(value)); }
+    void set(const QString& key, float value) { setVariant(AnimVariantKey(key), AnimVariant(value)); }
+    void set(const QString& key, const glm::vec3& value) { setVariant(AnimVariantKey(key), AnimVariant(value)); }
+    void set(const QString& key, const glm::quat& value) { setVariant(AnimVariantKey(key), AnimVariant(value)); }
+    void set(const QString& key, const glm::mat4& value) { setVariant(AnimVariantKey(key), AnimVariant(value)); }
+    void set(const QString& key, const QString& value) { setVariant(AnimVariantKey(key), AnimVariant(value)); }
+
+    void unset(const AnimVariantKey& key);
+    void unset(const QString& key) { unset(AnimVariantKey::find(key)); }
+
+    void setTrigger(const AnimVariantKey& key);
+    void setTrigger(const QString& key) { setTrigger(AnimVariantKey(key)); }
+    void clearTriggers() { std::fill(_isTrigger.begin(), _isTrigger.end(), false); }
+
+    void clearMap() { _values.clear(); _isSet.clear(); }
+    bool hasKey(const AnimVariantKey& key) const { return find(key.getSlot()) != nullptr; }
+    bool hasKey(const QString& key) const { return hasKey(AnimVariantKey::find(key)); }
 
     // Answer a Plain Old Javascript Object (for the given engine) all of our values set as properties.
     QScriptValue animVariantMapToScriptValue(QScriptEngine* engine, const QStringList& names, bool useNames) const;
@@ -172,28 +199,33 @@ public:
 #ifdef NDEBUG
     void dump() const {
         qCDebug(animation) << "AnimVariantMap =";
-        for (auto& pair : _map) {
-            switch (pair.second.getType()) {
+        for (int slot = 0; slot < (int)_values.size(); slot++) {
+            if (!_isSet[slot]) {
+                continue;
+            }
+            QString name = AnimVariantKey::getNameOfSlot(slot);
+            const AnimVariant& value = _values[slot];
+            switch (value.getType()) {
             case AnimVariant::Type::Bool:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getBool();
+                qCDebug(animation) << "    " << name << "=" << value.getBool();
                 break;
             case AnimVariant::Type::Int:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getInt();
+                qCDebug(animation) << "    " << name << "=" << value.getInt();
                 break;
             case AnimVariant::Type::Float:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getFloat();
+                qCDebug(animation) << "    " << name << "=" << value.getFloat();
                 break;
             case AnimVariant::Type::Vec3:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getVec3();
+                qCDebug(animation) << "    " << name << "=" << value.getVec3();
                 break;
             case AnimVariant::Type::Quat:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getQuat();
+                qCDebug(animation) << "    " << name << "=" << value.getQuat();
                 break;
             case AnimVariant::Type::Mat4:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getMat4();
+                qCDebug(animation) << "    " << name << "=" << value.getMat4();
                 break;
             case AnimVariant::Type::String:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getString();
+                qCDebug(animation) << "    " << name << "=" << value.getString();
                 break;
             default:
                 assert("AnimVariant::Type" == "valid");
@@ -203,8 +235,16 @@ public:
 #endif
 
 protected:
-    std::map<QString, AnimVariant> _map;
-    std::set<QString> _triggers;
+    const AnimVariant* find(int slot) const {
+        return (slot >= 0 && slot < (int)_isSet.size() && _isSet[slot]) ? &_values[slot] : nullptr;
+    }
+    bool isTrigger(int slot) const { return slot >= 0 && slot < (int)_isTrigger.size() && _isTrigger[slot]; }
+    void setVariant(const AnimVariantKey& key, const AnimVariant& value);
+
+    // indexed by the slots of the keys, they only grow as far as the highest slot that was set
+    std::vector<AnimVariant> _values;
+    std::vector<bool> _isSet;
+    std::vector<bool> _isTrigger;
 };
 
 typedef std::function<void(QScriptValue)> AnimVariantResultHandler;
@@ -21,6 +21,7 @@
 #include "AnimationHandle.h"
 #include "AnimationLogging.h"
 #include "AnimSkeleton.h"
+#include "AnimUtil.h"
 #include "IKTarget.h"
 
 void insertSorted(QList<AnimationHandlePointer>& handles, const AnimationHandlePointer& handle) {
@@ -705,20 +706,42 @@ void Rig::updateAnimationStateHandlers() { // called on avatar update thread (wh
     }
 }
 
-void Rig::updateAnimations(float deltaTime, glm::mat4 rootTransform) {
+void Rig::setAnimationLOD(float updatePeriod, bool isIKEnabled) {
+    _animationLODUpdatePeriod = updatePeriod;
+    _isAnimationLODIKEnabled = isIKEnabled;
+}
+
+bool Rig::updateAnimations(float deltaTime, glm::mat4 rootTransform) {
+
+    // the time since the last update is what the next one animates by
+    _animationLODDeltaTime += deltaTime;
+    bool isUpdateDue = _animationLODDeltaTime >= _animationLODUpdatePeriod;
 
     if (_enableAnimGraph) {
         if (!_animNode) {
-            return;
+            return false;
         }
 
-        updateAnimationStateHandlers();
-        // evaluate the animation
-        AnimNode::Triggers triggersOut;
-        AnimPoseVec poses = _animNode->evaluate(_animVars, deltaTime, triggersOut);
-        _animVars.clearTriggers();
-        for (auto& trigger : triggersOut) {
-            _animVars.setTrigger(trigger);
+        if (isUpdateDue || _animationLODPoses.empty()) {
+            updateAnimationStateHandlers();
+            _animVars.set("isIKEnabled", _isAnimationLODIKEnabled);
+
+            // evaluate the animation
+            AnimNode::Triggers triggersOut;
+            _animationLODPreviousPoses.swap(_animationLODPoses);
+            _animationLODPoses = _animNode->evaluate(_animVars, _animationLODDeltaTime, triggersOut);
+            _animVars.clearTriggers();
+            for (auto& trigger : triggersOut) {
+                _animVars.setTrigger(trigger);
+            }
+            _animationLODDeltaTime = 0.0f;
+        }
+
+        // below the full rate, the joints follow from the previous update to the last one by the next one
+        AnimPoseVec poses = _animationLODPoses;
+        if (_animationLODUpdatePeriod > 0.0f && _animationLODPreviousPoses.size() == poses.size()) {
+            float alpha = glm::clamp(_animationLODDeltaTime / _animationLODUpdatePeriod, 0.0f, 1.0f);
+            ::blend(poses.size(), &_animationLODPreviousPoses[0], &_animationLODPoses[0], alpha, &poses[0]);
         }
 
         clearJointStatePriorities();
@@ -731,6 +754,11 @@ void Rig::updateAnimations(float deltaTime, glm::mat4 rootTransform) {
         }
 
     } else {
+        if (!isUpdateDue) {
+            return false;
+        }
+        deltaTime = _animationLODDeltaTime;
+        _animationLODDeltaTime = 0.0f;
 
         // First normalize the fades so that they sum to 1.0.
         // update the fade data in each animation (not normalized as they are an independent propert of animation)
@@ -782,6 +810,7 @@ void Rig::updateAnimations(float deltaTime, glm::mat4 rootTransform) {
     for (int i = 0; i < _jointStates.size(); i++) {
         _jointStates[i].resetTransformChanged();
     }
+    return true;
 }
 
 bool Rig::setJointPosition(int jointIndex, const glm::vec3& position, const glm::quat& rotation, bool useRotation,
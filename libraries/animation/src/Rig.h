@@ -169,8 +169,12 @@ public:
     void setJointVisibleTransform(int jointIndex, glm::mat4 newTransform);
     // Start or stop animations as needed.
     void computeMotionAnimationState(float deltaTime, const glm::vec3& worldPosition, const glm::vec3& worldVelocity, const glm::quat& worldRotation);
+    // How much animation a rig is worth, chosen by its owner from how far it is: the joints are only updated once per
+    // updatePeriod (0 for every frame), with the graph's poses interpolated in between, and IK only runs if enabled.
+    void setAnimationLOD(float updatePeriod, bool isIKEnabled);
     // Regardless of who started the animations or how many, update the joints.
-    void updateAnimations(float deltaTime, glm::mat4 rootTransform);
+    // Returns false if the animation LOD skipped this frame, in which case the joints keep their last update.
+    bool updateAnimations(float deltaTime, glm::mat4 rootTransform);
     bool setJointPosition(int jointIndex, const glm::vec3& position, const glm::quat& rotation, bool useRotation,
                           int lastFreeIndex, bool allIntermediatesFree, const glm::vec3& alignment, float priority,
                           const QVector<int>& freeLineage, glm::mat4 rootTransform);
@@ -260,6 +264,12 @@ public:
     SimpleMovingAverage _averageForwardSpeed{ 10 };
     SimpleMovingAverage _averageLateralSpeed{ 10 };
 
+    float _animationLODUpdatePeriod { 0.0f };
+    float _animationLODDeltaTime { 0.0f }; // since the last update
+    bool _isAnimationLODIKEnabled { true };
+    AnimPoseVec _animationLODPreviousPoses; // the graph's poses of the last two updates, interpolated in between
+    AnimPoseVec _animationLODPoses;
+
 private:
     QMap<int, StateHandler> _stateHandlers;
     int _nextStateHandlerId {0};
@@ -30,6 +30,7 @@
 #endif
 
 #include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
 #include <QtMultimedia/QAudioInput>
 #include <QtMultimedia/QAudioOutput>
 
@@ -57,6 +58,7 @@ extern "C" {
 #endif
 
 #include <NodeList.h>
+#include <plugins/CodecPlugins.h>
 #include <udt/PacketHeaders.h>
 #include <PositionalAudioStream.h>
 #include <SettingHandle.h>
@@ -91,6 +93,7 @@ AudioClient::AudioClient() :
     _inputFormat(),
     _numInputCallbackBytes(0),
     _audioOutput(NULL),
+    _outputBackend(NULL),
     _desiredOutputFormat(),
     _outputFormat(),
     _outputFrameSize(0),
@@ -109,6 +112,7 @@ AudioClient::AudioClient() :
                                      DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_PERIOD),
     _outputStarveDetectionThreshold("audioOutputStarveDetectionThreshold",
                                     DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_THRESHOLD),
+    _lowLatencyOutputEnabled("audioLowLatencyOutput", DEFAULT_AUDIO_LOW_LATENCY_OUTPUT_ENABLED),
     _averagedLatency(0.0f),
     _lastInputLoudness(0.0f),
     _timeSinceLastClip(-1.0f),
@@ -136,6 +140,9 @@ AudioClient::AudioClient() :
     connect(&_receivedAudioStream, &MixedProcessedAudioStream::processSamples,
             this, &AudioClient::processReceivedSamples, Qt::DirectConnection);
 
+    // the packets come in on the network thread and the device pulls the samples on its own, neither waits on a lock
+    _receivedAudioStream.setSingleProducerSingleConsumer(true);
+
     _inputDevices = getDeviceNames(QAudio::AudioInput);
     _outputDevices = getDeviceNames(QAudio::AudioOutput);
 
@@ -155,10 +162,12 @@ AudioClient::AudioClient() :
     packetReceiver.registerListener(PacketType::MixedAudio, this, "handleAudioDataPacket");
     packetReceiver.registerListener(PacketType::NoisyMute, this, "handleNoisyMutePacket");
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
+    packetReceiver.registerListener(PacketType::SelectedAudioFormat, this, "handleSelectedAudioFormat");
 }
 
 AudioClient::~AudioClient() {
     stop();
+    cleanupCodec();
 
     if (_gverb) {
         gverb_free(_gverb);
@@ -178,11 +187,76 @@ void AudioClient::reset() {
 
 void AudioClient::audioMixerKilled() {
     _hasReceivedFirstPacket = false;
+    _hasMixerReverb = false;
     _outgoingAvatarAudioSequenceNumber = 0;
     _stats.reset();
+    cleanupCodec();
     emit disconnected();
 }
 
+void AudioClient::negotiateAudioFormat() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+
+    if (audioMixer) {
+        auto negotiateFormatPacket = NLPacket::create(PacketType::NegotiateAudioFormat);
+
+        // offer every codec we have, in our order of preference - the mixer makes the final pick
+        QByteArray offer;
+        QDataStream offerStream(&offer, QIODevice::WriteOnly);
+        offerStream << getCodecPluginNames();
+        negotiateFormatPacket->write(offer);
+
+        nodeList->sendPacket(std::move(negotiateFormatPacket), *audioMixer);
+    }
+}
+
+void AudioClient::handleSelectedAudioFormat(QSharedPointer<NLPacket> packet) {
+    QString selectedCodecName;
+    QDataStream packetStream(packet->readAll());
+    packetStream >> selectedCodecName;
+
+    cleanupCodec();
+
+    _codec = getCodecPlugin(selectedCodecName);
+    if (!_codec) {
+        qCDebug(audioclient) << "Audio mixer selected unknown codec" << selectedCodecName << "- falling back to PCM";
+        return;
+    }
+
+    qCDebug(audioclient) << "Audio mixer selected codec" << selectedCodecName;
+    _selectedCodecName = selectedCodecName;
+
+    setupEncoder();
+
+    // the mixer always sends us a stereo mix
+    _receivedAudioStream.setupCodec(_codec, _selectedCodecName, AudioConstants::STEREO);
+}
+
+void AudioClient::setupEncoder() {
+    if (_encoder) {
+        _codec->releaseEncoder(_encoder);
+        _encoder = nullptr;
+    }
+
+    if (_codec) {
+        _encoder = _codec->createEncoder(AudioConstants::SAMPLE_RATE,
+                                         _isStereoInput ? AudioConstants::STEREO : AudioConstants::MONO);
+    }
+}
+
+void AudioClient::cleanupCodec() {
+    _receivedAudioStream.cleanupCodec();
+
+    if (_codec && _encoder) {
+        _codec->releaseEncoder(_encoder);
+    }
+
+    _encoder = nullptr;
+    _codec.reset();
+    _selectedCodecName = QString();
+}
+
 
 QAudioDeviceInfo getNamedAudioDeviceForMode(QAudio::Mode mode, const QString& deviceName) {
     QAudioDeviceInfo result;
@@ -504,15 +578,22 @@ void AudioClient::handleAudioEnvironmentDataPacket(QSharedPointer<NLPacket> pack
         packet->readPrimitive(&wetLevel);
         _receivedAudioStream.setReverb(reverbTime, wetLevel);
     } else {
+        // also when the mixer has the zone reverb in the mix already, we mustn't add it a second time
         _receivedAudioStream.clearReverb();
    }
+
+    bool hasMixerReverb = oneAtBit(bitset, HAS_MIXER_REVERB_BIT);
+    if (hasMixerReverb != _hasMixerReverb) {
+        _hasMixerReverb = hasMixerReverb;
+        qCDebug(audioclient) << "The reverb of the zone" << (hasMixerReverb ? "is" : "isn't") << "mixed by the audio mixer";
+    }
 }
 
 void AudioClient::handleAudioDataPacket(QSharedPointer<NLPacket> packet) {
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::ReceiveFirstAudioPacket);
 
-    if (_audioOutput) {
+    if (_audioOutput || _outputBackend) {
 
         if (!_hasReceivedFirstPacket) {
             _hasReceivedFirstPacket = true;
@@ -688,7 +769,7 @@ void AudioClient::addReverb(ty_gverb* gverb, int16_t* samplesData, int16_t* reve
 void AudioClient::handleLocalEchoAndReverb(QByteArray& inputByteArray) {
     // If there is server echo, reverb will be applied to the recieved audio stream so no need to have it here.
     bool hasReverb = _reverb || _receivedAudioStream.hasReverb();
-    if (_muted || !_audioOutput || (!_shouldEchoLocally && !hasReverb)) {
+    if (_muted || (!_audioOutput && !_outputBackend) || (!_shouldEchoLocally && !hasReverb)) {
         return;
     }
 
@@ -889,8 +970,16 @@ void AudioClient::handleAudioInput() {
             _audioPacket->writePrimitive(headOrientation);
             
             if (_audioPacket->getType() != PacketType::SilentAudioFrame) {
-                // audio samples have already been packed (written to networkAudioSamples)
-                _audioPacket->setPayloadSize(_audioPacket->getPayloadSize() + numNetworkBytes);
+                if (_encoder) {
+                    // the raw samples are still sitting past the header, encode them and write the result in their place
+                    QByteArray decodedBuffer(reinterpret_cast<char*>(networkAudioSamples), numNetworkBytes);
+                    QByteArray encodedBuffer;
+                    _encoder->encode(decodedBuffer, encodedBuffer);
+                    _audioPacket->write(encodedBuffer.constData(), encodedBuffer.size());
+                } else {
+                    // audio samples have already been packed (written to networkAudioSamples)
+                    _audioPacket->setPayloadSize(_audioPacket->getPayloadSize() + numNetworkBytes);
+                }
             }
             
             _stats.sentPacket();
@@ -958,6 +1047,9 @@ void AudioClient::setIsStereoInput(bool isStereoInput) {
             _desiredInputFormat.setChannelCount(1);
         }
 
+        // the encoder is tied to a channel count, replace it
+        setupEncoder();
+
         // change in channel count for desired input format, restart the input device
         switchInputToAudioDevice(_inputAudioDeviceName);
     }
@@ -1120,12 +1212,22 @@ bool AudioClient::switchOutputToAudioDevice(const QAudioDeviceInfo& outputDevice
     bool supportedFormat = false;
 
     // cleanup any previously initialized device
+    if (_outputBackend) {
+        // once stopped, the device doesn't pull from the stream anymore
+        _outputBackend->stop();
+
+        delete _outputBackend;
+        _outputBackend = NULL;
+    }
+
     if (_audioOutput) {
         _audioOutput->stop();
 
         delete _audioOutput;
         _audioOutput = NULL;
+    }
 
+    if (_loopbackAudioOutput) {
         _loopbackOutputDevice = NULL;
         delete _loopbackAudioOutput;
         _loopbackAudioOutput = NULL;
@@ -1168,16 +1270,33 @@ bool AudioClient::switchOutputToAudioDevice(const QAudioDeviceInfo& outputDevice
 
             outputFormatChanged();
 
-            // setup our general output device for audio-mixer audio
-            _audioOutput = new QAudioOutput(outputDeviceInfo, _outputFormat, this);
-            _audioOutput->setBufferSize(_outputBufferSizeFrames.get() * _outputFrameSize * sizeof(int16_t));
+            _audioOutputIODevice.start();
 
-            connect(_audioOutput, &QAudioOutput::notify, this, &AudioClient::outputNotify);
+            // the native backends only open the default device, the others stay with Qt
+            if (_lowLatencyOutputEnabled.get() &&
+                    outputDeviceInfo.deviceName() == defaultAudioDeviceForMode(QAudio::AudioOutput).deviceName()) {
+                _outputBackend = AudioOutputBackend::create();
+                if (_outputBackend && !_outputBackend->start(_outputFormat.sampleRate(), _outputFormat.channelCount(),
+                        [this](int16_t* samples, int numSamples) {
+                            _audioOutputIODevice.pullSamples(samples, numSamples);
+                        })) {
+                    qCDebug(audioclient) << "Couldn't open the" << _outputBackend->getName() << "output, using Qt.";
+                    delete _outputBackend;
+                    _outputBackend = NULL;
+                }
+            }
 
-            qCDebug(audioclient) << "Output Buffer capacity in frames: " << _audioOutput->bufferSize() / sizeof(int16_t) / (float)_outputFrameSize;
+            if (!_outputBackend) {
+                // setup our general output device for audio-mixer audio
+                _audioOutput = new QAudioOutput(outputDeviceInfo, _outputFormat, this);
+                _audioOutput->setBufferSize(_outputBufferSizeFrames.get() * _outputFrameSize * sizeof(int16_t));
 
-            _audioOutputIODevice.start();
-            _audioOutput->start(&_audioOutputIODevice);
+                connect(_audioOutput, &QAudioOutput::notify, this, &AudioClient::outputNotify);
+
+                qCDebug(audioclient) << "Output Buffer capacity in frames: " << _audioOutput->bufferSize() / sizeof(int16_t) / (float)_outputFrameSize;
+
+                _audioOutput->start(&_audioOutputIODevice);
+            }
 
             // setup a loopback audio output device
             _loopbackAudioOutput = new QAudioOutput(outputDeviceInfo, _outputFormat, this);
@@ -1207,6 +1326,16 @@ void AudioClient::setOutputBufferSize(int numFrames) {
     }
 }
 
+void AudioClient::toggleLowLatencyOutput() {
+    _lowLatencyOutputEnabled.set(!_lowLatencyOutputEnabled.get());
+    qCDebug(audioclient) << "Low latency audio output:" << _lowLatencyOutputEnabled.get();
+
+    if (_audioOutput || _outputBackend) {
+        // the output device is opened again, through the backend now asked for
+        switchOutputToAudioDevice(getNamedAudioDeviceForMode(QAudio::AudioOutput, _outputAudioDeviceName));
+    }
+}
+
 // The following constant is operating system dependent due to differences in
 // the way input audio is handled. The audio input buffer size is inversely
 // proportional to the accelerator ratio.
@@ -1252,6 +1381,9 @@ float AudioClient::getInputRingBufferMsecsAvailable() const {
 }
 
 float AudioClient::getAudioOutputMsecsUnplayed() const {
+    if (_outputBackend) {
+        return _outputBackend->getLatencyMsecs();
+    }
     if (!_audioOutput) {
         return 0.0f;
     }
@@ -1265,9 +1397,7 @@ qint64 AudioClient::AudioOutputIODevice::readData(char * data, qint64 maxSize) {
     int samplesPopped;
     int bytesWritten;
 
-    if ((samplesPopped = _receivedAudioStream.popSamples(samplesRequested, false)) > 0) {
-        AudioRingBuffer::ConstIterator lastPopOutput = _receivedAudioStream.getLastPopOutput();
-        lastPopOutput.readSamples((int16_t*)data, samplesPopped);
+    if ((samplesPopped = _receivedAudioStream.popSamples((int16_t*)data, samplesRequested, false)) > 0) {
         bytesWritten = samplesPopped * sizeof(int16_t);
     } else {
         memset(data, 0, maxSize);
@@ -1282,6 +1412,13 @@ qint64 AudioClient::AudioOutputIODevice::readData(char * data, qint64 maxSize) {
     return bytesWritten;
 }
 
+void AudioClient::AudioOutputIODevice::pullSamples(int16_t* samples, int numSamples) {
+    int samplesPopped = _receivedAudioStream.popSamples(samples, numSamples, false);
+    if (samplesPopped < numSamples) {
+        memset(samples + samplesPopped, 0, (numSamples - samplesPopped) * sizeof(int16_t));
+    }
+}
+
 void AudioClient::checkDevices() {
 #   ifdef Q_OS_LINUX
     // on linux, this makes the audio stream hiccup
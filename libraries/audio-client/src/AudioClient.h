@@ -38,6 +38,7 @@
 #include <HifiSockAddr.h>
 #include <NLPacket.h>
 #include <MixedProcessedAudioStream.h>
+#include <plugins/CodecPlugin.h>
 #include <RingBufferHistory.h>
 #include <SettingHandle.h>
 #include <Sound.h>
@@ -45,6 +46,7 @@
 
 #include "AudioIOStats.h"
 #include "AudioNoiseGate.h"
+#include "AudioOutputBackend.h"
 #include "AudioSRC.h"
 
 #ifdef _WIN32
@@ -69,6 +71,7 @@ static const int MAX_AUDIO_OUTPUT_BUFFER_SIZE_FRAMES = 20;
 #endif
 static const int DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_THRESHOLD = 3;
 static const quint64 DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_PERIOD = 10 * 1000; // 10 Seconds
+static const bool DEFAULT_AUDIO_LOW_LATENCY_OUTPUT_ENABLED = false;
 
 class QAudioInput;
 class QAudioOutput;
@@ -96,6 +99,9 @@ public:
         qint64    readData(char * data, qint64 maxSize);
         qint64    writeData(const char * data, qint64 maxSize) { return 0; }
 
+        /// fills the whole buffer of a native device, with silence past what the stream has
+        void pullSamples(int16_t* samples, int numSamples);
+
         int getRecentUnfulfilledReads() { int unfulfilledReads = _unfulfilledReads; _unfulfilledReads = 0; return unfulfilledReads; }
     private:
         MixedProcessedAudioStream& _receivedAudioStream;
@@ -129,6 +135,11 @@ public:
     void setOutputStarveDetectionPeriod(int msecs) { _outputStarveDetectionPeriodMsec.set(msecs); }
 
     int getOutputStarveDetectionThreshold() { return _outputStarveDetectionThreshold.get(); }
+
+    bool isLowLatencyOutputEnabled() { return _lowLatencyOutputEnabled.get(); }
+
+    /// the native backend the output goes through, empty when it's QAudioOutput
+    QString getOutputBackendName() const { return _outputBackend ? _outputBackend->getName() : QString(); }
     void setOutputStarveDetectionThreshold(int threshold) { _outputStarveDetectionThreshold.set(threshold); }
 
     void setPositionGetter(AudioPositionGetter positionGetter) { _positionGetter = positionGetter; }
@@ -144,11 +155,13 @@ public slots:
     void handleAudioDataPacket(QSharedPointer<NLPacket> packet);
     void handleNoisyMutePacket(QSharedPointer<NLPacket> packet);
     void handleMuteEnvironmentPacket(QSharedPointer<NLPacket> packet);
+    void handleSelectedAudioFormat(QSharedPointer<NLPacket> packet);
 
     void sendDownstreamAudioStatsPacket() { _stats.sendDownstreamAudioStatsPacket(); }
     void handleAudioInput();
     void reset();
     void audioMixerKilled();
+    void negotiateAudioFormat();
     void toggleMute();
 
     virtual void enableAudioSourceInject(bool enable);
@@ -162,6 +175,8 @@ public slots:
     void toggleLocalEcho() { _shouldEchoLocally = !_shouldEchoLocally; }
     void toggleServerEcho() { _shouldEchoToServer = !_shouldEchoToServer; }
 
+    void toggleLowLatencyOutput();
+
     void processReceivedSamples(const QByteArray& inputBuffer, QByteArray& outputBuffer);
     void sendMuteEnvironmentPacket();
 
@@ -221,6 +236,7 @@ private:
     int _numInputCallbackBytes;
     int16_t _localProceduralSamples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
     QAudioOutput* _audioOutput;
+    AudioOutputBackend* _outputBackend;
     QAudioFormat _desiredOutputFormat;
     QAudioFormat _outputFormat;
     int _outputFrameSize;
@@ -243,6 +259,7 @@ private:
     Setting::Handle<int> _outputStarveDetectionPeriodMsec;
      // Maximum number of starves per _outputStarveDetectionPeriod before increasing buffer size
     Setting::Handle<int> _outputStarveDetectionThreshold;
+    Setting::Handle<bool> _lowLatencyOutputEnabled;
 
     StDev _stdev;
     QElapsedTimer _timeSinceLastReceived;
@@ -317,8 +334,16 @@ private:
     void checkDevices();
 
     bool _hasReceivedFirstPacket = false;
+    bool _hasMixerReverb = false;
 
     std::unique_ptr<NLPacket> _audioPacket;
+
+    CodecPluginPointer _codec;
+    QString _selectedCodecName;
+    Encoder* _encoder { nullptr }; // for outbound mic stream
+
+    void setupEncoder();
+    void cleanupCodec();
 };
 
 
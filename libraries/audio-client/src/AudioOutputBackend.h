@@ -0,0 +1,41 @@
+//
+//  AudioOutputBackend.h
+//  libraries/audio-client/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioOutputBackend_h
+#define hifi_AudioOutputBackend_h
+
+#include <functional>
+#include <stdint.h>
+
+/// An output device opened through the native API of the platform instead of QAudioOutput, with a buffer of a few
+/// milliseconds that the device fills by pulling the samples on its own thread when it needs them.
+class AudioOutputBackend {
+public:
+    /// Fills the interleaved int16 samples for the device. Called on the thread of the device, it must not block.
+    using PullCallback = std::function<void(int16_t* samples, int numSamples)>;
+
+    /// Returns the backend of this platform for the default output device, null if there is none.
+    static AudioOutputBackend* create();
+
+    virtual ~AudioOutputBackend() {}
+
+    virtual const char* getName() const = 0;
+
+    /// Opens the default output device in the given format, false if it can't be done.
+    virtual bool start(int sampleRate, int numChannels, const PullCallback& pull) = 0;
+
+    /// Closes the device, once this returns the callback won't be called anymore.
+    virtual void stop() = 0;
+
+    /// The time from a sample being pulled to it being heard, as measured by the device.
+    virtual float getLatencyMsecs() const = 0;
+};
+
+#endif // hifi_AudioOutputBackend_h
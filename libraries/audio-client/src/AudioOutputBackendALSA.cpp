@@ -0,0 +1,136 @@
+//
+//  AudioOutputBackendALSA.cpp
+//  libraries/audio-client/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QtGlobal>
+
+#ifdef Q_OS_LINUX
+
+#include "AudioOutputBackend.h"
+
+#ifdef HAVE_ALSA
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <alsa/asoundlib.h>
+
+#include <NumericalConstants.h>
+
+#include "AudioClientLogging.h"
+
+namespace {
+
+// what's asked of the device for its whole buffer, it picks the periods from there
+const unsigned int TARGET_LATENCY_USECS = 10000;
+
+/// The default PCM, which is the PulseAudio server where there's one, written period by period from our own thread.
+class ALSAOutputBackend : public AudioOutputBackend {
+public:
+    ALSAOutputBackend() : _isRunning(false), _latencyMsecs(0.0f) {}
+    ~ALSAOutputBackend() { stop(); }
+
+    virtual const char* getName() const override { return "ALSA"; }
+    virtual bool start(int sampleRate, int numChannels, const PullCallback& pull) override;
+    virtual void stop() override;
+    virtual float getLatencyMsecs() const override { return _latencyMsecs; }
+
+private:
+    void run();
+
+    snd_pcm_t* _pcm { nullptr };
+    snd_pcm_uframes_t _periodFrames { 0 };
+    int _sampleRate { 0 };
+    int _numChannels { 0 };
+    PullCallback _pull;
+
+    std::thread _thread;
+    std::atomic<bool> _isRunning;
+    std::atomic<float> _latencyMsecs;
+};
+
+bool ALSAOutputBackend::start(int sampleRate, int numChannels, const PullCallback& pull) {
+    _sampleRate = sampleRate;
+    _numChannels = numChannels;
+    _pull = pull;
+
+    int error = snd_pcm_open(&_pcm, "default", SND_PCM_STREAM_PLAYBACK, 0);
+    if (error < 0) {
+        qCDebug(audioclient) << "Couldn't open the default ALSA output:" << snd_strerror(error);
+        _pcm = nullptr;
+        return false;
+    }
+    error = snd_pcm_set_params(_pcm, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED, numChannels, sampleRate,
+                               1, TARGET_LATENCY_USECS);
+    snd_pcm_uframes_t bufferFrames;
+    if (error < 0 || (error = snd_pcm_get_params(_pcm, &bufferFrames, &_periodFrames)) < 0) {
+        qCDebug(audioclient) << "Couldn't set the format of the default ALSA output:" << snd_strerror(error);
+        stop();
+        return false;
+    }
+
+    qCDebug(audioclient) << "Opened the default ALSA output with a buffer of" << bufferFrames << "frames in periods of"
+        << _periodFrames;
+
+    _isRunning = true;
+    _thread = std::thread(&ALSAOutputBackend::run, this);
+    return true;
+}
+
+void ALSAOutputBackend::run() {
+    std::vector<int16_t> period(_periodFrames * _numChannels);
+    while (_isRunning) {
+        _pull(period.data(), (int)period.size());
+
+        // each write blocks until the device has room for the period
+        snd_pcm_sframes_t framesWritten = snd_pcm_writei(_pcm, period.data(), _periodFrames);
+        if (framesWritten < 0) {
+            // an underrun, the device starts again from an empty buffer
+            if (snd_pcm_recover(_pcm, (int)framesWritten, 1) < 0) {
+                qCDebug(audioclient) << "The ALSA output stopped:" << snd_strerror((int)framesWritten);
+                break;
+            }
+        }
+
+        // the frames from the one just written to the one being played
+        snd_pcm_sframes_t delayFrames;
+        if (snd_pcm_delay(_pcm, &delayFrames) == 0) {
+            _latencyMsecs = (float)delayFrames * MSECS_PER_SECOND / _sampleRate;
+        }
+    }
+}
+
+void ALSAOutputBackend::stop() {
+    _isRunning = false;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    if (_pcm) {
+        snd_pcm_drop(_pcm);
+        snd_pcm_close(_pcm);
+        _pcm = nullptr;
+    }
+}
+
+}
+
+AudioOutputBackend* AudioOutputBackend::create() {
+    return new ALSAOutputBackend();
+}
+
+#else
+
+AudioOutputBackend* AudioOutputBackend::create() {
+    return nullptr;
+}
+
+#endif
+
+#endif
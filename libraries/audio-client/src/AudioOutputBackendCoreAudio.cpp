@@ -0,0 +1,174 @@
+//
+//  AudioOutputBackendCoreAudio.cpp
+//  libraries/audio-client/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QtGlobal>
+
+#ifdef Q_OS_MAC
+
+#include <AudioUnit/AudioUnit.h>
+#include <CoreAudio/CoreAudio.h>
+
+#include <NumericalConstants.h>
+
+#include "AudioClientLogging.h"
+#include "AudioOutputBackend.h"
+
+namespace {
+
+// the frames of the IO cycle of the device, at its own rate
+const UInt32 PREFERRED_BUFFER_FRAMES = 256;
+
+UInt32 getDeviceProperty(AudioDeviceID device, AudioObjectPropertySelector selector, AudioObjectPropertyScope scope) {
+    AudioObjectPropertyAddress address = { selector, scope, kAudioObjectPropertyElementMaster };
+    UInt32 value = 0;
+    UInt32 size = sizeof(value);
+    if (AudioObjectGetPropertyData(device, &address, 0, NULL, &size, &value) != noErr) {
+        return 0;
+    }
+    return value;
+}
+
+/// The default output unit, which renders from our callback at each IO cycle of the device.
+class CoreAudioOutputBackend : public AudioOutputBackend {
+public:
+    ~CoreAudioOutputBackend() { stop(); }
+
+    virtual const char* getName() const override { return "CoreAudio"; }
+    virtual bool start(int sampleRate, int numChannels, const PullCallback& pull) override;
+    virtual void stop() override;
+    virtual float getLatencyMsecs() const override { return _latencyMsecs; }
+
+private:
+    static OSStatus render(void* backend, AudioUnitRenderActionFlags* flags, const AudioTimeStamp* timeStamp,
+                           UInt32 bus, UInt32 numFrames, AudioBufferList* data);
+
+    void measureLatency();
+
+    AudioUnit _unit { nullptr };
+    int _numChannels { 0 };
+    PullCallback _pull;
+    float _latencyMsecs { 0.0f };
+};
+
+bool CoreAudioOutputBackend::start(int sampleRate, int numChannels, const PullCallback& pull) {
+    _numChannels = numChannels;
+    _pull = pull;
+
+    AudioComponentDescription description = { kAudioUnitType_Output, kAudioUnitSubType_DefaultOutput,
+        kAudioUnitManufacturer_Apple, 0, 0 };
+    AudioComponent component = AudioComponentFindNext(NULL, &description);
+    if (!component || AudioComponentInstanceNew(component, &_unit) != noErr) {
+        _unit = nullptr;
+        return false;
+    }
+
+    AudioStreamBasicDescription format = {};
+    format.mSampleRate = sampleRate;
+    format.mFormatID = kAudioFormatLinearPCM;
+    format.mFormatFlags = kLinearPCMFormatFlagIsSignedInteger | kLinearPCMFormatFlagIsPacked;
+    format.mChannelsPerFrame = numChannels;
+    format.mBitsPerChannel = 16;
+    format.mBytesPerFrame = numChannels * sizeof(int16_t);
+    format.mFramesPerPacket = 1;
+    format.mBytesPerPacket = format.mBytesPerFrame;
+
+    AURenderCallbackStruct callback = { &CoreAudioOutputBackend::render, this };
+    if (AudioUnitSetProperty(_unit, kAudioUnitProperty_StreamFormat, kAudioUnitScope_Input, 0,
+                             &format, sizeof(format)) != noErr ||
+            AudioUnitSetProperty(_unit, kAudioUnitProperty_SetRenderCallback, kAudioUnitScope_Input, 0,
+                                 &callback, sizeof(callback)) != noErr) {
+        stop();
+        return false;
+    }
+
+    // the device runs IO cycles of 512 frames unless asked otherwise, this is most of the latency there is
+    AudioDeviceID device;
+    UInt32 size = sizeof(device);
+    if (AudioUnitGetProperty(_unit, kAudioOutputUnitProperty_CurrentDevice, kAudioUnitScope_Global, 0,
+                             &device, &size) == noErr) {
+        AudioObjectPropertyAddress address = { kAudioDevicePropertyBufferFrameSize, kAudioObjectPropertyScopeGlobal,
+            kAudioObjectPropertyElementMaster };
+        UInt32 bufferFrames = PREFERRED_BUFFER_FRAMES;
+        AudioObjectSetPropertyData(device, &address, 0, NULL, sizeof(bufferFrames), &bufferFrames);
+    }
+
+    if (AudioUnitInitialize(_unit) != noErr || AudioOutputUnitStart(_unit) != noErr) {
+        stop();
+        return false;
+    }
+    measureLatency();
+
+    qCDebug(audioclient) << "Opened the default output unit, with a latency of" << _latencyMsecs << "ms.";
+    return true;
+}
+
+void CoreAudioOutputBackend::measureLatency() {
+    AudioDeviceID device;
+    UInt32 size = sizeof(device);
+    if (AudioUnitGetProperty(_unit, kAudioOutputUnitProperty_CurrentDevice, kAudioUnitScope_Global, 0,
+                             &device, &size) != noErr) {
+        return;
+    }
+
+    // a sample waits for the IO cycle, then goes through the safety offset and the latency of the device and its stream
+    UInt32 latencyFrames = getDeviceProperty(device, kAudioDevicePropertyBufferFrameSize, kAudioObjectPropertyScopeGlobal) +
+        getDeviceProperty(device, kAudioDevicePropertySafetyOffset, kAudioDevicePropertyScopeOutput) +
+        getDeviceProperty(device, kAudioDevicePropertyLatency, kAudioDevicePropertyScopeOutput);
+
+    AudioStreamID stream;
+    AudioObjectPropertyAddress address = { kAudioDevicePropertyStreams, kAudioDevicePropertyScopeOutput,
+        kAudioObjectPropertyElementMaster };
+    size = sizeof(stream);
+    if (AudioObjectGetPropertyData(device, &address, 0, NULL, &size, &stream) == noErr && size == sizeof(stream)) {
+        latencyFrames += getDeviceProperty(stream, kAudioStreamPropertyLatency, kAudioObjectPropertyScopeGlobal);
+    }
+
+    Float64 deviceRate = 0.0;
+    address.mSelector = kAudioDevicePropertyNominalSampleRate;
+    address.mScope = kAudioObjectPropertyScopeGlobal;
+    size = sizeof(deviceRate);
+    if (AudioObjectGetPropertyData(device, &address, 0, NULL, &size, &deviceRate) != noErr || deviceRate <= 0.0) {
+        return;
+    }
+
+    // and the resampling of the unit, if the device isn't at our rate
+    Float64 unitLatencySecs = 0.0;
+    size = sizeof(unitLatencySecs);
+    AudioUnitGetProperty(_unit, kAudioUnitProperty_Latency, kAudioUnitScope_Global, 0, &unitLatencySecs, &size);
+
+    _latencyMsecs = (float)((latencyFrames / deviceRate + unitLatencySecs) * MSECS_PER_SECOND);
+}
+
+OSStatus CoreAudioOutputBackend::render(void* backend, AudioUnitRenderActionFlags* flags,
+                                        const AudioTimeStamp* timeStamp, UInt32 bus, UInt32 numFrames,
+                                        AudioBufferList* data) {
+    CoreAudioOutputBackend* self = static_cast<CoreAudioOutputBackend*>(backend);
+
+    // the format is interleaved, so there's the one buffer
+    self->_pull((int16_t*)data->mBuffers[0].mData, numFrames * self->_numChannels);
+    return noErr;
+}
+
+void CoreAudioOutputBackend::stop() {
+    if (_unit) {
+        AudioOutputUnitStop(_unit);
+        AudioUnitUninitialize(_unit);
+        AudioComponentInstanceDispose(_unit);
+        _unit = nullptr;
+    }
+}
+
+}
+
+AudioOutputBackend* AudioOutputBackend::create() {
+    return new CoreAudioOutputBackend();
+}
+
+#endif
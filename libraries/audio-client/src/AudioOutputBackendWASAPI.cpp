@@ -0,0 +1,234 @@
+//
+//  AudioOutputBackendWASAPI.cpp
+//  libraries/audio-client/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QtGlobal>
+
+#ifdef Q_OS_WIN
+
+#include <atomic>
+#include <thread>
+
+#include <windows.h>
+#include <audioclient.h>
+#include <avrt.h>
+#include <mmdeviceapi.h>
+
+#include <NumericalConstants.h>
+
+#include "AudioClientLogging.h"
+#include "AudioOutputBackend.h"
+
+namespace {
+
+const REFERENCE_TIME REFERENCE_TIMES_PER_SEC = 10000000;
+const DWORD EVENT_TIMEOUT_MSECS = 200;
+
+template <typename T> void safeRelease(T*& object) {
+    if (object) {
+        object->Release();
+        object = nullptr;
+    }
+}
+
+/// The default endpoint in exclusive mode, so nothing gets mixed in by the system, filled at each event of the device.
+class WASAPIOutputBackend : public AudioOutputBackend {
+public:
+    WASAPIOutputBackend() : _isRunning(false), _latencyMsecs(0.0f) {}
+    ~WASAPIOutputBackend() { stop(); }
+
+    virtual const char* getName() const override { return "WASAPI exclusive"; }
+    virtual bool start(int sampleRate, int numChannels, const PullCallback& pull) override;
+    virtual void stop() override;
+    virtual float getLatencyMsecs() const override { return _latencyMsecs; }
+
+private:
+    bool initializeClient(const WAVEFORMATEX& format);
+    void run();
+    void release();
+
+    bool _isCOMInitialized { false };
+    IMMDevice* _device { nullptr };
+    IAudioClient* _client { nullptr };
+    IAudioRenderClient* _renderClient { nullptr };
+    IAudioClock* _clock { nullptr };
+    HANDLE _event { NULL };
+    UINT32 _bufferFrames { 0 };
+    int _sampleRate { 0 };
+    int _numChannels { 0 };
+    PullCallback _pull;
+
+    std::thread _thread;
+    std::atomic<bool> _isRunning;
+    std::atomic<float> _latencyMsecs;
+};
+
+bool WASAPIOutputBackend::initializeClient(const WAVEFORMATEX& format) {
+    if (FAILED(_device->Activate(__uuidof(IAudioClient), CLSCTX_ALL, NULL, (void**)&_client))) {
+        return false;
+    }
+    if (_client->IsFormatSupported(AUDCLNT_SHAREMODE_EXCLUSIVE, &format, NULL) != S_OK) {
+        qCDebug(audioclient) << "The default output device doesn't take" << format.nSamplesPerSec << "Hz,"
+            << format.nChannels << "channels in exclusive mode.";
+        return false;
+    }
+
+    // ask for the smallest period the device can do, the buffer is then as big as one period
+    REFERENCE_TIME period;
+    _client->GetDevicePeriod(NULL, &period);
+    HRESULT result = _client->Initialize(AUDCLNT_SHAREMODE_EXCLUSIVE, AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
+                                         period, period, &format, NULL);
+    if (result == AUDCLNT_E_BUFFER_SIZE_NOT_ALIGNED) {
+        // the device wants a period of a whole number of its own blocks, we retry with the one it picked
+        UINT32 alignedFrames;
+        _client->GetBufferSize(&alignedFrames);
+        safeRelease(_client);
+        period = (REFERENCE_TIME)((double)REFERENCE_TIMES_PER_SEC * alignedFrames / format.nSamplesPerSec + 0.5);
+        if (FAILED(_device->Activate(__uuidof(IAudioClient), CLSCTX_ALL, NULL, (void**)&_client))) {
+            return false;
+        }
+        result = _client->Initialize(AUDCLNT_SHAREMODE_EXCLUSIVE, AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
+                                     period, period, &format, NULL);
+    }
+    if (FAILED(result)) {
+        qCDebug(audioclient) << "Couldn't open the default output device in exclusive mode, error" << hex << result;
+        return false;
+    }
+    return true;
+}
+
+bool WASAPIOutputBackend::start(int sampleRate, int numChannels, const PullCallback& pull) {
+    HRESULT result = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+    _isCOMInitialized = SUCCEEDED(result);
+
+    _sampleRate = sampleRate;
+    _numChannels = numChannels;
+    _pull = pull;
+
+    IMMDeviceEnumerator* enumerator = nullptr;
+    if (FAILED(CoCreateInstance(__uuidof(MMDeviceEnumerator), NULL, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator),
+                                (void**)&enumerator))) {
+        release();
+        return false;
+    }
+    result = enumerator->GetDefaultAudioEndpoint(eRender, eConsole, &_device);
+    safeRelease(enumerator);
+    if (FAILED(result)) {
+        release();
+        return false;
+    }
+
+    WAVEFORMATEX format = {};
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = numChannels;
+    format.nSamplesPerSec = sampleRate;
+    format.wBitsPerSample = 16;
+    format.nBlockAlign = numChannels * sizeof(int16_t);
+    format.nAvgBytesPerSec = sampleRate * format.nBlockAlign;
+
+    if (!initializeClient(format)) {
+        release();
+        return false;
+    }
+
+    _event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!_event || FAILED(_client->SetEventHandle(_event)) || FAILED(_client->GetBufferSize(&_bufferFrames)) ||
+            FAILED(_client->GetService(__uuidof(IAudioRenderClient), (void**)&_renderClient)) ||
+            FAILED(_client->GetService(__uuidof(IAudioClock), (void**)&_clock))) {
+        release();
+        return false;
+    }
+
+    // the device plays the first buffer as soon as it starts, it goes out silent
+    BYTE* data;
+    if (SUCCEEDED(_renderClient->GetBuffer(_bufferFrames, &data))) {
+        _renderClient->ReleaseBuffer(_bufferFrames, AUDCLNT_BUFFERFLAGS_SILENT);
+    }
+
+    qCDebug(audioclient) << "Opened the default output device in exclusive mode with a buffer of" << _bufferFrames
+        << "frames.";
+
+    _isRunning = true;
+    _thread = std::thread(&WASAPIOutputBackend::run, this);
+    if (FAILED(_client->Start())) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void WASAPIOutputBackend::run() {
+    CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+    // the scheduler gives the thread of the device its own class, it isn't held up by the rest of the application
+    DWORD taskIndex = 0;
+    HANDLE task = AvSetMmThreadCharacteristicsW(L"Pro Audio", &taskIndex);
+
+    UINT64 framesWritten = _bufferFrames;
+    UINT64 clockFrequency = 0;
+    _clock->GetFrequency(&clockFrequency);
+
+    while (_isRunning) {
+        if (WaitForSingleObject(_event, EVENT_TIMEOUT_MSECS) != WAIT_OBJECT_0) {
+            continue;
+        }
+
+        BYTE* data;
+        if (FAILED(_renderClient->GetBuffer(_bufferFrames, &data))) {
+            continue;
+        }
+        _pull((int16_t*)data, _bufferFrames * _numChannels);
+        _renderClient->ReleaseBuffer(_bufferFrames, 0);
+        framesWritten += _bufferFrames;
+
+        // what was written but not played yet, from the position the clock of the device is at
+        UINT64 position;
+        if (clockFrequency > 0 && SUCCEEDED(_clock->GetPosition(&position, NULL))) {
+            double framesPlayed = (double)position * _sampleRate / clockFrequency;
+            _latencyMsecs = (float)(((double)framesWritten - framesPlayed) * MSECS_PER_SECOND / _sampleRate);
+        }
+    }
+
+    if (task) {
+        AvRevertMmThreadCharacteristics(task);
+    }
+    CoUninitialize();
+}
+
+void WASAPIOutputBackend::stop() {
+    if (_isRunning) {
+        _isRunning = false;
+        _thread.join();
+        _client->Stop();
+    }
+    release();
+}
+
+void WASAPIOutputBackend::release() {
+    safeRelease(_clock);
+    safeRelease(_renderClient);
+    safeRelease(_client);
+    safeRelease(_device);
+    if (_event) {
+        CloseHandle(_event);
+        _event = NULL;
+    }
+    if (_isCOMInitialized) {
+        CoUninitialize();
+        _isCOMInitialized = false;
+    }
+}
+
+}
+
+AudioOutputBackend* AudioOutputBackend::create() {
+    return new WASAPIOutputBackend();
+}
+
+#endif
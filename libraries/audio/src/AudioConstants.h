@@ -20,6 +20,9 @@ namespace AudioConstants {
     const int SAMPLE_RATE = 24000;
     
     typedef int16_t AudioSample;
+
+    const int MONO = 1;
+    const int STEREO = 2;
     
     const int NETWORK_FRAME_BYTES_STEREO = 1024;
     const int NETWORK_FRAME_SAMPLES_STEREO = NETWORK_FRAME_BYTES_STEREO / sizeof(AudioSample);
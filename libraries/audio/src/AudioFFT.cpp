@@ -0,0 +1,127 @@
+//
+//  AudioFFT.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioFFT.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+AudioFFT::AudioFFT(int size) :
+    _size(size)
+{
+    assert(size >= 4 && (size & (size - 1)) == 0);
+
+    const double TWO_PI = 6.283185307179586;
+    int halfSize = size / 2;
+
+    int numBits = 0;
+    while ((1 << numBits) < halfSize) {
+        numBits++;
+    }
+    _bitReversedIndices.resize(halfSize);
+    for (int i = 0; i < halfSize; i++) {
+        int reversed = 0;
+        for (int bit = 0; bit < numBits; bit++) {
+            reversed |= ((i >> bit) & 1) << (numBits - 1 - bit);
+        }
+        _bitReversedIndices[i] = reversed;
+    }
+
+    _twiddles.resize(halfSize / 2);
+    for (int k = 0; k < halfSize / 2; k++) {
+        double angle = -TWO_PI * k / halfSize;
+        _twiddles[k] = Complex((float)cos(angle), (float)sin(angle));
+    }
+
+    _realTwiddles.resize(halfSize);
+    for (int k = 0; k < halfSize; k++) {
+        double angle = -TWO_PI * k / size;
+        _realTwiddles[k] = Complex((float)cos(angle), (float)sin(angle));
+    }
+}
+
+void AudioFFT::transform(Complex* data, bool isInverse) const {
+    int halfSize = _size / 2;
+
+    for (int i = 0; i < halfSize; i++) {
+        int j = _bitReversedIndices[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    for (int length = 2; length <= halfSize; length <<= 1) {
+        int halfLength = length / 2;
+        int twiddleStep = halfSize / length;
+
+        for (int start = 0; start < halfSize; start += length) {
+            for (int k = 0; k < halfLength; k++) {
+                Complex twiddle = _twiddles[k * twiddleStep];
+                if (isInverse) {
+                    twiddle = std::conj(twiddle);
+                }
+                Complex odd = data[start + k + halfLength] * twiddle;
+                data[start + k + halfLength] = data[start + k] - odd;
+                data[start + k] += odd;
+            }
+        }
+    }
+}
+
+void AudioFFT::forward(const float* input, Complex* bins) const {
+    int halfSize = _size / 2;
+
+    // the even samples are the real parts and the odd ones the imaginary parts of a signal of half the size
+    memcpy(reinterpret_cast<float*>(bins), input, _size * sizeof(float));
+    transform(bins, false);
+
+    // then the spectra of the even and odd samples are taken apart, and joined into the spectrum of the whole
+    Complex first = bins[0];
+    bins[0] = Complex(first.real() + first.imag(), 0.0f);
+    bins[halfSize] = Complex(first.real() - first.imag(), 0.0f);
+
+    for (int k = 1; k <= halfSize / 2; k++) {
+        Complex z = bins[k];
+        Complex mirror = std::conj(bins[halfSize - k]);
+
+        Complex even = 0.5f * (z + mirror);
+        Complex odd = Complex(0.0f, -0.5f) * (z - mirror);
+        bins[k] = even + _realTwiddles[k] * odd;
+
+        // the mirrored bin, from the same pair
+        Complex mirrorEven = std::conj(even);
+        Complex mirrorOdd = std::conj(odd);
+        bins[halfSize - k] = mirrorEven + _realTwiddles[halfSize - k] * mirrorOdd;
+    }
+}
+
+void AudioFFT::inverse(const Complex* bins, float* output) const {
+    int halfSize = _size / 2;
+
+    // the output is the half size complex signal until the end, its real and imaginary parts are the samples
+    Complex* data = reinterpret_cast<Complex*>(output);
+
+    for (int k = 0; k < halfSize; k++) {
+        Complex bin = bins[k];
+        Complex mirror = std::conj(bins[halfSize - k]);
+
+        Complex even = 0.5f * (bin + mirror);
+        Complex odd = 0.5f * (bin - mirror) * std::conj(_realTwiddles[k]);
+        data[k] = even + Complex(0.0f, 1.0f) * odd;
+    }
+
+    transform(data, true);
+
+    float scale = 1.0f / halfSize;
+    for (int i = 0; i < _size; i++) {
+        output[i] *= scale;
+    }
+}
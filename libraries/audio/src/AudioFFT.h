@@ -0,0 +1,44 @@
+//
+//  AudioFFT.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioFFT_h
+#define hifi_AudioFFT_h
+
+#include <complex>
+#include <vector>
+
+/// Radix-2 FFT of real signals, for sizes that are a power of two. A real signal of the size is transformed as a
+/// complex signal of half the size. The tables are built once and never written again, so one instance can be shared
+/// by every thread.
+class AudioFFT {
+public:
+    typedef std::complex<float> Complex;
+
+    AudioFFT(int size);
+
+    int getSize() const { return _size; }
+    int getNumBins() const { return _size / 2 + 1; }
+
+    /// the bins from DC to Nyquist of the real input, which has getSize() samples
+    void forward(const float* input, Complex* bins) const;
+
+    /// the real signal of the bins, the exact inverse of forward() - the bins are left untouched
+    void inverse(const Complex* bins, float* output) const;
+
+private:
+    void transform(Complex* data, bool isInverse) const;
+
+    int _size;
+    std::vector<int> _bitReversedIndices;   // of the half size complex transform
+    std::vector<Complex> _twiddles;         // e^(-2 pi i k / (size / 2)), for k < size / 4
+    std::vector<Complex> _realTwiddles;     // e^(-2 pi i k / size), for k < size / 2
+};
+
+#endif // hifi_AudioFFT_h
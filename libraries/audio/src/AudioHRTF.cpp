@@ -0,0 +1,309 @@
+//
+//  AudioHRTF.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioHRTF.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+using namespace AudioHRTFConstants;
+
+namespace {
+    const float PI = 3.14159265358979f;
+    const float TWO_PI = 2.0f * PI;
+    const float DEGREES_TO_RADIANS = PI / 180.0f;
+
+    const float SAMPLE_RATE = (float)AudioConstants::SAMPLE_RATE;
+
+    // the spherical head
+    const float HEAD_RADIUS = 0.0875f; // meters
+    const float SPEED_OF_SOUND = 343.0f; // meters per second
+    const float HEAD_FREQUENCY = SPEED_OF_SOUND / HEAD_RADIUS; // radians per second
+    const float HEAD_SHADOW_MIN_ALPHA = 0.1f;
+    const float HEAD_SHADOW_MIN_ANGLE = 150.0f * DEGREES_TO_RADIANS;
+
+    // sounds from behind lose their highs above this, down to this gain straight behind
+    const float REAR_SHELF_FREQUENCY = TWO_PI * 2000.0f;
+    const float REAR_SHELF_GAIN = 0.708f; // -3 dB
+
+    // the notch of the pinna rises with the elevation of the source, and is deepest for sources below
+    const float PINNA_NOTCH_LOW_FREQUENCY = TWO_PI * 5500.0f;
+    const float PINNA_NOTCH_HIGH_FREQUENCY = TWO_PI * 10000.0f;
+    const float PINNA_NOTCH_LOW_DEPTH = 0.3f;
+    const float PINNA_NOTCH_HIGH_DEPTH = 0.8f;
+    const float PINNA_NOTCH_Q = 2.0f;
+
+    // the grid of directions
+    const float AZIMUTH_STEP = 15.0f * DEGREES_TO_RADIANS;
+    const int NUM_AZIMUTHS = 24;
+    const float ELEVATION_STEP = 15.0f * DEGREES_TO_RADIANS;
+    const float MIN_ELEVATION = -45.0f * DEGREES_TO_RADIANS;
+    const float MAX_ELEVATION = 90.0f * DEGREES_TO_RADIANS;
+    const int NUM_ELEVATIONS = 10;
+
+    const int IMPULSE_FADE_SAMPLES = 32;
+
+    const float EPSILON = 1.0e-6f;
+
+    // a filter is interpolated again once its source has moved this far around the listener, or this much nearer
+    const float COS_MAX_DIRECTION_CHANGE = 0.99939f; // 2 degrees
+    const float MAX_NEARNESS_CHANGE = 0.05f;
+
+    glm::vec3 directionOf(float azimuth, float elevation) {
+        return glm::vec3(cosf(elevation) * sinf(azimuth), sinf(elevation), -cosf(elevation) * cosf(azimuth));
+    }
+}
+
+AudioHRTFTable::AudioHRTFTable() :
+    _fft(FFT_SIZE),
+    _directions(NUM_AZIMUTHS * NUM_ELEVATIONS)
+{
+    for (int elevationIndex = 0; elevationIndex < NUM_ELEVATIONS; elevationIndex++) {
+        for (int azimuthIndex = 0; azimuthIndex < NUM_AZIMUTHS; azimuthIndex++) {
+            computeDirection(azimuthIndex * AZIMUTH_STEP, MIN_ELEVATION + elevationIndex * ELEVATION_STEP,
+                             _directions[elevationIndex * NUM_AZIMUTHS + azimuthIndex]);
+        }
+    }
+}
+
+void AudioHRTFTable::computeDirection(float azimuth, float elevation, Direction& direction) const {
+    glm::vec3 unitDirection = directionOf(azimuth, elevation);
+    computeEar(unitDirection, glm::vec3(-1.0f, 0.0f, 0.0f), direction.left, direction.leftDelay);
+    computeEar(unitDirection, glm::vec3(1.0f, 0.0f, 0.0f), direction.right, direction.rightDelay);
+}
+
+void AudioHRTFTable::computeEar(const glm::vec3& direction, const glm::vec3& earAxis,
+                                Complex* filter, float& delay) const {
+    float angle = acosf(glm::clamp(glm::dot(direction, earAxis), -1.0f, 1.0f));
+
+    // the delay around the head (Woodworth), from the center of the head, then made positive
+    float pathDelay = (angle < PI / 2.0f) ? -cosf(angle) : (angle - PI / 2.0f);
+    delay = (pathDelay + 1.0f) * (HEAD_RADIUS / SPEED_OF_SOUND) * SAMPLE_RATE + BASE_DELAY_SAMPLES;
+
+    float alpha = (1.0f + HEAD_SHADOW_MIN_ALPHA / 2.0f) +
+        (1.0f - HEAD_SHADOW_MIN_ALPHA / 2.0f) * cosf(angle / HEAD_SHADOW_MIN_ANGLE * PI);
+
+    float behind = glm::max(direction.z, 0.0f);
+    float rearGain = 1.0f + (REAR_SHELF_GAIN - 1.0f) * behind;
+
+    float elevation = asinf(glm::clamp(direction.y, -1.0f, 1.0f));
+    float height = glm::clamp((elevation - MIN_ELEVATION) / (MAX_ELEVATION - MIN_ELEVATION), 0.0f, 1.0f);
+    float notchFrequency = PINNA_NOTCH_LOW_FREQUENCY + (PINNA_NOTCH_HIGH_FREQUENCY - PINNA_NOTCH_LOW_FREQUENCY) * height;
+    float notchDepth = PINNA_NOTCH_LOW_DEPTH + (PINNA_NOTCH_HIGH_DEPTH - PINNA_NOTCH_LOW_DEPTH) * height;
+    float notchZeroQ = PINNA_NOTCH_Q / notchDepth;
+
+    // the minimum phase response of the model at every bin
+    Complex response[NUM_BINS];
+    for (int k = 0; k < NUM_BINS; k++) {
+        float frequency = TWO_PI * k * SAMPLE_RATE / FFT_SIZE;
+
+        Complex shadow = Complex(1.0f, alpha * frequency / (2.0f * HEAD_FREQUENCY)) /
+            Complex(1.0f, frequency / (2.0f * HEAD_FREQUENCY));
+        Complex shelf = Complex(1.0f, rearGain * frequency / REAR_SHELF_FREQUENCY) /
+            Complex(1.0f, frequency / REAR_SHELF_FREQUENCY);
+
+        float notchReal = notchFrequency * notchFrequency - frequency * frequency;
+        Complex notch = Complex(notchReal, frequency * notchFrequency / notchZeroQ) /
+            Complex(notchReal, frequency * notchFrequency / PINNA_NOTCH_Q);
+
+        response[k] = shadow * shelf * notch;
+    }
+    response[0] = Complex(response[0].real(), 0.0f);
+    response[NUM_BINS - 1] = Complex(response[NUM_BINS - 1].real(), 0.0f);
+
+    // cut to a short impulse, faded out so the cut does not ring, so the filter fits in a frame
+    float impulse[FFT_SIZE];
+    _fft.inverse(response, impulse);
+    for (int i = IMPULSE_SAMPLES - IMPULSE_FADE_SAMPLES; i < IMPULSE_SAMPLES; i++) {
+        float fade = (float)(i - (IMPULSE_SAMPLES - IMPULSE_FADE_SAMPLES) + 1) / IMPULSE_FADE_SAMPLES;
+        impulse[i] *= 0.5f + 0.5f * cosf(fade * PI);
+    }
+    memset(impulse + IMPULSE_SAMPLES, 0, (FFT_SIZE - IMPULSE_SAMPLES) * sizeof(float));
+    _fft.forward(impulse, filter);
+}
+
+const AudioHRTFTable::Direction& AudioHRTFTable::getDirection(int azimuthIndex, int elevationIndex) const {
+    return _directions[elevationIndex * NUM_AZIMUTHS + (azimuthIndex % NUM_AZIMUTHS)];
+}
+
+void AudioHRTFTable::transformInput(const int16_t* previousAndCurrentFrames, Complex* spectrum) const {
+    float input[FFT_SIZE];
+    for (int i = 0; i < FFT_SIZE; i++) {
+        input[i] = previousAndCurrentFrames[i];
+    }
+    _fft.forward(input, spectrum);
+}
+
+void AudioHRTFTable::interpolate(const glm::vec3& direction, Complex* leftFilter, Complex* rightFilter,
+                                 float& leftDelay, float& rightDelay) const {
+    float azimuth = atan2f(direction.x, -direction.z);
+    if (azimuth < 0.0f) {
+        azimuth += TWO_PI;
+    }
+    float elevation = asinf(glm::clamp(direction.y, -1.0f, 1.0f));
+
+    float azimuthPosition = azimuth / AZIMUTH_STEP;
+    int azimuthIndex = glm::min((int)azimuthPosition, NUM_AZIMUTHS - 1);
+    float azimuthFraction = azimuthPosition - azimuthIndex;
+
+    float elevationPosition = glm::clamp((elevation - MIN_ELEVATION) / ELEVATION_STEP, 0.0f, (float)(NUM_ELEVATIONS - 1));
+    int elevationIndex = glm::min((int)elevationPosition, NUM_ELEVATIONS - 2);
+    float elevationFraction = elevationPosition - elevationIndex;
+
+    const Direction* corners[4] = {
+        &getDirection(azimuthIndex, elevationIndex),
+        &getDirection(azimuthIndex + 1, elevationIndex),
+        &getDirection(azimuthIndex, elevationIndex + 1),
+        &getDirection(azimuthIndex + 1, elevationIndex + 1)
+    };
+    float weights[4] = {
+        (1.0f - azimuthFraction) * (1.0f - elevationFraction),
+        azimuthFraction * (1.0f - elevationFraction),
+        (1.0f - azimuthFraction) * elevationFraction,
+        azimuthFraction * elevationFraction
+    };
+
+    leftDelay = 0.0f;
+    rightDelay = 0.0f;
+    for (int k = 0; k < NUM_BINS; k++) {
+        leftFilter[k] = Complex(0.0f, 0.0f);
+        rightFilter[k] = Complex(0.0f, 0.0f);
+    }
+    for (int i = 0; i < 4; i++) {
+        float weight = weights[i];
+        if (weight == 0.0f) {
+            continue;
+        }
+        for (int k = 0; k < NUM_BINS; k++) {
+            leftFilter[k] += weight * corners[i]->left[k];
+            rightFilter[k] += weight * corners[i]->right[k];
+        }
+        leftDelay += weight * corners[i]->leftDelay;
+        rightDelay += weight * corners[i]->rightDelay;
+    }
+}
+
+void AudioHRTFMix::begin() {
+    memset(_steady, 0, sizeof(_steady));
+    memset(_change, 0, sizeof(_change));
+    _hasSources = false;
+    _hasChanges = false;
+}
+
+void AudioHRTFMix::computeFilters(const AudioHRTFTable& table, const glm::vec3& direction, float nearness) {
+    float delays[2];
+    table.interpolate(direction, _newFilters[0], _newFilters[1], delays[0], delays[1]);
+
+    for (int ear = 0; ear < 2; ear++) {
+        // inside the head the filter fades to none, at the delay every ear has
+        float delay = nearness * delays[ear] + (1.0f - nearness) * BASE_DELAY_SAMPLES;
+
+        // the fractional delay is a short windowed sinc, which rings no further than the delay every ear has
+        float kernel[FFT_SIZE];
+        memset(kernel, 0, sizeof(kernel));
+        int first = (int)ceilf(delay - BASE_DELAY_SAMPLES);
+        int last = (int)floorf(delay + BASE_DELAY_SAMPLES);
+        float kernelSum = 0.0f;
+        for (int i = first; i <= last; i++) {
+            float offset = i - delay;
+            float sinc = (fabsf(offset) < EPSILON) ? 1.0f : sinf(PI * offset) / (PI * offset);
+            kernel[i] = sinc * (0.5f + 0.5f * cosf(PI * offset / BASE_DELAY_SAMPLES));
+            kernelSum += kernel[i];
+        }
+        for (int i = first; i <= last; i++) {
+            kernel[i] /= kernelSum;
+        }
+        Complex delayBins[NUM_BINS];
+        table.getFFT().forward(kernel, delayBins);
+
+        Complex* filter = _newFilters[ear];
+        for (int k = 0; k < NUM_BINS; k++) {
+            filter[k] = (nearness * filter[k] + Complex(1.0f - nearness, 0.0f)) * delayBins[k];
+        }
+    }
+}
+
+void AudioHRTFMix::addSource(const AudioHRTFTable& table, const Complex* input, AudioHRTFFilter& filter,
+                             const glm::vec3& direction, float nearness, float gain) {
+    _hasSources = true;
+
+    bool isMoved = !filter._hasFilters || glm::dot(direction, filter._direction) < COS_MAX_DIRECTION_CHANGE ||
+        fabsf(nearness - filter._nearness) > MAX_NEARNESS_CHANGE;
+    if (isMoved) {
+        computeFilters(table, direction, nearness);
+    }
+
+    if (!filter._hasFilters) {
+        // nothing to crossfade from
+        for (int ear = 0; ear < 2; ear++) {
+            for (int k = 0; k < NUM_BINS; k++) {
+                _steady[ear][k] += gain * (input[k] * _newFilters[ear][k]);
+            }
+        }
+    } else if (isMoved) {
+        float oldGain = filter._gain;
+        for (int ear = 0; ear < 2; ear++) {
+            for (int k = 0; k < NUM_BINS; k++) {
+                Complex oldOutput = oldGain * (input[k] * filter._filters[ear][k]);
+                _steady[ear][k] += oldOutput;
+                _change[ear][k] += gain * (input[k] * _newFilters[ear][k]) - oldOutput;
+            }
+        }
+        _hasChanges = true;
+    } else {
+        float oldGain = filter._gain;
+        float gainChange = gain - oldGain;
+        for (int ear = 0; ear < 2; ear++) {
+            for (int k = 0; k < NUM_BINS; k++) {
+                Complex output = input[k] * filter._filters[ear][k];
+                _steady[ear][k] += oldGain * output;
+                if (gainChange != 0.0f) {
+                    _change[ear][k] += gainChange * output;
+                }
+            }
+        }
+        _hasChanges |= (gainChange != 0.0f);
+    }
+
+    if (isMoved) {
+        memcpy(filter._filters, _newFilters, sizeof(_newFilters));
+        filter._direction = direction;
+        filter._nearness = nearness;
+        filter._hasFilters = true;
+    }
+    filter._gain = gain;
+}
+
+void AudioHRTFMix::render(const AudioHRTFTable& table, int32_t* stereoMix) {
+    if (!_hasSources) {
+        return;
+    }
+    const AudioFFT& fft = table.getFFT();
+
+    for (int ear = 0; ear < 2; ear++) {
+        // overlap-save: only the second half of the output is the convolution of the current frame
+        fft.inverse(_steady[ear], _output[0]);
+        const float* steady = _output[0] + FRAME_SAMPLES;
+
+        if (_hasChanges) {
+            fft.inverse(_change[ear], _output[1]);
+            const float* change = _output[1] + FRAME_SAMPLES;
+            for (int i = 0; i < FRAME_SAMPLES; i++) {
+                float fade = (float)(i + 1) / FRAME_SAMPLES;
+                stereoMix[2 * i + ear] += (int32_t)(steady[i] + fade * change[i]);
+            }
+        } else {
+            for (int i = 0; i < FRAME_SAMPLES; i++) {
+                stereoMix[2 * i + ear] += (int32_t)steady[i];
+            }
+        }
+    }
+}
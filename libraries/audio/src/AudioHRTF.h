@@ -0,0 +1,118 @@
+//
+//  AudioHRTF.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioHRTF_h
+#define hifi_AudioHRTF_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "AudioConstants.h"
+#include "AudioFFT.h"
+
+namespace AudioHRTFConstants {
+    // a source is convolved a whole network frame at a time, by overlap-save of its last two frames
+    const int FRAME_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    const int FFT_SIZE = 2 * FRAME_SAMPLES;
+    const int NUM_BINS = FRAME_SAMPLES + 1;
+
+    // the filters are cut to this many samples, with the delays of the ears on top they still fit in a frame
+    const int IMPULSE_SAMPLES = 128;
+
+    // the delay every ear has at least, so the tails of the fractional delays stay on the right side of zero
+    const float BASE_DELAY_SAMPLES = 8.0f;
+}
+
+/// The head related transfer functions of both ears, on a grid of directions around the listener. They come from a
+/// spherical head model: the shadow of the head, the delay around it, a notch of the pinna that moves with elevation
+/// and a duller sound from behind. Any direction is interpolated from the four directions of the grid around it.
+/// The table is built once and never written again, every mix worker reads it.
+class AudioHRTFTable {
+public:
+    typedef AudioFFT::Complex Complex;
+
+    AudioHRTFTable();
+
+    const AudioFFT& getFFT() const { return _fft; }
+
+    /// the spectrum of a mono input for its last frame, which starts at frame[FRAME_SAMPLES]
+    void transformInput(const int16_t* previousAndCurrentFrames, Complex* spectrum) const;
+
+    /// the filters of both ears for a direction in the listener's frame (-z ahead, +x right, +y up), with their delays
+    void interpolate(const glm::vec3& direction, Complex* leftFilter, Complex* rightFilter,
+                     float& leftDelay, float& rightDelay) const;
+
+private:
+    struct Direction {
+        Complex left[AudioHRTFConstants::NUM_BINS];
+        Complex right[AudioHRTFConstants::NUM_BINS];
+        float leftDelay;
+        float rightDelay;
+    };
+
+    void computeDirection(float azimuth, float elevation, Direction& direction) const;
+    void computeEar(const glm::vec3& direction, const glm::vec3& earAxis, Complex* filter, float& delay) const;
+
+    const Direction& getDirection(int azimuthIndex, int elevationIndex) const;
+
+    AudioFFT _fft;
+    std::vector<Direction> _directions; // by elevation, then azimuth
+};
+
+/// The filter one source was last heard through by one listener. It is kept from frame to frame so that it is only
+/// interpolated again once the source has moved around the listener, and so that a change is crossfaded over a frame.
+class AudioHRTFFilter {
+public:
+    AudioHRTFFilter() {}
+
+private:
+    friend class AudioHRTFMix;
+
+    AudioHRTFTable::Complex _filters[2][AudioHRTFConstants::NUM_BINS]; // delays included, without the gain
+    glm::vec3 _direction;
+    float _nearness { 0.0f };
+    float _gain { 0.0f };
+    bool _hasFilters { false };
+};
+
+/// The sources one listener hears through their HRTFs, summed in the frequency domain. However many sources there
+/// are, the mix takes an inverse FFT per ear, and another per ear for the sources whose filter changed this frame.
+class AudioHRTFMix {
+public:
+    typedef AudioHRTFTable::Complex Complex;
+
+    /// zeroes the sums for a new listener
+    void begin();
+
+    /// adds a source to the sums - its direction is normalized, in the listener's frame, and nearness blends its
+    /// filters towards none for sources inside the head
+    void addSource(const AudioHRTFTable& table, const Complex* input, AudioHRTFFilter& filter,
+                   const glm::vec3& direction, float nearness, float gain);
+
+    bool hasSources() const { return _hasSources; }
+
+    /// adds the sources to the interleaved stereo mix, the filters that changed are crossfaded over the frame
+    void render(const AudioHRTFTable& table, int32_t* stereoMix);
+
+private:
+    void computeFilters(const AudioHRTFTable& table, const glm::vec3& direction, float nearness);
+
+    // the sources through the filters they had at the start of the frame, and what their change adds by its end
+    Complex _steady[2][AudioHRTFConstants::NUM_BINS];
+    Complex _change[2][AudioHRTFConstants::NUM_BINS];
+    bool _hasSources { false };
+    bool _hasChanges { false };
+
+    Complex _newFilters[2][AudioHRTFConstants::NUM_BINS];
+    float _output[2][AudioHRTFConstants::FFT_SIZE];
+};
+
+#endif // hifi_AudioHRTF_h
@@ -18,6 +18,7 @@
 #include <UUID.h>
 
 #include "AbstractAudioInterface.h"
+#include "AudioInjectorManager.h"
 #include "AudioRingBuffer.h"
 #include "AudioLogging.h"
 #include "SoundCache.h"
@@ -32,12 +33,12 @@ AudioInjector::AudioInjector(QObject* parent) :
 }
 
 AudioInjector::AudioInjector(Sound* sound, const AudioInjectorOptions& injectorOptions) :
-    _audioData(sound->getByteArray()),
+    _audioData(sound->getAudioData()),
     _options(injectorOptions)
 {
 }
 
-AudioInjector::AudioInjector(const QByteArray& audioData, const AudioInjectorOptions& injectorOptions) :
+AudioInjector::AudioInjector(const SoundData& audioData, const AudioInjectorOptions& injectorOptions) :
     _audioData(audioData),
     _options(injectorOptions)
 {
@@ -110,9 +111,10 @@ void AudioInjector::restartPortionAfterFinished() {
 void AudioInjector::injectLocally() {
     bool success = false;
     if (_localAudioInterface) {
-        if (_audioData.size() > 0) {
+        if (_audioData.getNumBytes() > 0) {
 
-            _localBuffer = new AudioInjectorLocalBuffer(_audioData, this);
+            // the audio device pulls from anywhere in the buffer, a local sound is decoded whole
+            _localBuffer = new AudioInjectorLocalBuffer(_audioData.decodeAll(), this);
 
             _localBuffer->open(QIODevice::ReadOnly);
             _localBuffer->setShouldLoop(_options.loop);
@@ -145,137 +147,132 @@ const uchar MAX_INJECTOR_VOLUME = 0xFF;
 
 void AudioInjector::injectToMixer() {
     if (_currentSendOffset < 0 ||
-        _currentSendOffset >= _audioData.size()) {
+        _currentSendOffset >= _audioData.getNumBytes()) {
         _currentSendOffset = 0;
     }
 
-    auto nodeList = DependencyManager::get<NodeList>();
-
     // make sure we actually have samples downloaded to inject
-    if (_audioData.size()) {
-
-        auto audioPacket = NLPacket::create(PacketType::InjectAudio);
+    if (!_audioData.getNumBytes()) {
+        setIsFinished(true);
+        _isPlaying = !_isFinished; // Which can be false if a restart was requested
+        return;
+    }
 
-        // setup the packet for injected audio
-        QDataStream audioPacketStream(audioPacket.get());
+    _currentPacket = NLPacket::create(PacketType::InjectAudio);
 
-        // pack some placeholder sequence number for now
-        audioPacketStream << (quint16) 0;
+    // setup the packet for injected audio
+    QDataStream audioPacketStream(_currentPacket.get());
 
-        // pack stream identifier (a generated UUID)
-        audioPacketStream << QUuid::createUuid();
+    // pack some placeholder sequence number for now
+    audioPacketStream << (quint16) 0;
 
-        // pack the stereo/mono type of the stream
-        audioPacketStream << _options.stereo;
+    // pack stream identifier (a generated UUID)
+    audioPacketStream << QUuid::createUuid();
 
-        // pack the flag for loopback
-        uchar loopbackFlag = (uchar) true;
-        audioPacketStream << loopbackFlag;
+    // pack the stereo/mono type of the stream
+    audioPacketStream << _options.stereo;
 
-        // pack the position for injected audio
-        int positionOptionOffset = audioPacket->pos();
-        audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.position),
-                                  sizeof(_options.position));
+    // pack the flag for loopback
+    uchar loopbackFlag = (uchar) true;
+    audioPacketStream << loopbackFlag;
 
-        // pack our orientation for injected audio
-        audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.orientation),
-                                  sizeof(_options.orientation));
+    // pack the position for injected audio
+    _positionOptionOffset = _currentPacket->pos();
+    audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.position),
+                              sizeof(_options.position));
 
-        // pack zero for radius
-        float radius = 0;
-        audioPacketStream << radius;
+    // pack our orientation for injected audio
+    audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.orientation),
+                              sizeof(_options.orientation));
 
-        // pack 255 for attenuation byte
-        int volumeOptionOffset = audioPacket->pos();
-        quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
-        audioPacketStream << volume;
+    // pack zero for radius
+    float radius = 0;
+    audioPacketStream << radius;
 
-        audioPacketStream << _options.ignorePenumbra;
+    // pack 255 for attenuation byte
+    _volumeOptionOffset = _currentPacket->pos();
+    quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
+    audioPacketStream << volume;
 
-        int audioDataOffset = audioPacket->pos();
+    audioPacketStream << _options.ignorePenumbra;
 
-        QElapsedTimer timer;
-        timer.start();
-        int nextFrame = 0;
+    _audioDataOffset = _currentPacket->pos();
 
-        bool shouldLoop = _options.loop;
+    _outgoingSequenceNumber = 0;
+    _nextFrame = 0;
+    _frameTimer.start();
 
-        // loop to send off our audio in NETWORK_BUFFER_LENGTH_SAMPLES_PER_CHANNEL byte chunks
-        quint16 outgoingInjectedAudioSequenceNumber = 0;
+    // the frames go out from the frame clock of the injector thread, the first ones right away
+    auto audioMixer = DependencyManager::get<NodeList>()->soloNodeOfType(NodeType::AudioMixer);
+    if (injectNextFrames(audioMixer)) {
+        DependencyManager::get<AudioInjectorManager>()->scheduleInjector(this);
+    }
+}
 
-        while (_currentSendOffset < _audioData.size() && !_shouldStop) {
+bool AudioInjector::injectNextFrames(const SharedNodePointer& audioMixer) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    int frameUsecs = (_options.stereo ? 2 : 1) * AudioConstants::NETWORK_FRAME_USECS;
+    char frame[AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+
+    // two frames go before the first wait so the mixer can start playback right away
+    while (_currentSendOffset < _audioData.getNumBytes() && !_shouldStop &&
+           (_nextFrame <= 1 || _frameTimer.nsecsElapsed() / 1000 >= (qint64)(_nextFrame - 1) * frameUsecs)) {
+
+        int bytesToCopy = std::min((_options.stereo ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL,
+                                   _audioData.getNumBytes() - _currentSendOffset);
+        _audioData.read(_currentSendOffset, bytesToCopy, frame);
+
+        //  Measure the loudness of this frame
+        _loudness = 0.0f;
+        for (int i = 0; i < bytesToCopy; i += sizeof(int16_t)) {
+            _loudness += abs(*reinterpret_cast<int16_t*>(frame + i)) /
+            (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
+        }
+        _loudness /= (float)(bytesToCopy / sizeof(int16_t));
 
-            int bytesToCopy = std::min((_options.stereo ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL,
-                                       _audioData.size() - _currentSendOffset);
+        _currentPacket->seek(0);
 
-            //  Measure the loudness of this frame
-            _loudness = 0.0f;
-            for (int i = 0; i < bytesToCopy; i += sizeof(int16_t)) {
-                _loudness += abs(*reinterpret_cast<int16_t*>(_audioData.data() + _currentSendOffset + i)) /
-                (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
-            }
-            _loudness /= (float)(bytesToCopy / sizeof(int16_t));
-            
-            audioPacket->seek(0);
-            
-            // pack the sequence number
-            audioPacket->writePrimitive(outgoingInjectedAudioSequenceNumber);
-            
-            audioPacket->seek(positionOptionOffset);
-            audioPacket->writePrimitive(_options.position);
-            audioPacket->writePrimitive(_options.orientation);
-
-            volume = MAX_INJECTOR_VOLUME * _options.volume;
-            audioPacket->seek(volumeOptionOffset);
-            audioPacket->writePrimitive(volume);
-
-            audioPacket->seek(audioDataOffset);
-
-            // copy the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes to the packet
-            audioPacket->write(_audioData.data() + _currentSendOffset, bytesToCopy);
-
-            // set the correct size used for this packet
-            audioPacket->setPayloadSize(audioPacket->pos());
-
-            // grab our audio mixer from the NodeList, if it exists
-            SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
-            
-            if (audioMixer) {
-                // send off this audio packet
-                nodeList->sendUnreliablePacket(*audioPacket, *audioMixer);
-                outgoingInjectedAudioSequenceNumber++;
-            }
+        // pack the sequence number
+        _currentPacket->writePrimitive(_outgoingSequenceNumber);
 
-            _currentSendOffset += bytesToCopy;
+        _currentPacket->seek(_positionOptionOffset);
+        _currentPacket->writePrimitive(_options.position);
+        _currentPacket->writePrimitive(_options.orientation);
 
-            // send two packets before the first sleep so the mixer can start playback right away
+        quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
+        _currentPacket->seek(_volumeOptionOffset);
+        _currentPacket->writePrimitive(volume);
 
-            if (_currentSendOffset != bytesToCopy && _currentSendOffset < _audioData.size()) {
+        _currentPacket->seek(_audioDataOffset);
 
-                // process events in case we have been told to stop and be deleted
-                QCoreApplication::processEvents();
+        // copy the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes to the packet
+        _currentPacket->write(frame, bytesToCopy);
 
-                if (_shouldStop) {
-                    break;
-                }
+        // set the correct size used for this packet
+        _currentPacket->setPayloadSize(_currentPacket->pos());
 
-                // not the first packet and not done
-                // sleep for the appropriate time
-                int usecToSleep = (++nextFrame * (_options.stereo ? 2 : 1) * AudioConstants::NETWORK_FRAME_USECS) - timer.nsecsElapsed() / 1000;
+        if (audioMixer) {
+            // send off this audio packet
+            nodeList->sendUnreliablePacket(*_currentPacket, *audioMixer);
+            _outgoingSequenceNumber++;
+        }
 
-                if (usecToSleep > 0) {
-                    usleep(usecToSleep);
-                }
-            }
+        _currentSendOffset += bytesToCopy;
+        _nextFrame++;
 
-            if (shouldLoop && _currentSendOffset >= _audioData.size()) {
-                _currentSendOffset = 0;
-            }
+        if (_options.loop && _currentSendOffset >= _audioData.getNumBytes()) {
+            _currentSendOffset = 0;
         }
     }
 
+    if (_currentSendOffset < _audioData.getNumBytes() && !_shouldStop) {
+        return true;
+    }
+
+    _currentPacket.reset();
     setIsFinished(true);
     _isPlaying = !_isFinished; // Which can be false if a restart was requested
+    return false;
 }
 
 void AudioInjector::stop() {
@@ -311,11 +308,12 @@ AudioInjector* AudioInjector::playSound(const QString& soundUrl, const float vol
     options.position = position;
     options.volume = volume;
 
-    QByteArray samples = sound->getByteArray();
     if (stretchFactor == 1.0f) {
-        return playSoundAndDelete(samples, options, NULL);
+        return playSoundAndDelete(sound->getAudioData(), options, NULL);
     }
 
+    QByteArray samples = sound->getByteArray();
+
     const int standardRate = AudioConstants::SAMPLE_RATE;
     const int resampledRate = standardRate * stretchFactor;
     const int channelCount = sound->isStereo() ? 2 : 1;
@@ -334,30 +332,19 @@ AudioInjector* AudioInjector::playSound(const QString& soundUrl, const float vol
     return playSoundAndDelete(resampled, options, NULL);
 }
 
-AudioInjector* AudioInjector::playSoundAndDelete(const QByteArray& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface) {
+AudioInjector* AudioInjector::playSoundAndDelete(const SoundData& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface) {
     AudioInjector* sound = playSound(buffer, options, localInterface);
     sound->triggerDeleteAfterFinish();
     return sound;
 }
 
 
-AudioInjector* AudioInjector::playSound(const QByteArray& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface) {
-    QThread* injectorThread = new QThread();
-    injectorThread->setObjectName("Audio Injector Thread");
-
+AudioInjector* AudioInjector::playSound(const SoundData& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface) {
     AudioInjector* injector = new AudioInjector(buffer, options);
     injector->_isPlaying = true;
     injector->setLocalAudioInterface(localInterface);
 
-    injector->moveToThread(injectorThread);
-
-    // start injecting when the injector thread starts
-    connect(injectorThread, &QThread::started, injector, &AudioInjector::injectAudio);
-
-    // connect the right slots and signals for AudioInjector and thread cleanup
-    connect(injector, &AudioInjector::destroyed, injectorThread, &QThread::quit);
-    connect(injectorThread, &QThread::finished, injectorThread, &QThread::deleteLater);
-
-    injectorThread->start();
+    // all the injectors play from the same thread
+    DependencyManager::get<AudioInjectorManager>()->threadInjector(injector);
     return injector;
 }
@@ -12,6 +12,9 @@
 #ifndef hifi_AudioInjector_h
 #define hifi_AudioInjector_h
 
+#include <memory>
+
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QThread>
@@ -19,6 +22,9 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <NLPacket.h>
+#include <Node.h>
+
 #include "AudioInjectorLocalBuffer.h"
 #include "AudioInjectorOptions.h"
 #include "Sound.h"
@@ -34,7 +40,7 @@ class AudioInjector : public QObject {
 public:
     AudioInjector(QObject* parent);
     AudioInjector(Sound* sound, const AudioInjectorOptions& injectorOptions);
-    AudioInjector(const QByteArray& audioData, const AudioInjectorOptions& injectorOptions);
+    AudioInjector(const SoundData& audioData, const AudioInjectorOptions& injectorOptions);
     
     bool isFinished() const { return _isFinished; }
     
@@ -46,8 +52,11 @@ public:
     
     void setLocalAudioInterface(AbstractAudioInterface* localAudioInterface) { _localAudioInterface = localAudioInterface; }
 
-    static AudioInjector* playSoundAndDelete(const QByteArray& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface);
-    static AudioInjector* playSound(const QByteArray& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface);
+    // Sends the frames for the mixer that are due, returns false once the injector is finished
+    bool injectNextFrames(const SharedNodePointer& audioMixer);
+
+    static AudioInjector* playSoundAndDelete(const SoundData& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface);
+    static AudioInjector* playSound(const SoundData& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface);
     static AudioInjector* playSound(const QString& soundUrl, const float volume, const float stretchFactor, const glm::vec3 position);
 
 public slots:
@@ -74,7 +83,7 @@ private:
     
     void setIsFinished(bool isFinished);
     
-    QByteArray _audioData;
+    SoundData _audioData; // decoded a frame at a time as it's sent when compressed
     AudioInjectorOptions _options;
     bool _shouldStop = false;
     float _loudness = 0.0f;
@@ -85,6 +94,15 @@ private:
     int _currentSendOffset = 0;
     AbstractAudioInterface* _localAudioInterface = NULL;
     AudioInjectorLocalBuffer* _localBuffer = NULL;
+
+    // the packet reused for every frame sent to the mixer, and where it goes in it
+    std::unique_ptr<NLPacket> _currentPacket;
+    int _positionOptionOffset = 0;
+    int _volumeOptionOffset = 0;
+    int _audioDataOffset = 0;
+    quint16 _outgoingSequenceNumber = 0;
+    int _nextFrame = 0;
+    QElapsedTimer _frameTimer;
 };
 
 
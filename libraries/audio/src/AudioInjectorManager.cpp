@@ -0,0 +1,85 @@
+//
+//  AudioInjectorManager.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioInjectorManager.h"
+
+#include <NodeList.h>
+
+#include "AudioInjector.h"
+#include "AudioLogging.h"
+
+// the injectors have their own clock for when their frames are due, this only needs to come around often enough
+static const int FRAME_INTERVAL_MSECS = 10;
+static const size_t MAX_INJECTORS = 64;
+
+AudioInjectorManager::AudioInjectorManager() :
+    _frameTimer(new QTimer(this))
+{
+    _thread.setObjectName("Audio Injector Thread");
+
+    _frameTimer->setTimerType(Qt::PreciseTimer);
+    _frameTimer->setInterval(FRAME_INTERVAL_MSECS);
+    connect(_frameTimer, &QTimer::timeout, this, &AudioInjectorManager::sendFrames);
+
+    // the timer has to be stopped from its own thread, the thread emits finished from there before it exits
+    connect(&_thread, &QThread::finished, _frameTimer, &QTimer::stop, Qt::DirectConnection);
+
+    moveToThread(&_thread);
+    _thread.start();
+}
+
+AudioInjectorManager::~AudioInjectorManager() {
+    _thread.quit();
+    _thread.wait();
+}
+
+void AudioInjectorManager::threadInjector(AudioInjector* injector) {
+    injector->moveToThread(&_thread);
+    QMetaObject::invokeMethod(injector, "injectAudio", Qt::QueuedConnection);
+}
+
+void AudioInjectorManager::scheduleInjector(AudioInjector* injector) {
+    Q_ASSERT(QThread::currentThread() == &_thread);
+
+    if (_injectors.size() >= MAX_INJECTORS) {
+        // steal the place of the oldest one, it finishes right away
+        QPointer<AudioInjector> oldest = _injectors.front();
+        _injectors.pop_front();
+        if (oldest) {
+            qCDebug(audio) << "Too many audio injectors playing, stopping the oldest one.";
+            oldest->stop();
+            oldest->injectNextFrames(SharedNodePointer());
+        }
+    }
+    _injectors.push_back(injector);
+
+    if (!_frameTimer->isActive()) {
+        _frameTimer->start();
+    }
+}
+
+void AudioInjectorManager::sendFrames() {
+    // the mixer is looked up once for all the injectors
+    SharedNodePointer audioMixer = DependencyManager::get<NodeList>()->soloNodeOfType(NodeType::AudioMixer);
+
+    // the injectors that finish can restart, they are scheduled again from a queued call once this is done
+    for (auto it = _injectors.begin(); it != _injectors.end(); ) {
+        QPointer<AudioInjector> injector = *it;
+        if (injector && injector->injectNextFrames(audioMixer)) {
+            it++;
+        } else {
+            it = _injectors.erase(it);
+        }
+    }
+
+    if (_injectors.empty()) {
+        _frameTimer->stop();
+    }
+}
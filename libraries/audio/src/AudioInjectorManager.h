@@ -0,0 +1,51 @@
+//
+//  AudioInjectorManager.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioInjectorManager_h
+#define hifi_AudioInjectorManager_h
+
+#include <deque>
+
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <DependencyManager.h>
+
+class AudioInjector;
+
+// A single thread for all the injectors, instead of one each. Their frames for the mixer go out together on a frame
+// clock, and when too many of them are playing the oldest one is stopped to make room for the new one.
+class AudioInjectorManager : public QObject, public Dependency {
+    Q_OBJECT
+    SINGLETON_DEPENDENCY
+
+public:
+    ~AudioInjectorManager();
+
+    // Moves the injector to the injector thread and starts it there, call it from the thread the injector lives in
+    void threadInjector(AudioInjector* injector);
+
+    // Sends the frames of the injector for the mixer until it finishes, from the injector thread
+    void scheduleInjector(AudioInjector* injector);
+
+private slots:
+    void sendFrames();
+
+private:
+    AudioInjectorManager();
+
+    QThread _thread;
+    QTimer* _frameTimer;
+    std::deque<QPointer<AudioInjector>> _injectors; // the oldest first, only touched on the injector thread
+};
+
+#endif // hifi_AudioInjectorManager_h
@@ -0,0 +1,257 @@
+//
+//  AudioMixKernels.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioConstants.h"
+
+#include "AudioMixKernels.h"
+
+static inline int16_t saturateSample(int32_t sample) {
+    return (int16_t)(sample < AudioConstants::MIN_SAMPLE_VALUE ? AudioConstants::MIN_SAMPLE_VALUE :
+        (sample > AudioConstants::MAX_SAMPLE_VALUE ? AudioConstants::MAX_SAMPLE_VALUE : sample));
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// sign-extend 8 packed int16 samples into two vectors of 4 int32
+static inline void widenSamples(__m128i samples, __m128i& lo, __m128i& hi) {
+    lo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+    hi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+}
+
+void AudioMixKernels::accumulate(int32_t* accumulator, const int16_t* input, int numSamples) {
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i lo, hi;
+        widenSamples(_mm_loadu_si128((const __m128i*)&input[i]), lo, hi);
+
+        __m128i acc0 = _mm_loadu_si128((const __m128i*)&accumulator[i + 0]);
+        __m128i acc1 = _mm_loadu_si128((const __m128i*)&accumulator[i + 4]);
+
+        _mm_storeu_si128((__m128i*)&accumulator[i + 0], _mm_add_epi32(acc0, lo));
+        _mm_storeu_si128((__m128i*)&accumulator[i + 4], _mm_add_epi32(acc1, hi));
+    }
+
+    for (; i < numSamples; i++) {
+        accumulator[i] += input[i];
+    }
+}
+
+void AudioMixKernels::accumulateWithGain(int32_t* accumulator, const int16_t* input, float gain, int numSamples) {
+    __m128 g = _mm_set1_ps(gain);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i lo, hi;
+        widenSamples(_mm_loadu_si128((const __m128i*)&input[i]), lo, hi);
+
+        // truncate toward zero, to match the (int) conversion of the scalar path
+        lo = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(lo), g));
+        hi = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(hi), g));
+
+        __m128i acc0 = _mm_loadu_si128((const __m128i*)&accumulator[i + 0]);
+        __m128i acc1 = _mm_loadu_si128((const __m128i*)&accumulator[i + 4]);
+
+        _mm_storeu_si128((__m128i*)&accumulator[i + 0], _mm_add_epi32(acc0, lo));
+        _mm_storeu_si128((__m128i*)&accumulator[i + 4], _mm_add_epi32(acc1, hi));
+    }
+
+    for (; i < numSamples; i++) {
+        accumulator[i] += (int32_t)(input[i] * gain);
+    }
+}
+
+void AudioMixKernels::accumulateMonoToStereo(int32_t* accumulator, const int16_t* input, float leftGain, float rightGain,
+                                             int numInputSamples) {
+    __m128 gL = _mm_set1_ps(leftGain);
+    __m128 gR = _mm_set1_ps(rightGain);
+    int i = 0;
+
+    for (; i + 8 <= numInputSamples; i += 8) {
+        __m128i lo, hi;
+        widenSamples(_mm_loadu_si128((const __m128i*)&input[i]), lo, hi);
+
+        __m128 loSamples = _mm_cvtepi32_ps(lo);
+        __m128 hiSamples = _mm_cvtepi32_ps(hi);
+
+        __m128i loLeft = _mm_cvttps_epi32(_mm_mul_ps(loSamples, gL));
+        __m128i loRight = _mm_cvttps_epi32(_mm_mul_ps(loSamples, gR));
+        __m128i hiLeft = _mm_cvttps_epi32(_mm_mul_ps(hiSamples, gL));
+        __m128i hiRight = _mm_cvttps_epi32(_mm_mul_ps(hiSamples, gR));
+
+        // interleave back into left/right pairs
+        int32_t* out = &accumulator[2 * i];
+        __m128i acc0 = _mm_loadu_si128((const __m128i*)&out[0]);
+        __m128i acc1 = _mm_loadu_si128((const __m128i*)&out[4]);
+        __m128i acc2 = _mm_loadu_si128((const __m128i*)&out[8]);
+        __m128i acc3 = _mm_loadu_si128((const __m128i*)&out[12]);
+
+        _mm_storeu_si128((__m128i*)&out[0], _mm_add_epi32(acc0, _mm_unpacklo_epi32(loLeft, loRight)));
+        _mm_storeu_si128((__m128i*)&out[4], _mm_add_epi32(acc1, _mm_unpackhi_epi32(loLeft, loRight)));
+        _mm_storeu_si128((__m128i*)&out[8], _mm_add_epi32(acc2, _mm_unpacklo_epi32(hiLeft, hiRight)));
+        _mm_storeu_si128((__m128i*)&out[12], _mm_add_epi32(acc3, _mm_unpackhi_epi32(hiLeft, hiRight)));
+    }
+
+    for (; i < numInputSamples; i++) {
+        accumulator[2 * i] += (int32_t)(input[i] * leftGain);
+        accumulator[2 * i + 1] += (int32_t)(input[i] * rightGain);
+    }
+}
+
+void AudioMixKernels::applyGain(int16_t* samples, float gain, int numSamples) {
+    __m128 g = _mm_set1_ps(gain);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i lo, hi;
+        widenSamples(_mm_loadu_si128((const __m128i*)&samples[i]), lo, hi);
+
+        lo = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(lo), g));
+        hi = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(hi), g));
+
+        // packs saturates to int16
+        _mm_storeu_si128((__m128i*)&samples[i], _mm_packs_epi32(lo, hi));
+    }
+
+    for (; i < numSamples; i++) {
+        samples[i] = saturateSample((int32_t)(samples[i] * gain));
+    }
+}
+
+void AudioMixKernels::applyGain(float* samples, float gain, int numSamples) {
+    __m128 g = _mm_set1_ps(gain);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm_storeu_ps(&samples[i + 0], _mm_mul_ps(_mm_loadu_ps(&samples[i + 0]), g));
+        _mm_storeu_ps(&samples[i + 4], _mm_mul_ps(_mm_loadu_ps(&samples[i + 4]), g));
+    }
+
+    for (; i < numSamples; i++) {
+        samples[i] *= gain;
+    }
+}
+
+void AudioMixKernels::saturate(const int32_t* input, int16_t* output, int numSamples) {
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i lo = _mm_loadu_si128((const __m128i*)&input[i + 0]);
+        __m128i hi = _mm_loadu_si128((const __m128i*)&input[i + 4]);
+
+        _mm_storeu_si128((__m128i*)&output[i], _mm_packs_epi32(lo, hi));
+    }
+
+    for (; i < numSamples; i++) {
+        output[i] = saturateSample(input[i]);
+    }
+}
+
+#else
+
+//
+// on ARM architecture, armeabi-v7a does not guarantee NEON: its kernels are taken when the CPU supports them
+//
+#if defined(__arm__) || defined(__aarch64__)
+
+#include <CPUDetect.h>
+
+#include "neon/AudioMixKernels_neon.h"
+
+static const bool cpuHasNEON = cpuSupportsNEON();
+
+#endif
+
+void AudioMixKernels::accumulate(int32_t* accumulator, const int16_t* input, int numSamples) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        accumulate_NEON(accumulator, input, numSamples);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < numSamples; i++) {
+        accumulator[i] += input[i];
+    }
+}
+
+void AudioMixKernels::accumulateWithGain(int32_t* accumulator, const int16_t* input, float gain, int numSamples) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        accumulateWithGain_NEON(accumulator, input, gain, numSamples);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < numSamples; i++) {
+        accumulator[i] += (int32_t)(input[i] * gain);
+    }
+}
+
+void AudioMixKernels::accumulateMonoToStereo(int32_t* accumulator, const int16_t* input, float leftGain, float rightGain,
+                                             int numInputSamples) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        accumulateMonoToStereo_NEON(accumulator, input, leftGain, rightGain, numInputSamples);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < numInputSamples; i++) {
+        accumulator[2 * i] += (int32_t)(input[i] * leftGain);
+        accumulator[2 * i + 1] += (int32_t)(input[i] * rightGain);
+    }
+}
+
+void AudioMixKernels::applyGain(int16_t* samples, float gain, int numSamples) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        applyGain_NEON(samples, gain, numSamples);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = saturateSample((int32_t)(samples[i] * gain));
+    }
+}
+
+void AudioMixKernels::applyGain(float* samples, float gain, int numSamples) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        applyGain_NEON(samples, gain, numSamples);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] *= gain;
+    }
+}
+
+void AudioMixKernels::saturate(const int32_t* input, int16_t* output, int numSamples) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        saturate_NEON(input, output, numSamples);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < numSamples; i++) {
+        output[i] = saturateSample(input[i]);
+    }
+}
+
+#endif
@@ -0,0 +1,40 @@
+//
+//  AudioMixKernels.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernels_h
+#define hifi_AudioMixKernels_h
+
+#include <stdint.h>
+
+// Inner loops used when mixing many streams for a listener.
+// Accumulation happens in int32 so that saturation only needs to be applied once per mixed frame.
+namespace AudioMixKernels {
+
+    // accumulator[i] += input[i]
+    void accumulate(int32_t* accumulator, const int16_t* input, int numSamples);
+
+    // accumulator[i] += (int)(input[i] * gain)
+    void accumulateWithGain(int32_t* accumulator, const int16_t* input, float gain, int numSamples);
+
+    // accumulator[2i] += (int)(input[i] * leftGain), accumulator[2i + 1] += (int)(input[i] * rightGain)
+    void accumulateMonoToStereo(int32_t* accumulator, const int16_t* input, float leftGain, float rightGain,
+                                int numInputSamples);
+
+    // samples[i] = clamp((int)(samples[i] * gain), INT16_MIN, INT16_MAX)
+    void applyGain(int16_t* samples, float gain, int numSamples);
+
+    // samples[i] *= gain, for the float frames of the AudioGain and AudioPan filters
+    void applyGain(float* samples, float gain, int numSamples);
+
+    // output[i] = clamp(input[i], INT16_MIN, INT16_MAX)
+    void saturate(const int32_t* input, int16_t* output, int numSamples);
+}
+
+#endif // hifi_AudioMixKernels_h
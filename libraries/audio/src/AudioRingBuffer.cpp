@@ -19,6 +19,7 @@
 #include <udt/PacketHeaders.h>
 
 #include "AudioLogging.h"
+#include "AudioRingBufferPool.h"
 
 #include "AudioRingBuffer.h"
 
@@ -30,20 +31,16 @@ _numFrameSamples(numFrameSamples),
 _randomAccessMode(randomAccessMode),
 _overflowCount(0)
 {
-    if (numFrameSamples) {
-        _buffer = new int16_t[_bufferLength];
+    _buffer = AudioRingBufferPool::allocate(_bufferLength);
+    if (_buffer) {
         memset(_buffer, 0, _bufferLength * sizeof(int16_t));
-        _nextOutput = _buffer;
-        _endOfLastWrite = _buffer;
-    } else {
-        _buffer = NULL;
-        _nextOutput = NULL;
-        _endOfLastWrite = NULL;
     }
+    _nextOutput = _buffer;
+    _endOfLastWrite = _buffer;
 };
 
 AudioRingBuffer::~AudioRingBuffer() {
-    delete[] _buffer;
+    AudioRingBufferPool::release(_buffer, _bufferLength);
 }
 
 void AudioRingBuffer::reset() {
@@ -52,13 +49,12 @@ void AudioRingBuffer::reset() {
 }
 
 void AudioRingBuffer::resizeForFrameSize(int numFrameSamples) {
-    delete[] _buffer;
+    AudioRingBufferPool::release(_buffer, _bufferLength);
     _sampleCapacity = numFrameSamples * _frameCapacity;
     _bufferLength = numFrameSamples * (_frameCapacity + 1);
     _numFrameSamples = numFrameSamples;
-    _buffer = new int16_t[_bufferLength];
-    memset(_buffer, 0, _bufferLength * sizeof(int16_t));
-    if (_randomAccessMode) {
+    _buffer = AudioRingBufferPool::allocate(_bufferLength);
+    if (_buffer) {
         memset(_buffer, 0, _bufferLength * sizeof(int16_t));
     }
     reset();
@@ -82,17 +78,19 @@ int AudioRingBuffer::readData(char *data, int maxSize) {
     // differently. Namely, if anything has been written, we say we have as many samples as they ask for
     // otherwise we say we have nothing available
     if (_randomAccessMode) {
-        numReadSamples = _endOfLastWrite ? (maxSize / sizeof(int16_t)) : 0;
+        numReadSamples = _endOfLastWrite.load(std::memory_order_acquire) ? (maxSize / sizeof(int16_t)) : 0;
     }
 
-    if (_nextOutput + numReadSamples > _buffer + _bufferLength) {
+    int16_t* nextOutput = _nextOutput.load(std::memory_order_relaxed);
+
+    if (nextOutput + numReadSamples > _buffer + _bufferLength) {
         // we're going to need to do two reads to get this data, it wraps around the edge
 
         // read to the end of the buffer
-        int numSamplesToEnd = (_buffer + _bufferLength) - _nextOutput;
-        memcpy(data, _nextOutput, numSamplesToEnd * sizeof(int16_t));
+        int numSamplesToEnd = (_buffer + _bufferLength) - nextOutput;
+        memcpy(data, nextOutput, numSamplesToEnd * sizeof(int16_t));
         if (_randomAccessMode) {
-            memset(_nextOutput, 0, numSamplesToEnd * sizeof(int16_t)); // clear it
+            memset(nextOutput, 0, numSamplesToEnd * sizeof(int16_t)); // clear it
         }
 
         // read the rest from the beginning of the buffer
@@ -102,18 +100,37 @@ int AudioRingBuffer::readData(char *data, int maxSize) {
         }
     } else {
         // read the data
-        memcpy(data, _nextOutput, numReadSamples * sizeof(int16_t));
+        memcpy(data, nextOutput, numReadSamples * sizeof(int16_t));
         if (_randomAccessMode) {
-            memset(_nextOutput, 0, numReadSamples * sizeof(int16_t)); // clear it
+            memset(nextOutput, 0, numReadSamples * sizeof(int16_t)); // clear it
         }
     }
 
-    // push the position of _nextOutput by the number of samples read
-    _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, numReadSamples);
+    // push the position of _nextOutput by the number of samples read, the writer can have them once they're copied
+    _nextOutput.store(shiftedPositionAccomodatingWrap(nextOutput, numReadSamples), std::memory_order_release);
 
     return numReadSamples * sizeof(int16_t);
 }
 
+int AudioRingBuffer::makeRoomForWrite(int samplesToWrite) {
+    int samplesRoomFor = _sampleCapacity - samplesAvailable();
+    if (samplesToWrite > samplesRoomFor) {
+        _overflowCount++;
+        if (_isSingleProducerSingleConsumer) {
+            // the read position is the reader's, drop what doesn't fit instead
+            qCDebug(audio) << "Overflowed ring buffer! Dropping new data";
+            return samplesRoomFor;
+        }
+
+        // there's not enough room for this write.  erase old data to make room for this new data
+        int samplesToDelete = samplesToWrite - samplesRoomFor;
+        _nextOutput.store(shiftedPositionAccomodatingWrap(_nextOutput.load(std::memory_order_relaxed), samplesToDelete),
+                          std::memory_order_relaxed);
+        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
+    }
+    return samplesToWrite;
+}
+
 int AudioRingBuffer::writeSamples(const int16_t* source, int maxSamples) {
     return writeData((const char*)source, maxSamples * sizeof(int16_t)) / sizeof(int16_t);
 }
@@ -121,48 +138,45 @@ int AudioRingBuffer::writeSamples(const int16_t* source, int maxSamples) {
 int AudioRingBuffer::writeData(const char* data, int maxSize) {
     // make sure we have enough bytes left for this to be the right amount of audio
     // otherwise we should not copy that data, and leave the buffer pointers where they are
-    int samplesToCopy = std::min((int)(maxSize / sizeof(int16_t)), _sampleCapacity);
+    int samplesToCopy = makeRoomForWrite(std::min((int)(maxSize / sizeof(int16_t)), _sampleCapacity));
 
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
-    }
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
 
-    if (_endOfLastWrite + samplesToCopy <= _buffer + _bufferLength) {
-        memcpy(_endOfLastWrite, data, samplesToCopy * sizeof(int16_t));
+    if (endOfLastWrite + samplesToCopy <= _buffer + _bufferLength) {
+        memcpy(endOfLastWrite, data, samplesToCopy * sizeof(int16_t));
     } else {
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
-        memcpy(_endOfLastWrite, data, numSamplesToEnd * sizeof(int16_t));
+        int numSamplesToEnd = (_buffer + _bufferLength) - endOfLastWrite;
+        memcpy(endOfLastWrite, data, numSamplesToEnd * sizeof(int16_t));
         memcpy(_buffer, data + (numSamplesToEnd * sizeof(int16_t)), (samplesToCopy - numSamplesToEnd) * sizeof(int16_t));
     }
 
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, samplesToCopy);
+    // the reader can have the samples once they're all there
+    _endOfLastWrite.store(shiftedPositionAccomodatingWrap(endOfLastWrite, samplesToCopy), std::memory_order_release);
 
     return samplesToCopy * sizeof(int16_t);
 }
 
 int16_t& AudioRingBuffer::operator[](const int index) {
-    return *shiftedPositionAccomodatingWrap(_nextOutput, index);
+    return *shiftedPositionAccomodatingWrap(_nextOutput.load(std::memory_order_relaxed), index);
 }
 
 const int16_t& AudioRingBuffer::operator[] (const int index) const {
-    return *shiftedPositionAccomodatingWrap(_nextOutput, index);
+    return *shiftedPositionAccomodatingWrap(_nextOutput.load(std::memory_order_relaxed), index);
 }
 
 void AudioRingBuffer::shiftReadPosition(unsigned int numSamples) {
-    _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, numSamples);
+    _nextOutput.store(shiftedPositionAccomodatingWrap(_nextOutput.load(std::memory_order_relaxed), numSamples),
+                      std::memory_order_release);
 }
 
 int AudioRingBuffer::samplesAvailable() const {
-    if (!_endOfLastWrite) {
+    // acquire both, whichever side is asking sees what the other has published
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_acquire);
+    if (!endOfLastWrite) {
         return 0;
     }
 
-    int sampleDifference = _endOfLastWrite - _nextOutput;
+    int sampleDifference = endOfLastWrite - _nextOutput.load(std::memory_order_acquire);
     if (sampleDifference < 0) {
         sampleDifference += _bufferLength;
     }
@@ -180,14 +194,15 @@ int AudioRingBuffer::addSilentSamples(int silentSamples) {
 
     // memset zeroes into the buffer, accomodate a wrap around the end
     // push the _endOfLastWrite to the correct spot
-    if (_endOfLastWrite + silentSamples <= _buffer + _bufferLength) {
-        memset(_endOfLastWrite, 0, silentSamples * sizeof(int16_t));
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
+    if (endOfLastWrite + silentSamples <= _buffer + _bufferLength) {
+        memset(endOfLastWrite, 0, silentSamples * sizeof(int16_t));
     } else {
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
-        memset(_endOfLastWrite, 0, numSamplesToEnd * sizeof(int16_t));
+        int numSamplesToEnd = (_buffer + _bufferLength) - endOfLastWrite;
+        memset(endOfLastWrite, 0, numSamplesToEnd * sizeof(int16_t));
         memset(_buffer, 0, (silentSamples - numSamplesToEnd) * sizeof(int16_t));
     }
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, silentSamples);
+    _endOfLastWrite.store(shiftedPositionAccomodatingWrap(endOfLastWrite, silentSamples), std::memory_order_release);
 
     return silentSamples;
 }
@@ -228,47 +243,35 @@ float AudioRingBuffer::getFrameLoudness(ConstIterator frameStart) const {
 }
 
 float AudioRingBuffer::getNextOutputFrameLoudness() const {
-    return getFrameLoudness(_nextOutput);
+    return getFrameLoudness(_nextOutput.load(std::memory_order_relaxed));
 }
 
 int AudioRingBuffer::writeSamples(ConstIterator source, int maxSamples) {
-    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
-    }
+    int samplesToCopy = makeRoomForWrite(std::min(maxSamples, _sampleCapacity));
 
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
     int16_t* bufferLast = _buffer + _bufferLength - 1;
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = *source;
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        *endOfLastWrite = *source;
+        endOfLastWrite = (endOfLastWrite == bufferLast) ? _buffer : endOfLastWrite + 1;
         ++source;
     }
+    _endOfLastWrite.store(endOfLastWrite, std::memory_order_release);
 
     return samplesToCopy;
 }
 
 int AudioRingBuffer::writeSamplesWithFade(ConstIterator source, int maxSamples, float fade) {
-    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
-    }
+    int samplesToCopy = makeRoomForWrite(std::min(maxSamples, _sampleCapacity));
 
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
     int16_t* bufferLast = _buffer + _bufferLength - 1;
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = (int16_t)((float)(*source) * fade);
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        *endOfLastWrite = (int16_t)((float)(*source) * fade);
+        endOfLastWrite = (endOfLastWrite == bufferLast) ? _buffer : endOfLastWrite + 1;
         ++source;
     }
+    _endOfLastWrite.store(endOfLastWrite, std::memory_order_release);
 
     return samplesToCopy;
 }
@@ -14,6 +14,8 @@
 
 #include "AudioConstants.h"
 
+#include <atomic>
+
 #include <QtCore/QIODevice>
 
 #include <SharedUtil.h>
@@ -21,6 +23,10 @@
 
 const int DEFAULT_RING_BUFFER_FRAME_CAPACITY = 10;
 
+/// The samples of a stream between the one writing them and the one reading them. The read and the write positions
+/// are atomics, each moved by one side only and published with release/acquire, so there's no lock: one thread may
+/// write while another reads as long as the buffer is single-producer/single-consumer (see
+/// setSingleProducerSingleConsumer). reset(), clear() and resizeForFrameSize() need both sides to be idle.
 class AudioRingBuffer {
 public:
     AudioRingBuffer(int numFrameSamples, bool randomAccessMode = false, int numFramesCapacity = DEFAULT_RING_BUFFER_FRAME_CAPACITY);
@@ -56,6 +62,13 @@ public:
 
     int addSilentSamples(int samples);
 
+    /// A writer that overflows the buffer moves the read position over the oldest samples, unless the reader is on
+    /// another thread: then the samples that don't fit are dropped, and the reader drops what it wants to skip.
+    void setSingleProducerSingleConsumer(bool isSingleProducerSingleConsumer) {
+        _isSingleProducerSingleConsumer = isSingleProducerSingleConsumer;
+    }
+    bool isSingleProducerSingleConsumer() const { return _isSingleProducerSingleConsumer; }
+
 private:
     float getFrameLoudness(const int16_t* frameStart) const;
 
@@ -66,17 +79,28 @@ protected:
 
     int16_t* shiftedPositionAccomodatingWrap(int16_t* position, int numSamplesShift) const;
 
+    /// the samples the writer has room for, erasing the oldest ones to make more if it can, returns how many to write
+    int makeRoomForWrite(int samplesToWrite);
+
     int _frameCapacity;
     int _sampleCapacity;
     int _bufferLength;      // actual length of _buffer: will be one frame larger than _sampleCapacity
     int _numFrameSamples;
-    int16_t* _nextOutput;
-    int16_t* _endOfLastWrite;
     int16_t* _buffer;
     bool _randomAccessMode; /// will this ringbuffer be used for random access? if so, do some special processing
+    bool _isSingleProducerSingleConsumer { false };
 
     int _overflowCount; /// how many times has the ring buffer has overwritten old data
 
+    // moved by the reader and by the writer, on cache lines of their own so the two sides don't bounce a line between
+    // them at every sample they move
+    static const int CACHE_LINE_BYTES = 64;
+    char _readPositionPadding[CACHE_LINE_BYTES];
+    std::atomic<int16_t*> _nextOutput;
+    char _writePositionPadding[CACHE_LINE_BYTES];
+    std::atomic<int16_t*> _endOfLastWrite;
+    char _endPadding[CACHE_LINE_BYTES];
+
 public:
     class ConstIterator { //public std::iterator < std::forward_iterator_tag, int16_t > {
     public:
@@ -174,8 +198,12 @@ public:
         int16_t* _at;
     };
 
-    ConstIterator nextOutput() const { return ConstIterator(_buffer, _bufferLength, _nextOutput); }
-    ConstIterator lastFrameWritten() const { return ConstIterator(_buffer, _bufferLength, _endOfLastWrite) - _numFrameSamples; }
+    ConstIterator nextOutput() const {
+        return ConstIterator(_buffer, _bufferLength, _nextOutput.load(std::memory_order_relaxed));
+    }
+    ConstIterator lastFrameWritten() const {
+        return ConstIterator(_buffer, _bufferLength, _endOfLastWrite.load(std::memory_order_relaxed)) - _numFrameSamples;
+    }
 
     float getFrameLoudness(ConstIterator frameStart) const;
 
@@ -0,0 +1,79 @@
+//
+//  AudioRingBufferPool.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioRingBufferPool.h"
+
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+// the free buffers kept of one length, past this they are deleted, which only happens after a mass exodus of nodes
+static const int MAX_FREE_BUFFERS_PER_LENGTH = 512;
+
+namespace {
+    // buffers are allocated and released when streams are created and nodes are killed, a few times a second at most,
+    // so a single lock is enough
+    QMutex poolMutex;
+    QHash<int, std::vector<int16_t*>> freeBuffersByLength;
+    AudioRingBufferPool::Stats poolStats;
+}
+
+int16_t* AudioRingBufferPool::allocate(int numSamples) {
+    if (numSamples <= 0) {
+        return nullptr;
+    }
+
+    const qint64 numBytes = numSamples * (qint64)sizeof(int16_t);
+
+    QMutexLocker locker(&poolMutex);
+    auto it = freeBuffersByLength.find(numSamples);
+    if (it != freeBuffersByLength.end() && !it.value().empty()) {
+        int16_t* buffer = it.value().back();
+        it.value().pop_back();
+
+        ++poolStats.hits;
+        --poolStats.numFreeBuffers;
+        poolStats.bytesFree -= numBytes;
+        poolStats.bytesInUse += numBytes;
+        return buffer;
+    }
+
+    ++poolStats.misses;
+    ++poolStats.numBuffers;
+    poolStats.bytesInUse += numBytes;
+    return new int16_t[numSamples];
+}
+
+void AudioRingBufferPool::release(int16_t* buffer, int numSamples) {
+    if (!buffer) {
+        return;
+    }
+
+    const qint64 numBytes = numSamples * (qint64)sizeof(int16_t);
+
+    QMutexLocker locker(&poolMutex);
+    poolStats.bytesInUse -= numBytes;
+
+    std::vector<int16_t*>& freeBuffers = freeBuffersByLength[numSamples];
+    if ((int)freeBuffers.size() < MAX_FREE_BUFFERS_PER_LENGTH) {
+        freeBuffers.push_back(buffer);
+        ++poolStats.numFreeBuffers;
+        poolStats.bytesFree += numBytes;
+    } else {
+        --poolStats.numBuffers;
+        delete[] buffer;
+    }
+}
+
+AudioRingBufferPool::Stats AudioRingBufferPool::getStats() {
+    QMutexLocker locker(&poolMutex);
+    return poolStats;
+}
@@ -0,0 +1,41 @@
+//
+//  AudioRingBufferPool.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioRingBufferPool_h
+#define hifi_AudioRingBufferPool_h
+
+#include <stdint.h>
+
+#include <QtCore/QtGlobal>
+
+/// The sample storage of the ring buffers, kept in a free list per buffer length. The streams of a mixer come and go
+/// with its nodes but are a handful of lengths, so a killed node's buffers go to the next node instead of leaving holes
+/// in the heap between the allocations that outlived it.
+class AudioRingBufferPool {
+public:
+    struct Stats {
+        int numBuffers { 0 }; // buffers that currently exist, in use or free
+        int numFreeBuffers { 0 };
+        qint64 bytesInUse { 0 };
+        qint64 bytesFree { 0 };
+        quint64 hits { 0 }; // allocations served from a free list
+        quint64 misses { 0 }; // allocations that had to create a buffer
+    };
+
+    /// \return uninitialized storage for numSamples samples, or null if there are none
+    static int16_t* allocate(int numSamples);
+
+    /// gives back a buffer allocate returned for the same number of samples
+    static void release(int16_t* buffer, int numSamples);
+
+    static Stats getStats();
+};
+
+#endif // hifi_AudioRingBufferPool_h
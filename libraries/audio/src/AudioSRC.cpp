@@ -741,6 +741,97 @@ int AudioSRC::createIrrationalFilter(int upFactor, int downFactor, float gain) {
 
 #include <emmintrin.h>
 
+#include <CPUDetect.h>
+
+#include "avx2/AudioSRC_avx2.h"
+
+// the AVX2 kernels are taken when the CPU (and the OS) support them, the SSE2 ones otherwise
+static const bool cpuHasAVX2 = cpuSupportsAVX2();
+
+// horizontal sum
+static inline float sum4(__m128 acc) {
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(0,0,0,1)));
+    return _mm_cvtss_f32(acc);
+}
+
+static inline void FIR_1x4_SSE(const float* input0, float* output0, const float* c0, int numTaps) {
+    __m128 acc0 = _mm_setzero_ps();
+
+    for (int j = 0; j < numTaps; j += 4) {
+
+        //float coef = c0[j];
+        __m128 coef0 = _mm_loadu_ps(&c0[j]);
+
+        //acc0 += input0[j] * coef;
+        acc0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input0[j]), coef0), acc0);
+    }
+
+    *output0 = sum4(acc0);
+}
+
+static inline void FIR_1x4_SSE(const float* input0, float* output0, const float* c0, const float* c1, float frac,
+                               int numTaps) {
+    __m128 frac4 = _mm_set1_ps(frac);
+    __m128 acc0 = _mm_setzero_ps();
+
+    for (int j = 0; j < numTaps; j += 4) {
+
+        //float coef = c0[j] + frac * (c1[j] - c0[j]);
+        __m128 coef0 = _mm_loadu_ps(&c0[j]);
+        __m128 coef1 = _mm_loadu_ps(&c1[j]);
+        coef1 = _mm_sub_ps(coef1, coef0);
+        coef0 = _mm_add_ps(_mm_mul_ps(coef1, frac4), coef0);
+
+        //acc0 += input0[j] * coef;
+        acc0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input0[j]), coef0), acc0);
+    }
+
+    *output0 = sum4(acc0);
+}
+
+static inline void FIR_2x4_SSE(const float* input0, const float* input1, float* output0, float* output1,
+                               const float* c0, int numTaps) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+
+    for (int j = 0; j < numTaps; j += 4) {
+
+        //float coef = c0[j];
+        __m128 coef0 = _mm_loadu_ps(&c0[j]);
+
+        //acc0 += input0[j] * coef;
+        acc0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input0[j]), coef0), acc0);
+        acc1 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input1[j]), coef0), acc1);
+    }
+
+    *output0 = sum4(acc0);
+    *output1 = sum4(acc1);
+}
+
+static inline void FIR_2x4_SSE(const float* input0, const float* input1, float* output0, float* output1,
+                               const float* c0, const float* c1, float frac, int numTaps) {
+    __m128 frac4 = _mm_set1_ps(frac);
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+
+    for (int j = 0; j < numTaps; j += 4) {
+
+        //float coef = c0[j] + frac * (c1[j] - c0[j]);
+        __m128 coef0 = _mm_loadu_ps(&c0[j]);
+        __m128 coef1 = _mm_loadu_ps(&c1[j]);
+        coef1 = _mm_sub_ps(coef1, coef0);
+        coef0 = _mm_add_ps(_mm_mul_ps(coef1, frac4), coef0);
+
+        //acc0 += input0[j] * coef;
+        acc0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input0[j]), coef0), acc0);
+        acc1 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input1[j]), coef0), acc1);
+    }
+
+    *output0 = sum4(acc0);
+    *output1 = sum4(acc1);
+}
+
 int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFrames) {
     int outputFrames = 0;
 
@@ -754,22 +845,11 @@ int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFra
 
             const float* c0 = &_polyphaseFilter[_numTaps * _phase];
 
-            __m128 acc0 = _mm_setzero_ps();
-
-            for (int j = 0; j < _numTaps; j += 4) {
-
-                //float coef = c0[j];
-                __m128 coef0 = _mm_loadu_ps(&c0[j]);
-
-                //acc0 += input0[i + j] * coef;
-                acc0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0), acc0);
+            if (cpuHasAVX2) {
+                FIR_1x8_AVX2(&input0[i], &output0[outputFrames], c0, _numTaps);
+            } else {
+                FIR_1x4_SSE(&input0[i], &output0[outputFrames], c0, _numTaps);
             }
-
-            // horizontal sum
-            acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
-            acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(0,0,0,1)));
-
-            _mm_store_ss(&output0[outputFrames], acc0);
             outputFrames += 1;
 
             i += _stepTable[_phase];
@@ -787,30 +867,16 @@ int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFra
             uint32_t f = lo32(_offset);
 
             uint32_t phase = f >> SRC_FRACBITS;
-            __m128 frac = _mm_set1_ps((f & SRC_FRACMASK) * QFRAC_TO_FLOAT);
+            float frac = (f & SRC_FRACMASK) * QFRAC_TO_FLOAT;
 
             const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
             const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
 
-            __m128 acc0 = _mm_setzero_ps();
-
-            for (int j = 0; j < _numTaps; j += 4) {
-
-                //float coef = c0[j] + frac * (c1[j] - c0[j]);
-                __m128 coef0 = _mm_loadu_ps(&c0[j]);
-                __m128 coef1 = _mm_loadu_ps(&c1[j]);
-                coef1 = _mm_sub_ps(coef1, coef0);
-                coef0 = _mm_add_ps(_mm_mul_ps(coef1, frac), coef0);
-
-                //acc0 += input0[i + j] * coef;
-                acc0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0), acc0);
+            if (cpuHasAVX2) {
+                FIR_1x8_AVX2(&input0[i], &output0[outputFrames], c0, c1, frac, _numTaps);
+            } else {
+                FIR_1x4_SSE(&input0[i], &output0[outputFrames], c0, c1, frac, _numTaps);
             }
-
-            // horizontal sum
-            acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
-            acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(0,0,0,1)));
-
-            _mm_store_ss(&output0[outputFrames], acc0);
             outputFrames += 1;
 
             _offset += _step;
@@ -834,27 +900,11 @@ int AudioSRC::multirateFilter2(const float* input0, const float* input1, float*
 
             const float* c0 = &_polyphaseFilter[_numTaps * _phase];
 
-            __m128 acc0 = _mm_setzero_ps();
-            __m128 acc1 = _mm_setzero_ps();
-
-            for (int j = 0; j < _numTaps; j += 4) {
-
-                //float coef = c0[j];
-                __m128 coef0 = _mm_loadu_ps(&c0[j]);
-
-                //acc0 += input0[i + j] * coef;
-                acc0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0), acc0);
-                acc1 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input1[i + j]), coef0), acc1);
+            if (cpuHasAVX2) {
+                FIR_2x8_AVX2(&input0[i], &input1[i], &output0[outputFrames], &output1[outputFrames], c0, _numTaps);
+            } else {
+                FIR_2x4_SSE(&input0[i], &input1[i], &output0[outputFrames], &output1[outputFrames], c0, _numTaps);
             }
-
-            // horizontal sum
-            acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
-            acc1 = _mm_add_ps(acc1, _mm_movehl_ps(acc1, acc1));
-            acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(0,0,0,1)));
-            acc1 = _mm_add_ss(acc1, _mm_shuffle_ps(acc1, acc1, _MM_SHUFFLE(0,0,0,1)));
-
-            _mm_store_ss(&output0[outputFrames], acc0);
-            _mm_store_ss(&output1[outputFrames], acc1);
             outputFrames += 1;
 
             i += _stepTable[_phase];
@@ -872,35 +922,18 @@ int AudioSRC::multirateFilter2(const float* input0, const float* input1, float*
             uint32_t f = lo32(_offset);
 
             uint32_t phase = f >> SRC_FRACBITS;
-            __m128 frac = _mm_set1_ps((f & SRC_FRACMASK) * QFRAC_TO_FLOAT);
+            float frac = (f & SRC_FRACMASK) * QFRAC_TO_FLOAT;
 
             const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
             const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
 
-            __m128 acc0 = _mm_setzero_ps();
-            __m128 acc1 = _mm_setzero_ps();
-
-            for (int j = 0; j < _numTaps; j += 4) {
-
-                //float coef = c0[j] + frac * (c1[j] - c0[j]);
-                __m128 coef0 = _mm_loadu_ps(&c0[j]);
-                __m128 coef1 = _mm_loadu_ps(&c1[j]);
-                coef1 = _mm_sub_ps(coef1, coef0);
-                coef0 = _mm_add_ps(_mm_mul_ps(coef1, frac), coef0);
-
-                //acc0 += input0[i + j] * coef;
-                acc0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0), acc0);
-                acc1 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&input1[i + j]), coef0), acc1);
+            if (cpuHasAVX2) {
+                FIR_2x8_AVX2(&input0[i], &input1[i], &output0[outputFrames], &output1[outputFrames],
+                             c0, c1, frac, _numTaps);
+            } else {
+                FIR_2x4_SSE(&input0[i], &input1[i], &output0[outputFrames], &output1[outputFrames],
+                            c0, c1, frac, _numTaps);
             }
-
-            // horizontal sum
-            acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
-            acc1 = _mm_add_ps(acc1, _mm_movehl_ps(acc1, acc1));
-            acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(0,0,0,1)));
-            acc1 = _mm_add_ss(acc1, _mm_shuffle_ps(acc1, acc1, _MM_SHUFFLE(0,0,0,1)));
-
-            _mm_store_ss(&output0[outputFrames], acc0);
-            _mm_store_ss(&output1[outputFrames], acc1);
             outputFrames += 1;
 
             _offset += _step;
@@ -913,6 +946,11 @@ int AudioSRC::multirateFilter2(const float* input0, const float* input1, float*
 
 // convert int16_t to float, deinterleave stereo
 void AudioSRC::convertInputFromInt16(const int16_t* input, float** outputs, int numFrames) {
+    if (cpuHasAVX2) {
+        convertInputFromInt16_AVX2(input, outputs, numFrames, _numChannels);
+        return;
+    }
+
     __m128 scale = _mm_set1_ps(1/32768.0f);
 
     if (_numChannels == 1) {
@@ -992,6 +1030,11 @@ static inline __m128 dither4() {
 
 // convert float to int16_t, interleave stereo
 void AudioSRC::convertOutputToInt16(float** inputs, int16_t* output, int numFrames) {
+    if (cpuHasAVX2) {
+        convertOutputToInt16_AVX2(inputs, output, numFrames, _numChannels);
+        return;
+    }
+
     __m128 scale = _mm_set1_ps(32768.0f);
 
     if (_numChannels == 1) {
@@ -1064,6 +1107,112 @@ void AudioSRC::convertOutputToInt16(float** inputs, int16_t* output, int numFram
 
 #else
 
+//
+// on ARM architecture, armeabi-v7a does not guarantee NEON: its kernels are taken when the CPU supports them
+//
+#if defined(__arm__) || defined(__aarch64__)
+
+#include <CPUDetect.h>
+
+#include "neon/AudioSRC_neon.h"
+
+static const bool cpuHasNEON = cpuSupportsNEON();
+
+#endif
+
+static inline void FIR_1x1(const float* input0, float* output0, const float* c0, int numTaps) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        assert((numTaps & 0x3) == 0);  // SIMD4
+        FIR_1x4_NEON(input0, output0, c0, numTaps);
+        return;
+    }
+#endif
+
+    float acc0 = 0.0f;
+
+    for (int j = 0; j < numTaps; j++) {
+
+        float coef = c0[j];
+
+        acc0 += input0[j] * coef;
+    }
+
+    *output0 = acc0;
+}
+
+static inline void FIR_1x1(const float* input0, float* output0, const float* c0, const float* c1, float frac,
+                           int numTaps) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        assert((numTaps & 0x3) == 0);  // SIMD4
+        FIR_1x4_NEON(input0, output0, c0, c1, frac, numTaps);
+        return;
+    }
+#endif
+
+    float acc0 = 0.0f;
+
+    for (int j = 0; j < numTaps; j++) {
+
+        float coef = c0[j] + frac * (c1[j] - c0[j]);
+
+        acc0 += input0[j] * coef;
+    }
+
+    *output0 = acc0;
+}
+
+static inline void FIR_2x1(const float* input0, const float* input1, float* output0, float* output1,
+                           const float* c0, int numTaps) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        assert((numTaps & 0x3) == 0);  // SIMD4
+        FIR_2x4_NEON(input0, input1, output0, output1, c0, numTaps);
+        return;
+    }
+#endif
+
+    float acc0 = 0.0f;
+    float acc1 = 0.0f;
+
+    for (int j = 0; j < numTaps; j++) {
+
+        float coef = c0[j];
+
+        acc0 += input0[j] * coef;
+        acc1 += input1[j] * coef;
+    }
+
+    *output0 = acc0;
+    *output1 = acc1;
+}
+
+static inline void FIR_2x1(const float* input0, const float* input1, float* output0, float* output1,
+                           const float* c0, const float* c1, float frac, int numTaps) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        assert((numTaps & 0x3) == 0);  // SIMD4
+        FIR_2x4_NEON(input0, input1, output0, output1, c0, c1, frac, numTaps);
+        return;
+    }
+#endif
+
+    float acc0 = 0.0f;
+    float acc1 = 0.0f;
+
+    for (int j = 0; j < numTaps; j++) {
+
+        float coef = c0[j] + frac * (c1[j] - c0[j]);
+
+        acc0 += input0[j] * coef;
+        acc1 += input1[j] * coef;
+    }
+
+    *output0 = acc0;
+    *output1 = acc1;
+}
+
 int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFrames) {
     int outputFrames = 0;
 
@@ -1075,16 +1224,7 @@ int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFra
 
             const float* c0 = &_polyphaseFilter[_numTaps * _phase];
 
-            float acc0 = 0.0f;
-
-            for (int j = 0; j < _numTaps; j++) {
-
-                float coef = c0[j];
-
-                acc0 += input0[i + j] * coef;
-            }
-
-            output0[outputFrames] = acc0;
+            FIR_1x1(&input0[i], &output0[outputFrames], c0, _numTaps);
             outputFrames += 1;
 
             i += _stepTable[_phase];
@@ -1107,16 +1247,7 @@ int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFra
             const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
             const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
 
-            float acc0 = 0.0f;
-
-            for (int j = 0; j < _numTaps; j++) {
-
-                float coef = c0[j] + frac * (c1[j] - c0[j]);
-
-                acc0 += input0[i + j] * coef;
-            }
-
-            output0[outputFrames] = acc0;
+            FIR_1x1(&input0[i], &output0[outputFrames], c0, c1, frac, _numTaps);
             outputFrames += 1;
 
             _offset += _step;
@@ -1138,19 +1269,7 @@ int AudioSRC::multirateFilter2(const float* input0, const float* input1, float*
 
             const float* c0 = &_polyphaseFilter[_numTaps * _phase];
 
-            float acc0 = 0.0f;
-            float acc1 = 0.0f;
-
-            for (int j = 0; j < _numTaps; j++) {
-
-                float coef = c0[j];
-
-                acc0 += input0[i + j] * coef;
-                acc1 += input1[i + j] * coef;
-            }
-
-            output0[outputFrames] = acc0;
-            output1[outputFrames] = acc1;
+            FIR_2x1(&input0[i], &input1[i], &output0[outputFrames], &output1[outputFrames], c0, _numTaps);
             outputFrames += 1;
 
             i += _stepTable[_phase];
@@ -1173,19 +1292,8 @@ int AudioSRC::multirateFilter2(const float* input0, const float* input1, float*
             const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
             const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
 
-            float acc0 = 0.0f;
-            float acc1 = 0.0f;
-
-            for (int j = 0; j < _numTaps; j++) {
-
-                float coef = c0[j] + frac * (c1[j] - c0[j]);
-
-                acc0 += input0[i + j] * coef;
-                acc1 += input1[i + j] * coef;
-            }
-
-            output0[outputFrames] = acc0;
-            output1[outputFrames] = acc1;
+            FIR_2x1(&input0[i], &input1[i], &output0[outputFrames], &output1[outputFrames],
+                    c0, c1, frac, _numTaps);
             outputFrames += 1;
 
             _offset += _step;
@@ -1198,6 +1306,13 @@ int AudioSRC::multirateFilter2(const float* input0, const float* input1, float*
 
 // convert int16_t to float, deinterleave stereo
 void AudioSRC::convertInputFromInt16(const int16_t* input, float** outputs, int numFrames) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        convertInputFromInt16_NEON(input, outputs, numFrames, _numChannels);
+        return;
+    }
+#endif
+
     const float scale = 1/32768.0f;
 
     if (_numChannels == 1) {
@@ -1223,6 +1338,13 @@ static inline float dither() {
 
 // convert float to int16_t, interleave stereo
 void AudioSRC::convertOutputToInt16(float** inputs, int16_t* output, int numFrames) {
+#if defined(__arm__) || defined(__aarch64__)
+    if (cpuHasNEON) {
+        convertOutputToInt16_NEON(inputs, output, numFrames, _numChannels);
+        return;
+    }
+#endif
+
     const float scale = 32768.0f;
 
     if (_numChannels == 1) {
@@ -32,6 +32,11 @@ public:
         _consecutiveNotMixedCount(0),
         _overflowCount(0),
         _framesDropped(0),
+        _framesAccelerated(0),
+        _framesExpanded(0),
+        _latencyMsecs(0.0f),
+        _jitterMsecs(0.0f),
+        _starvedMsecs(0),
         _packetStreamStats(),
         _packetStreamWindowStats()
     {}
@@ -54,6 +59,13 @@ public:
     quint32 _overflowCount;
     quint32 _framesDropped;
 
+    // the frames time-stretched to drain or fill the jitter buffer, the delay the buffer adds, and the jitter it covers
+    quint32 _framesAccelerated;
+    quint32 _framesExpanded;
+    float _latencyMsecs;
+    float _jitterMsecs;
+    quint32 _starvedMsecs;
+
     PacketStreamStats _packetStreamStats;
     PacketStreamStats _packetStreamWindowStats;
 };
@@ -0,0 +1,116 @@
+//
+//  AudioTimeStretch.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioTimeStretch.h"
+
+#include <cmath>
+#include <string.h>
+
+#include "AudioConstants.h"
+
+namespace {
+
+// 2ms, shorter than the pitch period of voices, the longest is half the frame so two periods fit in it
+const int MIN_PERIOD_FRAMES = AudioConstants::SAMPLE_RATE / 500;
+
+// how alike two periods have to be for one to replace the other, or how quiet the frame
+const float MIN_CORRELATION = 0.8f;
+const float QUIET_MEAN_SQUARE = 64.0f * 64.0f;
+
+// the period of the frame with the best normalized correlation to the one after it, 0 if none is good enough
+int findPeriod(const int16_t* input, int numFrames, int numChannels) {
+    int maxPeriod = numFrames / 2;
+    if (maxPeriod < MIN_PERIOD_FRAMES) {
+        return 0;
+    }
+
+    float energy = 0.0f;
+    for (int i = 0; i < 2 * maxPeriod * numChannels; i++) {
+        energy += (float)input[i] * input[i];
+    }
+    if (energy / (2 * maxPeriod * numChannels) < QUIET_MEAN_SQUARE) {
+        // nothing to be heard, the longest period changes the length the most
+        return maxPeriod;
+    }
+
+    int bestPeriod = 0;
+    float bestCorrelation = MIN_CORRELATION;
+
+    for (int period = MIN_PERIOD_FRAMES; period <= maxPeriod; period++) {
+        float crossEnergy = 0.0f;
+        float firstEnergy = 0.0f;
+        float secondEnergy = 0.0f;
+        for (int i = 0; i < period; i++) {
+            float first = 0.0f;
+            float second = 0.0f;
+            for (int c = 0; c < numChannels; c++) {
+                first += input[i * numChannels + c];
+                second += input[(i + period) * numChannels + c];
+            }
+            crossEnergy += first * second;
+            firstEnergy += first * first;
+            secondEnergy += second * second;
+        }
+
+        float correlation = (firstEnergy > 0.0f && secondEnergy > 0.0f) ?
+            crossEnergy / sqrtf(firstEnergy * secondEnergy) : 0.0f;
+        if (correlation > bestCorrelation) {
+            bestCorrelation = correlation;
+            bestPeriod = period;
+        }
+    }
+    return bestPeriod;
+}
+
+// fades from the first period to the second over their length
+void crossfade(const int16_t* fadingOut, const int16_t* fadingIn, int period, int numChannels, int16_t* output) {
+    for (int i = 0; i < period; i++) {
+        float fade = (i + 0.5f) / period;
+        for (int c = 0; c < numChannels; c++) {
+            int index = i * numChannels + c;
+            output[index] = (int16_t)lrintf(fadingOut[index] * (1.0f - fade) + fadingIn[index] * fade);
+        }
+    }
+}
+
+}
+
+bool AudioTimeStretch::accelerate(const int16_t* input, int numFrames, int numChannels, QByteArray& output) {
+    int period = findPeriod(input, numFrames, numChannels);
+    if (period == 0) {
+        return false;
+    }
+
+    // [first period crossfaded to the second][the rest]
+    output.resize((numFrames - period) * numChannels * sizeof(int16_t));
+    int16_t* samples = reinterpret_cast<int16_t*>(output.data());
+
+    crossfade(input, input + period * numChannels, period, numChannels, samples);
+    memcpy(samples + period * numChannels, input + 2 * period * numChannels,
+           (numFrames - 2 * period) * numChannels * sizeof(int16_t));
+    return true;
+}
+
+bool AudioTimeStretch::expand(const int16_t* input, int numFrames, int numChannels, QByteArray& output) {
+    int period = findPeriod(input, numFrames, numChannels);
+    if (period == 0) {
+        return false;
+    }
+
+    // [first period][second period crossfaded back to the first][the rest from the second period]
+    output.resize((numFrames + period) * numChannels * sizeof(int16_t));
+    int16_t* samples = reinterpret_cast<int16_t*>(output.data());
+
+    memcpy(samples, input, period * numChannels * sizeof(int16_t));
+    crossfade(input + period * numChannels, input, period, numChannels, samples + period * numChannels);
+    memcpy(samples + 2 * period * numChannels, input + period * numChannels,
+           (numFrames - period) * numChannels * sizeof(int16_t));
+    return true;
+}
@@ -0,0 +1,30 @@
+//
+//  AudioTimeStretch.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioTimeStretch_h
+#define hifi_AudioTimeStretch_h
+
+#include <stdint.h>
+
+#include <QtCore/QByteArray>
+
+// Changes the length of a frame of interleaved int16 samples by one period of its own waveform, found by correlation
+// and overlapped with a crossfade (WSOLA), so a jitter buffer drains or fills without a drop or a gap being heard.
+// Both ends of the frame are kept as they are, it still joins the frames around it.
+namespace AudioTimeStretch {
+
+    /// Shortens the frame, false if it doesn't repeat well enough to do it unheard.
+    bool accelerate(const int16_t* input, int numFrames, int numChannels, QByteArray& output);
+
+    /// Lengthens the frame, false if it doesn't repeat well enough to do it unheard.
+    bool expand(const int16_t* input, int numFrames, int numChannels, QByteArray& output);
+}
+
+#endif // hifi_AudioTimeStretch_h
@@ -14,6 +14,7 @@
 #include <NLPacket.h>
 #include <Node.h>
 
+#include "AudioTimeStretch.h"
 #include "InboundAudioStream.h"
 
 const int STARVE_HISTORY_CAPACITY = 50;
@@ -33,8 +34,13 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
     _starveCount(0),
     _silentFramesDropped(0),
     _oldFramesDropped(0),
+    _framesAccelerated(0),
+    _framesExpanded(0),
+    _starveStartTime(0),
+    _starvedUsecs(0),
     _incomingSequenceNumberStats(STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _lastPacketReceivedTime(0),
+    _jitterEstimator(AudioConstants::NETWORK_FRAME_USECS),
     _timeGapStatsForDesiredCalcOnTooManyStarves(0, settings._windowSecondsForDesiredCalcOnTooManyStarves),
     _calculatedJitterBufferFramesUsingMaxGap(0),
     _stdevStatsForDesiredCalcOnTooManyStarves(),
@@ -51,6 +57,10 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
 {
 }
 
+InboundAudioStream::~InboundAudioStream() {
+    cleanupCodec();
+}
+
 void InboundAudioStream::reset() {
     _ringBuffer.reset();
     _lastPopSucceeded = false;
@@ -68,8 +78,13 @@ void InboundAudioStream::resetStats() {
     _starveCount = 0;
     _silentFramesDropped = 0;
     _oldFramesDropped = 0;
+    _framesAccelerated = 0;
+    _framesExpanded = 0;
+    _starveStartTime = 0;
+    _starvedUsecs = 0;
     _incomingSequenceNumberStats.reset();
     _lastPacketReceivedTime = 0;
+    _jitterEstimator.reset();
     _timeGapStatsForDesiredCalcOnTooManyStarves.reset();
     _stdevStatsForDesiredCalcOnTooManyStarves = StDev();
     _timeGapStatsForDesiredReduction.reset();
@@ -131,7 +146,21 @@ int InboundAudioStream::parseData(NLPacket& packet) {
             if (packet.getType() == PacketType::SilentAudioFrame) {
                 writeDroppableSilentSamples(networkSamples);
             } else {
-                parseAudioData(packet.getType(), packet.readWithoutCopy(packet.bytesLeftToRead()), networkSamples);
+                QByteArray audioData;
+                if (_decoder) {
+                    // decode to PCM first so that the subclasses only ever see raw samples
+                    _decoder->decode(packet.readWithoutCopy(packet.bytesLeftToRead()), audioData);
+                    networkSamples = audioData.size() / sizeof(int16_t);
+                } else {
+                    audioData = packet.readWithoutCopy(packet.bytesLeftToRead());
+                }
+
+                QByteArray stretchedAudioData;
+                if (timeStretchToDesired(audioData, stretchedAudioData)) {
+                    parseAudioData(packet.getType(), stretchedAudioData, stretchedAudioData.size() / sizeof(int16_t));
+                } else {
+                    parseAudioData(packet.getType(), audioData, networkSamples);
+                }
             }
             break;
         }
@@ -146,9 +175,25 @@ int InboundAudioStream::parseData(NLPacket& packet) {
     // if this stream was starved, check if we're still starved.
     if (_isStarved && framesAvailable >= _desiredJitterBufferFrames) {
         _isStarved = false;
+        if (_starveStartTime != 0) {
+            _starvedUsecs += usecTimestampNow() - _starveStartTime;
+            _starveStartTime = 0;
+        }
+    }
+    // the reader drops the frames itself when it owns the read position
+    if (!_ringBuffer.isSingleProducerSingleConsumer()) {
+        dropFramesOverDesired();
     }
-    // if the ringbuffer exceeds the desired size by more than the threshold specified,
-    // drop the oldest frames so the ringbuffer is down to the desired size.
+
+    framesAvailableChanged();
+
+    return packet.pos();
+}
+
+void InboundAudioStream::dropFramesOverDesired() {
+    // the time-stretching drains the buffer smoothly, if it still gets past the desired size by more than the threshold
+    // specified, drop the oldest frames so the ringbuffer is down to the desired size.
+    int framesAvailable = _ringBuffer.framesAvailable();
     if (framesAvailable > _desiredJitterBufferFrames + _maxFramesOverDesired) {
         int framesToDrop = framesAvailable - (_desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING);
         _ringBuffer.shiftReadPosition(framesToDrop * _ringBuffer.getNumFrameSamples());
@@ -158,10 +203,6 @@ int InboundAudioStream::parseData(NLPacket& packet) {
 
         _oldFramesDropped += framesToDrop;
     }
-
-    framesAvailableChanged();
-
-    return packet.pos();
 }
 
 int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) {
@@ -172,7 +213,7 @@ int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         return sizeof(quint16);
     } else {
         // mixed audio packets do not have any info between the seq num and the audio data.
-        numAudioSamples = packetAfterSeqNum.size() / sizeof(int16_t);
+        numAudioSamples = networkSamplesForAudioBytes(packetAfterSeqNum.size());
         return 0;
     }
 }
@@ -181,6 +222,64 @@ int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packet
     return _ringBuffer.writeData(packetAfterStreamProperties.data(), numAudioSamples * sizeof(int16_t));
 }
 
+int InboundAudioStream::networkSamplesForAudioBytes(int numAudioBytes) const {
+    if (_decoder) {
+        // encoded packets always carry exactly one network frame
+        return _codecNumChannels * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    }
+    return numAudioBytes / sizeof(int16_t);
+}
+
+void InboundAudioStream::setupCodec(CodecPluginPointer codec, const QString& codecName, int numChannels) {
+    // don't use cleanupCodec() here, the codec and name may be our own members when only the channel count changes
+    if (_codec && _decoder) {
+        _codec->releaseDecoder(_decoder);
+    }
+    _decoder = nullptr;
+
+    _codec = codec;
+    _selectedCodecName = codecName;
+    _codecNumChannels = numChannels;
+
+    if (_codec) {
+        _decoder = _codec->createDecoder(AudioConstants::SAMPLE_RATE, numChannels);
+    }
+}
+
+void InboundAudioStream::cleanupCodec() {
+    if (_codec && _decoder) {
+        _codec->releaseDecoder(_decoder);
+    }
+    _decoder = nullptr;
+    _codec.reset();
+    _selectedCodecName = QString();
+    _codecNumChannels = 0;
+}
+
+bool InboundAudioStream::timeStretchToDesired(const QByteArray& audioData, QByteArray& stretchedAudioData) {
+    if (!_dynamicJitterBuffers || _isStarved) {
+        return false;
+    }
+
+    int numChannels = getNumNetworkChannels();
+    int numFrames = audioData.size() / (numChannels * sizeof(int16_t));
+    const int16_t* samples = reinterpret_cast<const int16_t*>(audioData.constData());
+
+    int framesAvailable = _ringBuffer.framesAvailable();
+    if (framesAvailable > _desiredJitterBufferFrames + TIME_STRETCH_FRAMES_THRESHOLD) {
+        if (AudioTimeStretch::accelerate(samples, numFrames, numChannels, stretchedAudioData)) {
+            _framesAccelerated++;
+            return true;
+        }
+    } else if (framesAvailable + TIME_STRETCH_FRAMES_THRESHOLD < _desiredJitterBufferFrames) {
+        if (AudioTimeStretch::expand(samples, numFrames, numChannels, stretchedAudioData)) {
+            _framesExpanded++;
+            return true;
+        }
+    }
+    return false;
+}
+
 int InboundAudioStream::writeDroppableSilentSamples(int silentSamples) {
     // calculate how many silent frames we should drop.
     int samplesPerFrame = _ringBuffer.getNumFrameSamples();
@@ -209,6 +308,15 @@ int InboundAudioStream::writeDroppableSilentSamples(int silentSamples) {
 }
 
 int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing, bool starveIfNoSamplesPopped) {
+    return popSamples(nullptr, maxSamples, allOrNothing, starveIfNoSamplesPopped);
+}
+
+int InboundAudioStream::popSamples(int16_t* destination, int maxSamples, bool allOrNothing,
+                                   bool starveIfNoSamplesPopped) {
+    if (_ringBuffer.isSingleProducerSingleConsumer()) {
+        dropFramesOverDesired();
+    }
+
     int samplesPopped = 0;
     int samplesAvailable = _ringBuffer.samplesAvailable();
     if (_isStarved) {
@@ -218,12 +326,12 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing, bool starv
     } else {
         if (samplesAvailable >= maxSamples) {
             // we have enough samples to pop, so we're good to pop
-            popSamplesNoCheck(maxSamples);
+            popSamplesNoCheck(maxSamples, destination);
             samplesPopped = maxSamples;
         } else if (!allOrNothing && samplesAvailable > 0) {
             // we don't have the requested number of samples, but we do have some
             // samples available, so pop all those (except in all-or-nothing mode)
-            popSamplesNoCheck(samplesAvailable);
+            popSamplesNoCheck(samplesAvailable, destination);
             samplesPopped = samplesAvailable;
         } else {
             // we can't pop any samples. set this stream to starved if needed
@@ -238,6 +346,10 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing, bool starv
 }
 
 int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing, bool starveIfNoFramesPopped) {
+    if (_ringBuffer.isSingleProducerSingleConsumer()) {
+        dropFramesOverDesired();
+    }
+
     int framesPopped = 0;
     int framesAvailable = _ringBuffer.framesAvailable();
     if (_isStarved) {
@@ -266,8 +378,12 @@ int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing, bool starveI
     return framesPopped;
 }
 
-void InboundAudioStream::popSamplesNoCheck(int samples) {
+void InboundAudioStream::popSamplesNoCheck(int samples, int16_t* destination) {
     _lastPopOutput = _ringBuffer.nextOutput();
+    if (destination) {
+        // once the read position moves on, the writer is free to reuse these samples
+        _lastPopOutput.readSamples(destination, samples);
+    }
     _ringBuffer.shiftReadPosition(samples);
     framesAvailableChanged();
 
@@ -295,41 +411,13 @@ void InboundAudioStream::setToStarved() {
     quint64 now = usecTimestampNow();
     _starveHistory.insert(now);
 
-    if (_dynamicJitterBuffers) {
-        // dynamic jitter buffers are enabled. check if this starve put us over the window
-        // starve threshold
-        quint64 windowEnd = now - _starveHistoryWindowSeconds * USECS_PER_SECOND;
-        RingBufferHistory<quint64>::Iterator starvesIterator = _starveHistory.begin();
-        RingBufferHistory<quint64>::Iterator end = _starveHistory.end();
-        int starvesInWindow = 1;
-        do {
-            ++starvesIterator;
-            if (*starvesIterator < windowEnd) {
-                break;
-            }
-            starvesInWindow++;
-        } while (starvesIterator != end);
-
-        // this starve put us over the starve threshold. update _desiredJitterBufferFrames to
-        // value determined by window A.
-        if (starvesInWindow >= _starveThreshold) {
-            int calculatedJitterBufferFrames;
-            if (_useStDevForJitterCalc) {
-                calculatedJitterBufferFrames = _calculatedJitterBufferFramesUsingStDev;
-            } else {
-                // we don't know when the next packet will arrive, so it's possible the gap between the last packet and the
-                // next packet will exceed the max time gap in the window.  If the time since the last packet has already exceeded
-                // the window max gap, then we should use that value to calculate desired frames.
-                int framesSinceLastPacket = ceilf((float)(now - _lastPacketReceivedTime)
-                                                  / (float)AudioConstants::NETWORK_FRAME_USECS);
-                calculatedJitterBufferFrames = std::max(_calculatedJitterBufferFramesUsingMaxGap, framesSinceLastPacket);
-            }
-            // make sure _desiredJitterBufferFrames does not become lower here
-            if (calculatedJitterBufferFrames >= _desiredJitterBufferFrames) {
-                _desiredJitterBufferFrames = calculatedJitterBufferFrames;
-            }
-        }
+    // the time spent starved only counts once the stream has played
+    if (_isStarved && _hasStarted && _starveStartTime == 0) {
+        _starveStartTime = now;
     }
+
+    // there's nothing to do for the dynamic jitter buffers, the gap that starved us goes in the model of the arrivals
+    // once the next packet comes in
 }
 
 void InboundAudioStream::setSettings(const Settings& settings) {
@@ -408,17 +496,10 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
             _stdevStatsForDesiredCalcOnTooManyStarves.reset();
         }
 
+        // the desired frames follow the model of the arrivals every packet, up as well as down
+        _jitterEstimator.packetArrived(gap);
         if (_dynamicJitterBuffers) {
-            // if the max gap in window B (_timeGapStatsForDesiredReduction) corresponds to a smaller number of frames than _desiredJitterBufferFrames,
-            // then reduce _desiredJitterBufferFrames to that number of frames.
-            if (_timeGapStatsForDesiredReduction.getNewStatsAvailableFlag() && _timeGapStatsForDesiredReduction.isWindowFilled()) {
-                int calculatedJitterBufferFrames = ceilf((float)_timeGapStatsForDesiredReduction.getWindowMax()
-                                                         / (float)AudioConstants::NETWORK_FRAME_USECS);
-                if (calculatedJitterBufferFrames < _desiredJitterBufferFrames) {
-                    _desiredJitterBufferFrames = calculatedJitterBufferFrames;
-                }
-                _timeGapStatsForDesiredReduction.clearNewStatsAvailableFlag();
-            }
+            _desiredJitterBufferFrames = clampDesiredJitterBufferFramesValue(_jitterEstimator.getTargetFrames());
         }
     }
 
@@ -468,6 +549,16 @@ AudioStreamStats InboundAudioStream::getAudioStreamStats() const {
     streamStats._consecutiveNotMixedCount = _consecutiveNotMixedCount;
     streamStats._overflowCount = _ringBuffer.getOverflowCount();
     streamStats._framesDropped = _silentFramesDropped + _oldFramesDropped;    // TODO: add separate stat for old frames dropped
+    streamStats._framesAccelerated = _framesAccelerated;
+    streamStats._framesExpanded = _framesExpanded;
+    streamStats._latencyMsecs = _framesAvailableStat.getAverage() * AudioConstants::NETWORK_FRAME_MSECS;
+    streamStats._jitterMsecs = getJitterMsecs();
+
+    quint64 starvedUsecs = _starvedUsecs;
+    if (_starveStartTime != 0) {
+        starvedUsecs += usecTimestampNow() - _starveStartTime;
+    }
+    streamStats._starvedMsecs = (quint32)(starvedUsecs / USECS_PER_MSEC);
 
     streamStats._packetStreamStats = _incomingSequenceNumberStats.getStats();
     streamStats._packetStreamWindowStats = _incomingSequenceNumberStats.getStatsForHistoryWindow();
@@ -17,12 +17,18 @@
 #include <udt/PacketHeaders.h>
 #include <StDev.h>
 
+#include <plugins/CodecPlugin.h>
+
 #include "AudioRingBuffer.h"
+#include "JitterEstimator.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
 #include "AudioStreamStats.h"
 #include "TimeWeightedAvg.h"
 
+// The frames over or under the desired jitter buffer frames before the incoming frames are time-stretched to get back.
+const int TIME_STRETCH_FRAMES_THRESHOLD = 1;
+
 // This adds some number of frames to the desired jitter buffer frames target we use when we're dropping frames.
 // The larger this value is, the less frames we drop when attempting to reduce the jitter buffer length.
 // Setting this to 0 will try to get the jitter buffer to be exactly _desiredJitterBufferFrames when dropping frames,
@@ -49,6 +55,7 @@ const bool DEFAULT_REPETITION_WITH_FADE = true;
 
 // Audio Env bitset
 const int HAS_REVERB_BIT = 0; // 1st bit
+const int HAS_MIXER_REVERB_BIT = 1; // 2nd bit, the reverb of the zone is already in the mix
 
 class InboundAudioStream : public NodeData {
     Q_OBJECT
@@ -82,14 +89,14 @@ public:
         // max number of frames over desired in the ringbuffer.
         int _maxFramesOverDesired;
 
-        // if false, _desiredJitterBufferFrames will always be _staticDesiredJitterBufferFrames.  Otherwise,
-        // either fred or philip's method will be used to calculate _desiredJitterBufferFrames based on packet timegaps.
+        // if false, _desiredJitterBufferFrames will always be _staticDesiredJitterBufferFrames.  Otherwise, it follows
+        // the model of the packet arrivals, and the incoming frames are time-stretched to bring the buffer to it.
         bool _dynamicJitterBuffers;
 
         // settings for static jitter buffer mode
         int _staticDesiredJitterBufferFrames;
 
-        // settings for dynamic jitter buffer mode
+        // settings of the calculated jitter buffer frames, only for the stats since the model of the packet arrivals
         bool _useStDevForJitterCalc;       // if true, philip's method is used.  otherwise, fred's method is used.
         int _windowStarveThreshold;
         int _windowSecondsForDesiredCalcOnTooManyStarves;
@@ -102,6 +109,7 @@ public:
 
 public:
     InboundAudioStream(int numFrameSamples, int numFramesCapacity, const Settings& settings);
+    ~InboundAudioStream();
 
     void reset();
     virtual void resetStats();
@@ -112,6 +120,9 @@ public:
     int popFrames(int maxFrames, bool allOrNothing, bool starveIfNoFramesPopped = true);
     int popSamples(int maxSamples, bool allOrNothing, bool starveIfNoSamplesPopped = true);
 
+    /// pops the samples into the destination, they are copied before the read position is handed back to the writer
+    int popSamples(int16_t* destination, int maxSamples, bool allOrNothing, bool starveIfNoSamplesPopped = true);
+
     bool lastPopSucceeded() const { return _lastPopSucceeded; };
     const AudioRingBuffer::ConstIterator& getLastPopOutput() const { return _lastPopOutput; }
 
@@ -119,6 +130,12 @@ public:
 
     void setSettings(const Settings& settings);
 
+    /// the packets are parsed on one thread and the samples popped on another without a lock, see AudioRingBuffer.
+    /// The frames over the desired are then dropped by the reader.
+    void setSingleProducerSingleConsumer(bool isSingleProducerSingleConsumer) {
+        _ringBuffer.setSingleProducerSingleConsumer(isSingleProducerSingleConsumer);
+    }
+
     void setMaxFramesOverDesired(int maxFramesOverDesired) { _maxFramesOverDesired = maxFramesOverDesired; }
     void setDynamicJitterBuffers(bool setDynamicJitterBuffers);
     void setStaticDesiredJitterBufferFrames(int staticDesiredJitterBufferFrames);
@@ -162,6 +179,9 @@ public:
     int getStarveCount() const { return _starveCount; }
     int getSilentFramesDropped() const { return _silentFramesDropped; }
     int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
+    int getFramesAccelerated() const { return _framesAccelerated; }
+    int getFramesExpanded() const { return _framesExpanded; }
+    float getJitterMsecs() const { return _jitterEstimator.getJitterUsecs() / USECS_PER_MSEC; }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
     
@@ -170,6 +190,11 @@ public:
     float getWetLevel() const { return _wetLevel; }
     void setReverb(float reverbTime, float wetLevel);
     void clearReverb() { _hasReverb = false; }
+
+    /// decode the audio of this stream with the given codec, a null codec means raw PCM
+    void setupCodec(CodecPluginPointer codec, const QString& codecName, int numChannels);
+    void cleanupCodec();
+    const QString& getSelectedCodecName() const { return _selectedCodecName; }
     
 public slots:
     /// This function should be called every second for all the stats to function properly. If dynamic jitter buffers
@@ -183,7 +208,11 @@ private:
 
     int writeSamplesForDroppedPackets(int networkSamples);
 
-    void popSamplesNoCheck(int samples);
+    /// shortens or lengthens the frame when the buffer is away from the desired frames, false if left as it is
+    bool timeStretchToDesired(const QByteArray& audioData, QByteArray& stretchedAudioData);
+
+    void popSamplesNoCheck(int samples, int16_t* destination = nullptr);
+    void dropFramesOverDesired();
     void framesAvailableChanged();
 
 protected:
@@ -206,6 +235,12 @@ protected:
     /// writes the last written frame repeatedly, gradually fading to silence.
     /// used for writing samples for dropped packets.
     virtual int writeLastFrameRepeatedWithFade(int samples);
+
+    /// the number of network samples carried by audio data of the given size, taking the codec into account
+    int networkSamplesForAudioBytes(int numAudioBytes) const;
+
+    /// the channels interleaved in the audio data, the mixed streams are stereo
+    virtual int getNumNetworkChannels() const { return 2; }
     
 protected:
 
@@ -236,10 +271,15 @@ protected:
     int _starveCount;
     int _silentFramesDropped;
     int _oldFramesDropped;
+    int _framesAccelerated;
+    int _framesExpanded;
+    quint64 _starveStartTime;
+    quint64 _starvedUsecs;
 
     SequenceNumberStats _incomingSequenceNumberStats;
 
     quint64 _lastPacketReceivedTime;
+    JitterEstimator _jitterEstimator;
     MovingMinMaxAvg<quint64> _timeGapStatsForDesiredCalcOnTooManyStarves;   // for Freddy's method
     int _calculatedJitterBufferFramesUsingMaxGap;
     StDev _stdevStatsForDesiredCalcOnTooManyStarves;                        // for Philip's method
@@ -264,6 +304,11 @@ protected:
     bool _hasReverb;
     float _reverbTime;
     float _wetLevel;
+
+    CodecPluginPointer _codec;
+    QString _selectedCodecName;
+    Decoder* _decoder { nullptr };
+    int _codecNumChannels { 0 };
 };
 
 float calculateRepeatedFrameFadeFactor(int indexOfRepeat);
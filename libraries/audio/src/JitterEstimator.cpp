@@ -0,0 +1,60 @@
+//
+//  JitterEstimator.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JitterEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+// how much of the model each packet keeps, (1 - this) goes to its own arrival; about 3 seconds of memory at 100 packets/s
+const float FORGET_FACTOR = 0.997f;
+
+// the share of the arrivals the target outlasts, a starve every few seconds on a steady connection at most
+const float TARGET_PROBABILITY = 0.95f;
+
+// the smoothing of the jitter, as RFC 3550 has it
+const float JITTER_GAIN = 1.0f / 16.0f;
+
+JitterEstimator::JitterEstimator(int frameUsecs) :
+    _frameUsecs(frameUsecs)
+{
+    reset();
+}
+
+void JitterEstimator::reset() {
+    // start as a steady stream, one packet each frame
+    std::fill(_probabilities, _probabilities + MAX_INTER_ARRIVAL_FRAMES + 1, 0.0f);
+    _probabilities[1] = 1.0f;
+    _targetFrames = 1;
+    _jitterUsecs = 0.0f;
+}
+
+void JitterEstimator::packetArrived(quint64 gapUsecs) {
+    int interArrivalFrames = std::min((int)((gapUsecs + _frameUsecs / 2) / _frameUsecs), MAX_INTER_ARRIVAL_FRAMES);
+
+    // the probabilities keep summing to 1
+    for (int i = 0; i <= MAX_INTER_ARRIVAL_FRAMES; i++) {
+        _probabilities[i] *= FORGET_FACTOR;
+    }
+    _probabilities[interArrivalFrames] += 1.0f - FORGET_FACTOR;
+
+    float cumulative = 0.0f;
+    _targetFrames = MAX_INTER_ARRIVAL_FRAMES;
+    for (int i = 0; i <= MAX_INTER_ARRIVAL_FRAMES; i++) {
+        cumulative += _probabilities[i];
+        if (cumulative >= TARGET_PROBABILITY) {
+            _targetFrames = std::max(i, 1);
+            break;
+        }
+    }
+
+    float deviation = std::fabs((float)gapUsecs - (float)_frameUsecs);
+    _jitterUsecs += (deviation - _jitterUsecs) * JITTER_GAIN;
+}
@@ -0,0 +1,42 @@
+//
+//  JitterEstimator.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JitterEstimator_h
+#define hifi_JitterEstimator_h
+
+#include <QtCore/QtGlobal>
+
+/// A model of the packet arrivals of an audio stream: how likely each time between two packets is, in frames, with the
+/// older arrivals forgotten exponentially. The target depth of the jitter buffer follows the network both ways.
+class JitterEstimator {
+public:
+    static const int MAX_INTER_ARRIVAL_FRAMES = 50;
+
+    JitterEstimator(int frameUsecs);
+
+    void reset();
+
+    /// Adds the time since the previous packet to the model, and updates the target.
+    void packetArrived(quint64 gapUsecs);
+
+    /// The smallest number of frames that outlasts the time between two packets, most of the time.
+    int getTargetFrames() const { return _targetFrames; }
+
+    /// The smoothed deviation of the time between packets from the frame duration, as in RFC 3550.
+    float getJitterUsecs() const { return _jitterUsecs; }
+
+private:
+    int _frameUsecs;
+    float _probabilities[MAX_INTER_ARRIVAL_FRAMES + 1];
+    int _targetFrames;
+    float _jitterUsecs;
+};
+
+#endif // hifi_JitterEstimator_h
@@ -28,6 +28,7 @@
 #include "AudioBuffer.h"
 #include "AudioEditBuffer.h"
 #include "AudioLogging.h"
+#include "AudioSRC.h"
 #include "Sound.h"
 
 static int soundMetaTypeId = qRegisterMetaType<Sound*>();
@@ -56,20 +57,29 @@ Sound::Sound(const QUrl& url, bool isStereo) :
 
 }
 
+// the sounds longer than this stay compressed, the short ones are played too often to decode them every time
+static const float MIN_COMPRESSED_SOUND_SECONDS = 10.0f;
+
+// what the raw files are recorded at, there's no header to tell
+static const int RAW_SAMPLE_RATE = 48000;
+
 void Sound::downloadFinished(const QByteArray& data) {
     // replace our byte array with the downloaded data
     QByteArray rawAudioByteArray = QByteArray(data);
     QString fileName = getURL().fileName().toLower();
 
+    QByteArray samples;
+
     static const QString WAV_EXTENSION = ".wav";
     static const QString RAW_EXTENSION = ".raw";
     if (fileName.endsWith(WAV_EXTENSION)) {
 
         QByteArray outputAudioByteArray;
+        int sampleRate = 0;
 
-        interpretAsWav(rawAudioByteArray, outputAudioByteArray);
-        downSample(outputAudioByteArray);
-        trimFrames();
+        interpretAsWav(rawAudioByteArray, outputAudioByteArray, sampleRate);
+        samples = resample(outputAudioByteArray, sampleRate);
+        trimFrames(samples);
     } else if (fileName.endsWith(RAW_EXTENSION)) {
         // check if this was a stereo raw file
         // since it's raw the only way for us to know that is if the file was called .stereo.raw
@@ -79,65 +89,53 @@ void Sound::downloadFinished(const QByteArray& data) {
         }
 
         // Process as RAW file
-        downSample(rawAudioByteArray);
-        trimFrames();
+        samples = resample(rawAudioByteArray, RAW_SAMPLE_RATE);
+        trimFrames(samples);
     } else {
         qCDebug(audio) << "Unknown sound file type";
     }
 
+    int numChannels = _isStereo ? 2 : 1;
+    float seconds = samples.size() / (float)(numChannels * sizeof(AudioConstants::AudioSample) * AudioConstants::SAMPLE_RATE);
+    if (seconds >= MIN_COMPRESSED_SOUND_SECONDS) {
+        _audioData = SoundData::compress(samples, numChannels);
+        qCDebug(audio) << "Keeping" << seconds << "seconds of sound from" << getURL() << "compressed in"
+            << _audioData.getResidentBytes() << "bytes.";
+    } else {
+        _audioData = SoundData(samples);
+    }
+
     _isReady = true;
 }
 
-void Sound::downSample(const QByteArray& rawAudioByteArray) {
-    // assume that this was a RAW file and is now an array of samples that are
-    // signed, 16-bit, 48Khz
-
-    // we want to convert it to the format that the audio-mixer wants
-    // which is signed, 16-bit, 24Khz
-
-    int numSourceSamples = rawAudioByteArray.size() / sizeof(AudioConstants::AudioSample);
-
-    int numDestinationBytes = rawAudioByteArray.size() / sizeof(AudioConstants::AudioSample);
-    if (_isStereo && numSourceSamples % 2 != 0) {
-        numDestinationBytes += sizeof(AudioConstants::AudioSample);
+QByteArray Sound::resample(const QByteArray& samples, int sampleRate) {
+    // signed, 16-bit at the rate of the file to the format that the audio-mixer wants, signed, 16-bit, 24Khz
+    int numChannels = _isStereo ? 2 : 1;
+    int numFrames = samples.size() / (numChannels * sizeof(AudioConstants::AudioSample));
+    if (sampleRate == AudioConstants::SAMPLE_RATE || numFrames == 0) {
+        return samples.left(numFrames * numChannels * sizeof(AudioConstants::AudioSample));
     }
 
-    _byteArray.resize(numDestinationBytes);
+    AudioSRC resampler(sampleRate, AudioConstants::SAMPLE_RATE, numChannels);
 
-    int16_t* sourceSamples = (int16_t*) rawAudioByteArray.data();
-    int16_t* destinationSamples = (int16_t*) _byteArray.data();
+    QByteArray resampled(resampler.getMaxOutput(numFrames) * numChannels * sizeof(AudioConstants::AudioSample), 0);
+    int numResampledFrames = resampler.render(reinterpret_cast<const int16_t*>(samples.constData()),
+                                              reinterpret_cast<int16_t*>(resampled.data()), numFrames);
 
-    if (_isStereo) {
-        for (int i = 0; i < numSourceSamples; i += 4) {
-            if (i + 2 >= numSourceSamples) {
-                destinationSamples[i / 2] = sourceSamples[i];
-                destinationSamples[(i / 2) + 1] = sourceSamples[i + 1];
-            } else {
-                destinationSamples[i / 2] = (sourceSamples[i] + sourceSamples[i + 2]) / 2;
-                destinationSamples[(i / 2) + 1] = (sourceSamples[i + 1] + sourceSamples[i + 3]) / 2;
-            }
-        }
-    } else {
-        for (int i = 1; i < numSourceSamples; i += 2) {
-            if (i + 1 >= numSourceSamples) {
-                destinationSamples[(i - 1) / 2] = (sourceSamples[i - 1] + sourceSamples[i]) / 2;
-            } else {
-                destinationSamples[(i - 1) / 2] = ((sourceSamples[i - 1] + sourceSamples[i + 1]) / 4) + (sourceSamples[i] / 2);
-            }
-        }
-    }
+    resampled.resize(numResampledFrames * numChannels * sizeof(AudioConstants::AudioSample));
+    return resampled;
 }
 
-void Sound::trimFrames() {
+void Sound::trimFrames(QByteArray& samples) {
 
-    const uint32_t inputFrameCount = _byteArray.size() / sizeof(int16_t);
+    const uint32_t inputFrameCount = samples.size() / sizeof(int16_t);
     const uint32_t trimCount = 1024;  // number of leading and trailing frames to trim
 
     if (inputFrameCount <= (2 * trimCount)) {
         return;
     }
 
-    int16_t* inputFrameData = (int16_t*)_byteArray.data();
+    int16_t* inputFrameData = (int16_t*)samples.data();
 
     AudioEditBufferFloat32 editBuffer(1, inputFrameCount);
     editBuffer.copyFrames(1, inputFrameCount, inputFrameData, false /*copy in*/);
@@ -199,7 +197,7 @@ struct CombinedHeader {
     WAVEHeader  wave;
 };
 
-void Sound::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray) {
+void Sound::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray, int& sampleRate) {
 
     CombinedHeader fileHeader;
 
@@ -238,8 +236,10 @@ void Sound::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& ou
             qCDebug(audio) << "Currently not supporting non 16bit audio files.";
             return;
         }
-        if (qFromLittleEndian<quint32>(fileHeader.wave.sampleRate) != 48000) {
-            qCDebug(audio) << "Currently not supporting non 48KHz audio files.";
+        // any rate is resampled to the one of the mixer
+        sampleRate = qFromLittleEndian<quint32>(fileHeader.wave.sampleRate);
+        if (sampleRate <= 0) {
+            qCDebug(audio) << "Not a valid sample rate for a WAVE Audio file.";
             return;
         }
 
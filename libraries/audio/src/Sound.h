@@ -18,6 +18,8 @@
 
 #include <ResourceCache.h>
 
+#include "SoundData.h"
+
 class Sound : public Resource {
     Q_OBJECT
     
@@ -28,16 +30,21 @@ public:
     bool isStereo() const { return _isStereo; }    
     bool isReady() const { return _isReady; }
      
-    const QByteArray& getByteArray() { return _byteArray; }
+    /// The samples as they are kept, the long sounds stay compressed and are decoded as they play.
+    const SoundData& getAudioData() const { return _audioData; }
+
+    /// Decodes all the samples of the sound, prefer getAudioData() for the sounds that can be long.
+    /// Scripts get an ArrayBuffer that shares the samples of the sounds that aren't compressed.
+    Q_INVOKABLE QByteArray getByteArray() const { return _audioData.decodeAll(); }
 
 private:
-    QByteArray _byteArray;
+    SoundData _audioData;
     bool _isStereo;
     bool _isReady;
     
-    void trimFrames();
-    void downSample(const QByteArray& rawAudioByteArray);
-    void interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray);
+    void trimFrames(QByteArray& samples);
+    QByteArray resample(const QByteArray& samples, int sampleRate);
+    void interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray, int& sampleRate);
     
     virtual void downloadFinished(const QByteArray& data) override;
 };
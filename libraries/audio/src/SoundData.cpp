@@ -0,0 +1,93 @@
+//
+//  SoundData.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SoundData.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include <plugins/BuiltinCodecs.h>
+#include <plugins/CodecPlugins.h>
+
+#include "AudioConstants.h"
+
+SoundData::SoundData(const QByteArray& samples) :
+    _samples(samples),
+    _numBytes(samples.size())
+{
+}
+
+SoundData SoundData::compress(const QByteArray& samples, int numChannels) {
+    // the frames of ADPCM carry the state of the decoder in their header, any of them can be played on its own
+    CodecPluginPointer codec = getCodecPlugin(ADPCMCodec::NAME);
+    if (!codec || samples.isEmpty()) {
+        return SoundData(samples);
+    }
+
+    SoundData data;
+    data._codec = codec;
+    data._numBytes = samples.size();
+    data._numChannels = numChannels;
+    data._frameBytes = numChannels * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
+
+    Encoder* encoder = codec->createEncoder(AudioConstants::SAMPLE_RATE, numChannels);
+    QByteArray frame;
+    QByteArray encodedFrame;
+    for (int offset = 0; offset < samples.size(); offset += data._frameBytes) {
+        // the last frame is padded with silence so they all encode to the same size
+        frame = samples.mid(offset, data._frameBytes);
+        if (frame.size() < data._frameBytes) {
+            frame.append(QByteArray(data._frameBytes - frame.size(), 0));
+        }
+        encoder->encode(frame, encodedFrame);
+        if (data._frames.isEmpty()) {
+            data._encodedFrameBytes = encodedFrame.size();
+            data._frames.reserve(((samples.size() + data._frameBytes - 1) / data._frameBytes) * data._encodedFrameBytes);
+        }
+        data._frames.append(encodedFrame);
+    }
+    codec->releaseEncoder(encoder);
+
+    return data;
+}
+
+void SoundData::read(int offset, int numBytes, char* destination) const {
+    if (!isCompressed()) {
+        memcpy(destination, _samples.constData() + offset, numBytes);
+        return;
+    }
+
+    Decoder* decoder = _codec->createDecoder(AudioConstants::SAMPLE_RATE, _numChannels);
+    QByteArray decodedFrame;
+    while (numBytes > 0) {
+        int frameIndex = offset / _frameBytes;
+        int frameOffset = offset % _frameBytes;
+
+        decoder->decode(QByteArray::fromRawData(_frames.constData() + frameIndex * _encodedFrameBytes,
+                                                _encodedFrameBytes), decodedFrame);
+
+        int bytesToCopy = std::min(numBytes, _frameBytes - frameOffset);
+        memcpy(destination, decodedFrame.constData() + frameOffset, bytesToCopy);
+
+        destination += bytesToCopy;
+        offset += bytesToCopy;
+        numBytes -= bytesToCopy;
+    }
+    _codec->releaseDecoder(decoder);
+}
+
+QByteArray SoundData::decodeAll() const {
+    if (!isCompressed()) {
+        return _samples;
+    }
+    QByteArray samples(_numBytes, 0);
+    read(0, _numBytes, samples.data());
+    return samples;
+}
@@ -0,0 +1,52 @@
+//
+//  SoundData.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SoundData_h
+#define hifi_SoundData_h
+
+#include <QtCore/QByteArray>
+
+#include <plugins/Forward.h>
+
+/// The int16 samples of a sound at the mixer rate, either as they are or as the network frames of a codec, each
+/// decoded on its own when read so only the frames being played are ever resident. Copies share the data.
+class SoundData {
+public:
+    SoundData() {}
+    SoundData(const QByteArray& samples);
+
+    /// Encodes the samples into codec frames, they stay as they are if no codec is there to do it.
+    static SoundData compress(const QByteArray& samples, int numChannels);
+
+    bool isCompressed() const { return (bool)_codec; }
+
+    /// The size of the samples once decoded, not of what is kept.
+    int getNumBytes() const { return _numBytes; }
+    int getResidentBytes() const { return isCompressed() ? _frames.size() : _samples.size(); }
+
+    /// Copies the decoded bytes of the samples starting at the offset, the range must be within the sound.
+    void read(int offset, int numBytes, char* destination) const;
+
+    /// Decodes the whole sound, shared at no cost when it isn't compressed.
+    QByteArray decodeAll() const;
+
+private:
+    QByteArray _samples;
+    int _numBytes { 0 };
+
+    // the frames of the codec, each with the same encoded size so they can be found from an offset
+    CodecPluginPointer _codec;
+    QByteArray _frames;
+    int _numChannels { 1 };
+    int _frameBytes { 0 };
+    int _encodedFrameBytes { 0 };
+};
+
+#endif // hifi_SoundData_h
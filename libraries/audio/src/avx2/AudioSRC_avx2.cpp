@@ -0,0 +1,248 @@
+//
+//  AudioSRC_avx2.cpp
+//  libraries/audio/src/avx2
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <immintrin.h>
+
+#include "AudioSRC_avx2.h"
+
+// horizontal sum of the 8 lanes
+static inline float sum8(__m256 acc) {
+    __m128 acc4 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    acc4 = _mm_add_ps(acc4, _mm_movehl_ps(acc4, acc4));
+    acc4 = _mm_add_ss(acc4, _mm_shuffle_ps(acc4, acc4, _MM_SHUFFLE(0,0,0,1)));
+    return _mm_cvtss_f32(acc4);
+}
+
+// the taps past the last multiple of 8 are a multiple of 4, they go in the lower half
+static inline __m256 loadTail(const float* p) {
+    return _mm256_castps128_ps256(_mm_loadu_ps(p));
+}
+
+static inline __m256 zeroUpper(__m256 v) {
+    return _mm256_insertf128_ps(v, _mm_setzero_ps(), 1);
+}
+
+void FIR_1x8_AVX2(const float* input0, float* output0, const float* c0, int numTaps) {
+    __m256 acc0 = _mm256_setzero_ps();
+
+    int j = 0;
+    for (; j < numTaps - 7; j += 8) {
+        __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(&input0[j]), coef0, acc0);
+    }
+    if (j < numTaps) {
+        __m256 coef0 = zeroUpper(loadTail(&c0[j]));
+
+        acc0 = _mm256_fmadd_ps(zeroUpper(loadTail(&input0[j])), coef0, acc0);
+    }
+
+    *output0 = sum8(acc0);
+}
+
+void FIR_2x8_AVX2(const float* input0, const float* input1, float* output0, float* output1,
+                  const float* c0, int numTaps) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+
+    int j = 0;
+    for (; j < numTaps - 7; j += 8) {
+        __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(&input0[j]), coef0, acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(&input1[j]), coef0, acc1);
+    }
+    if (j < numTaps) {
+        __m256 coef0 = zeroUpper(loadTail(&c0[j]));
+
+        acc0 = _mm256_fmadd_ps(zeroUpper(loadTail(&input0[j])), coef0, acc0);
+        acc1 = _mm256_fmadd_ps(zeroUpper(loadTail(&input1[j])), coef0, acc1);
+    }
+
+    *output0 = sum8(acc0);
+    *output1 = sum8(acc1);
+}
+
+void FIR_1x8_AVX2(const float* input0, float* output0, const float* c0, const float* c1, float frac, int numTaps) {
+    __m256 frac8 = _mm256_set1_ps(frac);
+    __m256 acc0 = _mm256_setzero_ps();
+
+    int j = 0;
+    for (; j < numTaps - 7; j += 8) {
+        //float coef = c0[j] + frac * (c1[j] - c0[j]);
+        __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+        __m256 coef1 = _mm256_loadu_ps(&c1[j]);
+        coef0 = _mm256_fmadd_ps(_mm256_sub_ps(coef1, coef0), frac8, coef0);
+
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(&input0[j]), coef0, acc0);
+    }
+    if (j < numTaps) {
+        __m256 coef0 = loadTail(&c0[j]);
+        __m256 coef1 = loadTail(&c1[j]);
+        coef0 = zeroUpper(_mm256_fmadd_ps(_mm256_sub_ps(coef1, coef0), frac8, coef0));
+
+        acc0 = _mm256_fmadd_ps(zeroUpper(loadTail(&input0[j])), coef0, acc0);
+    }
+
+    *output0 = sum8(acc0);
+}
+
+void FIR_2x8_AVX2(const float* input0, const float* input1, float* output0, float* output1,
+                  const float* c0, const float* c1, float frac, int numTaps) {
+    __m256 frac8 = _mm256_set1_ps(frac);
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+
+    int j = 0;
+    for (; j < numTaps - 7; j += 8) {
+        //float coef = c0[j] + frac * (c1[j] - c0[j]);
+        __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+        __m256 coef1 = _mm256_loadu_ps(&c1[j]);
+        coef0 = _mm256_fmadd_ps(_mm256_sub_ps(coef1, coef0), frac8, coef0);
+
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(&input0[j]), coef0, acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(&input1[j]), coef0, acc1);
+    }
+    if (j < numTaps) {
+        __m256 coef0 = loadTail(&c0[j]);
+        __m256 coef1 = loadTail(&c1[j]);
+        coef0 = zeroUpper(_mm256_fmadd_ps(_mm256_sub_ps(coef1, coef0), frac8, coef0));
+
+        acc0 = _mm256_fmadd_ps(zeroUpper(loadTail(&input0[j])), coef0, acc0);
+        acc1 = _mm256_fmadd_ps(zeroUpper(loadTail(&input1[j])), coef0, acc1);
+    }
+
+    *output0 = sum8(acc0);
+    *output1 = sum8(acc1);
+}
+
+void convertInputFromInt16_AVX2(const int16_t* input, float** outputs, int numFrames, int numChannels) {
+    __m256 scale = _mm256_set1_ps(1/32768.0f);
+
+    if (numChannels == 1) {
+
+        int i = 0;
+        for (; i < numFrames - 7; i += 8) {
+            // sign-extend
+            __m256i a0 = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)&input[i]));
+
+            __m256 f0 = _mm256_mul_ps(_mm256_cvtepi32_ps(a0), scale);
+
+            _mm256_storeu_ps(&outputs[0][i], f0);
+        }
+        for (; i < numFrames; i++) {
+            outputs[0][i] = (float)input[i] * (1/32768.0f);
+        }
+
+    } else if (numChannels == 2) {
+
+        int i = 0;
+        for (; i < numFrames - 7; i += 8) {
+            __m256i a0 = _mm256_loadu_si256((__m256i*)&input[2*i]);
+            __m256i a1 = a0;
+
+            // deinterleave and sign-extend
+            a0 = _mm256_madd_epi16(a0, _mm256_set1_epi32(0x00000001));
+            a1 = _mm256_madd_epi16(a1, _mm256_set1_epi32(0x00010000));
+
+            __m256 f0 = _mm256_mul_ps(_mm256_cvtepi32_ps(a0), scale);
+            __m256 f1 = _mm256_mul_ps(_mm256_cvtepi32_ps(a1), scale);
+
+            _mm256_storeu_ps(&outputs[0][i], f0);
+            _mm256_storeu_ps(&outputs[1][i], f1);
+        }
+        for (; i < numFrames; i++) {
+            outputs[0][i] = (float)input[2*i + 0] * (1/32768.0f);
+            outputs[1][i] = (float)input[2*i + 1] * (1/32768.0f);
+        }
+    }
+}
+
+// the state of the 16 LCGs of the dither, kept in memory since a vector can't be initialized before the CPU is checked
+static int16_t ditherState[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+
+// fast TPDF dither in [-1.0f, 1.0f], the same maximum-length LCGs as the SSE2 version in each half
+static inline __m256 dither8(__m256i& rz) {
+    rz = _mm256_mullo_epi16(rz, _mm256_set_epi16(25173, -25511, -5975, -23279, 19445, -27591, 30185, -3495,
+                                                 25173, -25511, -5975, -23279, 19445, -27591, 30185, -3495));
+    rz = _mm256_add_epi16(rz, _mm256_set_epi16(13849, -32767, 105, -19675, -7701, -32679, -13225, 28013,
+                                               13849, -32767, 105, -19675, -7701, -32679, -13225, 28013));
+
+    // promote to 32-bit
+    __m256i r0 = _mm256_unpacklo_epi16(rz, _mm256_setzero_si256());
+    __m256i r1 = _mm256_unpackhi_epi16(rz, _mm256_setzero_si256());
+
+    // return (r0 - r1) * (1/65536.0f);
+    __m256 d0 = _mm256_cvtepi32_ps(_mm256_sub_epi32(r0, r1));
+    return _mm256_mul_ps(d0, _mm256_set1_ps(1/65536.0f));
+}
+
+// round and saturate 8 samples, in order in the lower half
+static inline __m128i packSamples(__m256 f0) {
+    __m256i a0 = _mm256_cvtps_epi32(f0);
+    a0 = _mm256_packs_epi32(a0, a0);
+    return _mm256_castsi256_si128(_mm256_permute4x64_epi64(a0, _MM_SHUFFLE(3,1,2,0)));
+}
+
+static inline int16_t packSample(float f) {
+    int32_t a = _mm_cvtss_si32(_mm_set_ss(f));
+    return (int16_t)(a < -32768 ? -32768 : (a > 32767 ? 32767 : a));
+}
+
+void convertOutputToInt16_AVX2(float** inputs, int16_t* output, int numFrames, int numChannels) {
+    __m256 scale = _mm256_set1_ps(32768.0f);
+    __m256i rz = _mm256_loadu_si256((__m256i*)ditherState);
+
+    if (numChannels == 1) {
+
+        int i = 0;
+        for (; i < numFrames - 7; i += 8) {
+            __m256 f0 = _mm256_mul_ps(_mm256_loadu_ps(&inputs[0][i]), scale);
+
+            f0 = _mm256_add_ps(f0, dither8(rz));
+
+            _mm_storeu_si128((__m128i*)&output[i], packSamples(f0));
+        }
+        for (; i < numFrames; i++) {
+            float d = _mm_cvtss_f32(_mm256_castps256_ps128(dither8(rz)));
+            output[i] = packSample(inputs[0][i] * 32768.0f + d);
+        }
+
+    } else if (numChannels == 2) {
+
+        int i = 0;
+        for (; i < numFrames - 7; i += 8) {
+            __m256 f0 = _mm256_mul_ps(_mm256_loadu_ps(&inputs[0][i]), scale);
+            __m256 f1 = _mm256_mul_ps(_mm256_loadu_ps(&inputs[1][i]), scale);
+
+            __m256 d0 = dither8(rz);
+            f0 = _mm256_add_ps(f0, d0);
+            f1 = _mm256_add_ps(f1, d0);
+
+            __m128i a0 = packSamples(f0);
+            __m128i a1 = packSamples(f1);
+
+            // interleave
+            _mm_storeu_si128((__m128i*)&output[2*i + 0], _mm_unpacklo_epi16(a0, a1));
+            _mm_storeu_si128((__m128i*)&output[2*i + 8], _mm_unpackhi_epi16(a0, a1));
+        }
+        for (; i < numFrames; i++) {
+            float d = _mm_cvtss_f32(_mm256_castps256_ps128(dither8(rz)));
+            output[2*i + 0] = packSample(inputs[0][i] * 32768.0f + d);
+            output[2*i + 1] = packSample(inputs[1][i] * 32768.0f + d);
+        }
+    }
+
+    _mm256_storeu_si256((__m256i*)ditherState, rz);
+}
+
+#endif
@@ -0,0 +1,37 @@
+//
+//  AudioSRC_avx2.h
+//  libraries/audio/src/avx2
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSRC_avx2_h
+#define hifi_AudioSRC_avx2_h
+
+#include <stdint.h>
+
+//
+// The AudioSRC kernels built for AVX2 and FMA, only call them once cpuSupportsAVX2() is known to be true.
+// The number of taps is a multiple of 4.
+//
+
+// one output of a phase of the filter
+void FIR_1x8_AVX2(const float* input0, float* output0, const float* c0, int numTaps);
+void FIR_2x8_AVX2(const float* input0, const float* input1, float* output0, float* output1,
+                  const float* c0, int numTaps);
+
+// one output of the filter interpolated between two phases
+void FIR_1x8_AVX2(const float* input0, float* output0, const float* c0, const float* c1, float frac, int numTaps);
+void FIR_2x8_AVX2(const float* input0, const float* input1, float* output0, float* output1,
+                  const float* c0, const float* c1, float frac, int numTaps);
+
+// int16_t to float, deinterleaving stereo
+void convertInputFromInt16_AVX2(const int16_t* input, float** outputs, int numFrames, int numChannels);
+
+// float to dithered int16_t, interleaving stereo
+void convertOutputToInt16_AVX2(float** inputs, int16_t* output, int numFrames, int numChannels);
+
+#endif // hifi_AudioSRC_avx2_h
@@ -0,0 +1,134 @@
+//
+//  AudioMixKernels_neon.cpp
+//  libraries/audio/src/neon
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(__arm__) || defined(__aarch64__)
+
+#include <arm_neon.h>
+
+#include "../AudioConstants.h"
+
+#include "AudioMixKernels_neon.h"
+
+static inline int16_t saturateSample(int32_t sample) {
+    return (int16_t)(sample < AudioConstants::MIN_SAMPLE_VALUE ? AudioConstants::MIN_SAMPLE_VALUE :
+        (sample > AudioConstants::MAX_SAMPLE_VALUE ? AudioConstants::MAX_SAMPLE_VALUE : sample));
+}
+
+// the conversion truncates toward zero, to match the (int) conversion of the scalar path
+static inline int32x4_t scaleSamples(int16x4_t samples, float32x4_t gain) {
+    return vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(vmovl_s16(samples)), gain));
+}
+
+void accumulate_NEON(int32_t* accumulator, const int16_t* input, int numSamples) {
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        int16x8_t samples = vld1q_s16(&input[i]);
+
+        // widening add
+        vst1q_s32(&accumulator[i + 0], vaddw_s16(vld1q_s32(&accumulator[i + 0]), vget_low_s16(samples)));
+        vst1q_s32(&accumulator[i + 4], vaddw_s16(vld1q_s32(&accumulator[i + 4]), vget_high_s16(samples)));
+    }
+
+    for (; i < numSamples; i++) {
+        accumulator[i] += input[i];
+    }
+}
+
+void accumulateWithGain_NEON(int32_t* accumulator, const int16_t* input, float gain, int numSamples) {
+    float32x4_t g = vdupq_n_f32(gain);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        int16x8_t samples = vld1q_s16(&input[i]);
+
+        int32x4_t lo = scaleSamples(vget_low_s16(samples), g);
+        int32x4_t hi = scaleSamples(vget_high_s16(samples), g);
+
+        vst1q_s32(&accumulator[i + 0], vaddq_s32(vld1q_s32(&accumulator[i + 0]), lo));
+        vst1q_s32(&accumulator[i + 4], vaddq_s32(vld1q_s32(&accumulator[i + 4]), hi));
+    }
+
+    for (; i < numSamples; i++) {
+        accumulator[i] += (int32_t)(input[i] * gain);
+    }
+}
+
+void accumulateMonoToStereo_NEON(int32_t* accumulator, const int16_t* input, float leftGain, float rightGain,
+                                 int numInputSamples) {
+    float32x4_t gL = vdupq_n_f32(leftGain);
+    float32x4_t gR = vdupq_n_f32(rightGain);
+    int i = 0;
+
+    for (; i + 4 <= numInputSamples; i += 4) {
+        int16x4_t samples = vld1_s16(&input[i]);
+
+        // the left/right pairs are deinterleaved by the load and interleaved back by the store
+        int32x4x2_t acc = vld2q_s32(&accumulator[2 * i]);
+        acc.val[0] = vaddq_s32(acc.val[0], scaleSamples(samples, gL));
+        acc.val[1] = vaddq_s32(acc.val[1], scaleSamples(samples, gR));
+        vst2q_s32(&accumulator[2 * i], acc);
+    }
+
+    for (; i < numInputSamples; i++) {
+        accumulator[2 * i] += (int32_t)(input[i] * leftGain);
+        accumulator[2 * i + 1] += (int32_t)(input[i] * rightGain);
+    }
+}
+
+void applyGain_NEON(int16_t* samples, float gain, int numSamples) {
+    float32x4_t g = vdupq_n_f32(gain);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        int16x8_t s = vld1q_s16(&samples[i]);
+
+        int32x4_t lo = scaleSamples(vget_low_s16(s), g);
+        int32x4_t hi = scaleSamples(vget_high_s16(s), g);
+
+        // the narrowing saturates to int16
+        vst1q_s16(&samples[i], vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+
+    for (; i < numSamples; i++) {
+        samples[i] = saturateSample((int32_t)(samples[i] * gain));
+    }
+}
+
+void applyGain_NEON(float* samples, float gain, int numSamples) {
+    float32x4_t g = vdupq_n_f32(gain);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        vst1q_f32(&samples[i + 0], vmulq_f32(vld1q_f32(&samples[i + 0]), g));
+        vst1q_f32(&samples[i + 4], vmulq_f32(vld1q_f32(&samples[i + 4]), g));
+    }
+
+    for (; i < numSamples; i++) {
+        samples[i] *= gain;
+    }
+}
+
+void saturate_NEON(const int32_t* input, int16_t* output, int numSamples) {
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        int16x4_t lo = vqmovn_s32(vld1q_s32(&input[i + 0]));
+        int16x4_t hi = vqmovn_s32(vld1q_s32(&input[i + 4]));
+
+        vst1q_s16(&output[i], vcombine_s16(lo, hi));
+    }
+
+    for (; i < numSamples; i++) {
+        output[i] = saturateSample(input[i]);
+    }
+}
+
+#endif
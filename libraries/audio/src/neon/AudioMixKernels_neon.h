@@ -0,0 +1,29 @@
+//
+//  AudioMixKernels_neon.h
+//  libraries/audio/src/neon
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernels_neon_h
+#define hifi_AudioMixKernels_neon_h
+
+#include <stdint.h>
+
+//
+// The AudioMixKernels built for NEON, only call them once cpuSupportsNEON() is known to be true.
+// They take the same arguments, and give the same results, as the scalar kernels.
+//
+
+void accumulate_NEON(int32_t* accumulator, const int16_t* input, int numSamples);
+void accumulateWithGain_NEON(int32_t* accumulator, const int16_t* input, float gain, int numSamples);
+void accumulateMonoToStereo_NEON(int32_t* accumulator, const int16_t* input, float leftGain, float rightGain,
+                                 int numInputSamples);
+void applyGain_NEON(int16_t* samples, float gain, int numSamples);
+void applyGain_NEON(float* samples, float gain, int numSamples);
+void saturate_NEON(const int32_t* input, int16_t* output, int numSamples);
+
+#endif // hifi_AudioMixKernels_neon_h
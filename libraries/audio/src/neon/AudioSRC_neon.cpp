@@ -0,0 +1,225 @@
+//
+//  AudioSRC_neon.cpp
+//  libraries/audio/src/neon
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(__arm__) || defined(__aarch64__)
+
+#include <algorithm>
+
+#include <arm_neon.h>
+
+#include "AudioSRC_neon.h"
+
+// horizontal sum
+static inline float sum4(float32x4_t acc) {
+    float32x2_t acc2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    acc2 = vpadd_f32(acc2, acc2);
+    return vget_lane_f32(acc2, 0);
+}
+
+void FIR_1x4_NEON(const float* input0, float* output0, const float* c0, int numTaps) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+
+    for (int j = 0; j < numTaps; j += 4) {
+
+        //float coef = c0[j];
+        float32x4_t coef0 = vld1q_f32(&c0[j]);
+
+        //acc0 += input0[j] * coef;
+        acc0 = vmlaq_f32(acc0, vld1q_f32(&input0[j]), coef0);
+    }
+
+    *output0 = sum4(acc0);
+}
+
+void FIR_1x4_NEON(const float* input0, float* output0, const float* c0, const float* c1, float frac, int numTaps) {
+    float32x4_t frac4 = vdupq_n_f32(frac);
+
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+
+    for (int j = 0; j < numTaps; j += 4) {
+
+        //float coef = c0[j] + frac * (c1[j] - c0[j]);
+        float32x4_t coef0 = vld1q_f32(&c0[j]);
+        float32x4_t coef1 = vld1q_f32(&c1[j]);
+        coef0 = vmlaq_f32(coef0, vsubq_f32(coef1, coef0), frac4);
+
+        //acc0 += input0[j] * coef;
+        acc0 = vmlaq_f32(acc0, vld1q_f32(&input0[j]), coef0);
+    }
+
+    *output0 = sum4(acc0);
+}
+
+void FIR_2x4_NEON(const float* input0, const float* input1, float* output0, float* output1,
+                  const float* c0, int numTaps) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+
+    for (int j = 0; j < numTaps; j += 4) {
+
+        //float coef = c0[j];
+        float32x4_t coef0 = vld1q_f32(&c0[j]);
+
+        //acc0 += input0[j] * coef;
+        acc0 = vmlaq_f32(acc0, vld1q_f32(&input0[j]), coef0);
+        acc1 = vmlaq_f32(acc1, vld1q_f32(&input1[j]), coef0);
+    }
+
+    *output0 = sum4(acc0);
+    *output1 = sum4(acc1);
+}
+
+void FIR_2x4_NEON(const float* input0, const float* input1, float* output0, float* output1,
+                  const float* c0, const float* c1, float frac, int numTaps) {
+    float32x4_t frac4 = vdupq_n_f32(frac);
+
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+
+    for (int j = 0; j < numTaps; j += 4) {
+
+        //float coef = c0[j] + frac * (c1[j] - c0[j]);
+        float32x4_t coef0 = vld1q_f32(&c0[j]);
+        float32x4_t coef1 = vld1q_f32(&c1[j]);
+        coef0 = vmlaq_f32(coef0, vsubq_f32(coef1, coef0), frac4);
+
+        //acc0 += input0[j] * coef;
+        acc0 = vmlaq_f32(acc0, vld1q_f32(&input0[j]), coef0);
+        acc1 = vmlaq_f32(acc1, vld1q_f32(&input1[j]), coef0);
+    }
+
+    *output0 = sum4(acc0);
+    *output1 = sum4(acc1);
+}
+
+void convertInputFromInt16_NEON(const int16_t* input, float** outputs, int numFrames, int numChannels) {
+    const float scale = 1/32768.0f;
+    float32x4_t scale4 = vdupq_n_f32(scale);
+
+    if (numChannels == 1) {
+
+        int i = 0;
+        for (; i < numFrames - 3; i += 4) {
+            // sign-extend
+            int32x4_t a0 = vmovl_s16(vld1_s16(&input[i]));
+
+            vst1q_f32(&outputs[0][i], vmulq_f32(vcvtq_f32_s32(a0), scale4));
+        }
+        for (; i < numFrames; i++) {
+            outputs[0][i] = (float)input[i] * scale;
+        }
+
+    } else if (numChannels == 2) {
+
+        int i = 0;
+        for (; i < numFrames - 3; i += 4) {
+            // deinterleave and sign-extend
+            int16x4x2_t a = vld2_s16(&input[2*i]);
+            int32x4_t a0 = vmovl_s16(a.val[0]);
+            int32x4_t a1 = vmovl_s16(a.val[1]);
+
+            vst1q_f32(&outputs[0][i], vmulq_f32(vcvtq_f32_s32(a0), scale4));
+            vst1q_f32(&outputs[1][i], vmulq_f32(vcvtq_f32_s32(a1), scale4));
+        }
+        for (; i < numFrames; i++) {
+            outputs[0][i] = (float)input[2*i + 0] * scale;
+            outputs[1][i] = (float)input[2*i + 1] * scale;
+        }
+    }
+}
+
+// fast TPDF dither in [-1.0f, 1.0f]
+static inline float dither() {
+    static uint32_t rz = 0;
+    rz = rz * 69069 + 1;
+    int32_t r0 = rz & 0xffff;
+    int32_t r1 = rz >> 16;
+    return (r0 - r1) * (1/65536.0f);
+}
+
+static inline float32x4_t dither4() {
+    float d[4] = { dither(), dither(), dither(), dither() };
+    return vld1q_f32(d);
+}
+
+// round half away from zero like the scalar version, the conversion truncates and the narrowing saturates
+static inline int16x4_t roundAndSaturate(float32x4_t f) {
+    uint32x4_t isNegative = vcltq_f32(f, vdupq_n_f32(0.0f));
+    f = vaddq_f32(f, vbslq_f32(isNegative, vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f)));
+    return vqmovn_s32(vcvtq_s32_f32(f));
+}
+
+void convertOutputToInt16_NEON(float** inputs, int16_t* output, int numFrames, int numChannels) {
+    const float scale = 32768.0f;
+    float32x4_t scale4 = vdupq_n_f32(scale);
+
+    if (numChannels == 1) {
+
+        int i = 0;
+        for (; i < numFrames - 3; i += 4) {
+            float32x4_t f0 = vmulq_f32(vld1q_f32(&inputs[0][i]), scale4);
+
+            f0 = vaddq_f32(f0, dither4());
+
+            vst1_s16(&output[i], roundAndSaturate(f0));
+        }
+        for (; i < numFrames; i++) {
+
+            float f = inputs[0][i] * scale;
+
+            f += dither();
+
+            // round and saturate
+            f += (f < 0.0f ? -0.5f : +0.5f);
+            f = std::max(std::min(f, 32767.0f), -32768.0f);
+
+            output[i] = (int16_t)f;
+        }
+
+    } else if (numChannels == 2) {
+
+        int i = 0;
+        for (; i < numFrames - 3; i += 4) {
+            float32x4_t f0 = vmulq_f32(vld1q_f32(&inputs[0][i]), scale4);
+            float32x4_t f1 = vmulq_f32(vld1q_f32(&inputs[1][i]), scale4);
+
+            float32x4_t d0 = dither4();
+            f0 = vaddq_f32(f0, d0);
+            f1 = vaddq_f32(f1, d0);
+
+            // interleave
+            int16x4x2_t a;
+            a.val[0] = roundAndSaturate(f0);
+            a.val[1] = roundAndSaturate(f1);
+            vst2_s16(&output[2*i], a);
+        }
+        for (; i < numFrames; i++) {
+
+            float f0 = inputs[0][i] * scale;
+            float f1 = inputs[1][i] * scale;
+
+            float d = dither();
+            f0 += d;
+            f1 += d;
+
+            // round and saturate
+            f0 += (f0 < 0.0f ? -0.5f : +0.5f);
+            f1 += (f1 < 0.0f ? -0.5f : +0.5f);
+            f0 = std::max(std::min(f0, 32767.0f), -32768.0f);
+            f1 = std::max(std::min(f1, 32767.0f), -32768.0f);
+
+            // interleave
+            output[2*i + 0] = (int16_t)f0;
+            output[2*i + 1] = (int16_t)f1;
+        }
+    }
+}
+
+#endif
@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <QtCore/QDataStream>
+#include <QtCore/QSet>
 #include <QtCore/QThread>
 #include <QtCore/QUuid>
 #include <QtCore/QJsonDocument>
@@ -35,6 +36,7 @@
 #include <shared/JSONHelpers.h>
 #include <recording/Deck.h>
 #include <recording/Clip.h>
+#include <recording/Frame.h>
 
 #include "AvatarLogging.h"
 
@@ -45,6 +47,9 @@ using namespace std;
 const glm::vec3 DEFAULT_LOCAL_AABOX_CORNER(-0.5f);
 const glm::vec3 DEFAULT_LOCAL_AABOX_SCALE(1.0f);
 
+// the frame type of recorded avatar states, the same as MyAvatar records them with
+static const QString AVATAR_FRAME_TYPE_NAME = QStringLiteral("com.highfidelity.recording.AvatarData");
+
 AvatarData::AvatarData() :
     _sessionUUID(),
     _position(0.0f),
@@ -198,6 +203,12 @@ void AvatarData::setHandPosition(const glm::vec3& handPosition) {
 }
 
 QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
+    return toByteArray(sendAll ? ALL_JOINTS_DATA : CHANGED_JOINTS_DATA, cullSmallChanges);
+}
+
+QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, bool cullSmallChanges) {
+    bool sendAll = (dataDetail == ALL_JOINTS_DATA);
+
     // TODO: DRY this up to a shared method
     // that can pack any type given the number of bytes
     // and return the number of bytes to push the pointer
@@ -287,6 +298,9 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
     // pupil dilation
     destinationBuffer += packFloatToByte(destinationBuffer, _headData->_pupilDilation, 1.0f);
 
+    // joint detail, lets the receiver tell joints that were left out from joints that did not change
+    *destinationBuffer++ = (unsigned char) dataDetail;
+
     // joint rotation data
     *destinationBuffer++ = _jointData.size();
     unsigned char* validityPosition = destinationBuffer;
@@ -302,7 +316,7 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
 
     for (int i=0; i < _jointData.size(); i++) {
         const JointData& data = _jointData.at(i);
-        if (sendAll || _lastSentJointData[i].rotation != data.rotation) {
+        if (isJointInDetail(i, dataDetail) && (sendAll || _lastSentJointData[i].rotation != data.rotation)) {
             if (sendAll ||
                 !cullSmallChanges ||
                 fabsf(glm::dot(data.rotation, _lastSentJointData[i].rotation)) <= AVATAR_MIN_ROTATION_DOT) {
@@ -350,7 +364,7 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
     float maxTranslationDimension = 0.0;
     for (int i=0; i < _jointData.size(); i++) {
         const JointData& data = _jointData.at(i);
-        if (sendAll || _lastSentJointData[i].translation != data.translation) {
+        if (isJointInDetail(i, dataDetail) && (sendAll || _lastSentJointData[i].translation != data.translation)) {
             if (sendAll ||
                 !cullSmallChanges ||
                 glm::distance(data.translation, _lastSentJointData[i].translation) > AVATAR_MIN_TRANSLATION) {
@@ -412,6 +426,134 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
     return avatarDataByteArray.left(destinationBuffer - startPosition);
 }
 
+bool AvatarData::isJointInDetail(int jointIndex, AvatarDataDetail dataDetail) const {
+    static const QSet<QString> ROOT_AND_HEAD_JOINT_NAMES = { "Hips", "Neck", "Head" };
+    static const QSet<QString> MAJOR_JOINT_NAMES = {
+        "Hips", "Spine", "Spine1", "Spine2", "Neck", "Head",
+        "LeftShoulder", "LeftArm", "LeftForeArm", "LeftHand",
+        "RightShoulder", "RightArm", "RightForeArm", "RightHand",
+        "LeftUpLeg", "LeftLeg", "LeftFoot", "RightUpLeg", "RightLeg", "RightFoot"
+    };
+
+    if (dataDetail == TRANSFORM_ONLY_DATA) {
+        return false;
+    } else if (dataDetail >= CHANGED_JOINTS_DATA) {
+        return true;
+    }
+
+    // the first joint is the root of the depth-first traversal
+    if (jointIndex == 0) {
+        return true;
+    }
+
+    if (jointIndex >= _jointNames.size()) {
+        // without the joint mappings there is no telling the major joints apart, so keep them all
+        return dataDetail == MAJOR_JOINTS_DATA;
+    }
+
+    const QString& jointName = _jointNames.at(jointIndex);
+    if (dataDetail == ROOT_AND_HEAD_JOINTS_DATA) {
+        return ROOT_AND_HEAD_JOINT_NAMES.contains(jointName);
+    } else {
+        return MAJOR_JOINT_NAMES.contains(jointName);
+    }
+}
+
+void AvatarData::interpolateHeldJoints(float deltaTime) {
+    // fraction of the remaining rotation covered per second
+    const float HELD_JOINT_CATCH_UP_RATE = 10.0f;
+    float alpha = glm::min(deltaTime * HELD_JOINT_CATCH_UP_RATE, 1.0f);
+
+    for (int i = 0; i < _interpolatingHeldJoints.size() && i < _jointData.size(); i++) {
+        if (!_interpolatingHeldJoints[i]) {
+            continue;
+        }
+
+        JointData& data = _jointData[i];
+        const glm::quat& target = _heldJointTargetRotations[i];
+
+        data.rotation = safeMix(data.rotation, target, alpha);
+        if (fabsf(glm::dot(data.rotation, target)) >= AVATAR_MIN_ROTATION_DOT) {
+            data.rotation = target;
+            _interpolatingHeldJoints[i] = false;
+        }
+        _hasNewJointRotations = true;
+    }
+}
+
+void AvatarData::recordSnapshot(quint64 now) {
+    Snapshot snapshot;
+    snapshot.timestamp = now;
+    snapshot.position = _position;
+    snapshot.orientation = glm::quat(glm::radians(glm::vec3(_bodyPitch, _bodyYaw, _bodyRoll)));
+    snapshot.jointData = _jointData;
+
+    // the joints easing in from being held are recorded with where they are going
+    for (int i = 0; i < _interpolatingHeldJoints.size() && i < snapshot.jointData.size(); i++) {
+        if (_interpolatingHeldJoints[i]) {
+            snapshot.jointData[i].rotation = _heldJointTargetRotations[i];
+        }
+    }
+
+    _snapshots.push_back(snapshot);
+    while ((int)_snapshots.size() > MAX_AVATAR_SNAPSHOTS) {
+        _snapshots.pop_front();
+    }
+}
+
+void AvatarData::playbackSnapshots(quint64 now) {
+    if (_snapshots.size() < 2) {
+        // until there are two poses to move between, the avatar is shown as it was last parsed
+        return;
+    }
+    quint64 playbackTime = now > AVATAR_SNAPSHOT_PLAYBACK_DELAY_USECS ? now - AVATAR_SNAPSHOT_PLAYBACK_DELAY_USECS : 0;
+
+    // the poses before the one being played back from are of no more use
+    while (_snapshots.size() > 2 && _snapshots[1].timestamp <= playbackTime) {
+        _snapshots.pop_front();
+    }
+    const Snapshot& previous = _snapshots[0];
+    const Snapshot& next = _snapshots[1];
+
+    // past the last pose this goes above one, which extrapolates the last two
+    float alpha = 0.0f;
+    if (playbackTime > previous.timestamp && next.timestamp > previous.timestamp) {
+        quint64 interval = next.timestamp - previous.timestamp;
+        quint64 elapsed = qMin(playbackTime - previous.timestamp, interval + AVATAR_SNAPSHOT_MAX_EXTRAPOLATION_USECS);
+        alpha = (float)elapsed / (float)interval;
+    } else if (playbackTime > previous.timestamp) {
+        alpha = 1.0f;
+    }
+
+    if (!_referential) {
+        _position = lerp(previous.position, next.position, alpha);
+        setOrientation(safeMix(previous.orientation, next.orientation, alpha));
+    }
+
+    int numJoints = qMin(_jointData.size(), qMin(previous.jointData.size(), next.jointData.size()));
+    for (int i = 0; i < numJoints; i++) {
+        const JointData& previousData = previous.jointData.at(i);
+        const JointData& nextData = next.jointData.at(i);
+        JointData& data = _jointData[i];
+
+        // joints easing in from being held carry on from where they are
+        if (previousData.rotationSet && nextData.rotationSet && !_interpolatingHeldJoints.value(i)) {
+            glm::quat rotation = safeMix(previousData.rotation, nextData.rotation, alpha);
+            if (rotation != data.rotation) {
+                data.rotation = rotation;
+                _hasNewJointRotations = true;
+            }
+        }
+        if (previousData.translationSet && nextData.translationSet) {
+            glm::vec3 translation = lerp(previousData.translation, nextData.translation, alpha);
+            if (translation != data.translation) {
+                data.translation = translation;
+                _hasNewJointTranslations = true;
+            }
+        }
+    }
+}
+
 void AvatarData::doneEncoding(bool cullSmallChanges) {
     // The server has finished sending this version of the joint-data to other nodes.  Update _lastSentJointData.
     _lastSentJointData.resize(_jointData.size());
@@ -473,9 +615,10 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     // }
     // + 1 byte for varying data
     // + 1 byte for pupilSize
+    // + 1 byte for joint detail
     // + 1 byte for numJoints (0)
-    // = 39 bytes
-    int minPossibleSize = 39;
+    // = 40 bytes
+    int minPossibleSize = 40;
 
     int maxAvailableSize = buffer.size();
     if (minPossibleSize > maxAvailableSize) {
@@ -658,6 +801,16 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         sourceBuffer += unpackFloatFromByte(sourceBuffer, _headData->_pupilDilation, 1.0f);
     } // 1 byte
 
+    // joint detail
+    int jointDataDetail = *sourceBuffer++;
+    if (jointDataDetail >= NUM_AVATAR_DATA_DETAILS) {
+        if (shouldLogError(now)) {
+            qCDebug(avatars) << "Malformed AvatarData packet, unknown joint detail" << jointDataDetail
+                << " displayName = '" << _displayName << "'";
+        }
+        return maxAvailableSize;
+    }
+
     // joint rotations
     int numJoints = *sourceBuffer++;
     int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
@@ -673,6 +826,9 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     }
     int numValidJointRotations = 0;
     _jointData.resize(numJoints);
+    _heldJoints.resize(numJoints);
+    _heldJointTargetRotations.resize(numJoints);
+    _interpolatingHeldJoints.resize(numJoints);
 
     QVector<bool> validRotations;
     validRotations.resize(numJoints);
@@ -711,8 +867,22 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
             JointData& data = _jointData[i];
             if (validRotations[i]) {
                 _hasNewJointRotations = true;
+
+                glm::quat rotation;
+                sourceBuffer += unpackOrientationQuatFromBytes(sourceBuffer, rotation);
+
+                if (_heldJoints[i] && data.rotationSet) {
+                    // this joint was left out of reduced detail packets, ease in to avoid a pop
+                    _heldJointTargetRotations[i] = rotation;
+                    _interpolatingHeldJoints[i] = true;
+                } else {
+                    data.rotation = rotation;
+                    _interpolatingHeldJoints[i] = false;
+                }
                 data.rotationSet = true;
-                sourceBuffer += unpackOrientationQuatFromBytes(sourceBuffer, data.rotation);
+                _heldJoints[i] = false;
+            } else if (!isJointInDetail(i, (AvatarDataDetail) jointDataDetail)) {
+                _heldJoints[i] = true;
             }
         }
     } // numJoints * 8 bytes
@@ -774,6 +944,10 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     }
     #endif
 
+    if (_isSnapshotPlaybackEnabled) {
+        recordSnapshot(now);
+    }
+
     int numBytesRead = sourceBuffer - startPosition;
     _averageBytesReceived.updateAverage(numBytesRead);
     return numBytesRead;
@@ -838,8 +1012,18 @@ void AvatarData::loadRecording(const QString& filename) {
         qWarning() << "Unable to load clip data from " << filename;
     }
 
+    // the clip drives this avatar rather than whichever one registered for avatar frames, and plays on the shared
+    // tick so that replaying many avatars costs one timer
+    FrameType avatarFrameType = Frame::registerFrameType(AVATAR_FRAME_TYPE_NAME);
     _player = std::make_shared<Deck>();
-    _player->queueClip(clip);
+    _player->setSharedTick(true);
+    _player->queueClip(clip, 0, [this, avatarFrameType](FrameConstPointer frame) {
+        if (frame->type == avatarFrameType) {
+            avatarStateFromFrame(frame->data, this);
+        } else {
+            Frame::handleFrame(frame);
+        }
+    });
 }
 
 void AvatarData::startPlaying() {
@@ -950,7 +1134,8 @@ void AvatarData::setJointData(int index, const glm::quat& rotation, const glm::v
         return;
     }
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setJointData", Q_ARG(int, index), Q_ARG(const glm::quat&, rotation));
+        queueJointRotation(index, rotation);
+        queueJointTranslation(index, translation);
         return;
     }
     if (_jointData.size() <= index) {
@@ -966,7 +1151,7 @@ void AvatarData::clearJointData(int index) {
         return;
     }
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "clearJointData", Q_ARG(int, index));
+        queueJointClear(index);
         return;
     }
     if (_jointData.size() <= index) {
@@ -1015,38 +1200,19 @@ glm::vec3 AvatarData::getJointTranslation(int index) const {
 }
 
 glm::vec3 AvatarData::getJointTranslation(const QString& name) const {
-    if (QThread::currentThread() != thread()) {
-        glm::vec3 result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this), "getJointTranslation", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(glm::vec3, result), Q_ARG(const QString&, name));
-        return result;
-    }
+    // the index and translation getters take care of being called from other threads
     return getJointTranslation(getJointIndex(name));
 }
 
 void AvatarData::setJointData(const QString& name, const glm::quat& rotation, const glm::vec3& translation) {
-    if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setJointData", Q_ARG(const QString&, name), Q_ARG(const glm::quat&, rotation),
-            Q_ARG(const glm::vec3&, translation));
-        return;
-    }
     setJointData(getJointIndex(name), rotation, translation);
 }
 
 void AvatarData::setJointRotation(const QString& name, const glm::quat& rotation) {
-    if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setJointRotation", Q_ARG(const QString&, name), Q_ARG(const glm::quat&, rotation));
-        return;
-    }
     setJointRotation(getJointIndex(name), rotation);
 }
 
 void AvatarData::setJointTranslation(const QString& name, const glm::vec3& translation) {
-    if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setJointTranslation", Q_ARG(const QString&, name),
-            Q_ARG(const glm::vec3&, translation));
-        return;
-    }
     setJointTranslation(getJointIndex(name), translation);
 }
 
@@ -1055,7 +1221,7 @@ void AvatarData::setJointRotation(int index, const glm::quat& rotation) {
         return;
     }
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setJointRotation", Q_ARG(int, index), Q_ARG(const glm::quat&, rotation));
+        queueJointRotation(index, rotation);
         return;
     }
     if (_jointData.size() <= index) {
@@ -1070,7 +1236,7 @@ void AvatarData::setJointTranslation(int index, const glm::vec3& translation) {
         return;
     }
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setJointTranslation", Q_ARG(int, index), Q_ARG(const glm::vec3&, translation));
+        queueJointTranslation(index, translation);
         return;
     }
     if (_jointData.size() <= index) {
@@ -1081,30 +1247,14 @@ void AvatarData::setJointTranslation(int index, const glm::vec3& translation) {
 }
 
 void AvatarData::clearJointData(const QString& name) {
-    if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "clearJointData", Q_ARG(const QString&, name));
-        return;
-    }
     clearJointData(getJointIndex(name));
 }
 
 bool AvatarData::isJointDataValid(const QString& name) const {
-    if (QThread::currentThread() != thread()) {
-        bool result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this), "isJointDataValid", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(bool, result), Q_ARG(const QString&, name));
-        return result;
-    }
     return isJointDataValid(getJointIndex(name));
 }
 
 glm::quat AvatarData::getJointRotation(const QString& name) const {
-    if (QThread::currentThread() != thread()) {
-        glm::quat result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this), "getJointRotation", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(glm::quat, result), Q_ARG(const QString&, name));
-        return result;
-    }
     return getJointRotation(getJointIndex(name));
 }
 
@@ -1125,10 +1275,10 @@ QVector<glm::quat> AvatarData::getJointRotations() const {
 
 void AvatarData::setJointRotations(QVector<glm::quat> jointRotations) {
     if (QThread::currentThread() != thread()) {
-        QVector<glm::quat> result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this),
-                                  "setJointRotations", Qt::BlockingQueuedConnection,
-                                  Q_ARG(QVector<glm::quat>, jointRotations));
+        for (int i = 0; i < jointRotations.size(); ++i) {
+            queueJointRotation(i, jointRotations[i]);
+        }
+        return;
     }
     if (_jointData.size() < jointRotations.size()) {
         _jointData.resize(jointRotations.size());
@@ -1142,10 +1292,10 @@ void AvatarData::setJointRotations(QVector<glm::quat> jointRotations) {
 
 void AvatarData::setJointTranslations(QVector<glm::vec3> jointTranslations) {
     if (QThread::currentThread() != thread()) {
-        QVector<glm::quat> result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this),
-                                  "setJointTranslations", Qt::BlockingQueuedConnection,
-                                  Q_ARG(QVector<glm::vec3>, jointTranslations));
+        for (int i = 0; i < jointTranslations.size(); ++i) {
+            queueJointTranslation(i, jointTranslations[i]);
+        }
+        return;
     }
 
     if (_jointData.size() < jointTranslations.size()) {
@@ -1158,6 +1308,70 @@ void AvatarData::setJointTranslations(QVector<glm::vec3> jointTranslations) {
     }
 }
 
+void AvatarData::queueJointRotation(int index, const glm::quat& rotation) {
+    bool isFirstChange;
+    {
+        QMutexLocker locker(&_queuedJointChangesMutex);
+        isFirstChange = _queuedJointChanges.isEmpty();
+        QueuedJointChange& change = _queuedJointChanges[index];
+        change.isRotationSet = true;
+        change.rotation = rotation;
+    }
+    if (isFirstChange) {
+        QMetaObject::invokeMethod(this, "applyQueuedJointChanges");
+    }
+}
+
+void AvatarData::queueJointTranslation(int index, const glm::vec3& translation) {
+    bool isFirstChange;
+    {
+        QMutexLocker locker(&_queuedJointChangesMutex);
+        isFirstChange = _queuedJointChanges.isEmpty();
+        QueuedJointChange& change = _queuedJointChanges[index];
+        change.isTranslationSet = true;
+        change.translation = translation;
+    }
+    if (isFirstChange) {
+        QMetaObject::invokeMethod(this, "applyQueuedJointChanges");
+    }
+}
+
+void AvatarData::queueJointClear(int index) {
+    bool isFirstChange;
+    {
+        QMutexLocker locker(&_queuedJointChangesMutex);
+        isFirstChange = _queuedJointChanges.isEmpty();
+        // the changes made before the clear are undone by it
+        QueuedJointChange& change = _queuedJointChanges[index];
+        change = QueuedJointChange();
+        change.isCleared = true;
+    }
+    if (isFirstChange) {
+        QMetaObject::invokeMethod(this, "applyQueuedJointChanges");
+    }
+}
+
+void AvatarData::applyQueuedJointChanges() {
+    QHash<int, QueuedJointChange> changes;
+    {
+        QMutexLocker locker(&_queuedJointChangesMutex);
+        changes.swap(_queuedJointChanges);
+    }
+    for (auto it = changes.constBegin(); it != changes.constEnd(); it++) {
+        const QueuedJointChange& change = it.value();
+        if (change.isCleared) {
+            clearJointData(it.key());
+        }
+        if (change.isRotationSet && change.isTranslationSet) {
+            setJointData(it.key(), change.rotation, change.translation);
+        } else if (change.isRotationSet) {
+            setJointRotation(it.key(), change.rotation);
+        } else if (change.isTranslationSet) {
+            setJointTranslation(it.key(), change.translation);
+        }
+    }
+}
+
 void AvatarData::clearJointsData() {
     for (int i = 0; i < _jointData.size(); ++i) {
         clearJointData(i);
@@ -12,6 +12,7 @@
 #ifndef hifi_AvatarData_h
 #define hifi_AvatarData_h
 
+#include <deque>
 #include <string>
 #include <memory>
 /* VS2010 defines stdint.h, but not inttypes.h */
@@ -36,6 +37,7 @@ typedef unsigned long long quint64;
 #include <QByteArray>
 #include <QElapsedTimer>
 #include <QHash>
+#include <QMutex>
 #include <QObject>
 #include <QRect>
 #include <QStringList>
@@ -119,6 +121,13 @@ const float AVATAR_SEND_FULL_UPDATE_RATIO = 0.02f;
 const float AVATAR_MIN_ROTATION_DOT = 0.9999999f;
 const float AVATAR_MIN_TRANSLATION = 0.0001f;
 
+// poses received from the avatar mixer are played back this late, so that there is usually a newer one to move towards
+const quint64 AVATAR_SNAPSHOT_PLAYBACK_DELAY_USECS = 100 * USECS_PER_MSEC;
+// once they stop arriving, the last two are extrapolated for this long before the avatar is held still
+const quint64 AVATAR_SNAPSHOT_MAX_EXTRAPOLATION_USECS = 100 * USECS_PER_MSEC;
+// the most poses kept for playback, in case it falls behind
+const int MAX_AVATAR_SNAPSHOTS = 64;
+
 
 // Where one's own Avatar begins in the world (will be overwritten if avatar data file is found).
 // This is the start location in the Sandbox (xyz: 6270, 211, 6000).
@@ -130,6 +139,16 @@ enum KeyState {
     DELETE_KEY_DOWN
 };
 
+// how much of the joint data toByteArray packs, from least to most
+enum AvatarDataDetail {
+    TRANSFORM_ONLY_DATA = 0, // body, head and face state, every joint is marked as unchanged
+    ROOT_AND_HEAD_JOINTS_DATA, // changed joints among the root, neck and head
+    MAJOR_JOINTS_DATA, // changed joints of the spine and limbs, no fingers or extra bones
+    CHANGED_JOINTS_DATA, // only the joints that changed since the last doneEncoding
+    ALL_JOINTS_DATA,
+    NUM_AVATAR_DATA_DETAILS
+};
+
 class QDataStream;
 
 class AttachmentData;
@@ -182,6 +201,17 @@ public:
     void setHandPosition(const glm::vec3& handPosition);
 
     virtual QByteArray toByteArray(bool cullSmallChanges, bool sendAll);
+    QByteArray toByteArray(AvatarDataDetail dataDetail, bool cullSmallChanges);
+
+    /// \return true if the joint is packed (when it changed) at the given detail
+    bool isJointInDetail(int jointIndex, AvatarDataDetail dataDetail) const;
+
+    /// eases joints that were held back by reduced detail packets towards the rotation they were finally sent with
+    void interpolateHeldJoints(float deltaTime);
+
+    /// plays the poses received from the avatar mixer back AVATAR_SNAPSHOT_PLAYBACK_DELAY_USECS after they arrived,
+    /// interpolating between them, or extrapolating the last two for a while once they stop arriving
+    void playbackSnapshots(quint64 now);
     virtual void doneEncoding(bool cullSmallChanges);
 
     /// \return true if an error should be logged
@@ -393,6 +423,23 @@ protected:
     QVector<JointData> _jointData; ///< the state of the skeleton joints
     QVector<JointData> _lastSentJointData; ///< the state of the skeleton joints last time we transmitted
 
+    // joints that reduced detail packets have left out, and the rotations of those that are easing back in
+    QVector<bool> _heldJoints;
+    QVector<glm::quat> _heldJointTargetRotations;
+    QVector<bool> _interpolatingHeldJoints;
+
+    // the poses parsed from the avatar mixer's packets, oldest first, as they were when they arrived
+    class Snapshot {
+    public:
+        quint64 timestamp; // usecs
+        glm::vec3 position;
+        glm::quat orientation;
+        QVector<JointData> jointData;
+    };
+    void recordSnapshot(quint64 now);
+    bool _isSnapshotPlaybackEnabled { false }; // set by the avatars that are rendered
+    std::deque<Snapshot> _snapshots;
+
     // key state
     KeyState _keyState;
 
@@ -435,12 +482,31 @@ protected:
     SimpleMovingAverage _averageBytesReceived;
 
     QMutex avatarLock; // Name is redundant, but it aids searches.
+
+    // the joint changes scripts make from their own threads are kept here, only the last change of each joint, and the
+    // avatar's thread applies them all at once rather than handling an event for each
+    void queueJointRotation(int index, const glm::quat& rotation);
+    void queueJointTranslation(int index, const glm::vec3& translation);
+    void queueJointClear(int index);
+    Q_INVOKABLE void applyQueuedJointChanges();
     
     // During recording, this holds the starting position, orientation & scale of the recorded avatar
     // During playback, it holds the 
     TransformPointer _recordingBasis;
 
 private:
+    class QueuedJointChange {
+    public:
+        bool isCleared { false }; // applied before the rotation and translation
+        bool isRotationSet { false };
+        bool isTranslationSet { false };
+        glm::quat rotation;
+        glm::vec3 translation;
+    };
+
+    QMutex _queuedJointChangesMutex;
+    QHash<int, QueuedJointChange> _queuedJointChanges;
+
     friend void avatarStateFromFrame(const QByteArray& frameData, AvatarData* _avatar);
     static QUrl _defaultFullAvatarModelUrl;
     // privatize the copy constructor and assignment operator so they cannot be called
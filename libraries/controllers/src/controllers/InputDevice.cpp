@@ -10,6 +10,11 @@
 //
 #include "InputDevice.h"
 
+#include <algorithm>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
 #include "Input.h"
 #include "impl/endpoints/InputEndpoint.h"
 
@@ -31,9 +36,39 @@ namespace controller {
         return InputDevice::_reticleMoveSpeed * RANGE_MULT + MIN_PIXEL_RANGE_MULT;
     }
 
+    // a pose is not predicted further than this, in case the polling thread stalled
+    const float MAX_POSE_PREDICTION = 0.05f; // seconds
+
+    void InputDevice::publishState() {
+        State& state = _publishedStates.getWriteBuffer();
+        state.buttons = _buttonPressedMap;
+        state.axes = _axisStateMap;
+        state.poses = _poseStateMap;
+        state.timestamp = usecTimestampNow();
+        _publishedStates.publish();
+    }
+
+    void InputDevice::sampleState() {
+        if (!_isPolled) {
+            return;
+        }
+        if (_publishedStates.fetch()) {
+            _sampledState = _publishedStates.getReadBuffer();
+        }
+
+        quint64 now = usecTimestampNow();
+        float predictionTime = now > _sampledState.timestamp ?
+            std::min((float)(now - _sampledState.timestamp) / USECS_PER_SECOND, MAX_POSE_PREDICTION) : 0.0f;
+        _predictedPoses.clear();
+        for (const auto& pose : _sampledState.poses) {
+            _predictedPoses[pose.first] = pose.second.extrapolate(predictionTime);
+        }
+    }
+
     float InputDevice::getButton(int channel) const {
-        if (!_buttonPressedMap.empty()) {
-            if (_buttonPressedMap.find(channel) != _buttonPressedMap.end()) {
+        const ButtonPressedMap& buttonPressedMap = _isPolled ? _sampledState.buttons : _buttonPressedMap;
+        if (!buttonPressedMap.empty()) {
+            if (buttonPressedMap.find(channel) != buttonPressedMap.end()) {
                 return 1.0f;
             } else {
                 return 0.0f;
@@ -43,8 +78,9 @@ namespace controller {
     }
 
     float InputDevice::getAxis(int channel) const {
-        auto axis = _axisStateMap.find(channel);
-        if (axis != _axisStateMap.end()) {
+        const AxisStateMap& axisStateMap = _isPolled ? _sampledState.axes : _axisStateMap;
+        auto axis = axisStateMap.find(channel);
+        if (axis != axisStateMap.end()) {
             return (*axis).second;
         } else {
             return 0.0f;
@@ -52,8 +88,9 @@ namespace controller {
     }
 
     Pose InputDevice::getPose(int channel) const {
-        auto pose = _poseStateMap.find(channel);
-        if (pose != _poseStateMap.end()) {
+        const PoseStateMap& poseStateMap = _isPolled ? _predictedPoses : _poseStateMap;
+        auto pose = poseStateMap.find(channel);
+        if (pose != poseStateMap.end()) {
             return (*pose).second;
         } else {
             return Pose();
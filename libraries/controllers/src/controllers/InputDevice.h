@@ -16,6 +16,8 @@
 
 #include <QtCore/QString>
 
+#include <TripleBuffer.h>
+
 #include "Pose.h"
 #include "Input.h"
 #include "StandardControls.h"
@@ -44,6 +46,14 @@ public:
     typedef std::map<int, float> AxisStateMap;
     typedef std::map<int, Pose> PoseStateMap;
 
+    // What a device polled on its own thread publishes after each poll
+    struct State {
+        ButtonPressedMap buttons;
+        AxisStateMap axes;
+        PoseStateMap poses;
+        quint64 timestamp { 0 }; // usecs, when the device was polled
+    };
+
     // Get current state for each channel
     float getButton(int channel) const;
     float getAxis(int channel) const;
@@ -61,6 +71,19 @@ public:
 
     virtual void focusOutEvent() = 0;
 
+    /// A polled device is updated on the polling thread of its plugin, which publishes its state after each update, and
+    /// is read from the state sampled last instead of from its maps.
+    bool isPolled() const { return _isPolled; }
+    void setPolled(bool polled) { _isPolled = polled; }
+
+    /// Called from the polling thread after the maps were updated
+    void publishState();
+
+    /// Called by the UserInputMapper before it runs the mappings, takes the state last published, with the poses
+    /// predicted from when the device was polled to now
+    void sampleState();
+    quint64 getSampledTimestamp() const { return _sampledState.timestamp; }
+
     int getDeviceID() { return _deviceID; }
     void setDeviceID(int deviceID) { _deviceID = deviceID; }
 
@@ -94,6 +117,11 @@ protected:
     AxisStateMap _axisStateMap;
     PoseStateMap _poseStateMap;
 
+    bool _isPolled { false };
+    TripleBuffer<State> _publishedStates;
+    State _sampledState;
+    PoseStateMap _predictedPoses;
+
     static bool _lowVelocityFilter;
 
 private:
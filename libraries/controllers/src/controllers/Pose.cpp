@@ -9,6 +9,7 @@
 #include <QtScript/QScriptEngine>
 #include <QtScript/QScriptValue>
 
+#include <NumericalConstants.h>
 #include <RegisteredMetaTypes.h>
 
 #include "Pose.h"
@@ -30,6 +31,20 @@ namespace controller {
             velocity == right.getVelocity() && angularVelocity == right.getAngularVelocity();
     }
 
+    Pose Pose::extrapolate(float deltaTime) const {
+        if (!valid) {
+            return *this;
+        }
+        Pose result(*this);
+        result.translation += velocity * deltaTime;
+        // the angular velocity turns by its angle every second
+        float angularSpeed = glm::angle(angularVelocity);
+        if (angularSpeed > EPSILON) {
+            result.rotation = glm::normalize(glm::angleAxis(angularSpeed * deltaTime, glm::axis(angularVelocity)) * rotation);
+        }
+        return result;
+    }
+
     QScriptValue Pose::toScriptValue(QScriptEngine* engine, const Pose& pose) {
         QScriptValue obj = engine->newObject();
         obj.setProperty("translation", vec3toScriptValue(engine, pose.translation));
@@ -40,6 +40,9 @@ namespace controller {
         vec3 getVelocity() const { return velocity; }
         quat getAngularVelocity() const { return angularVelocity; }
 
+        /// the pose deltaTime seconds later, if it keeps its velocities
+        Pose extrapolate(float deltaTime) const;
+
         static QScriptValue toScriptValue(QScriptEngine* engine, const Pose& event);
         static void fromScriptValue(const QScriptValue& object, Pose& event);
     };
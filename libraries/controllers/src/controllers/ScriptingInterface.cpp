@@ -10,6 +10,7 @@
 #include <mutex>
 #include <set>
 
+#include <QtCore/QMetaMethod>
 #include <QtCore/QRegularExpression>
 
 #include <QEventLoop>
@@ -44,8 +45,10 @@ static QVariantMap createDeviceMap(const controller::InputDevice::Pointer device
 controller::ScriptingInterface::ScriptingInterface() {
     auto userInputMapper = DependencyManager::get<UserInputMapper>();
 
-    connect(userInputMapper.data(), &UserInputMapper::actionEvent, this, &controller::ScriptingInterface::actionEvent);
-    connect(userInputMapper.data(), &UserInputMapper::inputEvent, this, &controller::ScriptingInterface::inputEvent);
+    // the changes are emitted together once the frame's snapshot is out, so that the scripts reading the values
+    // in their handlers see the whole frame
+    connect(userInputMapper.data(), &UserInputMapper::inputSnapshotPublished,
+        this, &controller::ScriptingInterface::emitInputChanges);
 
     // FIXME make this thread safe
     connect(userInputMapper.data(), &UserInputMapper::hardwareChanged, this, [=] {
@@ -84,8 +87,33 @@ namespace controller {
         userInputMapper->enableMapping(mappingName, enable);
     }
 
+    void ScriptingInterface::emitInputChanges() {
+        auto snapshot = DependencyManager::get<UserInputMapper>()->getInputSnapshot();
+        if (!snapshot) {
+            return;
+        }
+        // every emit is queued once for each script connected, so nothing is sent to signals no script listens to
+        if (isSignalConnected(QMetaMethod::fromSignal(&ScriptingInterface::actionEvent))) {
+            for (const auto& change : snapshot->actionChanges) {
+                emit actionEvent(change.first, change.second);
+            }
+        }
+        if (isSignalConnected(QMetaMethod::fromSignal(&ScriptingInterface::inputEvent))) {
+            for (const auto& change : snapshot->inputChanges) {
+                emit inputEvent(change.first, change.second);
+            }
+        }
+    }
+
     float ScriptingInterface::getValue(const int& source) const {
         auto userInputMapper = DependencyManager::get<UserInputMapper>();
+        auto snapshot = userInputMapper->getInputSnapshot();
+        if (snapshot) {
+            auto value = snapshot->inputValues.find((uint32_t)source);
+            if (value != snapshot->inputValues.end()) {
+                return value->second;
+            }
+        }
         return userInputMapper->getValue(Input((uint32_t)source));
     }
 
@@ -99,6 +127,13 @@ namespace controller {
 
     Pose ScriptingInterface::getPoseValue(const int& source) const {
         auto userInputMapper = DependencyManager::get<UserInputMapper>();
+        auto snapshot = userInputMapper->getInputSnapshot();
+        if (snapshot) {
+            auto pose = snapshot->inputPoses.find((uint32_t)source);
+            if (pose != snapshot->inputPoses.end()) {
+                return pose->second;
+            }
+        }
         return userInputMapper->getPose(Input((uint32_t)source)); 
     }
     
@@ -192,7 +227,12 @@ namespace controller {
     }
 
     float ScriptingInterface::getActionValue(int action) {
-        return DependencyManager::get<UserInputMapper>()->getActionState(Action(action));
+        auto userInputMapper = DependencyManager::get<UserInputMapper>();
+        auto snapshot = userInputMapper->getInputSnapshot();
+        if (snapshot && action >= 0 && action < (int)snapshot->actionStates.size()) {
+            return snapshot->actionStates[action];
+        }
+        return userInputMapper->getActionState(Action(action));
     }
 
     int ScriptingInterface::findAction(QString actionName) {
@@ -138,6 +138,9 @@ namespace controller {
         // Update the exposed variant maps reporting active hardware
         void updateMaps();
 
+        // emits the action and input changes of the last snapshot of the mapper
+        void emitInputChanges();
+
         QVariantMap _hardware;
         QVariantMap _actions;
         QVariantMap _standard;
@@ -8,6 +8,7 @@
 
 #include "UserInputMapper.h"
 
+#include <algorithm>
 #include <set>
 
 #include <QtCore/QThread>
@@ -26,6 +27,7 @@
 #include "Logging.h"
 
 #include "impl/conditionals/AndConditional.h"
+#include "impl/conditionals/ConstantConditional.h"
 #include "impl/conditionals/NotConditional.h"
 #include "impl/conditionals/EndpointConditional.h"
 #include "impl/conditionals/ScriptConditional.h"
@@ -235,6 +237,11 @@ void fixBisectedAxis(float& full, float& negative, float& positive) {
 
 void UserInputMapper::update(float deltaTime) {
     Locker locker(_lock);
+    // the devices polled on their own threads are read from the state they published last
+    for (const auto& device : _registeredDevices) {
+        device.second->sampleState();
+    }
+
     // Reset the axis state for next loop
     for (auto& channel : _actionStates) {
         channel = 0.0f;
@@ -255,16 +262,22 @@ void UserInputMapper::update(float deltaTime) {
     fixBisectedAxis(_actionStates[toInt(Action::ROTATE_Y)], _actionStates[toInt(Action::YAW_LEFT)], _actionStates[toInt(Action::YAW_RIGHT)]);
     fixBisectedAxis(_actionStates[toInt(Action::ROTATE_X)], _actionStates[toInt(Action::PITCH_UP)], _actionStates[toInt(Action::PITCH_DOWN)]);
 
+    auto snapshot = std::make_shared<InputSnapshot>();
+    snapshot->frame = ++_inputSnapshotFrame;
+
     static const float EPSILON = 0.01f;
     for (auto i = 0; i < toInt(Action::NUM_ACTIONS); i++) {
         _actionStates[i] *= _actionScales[i];
         // Emit only on change, and emit when moving back to 0
         if (fabsf(_actionStates[i] - _lastActionStates[i]) > EPSILON) {
             _lastActionStates[i] = _actionStates[i];
+            snapshot->actionChanges.push_back({ i, _actionStates[i] });
             emit actionEvent(i, _actionStates[i]);
         }
         // TODO: emit signal for pose changes
     }
+    snapshot->actionStates = _actionStates;
+    snapshot->poseStates = _poseStates;
 
     auto standardInputs = getStandardInputs();
     if ((int)_lastStandardStates.size() != standardInputs.size()) {
@@ -274,15 +287,24 @@ void UserInputMapper::update(float deltaTime) {
         }
     }
 
+    snapshot->inputValues.reserve(standardInputs.size());
     for (int i = 0; i < standardInputs.size(); ++i) {
         const auto& input = standardInputs[i].first;
+        if (input.isPose()) {
+            snapshot->inputPoses[input.id] = getPose(input);
+        }
         float value = getValue(input);
+        snapshot->inputValues[input.id] = value;
         float& oldValue = _lastStandardStates[i];
         if (value != oldValue) {
             oldValue = value;
+            snapshot->inputChanges.push_back({ (int)input.id, value });
             emit inputEvent(input.id, value);
         }
     }
+
+    std::atomic_store(&_inputSnapshot, InputSnapshot::Pointer(snapshot));
+    emit inputSnapshotPublished();
 }
 
 Input::NamedVector UserInputMapper::getAvailableInputs(uint16 deviceID) const {
@@ -444,12 +466,12 @@ void UserInputMapper::runMappings() {
         qCDebug(controllers) << "Processing device routes";
     }
     // Now process the current values for each level of the stack
-    applyRoutes(_deviceRoutes);
+    applyRoutes(_compiledDeviceRoutes);
 
     if (debugRoutes) {
         qCDebug(controllers) << "Processing standard routes";
     }
-    applyRoutes(_standardRoutes);
+    applyRoutes(_compiledStandardRoutes);
 
     if (debugRoutes) {
         qCDebug(controllers) << "Done with mappings";
@@ -457,57 +479,115 @@ void UserInputMapper::runMappings() {
     debugRoutes = false;
 }
 
-// Encapsulate the logic that routes should not be read before they are written
-void UserInputMapper::applyRoutes(const Route::List& routes) {
-    Route::List deferredRoutes;
-
+// The routes are compiled when a mapping is enabled or disabled, rather than worked out again each frame. A route that
+// reads a standard endpoint is ordered after the routes that write it, so that it never has to wait for it to be
+// written, the conditionals are folded, and the routes that could never apply are dropped.
+UserInputMapper::CompiledRouteList UserInputMapper::compileRouteList(const Route::List& routes) {
+    CompiledRouteList compiledRoutes;
     for (const auto& route : routes) {
-        if (!route) {
+        // THis could happen if the route destination failed to create
+        if (!route || !route->destination) {
             continue;
         }
+        CompiledRoute compiledRoute;
+        compiledRoute.route = route;
+        if (route->conditional) {
+            auto conditional = route->conditional->fold(route->conditional);
+            bool value;
+            if (!conditional->isConstant(value)) {
+                compiledRoute.conditional = conditional;
+            } else if (!value) {
+                continue;
+            }
+        }
+        auto& source = route->source;
+        compiledRoute.skipUnwrittenSource = source->getInput().device == STANDARD_DEVICE && !source->isPose() &&
+            route->filters.empty() && std::dynamic_pointer_cast<ActionEndpoint>(route->destination);
+        compiledRoutes.push_back(compiledRoute);
+    }
 
-        // Try all the deferred routes
-        deferredRoutes.remove_if([](Route::Pointer route) {
-            return UserInputMapper::applyRoute(route);
-        });
-
-        if (!applyRoute(route)) {
-            deferredRoutes.push_back(route);
+    auto writes = [](const CompiledRoute& writer, const Endpoint::Pointer& endpoint) {
+        const auto& destination = writer.route->destination;
+        if (destination == endpoint) {
+            return true;
+        }
+        auto array = std::dynamic_pointer_cast<ArrayEndpoint>(destination);
+        return array && std::find(array->_children.begin(), array->_children.end(), endpoint) != array->_children.end();
+    };
+    size_t count = compiledRoutes.size();
+    std::vector<std::vector<size_t>> readers(count);
+    std::vector<int> unappliedWriters(count, 0);
+    for (size_t reader = 0; reader < count; reader++) {
+        auto& source = compiledRoutes[reader].route->source;
+        if (source->getInput().device != STANDARD_DEVICE) {
+            continue;
+        }
+        for (size_t writer = 0; writer < count; writer++) {
+            if (writer != reader && writes(compiledRoutes[writer], source)) {
+                readers[writer].push_back(reader);
+                unappliedWriters[reader]++;
+            }
         }
     }
 
-    bool force = true;
-    for (const auto& route : deferredRoutes) {
-        UserInputMapper::applyRoute(route, force);
+    // each time the first route, in the order of the mappings, with all of its writers already ordered
+    std::set<size_t> ready;
+    for (size_t route = 0; route < count; route++) {
+        if (unappliedWriters[route] == 0) {
+            ready.insert(route);
+        }
     }
+    CompiledRouteList orderedRoutes;
+    orderedRoutes.reserve(count);
+    std::vector<bool> ordered(count, false);
+    while (orderedRoutes.size() < count) {
+        size_t next;
+        if (!ready.empty()) {
+            next = *ready.begin();
+            ready.erase(ready.begin());
+        } else {
+            // routes that read each other, the first of them goes first
+            next = std::find(ordered.begin(), ordered.end(), false) - ordered.begin();
+        }
+        ordered[next] = true;
+        orderedRoutes.push_back(compiledRoutes[next]);
+        for (auto reader : readers[next]) {
+            if (!ordered[reader] && --unappliedWriters[reader] == 0) {
+                ready.insert(reader);
+            }
+        }
+    }
+    return orderedRoutes;
 }
 
+void UserInputMapper::compileRoutes() {
+    _compiledDeviceRoutes = compileRouteList(_deviceRoutes);
+    _compiledStandardRoutes = compileRouteList(_standardRoutes);
+}
 
-bool UserInputMapper::applyRoute(const Route::Pointer& route, bool force) {
-    if (debugRoutes && route->debug) {
-        qCDebug(controllers) << "Applying route " << route->json;
+void UserInputMapper::applyRoutes(const CompiledRouteList& routes) {
+    for (const auto& route : routes) {
+        applyRoute(route);
     }
+}
 
-    // If the source hasn't been written yet, defer processing of this route
-    auto source = route->source;
-    auto sourceInput = source->getInput();
-    if (sourceInput.device == STANDARD_DEVICE && !force && source->writeable()) {
-        if (debugRoutes && route->debug) {
-            qCDebug(controllers) << "Source not yet written, deferring";
-        }
-        return false;
+void UserInputMapper::applyRoute(const CompiledRoute& compiledRoute) {
+    const auto& route = compiledRoute.route;
+    if (debugRoutes && route->debug) {
+        qCDebug(controllers) << "Applying route " << route->json;
     }
 
-    if (route->conditional) {
+    if (compiledRoute.conditional) {
         // FIXME for endpoint conditionals we need to check if they've been written
-        if (!route->conditional->satisfied()) {
+        if (!compiledRoute.conditional->satisfied()) {
             if (debugRoutes && route->debug) {
                 qCDebug(controllers) << "Conditional failed";
             }
-            return true;
+            return;
         }
     }
 
+    auto& source = route->source;
 
     // Most endpoints can only be read once (though a given mapping can route them to 
     // multiple places).  Consider... If the default is to wire the A button to JUMP
@@ -518,24 +598,25 @@ bool UserInputMapper::applyRoute(const Route::Pointer& route, bool force) {
         if (debugRoutes && route->debug) {
             qCDebug(controllers) << "Source unreadable";
         }
-        return true;
+        return;
     }
 
-    auto destination = route->destination;
-    // THis could happen if the route destination failed to create
-    // FIXME: Maybe do not create the route if the destination failed and avoid this case ?
-    if (!destination) {
+    auto& destination = route->destination;
+    if (!destination->writeable()) {
         if (debugRoutes && route->debug) {
-            qCDebug(controllers) << "Bad Destination";
+            qCDebug(controllers) << "Destination unwritable";
         }
-        return true;
+        return;
     }
 
-    if (!destination->writeable()) {
+    // A standard endpoint is only written when it is not zero, so an action would have nothing added to it, but the
+    // source still counts as read
+    if (compiledRoute.skipUnwrittenSource && source->writeable()) {
         if (debugRoutes && route->debug) {
-            qCDebug(controllers) << "Destination unwritable";
+            qCDebug(controllers) << "Source not written";
         }
-        return true;
+        getValue(source, route->peek);
+        return;
     }
 
     // Fetch the value, may have been overriden by previous loopback routes
@@ -571,7 +652,6 @@ bool UserInputMapper::applyRoute(const Route::Pointer& route, bool force) {
 
         destination->apply(value, source);
     }
-    return true;
 }
 
 Endpoint::Pointer UserInputMapper::endpointFor(const QJSValue& endpoint) {
@@ -799,6 +879,10 @@ Conditional::Pointer UserInputMapper::conditionalFor(const QScriptValue& conditi
         return std::make_shared<ScriptConditional>(condition);
     }
 
+    if (condition.isBool()) {
+        return std::make_shared<ConstantConditional>(condition.toBool());
+    }
+
     qWarning() << "Unsupported conditional type " << condition.toString();
     return Conditional::Pointer();
 }
@@ -852,6 +936,9 @@ Conditional::Pointer UserInputMapper::parseConditional(const QJsonValue& value)
 
         // Default and conditional behavior
         return conditional;
+    } else if (value.isBool()) {
+        // Support "when" : false, to turn a route off
+        return std::make_shared<ConstantConditional>(value.toBool());
     }
 
     return Conditional::parse(value);
@@ -1086,6 +1173,7 @@ void UserInputMapper::enableMapping(const Mapping::Pointer& mapping) {
     if (!debuggableRoutes) {
         debuggableRoutes = hasDebuggableRoute(_deviceRoutes) || hasDebuggableRoute(_standardRoutes);
     }
+    compileRoutes();
 }
 
 void UserInputMapper::disableMapping(const Mapping::Pointer& mapping) {
@@ -1102,6 +1190,7 @@ void UserInputMapper::disableMapping(const Mapping::Pointer& mapping) {
     if (debuggableRoutes) {
         debuggableRoutes = hasDebuggableRoute(_deviceRoutes) || hasDebuggableRoute(_standardRoutes);
     }
+    compileRoutes();
 }
 
 }
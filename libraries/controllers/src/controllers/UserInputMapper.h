@@ -12,10 +12,12 @@
 
 #include <glm/glm.hpp>
 
+#include <unordered_map>
 #include <unordered_set>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <QtQml/QJSValue>
 #include <QtScript/QScriptValue>
@@ -113,9 +115,29 @@ namespace controller {
         float getValue(const Input& input) const;
         Pose getPose(const Input& input) const;
 
+        // The actions and standard inputs as they were at the end of an update, with the ones that changed in it.
+        // A new one is published every frame, so that the threads reading the inputs, like the scripts, don't take the
+        // lock of the mapper and see the same frame in all their reads until they look at the next one.
+        struct InputSnapshot {
+            using Pointer = std::shared_ptr<const InputSnapshot>;
+            using Change = std::pair<int, float>;
+
+            quint64 frame { 0 };
+            std::vector<float> actionStates;
+            std::vector<Pose> poseStates;
+            std::unordered_map<uint32_t, float> inputValues; // by input id
+            std::unordered_map<uint32_t, Pose> inputPoses;
+            std::vector<Change> actionChanges;
+            std::vector<Change> inputChanges;
+        };
+
+        // null until the first update
+        InputSnapshot::Pointer getInputSnapshot() const { return std::atomic_load(&_inputSnapshot); }
+
     signals:
         void actionEvent(int action, float state);
         void inputEvent(int input, float state);
+        void inputSnapshotPublished();
         void hardwareChanged();
 
     protected:
@@ -129,6 +151,8 @@ namespace controller {
         std::vector<float> _lastActionStates = std::vector<float>(toInt(Action::NUM_ACTIONS), 0.0f);
         std::vector<Pose> _poseStates = std::vector<Pose>(toInt(Action::NUM_ACTIONS));
         std::vector<float> _lastStandardStates = std::vector<float>();
+        InputSnapshot::Pointer _inputSnapshot;
+        quint64 _inputSnapshotFrame { 0 };
 
         glm::mat4 _sensorToWorldMat;
 
@@ -143,8 +167,18 @@ namespace controller {
 
         void runMappings();
 
-        static void applyRoutes(const RouteList& route);
-        static bool applyRoute(const RoutePointer& route, bool force = false);
+        // A route as it is applied each frame, see compileRouteList
+        struct CompiledRoute {
+            RoutePointer route;
+            ConditionalPointer conditional; // folded, null when it always holds
+            bool skipUnwrittenSource { false }; // the zero of an unwritten standard source would not change the action
+        };
+        using CompiledRouteList = std::vector<CompiledRoute>;
+
+        void compileRoutes();
+        static CompiledRouteList compileRouteList(const RouteList& routes);
+        static void applyRoutes(const CompiledRouteList& routes);
+        static void applyRoute(const CompiledRoute& compiledRoute);
         void enableMapping(const MappingPointer& mapping);
         void disableMapping(const MappingPointer& mapping);
         EndpointPointer endpointFor(const QJSValue& endpoint);
@@ -176,6 +210,8 @@ namespace controller {
 
         RouteList _deviceRoutes;
         RouteList _standardRoutes;
+        CompiledRouteList _compiledDeviceRoutes;
+        CompiledRouteList _compiledStandardRoutes;
 
         using Locker = std::unique_lock<std::recursive_mutex>;
 
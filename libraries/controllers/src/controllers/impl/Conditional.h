@@ -33,6 +33,11 @@ namespace controller {
         virtual bool satisfied() = 0;
         virtual bool parseParameters(const QJsonValue& parameters) { return true; }
 
+        /// \return true if the conditional does not depend on any input, with what it always evaluates to
+        virtual bool isConstant(bool& value) const { return false; }
+        /// \return the conditional with its constant parts folded, when the mappings are compiled
+        virtual Pointer fold(const Pointer& self) { return self; }
+
         static Pointer parse(const QJsonValue& json);
         static void registerBuilder(const QString& name, Factory::Builder builder);
         static Factory& getFactory() { return _factory; }
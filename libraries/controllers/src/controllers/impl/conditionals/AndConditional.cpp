@@ -8,6 +8,8 @@
 
 #include "AndConditional.h"
 
+#include "ConstantConditional.h"
+
 using namespace controller;
 
 bool AndConditional::satisfied() {
@@ -19,3 +21,22 @@ bool AndConditional::satisfied() {
    return true;
 }
 
+Conditional::Pointer AndConditional::fold(const Conditional::Pointer& self) {
+    Conditional::List children;
+    for (auto& conditional : _children) {
+        auto child = conditional->fold(conditional);
+        bool value;
+        if (!child->isConstant(value)) {
+            children.push_back(child);
+        } else if (!value) {
+            return std::make_shared<ConstantConditional>(false);
+        }
+    }
+    if (children.empty()) {
+        return std::make_shared<ConstantConditional>(true);
+    }
+    if (children.size() == 1) {
+        return children.front();
+    }
+    return std::make_shared<AndConditional>(children);
+}
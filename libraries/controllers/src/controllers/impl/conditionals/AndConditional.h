@@ -21,6 +21,7 @@ public:
     AndConditional(Conditional::List children) : _children(children) { }
 
     virtual bool satisfied() override;
+    virtual Conditional::Pointer fold(const Conditional::Pointer& self) override;
 
 private:
     Conditional::List _children;
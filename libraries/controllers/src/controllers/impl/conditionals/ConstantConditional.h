@@ -0,0 +1,32 @@
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Controllers_ConstantConditional_h
+#define hifi_Controllers_ConstantConditional_h
+
+#include "../Conditional.h"
+
+namespace controller {
+
+// "when": true or false, and what the conditionals that do not depend on any input fold to
+class ConstantConditional : public Conditional {
+public:
+    using Pointer = std::shared_ptr<ConstantConditional>;
+
+    ConstantConditional(bool value) : _value(value) { }
+
+    virtual bool satisfied() override { return _value; }
+    virtual bool isConstant(bool& value) const override { value = _value; return true; }
+
+private:
+    const bool _value;
+};
+
+}
+
+#endif
@@ -9,6 +9,8 @@
 
 #include "NotConditional.h"
 
+#include "ConstantConditional.h"
+
 using namespace controller;
 
 bool NotConditional::satisfied() {
@@ -19,3 +21,14 @@ bool NotConditional::satisfied() {
     }
 }
 
+Conditional::Pointer NotConditional::fold(const Conditional::Pointer& self) {
+    if (!_operand) {
+        return std::make_shared<ConstantConditional>(false);
+    }
+    auto operand = _operand->fold(_operand);
+    bool value;
+    if (operand->isConstant(value)) {
+        return std::make_shared<ConstantConditional>(!value);
+    }
+    return operand == _operand ? self : std::make_shared<NotConditional>(operand);
+}
@@ -21,6 +21,7 @@ namespace controller {
         NotConditional(Conditional::Pointer operand) : _operand(operand) { }
 
         virtual bool satisfied() override;
+        virtual Conditional::Pointer fold(const Conditional::Pointer& self) override;
 
     private:
         Conditional::Pointer _operand;
@@ -26,6 +26,14 @@ const char* HTTPConnection::StatusCode401 = "401 Unauthorized";
 const char* HTTPConnection::StatusCode404 = "404 Not Found";
 const char* HTTPConnection::DefaultContentType = "text/plain; charset=ISO-8859-1";
 
+// a kept alive connection is closed once it has been idle this long, or has answered this many requests
+const int KEEP_ALIVE_IDLE_MSECS = 15 * 1000;
+const int MAX_KEEP_ALIVE_REQUESTS = 100;
+
+// a streamed response is read from its device this much at a time, while the socket has less than the most to write
+const qint64 RESPONSE_CHUNK_BYTES = 64 * 1024;
+const qint64 MAX_RESPONSE_BYTES_TO_WRITE = 256 * 1024;
+
 HTTPConnection::HTTPConnection (QTcpSocket* socket, HTTPManager* parentManager) :
     QObject(parentManager),
     _parentManager(parentManager),
@@ -40,6 +48,9 @@ HTTPConnection::HTTPConnection (QTcpSocket* socket, HTTPManager* parentManager)
     connect(socket, SIGNAL(readyRead()), SLOT(readRequest()));
     connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(deleteLater()));
     connect(socket, SIGNAL(disconnected()), SLOT(deleteLater()));
+
+    _idleTimer.setSingleShot(true);
+    connect(&_idleTimer, &QTimer::timeout, _socket, &QTcpSocket::disconnectFromHost);
 }
 
 HTTPConnection::~HTTPConnection() {
@@ -107,12 +118,51 @@ QList<FormData> HTTPConnection::parseFormData() const {
 }
 
 void HTTPConnection::respond(const char* code, const QByteArray& content, const char* contentType, const Headers& headers) {
+    // make sure we receive no further read notifications until the next request
+    _socket->disconnect(SIGNAL(readyRead()), this);
+
+    writeResponseHeaders(code, content.size(), contentType, headers);
+
+    if (content.size() > 0) {
+        _socket->write(content);
+    }
+
+    finishResponse();
+}
+
+void HTTPConnection::respond(const char* code, std::unique_ptr<QIODevice> device, const char* contentType,
+                             const Headers& headers) {
+    if (!device || !device->isReadable()) {
+        respond(code, QByteArray(), contentType, headers);
+        return;
+    }
+
+    // make sure we receive no further read notifications until the next request
+    _socket->disconnect(SIGNAL(readyRead()), this);
+
+    qint64 contentLength = device->isSequential() ? -1 : device->size() - device->pos();
+    _isResponseChunked = contentLength < 0 && _isRequestHTTP11;
+    writeResponseHeaders(code, contentLength, contentType, headers);
+
+    _responseDevice = std::move(device);
+    connect(_socket, &QIODevice::bytesWritten, this, &HTTPConnection::writeResponseContent);
+    connect(_responseDevice.get(), &QIODevice::readyRead, this, &HTTPConnection::writeResponseContent);
+
+    writeResponseContent();
+}
+
+void HTTPConnection::writeResponseHeaders(const char* code, qint64 contentLength, const char* contentType,
+                                          const Headers& headers) {
+    // HTTP/1.1 connections are kept alive unless the client asks otherwise, older ones only when it asks, and a
+    // response of unknown size to an older client ends when the connection does
+    QByteArray connection = _requestHeaders.value("Connection").toLower();
+    _isKeptAlive = (_isRequestHTTP11 ? !connection.contains("close") : connection.contains("keep-alive"))
+        && (contentLength >= 0 || _isResponseChunked) && _requestCount < MAX_KEEP_ALIVE_REQUESTS;
+
     _socket->write("HTTP/1.1 ");
     _socket->write(code);
     _socket->write("\r\n");
 
-    int csize = content.size();
-
     for (Headers::const_iterator it = headers.constBegin(), end = headers.constEnd();
             it != end; it++) {
         _socket->write(it.key());
@@ -120,31 +170,81 @@ void HTTPConnection::respond(const char* code, const QByteArray& content, const
         _socket->write(it.value());
         _socket->write("\r\n");
     }
-    if (csize > 0) {
+    if (contentLength >= 0) {
+        // an empty response has a length too, so that a client keeping the connection alive knows it is over
         _socket->write("Content-Length: ");
-        _socket->write(QByteArray::number(csize));
+        _socket->write(QByteArray::number(contentLength));
         _socket->write("\r\n");
-
+    } else if (_isResponseChunked) {
+        _socket->write("Transfer-Encoding: chunked\r\n");
+    }
+    if (contentLength != 0) {
         _socket->write("Content-Type: ");
         _socket->write(contentType);
         _socket->write("\r\n");
     }
-    _socket->write("Connection: close\r\n\r\n");
+    _socket->write(_isKeptAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
+}
 
-    if (csize > 0) {
-        _socket->write(content);
+void HTTPConnection::writeResponseContent() {
+    if (!_responseDevice) {
+        return;
     }
+    while (_socket->bytesToWrite() < MAX_RESPONSE_BYTES_TO_WRITE) {
+        QByteArray chunk = _responseDevice->read(RESPONSE_CHUNK_BYTES);
+        if (chunk.isEmpty()) {
+            // the device has no more data
+            if (_isResponseChunked) {
+                _socket->write("0\r\n\r\n");
+            }
+            _socket->disconnect(SIGNAL(bytesWritten(qint64)), this);
+            _responseDevice.reset();
+            _isResponseChunked = false;
 
-    // make sure we receive no further read notifications
-    _socket->disconnect(SIGNAL(readyRead()), this);
+            finishResponse();
+            return;
+        }
+        if (_isResponseChunked) {
+            _socket->write(QByteArray::number(chunk.size(), 16));
+            _socket->write("\r\n");
+            _socket->write(chunk);
+            _socket->write("\r\n");
+        } else {
+            _socket->write(chunk);
+        }
+    }
+}
+
+void HTTPConnection::finishResponse() {
+    if (_isKeptAlive) {
+        // the handler may still look at the request after it responds, so it is only cleared once it has returned
+        QMetaObject::invokeMethod(this, "startNextRequest", Qt::QueuedConnection);
+    } else {
+        _socket->disconnectFromHost();
+    }
+}
 
-    _socket->disconnectFromHost();
+void HTTPConnection::startNextRequest() {
+    _requestUrl.clear();
+    _requestHeaders.clear();
+    _lastRequestHeader.clear();
+    _requestContent.clear();
+    _isRequestHTTP11 = false;
+
+    connect(_socket, SIGNAL(readyRead()), SLOT(readRequest()));
+    _idleTimer.start(KEEP_ALIVE_IDLE_MSECS);
+
+    // the client may have sent the next request already
+    readRequest();
 }
 
 void HTTPConnection::readRequest() {
     if (!_socket->canReadLine()) {
         return;
     }
+    _idleTimer.stop();
+    _requestCount++;
+
     // parse out the method and resource
     QByteArray line = _socket->readLine().trimmed();
     if (line.startsWith("HEAD")) {
@@ -170,6 +270,9 @@ void HTTPConnection::readRequest() {
     int idx = line.indexOf(' ') + 1;
     _requestUrl.setUrl(line.mid(idx, line.lastIndexOf(' ') - idx));
 
+    QByteArray version = line.mid(line.lastIndexOf(' ') + 1);
+    _isRequestHTTP11 = version.startsWith("HTTP/") && version != "HTTP/1.0" && version != "HTTP/0.9";
+
     // switch to reading the header
     _socket->disconnect(this, SLOT(readRequest()));
     connect(_socket, SIGNAL(readyRead()), SLOT(readHeaders()));
@@ -206,6 +309,9 @@ void HTTPConnection::readHeaders() {
         int idx = trimmed.indexOf(':');
         if (idx == -1) {
             qWarning() << "Invalid header." << _address << trimmed;
+
+            // the rest of the request can't be told apart from the next one, so the connection isn't kept
+            _requestHeaders["Connection"] = "close";
             respond("400 Bad Request", "The header was malformed.");
             return;
         }
@@ -16,6 +16,8 @@
 #ifndef hifi_HTTPConnection_h
 #define hifi_HTTPConnection_h
 
+#include <memory>
+
 #include <QDataStream>
 #include <QHash>
 #include <QtNetwork/QHostAddress>
@@ -24,6 +26,7 @@
 #include <QtNetwork/QNetworkAccessManager>
 #include <QObject>
 #include <QPair>
+#include <QTimer>
 #include <QUrl>
 
 class QTcpSocket;
@@ -77,11 +80,17 @@ public:
     /// Parses the request content as form data, returning a list of header/content pairs.
     QList<FormData> parseFormData () const;
 
-    /// Sends a response and closes the connection.
+    /// Sends a response, then waits for the next request if the client keeps the connection alive or closes it.
     void respond (const char* code, const QByteArray& content = QByteArray(),
         const char* contentType = DefaultContentType,
         const Headers& headers = Headers());
 
+    /// Sends a response with the content of the device, which is read as the socket drains rather than all at once.
+    /// A device of unknown size is sent chunked to HTTP/1.1 clients. The connection takes ownership of the device.
+    void respond (const char* code, std::unique_ptr<QIODevice> device,
+        const char* contentType = DefaultContentType,
+        const Headers& headers = Headers());
+
 protected slots:
 
     /// Reads the request line.
@@ -93,8 +102,20 @@ protected slots:
     /// Reads the content.
     void readContent ();
 
+    /// Writes more of the response device once the socket has room for it.
+    void writeResponseContent ();
+
+    /// Clears the last request and reads the next one on a connection that is kept alive.
+    void startNextRequest ();
+
 protected:
 
+    /// Writes the status line and headers of a response, with the content length if it is known.
+    void writeResponseHeaders (const char* code, qint64 contentLength, const char* contentType, const Headers& headers);
+
+    /// Ends the response, closing the connection unless it is kept alive.
+    void finishResponse ();
+
     /// The parent HTTP manager
     HTTPManager* _parentManager;
 
@@ -121,6 +142,24 @@ protected:
 
     /// The content of the request.
     QByteArray _requestContent;
+
+    /// Whether the request was HTTP/1.1 or later, and so may keep the connection alive and take chunked responses.
+    bool _isRequestHTTP11 = false;
+
+    /// Whether the connection stays open for another request once the response is sent.
+    bool _isKeptAlive = false;
+
+    /// The requests answered on this connection.
+    int _requestCount = 0;
+
+    /// Closes a kept alive connection that has been idle for too long.
+    QTimer _idleTimer;
+
+    /// The device the content of the response is streamed from.
+    std::unique_ptr<QIODevice> _responseDevice;
+
+    /// Whether the response content is sent in chunks, because its size isn't known.
+    bool _isResponseChunked = false;
 };
 
 #endif // hifi_HTTPConnection_h
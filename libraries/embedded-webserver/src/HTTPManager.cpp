@@ -79,6 +79,9 @@ bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url,
             redirectHeader.insert(QByteArray("Location"), redirectLocation.toUtf8());
             
             connection->respond(HTTPConnection::StatusCode301, "", HTTPConnection::DefaultContentType, redirectHeader);
+            
+            // a kept alive connection would otherwise get the 404 below as the response to its next request
+            return true;
         }
         
         // if the last thing is a trailing slash then we want to look for index file
@@ -96,59 +99,21 @@ bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url,
         if (!filePath.isEmpty()) {
             // file exists, serve it
             static QMimeDatabase mimeDatabase;
+            QByteArray mimeType = mimeDatabase.mimeTypeForFile(filePath).name().toLocal8Bit();
             
-            QFile localFile(filePath);
-            localFile.open(QIODevice::ReadOnly);
-            QByteArray localFileData = localFile.readAll();
-            
-            QFileInfo localFileInfo(filePath);
-            
-            if (localFileInfo.completeSuffix() == "shtml") {
+            if (QFileInfo(filePath).completeSuffix() == "shtml") {
                 // this is a file that may have some SSI statements
-                // the only thing we support is the include directive, but check the contents for that
-                
-                // setup our static QRegExp that will catch <!--#include virtual ... --> and <!--#include file .. --> directives
-                const QString includeRegExpString = "<!--\\s*#include\\s+(virtual|file)\\s?=\\s?\"(\\S+)\"\\s*-->";
-                QRegExp includeRegExp(includeRegExpString);
-                
-                int matchPosition = 0;
-                
-                QString localFileString(localFileData);
-                
-                while ((matchPosition = includeRegExp.indexIn(localFileString, matchPosition)) != -1) {
-                    // check if this is a file or vitual include
-                    bool isFileInclude = includeRegExp.cap(1) == "file";
-                    
-                    // setup the correct file path for the included file
-                    QString includeFilePath = isFileInclude
-                    ? localFileInfo.canonicalPath() + "/" + includeRegExp.cap(2)
-                    : _documentRoot + includeRegExp.cap(2);
-                    
-                    QString replacementString;
-                    
-                    if (QFileInfo(includeFilePath).isFile()) {
-                        
-                        QFile includedFile(includeFilePath);
-                        includedFile.open(QIODevice::ReadOnly);
-                        
-                        replacementString = QString(includedFile.readAll());
-                    } else {
-                        qCDebug(embeddedwebserver) << "SSI include directive referenced a missing file:" << includeFilePath;
-                    }
-                    
-                    // replace the match with the contents of the file, or an empty string if the file was not found
-                    localFileString.replace(matchPosition, includeRegExp.matchedLength(), replacementString);
-                    
-                    // push the match position forward so we can check the next match
-                    matchPosition += includeRegExp.matchedLength();
+                connection->respond(HTTPConnection::StatusCode200, serverSideIncludedFile(filePath), mimeType.constData());
+            } else {
+                // plain files are streamed from disk as the connection takes them
+                std::unique_ptr<QFile> localFile(new QFile(filePath));
+                if (!localFile->open(QIODevice::ReadOnly)) {
+                    connection->respond(HTTPConnection::StatusCode404, "Resource not found.");
+                    return true;
                 }
-                
-                localFileData = localFileString.toLocal8Bit();
+                connection->respond(HTTPConnection::StatusCode200, std::move(localFile), mimeType.constData());
             }
             
-            connection->respond(HTTPConnection::StatusCode200, localFileData,
-                                qPrintable(mimeDatabase.mimeTypeForFile(filePath).name()));
-            
             return true;
         }
     }
@@ -159,6 +124,73 @@ bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url,
     return true;
 }
 
+const QByteArray& HTTPManager::serverSideIncludedFile(const QString& filePath) {
+    // the file is only processed again once it or one of the files it includes has changed
+    auto cached = _serverSideIncludes.find(filePath);
+    if (cached != _serverSideIncludes.end()) {
+        bool isCurrent = true;
+        for (auto it = cached->dependencies.constBegin(); isCurrent && it != cached->dependencies.constEnd(); ++it) {
+            isCurrent = QFileInfo(it.key()).lastModified() == it.value();
+        }
+        if (isCurrent) {
+            return cached->content;
+        }
+    }
+    
+    ServerSideInclude& include = _serverSideIncludes[filePath];
+    include.dependencies.clear();
+    
+    QFileInfo localFileInfo(filePath);
+    include.dependencies.insert(filePath, localFileInfo.lastModified());
+    
+    QFile localFile(filePath);
+    localFile.open(QIODevice::ReadOnly);
+    
+    // the only thing we support is the include directive, but check the contents for that
+    
+    // setup our static QRegExp that will catch <!--#include virtual ... --> and <!--#include file .. --> directives
+    const QString includeRegExpString = "<!--\\s*#include\\s+(virtual|file)\\s?=\\s?\"(\\S+)\"\\s*-->";
+    QRegExp includeRegExp(includeRegExpString);
+    
+    int matchPosition = 0;
+    
+    QString localFileString(localFile.readAll());
+    
+    while ((matchPosition = includeRegExp.indexIn(localFileString, matchPosition)) != -1) {
+        // check if this is a file or vitual include
+        bool isFileInclude = includeRegExp.cap(1) == "file";
+        
+        // setup the correct file path for the included file
+        QString includeFilePath = isFileInclude
+        ? localFileInfo.canonicalPath() + "/" + includeRegExp.cap(2)
+        : _documentRoot + includeRegExp.cap(2);
+        
+        QString replacementString;
+        
+        QFileInfo includeFileInfo(includeFilePath);
+        include.dependencies.insert(includeFilePath, includeFileInfo.lastModified());
+        
+        if (includeFileInfo.isFile()) {
+            
+            QFile includedFile(includeFilePath);
+            includedFile.open(QIODevice::ReadOnly);
+            
+            replacementString = QString(includedFile.readAll());
+        } else {
+            qCDebug(embeddedwebserver) << "SSI include directive referenced a missing file:" << includeFilePath;
+        }
+        
+        // replace the match with the contents of the file, or an empty string if the file was not found
+        localFileString.replace(matchPosition, includeRegExp.matchedLength(), replacementString);
+        
+        // push the match position forward so we can check the next match
+        matchPosition += includeRegExp.matchedLength();
+    }
+    
+    include.content = localFileString.toLocal8Bit();
+    return include.content;
+}
+
 bool HTTPManager::requestHandledByRequestHandler(HTTPConnection* connection, const QUrl& url) {
     return _requestHandler && _requestHandler->handleHTTPRequest(connection, url);
 }
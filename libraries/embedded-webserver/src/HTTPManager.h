@@ -17,6 +17,8 @@
 #define hifi_HTTPManager_h
 
 #include <QtNetwork/QTcpServer>
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
 #include <QtCore/QTimer>
 
 class HTTPConnection;
@@ -44,6 +46,15 @@ private slots:
 private:
     bool bindSocket();
     
+    /// Returns the file with its SSI include directives replaced by the files they include.
+    const QByteArray& serverSideIncludedFile(const QString& filePath);
+    
+    struct ServerSideInclude {
+        QByteArray content;
+        QHash<QString, QDateTime> dependencies; // the file and the ones it includes, with their modification times
+    };
+    QHash<QString, ServerSideInclude> _serverSideIncludes;
+    
 protected:
     /// Accepts all pending connections
     virtual void incomingConnection(qintptr socketDescriptor);
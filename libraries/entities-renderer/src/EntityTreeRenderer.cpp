@@ -80,6 +80,8 @@ EntityTreeRenderer::~EntityTreeRenderer() {
 void EntityTreeRenderer::clear() {
     leaveAllEntities();
     _entitiesScriptEngine->unloadAllEntityScripts();
+    _containmentEntities.clear();
+    _webSurfaceBudget.clear();
 
     auto scene = _viewState->getMain3DScene();
     render::PendingChanges pendingChanges;
@@ -96,7 +98,8 @@ void EntityTreeRenderer::reloadEntityScripts() {
     _entitiesScriptEngine->unloadAllEntityScripts();
     foreach(auto entity, _entitiesInScene) {
         if (!entity->getScript().isEmpty()) {
-            _entitiesScriptEngine->loadEntityScript(entity->getEntityItemID(), entity->getScript(), true);
+            float distance = glm::distance(entity->getPosition(), _viewState->getAvatarPosition());
+            _entitiesScriptEngine->loadEntityScript(entity->getEntityItemID(), entity->getScript(), true, distance);
         }
     }
 }
@@ -115,6 +118,11 @@ void EntityTreeRenderer::init() {
 
     forceRecheckEntities(); // setup our state to force checking our inside/outsideness of entities
 
+    if (_mousePickID == EntityRayPickManager::INVALID_PICK_ID) {
+        auto& rayPickManager = DependencyManager::get<EntityScriptingInterface>()->getRayPickManager();
+        _mousePickID = rayPickManager.addPick(EntityRayPickFilter()); // for mouse moves we do not do precision picking
+    }
+
     connect(entityTree.get(), &EntityTree::deletingEntity, this, &EntityTreeRenderer::deletingEntity, Qt::QueuedConnection);
     connect(entityTree.get(), &EntityTree::addingEntity, this, &EntityTreeRenderer::addingEntity, Qt::QueuedConnection);
     connect(entityTree.get(), &EntityTree::entityScriptChanging,
@@ -124,11 +132,16 @@ void EntityTreeRenderer::init() {
 void EntityTreeRenderer::shutdown() {
     _entitiesScriptEngine->disconnect(); // disconnect all slots/signals from the script engine
     _shuttingDown = true;
+
+    DependencyManager::get<EntityScriptingInterface>()->getRayPickManager().removePick(_mousePickID);
+    _mousePickID = EntityRayPickManager::INVALID_PICK_ID;
 }
 
 void EntityTreeRenderer::setTree(OctreePointer newTree) {
     OctreeRenderer::setTree(newTree);
     std::static_pointer_cast<EntityTree>(_tree)->setFBXService(this);
+    _containmentEntities.clear();
+    forceRecheckEntities();
 }
 
 void EntityTreeRenderer::update() {
@@ -139,6 +152,9 @@ void EntityTreeRenderer::update() {
         // check to see if the avatar has moved and if we need to handle enter/leave entity logic
         checkEnterLeaveEntities();
 
+        // the web views of the web entities that were not rendered last frame stop rendering
+        _webSurfaceBudget.update();
+
         // even if we haven't changed positions, if we previously attempted to set the skybox, but
         // have a pending download of the skybox texture, then we should attempt to reapply to 
         // get the correct texture.
@@ -146,6 +162,13 @@ void EntityTreeRenderer::update() {
             applyZonePropertiesToScene(_bestZone);
         }
 
+        // cast the picks of this frame together, the mouse moves since the last frame are handled with the result
+        auto& rayPickManager = DependencyManager::get<EntityScriptingInterface>()->getRayPickManager();
+        if (rayPickManager.update(tree) && _hasPendingMouseMove) {
+            _hasPendingMouseMove = false;
+            handleMouseMovePick(_pendingMouseMoveEvent);
+        }
+
         // Even if we're not moving the mouse, if we started clicking on an entity and we have
         // not yet released the hold then this is still considered a holdingClickOnEntity event
         // and we want to simulate this message here as well as in mouse move
@@ -158,26 +181,50 @@ void EntityTreeRenderer::update() {
     deleteReleasedModels();
 }
 
+// the avatar is tested against the candidates touching its cell, they are found again once it left the cell
+static const float CONTAINMENT_CELL_SIZE = 4.0f; // meters
+// and while it stays in the cell, for the entities that moved into it
+static const quint64 CONTAINMENT_CANDIDATES_REFRESH_USECS = USECS_PER_SECOND;
+
 void EntityTreeRenderer::checkEnterLeaveEntities() {
     if (_tree && !_shuttingDown) {
         glm::vec3 avatarPosition = _viewState->getAvatarPosition();
 
         if (avatarPosition != _lastAvatarPosition) {
-            float radius = 1.0f; // for now, assume 1 meter radius
-            QVector<EntityItemPointer> foundEntities;
+            glm::ivec3 cell = glm::ivec3(glm::floor(avatarPosition / CONTAINMENT_CELL_SIZE));
+            quint64 now = usecTimestampNow();
+            bool findCandidates = _containmentCandidatesDirty || cell != _containmentCell ||
+                now - _containmentCandidatesTime > CONTAINMENT_CANDIDATES_REFRESH_USECS;
+
+            // nothing in the cell can contain the avatar, it was not inside anything the last time either
+            if (!findCandidates && _containmentCandidates.isEmpty()) {
+                _lastAvatarPosition = avatarPosition;
+                return;
+            }
+
             QVector<EntityItemID> entitiesContainingAvatar;
             
-            // find the entities near us
             // don't let someone else change our tree while we search
             _tree->withReadLock([&] {
-                std::static_pointer_cast<EntityTree>(_tree)->findEntities(avatarPosition, radius, foundEntities);
+                if (findCandidates) {
+                    AABox cellBox(glm::vec3(cell) * CONTAINMENT_CELL_SIZE, CONTAINMENT_CELL_SIZE);
+                    _containmentCandidates.clear();
+                    foreach(const EntityItemPointer& entity, _containmentEntities) {
+                        if (entity->getAABox().touches(cellBox)) {
+                            _containmentCandidates << entity;
+                        }
+                    }
+                    _containmentCell = cell;
+                    _containmentCandidatesTime = now;
+                    _containmentCandidatesDirty = false;
+                }
 
                 // Whenever you're in an intersection between zones, we will always choose the smallest zone.
                 _bestZone = NULL; // NOTE: Is this what we want?
                 _bestZoneVolume = std::numeric_limits<float>::max();
 
                 // create a list of entities that actually contain the avatar's position
-                foreach(EntityItemPointer entity, foundEntities) {
+                foreach(const EntityItemPointer& entity, _containmentCandidates) {
                     if (entity->contains(avatarPosition)) {
                         entitiesContainingAvatar << entity->getEntityItemID();
 
@@ -251,6 +298,17 @@ void EntityTreeRenderer::forceRecheckEntities() {
     // make sure our "last avatar position" is something other than our current position, 
     // so that on our next chance, we'll check for enter/leave entity events.
     _lastAvatarPosition = _viewState->getAvatarPosition() + glm::vec3((float)TREE_SCALE);
+    _containmentCandidatesDirty = true;
+}
+
+void EntityTreeRenderer::updateContainmentEntity(const EntityItemID& entityID) {
+    EntityItemPointer entity = getTree()->findEntityByEntityItemID(entityID);
+    if (entity && (entity->getType() == EntityTypes::Zone || !entity->getScript().isEmpty())) {
+        _containmentEntities.insert(entityID, entity);
+    } else {
+        _containmentEntities.remove(entityID);
+    }
+    forceRecheckEntities();
 }
 
 
@@ -386,7 +444,7 @@ const FBXGeometry* EntityTreeRenderer::getCollisionGeometryForEntity(EntityItemP
     if (entityItem->getType() == EntityTypes::Model) {
         std::shared_ptr<RenderableModelEntityItem> modelEntityItem =
                                                         std::dynamic_pointer_cast<RenderableModelEntityItem>(entityItem);
-        if (modelEntityItem->hasCompoundShapeURL()) {
+        if (!modelEntityItem->getCollisionShapeURL().isEmpty()) {
             Model* model = modelEntityItem->getModel(this);
             if (model) {
                 const QSharedPointer<NetworkGeometry> collisionNetworkGeometry = model->getCollisionGeometry();
@@ -603,45 +661,57 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event, unsigned int deviceI
     }
     PerformanceTimer perfTimer("EntityTreeRenderer::mouseMoveEvent");
 
+    // the ray is cast with the other picks in update, which handles the last move of the frame once it has been
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
+    auto& rayPickManager = DependencyManager::get<EntityScriptingInterface>()->getRayPickManager();
+    rayPickManager.setRay(_mousePickID, ray.origin, ray.direction);
 
-    bool precisionPicking = false; // for mouse moves we do not do precision picking
-    RayToEntityIntersectionResult rayPickResult = findRayIntersectionWorker(ray, Octree::TryLock, precisionPicking);
-    if (rayPickResult.intersects) {
+    _pendingMouseMoveEvent = MouseEvent(*event, deviceID);
+    _hasPendingMouseMove = true;
+    _lastMouseEvent = MouseEvent(*event, deviceID);
+    _lastMouseEventValid = true;
+}
+
+void EntityTreeRenderer::handleMouseMovePick(const MouseEvent& event) {
+    EntityRayPick rayPick;
+    auto& rayPickManager = DependencyManager::get<EntityScriptingInterface>()->getRayPickManager();
+    bool intersects = rayPickManager.getResult(_mousePickID, rayPick) && rayPick.intersects && rayPick.entity;
+    if (intersects) {
+        EntityItemID entityID = rayPick.entity->getEntityItemID();
 
-        _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "mouseMoveEvent", MouseEvent(*event, deviceID));
-        _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "mouseMoveOnEntity", MouseEvent(*event, deviceID));
+        _entitiesScriptEngine->callEntityScriptMethod(entityID, "mouseMoveEvent", event);
+        _entitiesScriptEngine->callEntityScriptMethod(entityID, "mouseMoveOnEntity", event);
     
         // handle the hover logic...
     
         // if we were previously hovering over an entity, and this new entity is not the same as our previous entity
         // then we need to send the hover leave.
-        if (!_currentHoverOverEntityID.isInvalidID() && rayPickResult.entityID != _currentHoverOverEntityID) {
-            emit hoverLeaveEntity(_currentHoverOverEntityID, MouseEvent(*event, deviceID));
-            _entitiesScriptEngine->callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", MouseEvent(*event, deviceID));
+        if (!_currentHoverOverEntityID.isInvalidID() && entityID != _currentHoverOverEntityID) {
+            emit hoverLeaveEntity(_currentHoverOverEntityID, event);
+            _entitiesScriptEngine->callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", event);
         }
 
         // If the new hover entity does not match the previous hover entity then we are entering the new one
         // this is true if the _currentHoverOverEntityID is known or unknown
-        if (rayPickResult.entityID != _currentHoverOverEntityID) {
-            _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "hoverEnterEntity", MouseEvent(*event, deviceID));
+        if (entityID != _currentHoverOverEntityID) {
+            _entitiesScriptEngine->callEntityScriptMethod(entityID, "hoverEnterEntity", event);
         }
 
         // and finally, no matter what, if we're intersecting an entity then we're definitely hovering over it, and
         // we should send our hover over event
-        emit hoverOverEntity(rayPickResult.entityID, MouseEvent(*event, deviceID));
-        _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "hoverOverEntity", MouseEvent(*event, deviceID));
+        emit hoverOverEntity(entityID, event);
+        _entitiesScriptEngine->callEntityScriptMethod(entityID, "hoverOverEntity", event);
 
         // remember what we're hovering over
-        _currentHoverOverEntityID = rayPickResult.entityID;
+        _currentHoverOverEntityID = entityID;
 
     } else {
         // handle the hover logic...
         // if we were previously hovering over an entity, and we're no longer hovering over any entity then we need to
         // send the hover leave for our previous entity
         if (!_currentHoverOverEntityID.isInvalidID()) {
-            emit hoverLeaveEntity(_currentHoverOverEntityID, MouseEvent(*event, deviceID));
-            _entitiesScriptEngine->callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", MouseEvent(*event, deviceID));
+            emit hoverLeaveEntity(_currentHoverOverEntityID, event);
+            _entitiesScriptEngine->callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", event);
             _currentHoverOverEntityID = UNKNOWN_ENTITY_ID; // makes it the unknown ID
         }
     }
@@ -649,11 +719,9 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event, unsigned int deviceI
     // Even if we're no longer intersecting with an entity, if we started clicking on an entity and we have
     // not yet released the hold then this is still considered a holdingClickOnEntity event
     if (!_currentClickingOnEntityID.isInvalidID()) {
-        emit holdingClickOnEntity(_currentClickingOnEntityID, MouseEvent(*event, deviceID));
-        _entitiesScriptEngine->callEntityScriptMethod(_currentClickingOnEntityID, "holdingClickOnEntity", MouseEvent(*event, deviceID));
+        emit holdingClickOnEntity(_currentClickingOnEntityID, event);
+        _entitiesScriptEngine->callEntityScriptMethod(_currentClickingOnEntityID, "holdingClickOnEntity", event);
     }
-    _lastMouseEvent = MouseEvent(*event, deviceID);
-    _lastMouseEventValid = true;
 }
 
 void EntityTreeRenderer::deletingEntity(const EntityItemID& entityID) {
@@ -661,6 +729,7 @@ void EntityTreeRenderer::deletingEntity(const EntityItemID& entityID) {
         _entitiesScriptEngine->unloadEntityScript(entityID);
     }
 
+    _containmentEntities.remove(entityID);
     forceRecheckEntities(); // reset our state to force checking our inside/outsideness of entities
 
     // here's where we remove the entity payload from the scene
@@ -674,7 +743,7 @@ void EntityTreeRenderer::deletingEntity(const EntityItemID& entityID) {
 }
 
 void EntityTreeRenderer::addingEntity(const EntityItemID& entityID) {
-    forceRecheckEntities(); // reset our state to force checking our inside/outsideness of entities
+    updateContainmentEntity(entityID); // reset our state to force checking our inside/outsideness of entities
     checkAndCallPreload(entityID);
     auto entity = std::static_pointer_cast<EntityTree>(_tree)->findEntityByID(entityID);
     if (entity) {
@@ -697,6 +766,7 @@ void EntityTreeRenderer::entitySciptChanging(const EntityItemID& entityID, const
     if (_tree && !_shuttingDown) {
         _entitiesScriptEngine->unloadEntityScript(entityID);
         checkAndCallPreload(entityID, reload);
+        updateContainmentEntity(entityID);
     }
 }
 
@@ -706,7 +776,9 @@ void EntityTreeRenderer::checkAndCallPreload(const EntityItemID& entityID, const
         if (entity && !entity->getScript().isEmpty()) {
             QString scriptUrl = entity->getScript();
             scriptUrl = ResourceManager::normalizeURL(scriptUrl);
-            _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, reload);
+            // the scripts of the nearest entities are preloaded first
+            float distance = glm::distance(entity->getPosition(), _viewState->getAvatarPosition());
+            _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, reload, distance);
         }
     }
 }
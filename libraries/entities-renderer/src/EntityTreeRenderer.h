@@ -22,6 +22,8 @@
 #include <ScriptCache.h>
 #include <AbstractAudioInterface.h>
 
+#include "WebEntitySurfaceBudget.h"
+
 class AbstractScriptingServicesInterface;
 class AbstractViewStateInterface;
 class Model;
@@ -49,6 +51,8 @@ public:
 
     EntityTreePointer getTree() { return std::static_pointer_cast<EntityTree>(_tree); }
 
+    WebEntitySurfaceBudget& getWebSurfaceBudget() { return _webSurfaceBudget; }
+
     void processEraseMessage(NLPacket& packet, const SharedNodePointer& sourceNode);
 
     virtual void init();
@@ -132,6 +136,12 @@ private:
     RayToEntityIntersectionResult findRayIntersectionWorker(const PickRay& ray, Octree::lockType lockType,
                                                                 bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude = QVector<EntityItemID>());
 
+    void handleMouseMovePick(const MouseEvent& event);
+
+    EntityRayPickManager::PickID _mousePickID { EntityRayPickManager::INVALID_PICK_ID };
+    bool _hasPendingMouseMove { false };
+    MouseEvent _pendingMouseMoveEvent;
+
     EntityItemID _currentHoverOverEntityID;
     EntityItemID _currentClickingOnEntityID;
 
@@ -139,8 +149,17 @@ private:
     void checkEnterLeaveEntities();
     void leaveAllEntities();
     void forceRecheckEntities();
+    void updateContainmentEntity(const EntityItemID& entityID);
 
     glm::vec3 _lastAvatarPosition;
+
+    // the zones and the entities with a script, the only ones the avatar is tested against for enter/leave
+    QHash<EntityItemID, EntityItemPointer> _containmentEntities;
+    QVector<EntityItemPointer> _containmentCandidates; // the ones that touch the cell the avatar is in
+    glm::ivec3 _containmentCell;
+    quint64 _containmentCandidatesTime { 0 };
+    bool _containmentCandidatesDirty { true };
+
     bool _pendingSkyboxTextureDownload = false;
     QVector<EntityItemID> _currentEntitiesInside;
     
@@ -177,6 +196,7 @@ private:
     int _previousStageDay;
     
     QHash<EntityItemID, EntityItemPointer> _entitiesInScene;
+    WebEntitySurfaceBudget _webSurfaceBudget;
     // For Scene.shouldRenderEntities
     QList<EntityItemID> _entityIDsLastInScene;
 };
@@ -59,9 +59,9 @@ void RenderableBoxEntityItem::render(RenderArgs* args) {
         _procedural->prepare(batch, getPosition(), getDimensions());
         auto color = _procedural->getColor(cubeColor);
         batch._glColor4f(color.r, color.g, color.b, color.a);
-        DependencyManager::get<GeometryCache>()->renderCube(batch);
+        DependencyManager::getRaw<GeometryCache>()->renderCube(batch);
     } else {
-        DependencyManager::get<DeferredLightingEffect>()->renderSolidCubeInstance(batch, getTransformToCenter(), cubeColor);
+        DependencyManager::getRaw<DeferredLightingEffect>()->renderSolidCubeInstance(batch, getTransformToCenter(), cubeColor);
     }
 
     RenderableDebugableEntityItem::render(this, args);
@@ -29,7 +29,7 @@ void RenderableDebugableEntityItem::renderBoundingBox(EntityItem* entity, Render
         shapeTransform.postScale(1.0f + puffedOut);
     }
     batch.setModelTransform(Transform()); // we want to include the scale as well
-    DependencyManager::get<DeferredLightingEffect>()->renderWireCubeInstance(batch, shapeTransform, color);
+    DependencyManager::getRaw<DeferredLightingEffect>()->renderWireCubeInstance(batch, shapeTransform, color);
 }
 
 void RenderableDebugableEntityItem::render(EntityItem* entity, RenderArgs* args) {
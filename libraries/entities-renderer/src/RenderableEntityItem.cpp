@@ -21,6 +21,9 @@ namespace render {
             if (payload && payload->entity->getType() == EntityTypes::PolyLine) {
                 return ItemKey::Builder::transparentShape();
             }
+            if (payload->entity->isMoving()) {
+                return ItemKey::Builder().withTypeShape().withDynamic().build();
+            }
         }
         return ItemKey::Builder::opaqueShape();
     }
@@ -38,10 +38,10 @@ void RenderableLightEntityItem::render(RenderArgs* args) {
     float cutoff = glm::radians(getCutoff());
 
     if (_isSpotlight) {
-        DependencyManager::get<DeferredLightingEffect>()->addSpotLight(position, largestDiameter / 2.0f,
+        DependencyManager::getRaw<DeferredLightingEffect>()->addSpotLight(position, largestDiameter / 2.0f,
             color, intensity, rotation, exponent, cutoff);
     } else {
-        DependencyManager::get<DeferredLightingEffect>()->addPointLight(position, largestDiameter / 2.0f,
+        DependencyManager::getRaw<DeferredLightingEffect>()->addPointLight(position, largestDiameter / 2.0f,
             color, intensity);
     }
     
@@ -49,7 +49,7 @@ void RenderableLightEntityItem::render(RenderArgs* args) {
     Q_ASSERT(args->_batch);
     gpu::Batch& batch = *args->_batch;
     batch.setModelTransform(getTransformToCenter());
-    DependencyManager::get<DeferredLightingEffect>()->renderWireSphere(batch, 0.5f, 15, 15, glm::vec4(color, 1.0f));
+    DependencyManager::getRaw<DeferredLightingEffect>()->renderWireSphere(batch, 0.5f, 15, 15, glm::vec4(color, 1.0f));
 #endif
 };
 
@@ -24,7 +24,7 @@ EntityItemPointer RenderableLineEntityItem::factory(const EntityItemID& entityID
 }
 
 void RenderableLineEntityItem::updateGeometry() {
-    auto geometryCache = DependencyManager::get<GeometryCache>();
+    auto geometryCache = DependencyManager::getRaw<GeometryCache>();
     if (_lineVerticesID == GeometryCache::UNKNOWN_ID) {
         _lineVerticesID = geometryCache ->allocateID();
     }
@@ -51,8 +51,8 @@ void RenderableLineEntityItem::render(RenderArgs* args) {
     batch.setModelTransform(transform);
 
     if (getLinePoints().size() > 1) {
-        DependencyManager::get<DeferredLightingEffect>()->bindSimpleProgram(batch);
-        DependencyManager::get<GeometryCache>()->renderVertices(batch, gpu::LINE_STRIP, _lineVerticesID);
+        DependencyManager::getRaw<DeferredLightingEffect>()->bindSimpleProgram(batch);
+        DependencyManager::getRaw<GeometryCache>()->renderVertices(batch, gpu::LINE_STRIP, _lineVerticesID);
     }
 
     RenderableDebugableEntityItem::render(this, args);
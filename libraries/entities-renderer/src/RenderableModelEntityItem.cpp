@@ -160,6 +160,9 @@ public:
 
 namespace render {
     template <> const ItemKey payloadGetKey(const RenderableModelEntityItemMeta::Pointer& payload) { 
+        if (payload && payload->entity && payload->entity->isMoving()) {
+            return ItemKey::Builder().withTypeShape().withDynamic().build();
+        }
         return ItemKey::Builder::opaqueShape();
     }
     
@@ -298,6 +301,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
                 }
 
                 bool movingOrAnimating = isMoving() || isAnimatingSomething();
+                _model->setMoving(movingOrAnimating);
                 if ((movingOrAnimating ||
                      _needsInitialSimulation ||
                      _model->getTranslation() != getPosition() ||
@@ -352,10 +356,10 @@ Model* RenderableModelEntityItem::getModel(EntityTreeRenderer* renderer) {
         // if we have a previously allocated model, but its URL doesn't match
         // then we need to let our renderer update our model for us.
         if (_model && QUrl(getModelURL()) != _model->getURL()) {
-            result = _model = _myRenderer->updateModel(_model, getModelURL(), getCompoundShapeURL());
+            result = _model = _myRenderer->updateModel(_model, getModelURL(), getCollisionShapeURL());
             _needsInitialSimulation = true;
         } else if (!_model) { // if we don't yet have a model, then we want our renderer to allocate one
-            result = _model = _myRenderer->allocateModel(getModelURL(), getCompoundShapeURL());
+            result = _model = _myRenderer->allocateModel(getModelURL(), getCollisionShapeURL());
             _needsInitialSimulation = true;
         } else { // we already have the model we want...
             result = _model;
@@ -416,7 +420,7 @@ bool RenderableModelEntityItem::findDetailedRayIntersection(const glm::vec3& ori
 void RenderableModelEntityItem::setCompoundShapeURL(const QString& url) {
     ModelEntityItem::setCompoundShapeURL(url);
     if (_model) {
-        _model->setCollisionModelURL(QUrl(url));
+        _model->setCollisionModelURL(QUrl(getCollisionShapeURL()));
     }
 }
 
@@ -433,6 +437,8 @@ bool RenderableModelEntityItem::isReadyToComputeShape() {
             return false;
         }
 
+        // a compound shape type set after the model picks the hulls from the asset-server
+        _model->setCollisionModelURL(QUrl(getCollisionShapeURL()));
         assert(!_model->getCollisionURL().isEmpty());
     
         if (_model->getURL().isEmpty()) {
@@ -561,7 +567,7 @@ void RenderableModelEntityItem::computeShapeInfo(ShapeInfo& info) {
         }
 
         glm::vec3 collisionModelDimensions = box.getDimensions();
-        info.setParams(type, collisionModelDimensions, _compoundShapeURL);
+        info.setParams(type, collisionModelDimensions, getCollisionShapeURL());
         info.setConvexHulls(_points);
     }
 }
@@ -29,17 +29,16 @@ class ParticlePayload {
 public:
     typedef render::Payload<ParticlePayload> Payload;
     typedef Payload::DataPointer Pointer;
-    typedef RenderableParticleEffectEntityItem::Vertex Vertex;
+    typedef RenderableParticleEffectEntityItem::ParticleInstance ParticleInstance;
 
     ParticlePayload(EntityItemPointer entity) :
         _entity(entity),
-        _vertexFormat(std::make_shared<gpu::Stream::Format>()),
-        _vertexBuffer(std::make_shared<gpu::Buffer>()),
-        _indexBuffer(std::make_shared<gpu::Buffer>()) {
+        _instanceFormat(std::make_shared<gpu::Stream::Format>()),
+        _instanceBuffer(std::make_shared<gpu::Buffer>()) {
 
-        _vertexFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element::VEC3F_XYZ, 0);
-        _vertexFormat->setAttribute(gpu::Stream::TEXCOORD, 0, gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV), offsetof(Vertex, uv));
-        _vertexFormat->setAttribute(gpu::Stream::COLOR, 0, gpu::Element::COLOR_RGBA_32, offsetof(Vertex, rgba));
+        _instanceFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element::VEC4F_XYZW, 0, gpu::Stream::PER_INSTANCE);
+        _instanceFormat->setAttribute(gpu::Stream::COLOR, 0, gpu::Element::COLOR_RGBA_32,
+                                      offsetof(ParticleInstance, rgba), gpu::Stream::PER_INSTANCE);
     }
 
     void setPipeline(gpu::PipelinePointer pipeline) { _pipeline = pipeline; }
@@ -51,11 +50,8 @@ public:
     const AABox& getBound() const { return _bound; }
     void setBound(AABox& bound) { _bound = bound; }
 
-    gpu::BufferPointer getVertexBuffer() { return _vertexBuffer; }
-    const gpu::BufferPointer& getVertexBuffer() const { return _vertexBuffer; }
-
-    gpu::BufferPointer getIndexBuffer() { return _indexBuffer; }
-    const gpu::BufferPointer& getIndexBuffer() const { return _indexBuffer; }
+    gpu::BufferPointer getInstanceBuffer() { return _instanceBuffer; }
+    const gpu::BufferPointer& getInstanceBuffer() const { return _instanceBuffer; }
 
     void setTexture(gpu::TexturePointer texture) { _texture = texture; }
     const gpu::TexturePointer& getTexture() const { return _texture; }
@@ -74,12 +70,14 @@ public:
         }
 
         batch.setModelTransform(_modelTransform);
-        batch.setInputFormat(_vertexFormat);
-        batch.setInputBuffer(0, _vertexBuffer, 0, sizeof(Vertex));
-        batch.setIndexBuffer(gpu::UINT16, _indexBuffer, 0);
+        batch.setInputFormat(_instanceFormat);
+        batch.setInputBuffer(0, _instanceBuffer, 0, sizeof(ParticleInstance));
 
-        auto numIndices = _indexBuffer->getSize() / sizeof(uint16_t);
-        batch.drawIndexed(gpu::TRIANGLES, numIndices);
+        const uint32_t NUM_VERTICES_PER_PARTICLE = 4;
+        auto numParticles = (uint32_t)(_instanceBuffer->getSize() / sizeof(ParticleInstance));
+        if (numParticles > 0) {
+            batch.drawInstanced(numParticles, gpu::TRIANGLE_STRIP, NUM_VERTICES_PER_PARTICLE);
+        }
     }
 
 protected:
@@ -87,9 +85,8 @@ protected:
     Transform _modelTransform;
     AABox _bound;
     gpu::PipelinePointer _pipeline;
-    gpu::Stream::FormatPointer _vertexFormat;
-    gpu::BufferPointer _vertexBuffer;
-    gpu::BufferPointer _indexBuffer;
+    gpu::Stream::FormatPointer _instanceFormat;
+    gpu::BufferPointer _instanceBuffer;
     gpu::TexturePointer _texture;
     bool _visibleFlag = true;
 };
@@ -214,59 +211,25 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
 
 
 
-    // allocate vertices
-    _vertices.clear();
-
-    // build vertices from particle positions and radiuses
-    glm::vec3 dir = frustum->getDirection();
+    // the quads are built in the vertex shader, so each particle is uploaded once and faces the camera it's drawn for
+    _particleInstances.clear();
     for (auto&& particle : particleDetails) {
-        glm::vec3 right = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), dir));
-        glm::vec3 up = glm::normalize(glm::cross(right, dir));
-
-        glm::vec3 upOffset = up * particle.radius;
-        glm::vec3 rightOffset = right * particle.radius;
-        // generate corners of quad aligned to face the camera.
-        _vertices.emplace_back(particle.position + rightOffset + upOffset, glm::vec2(1.0f, 1.0f), particle.rgba);
-        _vertices.emplace_back(particle.position - rightOffset + upOffset, glm::vec2(0.0f, 1.0f), particle.rgba);
-        _vertices.emplace_back(particle.position - rightOffset - upOffset, glm::vec2(0.0f, 0.0f), particle.rgba);
-        _vertices.emplace_back(particle.position + rightOffset - upOffset, glm::vec2(1.0f, 0.0f), particle.rgba);
+        _particleInstances.emplace_back(particle.position, particle.radius, particle.rgba);
     }
 
     render::PendingChanges pendingChanges;
     pendingChanges.updateItem<ParticlePayload>(_renderItemId, [this](ParticlePayload& payload) {
-        // update vertex buffer
-        auto vertexBuffer = payload.getVertexBuffer();
-        size_t numBytes = sizeof(Vertex) * _vertices.size();
+        // update instance buffer
+        auto instanceBuffer = payload.getInstanceBuffer();
+        size_t numBytes = sizeof(ParticleInstance) * _particleInstances.size();
 
         if (numBytes == 0) {
-            vertexBuffer->resize(0);
-            auto indexBuffer = payload.getIndexBuffer();
-            indexBuffer->resize(0);
+            instanceBuffer->resize(0);
             return;
         }
 
-        vertexBuffer->resize(numBytes);
-        gpu::Byte* data = vertexBuffer->editData();
-        memcpy(data, &(_vertices[0]), numBytes);
-
-        // FIXME, don't update index buffer if num particles has not changed.
-        // update index buffer
-        auto indexBuffer = payload.getIndexBuffer();
-        const size_t NUM_VERTS_PER_PARTICLE = 4;
-        const size_t NUM_INDICES_PER_PARTICLE = 6;
-        auto numQuads = (_vertices.size() / NUM_VERTS_PER_PARTICLE);
-        numBytes = sizeof(uint16_t) * numQuads * NUM_INDICES_PER_PARTICLE;
-        indexBuffer->resize(numBytes);
-        data = indexBuffer->editData();
-        auto indexPtr = reinterpret_cast<uint16_t*>(data);
-        for (size_t i = 0; i < numQuads; ++i) {
-            indexPtr[i * NUM_INDICES_PER_PARTICLE + 0] = i * NUM_VERTS_PER_PARTICLE + 0;
-            indexPtr[i * NUM_INDICES_PER_PARTICLE + 1] = i * NUM_VERTS_PER_PARTICLE + 1;
-            indexPtr[i * NUM_INDICES_PER_PARTICLE + 2] = i * NUM_VERTS_PER_PARTICLE + 3;
-            indexPtr[i * NUM_INDICES_PER_PARTICLE + 3] = i * NUM_VERTS_PER_PARTICLE + 1;
-            indexPtr[i * NUM_INDICES_PER_PARTICLE + 4] = i * NUM_VERTS_PER_PARTICLE + 2;
-            indexPtr[i * NUM_INDICES_PER_PARTICLE + 5] = i * NUM_VERTS_PER_PARTICLE + 3;
-        }
+        instanceBuffer->resize(numBytes);
+        memcpy(instanceBuffer->editData(), &(_particleInstances[0]), numBytes);
 
         // update transform
         glm::quat rot = getRotation();
@@ -31,16 +31,16 @@ public:
 protected:
     render::ItemID _renderItemId;
 
-    struct Vertex {
-        Vertex(glm::vec3 xyzIn, glm::vec2 uvIn, uint32_t rgbaIn) : xyz(xyzIn), uv(uvIn), rgba(rgbaIn) {}
-        glm::vec3 xyz;
-        glm::vec2 uv;
+    // One per particle, the vertex shader expands each into a quad facing the camera
+    struct ParticleInstance {
+        ParticleInstance(glm::vec3 xyzIn, float radiusIn, uint32_t rgbaIn) : xyzr(xyzIn, radiusIn), rgba(rgbaIn) {}
+        glm::vec4 xyzr; // the position and the radius
         uint32_t rgba;
     };
 
     void createPipelines();
 
-    std::vector<Vertex> _vertices;
+    std::vector<ParticleInstance> _particleInstances;
     gpu::PipelinePointer _untexturedPipeline;
     gpu::PipelinePointer _texturedPipeline;
 
@@ -83,12 +83,18 @@ bool isEdged(PolyVoxEntityItem::PolyVoxSurfaceStyle surfaceStyle) {
 
 void RenderablePolyVoxEntityItem::setVoxelData(QByteArray voxelData) {
     _voxelDataLock.lockForWrite();
-    if (_voxelData == voxelData) {
+    if (isVoxelDataEdits(voxelData)) {
+        if (!applyVoxelDataEdits(_voxelData, voxelData)) {
+            qDebug() << "PolyVox edits don't apply to the volume, ignoring them" << getName() << getID();
+            _voxelDataLock.unlock();
+            return;
+        }
+    } else if (_voxelData == voxelData) {
         _voxelDataLock.unlock();
         return;
+    } else {
+        _voxelData = voxelData;
     }
-
-    _voxelData = voxelData;
     _voxelDataDirty = true;
     _voxelDataLock.unlock();
     decompressVolumeData();
@@ -116,7 +122,10 @@ void RenderablePolyVoxEntityItem::setVoxelSurfaceStyle(PolyVoxSurfaceStyle voxel
         setVoxelVolumeSize(_voxelVolumeSize);
         decompressVolumeData();
     } else {
+        _volDataLock.lockForWrite();
         _voxelSurfaceStyle = voxelSurfaceStyle;
+        markAllChunksDirty();
+        _volDataLock.unlock();
         getMesh();
     }
 }
@@ -646,6 +655,7 @@ void RenderablePolyVoxEntityItem::setVoxelVolumeSize(glm::vec3 voxelVolumeSize)
 
     // having the "outside of voxel-space" value be 255 has helped me notice some problems.
     _volData->setBorderValue(255);
+    resetChunks();
     _volDataLock.unlock();
     decompressVolumeData();
 }
@@ -699,17 +709,68 @@ bool RenderablePolyVoxEntityItem::setVoxelInternal(int x, int y, int z, uint8_t
         return result;
     }
 
+    uint8_t previousValue = getVoxelInternal(x, y, z);
     result = updateOnCount(x, y, z, toValue);
 
     if (isEdged(_voxelSurfaceStyle)) {
         _volData->setVoxelAt(x + 1, y + 1, z + 1, toValue);
+        if (toValue != previousValue) {
+            markChunksDirty(x + 1, y + 1, z + 1);
+        }
     } else {
         _volData->setVoxelAt(x, y, z, toValue);
+        if (toValue != previousValue) {
+            markChunksDirty(x, y, z);
+        }
     }
 
     return result;
 }
 
+void RenderablePolyVoxEntityItem::resetChunks() {
+    // called with _volDataLock held for writing, whenever _volData is replaced.  The chunks tile the cells between
+    // the voxels, so the last voxel along each axis is the upper corner of the last chunk.
+    _chunkCounts = glm::ivec3(std::max(1, (_volData->getWidth() - 1 + VOXEL_CHUNK_SIZE - 1) / VOXEL_CHUNK_SIZE),
+                              std::max(1, (_volData->getHeight() - 1 + VOXEL_CHUNK_SIZE - 1) / VOXEL_CHUNK_SIZE),
+                              std::max(1, (_volData->getDepth() - 1 + VOXEL_CHUNK_SIZE - 1) / VOXEL_CHUNK_SIZE));
+    _dirtyChunks.assign(_chunkCounts.x * _chunkCounts.y * _chunkCounts.z, true);
+}
+
+void RenderablePolyVoxEntityItem::markChunksDirty(int x, int y, int z) {
+    // x, y, z are in _volData coords.  The surface around a voxel, and the normals at it, reach into the cells
+    // next to its neighbors, so the chunks of those cells are extracted again too.
+    if (_dirtyChunks.empty()) {
+        return;
+    }
+    glm::ivec3 voxel(x, y, z);
+    glm::ivec3 low = glm::clamp((voxel - 2) / VOXEL_CHUNK_SIZE, glm::ivec3(0), _chunkCounts - 1);
+    glm::ivec3 high = glm::clamp((voxel + 1) / VOXEL_CHUNK_SIZE, glm::ivec3(0), _chunkCounts - 1);
+    for (int chunkZ = low.z; chunkZ <= high.z; chunkZ++) {
+        for (int chunkY = low.y; chunkY <= high.y; chunkY++) {
+            for (int chunkX = low.x; chunkX <= high.x; chunkX++) {
+                _dirtyChunks[(chunkZ * _chunkCounts.y + chunkY) * _chunkCounts.x + chunkX] = true;
+            }
+        }
+    }
+}
+
+void RenderablePolyVoxEntityItem::markAllChunksDirty() {
+    std::fill(_dirtyChunks.begin(), _dirtyChunks.end(), true);
+}
+
+PolyVox::Region RenderablePolyVoxEntityItem::getChunkRegion(int chunkIndex) const {
+    int chunkX = chunkIndex % _chunkCounts.x;
+    int chunkY = (chunkIndex / _chunkCounts.x) % _chunkCounts.y;
+    int chunkZ = chunkIndex / (_chunkCounts.x * _chunkCounts.y);
+
+    // neighboring chunks share the voxels on their faces, corners are inclusive
+    PolyVox::Vector3DInt32 lowCorner(chunkX * VOXEL_CHUNK_SIZE, chunkY * VOXEL_CHUNK_SIZE, chunkZ * VOXEL_CHUNK_SIZE);
+    PolyVox::Vector3DInt32 highCorner(std::min((chunkX + 1) * VOXEL_CHUNK_SIZE, _volData->getWidth() - 1),
+                                      std::min((chunkY + 1) * VOXEL_CHUNK_SIZE, _volData->getHeight() - 1),
+                                      std::min((chunkZ + 1) * VOXEL_CHUNK_SIZE, _volData->getDepth() - 1));
+    return PolyVox::Region(lowCorner, highCorner);
+}
+
 
 bool RenderablePolyVoxEntityItem::updateOnCount(int x, int y, int z, uint8_t toValue) {
     // keep _onCount up to date
@@ -824,13 +885,7 @@ void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacketAsync() {
     }
     _volDataLock.unlock();
 
-    QByteArray newVoxelData;
-    QDataStream writer(&newVoxelData, QIODevice::WriteOnly | QIODevice::Truncate);
-
-    writer << voxelXSize << voxelYSize << voxelZSize;
-
-    QByteArray compressedData = qCompress(uncompressedData, 9);
-    writer << compressedData;
+    QByteArray newVoxelData = packVoxelData(voxelXSize, voxelYSize, voxelZSize, uncompressedData);
 
     // make sure the compressed data can be sent over the wire-protocol
     if (newVoxelData.size() > 1150) {
@@ -847,12 +902,30 @@ void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacketAsync() {
     setLastBroadcast(now);
 
     _voxelDataLock.lockForWrite();
+    QByteArray oldVoxelData = _voxelData;
     _voxelDataDirty = true;
     _voxelData = newVoxelData;
     _voxelDataLock.unlock();
 
     EntityItemProperties properties = getProperties();
     properties.setVoxelDataDirty();
+
+    // send the voxels that changed since the last voxelData, and the whole volume every so often
+    quint16 oldXSize, oldYSize, oldZSize;
+    QByteArray oldUncompressedData;
+    if (_voxelEditsSinceSnapshot < VOXEL_EDITS_PER_SNAPSHOT &&
+        unpackVoxelData(oldVoxelData, oldXSize, oldYSize, oldZSize, oldUncompressedData) &&
+        oldXSize == voxelXSize && oldYSize == voxelYSize && oldZSize == voxelZSize) {
+        QByteArray edits = makeVoxelDataEdits(voxelXSize, voxelYSize, voxelZSize, oldUncompressedData, uncompressedData);
+        if (edits.size() < newVoxelData.size()) {
+            properties.setVoxelData(edits);
+            _voxelEditsSinceSnapshot++;
+        } else {
+            _voxelEditsSinceSnapshot = 0;
+        }
+    } else {
+        _voxelEditsSinceSnapshot = 0;
+    }
     properties.setLastEdited(now);
 
     EntityTreeElementPointer element = getElement();
@@ -861,7 +934,7 @@ void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacketAsync() {
     PhysicalEntitySimulation* peSimulation = static_cast<PhysicalEntitySimulation*>(simulation);
     EntityEditPacketSender* packetSender = peSimulation ? peSimulation->getPacketSender() : nullptr;
     if (packetSender) {
-        packetSender->queueEditEntityMessage(PacketType::EntityEdit, _id, properties);
+        packetSender->queueEditEntityMessage(PacketType::EntityEdit, _id, properties, getPosition());
     }
     _threadRunning.release();
 }
@@ -957,7 +1030,10 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int y = 0; y < _volData->getHeight(); y++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = polyVoxXPNeighbor->getVoxel(0, y, z);
-                    _volData->setVoxelAt(_volData->getWidth() - 1, y, z, neighborValue);
+                    if (_volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
+                        _volData->setVoxelAt(_volData->getWidth() - 1, y, z, neighborValue);
+                        markChunksDirty(_volData->getWidth() - 1, y, z);
+                    }
                 }
             }
         }
@@ -969,7 +1045,10 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = polyVoxYPNeighbor->getVoxel(x, 0, z);
-                    _volData->setVoxelAt(x, _volData->getWidth() - 1, z, neighborValue);
+                    if (_volData->getVoxelAt(x, _volData->getWidth() - 1, z) != neighborValue) {
+                        _volData->setVoxelAt(x, _volData->getWidth() - 1, z, neighborValue);
+                        markChunksDirty(x, _volData->getWidth() - 1, z);
+                    }
                 }
             }
         }
@@ -981,7 +1060,10 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int y = 0; y < _volData->getHeight(); y++) {
                     uint8_t neighborValue = polyVoxZPNeighbor->getVoxel(x, y, 0);
-                    _volData->setVoxelAt(x, y, _volData->getDepth() - 1, neighborValue);
+                    if (_volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
+                        _volData->setVoxelAt(x, y, _volData->getDepth() - 1, neighborValue);
+                        markChunksDirty(x, y, _volData->getDepth() - 1);
+                    }
                 }
             }
         }
@@ -993,9 +1075,6 @@ void RenderablePolyVoxEntityItem::getMeshAsync() {
 
     cacheNeighbors();
 
-    // A mesh object to hold the result of surface extraction
-    PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
-
     _volDataLock.lockForRead();
     if (!_volData) {
         _volDataLock.unlock();
@@ -1003,42 +1082,43 @@ void RenderablePolyVoxEntityItem::getMeshAsync() {
     }
     copyUpperEdgesFromNeighbors();
 
-    switch (_voxelSurfaceStyle) {
-        case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES: {
-            PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                (_volData, _volData->getEnclosingRegion(), &polyVoxMesh);
-            surfaceExtractor.execute();
-            break;
+    // only the chunks with changed voxels are extracted again, the rest keep their meshes
+    if (_chunks.size() != _dirtyChunks.size()) {
+        _chunks.clear();
+        _chunks.resize(_dirtyChunks.size());
+        markAllChunksDirty();
+    }
+    for (size_t i = 0; i < _chunks.size(); i++) {
+        if (_dirtyChunks[i]) {
+            _chunks[i].region = getChunkRegion((int)i);
+            extractChunkMesh(_chunks[i]);
+            _dirtyChunks[i] = false;
         }
-        case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
-            PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                (_volData, _volData->getEnclosingRegion(), &polyVoxMesh);
-            surfaceExtractor.execute();
-            break;
-        }
-        case PolyVoxEntityItem::SURFACE_EDGED_CUBIC: {
-            PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                (_volData, _volData->getEnclosingRegion(), &polyVoxMesh);
-            surfaceExtractor.execute();
-            break;
+    }
+
+    // convert the PolyVox meshes of the chunks to a Sam mesh
+    std::vector<uint32_t> vecIndices;
+    std::vector<PolyVox::PositionMaterialNormal> vecVertices;
+    for (auto& chunk : _chunks) {
+        uint32_t firstVertex = (uint32_t)vecVertices.size();
+        for (uint32_t index : chunk.mesh.getIndices()) {
+            vecIndices.push_back(firstVertex + index);
         }
-        case PolyVoxEntityItem::SURFACE_CUBIC: {
-            PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                (_volData, _volData->getEnclosingRegion(), &polyVoxMesh);
-            surfaceExtractor.execute();
-            break;
+        PolyVox::Vector3DFloat offset(chunk.region.getLowerCorner().getX(),
+                                      chunk.region.getLowerCorner().getY(),
+                                      chunk.region.getLowerCorner().getZ());
+        for (PolyVox::PositionMaterialNormal vertex : chunk.mesh.getVertices()) {
+            vertex.setPosition(vertex.getPosition() + offset);
+            vecVertices.push_back(vertex);
         }
     }
 
-    // convert PolyVox mesh to a Sam mesh
-    const std::vector<uint32_t>& vecIndices = polyVoxMesh.getIndices();
     auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
                                                      (gpu::Byte*)vecIndices.data());
     auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
     auto indexBufferView = new gpu::BufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::RAW));
     mesh->setIndexBuffer(*indexBufferView);
 
-    const std::vector<PolyVox::PositionMaterialNormal>& vecVertices = polyVoxMesh.getVertices();
     auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
                                                       (gpu::Byte*)vecVertices.data());
     auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
@@ -1067,37 +1147,55 @@ void RenderablePolyVoxEntityItem::getMeshAsync() {
     _threadRunning.release();
 }
 
+void RenderablePolyVoxEntityItem::extractChunkMesh(VoxelChunk& chunk) {
+    // called by getMeshAsync with _volDataLock held for reading
+    chunk.mesh.clear();
+    switch (_voxelSurfaceStyle) {
+        case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES:
+        case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
+            PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                (_volData, chunk.region, &chunk.mesh);
+            surfaceExtractor.execute();
+            break;
+        }
+        case PolyVoxEntityItem::SURFACE_EDGED_CUBIC:
+        case PolyVoxEntityItem::SURFACE_CUBIC: {
+            PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                (_volData, chunk.region, &chunk.mesh);
+            surfaceExtractor.execute();
+            break;
+        }
+    }
+    chunk.shapeDirty = true;
+}
+
 void RenderablePolyVoxEntityItem::computeShapeInfoWorker() {
     _threadRunning.acquire();
     QtConcurrent::run(this, &RenderablePolyVoxEntityItem::computeShapeInfoWorkerAsync);
 }
 
-
-void RenderablePolyVoxEntityItem::computeShapeInfoWorkerAsync() {
-    QVector<QVector<glm::vec3>> points;
-    AABox box;
-    glm::mat4 vtoM = voxelToLocalMatrix();
+void RenderablePolyVoxEntityItem::computeChunkHulls(VoxelChunk& chunk, const glm::mat4& vtoM) {
+    chunk.hulls.clear();
+    chunk.hullBox = AABox();
+    AABox& box = chunk.hullBox;
+    QVector<QVector<glm::vec3>>& points = chunk.hulls;
+    unsigned int i = 0;
 
     if (_voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
         _voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES) {
-        // pull each triangle in the mesh into a polyhedron which can be collided with
-        unsigned int i = 0;
-
-        _meshLock.lockForRead();
-        model::MeshPointer mesh = _mesh;
-        const gpu::BufferView vertexBufferView = mesh->getVertexBuffer();
-        const gpu::BufferView& indexBufferView = mesh->getIndexBuffer();
-        _meshLock.unlock();
-
-        gpu::BufferView::Iterator<const uint32_t> it = indexBufferView.cbegin<uint32_t>();
-        while (it != indexBufferView.cend<uint32_t>()) {
-            uint32_t p0Index = *(it++);
-            uint32_t p1Index = *(it++);
-            uint32_t p2Index = *(it++);
-
-            const glm::vec3& p0 = vertexBufferView.get<const glm::vec3>(p0Index);
-            const glm::vec3& p1 = vertexBufferView.get<const glm::vec3>(p1Index);
-            const glm::vec3& p2 = vertexBufferView.get<const glm::vec3>(p2Index);
+        // pull each triangle in the chunk's mesh into a polyhedron which can be collided with
+        glm::vec3 offset(chunk.region.getLowerCorner().getX(),
+                         chunk.region.getLowerCorner().getY(),
+                         chunk.region.getLowerCorner().getZ());
+        const std::vector<uint32_t>& indices = chunk.mesh.getIndices();
+        const std::vector<PolyVox::PositionMaterialNormal>& vertices = chunk.mesh.getVertices();
+        for (size_t index = 0; index + 2 < indices.size(); index += 3) {
+            const PolyVox::Vector3DFloat& v0 = vertices[indices[index]].getPosition();
+            const PolyVox::Vector3DFloat& v1 = vertices[indices[index + 1]].getPosition();
+            const PolyVox::Vector3DFloat& v2 = vertices[indices[index + 2]].getPosition();
+            glm::vec3 p0 = offset + glm::vec3(v0.getX(), v0.getY(), v0.getZ());
+            glm::vec3 p1 = offset + glm::vec3(v1.getX(), v1.getY(), v1.getZ());
+            glm::vec3 p2 = offset + glm::vec3(v2.getX(), v2.getY(), v2.getZ());
 
             glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
             glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
@@ -1124,78 +1222,102 @@ void RenderablePolyVoxEntityItem::computeShapeInfoWorkerAsync() {
             // add points to the new convex hull
             points[i++] << pointsInPart;
         }
-    } else {
-        unsigned int i = 0;
+        return;
+    }
 
-        _volDataLock.lockForRead();
-        if (!_volData) {
-            _volDataLock.unlock();
-            return;
-        }
+    // called with _volDataLock held for reading, the voxels whose cells start in the chunk are the chunk's
+    int edgeOffset = isEdged(_voxelSurfaceStyle) ? 1 : 0;
+    int xLow = std::max(chunk.region.getLowerCorner().getX() - edgeOffset, 0);
+    int yLow = std::max(chunk.region.getLowerCorner().getY() - edgeOffset, 0);
+    int zLow = std::max(chunk.region.getLowerCorner().getZ() - edgeOffset, 0);
+    int xHigh = std::min(chunk.region.getUpperCorner().getX() - edgeOffset, (int)_voxelVolumeSize.x);
+    int yHigh = std::min(chunk.region.getUpperCorner().getY() - edgeOffset, (int)_voxelVolumeSize.y);
+    int zHigh = std::min(chunk.region.getUpperCorner().getZ() - edgeOffset, (int)_voxelVolumeSize.z);
+    for (int z = zLow; z < zHigh; z++) {
+        for (int y = yLow; y < yHigh; y++) {
+            for (int x = xLow; x < xHigh; x++) {
+                if (getVoxelInternal(x, y, z) > 0) {
+
+                    if ((x > 0 && getVoxel(x - 1, y, z) > 0) &&
+                        (y > 0 && getVoxel(x, y - 1, z) > 0) &&
+                        (z > 0 && getVoxel(x, y, z - 1) > 0) &&
+                        (x < _voxelVolumeSize.x - 1 && getVoxel(x + 1, y, z) > 0) &&
+                        (y < _voxelVolumeSize.y - 1 && getVoxel(x, y + 1, z) > 0) &&
+                        (z < _voxelVolumeSize.z - 1 && getVoxel(x, y, z + 1) > 0)) {
+                        // this voxel has neighbors in every cardinal direction, so there's no need
+                        // to include it in the collision hull.
+                        continue;
+                    }
 
-        for (int z = 0; z < _voxelVolumeSize.z; z++) {
-            for (int y = 0; y < _voxelVolumeSize.y; y++) {
-                for (int x = 0; x < _voxelVolumeSize.x; x++) {
-                    if (getVoxelInternal(x, y, z) > 0) {
-
-                        if ((x > 0 && getVoxel(x - 1, y, z) > 0) &&
-                            (y > 0 && getVoxel(x, y - 1, z) > 0) &&
-                            (z > 0 && getVoxel(x, y, z - 1) > 0) &&
-                            (x < _voxelVolumeSize.x - 1 && getVoxel(x + 1, y, z) > 0) &&
-                            (y < _voxelVolumeSize.y - 1 && getVoxel(x, y + 1, z) > 0) &&
-                            (z < _voxelVolumeSize.z - 1 && getVoxel(x, y, z + 1) > 0)) {
-                            // this voxel has neighbors in every cardinal direction, so there's no need
-                            // to include it in the collision hull.
-                            continue;
-                        }
-
-                        QVector<glm::vec3> pointsInPart;
-
-                        float offL = -0.5f;
-                        float offH = 0.5f;
-                        if (_voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
-                            offL += 1.0f;
-                            offH += 1.0f;
-                        }
-
-                        glm::vec3 p000 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offL, 1.0f));
-                        glm::vec3 p001 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offH, 1.0f));
-                        glm::vec3 p010 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offL, 1.0f));
-                        glm::vec3 p011 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offH, 1.0f));
-                        glm::vec3 p100 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offL, 1.0f));
-                        glm::vec3 p101 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offH, 1.0f));
-                        glm::vec3 p110 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offL, 1.0f));
-                        glm::vec3 p111 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offH, 1.0f));
-
-                        box += p000;
-                        box += p001;
-                        box += p010;
-                        box += p011;
-                        box += p100;
-                        box += p101;
-                        box += p110;
-                        box += p111;
-
-                        pointsInPart << p000;
-                        pointsInPart << p001;
-                        pointsInPart << p010;
-                        pointsInPart << p011;
-                        pointsInPart << p100;
-                        pointsInPart << p101;
-                        pointsInPart << p110;
-                        pointsInPart << p111;
-
-                        // add next convex hull
-                        QVector<glm::vec3> newMeshPoints;
-                        points << newMeshPoints;
-                        // add points to the new convex hull
-                        points[i++] << pointsInPart;
+                    QVector<glm::vec3> pointsInPart;
+
+                    float offL = -0.5f;
+                    float offH = 0.5f;
+                    if (_voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
+                        offL += 1.0f;
+                        offH += 1.0f;
                     }
+
+                    glm::vec3 p000 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offL, 1.0f));
+                    glm::vec3 p001 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offH, 1.0f));
+                    glm::vec3 p010 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offL, 1.0f));
+                    glm::vec3 p011 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offH, 1.0f));
+                    glm::vec3 p100 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offL, 1.0f));
+                    glm::vec3 p101 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offH, 1.0f));
+                    glm::vec3 p110 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offL, 1.0f));
+                    glm::vec3 p111 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offH, 1.0f));
+
+                    box += p000;
+                    box += p001;
+                    box += p010;
+                    box += p011;
+                    box += p100;
+                    box += p101;
+                    box += p110;
+                    box += p111;
+
+                    pointsInPart << p000;
+                    pointsInPart << p001;
+                    pointsInPart << p010;
+                    pointsInPart << p011;
+                    pointsInPart << p100;
+                    pointsInPart << p101;
+                    pointsInPart << p110;
+                    pointsInPart << p111;
+
+                    // add next convex hull
+                    QVector<glm::vec3> newMeshPoints;
+                    points << newMeshPoints;
+                    // add points to the new convex hull
+                    points[i++] << pointsInPart;
                 }
             }
         }
+    }
+}
+
+void RenderablePolyVoxEntityItem::computeShapeInfoWorkerAsync() {
+    QVector<QVector<glm::vec3>> points;
+    AABox box;
+    glm::mat4 vtoM = voxelToLocalMatrix();
+
+    _volDataLock.lockForRead();
+    if (!_volData) {
         _volDataLock.unlock();
+        _threadRunning.release();
+        return;
+    }
+
+    // only the chunks that were extracted again since the last shape get new hulls
+    for (auto& chunk : _chunks) {
+        if (chunk.shapeDirty) {
+            computeChunkHulls(chunk, vtoM);
+            chunk.shapeDirty = false;
+        }
+        points += chunk.hulls;
+        box += chunk.hullBox;
     }
+    _volDataLock.unlock();
 
     if (points.isEmpty()) {
         _shapeInfoLock.lockForWrite();
@@ -16,6 +16,7 @@
 #include <atomic>
 
 #include <PolyVoxCore/SimpleVolume.h>
+#include <PolyVoxCore/SurfaceMesh.h>
 #include <PolyVoxCore/Raycast.h>
 
 #include <TextureCache.h>
@@ -142,6 +143,27 @@ private:
     bool _volDataDirty = false; // does getMesh need to be called?
     int _onCount; // how many non-zero voxels are in _volData
 
+    // The volume is meshed and its collision hulls are made in chunks of this many voxels along each axis, so that
+    // changing a few voxels only extracts the chunks around them again.
+    static const int VOXEL_CHUNK_SIZE = 16;
+    struct VoxelChunk {
+        PolyVox::Region region; // in _volData coords
+        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> mesh; // relative to the region's lower corner
+        QVector<QVector<glm::vec3>> hulls; // in local coords
+        AABox hullBox;
+        bool shapeDirty { true };
+    };
+    glm::ivec3 _chunkCounts; // guarded by _volDataLock, as is _dirtyChunks
+    std::vector<bool> _dirtyChunks; // which chunks getMeshAsync needs to extract again
+    std::vector<VoxelChunk> _chunks; // only used by the workers, which _threadRunning keeps to one at a time
+
+    void resetChunks();
+    void markChunksDirty(int x, int y, int z);
+    void markAllChunksDirty();
+    PolyVox::Region getChunkRegion(int chunkIndex) const;
+    void extractChunkMesh(VoxelChunk& chunk);
+    void computeChunkHulls(VoxelChunk& chunk, const glm::mat4& vtoM);
+
     bool inUserBounds(const PolyVox::SimpleVolume<uint8_t>* vol, PolyVoxEntityItem::PolyVoxSurfaceStyle surfaceStyle,
                       int x, int y, int z) const;
     uint8_t getVoxelInternal(int x, int y, int z);
@@ -161,6 +183,10 @@ private:
 
     QSemaphore _threadRunning{1};
 
+    // how many edits are sent between the whole volumes, so that a lost edit doesn't leave the volume out of sync for long
+    static const int VOXEL_EDITS_PER_SNAPSHOT = 16;
+    int _voxelEditsSinceSnapshot { 0 }; // only used by the thread that sends the edits
+
     // these are cached lookups of _xNNeighborID, _yNNeighborID, _zNNeighborID, _xPNeighborID, _yPNeighborID, _zPNeighborID
     EntityItemWeakPointer _xNNeighbor; // neighor found by going along negative X axis
     EntityItemWeakPointer _yNNeighbor;
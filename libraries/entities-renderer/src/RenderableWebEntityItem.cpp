@@ -8,11 +8,15 @@
 
 #include "RenderableWebEntityItem.h"
 
+#include <mutex>
+#include <vector>
+
 #include <QMouseEvent>
 #include <QQuickItem>
 #include <QQuickWindow>
 #include <QOpenGLContext>
 
+#include <glm/gtx/component_wise.hpp>
 #include <glm/gtx/quaternion.hpp>
 
 #include <DeferredLightingEffect.h>
@@ -30,6 +34,33 @@
 const float DPI = 30.47f;
 const float METERS_TO_INCHES = 39.3701f;
 
+// closer than this the entity is considered to take up as much of the view as it does from there
+const float MIN_VIEW_DISTANCE = 0.1f;
+// below this share of the width of the view the web view is paused, a quarter of the view gets the full frame rate
+const float MIN_LIVE_SCREEN_SHARE = 0.02f;
+const float FULL_RATE_SCREEN_SHARE = 0.25f;
+const uint8_t MIN_WEB_SURFACE_FPS = 5;
+const uint8_t MAX_WEB_SURFACE_FPS = 60;
+
+static std::mutex pendingSnapshotDeletesMutex;
+static std::vector<uint32_t> pendingSnapshotDeletes;
+
+static void deletePendingSnapshots() {
+    std::vector<uint32_t> snapshots;
+    {
+        std::lock_guard<std::mutex> lock(pendingSnapshotDeletesMutex);
+        snapshots.swap(pendingSnapshotDeletes);
+    }
+    for (auto snapshot : snapshots) {
+        OffscreenQmlSurface::deleteTextureCopy(snapshot);
+    }
+}
+
+static uint8_t maxFpsForScreenShare(float screenShare) {
+    float fps = MAX_WEB_SURFACE_FPS * screenShare / FULL_RATE_SCREEN_SHARE;
+    return (uint8_t)glm::clamp(fps, (float)MIN_WEB_SURFACE_FPS, (float)MAX_WEB_SURFACE_FPS);
+}
+
 EntityItemPointer RenderableWebEntityItem::factory(const EntityItemID& entityID, const EntityItemProperties& properties) {
     return std::make_shared<RenderableWebEntityItem>(entityID, properties);
 }
@@ -40,9 +71,23 @@ RenderableWebEntityItem::RenderableWebEntityItem(const EntityItemID& entityItemI
 }
 
 RenderableWebEntityItem::~RenderableWebEntityItem() {
+    destroyWebSurface();
+    if (_snapshotTexture) {
+        // the entity may go away on any thread, its snapshot is deleted by the next web entity rendered
+        std::lock_guard<std::mutex> lock(pendingSnapshotDeletesMutex);
+        pendingSnapshotDeletes.push_back(_snapshotTexture);
+    }
+    qDebug() << "Destroyed web entity " << getID();
+}
+
+void RenderableWebEntityItem::destroyWebSurface() {
     if (_webSurface) {
         _webSurface->pause();
         _webSurface->disconnect(_connection);
+        foreach (const QMetaObject::Connection& connection, _mouseConnections) {
+            QObject::disconnect(connection);
+        }
+        _mouseConnections.clear();
         // The lifetime of the QML surface MUST be managed by the main thread
         // Additionally, we MUST use local variables copied by value, rather than
         // member variables, since they would implicitly refer to a this that 
@@ -51,131 +96,191 @@ RenderableWebEntityItem::~RenderableWebEntityItem() {
         AbstractViewStateInterface::instance()->postLambdaEvent([webSurface] {
             webSurface->deleteLater();
         });
+        _webSurface = nullptr;
+        _texture = 0;
     }
-    qDebug() << "Destroyed web entity " << getID();
 }
 
-void RenderableWebEntityItem::render(RenderArgs* args) {
-    
-    #ifdef WANT_EXTRA_DEBUGGING
-    {
-        gpu::Batch& batch = *args->_batch;
-        batch.setModelTransform(getTransformToCenter()); // we want to include the scale as well
-        glm::vec4 cubeColor{ 1.0f, 0.0f, 0.0f, 1.0f};
-        DependencyManager::get<DeferredLightingEffect>()->renderWireCube(batch, 1.0f, cubeColor);
+void RenderableWebEntityItem::releaseWebSurface() {
+    if (_webSurface) {
+        // called while a web entity renders, with the context the surface shares with current
+        uint32_t snapshot = _webSurface->copyCurrentTexture();
+        if (snapshot) {
+            OffscreenQmlSurface::deleteTextureCopy(_snapshotTexture);
+            _snapshotTexture = snapshot;
+        }
+        destroyWebSurface();
     }
-    #endif
+}
 
-    QOpenGLContext * currentContext = QOpenGLContext::currentContext();
-    QSurface * currentSurface = currentContext->surface();
-    if (!_webSurface) {
-        _webSurface = new OffscreenQmlSurface();
-        _webSurface->create(currentContext);
-        _webSurface->setBaseUrl(QUrl::fromLocalFile(PathUtils::resourcesPath() + "/qml/"));
-        _webSurface->load("WebEntity.qml");
-        _webSurface->resume();
-        _webSurface->getRootItem()->setProperty("url", _sourceUrl);
-        _connection = QObject::connect(_webSurface, &OffscreenQmlSurface::textureUpdated, [&](GLuint textureId) {
-            _texture = textureId;
-        });
+void RenderableWebEntityItem::pauseWebSurface() {
+    if (_webSurface && !_webSurface->isPaused()) {
+        _webSurface->pause();
+    }
+}
 
-        auto forwardMouseEvent = [=](const RayToEntityIntersectionResult& intersection, const QMouseEvent* event, unsigned int deviceId) {
-            // Ignore mouse interaction if we're locked
-            if (this->getLocked()) {
-                return;
+void RenderableWebEntityItem::createWebSurface(EntityTreeRenderer* renderer, QOpenGLContext* currentContext) {
+    _webSurface = new OffscreenQmlSurface();
+    _webSurface->create(currentContext);
+    _webSurface->setBaseUrl(QUrl::fromLocalFile(PathUtils::resourcesPath() + "/qml/"));
+    _webSurface->load("WebEntity.qml");
+    _webSurface->resume();
+    _webSurface->getRootItem()->setProperty("url", _sourceUrl);
+    if (_proxyWindow) {
+        _webSurface->setProxyWindow(_proxyWindow);
+    }
+    _connection = QObject::connect(_webSurface, &OffscreenQmlSurface::textureUpdated, [&](GLuint textureId) {
+        _texture = textureId;
+    });
+
+    auto forwardMouseEvent = [=](const RayToEntityIntersectionResult& intersection, const QMouseEvent* event, unsigned int deviceId) {
+        // Ignore mouse interaction if we're locked
+        if (this->getLocked()) {
+            return;
+        }
+
+        if (event->button() == Qt::MouseButton::RightButton) {
+            if (event->type() == QEvent::MouseButtonPress) {
+                const QMouseEvent* mouseEvent = static_cast<const QMouseEvent*>(event);
+                _lastPress = toGlm(mouseEvent->pos());
             }
+        }
 
+        if (intersection.entityID == getID()) {
             if (event->button() == Qt::MouseButton::RightButton) {
-                if (event->type() == QEvent::MouseButtonPress) {
+                if (event->type() == QEvent::MouseButtonRelease) {
                     const QMouseEvent* mouseEvent = static_cast<const QMouseEvent*>(event);
-                    _lastPress = toGlm(mouseEvent->pos());
+                    ivec2 dist = glm::abs(toGlm(mouseEvent->pos()) - _lastPress);
+                    if (!glm::any(glm::greaterThan(dist, ivec2(1)))) {
+                        AbstractViewStateInterface::instance()->postLambdaEvent([this] {
+                            if (_webSurface) {
+                                QMetaObject::invokeMethod(_webSurface->getRootItem(), "goBack");
+                            }
+                        });
+                    }
+                    _lastPress = ivec2(INT_MIN);
                 }
+                return;
             }
 
-            if (intersection.entityID == getID()) {
-                if (event->button() == Qt::MouseButton::RightButton) {
-                    if (event->type() == QEvent::MouseButtonRelease) {
-                        const QMouseEvent* mouseEvent = static_cast<const QMouseEvent*>(event);
-                        ivec2 dist = glm::abs(toGlm(mouseEvent->pos()) - _lastPress);
-                        if (!glm::any(glm::greaterThan(dist, ivec2(1)))) {
-                            AbstractViewStateInterface::instance()->postLambdaEvent([this] {
-                                QMetaObject::invokeMethod(_webSurface->getRootItem(), "goBack");
-                            });
-                        }
-                        _lastPress = ivec2(INT_MIN);
+            // FIXME doesn't work... double click events not received
+            if (event->type() == QEvent::MouseButtonDblClick) {
+                AbstractViewStateInterface::instance()->postLambdaEvent([this] {
+                    if (_webSurface) {
+                        _webSurface->getRootItem()->setProperty("url", _sourceUrl);
                     }
-                    return;
-                }
+                });
+            }
 
-                // FIXME doesn't work... double click events not received
-                if (event->type() == QEvent::MouseButtonDblClick) {
+            if (event->button() == Qt::MouseButton::MiddleButton) {
+                if (event->type() == QEvent::MouseButtonRelease) {
                     AbstractViewStateInterface::instance()->postLambdaEvent([this] {
-                        _webSurface->getRootItem()->setProperty("url", _sourceUrl);
+                        if (_webSurface) {
+                            _webSurface->getRootItem()->setProperty("url", _sourceUrl);
+                        }
                     });
                 }
+                return;
+            }
 
-                if (event->button() == Qt::MouseButton::MiddleButton) {
-                    if (event->type() == QEvent::MouseButtonRelease) {
-                        AbstractViewStateInterface::instance()->postLambdaEvent([this] {
-                            _webSurface->getRootItem()->setProperty("url", _sourceUrl);
-                        });
-                    }
-                    return;
-                }
+            // Map the intersection point to an actual offscreen pixel
+            glm::vec3 point = intersection.intersection;
+            point -= getPosition();
+            point = glm::inverse(getRotation()) * point;
+            point /= getDimensions();
+            point += 0.5f;
+            point.y = 1.0f - point.y;
+            point *= getDimensions() * METERS_TO_INCHES * DPI;
 
-                // Map the intersection point to an actual offscreen pixel
-                glm::vec3 point = intersection.intersection;
-                point -= getPosition();
-                point = glm::inverse(getRotation()) * point;
-                point /= getDimensions();
-                point += 0.5f;
-                point.y = 1.0f - point.y;
-                point *= getDimensions() * METERS_TO_INCHES * DPI;
-
-                if (event->button() == Qt::MouseButton::LeftButton) {
-                    if (event->type() == QEvent::MouseButtonPress) {
-                        this->_pressed = true;
-                        this->_lastMove = ivec2((int)point.x, (int)point.y);
-                    } else if (event->type() == QEvent::MouseButtonRelease) {
-                        this->_pressed = false;
-                    }
-                }
-                if (event->type() == QEvent::MouseMove) {
+            if (event->button() == Qt::MouseButton::LeftButton) {
+                if (event->type() == QEvent::MouseButtonPress) {
+                    this->_pressed = true;
                     this->_lastMove = ivec2((int)point.x, (int)point.y);
+                } else if (event->type() == QEvent::MouseButtonRelease) {
+                    this->_pressed = false;
                 }
-
-                // Forward the mouse event.  
-                QMouseEvent mappedEvent(event->type(),
-                    QPoint((int)point.x, (int)point.y),
-                    event->screenPos(), event->button(),
-                    event->buttons(), event->modifiers());
-                QCoreApplication::sendEvent(_webSurface->getWindow(), &mappedEvent);
             }
-        };
-
-        EntityTreeRenderer* renderer = static_cast<EntityTreeRenderer*>(args->_renderer);
-        QObject::connect(renderer, &EntityTreeRenderer::mousePressOnEntity, forwardMouseEvent);
-        QObject::connect(renderer, &EntityTreeRenderer::mouseReleaseOnEntity, forwardMouseEvent);
-        QObject::connect(renderer, &EntityTreeRenderer::mouseMoveOnEntity, forwardMouseEvent);
-        QObject::connect(renderer, &EntityTreeRenderer::hoverLeaveEntity, [=](const EntityItemID& entityItemID, const MouseEvent& event) {
-            if (this->_pressed && this->getID() == entityItemID) {
-                // If the user mouses off the entity while the button is down, simulate a mouse release
-                QMouseEvent mappedEvent(QEvent::MouseButtonRelease, 
-                    QPoint(_lastMove.x, _lastMove.y), 
-                    Qt::MouseButton::LeftButton, 
-                    Qt::MouseButtons(), Qt::KeyboardModifiers());
-                QCoreApplication::sendEvent(_webSurface->getWindow(), &mappedEvent);
+            if (event->type() == QEvent::MouseMove) {
+                this->_lastMove = ivec2((int)point.x, (int)point.y);
             }
-        });
+
+            // Forward the mouse event.  
+            QMouseEvent mappedEvent(event->type(),
+                QPoint((int)point.x, (int)point.y),
+                event->screenPos(), event->button(),
+                event->buttons(), event->modifiers());
+            QCoreApplication::sendEvent(_webSurface->getWindow(), &mappedEvent);
+        }
+    };
+
+    _mouseConnections << QObject::connect(renderer, &EntityTreeRenderer::mousePressOnEntity, forwardMouseEvent);
+    _mouseConnections << QObject::connect(renderer, &EntityTreeRenderer::mouseReleaseOnEntity, forwardMouseEvent);
+    _mouseConnections << QObject::connect(renderer, &EntityTreeRenderer::mouseMoveOnEntity, forwardMouseEvent);
+    _mouseConnections << QObject::connect(renderer, &EntityTreeRenderer::hoverLeaveEntity, [=](const EntityItemID& entityItemID, const MouseEvent& event) {
+        if (this->_pressed && this->getID() == entityItemID) {
+            // If the user mouses off the entity while the button is down, simulate a mouse release
+            QMouseEvent mappedEvent(QEvent::MouseButtonRelease, 
+                QPoint(_lastMove.x, _lastMove.y), 
+                Qt::MouseButton::LeftButton, 
+                Qt::MouseButtons(), Qt::KeyboardModifiers());
+            QCoreApplication::sendEvent(_webSurface->getWindow(), &mappedEvent);
+        }
+    });
+}
+
+void RenderableWebEntityItem::render(RenderArgs* args) {
+    
+    #ifdef WANT_EXTRA_DEBUGGING
+    {
+        gpu::Batch& batch = *args->_batch;
+        batch.setModelTransform(getTransformToCenter()); // we want to include the scale as well
+        glm::vec4 cubeColor{ 1.0f, 0.0f, 0.0f, 1.0f};
+        DependencyManager::getRaw<DeferredLightingEffect>()->renderWireCube(batch, 1.0f, cubeColor);
     }
+    #endif
+
+    QOpenGLContext * currentContext = QOpenGLContext::currentContext();
+    QSurface * currentSurface = currentContext->surface();
+
+    // the snapshots of the web entities that went away are deleted here, where there is a context to do it with
+    deletePendingSnapshots();
 
-    glm::vec2 dims = glm::vec2(getDimensions());
-    dims *= METERS_TO_INCHES * DPI;
-    // The offscreen surface is idempotent for resizes (bails early
-    // if it's a no-op), so it's safe to just call resize every frame 
-    // without worrying about excessive overhead.
-    _webSurface->resize(QSize(dims.x, dims.y));
-    currentContext->makeCurrent(currentSurface);
+    // the share of the width of the view the entity takes, which its view renders at a rate for
+    float distance = glm::max(glm::distance(getPosition(), args->_viewFrustum->getPosition()), MIN_VIEW_DISTANCE);
+    float angularSize = 2.0f * atanf(0.5f * glm::compMax(glm::vec2(getDimensions())) / distance);
+    float screenShare = angularSize / glm::radians(args->_viewFrustum->getFieldOfView());
+
+    EntityTreeRenderer* renderer = static_cast<EntityTreeRenderer*>(args->_renderer);
+    auto thisPointer = std::static_pointer_cast<RenderableWebEntityItem>(shared_from_this());
+    if (renderer->getWebSurfaceBudget().acquire(thisPointer, screenShare)) {
+        if (!_webSurface) {
+            createWebSurface(renderer, currentContext);
+        }
+
+        if (screenShare < MIN_LIVE_SCREEN_SHARE) {
+            // too small to make out, it is left on its last frame
+            _webSurface->pause();
+        } else {
+            if (_webSurface->isPaused()) {
+                _webSurface->resume();
+            }
+            _webSurface->setMaxFps(maxFpsForScreenShare(screenShare));
+        }
+
+        glm::vec2 dims = glm::vec2(getDimensions());
+        dims *= METERS_TO_INCHES * DPI;
+        // The offscreen surface is idempotent for resizes (bails early
+        // if it's a no-op), so it's safe to just call resize every frame 
+        // without worrying about excessive overhead.
+        _webSurface->resize(QSize(dims.x, dims.y));
+        currentContext->makeCurrent(currentSurface);
+    }
+
+    // the snapshot stands in until the new view has a frame of its own
+    if (_texture && _snapshotTexture) {
+        OffscreenQmlSurface::deleteTextureCopy(_snapshotTexture);
+        _snapshotTexture = 0;
+    }
 
     PerformanceTimer perfTimer("RenderableWebEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::Web);
@@ -185,13 +290,14 @@ void RenderableWebEntityItem::render(RenderArgs* args) {
     gpu::Batch& batch = *args->_batch;
     batch.setModelTransform(getTransformToCenter());
     bool textured = false, culled = false, emissive = false;
-    if (_texture) {
-        batch._glActiveBindTexture(GL_TEXTURE0, GL_TEXTURE_2D, _texture);
+    GLuint texture = _texture ? _texture : _snapshotTexture;
+    if (texture) {
+        batch._glActiveBindTexture(GL_TEXTURE0, GL_TEXTURE_2D, texture);
         textured = emissive = true;
     }
     
-    DependencyManager::get<DeferredLightingEffect>()->bindSimpleProgram(batch, textured, culled, emissive);
-    DependencyManager::get<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, texMin, texMax, glm::vec4(1.0f));
+    DependencyManager::getRaw<DeferredLightingEffect>()->bindSimpleProgram(batch, textured, culled, emissive);
+    DependencyManager::getRaw<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, texMin, texMax, glm::vec4(1.0f));
 }
 
 void RenderableWebEntityItem::setSourceUrl(const QString& value) {
@@ -200,16 +306,22 @@ void RenderableWebEntityItem::setSourceUrl(const QString& value) {
         _sourceUrl = value;
         if (_webSurface) {
             AbstractViewStateInterface::instance()->postLambdaEvent([this] {
-                _webSurface->getRootItem()->setProperty("url", _sourceUrl);
+                if (_webSurface) {
+                    _webSurface->getRootItem()->setProperty("url", _sourceUrl);
+                }
             });
         }
     }
 }
 
 void RenderableWebEntityItem::setProxyWindow(QWindow* proxyWindow) {
-    _webSurface->setProxyWindow(proxyWindow);
+    // kept for the next view, if this one is let go of
+    _proxyWindow = proxyWindow;
+    if (_webSurface) {
+        _webSurface->setProxyWindow(proxyWindow);
+    }
 }
 
 QObject* RenderableWebEntityItem::getEventHandler() {
-    return _webSurface->getEventHandler();
+    return _webSurface ? _webSurface->getEventHandler() : nullptr;
 }
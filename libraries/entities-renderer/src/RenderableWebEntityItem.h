@@ -15,7 +15,9 @@
 
 #include "RenderableEntityItem.h"
 
+class EntityTreeRenderer;
 class OffscreenQmlSurface;
+class QOpenGLContext;
 class QWindow;
 class QObject;
 
@@ -32,12 +34,22 @@ public:
     void setProxyWindow(QWindow* proxyWindow);
     QObject* getEventHandler();
 
+    // the web view is let go of when WebEntitySurfaceBudget needs its place, a snapshot of its last frame is shown instead
+    void releaseWebSurface();
+    void pauseWebSurface();
+
     SIMPLE_RENDERABLE();
 
 private:
+    void createWebSurface(EntityTreeRenderer* renderer, QOpenGLContext* currentContext);
+    void destroyWebSurface();
+
     OffscreenQmlSurface* _webSurface{ nullptr };
     QMetaObject::Connection _connection;
+    QList<QMetaObject::Connection> _mouseConnections;
+    QWindow* _proxyWindow{ nullptr };
     uint32_t _texture{ 0 };
+    uint32_t _snapshotTexture{ 0 };
     ivec2  _lastPress{ INT_MIN };
     bool _pressed{ false };
     ivec2 _lastMove{ INT_MIN };
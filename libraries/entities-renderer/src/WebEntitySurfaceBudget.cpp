@@ -0,0 +1,96 @@
+//
+//  WebEntitySurfaceBudget.cpp
+//  libraries/entities-renderer/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "WebEntitySurfaceBudget.h"
+
+#include "RenderableWebEntityItem.h"
+
+// a visible view is only torn down for one this much bigger on screen, so that two of about the same size don't take turns
+static const float MIN_SCREEN_SHARE_RATIO_TO_TEAR_DOWN = 2.0f;
+
+bool WebEntitySurfaceBudget::acquire(const std::shared_ptr<RenderableWebEntityItem>& entity, float screenShare) {
+    auto it = _liveSurfaces.find(entity->getEntityItemID());
+    if (it == _liveSurfaces.end()) {
+        if (_hasCreatedThisFrame || !makeRoomFor(screenShare)) {
+            return false;
+        }
+        _hasCreatedThisFrame = true;
+        it = _liveSurfaces.insert(entity->getEntityItemID(), LiveSurface());
+        it->entity = entity;
+    }
+    it->lastRenderedFrame = _frame;
+    it->screenShare = screenShare;
+    return true;
+}
+
+bool WebEntitySurfaceBudget::makeRoomFor(float screenShare) {
+    // the entities that are gone free their place
+    for (auto it = _liveSurfaces.begin(); it != _liveSurfaces.end();) {
+        if (it->entity.expired()) {
+            it = _liveSurfaces.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (_liveSurfaces.size() < MAX_LIVE_SURFACES) {
+        return true;
+    }
+
+    // the hidden ones were rendered neither in the last frame nor in this one
+    auto isHidden = [&](const LiveSurface& surface) {
+        return surface.lastRenderedFrame + 1 < _frame;
+    };
+    // the least recently viewed of the hidden ones goes first, or else the smallest of the visible ones
+    auto goesBefore = [&](const LiveSurface& surface, const LiveSurface& other) {
+        if (isHidden(surface) != isHidden(other)) {
+            return isHidden(surface);
+        }
+        return isHidden(surface) ? surface.lastRenderedFrame < other.lastRenderedFrame
+                                 : surface.screenShare < other.screenShare;
+    };
+
+    auto victim = _liveSurfaces.begin();
+    for (auto it = _liveSurfaces.begin(); it != _liveSurfaces.end(); ++it) {
+        if (goesBefore(*it, *victim)) {
+            victim = it;
+        }
+    }
+
+    if (!isHidden(*victim) && screenShare < victim->screenShare * MIN_SCREEN_SHARE_RATIO_TO_TEAR_DOWN) {
+        return false;
+    }
+
+    if (auto victimEntity = victim->entity.lock()) {
+        victimEntity->releaseWebSurface();
+    }
+    _liveSurfaces.erase(victim);
+    return true;
+}
+
+void WebEntitySurfaceBudget::update() {
+    // the views of the entities that weren't rendered last frame, culled or out of the view, stop rendering
+    for (auto it = _liveSurfaces.begin(); it != _liveSurfaces.end();) {
+        auto entity = it->entity.lock();
+        if (!entity) {
+            it = _liveSurfaces.erase(it);
+            continue;
+        }
+        if (it->lastRenderedFrame < _frame) {
+            entity->pauseWebSurface();
+        }
+        ++it;
+    }
+    ++_frame;
+    _hasCreatedThisFrame = false;
+}
+
+void WebEntitySurfaceBudget::clear() {
+    _liveSurfaces.clear();
+}
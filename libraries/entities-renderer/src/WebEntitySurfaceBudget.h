@@ -0,0 +1,52 @@
+//
+//  WebEntitySurfaceBudget.h
+//  libraries/entities-renderer/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_WebEntitySurfaceBudget_h
+#define hifi_WebEntitySurfaceBudget_h
+
+#include <memory>
+
+#include <QtCore/QHash>
+
+#include <EntityItemID.h>
+
+class RenderableWebEntityItem;
+
+/// Bounds the web views the web entities of a domain keep live. A view is paused once its entity is no longer rendered,
+/// and past MAX_LIVE_SURFACES views the one viewed the longest time ago, or else the smallest on screen, is torn down.
+/// Torn down entities show a snapshot of their last frame until they get a view again.
+/// Called from the main thread, the web entities are rendered on it.
+class WebEntitySurfaceBudget {
+public:
+    static const int MAX_LIVE_SURFACES = 4;
+
+    /// the web entity is rendered this frame, at this share of the width of the view
+    /// \return false if it can't have a live view and shows its snapshot instead
+    bool acquire(const std::shared_ptr<RenderableWebEntityItem>& entity, float screenShare);
+
+    /// called once a frame, before the entities are rendered
+    void update();
+    void clear();
+
+private:
+    struct LiveSurface {
+        std::weak_ptr<RenderableWebEntityItem> entity;
+        quint64 lastRenderedFrame { 0 };
+        float screenShare { 0.0f };
+    };
+
+    bool makeRoomFor(float screenShare);
+
+    QHash<EntityItemID, LiveSurface> _liveSurfaces;
+    quint64 _frame { 1 };
+    bool _hasCreatedThisFrame { false }; // a web view is slow to make, at most one is made each frame
+};
+
+#endif // hifi_WebEntitySurfaceBudget_h
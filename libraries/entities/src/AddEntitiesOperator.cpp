@@ -0,0 +1,97 @@
+//
+//  AddEntitiesOperator.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityItem.h"
+#include "EntityTree.h"
+#include "EntityTreeElement.h"
+
+#include "AddEntitiesOperator.h"
+
+AddEntitiesOperator::AddEntitiesOperator(EntityTreePointer tree, const QVector<EntityItemPointer>& newEntities) :
+    _tree(tree),
+    _numFound(0)
+{
+    _newEntities.reserve(newEntities.size());
+    foreach (const EntityItemPointer& newEntity, newEntities) {
+        // caller must have verified existence of the new entities
+        assert(newEntity);
+
+        NewEntity details;
+        details.entity = newEntity;
+        details.box = newEntity->getMaximumAACube().clamp((float)(-HALF_TREE_SCALE), (float)HALF_TREE_SCALE);
+        details.found = false;
+        _newEntities << details;
+    }
+}
+
+bool AddEntitiesOperator::preRecursion(const OctreeElementPointer& element) {
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+
+    PathElement pathElement;
+    pathElement.changed = false;
+
+    auto searchHere = [&](int index) {
+        NewEntity& newEntity = _newEntities[index];
+        if (newEntity.found || !element->getAACube().contains(newEntity.box)) {
+            return;
+        }
+        pathElement.changed = true;
+
+        // If this element is the best fit for the new entity properties, then add it here
+        if (entityTreeElement->bestFitBounds(newEntity.box)) {
+            entityTreeElement->addEntityItem(newEntity.entity);
+            _tree->setContainingElement(newEntity.entity->getEntityItemID(), entityTreeElement);
+            newEntity.found = true;
+            _numFound++;
+        } else {
+            pathElement.searching << index;
+        }
+    };
+
+    if (_path.isEmpty()) {
+        for (int i = 0; i < _newEntities.size(); i++) {
+            searchHere(i);
+        }
+    } else {
+        foreach (int index, _path.last().searching) {
+            searchHere(index);
+        }
+    }
+
+    bool keepSearching = !pathElement.searching.isEmpty();
+
+    // postRecursion() is called for this element whatever we return
+    _path << pathElement;
+
+    return keepSearching;
+}
+
+bool AddEntitiesOperator::postRecursion(const OctreeElementPointer& element) {
+    // As we unwind we mark the elements on the paths to the new entities as changed
+    if (_path.last().changed) {
+        element->markWithChangedTime();
+    }
+    _path.removeLast();
+
+    return _numFound < _newEntities.size(); // if we haven't yet found them all, keep looking
+}
+
+OctreeElementPointer AddEntitiesOperator::possiblyCreateChildAt(const OctreeElementPointer& element, int childIndex) {
+    // we're called for the children of the element on top of the path, make the child if a new entity needs it
+    float childElementScale = element->getAACube().getScale() / 2.0f; // all of our children will be half our scale
+    foreach (int index, _path.last().searching) {
+        const NewEntity& newEntity = _newEntities[index];
+        if (!newEntity.found && newEntity.box.getLargestDimension() <= childElementScale &&
+            element->getMyChildContaining(newEntity.box) == childIndex) {
+            return element->addChildAtIndex(childIndex);
+        }
+    }
+    return NULL;
+}
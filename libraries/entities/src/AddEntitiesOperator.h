@@ -0,0 +1,45 @@
+//
+//  AddEntitiesOperator.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AddEntitiesOperator_h
+#define hifi_AddEntitiesOperator_h
+
+#include <QVector>
+
+// AddEntityOperator for many entities in one pass. Every element on the way down only looks at the entities its
+// parent passed on, so each branch of the tree is walked once for all the entities stored below it.
+class AddEntitiesOperator : public RecurseOctreeOperator {
+public:
+    AddEntitiesOperator(EntityTreePointer tree, const QVector<EntityItemPointer>& newEntities);
+
+    virtual bool preRecursion(const OctreeElementPointer& element);
+    virtual bool postRecursion(const OctreeElementPointer& element);
+    virtual OctreeElementPointer possiblyCreateChildAt(const OctreeElementPointer& element, int childIndex);
+
+private:
+    struct NewEntity {
+        EntityItemPointer entity;
+        AABox box;
+        bool found;
+    };
+
+    // the entities still looking for their element below an element of the current path
+    struct PathElement {
+        QVector<int> searching;
+        bool changed;
+    };
+
+    EntityTreePointer _tree;
+    QVector<NewEntity> _newEntities;
+    QVector<PathElement> _path;
+    int _numFound;
+};
+
+#endif // hifi_AddEntitiesOperator_h
@@ -16,9 +16,9 @@ class AddEntityOperator : public RecurseOctreeOperator {
 public:
     AddEntityOperator(EntityTreePointer tree, EntityItemPointer newEntity);
                             
-    virtual bool preRecursion(OctreeElementPointer element);
-    virtual bool postRecursion(OctreeElementPointer element);
-    virtual OctreeElementPointer possiblyCreateChildAt(OctreeElementPointer element, int childIndex);
+    virtual bool preRecursion(const OctreeElementPointer& element);
+    virtual bool postRecursion(const OctreeElementPointer& element);
+    virtual OctreeElementPointer possiblyCreateChildAt(const OctreeElementPointer& element, int childIndex);
 private:
     EntityTreePointer _tree;
     EntityItemPointer _newEntity;
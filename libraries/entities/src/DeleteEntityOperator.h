@@ -36,8 +36,8 @@ public:
     ~DeleteEntityOperator();
 
     void addEntityIDToDeleteList(const EntityItemID& searchEntityID);
-    virtual bool preRecursion(OctreeElementPointer element);
-    virtual bool postRecursion(OctreeElementPointer element);
+    virtual bool preRecursion(const OctreeElementPointer& element);
+    virtual bool postRecursion(const OctreeElementPointer& element);
 
     const RemovedEntities& getEntities() const { return _entitiesToDelete; }
 private:
@@ -0,0 +1,277 @@
+//
+//  EntityBinaryFile.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityBinaryFile.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QThread>
+#include <QtEndian>
+#include <QVector>
+#include <QtScript/QScriptEngine>
+
+#include "EntitiesLogging.h"
+#include "EntityItemProperties.h"
+#include "EntityTree.h"
+#include "VariantMapToScriptValue.h"
+
+static const char MAGIC[] = { 'H', 'F', 'E', 'B' };
+static const quint32 FORMAT_VERSION = 1;
+static const QDataStream::Version STREAM_VERSION = QDataStream::Qt_5_0;
+
+// how many records each thread turns into properties before the entities are added, this bounds the memory used
+// by the decoded properties that wait for the tree
+static const int RECORDS_PER_THREAD_BATCH = 512;
+
+namespace {
+    struct DecodedEntity {
+        EntityItemID entityID;
+        EntityItemProperties properties;
+        bool valid { false };
+    };
+}
+
+static void setupStream(QDataStream& stream) {
+    stream.setVersion(STREAM_VERSION);
+    stream.setByteOrder(QDataStream::LittleEndian);
+}
+
+bool EntityBinaryFile::write(const QString& fileName, const QVariantMap& entityDescription) {
+    QVariantList entitiesList = entityDescription["Entities"].toList();
+
+    QStringList names;
+    QHash<QString, quint16> nameIndices;
+
+    QByteArray records;
+    QDataStream recordsStream(&records, QIODevice::WriteOnly);
+    setupStream(recordsStream);
+
+    QVector<quint64> recordOffsets;
+    recordOffsets.reserve(entitiesList.size());
+
+    foreach (const QVariant& entityVariant, entitiesList) {
+        QVariantMap entityMap = entityVariant.toMap();
+
+        QByteArray record;
+        QDataStream recordStream(&record, QIODevice::WriteOnly);
+        setupStream(recordStream);
+
+        recordStream << (quint16)entityMap.size();
+        for (auto property = entityMap.constBegin(); property != entityMap.constEnd(); ++property) {
+            auto nameIndex = nameIndices.find(property.key());
+            if (nameIndex == nameIndices.end()) {
+                if (names.size() > std::numeric_limits<quint16>::max()) {
+                    qCDebug(entities) << "Too many entity property names to write binary entities file" << fileName;
+                    return false;
+                }
+                nameIndex = nameIndices.insert(property.key(), (quint16)names.size());
+                names << property.key();
+            }
+            recordStream << nameIndex.value() << property.value();
+        }
+
+        recordOffsets << (quint64)records.size();
+        recordsStream << (quint32)record.size();
+        recordsStream.writeRawData(record.constData(), record.size());
+    }
+
+    QByteArray header;
+    QDataStream headerStream(&header, QIODevice::WriteOnly);
+    setupStream(headerStream);
+
+    headerStream.writeRawData(MAGIC, sizeof(MAGIC));
+    headerStream << FORMAT_VERSION << (quint32)entityDescription["Version"].toInt();
+    headerStream << (quint32)names.size();
+    foreach (const QString& name, names) {
+        headerStream << name;
+    }
+
+    // the records follow the index
+    quint64 recordsStart = header.size() + sizeof(quint32) + recordOffsets.size() * sizeof(quint64);
+    headerStream << (quint32)recordOffsets.size();
+    foreach (quint64 recordOffset, recordOffsets) {
+        headerStream << recordsStart + recordOffset;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(entities) << "Could not open binary entities file for writing:" << fileName;
+        return false;
+    }
+
+    return file.write(header) == header.size() && file.write(records) == records.size();
+}
+
+static bool decodeRecord(const char* data, quint64 size, quint64 offset, const QVector<QString>& names,
+                         QScriptEngine& scriptEngine, DecodedEntity& decoded) {
+    if (offset + sizeof(quint32) > size) {
+        return false;
+    }
+
+    quint32 length;
+    memcpy(&length, data + offset, sizeof(length));
+    length = qFromLittleEndian(length);
+    offset += sizeof(quint32);
+
+    if (offset + length > size) {
+        return false;
+    }
+
+    QByteArray record = QByteArray::fromRawData(data + offset, length);
+    QDataStream recordStream(record);
+    setupStream(recordStream);
+
+    quint16 numProperties;
+    recordStream >> numProperties;
+
+    QVariantMap entityMap;
+    for (int i = 0; i < numProperties; ++i) {
+        quint16 nameIndex;
+        QVariant value;
+        recordStream >> nameIndex >> value;
+        if (nameIndex >= names.size()) {
+            return false;
+        }
+        entityMap.insert(names[nameIndex], value);
+    }
+
+    if (recordStream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // QVariantMap --> QScriptValue --> EntityItemProperties, like EntityTree::readFromMap
+    QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+    EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, decoded.properties);
+
+    if (entityMap.contains("id")) {
+        decoded.entityID = EntityItemID(QUuid(entityMap["id"].toString()));
+    } else {
+        decoded.entityID = EntityItemID(QUuid::createUuid());
+    }
+    decoded.valid = true;
+    return true;
+}
+
+bool EntityBinaryFile::read(EntityTree& tree, const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCDebug(entities) << "Could not open binary entities file for reading:" << fileName;
+        return false;
+    }
+
+    quint64 size = file.size();
+
+    // fall back to reading the whole file where it can't be mapped
+    QByteArray fileData;
+    const char* data = reinterpret_cast<const char*>(file.map(0, size));
+    if (!data) {
+        fileData = file.readAll();
+        data = fileData.constData();
+        size = fileData.size();
+    }
+
+    QByteArray header = QByteArray::fromRawData(data, size);
+    QDataStream headerStream(header);
+    setupStream(headerStream);
+
+    char magic[sizeof(MAGIC)];
+    quint32 formatVersion = 0;
+    quint32 dataVersion = 0;
+    if (headerStream.readRawData(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        qCDebug(entities) << "Not a binary entities file:" << fileName;
+        return false;
+    }
+    headerStream >> formatVersion >> dataVersion;
+    if (formatVersion != FORMAT_VERSION) {
+        qCDebug(entities) << "Unsupported binary entities file version" << formatVersion << "in" << fileName;
+        return false;
+    }
+
+    quint32 numNames;
+    headerStream >> numNames;
+    QVector<QString> names;
+    for (quint32 i = 0; i < numNames && headerStream.status() == QDataStream::Ok; ++i) {
+        QString name;
+        headerStream >> name;
+        names << name;
+    }
+
+    quint32 numRecords;
+    headerStream >> numRecords;
+    if (headerStream.status() != QDataStream::Ok || (quint64)numRecords * sizeof(quint64) > size) {
+        qCDebug(entities) << "Corrupt binary entities file header:" << fileName;
+        return false;
+    }
+
+    QVector<quint64> recordOffsets(numRecords);
+    for (quint32 i = 0; i < numRecords; ++i) {
+        headerStream >> recordOffsets[i];
+    }
+    if (headerStream.status() != QDataStream::Ok) {
+        qCDebug(entities) << "Corrupt binary entities file index:" << fileName;
+        return false;
+    }
+
+    int numThreads = std::max(1, QThread::idealThreadCount());
+    int batchSize = numThreads * RECORDS_PER_THREAD_BATCH;
+    std::vector<DecodedEntity> batch;
+    int numCorrupt = 0;
+
+    for (quint32 batchStart = 0; batchStart < numRecords; batchStart += batchSize) {
+        quint32 batchEnd = std::min(numRecords, batchStart + batchSize);
+
+        batch.clear();
+        batch.resize(batchEnd - batchStart);
+
+        // each thread needs its own script engine for the conversion to properties
+        auto decodeRange = [&](quint32 first, quint32 last) {
+            QScriptEngine scriptEngine;
+            for (quint32 i = first; i < last; ++i) {
+                decodeRecord(data, size, recordOffsets[i], names, scriptEngine, batch[i - batchStart]);
+            }
+        };
+
+        quint32 recordsPerThread = (batchEnd - batchStart + numThreads - 1) / numThreads;
+        std::vector<std::thread> threads;
+        for (quint32 first = batchStart + recordsPerThread; first < batchEnd; first += recordsPerThread) {
+            threads.emplace_back(decodeRange, first, std::min(batchEnd, first + recordsPerThread));
+        }
+        decodeRange(batchStart, std::min(batchEnd, batchStart + recordsPerThread));
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (auto& decoded : batch) {
+            if (!decoded.valid) {
+                ++numCorrupt;
+                continue;
+            }
+            EntityItemPointer entity = tree.addEntity(decoded.entityID, decoded.properties);
+            if (!entity) {
+                qCDebug(entities) << "adding Entity failed:" << decoded.entityID << decoded.properties.getType();
+            }
+        }
+    }
+
+    if (numCorrupt > 0) {
+        qCDebug(entities) << "Skipped" << numCorrupt << "corrupt records in binary entities file" << fileName;
+    }
+
+    return true;
+}
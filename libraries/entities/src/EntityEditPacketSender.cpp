@@ -17,6 +17,10 @@
 #include "EntitiesLogging.h"
 #include "EntityItem.h"
 #include "EntityItemProperties.h"
+#include "EntitySimulationUpdate.h"
+
+// how long an edit can wait for the edits that supersede it when the queued messages aren't released
+static const quint64 EDIT_COALESCING_WINDOW_USECS = USECS_PER_SECOND / 60;
 
 EntityEditPacketSender::EntityEditPacketSender() {
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
@@ -30,7 +34,7 @@ void EntityEditPacketSender::processEntityEditNackPacket(QSharedPointer<NLPacket
 }
 
 void EntityEditPacketSender::adjustEditPacketForClockSkew(PacketType type, QByteArray& buffer, int clockSkew) {
-    if (type == PacketType::EntityAdd || type == PacketType::EntityEdit) {
+    if (type == PacketType::EntityAdd || type == PacketType::EntityEdit || type == PacketType::EntitySimulationUpdate) {
         EntityItem::adjustEditPacketForClockSkew(buffer, clockSkew);
     }
 }
@@ -49,10 +53,77 @@ void EntityEditPacketSender::queueEditEntityMessage(PacketType type, EntityItemI
             qCDebug(entities) << "    id:" << modelID;
             qCDebug(entities) << "    properties:" << properties;
         #endif
-        queueOctreeEditMessage(type, bufferOut);
+        if (type == PacketType::EntityAdd) {
+            // a new entity belongs to the server of the position it is added at
+            routeMessage(type, bufferOut, properties.getPosition());
+        }
+        queueCoalescedMessage(type, modelID, properties.getChangedProperties(), bufferOut);
     }
 }
 
+void EntityEditPacketSender::queueEditEntityMessage(PacketType type, EntityItemID modelID,
+                                                    const EntityItemProperties& properties,
+                                                    const glm::vec3& routingPosition) {
+    if (!_shouldSend) {
+        return; // bail early
+    }
+
+    QByteArray bufferOut(NLPacket::maxPayloadSize(type), 0);
+
+    if (EntityItemProperties::encodeEntityEditPacket(type, modelID, properties, bufferOut)) {
+        routeMessage(type, bufferOut, routingPosition);
+        queueCoalescedMessage(type, modelID, properties.getChangedProperties(), bufferOut);
+    }
+}
+
+void EntityEditPacketSender::queueSimulationUpdateMessage(const EntityItemID& entityItemID,
+                                                          const EntityItemProperties& properties,
+                                                          const glm::vec3& gravity,
+                                                          const glm::vec3& routingPosition) {
+    if (!_shouldSend) {
+        return; // bail early
+    }
+
+    if (!EntitySimulationUpdate::canEncode(properties, gravity)) {
+        queueEditEntityMessage(PacketType::EntityEdit, entityItemID, properties, routingPosition);
+        return;
+    }
+
+    QByteArray bufferOut(NLPacket::maxPayloadSize(PacketType::EntitySimulationUpdate), 0);
+
+    if (EntitySimulationUpdate::encode(entityItemID, properties, bufferOut)) {
+        routeMessage(PacketType::EntitySimulationUpdate, bufferOut, routingPosition);
+        queueCoalescedMessage(PacketType::EntitySimulationUpdate, entityItemID, properties.getChangedProperties(),
+                              bufferOut);
+    }
+}
+
+void EntityEditPacketSender::routeMessage(PacketType type, QByteArray& message, const glm::vec3& routingPosition) {
+    // messages are encoded with the root octcode, which goes to every server: with a single server there is nothing
+    // to choose, and it keeps the messages smaller
+    bool hasSeveralServers = false;
+    if (_serverJurisdictions) {
+        _serverJurisdictions->withReadLock([&] {
+            hasSeveralServers = _serverJurisdictions->size() > 1;
+        });
+    }
+    if (!hasSeveralServers) {
+        return;
+    }
+
+    const unsigned char* messageData = reinterpret_cast<const unsigned char*>(message.constData());
+    int rootLength = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(messageData, message.size()));
+    unsigned char* octcode = JurisdictionMap::routingOctalCodeForPosition(routingPosition);
+    int octcodeLength = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(octcode));
+
+    // the edit packets start with a sequence number and a timestamp, a message that wouldn't fit anymore keeps the root
+    int maxMessageSize = NLPacket::maxPayloadSize(type) - (int)(sizeof(quint16) + sizeof(quint64));
+    if (message.size() - rootLength + octcodeLength <= maxMessageSize) {
+        message.replace(0, rootLength, QByteArray(reinterpret_cast<const char*>(octcode), octcodeLength));
+    }
+    delete[] octcode;
+}
+
 void EntityEditPacketSender::queueEraseEntityMessage(const EntityItemID& entityItemID) {
     if (!_shouldSend) {
         return; // bail early
@@ -61,6 +132,82 @@ void EntityEditPacketSender::queueEraseEntityMessage(const EntityItemID& entityI
     QByteArray bufferOut(NLPacket::maxPayloadSize(PacketType::EntityErase), 0);
 
     if (EntityItemProperties::encodeEraseEntityMessage(entityItemID, bufferOut)) {
-        queueOctreeEditMessage(PacketType::EntityErase, bufferOut);
+        queueCoalescedMessage(PacketType::EntityErase, entityItemID, EntityPropertyFlags(), bufferOut);
+    }
+}
+
+// true if every property of the older edit is changed again by the newer one
+static bool isSupersededBy(const EntityPropertyFlags& older, const EntityPropertyFlags& newer) {
+    if (older.isEmpty()) {
+        return false;
+    }
+    for (int i = older.firstFlag(); i <= older.lastFlag(); i++) {
+        EntityPropertyList property = (EntityPropertyList)i;
+        if (older.getHasProperty(property) && !newer.getHasProperty(property)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EntityEditPacketSender::queueCoalescedMessage(PacketType type, const EntityItemID& entityItemID,
+                                                   const EntityPropertyFlags& properties, const QByteArray& message) {
+    QMutexLocker locker(&_coalescedEditsLock);
+
+    quint64 now = usecTimestampNow();
+    if (_coalescedEdits.empty()) {
+        _coalescingStarted = now;
+    }
+
+    QVector<int>& entityEdits = _coalescedEditIndices[entityItemID];
+    if (type != PacketType::EntityAdd) {
+        // an erase supersedes every edit before it, adds are never dropped
+        for (int i = entityEdits.size() - 1; i >= 0; i--) {
+            CoalescedEdit& olderEdit = _coalescedEdits[entityEdits[i]];
+            if (olderEdit.type != PacketType::EntityAdd &&
+                    (type == PacketType::EntityErase || isSupersededBy(olderEdit.properties, properties))) {
+                olderEdit.superseded = true;
+                _coalescedBytes -= olderEdit.message.size();
+                entityEdits.remove(i);
+            }
+        }
+    }
+
+    if (type == PacketType::EntityErase) {
+        // the edits after an erase belong to an entity added again, they don't merge with the ones before
+        _coalescedEditIndices.remove(entityItemID);
+    } else {
+        entityEdits << (int)_coalescedEdits.size();
+    }
+
+    CoalescedEdit edit;
+    edit.type = type;
+    edit.entityItemID = entityItemID;
+    edit.properties = properties;
+    edit.message = message;
+    edit.superseded = false;
+    _coalescedEdits.push_back(edit);
+    _coalescedBytes += message.size();
+
+    // don't hold back more than a packet, or for longer than the window
+    if (_coalescedBytes >= NLPacket::maxPayloadSize(type) || now - _coalescingStarted > EDIT_COALESCING_WINDOW_USECS) {
+        releaseCoalescedMessagesLocked();
+    }
+}
+
+void EntityEditPacketSender::releaseCoalescedMessages() {
+    QMutexLocker locker(&_coalescedEditsLock);
+    releaseCoalescedMessagesLocked();
+}
+
+void EntityEditPacketSender::releaseCoalescedMessagesLocked() {
+    // the lock is held while queueing so that messages released from different threads keep their order
+    for (auto& edit : _coalescedEdits) {
+        if (!edit.superseded) {
+            queueOctreeEditMessage(edit.type, edit.message);
+        }
     }
+    _coalescedEdits.clear();
+    _coalescedEditIndices.clear();
+    _coalescedBytes = 0;
 }
@@ -12,11 +12,21 @@
 #ifndef hifi_EntityEditPacketSender_h
 #define hifi_EntityEditPacketSender_h
 
+#include <vector>
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
 #include <OctreeEditPacketSender.h>
 
 #include "EntityItem.h"
 
 /// Utility for processing, packing, queueing and sending of outbound edit voxel messages.
+///
+/// Edit messages are held back until the queued messages are released, or for at most EDIT_COALESCING_WINDOW_USECS,
+/// so that an edit of an entity whose properties are all changed again by a later edit isn't sent at all. Adds and
+/// erases are never merged away and keep their order with the edits of their entity.
 class EntityEditPacketSender :  public OctreeEditPacketSender {
     Q_OBJECT
 public:
@@ -26,8 +36,20 @@ public:
     /// which voxel-server node or nodes the packet should be sent to. Can be called even before voxel servers are known, in
     /// which case up to MaxPendingMessages will be buffered and processed when voxel servers are known.
     /// NOTE: EntityItemProperties assumes that all distances are in meter units
+    ///
+    /// Adds go to the server whose jurisdiction contains the position of the new entity, edits go to every server.
     void queueEditEntityMessage(PacketType type, EntityItemID modelID, const EntityItemProperties& properties);
 
+    /// Queues an edit for the server whose jurisdiction contains the routing position, the position the entity has
+    /// before the edit.
+    void queueEditEntityMessage(PacketType type, EntityItemID modelID, const EntityItemProperties& properties,
+                                const glm::vec3& routingPosition);
+
+    /// Queues the edit of a simulation owner as a compact EntitySimulationUpdate message, or as EntityEdit if the
+    /// properties don't fit that format. The gravity of the entity lets the acceleration be sent as a flag.
+    void queueSimulationUpdateMessage(const EntityItemID& entityItemID, const EntityItemProperties& properties,
+                                      const glm::vec3& gravity, const glm::vec3& routingPosition);
+
     void queueEraseEntityMessage(const EntityItemID& entityItemID);
 
     // My server type is the model server
@@ -38,7 +60,29 @@ public slots:
     void processEntityEditNackPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
     void toggleNackPackets() { _shouldProcessNack = !_shouldProcessNack; }
 
+protected:
+    virtual void releaseCoalescedMessages();
+
 private:
+    struct CoalescedEdit {
+        PacketType type;
+        EntityItemID entityItemID;
+        EntityPropertyFlags properties;
+        QByteArray message;
+        bool superseded;
+    };
+
+    void routeMessage(PacketType type, QByteArray& message, const glm::vec3& routingPosition);
+    void queueCoalescedMessage(PacketType type, const EntityItemID& entityItemID, const EntityPropertyFlags& properties,
+                               const QByteArray& message);
+    void releaseCoalescedMessagesLocked();
+
     bool _shouldProcessNack = true;
+
+    QMutex _coalescedEditsLock;
+    std::vector<CoalescedEdit> _coalescedEdits; // in the order they were queued
+    QHash<EntityItemID, QVector<int>> _coalescedEditIndices; // the edits of an entity since its last erase
+    int _coalescedBytes { 0 };
+    quint64 _coalescingStarted { 0 };
 };
 #endif // hifi_EntityEditPacketSender_h
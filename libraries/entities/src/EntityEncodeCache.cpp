@@ -0,0 +1,68 @@
+//
+//  EntityEncodeCache.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEncodeCache.h"
+
+EntityEncodeCache::EntityEncodeCache() {
+    OctreeElement::addUpdateHook(this);
+    OctreeElement::addDeleteHook(this);
+}
+
+EntityEncodeCache::~EntityEncodeCache() {
+    OctreeElement::removeDeleteHook(this);
+    OctreeElement::removeUpdateHook(this);
+}
+
+bool EntityEncodeCache::findEncodedEntity(const OctreeElement* element, const EntityItemPointer& entity,
+                                          QByteArray& encodedEntity) {
+    QReadLocker locker(&_lock);
+
+    auto elementIt = _elements.constFind(element);
+    if (elementIt == _elements.constEnd()) {
+        return false;
+    }
+
+    auto entityIt = elementIt->constFind(entity->getEntityItemID());
+    if (entityIt == elementIt->constEnd()) {
+        return false;
+    }
+
+    if (entityIt->lastEdited != entity->getLastEdited() || entityIt->lastUpdated != entity->getLastUpdated()
+        || entityIt->lastSimulated != entity->getLastSimulated()
+        || entityIt->lastChangedOnServer != entity->getLastChangedOnServer()) {
+        return false;
+    }
+
+    encodedEntity = entityIt->bytes;
+    return true;
+}
+
+void EntityEncodeCache::insertEncodedEntity(const OctreeElement* element, const EntityItemPointer& entity,
+                                            const QByteArray& encodedEntity) {
+    EncodedEntity encoded;
+    encoded.lastEdited = entity->getLastEdited();
+    encoded.lastUpdated = entity->getLastUpdated();
+    encoded.lastSimulated = entity->getLastSimulated();
+    encoded.lastChangedOnServer = entity->getLastChangedOnServer();
+    encoded.bytes = encodedEntity;
+
+    QWriteLocker locker(&_lock);
+    _elements[element].insert(entity->getEntityItemID(), encoded);
+}
+
+void EntityEncodeCache::elementUpdated(OctreeElementPointer element) {
+    QWriteLocker locker(&_lock);
+    _elements.remove(element.get());
+}
+
+void EntityEncodeCache::elementDeleted(OctreeElementPointer element) {
+    QWriteLocker locker(&_lock);
+    _elements.remove(element.get());
+}
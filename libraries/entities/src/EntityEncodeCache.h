@@ -0,0 +1,53 @@
+//
+//  EntityEncodeCache.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodeCache_h
+#define hifi_EntityEncodeCache_h
+
+#include <QByteArray>
+#include <QHash>
+#include <QReadWriteLock>
+
+#include <OctreeElement.h>
+
+#include "EntityItem.h"
+#include "EntityItemID.h"
+
+// Keeps the bitstream of every entity that was completely encoded by EntityTreeElement::appendElementData, so that
+// the send threads of all the viewers of an element serialize each of its entities only once between changes.
+// Entries are dropped when their element is updated or deleted, and an entity whose edit or simulation times moved
+// since it was encoded is never served from the cache.
+class EntityEncodeCache : public OctreeElementUpdateHook, public OctreeElementDeleteHook {
+public:
+    EntityEncodeCache();
+    ~EntityEncodeCache();
+
+    bool findEncodedEntity(const OctreeElement* element, const EntityItemPointer& entity, QByteArray& encodedEntity);
+    void insertEncodedEntity(const OctreeElement* element, const EntityItemPointer& entity, const QByteArray& encodedEntity);
+
+    virtual void elementUpdated(OctreeElementPointer element);
+    virtual void elementDeleted(OctreeElementPointer element);
+
+private:
+    struct EncodedEntity {
+        quint64 lastEdited;
+        quint64 lastUpdated;
+        quint64 lastSimulated;
+        quint64 lastChangedOnServer;
+        QByteArray bytes;
+    };
+
+    using ElementEntities = QHash<EntityItemID, EncodedEntity>;
+
+    QReadWriteLock _lock;
+    QHash<const OctreeElement*, ElementEntities> _elements;
+};
+
+#endif // hifi_EntityEncodeCache_h
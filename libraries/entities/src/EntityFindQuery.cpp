@@ -0,0 +1,84 @@
+//
+//  EntityFindQuery.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityFindQuery.h"
+
+#include <StreamUtils.h>
+
+#include "EntityItem.h"
+
+bool EntityFindQuery::passesFilter(const EntityItem& entity) const {
+    if (type != EntityTypes::Unknown && entity.getType() != type) {
+        return false;
+    }
+    return name.isEmpty() || entity.getName() == name;
+}
+
+QDataStream& operator<<(QDataStream& out, const EntityFindQuery& query) {
+    return out << query.requestID << (quint8)query.shape << query.position << query.radius << query.dimensions
+        << (quint8)query.type << query.name;
+}
+
+QDataStream& operator>>(QDataStream& in, EntityFindQuery& query) {
+    quint8 shape;
+    quint8 type;
+    in >> query.requestID >> shape >> query.position >> query.radius >> query.dimensions >> type >> query.name;
+    query.shape = (EntityFindQuery::Shape)shape;
+    query.type = (EntityTypes::EntityType)type;
+    return in;
+}
+
+EntityFindResult::EntityFindResult(const EntityItem& entity) :
+    id(entity.getID()),
+    type(entity.getType()),
+    name(entity.getName()),
+    position(entity.getPosition()),
+    rotation(entity.getRotation()),
+    dimensions(entity.getDimensions())
+{
+}
+
+static QVariantMap vec3ToVariantMap(const glm::vec3& vector) {
+    QVariantMap map;
+    map["x"] = vector.x;
+    map["y"] = vector.y;
+    map["z"] = vector.z;
+    return map;
+}
+
+QVariantMap EntityFindResult::toVariantMap() const {
+    QVariantMap rotationMap;
+    rotationMap["x"] = rotation.x;
+    rotationMap["y"] = rotation.y;
+    rotationMap["z"] = rotation.z;
+    rotationMap["w"] = rotation.w;
+
+    // the same names as the properties of the entity, for the scripts
+    QVariantMap map;
+    map["id"] = id;
+    map["type"] = EntityTypes::getEntityTypeName(type);
+    map["name"] = name;
+    map["position"] = vec3ToVariantMap(position);
+    map["rotation"] = rotationMap;
+    map["dimensions"] = vec3ToVariantMap(dimensions);
+    return map;
+}
+
+QDataStream& operator<<(QDataStream& out, const EntityFindResult& result) {
+    return out << result.id << (quint8)result.type << result.name << result.position << result.rotation
+        << result.dimensions;
+}
+
+QDataStream& operator>>(QDataStream& in, EntityFindResult& result) {
+    quint8 type;
+    in >> result.id >> type >> result.name >> result.position >> result.rotation >> result.dimensions;
+    result.type = (EntityTypes::EntityType)type;
+    return in;
+}
@@ -0,0 +1,71 @@
+//
+//  EntityFindQuery.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityFindQuery_h
+#define hifi_EntityFindQuery_h
+
+#include <QtCore/QDataStream>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+#include <QtCore/QVariantMap>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "EntityTypes.h"
+
+class EntityItem;
+
+// A search the entity server runs on its own tree for a client that does not keep a copy of it, like the agents
+// whose scripts only need to find the entities around their bots. It goes out in an EntityFind packet and the server
+// answers with the EntityFindResults of the entities in the volume that pass the filter, in an EntityFindReply.
+struct EntityFindQuery {
+    enum Shape : quint8 {
+        Sphere,
+        Box
+    };
+
+    quint32 requestID { 0 };
+    Shape shape { Sphere };
+
+    // the center and radius of the sphere, or the corner and dimensions of the box
+    glm::vec3 position;
+    float radius { 0.0f };
+    glm::vec3 dimensions;
+
+    EntityTypes::EntityType type { EntityTypes::Unknown }; // entities of any type when unknown
+    QString name; // entities of any name when empty
+
+    bool passesFilter(const EntityItem& entity) const;
+};
+
+QDataStream& operator<<(QDataStream& out, const EntityFindQuery& query);
+QDataStream& operator>>(QDataStream& in, EntityFindQuery& query);
+
+// What an EntityFindReply says about each entity that was found
+struct EntityFindResult {
+    EntityFindResult() {}
+    EntityFindResult(const EntityItem& entity);
+
+    QUuid id;
+    EntityTypes::EntityType type { EntityTypes::Unknown };
+    QString name;
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 dimensions;
+
+    QVariantMap toVariantMap() const;
+};
+
+QDataStream& operator<<(QDataStream& out, const EntityFindResult& result);
+QDataStream& operator>>(QDataStream& in, EntityFindResult& result);
+
+#endif // hifi_EntityFindQuery_h
@@ -36,44 +36,40 @@ bool EntityItem::_sendPhysicsUpdates = true;
 int EntityItem::_maxActionsDataSize = 800;
 quint64 EntityItem::_rememberDeletedActionTime = 20 * USECS_PER_SECOND;
 
+// shared by every entity until it sets one of the rarely used properties
+static const std::shared_ptr<EntityItemColdData> DEFAULT_COLD_DATA = std::make_shared<EntityItemColdData>();
+
 EntityItem::EntityItem(const EntityItemID& entityItemID) :
-    _type(EntityTypes::Unknown),
-    _id(entityItemID),
+    _transform(),
+    _velocity(ENTITY_ITEM_DEFAULT_VELOCITY),
+    _gravity(ENTITY_ITEM_DEFAULT_GRAVITY),
+    _acceleration(ENTITY_ITEM_DEFAULT_ACCELERATION),
+    _angularVelocity(ENTITY_ITEM_DEFAULT_ANGULAR_VELOCITY),
+    _damping(ENTITY_ITEM_DEFAULT_DAMPING),
+    _angularDamping(ENTITY_ITEM_DEFAULT_ANGULAR_DAMPING),
     _lastSimulated(0),
     _lastUpdated(0),
     _lastEdited(0),
+    _registrationPoint(ENTITY_ITEM_DEFAULT_REGISTRATION_POINT),
+    _visible(ENTITY_ITEM_DEFAULT_VISIBLE),
+    _ignoreForCollisions(ENTITY_ITEM_DEFAULT_IGNORE_FOR_COLLISIONS),
+    _collisionsWillMove(ENTITY_ITEM_DEFAULT_COLLISIONS_WILL_MOVE),
+    _locked(ENTITY_ITEM_DEFAULT_LOCKED),
+    _type(EntityTypes::Unknown),
+    _id(entityItemID),
     _lastEditedFromRemote(0),
     _lastEditedFromRemoteInRemoteTime(0),
     _created(UNKNOWN_CREATED_TIME),
     _changedOnServer(0),
-    _transform(),
     _glowLevel(ENTITY_ITEM_DEFAULT_GLOW_LEVEL),
     _localRenderAlpha(ENTITY_ITEM_DEFAULT_LOCAL_RENDER_ALPHA),
     _density(ENTITY_ITEM_DEFAULT_DENSITY),
     _volumeMultiplier(1.0f),
-    _velocity(ENTITY_ITEM_DEFAULT_VELOCITY),
-    _gravity(ENTITY_ITEM_DEFAULT_GRAVITY),
-    _acceleration(ENTITY_ITEM_DEFAULT_ACCELERATION),
-    _damping(ENTITY_ITEM_DEFAULT_DAMPING),
     _restitution(ENTITY_ITEM_DEFAULT_RESTITUTION),
     _friction(ENTITY_ITEM_DEFAULT_FRICTION),
     _lifetime(ENTITY_ITEM_DEFAULT_LIFETIME),
-    _script(ENTITY_ITEM_DEFAULT_SCRIPT),
-    _scriptTimestamp(ENTITY_ITEM_DEFAULT_SCRIPT_TIMESTAMP),
-    _collisionSoundURL(ENTITY_ITEM_DEFAULT_COLLISION_SOUND_URL),
-    _registrationPoint(ENTITY_ITEM_DEFAULT_REGISTRATION_POINT),
-    _angularVelocity(ENTITY_ITEM_DEFAULT_ANGULAR_VELOCITY),
-    _angularDamping(ENTITY_ITEM_DEFAULT_ANGULAR_DAMPING),
-    _visible(ENTITY_ITEM_DEFAULT_VISIBLE),
-    _ignoreForCollisions(ENTITY_ITEM_DEFAULT_IGNORE_FOR_COLLISIONS),
-    _collisionsWillMove(ENTITY_ITEM_DEFAULT_COLLISIONS_WILL_MOVE),
-    _locked(ENTITY_ITEM_DEFAULT_LOCKED),
-    _userData(ENTITY_ITEM_DEFAULT_USER_DATA),
     _simulationOwner(),
-    _marketplaceID(ENTITY_ITEM_DEFAULT_MARKETPLACE_ID),
-    _name(ENTITY_ITEM_DEFAULT_NAME),
-    _href(""),
-    _description(""),
+    _coldData(DEFAULT_COLD_DATA),
     _dirtyFlags(0),
     _element(nullptr),
     _physicsInfo(nullptr),
@@ -88,6 +84,13 @@ EntityItem::EntityItem(const EntityItemID& entityItemID) :
     _lastUpdated = now;
 }
 
+EntityItemColdData& EntityItem::editColdData() {
+    if (_coldData == DEFAULT_COLD_DATA) {
+        _coldData = std::make_shared<EntityItemColdData>(*DEFAULT_COLD_DATA);
+    }
+    return *_coldData;
+}
+
 EntityItem::~EntityItem() {
     // clear out any left-over actions
     EntityTreePointer entityTree = _element ? _element->getTree() : nullptr;
@@ -500,6 +503,11 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
         }
     }
 
+    // the cached entities were saved in the times of the last visit, the server has the up to date ones
+    if (_isFromCache && args.sourceNode) {
+        ignoreServerPacket = false;
+    }
+
     if (ignoreServerPacket) {
         overwriteLocalData = false;
         #ifdef WANT_DEBUG
@@ -516,6 +524,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
         _lastEdited = lastEditedFromBufferAdjusted;
         _lastEditedFromRemote = now;
         _lastEditedFromRemoteInRemoteTime = lastEditedFromBuffer;
+        _isFromCache = false;
 
         // TODO: only send this notification if something ACTUALLY changed (hint, we haven't yet parsed
         // the properties out of the bitstream (see below))
@@ -879,57 +888,32 @@ void EntityItem::simulate(const quint64& now) {
     _lastSimulated = now;
 }
 
+static float clampSimulationTimeElapsed(float timeElapsed) {
+    const float MIN_TIME_SKIP = 0.0f;
+    const float MAX_TIME_SKIP = 1.0f; // in seconds
+
+    return glm::clamp(timeElapsed, MIN_TIME_SKIP, MAX_TIME_SKIP);
+}
+
+float EntityItem::startSimulationStep(const quint64& now) {
+    if (_lastSimulated == 0) {
+        _lastSimulated = now;
+    }
+    return clampSimulationTimeElapsed((float)(now - _lastSimulated) / (float)(USECS_PER_SECOND));
+}
+
 void EntityItem::simulateKinematicMotion(float timeElapsed, bool setFlags) {
 #ifdef WANT_DEBUG
     qCDebug(entities) << "EntityItem::simulateKinematicMotion timeElapsed" << timeElapsed;
 #endif
     
-    const float MIN_TIME_SKIP = 0.0f;
-    const float MAX_TIME_SKIP = 1.0f; // in seconds
-    
-    timeElapsed = glm::clamp(timeElapsed, MIN_TIME_SKIP, MAX_TIME_SKIP);
+    timeElapsed = clampSimulationTimeElapsed(timeElapsed);
     
     if (hasActions()) {
         return;
     }
 
-    if (hasAngularVelocity()) {
-        // angular damping
-        if (_angularDamping > 0.0f) {
-            _angularVelocity *= powf(1.0f - _angularDamping, timeElapsed);
-            #ifdef WANT_DEBUG
-                qCDebug(entities) << "    angularDamping :" << _angularDamping;
-                qCDebug(entities) << "    newAngularVelocity:" << _angularVelocity;
-            #endif
-        }
-
-        float angularSpeed = glm::length(_angularVelocity);
-
-        const float EPSILON_ANGULAR_VELOCITY_LENGTH = 0.0017453f; // 0.0017453 rad/sec = 0.1f degrees/sec
-        if (angularSpeed < EPSILON_ANGULAR_VELOCITY_LENGTH) {
-            if (setFlags && angularSpeed > 0.0f) {
-                _dirtyFlags |= Simulation::DIRTY_MOTION_TYPE;
-            }
-            _angularVelocity = ENTITY_ITEM_ZERO_VEC3;
-        } else {
-            // for improved agreement with the way Bullet integrates rotations we use an approximation
-            // and break the integration into bullet-sized substeps
-            glm::quat rotation = getRotation();
-            float dt = timeElapsed;
-            while (dt > PHYSICS_ENGINE_FIXED_SUBSTEP) {
-                glm::quat  dQ = computeBulletRotationStep(_angularVelocity, PHYSICS_ENGINE_FIXED_SUBSTEP);
-                rotation = glm::normalize(dQ * rotation);
-                dt -= PHYSICS_ENGINE_FIXED_SUBSTEP;
-            }
-            // NOTE: this final partial substep can drift away from a real Bullet simulation however
-            // it only becomes significant for rapidly rotating objects
-            // (e.g. around PI/4 radians per substep, or 7.5 rotations/sec at 60 substeps/sec).
-            glm::quat  dQ = computeBulletRotationStep(_angularVelocity, dt);
-            rotation = glm::normalize(dQ * rotation);
-
-            setRotation(rotation);
-        }
-    }
+    simulateAngularMotion(timeElapsed, setFlags);
 
     if (hasVelocity()) {
         // linear damping
@@ -965,25 +949,68 @@ void EntityItem::simulateKinematicMotion(float timeElapsed, bool setFlags) {
             velocity += getAcceleration() * timeElapsed;
         }
 
-        float speed = glm::length(velocity);
-        const float EPSILON_LINEAR_VELOCITY_LENGTH = 0.001f; // 1mm/sec
-        if (speed < EPSILON_LINEAR_VELOCITY_LENGTH) {
-            setVelocity(ENTITY_ITEM_ZERO_VEC3);
-            if (setFlags && speed > 0.0f) {
+        finishLinearMotion(position, velocity, glm::length(velocity), setFlags);
+    }
+}
+
+void EntityItem::simulateAngularMotion(float timeElapsed, bool setFlags) {
+    if (hasAngularVelocity()) {
+        // angular damping
+        if (_angularDamping > 0.0f) {
+            _angularVelocity *= powf(1.0f - _angularDamping, timeElapsed);
+            #ifdef WANT_DEBUG
+                qCDebug(entities) << "    angularDamping :" << _angularDamping;
+                qCDebug(entities) << "    newAngularVelocity:" << _angularVelocity;
+            #endif
+        }
+
+        float angularSpeed = glm::length(_angularVelocity);
+
+        const float EPSILON_ANGULAR_VELOCITY_LENGTH = 0.0017453f; // 0.0017453 rad/sec = 0.1f degrees/sec
+        if (angularSpeed < EPSILON_ANGULAR_VELOCITY_LENGTH) {
+            if (setFlags && angularSpeed > 0.0f) {
                 _dirtyFlags |= Simulation::DIRTY_MOTION_TYPE;
             }
+            _angularVelocity = ENTITY_ITEM_ZERO_VEC3;
         } else {
-            setPosition(position);
-            setVelocity(velocity);
+            // for improved agreement with the way Bullet integrates rotations we use an approximation
+            // and break the integration into bullet-sized substeps
+            glm::quat rotation = getRotation();
+            float dt = timeElapsed;
+            while (dt > PHYSICS_ENGINE_FIXED_SUBSTEP) {
+                glm::quat  dQ = computeBulletRotationStep(_angularVelocity, PHYSICS_ENGINE_FIXED_SUBSTEP);
+                rotation = glm::normalize(dQ * rotation);
+                dt -= PHYSICS_ENGINE_FIXED_SUBSTEP;
+            }
+            // NOTE: this final partial substep can drift away from a real Bullet simulation however
+            // it only becomes significant for rapidly rotating objects
+            // (e.g. around PI/4 radians per substep, or 7.5 rotations/sec at 60 substeps/sec).
+            glm::quat  dQ = computeBulletRotationStep(_angularVelocity, dt);
+            rotation = glm::normalize(dQ * rotation);
+
+            setRotation(rotation);
         }
+    }
+}
 
-        #ifdef WANT_DEBUG
-            qCDebug(entities) << "    new position:" << position;
-            qCDebug(entities) << "    new velocity:" << velocity;
-            qCDebug(entities) << "    new AACube:" << getMaximumAACube();
-            qCDebug(entities) << "    old getAABox:" << getAABox();
-        #endif
+void EntityItem::finishLinearMotion(const glm::vec3& position, const glm::vec3& velocity, float speed, bool setFlags) {
+    const float EPSILON_LINEAR_VELOCITY_LENGTH = 0.001f; // 1mm/sec
+    if (speed < EPSILON_LINEAR_VELOCITY_LENGTH) {
+        setVelocity(ENTITY_ITEM_ZERO_VEC3);
+        if (setFlags && speed > 0.0f) {
+            _dirtyFlags |= Simulation::DIRTY_MOTION_TYPE;
+        }
+    } else {
+        setPosition(position);
+        setVelocity(velocity);
     }
+
+    #ifdef WANT_DEBUG
+        qCDebug(entities) << "    new position:" << position;
+        qCDebug(entities) << "    new velocity:" << velocity;
+        qCDebug(entities) << "    new AACube:" << getMaximumAACube();
+        qCDebug(entities) << "    old getAABox:" << getAABox();
+    #endif
 }
 
 bool EntityItem::isMoving() const {
@@ -1026,7 +1053,16 @@ quint64 EntityItem::getExpiry() const {
 
 EntityItemProperties EntityItem::getProperties(EntityPropertyFlags desiredProperties) const {
     EncodeBitstreamParams params; // unknown
-    EntityPropertyFlags propertyFlags = desiredProperties.isEmpty() ? getEntityProperties(params) : desiredProperties;
+    EntityPropertyFlags propertyFlags = desiredProperties;
+    if (propertyFlags.isEmpty()) {
+        // all the properties, including the ones scripts can only get
+        propertyFlags = getEntityProperties(params);
+        propertyFlags += PROP_CREATED;
+        propertyFlags += PROP_AGE;
+        propertyFlags += PROP_SITTING_POINTS;
+        propertyFlags += PROP_BOUNDING_BOX;
+        propertyFlags += PROP_ORIGINAL_TEXTURES;
+    }
     EntityItemProperties properties(propertyFlags);
     properties._id = getID();
     properties._idSet = true;
@@ -92,6 +92,20 @@ const float ACTIVATION_ANGULAR_VELOCITY_DELTA = 0.03f;
 #define assertUnlocked()
 #define assertWriteLocked()
 
+/// The rarely used properties of an EntityItem, kept apart so that the state simulation and rendering go through every
+/// frame takes fewer cache lines. Entities that never set any of them all share the same default instance.
+class EntityItemColdData {
+public:
+    QString script = ENTITY_ITEM_DEFAULT_SCRIPT;
+    quint64 scriptTimestamp = ENTITY_ITEM_DEFAULT_SCRIPT_TIMESTAMP;
+    QString collisionSoundURL = ENTITY_ITEM_DEFAULT_COLLISION_SOUND_URL;
+    QString userData = ENTITY_ITEM_DEFAULT_USER_DATA;
+    QString marketplaceID = ENTITY_ITEM_DEFAULT_MARKETPLACE_ID;
+    QString name = ENTITY_ITEM_DEFAULT_NAME;
+    QString href; //Hyperlink href
+    QString description; //Hyperlink description
+};
+
 /// EntityItem class this is the base class for all entity types. It handles the basic properties and functionality available
 /// to all other entity types. In particular: postion, size, rotation, age, lifetime, velocity, gravity. You can not instantiate
 /// one directly, instead you must only construct one of it's derived classes with additional features.
@@ -185,6 +199,11 @@ public:
     void simulate(const quint64& now);
     void simulateKinematicMotion(float timeElapsed, bool setFlags=true);
 
+    // the steps of simulate(), EntitySimulation integrates the linear motion of many entities together in between
+    float startSimulationStep(const quint64& now); // the clamped time since the last simulation
+    void simulateAngularMotion(float timeElapsed, bool setFlags=true);
+    void finishLinearMotion(const glm::vec3& position, const glm::vec3& velocity, float speed, bool setFlags=true);
+
     virtual bool needsToCallUpdate() const { return false; }
 
     virtual void debugDump() const;
@@ -217,11 +236,11 @@ public:
     inline void requiresRecalcBoxes() { _recalcAABox = true; _recalcMinAACube = true; _recalcMaxAACube = true; }
 
     // Hyperlink related getters and setters
-    QString getHref() const { return _href; }
-    void setHref(QString value) { _href = value; }
+    QString getHref() const { return _coldData->href; }
+    void setHref(QString value) { setColdProperty(&EntityItemColdData::href, value); }
 
-    QString getDescription() const { return _description; }
-    void setDescription(QString value) { _description = value; }
+    QString getDescription() const { return _coldData->description; }
+    void setDescription(QString value) { setColdProperty(&EntityItemColdData::description, value); }
 
     /// Dimensions in meters (0.0 - TREE_SCALE)
     inline const glm::vec3& getDimensions() const { return _transform.getScale(); }
@@ -283,14 +302,14 @@ public:
     const AACube& getMinimumAACube() const;
     const AABox& getAABox() const; /// axis aligned bounding box in world-frame (meters)
 
-    const QString& getScript() const { return _script; }
-    void setScript(const QString& value) { _script = value; }
+    const QString& getScript() const { return _coldData->script; }
+    void setScript(const QString& value) { setColdProperty(&EntityItemColdData::script, value); }
 
-    quint64 getScriptTimestamp() const { return _scriptTimestamp; }
-    void setScriptTimestamp(const quint64 value) { _scriptTimestamp = value; }
+    quint64 getScriptTimestamp() const { return _coldData->scriptTimestamp; }
+    void setScriptTimestamp(const quint64 value) { setColdProperty(&EntityItemColdData::scriptTimestamp, value); }
 
-    const QString& getCollisionSoundURL() const { return _collisionSoundURL; }
-    void setCollisionSoundURL(const QString& value) { _collisionSoundURL = value; }
+    const QString& getCollisionSoundURL() const { return _coldData->collisionSoundURL; }
+    void setCollisionSoundURL(const QString& value) { setColdProperty(&EntityItemColdData::collisionSoundURL, value); }
 
     const glm::vec3& getRegistrationPoint() const { return _registrationPoint; } /// registration point as ratio of entity
 
@@ -305,8 +324,8 @@ public:
     float getAngularDamping() const { return _angularDamping; }
     void setAngularDamping(float value) { _angularDamping = value; }
 
-    QString getName() const { return _name; }
-    void setName(const QString& value) { _name = value; }
+    QString getName() const { return _coldData->name; }
+    void setName(const QString& value) { setColdProperty(&EntityItemColdData::name, value); }
 
     bool getVisible() const { return _visible; }
     void setVisible(bool value) { _visible = value; }
@@ -324,8 +343,8 @@ public:
     bool getLocked() const { return _locked; }
     void setLocked(bool value) { _locked = value; }
 
-    const QString& getUserData() const { return _userData; }
-    virtual void setUserData(const QString& value) { _userData = value; }
+    const QString& getUserData() const { return _coldData->userData; }
+    virtual void setUserData(const QString& value) { setColdProperty(&EntityItemColdData::userData, value); }
 
     const SimulationOwner& getSimulationOwner() const { return _simulationOwner; }
     void setSimulationOwner(const QUuid& id, quint8 priority);
@@ -337,8 +356,8 @@ public:
     void updateSimulatorID(const QUuid& value);
     void clearSimulationOwnership();
 
-    const QString& getMarketplaceID() const { return _marketplaceID; }
-    void setMarketplaceID(const QString& value) { _marketplaceID = value; }
+    const QString& getMarketplaceID() const { return _coldData->marketplaceID; }
+    void setMarketplaceID(const QString& value) { setColdProperty(&EntityItemColdData::marketplaceID, value); }
 
     // TODO: get rid of users of getRadius()...
     float getRadius() const;
@@ -392,6 +411,10 @@ public:
 
     quint64 getLastEditedFromRemote() { return _lastEditedFromRemote; }
 
+    /// kept from an earlier visit to the domain, until the server sends it again: whatever it sends replaces it
+    bool isFromCache() const { return _isFromCache; }
+    void setIsFromCache(bool isFromCache) { _isFromCache = isFromCache; }
+
     void getAllTerseUpdateProperties(EntityItemProperties& properties) const;
 
     void flagForOwnership() { _dirtyFlags |= Simulation::DIRTY_SIMULATOR_OWNERSHIP; }
@@ -419,27 +442,41 @@ protected:
     void setActionDataInternal(QByteArray actionData);
 
     static bool _sendPhysicsUpdates;
-    EntityTypes::EntityType _type;
-    QUuid _id;
+
+    // the state simulation and rendering read every frame comes first, together
+    Transform _transform;
+    glm::vec3 _velocity;
+    glm::vec3 _gravity;
+    glm::vec3 _acceleration;
+    glm::vec3 _angularVelocity;
+    float _damping;
+    float _angularDamping;
     quint64 _lastSimulated; // last time this entity called simulate(), this includes velocity, angular velocity,
                             // and physics changes
     quint64 _lastUpdated; // last time this entity called update(), this includes animations and non-physics changes
     quint64 _lastEdited; // last official local or remote edit time
+    glm::vec3 _registrationPoint;
+    mutable AABox _cachedAABox;
+    mutable AACube _maxAACube;
+    mutable AACube _minAACube;
+    mutable bool _recalcAABox = true;
+    mutable bool _recalcMinAACube = true;
+    mutable bool _recalcMaxAACube = true;
+    bool _visible;
+    bool _ignoreForCollisions;
+    bool _collisionsWillMove;
+    bool _locked;
+
+    EntityTypes::EntityType _type;
+    QUuid _id;
     quint64 _lastBroadcast; // the last time we sent an edit packet about this entity
 
     quint64 _lastEditedFromRemote; // last time we received and edit from the server
+    bool _isFromCache { false };
     quint64 _lastEditedFromRemoteInRemoteTime; // last time we received an edit from the server (in server-time-frame)
     quint64 _created;
     quint64 _changedOnServer;
 
-    Transform _transform;
-    mutable AABox _cachedAABox;
-    mutable AACube _maxAACube;
-    mutable AACube _minAACube;
-    mutable bool _recalcAABox = true;
-    mutable bool _recalcMinAACube = true;
-    mutable bool _recalcMaxAACube = true;
-    
     float _glowLevel;
     float _localRenderAlpha;
     float _density = ENTITY_ITEM_DEFAULT_DENSITY; // kg/m^3
@@ -447,29 +484,22 @@ protected:
     // rather than in all of the derived classes.  If we ever collapse these classes to one we could do it a
     // different way.
     float _volumeMultiplier = 1.0f;
-    glm::vec3 _velocity;
-    glm::vec3 _gravity;
-    glm::vec3 _acceleration;
-    float _damping;
     float _restitution;
     float _friction;
     float _lifetime;
-    QString _script;
-    quint64 _scriptTimestamp;
-    QString _collisionSoundURL;
-    glm::vec3 _registrationPoint;
-    glm::vec3 _angularVelocity;
-    float _angularDamping;
-    bool _visible;
-    bool _ignoreForCollisions;
-    bool _collisionsWillMove;
-    bool _locked;
-    QString _userData;
     SimulationOwner _simulationOwner;
-    QString _marketplaceID;
-    QString _name;
-    QString _href; //Hyperlink href
-    QString _description; //Hyperlink description
+
+    // the rarely used properties, shared with the default instance until one of them is set
+    std::shared_ptr<EntityItemColdData> _coldData;
+    EntityItemColdData& editColdData();
+
+    template <typename T>
+    void setColdProperty(T EntityItemColdData::* property, const T& value) {
+        // decoding sets every property it reads, don't stop sharing the defaults for an unchanged value
+        if (!((*_coldData).*property == value)) {
+            editColdData().*property = value;
+        }
+    }
 
     // NOTE: Damping is applied like this:  v *= pow(1 - damping, dt)
     //
@@ -32,6 +32,17 @@ KeyLightPropertyGroup EntityItemProperties::_staticKeyLight;
 
 EntityPropertyList PROP_LAST_ITEM = (EntityPropertyList)(PROP_AFTER_LAST_ITEM - 1);
 
+// the properties that non default values are compared to, built once since they are the same for every conversion
+static std::once_flag initDefaultEntityProperties;
+static EntityItemProperties* defaultEntityPropertiesInstance { nullptr };
+
+static const EntityItemProperties& getDefaultEntityProperties() {
+    std::call_once(initDefaultEntityProperties, [] {
+        defaultEntityPropertiesInstance = new EntityItemProperties();
+    });
+    return *defaultEntityPropertiesInstance;
+}
+
 EntityItemProperties::EntityItemProperties(EntityPropertyFlags desiredProperties) :
 
 _id(UNKNOWN_ENTITY_ID),
@@ -272,18 +283,20 @@ EntityPropertyFlags EntityItemProperties::getChangedProperties() const {
 
 QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine, bool skipDefaults) const {
     QScriptValue properties = engine->newObject();
-    EntityItemProperties defaultEntityProperties;
+    const EntityItemProperties& defaultEntityProperties = getDefaultEntityProperties();
 
     if (_idSet) {
         COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_ALWAYS(id, _id.toString());
     }
 
     COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_ALWAYS(type, EntityTypes::getEntityTypeName(_type));
-    auto created = QDateTime::fromMSecsSinceEpoch(getCreated() / 1000.0f, Qt::UTC); // usec per msec
-    created.setTimeSpec(Qt::OffsetFromUTC);
-    COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_ALWAYS(created, created.toString(Qt::ISODate));
+    if (isDesiredProperty(PROP_CREATED)) {
+        auto created = QDateTime::fromMSecsSinceEpoch(getCreated() / 1000.0f, Qt::UTC); // usec per msec
+        created.setTimeSpec(Qt::OffsetFromUTC);
+        COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_ALWAYS(created, created.toString(Qt::ISODate));
+    }
 
-    if (!skipDefaults || _lifetime != defaultEntityProperties._lifetime) {
+    if (isDesiredProperty(PROP_AGE) && (!skipDefaults || _lifetime != defaultEntityProperties._lifetime)) {
         COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_NO_SKIP(age, getAge()); // gettable, but not settable
         COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_NO_SKIP(ageAsText, formatSecondsElapsed(getAge())); // gettable, but not settable
     }
@@ -435,7 +448,7 @@ QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine, bool
     }
 
     // Sitting properties support
-    if (!skipDefaults) {
+    if (!skipDefaults && isDesiredProperty(PROP_SITTING_POINTS)) {
         QScriptValue sittingPoints = engine->newObject();
         for (int i = 0; i < _sittingPoints.size(); ++i) {
             QScriptValue sittingPoint = engine->newObject();
@@ -448,7 +461,7 @@ QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine, bool
         COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_ALWAYS(sittingPoints, sittingPoints); // gettable, but not settable
     }
 
-    if (!skipDefaults) {
+    if (!skipDefaults && isDesiredProperty(PROP_BOUNDING_BOX)) {
         AABox aaBox = getAABox();
         QScriptValue boundingBox = engine->newObject();
         QScriptValue bottomRightNear = vec3toScriptValue(engine, aaBox.getCorner());
@@ -462,8 +475,8 @@ QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine, bool
         COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_NO_SKIP(boundingBox, boundingBox); // gettable, but not settable
     }
 
-    QString textureNamesList = _textureNames.join(",\n");
-    if (!skipDefaults) {
+    if (!skipDefaults && isDesiredProperty(PROP_ORIGINAL_TEXTURES)) {
+        QString textureNamesList = _textureNames.join(",\n");
         COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_NO_SKIP(originalTextures, textureNamesList); // gettable, but not settable
     }
 
@@ -752,8 +765,15 @@ void EntityItemProperties::entityPropertyFlagsFromScriptValue(const QScriptValue
         ADD_GROUP_PROPERTY_TO_MAP(PROP_STAGE_HOUR, Stage, stage, Hour, hour);
         ADD_GROUP_PROPERTY_TO_MAP(PROP_STAGE_AUTOMATIC_HOURDAY, Stage, stage, AutomaticHourDay, automaticHourDay);
 
-        // FIXME - these are not yet handled
-        //ADD_PROPERTY_TO_MAP(PROP_CREATED, Created, created, quint64);
+        // gettable, but not settable
+        ADD_PROPERTY_TO_MAP(PROP_CREATED, Created, created, quint64);
+        ADD_PROPERTY_TO_MAP(PROP_AGE, Age, age, float);
+        ADD_PROPERTY_TO_MAP(PROP_AGE, AgeAsText, ageAsText, QString);
+        ADD_PROPERTY_TO_MAP(PROP_DIMENSIONS, NaturalDimensions, naturalDimensions, glm::vec3);
+        ADD_PROPERTY_TO_MAP(PROP_POSITION, NaturalPosition, naturalPosition, glm::vec3);
+        ADD_PROPERTY_TO_MAP(PROP_SITTING_POINTS, SittingPoints, sittingPoints, QVector<SittingPoint>);
+        ADD_PROPERTY_TO_MAP(PROP_BOUNDING_BOX, BoundingBox, boundingBox, AABox);
+        ADD_PROPERTY_TO_MAP(PROP_ORIGINAL_TEXTURES, OriginalTextures, originalTextures, QString);
 
     });
 
@@ -795,14 +815,11 @@ bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItem
     bool success = true; // assume the best
     OctreeElement::AppendState appendState = OctreeElement::COMPLETED; // assume the best
 
-    // TODO: We need to review how jurisdictions should be handled for entities. (The old Models and Particles code
-    // didn't do anything special for jurisdictions, so we're keeping that same behavior here.)
-    //
-    // Always include the root octcode. This is only because the OctreeEditPacketSender will check these octcodes
-    // to determine which server to send the changes to in the case of multiple jurisdictions. The root will be sent
-    // to all servers.
+    // Always include the root octcode. The OctreeEditPacketSender checks these octcodes to determine which server to
+    // send the changes to in the case of multiple jurisdictions, and the root is sent to all servers. When it knows
+    // several jurisdictions, the EntityEditPacketSender replaces it with the octcode of the entity's position.
     glm::vec3 rootPosition(0);
-    float rootScale = 0.5f;
+    float rootScale = 1.0f;
     unsigned char* octcode = pointToOctalCode(rootPosition.x, rootPosition.y, rootPosition.z, rootScale);
 
     success = packetData->startSubTree(octcode);
@@ -83,6 +83,11 @@ public:
         { return (float)(usecTimestampNow() - getLastEdited()) / (float)USECS_PER_SECOND; }
     EntityPropertyFlags getChangedProperties() const;
 
+    // whether the property is one of the desired ones, all of them are when none are named
+    bool isDesiredProperty(EntityPropertyList property) const {
+        return _desiredProperties.isEmpty() || _desiredProperties.getHasProperty(property);
+    }
+
     AACube getMaximumAACube() const;
     AABox getAABox() const;
 
@@ -156,6 +156,15 @@ enum EntityPropertyList {
     PROP_AFTER_LAST_ITEM,
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    // Properties that scripts can get but not set, they are never sent, and only exist so that scripts can ask for
+    // them by name in a set of desired properties
+    PROP_CREATED,
+    PROP_AGE,
+    PROP_SITTING_POINTS,
+    PROP_BOUNDING_BOX,
+    PROP_ORIGINAL_TEXTURES,
+
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     // WARNING! Do not add props here unless you intentionally mean to reuse PROP_ indexes
     //
@@ -0,0 +1,33 @@
+//
+//  EntityRayPick.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityRayPick.h"
+
+#include <cfloat>
+
+#include "EntityItem.h"
+
+bool EntityRayPickFilter::passes(const EntityItem& entity) const {
+    if (!include.isEmpty() && !include.contains(entity.getEntityItemID())) {
+        return false;
+    }
+    if (exclude.contains(entity.getEntityItemID())) {
+        return false;
+    }
+    return types.isEmpty() || types.contains(entity.getType());
+}
+
+void EntityRayPick::resetResult() {
+    intersects = false;
+    distance = FLT_MAX;
+    face = UNKNOWN_FACE;
+    surfaceNormal = glm::vec3();
+    entity.reset();
+}
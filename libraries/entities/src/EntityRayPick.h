@@ -0,0 +1,52 @@
+//
+//  EntityRayPick.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityRayPick_h
+#define hifi_EntityRayPick_h
+
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+#include <BoxBase.h>
+
+#include "EntityItemID.h"
+#include "EntityTypes.h"
+
+// Which entities a pick can hit
+class EntityRayPickFilter {
+public:
+    QVector<EntityItemID> include; // any entity when empty
+    QVector<EntityItemID> exclude;
+    QSet<EntityTypes::EntityType> types; // entities of any type when empty
+    bool precisionPicking { false };
+
+    bool passes(const EntityItem& entity) const;
+};
+
+// A ray cast into the entity tree along with the others of a frame, see EntityTree::findRayIntersections
+class EntityRayPick {
+public:
+    glm::vec3 origin;
+    glm::vec3 direction;
+    EntityRayPickFilter filter;
+
+    // the closest entity the ray hits, if it does
+    bool intersects { false };
+    float distance { 0.0f };
+    BoxFace face { UNKNOWN_FACE };
+    glm::vec3 surfaceNormal;
+    EntityItemPointer entity;
+
+    void resetResult();
+};
+
+#endif // hifi_EntityRayPick_h
@@ -0,0 +1,116 @@
+//
+//  EntityRayPickManager.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityRayPickManager.h"
+
+#include <PerfStat.h>
+
+EntityRayPickManager::PickID EntityRayPickManager::addPick(const EntityRayPickFilter& filter) {
+    QMutexLocker locker(&_picksLock);
+    PickID pickID = ++_lastPickID;
+    _picks[pickID].pick.filter = filter;
+    return pickID;
+}
+
+EntityRayPickManager::PickID EntityRayPickManager::addOneShotPick(const glm::vec3& origin, const glm::vec3& direction,
+                                                                  const EntityRayPickFilter& filter) {
+    QMutexLocker locker(&_picksLock);
+    PickID pickID = ++_lastPickID;
+    Pick& pick = _picks[pickID];
+    pick.pick.origin = origin;
+    pick.pick.direction = direction;
+    pick.pick.filter = filter;
+    pick.hasRay = true;
+    pick.isOneShot = true;
+    return pickID;
+}
+
+void EntityRayPickManager::removePick(PickID pickID) {
+    QMutexLocker locker(&_picksLock);
+    _picks.remove(pickID);
+}
+
+void EntityRayPickManager::setRay(PickID pickID, const glm::vec3& origin, const glm::vec3& direction) {
+    QMutexLocker locker(&_picksLock);
+    auto it = _picks.find(pickID);
+    if (it != _picks.end() && !it->isOneShot) {
+        it->pick.origin = origin;
+        it->pick.direction = direction;
+        it->hasRay = true;
+    }
+}
+
+void EntityRayPickManager::clearRay(PickID pickID) {
+    QMutexLocker locker(&_picksLock);
+    auto it = _picks.find(pickID);
+    if (it != _picks.end() && !it->isOneShot) {
+        it->hasRay = false;
+        it->hasResult = false;
+    }
+}
+
+bool EntityRayPickManager::getResult(PickID pickID, EntityRayPick& result) const {
+    QMutexLocker locker(&_picksLock);
+    auto it = _picks.find(pickID);
+    if (it == _picks.end() || !it->hasResult) {
+        return false;
+    }
+    result = it->result;
+    return true;
+}
+
+bool EntityRayPickManager::update(EntityTreePointer tree) {
+    if (!tree) {
+        return false;
+    }
+    PerformanceTimer perfTimer("EntityRayPickManager::update");
+
+    // the picks are cast from copies, so that they can still be moved and read while the tree is searched
+    QVector<PickID> pickIDs;
+    QVector<EntityRayPick> picks;
+    {
+        QMutexLocker locker(&_picksLock);
+        for (auto it = _picks.begin(); it != _picks.end();) {
+            // the one shot picks were read for a frame
+            if (it->isOneShot && it->hasResult) {
+                it = _picks.erase(it);
+                continue;
+            }
+            if (it->hasRay) {
+                pickIDs << it.key();
+                picks << it->pick;
+            }
+            ++it;
+        }
+    }
+    if (picks.isEmpty()) {
+        return true;
+    }
+
+    QVector<EntityRayPick*> pickPointers;
+    pickPointers.reserve(picks.size());
+    for (int i = 0; i < picks.size(); i++) {
+        pickPointers << &picks[i];
+    }
+    if (!tree->findRayIntersections(pickPointers, Octree::TryLock)) {
+        return false;
+    }
+
+    QMutexLocker locker(&_picksLock);
+    for (int i = 0; i < pickIDs.size(); i++) {
+        auto it = _picks.find(pickIDs[i]);
+        if (it == _picks.end()) {
+            continue; // removed while it was cast
+        }
+        it->result = picks[i];
+        it->hasResult = true;
+    }
+    return true;
+}
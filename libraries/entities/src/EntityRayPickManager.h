@@ -0,0 +1,58 @@
+//
+//  EntityRayPickManager.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityRayPickManager_h
+#define hifi_EntityRayPickManager_h
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+#include "EntityRayPick.h"
+#include "EntityTree.h"
+
+// The rays the mouse, the hand controllers and the scripts cast into the entities, cast together once a frame so that
+// each of them does not take the lock and traverse the tree on its own. A persistent pick is moved with setRay and
+// keeps the result of its last cast, a one shot pick is cast once and can be read until the picks are cast again.
+// The picks can be made and read from any thread.
+class EntityRayPickManager {
+public:
+    using PickID = quint32;
+    static const PickID INVALID_PICK_ID = 0;
+
+    /// a persistent pick, only cast once it has a ray
+    PickID addPick(const EntityRayPickFilter& filter);
+    PickID addOneShotPick(const glm::vec3& origin, const glm::vec3& direction, const EntityRayPickFilter& filter);
+    void removePick(PickID pickID);
+
+    void setRay(PickID pickID, const glm::vec3& origin, const glm::vec3& direction);
+    /// the pick is not cast and has no result until its ray is set again
+    void clearRay(PickID pickID);
+
+    /// \return false if the pick does not exist or has not been cast yet
+    bool getResult(PickID pickID, EntityRayPick& result) const;
+
+    /// casts the picks with a ray, false if they could not get the lock and will be cast the next time instead
+    bool update(EntityTreePointer tree);
+
+private:
+    struct Pick {
+        EntityRayPick pick;
+        EntityRayPick result; // with the ray it was cast along, the pick may have moved since
+        bool hasRay { false };
+        bool hasResult { false };
+        bool isOneShot { false };
+    };
+
+    mutable QMutex _picksLock;
+    QHash<PickID, Pick> _picks;
+    PickID _lastPickID { INVALID_PICK_ID };
+};
+
+#endif // hifi_EntityRayPickManager_h
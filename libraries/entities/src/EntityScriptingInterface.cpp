@@ -38,6 +38,12 @@ void EntityScriptingInterface::queueEntityMessage(PacketType packetType,
     getEntityPacketSender()->queueEditEntityMessage(packetType, entityID, properties);
 }
 
+void EntityScriptingInterface::queueEntityMessage(PacketType packetType, EntityItemID entityID,
+                                                  const EntityItemProperties& properties,
+                                                  const glm::vec3& routingPosition) {
+    getEntityPacketSender()->queueEditEntityMessage(packetType, entityID, properties, routingPosition);
+}
+
 bool EntityScriptingInterface::canAdjustLocks() {
     auto nodeList = DependencyManager::get<NodeList>();
     return nodeList->getThisNodeCanAdjustLocks();
@@ -111,21 +117,24 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
         _entityTree->withReadLock([&] {
             EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(identity));
             if (entity) {
-                results = entity->getProperties(desiredProperties);
-
-                // TODO: improve sitting points and naturalDimensions in the future,
-                //       for now we've included the old sitting points model behavior for entity types that are models
-                //        we've also added this hack for setting natural dimensions of models
-                if (entity->getType() == EntityTypes::Model) {
-                    const FBXGeometry* geometry = _entityTree->getGeometryForEntity(entity);
-                    if (geometry) {
-                        results.setSittingPoints(geometry->sittingPoints);
-                        Extents meshExtents = geometry->getUnscaledMeshExtents();
-                        results.setNaturalDimensions(meshExtents.maximum - meshExtents.minimum);
-                        results.calculateNaturalPosition(meshExtents.minimum, meshExtents.maximum);
-                    }
-                }
+                results = getPropertiesOfEntity(entity, desiredProperties);
+            }
+        });
+    }
 
+    return results;
+}
+
+QVector<EntityItemProperties> EntityScriptingInterface::getMultipleEntityProperties(const QVector<QUuid>& entityIDs,
+                                                                                   EntityPropertyFlags desiredProperties) {
+    QVector<EntityItemProperties> results(entityIDs.size());
+    if (_entityTree) {
+        _entityTree->withReadLock([&] {
+            for (int i = 0; i < entityIDs.size(); i++) {
+                EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(entityIDs[i]));
+                if (entity) {
+                    results[i] = getPropertiesOfEntity(entity, desiredProperties);
+                }
             }
         });
     }
@@ -133,6 +142,27 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
     return results;
 }
 
+EntityItemProperties EntityScriptingInterface::getPropertiesOfEntity(EntityItemPointer entity,
+                                                                     EntityPropertyFlags desiredProperties) {
+    EntityItemProperties results = entity->getProperties(desiredProperties);
+
+    // TODO: improve sitting points and naturalDimensions in the future,
+    //       for now we've included the old sitting points model behavior for entity types that are models
+    //        we've also added this hack for setting natural dimensions of models
+    bool wantsGeometryProperties = results.isDesiredProperty(PROP_SITTING_POINTS) ||
+        results.isDesiredProperty(PROP_DIMENSIONS) || results.isDesiredProperty(PROP_POSITION);
+    if (entity->getType() == EntityTypes::Model && wantsGeometryProperties) {
+        const FBXGeometry* geometry = _entityTree->getGeometryForEntity(entity);
+        if (geometry) {
+            results.setSittingPoints(geometry->sittingPoints);
+            Extents meshExtents = geometry->getUnscaledMeshExtents();
+            results.setNaturalDimensions(meshExtents.maximum - meshExtents.minimum);
+            results.calculateNaturalPosition(meshExtents.minimum, meshExtents.maximum);
+        }
+    }
+    return results;
+}
+
 QUuid EntityScriptingInterface::editEntity(QUuid id, EntityItemProperties properties) {
     EntityItemID entityID(id);
     // If we have a local entity tree set, then also update it.
@@ -141,8 +171,14 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, EntityItemProperties proper
         return id;
     }
 
+    // the edit goes to the server that has the entity where it was before the edit
+    glm::vec3 routingPosition(0.0f);
     bool updatedEntity = false;
     _entityTree->withWriteLock([&] {
+        EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
+        if (entity) {
+            routingPosition = entity->getPosition();
+        }
         updatedEntity = _entityTree->updateEntity(entityID, properties);
     });
 
@@ -154,43 +190,96 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, EntityItemProperties proper
     _entityTree->withReadLock([&] {
         EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
         if (entity) {
-            // make sure the properties has a type, so that the encode can know which properties to include
-            properties.setType(entity->getType());
-            bool hasTerseUpdateChanges = properties.hasTerseUpdateChanges();
-            bool hasPhysicsChanges = properties.hasMiscPhysicsChanges() || hasTerseUpdateChanges;
-            if (hasPhysicsChanges) {
-                auto nodeList = DependencyManager::get<NodeList>();
-                const QUuid myNodeID = nodeList->getSessionUUID();
+            prepareEditForEntity(entity, properties);
+        }
+    });
+    queueEntityMessage(PacketType::EntityEdit, entityID, properties, routingPosition);
+    return id;
+}
 
-                if (entity->getSimulatorID() == myNodeID) {
-                    // we think we already own the simulation, so make sure to send ALL TerseUpdate properties
-                    if (hasTerseUpdateChanges) {
-                        entity->getAllTerseUpdateProperties(properties);
-                    }
-                    // TODO: if we knew that ONLY TerseUpdate properties have changed in properties AND the object 
-                    // is dynamic AND it is active in the physics simulation then we could chose to NOT queue an update 
-                    // and instead let the physics simulation decide when to send a terse update.  This would remove
-                    // the "slide-no-rotate" glitch (and typical a double-update) that we see during the "poke rolling
-                    // balls" test.  However, even if we solve this problem we still need to provide a "slerp the visible
-                    // proxy toward the true physical position" feature to hide the final glitches in the remote watcher's
-                    // simulation.
-
-                    if (entity->getSimulationPriority() < SCRIPT_EDIT_SIMULATION_PRIORITY) {
-                        // we re-assert our simulation ownership at a higher priority
-                        properties.setSimulationOwner(myNodeID,
-                            glm::max(entity->getSimulationPriority(), SCRIPT_EDIT_SIMULATION_PRIORITY));
-                    }
-                } else {
-                    // we make a bid for simulation ownership
-                    properties.setSimulationOwner(myNodeID, SCRIPT_EDIT_SIMULATION_PRIORITY);
-                    entity->flagForOwnership();
-                }
+QVector<QUuid> EntityScriptingInterface::editEntities(const QVector<QUuid>& entityIDs,
+                                                      const QVector<EntityItemProperties>& properties) {
+    QVector<QUuid> results(entityIDs.size());
+    if (properties.size() != entityIDs.size() && properties.size() != 1) {
+        qCDebug(entities) << "editEntities expects one set of properties, or one for each entity, got"
+            << properties.size() << "for" << entityIDs.size() << "entities";
+        return results;
+    }
+
+    QVector<EntityItemProperties> edits(entityIDs.size());
+    for (int i = 0; i < entityIDs.size(); i++) {
+        edits[i] = properties[properties.size() == 1 ? 0 : i];
+    }
+
+    if (!_entityTree) {
+        for (int i = 0; i < entityIDs.size(); i++) {
+            queueEntityMessage(PacketType::EntityEdit, EntityItemID(entityIDs[i]), edits[i]);
+            results[i] = entityIDs[i];
+        }
+        getEntityPacketSender()->releaseQueuedMessages();
+        return results;
+    }
+
+    // the whole batch is applied under one lock, the write lock lets the ownership be worked out right after each update
+    QVector<glm::vec3> routingPositions(entityIDs.size());
+    _entityTree->withWriteLock([&] {
+        for (int i = 0; i < entityIDs.size(); i++) {
+            EntityItemID entityID(entityIDs[i]);
+            EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
+            if (!entity) {
+                continue;
+            }
+            routingPositions[i] = entity->getPosition();
+            if (_entityTree->updateEntity(entityID, edits[i])) {
+                prepareEditForEntity(entity, edits[i]);
+                results[i] = entityIDs[i];
             }
-            entity->setLastBroadcast(usecTimestampNow());
         }
     });
-    queueEntityMessage(PacketType::EntityEdit, entityID, properties);
-    return id;
+
+    for (int i = 0; i < entityIDs.size(); i++) {
+        if (!results[i].isNull()) {
+            queueEntityMessage(PacketType::EntityEdit, EntityItemID(entityIDs[i]), edits[i], routingPositions[i]);
+        }
+    }
+    getEntityPacketSender()->releaseQueuedMessages();
+    return results;
+}
+
+void EntityScriptingInterface::prepareEditForEntity(EntityItemPointer entity, EntityItemProperties& properties) {
+    // make sure the properties has a type, so that the encode can know which properties to include
+    properties.setType(entity->getType());
+    bool hasTerseUpdateChanges = properties.hasTerseUpdateChanges();
+    bool hasPhysicsChanges = properties.hasMiscPhysicsChanges() || hasTerseUpdateChanges;
+    if (hasPhysicsChanges) {
+        auto nodeList = DependencyManager::get<NodeList>();
+        const QUuid myNodeID = nodeList->getSessionUUID();
+
+        if (entity->getSimulatorID() == myNodeID) {
+            // we think we already own the simulation, so make sure to send ALL TerseUpdate properties
+            if (hasTerseUpdateChanges) {
+                entity->getAllTerseUpdateProperties(properties);
+            }
+            // TODO: if we knew that ONLY TerseUpdate properties have changed in properties AND the object 
+            // is dynamic AND it is active in the physics simulation then we could chose to NOT queue an update 
+            // and instead let the physics simulation decide when to send a terse update.  This would remove
+            // the "slide-no-rotate" glitch (and typical a double-update) that we see during the "poke rolling
+            // balls" test.  However, even if we solve this problem we still need to provide a "slerp the visible
+            // proxy toward the true physical position" feature to hide the final glitches in the remote watcher's
+            // simulation.
+
+            if (entity->getSimulationPriority() < SCRIPT_EDIT_SIMULATION_PRIORITY) {
+                // we re-assert our simulation ownership at a higher priority
+                properties.setSimulationOwner(myNodeID,
+                    glm::max(entity->getSimulationPriority(), SCRIPT_EDIT_SIMULATION_PRIORITY));
+            }
+        } else {
+            // we make a bid for simulation ownership
+            properties.setSimulationOwner(myNodeID, SCRIPT_EDIT_SIMULATION_PRIORITY);
+            entity->flagForOwnership();
+        }
+    }
+    entity->setLastBroadcast(usecTimestampNow());
 }
 
 void EntityScriptingInterface::deleteEntity(QUuid id) {
@@ -309,6 +398,66 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorke
     return result;
 }
 
+static EntityRayPickFilter rayPickFilterFromScriptValue(const QScriptValue& filter) {
+    EntityRayPickFilter pickFilter;
+    if (!filter.isObject()) {
+        return pickFilter;
+    }
+
+    pickFilter.include = qVectorEntityItemIDFromScriptValue(filter.property("include"));
+    pickFilter.exclude = qVectorEntityItemIDFromScriptValue(filter.property("exclude"));
+    pickFilter.precisionPicking = filter.property("precisionPicking").toBool();
+
+    QScriptValue types = filter.property("types");
+    if (types.isArray()) {
+        int length = types.property("length").toInteger();
+        for (int i = 0; i < length; i++) {
+            EntityTypes::EntityType type = EntityTypes::getEntityTypeFromName(types.property(i).toString());
+            if (type != EntityTypes::Unknown) {
+                pickFilter.types.insert(type);
+            }
+        }
+    }
+    return pickFilter;
+}
+
+quint32 EntityScriptingInterface::createRayPick(const QScriptValue& filter) {
+    return _rayPickManager.addPick(rayPickFilterFromScriptValue(filter));
+}
+
+void EntityScriptingInterface::setRayPickRay(quint32 pickID, const PickRay& ray) {
+    _rayPickManager.setRay(pickID, ray.origin, ray.direction);
+}
+
+void EntityScriptingInterface::stopRayPick(quint32 pickID) {
+    _rayPickManager.clearRay(pickID);
+}
+
+void EntityScriptingInterface::removeRayPick(quint32 pickID) {
+    _rayPickManager.removePick(pickID);
+}
+
+quint32 EntityScriptingInterface::requestRayPick(const PickRay& ray, const QScriptValue& filter) {
+    return _rayPickManager.addOneShotPick(ray.origin, ray.direction, rayPickFilterFromScriptValue(filter));
+}
+
+RayToEntityIntersectionResult EntityScriptingInterface::getRayPickResult(quint32 pickID) const {
+    RayToEntityIntersectionResult result;
+    EntityRayPick pick;
+    if (_rayPickManager.getResult(pickID, pick) && pick.intersects && pick.entity) {
+        result.intersects = true;
+        result.accurate = true;
+        result.entityID = pick.entity->getEntityItemID();
+        result.properties = pick.entity->getProperties();
+        result.distance = pick.distance;
+        result.face = pick.face;
+        result.surfaceNormal = pick.surfaceNormal;
+        result.intersection = pick.origin + (pick.direction * pick.distance);
+        result.entity = pick.entity;
+    }
+    return result;
+}
+
 void EntityScriptingInterface::setLightsArePickable(bool value) {
     LightEntityItem::setLightsArePickable(value);
 }
@@ -495,7 +644,7 @@ bool EntityScriptingInterface::setPoints(QUuid entityID, std::function<bool(Line
     properties.setLinePointsDirty();
     properties.setLastEdited(now);
 
-    queueEntityMessage(PacketType::EntityEdit, entityID, properties);
+    queueEntityMessage(PacketType::EntityEdit, entityID, properties, properties.getPosition());
     return success;
 }
 
@@ -599,7 +748,7 @@ bool EntityScriptingInterface::actionWorker(const QUuid& entityID,
         properties.setActionDataDirty();
         auto now = usecTimestampNow();
         properties.setLastEdited(now);
-        queueEntityMessage(PacketType::EntityEdit, entityID, properties);
+        queueEntityMessage(PacketType::EntityEdit, entityID, properties, properties.getPosition());
     }
 
     return doTransmit;
@@ -30,6 +30,7 @@
 #include "EntityEditPacketSender.h"
 #include "EntitiesScriptEngineProvider.h"
 #include "EntityItemProperties.h"
+#include "EntityRayPickManager.h"
 
 class EntityTree;
 class MouseEvent;
@@ -66,6 +67,9 @@ public:
 
     void setEntityTree(EntityTreePointer modelTree);
     EntityTreePointer getEntityTree() { return _entityTree; }
+
+    /// the picks cast together once a frame, for the callers that cast a ray every frame
+    EntityRayPickManager& getRayPickManager() { return _rayPickManager; }
     void setEntitiesScriptEngine(EntitiesScriptEngineProvider* engine) { _entitiesScriptEngine = engine; }
 
 public slots:
@@ -88,6 +92,14 @@ public slots:
     /// successful edit, if the input entityID is for an unknown model this function will have no effect
     Q_INVOKABLE QUuid editEntity(QUuid entityID, EntityItemProperties properties);
 
+    /// gets the properties of each of the entities, all of them under one lock, an unknown entity gets empty properties
+    Q_INVOKABLE QVector<EntityItemProperties> getMultipleEntityProperties(const QVector<QUuid>& entityIDs,
+                                                                      EntityPropertyFlags desiredProperties = EntityPropertyFlags());
+
+    /// edits each of the entities with its properties, or all of them with the same properties if only one set is given,
+    /// the edits are applied under one lock and sent together, returns the ids with a null id for each edit that failed
+    Q_INVOKABLE QVector<QUuid> editEntities(const QVector<QUuid>& entityIDs, const QVector<EntityItemProperties>& properties);
+
     /// deletes a model
     Q_INVOKABLE void deleteEntity(QUuid entityID);
 
@@ -118,6 +130,20 @@ public slots:
     /// order to return an accurate result
     Q_INVOKABLE RayToEntityIntersectionResult findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue());
 
+    /// A pick cast along with the others once a frame, its result is read with getRayPickResult once its ray is set.
+    /// The filter can hold include and exclude arrays of entity IDs, a types array of entity type names and
+    /// precisionPicking.
+    Q_INVOKABLE quint32 createRayPick(const QScriptValue& filter = QScriptValue());
+    Q_INVOKABLE void setRayPickRay(quint32 pickID, const PickRay& ray);
+    Q_INVOKABLE void stopRayPick(quint32 pickID);
+    Q_INVOKABLE void removeRayPick(quint32 pickID);
+
+    /// casts the ray with the picks of the next frame, its result can then be read until the frame after
+    Q_INVOKABLE quint32 requestRayPick(const PickRay& ray, const QScriptValue& filter = QScriptValue());
+
+    /// the result of the last cast of the pick, which does not intersect until it has been cast
+    Q_INVOKABLE RayToEntityIntersectionResult getRayPickResult(quint32 pickID) const;
+
     Q_INVOKABLE void setLightsArePickable(bool value);
     Q_INVOKABLE bool getLightsArePickable() const;
 
@@ -181,7 +207,11 @@ private:
     bool actionWorker(const QUuid& entityID, std::function<bool(EntitySimulation*, EntityItemPointer)> actor);
     bool setVoxels(QUuid entityID, std::function<bool(PolyVoxEntityItem&)> actor);
     bool setPoints(QUuid entityID, std::function<bool(LineEntityItem&)> actor);
+    EntityItemProperties getPropertiesOfEntity(EntityItemPointer entity, EntityPropertyFlags desiredProperties);
+    void prepareEditForEntity(EntityItemPointer entity, EntityItemProperties& properties);
     void queueEntityMessage(PacketType packetType, EntityItemID entityID, const EntityItemProperties& properties);
+    void queueEntityMessage(PacketType packetType, EntityItemID entityID, const EntityItemProperties& properties,
+                            const glm::vec3& routingPosition);
 
 
     /// actually does the work of finding the ray intersection, can be called in locking mode or tryLock mode
@@ -190,6 +220,7 @@ private:
 
     EntityTreePointer _entityTree;
     EntitiesScriptEngineProvider* _entitiesScriptEngine = nullptr;
+    EntityRayPickManager _rayPickManager;
 };
 
 #endif // hifi_EntityScriptingInterface_h
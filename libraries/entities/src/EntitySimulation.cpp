@@ -9,6 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+
 #include <AACube.h>
 
 #include "EntitySimulation.h"
@@ -18,7 +24,7 @@
 void EntitySimulation::setEntityTree(EntityTreePointer tree) {
     if (_entityTree && _entityTree != tree) {
         _mortalEntities.clear();
-        _nextExpiry = quint64(-1);
+        _expiryQueue = decltype(_expiryQueue)();
         _entitiesToUpdate.clear();
         _entitiesToSort.clear();
         _simpleKinematicEntities.clear();
@@ -61,36 +67,57 @@ void EntitySimulation::changeEntityInternal(EntityItemPointer entity) {
     }
 }
 
+// the stale entries are dropped from the expiry queue once they outnumber the live ones by this many
+const size_t MAX_STALE_EXPIRY_ENTRIES = 256;
+
 // protected
 void EntitySimulation::expireMortalEntities(const quint64& now) {
-    if (now > _nextExpiry) {
-        // only search for expired entities if we expect to find one
-        _nextExpiry = quint64(-1);
-        SetOfEntities::iterator itemItr = _mortalEntities.begin();
-        while (itemItr != _mortalEntities.end()) {
-            EntityItemPointer entity = *itemItr;
-            quint64 expiry = entity->getExpiry();
-            if (expiry < now) {
-                _entitiesToDelete.insert(entity);
-                itemItr = _mortalEntities.erase(itemItr);
-                _entitiesToUpdate.remove(entity);
-                _entitiesToSort.remove(entity);
-                _simpleKinematicEntities.remove(entity);
-                removeEntityInternal(entity);
-
-                _allEntities.remove(entity);
-                entity->_simulated = false;
-            } else {
-                if (expiry < _nextExpiry) {
-                    // remeber the smallest _nextExpiry so we know when to start the next search
-                    _nextExpiry = expiry;
-                }
-                ++itemItr;
-            }
+    // only the entries that are due are looked at, so nothing is done until the soonest expiry has passed
+    while (!_expiryQueue.empty() && _expiryQueue.top().expiry < now) {
+        MortalEntry entry = _expiryQueue.top();
+        _expiryQueue.pop();
+
+        EntityItemPointer entity = entry.entity.lock();
+        if (!entity || !_mortalEntities.contains(entity)) {
+            continue; // removed, or made immortal, since the entry was queued
         }
+        quint64 expiry = entity->getExpiry();
+        if (expiry != entry.expiry) {
+            // its lifetime changed, the entry for its new expiry may already be queued but one more does no harm
+            _expiryQueue.push({ expiry, entity });
+            continue;
+        }
+
+        _entitiesToDelete.insert(entity);
+        _mortalEntities.remove(entity);
+        _entitiesToUpdate.remove(entity);
+        _entitiesToSort.remove(entity);
+        _simpleKinematicEntities.remove(entity);
+        removeEntityInternal(entity);
+
+        _allEntities.remove(entity);
+        entity->_simulated = false;
+    }
+
+    if (_expiryQueue.size() > (size_t)_mortalEntities.size() + MAX_STALE_EXPIRY_ENTRIES) {
+        rebuildExpiryQueue();
     }
 }
 
+void EntitySimulation::addMortalEntity(EntityItemPointer entity) {
+    _mortalEntities.insert(entity);
+    _expiryQueue.push({ entity->getExpiry(), entity });
+}
+
+void EntitySimulation::rebuildExpiryQueue() {
+    std::vector<MortalEntry> entries;
+    entries.reserve(_mortalEntities.size());
+    for (auto entity : _mortalEntities) {
+        entries.push_back({ entity->getExpiry(), entity });
+    }
+    _expiryQueue = decltype(_expiryQueue)(LaterExpiry(), std::move(entries));
+}
+
 // protected
 void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
     PerformanceTimer perfTimer("updatingEntities");
@@ -108,19 +135,73 @@ void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
     }
 }
 
+// below this many moved entities it is quicker to check them all on this thread than to hand them out
+const int MIN_ENTITIES_TO_SORT_IN_PARALLEL = 256;
+
+class EntitySortChecker : public QRunnable {
+public:
+    EntitySortChecker(QVector<EntityToSort>& entities, int begin, int end, QSemaphore* done) :
+        _entities(entities), _begin(begin), _end(end), _done(done) { }
+
+    void run() {
+        AACube domainBounds(glm::vec3((float)-HALF_TREE_SCALE), (float)TREE_SCALE);
+        for (int i = _begin; i < _end; ++i) {
+            EntityToSort& toSort = _entities[i];
+            // only reads the tree, the elements are not changed until all the entities have been checked
+            toSort.newCube = toSort.entity->getMaximumAACube();
+            toSort.outOfBounds = !domainBounds.touches(toSort.newCube);
+            EntityTreeElementPointer element = toSort.entity->getElement();
+            toSort.needsMove = !toSort.outOfBounds && (!element || !element->bestFitBounds(toSort.newCube));
+        }
+        if (_done) {
+            _done->release();
+        }
+    }
+
+private:
+    QVector<EntityToSort>& _entities;
+    int _begin;
+    int _end;
+    QSemaphore* _done;
+};
+
 // protected
 void EntitySimulation::sortEntitiesThatMoved() {
     // NOTE: this is only for entities that have been moved by THIS EntitySimulation.
     // External changes to entity position/shape are expected to be sorted outside of the EntitySimulation.
     PerformanceTimer perfTimer("sortingEntities");
+    if (_entitiesToSort.isEmpty()) {
+        return;
+    }
+
+    // the new cube of each entity and whether it left its element are worked out first, on the thread pool when
+    // there are many of them, so that the operator only has to recurse the tree for the ones that changed elements
+    _entitiesToCheck.resize(_entitiesToSort.size());
+    int index = 0;
+    foreach (EntityItemPointer entity, _entitiesToSort) {
+        _entitiesToCheck[index++].entity = entity;
+    }
+    {
+        PerformanceTimer perfTimer("checkEntitiesThatMoved");
+        int numEntities = _entitiesToCheck.size();
+        int numChunks = numEntities < MIN_ENTITIES_TO_SORT_IN_PARALLEL ? 1 :
+            std::min(QThreadPool::globalInstance()->maxThreadCount() + 1, numEntities / MIN_ENTITIES_TO_SORT_IN_PARALLEL);
+        int chunkSize = (numEntities + numChunks - 1) / numChunks;
+        QSemaphore done;
+        for (int chunk = 1; chunk < numChunks; ++chunk) {
+            int begin = chunk * chunkSize;
+            QThreadPool::globalInstance()->start(new EntitySortChecker(_entitiesToCheck, begin,
+                                                                       std::min(begin + chunkSize, numEntities), &done));
+        }
+        EntitySortChecker(_entitiesToCheck, 0, std::min(chunkSize, numEntities), nullptr).run();
+        done.acquire(numChunks - 1);
+    }
+
     MovingEntitiesOperator moveOperator(_entityTree);
-    AACube domainBounds(glm::vec3((float)-HALF_TREE_SCALE), (float)TREE_SCALE);
-    SetOfEntities::iterator itemItr = _entitiesToSort.begin();
-    while (itemItr != _entitiesToSort.end()) {
-        EntityItemPointer entity = *itemItr;
+    foreach (const EntityToSort& toSort, _entitiesToCheck) {
+        EntityItemPointer entity = toSort.entity;
         // check to see if this movement has sent the entity outside of the domain.
-        AACube newCube = entity->getMaximumAACube();
-        if (!domainBounds.touches(newCube)) {
+        if (toSort.outOfBounds) {
             qCDebug(entities) << "Entity " << entity->getEntityItemID() << " moved out of domain bounds.";
             _entitiesToDelete.insert(entity);
             _mortalEntities.remove(entity);
@@ -130,11 +211,8 @@ void EntitySimulation::sortEntitiesThatMoved() {
 
             _allEntities.remove(entity);
             entity->_simulated = false;
-
-            itemItr = _entitiesToSort.erase(itemItr);
-        } else {
-            moveOperator.addEntityToMoveList(entity, newCube);
-            ++itemItr;
+        } else if (toSort.needsMove) {
+            moveOperator.addEntityToMoveList(entity, toSort.newCube);
         }
     }
     if (moveOperator.hasMovingEntities()) {
@@ -142,6 +220,7 @@ void EntitySimulation::sortEntitiesThatMoved() {
         _entityTree->recurseTreeWithOperator(&moveOperator);
     }
 
+    _entitiesToCheck.clear();
     _entitiesToSort.clear();
 }
 
@@ -150,11 +229,7 @@ void EntitySimulation::addEntity(EntityItemPointer entity) {
     assert(entity);
     entity->deserializeActions();
     if (entity->isMortal()) {
-        _mortalEntities.insert(entity);
-        quint64 expiry = entity->getExpiry();
-        if (expiry < _nextExpiry) {
-            _nextExpiry = expiry;
-        }
+        addMortalEntity(entity);
     }
     if (entity->needsToCallUpdate()) {
         _entitiesToUpdate.insert(entity);
@@ -216,11 +291,7 @@ void EntitySimulation::changeEntity(EntityItemPointer entity) {
     if (!wasRemoved) {
         if (dirtyFlags & Simulation::DIRTY_LIFETIME) {
             if (entity->isMortal()) {
-                _mortalEntities.insert(entity);
-                quint64 expiry = entity->getExpiry();
-                if (expiry < _nextExpiry) {
-                    _nextExpiry = expiry;
-                }
+                addMortalEntity(entity);
             } else {
                 _mortalEntities.remove(entity);
             }
@@ -238,7 +309,7 @@ void EntitySimulation::changeEntity(EntityItemPointer entity) {
 void EntitySimulation::clearEntities() {
     QMutexLocker lock(&_mutex);
     _mortalEntities.clear();
-    _nextExpiry = quint64(-1);
+    _expiryQueue = decltype(_expiryQueue)();
     _entitiesToUpdate.clear();
     _entitiesToSort.clear();
     _simpleKinematicEntities.clear();
@@ -253,18 +324,50 @@ void EntitySimulation::clearEntities() {
 }
 
 void EntitySimulation::moveSimpleKinematics(const quint64& now) {
+    // the same steps as EntityItem::simulate(), with the linear motion of all the entities integrated together
+    _kinematicBatch.clear();
+    _kinematicBatchEntities.clear();
+    _movedKinematicEntities.clear();
+
     SetOfEntities::iterator itemItr = _simpleKinematicEntities.begin();
     while (itemItr != _simpleKinematicEntities.end()) {
         EntityItemPointer entity = *itemItr;
         if (entity->isMoving() && !entity->getPhysicsInfo()) {
-            entity->simulate(now);
-            _entitiesToSort.insert(entity);
+            float timeElapsed = entity->startSimulationStep(now);
+            if (!entity->hasActions()) {
+                entity->simulateAngularMotion(timeElapsed);
+                if (entity->hasVelocity()) {
+                    float damping = entity->getDamping();
+                    float dampingFactor = (damping > 0.0f) ? powf(1.0f - damping, timeElapsed) : 1.0f;
+                    _kinematicBatch.add(entity->getPosition(), entity->getVelocity(), entity->getAcceleration(),
+                                        dampingFactor, timeElapsed);
+                    _kinematicBatchEntities.push_back(entity);
+                }
+            }
+            entity->setLastSimulated(now);
+            _movedKinematicEntities.push_back(entity);
             ++itemItr;
         } else {
             // the entity is no longer non-physical-kinematic
             itemItr = _simpleKinematicEntities.erase(itemItr);
         }
     }
+
+    _kinematicBatch.integrate();
+
+    for (int i = 0; i < _kinematicBatchEntities.size(); ++i) {
+        _kinematicBatchEntities[i]->finishLinearMotion(_kinematicBatch.getPosition(i), _kinematicBatch.getVelocity(i),
+                                                       _kinematicBatch.getSpeed(i));
+    }
+
+    // only the entities that left the best fit of their element need to be sorted, sortEntitiesThatMoved() would
+    // leave the others where they are
+    foreach (EntityItemPointer entity, _movedKinematicEntities) {
+        EntityTreeElementPointer element = entity->getElement();
+        if (!element || !element->bestFitBounds(entity->getMaximumAACube())) {
+            _entitiesToSort.insert(entity);
+        }
+    }
 }
 
 void EntitySimulation::addAction(EntityActionPointer action) {
@@ -12,6 +12,9 @@
 #ifndef hifi_EntitySimulation_h
 #define hifi_EntitySimulation_h
 
+#include <queue>
+#include <vector>
+
 #include <QtCore/QObject>
 #include <QSet>
 #include <QVector>
@@ -21,10 +24,19 @@
 #include "EntityActionInterface.h"
 #include "EntityItem.h"
 #include "EntityTree.h"
+#include "KinematicBatch.h"
 
 typedef QSet<EntityItemPointer> SetOfEntities;
 typedef QVector<EntityItemPointer> VectorOfEntities;
 
+// A moved entity as it is checked by sortEntitiesThatMoved, before the ones that left their element are moved
+struct EntityToSort {
+    EntityItemPointer entity;
+    AACube newCube;
+    bool outOfBounds { false };
+    bool needsMove { false };
+};
+
 // the EntitySimulation needs to know when these things change on an entity,
 // so it can sort EntityItem or relay its state to the PhysicsEngine.
 const int DIRTY_SIMULATION_FLAGS =
@@ -44,7 +56,7 @@ const int DIRTY_SIMULATION_FLAGS =
 class EntitySimulation : public QObject {
 Q_OBJECT
 public:
-    EntitySimulation() : _mutex(QMutex::Recursive), _entityTree(NULL), _nextExpiry(quint64(-1)) { }
+    EntitySimulation() : _mutex(QMutex::Recursive), _entityTree(NULL) { }
     virtual ~EntitySimulation() { setEntityTree(NULL); }
 
     /// \param tree pointer to EntityTree which is stored internally
@@ -102,13 +114,30 @@ protected:
     QMutex _mutex{ QMutex::Recursive };
 
     SetOfEntities _entitiesToSort; // entities moved by simulation (and might need resort in EntityTree)
+    QVector<EntityToSort> _entitiesToCheck; // _entitiesToSort while sortEntitiesThatMoved checks them
     SetOfEntities _simpleKinematicEntities; // entities undergoing non-colliding kinematic motion
+    KinematicBatch _kinematicBatch; // the linear motion of _kinematicBatchEntities, for moveSimpleKinematics()
+    VectorOfEntities _kinematicBatchEntities;
+    VectorOfEntities _movedKinematicEntities;
     QList<EntityActionPointer> _actionsToAdd;
     QSet<QUuid> _actionsToRemove;
 
 private:
     void moveSimpleKinematics();
 
+    // An entry of the expiry queue, which may be out of date: an entity whose lifetime changed has a new entry and
+    // keeps the old one, and an entity that was removed keeps its entries, until they come to the top of the queue.
+    struct MortalEntry {
+        quint64 expiry;
+        EntityItemWeakPointer entity;
+    };
+    struct LaterExpiry {
+        bool operator()(const MortalEntry& a, const MortalEntry& b) const { return a.expiry > b.expiry; }
+    };
+
+    void addMortalEntity(EntityItemPointer entity);
+    void rebuildExpiryQueue();
+
     // back pointer to EntityTree structure
     EntityTreePointer _entityTree;
 
@@ -116,7 +145,7 @@ private:
     // An entity may be in more than one list.
     SetOfEntities _allEntities; // tracks all entities added the simulation
     SetOfEntities _mortalEntities; // entities that have an expiry
-    quint64 _nextExpiry;
+    std::priority_queue<MortalEntry, std::vector<MortalEntry>, LaterExpiry> _expiryQueue; // soonest expiry on top
 
 
     SetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
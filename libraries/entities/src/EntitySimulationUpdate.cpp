@@ -0,0 +1,278 @@
+//
+//  EntitySimulationUpdate.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySimulationUpdate.h"
+
+#include <string.h>
+
+#include <limits>
+
+#include <GLMHelpers.h>
+#include <OctalCode.h>
+
+#include "EntitiesLogging.h"
+
+// the flags that follow the entity ID say which values follow them
+static const quint8 HAS_POSITION = 1 << 0;
+static const quint8 HAS_ROTATION = 1 << 1;
+static const quint8 HAS_VELOCITY = 1 << 2;
+static const quint8 HAS_ANGULAR_VELOCITY = 1 << 3;
+static const quint8 ACCELERATION_IS_ZERO = 1 << 4;
+static const quint8 ACCELERATION_IS_GRAVITY = 1 << 5;
+static const quint8 HAS_SIMULATION_OWNER = 1 << 6;
+static const quint8 HAS_ACTION_DATA = 1 << 7;
+
+// velocities up to 32 meters per second with millimeter per second steps, angular velocities up to 16 radians per
+// second with half milliradian per second steps
+static const int VELOCITY_RADIX = 10;
+static const int ANGULAR_VELOCITY_RADIX = 11;
+static const int NUM_BYTES_FIXED_VEC3 = 3 * sizeof(int16_t);
+static const int NUM_BYTES_ROTATION = 6;
+
+static bool fitsSignedTwoByteFixed(const glm::vec3& vector, int radix) {
+    const float MAX_FIXED_VALUE = (float)std::numeric_limits<int16_t>::max();
+    glm::vec3 scaled = glm::abs(vector) * (float)(1 << radix);
+    return scaled.x < MAX_FIXED_VALUE && scaled.y < MAX_FIXED_VALUE && scaled.z < MAX_FIXED_VALUE;
+}
+
+static bool isSimulationProperty(EntityPropertyList property) {
+    switch (property) {
+        case PROP_POSITION:
+        case PROP_ROTATION:
+        case PROP_VELOCITY:
+        case PROP_ANGULAR_VELOCITY:
+        case PROP_ACCELERATION:
+        case PROP_SIMULATION_OWNER:
+        case PROP_ACTION_DATA:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool EntitySimulationUpdate::canEncode(const EntityItemProperties& properties, const glm::vec3& gravity) {
+    EntityPropertyFlags changedProperties = properties.getChangedProperties();
+    for (int i = PROP_PAGED_PROPERTY; i < PROP_AFTER_LAST_ITEM; i++) {
+        EntityPropertyList property = (EntityPropertyList)i;
+        if (changedProperties.getHasProperty(property) && !isSimulationProperty(property)) {
+            return false;
+        }
+    }
+
+    if (properties.accelerationChanged() && properties.getAcceleration() != glm::vec3(0.0f) &&
+            properties.getAcceleration() != gravity) {
+        return false;
+    }
+    if (properties.velocityChanged() && !fitsSignedTwoByteFixed(properties.getVelocity(), VELOCITY_RADIX)) {
+        return false;
+    }
+    if (properties.angularVelocityChanged() &&
+            !fitsSignedTwoByteFixed(properties.getAngularVelocity(), ANGULAR_VELOCITY_RADIX)) {
+        return false;
+    }
+    return !properties.actionDataChanged() || properties.getActionData().size() <= std::numeric_limits<quint16>::max();
+}
+
+bool EntitySimulationUpdate::encode(const EntityItemID& id, const EntityItemProperties& properties,
+                                    QByteArray& buffer) {
+    // the root octcode, like EntityItemProperties::encodeEntityEditPacket, goes to every server
+    unsigned char* octcode = pointToOctalCode(0.0f, 0.0f, 0.0f, 1.0f);
+    int octcodeLength = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(octcode));
+
+    quint8 flags = 0;
+    int length = octcodeLength + sizeof(quint64) + NUM_BYTES_RFC4122_UUID + sizeof(flags);
+    if (properties.positionChanged()) {
+        flags |= HAS_POSITION;
+        length += sizeof(glm::vec3);
+    }
+    if (properties.rotationChanged()) {
+        flags |= HAS_ROTATION;
+        length += NUM_BYTES_ROTATION;
+    }
+    if (properties.velocityChanged()) {
+        flags |= HAS_VELOCITY;
+        length += NUM_BYTES_FIXED_VEC3;
+    }
+    if (properties.angularVelocityChanged()) {
+        flags |= HAS_ANGULAR_VELOCITY;
+        length += NUM_BYTES_FIXED_VEC3;
+    }
+    if (properties.accelerationChanged()) {
+        // canEncode() only accepts zero or the gravity of the entity
+        flags |= (properties.getAcceleration() == glm::vec3(0.0f)) ? ACCELERATION_IS_ZERO : ACCELERATION_IS_GRAVITY;
+    }
+    if (properties.simulationOwnerChanged()) {
+        flags |= HAS_SIMULATION_OWNER;
+        length += SimulationOwner::NUM_BYTES_ENCODED;
+    }
+    if (properties.actionDataChanged()) {
+        flags |= HAS_ACTION_DATA;
+        length += sizeof(quint16) + properties.getActionData().size();
+    }
+
+    if (buffer.size() < length) {
+        qCDebug(entities) << "ERROR - EntitySimulationUpdate::encode() called with buffer that is too small!";
+        delete[] octcode;
+        return false;
+    }
+
+    unsigned char* copyAt = reinterpret_cast<unsigned char*>(buffer.data());
+    memcpy(copyAt, octcode, octcodeLength);
+    copyAt += octcodeLength;
+    delete[] octcode;
+
+    // lastEdited right after the octcode, where EntityItem::adjustEditPacketForClockSkew expects it
+    quint64 lastEdited = properties.getLastEdited();
+    memcpy(copyAt, &lastEdited, sizeof(lastEdited));
+    copyAt += sizeof(lastEdited);
+
+    memcpy(copyAt, id.toRfc4122().constData(), NUM_BYTES_RFC4122_UUID);
+    copyAt += NUM_BYTES_RFC4122_UUID;
+
+    *copyAt++ = flags;
+
+    if (flags & HAS_POSITION) {
+        memcpy(copyAt, &properties.getPosition(), sizeof(glm::vec3));
+        copyAt += sizeof(glm::vec3);
+    }
+    if (flags & HAS_ROTATION) {
+        copyAt += packOrientationQuatToSixBytes(copyAt, properties.getRotation());
+    }
+    if (flags & HAS_VELOCITY) {
+        copyAt += packFloatVec3ToSignedTwoByteFixed(copyAt, properties.getVelocity(), VELOCITY_RADIX);
+    }
+    if (flags & HAS_ANGULAR_VELOCITY) {
+        copyAt += packFloatVec3ToSignedTwoByteFixed(copyAt, properties.getAngularVelocity(), ANGULAR_VELOCITY_RADIX);
+    }
+    if (flags & HAS_SIMULATION_OWNER) {
+        QByteArray simulationOwner = properties.getSimulationOwner().toByteArray();
+        memcpy(copyAt, simulationOwner.constData(), SimulationOwner::NUM_BYTES_ENCODED);
+        copyAt += SimulationOwner::NUM_BYTES_ENCODED;
+    }
+    if (flags & HAS_ACTION_DATA) {
+        const QByteArray& actionData = properties.getActionData();
+        quint16 actionDataLength = actionData.size();
+        memcpy(copyAt, &actionDataLength, sizeof(actionDataLength));
+        copyAt += sizeof(actionDataLength);
+        memcpy(copyAt, actionData.constData(), actionDataLength);
+        copyAt += actionDataLength;
+    }
+
+    buffer.resize(length);
+    return true;
+}
+
+bool EntitySimulationUpdate::decode(const unsigned char* data, int bytesToRead, int& processedBytes,
+                                    EntityItemID& entityID, EntityItemProperties& properties,
+                                    bool& accelerationIsGravity) {
+    // a message that doesn't add up takes the rest of the packet with it
+    processedBytes = bytesToRead;
+    accelerationIsGravity = false;
+
+    int octcodeLength = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(data, bytesToRead));
+    int headerLength = octcodeLength + sizeof(quint64) + NUM_BYTES_RFC4122_UUID + sizeof(quint8);
+    if (headerLength > bytesToRead) {
+        return false;
+    }
+
+    const unsigned char* dataAt = data + octcodeLength;
+    const unsigned char* dataEnd = data + bytesToRead;
+
+    // the time has been adjusted for clock skew by the sender
+    quint64 lastEdited;
+    memcpy(&lastEdited, dataAt, sizeof(lastEdited));
+    dataAt += sizeof(lastEdited);
+    properties.setLastEdited(lastEdited);
+
+    entityID = QUuid::fromRfc4122(QByteArray::fromRawData(reinterpret_cast<const char*>(dataAt),
+                                                          NUM_BYTES_RFC4122_UUID));
+    dataAt += NUM_BYTES_RFC4122_UUID;
+
+    quint8 flags = *dataAt++;
+
+    int valuesLength = ((flags & HAS_POSITION) ? sizeof(glm::vec3) : 0)
+        + ((flags & HAS_ROTATION) ? NUM_BYTES_ROTATION : 0)
+        + ((flags & HAS_VELOCITY) ? NUM_BYTES_FIXED_VEC3 : 0)
+        + ((flags & HAS_ANGULAR_VELOCITY) ? NUM_BYTES_FIXED_VEC3 : 0)
+        + ((flags & HAS_SIMULATION_OWNER) ? SimulationOwner::NUM_BYTES_ENCODED : 0)
+        + ((flags & HAS_ACTION_DATA) ? sizeof(quint16) : 0);
+    if (valuesLength > dataEnd - dataAt) {
+        return false;
+    }
+
+    if (flags & HAS_POSITION) {
+        glm::vec3 position;
+        memcpy(&position, dataAt, sizeof(position));
+        dataAt += sizeof(position);
+        properties.setPosition(position);
+    }
+    if (flags & HAS_ROTATION) {
+        glm::quat rotation;
+        dataAt += unpackOrientationQuatFromSixBytes(dataAt, rotation);
+        properties.setRotation(rotation);
+    }
+    if (flags & HAS_VELOCITY) {
+        glm::vec3 velocity;
+        dataAt += unpackFloatVec3FromSignedTwoByteFixed(dataAt, velocity, VELOCITY_RADIX);
+        properties.setVelocity(velocity);
+    }
+    if (flags & HAS_ANGULAR_VELOCITY) {
+        glm::vec3 angularVelocity;
+        dataAt += unpackFloatVec3FromSignedTwoByteFixed(dataAt, angularVelocity, ANGULAR_VELOCITY_RADIX);
+        properties.setAngularVelocity(angularVelocity);
+    }
+    if (flags & ACCELERATION_IS_ZERO) {
+        properties.setAcceleration(glm::vec3(0.0f));
+    } else if (flags & ACCELERATION_IS_GRAVITY) {
+        accelerationIsGravity = true;
+    }
+    if (flags & HAS_SIMULATION_OWNER) {
+        properties.setSimulationOwner(QByteArray(reinterpret_cast<const char*>(dataAt),
+                                                 SimulationOwner::NUM_BYTES_ENCODED));
+        dataAt += SimulationOwner::NUM_BYTES_ENCODED;
+    }
+    if (flags & HAS_ACTION_DATA) {
+        quint16 actionDataLength;
+        memcpy(&actionDataLength, dataAt, sizeof(actionDataLength));
+        dataAt += sizeof(actionDataLength);
+        if (actionDataLength > dataEnd - dataAt) {
+            return false;
+        }
+        properties.setActionData(QByteArray(reinterpret_cast<const char*>(dataAt), actionDataLength));
+        dataAt += actionDataLength;
+    }
+
+    processedBytes = dataAt - data;
+    return true;
+}
+
+glm::quat EntitySimulationUpdate::quantizeRotation(const glm::quat& rotation) {
+    unsigned char buffer[NUM_BYTES_ROTATION];
+    packOrientationQuatToSixBytes(buffer, rotation);
+    glm::quat quantized;
+    unpackOrientationQuatFromSixBytes(buffer, quantized);
+    return quantized;
+}
+
+glm::vec3 EntitySimulationUpdate::quantizeVelocity(const glm::vec3& velocity) {
+    unsigned char buffer[NUM_BYTES_FIXED_VEC3];
+    packFloatVec3ToSignedTwoByteFixed(buffer, velocity, VELOCITY_RADIX);
+    glm::vec3 quantized;
+    unpackFloatVec3FromSignedTwoByteFixed(buffer, quantized, VELOCITY_RADIX);
+    return quantized;
+}
+
+glm::vec3 EntitySimulationUpdate::quantizeAngularVelocity(const glm::vec3& angularVelocity) {
+    unsigned char buffer[NUM_BYTES_FIXED_VEC3];
+    packFloatVec3ToSignedTwoByteFixed(buffer, angularVelocity, ANGULAR_VELOCITY_RADIX);
+    glm::vec3 quantized;
+    unpackFloatVec3FromSignedTwoByteFixed(buffer, quantized, ANGULAR_VELOCITY_RADIX);
+    return quantized;
+}
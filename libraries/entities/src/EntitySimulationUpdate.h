@@ -0,0 +1,51 @@
+//
+//  EntitySimulationUpdate.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySimulationUpdate_h
+#define hifi_EntitySimulationUpdate_h
+
+#include <QByteArray>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "EntityItemID.h"
+#include "EntityItemProperties.h"
+
+// The compact edit message a simulation owner streams for an entity it moves, sent as PacketType::EntitySimulationUpdate.
+// It only carries position, rotation, velocities, acceleration, action data and simulation ownership: rotations are
+// sent as their three smallest components, velocities as fixed point and acceleration as a flag for either zero or
+// the entity's gravity. Updates with any other change, or with values out of range of the format, are sent as
+// EntityEdit instead.
+//
+// Like every edit message it starts with an octcode and the lastEdited time, so it can be routed and adjusted for
+// clock skew the same way.
+class EntitySimulationUpdate {
+public:
+    /// \return true if the changed properties can be sent as a simulation update
+    /// \param gravity the gravity of the entity, the only acceleration other than zero the format can carry
+    static bool canEncode(const EntityItemProperties& properties, const glm::vec3& gravity);
+
+    /// encodes properties that canEncode() accepted
+    /// \return true if the update fit in the buffer, which is then resized to the encoded message
+    static bool encode(const EntityItemID& id, const EntityItemProperties& properties, QByteArray& buffer);
+
+    /// \param accelerationIsGravity[out] true if the acceleration is the gravity of the entity, which the caller sets
+    /// \return true if the message was valid, processedBytes is the size of the message either way
+    static bool decode(const unsigned char* data, int bytesToRead, int& processedBytes, EntityItemID& entityID,
+                       EntityItemProperties& properties, bool& accelerationIsGravity);
+
+    // the values a receiver decodes, so that a sender can predict the state it has
+    static glm::quat quantizeRotation(const glm::quat& rotation);
+    static glm::vec3 quantizeVelocity(const glm::vec3& velocity);
+    static glm::vec3 quantizeAngularVelocity(const glm::vec3& angularVelocity);
+};
+
+#endif // hifi_EntitySimulationUpdate_h
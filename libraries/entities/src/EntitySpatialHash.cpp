@@ -0,0 +1,134 @@
+//
+//  EntitySpatialHash.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySpatialHash.h"
+
+#include <math.h>
+
+// cell coordinates are packed 21 bits per axis into the cell key
+static const int CELL_COORDINATE_BITS = 21;
+static const quint64 CELL_COORDINATE_MASK = (1ULL << CELL_COORDINATE_BITS) - 1;
+
+static quint64 packCellKey(qint64 x, qint64 y, qint64 z) {
+    return ((quint64)x & CELL_COORDINATE_MASK)
+        | (((quint64)y & CELL_COORDINATE_MASK) << CELL_COORDINATE_BITS)
+        | (((quint64)z & CELL_COORDINATE_MASK) << (2 * CELL_COORDINATE_BITS));
+}
+
+EntitySpatialHash::EntitySpatialHash(float cellSize) :
+    _cellSize(cellSize)
+{
+}
+
+quint64 EntitySpatialHash::cellKey(const glm::vec3& position) const {
+    return packCellKey((qint64)floorf(position.x / _cellSize), (qint64)floorf(position.y / _cellSize),
+                       (qint64)floorf(position.z / _cellSize));
+}
+
+EntitySpatialHash::Cell* EntitySpatialHash::cellFor(const EntityTreeElementPointer& element, bool create) {
+    const AACube& cube = element->getAACube();
+    if (cube.getScale() > _cellSize) {
+        return &_largeElements;
+    }
+
+    quint64 key = cellKey(cube.calcCenter());
+    if (create) {
+        return &_cells[key];
+    }
+
+    auto cell = _cells.find(key);
+    return (cell != _cells.end()) ? &cell.value() : nullptr;
+}
+
+void EntitySpatialHash::addElement(const EntityTreeElementPointer& element) {
+    Cell* cell = cellFor(element, true);
+
+    for (auto& entry : *cell) {
+        if (entry.element == element) {
+            ++entry.entityCount;
+            return;
+        }
+    }
+
+    cell->push_back({ element, 1 });
+    ++_elementCount;
+}
+
+void EntitySpatialHash::removeElement(const EntityTreeElementPointer& element) {
+    Cell* cell = cellFor(element, false);
+    if (!cell) {
+        return;
+    }
+
+    for (int i = 0; i < cell->size(); ++i) {
+        Entry& entry = (*cell)[i];
+        if (entry.element == element) {
+            if (--entry.entityCount == 0) {
+                // order in a cell doesn't matter
+                entry = cell->last();
+                cell->pop_back();
+                --_elementCount;
+
+                if (cell->isEmpty() && cell != &_largeElements) {
+                    _cells.remove(cellKey(element->getAACube().calcCenter()));
+                }
+            }
+            return;
+        }
+    }
+}
+
+void EntitySpatialHash::clear() {
+    _cells.clear();
+    _largeElements.clear();
+    _elementCount = 0;
+}
+
+void EntitySpatialHash::findInCell(const Cell& cell, const AABox& bounds,
+                                   QVector<EntityTreeElementPointer>& foundElements) const {
+    for (const auto& entry : cell) {
+        if (entry.element->getAACube().touches(bounds)) {
+            foundElements.push_back(entry.element);
+        }
+    }
+}
+
+void EntitySpatialHash::findElements(const AABox& bounds, QVector<EntityTreeElementPointer>& foundElements) const {
+    findInCell(_largeElements, bounds, foundElements);
+
+    // elements in a cell reach at most half a cell past it
+    glm::vec3 halfCell(_cellSize * 0.5f);
+    glm::vec3 minimum = glm::floor((bounds.getMinimumPoint() - halfCell) / _cellSize);
+    glm::vec3 maximum = glm::floor((bounds.getMaximumPoint() + halfCell) / _cellSize);
+
+    qint64 minX = (qint64)minimum.x, minY = (qint64)minimum.y, minZ = (qint64)minimum.z;
+    qint64 maxX = (qint64)maximum.x, maxY = (qint64)maximum.y, maxZ = (qint64)maximum.z;
+
+    double numQueryCells = (double)(maxX - minX + 1) * (double)(maxY - minY + 1) * (double)(maxZ - minZ + 1);
+
+    if (numQueryCells > _cells.size()) {
+        // the bounds cover more cells than are used, looking at the used ones is cheaper
+        for (auto cell = _cells.constBegin(); cell != _cells.constEnd(); ++cell) {
+            findInCell(cell.value(), bounds, foundElements);
+        }
+        return;
+    }
+
+    for (qint64 z = minZ; z <= maxZ; ++z) {
+        for (qint64 y = minY; y <= maxY; ++y) {
+            for (qint64 x = minX; x <= maxX; ++x) {
+                auto cell = _cells.constFind(packCellKey(x, y, z));
+                if (cell != _cells.constEnd()) {
+                    findInCell(cell.value(), bounds, foundElements);
+                }
+            }
+        }
+    }
+}
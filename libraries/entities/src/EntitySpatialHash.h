@@ -0,0 +1,58 @@
+//
+//  EntitySpatialHash.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialHash_h
+#define hifi_EntitySpatialHash_h
+
+#include <QHash>
+#include <QVector>
+
+#include <AABox.h>
+
+#include "EntityTreeElement.h"
+
+// A loose uniform grid over the tree elements that hold entities, so that small spatial queries don't have to recurse
+// the octree from its root. Elements no bigger than a cell are kept in the cell holding their center, so a query only
+// has to look half a cell past its bounds, bigger elements are kept in a list every query looks at.
+//
+// Elements are counted once for every entity they contain, the tree adds and removes them as entities change element.
+class EntitySpatialHash {
+public:
+    EntitySpatialHash(float cellSize);
+
+    void addElement(const EntityTreeElementPointer& element);
+    void removeElement(const EntityTreeElementPointer& element);
+    void clear();
+
+    /// finds the elements holding entities whose cubes touch the bounds
+    /// \param foundElements[out] the elements, each one once
+    void findElements(const AABox& bounds, QVector<EntityTreeElementPointer>& foundElements) const;
+
+    float getCellSize() const { return _cellSize; }
+    int getElementCount() const { return _elementCount; }
+
+private:
+    struct Entry {
+        EntityTreeElementPointer element;
+        int entityCount;
+    };
+    using Cell = QVector<Entry>;
+
+    quint64 cellKey(const glm::vec3& position) const;
+    Cell* cellFor(const EntityTreeElementPointer& element, bool create);
+    void findInCell(const Cell& cell, const AABox& bounds, QVector<EntityTreeElementPointer>& foundElements) const;
+
+    float _cellSize;
+    QHash<quint64, Cell> _cells;
+    Cell _largeElements;
+    int _elementCount { 0 };
+};
+
+#endif // hifi_EntitySpatialHash_h
@@ -9,15 +9,25 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
+#include <OctalCode.h>
 #include <PerfStat.h>
 #include <QDateTime>
+#include <QVarLengthArray>
+#include <RayIntersectionKernels.h>
 #include <QtScript/QScriptEngine>
 
 #include "EntityTree.h"
+#include "EntityBinaryFile.h"
+#include "EntityEncodeCache.h"
 #include "EntitySimulation.h"
+#include "EntitySimulationUpdate.h"
 #include "VariantMapToScriptValue.h"
 
 #include "AddEntityOperator.h"
+#include "AddEntitiesOperator.h"
+#include "MarkChangedElementsOperator.h"
 #include "MovingEntitiesOperator.h"
 #include "UpdateEntityOperator.h"
 #include "QVariantGLM.h"
@@ -27,10 +37,14 @@
 
 static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC * 50;
 
+// meters, elements bigger than this are looked at by every spatial query
+static const float SPATIAL_HASH_CELL_SIZE = 8.0f;
+
 EntityTree::EntityTree(bool shouldReaverage) :
     Octree(shouldReaverage),
     _fbxService(NULL),
-    _simulation(NULL)
+    _simulation(NULL),
+    _spatialHash(SPATIAL_HASH_CELL_SIZE)
 {
     resetClientEditStats();
 }
@@ -39,6 +53,12 @@ EntityTree::~EntityTree() {
     eraseAllOctreeElements(false);
 }
 
+void EntityTree::enableEncodeCache() {
+    if (!_encodeCache) {
+        _encodeCache.reset(new EntityEncodeCache());
+    }
+}
+
 void EntityTree::createRootElement() {
     _rootElement = createNewElement();
 }
@@ -65,6 +85,7 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         element->cleanupEntities();
     }
     _entityToElementMap.clear();
+    _spatialHash.clear();
     Octree::eraseAllOctreeElements(createNewRoot);
 
     resetClientEditStats();
@@ -75,6 +96,7 @@ bool EntityTree::handlesEditPacketType(PacketType packetType) const {
     switch (packetType) {
         case PacketType::EntityAdd:
         case PacketType::EntityEdit:
+        case PacketType::EntitySimulationUpdate:
         case PacketType::EntityErase:
             return true;
         default:
@@ -90,6 +112,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
         _simulation->addEntity(entity);
     }
     _isDirty = true;
+    journalEntityChanged(entity->getEntityItemID());
     maybeNotifyNewCollisionSoundURL("", entity->getCollisionSoundURL());
     emit addingEntity(entity->getEntityItemID());
 }
@@ -147,6 +170,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
                 UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, tempProperties);
                 recurseTreeWithOperator(&theOperator);
                 _isDirty = true;
+                journalEntityChanged(entity->getEntityItemID());
             }
         }
     } else {
@@ -176,10 +200,13 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
                         // so we apply the rules for ownership change:
                         // (1) higher priority wins
                         // (2) equal priority wins if ownership filter has expired except...
+                        // (3) a script edit wins over the physics-simulator, which takes the object back later
                         uint8_t oldPriority = entity->getSimulationPriority();
                         uint8_t newPriority = properties.getSimulationOwner().getPriority();
                         if (newPriority > oldPriority ||
-                             (newPriority == oldPriority && properties.getSimulationOwner().hasExpired())) {
+                             (newPriority == oldPriority && properties.getSimulationOwner().hasExpired()) ||
+                             (oldPriority == AUTHORITATIVE_SIMULATION_PRIORITY &&
+                              newPriority >= SCRIPT_EDIT_SIMULATION_PRIORITY)) {
                             simulationBlocked = false;
                         }
                     }
@@ -207,8 +234,14 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
         QString collisionSoundURLBefore = entity->getCollisionSoundURL();
         uint32_t preFlags = entity->getDirtyFlags();
         UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, properties);
-        recurseTreeWithOperator(&theOperator);
+        if (_editBatchStarted && theOperator.canApplyInPlace()) {
+            theOperator.applyInPlace();
+            _pendingChangedElements << containingElement;
+        } else {
+            recurseTreeWithOperator(&theOperator);
+        }
         _isDirty = true;
+        journalEntityChanged(entity->getEntityItemID());
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
@@ -276,15 +309,54 @@ EntityItemPointer EntityTree::addEntity(const EntityItemID& entityID, const Enti
         if (recordCreationTime) {
             result->recordCreationTime();
         }
-        // Recurse the tree and store the entity in the correct tree element
-        AddEntityOperator theOperator(getThisPointer(), result);
-        recurseTreeWithOperator(&theOperator);
+        if (_editBatchStarted) {
+            _pendingAdds << result;
+            _pendingAddIDs.insert(entityID);
+        } else {
+            // Recurse the tree and store the entity in the correct tree element
+            AddEntityOperator theOperator(getThisPointer(), result);
+            recurseTreeWithOperator(&theOperator);
 
-        postAddEntity(result);
+            postAddEntity(result);
+        }
     }
     return result;
 }
 
+void EntityTree::startEditBatch() {
+    _editBatchStarted = true;
+}
+
+void EntityTree::finishEditBatch() {
+    flushPendingAdds();
+
+    if (!_pendingChangedElements.isEmpty()) {
+        MarkChangedElementsOperator theOperator(_pendingChangedElements);
+        _pendingChangedElements.clear();
+        recurseTreeWithOperator(&theOperator);
+    }
+
+    _editBatchStarted = false;
+}
+
+void EntityTree::flushPendingAdds() {
+    if (_pendingAdds.isEmpty()) {
+        return;
+    }
+
+    QVector<EntityItemPointer> newEntities;
+    newEntities.swap(_pendingAdds);
+    _pendingAddIDs.clear();
+
+    // Recurse the tree once and store all the entities in their tree elements
+    AddEntitiesOperator theOperator(getThisPointer(), newEntities);
+    recurseTreeWithOperator(&theOperator);
+
+    foreach (const EntityItemPointer& newEntity, newEntities) {
+        postAddEntity(newEntity);
+    }
+}
+
 void EntityTree::emitEntityScriptChanging(const EntityItemID& entityItemID, const bool reload) {
     emit entityScriptChanging(entityItemID, reload);
 }
@@ -384,16 +456,22 @@ void EntityTree::deleteEntities(QSet<EntityItemID> entityIDs, bool force, bool i
     }
 }
 
-void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator) {
+void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator, bool eraseOnViewers) {
     quint64 deletedAt = usecTimestampNow();
     const RemovedEntities& entities = theOperator.getEntities();
     foreach(const EntityToDeleteDetails& details, entities) {
         EntityItemPointer theEntity = details.entity;
 
-        if (getIsServer()) {
+        journalEntityDeleted(theEntity->getEntityItemID());
+
+        if (getIsServer() && eraseOnViewers) {
             // set up the deleted entities ID
             QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-            _recentlyDeletedEntityItemIDs.insert(deletedAt, theEntity->getEntityItemID());
+            // the log stays ordered even if the clock skew was adjusted since the last deletion
+            if (!_recentlyDeletedEntities.empty()) {
+                deletedAt = std::max(deletedAt, _recentlyDeletedEntities.back().deletedAt);
+            }
+            _recentlyDeletedEntities.push_back({ deletedAt, theEntity->getEntityItemID() });
         }
 
         if (_simulation) {
@@ -414,7 +492,7 @@ public:
 };
 
 
-bool EntityTree::findNearPointOperation(OctreeElementPointer element, void* extraData) {
+bool EntityTree::findNearPointOperation(const OctreeElementPointer& element, void* extraData) {
     FindNearPointArgs* args = static_cast<FindNearPointArgs*>(extraData);
     EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
 
@@ -448,6 +526,9 @@ bool EntityTree::findNearPointOperation(OctreeElementPointer element, void* extr
     // if this element doesn't contain the point, then none of its children can contain the point, so stop searching
     return false;
 }
+// the picks a traversal holds without allocating, more spill onto the heap
+const int MAX_INLINE_RAY_PICKS = 8;
+
 // combines the ray cast arguments into a single object
 class RayArgs {
 public:
@@ -464,16 +545,65 @@ public:
 };
 
 
-bool findRayIntersectionOp(OctreeElementPointer element, void* extraData) {
-    RayArgs* args = static_cast<RayArgs*>(extraData);
+// like recursing the tree with an operation, but the children of an element are tested against the ray together and
+// only the ones it hits are visited, closest first and never past the closest intersection found so far
+static void findRayIntersectionInElement(EntityTreeElementPointer element, RayArgs& args, int recursionCount = 0) {
+    if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
+        qCDebug(entities) << "EntityTree::findRayIntersection() reached DANGEROUSLY_DEEP_RECURSION, bailing!";
+        return;
+    }
+
     bool keepSearching = true;
-    EntityTreeElementPointer entityTreeElementPointer = std::dynamic_pointer_cast<EntityTreeElement>(element);
-    if (entityTreeElementPointer ->findRayIntersection(args->origin, args->direction, keepSearching,
-        args->element, args->distance, args->face, args->surfaceNormal, args->entityIdsToInclude,
-        args->intersectedObject, args->precisionPicking)) {
-        args->found = true;
+    if (element->findRayIntersection(args.origin, args.direction, keepSearching,
+        args.element, args.distance, args.face, args.surfaceNormal, args.entityIdsToInclude,
+        args.intersectedObject, args.precisionPicking)) {
+        args.found = true;
+    }
+    if (!keepSearching) {
+        return;
+    }
+
+    RayIntersectionKernels::BoxBatch childBoxes;
+    EntityTreeElementPointer children[NUMBER_OF_CHILDREN];
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElementPointer child = element->getChildAtIndex(i);
+        if (child) {
+            const AACube& childCube = child->getAACube();
+            children[childBoxes.numBoxes] = std::static_pointer_cast<EntityTreeElement>(child);
+            childBoxes.add(childCube.getMinimumPoint(), childCube.getMaximumPoint());
+        }
+    }
+    if (childBoxes.numBoxes == 0) {
+        return;
+    }
+
+    float childDistances[RayIntersectionKernels::BOX_BATCH_SIZE];
+    uint8_t childHits = RayIntersectionKernels::findRayBoxesIntersection(args.origin, args.direction, childBoxes,
+                                                                         childDistances);
+
+    // sort the hit children by distance, closer intersections let more of the far ones be skipped
+    int hitOrder[NUMBER_OF_CHILDREN];
+    int numHits = 0;
+    for (int i = 0; i < childBoxes.numBoxes; i++) {
+        if (childHits & (1 << i)) {
+            int position = numHits++;
+            while (position > 0 && childDistances[hitOrder[position - 1]] > childDistances[i]) {
+                hitOrder[position] = hitOrder[position - 1];
+                position--;
+            }
+            hitOrder[position] = i;
+        }
+    }
+
+    for (int i = 0; i < numHits; i++) {
+        int child = hitOrder[i];
+        // nothing in a child the ray enters past the closest intersection can be closer, the child and its
+        // descendants would skip their details anyway
+        if (childDistances[child] > 0.0f && childDistances[child] >= args.distance) {
+            break;
+        }
+        findRayIntersectionInElement(children[child], args, recursionCount + 1);
     }
-    return keepSearching;
 }
 
 bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
@@ -485,7 +615,9 @@ bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& d
 
     bool requireLock = lockType == Octree::Lock;
     bool lockResult = withReadLock([&]{
-        recurseTreeWithOperation(findRayIntersectionOp, &args);
+        if (_rootElement) {
+            findRayIntersectionInElement(std::static_pointer_cast<EntityTreeElement>(_rootElement), args);
+        }
     }, requireLock);
 
     if (accurateResult) {
@@ -495,12 +627,128 @@ bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& d
     return args.found;
 }
 
+// a pick and where it enters the children of the element being visited
+struct ChildPickHits {
+    EntityRayPick* pick;
+    uint8_t hits;
+    float distances[RayIntersectionKernels::BOX_BATCH_SIZE];
+};
+
+// findRayIntersectionInElement for many picks, each child is visited once with the picks that hit it, as long as they
+// have hit nothing closer than where they enter it
+static void findRayPickIntersectionsInElement(EntityTreeElementPointer element, EntityRayPick* const* picks, int numPicks,
+                                              int recursionCount = 0) {
+    if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
+        qCDebug(entities) << "EntityTree::findRayIntersections() reached DANGEROUSLY_DEEP_RECURSION, bailing!";
+        return;
+    }
+
+    QVarLengthArray<EntityRayPick*, MAX_INLINE_RAY_PICKS> searchingPicks;
+    for (int i = 0; i < numPicks; i++) {
+        bool keepSearching = true;
+        element->findRayPickIntersection(*picks[i], keepSearching);
+        if (keepSearching) {
+            searchingPicks.append(picks[i]);
+        }
+    }
+    if (searchingPicks.isEmpty()) {
+        return;
+    }
+
+    RayIntersectionKernels::BoxBatch childBoxes;
+    EntityTreeElementPointer children[NUMBER_OF_CHILDREN];
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElementPointer child = element->getChildAtIndex(i);
+        if (child) {
+            const AACube& childCube = child->getAACube();
+            children[childBoxes.numBoxes] = std::static_pointer_cast<EntityTreeElement>(child);
+            childBoxes.add(childCube.getMinimumPoint(), childCube.getMaximumPoint());
+        }
+    }
+    if (childBoxes.numBoxes == 0) {
+        return;
+    }
+
+    // the closest any pick enters each child, to visit them in that order
+    QVarLengthArray<ChildPickHits, MAX_INLINE_RAY_PICKS> pickHits;
+    float closestDistances[NUMBER_OF_CHILDREN];
+    std::fill(closestDistances, closestDistances + NUMBER_OF_CHILDREN, FLT_MAX);
+    uint8_t anyHits = 0;
+    foreach (EntityRayPick* pick, searchingPicks) {
+        ChildPickHits pickHit;
+        pickHit.pick = pick;
+        pickHit.hits = RayIntersectionKernels::findRayBoxesIntersection(pick->origin, pick->direction, childBoxes,
+                                                                        pickHit.distances);
+        if (pickHit.hits == 0) {
+            continue;
+        }
+        for (int child = 0; child < childBoxes.numBoxes; child++) {
+            if (pickHit.hits & (1 << child)) {
+                closestDistances[child] = std::min(closestDistances[child], pickHit.distances[child]);
+            }
+        }
+        anyHits |= pickHit.hits;
+        pickHits.append(pickHit);
+    }
+
+    int hitOrder[NUMBER_OF_CHILDREN];
+    int numHits = 0;
+    for (int i = 0; i < childBoxes.numBoxes; i++) {
+        if (anyHits & (1 << i)) {
+            int position = numHits++;
+            while (position > 0 && closestDistances[hitOrder[position - 1]] > closestDistances[i]) {
+                hitOrder[position] = hitOrder[position - 1];
+                position--;
+            }
+            hitOrder[position] = i;
+        }
+    }
+
+    for (int i = 0; i < numHits; i++) {
+        int child = hitOrder[i];
+        QVarLengthArray<EntityRayPick*, MAX_INLINE_RAY_PICKS> childPicks;
+        foreach (const ChildPickHits& pickHit, pickHits) {
+            float childDistance = pickHit.distances[child];
+            if ((pickHit.hits & (1 << child)) && (childDistance <= 0.0f || childDistance < pickHit.pick->distance)) {
+                childPicks.append(pickHit.pick);
+            }
+        }
+        if (!childPicks.isEmpty()) {
+            findRayPickIntersectionsInElement(children[child], childPicks.constData(), childPicks.size(), recursionCount + 1);
+        }
+    }
+}
+
+bool EntityTree::findRayIntersections(QVector<EntityRayPick*>& picks, Octree::lockType lockType) {
+    if (picks.isEmpty()) {
+        return true;
+    }
+
+    bool requireLock = lockType == Octree::Lock;
+    return withReadLock([&] {
+        foreach (EntityRayPick* pick, picks) {
+            pick->resetResult();
+        }
+        if (_rootElement) {
+            findRayPickIntersectionsInElement(std::static_pointer_cast<EntityTreeElement>(_rootElement),
+                                              picks.constData(), picks.size());
+        }
+    }, requireLock);
+}
 
 EntityItemPointer EntityTree::findClosestEntity(glm::vec3 position, float targetRadius) {
     FindNearPointArgs args = { position, targetRadius, false, NULL, FLT_MAX };
     withReadLock([&] {
-        // NOTE: This should use recursion, since this is a spatial operation
-        recurseTreeWithOperation(findNearPointOperation, &args);
+        if (_useSpatialHash) {
+            QVector<EntityTreeElementPointer> elements;
+            _spatialHash.findElements(AABox(position - glm::vec3(targetRadius), 2.0f * targetRadius), elements);
+            foreach (EntityTreeElementPointer element, elements) {
+                findNearPointOperation(element, &args);
+            }
+        } else {
+            // NOTE: This should use recursion, since this is a spatial operation
+            recurseTreeWithOperation(findNearPointOperation, &args);
+        }
     });
     return args.closestEntity;
 }
@@ -513,7 +761,7 @@ public:
 };
 
 
-bool EntityTree::findInSphereOperation(OctreeElementPointer element, void* extraData) {
+bool EntityTree::findInSphereOperation(const OctreeElementPointer& element, void* extraData) {
     FindAllNearPointArgs* args = static_cast<FindAllNearPointArgs*>(extraData);
     glm::vec3 penetration;
     bool sphereIntersection = element->getAACube().findSpherePenetration(args->position, args->targetRadius, penetration);
@@ -532,8 +780,16 @@ bool EntityTree::findInSphereOperation(OctreeElementPointer element, void* extra
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities) {
     FindAllNearPointArgs args = { center, radius, QVector<EntityItemPointer>() };
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInSphereOperation, &args);
+    if (_useSpatialHash) {
+        QVector<EntityTreeElementPointer> elements;
+        _spatialHash.findElements(AABox(center - glm::vec3(radius), 2.0f * radius), elements);
+        foreach (EntityTreeElementPointer element, elements) {
+            findInSphereOperation(element, &args);
+        }
+    } else {
+        // NOTE: This should use recursion, since this is a spatial operation
+        recurseTreeWithOperation(findInSphereOperation, &args);
+    }
 
     // swap the two lists of entity pointers instead of copy
     foundEntities.swap(args.entities);
@@ -549,7 +805,7 @@ public:
     QVector<EntityItemPointer> _foundEntities;
 };
 
-bool EntityTree::findInCubeOperation(OctreeElementPointer element, void* extraData) {
+bool EntityTree::findInCubeOperation(const OctreeElementPointer& element, void* extraData) {
     FindEntitiesInCubeArgs* args = static_cast<FindEntitiesInCubeArgs*>(extraData);
     if (element->getAACube().touches(args->_cube)) {
         EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
@@ -562,8 +818,16 @@ bool EntityTree::findInCubeOperation(OctreeElementPointer element, void* extraDa
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) {
     FindEntitiesInCubeArgs args(cube);
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInCubeOperation, &args);
+    if (_useSpatialHash) {
+        QVector<EntityTreeElementPointer> elements;
+        _spatialHash.findElements(AABox(cube), elements);
+        foreach (EntityTreeElementPointer element, elements) {
+            findInCubeOperation(element, &args);
+        }
+    } else {
+        // NOTE: This should use recursion, since this is a spatial operation
+        recurseTreeWithOperation(findInCubeOperation, &args);
+    }
     // swap the two lists of entity pointers instead of copy
     foundEntities.swap(args._foundEntities);
 }
@@ -578,7 +842,7 @@ public:
     QVector<EntityItemPointer> _foundEntities;
 };
 
-bool EntityTree::findInBoxOperation(OctreeElementPointer element, void* extraData) {
+bool EntityTree::findInBoxOperation(const OctreeElementPointer& element, void* extraData) {
     FindEntitiesInBoxArgs* args = static_cast<FindEntitiesInBoxArgs*>(extraData);
     if (element->getAACube().touches(args->_box)) {
         EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
@@ -591,8 +855,16 @@ bool EntityTree::findInBoxOperation(OctreeElementPointer element, void* extraDat
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) {
     FindEntitiesInBoxArgs args(box);
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInBoxOperation, &args);
+    if (_useSpatialHash) {
+        QVector<EntityTreeElementPointer> elements;
+        _spatialHash.findElements(box, elements);
+        foreach (EntityTreeElementPointer element, elements) {
+            findInBoxOperation(element, &args);
+        }
+    } else {
+        // NOTE: This should use recursion, since this is a spatial operation
+        recurseTreeWithOperation(findInBoxOperation, &args);
+    }
     // swap the two lists of entity pointers instead of copy
     foundEntities.swap(args._foundEntities);
 }
@@ -639,95 +911,13 @@ int EntityTree::processEditPacketData(NLPacket& packet, const unsigned char* edi
         }
 
         case PacketType::EntityAdd:
-        case PacketType::EntityEdit: {
-            quint64 startDecode = 0, endDecode = 0;
-            quint64 startLookup = 0, endLookup = 0;
-            quint64 startUpdate = 0, endUpdate = 0;
-            quint64 startCreate = 0, endCreate = 0;
-            quint64 startLogging = 0, endLogging = 0;
-
-            _totalEditMessages++;
-
-            EntityItemID entityItemID;
-            EntityItemProperties properties;
-            startDecode = usecTimestampNow();
-           
-            bool validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
-                                                                                entityItemID, properties);
-            endDecode = usecTimestampNow();
-
-            // If we got a valid edit packet, then it could be a new entity or it could be an update to
-            // an existing entity... handle appropriately
-            if (validEditPacket) {
-                // search for the entity by EntityItemID
-                startLookup = usecTimestampNow();
-                EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
-                endLookup = usecTimestampNow();
-                if (existingEntity && packet.getType() == PacketType::EntityEdit) {
-                    // if the EntityItem exists, then update it
-                    startLogging = usecTimestampNow();
-                    if (wantEditLogging()) {
-                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
-                        qCDebug(entities) << "   properties:" << properties;
-                    }
-                    if (wantTerseEditLogging()) {
-                        QList<QString> changedProperties = properties.listChangedProperties();
-                        fixupTerseEditLogging(properties, changedProperties);
-                        qCDebug(entities) << "edit" << entityItemID.toString() << changedProperties;
-                    }
-                    endLogging = usecTimestampNow();
-
-                    startUpdate = usecTimestampNow();
-                    updateEntity(entityItemID, properties, senderNode);
-                    existingEntity->markAsChangedOnServer();
-                    endUpdate = usecTimestampNow();
-                    _totalUpdates++;
-                } else if (packet.getType() == PacketType::EntityAdd) {
-                    if (senderNode->getCanRez()) {
-                        // this is a new entity... assign a new entityID
-                        properties.setCreated(properties.getLastEdited());
-                        startCreate = usecTimestampNow();
-                        EntityItemPointer newEntity = addEntity(entityItemID, properties);
-                        endCreate = usecTimestampNow();
-                        _totalCreates++;
-                        if (newEntity) {
-                            newEntity->markAsChangedOnServer();
-                            notifyNewlyCreatedEntity(*newEntity, senderNode);
-
-                            startLogging = usecTimestampNow();
-                            if (wantEditLogging()) {
-                                qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
-                                                << newEntity->getEntityItemID();
-                                qCDebug(entities) << "   properties:" << properties;
-                            }
-                            if (wantTerseEditLogging()) {
-                                QList<QString> changedProperties = properties.listChangedProperties();
-                                fixupTerseEditLogging(properties, changedProperties);
-                                qCDebug(entities) << "add" << entityItemID.toString() << changedProperties;
-                            }
-                            endLogging = usecTimestampNow();
-
-                        }
-                    } else {
-                        qCDebug(entities) << "User without 'rez rights' [" << senderNode->getUUID()
-                                          << "] attempted to add an entity.";
-                    }
-                } else {
-                    static QString repeatedMessage =
-                        LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
-                    qCDebug(entities) << "Edit failed. [" << packet.getType() <<"] " <<
-                            "entity id:" << entityItemID << 
-                            "existingEntity pointer:" << existingEntity.get();
-                }
+        case PacketType::EntityEdit:
+        case PacketType::EntitySimulationUpdate: {
+            std::function<void()> applyEdit;
+            processedBytes = decodeEditPacketData(packet, editData, maxLength, senderNode, applyEdit);
+            if (applyEdit) {
+                applyEdit();
             }
-
-
-            _totalDecodeTime += endDecode - startDecode;
-            _totalLookupTime += endLookup - startLookup;
-            _totalUpdateTime += endUpdate - startUpdate;
-            _totalCreateTime += endCreate - startCreate;
-            _totalLoggingTime += endLogging - startLogging;
-
             break;
         }
 
@@ -739,6 +929,178 @@ int EntityTree::processEditPacketData(NLPacket& packet, const unsigned char* edi
 }
 
 
+int EntityTree::decodeEditPacketData(NLPacket& packet, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& senderNode, std::function<void()>& applyEdit) {
+    PacketType packetType = packet.getType();
+
+    // erases are left to processEditPacketData, they are rare and cheap to decode
+    if (!getIsServer() || (packetType != PacketType::EntityAdd && packetType != PacketType::EntityEdit &&
+                           packetType != PacketType::EntitySimulationUpdate)) {
+        return 0;
+    }
+
+    _totalEditMessages++;
+
+    int processedBytes = 0;
+    EntityItemID entityItemID;
+    EntityItemProperties properties;
+    bool validEditPacket = false;
+    bool accelerationIsGravity = false;
+
+    quint64 startDecode = usecTimestampNow();
+    if (packetType == PacketType::EntitySimulationUpdate) {
+        validEditPacket = EntitySimulationUpdate::decode(editData, maxLength, processedBytes, entityItemID, properties,
+                                                         accelerationIsGravity);
+    } else {
+        validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
+                                                                       entityItemID, properties);
+    }
+    _totalDecodeTime += usecTimestampNow() - startDecode;
+
+    // If we got a valid edit packet, then it could be a new entity or it could be an update to
+    // an existing entity... handle appropriately
+    if (validEditPacket) {
+        applyEdit = [=]() mutable {
+            if (packetType == PacketType::EntitySimulationUpdate) {
+                // a simulation update is an edit whose acceleration may be the gravity the entity has in the tree
+                if (accelerationIsGravity) {
+                    EntityItemPointer entity = findEntityByEntityItemID(entityItemID);
+                    if (entity) {
+                        properties.setAcceleration(entity->getGravity());
+                    }
+                }
+                applyEditPacketData(PacketType::EntityEdit, entityItemID, properties, senderNode);
+            } else {
+                applyEditPacketData(packetType, entityItemID, properties, senderNode);
+            }
+        };
+    } else {
+        applyEdit = []{ };
+    }
+
+    return processedBytes;
+}
+
+int EntityTree::predecodeElementData(const unsigned char* data, int bytesLeftToRead, bool isRootElement,
+                                     ReadBitstreamToTreeParams& args, PredecodedBitstreamPointer& predecoded) const {
+    // this follows EntityTreeElement::readElementDataFromBuffer, the entities are read into new items apart from the tree
+    if (isRootElement && args.bitstreamVersion < VERSION_ROOT_ELEMENT_HAS_DATA) {
+        return 0;
+    }
+    if (args.bitstreamVersion < VERSION_ENTITIES_SUPPORT_SPLIT_MTU) {
+        return -1; // old files without entity ids, nothing to match the items to later
+    }
+
+    const unsigned char* dataAt = data;
+    int bytesRead = 0;
+    uint16_t numberOfEntities = 0;
+    if (bytesLeftToRead < (int)sizeof(numberOfEntities)) {
+        return 0;
+    }
+    numberOfEntities = *(uint16_t*)dataAt;
+    dataAt += sizeof(numberOfEntities);
+    bytesLeftToRead -= (int)sizeof(numberOfEntities);
+    bytesRead += sizeof(numberOfEntities);
+
+    if (bytesLeftToRead < (int)(numberOfEntities * EntityItem::expectedBytes())) {
+        return bytesRead;
+    }
+
+    for (uint16_t i = 0; i < numberOfEntities; i++) {
+        EntityItemPointer entityItem = EntityTypes::constructEntityItem(dataAt, bytesLeftToRead, args);
+        if (!entityItem) {
+            return -1;
+        }
+        int bytesForThisEntity = entityItem->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
+        if (!predecoded) {
+            predecoded = std::make_shared<PredecodedEntities>();
+        }
+        PredecodedEntities::Entity predecodedEntity;
+        predecodedEntity.entity = entityItem;
+        predecodedEntity.bytes = bytesForThisEntity;
+        static_cast<PredecodedEntities*>(predecoded.get())->entities.insert(dataAt, predecodedEntity);
+
+        dataAt += bytesForThisEntity;
+        bytesLeftToRead -= bytesForThisEntity;
+        bytesRead += bytesForThisEntity;
+    }
+    return bytesRead;
+}
+
+void EntityTree::applyEditPacketData(PacketType packetType, const EntityItemID& entityItemID,
+                                     EntityItemProperties& properties, const SharedNodePointer& senderNode) {
+    quint64 startLookup = 0, endLookup = 0;
+    quint64 startUpdate = 0, endUpdate = 0;
+    quint64 startCreate = 0, endCreate = 0;
+    quint64 startLogging = 0, endLogging = 0;
+
+    // search for the entity by EntityItemID
+    startLookup = usecTimestampNow();
+    EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
+    endLookup = usecTimestampNow();
+    if (existingEntity && packetType == PacketType::EntityEdit) {
+        // if the EntityItem exists, then update it
+        startLogging = usecTimestampNow();
+        if (wantEditLogging()) {
+            qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+            qCDebug(entities) << "   properties:" << properties;
+        }
+        if (wantTerseEditLogging()) {
+            QList<QString> changedProperties = properties.listChangedProperties();
+            fixupTerseEditLogging(properties, changedProperties);
+            qCDebug(entities) << "edit" << entityItemID.toString() << changedProperties;
+        }
+        endLogging = usecTimestampNow();
+
+        startUpdate = usecTimestampNow();
+        updateEntity(entityItemID, properties, senderNode);
+        existingEntity->markAsChangedOnServer();
+        endUpdate = usecTimestampNow();
+        _totalUpdates++;
+    } else if (packetType == PacketType::EntityAdd) {
+        if (senderNode->getCanRez()) {
+            // this is a new entity... assign a new entityID
+            properties.setCreated(properties.getLastEdited());
+            startCreate = usecTimestampNow();
+            EntityItemPointer newEntity = addEntity(entityItemID, properties);
+            endCreate = usecTimestampNow();
+            _totalCreates++;
+            if (newEntity) {
+                newEntity->markAsChangedOnServer();
+                notifyNewlyCreatedEntity(*newEntity, senderNode);
+
+                startLogging = usecTimestampNow();
+                if (wantEditLogging()) {
+                    qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
+                                    << newEntity->getEntityItemID();
+                    qCDebug(entities) << "   properties:" << properties;
+                }
+                if (wantTerseEditLogging()) {
+                    QList<QString> changedProperties = properties.listChangedProperties();
+                    fixupTerseEditLogging(properties, changedProperties);
+                    qCDebug(entities) << "add" << entityItemID.toString() << changedProperties;
+                }
+                endLogging = usecTimestampNow();
+
+            }
+        } else {
+            qCDebug(entities) << "User without 'rez rights' [" << senderNode->getUUID()
+                              << "] attempted to add an entity.";
+        }
+    } else {
+        static QString repeatedMessage =
+            LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
+        qCDebug(entities) << "Edit failed. [" << packetType <<"] " <<
+                "entity id:" << entityItemID << 
+                "existingEntity pointer:" << existingEntity.get();
+    }
+
+    _totalLookupTime += endLookup - startLookup;
+    _totalUpdateTime += endUpdate - startUpdate;
+    _totalCreateTime += endCreate - startCreate;
+    _totalLoggingTime += endLogging - startLogging;
+}
+
 void EntityTree::notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
     _newlyCreatedHooksLock.lockForRead();
     for (int i = 0; i < _newlyCreatedHooks.size(); i++) {
@@ -806,21 +1168,13 @@ quint64 EntityTree::getAdjustedConsiderSince(quint64 sinceTime) {
 }
 
 
-bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime) {
+bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime) const {
     quint64 considerEntitiesSince = getAdjustedConsiderSince(sinceTime);
 
-    // we can probably leverage the ordered nature of QMultiMap to do this quickly...
-    bool hasSomethingNewer = false;
-
+    // the log is ordered by the time of the deletions, which are kept for a while after every client was told
     QReadLocker locker(&_recentlyDeletedEntitiesLock);
-    QMultiMap<quint64, QUuid>::const_iterator iterator = _recentlyDeletedEntityItemIDs.constBegin();
-    while (iterator != _recentlyDeletedEntityItemIDs.constEnd()) {
-        if (iterator.key() > considerEntitiesSince) {
-            hasSomethingNewer = true;
-            break; // if we have at least one item, we don't need to keep searching
-        }
-        ++iterator;
-    }
+    bool hasSomethingNewer = !_recentlyDeletedEntities.empty() &&
+        _recentlyDeletedEntities.back().deletedAt > considerEntitiesSince;
 
 #ifdef EXTRA_ERASE_DEBUGGING
     if (hasSomethingNewer) {
@@ -837,22 +1191,24 @@ bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime) {
 // called by the server when it knows all nodes have been sent deleted packets
 void EntityTree::forgetEntitiesDeletedBefore(quint64 sinceTime) {
     quint64 considerSinceTime = sinceTime - DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER;
-    QSet<quint64> keysToRemove;
     QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-    QMultiMap<quint64, QUuid>::iterator iterator = _recentlyDeletedEntityItemIDs.begin();
-
-    // First find all the keys in the map that are older and need to be deleted
-    while (iterator != _recentlyDeletedEntityItemIDs.end()) {
-        if (iterator.key() <= considerSinceTime) {
-            keysToRemove << iterator.key();
-        }
-        ++iterator;
+    while (!_recentlyDeletedEntities.empty() && _recentlyDeletedEntities.front().deletedAt <= considerSinceTime) {
+        _recentlyDeletedEntities.pop_front();
     }
+    _deletedEntitiesForgottenBefore = std::max(_deletedEntitiesForgottenBefore, considerSinceTime);
+}
 
-    // Now run through the keysToRemove and remove them
-    foreach (quint64 value, keysToRemove) {
-        _recentlyDeletedEntityItemIDs.remove(value);
+quint64 EntityTree::getEntityDeletedAt(int countBeforeNewest) const {
+    QReadLocker locker(&_recentlyDeletedEntitiesLock);
+    if (countBeforeNewest < 0 || countBeforeNewest >= (int)_recentlyDeletedEntities.size()) {
+        return 0;
     }
+    return _recentlyDeletedEntities[_recentlyDeletedEntities.size() - 1 - countBeforeNewest].deletedAt;
+}
+
+bool EntityTree::hasAllEntitiesDeletedSince(quint64 sinceTime) const {
+    QReadLocker locker(&_recentlyDeletedEntitiesLock);
+    return sinceTime <= usecTimestampNow() && getAdjustedConsiderSince(sinceTime) >= _deletedEntitiesForgottenBefore;
 }
 
 
@@ -947,6 +1303,11 @@ int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, cons
 }
 
 EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& entityItemID)  /*const*/ {
+    // an entity added in the current edit batch has to be placed before it can be found
+    if (_pendingAddIDs.contains(entityItemID)) {
+        flushPendingAdds();
+    }
+
     // TODO: do we need to make this thread safe? Or is it acceptable as is
     EntityTreeElementPointer element = _entityToElementMap.value(entityItemID);
     return element;
@@ -954,8 +1315,17 @@ EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& en
 
 void EntityTree::setContainingElement(const EntityItemID& entityItemID, EntityTreeElementPointer element) {
     // TODO: do we need to make this thread safe? Or is it acceptable as is
+    EntityTreeElementPointer oldElement = _entityToElementMap.value(entityItemID);
+    if (oldElement == element) {
+        return;
+    }
+    if (oldElement) {
+        _spatialHash.removeElement(oldElement);
+    }
+
     if (element) {
         _entityToElementMap[entityItemID] = element;
+        _spatialHash.addElement(element);
     } else {
         _entityToElementMap.remove(entityItemID);
     }
@@ -973,14 +1343,14 @@ void EntityTree::debugDumpMap() {
 
 class ContentsDimensionOperator : public RecurseOctreeOperator {
 public:
-    virtual bool preRecursion(OctreeElementPointer element);
-    virtual bool postRecursion(OctreeElementPointer element) { return true; }
+    virtual bool preRecursion(const OctreeElementPointer& element);
+    virtual bool postRecursion(const OctreeElementPointer& element) { return true; }
     float getLargestDimension() const { return _contentExtents.largestDimension(); }
 private:
     Extents _contentExtents;
 };
 
-bool ContentsDimensionOperator::preRecursion(OctreeElementPointer element) {
+bool ContentsDimensionOperator::preRecursion(const OctreeElementPointer& element) {
     EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
     entityTreeElement->expandExtentsToContents(_contentExtents);
     return true;
@@ -994,11 +1364,11 @@ float EntityTree::getContentsLargestDimension() {
 
 class DebugOperator : public RecurseOctreeOperator {
 public:
-    virtual bool preRecursion(OctreeElementPointer element);
-    virtual bool postRecursion(OctreeElementPointer element) { return true; }
+    virtual bool preRecursion(const OctreeElementPointer& element);
+    virtual bool postRecursion(const OctreeElementPointer& element) { return true; }
 };
 
-bool DebugOperator::preRecursion(OctreeElementPointer element) {
+bool DebugOperator::preRecursion(const OctreeElementPointer& element) {
     EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
     qCDebug(entities) << "EntityTreeElement [" << entityTreeElement.get() << "]";
     entityTreeElement->debugDump();
@@ -1012,11 +1382,11 @@ void EntityTree::dumpTree() {
 
 class PruneOperator : public RecurseOctreeOperator {
 public:
-    virtual bool preRecursion(OctreeElementPointer element) { return true; }
-    virtual bool postRecursion(OctreeElementPointer element);
+    virtual bool preRecursion(const OctreeElementPointer& element) { return true; }
+    virtual bool postRecursion(const OctreeElementPointer& element);
 };
 
-bool PruneOperator::postRecursion(OctreeElementPointer element) {
+bool PruneOperator::postRecursion(const OctreeElementPointer& element) {
     EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
     entityTreeElement->pruneChildren();
     return true;
@@ -1041,7 +1411,7 @@ QVector<EntityItemID> EntityTree::sendEntities(EntityEditPacketSender* packetSen
     return newEntityIDs;
 }
 
-bool EntityTree::sendEntitiesOperation(OctreeElementPointer element, void* extraData) {
+bool EntityTree::sendEntitiesOperation(const OctreeElementPointer& element, void* extraData) {
     SendEntitiesOperationArgs* args = static_cast<SendEntitiesOperationArgs*>(extraData);
     EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
     entityTreeElement->forEachEntity([&](EntityItemPointer entityItem) {
@@ -1064,6 +1434,88 @@ bool EntityTree::sendEntitiesOperation(OctreeElementPointer element, void* extra
     return true;
 }
 
+int EntityTree::handOffEntities(const JurisdictionMap& myJurisdiction, NodeToJurisdictionMap& otherJurisdictions,
+                                EntityEditPacketSender* packetSender) {
+    QVector<EntityItemPointer> handedOffEntities;
+    otherJurisdictions.withReadLock([&] {
+        if (!otherJurisdictions.isEmpty()) {
+            HandOffEntitiesOperationArgs args;
+            args.myJurisdiction = &myJurisdiction;
+            args.otherJurisdictions = &otherJurisdictions;
+            args.handedOffEntities = &handedOffEntities;
+            recurseTreeWithOperation(handOffEntitiesOperation, &args);
+        }
+    });
+
+    if (handedOffEntities.isEmpty()) {
+        return 0;
+    }
+
+    DeleteEntityOperator theOperator(getThisPointer());
+    foreach (EntityItemPointer entityItem, handedOffEntities) {
+        EntityItemProperties properties = entityItem->getProperties();
+        properties.markAllChanged(); // the whole entity is new to the other server
+
+        // the add goes to the server whose jurisdiction contains the position of the entity
+        packetSender->queueEditEntityMessage(PacketType::EntityAdd, entityItem->getEntityItemID(), properties);
+
+        theOperator.addEntityIDToDeleteList(entityItem->getEntityItemID());
+        emit deletingEntity(entityItem->getEntityItemID());
+    }
+    recurseTreeWithOperator(&theOperator);
+    processRemovedEntities(theOperator, false);
+    _isDirty = true;
+
+    return handedOffEntities.size();
+}
+
+bool EntityTree::handOffEntitiesOperation(const OctreeElementPointer& element, void* extraData) {
+    HandOffEntitiesOperationArgs* args = static_cast<HandOffEntitiesOperationArgs*>(extraData);
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+    entityTreeElement->forEachEntity([&](EntityItemPointer entityItem) {
+        glm::vec3 position = entityItem->getPosition();
+        if (args->myJurisdiction->isMyJurisdiction(position) == JurisdictionMap::WITHIN) {
+            return;
+        }
+        for (auto& jurisdiction : *args->otherJurisdictions) {
+            if (jurisdiction.isMyJurisdiction(position) == JurisdictionMap::WITHIN) {
+                args->handedOffEntities->append(entityItem);
+                return;
+            }
+        }
+    });
+    return true;
+}
+
+// the number of entities in the subtree of the element, once the largest subtrees with at most maxEntities are in roots
+static int collectJurisdictionRoots(OctreeElementPointer element, int maxEntities, QStringList& roots) {
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+    int entityCount = entityTreeElement->size();
+    QStringList childRoots;
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElementPointer child = element->getChildAtIndex(i);
+        if (child) {
+            entityCount += collectJurisdictionRoots(child, maxEntities, childRoots);
+        }
+    }
+    if (entityCount <= maxEntities) {
+        if (entityCount > 0) {
+            roots << octalCodeToHexString(element->getOctalCode());
+        }
+    } else {
+        roots << childRoots;
+    }
+    return entityCount;
+}
+
+QStringList EntityTree::suggestJurisdictionRoots(int maxEntities) {
+    QStringList roots;
+    withReadLock([&] {
+        collectJurisdictionRoots(getRoot(), maxEntities, roots);
+    });
+    return roots;
+}
+
 bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues) {
     if (! entityDescription.contains("Entities")) {
         entityDescription["Entities"] = QVariantList();
@@ -1083,26 +1535,111 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     QScriptEngine scriptEngine;
 
     foreach (QVariant entityVariant, entitiesQList) {
-        // QVariantMap --> QScriptValue --> EntityItemProperties --> Entity
         QVariantMap entityMap = entityVariant.toMap();
-        QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
-        EntityItemProperties properties;
-        EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+        addEntityFromMap(entityMap, scriptEngine);
+    }
 
-        EntityItemID entityItemID;
-        if (entityMap.contains("id")) {
-            entityItemID = EntityItemID(QUuid(entityMap["id"].toString()));
-        } else {
-            entityItemID = EntityItemID(QUuid::createUuid());
-        }
+    return true;
+}
+
+bool EntityTree::writeBinaryMapToFile(const char* fileName, const QVariantMap& entityDescription) {
+    return EntityBinaryFile::write(fileName, entityDescription);
+}
 
-        EntityItemPointer entity = addEntity(entityItemID, properties);
+bool EntityTree::readFromBinaryFile(const QString& fileName) {
+    return EntityBinaryFile::read(*this, fileName);
+}
+
+EntityItemPointer EntityTree::addEntityFromMap(QVariantMap& entityMap, QScriptEngine& scriptEngine) {
+    // QVariantMap --> QScriptValue --> EntityItemProperties --> Entity
+    QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+    EntityItemProperties properties;
+    EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+
+    EntityItemID entityItemID;
+    if (entityMap.contains("id")) {
+        entityItemID = EntityItemID(QUuid(entityMap["id"].toString()));
+    } else {
+        entityItemID = EntityItemID(QUuid::createUuid());
+    }
+
+    EntityItemPointer entity = addEntity(entityItemID, properties);
+    if (!entity) {
+        qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+    }
+    return entity;
+}
+
+bool EntityTree::startJournal() {
+    _journalStarted = true;
+    _journalChangedEntities.clear();
+    _journalDeletedEntities.clear();
+    return true;
+}
+
+void EntityTree::journalEntityChanged(const EntityItemID& entityID) {
+    if (_journalStarted) {
+        _journalDeletedEntities.remove(entityID);
+        _journalChangedEntities.insert(entityID);
+    }
+}
+
+void EntityTree::journalEntityDeleted(const EntityItemID& entityID) {
+    if (_journalStarted) {
+        _journalChangedEntities.remove(entityID);
+        _journalDeletedEntities.insert(entityID);
+    }
+}
+
+void EntityTree::takeJournalEntries(QVariantList& entries) {
+    foreach (const EntityItemID& entityID, _journalDeletedEntities) {
+        QVariantMap entry;
+        entry["op"] = "delete";
+        entry["id"] = entityID.toString();
+        entries << entry;
+    }
+    _journalDeletedEntities.clear();
+
+    if (_journalChangedEntities.isEmpty()) {
+        return;
+    }
+
+    // the entity is written as it is now, however many times it was edited since the last call
+    QScriptEngine scriptEngine;
+    foreach (const EntityItemID& entityID, _journalChangedEntities) {
+        EntityItemPointer entity = findEntityByEntityItemID(entityID);
         if (!entity) {
-            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+            continue;
         }
+        QVariantMap entry;
+        entry["op"] = "edit";
+        entry["entity"] = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, entity->getProperties()).toVariant();
+        entries << entry;
     }
+    _journalChangedEntities.clear();
+}
 
-    return true;
+bool EntityTree::readJournalEntry(const QVariantMap& entry) {
+    QString op = entry["op"].toString();
+
+    if (op == "delete") {
+        deleteEntity(EntityItemID(QUuid(entry["id"].toString())), true, true);
+        return true;
+    } else if (op == "edit") {
+        QVariantMap entityMap = entry["entity"].toMap();
+        if (!entityMap.contains("id")) {
+            return false;
+        }
+
+        // replace whatever the snapshot or an earlier entry had for this entity
+        deleteEntity(EntityItemID(QUuid(entityMap["id"].toString())), true, true);
+
+        QScriptEngine scriptEngine;
+        return addEntityFromMap(entityMap, scriptEngine) != nullptr;
+    }
+
+    qCDebug(entities) << "unknown entity journal entry:" << op;
+    return false;
 }
 
 void EntityTree::resetClientEditStats() {
@@ -12,9 +12,14 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <algorithm>
+#include <deque>
+
 #include <QSet>
+#include <QStringList>
 #include <QVector>
 
+#include <JurisdictionMap.h>
 #include <Octree.h>
 
 class EntityTree;
@@ -22,9 +27,12 @@ typedef std::shared_ptr<EntityTree> EntityTreePointer;
 
 
 #include "EntityTreeElement.h"
+#include "EntitySpatialHash.h"
 #include "DeleteEntityOperator.h"
 
 class Model;
+class EntityEncodeCache;
+class QScriptEngine;
 class EntitySimulation;
 
 class NewlyCreatedEntityHook {
@@ -40,6 +48,17 @@ public:
 };
 
 
+/// The entities of a bitstream read ahead of the tree, by where their data starts in the bitstream. They are new items
+/// that no element holds, readElementDataFromBuffer adds them to the tree when it doesn't have their entities yet.
+class PredecodedEntities : public PredecodedBitstream {
+public:
+    struct Entity {
+        EntityItemPointer entity;
+        int bytes { 0 };
+    };
+    QHash<const unsigned char*, Entity> entities;
+};
+
 class SendEntitiesOperationArgs {
 public:
     glm::vec3 root;
@@ -48,6 +67,13 @@ public:
     QVector<EntityItemID>* newEntityIDs;
 };
 
+class HandOffEntitiesOperationArgs {
+public:
+    const JurisdictionMap* myJurisdiction;
+    const NodeToJurisdictionMap* otherJurisdictions;
+    QVector<EntityItemPointer>* handedOffEntities;
+};
+
 
 class EntityTree : public Octree {
     Q_OBJECT
@@ -80,6 +106,11 @@ public:
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(NLPacket& packet, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode);
+    virtual void startEditBatch();
+    virtual void finishEditBatch();
+
+    virtual int decodeEditPacketData(NLPacket& packet, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& senderNode, std::function<void()>& applyEdit);
 
     virtual bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
         OctreeElementPointer& node, float& distance, BoxFace& face, glm::vec3& surfaceNormal,
@@ -89,6 +120,10 @@ public:
         bool* accurateResult = NULL,
         bool precisionPicking = false);
 
+    // casts all the picks in a single traversal of the tree under one lock, for the callers that each have a ray to
+    // cast every frame. Returns false when the lock could not be taken, and the picks are left as they were.
+    bool findRayIntersections(QVector<EntityRayPick*>& picks, Octree::lockType lockType = Octree::TryLock);
+
     virtual bool rootElementHasData() const { return true; }
 
     // the root at least needs to store the number of entities in the packet/buffer
@@ -144,23 +179,41 @@ public:
     /// \remark Side effect: any initial contents in entities will be lost
     void findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities);
 
+    /// spatial queries are answered from a grid of the elements holding entities unless this is turned off, in which
+    /// case they recurse the octree
+    void setUseSpatialHash(bool useSpatialHash) { _useSpatialHash = useSpatialHash; }
+    bool getUseSpatialHash() const { return _useSpatialHash; }
+
     void addNewlyCreatedHook(NewlyCreatedEntityHook* hook);
     void removeNewlyCreatedHook(NewlyCreatedEntityHook* hook);
 
     bool hasAnyDeletedEntities() const { 
         QReadLocker locker(&_recentlyDeletedEntitiesLock);
-        return _recentlyDeletedEntityItemIDs.size() > 0;
+        return !_recentlyDeletedEntities.empty();
     }
 
-    bool hasEntitiesDeletedSince(quint64 sinceTime);
+    bool hasEntitiesDeletedSince(quint64 sinceTime) const;
     static quint64 getAdjustedConsiderSince(quint64 sinceTime);
 
-    QMultiMap<quint64, QUuid> getRecentlyDeletedEntityIDs() const { 
+    /// calls the functor with the ID of each entity deleted after the time, in the order they were deleted; the IDs are
+    /// not copied, the deletions wait for the functor
+    template <typename F>
+    void eachEntityDeletedSince(quint64 sinceTime, F functor) const {
         QReadLocker locker(&_recentlyDeletedEntitiesLock);
-        return _recentlyDeletedEntityItemIDs;
+        auto it = std::upper_bound(_recentlyDeletedEntities.cbegin(), _recentlyDeletedEntities.cend(), sinceTime,
+            [](quint64 time, const DeletedEntity& deleted) { return time < deleted.deletedAt; });
+        for (; it != _recentlyDeletedEntities.cend(); ++it) {
+            functor(it->entityID);
+        }
     }
 
+    /// the time of the deletion that many before the newest, 0 when fewer are known
+    quint64 getEntityDeletedAt(int countBeforeNewest) const;
+
     void forgetEntitiesDeletedBefore(quint64 sinceTime);
+    /// whether every entity deleted since then is still known, so that a client that has the entities of then can be
+    /// sent just the deletions since
+    bool hasAllEntitiesDeletedSince(quint64 sinceTime) const;
 
     int processEraseMessage(NLPacket& packet, const SharedNodePointer& sourceNode);
     int processEraseMessageDetails(const QByteArray& buffer, const SharedNodePointer& sourceNode);
@@ -183,6 +236,20 @@ public:
     QVector<EntityItemID> sendEntities(EntityEditPacketSender* packetSender, EntityTreePointer localTree,
                                        float x, float y, float z);
 
+    /// Sends the entities outside of the jurisdiction of this server to the servers whose jurisdictions contain them,
+    /// as adds, and removes them from this tree without erasing them on the viewers, which get them from their new
+    /// server. Entities that no known jurisdiction contains stay here.
+    /// NOTE: callers must lock the tree before using this method
+    /// 
+eturn the number of entities handed off
+    int handOffEntities(const JurisdictionMap& myJurisdiction, NodeToJurisdictionMap& otherJurisdictions,
+                        EntityEditPacketSender* packetSender);
+
+    /// Partitions the tree in the largest subtrees with at most maxEntities entities, the jurisdiction roots of servers
+    /// that would share its load, as hex octal codes. The entities of the elements above them stay with the server
+    /// of the root of the tree.
+    QStringList suggestJurisdictionRoots(int maxEntities);
+
     void entityChanged(EntityItemPointer entity);
 
     void emitEntityScriptChanging(const EntityItemID& entityItemID, const bool reload);
@@ -199,6 +266,14 @@ public:
     bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues);
     bool readFromMap(QVariantMap& entityDescription);
 
+    virtual bool writeBinaryMapToFile(const char* fileName, const QVariantMap& entityDescription);
+    virtual bool readFromBinaryFile(const QString& fileName);
+
+    // journal entries hold the whole state of an added or edited entity, so replaying them more than once is harmless
+    virtual bool startJournal();
+    virtual void takeJournalEntries(QVariantList& entries);
+    virtual bool readJournalEntry(const QVariantMap& entry);
+
     float getContentsLargestDimension();
 
     virtual void resetEditStats() {
@@ -228,6 +303,10 @@ public:
 
     EntityTreePointer getThisPointer() { return std::static_pointer_cast<EntityTree>(shared_from_this()); }
 
+    /// share encoded entities between the viewers of this tree, only worth it in server trees
+    void enableEncodeCache();
+    EntityEncodeCache* getEncodeCache() const { return _encodeCache.get(); }
+
 signals:
     void deletingEntity(const EntityItemID& entityID);
     void addingEntity(const EntityItemID& entityID);
@@ -235,31 +314,71 @@ signals:
     void newCollisionSoundURL(const QUrl& url);
     void clearingEntities();
 
+protected:
+    virtual int predecodeElementData(const unsigned char* data, int bytesLeftToRead, bool isRootElement,
+                                     ReadBitstreamToTreeParams& args, PredecodedBitstreamPointer& predecoded) const;
+
 private:
 
-    void processRemovedEntities(const DeleteEntityOperator& theOperator);
+    /// \param eraseOnViewers false for entities that another server has now, which the viewers must keep
+    void processRemovedEntities(const DeleteEntityOperator& theOperator, bool eraseOnViewers = true);
     bool updateEntityWithElement(EntityItemPointer entity, const EntityItemProperties& properties,
                                  EntityTreeElementPointer containingElement,
                                  const SharedNodePointer& senderNode = SharedNodePointer(nullptr));
-    static bool findNearPointOperation(OctreeElementPointer element, void* extraData);
-    static bool findInSphereOperation(OctreeElementPointer element, void* extraData);
-    static bool findInCubeOperation(OctreeElementPointer element, void* extraData);
-    static bool findInBoxOperation(OctreeElementPointer element, void* extraData);
-    static bool sendEntitiesOperation(OctreeElementPointer element, void* extraData);
+    static bool findNearPointOperation(const OctreeElementPointer& element, void* extraData);
+    static bool findInSphereOperation(const OctreeElementPointer& element, void* extraData);
+    static bool findInCubeOperation(const OctreeElementPointer& element, void* extraData);
+    static bool findInBoxOperation(const OctreeElementPointer& element, void* extraData);
+    static bool sendEntitiesOperation(const OctreeElementPointer& element, void* extraData);
+    static bool handOffEntitiesOperation(const OctreeElementPointer& element, void* extraData);
+
+    void applyEditPacketData(PacketType packetType, const EntityItemID& entityItemID, EntityItemProperties& properties,
+                             const SharedNodePointer& senderNode);
 
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
+    EntityItemPointer addEntityFromMap(QVariantMap& entityMap, QScriptEngine& scriptEngine);
+
+    void flushPendingAdds();
+
+    void journalEntityChanged(const EntityItemID& entityID);
+    void journalEntityDeleted(const EntityItemID& entityID);
+
     QReadWriteLock _newlyCreatedHooksLock;
     QVector<NewlyCreatedEntityHook*> _newlyCreatedHooks;
 
+    struct DeletedEntity {
+        quint64 deletedAt;
+        QUuid entityID;
+    };
+
     mutable QReadWriteLock _recentlyDeletedEntitiesLock;
-    QMultiMap<quint64, QUuid> _recentlyDeletedEntityItemIDs;
+    std::deque<DeletedEntity> _recentlyDeletedEntities; // in the order of their times, forgotten from the front
+    quint64 _deletedEntitiesForgottenBefore { usecTimestampNow() }; // the deletions before this are not known
     EntityItemFBXService* _fbxService;
 
     QHash<EntityItemID, EntityTreeElementPointer> _entityToElementMap;
 
+    // kept in sync with _entityToElementMap
+    EntitySpatialHash _spatialHash;
+    bool _useSpatialHash = true;
+
     EntitySimulation* _simulation;
 
+    std::unique_ptr<EntityEncodeCache> _encodeCache;
+
+    // while an edit batch is started, adds are placed in the tree together when they're next looked up or when the
+    // batch finishes, and the elements of in place updates have their paths marked at the end
+    bool _editBatchStarted = false;
+    QVector<EntityItemPointer> _pendingAdds;
+    QSet<EntityItemID> _pendingAddIDs;
+    QVector<EntityTreeElementPointer> _pendingChangedElements;
+
+    // changes not yet taken by takeJournalEntries(), guarded by the tree lock
+    bool _journalStarted = false;
+    QSet<EntityItemID> _journalChangedEntities;
+    QSet<EntityItemID> _journalDeletedEntities;
+
     bool _wantEditLogging = false;
     bool _wantTerseEditLogging = false;
     void maybeNotifyNewCollisionSoundURL(const QString& oldCollisionSoundURL, const QString& newCollisionSoundURL);
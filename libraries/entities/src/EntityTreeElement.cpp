@@ -13,8 +13,10 @@
 
 #include <FBXReader.h>
 #include <GeometryUtil.h>
+#include <OctreeElementPool.h>
 
 #include "EntitiesLogging.h"
+#include "EntityEncodeCache.h"
 #include "EntityItemProperties.h"
 #include "EntityTree.h"
 #include "EntityTreeElement.h"
@@ -28,6 +30,20 @@ EntityTreeElement::~EntityTreeElement() {
     _octreeMemoryUsage -= sizeof(EntityTreeElement);
 }
 
+// a function static, so the pool outlives the trees that static objects may still hold at exit
+static OctreeElementPool& getElementPool() {
+    static OctreeElementPool* pool = new OctreeElementPool(sizeof(EntityTreeElement));
+    return *pool;
+}
+
+void* EntityTreeElement::operator new(size_t size) {
+    return getElementPool().allocate(size);
+}
+
+void EntityTreeElement::operator delete(void* block, size_t size) {
+    getElementPool().release(block, size);
+}
+
 // This will be called primarily on addChildAt(), which means we're adding a child of our
 // own type to our own tree. This means we should initialize that child with any tree and type
 // specific settings that our children must have.
@@ -340,11 +356,34 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
         bool successAppendEntityCount = packetData->appendValue(numberOfEntities);
 
         if (successAppendEntityCount) {
+            EntityEncodeCache* encodeCache = _myTree ? _myTree->getEncodeCache() : nullptr;
+
             foreach(uint16_t i, indexesOfEntitiesToInclude) {
                 EntityItemPointer entity = _entityItems[i];
                 LevelDetails entityLevel = packetData->startLevel();
-                OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData,
-                    params, entityTreeElementExtraEncodeData);
+                OctreeElement::AppendState appendEntityState;
+
+                // only complete encodes of an entity can be shared, not the left overs of a partial one
+                bool wantsAllProperties = encodeCache &&
+                    entityTreeElementExtraEncodeData->entities.value(entity->getEntityItemID()) ==
+                    entity->getEntityProperties(params);
+
+                QByteArray encodedEntity;
+                if (wantsAllProperties && encodeCache->findEncodedEntity(this, entity, encodedEntity)) {
+                    appendEntityState = packetData->appendRawData(encodedEntity) ?
+                        OctreeElement::COMPLETED : OctreeElement::NONE;
+                } else {
+                    int entityOffset = packetData->getUncompressedByteOffset();
+
+                    appendEntityState = entity->appendEntityData(packetData, params, entityTreeElementExtraEncodeData);
+
+                    if (wantsAllProperties && appendEntityState == OctreeElement::COMPLETED) {
+                        int entityBytes = packetData->getUncompressedByteOffset() - entityOffset;
+                        encodedEntity = QByteArray(reinterpret_cast<const char*>(packetData->getUncompressedData(entityOffset)),
+                                                   entityBytes);
+                        encodeCache->insertEncodedEntity(this, entity, encodedEntity);
+                    }
+                }
 
                 // If none of this entity data was able to be appended, then discard it
                 // and don't include it in our entity count
@@ -535,75 +574,117 @@ bool EntityTreeElement::findRayIntersection(const glm::vec3& origin, const glm::
     return false;
 }
 
+// whether the ray hits the entity closer than the distance, which it then moves up to the hit
+static bool findEntityRayIntersection(const EntityItemPointer& entity, const glm::vec3& origin, const glm::vec3& direction,
+                                      bool& keepSearching, OctreeElementPointer& element, float& distance, BoxFace& face,
+                                      glm::vec3& surfaceNormal, void** intersectedObject, bool precisionPicking) {
+    AABox entityBox = entity->getAABox();
+    float localDistance;
+    BoxFace localFace;
+    glm::vec3 localSurfaceNormal;
+
+    // if the ray doesn't intersect with our cube, we can stop searching!
+    if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
+        return false;
+    }
+
+    // extents is the entity relative, scaled, centered extents of the entity
+    glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
+    glm::mat4 translation = glm::translate(entity->getPosition());
+    glm::mat4 entityToWorldMatrix = translation * rotation;
+    glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+
+    glm::vec3 dimensions = entity->getDimensions();
+    glm::vec3 registrationPoint = entity->getRegistrationPoint();
+    glm::vec3 corner = -(dimensions * registrationPoint);
+
+    AABox entityFrameBox(corner, dimensions);
+
+    glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
+    glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
+
+    // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
+    // and testing intersection there.
+    if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance,
+                                            localFace, localSurfaceNormal)) {
+        if (localDistance < distance) {
+            // now ask the entity if we actually intersect
+            if (entity->supportsDetailedRayIntersection()) {
+                if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
+                    localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
+
+                    if (localDistance < distance) {
+                        distance = localDistance;
+                        face = localFace;
+                        surfaceNormal = localSurfaceNormal;
+                        return true;
+                    }
+                }
+            } else {
+                // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
+                // Never intersect with particle effect entities
+                if (localDistance < distance && EntityTypes::getEntityTypeName(entity->getType()) != "ParticleEffect") {
+                    distance = localDistance;
+                    face = localFace;
+                    surfaceNormal = localSurfaceNormal;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
 bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, const glm::vec3& direction, bool& keepSearching,
                                     OctreeElementPointer& element, float& distance, BoxFace& face, glm::vec3& surfaceNormal,
                                     const QVector<EntityItemID>& entityIdsToInclude, void** intersectedObject, bool precisionPicking, float distanceToElementCube) {
 
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
-    int entityNumber = 0;
     bool somethingIntersected = false;
     forEachEntity([&](EntityItemPointer entity) {
         if (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID())) {
             return;
         }
 
-        AABox entityBox = entity->getAABox();
-        float localDistance;
-        BoxFace localFace;
-        glm::vec3 localSurfaceNormal;
+        if (findEntityRayIntersection(entity, origin, direction, keepSearching, element, distance, face, surfaceNormal,
+                                      intersectedObject, precisionPicking)) {
+            *intersectedObject = (void*)entity.get();
+            somethingIntersected = true;
+        }
+    });
+    return somethingIntersected;
+}
+
+bool EntityTreeElement::findRayPickIntersection(EntityRayPick& pick, bool& keepSearching) {
+    keepSearching = true;
+
+    float distanceToElementCube = std::numeric_limits<float>::max();
+    BoxFace localFace;
+    glm::vec3 localSurfaceNormal;
+    if (!_cube.findRayIntersection(pick.origin, pick.direction, distanceToElementCube, localFace, localSurfaceNormal)) {
+        keepSearching = false;
+        return false;
+    }
 
-        // if the ray doesn't intersect with our cube, we can stop searching!
-        if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
+    // nothing in the cube can be closer than what the pick has already hit
+    if (!canRayIntersect() || (!_cube.contains(pick.origin) && distanceToElementCube >= pick.distance)) {
+        return false;
+    }
+
+    OctreeElementPointer element;
+    void* intersectedObject = nullptr;
+    bool somethingIntersected = false;
+    forEachEntity([&](EntityItemPointer entity) {
+        if (!pick.filter.passes(*entity)) {
             return;
         }
 
-        // extents is the entity relative, scaled, centered extents of the entity
-        glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
-        glm::mat4 translation = glm::translate(entity->getPosition());
-        glm::mat4 entityToWorldMatrix = translation * rotation;
-        glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
-
-        glm::vec3 dimensions = entity->getDimensions();
-        glm::vec3 registrationPoint = entity->getRegistrationPoint();
-        glm::vec3 corner = -(dimensions * registrationPoint);
-
-        AABox entityFrameBox(corner, dimensions);
-
-        glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
-        glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
-
-        // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
-        // and testing intersection there.
-        if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance, 
-                                                localFace, localSurfaceNormal)) {
-            if (localDistance < distance) {
-                // now ask the entity if we actually intersect
-                if (entity->supportsDetailedRayIntersection()) {
-                    if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
-                        localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
-
-                        if (localDistance < distance) {
-                            distance = localDistance;
-                            face = localFace;
-                            surfaceNormal = localSurfaceNormal;
-                            *intersectedObject = (void*)entity.get();
-                            somethingIntersected = true;
-                        }
-                    }
-                } else {
-                    // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
-                    // Never intersect with particle effect entities
-                    if (localDistance < distance && EntityTypes::getEntityTypeName(entity->getType()) != "ParticleEffect") {
-                        distance = localDistance;
-                        face = localFace;
-                        surfaceNormal = localSurfaceNormal;
-                        *intersectedObject = (void*)entity.get();
-                        somethingIntersected = true;
-                    }
-                }
-            }
+        if (findEntityRayIntersection(entity, pick.origin, pick.direction, keepSearching, element, pick.distance,
+                                      pick.face, pick.surfaceNormal, &intersectedObject, pick.filter.precisionPicking)) {
+            pick.entity = entity;
+            pick.intersects = true;
+            somethingIntersected = true;
         }
-        entityNumber++;
     });
     return somethingIntersected;
 }
@@ -891,9 +972,21 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
                     }
 
                 } else {
-                    entityItem = EntityTypes::constructEntityItem(dataAt, bytesLeftToRead, args);
+                    // use the item read ahead of the tree if there is one, it was read the same way
+                    auto predecoded = static_cast<PredecodedEntities*>(args.predecoded.get());
+                    PredecodedEntities::Entity predecodedEntity = predecoded ? predecoded->entities.take(dataAt) :
+                        PredecodedEntities::Entity();
+                    if (predecodedEntity.entity) {
+                        entityItem = predecodedEntity.entity;
+                        bytesForThisEntity = predecodedEntity.bytes;
+                        args.entitiesPerPacket++;
+                    } else {
+                        entityItem = EntityTypes::constructEntityItem(dataAt, bytesLeftToRead, args);
+                        if (entityItem) {
+                            bytesForThisEntity = entityItem->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
+                        }
+                    }
                     if (entityItem) {
-                        bytesForThisEntity = entityItem->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
                         addEntityItem(entityItem); // add this new entity to this elements entities
                         entityItemID = entityItem->getEntityItemID();
                         _myTree->setContainingElement(entityItemID, getThisPointer());
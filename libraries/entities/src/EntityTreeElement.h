@@ -19,6 +19,7 @@
 
 #include "EntityEditPacketSender.h"
 #include "EntityItem.h"
+#include "EntityRayPick.h"
 #include "EntityTree.h"
 
 typedef QVector<EntityItemPointer> EntityItems;
@@ -85,6 +86,10 @@ class EntityTreeElement : public OctreeElement, ReadWriteLockable {
 public:
     virtual ~EntityTreeElement();
 
+    // the elements come out of a pool, see OctreeElementPool
+    static void* operator new(size_t size);
+    static void operator delete(void* block, size_t size);
+
     // type safe versions of OctreeElement methods
     EntityTreeElementPointer getChildAtIndex(int index) const {
         return std::static_pointer_cast<EntityTreeElement>(OctreeElement::getChildAtIndex(index));
@@ -150,6 +155,8 @@ public:
                          bool& keepSearching, OctreeElementPointer& element, float& distance, 
                          BoxFace& face, glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
                          void** intersectedObject, bool precisionPicking, float distanceToElementCube);
+    // tests the pick against the entities of this element the way findRayIntersection does, along with its filter
+    bool findRayPickIntersection(EntityRayPick& pick, bool& keepSearching);
     virtual bool findSpherePenetration(const glm::vec3& center, float radius,
                         glm::vec3& penetration, void** penetratedObject) const;
 
@@ -10,6 +10,10 @@
 //
 
 #include "EntityTreeHeadlessViewer.h"
+
+#include <NodeList.h>
+
+#include "EntitiesLogging.h"
 #include "SimpleEntitySimulation.h"
 
 EntityTreeHeadlessViewer::EntityTreeHeadlessViewer()
@@ -28,6 +32,10 @@ void EntityTreeHeadlessViewer::init() {
         entityTree->setSimulation(simpleSimulation);
         _simulation = simpleSimulation;
     }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->getPacketReceiver().registerMessageListener(PacketType::EntityFindReply, this, "handleEntityFindReply");
+    connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &EntityTreeHeadlessViewer::handleNodeKilled);
 }
 
 void EntityTreeHeadlessViewer::update() {
@@ -42,3 +50,102 @@ void EntityTreeHeadlessViewer::update() {
 void EntityTreeHeadlessViewer::processEraseMessage(NLPacket& packet, const SharedNodePointer& sourceNode) {
     std::static_pointer_cast<EntityTree>(_tree)->processEraseMessage(packet, sourceNode);
 }
+
+quint32 EntityTreeHeadlessViewer::findEntitiesOnServers(const glm::vec3& center, float radius,
+                                                       const QString& type, const QString& name) {
+    EntityFindQuery query;
+    query.shape = EntityFindQuery::Sphere;
+    query.position = center;
+    query.radius = radius;
+    query.name = name;
+    return findEntitiesOnServers(query, type);
+}
+
+quint32 EntityTreeHeadlessViewer::findEntitiesInBoxOnServers(const glm::vec3& corner, const glm::vec3& dimensions,
+                                                            const QString& type, const QString& name) {
+    EntityFindQuery query;
+    query.shape = EntityFindQuery::Box;
+    query.position = corner;
+    query.dimensions = dimensions;
+    query.name = name;
+    return findEntitiesOnServers(query, type);
+}
+
+quint32 EntityTreeHeadlessViewer::findEntitiesOnServers(EntityFindQuery& query, const QString& type) {
+    if (!type.isEmpty()) {
+        query.type = EntityTypes::getEntityTypeFromName(type);
+        if (query.type == EntityTypes::Unknown) {
+            qCDebug(entities) << "Not searching the entity servers for entities of unknown type" << type;
+            return 0;
+        }
+    }
+
+    query.requestID = ++_lastFindRequestID;
+    if (query.requestID == 0) {
+        query.requestID = ++_lastFindRequestID;
+    }
+
+    QByteArray payload;
+    QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+    payloadStream << query;
+
+    // with jurisdictions the tree is split between the servers, each finds what it has
+    PendingFind pendingFind;
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->eachNode([&](const SharedNodePointer& node) {
+        if (node->getType() == NodeType::EntityServer && node->getActiveSocket()) {
+            auto packet = NLPacket::create(PacketType::EntityFind, payload.size(), true);
+            packet->write(payload);
+            nodeList->sendPacket(std::move(packet), *node);
+            pendingFind.servers.insert(node->getUUID());
+        }
+    });
+
+    if (pendingFind.servers.isEmpty()) {
+        return 0;
+    }
+    _pendingFinds.insert(query.requestID, pendingFind);
+    return query.requestID;
+}
+
+void EntityTreeHeadlessViewer::handleEntityFindReply(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode) {
+    QDataStream replyStream(packetList->getMessage());
+    quint32 requestID;
+    QVector<EntityFindResult> results;
+    replyStream >> requestID >> results;
+    if (replyStream.status() != QDataStream::Ok) {
+        qCDebug(entities) << "Dropping an EntityFindReply from" << senderNode->getUUID() << "that could not be read";
+        return;
+    }
+
+    auto it = _pendingFinds.find(requestID);
+    if (it == _pendingFinds.end() || !it->servers.remove(senderNode->getUUID())) {
+        return;
+    }
+    foreach (const EntityFindResult& result, results) {
+        it->entities << result.toVariantMap();
+    }
+    finishFindIfAnswered(requestID);
+}
+
+void EntityTreeHeadlessViewer::handleNodeKilled(SharedNodePointer node) {
+    if (node->getType() != NodeType::EntityServer) {
+        return;
+    }
+
+    // the searches it had not answered get what the other servers found
+    foreach (quint32 requestID, _pendingFinds.keys()) {
+        if (_pendingFinds[requestID].servers.remove(node->getUUID())) {
+            finishFindIfAnswered(requestID);
+        }
+    }
+}
+
+void EntityTreeHeadlessViewer::finishFindIfAnswered(quint32 requestID) {
+    auto it = _pendingFinds.find(requestID);
+    if (it != _pendingFinds.end() && it->servers.isEmpty()) {
+        QVariantList entities = it->entities;
+        _pendingFinds.erase(it);
+        emit entitiesFound(requestID, entities);
+    }
+}
@@ -12,13 +12,19 @@
 #ifndef hifi_EntityTreeHeadlessViewer_h
 #define hifi_EntityTreeHeadlessViewer_h
 
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+
 #include <udt/PacketHeaders.h>
+#include <NLPacketList.h>
+#include <Node.h>
 #include <SharedUtil.h>
 #include <Octree.h>
 #include <OctreePacketData.h>
 #include <OctreeHeadlessViewer.h>
 #include <ViewFrustum.h>
 
+#include "EntityFindQuery.h"
 #include "EntityTree.h"
 
 class EntitySimulation;
@@ -42,6 +48,22 @@ public:
 
     virtual void init();
 
+public slots:
+    // searches the tree on the entity servers, for the scripts that would rather not keep a copy of it. The entities
+    // of the type and name given, or of any if they are empty, come back with entitiesFound under the returned ID. No
+    // search is made and 0 is returned when there is no entity server to ask.
+    quint32 findEntitiesOnServers(const glm::vec3& center, float radius,
+                                  const QString& type = QString(), const QString& name = QString());
+    quint32 findEntitiesInBoxOnServers(const glm::vec3& corner, const glm::vec3& dimensions,
+                                       const QString& type = QString(), const QString& name = QString());
+
+signals:
+    void entitiesFound(quint32 requestID, const QVariantList& entities);
+
+private slots:
+    void handleEntityFindReply(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode);
+    void handleNodeKilled(SharedNodePointer node);
+
 protected:
     virtual OctreePointer createTree() {
         EntityTreePointer newTree = EntityTreePointer(new EntityTree(true));
@@ -50,6 +72,19 @@ protected:
     }
 
     EntitySimulation* _simulation;
+
+private:
+    quint32 findEntitiesOnServers(EntityFindQuery& query, const QString& type);
+    void finishFindIfAnswered(quint32 requestID);
+
+    // a search the servers have not all answered yet
+    struct PendingFind {
+        QSet<QUuid> servers;
+        QVariantList entities;
+    };
+
+    quint32 _lastFindRequestID { 0 };
+    QHash<quint32, PendingFind> _pendingFinds;
 };
 
 #endif // hifi_EntityTreeHeadlessViewer_h
@@ -0,0 +1,103 @@
+//
+//  KinematicBatch.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "KinematicBatch.h"
+
+void KinematicBatch::clear() {
+    // keep the allocations for the next frame
+    _positionX.clear();
+    _positionY.clear();
+    _positionZ.clear();
+    _velocityX.clear();
+    _velocityY.clear();
+    _velocityZ.clear();
+    _accelerationX.clear();
+    _accelerationY.clear();
+    _accelerationZ.clear();
+    _dampingFactor.clear();
+    _timeElapsed.clear();
+}
+
+int KinematicBatch::add(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& acceleration,
+                        float dampingFactor, float timeElapsed) {
+    _positionX.push_back(position.x);
+    _positionY.push_back(position.y);
+    _positionZ.push_back(position.z);
+    _velocityX.push_back(velocity.x);
+    _velocityY.push_back(velocity.y);
+    _velocityZ.push_back(velocity.z);
+    _accelerationX.push_back(acceleration.x);
+    _accelerationY.push_back(acceleration.y);
+    _accelerationZ.push_back(acceleration.z);
+    _dampingFactor.push_back(dampingFactor);
+    _timeElapsed.push_back(timeElapsed);
+    return size() - 1;
+}
+
+float KinematicBatch::getSpeed(int index) const {
+    return glm::length(getVelocity(index));
+}
+
+static inline void integrateOne(float& position, float& velocity, float acceleration, float dampingFactor,
+                                float timeElapsed) {
+    velocity *= dampingFactor;
+    position += velocity * timeElapsed;
+    velocity += acceleration * timeElapsed;
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+static inline void integrateFour(float* position, float* velocity, const float* acceleration,
+                                 __m128 dampingFactor, __m128 timeElapsed) {
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(velocity), dampingFactor);
+    __m128 p = _mm_add_ps(_mm_loadu_ps(position), _mm_mul_ps(v, timeElapsed));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(acceleration), timeElapsed));
+
+    _mm_storeu_ps(position, p);
+    _mm_storeu_ps(velocity, v);
+}
+
+void KinematicBatch::integrate() {
+    int numEntities = size();
+    int i = 0;
+
+    for (; i + 4 <= numEntities; i += 4) {
+        __m128 dampingFactor = _mm_loadu_ps(&_dampingFactor[i]);
+        __m128 timeElapsed = _mm_loadu_ps(&_timeElapsed[i]);
+
+        integrateFour(&_positionX[i], &_velocityX[i], &_accelerationX[i], dampingFactor, timeElapsed);
+        integrateFour(&_positionY[i], &_velocityY[i], &_accelerationY[i], dampingFactor, timeElapsed);
+        integrateFour(&_positionZ[i], &_velocityZ[i], &_accelerationZ[i], dampingFactor, timeElapsed);
+    }
+
+    for (; i < numEntities; i++) {
+        integrateOne(_positionX[i], _velocityX[i], _accelerationX[i], _dampingFactor[i], _timeElapsed[i]);
+        integrateOne(_positionY[i], _velocityY[i], _accelerationY[i], _dampingFactor[i], _timeElapsed[i]);
+        integrateOne(_positionZ[i], _velocityZ[i], _accelerationZ[i], _dampingFactor[i], _timeElapsed[i]);
+    }
+}
+
+#else
+
+void KinematicBatch::integrate() {
+    int numEntities = size();
+    for (int i = 0; i < numEntities; i++) {
+        integrateOne(_positionX[i], _velocityX[i], _accelerationX[i], _dampingFactor[i], _timeElapsed[i]);
+        integrateOne(_positionY[i], _velocityY[i], _accelerationY[i], _dampingFactor[i], _timeElapsed[i]);
+        integrateOne(_positionZ[i], _velocityZ[i], _accelerationZ[i], _dampingFactor[i], _timeElapsed[i]);
+    }
+}
+
+#endif
@@ -0,0 +1,54 @@
+//
+//  KinematicBatch.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_KinematicBatch_h
+#define hifi_KinematicBatch_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// The linear motion of many entities moving without physics, packed one component after the other so that it can be
+// integrated several entities at a time. Each step is the one EntityItem::simulateKinematicMotion() takes:
+//     velocity *= dampingFactor
+//     position += velocity * timeElapsed
+//     velocity += acceleration * timeElapsed
+class KinematicBatch {
+public:
+    void clear();
+
+    /// \param dampingFactor the velocity is scaled by this, pow(1 - damping, timeElapsed)
+    /// \return the index of the entity's state in the batch
+    int add(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& acceleration,
+            float dampingFactor, float timeElapsed);
+
+    void integrate();
+
+    int size() const { return (int)_timeElapsed.size(); }
+
+    glm::vec3 getPosition(int index) const { return glm::vec3(_positionX[index], _positionY[index], _positionZ[index]); }
+    glm::vec3 getVelocity(int index) const { return glm::vec3(_velocityX[index], _velocityY[index], _velocityZ[index]); }
+    float getSpeed(int index) const;
+
+private:
+    std::vector<float> _positionX;
+    std::vector<float> _positionY;
+    std::vector<float> _positionZ;
+    std::vector<float> _velocityX;
+    std::vector<float> _velocityY;
+    std::vector<float> _velocityZ;
+    std::vector<float> _accelerationX;
+    std::vector<float> _accelerationY;
+    std::vector<float> _accelerationZ;
+    std::vector<float> _dampingFactor;
+    std::vector<float> _timeElapsed;
+};
+
+#endif // hifi_KinematicBatch_h
@@ -0,0 +1,66 @@
+//
+//  MarkChangedElementsOperator.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTree.h"
+#include "EntityTreeElement.h"
+
+#include "MarkChangedElementsOperator.h"
+
+MarkChangedElementsOperator::MarkChangedElementsOperator(const QVector<EntityTreeElementPointer>& changedElements) {
+    _changedCubes.reserve(changedElements.size());
+    foreach (const EntityTreeElementPointer& element, changedElements) {
+        _changedCubes << element->getAACube();
+    }
+}
+
+bool MarkChangedElementsOperator::preRecursion(const OctreeElementPointer& element) {
+    const AACube& elementCube = element->getAACube();
+
+    bool onPath = false;
+    QVector<int> below;
+
+    auto checkCube = [&](int index) {
+        const AACube& changedCube = _changedCubes[index];
+        if (elementCube.contains(changedCube)) {
+            onPath = true;
+            if (!(elementCube == changedCube)) {
+                below << index;
+            }
+        }
+    };
+
+    if (_path.isEmpty()) {
+        for (int i = 0; i < _changedCubes.size(); i++) {
+            checkCube(i);
+        }
+    } else {
+        foreach (int index, _path.last()) {
+            checkCube(index);
+        }
+    }
+
+    if (onPath) {
+        element->markWithChangedTime();
+    }
+
+    // postRecursion() is called for this element whatever we return
+    _path << below;
+    return !below.isEmpty();
+}
+
+bool MarkChangedElementsOperator::postRecursion(const OctreeElementPointer& element) {
+    _path.removeLast();
+
+    // nothing was removed from the changed elements, so any of them can be pruned
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+    entityTreeElement->pruneChildren(); // take this opportunity to prune any empty leaves
+
+    return true;
+}
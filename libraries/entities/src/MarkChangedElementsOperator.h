@@ -0,0 +1,32 @@
+//
+//  MarkChangedElementsOperator.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MarkChangedElementsOperator_h
+#define hifi_MarkChangedElementsOperator_h
+
+#include <QVector>
+
+// Finishes a batch of updates applied in place by UpdateEntityOperator::applyInPlace(), marking the paths from the
+// root to all of their elements as changed in one pass, and pruning along them like UpdateEntityOperator does.
+class MarkChangedElementsOperator : public RecurseOctreeOperator {
+public:
+    MarkChangedElementsOperator(const QVector<EntityTreeElementPointer>& changedElements);
+
+    virtual bool preRecursion(const OctreeElementPointer& element);
+    virtual bool postRecursion(const OctreeElementPointer& element);
+
+private:
+    QVector<AACube> _changedCubes;
+
+    // the changed elements that are below an element of the current path
+    QVector<QVector<int>> _path;
+};
+
+#endif // hifi_MarkChangedElementsOperator_h
@@ -11,6 +11,7 @@
 
 #include <QtCore/QJsonDocument>
 
+#include <AssetUtils.h>
 #include <ByteCountCoding.h>
 #include <GLMHelpers.h>
 
@@ -307,12 +308,29 @@ void ModelEntityItem::updateShapeType(ShapeType type) {
 // virtual
 ShapeType ModelEntityItem::getShapeType() const {
     if (_shapeType == SHAPE_TYPE_COMPOUND) {
-        return hasCompoundShapeURL() ? SHAPE_TYPE_COMPOUND : SHAPE_TYPE_NONE;
+        return !getCollisionShapeURL().isEmpty() ? SHAPE_TYPE_COMPOUND : SHAPE_TYPE_NONE;
     } else {
         return _shapeType;
     }
 }
 
+QString ModelEntityItem::getCollisionShapeURL() const {
+    if (hasCompoundShapeURL() || _shapeType != SHAPE_TYPE_COMPOUND) {
+        return _compoundShapeURL;
+    }
+    return getATPHullUrl(QUrl(_modelURL)).toString();
+}
+
+void ModelEntityItem::setModelURL(const QString& url) {
+    if (_modelURL != url) {
+        _modelURL = url;
+        if (_shapeType == SHAPE_TYPE_COMPOUND && !hasCompoundShapeURL()) {
+            // the hulls of the model go with it
+            _dirtyFlags |= Simulation::DIRTY_SHAPE | Simulation::DIRTY_MASS;
+        }
+    }
+}
+
 void ModelEntityItem::setCompoundShapeURL(const QString& url) {
     if (_compoundShapeURL != url) {
         _compoundShapeURL = url;
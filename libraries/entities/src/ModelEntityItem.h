@@ -67,6 +67,9 @@ public:
     static const QString DEFAULT_COMPOUND_SHAPE_URL;
     const QString& getCompoundShapeURL() const { return _compoundShapeURL; }
 
+    // the compound shape, or for a compound shape type without one, the hulls the asset-server made of the model
+    QString getCollisionShapeURL() const;
+
     void setColor(const rgbColor& value) { memcpy(_color, value, sizeof(_color)); }
     void setColor(const xColor& value) {
             _color[RED_INDEX] = value.red;
@@ -75,7 +78,7 @@ public:
     }
     
     // model related properties
-    void setModelURL(const QString& url) { _modelURL = url; }
+    void setModelURL(const QString& url);
     virtual void setCompoundShapeURL(const QString& url);
 
 
@@ -10,7 +10,11 @@
 //
 
 
+#include <algorithm>
+#include <string.h>
+
 #include <QByteArray>
+#include <QDataStream>
 #include <QDebug>
 #include <QWriteLocker>
 
@@ -37,8 +41,11 @@ EntityItemPointer PolyVoxEntityItem::factory(const EntityItemID& entityID, const
 
 QByteArray PolyVoxEntityItem::makeEmptyVoxelData(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize) {
     int rawSize = voxelXSize * voxelYSize * voxelZSize;
+    return packVoxelData(voxelXSize, voxelYSize, voxelZSize, QByteArray(rawSize, '\0'));
+}
 
-    QByteArray uncompressedData = QByteArray(rawSize, '\0');
+QByteArray PolyVoxEntityItem::packVoxelData(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize,
+                                            const QByteArray& uncompressedData) {
     QByteArray newVoxelData;
     QDataStream writer(&newVoxelData, QIODevice::WriteOnly | QIODevice::Truncate);
     writer << voxelXSize << voxelYSize << voxelZSize;
@@ -49,6 +56,117 @@ QByteArray PolyVoxEntityItem::makeEmptyVoxelData(quint16 voxelXSize, quint16 vox
     return newVoxelData;
 }
 
+bool PolyVoxEntityItem::unpackVoxelData(const QByteArray& voxelData, quint16& voxelXSize, quint16& voxelYSize,
+                                        quint16& voxelZSize, QByteArray& uncompressedData) {
+    QDataStream reader(voxelData);
+    QByteArray compressedData;
+    reader >> voxelXSize >> voxelYSize >> voxelZSize >> compressedData;
+    if (reader.status() != QDataStream::Ok || voxelXSize == 0 || voxelYSize == 0 || voxelZSize == 0) {
+        return false;
+    }
+    uncompressedData = qUncompress(compressedData);
+    return uncompressedData.size() == voxelXSize * voxelYSize * voxelZSize;
+}
+
+static void appendVarInt(QByteArray& output, quint32 value) {
+    while (value >= 0x80) {
+        output.append((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    output.append((char)value);
+}
+
+static bool readVarInt(const uchar*& current, const uchar* end, quint32& value) {
+    value = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        if (current == end) {
+            return false;
+        }
+        uchar byte = *current++;
+        value |= (quint32)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QByteArray PolyVoxEntityItem::makeVoxelDataEdits(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize,
+                                                 const QByteArray& fromUncompressedData,
+                                                 const QByteArray& toUncompressedData) {
+    // each run is the number of voxels skipped since the last one, then how many voxels it sets and their value
+    QByteArray runs;
+    const int size = std::min(fromUncompressedData.size(), toUncompressedData.size());
+    const char* from = fromUncompressedData.constData();
+    const char* to = toUncompressedData.constData();
+    int runEnd = 0;
+    for (int i = 0; i < size;) {
+        if (from[i] == to[i]) {
+            i++;
+            continue;
+        }
+        int runStart = i;
+        char value = to[i];
+        while (i < size && from[i] != to[i] && to[i] == value) {
+            i++;
+        }
+        appendVarInt(runs, runStart - runEnd);
+        appendVarInt(runs, i - runStart);
+        runs.append(value);
+        runEnd = i;
+    }
+
+    QByteArray edits;
+    QDataStream writer(&edits, QIODevice::WriteOnly | QIODevice::Truncate);
+    writer << (quint16)0 << voxelXSize << voxelYSize << voxelZSize;
+    writer << qCompress(runs, 9);
+    return edits;
+}
+
+bool PolyVoxEntityItem::isVoxelDataEdits(const QByteArray& voxelData) {
+    QDataStream reader(voxelData);
+    quint16 voxelXSize;
+    reader >> voxelXSize;
+    return reader.status() == QDataStream::Ok && voxelXSize == 0;
+}
+
+bool PolyVoxEntityItem::applyVoxelDataEdits(QByteArray& voxelData, const QByteArray& edits) {
+    QDataStream reader(edits);
+    quint16 marker, editXSize, editYSize, editZSize;
+    QByteArray compressedRuns;
+    reader >> marker >> editXSize >> editYSize >> editZSize >> compressedRuns;
+    if (reader.status() != QDataStream::Ok || marker != 0) {
+        return false;
+    }
+
+    quint16 voxelXSize, voxelYSize, voxelZSize;
+    QByteArray uncompressedData;
+    if (!unpackVoxelData(voxelData, voxelXSize, voxelYSize, voxelZSize, uncompressedData) ||
+        voxelXSize != editXSize || voxelYSize != editYSize || voxelZSize != editZSize) {
+        return false;
+    }
+
+    QByteArray runs = qUncompress(compressedRuns);
+    const uchar* current = reinterpret_cast<const uchar*>(runs.constData());
+    const uchar* end = current + runs.size();
+    quint32 position = 0;
+    const quint32 size = (quint32)uncompressedData.size();
+    char* data = uncompressedData.data();
+    while (current < end) {
+        quint32 skipped, count;
+        if (!readVarInt(current, end, skipped) || !readVarInt(current, end, count) || current == end ||
+            skipped > size - position || count > size - position - skipped) {
+            return false;
+        }
+        position += skipped;
+        memset(data + position, *current++, count);
+        position += count;
+    }
+
+    voxelData = packVoxelData(voxelXSize, voxelYSize, voxelZSize, uncompressedData);
+    return true;
+}
+
 PolyVoxEntityItem::PolyVoxEntityItem(const EntityItemID& entityItemID, const EntityItemProperties& properties) :
     EntityItem(entityItemID),
     _voxelVolumeSize(PolyVoxEntityItem::DEFAULT_VOXEL_VOLUME_SIZE),
@@ -225,8 +343,15 @@ void PolyVoxEntityItem::debugDump() const {
 }
 
 void PolyVoxEntityItem::setVoxelData(QByteArray voxelData) {
-    QWriteLocker(&this->_voxelDataLock);
-    _voxelData = voxelData;
+    QWriteLocker locker(&_voxelDataLock);
+    if (isVoxelDataEdits(voxelData)) {
+        if (!applyVoxelDataEdits(_voxelData, voxelData)) {
+            qCDebug(entities) << "PolyVox edits don't apply to the volume, ignoring them" << getName() << getID();
+            return;
+        }
+    } else {
+        _voxelData = voxelData;
+    }
     _voxelDataDirty = true;
 }
 
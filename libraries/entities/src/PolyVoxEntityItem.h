@@ -93,6 +93,19 @@ class PolyVoxEntityItem : public EntityItem {
     virtual bool setVoxel(int x, int y, int z, uint8_t toValue) { return false; }
 
     static QByteArray makeEmptyVoxelData(quint16 voxelXSize = 16, quint16 voxelYSize = 16, quint16 voxelZSize = 16);
+    static QByteArray packVoxelData(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize,
+                                    const QByteArray& uncompressedData);
+    static bool unpackVoxelData(const QByteArray& voxelData, quint16& voxelXSize, quint16& voxelYSize, quint16& voxelZSize,
+                                QByteArray& uncompressedData);
+
+    // A voxelData with an x size of zero holds edits rather than a whole volume: the runs of voxels that changed, and
+    // what they changed to.  Edits only carry the voxels that changed, so the ones made by different users don't undo
+    // each other, and setVoxelData applies them to the volume it already has.
+    static QByteArray makeVoxelDataEdits(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize,
+                                         const QByteArray& fromUncompressedData, const QByteArray& toUncompressedData);
+    static bool isVoxelDataEdits(const QByteArray& voxelData);
+    // false if the edits aren't valid or were made for a volume of another size, voxelData is then unchanged
+    static bool applyVoxelDataEdits(QByteArray& voxelData, const QByteArray& edits);
 
     static const QString DEFAULT_X_TEXTURE_URL;
     virtual void setXTextureURL(QString xTextureURL) { _xTextureURL = xTextureURL; }
@@ -32,14 +32,14 @@ RecurseOctreeToMapOperator::RecurseOctreeToMapOperator(QVariantMap& map,
     }
 };
 
-bool RecurseOctreeToMapOperator::preRecursion(OctreeElementPointer element) {
+bool RecurseOctreeToMapOperator::preRecursion(const OctreeElementPointer& element) {
     if (element == _top) {
         _withinTop = true;
     }
     return true;
 }
 
-bool RecurseOctreeToMapOperator::postRecursion(OctreeElementPointer element) {
+bool RecurseOctreeToMapOperator::postRecursion(const OctreeElementPointer& element) {
 
     EntityItemProperties defaultProperties;
 
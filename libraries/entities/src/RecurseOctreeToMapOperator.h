@@ -14,8 +14,8 @@
 class RecurseOctreeToMapOperator : public RecurseOctreeOperator {
 public:
     RecurseOctreeToMapOperator(QVariantMap& map, OctreeElementPointer top, QScriptEngine* engine, bool skipDefaultValues);
-    bool preRecursion(OctreeElementPointer element);
-    bool postRecursion(OctreeElementPointer element);
+    bool preRecursion(const OctreeElementPointer& element);
+    bool postRecursion(const OctreeElementPointer& element);
  private:
     QVariantMap& _map;
     OctreeElementPointer _top;
@@ -11,12 +11,28 @@
 
 //#include <PerfStat.h>
 
+#include <algorithm>
+#include <tuple>
+
+#include <Metrics.h>
+
 #include "EntityItem.h"
 #include "SimpleEntitySimulation.h"
 #include "EntitiesLogging.h"
 
 const quint64 AUTO_REMOVE_SIMULATION_OWNER_USEC = 2 * USECS_PER_SECOND;
 
+// how often the ownership of the objects is moved from the overloaded simulators to the ones with spare capacity,
+// and how many a simulator gives away each time so that the simulators can report their new load in between
+const quint64 REBALANCE_SIMULATION_OWNERSHIP_USEC = 2 * USECS_PER_SECOND;
+const int MAX_ENTITIES_REBALANCED_PER_SIMULATOR = 16;
+// a simulator that has not reported its load for this long is neither given objects nor has them taken away
+const quint64 SIMULATOR_LOAD_TIMEOUT_USEC = 5 * USECS_PER_SECOND;
+
+static const auto rebalancedEntitiesMetric =
+    MetricsRegistry::counter("hifi_entity_server_rebalanced_owners_total",
+                             "Entities whose simulation was moved from an overloaded simulator to one with spare capacity.");
+
 void SimpleEntitySimulation::updateEntitiesInternal(const quint64& now) {
     // If an Entity has a simulation owner and we don't get an update for some amount of time,
     // clear the owner.  This guards against an interface failing to release the Entity when it
@@ -43,6 +59,95 @@ void SimpleEntitySimulation::updateEntitiesInternal(const quint64& now) {
             ++itemItr;
         }
     }
+
+    rebalanceSimulationOwnership(now);
+}
+
+void SimpleEntitySimulation::setSimulatorLoad(const QUuid& simulatorID, const SimulatorLoad& load, bool isPreferred) {
+    QMutexLocker lock(&_mutex);
+    ReportedLoad& reported = _simulatorLoads[simulatorID];
+    reported.load = load;
+    reported.isPreferred = isPreferred;
+    reported.reportedAt = usecTimestampNow();
+}
+
+void SimpleEntitySimulation::rebalanceSimulationOwnership(const quint64& now) {
+    if (now < _nextRebalance) {
+        return;
+    }
+    _nextRebalance = now + REBALANCE_SIMULATION_OWNERSHIP_USEC;
+
+    for (auto it = _simulatorLoads.begin(); it != _simulatorLoads.end();) {
+        if (now - it->reportedAt > SIMULATOR_LOAD_TIMEOUT_USEC) {
+            it = _simulatorLoads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (_simulatorLoads.size() < 2) {
+        return;
+    }
+
+    // the objects that only have an owner because it volunteered for them can be moved, the ones a simulator is
+    // holding, pushing with its avatar or editing with a script stay with it
+    QHash<QUuid, int> numOwned;
+    QHash<QUuid, QVector<EntityItemPointer>> movable;
+    foreach (EntityItemPointer entity, _entitiesWithSimulator) {
+        QUuid simulatorID = entity->getSimulatorID();
+        auto load = _simulatorLoads.find(simulatorID);
+        if (load == _simulatorLoads.end() || !load->load.isOverloaded()) {
+            continue;
+        }
+        numOwned[simulatorID]++;
+        if (entity->getSimulationPriority() <= RECRUIT_SIMULATION_PRIORITY && !entity->hasActions() &&
+            movable[simulatorID].size() < MAX_ENTITIES_REBALANCED_PER_SIMULATOR) {
+            movable[simulatorID] << entity;
+        }
+    }
+    if (movable.isEmpty()) {
+        return;
+    }
+
+    struct Receiver {
+        QUuid id;
+        bool isPreferred;
+        float spareUsecs;
+    };
+    QVector<Receiver> receivers;
+    for (auto it = _simulatorLoads.begin(); it != _simulatorLoads.end(); ++it) {
+        if (it->load.hasSpareCapacity()) {
+            receivers.push_back({ it.key(), it->isPreferred, it->load.getHeadroom() * it->load.stepBudgetUsecs });
+        }
+    }
+
+    for (auto it = movable.begin(); it != movable.end(); ++it) {
+        const SimulatorLoad& load = _simulatorLoads[it.key()].load;
+        // what an object costs its simulator, to estimate how many more a receiver can take before it is full
+        float usecsPerEntity = (float)load.stepUsecs / (float)std::max(numOwned[it.key()], 1);
+
+        foreach (EntityItemPointer entity, it.value()) {
+            // a preferred simulator with room for the object first, then the one with the most room left
+            auto rank = [usecsPerEntity](const Receiver& receiver) {
+                return std::make_tuple(receiver.spareUsecs >= usecsPerEntity, receiver.isPreferred, receiver.spareUsecs);
+            };
+            auto receiver = std::max_element(receivers.begin(), receivers.end(), [&](const Receiver& a, const Receiver& b) {
+                return rank(a) < rank(b);
+            });
+            if (receiver == receivers.end() || receiver->spareUsecs < usecsPerEntity) {
+                break;
+            }
+            receiver->spareUsecs -= usecsPerEntity;
+
+            // the server decides the owner, the next update of the entity tells both simulators of the change
+            entity->setSimulationOwner(receiver->id, RECRUIT_SIMULATION_PRIORITY);
+            entity->markAsChangedOnServer();
+            EntityTreeElementPointer element = entity->getElement();
+            if (element) {
+                element->markWithChangedTime();
+            }
+            rebalancedEntitiesMetric->increment();
+        }
+    }
 }
 
 void SimpleEntitySimulation::addEntityInternal(EntityItemPointer entity) {
@@ -13,6 +13,7 @@
 #define hifi_SimpleEntitySimulation_h
 
 #include "EntitySimulation.h"
+#include "SimulatorLoad.h"
 
 /// provides simple velocity + gravity extrapolation of EntityItem's
 
@@ -21,6 +22,9 @@ public:
     SimpleEntitySimulation() : EntitySimulation() { }
     virtual ~SimpleEntitySimulation() { clearEntitiesInternal(); }
 
+    /// the last load a simulator reported, a preferred simulator is given objects before the others with spare capacity
+    void setSimulatorLoad(const QUuid& simulatorID, const SimulatorLoad& load, bool isPreferred);
+
 protected:
     virtual void updateEntitiesInternal(const quint64& now);
     virtual void addEntityInternal(EntityItemPointer entity);
@@ -29,6 +33,18 @@ protected:
     virtual void clearEntitiesInternal();
 
     SetOfEntities _entitiesWithSimulator;
+
+private:
+    struct ReportedLoad {
+        SimulatorLoad load;
+        bool isPreferred { false };
+        quint64 reportedAt { 0 };
+    };
+
+    void rebalanceSimulationOwnership(const quint64& now);
+
+    QHash<QUuid, ReportedLoad> _simulatorLoads;
+    quint64 _nextRebalance { 0 };
 };
 
 #endif // hifi_SimpleEntitySimulation_h
@@ -33,6 +33,10 @@ const quint8 SCRIPT_EDIT_SIMULATION_PRIORITY = 0x80;
 // objects that collide its MyAvatar.
 const quint8 PERSONAL_SIMULATION_PRIORITY = SCRIPT_EDIT_SIMULATION_PRIORITY - 1;
 
+// AUTHORITATIVE priority is the level at which the physics-simulator assignment owns the moving objects of the domain.
+// Only a SCRIPT_EDIT bid or higher takes an object from it, and it claims the object back once it moves on its own.
+const quint8 AUTHORITATIVE_SIMULATION_PRIORITY = 0xff;
+
 
 class SimulationOwner {
 public:
@@ -0,0 +1,38 @@
+//
+//  SimulatorLoad.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SimulatorLoad.h"
+
+// a simulator using more than this much of its budget gives objects away, one using less than this takes them
+const float OVERLOADED_HEADROOM = 0.1f;
+const float SPARE_CAPACITY_HEADROOM = 0.5f;
+
+float SimulatorLoad::getHeadroom() const {
+    if (stepBudgetUsecs == 0) {
+        return 0.0f;
+    }
+    return 1.0f - (float)stepUsecs / (float)stepBudgetUsecs;
+}
+
+bool SimulatorLoad::isOverloaded() const {
+    return stepBudgetUsecs > 0 && getHeadroom() < OVERLOADED_HEADROOM;
+}
+
+bool SimulatorLoad::hasSpareCapacity() const {
+    return stepBudgetUsecs > 0 && getHeadroom() > SPARE_CAPACITY_HEADROOM;
+}
+
+QDataStream& operator<<(QDataStream& out, const SimulatorLoad& load) {
+    return out << load.stepBudgetUsecs << load.stepUsecs;
+}
+
+QDataStream& operator>>(QDataStream& in, SimulatorLoad& load) {
+    return in >> load.stepBudgetUsecs >> load.stepUsecs;
+}
@@ -0,0 +1,32 @@
+//
+//  SimulatorLoad.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SimulatorLoad_h
+#define hifi_SimulatorLoad_h
+
+#include <QtCore/QDataStream>
+
+// How busy the physics of a simulator is, which each simulator reports to the entity servers in a SimulatorLoad
+// packet once a second so that they can move the ownership of idle objects away from the ones that cannot keep up.
+struct SimulatorLoad {
+    quint32 stepBudgetUsecs { 0 }; // the time each frame the simulator allows its physics step
+    quint32 stepUsecs { 0 }; // the average time its physics step actually took
+
+    /// \return the fraction of the budget left, negative when the simulator is over its budget
+    float getHeadroom() const;
+
+    bool isOverloaded() const;
+    bool hasSpareCapacity() const;
+};
+
+QDataStream& operator<<(QDataStream& out, const SimulatorLoad& load);
+QDataStream& operator>>(QDataStream& in, SimulatorLoad& load);
+
+#endif // hifi_SimulatorLoad_h
@@ -137,6 +137,18 @@ UpdateEntityOperator::UpdateEntityOperator(EntityTreePointer tree,
 UpdateEntityOperator::~UpdateEntityOperator() {
 }
 
+bool UpdateEntityOperator::canApplyInPlace() const {
+    // the recursion would stop at the element that best fits the new box, make sure that's where the entity is
+    return _dontMove && _existingEntity->getElement() == _containingElement
+        && _containingElement->bestFitBounds(_newEntityBox);
+}
+
+void UpdateEntityOperator::applyInPlace() {
+    assert(canApplyInPlace());
+    _existingEntity->setProperties(_properties);
+    _containingElement->markWithChangedTime();
+}
+
 
 // does this entity tree element contain the old entity
 bool UpdateEntityOperator::subTreeContainsOldEntity(OctreeElementPointer element) {
@@ -174,7 +186,7 @@ bool UpdateEntityOperator::subTreeContainsNewEntity(OctreeElementPointer element
 }
 
 
-bool UpdateEntityOperator::preRecursion(OctreeElementPointer element) {
+bool UpdateEntityOperator::preRecursion(const OctreeElementPointer& element) {
     EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
     
     // In Pre-recursion, we're generally deciding whether or not we want to recurse this
@@ -312,7 +324,7 @@ bool UpdateEntityOperator::preRecursion(OctreeElementPointer element) {
     return keepSearching; // if we haven't yet found it, keep looking
 }
 
-bool UpdateEntityOperator::postRecursion(OctreeElementPointer element) {
+bool UpdateEntityOperator::postRecursion(const OctreeElementPointer& element) {
     // Post-recursion is the unwinding process. For this operation, while we
     // unwind we want to mark the path as being dirty if we changed it below.
     // We might have two paths, one for the old entity and one for the new entity.
@@ -344,7 +356,7 @@ bool UpdateEntityOperator::postRecursion(OctreeElementPointer element) {
     return keepSearching; // if we haven't yet found it, keep looking
 }
 
-OctreeElementPointer UpdateEntityOperator::possiblyCreateChildAt(OctreeElementPointer element, int childIndex) { 
+OctreeElementPointer UpdateEntityOperator::possiblyCreateChildAt(const OctreeElementPointer& element, int childIndex) { 
     // If we're getting called, it's because there was no child element at this index while recursing.
     // We only care if this happens while still searching for the new entity location.
     // Check to see if 
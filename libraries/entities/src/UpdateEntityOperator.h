@@ -24,9 +24,16 @@ public:
                          EntityItemPointer existingEntity, const EntityItemProperties& properties);
     ~UpdateEntityOperator();
 
-    virtual bool preRecursion(OctreeElementPointer element);
-    virtual bool postRecursion(OctreeElementPointer element);
-    virtual OctreeElementPointer possiblyCreateChildAt(OctreeElementPointer element, int childIndex);
+    virtual bool preRecursion(const OctreeElementPointer& element);
+    virtual bool postRecursion(const OctreeElementPointer& element);
+    virtual OctreeElementPointer possiblyCreateChildAt(const OctreeElementPointer& element, int childIndex);
+
+    /// true if the entity stays in its containing element, in which case the update doesn't need a recursion
+    bool canApplyInPlace() const;
+
+    /// sets the properties of an entity that stays in its element, the caller has to mark the path to the element as
+    /// changed, see MarkChangedElementsOperator
+    void applyInPlace();
 private:
     EntityTreePointer _tree;
     EntityItemPointer _existingEntity;
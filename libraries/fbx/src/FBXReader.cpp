@@ -9,12 +9,17 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <thread>
 #include <QBuffer>
 #include <QDataStream>
 #include <QIODevice>
 #include <QStringList>
 #include <QTextStream>
+#include <QThread>
 #include <QtDebug>
 #include <QtEndian>
 #include <QFileInfo>
@@ -293,6 +298,55 @@ void setTangents(FBXMesh& mesh, int firstIndex, int secondIndex) {
         glm::normalize(bitangent), normalizedNormal);
 }
 
+void computeTangents(FBXMesh& mesh) {
+    mesh.tangents.resize(mesh.vertices.size());
+    foreach (const FBXMeshPart& part, mesh.parts) {
+        for (int i = 0; i < part.quadIndices.size(); i += 4) {
+            setTangents(mesh, part.quadIndices.at(i), part.quadIndices.at(i + 1));
+            setTangents(mesh, part.quadIndices.at(i + 1), part.quadIndices.at(i + 2));
+            setTangents(mesh, part.quadIndices.at(i + 2), part.quadIndices.at(i + 3));
+            setTangents(mesh, part.quadIndices.at(i + 3), part.quadIndices.at(i));
+        }
+        // <= size - 3 in order to prevent overflowing triangleIndices when (i % 3) != 0
+        // This is most likely evidence of a further problem in extractMesh()
+        for (int i = 0; i <= part.triangleIndices.size() - 3; i += 3) {
+            setTangents(mesh, part.triangleIndices.at(i), part.triangleIndices.at(i + 1));
+            setTangents(mesh, part.triangleIndices.at(i + 1), part.triangleIndices.at(i + 2));
+            setTangents(mesh, part.triangleIndices.at(i + 2), part.triangleIndices.at(i));
+        }
+        if ((part.triangleIndices.size() % 3) != 0){
+            qCDebug(modelformat) << "Error in extractFBXGeometry part.triangleIndices.size() is not divisible by three ";
+        }
+    }
+}
+
+// Runs task(0) to task(count - 1) across the cores, each thread taking the next index as it finishes the last, since
+// the meshes of a model differ a lot in size
+void runInParallel(int count, const std::function<void(int)>& task) {
+    int numThreads = std::min(count, std::max(1, QThread::idealThreadCount()));
+    std::atomic<int> nextIndex(0);
+    auto work = [&]() {
+        for (int i = nextIndex++; i < count; i = nextIndex++) {
+            task(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; i++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+class PendingMesh {
+public:
+    QString id;
+    const FBXNode* object;
+    unsigned int meshIndex;
+};
+
 QVector<int> getIndices(const QVector<QString> ids, QVector<QString> modelIDs) {
     QVector<int> indices;
     foreach (const QString& id, ids) {
@@ -445,6 +499,7 @@ QByteArray fileOnUrl(const QByteArray& filenameString, const QString& url) {
 FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QString& url) {
     const FBXNode& node = _fbxNode;
     QMap<QString, ExtractedMesh> meshes;
+    QVector<PendingMesh> pendingMeshes;
     QHash<QString, QString> modelIDsToNames;
     QHash<QString, int> meshIDsToMeshIndices;
     QHash<QString, QString> ooChildToParent;
@@ -570,7 +625,9 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
             foreach (const FBXNode& object, child.children) {
                 if (object.name == "Geometry") {
                     if (object.properties.at(2) == "Mesh") {
-                        meshes.insert(getID(object.properties), extractMesh(object, meshIndex));
+                        // extracted once the whole tree is scanned, along with the other meshes
+                        PendingMesh pending = { getID(object.properties), &object, meshIndex++ };
+                        pendingMeshes.append(pending);
                     } else { // object.properties.at(2) == "Shape"
                         ExtractedBlendshape extracted = { getID(object.properties), extractBlendshape(object) };
                         blendshapes.append(extracted);
@@ -1101,6 +1158,17 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
 #endif
     }
 
+    // the meshes don't depend on each other, they merge back in the order they came in the file
+    QVector<ExtractedMesh> extractedMeshes(pendingMeshes.size());
+    ExtractedMesh* results = extractedMeshes.data();
+    runInParallel(pendingMeshes.size(), [&](int i) {
+        unsigned int index = pendingMeshes.at(i).meshIndex;
+        results[i] = extractMesh(*pendingMeshes.at(i).object, index);
+    });
+    for (int i = 0; i < pendingMeshes.size(); i++) {
+        meshes.insert(pendingMeshes.at(i).id, extractedMeshes.at(i));
+    }
+
     // TODO: check if is code is needed
     if (!lights.empty()) {
         if (hifiGlobalNodeID.isEmpty()) {
@@ -1293,6 +1361,7 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
     // see if any materials have texture children
     bool materialsHaveTextures = checkMaterialsHaveTextures(_fbxMaterials, _textureFilenames, _connectionChildMap);
 
+    QVector<bool> meshesNeedTangents;
     for (QMap<QString, ExtractedMesh>::iterator it = meshes.begin(); it != meshes.end(); it++) {
         ExtractedMesh& extracted = it.value();
 
@@ -1350,28 +1419,8 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
             }
         }
 
-        // if we have a normal map (and texture coordinates), we must compute tangents
-        if (generateTangents && !extracted.mesh.texCoords.isEmpty()) {
-            extracted.mesh.tangents.resize(extracted.mesh.vertices.size());
-            foreach (const FBXMeshPart& part, extracted.mesh.parts) {
-                for (int i = 0; i < part.quadIndices.size(); i += 4) {
-                    setTangents(extracted.mesh, part.quadIndices.at(i), part.quadIndices.at(i + 1));
-                    setTangents(extracted.mesh, part.quadIndices.at(i + 1), part.quadIndices.at(i + 2));
-                    setTangents(extracted.mesh, part.quadIndices.at(i + 2), part.quadIndices.at(i + 3));
-                    setTangents(extracted.mesh, part.quadIndices.at(i + 3), part.quadIndices.at(i));
-                }
-                // <= size - 3 in order to prevent overflowing triangleIndices when (i % 3) != 0
-                // This is most likely evidence of a further problem in extractMesh()
-                for (int i = 0; i <= part.triangleIndices.size() - 3; i += 3) {
-                    setTangents(extracted.mesh, part.triangleIndices.at(i), part.triangleIndices.at(i + 1));
-                    setTangents(extracted.mesh, part.triangleIndices.at(i + 1), part.triangleIndices.at(i + 2));
-                    setTangents(extracted.mesh, part.triangleIndices.at(i + 2), part.triangleIndices.at(i));
-                }
-                if ((part.triangleIndices.size() % 3) != 0){
-                    qCDebug(modelformat) << "Error in extractFBXGeometry part.triangleIndices.size() is not divisible by three ";
-                }
-            }
-        }
+        // if we have a normal map (and texture coordinates), we must compute tangents, with the other meshes
+        meshesNeedTangents.append(generateTangents && !extracted.mesh.texCoords.isEmpty());
 
         // find the clusters with which the mesh is associated
         QVector<QString> clusterIDs;
@@ -1520,8 +1569,6 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
         }
         extracted.mesh.isEye = (maxJointIndex == geometry.leftEyeJointIndex || maxJointIndex == geometry.rightEyeJointIndex);
 
-        buildModelMesh(extracted.mesh, url);
-
         if (extracted.mesh.isEye) {
             if (maxJointIndex == geometry.leftEyeJointIndex) {
                 geometry.leftEyeSize = extracted.mesh.meshExtents.largestDimension() * offsetScale;
@@ -1535,6 +1582,15 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
         meshIDsToMeshIndices.insert(it.key(), meshIndex);
     }
 
+    // the tangents and the simplified levels of detail only depend on their own mesh
+    FBXMesh* geometryMeshes = geometry.meshes.data();
+    runInParallel(geometry.meshes.size(), [&](int i) {
+        if (meshesNeedTangents.at(i)) {
+            computeTangents(geometryMeshes[i]);
+        }
+        buildModelMesh(geometryMeshes[i], url);
+    });
+
     // now that all joints have been scanned, compute a radius for each bone
     glm::vec3 defaultCapsuleAxis(0.0f, 1.0f, 0.0f);
     for (int i = 0; i < geometry.joints.size(); ++i) {
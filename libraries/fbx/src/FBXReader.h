@@ -188,6 +188,10 @@ public:
     unsigned int meshIndex; // the order the meshes appeared in the object file
 
     model::MeshPointer _mesh;
+
+    // The simplified levels of detail follow the full parts in the part buffer of _mesh, level l of part i being part
+    // i + l * parts.size(). Each level has the largest distance it moves the surface by, in the space of the vertices.
+    QVector<float> lodErrors;
 };
 
 class ExtractedMesh {
@@ -390,6 +394,10 @@ public:
     QHash<QString, ExtractedMesh> meshes;
     static void buildModelMesh(FBXMesh& extractedMesh, const QString& url);
 
+    /// Builds the mesh around indices and parts already laid out, the levels of detail included.
+    static void buildModelMesh(FBXMesh& extractedMesh, const gpu::BufferPointer& indexBuffer,
+                               const gpu::BufferPointer& partBuffer);
+
     FBXTexture getTexture(const QString& textureID);
 
     QHash<QString, QString> _textureNames;
@@ -20,11 +20,15 @@
 #include <QFileInfo>
 #include <QHash>
 #include <LogHandler.h>
+#include <MeshSimplifier.h>
 #include "ModelFormatLogging.h"
 
 #include "FBXReader.h"
 
 #include <memory>
+#include <mutex>
+
+#include <glm/gtc/packing.hpp>
 
 
 class Vertex {
@@ -386,8 +390,13 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
     return data.extracted;
 }
 
+// The meshes of a model get built on several threads at once, where a local static isn't safe to initialize
+static std::once_flag repeatedMessageFlag;
+
 void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
-    static QString repeatedMessage = LogHandler::getInstance().addRepeatedMessageRegex("buildModelMesh failed -- .*");
+    std::call_once(repeatedMessageFlag, [] {
+        LogHandler::getInstance().addRepeatedMessageRegex("buildModelMesh failed -- .*");
+    });
 
     unsigned int totalSourceIndices = 0;
     foreach(const FBXMeshPart& part, extractedMesh.parts) {
@@ -405,23 +414,191 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
     }
 
     FBXMesh& fbxMesh = extractedMesh;
+    unsigned int totalIndices = totalSourceIndices;
+
+    // The levels of detail only index the vertices of the full mesh, so they skin and blend along with it
+    QVector<MeshSimplifier::Level> lods;
+    fbxMesh.lodErrors.clear();
+    const unsigned int MIN_LOD_TRIANGLES = 256;
+    if (totalIndices / 3 >= MIN_LOD_TRIANGLES) {
+        QVector<QVector<int>> partIndices;
+        foreach(const FBXMeshPart& part, extractedMesh.parts) {
+            partIndices.push_back(part.quadTrianglesIndices + part.triangleIndices);
+        }
+        const QVector<float> LOD_RATIOS = { 0.5f, 0.25f };
+        lods = MeshSimplifier::simplify(extractedMesh.vertices, partIndices, LOD_RATIOS);
+        foreach(const MeshSimplifier::Level& lod, lods) {
+            fbxMesh.lodErrors.push_back(lod.error);
+            totalIndices += lod.numTriangles * 3;
+        }
+    }
+
+    auto indexBuffer = std::make_shared<gpu::Buffer>();
+    indexBuffer->resize(totalIndices * sizeof(int));
+
+    int indexNum = 0;
+    int offset = 0;
+
+    std::vector< model::Mesh::Part > parts;
+    if (extractedMesh.parts.size() > 1) {
+        indexNum = 0;
+    }
+    foreach(const FBXMeshPart& part, extractedMesh.parts) {
+        model::Mesh::Part modelPart(indexNum, 0, 0, model::Mesh::TRIANGLES);
+        
+        if (part.quadTrianglesIndices.size()) {
+            indexBuffer->setSubData(offset,
+                            part.quadTrianglesIndices.size() * sizeof(int),
+                            (gpu::Byte*) part.quadTrianglesIndices.constData());
+            offset += part.quadTrianglesIndices.size() * sizeof(int);
+            indexNum += part.quadTrianglesIndices.size();
+            modelPart._numIndices += part.quadTrianglesIndices.size();
+        }
+
+        if (part.triangleIndices.size()) {
+            indexBuffer->setSubData(offset,
+                            part.triangleIndices.size() * sizeof(int),
+                            (gpu::Byte*) part.triangleIndices.constData());
+            offset += part.triangleIndices.size() * sizeof(int);
+            indexNum += part.triangleIndices.size();
+            modelPart._numIndices += part.triangleIndices.size();
+        }
+
+        parts.push_back(modelPart);
+    }
+
+    foreach(const MeshSimplifier::Level& lod, lods) {
+        foreach(const QVector<int>& indices, lod.partIndices) {
+            model::Mesh::Part modelPart(indexNum, indices.size(), 0, model::Mesh::TRIANGLES);
+            if (indices.size()) {
+                indexBuffer->setSubData(offset, indices.size() * sizeof(int), (gpu::Byte*) indices.constData());
+                offset += indices.size() * sizeof(int);
+                indexNum += indices.size();
+            }
+            parts.push_back(modelPart);
+        }
+    }
+
+    if (parts.empty()) {
+        qCDebug(modelformat) << "buildModelMesh failed -- no parts, url = " << url;
+        return;
+    }
+    auto partBuffer = std::make_shared<gpu::Buffer>();
+    partBuffer->setData(parts.size() * sizeof(model::Mesh::Part), (const gpu::Byte*) parts.data());
+
+    buildModelMesh(extractedMesh, indexBuffer, partBuffer);
+}
+
+// The attributes the shaders read as floats all the same, packed into fewer bytes when they fit
+static QVector<quint32> packDirections(const QVector<glm::vec3>& directions) {
+    QVector<quint32> packed;
+    packed.reserve(directions.size());
+    foreach (const glm::vec3& direction, directions) {
+        packed.append(glm::packSnorm4x8(glm::vec4(direction, 0.0f)));
+    }
+    return packed;
+}
+
+// Half floats keep a texel of precision up to a 2048 texture when the coordinates don't wrap more than once
+static bool canPackTexCoords(const QVector<glm::vec2>& texCoords) {
+    const float MAX_PACKED_TEX_COORD = 2.0f;
+    foreach (const glm::vec2& texCoord, texCoords) {
+        if (glm::any(glm::greaterThan(glm::abs(texCoord), glm::vec2(MAX_PACKED_TEX_COORD)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static QVector<quint32> packTexCoords(const QVector<glm::vec2>& texCoords) {
+    QVector<quint32> packed;
+    packed.reserve(texCoords.size());
+    foreach (const glm::vec2& texCoord, texCoords) {
+        packed.append(glm::packHalf2x16(texCoord));
+    }
+    return packed;
+}
+
+static bool canPackClusterIndices(const QVector<glm::vec4>& clusterIndices) {
+    const float MAX_PACKED_CLUSTER_INDEX = 255.0f;
+    foreach (const glm::vec4& indices, clusterIndices) {
+        if (glm::any(glm::greaterThan(indices, glm::vec4(MAX_PACKED_CLUSTER_INDEX)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static QVector<quint32> packClusterIndices(const QVector<glm::vec4>& clusterIndices) {
+    QVector<quint32> packed;
+    packed.reserve(clusterIndices.size());
+    foreach (const glm::vec4& indices, clusterIndices) {
+        glm::uvec4 bytes(indices);
+        packed.append(bytes.x | (bytes.y << 8) | (bytes.z << 16) | (bytes.w << 24));
+    }
+    return packed;
+}
+
+// The rounding error goes to the heaviest weight, so that the weights of a vertex still add up to one
+static QVector<quint32> packClusterWeights(const QVector<glm::vec4>& clusterWeights) {
+    const float MAX_BYTE = 255.0f;
+    QVector<quint32> packed;
+    packed.reserve(clusterWeights.size());
+    foreach (const glm::vec4& weights, clusterWeights) {
+        glm::ivec4 bytes(glm::round(glm::clamp(weights, 0.0f, 1.0f) * MAX_BYTE));
+        int heaviest = 0;
+        for (int i = 1; i < 4; i++) {
+            if (bytes[i] > bytes[heaviest]) {
+                heaviest = i;
+            }
+        }
+        int sum = bytes.x + bytes.y + bytes.z + bytes.w;
+        if (sum > 0) {
+            bytes[heaviest] = glm::clamp(bytes[heaviest] + (int)MAX_BYTE - sum, 0, (int)MAX_BYTE);
+        }
+        packed.append(bytes.x | (bytes.y << 8) | (bytes.z << 16) | (bytes.w << 24));
+    }
+    return packed;
+}
+
+void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const gpu::BufferPointer& indexBuffer,
+                               const gpu::BufferPointer& partBuffer) {
+    const FBXMesh& fbxMesh = extractedMesh;
     model::MeshPointer mesh(new model::Mesh());
 
-    // Grab the vertices in a buffer
+    // Grab the vertices in a buffer, as floats since they are read back for the bounds and the blending
     auto vb = std::make_shared<gpu::Buffer>();
     vb->setData(extractedMesh.vertices.size() * sizeof(glm::vec3),
                 (const gpu::Byte*) extractedMesh.vertices.data());
     gpu::BufferView vbv(vb, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
     mesh->setVertexBuffer(vbv);
 
+    // the blended normals replace the normals of the mesh as floats, for the same format
+    bool packNormals = fbxMesh.blendshapes.isEmpty();
+    bool packTexCoords0 = canPackTexCoords(fbxMesh.texCoords);
+    bool packTexCoords1 = canPackTexCoords(fbxMesh.texCoords1);
+    bool packClusters = canPackClusterIndices(fbxMesh.clusterIndices);
+
+    QVector<quint32> packedNormals = packNormals ? packDirections(fbxMesh.normals) : QVector<quint32>();
+    QVector<quint32> packedTangents = packDirections(fbxMesh.tangents);
+    QVector<quint32> packedTexCoords = packTexCoords0 ? packTexCoords(fbxMesh.texCoords) : QVector<quint32>();
+    QVector<quint32> packedTexCoords1 = packTexCoords1 ? packTexCoords(fbxMesh.texCoords1) : QVector<quint32>();
+    QVector<quint32> packedClusterIndices = packClusters ? packClusterIndices(fbxMesh.clusterIndices) : QVector<quint32>();
+    QVector<quint32> packedClusterWeights = packClusters ? packClusterWeights(fbxMesh.clusterWeights) : QVector<quint32>();
+
+    const gpu::Element PACKED_DIRECTION_ELEMENT(gpu::VEC4, gpu::NINT8, gpu::XYZW);
+    const gpu::Element PACKED_TEX_COORD_ELEMENT(gpu::VEC2, gpu::HALF, gpu::UV);
+    const gpu::Element PACKED_CLUSTER_INDEX_ELEMENT(gpu::VEC4, gpu::UINT8, gpu::XYZW);
+    const gpu::Element PACKED_CLUSTER_WEIGHT_ELEMENT(gpu::VEC4, gpu::NUINT8, gpu::XYZW);
+
     // evaluate all attribute channels sizes
-    int normalsSize = fbxMesh.normals.size() * sizeof(glm::vec3);
-    int tangentsSize = fbxMesh.tangents.size() * sizeof(glm::vec3);
+    int normalsSize = fbxMesh.normals.size() * (packNormals ? sizeof(quint32) : sizeof(glm::vec3));
+    int tangentsSize = fbxMesh.tangents.size() * sizeof(quint32);
     int colorsSize = fbxMesh.colors.size() * sizeof(glm::vec3);
-    int texCoordsSize = fbxMesh.texCoords.size() * sizeof(glm::vec2);
-    int texCoords1Size = fbxMesh.texCoords1.size() * sizeof(glm::vec2);
-    int clusterIndicesSize = fbxMesh.clusterIndices.size() * sizeof(glm::vec4);
-    int clusterWeightsSize = fbxMesh.clusterWeights.size() * sizeof(glm::vec4);
+    int texCoordsSize = fbxMesh.texCoords.size() * (packTexCoords0 ? sizeof(quint32) : sizeof(glm::vec2));
+    int texCoords1Size = fbxMesh.texCoords1.size() * (packTexCoords1 ? sizeof(quint32) : sizeof(glm::vec2));
+    int clusterIndicesSize = fbxMesh.clusterIndices.size() * (packClusters ? sizeof(quint32) : sizeof(glm::vec4));
+    int clusterWeightsSize = fbxMesh.clusterWeights.size() * (packClusters ? sizeof(quint32) : sizeof(glm::vec4));
 
     int normalsOffset = 0;
     int tangentsOffset = normalsOffset + normalsSize;
@@ -435,23 +612,30 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
     // Copy all attribute data in a single attribute buffer
     auto attribBuffer = std::make_shared<gpu::Buffer>();
     attribBuffer->resize(totalAttributeSize);
-    attribBuffer->setSubData(normalsOffset, normalsSize, (gpu::Byte*) fbxMesh.normals.constData());
-    attribBuffer->setSubData(tangentsOffset, tangentsSize, (gpu::Byte*) fbxMesh.tangents.constData());
+    attribBuffer->setSubData(normalsOffset, normalsSize, packNormals ?
+        (gpu::Byte*) packedNormals.constData() : (gpu::Byte*) fbxMesh.normals.constData());
+    attribBuffer->setSubData(tangentsOffset, tangentsSize, (gpu::Byte*) packedTangents.constData());
     attribBuffer->setSubData(colorsOffset, colorsSize, (gpu::Byte*) fbxMesh.colors.constData());
-    attribBuffer->setSubData(texCoordsOffset, texCoordsSize, (gpu::Byte*) fbxMesh.texCoords.constData());
-    attribBuffer->setSubData(texCoords1Offset, texCoords1Size, (gpu::Byte*) fbxMesh.texCoords1.constData());
-    attribBuffer->setSubData(clusterIndicesOffset, clusterIndicesSize, (gpu::Byte*) fbxMesh.clusterIndices.constData());
-    attribBuffer->setSubData(clusterWeightsOffset, clusterWeightsSize, (gpu::Byte*) fbxMesh.clusterWeights.constData());
+    attribBuffer->setSubData(texCoordsOffset, texCoordsSize, packTexCoords0 ?
+        (gpu::Byte*) packedTexCoords.constData() : (gpu::Byte*) fbxMesh.texCoords.constData());
+    attribBuffer->setSubData(texCoords1Offset, texCoords1Size, packTexCoords1 ?
+        (gpu::Byte*) packedTexCoords1.constData() : (gpu::Byte*) fbxMesh.texCoords1.constData());
+    attribBuffer->setSubData(clusterIndicesOffset, clusterIndicesSize, packClusters ?
+        (gpu::Byte*) packedClusterIndices.constData() : (gpu::Byte*) fbxMesh.clusterIndices.constData());
+    attribBuffer->setSubData(clusterWeightsOffset, clusterWeightsSize, packClusters ?
+        (gpu::Byte*) packedClusterWeights.constData() : (gpu::Byte*) fbxMesh.clusterWeights.constData());
+
+    gpu::Element texCoordsElement = packTexCoords0 ? PACKED_TEX_COORD_ELEMENT : gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV);
+    gpu::Element texCoords1Element = packTexCoords1 ? PACKED_TEX_COORD_ELEMENT : gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV);
 
     if (normalsSize) {
         mesh->addAttribute(gpu::Stream::NORMAL,
-                            model::BufferView(attribBuffer, normalsOffset, normalsSize,
-                            gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
+                            model::BufferView(attribBuffer, normalsOffset, normalsSize, packNormals ?
+                            PACKED_DIRECTION_ELEMENT : gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
     }
     if (tangentsSize) {
         mesh->addAttribute(gpu::Stream::TANGENT,
-                            model::BufferView(attribBuffer, tangentsOffset, tangentsSize,
-                            gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
+                            model::BufferView(attribBuffer, tangentsOffset, tangentsSize, PACKED_DIRECTION_ELEMENT));
     }
     if (colorsSize) {
         mesh->addAttribute(gpu::Stream::COLOR,
@@ -460,87 +644,32 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
     }
     if (texCoordsSize) {
         mesh->addAttribute(gpu::Stream::TEXCOORD,
-                            model::BufferView( attribBuffer, texCoordsOffset, texCoordsSize,
-                            gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV)));
+                            model::BufferView( attribBuffer, texCoordsOffset, texCoordsSize, texCoordsElement));
     }
     if (texCoords1Size) {
         mesh->addAttribute( gpu::Stream::TEXCOORD1,
-                            model::BufferView(attribBuffer, texCoords1Offset, texCoords1Size,
-                            gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV)));
+                            model::BufferView(attribBuffer, texCoords1Offset, texCoords1Size, texCoords1Element));
     } else if (texCoordsSize) {
         mesh->addAttribute(gpu::Stream::TEXCOORD1,
-                            model::BufferView(attribBuffer, texCoordsOffset, texCoordsSize,
-                            gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV)));
+                            model::BufferView(attribBuffer, texCoordsOffset, texCoordsSize, texCoordsElement));
     }
 
     if (clusterIndicesSize) {
         mesh->addAttribute(gpu::Stream::SKIN_CLUSTER_INDEX,
-                          model::BufferView(attribBuffer, clusterIndicesOffset, clusterIndicesSize,
-                                            gpu::Element(gpu::VEC4, gpu::FLOAT, gpu::XYZW)));
+                          model::BufferView(attribBuffer, clusterIndicesOffset, clusterIndicesSize, packClusters ?
+                                            PACKED_CLUSTER_INDEX_ELEMENT : gpu::Element(gpu::VEC4, gpu::FLOAT, gpu::XYZW)));
     }
     if (clusterWeightsSize) {
         mesh->addAttribute(gpu::Stream::SKIN_CLUSTER_WEIGHT,
-                          model::BufferView(attribBuffer, clusterWeightsOffset, clusterWeightsSize,
-                                            gpu::Element(gpu::VEC4, gpu::FLOAT, gpu::XYZW)));
-    }
-
-
-    unsigned int totalIndices = 0;
-    foreach(const FBXMeshPart& part, extractedMesh.parts) {
-        totalIndices += (part.quadTrianglesIndices.size() + part.triangleIndices.size());
-    }
-
-    if (! totalIndices) {
-        qCDebug(modelformat) << "buildModelMesh failed -- no indices, url = " << url;
-        return;
-    }
-
-    auto indexBuffer = std::make_shared<gpu::Buffer>();
-    indexBuffer->resize(totalIndices * sizeof(int));
-
-    int indexNum = 0;
-    int offset = 0;
-
-    std::vector< model::Mesh::Part > parts;
-    if (extractedMesh.parts.size() > 1) {
-        indexNum = 0;
-    }
-    foreach(const FBXMeshPart& part, extractedMesh.parts) {
-        model::Mesh::Part modelPart(indexNum, 0, 0, model::Mesh::TRIANGLES);
-        
-        if (part.quadTrianglesIndices.size()) {
-            indexBuffer->setSubData(offset,
-                            part.quadTrianglesIndices.size() * sizeof(int),
-                            (gpu::Byte*) part.quadTrianglesIndices.constData());
-            offset += part.quadTrianglesIndices.size() * sizeof(int);
-            indexNum += part.quadTrianglesIndices.size();
-            modelPart._numIndices += part.quadTrianglesIndices.size();
-        }
-
-        if (part.triangleIndices.size()) {
-            indexBuffer->setSubData(offset,
-                            part.triangleIndices.size() * sizeof(int),
-                            (gpu::Byte*) part.triangleIndices.constData());
-            offset += part.triangleIndices.size() * sizeof(int);
-            indexNum += part.triangleIndices.size();
-            modelPart._numIndices += part.triangleIndices.size();
-        }
-
-        parts.push_back(modelPart);
+                          model::BufferView(attribBuffer, clusterWeightsOffset, clusterWeightsSize, packClusters ?
+                                            PACKED_CLUSTER_WEIGHT_ELEMENT : gpu::Element(gpu::VEC4, gpu::FLOAT, gpu::XYZW)));
     }
 
     gpu::BufferView indexBufferView(indexBuffer, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::XYZ));
     mesh->setIndexBuffer(indexBufferView);
 
-    if (parts.size()) {
-        auto pb = std::make_shared<gpu::Buffer>();
-        pb->setData(parts.size() * sizeof(model::Mesh::Part), (const gpu::Byte*) parts.data());
-        gpu::BufferView pbv(pb, gpu::Element(gpu::VEC4, gpu::UINT32, gpu::XYZW));
-        mesh->setPartBuffer(pbv);
-    } else {
-        qCDebug(modelformat) << "buildModelMesh failed -- no parts, url = " << url;
-        return;
-    }
+    gpu::BufferView pbv(partBuffer, gpu::Element(gpu::VEC4, gpu::UINT32, gpu::XYZW));
+    mesh->setPartBuffer(pbv);
 
     // model::Box box =
     mesh->evalPartBound(0);
@@ -0,0 +1,428 @@
+//
+//  FBXSerializer.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXSerializer.h"
+
+#include <QDataStream>
+
+#include "FBXReader.h"
+#include "ModelFormatLogging.h"
+
+namespace {
+
+const quint32 MAGIC = 0x43584246; // FBXC
+const quint32 VERSION = 1;
+
+// the raw arrays are only readable by a machine of the same endianness
+const quint32 ENDIANNESS = 0x04030201;
+
+template<typename T> void writeRaw(QDataStream& out, const T& value) {
+    out.writeRawData((const char*)&value, sizeof(T));
+}
+
+template<typename T> void readRaw(QDataStream& in, T& value) {
+    if (in.readRawData((char*)&value, sizeof(T)) != (int)sizeof(T)) {
+        in.setStatus(QDataStream::ReadPastEnd);
+    }
+}
+
+template<typename T> void writeArray(QDataStream& out, const QVector<T>& values) {
+    out << (qint32)values.size();
+    out.writeRawData((const char*)values.constData(), values.size() * (int)sizeof(T));
+}
+
+template<typename T> void readArray(QDataStream& in, QVector<T>& values) {
+    qint32 size;
+    in >> size;
+    if (in.status() != QDataStream::Ok || size < 0 || (qint64)size * (qint64)sizeof(T) > in.device()->bytesAvailable()) {
+        in.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+    values.resize(size);
+    in.readRawData((char*)values.data(), size * (int)sizeof(T));
+}
+
+// The arrays of structures go one element at a time
+template<typename T> void writeList(QDataStream& out, const QVector<T>& values, void (*write)(QDataStream&, const T&)) {
+    out << (qint32)values.size();
+    foreach (const T& value, values) {
+        write(out, value);
+    }
+}
+
+template<typename T> void readList(QDataStream& in, QVector<T>& values, void (*read)(QDataStream&, T&)) {
+    qint32 size;
+    in >> size;
+    if (in.status() != QDataStream::Ok || size < 0 || size > in.device()->bytesAvailable()) {
+        in.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+    values.resize(size);
+    for (int i = 0; i < size && in.status() == QDataStream::Ok; i++) {
+        read(in, values[i]);
+    }
+}
+
+void writeBuffer(QDataStream& out, const gpu::BufferPointer& buffer) {
+    out << (qint32)buffer->getSize();
+    out.writeRawData((const char*)buffer->getData(), (int)buffer->getSize());
+}
+
+gpu::BufferPointer readBuffer(QDataStream& in) {
+    qint32 size;
+    in >> size;
+    if (in.status() != QDataStream::Ok || size < 0 || size > in.device()->bytesAvailable()) {
+        in.setStatus(QDataStream::ReadCorruptData);
+        return gpu::BufferPointer();
+    }
+    auto buffer = std::make_shared<gpu::Buffer>();
+    buffer->resize(size);
+    in.readRawData((char*)buffer->editData(), size);
+    return buffer;
+}
+
+void writeTexture(QDataStream& out, const FBXTexture& texture) {
+    out << texture.name << texture.filename << texture.content;
+    writeRaw(out, texture.transform.getTranslation());
+    writeRaw(out, texture.transform.getRotation());
+    writeRaw(out, texture.transform.getScale());
+    out << (qint32)texture.texcoordSet << texture.texcoordSetName << texture.isBumpmap;
+}
+
+void readTexture(QDataStream& in, FBXTexture& texture) {
+    glm::vec3 translation, scale;
+    glm::quat rotation;
+    qint32 texcoordSet;
+    in >> texture.name >> texture.filename >> texture.content;
+    readRaw(in, translation);
+    readRaw(in, rotation);
+    readRaw(in, scale);
+    in >> texcoordSet >> texture.texcoordSetName >> texture.isBumpmap;
+    texture.transform.setTranslation(translation);
+    texture.transform.setRotation(rotation);
+    texture.transform.setScale(scale);
+    texture.texcoordSet = texcoordSet;
+}
+
+void writeMaterial(QDataStream& out, const FBXMaterial& material) {
+    writeRaw(out, material.diffuseColor);
+    writeRaw(out, material.diffuseFactor);
+    writeRaw(out, material.specularColor);
+    writeRaw(out, material.specularFactor);
+    writeRaw(out, material.emissiveColor);
+    writeRaw(out, material.emissiveParams);
+    writeRaw(out, material.shininess);
+    writeRaw(out, material.opacity);
+    out << material.materialID;
+    writeTexture(out, material.diffuseTexture);
+    writeTexture(out, material.opacityTexture);
+    writeTexture(out, material.normalTexture);
+    writeTexture(out, material.specularTexture);
+    writeTexture(out, material.emissiveTexture);
+
+    // the readers don't map the properties to the model material the same way, so it keeps its own values
+    bool hasMaterial = (bool)material._material;
+    out << hasMaterial;
+    if (hasMaterial) {
+        writeRaw(out, material._material->getEmissive());
+        writeRaw(out, material._material->getDiffuse());
+        writeRaw(out, material._material->getMetallic());
+        writeRaw(out, material._material->getGloss());
+        writeRaw(out, material._material->getOpacity());
+    }
+}
+
+void readMaterial(QDataStream& in, FBXMaterial& material) {
+    readRaw(in, material.diffuseColor);
+    readRaw(in, material.diffuseFactor);
+    readRaw(in, material.specularColor);
+    readRaw(in, material.specularFactor);
+    readRaw(in, material.emissiveColor);
+    readRaw(in, material.emissiveParams);
+    readRaw(in, material.shininess);
+    readRaw(in, material.opacity);
+    in >> material.materialID;
+    readTexture(in, material.diffuseTexture);
+    readTexture(in, material.opacityTexture);
+    readTexture(in, material.normalTexture);
+    readTexture(in, material.specularTexture);
+    readTexture(in, material.emissiveTexture);
+
+    bool hasMaterial;
+    in >> hasMaterial;
+    if (hasMaterial) {
+        model::Material::Color emissive, diffuse;
+        float metallic, gloss, opacity;
+        readRaw(in, emissive);
+        readRaw(in, diffuse);
+        readRaw(in, metallic);
+        readRaw(in, gloss);
+        readRaw(in, opacity);
+        material._material = std::make_shared<model::Material>();
+        material._material->setEmissive(emissive);
+        material._material->setDiffuse(diffuse);
+        material._material->setMetallic(metallic);
+        material._material->setGloss(gloss);
+        material._material->setOpacity(opacity);
+    }
+}
+
+void writePart(QDataStream& out, const FBXMeshPart& part) {
+    writeArray(out, part.quadIndices);
+    writeArray(out, part.quadTrianglesIndices);
+    writeArray(out, part.triangleIndices);
+    out << part.materialID;
+}
+
+void readPart(QDataStream& in, FBXMeshPart& part) {
+    readArray(in, part.quadIndices);
+    readArray(in, part.quadTrianglesIndices);
+    readArray(in, part.triangleIndices);
+    in >> part.materialID;
+}
+
+void writeCluster(QDataStream& out, const FBXCluster& cluster) {
+    out << (qint32)cluster.jointIndex;
+    writeRaw(out, cluster.inverseBindMatrix);
+}
+
+void readCluster(QDataStream& in, FBXCluster& cluster) {
+    qint32 jointIndex;
+    in >> jointIndex;
+    readRaw(in, cluster.inverseBindMatrix);
+    cluster.jointIndex = jointIndex;
+}
+
+void writeBlendshape(QDataStream& out, const FBXBlendshape& blendshape) {
+    writeArray(out, blendshape.indices);
+    writeArray(out, blendshape.vertices);
+    writeArray(out, blendshape.normals);
+}
+
+void readBlendshape(QDataStream& in, FBXBlendshape& blendshape) {
+    readArray(in, blendshape.indices);
+    readArray(in, blendshape.vertices);
+    readArray(in, blendshape.normals);
+}
+
+void writeMesh(QDataStream& out, const FBXMesh& mesh) {
+    writeList(out, mesh.parts, &writePart);
+    writeArray(out, mesh.vertices);
+    writeArray(out, mesh.normals);
+    writeArray(out, mesh.tangents);
+    writeArray(out, mesh.colors);
+    writeArray(out, mesh.texCoords);
+    writeArray(out, mesh.texCoords1);
+    writeArray(out, mesh.clusterIndices);
+    writeArray(out, mesh.clusterWeights);
+    writeList(out, mesh.clusters, &writeCluster);
+    writeRaw(out, mesh.meshExtents);
+    writeRaw(out, mesh.modelTransform);
+    out << mesh.isEye;
+    writeList(out, mesh.blendshapes, &writeBlendshape);
+    out << (quint32)mesh.meshIndex;
+    writeArray(out, mesh.lodErrors);
+
+    // the built indices hold the simplified levels of detail, the longest to compute
+    bool hasMesh = mesh._mesh && mesh._mesh->getIndexBuffer()._buffer && mesh._mesh->getPartBuffer()._buffer;
+    out << hasMesh;
+    if (hasMesh) {
+        writeBuffer(out, mesh._mesh->getIndexBuffer()._buffer);
+        writeBuffer(out, mesh._mesh->getPartBuffer()._buffer);
+    }
+}
+
+void readMesh(QDataStream& in, FBXMesh& mesh) {
+    readList(in, mesh.parts, &readPart);
+    readArray(in, mesh.vertices);
+    readArray(in, mesh.normals);
+    readArray(in, mesh.tangents);
+    readArray(in, mesh.colors);
+    readArray(in, mesh.texCoords);
+    readArray(in, mesh.texCoords1);
+    readArray(in, mesh.clusterIndices);
+    readArray(in, mesh.clusterWeights);
+    readList(in, mesh.clusters, &readCluster);
+    readRaw(in, mesh.meshExtents);
+    readRaw(in, mesh.modelTransform);
+    in >> mesh.isEye;
+    readList(in, mesh.blendshapes, &readBlendshape);
+    quint32 meshIndex;
+    in >> meshIndex;
+    mesh.meshIndex = meshIndex;
+    readArray(in, mesh.lodErrors);
+
+    bool hasMesh;
+    in >> hasMesh;
+    if (hasMesh) {
+        gpu::BufferPointer indexBuffer = readBuffer(in);
+        gpu::BufferPointer partBuffer = readBuffer(in);
+        if (in.status() == QDataStream::Ok) {
+            FBXReader::buildModelMesh(mesh, indexBuffer, partBuffer);
+        }
+    }
+}
+
+void writeJoint(QDataStream& out, const FBXJoint& joint) {
+    writeArray(out, joint.shapeInfo.points);
+    writeRaw(out, joint.shapeInfo.radius);
+    writeArray(out, joint.freeLineage);
+    out << joint.isFree << (qint32)joint.parentIndex;
+    writeRaw(out, joint.distanceToParent);
+    writeRaw(out, joint.translation);
+    writeRaw(out, joint.preTransform);
+    writeRaw(out, joint.preRotation);
+    writeRaw(out, joint.rotation);
+    writeRaw(out, joint.postRotation);
+    writeRaw(out, joint.postTransform);
+    writeRaw(out, joint.transform);
+    writeRaw(out, joint.rotationMin);
+    writeRaw(out, joint.rotationMax);
+    writeRaw(out, joint.inverseDefaultRotation);
+    writeRaw(out, joint.inverseBindRotation);
+    writeRaw(out, joint.bindTransform);
+    out << joint.name << joint.isSkeletonJoint << joint.bindTransformFoundInCluster;
+}
+
+void readJoint(QDataStream& in, FBXJoint& joint) {
+    qint32 parentIndex;
+    readArray(in, joint.shapeInfo.points);
+    readRaw(in, joint.shapeInfo.radius);
+    readArray(in, joint.freeLineage);
+    in >> joint.isFree >> parentIndex;
+    joint.parentIndex = parentIndex;
+    readRaw(in, joint.distanceToParent);
+    readRaw(in, joint.translation);
+    readRaw(in, joint.preTransform);
+    readRaw(in, joint.preRotation);
+    readRaw(in, joint.rotation);
+    readRaw(in, joint.postRotation);
+    readRaw(in, joint.postTransform);
+    readRaw(in, joint.transform);
+    readRaw(in, joint.rotationMin);
+    readRaw(in, joint.rotationMax);
+    readRaw(in, joint.inverseDefaultRotation);
+    readRaw(in, joint.inverseBindRotation);
+    readRaw(in, joint.bindTransform);
+    in >> joint.name >> joint.isSkeletonJoint >> joint.bindTransformFoundInCluster;
+}
+
+void writeAnimationFrame(QDataStream& out, const FBXAnimationFrame& frame) {
+    writeArray(out, frame.rotations);
+    writeArray(out, frame.translations);
+}
+
+void readAnimationFrame(QDataStream& in, FBXAnimationFrame& frame) {
+    readArray(in, frame.rotations);
+    readArray(in, frame.translations);
+}
+
+void writeSittingPoint(QDataStream& out, const SittingPoint& point) {
+    out << point.name;
+    writeRaw(out, point.position);
+    writeRaw(out, point.rotation);
+}
+
+void readSittingPoint(QDataStream& in, SittingPoint& point) {
+    in >> point.name;
+    readRaw(in, point.position);
+    readRaw(in, point.rotation);
+}
+
+}
+
+QByteArray FBXSerializer::write(const FBXGeometry& geometry) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << MAGIC << VERSION << ENDIANNESS;
+
+    out << geometry.author << geometry.applicationName;
+    writeList(out, geometry.joints, &writeJoint);
+    out << geometry.jointIndices << geometry.hasSkeletonJoints;
+    writeList(out, geometry.meshes, &writeMesh);
+
+    out << (qint32)geometry.materials.size();
+    for (auto it = geometry.materials.constBegin(); it != geometry.materials.constEnd(); it++) {
+        out << it.key();
+        writeMaterial(out, it.value());
+    }
+
+    writeRaw(out, geometry.offset);
+    const int* jointIndices[] = { &geometry.leftEyeJointIndex, &geometry.rightEyeJointIndex, &geometry.neckJointIndex,
+        &geometry.rootJointIndex, &geometry.leanJointIndex, &geometry.headJointIndex, &geometry.leftHandJointIndex,
+        &geometry.rightHandJointIndex, &geometry.leftToeJointIndex, &geometry.rightToeJointIndex };
+    for (const int* jointIndex : jointIndices) {
+        out << (qint32)*jointIndex;
+    }
+    writeRaw(out, geometry.leftEyeSize);
+    writeRaw(out, geometry.rightEyeSize);
+    writeArray(out, geometry.humanIKJointIndices);
+    writeRaw(out, geometry.palmDirection);
+    writeList(out, geometry.sittingPoints, &writeSittingPoint);
+    writeRaw(out, geometry.neckPivot);
+    writeRaw(out, geometry.bindExtents);
+    writeRaw(out, geometry.meshExtents);
+    writeList(out, geometry.animationFrames, &writeAnimationFrame);
+    out << geometry.meshIndicesToModelNames << geometry.blendshapeChannelNames;
+    return data;
+}
+
+FBXGeometry* FBXSerializer::read(const QByteArray& data, const QString& url) {
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version, endianness;
+    in >> magic >> version >> endianness;
+    if (in.status() != QDataStream::Ok || magic != MAGIC || version != VERSION || endianness != ENDIANNESS) {
+        return nullptr;
+    }
+
+    FBXGeometry* geometryPtr = new FBXGeometry();
+    FBXGeometry& geometry = *geometryPtr;
+    in >> geometry.author >> geometry.applicationName;
+    readList(in, geometry.joints, &readJoint);
+    in >> geometry.jointIndices >> geometry.hasSkeletonJoints;
+    readList(in, geometry.meshes, &readMesh);
+
+    qint32 numMaterials;
+    in >> numMaterials;
+    for (int i = 0; i < numMaterials && in.status() == QDataStream::Ok; i++) {
+        QString materialID;
+        in >> materialID;
+        readMaterial(in, geometry.materials[materialID]);
+    }
+
+    readRaw(in, geometry.offset);
+    int* jointIndices[] = { &geometry.leftEyeJointIndex, &geometry.rightEyeJointIndex, &geometry.neckJointIndex,
+        &geometry.rootJointIndex, &geometry.leanJointIndex, &geometry.headJointIndex, &geometry.leftHandJointIndex,
+        &geometry.rightHandJointIndex, &geometry.leftToeJointIndex, &geometry.rightToeJointIndex };
+    for (int* jointIndex : jointIndices) {
+        qint32 value;
+        in >> value;
+        *jointIndex = value;
+    }
+    readRaw(in, geometry.leftEyeSize);
+    readRaw(in, geometry.rightEyeSize);
+    readArray(in, geometry.humanIKJointIndices);
+    readRaw(in, geometry.palmDirection);
+    readList(in, geometry.sittingPoints, &readSittingPoint);
+    readRaw(in, geometry.neckPivot);
+    readRaw(in, geometry.bindExtents);
+    readRaw(in, geometry.meshExtents);
+    readList(in, geometry.animationFrames, &readAnimationFrame);
+    in >> geometry.meshIndicesToModelNames >> geometry.blendshapeChannelNames;
+
+    if (in.status() != QDataStream::Ok) {
+        qCDebug(modelformat) << "Truncated cached geometry for" << url;
+        delete geometryPtr;
+        return nullptr;
+    }
+    return geometryPtr;
+}
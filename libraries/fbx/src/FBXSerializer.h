@@ -0,0 +1,30 @@
+//
+//  FBXSerializer.h
+//  libraries/fbx/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXSerializer_h
+#define hifi_FBXSerializer_h
+
+#include <QByteArray>
+#include <QString>
+
+class FBXGeometry;
+
+/// The geometry the readers extract, as a binary blob to load back without parsing the model again. The arrays are
+/// laid out as they are in memory, so loading them is a copy out of the (mapped) blob.
+class FBXSerializer {
+public:
+    static QByteArray write(const FBXGeometry& geometry);
+
+    /// Reads the geometry back with the meshes and materials built, null if the blob is from another version or
+    /// truncated.
+    static FBXGeometry* read(const QByteArray& data, const QString& url);
+};
+
+#endif // hifi_FBXSerializer_h
@@ -125,6 +125,12 @@ public:
         return result;
     }
     
+    // True while a submitted resource hasn't been fetched yet, including one whose fence hasn't signaled
+    bool hasPendingSubmits() {
+        Lock lock(_mutex);
+        return !_submits.empty();
+    }
+
     // If fetch returns a non-zero value, it's the responsibility of the
     // client to release it at some point
     void release(T t, GLsync readSync = 0) {
@@ -334,7 +334,8 @@ void OffscreenQmlSurface::create(QOpenGLContext* shareContext) {
     }
 
     // When Quick says there is a need to render, we will not render immediately. Instead,
-    // a timer with a small interval is used to get better performance.
+    // a timer with a small interval is used to get better performance.  The timer only runs
+    // while there is something to render or a rendered texture to hand over, see updateQuick()
     _updateTimer.setInterval(MIN_TIMER_MS);
     connect(&_updateTimer, &QTimer::timeout, this, &OffscreenQmlSurface::updateQuick);
     _updateTimer.start();
@@ -390,10 +391,18 @@ QObject* OffscreenQmlSurface::load(const QUrl& qmlSource, std::function<void(QQm
 void OffscreenQmlSurface::requestUpdate() {
     _polish = true;
     _render = true;
+    wakeUpdateTimer();
 }
 
 void OffscreenQmlSurface::requestRender() {
     _render = true;
+    wakeUpdateTimer();
+}
+
+void OffscreenQmlSurface::wakeUpdateTimer() {
+    if (!_updateTimer.isActive()) {
+        _updateTimer.start();
+    }
 }
 
 QObject* OffscreenQmlSurface::finishQmlLoad(std::function<void(QQmlContext*, QObject*)> f) {
@@ -457,6 +466,14 @@ void OffscreenQmlSurface::updateQuick() {
         return;
     }
 
+#ifndef QML_THREADED
+    // a paused surface neither polishes nor renders, it stops polling until it is resumed
+    if (_paused) {
+        _updateTimer.stop();
+        return;
+    }
+#endif
+
     if (_polish) {
         _renderer->_renderControl->polishItems();
         _polish = false;
@@ -479,6 +496,14 @@ void OffscreenQmlSurface::updateQuick() {
         _currentTexture = newTexture;
         emit textureUpdated(_currentTexture);
     }
+
+#ifndef QML_THREADED
+    // An idle surface, one whose scene hasn't changed and whose last texture has been handed over,
+    // stops polling until Quick asks for another render, so the surfaces that aren't changing cost nothing
+    if (!_polish && !_render && !_renderer->_escrow.hasPendingSubmits()) {
+        _updateTimer.stop();
+    }
+#endif
 }
 
 QPointF OffscreenQmlSurface::mapWindowToUi(const QPointF& sourcePosition, QObject* sourceObject) {
@@ -597,6 +622,51 @@ bool OffscreenQmlSurface::isPaused() const {
     return _paused;
 }
 
+uint32_t OffscreenQmlSurface::copyCurrentTexture() const {
+    if (!_currentTexture) {
+        return 0;
+    }
+
+    // leave the bindings as we found them, whoever is rendering with this context keeps track of them
+    GLint previousTexture = 0;
+    GLint previousReadFramebuffer = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+
+    GLint width = 0;
+    GLint height = 0;
+    glBindTexture(GL_TEXTURE_2D, _currentTexture);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+
+    GLuint framebuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _currentTexture, 0);
+
+    // a single level, so sampling it doesn't depend on mips it doesn't have
+    GLuint copy = 0;
+    glGenTextures(1, &copy);
+    glBindTexture(GL_TEXTURE_2D, copy);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    glBindTexture(GL_TEXTURE_2D, previousTexture);
+
+    return copy;
+}
+
+void OffscreenQmlSurface::deleteTextureCopy(uint32_t texture) {
+    if (texture) {
+        glDeleteTextures(1, &texture);
+    }
+}
+
 void OffscreenQmlSurface::setProxyWindow(QWindow* window) {
     _renderer->_renderControl->_renderWindow = window;
 }
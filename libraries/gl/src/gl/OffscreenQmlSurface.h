@@ -56,6 +56,11 @@ public:
     void resume();
     bool isPaused() const;
 
+    // a copy of the last texture handed over, that outlives the surface - 0 if none was
+    // must be called, and the copy deleted, with a context current that shares with the one the surface was created with
+    uint32_t copyCurrentTexture() const;
+    static void deleteTextureCopy(uint32_t texture);
+
     void setBaseUrl(const QUrl& baseUrl);
     QQuickItem* getRootItem();
     QQuickWindow* getWindow();
@@ -75,6 +80,7 @@ public slots:
 private:
     QObject* finishQmlLoad(std::function<void(QQmlContext*, QObject*)> f);
     QPointF mapWindowToUi(const QPointF& sourcePosition, QObject* sourceObject);
+    void wakeUpdateTimer();
 
 private slots:
     void updateQuick();
@@ -55,6 +55,15 @@ Batch::Batch(const CacheState& cacheState) : Batch() {
     _commandOffsets.reserve(cacheState.offsetsSize);
     _params.reserve(cacheState.paramsSize);
     _data.reserve(cacheState.dataSize);
+
+    // the objects grow with the commands, they're as big as in the last batch too
+    _buffers.reserve(cacheState.buffersSize);
+    _textures.reserve(cacheState.texturesSize);
+    _streamFormats.reserve(cacheState.streamFormatsSize);
+    _transforms.reserve(cacheState.transformsSize);
+    _pipelines.reserve(cacheState.pipelinesSize);
+    _framebuffers.reserve(cacheState.framebuffersSize);
+    _queries.reserve(cacheState.queriesSize);
 }
 
 Batch::CacheState Batch::getCacheState() {
@@ -78,6 +87,7 @@ void Batch::clear() {
     _transforms.clear();
     _pipelines.clear();
     _framebuffers.clear();
+    _batches.clear();
 }
 
 uint32 Batch::cacheData(uint32 size, const void* data) {
@@ -345,6 +355,30 @@ void Batch::runLambda(std::function<void()> f) {
     _params.push_back(_lambdas.cache(f));
 }
 
+void Batch::executeBatch(const std::shared_ptr<Batch>& batch) {
+    assert(batch.get() != this);
+    // the named calls of the retained batch become its commands once, when it's first executed
+    batch->preExecute();
+
+    ADD_COMMAND(executeBatch);
+    _params.push_back(_batches.cache(batch));
+}
+
+void Batch::patchModelTransform(size_t commandIndex, const Transform& model) {
+    assert(_commands[commandIndex] == COMMAND_setModelTransform);
+    _transforms._items[_params[_commandOffsets[commandIndex]]._uint]._data = model;
+}
+
+void Batch::patchViewTransform(size_t commandIndex, const Transform& view) {
+    assert(_commands[commandIndex] == COMMAND_setViewTransform);
+    _transforms._items[_params[_commandOffsets[commandIndex]]._uint]._data = view;
+}
+
+void Batch::patchProjectionTransform(size_t commandIndex, const Mat4& proj) {
+    assert(_commands[commandIndex] == COMMAND_setProjectionTransform);
+    memcpy(editData(_params[_commandOffsets[commandIndex]]._uint), &proj, sizeof(Mat4));
+}
+
 void Batch::enableStereo(bool enable) {
     _enableStereo = enable;
 }
@@ -41,6 +41,7 @@ namespace gpu {
 enum ReservedSlot {
     TRANSFORM_OBJECT_SLOT = 6,
     TRANSFORM_CAMERA_SLOT = 7,
+    TRANSFORM_STEREO_CAMERA_SLOT = 8, // the camera of the right eye, when the eyes are instanced
 };
 
 // The named batch data provides a mechanism for accumulating data into buffers over the course 
@@ -229,6 +230,17 @@ public:
     // Reset the stage caches and states
     void resetStages();
 
+    // Run the commands of a batch recorded once, for what looks the same from a frame to the next. The retained batch
+    // keeps its own caches and is not recorded again, only patched; the transforms it sets stay set after it.
+    // It runs with the patches it has when this batch is rendered, and must not execute itself.
+    void executeBatch(const std::shared_ptr<Batch>& batch);
+
+    // Patch the recorded transform commands of a retained batch, the index is the size of getCommands() just before
+    // the command was recorded
+    void patchModelTransform(size_t commandIndex, const Transform& model);
+    void patchViewTransform(size_t commandIndex, const Transform& view);
+    void patchProjectionTransform(size_t commandIndex, const Mat4& proj);
+
     // Debugging
     void pushProfileRange(const char* name);
     void popProfileRange();
@@ -311,6 +323,8 @@ public:
 
         COMMAND_runLambda,
 
+        COMMAND_executeBatch,
+
         // TODO: As long as we have gl calls explicitely issued from interface
         // code, we need to be able to record and batch these calls. THe long 
         // term strategy is to get rid of any GL calls in favor of the HIFI GPU API
@@ -370,6 +384,7 @@ public:
             std::vector< Cache<T> > _items;
 
             size_t size() const { return _items.size(); }
+            void reserve(size_t size) { _items.reserve(size); }
             uint32 cache(const Data& data) {
                 uint32 offset = _items.size();
                 _items.push_back(Cache<T>(data));
@@ -398,6 +413,7 @@ public:
     typedef Cache<QueryPointer>::Vector QueryCaches;
     typedef Cache<std::string>::Vector ProfileRangeCaches;
     typedef Cache<std::function<void()>>::Vector LambdaCache;
+    typedef Cache<std::shared_ptr<Batch>>::Vector BatchCaches;
 
     // Cache Data in a byte array if too big to fit in Param
     // FOr example Mat4s are going there
@@ -425,6 +441,7 @@ public:
     QueryCaches _queries;
     LambdaCache _lambdas;
     ProfileRangeCaches _profileRanges;
+    BatchCaches _batches;
 
     NamedBatchDataMap _namedData;
 
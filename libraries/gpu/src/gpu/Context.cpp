@@ -48,6 +48,14 @@ bool Context::isStereo() {
     return _backend->isStereo();
 }
 
+void Context::enableInstancedStereo(bool enable) {
+    _backend->enableInstancedStereo(enable);
+}
+
+bool Context::isInstancedStereo() {
+    return _backend->isInstancedStereo();
+}
+
 void Context::setStereoProjections(const mat4 eyeProjections[2]) {
     _backend->setStereoProjections(eyeProjections);
 }
@@ -94,6 +102,14 @@ Backend::TransformCamera Backend::TransformCamera::getEyeCamera(int eye, const S
         result._view = skyboxView * result._view;
     }
     result._projection = _stereo._eyeProjections[eye];
+    if (_stereo._instancedPass) {
+        // The viewport covers both eyes then, each is drawn in its half
+        result._viewport.z *= 0.5f;
+        if (eye) {
+            result._viewport.x += result._viewport.z;
+        }
+        result._stereoInfo = Vec4(1.0f, (float)eye, 0.0f, 0.0f);
+    }
     result.recomputeDerived();
     return result;
 }
@@ -32,6 +32,10 @@ struct StereoState {
     bool _skybox{ false };
     // 0 for left eye, 1 for right eye
     uint8_t _pass{ 0 };
+    // Draw the eyes as two instances of every draw in one pass over the batch, rather than running the batch for each
+    bool _instanced{ false };
+    // The batch being rendered has its eyes instanced, which only the batches whose programs all support it do
+    bool _instancedPass{ false };
     mat4 _eyeViews[2];
     mat4 _eyeProjections[2];
 };
@@ -49,6 +53,14 @@ public:
         return _stereo._enable;
     }
 
+    virtual void enableInstancedStereo(bool enable) {
+        _stereo._instanced = enable;
+    }
+
+    virtual bool isInstancedStereo() {
+        return _stereo._instanced;
+    }
+
     void setStereoProjections(const mat4 eyeProjections[2]) {
         for (int i = 0; i < 2; ++i) {
             _stereo._eyeProjections[i] = eyeProjections[i];
@@ -92,6 +104,7 @@ public:
         Mat4 _projection;
         mutable Mat4 _projectionInverse;
         Vec4 _viewport; // Public value is int but float in the shader to stay in floats for all the transform computations.
+        Vec4 _stereoInfo; // x is 1 when the eyes are instanced, y is the eye
 
         const Backend::TransformCamera& recomputeDerived() const;
         TransformCamera getEyeCamera(int eye, const StereoState& stereo) const;
@@ -186,6 +199,8 @@ public:
     void render(Batch& batch);
     void enableStereo(bool enable = true);
     bool isStereo();
+    void enableInstancedStereo(bool enable = true);
+    bool isInstancedStereo();
     void setStereoProjections(const mat4 eyeProjections[2]);
     void setStereoViews(const mat4 eyeViews[2]);
     void getStereoProjections(mat4* eyeProjections) const;
@@ -181,6 +181,11 @@ enum Semantic {
     SAMPLER,
     SAMPLER_MULTISAMPLE,
     SAMPLER_SHADOW,
+
+    // Texel formats compressed in blocks of 4x4 texels
+    COMPRESSED_BC1_RGB,
+    COMPRESSED_BC3_RGBA,
+    COMPRESSED_BC5_XY,
   
  
     NUM_SEMANTICS,
@@ -220,6 +225,10 @@ public:
 
     uint16 getRaw() const { return *((uint16*) (this)); }
 
+    // The compressed formats go by blocks of 4x4 texels, the size of an element doesn't apply to them
+    bool isCompressed() const { return (getSemantic() >= COMPRESSED_BC1_RGB) && (getSemantic() <= COMPRESSED_BC5_XY); }
+    uint32 getCompressedBlockSize() const { return (getSemantic() == COMPRESSED_BC1_RGB ? 8 : 16); }
+
     
     bool operator ==(const Element& right) const {
         return getRaw() == right.getRaw();
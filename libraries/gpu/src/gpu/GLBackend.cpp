@@ -61,6 +61,8 @@ GLBackend::CommandCall GLBackend::_commandCalls[Batch::NUM_COMMANDS] =
 
     (&::gpu::GLBackend::do_runLambda),
 
+    (&::gpu::GLBackend::do_executeBatch),
+
     (&::gpu::GLBackend::do_glActiveBindTexture),
 
     (&::gpu::GLBackend::do_glUniform1i),
@@ -138,10 +140,6 @@ GLBackend::~GLBackend() {
 }
 
 void GLBackend::renderPassTransfer(Batch& batch) {
-    const size_t numCommands = batch.getCommands().size();
-    const Batch::Commands::value_type* command = batch.getCommands().data();
-    const Batch::CommandOffsets::value_type* offset = batch.getCommandOffsets().data();
-
     { // Sync all the buffers
         PROFILE_RANGE("syncGPUBuffer");
 
@@ -159,30 +157,8 @@ void GLBackend::renderPassTransfer(Batch& batch) {
         _transform._objects.resize(0);
         _transform._objectOffsets.clear();
 
-        for (_commandIndex = 0; _commandIndex < numCommands; ++_commandIndex) {
-            switch (*command) {
-            case Batch::COMMAND_draw:
-            case Batch::COMMAND_drawIndexed:
-            case Batch::COMMAND_drawInstanced:
-            case Batch::COMMAND_drawIndexedInstanced:
-                _transform.preUpdate(_commandIndex, _stereo);
-                break;
-
-            case Batch::COMMAND_setModelTransform:
-            case Batch::COMMAND_setViewportTransform:
-            case Batch::COMMAND_setViewTransform:
-            case Batch::COMMAND_setProjectionTransform: {
-                CommandCall call = _commandCalls[(*command)];
-                (this->*(call))(batch, *offset);
-                break;
-            }
-
-            default:
-                break;
-            }
-            command++;
-            offset++;
-        }
+        _commandIndex = 0;
+        transferBatchTransforms(batch);
     }
 
     { // Sync the transform buffers
@@ -191,13 +167,65 @@ void GLBackend::renderPassTransfer(Batch& batch) {
     }
 }
 
+// The command index runs on through the retained batches, the same way in both passes, so that the transforms
+// of their draws are found again in the draw pass
+void GLBackend::transferBatchTransforms(Batch& batch) {
+    const size_t numCommands = batch.getCommands().size();
+    const Batch::Commands::value_type* command = batch.getCommands().data();
+    const Batch::CommandOffsets::value_type* offset = batch.getCommandOffsets().data();
+
+    for (size_t i = 0; i < numCommands; ++i) {
+        switch (*command) {
+        case Batch::COMMAND_draw:
+        case Batch::COMMAND_drawIndexed:
+        case Batch::COMMAND_drawInstanced:
+        case Batch::COMMAND_drawIndexedInstanced:
+            _transform.preUpdate(_commandIndex, _stereo);
+            break;
+
+        case Batch::COMMAND_setModelTransform:
+        case Batch::COMMAND_setViewportTransform:
+        case Batch::COMMAND_setViewTransform:
+        case Batch::COMMAND_setProjectionTransform: {
+            CommandCall call = _commandCalls[(*command)];
+            (this->*(call))(batch, *offset);
+            break;
+        }
+
+        case Batch::COMMAND_executeBatch: {
+            auto retained = batch._batches.get(batch._params[*offset]._uint);
+            if (retained) {
+                for (auto& cached : retained->_buffers._items) {
+                    if (cached._data) {
+                        syncGPUObject(*cached._data);
+                    }
+                }
+                transferBatchTransforms(*retained);
+            }
+            break;
+        }
+
+        default:
+            break;
+        }
+        _commandIndex++;
+        command++;
+        offset++;
+    }
+}
+
 void GLBackend::renderPassDraw(Batch& batch) {
     _transform._objectsItr = _transform._objectOffsets.begin();
     _transform._camerasItr = _transform._cameraOffsets.begin();
+    _commandIndex = 0;
+    drawBatch(batch);
+}
+
+void GLBackend::drawBatch(Batch& batch) {
     const size_t numCommands = batch.getCommands().size();
     const Batch::Commands::value_type* command = batch.getCommands().data();
     const Batch::CommandOffsets::value_type* offset = batch.getCommandOffsets().data();
-    for (_commandIndex = 0; _commandIndex < numCommands; ++_commandIndex) {
+    for (size_t i = 0; i < numCommands; ++i) {
         switch (*command) {
             // Ignore these commands on this pass, taken care of in the transfer pass
             // Note we allow COMMAND_setViewportTransform to occur in both passes
@@ -215,11 +243,35 @@ void GLBackend::renderPassDraw(Batch& batch) {
             }
         }
 
+        _commandIndex++;
         command++;
         offset++;
     }
 }
 
+bool GLBackend::canInstanceStereo(const Batch& batch) {
+    for (auto& cached : batch._batches._items) {
+        if (cached._data && !canInstanceStereo(*cached._data)) {
+            return false;
+        }
+    }
+    // the commands of the indirect draws hold their instance counts, which can't be doubled for the eyes
+    for (auto command : batch.getCommands()) {
+        if (command == Batch::COMMAND_multiDrawIndirect || command == Batch::COMMAND_multiDrawIndexedIndirect) {
+            return false;
+        }
+    }
+    for (auto& cached : batch._pipelines._items) {
+        if (cached._data) {
+            GLPipeline* pipeline = syncGPUObject(*cached._data);
+            if (!pipeline || !pipeline->_program || !pipeline->_program->_isStereoInstanceable) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 void GLBackend::render(Batch& batch) {
     // Finalize the batch by moving all the instanced rendering into the command buffer
     batch.preExecute();
@@ -232,21 +284,36 @@ void GLBackend::render(Batch& batch) {
         _stereo._enable = false;
     }
 
+    // The eyes are instanced in a single pass over the batch when all its programs can place them, or the batch runs
+    // once for each eye. The instance divisors change with the pass, so the input format is set again then.
+    bool instancedPass = _stereo._enable && _stereo._instanced && canInstanceStereo(batch);
+    if (instancedPass != _stereo._instancedPass) {
+        _stereo._instancedPass = instancedPass;
+        _input._invalidFormat = true;
+    }
+
     {
         PROFILE_RANGE("Transfer");
         renderPassTransfer(batch);
     }
 
-    {
-        PROFILE_RANGE(_stereo._enable ? "LeftRender" : "Render");
+    if (_stereo._instancedPass) {
+        PROFILE_RANGE("InstancedStereoRender");
+        glEnable(GL_CLIP_DISTANCE0);
         renderPassDraw(batch);
-    }
+        glDisable(GL_CLIP_DISTANCE0);
+    } else {
+        {
+            PROFILE_RANGE(_stereo._enable ? "LeftRender" : "Render");
+            renderPassDraw(batch);
+        }
 
-    if (_stereo._enable) {
-        PROFILE_RANGE("RightRender");
-        _stereo._pass = 1;
-        renderPassDraw(batch);
-        _stereo._pass = 0;
+        if (_stereo._enable) {
+            PROFILE_RANGE("RightRender");
+            _stereo._pass = 1;
+            renderPassDraw(batch);
+            _stereo._pass = 0;
+        }
     }
 
     // Restore the saved stereo state for the next batch
@@ -296,6 +363,11 @@ bool GLBackend::checkGLErrorDebug(const char* name) {
 }
 
 void GLBackend::syncCache() {
+    // Each frame starts by syncing the cache, the textures streaming in get a new budget
+    // and the ones out of use for a while may give back their memory
+    resetTextureUploadBudget();
+    updateTextureResidency();
+
     syncTransformStateCache();
     syncPipelineStateCache();
     syncInputStateCache();
@@ -313,7 +385,11 @@ void GLBackend::do_draw(Batch& batch, uint32 paramOffset) {
     GLenum mode = _primitiveToGLmode[primitiveType];
     uint32 numVertices = batch._params[paramOffset + 1]._uint;
     uint32 startVertex = batch._params[paramOffset + 0]._uint;
-    glDrawArrays(mode, startVertex, numVertices);
+    if (_stereo._instancedPass) {
+        glDrawArraysInstancedARB(mode, startVertex, numVertices, 2);
+    } else {
+        glDrawArrays(mode, startVertex, numVertices);
+    }
     (void) CHECK_GL_ERROR();
 }
 
@@ -332,7 +408,11 @@ void GLBackend::do_drawIndexed(Batch& batch, uint32 paramOffset) {
     auto typeByteSize = TYPE_SIZE[_input._indexBufferType];
     GLvoid* indexBufferByteOffset = reinterpret_cast<GLvoid*>(startIndex * typeByteSize + _input._indexBufferOffset);
 
-    glDrawElements(mode, numIndices, glType, indexBufferByteOffset);
+    if (_stereo._instancedPass) {
+        glDrawElementsInstanced(mode, numIndices, glType, indexBufferByteOffset, 2);
+    } else {
+        glDrawElements(mode, numIndices, glType, indexBufferByteOffset);
+    }
     (void) CHECK_GL_ERROR();
 }
 
@@ -347,6 +427,11 @@ void GLBackend::do_drawInstanced(Batch& batch, uint32 paramOffset) {
     uint32 numVertices = batch._params[paramOffset + 2]._uint;
     uint32 startVertex = batch._params[paramOffset + 1]._uint;
 
+    // both eyes of each instance, which the doubled divisors of the instance attributes share
+    if (_stereo._instancedPass) {
+        numInstances *= 2;
+    }
+
     glDrawArraysInstancedARB(mode, startVertex, numVertices, numInstances);
     (void) CHECK_GL_ERROR();
 }
@@ -367,6 +452,10 @@ void GLBackend::do_drawIndexedInstanced(Batch& batch, uint32 paramOffset) {
 
     auto typeByteSize = TYPE_SIZE[_input._indexBufferType];
     GLvoid* indexBufferByteOffset = reinterpret_cast<GLvoid*>(startIndex * typeByteSize + _input._indexBufferOffset);
+
+    if (_stereo._instancedPass) {
+        numInstances *= 2;
+    }
     
 #if (GPU_INPUT_PROFILE == GPU_CORE_43)
     glDrawElementsInstancedBaseVertexBaseInstance(mode, numIndices, glType, indexBufferByteOffset, numInstances, 0, startInstance);
@@ -422,6 +511,13 @@ void GLBackend::do_runLambda(Batch& batch, uint32 paramOffset) {
     f();
 }
 
+void GLBackend::do_executeBatch(Batch& batch, uint32 paramOffset) {
+    auto retained = batch._batches.get(batch._params[paramOffset]._uint);
+    if (retained) {
+        drawBatch(*retained);
+    }
+}
+
 void GLBackend::resetStages() {
     resetInputStage();
     resetPipelineStage();
@@ -11,6 +11,7 @@
 #ifndef hifi_gpu_GLBackend_h
 #define hifi_gpu_GLBackend_h
 
+#include <algorithm>
 #include <assert.h>
 #include <functional>
 #include <bitset>
@@ -64,6 +65,7 @@ public:
         Stamp _stamp;
         GLuint _buffer;
         GLuint _size;
+        GLuint _capacity; // the bytes allocated in the bo, more than the size once the buffer grew
 
         GLBuffer();
         ~GLBuffer();
@@ -73,13 +75,26 @@ public:
 
     class GLTexture : public GPUObject {
     public:
+        const Texture& _gpuTexture;
         Stamp _storageStamp;
         Stamp _contentStamp;
         GLuint _texture;
         GLenum _target;
         GLuint _size;
 
-        GLTexture();
+        // The next mip to upload when the texture streams in from its smallest mip, -1 once all are in
+        int _pendingMip;
+
+        // The first mip kept in the GPU memory, above 0 when the top mips got dropped to stay under the memory budget
+        uint16 _residentMip;
+
+        // The frame the texture was last synced for rendering
+        uint32 _lastUsedFrame;
+
+        // Track the GPU memory of the texture, _size tells the bytes currently allocated
+        void setSize(GLuint size);
+
+        GLTexture(const Texture& texture);
         ~GLTexture();
     };
     static GLTexture* syncGPUObject(const Texture& texture);
@@ -88,6 +103,16 @@ public:
     // very specific for now
     static void syncSampler(const Sampler& sampler, Texture::Type type, GLTexture* object);
 
+    // Upload the pending mips of the texture down from the smallest, as long as the upload budget of the frame allows
+    static void uploadPendingMips(const Texture& texture, GLTexture* object);
+    static void resetTextureUploadBudget();
+
+    // Drop the top mips of the textures unused for the longest while the texture memory is over the budget,
+    // they come back through uploadPendingMips the next time the texture is rendered
+    static void updateTextureResidency();
+    static void dropTopMips(const Texture& texture, GLTexture* object);
+    static void restoreDroppedMips(const Texture& texture, GLTexture* object);
+
     class GLShader : public GPUObject {
     public:
         GLuint _shader;
@@ -95,6 +120,10 @@ public:
 
         GLint _transformCameraSlot = -1;
         GLint _transformObjectSlot = -1;
+        GLint _transformStereoCameraSlot = -1;
+
+        // The vertex shader places the eyes of instanced stereo, and the pixel shader doesn't depend on the eye
+        bool _isStereoInstanceable = false;
 
         GLShader();
         ~GLShader();
@@ -184,6 +213,7 @@ public:
     public:
         GLuint _qo = 0;
         GLuint64 _result = 0;
+        bool _isIssued = false;
 
         GLQuery();
         ~GLQuery();
@@ -244,6 +274,11 @@ public:
 protected:
     void renderPassTransfer(Batch& batch);
     void renderPassDraw(Batch& batch);
+    void transferBatchTransforms(Batch& batch);
+    void drawBatch(Batch& batch);
+
+    // True if all the programs of the batch can draw the eyes instanced
+    bool canInstanceStereo(const Batch& batch);
 
     Stats _stats;
 
@@ -353,9 +388,32 @@ protected:
         mutable List::const_iterator _objectsItr;
         mutable List::const_iterator _camerasItr;
 
+        // With GL 4.4 the cameras and objects get written straight into a persistently mapped ring buffer. Each batch
+        // takes the next range of the current segment, and a segment gets reused once the fence issued when leaving it
+        // is signaled.
+        static const int NUM_RING_SEGMENTS = 3;
+        static const size_t RING_SEGMENT_SIZE = 4 * 1024 * 1024;
+        GLuint _ringBuffer{ 0 };
+        Byte* _ringData{ nullptr };
+        GLsync _ringFences[NUM_RING_SEGMENTS];
+        int _ringSegment{ 0 };
+        size_t _ringOffset{ 0 }; // in the current segment
+
+        // Where the last transfer put the cameras and the objects
+        GLuint _boundCameraBuffer{ 0 };
+        GLuint _boundObjectBuffer{ 0 };
+        size_t _cameraBufferOffset{ 0 };
+        size_t _objectBufferOffset{ 0 };
+
+        TransformStageState() { std::fill(_ringFences, _ringFences + NUM_RING_SEGMENTS, (GLsync)0); }
+
+        void initRingBuffer();
+        void killRingBuffer();
+        bool transferToRingBuffer(size_t camerasSize, size_t objectsSize);
+
         void preUpdate(size_t commandIndex, const StereoState& stereo);
         void update(size_t commandIndex, const StereoState& stereo) const;
-        void transfer() const;
+        void transfer();
     } _transform;
 
     int32_t _uboAlignment{ 0 };
@@ -460,6 +518,8 @@ protected:
 
     void do_runLambda(Batch& batch, uint32 paramOffset);
 
+    void do_executeBatch(Batch& batch, uint32 paramOffset);
+
     void resetStages();
 
     // TODO: As long as we have gl calls explicitely issued from interface
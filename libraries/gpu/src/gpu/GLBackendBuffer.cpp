@@ -15,7 +15,8 @@ using namespace gpu;
 GLBackend::GLBuffer::GLBuffer() :
     _stamp(0),
     _buffer(0),
-    _size(0)
+    _size(0),
+    _capacity(0)
 {}
 
 GLBackend::GLBuffer::~GLBuffer() {
@@ -39,15 +40,43 @@ GLBackend::GLBuffer* GLBackend::syncGPUObject(const Buffer& buffer) {
         Backend::setGPUObject(buffer, object);
     }
 
-    // Now let's update the content of the bo with the sysmem version
-    // TODO: in the future, be smarter about when to actually upload the glBO version based on the data that did change
-    //if () {
+    // Now let's update the content of the bo with the sysmem version, only the ranges that did change if we know them
+    const Resource::Sysmem& sysmem = buffer.getSysmem();
+    Resource::Size size = sysmem.getSize();
+    std::vector<Buffer::Range> dirtyRanges;
+    bool isPartial = (object->_capacity > 0) && (size <= object->_capacity) &&
+        buffer.getDirtyRangesSince(object->_stamp, dirtyRanges);
+
     glBindBuffer(GL_ARRAY_BUFFER, object->_buffer);
-    glBufferData(GL_ARRAY_BUFFER, buffer.getSysmem().getSize(), buffer.getSysmem().readData(), GL_DYNAMIC_DRAW);
+    int64_t bytesUploaded = 0;
+    if (isPartial) {
+        for (const auto& range : dirtyRanges) {
+            glBufferSubData(GL_ARRAY_BUFFER, range._offset, range._size, sysmem.readData() + range._offset);
+            bytesUploaded += range._size;
+        }
+    } else if (size > 0 && size <= object->_capacity && object->_capacity / 2 < size) {
+        // the bo still fits without wasting much of it
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, sysmem.readData());
+        bytesUploaded = size;
+    } else {
+        GLuint capacity = size;
+        if (object->_capacity > 0 && size > object->_capacity) {
+            // a buffer that grows is likely to grow again, leave room for the next appends
+            capacity = std::max<GLuint>(size, object->_capacity + object->_capacity / 2);
+        }
+        if (capacity == size) {
+            glBufferData(GL_ARRAY_BUFFER, size, sysmem.readData(), GL_DYNAMIC_DRAW);
+        } else {
+            glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, sysmem.readData());
+        }
+        object->_capacity = capacity;
+        bytesUploaded = size;
+    }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    object->_stamp = buffer.getSysmem().getStamp();
-    object->_size = buffer.getSysmem().getSize();
-    //}
+    object->_stamp = sysmem.getStamp();
+    object->_size = size;
+    Buffer::updateBufferGPUBytesUploaded(bytesUploaded);
     (void) CHECK_GL_ERROR();
 
     return object;
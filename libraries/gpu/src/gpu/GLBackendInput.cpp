@@ -120,7 +120,7 @@ void GLBackend::updateInput() {
                     glVertexAttribFormat(slot + locNum, count, type, isNormalized, offset + locNum * perLocationSize);
                     glVertexAttribBinding(slot + locNum, attrib._channel);
                 }
-                glVertexBindingDivisor(attrib._channel, attrib._frequency);
+                glVertexBindingDivisor(attrib._channel, attrib._frequency * (_stereo._instancedPass ? 2 : 1));
             }
             (void) CHECK_GL_ERROR();
         }
@@ -239,7 +239,8 @@ void GLBackend::updateInput() {
                             for (size_t locNum = 0; locNum < locationCount; ++locNum) {
                                 glVertexAttribPointer(slot + locNum, count, type, isNormalized, stride,
                                     reinterpret_cast<GLvoid*>(pointer + perLocationStride * locNum));
-                                glVertexAttribDivisor(slot + locNum, attrib._frequency);
+                                // each instance is drawn once for each eye in an instanced stereo pass
+                                glVertexAttribDivisor(slot + locNum, attrib._frequency * (_stereo._instancedPass ? 2 : 1));
                             }
                             
                             // TODO: Support properly the IAttrib version
@@ -245,8 +245,9 @@ void GLBackend::do_setResourceTexture(Batch& batch, uint32 paramOffset) {
         releaseResourceTexture(slot);
         return;
     }
-    // check cache before thinking
+    // check cache before thinking, the sync still keeps the bound texture streaming in and resident
     if (_resource._textures[slot] == resourceTexture) {
+        GLBackend::syncGPUObject(*resourceTexture);
         return;
     }
 
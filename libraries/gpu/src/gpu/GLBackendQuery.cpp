@@ -60,16 +60,29 @@ GLuint GLBackend::getQueryID(const QueryPointer& query) {
     }
 }
 
+// The target of the queries of the type
+static GLenum getQueryTarget(Query::Type type) {
+    if (type == Query::ANY_SAMPLES_PASSED) {
+        #if (GPU_FEATURE_PROFILE == GPU_LEGACY)
+            return GL_SAMPLES_PASSED;
+        #else
+            return GL_ANY_SAMPLES_PASSED;
+        #endif
+    }
+    #if (GPU_FEATURE_PROFILE == GPU_LEGACY)
+        // (EXT_TIMER_QUERY)
+        return GL_TIME_ELAPSED_EXT;
+    #else
+        return GL_TIME_ELAPSED;
+    #endif
+}
+
 void GLBackend::do_beginQuery(Batch& batch, uint32 paramOffset) {
     auto query = batch._queries.get(batch._params[paramOffset]._uint);
     GLQuery* glquery = syncGPUObject(*query);
     if (glquery) {
-        #if (GPU_FEATURE_PROFILE == GPU_LEGACY)
-            // (EXT_TIMER_QUERY)
-            glBeginQuery(GL_TIME_ELAPSED_EXT, glquery->_qo);
-        #else
-            glBeginQuery(GL_TIME_ELAPSED, glquery->_qo);
-        #endif
+        glBeginQuery(getQueryTarget(query->getType()), glquery->_qo);
+        glquery->_isIssued = true;
         (void)CHECK_GL_ERROR();
     }
 }
@@ -78,12 +91,7 @@ void GLBackend::do_endQuery(Batch& batch, uint32 paramOffset) {
     auto query = batch._queries.get(batch._params[paramOffset]._uint);
     GLQuery* glquery = syncGPUObject(*query);
     if (glquery) {
-        #if (GPU_FEATURE_PROFILE == GPU_LEGACY)
-            // (EXT_TIMER_QUERY)
-            glEndQuery(GL_TIME_ELAPSED_EXT);
-        #else
-            glEndQuery(GL_TIME_ELAPSED);
-        #endif
+        glEndQuery(getQueryTarget(query->getType()));
         (void)CHECK_GL_ERROR();
     }
 }
@@ -91,7 +99,21 @@ void GLBackend::do_endQuery(Batch& batch, uint32 paramOffset) {
 void GLBackend::do_getQuery(Batch& batch, uint32 paramOffset) {
     auto query = batch._queries.get(batch._params[paramOffset]._uint);
     GLQuery* glquery = syncGPUObject(*query);
-    if (glquery) { 
+    if (glquery && query->getType() != Query::TIMER) {
+        // only poll, the result of a query that never began or is still in flight stays pending
+        GLuint available = GL_FALSE;
+        if (glquery->_isIssued) {
+            glGetQueryObjectuiv(glquery->_qo, GL_QUERY_RESULT_AVAILABLE, &available);
+        }
+        if (available) {
+            GLuint result = 0;
+            glGetQueryObjectuiv(glquery->_qo, GL_QUERY_RESULT, &result);
+            glquery->_result = result;
+            query->queryResult = result;
+            query->isResultReady = true;
+        }
+        (void)CHECK_GL_ERROR();
+    } else if (glquery) { 
         #if (GPU_FEATURE_PROFILE == GPU_LEGACY)
             // (EXT_TIMER_QUERY)
             #if !defined(Q_OS_LINUX)
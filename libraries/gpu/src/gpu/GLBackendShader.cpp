@@ -8,6 +8,13 @@
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
 #include "GLBackendShared.h"
 #include "Format.h"
 
@@ -27,6 +34,8 @@ GLBackend::GLShader::~GLShader() {
     }
 }
 
+void makeUniformBlockBindings(GLBackend::GLShader* shader);
+
 void makeBindings(GLBackend::GLShader* shader) {
     if(!shader || !shader->_program) {
         return;
@@ -90,6 +99,13 @@ void makeBindings(GLBackend::GLShader* shader) {
     }
 
     // now assign the ubo binding, then DON't relink!
+    makeUniformBlockBindings(shader);
+}
+
+// The ubo bindings aren't part of a program binary, so the programs loaded from one get them here
+void makeUniformBlockBindings(GLBackend::GLShader* shader) {
+    GLuint glprogram = shader->_program;
+    GLint loc = -1;
 
     //Check for gpu specific uniform slotBindings
     loc = glGetUniformBlockIndex(glprogram, "transformObjectBuffer");
@@ -103,6 +119,12 @@ void makeBindings(GLBackend::GLShader* shader) {
         glUniformBlockBinding(glprogram, loc, gpu::TRANSFORM_CAMERA_SLOT);
         shader->_transformCameraSlot = gpu::TRANSFORM_CAMERA_SLOT;
     }
+
+    loc = glGetUniformBlockIndex(glprogram, "transformStereoCameraBuffer");
+    if (loc >= 0) {
+        glUniformBlockBinding(glprogram, loc, gpu::TRANSFORM_STEREO_CAMERA_SLOT);
+        shader->_transformStereoCameraSlot = gpu::TRANSFORM_STEREO_CAMERA_SLOT;
+    }
 }
 
 GLBackend::GLShader* compileShader(const Shader& shader) {
@@ -124,9 +146,19 @@ GLBackend::GLShader* compileShader(const Shader& shader) {
         return nullptr;
     }
 
-    // Assign the source
-    const GLchar* srcstr = shaderSource.c_str();
-    glShaderSource(glshader, 1, &srcstr, NULL);
+    // Assign the source, with the domain defined right after the version for the code of the shared headers
+    // that only compiles in one of them
+    const std::string SHADER_DOMAIN_DEFINES[2] = { "#define GPU_VERTEX_SHADER\n", "#define GPU_PIXEL_SHADER\n" };
+    size_t versionEnd = shaderSource.find("#version");
+    versionEnd = (versionEnd == std::string::npos) ? 0 : shaderSource.find('\n', versionEnd);
+    versionEnd = (versionEnd == std::string::npos) ? shaderSource.size() : versionEnd + 1;
+    std::string versionSource = shaderSource.substr(0, versionEnd);
+    if (versionEnd == 0 || versionSource.back() != '\n') {
+        versionSource += '\n';
+    }
+    const GLchar* srcstrs[3] = { versionSource.c_str(), SHADER_DOMAIN_DEFINES[shader.getType()].c_str(),
+        shaderSource.c_str() + versionEnd };
+    glShaderSource(glshader, 3, srcstrs, NULL);
 
     // Compile !
     glCompileShader(glshader);
@@ -223,17 +255,142 @@ GLBackend::GLShader* compileShader(const Shader& shader) {
     GLBackend::GLShader* object = new GLBackend::GLShader();
     object->_shader = glshader;
     object->_program = glprogram;
+    object->_isStereoInstanceable = isStereoInstanceable(program);
 
     makeBindings(object);
 
     return object;
 }
 
+// The linked programs are kept on disk as the binaries of the driver, and load from there next time without compiling or
+// linking their shaders again. The key covers the sources and the driver, so a changed shader or driver misses the cache.
+static bool isProgramBinaryCacheSupported() {
+    static bool isSupported = false;
+    static bool isChecked = false;
+    if (!isChecked) {
+        GLint numFormats = 0;
+        if (GLEW_ARB_get_program_binary) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        }
+        isSupported = numFormats > 0;
+        isChecked = true;
+    }
+    return isSupported;
+}
+
+static void addGLString(QCryptographicHash& hash, GLenum name) {
+    const char* value = reinterpret_cast<const char*>(glGetString(name));
+    if (value) {
+        hash.addData(value);
+    }
+}
+
+static QString getProgramBinaryCachePath(const Shader& program) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    addGLString(hash, GL_VENDOR);
+    addGLString(hash, GL_RENDERER);
+    addGLString(hash, GL_VERSION);
+    for (auto subShader : program.getShaders()) {
+        const std::string& shaderSource = subShader->getSource().getCode();
+        hash.addData(QByteArray::number((int)subShader->getType()));
+        hash.addData(shaderSource.data(), (int)shaderSource.size());
+    }
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/shaders/" + hash.result().toHex() + ".bin";
+}
+
+// the program of the cached binary, 0 if there is none or the driver doesn't take it anymore
+static GLuint loadProgramBinary(const QString& cachePath) {
+    QFile cacheFile(cachePath);
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    QByteArray cached = cacheFile.readAll();
+    GLenum format = 0;
+    if (cached.size() <= (int)sizeof(format)) {
+        return 0;
+    }
+    memcpy(&format, cached.constData(), sizeof(format));
+
+    GLuint glprogram = glCreateProgram();
+    if (!glprogram) {
+        return 0;
+    }
+    glProgramBinary(glprogram, format, cached.constData() + sizeof(format), cached.size() - (int)sizeof(format));
+
+    GLint linked = 0;
+    glGetProgramiv(glprogram, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        glDeleteProgram(glprogram);
+        return 0;
+    }
+    return glprogram;
+}
+
+static void saveProgramBinary(GLuint glprogram, const QString& cachePath) {
+    GLint length = 0;
+    glGetProgramiv(glprogram, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    // the binary goes after its format
+    GLenum format = 0;
+    QByteArray cached(sizeof(format) + length, 0);
+    glGetProgramBinary(glprogram, length, nullptr, &format, cached.data() + sizeof(format));
+    memcpy(cached.data(), &format, sizeof(format));
+
+    QSaveFile cacheFile(cachePath);
+    if (QDir().mkpath(QFileInfo(cachePath).path()) && cacheFile.open(QIODevice::WriteOnly)) {
+        cacheFile.write(cached);
+        if (!cacheFile.commit()) {
+            qCDebug(gpulogging) << "GLShader::compileProgram - failed to cache the program binary in" << cachePath;
+        }
+    }
+}
+
+// Whether the source calls the function besides declaring it
+static bool isFunctionCalled(const std::string& source, const std::string& function) {
+    size_t position = source.find(function);
+    return (position != std::string::npos) && (source.find(function, position + function.size()) != std::string::npos);
+}
+
+// The eyes can be instanced with the programs whose vertex shader places its clip position with the standard
+// transform, and whose pixel shader doesn't read the camera, which would be the one of the left eye
+static bool isStereoInstanceable(const Shader& program) {
+    bool placesEyes = false;
+    for (auto subShader : program.getShaders()) {
+        const std::string& shaderSource = subShader->getSource().getCode();
+        if (subShader->getType() == Shader::VERTEX) {
+            placesEyes = isFunctionCalled(shaderSource, "evalStereoClipPos(");
+        } else if (isFunctionCalled(shaderSource, "getTransformCamera()")) {
+            return false;
+        }
+    }
+    return placesEyes;
+}
+
 GLBackend::GLShader* compileProgram(const Shader& program) {
     if(!program.isProgram()) {
         return nullptr;
     }
 
+    // A cached binary spares compiling the sub shaders too
+    QString cachePath;
+    if (isProgramBinaryCacheSupported()) {
+        cachePath = getProgramBinaryCachePath(program);
+        GLuint glprogram = loadProgramBinary(cachePath);
+        if (glprogram) {
+            GLBackend::GLShader* object = new GLBackend::GLShader();
+            object->_shader = 0;
+            object->_program = glprogram;
+            object->_isStereoInstanceable = isStereoInstanceable(program);
+
+            makeUniformBlockBindings(object);
+
+            return object;
+        }
+    }
+
     // Let's go through every shaders and make sure they are ready to go
     std::vector< GLuint > shaderObjects;
     for (auto subShader : program.getShaders()) {
@@ -252,7 +409,10 @@ GLBackend::GLShader* compileProgram(const Shader& program) {
         return nullptr;
     }
 
-    // glProgramParameteri(glprogram, GL_PROGRAM_, GL_TRUE);
+    if (!cachePath.isEmpty()) {
+        glProgramParameteri(glprogram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     // Create the program from the sub shaders
     for (auto so : shaderObjects) {
         glAttachShader(glprogram, so);
@@ -304,6 +464,10 @@ GLBackend::GLShader* compileProgram(const Shader& program) {
 
     makeBindings(object);
 
+    if (!cachePath.isEmpty()) {
+        saveProgramBinary(glprogram, cachePath);
+    }
+
     return object;
 }
 
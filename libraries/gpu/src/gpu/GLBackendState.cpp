@@ -778,7 +778,7 @@ void GLBackend::do_setStateScissorRect(Batch& batch, uint32 paramOffset) {
     Vec4i rect;
     memcpy(&rect, batch.editData(batch._params[paramOffset]._uint), sizeof(Vec4i));
 
-    if (_stereo._enable) {
+    if (_stereo._enable && !_stereo._instancedPass) {
         rect.z /= 2;
         if (_stereo._pass) {
             rect.x += rect.z;
@@ -11,22 +11,58 @@
 #include "GPULogging.h"
 #include "GLBackendShared.h"
 
+#include <mutex>
+#include <unordered_set>
+
 using namespace gpu;
 
-GLBackend::GLTexture::GLTexture() :
+// All the gl textures alive, for the residency to go through when over the memory budget
+static std::mutex residentTexturesMutex;
+static std::unordered_set<GLBackend::GLTexture*> residentTextures;
+
+// Counts the frames for the textures to tell when they were last used
+static uint32 textureFrame = 0;
+
+GLBackend::GLTexture::GLTexture(const Texture& texture) :
+    _gpuTexture(texture),
     _storageStamp(0),
     _contentStamp(0),
     _texture(0),
     _target(GL_TEXTURE_2D),
-    _size(0)
-{}
+    _size(0),
+    _pendingMip(-1),
+    _residentMip(0),
+    _lastUsedFrame(textureFrame)
+{
+    std::lock_guard<std::mutex> lock(residentTexturesMutex);
+    residentTextures.insert(this);
+}
 
 GLBackend::GLTexture::~GLTexture() {
+    {
+        std::lock_guard<std::mutex> lock(residentTexturesMutex);
+        residentTextures.erase(this);
+    }
+    setSize(0);
     if (_texture != 0) {
         glDeleteTextures(1, &_texture);
     }
 }
 
+void GLBackend::GLTexture::setSize(GLuint size) {
+    Texture::updateTextureGPUMemoryUsage(_size, size);
+    _size = size;
+}
+
+// The bytes of the mips from residentMip down to the smallest, for the textures streaming their mips
+static GLuint evalResidentSize(const Texture& texture, uint16 residentMip) {
+    GLuint size = 0;
+    for (uint16 level = residentMip; level <= texture.maxMip(); level++) {
+        size += texture.evalMipSize(level);
+    }
+    return size;
+}
+
 class GLTexelFormat {
 public:
     GLenum internalFormat;
@@ -34,6 +70,24 @@ public:
     GLenum type;
 
     static GLTexelFormat evalGLTexelFormat(const Element& dstFormat, const Element& srcFormat) {
+        // The compressed pixels go as they are, only the internal format matters
+        if (dstFormat.isCompressed()) {
+            GLTexelFormat texel = {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_RGBA, GL_UNSIGNED_BYTE};
+            switch (dstFormat.getSemantic()) {
+            case gpu::COMPRESSED_BC1_RGB:
+                texel.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                texel.format = GL_RGB;
+                break;
+            case gpu::COMPRESSED_BC5_XY:
+                texel.internalFormat = GL_COMPRESSED_RG_RGTC2;
+                texel.format = GL_RG;
+                break;
+            default:
+                break;
+            }
+            return texel;
+        }
+
         if (dstFormat != srcFormat) {
             GLTexelFormat texel = {GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE};
 
@@ -264,13 +318,22 @@ public:
 
 GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
     GLTexture* object = Backend::getGPUObject<GLBackend::GLTexture>(texture);
+    if (object) {
+        object->_lastUsedFrame = textureFrame;
+    }
 
     // If GPU object already created and in sync
     bool needUpdate = false;
     if (object && (object->_storageStamp == texture.getStamp())) {
         // If gpu object info is in sync with sysmem version
         if (object->_contentStamp >= texture.getDataStamp()) {
-            // Then all good, GPU object is ready to be used
+            // Then all good, GPU object is ready to be used, while its mips keep streaming in
+            if (object->_residentMip > 0) {
+                restoreDroppedMips(texture, object);
+            }
+            if (object->_pendingMip >= 0) {
+                uploadPendingMips(texture, object);
+            }
             return object;
         } else {
             // Need to update the content of the GPU object from the source sysmem of the texture
@@ -283,7 +346,7 @@ GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
 
     // need to have a gpu object?
     if (!object) {
-        object = new GLTexture();
+        object = new GLTexture(texture);
         glGenTextures(1, &object->_texture);
         (void) CHECK_GL_ERROR();
         Backend::setGPUObject(texture, object);
@@ -325,6 +388,36 @@ GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
 
                     object->_contentStamp = texture.getDataStamp();
                 }
+            } else if (!texture.isAutogenerateMips() && (texture.maxMip() > 0) &&
+                    texture.isStoredMipFaceAvailable(0) && texture.isStoredMipFaceAvailable(texture.maxMip())) {
+                // The texture comes with its mips, allocate them all and stream them in from the smallest
+                Element srcFormat = texture.accessStoredMipFace(0)->_format;
+                GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(texture.getTexelFormat(), srcFormat);
+
+                for (uint16 level = 0; level <= texture.maxMip(); level++) {
+                    if (texture.getTexelFormat().isCompressed()) {
+                        glCompressedTexImage2D(GL_TEXTURE_2D, level,
+                            texelFormat.internalFormat, texture.evalMipWidth(level), texture.evalMipHeight(level), 0,
+                            texture.evalMipFaceSize(level), 0);
+                    } else {
+                        glTexImage2D(GL_TEXTURE_2D, level,
+                            texelFormat.internalFormat, texture.evalMipWidth(level), texture.evalMipHeight(level), 0,
+                            texelFormat.format, texelFormat.type, 0);
+                    }
+                }
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.maxMip());
+
+                object->_target = GL_TEXTURE_2D;
+
+                syncSampler(texture.getSampler(), texture.getType(), object);
+
+                object->_pendingMip = texture.maxMip();
+                object->_residentMip = 0;
+                uploadPendingMips(texture, object);
+
+                object->_storageStamp = texture.getStamp();
+                object->_contentStamp = texture.getDataStamp();
+                object->setSize(evalResidentSize(texture, 0));
             } else {
                 const GLvoid* bytes = 0;
                 Element srcFormat = texture.getTexelFormat();
@@ -339,9 +432,15 @@ GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
 
                 GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(texture.getTexelFormat(), srcFormat);
 
-                glTexImage2D(GL_TEXTURE_2D, 0,
-                    texelFormat.internalFormat, texture.getWidth(), texture.getHeight(), 0,
-                    texelFormat.format, texelFormat.type, bytes);
+                if (texture.getTexelFormat().isCompressed()) {
+                    glCompressedTexImage2D(GL_TEXTURE_2D, 0,
+                        texelFormat.internalFormat, texture.getWidth(), texture.getHeight(), 0,
+                        texture.evalMipFaceSize(0), bytes);
+                } else {
+                    glTexImage2D(GL_TEXTURE_2D, 0,
+                        texelFormat.internalFormat, texture.getWidth(), texture.getHeight(), 0,
+                        texelFormat.format, texelFormat.type, bytes);
+                }
 
                 if (bytes && texture.isAutogenerateMips()) {
                     glGenerateMipmap(GL_TEXTURE_2D);
@@ -355,9 +454,11 @@ GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
                 // At this point the mip pixels have been loaded, we can notify
                 texture.notifyMipFaceGPULoaded(0, 0);
 
+                object->_pendingMip = -1;
+                object->_residentMip = 0;
                 object->_storageStamp = texture.getStamp();
                 object->_contentStamp = texture.getDataStamp();
-                object->_size = texture.getSize();
+                object->setSize(texture.getSize());
             }
 
             glBindTexture(GL_TEXTURE_2D, boundTex);
@@ -435,7 +536,7 @@ GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
 
                 object->_storageStamp = texture.getStamp();
                 object->_contentStamp = texture.getDataStamp();
-                object->_size = texture.getSize();
+                object->setSize(texture.getSize());
             }
 
             glBindTexture(GL_TEXTURE_CUBE_MAP, boundTex);
@@ -452,6 +553,174 @@ GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
 
 
 
+// The bytes of mips uploaded per frame by the textures streaming in, a mip larger than that goes alone in its frame
+const int64_t MAX_TEXTURE_UPLOAD_BYTES_PER_FRAME = 8 * 1024 * 1024;
+static int64_t textureUploadBudget = MAX_TEXTURE_UPLOAD_BYTES_PER_FRAME;
+
+void GLBackend::resetTextureUploadBudget() {
+    textureUploadBudget = MAX_TEXTURE_UPLOAD_BYTES_PER_FRAME;
+}
+
+void GLBackend::uploadPendingMips(const Texture& texture, GLTexture* object) {
+    GLint boundTex = -1;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTex);
+    glBindTexture(GL_TEXTURE_2D, object->_texture);
+
+    while (object->_pendingMip >= 0) {
+        uint16 level = object->_pendingMip;
+        int64_t mipSize = texture.evalMipSize(level);
+
+        // The smallest mip always goes in, so the texture can be sampled from its first use
+        bool isFirstMip = (level == texture.maxMip());
+        bool isBudgetFull = (textureUploadBudget == MAX_TEXTURE_UPLOAD_BYTES_PER_FRAME);
+        if (!isFirstMip && !isBudgetFull && (mipSize > textureUploadBudget)) {
+            break;
+        }
+
+        Texture::PixelsPointer mip = texture.accessStoredMipFace(level);
+        if (mip && mip->_sysmem.getSize()) {
+            GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(texture.getTexelFormat(), mip->_format);
+            if (texture.getTexelFormat().isCompressed()) {
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, texture.evalMipWidth(level), texture.evalMipHeight(level),
+                    texelFormat.internalFormat, texture.evalMipFaceSize(level), mip->_sysmem.read<Byte>());
+            } else {
+                glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, texture.evalMipWidth(level), texture.evalMipHeight(level),
+                    texelFormat.format, texelFormat.type, mip->_sysmem.read<Byte>());
+            }
+
+            // At this point the mip pixels have been loaded, we can notify
+            texture.notifyMipFaceGPULoaded(level, 0);
+        }
+
+        textureUploadBudget = std::max(textureUploadBudget - mipSize, (int64_t)0);
+        object->_pendingMip--;
+    }
+
+    // Only sample the mips already uploaded
+    GLint baseLevel = std::max((GLint)texture.getSampler().getMipOffset(), (GLint)(object->_pendingMip + 1));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel);
+
+    glBindTexture(GL_TEXTURE_2D, boundTex);
+    (void) CHECK_GL_ERROR();
+}
+
+// The textures out of use for that many frames can drop their top mips, down to the smallest ones
+const uint32 MIN_UNUSED_FRAMES_TO_DROP = 60;
+const uint16 NUM_UNDROPPABLE_MIPS = 7; // 64 x 64 and below for a square texture
+
+// The mips dropped read back to the sysmem first, limit the stall within a frame
+const int64_t MAX_TEXTURE_DROP_BYTES_PER_FRAME = 32 * 1024 * 1024;
+
+// Only the textures streaming their own mips can drop some, once they're all in
+static bool canDropMips(const Texture& texture, const GLBackend::GLTexture* object) {
+    return (object->_target == GL_TEXTURE_2D) && (texture.getType() == Texture::TEX_2D) && !texture.isAutogenerateMips() &&
+        (object->_pendingMip < 0) && (object->_residentMip + NUM_UNDROPPABLE_MIPS <= texture.maxMip()) &&
+        (textureFrame - object->_lastUsedFrame >= MIN_UNUSED_FRAMES_TO_DROP);
+}
+
+void GLBackend::updateTextureResidency() {
+    textureFrame++;
+
+    if (Texture::getTextureGPUMemoryUsage() <= Texture::getTextureGPUMemoryBudget()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(residentTexturesMutex);
+    std::vector<GLTexture*> candidates;
+    for (auto object : residentTextures) {
+        if (canDropMips(object->_gpuTexture, object)) {
+            candidates.push_back(object);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const GLTexture* left, const GLTexture* right) {
+        return left->_lastUsedFrame < right->_lastUsedFrame;
+    });
+
+    // Each pass drops the top mip of the least recently used textures, which frees three quarters of their memory
+    int64_t droppedBytes = 0;
+    for (auto object : candidates) {
+        if ((Texture::getTextureGPUMemoryUsage() <= Texture::getTextureGPUMemoryBudget()) ||
+                (droppedBytes >= MAX_TEXTURE_DROP_BYTES_PER_FRAME)) {
+            break;
+        }
+        GLuint prevSize = object->_size;
+        dropTopMips(object->_gpuTexture, object);
+        droppedBytes += prevSize - object->_size;
+    }
+}
+
+void GLBackend::dropTopMips(const Texture& texture, GLTexture* object) {
+    GLint boundTex = -1;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTex);
+    glBindTexture(GL_TEXTURE_2D, object->_texture);
+
+    while (object->_residentMip + NUM_UNDROPPABLE_MIPS <= texture.maxMip() &&
+            Texture::getTextureGPUMemoryUsage() > Texture::getTextureGPUMemoryBudget()) {
+        uint16 level = object->_residentMip;
+        Texture::PixelsPointer mip = texture.accessStoredMipFace(level);
+        if (!mip) {
+            break;
+        }
+        GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(texture.getTexelFormat(), mip->_format);
+        GLsizei width = texture.evalMipWidth(level);
+        GLsizei height = texture.evalMipHeight(level);
+
+        // Give the pixels back to the sysmem, in the format they were uploaded from, then free the mip
+        if (texture.getTexelFormat().isCompressed()) {
+            std::vector<Byte> bytes(texture.evalMipFaceSize(level));
+            glGetCompressedTexImage(GL_TEXTURE_2D, level, bytes.data());
+            texture.notifyMipFaceGPUUnloaded(level, 0, (Texture::Size)bytes.size(), bytes.data());
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, texelFormat.internalFormat, 0, 0, 0, 0, 0);
+        } else {
+            // the rows are packed as they were unpacked, aligned on 4 bytes
+            const GLint ROW_ALIGNMENT = 4;
+            GLint rowSize = width * mip->_format.getSize();
+            rowSize = (rowSize + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+            std::vector<Byte> bytes(std::max((GLint)texture.evalMipFaceSize(level), rowSize * height));
+            glPixelStorei(GL_PACK_ALIGNMENT, ROW_ALIGNMENT);
+            glGetTexImage(GL_TEXTURE_2D, level, texelFormat.format, texelFormat.type, bytes.data());
+            texture.notifyMipFaceGPUUnloaded(level, 0, (Texture::Size)bytes.size(), bytes.data());
+            glTexImage2D(GL_TEXTURE_2D, level, texelFormat.internalFormat, 0, 0, 0, texelFormat.format, texelFormat.type, 0);
+        }
+        object->_residentMip++;
+        object->setSize(evalResidentSize(texture, object->_residentMip));
+    }
+
+    GLint baseLevel = std::max((GLint)texture.getSampler().getMipOffset(), (GLint)object->_residentMip);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel);
+
+    glBindTexture(GL_TEXTURE_2D, boundTex);
+    (void) CHECK_GL_ERROR();
+}
+
+void GLBackend::restoreDroppedMips(const Texture& texture, GLTexture* object) {
+    GLint boundTex = -1;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTex);
+    glBindTexture(GL_TEXTURE_2D, object->_texture);
+
+    // Allocate the dropped mips again, they stream back in from the sysmem like when the texture first loaded
+    for (uint16 level = 0; level < object->_residentMip; level++) {
+        Texture::PixelsPointer mip = texture.accessStoredMipFace(level);
+        Element srcFormat = (mip ? mip->_format : texture.getTexelFormat());
+        GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(texture.getTexelFormat(), srcFormat);
+        if (texture.getTexelFormat().isCompressed()) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level,
+                texelFormat.internalFormat, texture.evalMipWidth(level), texture.evalMipHeight(level), 0,
+                texture.evalMipFaceSize(level), 0);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, level,
+                texelFormat.internalFormat, texture.evalMipWidth(level), texture.evalMipHeight(level), 0,
+                texelFormat.format, texelFormat.type, 0);
+        }
+    }
+    object->_pendingMip = object->_residentMip - 1;
+    object->_residentMip = 0;
+    object->setSize(evalResidentSize(texture, 0));
+
+    glBindTexture(GL_TEXTURE_2D, boundTex);
+    (void) CHECK_GL_ERROR();
+}
+
 GLuint GLBackend::getTextureID(const TexturePointer& texture) {
     if (!texture) {
         return 0;
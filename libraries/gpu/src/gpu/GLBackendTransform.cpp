@@ -35,8 +35,8 @@ void GLBackend::do_setViewportTransform(Batch& batch, uint32 paramOffset) {
 
     ivec4& vp = _transform._viewport;
 
-    // Where we assign the GL viewport
-    if (_stereo._enable) {
+    // Where we assign the GL viewport, the instanced stereo pass covers both eyes and the shaders split it
+    if (_stereo._enable && !_stereo._instancedPass) {
         vp.z /= 2;
         if (_stereo._pass) {
             vp.x += vp.z;
@@ -71,13 +71,54 @@ void GLBackend::initTransform() {
     while (_transform._objectUboSize < objectSize) {
         _transform._objectUboSize += _uboAlignment;
     }
+    _transform.initRingBuffer();
 }
 
 void GLBackend::killTransform() {
+    _transform.killRingBuffer();
     glDeleteBuffers(1, &_transform._objectBuffer);
     glDeleteBuffers(1, &_transform._cameraBuffer);
 }
 
+void GLBackend::TransformStageState::initRingBuffer() {
+    // The older contexts, like the 4.1 of the mac, stay on glBufferData
+    if (!GLEW_ARB_buffer_storage) {
+        return;
+    }
+
+    const GLbitfield FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr RING_SIZE = NUM_RING_SEGMENTS * RING_SEGMENT_SIZE;
+    glGenBuffers(1, &_ringBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, _ringBuffer);
+    glBufferStorage(GL_UNIFORM_BUFFER, RING_SIZE, nullptr, FLAGS);
+    _ringData = reinterpret_cast<Byte*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, RING_SIZE, FLAGS));
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    if (!_ringData) {
+        qCDebug(gpulogging) << "GLBackend: couldn't map the transform ring buffer, using glBufferData";
+        glDeleteBuffers(1, &_ringBuffer);
+        _ringBuffer = 0;
+    }
+    (void)CHECK_GL_ERROR();
+}
+
+void GLBackend::TransformStageState::killRingBuffer() {
+    for (auto& fence : _ringFences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = 0;
+        }
+    }
+    if (_ringBuffer) {
+        glBindBuffer(GL_UNIFORM_BUFFER, _ringBuffer);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glDeleteBuffers(1, &_ringBuffer);
+        _ringBuffer = 0;
+        _ringData = nullptr;
+    }
+}
+
 void GLBackend::syncTransformStateCache() {
     _transform._invalidViewport = true;
     _transform._invalidProj = true;
@@ -141,7 +182,65 @@ void GLBackend::TransformStageState::preUpdate(size_t commandIndex, const Stereo
     _invalidView = _invalidProj = _invalidModel = _invalidViewport = false;
 }
 
-void GLBackend::TransformStageState::transfer() const {
+static size_t alignTo(size_t size, size_t alignment) {
+    return (alignment > 1) ? ((size + alignment - 1) / alignment) * alignment : size;
+}
+
+bool GLBackend::TransformStageState::transferToRingBuffer(size_t camerasSize, size_t objectsSize) {
+    size_t alignment = std::max(_cameraUboSize, _objectUboSize);
+    size_t camerasRange = alignTo(camerasSize, alignment);
+    size_t size = camerasRange + objectsSize;
+    if (!_ringData || size > RING_SEGMENT_SIZE) {
+        return false;
+    }
+
+    if (_ringOffset + size > RING_SEGMENT_SIZE) {
+        // the draws of the previous batches are all issued, fence them and move on to the next segment
+        _ringFences[_ringSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        _ringSegment = (_ringSegment + 1) % NUM_RING_SEGMENTS;
+        _ringOffset = 0;
+
+        GLsync& fence = _ringFences[_ringSegment];
+        if (fence) {
+            // only waits when the GPU is whole segments behind
+            const GLuint64 TIMEOUT = 1000000000; // nanoseconds
+            GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, TIMEOUT);
+            if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+                qCDebug(gpulogging) << "GLBackend: the transform ring buffer fence didn't signal";
+            }
+            glDeleteSync(fence);
+            fence = 0;
+        }
+    }
+
+    size_t offset = _ringSegment * RING_SEGMENT_SIZE + _ringOffset;
+    _cameraBufferOffset = offset;
+    _objectBufferOffset = offset + camerasRange;
+    _boundCameraBuffer = _boundObjectBuffer = _ringBuffer;
+
+    for (size_t i = 0; i < _cameras.size(); ++i) {
+        memcpy(_ringData + _cameraBufferOffset + (_cameraUboSize * i), &_cameras[i], sizeof(TransformCamera));
+    }
+    for (size_t i = 0; i < _objects.size(); ++i) {
+        memcpy(_ringData + _objectBufferOffset + (_objectUboSize * i), &_objects[i], sizeof(TransformObject));
+    }
+
+    _ringOffset += alignTo(size, alignment);
+    return true;
+}
+
+void GLBackend::TransformStageState::transfer() {
+    size_t camerasSize = _cameraUboSize * _cameras.size();
+    size_t objectsSize = _objectUboSize * _objects.size();
+    if ((camerasSize + objectsSize) == 0 || transferToRingBuffer(camerasSize, objectsSize)) {
+        return;
+    }
+
+    // Without persistent mapping, or for a batch too large for a segment
+    _boundCameraBuffer = _cameraBuffer;
+    _boundObjectBuffer = _objectBuffer;
+    _cameraBufferOffset = _objectBufferOffset = 0;
+
     static QByteArray bufferData;
     if (!_cameras.empty()) {
         glBindBuffer(GL_UNIFORM_BUFFER, _cameraBuffer);
@@ -175,7 +274,7 @@ void GLBackend::TransformStageState::update(size_t commandIndex, const StereoSta
     }
     if (offset >= 0) {
         glBindBufferRange(GL_UNIFORM_BUFFER, TRANSFORM_OBJECT_SLOT,
-            _objectBuffer, offset, sizeof(Backend::TransformObject));
+            _boundObjectBuffer, _objectBufferOffset + offset, sizeof(Backend::TransformObject));
     }
 
     offset = -1;
@@ -184,12 +283,21 @@ void GLBackend::TransformStageState::update(size_t commandIndex, const StereoSta
         ++_camerasItr;
     }
     if (offset >= 0) {
-        // We include both camera offsets for stereo
-        if (stereo._enable && stereo._pass) {
-            offset += _cameraUboSize;
+        // We include both camera offsets for stereo, the instanced pass reads the right eye from its own slot
+        if (stereo._instancedPass) {
+            glBindBufferRange(GL_UNIFORM_BUFFER, TRANSFORM_CAMERA_SLOT,
+                _boundCameraBuffer, _cameraBufferOffset + offset, sizeof(Backend::TransformCamera));
+            glBindBufferRange(GL_UNIFORM_BUFFER, TRANSFORM_STEREO_CAMERA_SLOT,
+                _boundCameraBuffer, _cameraBufferOffset + offset + _cameraUboSize, sizeof(Backend::TransformCamera));
+        } else {
+            if (stereo._enable && stereo._pass) {
+                offset += _cameraUboSize;
+            }
+            glBindBufferRange(GL_UNIFORM_BUFFER, TRANSFORM_CAMERA_SLOT,
+                _boundCameraBuffer, _cameraBufferOffset + offset, sizeof(Backend::TransformCamera));
+            glBindBufferRange(GL_UNIFORM_BUFFER, TRANSFORM_STEREO_CAMERA_SLOT,
+                _boundCameraBuffer, _cameraBufferOffset + offset, sizeof(Backend::TransformCamera));
         }
-        glBindBufferRange(GL_UNIFORM_BUFFER, TRANSFORM_CAMERA_SLOT,
-            _cameraBuffer, offset, sizeof(Backend::TransformCamera));
     }
 
     (void)CHECK_GL_ERROR();
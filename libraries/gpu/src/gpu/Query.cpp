@@ -14,7 +14,8 @@
 
 using namespace gpu;
 
-Query::Query()
+Query::Query(Type type) :
+    _type(type)
 {
 }
 
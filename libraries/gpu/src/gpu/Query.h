@@ -21,15 +21,29 @@ namespace gpu {
 
     class Query {
     public:
-        Query();
+        enum Type {
+            TIMER = 0,
+
+            // Counts if any sample of the draws between begin and end passed the depth test. Getting it doesn't wait
+            // on the gpu, the result stays pending until a later getQuery finds it available.
+            ANY_SAMPLES_PASSED,
+        };
+
+        Query(Type type = TIMER);
         ~Query();
 
-        uint32 queryResult;
+        Type getType() const { return _type; }
+
+        uint32 queryResult { 0 };
+
+        // Set by the backend when a getQuery read a fresh result
+        bool isResultReady { false };
 
         double getElapsedTime();
 
     protected:
-        
+        Type _type;
+
         // This shouldn't be used by anything else than the Backend class with the proper casting.
         mutable GPUObject* _gpuObject = NULL;
         void setGPUObject(GPUObject* gpuObject) const { _gpuObject = gpuObject; }
@@ -10,10 +10,20 @@
 //
 #include "Resource.h"
 
+#include <algorithm>
+
 #include <QDebug>
 
 using namespace gpu;
 
+std::atomic<int64_t> Buffer::_bufferGPUBytesUploaded { 0 };
+
+// Past this many updates they are merged into one covering them all
+const size_t MAX_TRACKED_BUFFER_UPDATES = 64;
+
+// Dirty ranges closer than this are uploaded together, a gap costs less than another upload call
+const Resource::Size MIN_DIRTY_RANGE_GAP = 256;
+
 Resource::Size Resource::Sysmem::allocateMemory(Byte** dataAllocated, Size size) {
     if ( !dataAllocated ) { 
         qWarning() << "Buffer::Sysmem::allocateMemory() : Must have a valid dataAllocated pointer.";
@@ -203,7 +213,14 @@ Buffer::~Buffer() {
 }
 
 Buffer::Size Buffer::resize(Size size) {
-    return editSysmem().resize(size);
+    Stamp from = getSysmem().getStamp();
+    Size oldSize = getSize();
+    Size newSize = editSysmem().resize(size);
+    if (getSysmem().getStamp() != from) {
+        // only the grown part holds new bytes
+        recordUpdate(from, oldSize, (newSize > oldSize) ? newSize - oldSize : 0);
+    }
+    return newSize;
 }
 
 Buffer::Size Buffer::setData(Size size, const Byte* data) {
@@ -211,10 +228,102 @@ Buffer::Size Buffer::setData(Size size, const Byte* data) {
 }
 
 Buffer::Size Buffer::setSubData(Size offset, Size size, const Byte* data) {
-    return editSysmem().setSubData( offset, size, data);
+    Stamp from = getSysmem().getStamp();
+    Size copied = editSysmem().setSubData( offset, size, data);
+    if (copied) {
+        recordUpdate(from, offset, copied);
+    }
+    return copied;
 }
 
 Buffer::Size Buffer::append(Size size, const Byte* data) {
-    return editSysmem().append( size, data);
+    Stamp from = getSysmem().getStamp();
+    Size oldSize = getSize();
+    Size copied = editSysmem().append( size, data);
+    if (copied) {
+        recordUpdate(from, oldSize, copied);
+    }
+    return copied;
+}
+
+void Buffer::recordUpdate(Stamp from, Size offset, Size size) {
+    Stamp to = getSysmem().getStamp();
+    if (!_updates.empty() && _updates.back()._to != from) {
+        // changed some other way in between, the earlier updates don't lead to the current data anymore
+        _updates.clear();
+    }
+
+    if (!_updates.empty()) {
+        // the appends and the edits of the same bytes extend the last update
+        Range& last = _updates.back()._range;
+        if (offset <= last._offset + last._size && last._offset <= offset + size) {
+            Size end = std::max(last._offset + last._size, offset + size);
+            last._offset = std::min(last._offset, offset);
+            last._size = end - last._offset;
+            _updates.back()._to = to;
+            return;
+        }
+    }
+
+    if (_updates.size() >= MAX_TRACKED_BUFFER_UPDATES) {
+        // one update over all of them, from the oldest stamp
+        Update merged = _updates.front();
+        Size end = merged._range._offset + merged._range._size;
+        for (const auto& update : _updates) {
+            end = std::max(end, update._range._offset + update._range._size);
+            merged._range._offset = std::min(merged._range._offset, update._range._offset);
+        }
+        merged._range._size = end - merged._range._offset;
+        merged._to = _updates.back()._to;
+        _updates.clear();
+        _updates.push_back(merged);
+    }
+
+    Update update;
+    update._from = from;
+    update._to = to;
+    update._range._offset = offset;
+    update._range._size = size;
+    _updates.push_back(update);
+}
+
+bool Buffer::getDirtyRangesSince(Stamp stamp, std::vector<Range>& ranges) const {
+    ranges.clear();
+    if (_updates.empty() || _updates.back()._to != getSysmem().getStamp()) {
+        return false;
+    }
+    int first = (int)_updates.size() - 1;
+    while (first >= 0 && _updates[first]._from != stamp) {
+        first--;
+    }
+    if (first < 0) {
+        return false;
+    }
+
+    // the bytes past a shrink are gone
+    Size size = getSize();
+    for (size_t i = first; i < _updates.size(); i++) {
+        Range range = _updates[i]._range;
+        if (range._offset < size) {
+            range._size = std::min(range._size, size - range._offset);
+            if (range._size > 0) {
+                ranges.push_back(range);
+            }
+        }
+    }
+    if (ranges.size() > 1) {
+        std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) { return a._offset < b._offset; });
+        size_t merged = 0;
+        for (size_t i = 1; i < ranges.size(); i++) {
+            Range& last = ranges[merged];
+            if (ranges[i]._offset <= last._offset + last._size + MIN_DIRTY_RANGE_GAP) {
+                last._size = std::max(last._offset + last._size, ranges[i]._offset + ranges[i]._size) - last._offset;
+            } else {
+                ranges[++merged] = ranges[i];
+            }
+        }
+        ranges.resize(merged + 1);
+    }
+    return true;
 }
 
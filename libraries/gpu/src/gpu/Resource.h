@@ -15,6 +15,7 @@
 
 #include "Format.h"
 
+#include <atomic>
 #include <vector>
 
 #include <memory>
@@ -153,7 +154,36 @@ public:
     const Sysmem& getSysmem() const { assert(_sysmem); return (*_sysmem); }
     Sysmem& editSysmem() { assert(_sysmem); return (*_sysmem); }
 
+    class Range {
+    public:
+        Size _offset { 0 };
+        Size _size { 0 };
+    };
+
+    // The ranges of bytes changed by setSubData, append and resize since the sysmem had the stamp, sorted and merged,
+    // so that the backend only uploads those. False when the buffer also changed some other way since, through
+    // setData or editData, or when the stamp is too old: then the whole buffer is dirty.
+    bool getDirtyRangesSince(Stamp stamp, std::vector<Range>& ranges) const;
+
+    // The bytes all the buffers uploaded to the GPU so far, the stats take the difference every frame
+    static int64_t getBufferGPUBytesUploaded() { return _bufferGPUBytesUploaded; }
+
+    // Only callable by the Backend
+    static void updateBufferGPUBytesUploaded(int64_t bytes) { _bufferGPUBytesUploaded += bytes; }
+
 protected:
+    static std::atomic<int64_t> _bufferGPUBytesUploaded;
+
+    // A change of the range that moved the sysmem from one stamp to the next, the updates always follow each other
+    class Update {
+    public:
+        Stamp _from;
+        Stamp _to;
+        Range _range;
+    };
+    std::vector<Update> _updates;
+
+    void recordUpdate(Stamp from, Size offset, Size size);
 
     Sysmem* _sysmem = NULL;
 
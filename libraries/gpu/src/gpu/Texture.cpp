@@ -11,6 +11,9 @@
 
 #include "Texture.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <glm/gtc/constants.hpp>
 
 #include <QDebug>
@@ -19,6 +22,12 @@ using namespace gpu;
 
 uint8 Texture::NUM_FACES_PER_TYPE[NUM_TYPES] = {1, 1, 1, 6};
 
+// Half of the smaller GPUs, the rest goes to the framebuffers and the geometry
+const int64_t DEFAULT_TEXTURE_GPU_MEMORY_BUDGET = 1024 * 1024 * 1024;
+
+std::atomic<int64_t> Texture::_textureGPUMemoryUsage { 0 };
+std::atomic<int64_t> Texture::_textureGPUMemoryBudget { DEFAULT_TEXTURE_GPU_MEMORY_BUDGET };
+
 Texture::Pixels::Pixels(const Element& format, Size size, const Byte* bytes) :
     _sysmem(size, bytes),
     _format(format),
@@ -65,6 +74,14 @@ void Texture::Storage::notifyMipFaceGPULoaded(uint16 level, uint8 face) const {
     }
 }
 
+void Texture::Storage::notifyMipFaceGPUUnloaded(uint16 level, uint8 face, Size size, const Byte* bytes) const {
+    PixelsPointer mipFace = getMipFace(level, face);
+    if (mipFace) {
+        mipFace->_sysmem.setData(size, bytes);
+        mipFace->_isGPULoaded = false;
+    }
+}
+
 bool Texture::Storage::isMipAvailable(uint16 level, uint8 face) const {
     PixelsPointer mipFace = getMipFace(level, face);
     return (mipFace && mipFace->_sysmem.getSize());
@@ -175,6 +192,10 @@ Texture::Texture():
 
 Texture::~Texture()
 {
+    if (_gpuObject) {
+        delete _gpuObject;
+        _gpuObject = NULL;
+    }
 }
 
 Texture::Size Texture::resize(Type type, const Element& texelFormat, uint16 width, uint16 height, uint16 depth, uint16 numSamples, uint16 numSlices) {
@@ -214,7 +235,7 @@ Texture::Size Texture::resize(Type type, const Element& texelFormat, uint16 widt
         }
         
         // Evaluate the new size with the new format
-        uint32_t size = NUM_FACES_PER_TYPE[_type] *_width * _height * _depth * _numSamples * texelFormat.getSize();
+        uint32_t size = NUM_FACES_PER_TYPE[_type] * evalPixelsSize(texelFormat, _width, _height, _depth) * _numSamples;
 
         // If size change then we need to reset 
         if (changed || (size != getSize())) {
@@ -296,6 +317,7 @@ bool Texture::assignStoredMip(uint16 level, const Element& format, Size size, co
     Size expectedSize = evalStoredMipSize(level, format);
     if (size == expectedSize) {
         _storage->assignMipData(level, format, size, bytes);
+        _maxMip = std::max(_maxMip, level);
         _stamp++;
         return true;
     } else if (size > expectedSize) {
@@ -304,6 +326,7 @@ bool Texture::assignStoredMip(uint16 level, const Element& format, Size size, co
         // We should probably consider something a bit more smart to get the correct result but for now (UI elements)
         // it seems to work...
         _storage->assignMipData(level, format, size, bytes);
+        _maxMip = std::max(_maxMip, level);
         _stamp++;
         return true;
     }
@@ -397,7 +420,7 @@ uint32 Texture::getStoredMipNumTexels(uint16 level) const {
 uint32 Texture::getStoredMipSize(uint16 level) const {
     PixelsPointer mipFace = accessStoredMipFace(level);
     if (mipFace && mipFace->_sysmem.getSize()) {
-        return evalMipWidth(level) * evalMipHeight(level) * evalMipDepth(level) * getTexelFormat().getSize();
+        return evalMipFaceSize(level);
     }
     return 0;
 }
@@ -610,14 +633,66 @@ void sphericalHarmonicsEvaluateDirection(float * result, int order,  const glm::
    result[8] = P_2_2 * ((double)dir.x * (double)dir.x - (double)dir.y * (double)dir.y);
 }
 
+// The direction from the center of the cube to a point of a face, x and y in texels from its top left corner
+static glm::vec3 cubeFaceDirection(int face, float x, float y, float invWidthBy2) {
+    glm::vec3 dir;
+    switch(face) {
+    case gpu::Texture::CUBE_FACE_RIGHT_POS_X: {
+        dir.x = 1.0f;
+        dir.y = 1.0f - invWidthBy2 * y;
+        dir.z = 1.0f - invWidthBy2 * x;
+        dir = -dir;
+        break;
+    }
+    case gpu::Texture::CUBE_FACE_LEFT_NEG_X: {
+        dir.x = -1.0f;
+        dir.y = 1.0f - invWidthBy2 * y;
+        dir.z = -1.0f + invWidthBy2 * x;
+        dir = -dir;
+        break;
+    }
+    case gpu::Texture::CUBE_FACE_TOP_POS_Y: {
+        dir.x = - 1.0f + invWidthBy2 * x;
+        dir.y = 1.0f;
+        dir.z = - 1.0f + invWidthBy2 * y;
+        dir = -dir;
+        break;
+    }
+    case gpu::Texture::CUBE_FACE_BOTTOM_NEG_Y: {
+        dir.x = - 1.0f + invWidthBy2 * x;
+        dir.y = - 1.0f;
+        dir.z = 1.0f - invWidthBy2 * y;
+        dir = -dir;
+        break;
+    }
+    case gpu::Texture::CUBE_FACE_BACK_POS_Z: {
+        dir.x = - 1.0f + invWidthBy2 * x;
+        dir.y = 1.0f - invWidthBy2 * y;
+        dir.z = 1.0f;
+        break;
+    }
+    case gpu::Texture::CUBE_FACE_FRONT_NEG_Z: {
+        dir.x = 1.0f - invWidthBy2 * x;
+        dir.y = 1.0f - invWidthBy2 * y;
+        dir.z = - 1.0f;
+        break;
+    }
+    }
+    return glm::normalize(dir);
+}
+
+// The irradiance is low frequency, the texels of a face are averaged in blocks so that the harmonics are only evaluated
+// for this many blocks along each side of the face
+const int MAX_SH_BLOCKS_PER_FACE_SIDE = 64;
+
 bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<glm::vec3> & output, const uint order) {
     const uint sqOrder = order*order;
 
     // allocate memory for calculations
     output.resize(sqOrder);
-    std::vector<float> resultR(sqOrder);
-    std::vector<float> resultG(sqOrder);
-    std::vector<float> resultB(sqOrder);
+    std::vector<float> resultR(sqOrder, 0.0f);
+    std::vector<float> resultG(sqOrder, 0.0f);
+    std::vector<float> resultB(sqOrder, 0.0f);
 
     int width, height;
 
@@ -625,9 +700,6 @@ bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<
     float fWt = 0.0f;
     for(uint i=0; i < sqOrder; i++) {
         output[i] = glm::vec3(0.0f);
-        resultR[i] = 0.0f;
-        resultG[i] = 0;
-        resultB[i] = 0;
     }
     std::vector<float> shBuff(sqOrder);
     std::vector<float> shBuffB(sqOrder);
@@ -637,7 +709,21 @@ bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<
         return false;
     }
 
-    const float UCHAR_TO_FLOAT = 1.0f / float(std::numeric_limits<unsigned char>::max());
+    // the gamma corrected value of each byte, instead of a pow per texel
+    static const std::vector<float> SRGB_TO_LINEAR = [] {
+        const float GAMMA_CORRECTION = 2.2f;
+        const float UCHAR_TO_FLOAT = 1.0f / float(std::numeric_limits<unsigned char>::max());
+        std::vector<float> table(std::numeric_limits<unsigned char>::max() + 1);
+        for (size_t i = 0; i < table.size(); i++) {
+            table[i] = powf(float(i) * UCHAR_TO_FLOAT, GAMMA_CORRECTION);
+        }
+        return table;
+    }();
+
+    const int blockSize = std::max(1, (width + MAX_SH_BLOCKS_PER_FACE_SIDE - 1) / MAX_SH_BLOCKS_PER_FACE_SIDE);
+
+    // step between two texels for range [-1, 1]
+    const float invWidthBy2 = 2.0f / float(width);
 
     // for each face of cube texture
     for(int face=0; face < gpu::Texture::NUM_CUBE_FACES; face++) {
@@ -648,90 +734,40 @@ bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<
             continue;
         }
 
-        // step between two texels for range [0, 1]
-        float invWidth = 1.0f / float(width);
-        // initial negative bound for range [-1, 1]
-        float negativeBound = -1.0f + invWidth;
-        // step between two texels for range [-1, 1]
-        float invWidthBy2 = 2.0f / float(width);
-
-        for(int y=0; y < width; y++) {
-            // texture coordinate V in range [-1 to 1]
-            const float fV = negativeBound + float(y) * invWidthBy2;
-
-            for(int x=0; x < width; x++) {
-                // texture coordinate U in range [-1 to 1]
-                const float fU = negativeBound + float(x) * invWidthBy2;
-
-                // determine direction from center of cube texture to current texel
-                glm::vec3 dir;
-                switch(face) {
-                case gpu::Texture::CUBE_FACE_RIGHT_POS_X: {
-                    dir.x = 1.0f;
-                    dir.y = 1.0f - (invWidthBy2 * float(y) + invWidth);
-                    dir.z = 1.0f - (invWidthBy2 * float(x) + invWidth);
-                    dir = -dir;
-                    break;
-                }
-                case gpu::Texture::CUBE_FACE_LEFT_NEG_X: {
-                    dir.x = -1.0f;
-                    dir.y = 1.0f - (invWidthBy2 * float(y) + invWidth);
-                    dir.z = -1.0f + (invWidthBy2 * float(x) + invWidth);
-                    dir = -dir;
-                    break;
-                }
-                case gpu::Texture::CUBE_FACE_TOP_POS_Y: {
-                    dir.x = - 1.0f + (invWidthBy2 * float(x) + invWidth);
-                    dir.y = 1.0f;
-                    dir.z = - 1.0f + (invWidthBy2 * float(y) + invWidth);
-                    dir = -dir;
-                    break;
-                }
-                case gpu::Texture::CUBE_FACE_BOTTOM_NEG_Y: {
-                    dir.x = - 1.0f + (invWidthBy2 * float(x) + invWidth);
-                    dir.y = - 1.0f;
-                    dir.z = 1.0f - (invWidthBy2 * float(y) + invWidth);
-                    dir = -dir;
-                    break;
-                }
-                case gpu::Texture::CUBE_FACE_BACK_POS_Z: {
-                    dir.x = - 1.0f + (invWidthBy2 * float(x) + invWidth);
-                    dir.y = 1.0f - (invWidthBy2 * float(y) + invWidth);
-                    dir.z = 1.0f;
-                    break;
-                }
-                case gpu::Texture::CUBE_FACE_FRONT_NEG_Z: {
-                    dir.x = 1.0f - (invWidthBy2 * float(x) + invWidth);
-                    dir.y = 1.0f - (invWidthBy2 * float(y) + invWidth);
-                    dir.z = - 1.0f;
-                    break;
-                }
-                default:
-                    return false;
+        for (int blockY = 0; blockY < width; blockY += blockSize) {
+            const int endY = std::min(blockY + blockSize, width);
+
+            for (int blockX = 0; blockX < width; blockX += blockSize) {
+                const int endX = std::min(blockX + blockSize, width);
+
+                // average color of the block, in linear space
+                glm::vec3 clr(0.0f);
+                for (int y = blockY; y < endY; y++) {
+                    const Byte* texel = data + (blockX + y * width) * numComponents;
+                    for (int x = blockX; x < endX; x++, texel += numComponents) {
+                        clr += glm::vec3(SRGB_TO_LINEAR[texel[0]], SRGB_TO_LINEAR[texel[1]], SRGB_TO_LINEAR[texel[2]]);
+                    }
                 }
+                const float numTexels = float((endX - blockX) * (endY - blockY));
+                clr /= numTexels;
 
-                // normalize direction
-                dir = glm::normalize(dir);
+                // center of the block, and texture coordinates U and V in range [-1 to 1]
+                const float centerX = 0.5f * float(blockX + endX);
+                const float centerY = 0.5f * float(blockY + endY);
+                const float fU = -1.0f + centerX * invWidthBy2;
+                const float fV = -1.0f + centerY * invWidthBy2;
 
-                // scale factor depending on distance from center of the face
-                const float fDiffSolid = 4.0f / ((1.0f + fU*fU + fV*fV) *
+                // determine direction from center of cube texture to the block
+                glm::vec3 dir = cubeFaceDirection(face, centerX, centerY, invWidthBy2);
+
+                // scale factor depending on distance from center of the face, for all the texels of the block
+                const float fDiffSolid = numTexels * 4.0f / ((1.0f + fU*fU + fV*fV) *
                                             sqrtf(1.0f + fU*fU + fV*fV));
                 fWt += fDiffSolid;
 
                 // calculate coefficients of spherical harmonics for current direction
                 sphericalHarmonicsEvaluateDirection(shBuff.data(), order, dir);
 
-                // index of texel in texture
-                uint pixOffsetIndex = (x + y * width) * numComponents;
-
-                // get color from texture and map to range [0, 1]
-                glm::vec3 clr(float(data[pixOffsetIndex]) * UCHAR_TO_FLOAT,
-                            float(data[pixOffsetIndex+1]) * UCHAR_TO_FLOAT,
-                            float(data[pixOffsetIndex+2]) * UCHAR_TO_FLOAT);
-
-                // Gamma correct
-                clr = sRGBToLinear(clr);
-
                 // scale color and add to previously accumulated coefficients
                 sphericalHarmonicsScale(shBuffB.data(), order,
                         shBuff.data(), clr.r * fDiffSolid);
@@ -749,6 +785,10 @@ bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<
         }
     }
 
+    if (fWt == 0.0f) {
+        return false;
+    }
+
     // final scale for coefficients
     const float fNormProj = (4.0f * glm::pi<float>()) / fWt;
     sphericalHarmonicsScale(resultR.data(), order, resultR.data(), fNormProj);
@@ -14,6 +14,7 @@
 #include "Resource.h"
 
 #include <algorithm> //min max and more
+#include <atomic>
 
 #include <QUrl>
 
@@ -203,6 +204,9 @@ public:
         // THis should be only called by the Texture from the Backend to notify the storage that the specified mip face pixels
         //  have been uploaded to the GPU memory. IT is possible for the storage to free the system memory then
         virtual void notifyMipFaceGPULoaded(uint16 level, uint8 face) const;
+
+        // And the other way, the backend dropped the mip face from the GPU memory and gives back its pixels
+        virtual void notifyMipFaceGPUUnloaded(uint16 level, uint8 face, Size size, const Byte* bytes) const;
     };
 
  
@@ -279,16 +283,26 @@ public:
     uint16 evalMipHeight(uint16 level) const { return std::max(_height >> level, 1); }
     uint16 evalMipDepth(uint16 level) const { return std::max(_depth >> level, 1); }
 
+    // Size of the pixels of a face in a format, the compressed formats counting their blocks of 4x4 texels
+    static uint32 evalPixelsSize(const Element& format, uint16 width, uint16 height, uint16 depth) {
+        if (format.isCompressed()) {
+            return ((width + 3) / 4) * ((height + 3) / 4) * depth * format.getCompressedBlockSize();
+        }
+        return width * height * depth * format.getSize();
+    }
+
     // Size for each face of a mip at a particular level
     uint32 evalMipFaceNumTexels(uint16 level) const { return evalMipWidth(level) * evalMipHeight(level) * evalMipDepth(level); }
-    uint32 evalMipFaceSize(uint16 level) const { return evalMipFaceNumTexels(level) * getTexelFormat().getSize(); }
+    uint32 evalMipFaceSize(uint16 level) const { return evalStoredMipFaceSize(level, getTexelFormat()); }
     
     // Total size for the mip
     uint32 evalMipNumTexels(uint16 level) const { return evalMipFaceNumTexels(level) * getNumFaces(); }
-    uint32 evalMipSize(uint16 level) const { return evalMipNumTexels(level) * getTexelFormat().getSize(); }
+    uint32 evalMipSize(uint16 level) const { return evalMipFaceSize(level) * getNumFaces(); }
 
-    uint32 evalStoredMipFaceSize(uint16 level, const Element& format) const { return evalMipFaceNumTexels(level) * format.getSize(); }
-    uint32 evalStoredMipSize(uint16 level, const Element& format) const { return evalMipNumTexels(level) * format.getSize(); }
+    uint32 evalStoredMipFaceSize(uint16 level, const Element& format) const {
+        return evalPixelsSize(format, evalMipWidth(level), evalMipHeight(level), evalMipDepth(level));
+    }
+    uint32 evalStoredMipSize(uint16 level, const Element& format) const { return evalStoredMipFaceSize(level, format) * getNumFaces(); }
 
     uint32 evalTotalSize() const {
         uint32 size = 0;
@@ -345,6 +359,8 @@ public:
 
     // For Cube Texture, it's possible to generate the irradiance spherical harmonics and make them availalbe with the texture
     bool generateIrradiance();
+    // The irradiance generated earlier for the same cube, when it was cached
+    void overrideIrradiance(const SHPointer& irradiance) { _irradiance = irradiance; }
     const SHPointer& getIrradiance(uint16 slice = 0) const { return _irradiance; }
     bool isIrradianceValid() const { return _isIrradianceValid; }
 
@@ -355,8 +371,23 @@ public:
 
     // Only callable by the Backend
     void notifyMipFaceGPULoaded(uint16 level, uint8 face) const { return _storage->notifyMipFaceGPULoaded(level, face); }
+    void notifyMipFaceGPUUnloaded(uint16 level, uint8 face, Size size, const Byte* bytes) const {
+        return _storage->notifyMipFaceGPUUnloaded(level, face, size, bytes);
+    }
+
+    // The bytes of all the textures in the GPU memory, that the backend keeps under the budget by dropping the top mips
+    // of the textures rendered the longest ago
+    static int64_t getTextureGPUMemoryUsage() { return _textureGPUMemoryUsage; }
+    static int64_t getTextureGPUMemoryBudget() { return _textureGPUMemoryBudget; }
+    static void setTextureGPUMemoryBudget(int64_t budget) { _textureGPUMemoryBudget = budget; }
+
+    // Only callable by the Backend, when the GPU memory of a texture goes from prevSize to newSize bytes
+    static void updateTextureGPUMemoryUsage(int64_t prevSize, int64_t newSize) { _textureGPUMemoryUsage += newSize - prevSize; }
 
 protected:
+    static std::atomic<int64_t> _textureGPUMemoryUsage;
+    static std::atomic<int64_t> _textureGPUMemoryBudget;
+
     std::unique_ptr< Storage > _storage;
 
     Stamp _stamp = 0;
@@ -77,6 +77,10 @@ void SixenseManager::activate() {
 
     loadSettings();
     sixenseInit();
+
+    // the sdk is read on a thread of its own, so that the hands are as fresh as it has them
+    _inputDevice->setPolled(true);
+    startPolling(POLLS_PER_SECOND);
 #endif
 }
 
@@ -84,6 +88,9 @@ void SixenseManager::deactivate() {
     InputPlugin::deactivate();
 
 #ifdef HAVE_SIXENSE
+    stopPolling();
+    _inputDevice->setPolled(false);
+
     _container->removeMenuItem(MENU_NAME, TOGGLE_SMOOTH);
     _container->removeMenu(MENU_PATH);
 
@@ -106,14 +113,30 @@ void SixenseManager::setSixenseFilter(bool filter) {
 #endif
 }
 
+void SixenseManager::pluginFocusOutEvent() {
+    // the polling thread owns the maps, and replaces them on its next poll anyway
+    if (!isPolling()) {
+        _inputDevice->focusOutEvent();
+    }
+}
+
 void SixenseManager::pluginUpdate(float deltaTime, bool jointsCaptured) {
-    _inputDevice->update(deltaTime, jointsCaptured);
+    if (isPolling()) {
+        _jointsCaptured = jointsCaptured;
+    } else {
+        _inputDevice->update(deltaTime, jointsCaptured);
+    }
     if (_inputDevice->_requestReset) {
         _container->requestReset();
         _inputDevice->_requestReset = false;
     }
 }
 
+void SixenseManager::pollDevice(float deltaTime) {
+    _inputDevice->update(deltaTime, _jointsCaptured);
+    _inputDevice->publishState();
+}
+
 void SixenseManager::InputDevice::update(float deltaTime, bool jointsCaptured) {
 #ifdef HAVE_SIXENSE
     _buttonPressedMap.clear();
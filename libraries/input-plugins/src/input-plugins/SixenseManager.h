@@ -12,6 +12,8 @@
 #ifndef hifi_SixenseManager_h
 #define hifi_SixenseManager_h
 
+#include <atomic>
+
 #include <SimpleMovingAverage.h>
 
 #include <controllers/InputDevice.h>
@@ -35,7 +37,7 @@ public:
     virtual void activate() override;
     virtual void deactivate() override;
 
-    virtual void pluginFocusOutEvent() override { _inputDevice->focusOutEvent(); }
+    virtual void pluginFocusOutEvent() override;
     virtual void pluginUpdate(float deltaTime, bool jointsCaptured) override;
 
     virtual void saveSettings() const override;
@@ -44,7 +46,11 @@ public:
 public slots:
     void setSixenseFilter(bool filter);
 
+protected:
+    virtual void pollDevice(float deltaTime) override;
+
 private:
+    static const int POLLS_PER_SECOND = 100;
     static const int MAX_NUM_AVERAGING_SAMPLES = 50; // At ~100 updates per seconds this means averaging over ~.5s
     static const int CALIBRATION_STATE_IDLE = 0;
     static const int CALIBRATION_STATE_IN_PROGRESS = 1;
@@ -81,7 +87,7 @@ private:
         glm::quat _avatarRotation; // in hydra-frame
     
         float _lastDistance;
-        bool _requestReset { false };
+        std::atomic<bool> _requestReset { false };
         // these are measured values used to compute the calibration results
         quint64 _lockExpiry;
         glm::vec3 _averageLeft;
@@ -91,6 +97,7 @@ private:
     };
 
     std::shared_ptr<InputDevice> _inputDevice { std::make_shared<InputDevice>() };
+    std::atomic<bool> _jointsCaptured { false };
 
     static const QString NAME;
     static const QString HYDRA_ID_STRING;
@@ -11,11 +11,19 @@
 
 #include "ModelCache.h"
 
+#include <algorithm>
 #include <cmath>
 
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
 #include <QNetworkReply>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QThreadPool>
 
+#include <FBXSerializer.h>
 #include <FSTReader.h>
 #include <NumericalConstants.h>
 
@@ -51,6 +59,41 @@ GeometryReader::GeometryReader(const QUrl& url, const QByteArray& data, const QV
     _mapping(mapping) {
 }
 
+// The extracted geometry stays on disk, where it loads from next time without parsing the model or simplifying its
+// meshes again. The key covers the mapping and the content, so a change to either misses the cache.
+static QString getGeometryCachePath(const QUrl& url, const QVariantHash& mapping, const QByteArray& data) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(url.toEncoded());
+    hash.addData(QJsonDocument::fromVariant(mapping).toJson(QJsonDocument::Compact));
+    hash.addData(data);
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/geometry/" + hash.result().toHex() + ".fbxc";
+}
+
+static FBXGeometry* readCachedGeometry(const QString& cachePath, const QUrl& url) {
+    QFile cacheFile(cachePath);
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    uchar* mapped = cacheFile.map(0, cacheFile.size());
+    if (!mapped) {
+        return FBXSerializer::read(cacheFile.readAll(), url.toString());
+    }
+    FBXGeometry* geometry = FBXSerializer::read(QByteArray::fromRawData((const char*)mapped, cacheFile.size()),
+                                                url.toString());
+    cacheFile.unmap(mapped);
+    return geometry;
+}
+
+static void writeCachedGeometry(const QString& cachePath, const QUrl& url, const FBXGeometry& geometry) {
+    QSaveFile cacheFile(cachePath);
+    if (QDir().mkpath(QFileInfo(cachePath).path()) && cacheFile.open(QIODevice::WriteOnly)) {
+        cacheFile.write(FBXSerializer::write(geometry));
+        if (!cacheFile.commit()) {
+            qCDebug(modelnetworking) << "Failed to cache the geometry of" << url << "in" << cachePath;
+        }
+    }
+}
+
 void GeometryReader::run() {
     try {
         if (_data.isEmpty()) {
@@ -63,8 +106,14 @@ void GeometryReader::run() {
         urlValid &= _url.path().toLower().endsWith(".fbx") || _url.path().toLower().endsWith(".obj");
 
         if (urlValid) {
+            QString cachePath = getGeometryCachePath(_url, _mapping, _data);
+            FBXGeometry* fbxgeo = readCachedGeometry(cachePath, _url);
+            if (fbxgeo) {
+                emit onSuccess(fbxgeo);
+                return;
+            }
+
             // Let's read the binaries from the network
-            FBXGeometry* fbxgeo = nullptr;
             if (_url.path().toLower().endsWith(".fbx")) {
                 const bool grabLightmaps = true;
                 const float lightmapLevel = 1.0f;
@@ -75,6 +124,9 @@ void GeometryReader::run() {
                 QString errorStr("usupported format");
                 emit onError(NetworkGeometry::ModelParseError, errorStr);
             }
+            if (fbxgeo) {
+                writeCachedGeometry(cachePath, _url, *fbxgeo);
+            }
             emit onSuccess(fbxgeo);
         } else {
             throw QString("url is invalid");
@@ -121,7 +173,8 @@ void NetworkGeometry::attemptRequestInternal() {
 }
 
 bool NetworkGeometry::isLoaded() const {
-    return _state == SuccessState;
+    // a coarse level stays usable while the next one loads
+    return _state == SuccessState || _numLoadedLevels > 0;
 }
 
 bool NetworkGeometry::isLoadedWithTextures() const {
@@ -160,12 +213,37 @@ void NetworkGeometry::setTextureWithNameToURL(const QString& name, const QUrl& u
                 material->emissiveTexture = textureCache->getTexture(url);
             }
         }
+        applyLoadPriorityOperatorsToTextures();
     } else {
         qCWarning(modelnetworking) << "Ignoring setTextureWirthNameToURL() geometry not ready." << name << url;
     }
     _isLoadedWithTextures = false;
 }
 
+void NetworkGeometry::setLoadPriorityOperator(const QPointer<QObject>& owner, std::function<float()> priorityOperator) {
+    _loadPriorityOperators.insert(owner, priorityOperator);
+    applyLoadPriorityOperators(_resource);
+    applyLoadPriorityOperatorsToTextures();
+}
+
+void NetworkGeometry::applyLoadPriorityOperators(Resource* resource) const {
+    if (!resource) {
+        return;
+    }
+    for (auto it = _loadPriorityOperators.constBegin(); it != _loadPriorityOperators.constEnd(); it++) {
+        resource->setLoadPriorityOperator(it.key(), it.value());
+    }
+}
+
+void NetworkGeometry::applyLoadPriorityOperatorsToTextures() const {
+    for (auto&& material : _materials) {
+        applyLoadPriorityOperators(material->diffuseTexture.data());
+        applyLoadPriorityOperators(material->normalTexture.data());
+        applyLoadPriorityOperators(material->specularTexture.data());
+        applyLoadPriorityOperators(material->emissiveTexture.data());
+    }
+}
+
 QStringList NetworkGeometry::getTextureNames() const {
     QStringList result;
     for (auto&& material : _materials) {
@@ -199,6 +277,7 @@ void NetworkGeometry::requestMapping(const QUrl& url) {
         _resource->deleteLater();
     }
     _resource = new Resource(url, false);
+    applyLoadPriorityOperators(_resource);
     connect(_resource, &Resource::loaded, this, &NetworkGeometry::mappingRequestDone);
     connect(_resource, &Resource::failed, this, &NetworkGeometry::mappingRequestError);
 }
@@ -210,6 +289,7 @@ void NetworkGeometry::requestModel(const QUrl& url) {
     }
     _modelUrl = url;
     _resource = new Resource(url, false);
+    applyLoadPriorityOperators(_resource);
     connect(_resource, &Resource::loaded, this, &NetworkGeometry::modelRequestDone);
     connect(_resource, &Resource::failed, this, &NetworkGeometry::modelRequestError);
 }
@@ -235,8 +315,21 @@ void NetworkGeometry::mappingRequestDone(const QByteArray& data) {
             _textureBaseUrl = replyUrl.resolved(texdir);
         }
 
-        _modelUrl = replyUrl.resolved(modelUrlStr);
-        requestModel(_modelUrl);
+        // the lod models map to the distance they start at, the farthest being the coarsest
+        QVariantHash lods = _mapping.value(LOD_FIELD).toHash();
+        QList<QPair<float, QUrl>> levels;
+        for (auto it = lods.constBegin(); it != lods.constEnd(); it++) {
+            levels.append(qMakePair(-it.value().toFloat(), replyUrl.resolved(it.key())));
+        }
+        std::stable_sort(levels.begin(), levels.end(), [](const QPair<float, QUrl>& a, const QPair<float, QUrl>& b) {
+            return a.first < b.first;
+        });
+        _levelUrls.clear();
+        for (auto& level : levels) {
+            _levelUrls.append(level.second);
+        }
+        _levelUrls.append(replyUrl.resolved(modelUrlStr));
+        requestModel(_levelUrls.takeFirst());
     }
 }
 
@@ -261,10 +354,25 @@ void NetworkGeometry::modelRequestDone(const QByteArray& data) {
 
 void NetworkGeometry::modelRequestError(QNetworkReply::NetworkError error) {
     assert(_state == RequestModelState);
+    if (keepLoadedLevel()) {
+        return;
+    }
     _state = ErrorState;
     emit onFailure(*this, ModelRequestError);
 }
 
+bool NetworkGeometry::keepLoadedLevel() {
+    if (_numLoadedLevels == 0) {
+        return false;
+    }
+    qCDebug(modelnetworking) << "Failed to refine" << _url << "past" << _modelUrl << ", keeping the coarser level";
+    _levelUrls.clear();
+    _state = SuccessState;
+    delete _resource;
+    _resource = nullptr;
+    return true;
+}
+
 static NetworkMesh* buildNetworkMesh(const FBXMesh& mesh, const QUrl& textureBaseUrl) {
     NetworkMesh* networkMesh = new NetworkMesh();
 
@@ -326,10 +434,16 @@ static NetworkMaterial* buildNetworkMaterial(const FBXMaterial& material, const
 
 
 void NetworkGeometry::modelParseSuccess(FBXGeometry* geometry) {
-    // assume owner ship of geometry pointer
-    _geometry.reset(geometry);
-
-
+    // assume owner ship of geometry pointer, replacing any coarser level
+    {
+        QMutexLocker locker(&_pickDataLock);
+        _geometry.reset(geometry);
+        _pickData.reset();
+    }
+    _meshes.clear();
+    _materials.clear();
+    _shapes.clear();
+    _isLoadedWithTextures = false;
 
     foreach(const FBXMesh& mesh, _geometry->meshes) {
         _meshes.emplace_back(buildNetworkMesh(mesh, _textureBaseUrl));
@@ -340,6 +454,7 @@ void NetworkGeometry::modelParseSuccess(FBXGeometry* geometry) {
         fbxMatIDToMatID[material.materialID] = _materials.size();
         _materials.emplace_back(buildNetworkMaterial(material, _textureBaseUrl));
     }
+    applyLoadPriorityOperatorsToTextures();
 
 
     int meshID = 0;
@@ -356,14 +471,91 @@ void NetworkGeometry::modelParseSuccess(FBXGeometry* geometry) {
         meshID++;
     }
 
+    _numLoadedLevels++;
+    delete _resource;
+    _resource = nullptr;
+
+    if (!_levelUrls.isEmpty()) {
+        requestModel(_levelUrls.takeFirst());
+        emit onRefined(*this, *_geometry.get());
+        return;
+    }
     _state = SuccessState;
     emit onSuccess(*this, *_geometry.get());
+}
 
-    delete _resource;
-    _resource = nullptr;
+static GeometryPickDataPointer buildPickData(const FBXGeometry& geometry) {
+    auto pickData = std::make_shared<GeometryPickData>();
+    int numberOfMeshes = geometry.meshes.size();
+    pickData->meshTriangles.resize(numberOfMeshes);
+    for (int i = 0; i < numberOfMeshes; i++) {
+        const FBXMesh& mesh = geometry.meshes.at(i);
+        glm::mat4 meshToGeometry = geometry.offset * mesh.modelTransform;
+        QVector<glm::vec3> vertices;
+        vertices.reserve(mesh.vertices.size());
+        foreach (const glm::vec3& vertex, mesh.vertices) {
+            vertices.append(glm::vec3(meshToGeometry * glm::vec4(vertex, 1.0f)));
+        }
+
+        QVector<Triangle>& meshTriangles = pickData->meshTriangles[i];
+        for (int j = 0; j < mesh.parts.size(); j++) {
+            const FBXMeshPart& part = mesh.parts.at(j);
+            AABox partBounds;
+            bool atLeastOnePointInBounds = false;
+            auto addToBounds = [&](const glm::vec3& point) {
+                if (!atLeastOnePointInBounds) {
+                    partBounds.setBox(point, 0.0f);
+                    atLeastOnePointInBounds = true;
+                } else {
+                    partBounds += point;
+                }
+            };
+
+            const int INDICES_PER_QUAD = 4;
+            for (int q = 0; q + INDICES_PER_QUAD <= part.quadIndices.size(); q += INDICES_PER_QUAD) {
+                const glm::vec3& v0 = vertices.at(part.quadIndices.at(q));
+                const glm::vec3& v1 = vertices.at(part.quadIndices.at(q + 1));
+                const glm::vec3& v2 = vertices.at(part.quadIndices.at(q + 2));
+                const glm::vec3& v3 = vertices.at(part.quadIndices.at(q + 3));
+                addToBounds(v0);
+                addToBounds(v1);
+                addToBounds(v2);
+                addToBounds(v3);
+
+                // Sam's recommended triangle slices
+                meshTriangles.push_back({ v0, v1, v3 });
+                meshTriangles.push_back({ v1, v2, v3 });
+            }
+
+            const int INDICES_PER_TRIANGLE = 3;
+            for (int t = 0; t + INDICES_PER_TRIANGLE <= part.triangleIndices.size(); t += INDICES_PER_TRIANGLE) {
+                const glm::vec3& v0 = vertices.at(part.triangleIndices.at(t));
+                const glm::vec3& v1 = vertices.at(part.triangleIndices.at(t + 1));
+                const glm::vec3& v2 = vertices.at(part.triangleIndices.at(t + 2));
+                addToBounds(v0);
+                addToBounds(v1);
+                addToBounds(v2);
+
+                meshTriangles.push_back({ v0, v1, v2 });
+            }
+            pickData->meshPartBoxes[QPair<int, int>(i, j)] = partBounds;
+        }
+    }
+    return pickData;
+}
+
+GeometryPickDataPointer NetworkGeometry::getPickData() const {
+    QMutexLocker locker(&_pickDataLock);
+    if (!_pickData && _geometry) {
+        _pickData = buildPickData(*_geometry);
+    }
+    return _pickData;
 }
 
 void NetworkGeometry::modelParseError(int error, QString str) {
+    if (keepLoadedLevel()) {
+        return;
+    }
     _state = ErrorState;
     emit onFailure(*this, (NetworkGeometry::Error)error);
 
@@ -12,10 +12,15 @@
 #ifndef hifi_ModelCache_h
 #define hifi_ModelCache_h
 
+#include <memory>
+
 #include <QMap>
+#include <QMutex>
 #include <QRunnable>
 
+#include <AABox.h>
 #include <DependencyManager.h>
+#include <GeometryUtil.h>
 #include <ResourceCache.h>
 
 #include "FBXReader.h"
@@ -34,6 +39,15 @@ class NetworkTexture;
 class NetworkMaterial;
 class NetworkShape;
 
+/// The triangles of the meshes of a geometry and the boxes of their parts, in the frame of the geometry (with the
+/// transforms of the meshes and the offset of the mapping applied), built once for every model showing it.
+class GeometryPickData {
+public:
+    QVector<QVector<Triangle>> meshTriangles;
+    QHash<QPair<int, int>, AABox> meshPartBoxes;
+};
+using GeometryPickDataPointer = std::shared_ptr<const GeometryPickData>;
+
 /// Stores cached geometry.
 class ModelCache : public ResourceCache, public Dependency {
     Q_OBJECT
@@ -75,12 +89,22 @@ public:
     // true when the geometry is loaded (but maybe not it's associated textures)
     bool isLoaded() const;
 
+    // The lod models of the mapping load first, the coarsest first, each replacing the last until the full model.
+    // Counts the levels loaded so far, for the owners to rebuild when a finer one comes in.
+    int getNumLoadedLevels() const { return _numLoadedLevels; }
+
+    // true while a finer level is still to come
+    bool isRefining() const { return !_levelUrls.isEmpty() || (_numLoadedLevels > 0 && _state != SuccessState); }
+
     // true when the requested geometry and its textures are loaded.
     bool isLoadedWithTextures() const;
 
     // WARNING: only valid when isLoaded returns true.
     const FBXGeometry& getFBXGeometry() const { return *_geometry; }
     const std::vector<std::unique_ptr<NetworkMesh>>& getMeshes() const { return _meshes; }
+
+    // The pick triangles of the loaded level, built on the first call, from any thread
+    GeometryPickDataPointer getPickData() const;
   //  const model::AssetPointer getAsset() const { return _asset; }
 
    // model::MeshPointer getShapeMesh(int shapeID);
@@ -94,6 +118,9 @@ public:
     void setTextureWithNameToURL(const QString& name, const QUrl& url);
     QStringList getTextureNames() const;
 
+    // The priority of the owner goes to the requests of the geometry and of its textures
+    void setLoadPriorityOperator(const QPointer<QObject>& owner, std::function<float()> priorityOperator);
+
     enum Error {
         MissingFilenameInMapping = 0,
         MappingRequestError,
@@ -105,6 +132,9 @@ signals:
     // Fired when everything has downloaded and parsed successfully.
     void onSuccess(NetworkGeometry& networkGeometry, FBXGeometry& fbxGeometry);
 
+    // Fired when a coarse level of the model is loaded, usable until the next one replaces it.
+    void onRefined(NetworkGeometry& networkGeometry, FBXGeometry& fbxGeometry);
+
     // Fired when something went wrong.
     void onFailure(NetworkGeometry& networkGeometry, Error error);
 
@@ -122,6 +152,9 @@ protected:
     void attemptRequestInternal();
     void requestMapping(const QUrl& url);
     void requestModel(const QUrl& url);
+    bool keepLoadedLevel();
+    void applyLoadPriorityOperators(Resource* resource) const;
+    void applyLoadPriorityOperatorsToTextures() const;
 
     enum State { DelayState,
                  RequestMappingState,
@@ -134,11 +167,16 @@ protected:
     QUrl _url;
     QUrl _mappingUrl;
     QUrl _modelUrl;
+    QList<QUrl> _levelUrls; // the finer levels still to load, the full model last
+    int _numLoadedLevels = 0;
     QVariantHash _mapping;
     QUrl _textureBaseUrl;
 
     Resource* _resource = nullptr;
+    QHash<QPointer<QObject>, std::function<float()>> _loadPriorityOperators;
     std::unique_ptr<FBXGeometry> _geometry; // This should go away evenutally once we can put everything we need in the model::AssetPointer
+    mutable QMutex _pickDataLock; // also held while the geometry is replaced, that the pick data is built from
+    mutable GeometryPickDataPointer _pickData;
     std::vector<std::unique_ptr<NetworkMesh>> _meshes;
     std::vector<std::unique_ptr<NetworkMaterial>> _materials;
     std::vector<std::unique_ptr<NetworkShape>> _shapes;
@@ -16,9 +16,16 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/random.hpp>
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QNetworkReply>
 #include <QPainter>
 #include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QThreadPool>
 #include <qimagereader.h>
 #include <PathUtils.h>
@@ -295,11 +302,95 @@ void listSupportedImageFormats() {
     });
 }
 
+// The textures that get compressed keep their blocks on disk, where they load from next time without decoding or
+// compressing the image again. The key covers the content, so a changed image at the same url misses the cache.
+static bool isCompressedTextureType(TextureType type) {
+    return type == DEFAULT_TEXTURE || type == SPECULAR_TEXTURE || type == EMISSIVE_TEXTURE || type == NORMAL_TEXTURE;
+}
+
+static QString getCachePath(const QUrl& url, TextureType type, const QByteArray& content, const QString& extension) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(url.toEncoded());
+    hash.addData(QByteArray::number((int)type));
+    hash.addData(content);
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/ktx/" + hash.result().toHex() + extension;
+}
+
+static QString getKTXCachePath(const QUrl& url, TextureType type, const QByteArray& content) {
+    return getCachePath(url, type, content, ".ktx");
+}
+
+// The cubemaps are not compressed, but the irradiance evaluated from their texels is kept beside the KTX files so that
+// a skybox seen before does not walk its faces again
+static const quint32 IRRADIANCE_CACHE_VERSION = 1;
+
+static QString getIrradianceCachePath(const QUrl& url, const QByteArray& content) {
+    return getCachePath(url, CUBE_TEXTURE, content, ".sh");
+}
+
+static gpu::SHPointer readIrradiance(const QString& cachePath) {
+    QFile cacheFile(cachePath);
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        return gpu::SHPointer();
+    }
+    QDataStream stream(&cacheFile);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    quint32 version;
+    stream >> version;
+    if (version != IRRADIANCE_CACHE_VERSION) {
+        return gpu::SHPointer();
+    }
+    auto irradiance = std::make_shared<gpu::SphericalHarmonics>();
+    for (glm::vec3* coefficient : { &irradiance->L00, &irradiance->L1m1, &irradiance->L10, &irradiance->L11,
+            &irradiance->L2m2, &irradiance->L2m1, &irradiance->L20, &irradiance->L21, &irradiance->L22 }) {
+        stream >> coefficient->x >> coefficient->y >> coefficient->z;
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return gpu::SHPointer();
+    }
+    return irradiance;
+}
+
+static void writeIrradiance(const QString& cachePath, const gpu::SphericalHarmonics& irradiance) {
+    QSaveFile cacheFile(cachePath);
+    if (!QDir().mkpath(QFileInfo(cachePath).path()) || !cacheFile.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream stream(&cacheFile);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << IRRADIANCE_CACHE_VERSION;
+    for (const glm::vec3& coefficient : { irradiance.L00, irradiance.L1m1, irradiance.L10, irradiance.L11,
+            irradiance.L2m2, irradiance.L2m1, irradiance.L20, irradiance.L21, irradiance.L22 }) {
+        stream << coefficient.x << coefficient.y << coefficient.z;
+    }
+    if (!cacheFile.commit()) {
+        qCDebug(modelnetworking) << "Failed to cache the irradiance in" << cachePath;
+    }
+}
+
 void ImageReader::run() {
     QSharedPointer<Resource> texture = _texture.toStrongRef();
     if (texture.isNull()) {
         return;
     }
+    auto ntex = dynamic_cast<NetworkTexture*>(&*texture);
+    bool isCached = ntex && isCompressedTextureType(ntex->getType());
+
+    QString cachePath;
+    if (isCached) {
+        cachePath = getKTXCachePath(_url, ntex->getType(), _content);
+        QFile cacheFile(cachePath);
+        if (cacheFile.open(QIODevice::ReadOnly)) {
+            gpu::Texture* theTexture = model::TextureUsage::createTextureFromKTX(cacheFile.readAll(), _url.toString().toStdString());
+            if (theTexture) {
+                QMetaObject::invokeMethod(texture.data(), "setImage",
+                    Q_ARG(const QImage&, QImage()),
+                    Q_ARG(void*, theTexture),
+                    Q_ARG(int, theTexture->getWidth()), Q_ARG(int, theTexture->getHeight()));
+                return;
+            }
+        }
+    }
 
     listSupportedImageFormats();
 
@@ -324,11 +415,35 @@ void ImageReader::run() {
     }
 
     gpu::Texture* theTexture = nullptr;
-    auto ntex = dynamic_cast<NetworkTexture*>(&*texture);
-    if (ntex) {
+    if (ntex && ntex->getType() == CUBE_TEXTURE) {
+        QString irradiancePath = getIrradianceCachePath(_url, _content);
+        gpu::SHPointer irradiance = readIrradiance(irradiancePath);
+        if (irradiance) {
+            theTexture = model::TextureUsage::createCubeTextureFromImageWithoutIrradiance(image, _url.toString().toStdString());
+            if (theTexture) {
+                theTexture->overrideIrradiance(irradiance);
+            }
+        } else {
+            theTexture = ntex->getTextureLoader()(image, _url.toString().toStdString());
+            if (theTexture && theTexture->getIrradiance()) {
+                writeIrradiance(irradiancePath, *theTexture->getIrradiance());
+            }
+        }
+    } else if (ntex) {
         theTexture = ntex->getTextureLoader()(image, _url.toString().toStdString());
     }
 
+    if (isCached && theTexture) {
+        QByteArray ktx = model::TextureUsage::writeKTX(*theTexture);
+        QSaveFile cacheFile(cachePath);
+        if (!ktx.isEmpty() && QDir().mkpath(QFileInfo(cachePath).path()) && cacheFile.open(QIODevice::WriteOnly)) {
+            cacheFile.write(ktx);
+            if (!cacheFile.commit()) {
+                qCDebug(modelnetworking) << "Failed to cache the compressed texture" << _url << "in" << cachePath;
+            }
+        }
+    }
+
     QMetaObject::invokeMethod(texture.data(), "setImage", 
         Q_ARG(const QImage&, image),
         Q_ARG(void*, theTexture),
@@ -121,6 +121,7 @@ public:
     int getOriginalHeight() const { return _originalHeight; }
     int getWidth() const { return _width; }
     int getHeight() const { return _height; }
+    TextureType getType() const { return _type; }
     
     TextureLoaderFunc getTextureLoader() const;
     
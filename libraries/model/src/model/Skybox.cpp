@@ -112,24 +112,38 @@ void Skybox::render(gpu::Batch& batch, const ViewFrustum& viewFrustum, const Sky
 
     Transform viewTransform;
     viewFrustum.evalViewTransform(viewTransform);
-    batch.setProjectionTransform(projMat);
-    batch.setViewTransform(viewTransform);
-    batch.setModelTransform(Transform()); // only for Mac
-    batch.setInputBuffer(gpu::Stream::POSITION, theBuffer, 0, 8);
-    batch.setInputFormat(theFormat);
 
     gpu::TexturePointer skymap;
     if (skybox.getCubemap() && skybox.getCubemap()->isDefined()) {
         skymap = skybox.getCubemap();
     }
 
-    batch.setPipeline(thePipeline);
-    batch.setUniformBuffer(SKYBOX_CONSTANTS_SLOT, skybox._dataBuffer);
-    batch.setResourceTexture(SKYBOX_SKYMAP_SLOT, skymap);
-
-    batch.draw(gpu::TRIANGLE_STRIP, 4);
-
-    batch.setResourceTexture(SKYBOX_SKYMAP_SLOT, nullptr);
+    // record the commands again only when the cubemap changed
+    if (!skybox._retainedBatch || skybox._retainedSkymap != skymap) {
+        auto retained = std::make_shared<gpu::Batch>();
+        skybox._projectionCommand = retained->getCommands().size();
+        retained->setProjectionTransform(projMat);
+        skybox._viewCommand = retained->getCommands().size();
+        retained->setViewTransform(viewTransform);
+        retained->setModelTransform(Transform()); // only for Mac
+        retained->setInputBuffer(gpu::Stream::POSITION, theBuffer, 0, 8);
+        retained->setInputFormat(theFormat);
+
+        retained->setPipeline(thePipeline);
+        retained->setUniformBuffer(SKYBOX_CONSTANTS_SLOT, skybox._dataBuffer);
+        retained->setResourceTexture(SKYBOX_SKYMAP_SLOT, skymap);
+
+        retained->draw(gpu::TRIANGLE_STRIP, 4);
+
+        retained->setResourceTexture(SKYBOX_SKYMAP_SLOT, nullptr);
+
+        skybox._retainedBatch = retained;
+        skybox._retainedSkymap = skymap;
+    } else {
+        skybox._retainedBatch->patchProjectionTransform(skybox._projectionCommand, projMat);
+        skybox._retainedBatch->patchViewTransform(skybox._viewCommand, viewTransform);
+    }
 
+    batch.executeBatch(skybox._retainedBatch);
 }
 
@@ -51,6 +51,12 @@ protected:
 
     mutable gpu::BufferView _dataBuffer;
 
+    // The commands of the skybox are recorded once, each frame only patches its view and projection
+    mutable std::shared_ptr<gpu::Batch> _retainedBatch;
+    mutable gpu::TexturePointer _retainedSkymap;
+    mutable size_t _projectionCommand { 0 };
+    mutable size_t _viewCommand { 0 };
+
     void updateDataBuffer() const;
 };
 typedef std::shared_ptr< Skybox > SkyboxPointer;
@@ -14,6 +14,9 @@
 #include <QPainter>
 #include <QDebug>
 
+#include <BlockCompression.h>
+#include <KTX.h>
+
 #include "ModelLogging.h"
 
 using namespace model;
@@ -52,6 +55,49 @@ void TextureMap::setLightmapOffsetScale(float offset, float scale) {
 
 
 
+// The sub mips get built here on the thread decoding the image rather than by the gpu when the texture first gets used,
+// so the backend can upload the texture over several frames from its smallest mip
+static void generateMips(gpu::Texture* texture, const QImage& image, const gpu::Element& formatMip) {
+    QImage mip = image;
+    uint16 numMips = texture->evalNumMips();
+    for (uint16 level = 1; level < numMips; level++) {
+        mip = mip.scaled(texture->evalMipWidth(level), texture->evalMipHeight(level),
+                         Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(image.format());
+        texture->assignStoredMip(level, formatMip, mip.byteCount(), mip.constBits());
+    }
+}
+
+// The gl formats of the compressed textures in their KTX files
+class KTXFormat {
+public:
+    gpu::Element element;
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+};
+static const KTXFormat KTX_FORMATS[] = {
+    { gpu::Element(gpu::VEC3, gpu::NUINT8, gpu::COMPRESSED_BC1_RGB), 0x83F0, 0x1907 }, // DXT1 RGB, RGB
+    { gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::COMPRESSED_BC3_RGBA), 0x83F3, 0x1908 }, // DXT5 RGBA, RGBA
+    { gpu::Element(gpu::VEC2, gpu::NUINT8, gpu::COMPRESSED_BC5_XY), 0x8DBD, 0x8227 }, // RGTC2 RG, RG
+};
+
+// The mips get compressed on the thread decoding the image, to an eighth or a quarter of their 32 bit pixels
+static gpu::Texture* createCompressedTexture(const QImage& image, BlockCompression::Format format, const gpu::Element& formatGPU) {
+    QImage mip = image.convertToFormat(QImage::Format_ARGB32);
+    gpu::Texture* texture = gpu::Texture::create2D(formatGPU, mip.width(), mip.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR));
+
+    uint16 numMips = texture->evalNumMips();
+    for (uint16 level = 0; level < numMips; level++) {
+        if (level > 0) {
+            mip = mip.scaled(texture->evalMipWidth(level), texture->evalMipHeight(level),
+                             Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(QImage::Format_ARGB32);
+        }
+        QByteArray blocks = BlockCompression::compress(format, reinterpret_cast<const QRgb*>(mip.constBits()),
+                                                       mip.width(), mip.height(), mip.bytesPerLine() / sizeof(QRgb));
+        texture->assignStoredMip(level, formatGPU, blocks.size(), reinterpret_cast<const gpu::Byte*>(blocks.constData()));
+    }
+    return texture;
+}
+
 gpu::Texture* TextureUsage::create2DTextureFromImage(const QImage& srcImage, const std::string& srcImageName) {
     QImage image = srcImage;
  
@@ -118,20 +164,12 @@ gpu::Texture* TextureUsage::create2DTextureFromImage(const QImage& srcImage, con
     gpu::Texture* theTexture = nullptr;
     if ((image.width() > 0) && (image.height() > 0)) {
         
-        // bool isLinearRGB = true; //(_type == NORMAL_TEXTURE) || (_type == EMISSIVE_TEXTURE);
-        bool isLinearRGB = true; //(_type == NORMAL_TEXTURE) || (_type == EMISSIVE_TEXTURE);
-        
-        gpu::Element formatGPU = gpu::Element(gpu::VEC3, gpu::UINT8, (isLinearRGB ? gpu::RGB : gpu::SRGB));
-        gpu::Element formatMip = gpu::Element(gpu::VEC3, gpu::UINT8, (isLinearRGB ? gpu::RGB : gpu::SRGB));
+        // The opaque images go to BC1, the ones with an alpha to BC3
         if (image.hasAlphaChannel()) {
-            formatGPU = gpu::Element(gpu::VEC4, gpu::UINT8, (isLinearRGB ? gpu::RGBA : gpu::SRGBA));
-            formatMip = gpu::Element(gpu::VEC4, gpu::UINT8, (isLinearRGB ? gpu::BGRA : gpu::SBGRA));
+            theTexture = createCompressedTexture(image, BlockCompression::BC3, KTX_FORMATS[1].element);
+        } else {
+            theTexture = createCompressedTexture(image, BlockCompression::BC1, KTX_FORMATS[0].element);
         }
-        
-
-            theTexture = (gpu::Texture::create2D(formatGPU, image.width(), image.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
-            theTexture->assignStoredMip(0, formatMip, image.byteCount(), image.constBits());
-            theTexture->autoGenerateMips(-1);
     }
     
     return theTexture;
@@ -154,18 +192,8 @@ gpu::Texture* TextureUsage::createNormalTextureFromNormalImage(const QImage& src
     gpu::Texture* theTexture = nullptr;
     if ((image.width() > 0) && (image.height() > 0)) {
 
-        bool isLinearRGB = true;
-
-        gpu::Element formatGPU = gpu::Element(gpu::VEC3, gpu::UINT8, (isLinearRGB ? gpu::RGB : gpu::SRGB));
-        gpu::Element formatMip = gpu::Element(gpu::VEC3, gpu::UINT8, (isLinearRGB ? gpu::RGB : gpu::SRGB));
-        if (image.hasAlphaChannel()) {
-            formatGPU = gpu::Element(gpu::VEC4, gpu::UINT8, (isLinearRGB ? gpu::RGBA : gpu::SRGBA));
-            formatMip = gpu::Element(gpu::VEC4, gpu::UINT8, (isLinearRGB ? gpu::BGRA : gpu::SBGRA));
-        }
-
-        theTexture = (gpu::Texture::create2D(formatGPU, image.width(), image.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
-        theTexture->assignStoredMip(0, formatMip, image.byteCount(), image.constBits());
-        theTexture->autoGenerateMips(-1);
+        // The normals keep their x and y in BC5, the shaders rebuild the z
+        theTexture = createCompressedTexture(image, BlockCompression::BC5, KTX_FORMATS[2].element);
     }
 
     return theTexture;
@@ -256,12 +284,69 @@ gpu::Texture* TextureUsage::createNormalTextureFromBumpImage(const QImage& srcIm
         
         theTexture = (gpu::Texture::create2D(formatGPU, image.width(), image.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
         theTexture->assignStoredMip(0, formatMip, image.byteCount(), image.constBits());
-        theTexture->autoGenerateMips(-1);
+        generateMips(theTexture, image, formatMip);
     }
     
     return theTexture;
 }
 
+QByteArray TextureUsage::writeKTX(const gpu::Texture& texture) {
+    KTX::Image image;
+    bool isKTXFormat = false;
+    for (auto& format : KTX_FORMATS) {
+        if (format.element == texture.getTexelFormat()) {
+            image.glInternalFormat = format.glInternalFormat;
+            image.glBaseInternalFormat = format.glBaseInternalFormat;
+            isKTXFormat = true;
+        }
+    }
+    if (!isKTXFormat || texture.getType() != gpu::Texture::TEX_2D) {
+        return QByteArray();
+    }
+    image.width = texture.getWidth();
+    image.height = texture.getHeight();
+
+    for (uint16 level = 0; level <= texture.maxMip(); level++) {
+        if (!texture.isStoredMipFaceAvailable(level)) {
+            return QByteArray();
+        }
+        const auto& sysmem = texture.accessStoredMipFace(level)->_sysmem;
+        image.mips.push_back(QByteArray(reinterpret_cast<const char*>(sysmem.readData()), (int)sysmem.getSize()));
+    }
+    return KTX::write(image);
+}
+
+gpu::Texture* TextureUsage::createTextureFromKTX(const QByteArray& data, const std::string& srcImageName) {
+    KTX::Image image;
+    if (!KTX::read(data, image)) {
+        qCDebug(modelLog) << "Invalid KTX file for" << QString(srcImageName.c_str());
+        return nullptr;
+    }
+    const KTXFormat* ktxFormat = nullptr;
+    for (auto& format : KTX_FORMATS) {
+        if (format.glInternalFormat == image.glInternalFormat) {
+            ktxFormat = &format;
+        }
+    }
+    const uint32_t MAX_DIMENSION = 0xFFFF;
+    if (!ktxFormat || image.width == 0 || image.height == 0 || image.width > MAX_DIMENSION || image.height > MAX_DIMENSION) {
+        qCDebug(modelLog) << "Unsupported KTX file for" << QString(srcImageName.c_str());
+        return nullptr;
+    }
+
+    gpu::Texture* texture = gpu::Texture::create2D(ktxFormat->element, image.width, image.height,
+                                                   gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR));
+    for (int level = 0; level < image.mips.size(); level++) {
+        const QByteArray& mip = image.mips[level];
+        if (!texture->assignStoredMip(level, ktxFormat->element, mip.size(), reinterpret_cast<const gpu::Byte*>(mip.constData()))) {
+            qCDebug(modelLog) << "Invalid mip" << level << "in the KTX file for" << QString(srcImageName.c_str());
+            delete texture;
+            return nullptr;
+        }
+    }
+    return texture;
+}
+
 class CubeLayout {
 public:
     int _widthRatio = 1;
@@ -297,6 +382,15 @@ public:
 };
 
 gpu::Texture* TextureUsage::createCubeTextureFromImage(const QImage& srcImage, const std::string& srcImageName) {
+    gpu::Texture* theTexture = createCubeTextureFromImageWithoutIrradiance(srcImage, srcImageName);
+    if (theTexture) {
+        // GEnerate irradiance while we are at it
+        theTexture->generateIrradiance();
+    }
+    return theTexture;
+}
+
+gpu::Texture* TextureUsage::createCubeTextureFromImageWithoutIrradiance(const QImage& srcImage, const std::string& srcImageName) {
     QImage image = srcImage;
     
     int imageArea = image.width() * image.height();
@@ -512,9 +606,6 @@ gpu::Texture* TextureUsage::createCubeTextureFromImage(const QImage& srcImage, c
                     theTexture->assignStoredMipFace(0, formatMip, face.byteCount(), face.constBits(), f);
                     f++;
                 }
-                
-                // GEnerate irradiance while we are at it
-                theTexture->generateIrradiance();
             }
     }
     
@@ -18,6 +18,7 @@
 
 #include <qurl.h>
 
+class QByteArray;
 class QImage;
 
 namespace model {
@@ -35,6 +36,12 @@ public:
     static gpu::Texture* createNormalTextureFromNormalImage(const QImage& image, const std::string& srcImageName);
     static gpu::Texture* createNormalTextureFromBumpImage(const QImage& image, const std::string& srcImageName);
     static gpu::Texture* createCubeTextureFromImage(const QImage& image, const std::string& srcImageName);
+    // The cube alone, for when its irradiance is already known
+    static gpu::Texture* createCubeTextureFromImageWithoutIrradiance(const QImage& image, const std::string& srcImageName);
+
+    // The compressed 2D textures saved as KTX files, an empty array for any other texture or once its mips left the sysmem
+    static QByteArray writeKTX(const gpu::Texture& texture);
+    static gpu::Texture* createTextureFromKTX(const QByteArray& data, const std::string& srcImageName);
 };
 
 
@@ -11,7 +11,9 @@
 
 #include <QApplication>
 #include <QClipboard>
+#include <QDateTime>
 #include <QDebug>
+#include <QHostInfo>
 #include <QJsonDocument>
 #include <QRegExp>
 #include <QStringList>
@@ -29,6 +31,16 @@ const QString ADDRESS_MANAGER_SETTINGS_GROUP = "AddressManager";
 const QString SETTINGS_CURRENT_ADDRESS_KEY = "address";
 
 Setting::Handle<QUrl> currentAddressHandle(QStringList() << ADDRESS_MANAGER_SETTINGS_GROUP << "address", DEFAULT_HIFI_ADDRESS);
+Setting::Handle<QVariantMap> lookupCacheHandle(QStringList() << ADDRESS_MANAGER_SETTINGS_GROUP << "lookupCache");
+
+const QString GET_DOMAIN_ID = "/api/v1/domains/%1";
+
+const char OVERRIDE_PATH_KEY[] = "override_path";
+const char LOOKUP_TRIGGER_KEY[] = "lookup_trigger";
+const char LOOKUP_CACHE_KEY[] = "lookup_cache_key";
+
+const QString LOOKUP_CACHE_TIME_KEY = "time";
+const QString LOOKUP_CACHE_DATA_KEY = "data";
 
 AddressManager::AddressManager() :
     _port(0)
@@ -115,6 +127,21 @@ const QString AddressManager::currentPath(bool withOrientation) const {
     }
 }
 
+const JSONCallbackParameters& AddressManager::prefetchCallbackParameters() {
+    static bool hasSetupParameters = false;
+    static JSONCallbackParameters callbackParams;
+
+    if (!hasSetupParameters) {
+        callbackParams.jsonCallbackReceiver = this;
+        callbackParams.jsonCallbackMethod = "handlePrefetchResponse";
+        callbackParams.errorCallbackReceiver = this;
+        callbackParams.errorCallbackMethod = "handlePrefetchError";
+        hasSetupParameters = true;
+    }
+
+    return callbackParams;
+}
+
 const JSONCallbackParameters& AddressManager::apiCallbackParameters() {
     static bool hasSetupParameters = false;
     static JSONCallbackParameters callbackParams;
@@ -176,63 +203,131 @@ bool AddressManager::handleUrl(const QUrl& lookupUrl, LookupTrigger trigger) {
     return false;
 }
 
+QUrl AddressManager::urlFromLookupString(const QString& lookupString) {
+    // make this a valid hifi URL
+    QString sanitizedString = lookupString.trimmed();
+
+    if (!lookupString.startsWith('/')) {
+        const QRegExp HIFI_SCHEME_REGEX = QRegExp(HIFI_URL_SCHEME + ":\\/{1,2}", Qt::CaseInsensitive);
+        sanitizedString = sanitizedString.remove(HIFI_SCHEME_REGEX);
+
+        return QUrl(HIFI_URL_SCHEME + "://" + sanitizedString);
+    } else {
+        return QUrl(lookupString);
+    }
+}
+
 void AddressManager::handleLookupString(const QString& lookupString) {
     if (!lookupString.isEmpty()) {
         // make this a valid hifi URL and handle it off to handleUrl
-        QString sanitizedString = lookupString.trimmed();
-        QUrl lookupURL;
+        handleUrl(urlFromLookupString(lookupString));
+    }
+}
 
-        if (!lookupString.startsWith('/')) {
-            const QRegExp HIFI_SCHEME_REGEX = QRegExp(HIFI_URL_SCHEME + ":\\/{1,2}", Qt::CaseInsensitive);
-            sanitizedString = sanitizedString.remove(HIFI_SCHEME_REGEX);
+void AddressManager::prefetchLookupString(const QString& lookupString) {
+    if (lookupString.isEmpty() || lookupString.startsWith('/')) {
+        return;
+    }
 
-            lookupURL = QUrl(HIFI_URL_SCHEME + "://" + sanitizedString);
-        } else {
-            lookupURL = QUrl(lookupString);
-        }
+    QUrl lookupUrl = urlFromLookupString(lookupString);
+    if (lookupUrl.authority().startsWith('@')) {
+        // a user moves around, where they are is looked up when we go to them
+        return;
+    }
+
+    QString hostname;
+    quint16 port;
+    if (parseNetworkAddress(lookupUrl.host(), hostname, port)) {
+        QHostInfo::lookupHost(hostname, this, SLOT(handleWarmUpLookup(const QHostInfo&)));
+        return;
+    }
 
-        handleUrl(lookupURL);
+    QString cacheKey = lookupUrl.host().toLower();
+    QVariantMap dataObject;
+    if (getCachedLookup(cacheKey, dataObject)) {
+        warmUpDomainHostname(dataObject);
+    } else if (!_pendingPrefetches.contains(cacheKey)) {
+        _pendingPrefetches.insert(cacheKey);
+
+        QVariantMap requestParams;
+        requestParams.insert(LOOKUP_CACHE_KEY, cacheKey);
+
+        QString lookupPath = handleDomainID(lookupUrl.host()) ? GET_DOMAIN_ID : GET_PLACE;
+        AccountManager::getInstance().sendRequest(lookupPath.arg(QString(QUrl::toPercentEncoding(lookupUrl.host()))),
+                                                  AccountManagerAuth::None,
+                                                  QNetworkAccessManager::GetOperation,
+                                                  prefetchCallbackParameters(),
+                                                  QByteArray(), NULL, requestParams);
     }
 }
 
 const QString DATA_OBJECT_DOMAIN_KEY = "domain";
 
+const QString LOCATION_API_ROOT_KEY = "root";
+const QString LOCATION_API_DOMAIN_KEY = "domain";
+const QString LOCATION_API_ONLINE_KEY = "online";
+
+const QString DOMAIN_NETWORK_ADDRESS_KEY = "network_address";
+const QString DOMAIN_ICE_SERVER_ADDRESS_KEY = "ice_server_address";
+
+// the place, domain or user location in a response of the API
+static QVariantMap getLocationMap(const QVariantMap& dataObject) {
+    const QString DATA_OBJECT_PLACE_KEY = "place";
+    const QString DATA_OBJECT_USER_LOCATION_KEY = "location";
+
+    if (dataObject.contains(DATA_OBJECT_PLACE_KEY)) {
+        return dataObject[DATA_OBJECT_PLACE_KEY].toMap();
+    } else if (dataObject.contains(DATA_OBJECT_DOMAIN_KEY)) {
+        return dataObject;
+    } else {
+        return dataObject[DATA_OBJECT_USER_LOCATION_KEY].toMap();
+    }
+}
+
+// the domain of a response of the API, empty if it has none or it is offline
+static QVariantMap getOnlineDomainObject(const QVariantMap& dataObject) {
+    QVariantMap locationMap = getLocationMap(dataObject);
+    if (locationMap.contains(LOCATION_API_ONLINE_KEY) && !locationMap[LOCATION_API_ONLINE_KEY].toBool()) {
+        return QVariantMap();
+    }
+
+    QVariantMap rootMap = locationMap[LOCATION_API_ROOT_KEY].toMap();
+    if (rootMap.isEmpty()) {
+        rootMap = locationMap;
+    }
+    return rootMap[LOCATION_API_DOMAIN_KEY].toMap();
+}
 
 void AddressManager::handleAPIResponse(QNetworkReply& requestReply) {
     QJsonObject responseObject = QJsonDocument::fromJson(requestReply.readAll()).object();
     QJsonObject dataObject = responseObject["data"].toObject();
 
+    QVariantMap addressMap;
     if (!dataObject.isEmpty()) {
-        goToAddressFromObject(dataObject.toVariantMap(), requestReply);
+        addressMap = dataObject.toVariantMap();
     } else if (responseObject.contains(DATA_OBJECT_DOMAIN_KEY)) {
-        goToAddressFromObject(responseObject.toVariantMap(), requestReply);
+        addressMap = responseObject.toVariantMap();
     }
 
-    emit lookupResultsFinished();
-}
-
-const char OVERRIDE_PATH_KEY[] = "override_path";
-const char LOOKUP_TRIGGER_KEY[] = "lookup_trigger";
+    if (!addressMap.isEmpty()) {
+        // keep the places and domain IDs we looked up for the next time we go to them
+        QString cacheKey = requestReply.property(LOOKUP_CACHE_KEY).toString();
+        if (!cacheKey.isEmpty()) {
+            cacheLookup(cacheKey, addressMap);
+        }
 
-void AddressManager::goToAddressFromObject(const QVariantMap& dataObject, const QNetworkReply& reply) {
+        LookupTrigger trigger = (LookupTrigger) requestReply.property(LOOKUP_TRIGGER_KEY).toInt();
+        goToAddressFromObject(addressMap, trigger, requestReply.property(OVERRIDE_PATH_KEY).toString());
+    }
 
-    const QString DATA_OBJECT_PLACE_KEY = "place";
-    const QString DATA_OBJECT_USER_LOCATION_KEY = "location";
+    emit lookupResultsFinished();
+}
 
-    QVariantMap locationMap;
-    if (dataObject.contains(DATA_OBJECT_PLACE_KEY)) {
-        locationMap = dataObject[DATA_OBJECT_PLACE_KEY].toMap();
-    } else if (dataObject.contains(DATA_OBJECT_DOMAIN_KEY)) {
-        locationMap = dataObject;
-    } else {
-        locationMap = dataObject[DATA_OBJECT_USER_LOCATION_KEY].toMap();
-    }
+void AddressManager::goToAddressFromObject(const QVariantMap& dataObject, LookupTrigger trigger,
+                                           const QString& overridePath) {
+    QVariantMap locationMap = getLocationMap(dataObject);
 
     if (!locationMap.isEmpty()) {
-        const QString LOCATION_API_ROOT_KEY = "root";
-        const QString LOCATION_API_DOMAIN_KEY = "domain";
-        const QString LOCATION_API_ONLINE_KEY = "online";
-
         if (!locationMap.contains(LOCATION_API_ONLINE_KEY)
             || locationMap[LOCATION_API_ONLINE_KEY].toBool()) {
 
@@ -244,9 +339,7 @@ void AddressManager::goToAddressFromObject(const QVariantMap& dataObject, const
             QVariantMap domainObject = rootMap[LOCATION_API_DOMAIN_KEY].toMap();
 
             if (!domainObject.isEmpty()) {
-                const QString DOMAIN_NETWORK_ADDRESS_KEY = "network_address";
                 const QString DOMAIN_NETWORK_PORT_KEY = "network_port";
-                const QString DOMAIN_ICE_SERVER_ADDRESS_KEY = "ice_server_address";
 
                 DependencyManager::get<NodeList>()->flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::HandleAddress);
 
@@ -273,8 +366,6 @@ void AddressManager::goToAddressFromObject(const QVariantMap& dataObject, const
                     emit possibleDomainChangeRequiredViaICEForID(iceServerAddress, domainID);
                 }
 
-                LookupTrigger trigger = (LookupTrigger) reply.property(LOOKUP_TRIGGER_KEY).toInt();
-
                 // set our current root place id to the ID that came back
                 const QString PLACE_ID_KEY = "id";
                 _rootPlaceID = rootMap[PLACE_ID_KEY].toUuid();
@@ -289,8 +380,6 @@ void AddressManager::goToAddressFromObject(const QVariantMap& dataObject, const
                 }
 
                 // check if we had a path to override the path returned
-                QString overridePath = reply.property(OVERRIDE_PATH_KEY).toString();
-
                 if (!overridePath.isEmpty()) {
                     handlePath(overridePath, trigger);
                 } else {
@@ -338,12 +427,123 @@ void AddressManager::handleAPIError(QNetworkReply& errorReply) {
     qCDebug(networking) << "AddressManager API error -" << errorReply.error() << "-" << errorReply.errorString();
 
     if (errorReply.error() == QNetworkReply::ContentNotFoundError) {
+        uncacheLookup(errorReply.property(LOOKUP_CACHE_KEY).toString());
         emit lookupResultIsNotFound();
     }
     emit lookupResultsFinished();
 }
 
+void AddressManager::handlePrefetchResponse(QNetworkReply& requestReply) {
+    QString cacheKey = requestReply.property(LOOKUP_CACHE_KEY).toString();
+    _pendingPrefetches.remove(cacheKey);
+
+    QJsonObject responseObject = QJsonDocument::fromJson(requestReply.readAll()).object();
+    QJsonObject dataObject = responseObject["data"].toObject();
+
+    QVariantMap addressMap = !dataObject.isEmpty() ? dataObject.toVariantMap() : responseObject.toVariantMap();
+    cacheLookup(cacheKey, addressMap);
+    warmUpDomainHostname(addressMap);
+}
+
+void AddressManager::handlePrefetchError(QNetworkReply& errorReply) {
+    QString cacheKey = errorReply.property(LOOKUP_CACHE_KEY).toString();
+    _pendingPrefetches.remove(cacheKey);
+
+    if (errorReply.error() == QNetworkReply::ContentNotFoundError) {
+        uncacheLookup(cacheKey);
+    }
+}
+
+void AddressManager::handleWarmUpLookup(const QHostInfo& hostInfo) {
+    if (hostInfo.error() != QHostInfo::NoError) {
+        qCDebug(networking) << "Could not resolve" << hostInfo.hostName() << "ahead of a jump -" << hostInfo.errorString();
+    }
+}
+
+QVariantMap& AddressManager::getLookupCache() {
+    // the settings are read the first time a lookup needs them, they may not be set up when we are made
+    if (!_hasLoadedLookupCache) {
+        _lookupCache = lookupCacheHandle.get();
+        _hasLoadedLookupCache = true;
+    }
+    return _lookupCache;
+}
+
+bool AddressManager::getCachedLookup(const QString& cacheKey, QVariantMap& dataObject) {
+    QVariantMap& lookupCache = getLookupCache();
+
+    auto it = lookupCache.find(cacheKey);
+    if (it == lookupCache.end()) {
+        return false;
+    }
+
+    QVariantMap entry = it->toMap();
+    qint64 age = QDateTime::currentMSecsSinceEpoch() - entry[LOOKUP_CACHE_TIME_KEY].toLongLong();
+    if (age < 0 || age > PLACE_LOOKUP_CACHE_TTL_MSECS) {
+        return false;
+    }
+
+    dataObject = entry[LOOKUP_CACHE_DATA_KEY].toMap();
+    return true;
+}
+
+void AddressManager::cacheLookup(const QString& cacheKey, const QVariantMap& dataObject) {
+    if (getOnlineDomainObject(dataObject).isEmpty()) {
+        // an offline place may be back any time, it is looked up again
+        uncacheLookup(cacheKey);
+        return;
+    }
+
+    QVariantMap& lookupCache = getLookupCache();
+
+    // the expired entries go when a new one is kept, so that the settings do not grow with every place visited
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (auto it = lookupCache.begin(); it != lookupCache.end();) {
+        qint64 age = now - it->toMap()[LOOKUP_CACHE_TIME_KEY].toLongLong();
+        if (age < 0 || age > PLACE_LOOKUP_CACHE_TTL_MSECS) {
+            it = lookupCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    QVariantMap entry;
+    entry.insert(LOOKUP_CACHE_TIME_KEY, now);
+    entry.insert(LOOKUP_CACHE_DATA_KEY, dataObject);
+    lookupCache.insert(cacheKey, entry);
+    lookupCacheHandle.set(lookupCache);
+}
+
+void AddressManager::uncacheLookup(const QString& cacheKey) {
+    QVariantMap& lookupCache = getLookupCache();
+    if (!cacheKey.isEmpty() && lookupCache.remove(cacheKey) > 0) {
+        lookupCacheHandle.set(lookupCache);
+    }
+}
+
+void AddressManager::warmUpDomainHostname(const QVariantMap& dataObject) {
+    // the domain-server or the ice-server is resolved now, so that the lookup is cached by the time we connect
+    QVariantMap domainObject = getOnlineDomainObject(dataObject);
+    QString hostname = domainObject.contains(DOMAIN_NETWORK_ADDRESS_KEY)
+        ? domainObject[DOMAIN_NETWORK_ADDRESS_KEY].toString()
+        : domainObject[DOMAIN_ICE_SERVER_ADDRESS_KEY].toString();
+
+    if (!hostname.isEmpty()) {
+        QHostInfo::lookupHost(hostname, this, SLOT(handleWarmUpLookup(const QHostInfo&)));
+    }
+}
+
 void AddressManager::attemptPlaceNameLookup(const QString& lookupString, const QString& overridePath, LookupTrigger trigger) {
+    // we may have been to this place a moment ago, or looked it up when it showed in a menu
+    QString cacheKey = lookupString.toLower();
+    QVariantMap cachedDataObject;
+    if (getCachedLookup(cacheKey, cachedDataObject)) {
+        qCDebug(networking) << "Using the cached lookup of place" << lookupString;
+        goToAddressFromObject(cachedDataObject, trigger, overridePath);
+        emit lookupResultsFinished();
+        return;
+    }
+
     // assume this is a place name and see if we can get any info on it
     QString placeName = QUrl::toPercentEncoding(lookupString);
 
@@ -356,6 +556,7 @@ void AddressManager::attemptPlaceNameLookup(const QString& lookupString, const Q
 
     // remember how this lookup was triggered for history storage handling later
     requestParams.insert(LOOKUP_TRIGGER_KEY, static_cast<int>(trigger));
+    requestParams.insert(LOOKUP_CACHE_KEY, cacheKey);
 
     AccountManager::getInstance().sendRequest(GET_PLACE.arg(placeName),
                                               AccountManagerAuth::None,
@@ -364,9 +565,16 @@ void AddressManager::attemptPlaceNameLookup(const QString& lookupString, const Q
                                               QByteArray(), NULL, requestParams);
 }
 
-const QString GET_DOMAIN_ID = "/api/v1/domains/%1";
-
 void AddressManager::attemptDomainIDLookup(const QString& lookupString, const QString& overridePath, LookupTrigger trigger) {
+    QString cacheKey = lookupString.toLower();
+    QVariantMap cachedDataObject;
+    if (getCachedLookup(cacheKey, cachedDataObject)) {
+        qCDebug(networking) << "Using the cached lookup of domain ID" << lookupString;
+        goToAddressFromObject(cachedDataObject, trigger, overridePath);
+        emit lookupResultsFinished();
+        return;
+    }
+
     // assume this is a domain ID and see if we can get any info on it
     QString domainID = QUrl::toPercentEncoding(lookupString);
 
@@ -379,6 +587,7 @@ void AddressManager::attemptDomainIDLookup(const QString& lookupString, const QS
 
     // remember how this lookup was triggered for history storage handling later
     requestParams.insert(LOOKUP_TRIGGER_KEY, static_cast<int>(trigger));
+    requestParams.insert(LOOKUP_CACHE_KEY, cacheKey);
 
     AccountManager::getInstance().sendRequest(GET_DOMAIN_ID.arg(domainID),
                                                 AccountManagerAuth::None,
@@ -387,7 +596,7 @@ void AddressManager::attemptDomainIDLookup(const QString& lookupString, const QS
                                                 QByteArray(), NULL, requestParams);
 }
 
-bool AddressManager::handleNetworkAddress(const QString& lookupString, LookupTrigger trigger) {
+bool AddressManager::parseNetworkAddress(const QString& lookupString, QString& hostname, quint16& port) {
     const QString IP_ADDRESS_REGEX_STRING = "^((?:(?:[0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])\\.){3}"
         "(?:[0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5]))(?::(\\d{1,5}))?$";
 
@@ -397,30 +606,38 @@ bool AddressManager::handleNetworkAddress(const QString& lookupString, LookupTri
     QRegExp ipAddressRegex(IP_ADDRESS_REGEX_STRING);
 
     if (ipAddressRegex.indexIn(lookupString) != -1) {
-        QString domainIPString = ipAddressRegex.cap(1);
+        hostname = ipAddressRegex.cap(1);
 
-        qint16 domainPort = DEFAULT_DOMAIN_SERVER_PORT;
+        port = DEFAULT_DOMAIN_SERVER_PORT;
         if (!ipAddressRegex.cap(2).isEmpty()) {
-            domainPort = (qint16) ipAddressRegex.cap(2).toInt();
+            port = (quint16) ipAddressRegex.cap(2).toInt();
         }
 
-        emit lookupResultsFinished();
-        setDomainInfo(domainIPString, domainPort, trigger);
-
         return true;
     }
 
     QRegExp hostnameRegex(HOSTNAME_REGEX_STRING, Qt::CaseInsensitive);
 
     if (hostnameRegex.indexIn(lookupString) != -1) {
-        QString domainHostname = hostnameRegex.cap(1);
+        hostname = hostnameRegex.cap(1);
 
-        quint16 domainPort = DEFAULT_DOMAIN_SERVER_PORT;
+        port = DEFAULT_DOMAIN_SERVER_PORT;
 
         if (!hostnameRegex.cap(2).isEmpty()) {
-            domainPort = (qint16)hostnameRegex.cap(2).toInt();
+            port = (quint16) hostnameRegex.cap(2).toInt();
         }
 
+        return true;
+    }
+
+    return false;
+}
+
+bool AddressManager::handleNetworkAddress(const QString& lookupString, LookupTrigger trigger) {
+    QString domainHostname;
+    quint16 domainPort;
+
+    if (parseNetworkAddress(lookupString, domainHostname, domainPort)) {
         emit lookupResultsFinished();
         setDomainInfo(domainHostname, domainPort, trigger);
 
@@ -13,7 +13,9 @@
 #define hifi_AddressManager_h
 
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtCore/QStack>
+#include <QtNetwork/QHostInfo>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -28,6 +30,9 @@ const QString INDEX_PATH = "/";
 
 const QString GET_PLACE = "/api/v1/places/%1";
 
+// how long the place and domain ID lookups are kept, the domain a place is on rarely changes
+const qint64 PLACE_LOOKUP_CACHE_TTL_MSECS = 10 * 60 * 1000;
+
 class AddressManager : public QObject, public Dependency {
     Q_OBJECT
     SINGLETON_DEPENDENCY
@@ -68,6 +73,10 @@ public:
 public slots:
     void handleLookupString(const QString& lookupString);
 
+    /// looks up the place or domain ID ahead of a jump that may follow, and resolves the hostname of its domain,
+    /// for the destinations the user is about to pick from
+    void prefetchLookupString(const QString& lookupString);
+
     // we currently expect this to be called from NodeList once handleLookupString has been called with a path
     bool goToViewpointForPath(const QString& viewpointString, const QString& pathString)
         { return handleViewpoint(viewpointString, false, false, pathString); }
@@ -105,15 +114,23 @@ private slots:
     void handleAPIResponse(QNetworkReply& requestReply);
     void handleAPIError(QNetworkReply& errorReply);
 
-    void goToAddressFromObject(const QVariantMap& addressMap, const QNetworkReply& reply);
+    void handlePrefetchResponse(QNetworkReply& requestReply);
+    void handlePrefetchError(QNetworkReply& errorReply);
+    void handleWarmUpLookup(const QHostInfo& hostInfo);
 private:
+    void goToAddressFromObject(const QVariantMap& addressMap, LookupTrigger trigger, const QString& overridePath);
+
     void setHost(const QString& host, LookupTrigger trigger, quint16 port = 0);
     void setDomainInfo(const QString& hostname, quint16 port, LookupTrigger trigger);
 
     const JSONCallbackParameters& apiCallbackParameters();
+    const JSONCallbackParameters& prefetchCallbackParameters();
+
+    static QUrl urlFromLookupString(const QString& lookupString);
 
     bool handleUrl(const QUrl& lookupUrl, LookupTrigger trigger = UserInput);
 
+    static bool parseNetworkAddress(const QString& lookupString, QString& hostname, quint16& port);
     bool handleNetworkAddress(const QString& lookupString, LookupTrigger trigger);
     void handlePath(const QString& path, LookupTrigger trigger, bool wasPathOnly = false);
     bool handleViewpoint(const QString& viewpointString, bool shouldFace = false,
@@ -126,6 +143,13 @@ private:
 
     void addCurrentAddressToHistory(LookupTrigger trigger);
 
+    // the lookups of places and domain IDs that resolved to an online domain, by lower case place name or domain ID
+    QVariantMap& getLookupCache();
+    bool getCachedLookup(const QString& cacheKey, QVariantMap& dataObject);
+    void cacheLookup(const QString& cacheKey, const QVariantMap& dataObject);
+    void uncacheLookup(const QString& cacheKey);
+    void warmUpDomainHostname(const QVariantMap& dataObject);
+
     QString _host;
     quint16 _port;
     QUuid _rootPlaceID;
@@ -137,6 +161,10 @@ private:
     quint64 _lastBackPush = 0;
 
     QString _newHostLookupPath;
+
+    bool _hasLoadedLookupCache = false;
+    QVariantMap _lookupCache; // { cacheKey: { time, data }, ... }
+    QSet<QString> _pendingPrefetches;
 };
 
 #endif // hifi_AddressManager_h
@@ -11,6 +11,7 @@
 
 #include "AssetClient.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include <QtCore/QBuffer>
@@ -39,7 +40,7 @@ AssetClient::AssetClient() {
     auto nodeList = DependencyManager::get<NodeList>();
     auto& packetReceiver = nodeList->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AssetGetInfoReply, this, "handleAssetGetInfoReply");
-    packetReceiver.registerMessageListener(PacketType::AssetGetReply, this, "handleAssetGetReply");
+    packetReceiver.registerMessageStreamListener(PacketType::AssetGetReply, this, "handleAssetGetReply");
     packetReceiver.registerListener(PacketType::AssetUploadReply, this, "handleAssetUploadReply");
 
     connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &AssetClient::handleNodeKilled);
@@ -124,7 +125,7 @@ AssetUpload* AssetClient::createUpload(const QByteArray& data, const QString& ex
 }
 
 bool AssetClient::getAsset(const QString& hash, const QString& extension, DataOffset start, DataOffset end,
-                           ReceivedAssetCallback callback) {
+                           ReceivedAssetCallback callback, ProgressCallback progressCallback) {
     if (hash.length() != SHA256_HASH_HEX_LENGTH) {
         qCWarning(asset_client) << "Invalid hash size";
         return false;
@@ -155,7 +156,7 @@ bool AssetClient::getAsset(const QString& hash, const QString& extension, DataOf
 
         nodeList->sendPacket(std::move(packet), *assetServer);
 
-        _pendingRequests[assetServer][messageID] = callback;
+        _pendingRequests[assetServer][messageID] = { callback, progressCallback };
 
         return true;
     }
@@ -222,46 +223,62 @@ void AssetClient::handleAssetGetInfoReply(QSharedPointer<NLPacket> packet, Share
     }
 }
 
-void AssetClient::handleAssetGetReply(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode) {
-    QByteArray data = packetList->getMessage();
-    QBuffer packet { &data };
-    packet.open(QIODevice::ReadOnly);
+void AssetClient::handleAssetGetReply(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
+    // replies are streamed to us a packet at a time, the header is at the start of the first one
+    auto& nodeReplies = _pendingReplies[senderNode];
+    auto& reply = nodeReplies[packet->getMessageNumber()];
 
-    auto assetHash = packet.read(SHA256_HASH_LENGTH);
-    qCDebug(asset_client) << "Got reply for asset: " << assetHash.toHex();
+    if (packet->getMessagePartNumber() == 0) {
+        auto assetHash = packet->read(SHA256_HASH_LENGTH);
+        qCDebug(asset_client) << "Got reply for asset: " << assetHash.toHex();
 
-    MessageID messageID;
-    packet.read(reinterpret_cast<char*>(&messageID), sizeof(messageID));
+        packet->readPrimitive(&reply.messageID);
+        packet->readPrimitive(&reply.error);
 
-    AssetServerError error;
-    packet.read(reinterpret_cast<char*>(&error), sizeof(AssetServerError));
-    QByteArray assetData;
+        if (!reply.error) {
+            packet->readPrimitive(&reply.length);
 
-    if (!error) {
-        DataOffset length;
-        packet.read(reinterpret_cast<char*>(&length), sizeof(DataOffset));
-        data = packet.read(length);
-    } else {
-        qCWarning(asset_client) << "Failure getting asset: " << error;
+            // the data is copied once, into a buffer that already has room for all of it
+            reply.data.reserve(reply.length);
+        } else {
+            qCWarning(asset_client) << "Failure getting asset: " << reply.error;
+        }
     }
 
-    // Check if we have any pending requests for this node
+    // Check if we have a pending request for this reply
+    GetAssetCallbacks* callbacks = nullptr;
+
     auto messageMapIt = _pendingRequests.find(senderNode);
     if (messageMapIt != _pendingRequests.end()) {
+        auto requestIt = messageMapIt->second.find(reply.messageID);
+        if (requestIt != messageMapIt->second.end()) {
+            callbacks = &requestIt->second;
+        }
+    }
 
-        // Found the node, get the MessageID -> Callback map
-        auto& messageCallbackMap = messageMapIt->second;
+    if (!reply.error) {
+        qint64 numBytes = std::min(packet->bytesLeftToRead(), (qint64)(reply.length - reply.data.size()));
+        reply.data.append(packet->readWithoutCopy(numBytes));
 
-        // Check if we have this pending request
-        auto requestIt = messageCallbackMap.find(messageID);
-        if (requestIt != messageCallbackMap.end()) {
-            auto callback = requestIt->second;
-            callback(true, error, data);
-            messageCallbackMap.erase(requestIt);
+        if (callbacks && callbacks->progressCallback) {
+            callbacks->progressCallback(reply.data.size(), reply.length);
+        }
+    }
+
+    if (packet->getPacketPosition() == NLPacket::PacketPosition::LAST
+        || packet->getPacketPosition() == NLPacket::PacketPosition::ONLY) {
+
+        if (callbacks) {
+            auto callback = callbacks->completeCallback;
+            messageMapIt->second.erase(reply.messageID);
+
+            callback(true, reply.error, reply.data);
         }
 
         // Although the messageCallbackMap may now be empty, we won't delete the node until we have disconnected from
         // it to avoid constantly creating/deleting the map on subsequent requests.
+
+        nodeReplies.erase(packet->getMessageNumber());
     }
 }
 
@@ -271,6 +288,7 @@ bool AssetClient::uploadAsset(const QByteArray& data, const QString& extension,
     
     if (assetServer) {
         auto packetList = NLPacketList::create(PacketType::AssetUpload, QByteArray(), true, true);
+        packetList->setPriority(udt::PacketList::Priority::Bulk);
 
         auto messageID = ++_currentID;
         packetList->writePrimitive(messageID);
@@ -338,12 +356,14 @@ void AssetClient::handleNodeKilled(SharedNodePointer node) {
         auto messageMapIt = _pendingRequests.find(node);
         if (messageMapIt != _pendingRequests.end()) {
             for (const auto& value : messageMapIt->second) {
-                value.second(false, AssetServerError::NoError, QByteArray());
+                value.second.completeCallback(false, AssetServerError::NoError, QByteArray());
             }
             messageMapIt->second.clear();
         }
     }
 
+    _pendingReplies.erase(node);
+
     {
         auto messageMapIt = _pendingInfoRequests.find(node);
         if (messageMapIt != _pendingInfoRequests.end()) {
@@ -33,6 +33,7 @@ struct AssetInfo {
 using ReceivedAssetCallback = std::function<void(bool responseReceived, AssetServerError serverError, const QByteArray& data)>;
 using GetInfoCallback = std::function<void(bool responseReceived, AssetServerError serverError, AssetInfo info)>;
 using UploadResultCallback = std::function<void(bool responseReceived, AssetServerError serverError, const QString& hash)>;
+using ProgressCallback = std::function<void(qint64 totalReceived, qint64 total)>;
 
 
 
@@ -49,18 +50,33 @@ public:
 
 private slots:
     void handleAssetGetInfoReply(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
-    void handleAssetGetReply(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode);
+    void handleAssetGetReply(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
     void handleAssetUploadReply(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
 
     void handleNodeKilled(SharedNodePointer node);
 
 private:
     bool getAssetInfo(const QString& hash, const QString& extension, GetInfoCallback callback);
-    bool getAsset(const QString& hash, const QString& extension, DataOffset start, DataOffset end, ReceivedAssetCallback callback);
+    bool getAsset(const QString& hash, const QString& extension, DataOffset start, DataOffset end,
+                  ReceivedAssetCallback callback, ProgressCallback progressCallback = ProgressCallback());
     bool uploadAsset(const QByteArray& data, const QString& extension, UploadResultCallback callback);
 
+    struct GetAssetCallbacks {
+        ReceivedAssetCallback completeCallback;
+        ProgressCallback progressCallback;
+    };
+    
+    // a reply whose packets are still coming in
+    struct PendingAssetReply {
+        MessageID messageID { 0 };
+        AssetServerError error { AssetServerError::NoError };
+        DataOffset length { 0 };
+        QByteArray data;
+    };
+
     static MessageID _currentID;
-    std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, ReceivedAssetCallback>> _pendingRequests;
+    std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetAssetCallbacks>> _pendingRequests;
+    std::unordered_map<SharedNodePointer, std::unordered_map<udt::Packet::MessageNumber, PendingAssetReply>> _pendingReplies;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetInfoCallback>> _pendingInfoRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadResultCallback>> _pendingUploads;
     
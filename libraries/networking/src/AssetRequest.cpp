@@ -20,6 +20,10 @@
 #include "NodeList.h"
 #include "ResourceCache.h"
 
+// the large assets come in ranges of that size, a few of them at once
+static const DataOffset CHUNK_SIZE = 1024 * 1024;
+static const int MAX_PENDING_CHUNKS = 4;
+
 AssetRequest::AssetRequest(const QString& hash, const QString& extension) :
     QObject(),
     _hash(hash),
@@ -82,48 +86,93 @@ void AssetRequest::start() {
         
         qCDebug(asset_client) << "Got size of " << _hash << " : " << info.size << " bytes";
         
-        int start = 0, end = _info.size;
-        
-        auto assetClient = DependencyManager::get<AssetClient>();
-        assetClient->getAsset(_hash, _extension, start, end, [this, start, end](bool responseReceived, AssetServerError serverError,
-                                                                                const QByteArray& data) {
-            if (!responseReceived) {
-                _error = NetworkError;
-            } else if (serverError != AssetServerError::NoError) {
-                switch (serverError) {
-                    case AssetServerError::AssetNotFound:
-                        _error = NotFound;
-                        break;
-                    case AssetServerError::InvalidByteRange:
-                        _error = InvalidByteRange;
-                        break;
-                    default:
-                        _error = UnknownError;
-                        break;
-                }
-            } else {
-                Q_ASSERT(data.size() == (end - start));
-                
-                // we need to check the hash of the received data to make sure it matches what we expect
-                if (hashData(data).toHex() == _hash) {
-                    memcpy(_data.data() + start, data.constData(), data.size());
-                    _totalReceived += data.size();
-                    emit progress(_totalReceived, _info.size);
-                    
-                    saveToCache(getUrl(), data);
-                } else {
-                    // hash doesn't match - we have an error
-                    _error = HashVerificationFailed;
-                }
-                
-            }
-            
-            if (_error != NoError) {
-                qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+        requestNextChunks();
+    });
+}
+
+void AssetRequest::requestNextChunks() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+
+    while (_error == NoError && _numPendingRequests < MAX_PENDING_CHUNKS && _nextChunkStart < (DataOffset)_info.size) {
+        DataOffset start = _nextChunkStart;
+        DataOffset end = std::min(start + CHUNK_SIZE, (DataOffset)_info.size);
+        _nextChunkStart = end;
+
+        bool sent = assetClient->getAsset(_hash, _extension, start, end,
+                                          [this, start, end](bool responseReceived, AssetServerError serverError,
+                                                             const QByteArray& data) {
+            _numPendingRequests--;
+            _chunksReceiving.remove(start);
+            chunkReceived(responseReceived, serverError, start, end, data);
+        }, [this, start](qint64 totalReceived, qint64 total) {
+            // the data is only handed over once the whole asset is verified, but progress is reported as it streams in
+            _chunksReceiving[start] = totalReceived;
+            qint64 receiving = 0;
+            foreach (qint64 chunkBytes, _chunksReceiving) {
+                receiving += chunkBytes;
             }
-            
+            emit progress(_totalReceived + receiving, _info.size);
+        });
+
+        if (sent) {
+            _numPendingRequests++;
+        } else {
+            _error = NetworkError;
+        }
+    }
+
+    if (_numPendingRequests == 0) {
+        if (_error == NoError) {
+            verifyData();
+        } else {
+            qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
             _state = Finished;
             emit finished(this);
-        });
-    });
+        }
+    }
+}
+
+void AssetRequest::chunkReceived(bool responseReceived, AssetServerError serverError, DataOffset start, DataOffset end,
+                                 const QByteArray& data) {
+    // once a chunk failed, the others in flight are only waited for, the request can't finish before their callbacks
+    if (_error == NoError) {
+        if (!responseReceived) {
+            _error = NetworkError;
+        } else if (serverError != AssetServerError::NoError) {
+            switch (serverError) {
+                case AssetServerError::AssetNotFound:
+                    _error = NotFound;
+                    break;
+                case AssetServerError::InvalidByteRange:
+                    _error = InvalidByteRange;
+                    break;
+                default:
+                    _error = UnknownError;
+                    break;
+            }
+        } else if (data.size() != (end - start)) {
+            _error = InvalidByteRange;
+        } else {
+            memcpy(_data.data() + start, data.constData(), data.size());
+            _totalReceived += data.size();
+            emit progress(_totalReceived, _info.size);
+        }
+    }
+
+    requestNextChunks();
+}
+
+void AssetRequest::verifyData() {
+    // we need to check the hash of the received data to make sure it matches what we expect,
+    // except for the hulls, which are named by the hash of the model they were made from
+    if (_extension == HULL_ASSET_EXTENSION || hashData(_data).toHex() == _hash) {
+        saveToCache(getUrl(), _data);
+    } else {
+        // hash doesn't match - we have an error
+        _error = HashVerificationFailed;
+        qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+    }
+
+    _state = Finished;
+    emit finished(this);
 }
@@ -13,6 +13,7 @@
 #define hifi_AssetRequest_h
 
 #include <QByteArray>
+#include <QHash>
 #include <QObject>
 #include <QString>
 
@@ -53,6 +54,11 @@ signals:
     void progress(qint64 totalReceived, qint64 total);
 
 private:
+    void requestNextChunks();
+    void chunkReceived(bool responseReceived, AssetServerError serverError, DataOffset start, DataOffset end,
+                       const QByteArray& data);
+    void verifyData();
+
     State _state = NotStarted;
     Error _error = NoError;
     AssetInfo _info;
@@ -61,6 +67,8 @@ private:
     QString _extension;
     QByteArray _data;
     int _numPendingRequests { 0 };
+    DataOffset _nextChunkStart { 0 };
+    QHash<DataOffset, qint64> _chunksReceiving; // the bytes streamed so far of the chunks in flight
 };
 
 #endif
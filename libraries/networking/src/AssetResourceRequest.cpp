@@ -25,7 +25,8 @@ void AssetResourceRequest::doSend() {
     auto assetClient = DependencyManager::get<AssetClient>();
     auto parts = _url.path().split(".", QString::SkipEmptyParts);
     auto hash = parts.length() > 0 ? parts[0] : "";
-    auto extension = parts.length() > 1 ? parts[1] : "";
+    // the extension can have dots of its own, like the hulls of the models
+    auto extension = parts.length() > 1 ? QStringList(parts.mid(1)).join(".") : "";
 
     if (hash.length() != SHA256_HASH_HEX_LENGTH) {
         _result = InvalidURL;
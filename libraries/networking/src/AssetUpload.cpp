@@ -16,6 +16,7 @@
 
 #include "AssetClient.h"
 #include "NetworkLogging.h"
+#include "NodeList.h"
 
 const QString AssetUpload::PERMISSION_DENIED_ERROR = "You do not have permission to upload content to this asset-server.";
 
@@ -71,9 +72,40 @@ void AssetUpload::start() {
             
             // emit that we are done
             emit finished(this, QString());
+            return;
         }
     }
     
+    _hash = hashData(_data).toHex();
+    
+    // the asset-server is asked for the hash first, the transfer is skipped if it already has the same content
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (!nodeList->getThisNodeCanRez()) {
+        // the asset-server refuses this upload, let its reply tell why
+        upload();
+        return;
+    }
+    
+    auto assetClient = DependencyManager::get<AssetClient>();
+    bool requested = assetClient->getAssetInfo(_hash, _extension, [this](bool responseReceived, AssetServerError error,
+                                                                         AssetInfo info) {
+        if (responseReceived && error == AssetServerError::NoError && info.size == _data.size()) {
+            qCDebug(asset_client) << "The asset-server already has" << _hash << "- skipping the upload.";
+            
+            _error = NoError;
+            saveToCache(getATPUrl(_hash, _extension), _data);
+            emit finished(this, _hash);
+        } else {
+            upload();
+        }
+    });
+    
+    if (!requested) {
+        upload();
+    }
+}
+
+void AssetUpload::upload() {
     // ask the AssetClient to upload the asset and emit the proper signals from the passed callback
     auto assetClient = DependencyManager::get<AssetClient>();
    
@@ -101,7 +133,7 @@ void AssetUpload::start() {
             }
         }
         
-        if (_error == NoError && hash == hashData(_data).toHex()) {
+        if (_error == NoError && hash == _hash) {
             saveToCache(getATPUrl(hash, _extension), _data);
         }
         
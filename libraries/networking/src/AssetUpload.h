@@ -52,9 +52,12 @@ signals:
     void progress(uint64_t totalReceived, uint64_t total);
     
 private:
+    void upload();
+    
     QString _filename;
     QByteArray _data;
     QString _extension;
+    QString _hash; // of _data, once the upload started
     Error _error;
 };
 
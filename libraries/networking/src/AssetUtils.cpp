@@ -27,6 +27,22 @@ QUrl getATPUrl(const QString& hash, const QString& extension) {
     }
 }
 
+bool isHullSourceExtension(const QString& extension) {
+    auto lowerExtension = extension.toLower();
+    return lowerExtension == "fbx" || lowerExtension == "obj";
+}
+
+QUrl getATPHullUrl(const QUrl& modelUrl) {
+    if (modelUrl.scheme() != URL_SCHEME_ATP) {
+        return QUrl();
+    }
+    auto parts = modelUrl.path().split(".", QString::SkipEmptyParts);
+    if (parts.length() != 2 || parts[0].length() != SHA256_HASH_HEX_LENGTH || !isHullSourceExtension(parts[1])) {
+        return QUrl();
+    }
+    return getATPUrl(parts[0], HULL_ASSET_EXTENSION);
+}
+
 QByteArray hashData(const QByteArray& data) {
     return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
 }
@@ -32,8 +32,18 @@ enum AssetServerError : uint8_t {
     PermissionDenied
 };
 
+// The asset-server decomposes the models uploaded to it into convex hulls for their collisions, and serves the hulls
+// under the hash of their model with this extension. Their data is not what the hash names, so it isn't verified.
+const QString HULL_ASSET_EXTENSION = "hull.obj";
+
 QUrl getATPUrl(const QString& hash, const QString& extension = QString());
 
+// the extensions of the models the asset-server decomposes
+bool isHullSourceExtension(const QString& extension);
+
+// the URL of the hull of a model on the asset-server, empty for other URLs
+QUrl getATPHullUrl(const QUrl& modelUrl);
+
 QByteArray hashData(const QByteArray& data);
 
 QByteArray loadFromCache(const QUrl& url);
@@ -0,0 +1,129 @@
+//
+//  FrameScheduler.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FrameScheduler.h"
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <LogHandler.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "NetworkLogging.h"
+
+static const int TRAILING_AVERAGE_FRAMES = 100;
+static const float CURRENT_FRAME_RATIO = 1.0f / TRAILING_AVERAGE_FRAMES;
+static const float PREVIOUS_FRAMES_RATIO = 1.0f - CURRENT_FRAME_RATIO;
+
+void FrameScheduler::start() {
+    _timer.start();
+    _nextFrameUsecs = 0;
+    _frameStartUsecs = 0;
+}
+
+quint64 FrameScheduler::waitForNextFrame() {
+    quint64 now = _timer.nsecsElapsed() / NSECS_PER_USEC;
+    quint64 frameTimeUsecs = now - _frameStartUsecs;
+
+    _nextFrameUsecs += _frameUsecs;
+
+    quint64 numSkippedFrames = 0;
+    if (now > _nextFrameUsecs + MAX_FRAMES_BEHIND * _frameUsecs) {
+        // we can't catch up, give up on the frames we missed and keep the phase of the schedule
+        numSkippedFrames = (now - _nextFrameUsecs) / _frameUsecs;
+        _nextFrameUsecs += numSkippedFrames * _frameUsecs;
+
+        static const QString SKIPPED_REGEX = "Frames are running more than \\d+ behind, skipped \\d+";
+        static QString repeatedMessage = LogHandler::getInstance().addRepeatedMessageRegex(SKIPPED_REGEX);
+
+        qCDebug(networking) << "Frames are running more than" << MAX_FRAMES_BEHIND << "behind, skipped" << numSkippedFrames;
+    }
+
+    quint64 sleptUsecs = 0;
+    if (_nextFrameUsecs > now) {
+        usleep(_nextFrameUsecs - now);
+        _frameStartUsecs = _timer.nsecsElapsed() / NSECS_PER_USEC;
+        sleptUsecs = _frameStartUsecs - now;
+    } else {
+        _frameStartUsecs = now;
+    }
+
+    _trailingSleepRatio = (PREVIOUS_FRAMES_RATIO * _trailingSleepRatio)
+        + (std::min(sleptUsecs, _frameUsecs) * CURRENT_FRAME_RATIO / (float) _frameUsecs);
+
+    QMutexLocker locker(&_statsMutex);
+    if (frameTimeUsecs > _frameUsecs) {
+        ++_numLateFrames;
+    }
+    _numSkippedFrames += numSkippedFrames;
+    _frameTimes.record(frameTimeUsecs);
+
+    return sleptUsecs;
+}
+
+QJsonObject FrameScheduler::takeStatsObject() {
+    QJsonObject statsObject;
+
+    QMutexLocker locker(&_statsMutex);
+
+    statsObject["frame_usecs"] = (double) _frameUsecs;
+    statsObject["frames"] = _frameTimes.getCount();
+    statsObject["late_frames"] = (double) _numLateFrames;
+    statsObject["skipped_frames"] = (double) _numSkippedFrames;
+    statsObject["frame_time_usecs_p50"] = (double) _frameTimes.getPercentile(50.0);
+    statsObject["frame_time_usecs_p90"] = (double) _frameTimes.getPercentile(90.0);
+    statsObject["frame_time_usecs_p99"] = (double) _frameTimes.getPercentile(99.0);
+    statsObject["frame_time_usecs_max"] = (double) _frameTimes.getMax();
+
+    _numLateFrames = 0;
+    _numSkippedFrames = 0;
+    _frameTimes = udt::LatencyHistogram();
+
+    return statsObject;
+}
+
+bool FrameScheduler::setCurrentThreadRealtime() {
+#ifdef Q_OS_LINUX
+    // the lowest realtime priority, enough to run ahead of every normal thread without starving other realtime ones
+    sched_param parameters;
+    parameters.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+    if (error != 0) {
+        qCWarning(networking) << "Could not give the frame thread a realtime priority, error" << error;
+        return false;
+    }
+    return true;
+#else
+    qCWarning(networking) << "Realtime frame threads are not supported on this platform";
+    return false;
+#endif
+}
+
+bool FrameScheduler::setCurrentThreadCPU(int cpu) {
+#ifdef Q_OS_LINUX
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (error != 0) {
+        qCWarning(networking) << "Could not keep the frame thread on CPU" << cpu << "- error" << error;
+        return false;
+    }
+    return true;
+#else
+    qCWarning(networking) << "Frame thread CPU affinity is not supported on this platform";
+    return false;
+#endif
+}
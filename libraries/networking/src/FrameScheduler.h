@@ -0,0 +1,65 @@
+//
+//  FrameScheduler.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FrameScheduler_h
+#define hifi_FrameScheduler_h
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+
+#include "udt/LatencyHistogram.h"
+
+/// Paces the frames of a mixer at a fixed rate. Each frame is due a frame interval after the one before it, rather than
+/// an interval after the last one ended, so that the rate doesn't drift with the time the frames take. A frame that runs
+/// late is followed by the next one right away to catch up, but once the mixer is more than MAX_FRAMES_BEHIND frames
+/// behind the frames it missed are skipped and counted instead of being run back to back.
+class FrameScheduler {
+public:
+    static const int MAX_FRAMES_BEHIND = 2;
+
+    FrameScheduler(quint64 frameUsecs = 0) : _frameUsecs(frameUsecs) {}
+
+    quint64 getFrameUsecs() const { return _frameUsecs; }
+    void setFrameUsecs(quint64 frameUsecs) { _frameUsecs = frameUsecs; }
+
+    /// starts the schedule with a frame that is due now
+    void start();
+
+    /// ends the frame that was running and sleeps until the next one is due
+    /// \return the usecs slept, zero if the frame ran late
+    quint64 waitForNextFrame();
+
+    /// the part of the frame interval slept, averaged over the last hundred frames or so
+    float getTrailingSleepRatio() const { return _trailingSleepRatio; }
+
+    /// the frame counts and frame time percentiles since the last call, which are then reset, callable from any thread
+    QJsonObject takeStatsObject();
+
+    /// gives the calling thread a realtime scheduling priority, where the platform allows it
+    static bool setCurrentThreadRealtime();
+
+    /// keeps the calling thread on one CPU, where the platform allows it
+    static bool setCurrentThreadCPU(int cpu);
+
+private:
+    quint64 _frameUsecs;
+    QElapsedTimer _timer;
+    quint64 _nextFrameUsecs { 0 }; // when the next frame is due, on _timer
+    quint64 _frameStartUsecs { 0 };
+    float _trailingSleepRatio { 1.0f };
+
+    QMutex _statsMutex;
+    quint64 _numLateFrames { 0 };
+    quint64 _numSkippedFrames { 0 };
+    udt::LatencyHistogram _frameTimes; // how long the frames ran, not counting the sleep after them
+};
+
+#endif // hifi_FrameScheduler_h
@@ -19,6 +19,7 @@
 
 #include "NetworkAccessManager.h"
 #include "NetworkLogging.h"
+#include "ResourceDiskCache.h"
 
 HTTPResourceRequest::~HTTPResourceRequest() {
     if (_reply) {
@@ -32,7 +33,27 @@ void HTTPResourceRequest::doSend() {
     QNetworkRequest networkRequest(_url);
     networkRequest.setHeader(QNetworkRequest::UserAgentHeader, HIGH_FIDELITY_USER_AGENT);
 
-    if (_cacheEnabled) {
+    if (_cacheEnabled && ResourceDiskCache::isEnabled()) {
+        // a fresh entry doesn't need the server, a stale one gets revalidated with its validators
+        if (ResourceDiskCache::isFresh(_url) && ResourceDiskCache::load(_url, _data)) {
+            _loadedFromCache = true;
+            _result = Success;
+            _state = Finished;
+            QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection);
+            return;
+        }
+        ResourceDiskCache::Validators validators;
+        if (ResourceDiskCache::getValidators(_url, validators)) {
+            if (!validators.eTag.isEmpty()) {
+                networkRequest.setRawHeader("If-None-Match", validators.eTag);
+            }
+            if (!validators.lastModified.isEmpty()) {
+                networkRequest.setRawHeader("If-Modified-Since", validators.lastModified);
+            }
+        }
+        networkRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+        networkRequest.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+    } else if (_cacheEnabled) {
         networkRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
     } else {
         networkRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
@@ -57,6 +78,10 @@ void HTTPResourceRequest::onRequestFinished() {
     
     switch(_reply->error()) {
         case QNetworkReply::NoError:
+            if (_cacheEnabled && ResourceDiskCache::isEnabled()) {
+                storeInDiskCache();
+                break;
+            }
             _data = _reply->readAll();
             _loadedFromCache = _reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
             _result = Success;
@@ -76,6 +101,30 @@ void HTTPResourceRequest::onRequestFinished() {
     emit finished();
 }
 
+void HTTPResourceRequest::storeInDiskCache() {
+    const int NOT_MODIFIED = 304;
+    ResourceDiskCache::Validators validators;
+    bool storable = ResourceDiskCache::evalValidators(*_reply, validators);
+    if (_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == NOT_MODIFIED) {
+        if (ResourceDiskCache::load(_url, _data)) {
+            ResourceDiskCache::revalidate(_url, validators.expiration);
+            _loadedFromCache = true;
+            _result = Success;
+        } else {
+            // the entry went away since the request was sent
+            _result = Error;
+        }
+        return;
+    }
+    _data = _reply->readAll();
+    _result = Success;
+    if (storable) {
+        ResourceDiskCache::store(_url, _data, validators);
+    } else {
+        ResourceDiskCache::remove(_url);
+    }
+}
+
 void HTTPResourceRequest::onDownloadProgress(qint64 bytesReceived, qint64 bytesTotal) {
     Q_ASSERT(_state == InProgress);
     
@@ -33,6 +33,8 @@ private slots:
     void onRequestFinished();
 
 private:
+    void storeInDiskCache();
+
     QTimer _sendTimer;
     QNetworkReply* _reply { nullptr };
 };
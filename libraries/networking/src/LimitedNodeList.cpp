@@ -20,6 +20,7 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QUrl>
 #include <QtNetwork/QHostInfo>
+#include <QtNetwork/QNetworkInterface>
 
 #include <tbb/parallel_for.h>
 
@@ -48,6 +49,7 @@ LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short
     _dtlsSocket(NULL),
     _localSockAddr(),
     _publicSockAddr(),
+    _hostAddresses(QNetworkInterface::allAddresses()),
     _stunSockAddr(STUN_SERVER_HOSTNAME, STUN_SERVER_PORT),
     _packetReceiver(new PacketReceiver(this)),
     _numCollectedPackets(0),
@@ -105,6 +107,13 @@ LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short
         }
     );
 
+    // messages with a stream listener go to handleVerifiedPacket one packet at a time
+    _nodeSocket.setMessageStreamFilterOperator(
+        [this](const udt::Packet& packet) {
+            return _packetReceiver->isMessageStreamed(NLPacket::typeInHeader(packet));
+        }
+    );
+
     // set our isPacketVerified method as the verify operator for the udt::Socket
     using std::placeholders::_1;
     _nodeSocket.setPacketFilterOperator(std::bind(&LimitedNodeList::isPacketVerified, this, _1));
@@ -216,7 +225,9 @@ bool LimitedNodeList::packetSourceAndHashMatch(const udt::Packet& packet) {
         SharedNodePointer matchingNode = nodeWithUUID(sourceID);
         
         if (matchingNode) {
-            if (!NON_VERIFIED_PACKETS.contains(headerType)) {
+            // co-located nodes leave the hash out of what they send us over loopback
+            if (!NON_VERIFIED_PACKETS.contains(headerType)
+                && !isCoLocatedSender(packet.getSenderSockAddr(), *matchingNode)) {
                 
                 QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
                 QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, matchingNode->getConnectionSecret());
@@ -282,7 +293,8 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const Node&
     emit dataSent(destinationNode.getType(), packet.getDataSize());
     destinationNode.recordBytesSent(packet.getDataSize());
     
-    return sendUnreliablePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getConnectionSecret());
+    auto& activeSocket = *destinationNode.getActiveSocket();
+    return sendUnreliablePacket(packet, activeSocket, connectionSecretForDestination(destinationNode, activeSocket));
 }
 
 qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr,
@@ -297,6 +309,17 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiS
     return _nodeSocket.writePacket(packet, sockAddr);
 }
 
+void LimitedNodeList::setForwardErrorCorrection(const QSet<PacketType>& packetTypes, int groupSize, int numParityPackets) {
+    _nodeSocket.setForwardErrorCorrection([packetTypes](const udt::Packet& packet) {
+        return packetTypes.contains(NLPacket::typeInHeader(packet));
+    }, groupSize, numParityPackets);
+    
+    if (groupSize > 0) {
+        qCDebug(networking) << "Sending" << numParityPackets << "parity packets for every" << groupSize
+            << "unreliable packets of types" << packetTypes;
+    }
+}
+
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode) {
     Q_ASSERT(!packet->isPartOfMessage());
     if (!destinationNode.getActiveSocket()) {
@@ -306,7 +329,8 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
     emit dataSent(destinationNode.getType(), packet->getDataSize());
     destinationNode.recordBytesSent(packet->getDataSize());
     
-    return sendPacket(std::move(packet), *destinationNode.getActiveSocket(), destinationNode.getConnectionSecret());
+    auto& activeSocket = *destinationNode.getActiveSocket();
+    return sendPacket(std::move(packet), activeSocket, connectionSecretForDestination(destinationNode, activeSocket));
 }
 
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr,
@@ -331,7 +355,7 @@ qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const Node& des
         return 0;
     }
     qint64 bytesSent = 0;
-    auto connectionSecret = destinationNode.getConnectionSecret();
+    auto connectionSecret = connectionSecretForDestination(destinationNode, *activeSocket);
     
     // close the last packet in the list
     packetList.closeCurrentPacket();
@@ -362,6 +386,11 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
     // close the last packet in the list
     packetList->closeCurrentPacket();
     
+    if (packetList->isReliable()) {
+        // messages are cut into packets as large as the path to the destination carries
+        packetList->resizePackets(_nodeSocket.getMaxPacketSize(sockAddr));
+    }
+    
     for (std::unique_ptr<udt::Packet>& packet : packetList->_packets) {
         NLPacket* nlPacket = static_cast<NLPacket*>(packet.get());
         collectPacketStats(*nlPacket);
@@ -375,10 +404,17 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
     // close the last packet in the list
     packetList->closeCurrentPacket();
 
+    auto connectionSecret = connectionSecretForDestination(destinationNode, *destinationNode.getActiveSocket());
+    
+    if (packetList->isReliable()) {
+        // messages are cut into packets as large as the path to the destination carries
+        packetList->resizePackets(_nodeSocket.getMaxPacketSize(*destinationNode.getActiveSocket()));
+    }
+
     for (std::unique_ptr<udt::Packet>& packet : packetList->_packets) {
         NLPacket* nlPacket = static_cast<NLPacket*>(packet.get());
         collectPacketStats(*nlPacket);
-        fillPacketHeader(*nlPacket, destinationNode.getConnectionSecret());
+        fillPacketHeader(*nlPacket, connectionSecret);
     }
 
     return _nodeSocket.writePacketList(std::move(packetList), *destinationNode.getActiveSocket());
@@ -389,7 +425,32 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
     // use the node's active socket as the destination socket if there is no overriden socket address
     auto& destinationSockAddr = (overridenSockAddr.isNull()) ? *destinationNode.getActiveSocket()
                                                              : overridenSockAddr;
-    return sendPacket(std::move(packet), destinationSockAddr, destinationNode.getConnectionSecret());
+    return sendPacket(std::move(packet), destinationSockAddr,
+                      connectionSecretForDestination(destinationNode, destinationSockAddr));
+}
+
+QUuid LimitedNodeList::connectionSecretForDestination(const Node& destinationNode,
+                                                      const HifiSockAddr& destinationSockAddr) const {
+    // only a process on this host can send from a loopback address, so a co-located node can tell it is us from
+    // the socket the packet came from and the hash is left out, see isCoLocatedSender
+    if (destinationSockAddr.getAddress().isLoopback()) {
+        return QUuid();
+    }
+    return destinationNode.getConnectionSecret();
+}
+
+bool LimitedNodeList::isCoLocatedSender(const HifiSockAddr& senderSockAddr, const Node& sendingNode) const {
+    if (!senderSockAddr.getAddress().isLoopback()) {
+        return false;
+    }
+
+    // the port is bound by the node's process, so no other process on this host can send from it, as long as the
+    // node's socket is one on this host and not a remote node that happens to use the same port
+    auto isSendingNodeSocket = [&](const HifiSockAddr& nodeSockAddr) {
+        return nodeSockAddr.getPort() == senderSockAddr.getPort()
+            && (nodeSockAddr.getAddress().isLoopback() || _hostAddresses.contains(nodeSockAddr.getAddress()));
+    };
+    return isSendingNodeSocket(sendingNode.getPublicSocket()) || isSendingNodeSocket(sendingNode.getLocalSocket());
 }
 
 int LimitedNodeList::updateNodeWithDataFromPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
@@ -428,12 +489,32 @@ void LimitedNodeList::eraseAllNodes() {
         QWriteLocker writeLocker(&_nodeMutex);
         _nodeHash.clear();
     }
+
+    publishNodeSnapshot();
     
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
 }
 
+void LimitedNodeList::publishNodeSnapshot() {
+    QMutexLocker publishLocker(&_nodeSnapshotPublishMutex);
+
+    auto snapshot = std::make_shared<NodeSnapshot>();
+
+    {
+        QReadLocker readLocker(&_nodeMutex);
+
+        snapshot->reserve(_nodeHash.size());
+        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
+            snapshot->push_back(it->second);
+        }
+    }
+
+    // readers holding the previous snapshot keep it alive until they are done with it
+    std::atomic_store(&_nodeSnapshot, NodeSnapshotPointer(std::move(snapshot)));
+}
+
 void LimitedNodeList::reset() {
     eraseAllNodes();
     
@@ -454,6 +535,8 @@ void LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
             QWriteLocker writeLocker(&_nodeMutex);
             _nodeHash.unsafe_erase(it);
         }
+
+        publishNodeSnapshot();
         
         handleNodeKill(matchingNode);
     }
@@ -505,10 +588,21 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 
         _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
 
+        publishNodeSnapshot();
+
         qCDebug(networking) << "Added" << *newNode;
 
         emit nodeAdded(newNodePointer);
 
+        // a weak pointer in the lambda means the connection doesn't keep the node alive
+        QWeakPointer<Node> weakNodePointer = newNodePointer.toWeakRef();
+        connect(newNode, &NetworkPeer::socketActivated, this, [this, weakNodePointer] {
+            SharedNodePointer activatedNode = weakNodePointer.toStrongRef();
+            if (activatedNode) {
+                emit nodeActivated(activatedNode);
+            }
+        });
+
         return newNodePointer;
     }
 }
@@ -616,6 +710,10 @@ void LimitedNodeList::removeSilentNodes() {
         node->getMutex().unlock();
     });
 
+    if (!killedNodes.isEmpty()) {
+        publishNodeSnapshot();
+    }
+
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -17,12 +17,14 @@
 #include <iterator>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
 #endif
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
 #include <QtCore/QPointer>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QSet>
@@ -60,9 +62,19 @@ const QHostAddress DEFAULT_ASSIGNMENT_CLIENT_MONITOR_HOSTNAME = QHostAddress::Lo
 
 const QString USERNAME_UUID_REPLACEMENT_STATS_KEY = "$username";
 
+// each entry of a domain list starts with its kind, an added node is followed by its connection secret and a
+// removed one is only its UUID, the full lists only have added nodes
+typedef quint8 DomainListEntry_t;
+namespace DomainListEntry {
+    const DomainListEntry_t AddedNode = 0;
+    const DomainListEntry_t RemovedNode = 1;
+}
+
 using namespace tbb;
 typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
 typedef concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
+typedef std::vector<SharedNodePointer> NodeSnapshot;
+typedef std::shared_ptr<const NodeSnapshot> NodeSnapshotPointer;
 
 typedef quint8 PingType_t;
 namespace PingType {
@@ -94,6 +106,9 @@ public:
         AddedAudioMixer,
         SendAudioPing,
         SetAudioMixerSocket,
+        SetAvatarMixerSocket,
+        SetEntityServerSocket,
+        SetAssetServerSocket,
         SendAudioPacket,
         ReceiveFirstAudioPacket
     };
@@ -165,32 +180,37 @@ public:
 
     SharedNodePointer findNodeWithAddr(const HifiSockAddr& addr);
     
+    /// Immutable list of the nodes as they were after the last node add or kill. Grab it once (e.g. per mix frame)
+    /// and iterate it without taking any lock - a node killed since is still in it until the next snapshot is grabbed.
+    NodeSnapshotPointer getNodeSnapshot() const { return std::atomic_load(&_nodeSnapshot); }
+
+    // the iteration helpers below all go over the current snapshot, so they never contend with node adds or kills
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshotPointer snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const SharedNodePointer& node : *snapshot) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshotPointer snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const SharedNodePointer& node : *snapshot) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshotPointer snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const SharedNodePointer& node : *snapshot) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -198,11 +218,11 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshotPointer snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (const SharedNodePointer& node : *snapshot) {
+            if (predicate(node)) {
+                return node;
             }
         }
 
@@ -218,6 +238,10 @@ public:
 
     udt::Socket::StatsVector sampleStatsForAllConnections() { return _nodeSocket.sampleStatsForAllConnections(); }
 
+    /// sends parity after every groupSize unreliable packets of the given types so that receivers can rebuild up to
+    /// numParityPackets of them per group, a groupSize of 0 turns this off
+    void setForwardErrorCorrection(const QSet<PacketType>& packetTypes, int groupSize, int numParityPackets);
+
 public slots:
     void reset();
     void eraseAllNodes();
@@ -239,6 +263,7 @@ signals:
     void uuidChanged(const QUuid& ownerUUID, const QUuid& oldUUID);
     void nodeAdded(SharedNodePointer);
     void nodeKilled(SharedNodePointer);
+    void nodeActivated(SharedNodePointer);
 
     void localSockAddrChanged(const HifiSockAddr& localSockAddr);
     void publicSockAddrChanged(const HifiSockAddr& publicSockAddr);
@@ -257,6 +282,8 @@ protected:
                        const QUuid& connectionSecret = QUuid());
     void collectPacketStats(const NLPacket& packet);
     void fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret = QUuid());
+    QUuid connectionSecretForDestination(const Node& destinationNode, const HifiSockAddr& destinationSockAddr) const;
+    bool isCoLocatedSender(const HifiSockAddr& senderSockAddr, const Node& sendingNode) const;
     
     bool isPacketVerified(const udt::Packet& packet);
     bool packetVersionMatch(const udt::Packet& packet);
@@ -275,10 +302,13 @@ protected:
     QUuid _sessionUUID;
     NodeHash _nodeHash;
     QReadWriteLock _nodeMutex;
+    NodeSnapshotPointer _nodeSnapshot { std::make_shared<NodeSnapshot>() }; // only accessed with std::atomic_load/store
+    QMutex _nodeSnapshotPublishMutex; // makes sure the last snapshot published is built from the latest node hash
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
     HifiSockAddr _publicSockAddr;
+    QList<QHostAddress> _hostAddresses; // the addresses of this host's interfaces, for isCoLocatedSender
     HifiSockAddr _stunSockAddr;
 
     PacketReceiver* _packetReceiver;
@@ -301,6 +331,9 @@ protected:
     QMap<quint64, ConnectionStep> _lastConnectionTimes;
     bool _areConnectionTimesComplete = false;
 
+    // rebuilds the snapshot from the node hash, call after every change to the node hash
+    void publishNodeSnapshot();
+
     template<typename IteratorLambda>
     void eachNodeHashIterator(IteratorLambda functor) {
         QWriteLocker writeLock(&_nodeMutex);
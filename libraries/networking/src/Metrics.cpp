@@ -0,0 +1,148 @@
+//
+//  Metrics.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <QtCore/QMap>
+
+#include "NetworkLogging.h"
+
+MetricHistogram::MetricHistogram(const std::vector<double>& bucketBounds) :
+    _bucketBounds(bucketBounds),
+    _bucketCounts(new std::atomic<quint64>[bucketBounds.size() + 1])
+{
+    for (size_t i = 0; i <= _bucketBounds.size(); i++) {
+        _bucketCounts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::observe(double value) {
+    auto bucket = std::lower_bound(_bucketBounds.begin(), _bucketBounds.end(), value) - _bucketBounds.begin();
+    _bucketCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+
+    double sum = _sum.load(std::memory_order_relaxed);
+    while (!_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
+}
+
+struct MetricEntry {
+    QString help;
+    QByteArray type;
+    std::shared_ptr<MetricCounter> counter;
+    std::shared_ptr<MetricGauge> gauge;
+    std::shared_ptr<MetricHistogram> histogram;
+};
+
+// function statics, since the metrics of an assignment can be registered by the static initializers of its files
+static std::mutex& getMetricsMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+static QMap<QString, MetricEntry>& getMetrics() {
+    static QMap<QString, MetricEntry> metrics;
+    return metrics;
+}
+
+// the entry of the name, false if the name was registered with another type
+static bool findOrAddEntry(const QString& name, const QString& help, const QByteArray& type, MetricEntry*& entry) {
+    auto& metrics = getMetrics();
+    auto it = metrics.find(name);
+    if (it == metrics.end()) {
+        it = metrics.insert(name, MetricEntry());
+        it->help = help;
+        it->type = type;
+    } else if (it->type != type) {
+        qCWarning(networking) << "Metric" << name << "is already registered as a" << it->type << "not a" << type;
+        return false;
+    }
+    entry = &it.value();
+    return true;
+}
+
+std::shared_ptr<MetricCounter> MetricsRegistry::counter(const QString& name, const QString& help) {
+    std::lock_guard<std::mutex> lock(getMetricsMutex());
+    MetricEntry* entry;
+    if (!findOrAddEntry(name, help, "counter", entry)) {
+        return std::make_shared<MetricCounter>();
+    }
+    if (!entry->counter) {
+        entry->counter = std::make_shared<MetricCounter>();
+    }
+    return entry->counter;
+}
+
+std::shared_ptr<MetricGauge> MetricsRegistry::gauge(const QString& name, const QString& help) {
+    std::lock_guard<std::mutex> lock(getMetricsMutex());
+    MetricEntry* entry;
+    if (!findOrAddEntry(name, help, "gauge", entry)) {
+        return std::make_shared<MetricGauge>();
+    }
+    if (!entry->gauge) {
+        entry->gauge = std::make_shared<MetricGauge>();
+    }
+    return entry->gauge;
+}
+
+std::shared_ptr<MetricHistogram> MetricsRegistry::histogram(const QString& name, const QString& help,
+                                                            const std::vector<double>& bucketBounds) {
+    std::lock_guard<std::mutex> lock(getMetricsMutex());
+    MetricEntry* entry;
+    if (!findOrAddEntry(name, help, "histogram", entry)) {
+        return std::make_shared<MetricHistogram>(bucketBounds);
+    }
+    if (!entry->histogram) {
+        entry->histogram = std::make_shared<MetricHistogram>(bucketBounds);
+    }
+    return entry->histogram;
+}
+
+static QByteArray formatValue(double value) {
+    return QByteArray::number(value, 'g', 12);
+}
+
+QByteArray MetricsRegistry::toPrometheusText() {
+    std::lock_guard<std::mutex> lock(getMetricsMutex());
+    QByteArray text;
+    auto& metrics = getMetrics();
+    for (auto it = metrics.constBegin(); it != metrics.constEnd(); ++it) {
+        QByteArray name = it.key().toUtf8();
+        const MetricEntry& entry = it.value();
+        QByteArray help = entry.help.toUtf8();
+        help.replace("\\", "\\\\").replace("\n", "\\n");
+        text += "# HELP " + name + " " + help + "\n";
+        text += "# TYPE " + name + " " + entry.type + "\n";
+
+        if (entry.counter) {
+            text += name + " " + QByteArray::number(entry.counter->get()) + "\n";
+        } else if (entry.gauge) {
+            text += name + " " + formatValue(entry.gauge->get()) + "\n";
+        } else if (entry.histogram) {
+            // the buckets are cumulative in the export, each counts the values at or below its bound
+            const MetricHistogram& histogram = *entry.histogram;
+            const std::vector<double>& bounds = histogram.getBucketBounds();
+            quint64 cumulativeCount = 0;
+            for (size_t bucket = 0; bucket < bounds.size(); bucket++) {
+                cumulativeCount += histogram.getBucketCount((int)bucket);
+                text += name + "_bucket{le=\"" + formatValue(bounds[bucket]) + "\"} " +
+                    QByteArray::number(cumulativeCount) + "\n";
+            }
+            cumulativeCount += histogram.getBucketCount((int)bounds.size());
+            text += name + "_bucket{le=\"+Inf\"} " + QByteArray::number(cumulativeCount) + "\n";
+            text += name + "_sum " + formatValue(histogram.getSum()) + "\n";
+            text += name + "_count " + QByteArray::number(cumulativeCount) + "\n";
+        }
+    }
+    return text;
+}
@@ -0,0 +1,76 @@
+//
+//  Metrics.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Metrics_h
+#define hifi_Metrics_h
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+// A count that only goes up, like the packets sent. Metrics are updated with relaxed atomics and read only when they
+// are exported, so they cost next to nothing when nobody collects them.
+class MetricCounter {
+public:
+    void increment(quint64 amount = 1) { _value.fetch_add(amount, std::memory_order_relaxed); }
+    quint64 get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> _value { 0 };
+};
+
+// A value that goes up and down, like the nodes connected
+class MetricGauge {
+public:
+    void set(double value) { _value.store(value, std::memory_order_relaxed); }
+    double get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> _value { 0.0 };
+};
+
+// Counts of the values observed at or below each bound, and above the last one
+class MetricHistogram {
+public:
+    // the bounds go up
+    MetricHistogram(const std::vector<double>& bucketBounds);
+
+    void observe(double value);
+
+    const std::vector<double>& getBucketBounds() const { return _bucketBounds; }
+    // the values observed above the bound before the bucket and at or below its own, the last bucket has no bound
+    quint64 getBucketCount(int bucket) const { return _bucketCounts[bucket].load(std::memory_order_relaxed); }
+    quint64 getCount() const { return _count.load(std::memory_order_relaxed); }
+    double getSum() const { return _sum.load(std::memory_order_relaxed); }
+
+private:
+    const std::vector<double> _bucketBounds;
+    std::unique_ptr<std::atomic<quint64>[]> _bucketCounts;
+    std::atomic<quint64> _count { 0 };
+    std::atomic<double> _sum { 0.0 };
+};
+
+// The metrics of the process by name, for the assignments to register with and the metrics endpoint to export in the
+// Prometheus text format. Registering a name again gives back the metric it already has, so the assignments an
+// assignment client runs one after the other keep adding to the same metrics.
+class MetricsRegistry {
+public:
+    static std::shared_ptr<MetricCounter> counter(const QString& name, const QString& help);
+    static std::shared_ptr<MetricGauge> gauge(const QString& name, const QString& help);
+    static std::shared_ptr<MetricHistogram> histogram(const QString& name, const QString& help,
+                                                      const std::vector<double>& bucketBounds);
+
+    static QByteArray toPrometheusText();
+};
+
+#endif // hifi_Metrics_h
@@ -11,6 +11,8 @@
 
 #include "NLPacket.h"
 
+#include <SipHash.h>
+
 int NLPacket::localHeaderSize(PacketType type) {
     bool nonSourced = NON_SOURCED_PACKETS.contains(type);
     bool nonVerified = NON_VERIFIED_PACKETS.contains(type);
@@ -32,7 +34,7 @@ std::unique_ptr<NLPacket> NLPacket::create(PacketType type, qint64 size, bool is
     return packet;
 }
 
-std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(PacketBuffer data, qint64 size,
                                                        const HifiSockAddr& senderSockAddr) {
     // Fail with null data
     Q_ASSERT(data);
@@ -87,7 +89,7 @@ NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
     _sourceID = other._sourceID;
 }
 
-NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+NLPacket::NLPacket(PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     Packet(std::move(data), size, senderSockAddr)
 {    
     // sanity check before we decrease the payloadSize with the payloadCapacity
@@ -149,11 +151,38 @@ QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
     return QByteArray(packet.getData() + offset, NUM_BYTES_MD5_HASH);
 }
 
+static QByteArray sipHashForPacketAndSecret(const udt::Packet& packet, int payloadOffset, const QUuid& connectionSecret) {
+    // the connection secret is the key, in its RFC 4122 byte order but without making a QByteArray for it
+    unsigned char key[SIP_HASH_KEY_SIZE];
+    for (int i = 0; i < 4; i++) {
+        key[i] = (unsigned char)(connectionSecret.data1 >> (24 - 8 * i));
+    }
+    key[4] = (unsigned char)(connectionSecret.data2 >> 8);
+    key[5] = (unsigned char)connectionSecret.data2;
+    key[6] = (unsigned char)(connectionSecret.data3 >> 8);
+    key[7] = (unsigned char)connectionSecret.data3;
+    memcpy(key + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+
+    uint64_t mac = sipHash24(key, reinterpret_cast<const unsigned char*>(packet.getData() + payloadOffset),
+                             packet.getDataSize() - payloadOffset);
+
+    // the 64 bit MAC goes in the front of the hash in the header, little endian, and the rest is left zero
+    QByteArray hash(NUM_BYTES_MD5_HASH, 0);
+    for (int i = 0; i < (int)sizeof(mac); i++) {
+        hash[i] = (char)(mac >> (8 * i));
+    }
+    return hash;
+}
+
 QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret) {
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    
     int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
         + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
+
+    if (SIP_HASH_VERIFIED_PACKETS.contains(typeInHeader(packet))) {
+        return sipHashForPacketAndSecret(packet, offset, connectionSecret);
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
     
     // add the packet payload and the connection UUID
     hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
@@ -29,7 +29,7 @@ public:
     static std::unique_ptr<NLPacket> create(PacketType type, qint64 size = -1,
                                             bool isReliable = false, bool isPartOfMessage = false);
     
-    static std::unique_ptr<NLPacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+    static std::unique_ptr<NLPacket> fromReceivedPacket(PacketBuffer data, qint64 size,
                                                         const HifiSockAddr& senderSockAddr);
     static std::unique_ptr<NLPacket> fromBase(std::unique_ptr<Packet> packet);
     
@@ -63,7 +63,7 @@ public:
 protected:
     
     NLPacket(PacketType type, qint64 size = -1, bool forceReliable = false, bool isPartOfMessage = false);
-    NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr);
+    NLPacket(PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr);
     
     NLPacket(const NLPacket& other);
     NLPacket(NLPacket&& other);
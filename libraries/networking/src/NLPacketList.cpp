@@ -48,5 +48,6 @@ NLPacketList::NLPacketList(PacketList&& other) : PacketList(std::move(other)) {
 }
 
 std::unique_ptr<udt::Packet> NLPacketList::createPacket() {
-    return NLPacket::create(getType(), -1, isReliable(), isOrdered());
+    qint64 payloadSize = (_maxPacketSize == -1) ? -1 : _maxPacketSize - NLPacket::totalHeaderSize(getType(), isOrdered());
+    return NLPacket::create(getType(), payloadSize, isReliable(), isOrdered());
 }
@@ -33,6 +33,7 @@ void NodeType::init() {
     TypeNameHash.insert(NodeType::AudioMixer, "Audio Mixer");
     TypeNameHash.insert(NodeType::AvatarMixer, "Avatar Mixer");
     TypeNameHash.insert(NodeType::AssetServer, "Asset Server");
+    TypeNameHash.insert(NodeType::PhysicsSimulator, "Physics Simulator");
     TypeNameHash.insert(NodeType::Unassigned, "Unassigned");
 }
 
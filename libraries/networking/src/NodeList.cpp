@@ -14,6 +14,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtCore/QMetaEnum>
 #include <QtCore/QUrl>
 #include <QtCore/QThread>
@@ -29,6 +30,7 @@
 #include "HifiSockAddr.h"
 
 #include "NetworkLogging.h"
+#include "udt/CongestionControl.h"
 #include "udt/PacketHeaders.h"
 #include "SharedUtil.h"
 
@@ -79,6 +81,9 @@ NodeList::NodeList(char newOwnerType, unsigned short socketListenPort, unsigned
     // send a ping punch immediately
     connect(&_domainHandler, &DomainHandler::icePeerSocketsReceived, this, &NodeList::pingPunchForDomainServer);
 
+    // pick the congestion control the domain wants for our type of node
+    connect(&_domainHandler, &DomainHandler::settingsReceived, this, &NodeList::setCongestionControlFromSettings);
+
     // clear out NodeList when login is finished
     connect(&AccountManager::getInstance(), &AccountManager::loginComplete , this, &NodeList::reset);
 
@@ -88,6 +93,9 @@ NodeList::NodeList(char newOwnerType, unsigned short socketListenPort, unsigned
     // anytime we get a new node we will want to attempt to punch to it
     connect(this, &LimitedNodeList::nodeAdded, this, &NodeList::startNodeHolePunch);
 
+    // and once we can reach it, we get the rest of the connection going without waiting on the first packet for it
+    connect(this, &LimitedNodeList::nodeActivated, this, &NodeList::handleNodeActivation);
+
     // we definitely want STUN to update our public socket, so call the LNL to kick that off
     startSTUNPublicSocketUpdate();
 
@@ -107,6 +115,7 @@ NodeList::NodeList(char newOwnerType, unsigned short socketListenPort, unsigned
 
 qint64 NodeList::sendStats(const QJsonObject& statsObject, const HifiSockAddr& destination) {
     auto statsPacketList = NLPacketList::create(PacketType::NodeJsonStats, QByteArray(), true, true);
+    statsPacketList->setPriority(udt::PacketList::Priority::Bulk);
 
     QJsonDocument jsonDocument(statsObject);
     statsPacketList->write(jsonDocument.toBinaryData());
@@ -194,6 +203,7 @@ void NodeList::reset() {
     LimitedNodeList::reset();
 
     _numNoReplyDomainCheckIns = 0;
+    _domainListVersion = 0;
 
     // refresh the owner UUID to the NULL UUID
     setSessionUUID(QUuid());
@@ -271,6 +281,11 @@ void NodeList::sendDomainServerCheckIn() {
 
         // pack our data to send to the domain-server
         packetStream << _ownerType << _publicSockAddr << _localSockAddr << _nodeTypesOfInterest.toList();
+
+        if (domainPacketType == PacketType::DomainListRequest) {
+            // so that the domain-server only sends what changed since the list we have
+            packetStream << _domainListVersion;
+        }
         
         // if this is a connect request, and we can present a username signature, send it along
         if (!_domainHandler.isConnected() ) {
@@ -453,6 +468,36 @@ void NodeList::pingPunchForDomainServer() {
     }
 }
 
+void NodeList::setCongestionControlFromSettings(const QJsonObject& domainSettingsObject) {
+    static const QString CONGESTION_CONTROL_GROUP_KEY = "congestion_control";
+    static const QString BBR_CONGESTION_CONTROL = "bbr";
+
+    // the domain only sends us the setting for our own node type
+    static const QHash<NodeType_t, QString> CONGESTION_CONTROL_KEYS {
+        { NodeType::AudioMixer, "audio_mixer" },
+        { NodeType::AvatarMixer, "avatar_mixer" },
+        { NodeType::AssetServer, "asset_server" },
+        { NodeType::EntityServer, "entity_server" }
+    };
+
+    QString congestionControlKey = CONGESTION_CONTROL_KEYS.value(_ownerType);
+    QJsonObject congestionControlObject = domainSettingsObject[CONGESTION_CONTROL_GROUP_KEY].toObject();
+
+    if (congestionControlKey.isEmpty() || !congestionControlObject.contains(congestionControlKey)) {
+        return;
+    }
+
+    // this only applies to connections created from now on
+    if (congestionControlObject[congestionControlKey].toString() == BBR_CONGESTION_CONTROL) {
+        qCDebug(networking) << "Using BBR congestion control for new connections";
+        _nodeSocket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+            new udt::CongestionControlFactory<udt::BBRCC>()));
+    } else {
+        _nodeSocket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+            new udt::CongestionControlFactory<udt::DefaultCC>()));
+    }
+}
+
 void NodeList::processDomainServerConnectionTokenPacket(QSharedPointer<NLPacket> packet) {
     if (_domainHandler.getSockAddr().isNull()) {
         // refuse to process this packet if we aren't currently connected to the DS
@@ -498,10 +543,35 @@ void NodeList::processDomainServerList(QSharedPointer<NLPacket> packet) {
     quint8 thisNodeCanRez;
     packetStream >> thisNodeCanRez;
     setThisNodeCanRez((bool) thisNodeCanRez);
+
+    // an incremental list has the changes since the version it applies to, a full one applies to any
+    quint32 listVersion, baseListVersion;
+    packetStream >> listVersion >> baseListVersion;
+
+    if (baseListVersion != 0 && domainUUID != _domainHandler.getUUID()) {
+        // the changes are to a list from another domain-server
+        _domainListVersion = 0;
+        return;
+    }
+
+    if (baseListVersion != 0 && baseListVersion != _domainListVersion && listVersion != _domainListVersion) {
+        // the changes are to a list we don't have, the next check-in asks for the changes to the one we do have
+        return;
+    }
+    _domainListVersion = listVersion;
     
     // pull each node in the packet
     while (packetStream.device()->pos() < packet->getPayloadSize()) {
-        parseNodeFromPacketStream(packetStream);
+        DomainListEntry_t entry;
+        packetStream >> entry;
+
+        if (entry == DomainListEntry::RemovedNode) {
+            QUuid nodeUUID;
+            packetStream >> nodeUUID;
+            killNodeWithUUID(nodeUUID);
+        } else {
+            parseNodeFromPacketStream(packetStream);
+        }
     }
 }
 
@@ -599,6 +669,25 @@ void NodeList::handleNodePingTimeout() {
     }
 }
 
+void NodeList::handleNodeActivation(const SharedNodePointer& node) {
+    switch (node->getType()) {
+        case NodeType::AvatarMixer:
+            flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SetAvatarMixerSocket);
+            break;
+        case NodeType::EntityServer:
+            flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SetEntityServerSocket);
+            break;
+        case NodeType::AssetServer:
+            flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SetAssetServerSocket);
+
+            // the asset requests are reliable - shake hands now so the first of them doesn't wait a round trip for it
+            _nodeSocket.startHandshake(*node->getActiveSocket());
+            break;
+        default:
+            break;
+    }
+}
+
 void NodeList::activateSocketFromNodeCommunication(QSharedPointer<NLPacket> packet, const SharedNodePointer& sendingNode) {
     // deconstruct this ping packet to see if it is a public or local reply
     QDataStream packetStream(packet.data());
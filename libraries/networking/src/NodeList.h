@@ -90,8 +90,11 @@ private slots:
 
     void startNodeHolePunch(const SharedNodePointer& node);
     void handleNodePingTimeout();
+    void handleNodeActivation(const SharedNodePointer& node);
 
     void pingPunchForDomainServer();
+
+    void setCongestionControlFromSettings(const QJsonObject& domainSettingsObject);
 private:
     NodeList() : LimitedNodeList(0, 0) { assert(false); } // Not implemented, needed for DependencyManager templates compile
     NodeList(char ownerType, unsigned short socketListenPort = 0, unsigned short dtlsListenPort = 0);
@@ -113,6 +116,7 @@ private:
     NodeSet _nodeTypesOfInterest;
     DomainHandler _domainHandler;
     int _numNoReplyDomainCheckIns;
+    quint32 _domainListVersion { 0 }; // the version of the last domain list, sent with each check-in
     HifiSockAddr _assignmentServerSocket;
 };
 
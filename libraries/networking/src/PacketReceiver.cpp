@@ -108,6 +108,14 @@ bool PacketReceiver::registerMessageListener(PacketType type, QObject* listener,
                 << "that will remove a previously registered listener";
         }
 
+        if (_packetListHandlerMap.remove(type) > 0) {
+            qCWarning(networking) << "Registering a packet listener for packet type" << type
+                << "that will remove a previously registered handler";
+        }
+
+        // messages of this type are reassembled again
+        _streamedMessageTypes.remove(type);
+
         // add the mapping
         _packetListListenerMap[type] = ObjectMethodPair(QPointer<QObject>(listener), matchingMethod);
         return true;
@@ -116,6 +124,34 @@ bool PacketReceiver::registerMessageListener(PacketType type, QObject* listener,
     }
 }
 
+bool PacketReceiver::registerMessageStreamListener(PacketType type, QObject* listener, const char* slot) {
+    Q_ASSERT_X(listener, "PacketReceiver::registerMessageStreamListener", "No object to register");
+    Q_ASSERT_X(slot, "PacketReceiver::registerMessageStreamListener", "No slot to register");
+    
+    if (!registerListener(type, listener, slot)) {
+        return false;
+    }
+    
+    QMutexLocker locker(&_packetListenerLock);
+    
+    int numRemoved = _packetListListenerMap.remove(type) + _packetListHandlerMap.remove(type);
+    if (numRemoved > 0) {
+        qCWarning(networking) << "Registering a message stream listener for packet type" << type
+            << "that will remove a previously registered message listener";
+    }
+    
+    _streamedMessageTypes.insert(type);
+    
+    return true;
+}
+
+bool PacketReceiver::isMessageStreamed(PacketType type) {
+    QMutexLocker locker(&_packetListenerLock);
+    
+    // once the listener is gone the messages are reassembled again, so that they hit the missing listener warning
+    return _streamedMessageTypes.contains(type) && _packetListenerMap.contains(type) && _packetListenerMap[type].first;
+}
+
 bool PacketReceiver::registerListener(PacketType type, QObject* listener, const char* slot) {
     Q_ASSERT_X(listener, "PacketReceiver::registerListener", "No object to register");
     Q_ASSERT_X(slot, "PacketReceiver::registerListener", "No slot to register");
@@ -201,10 +237,65 @@ void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object,
             << "that will remove a previously registered listener";
     }
     
+    if (_packetHandlerMap.remove(type) > 0) {
+        qCWarning(networking) << "Registering a packet listener for packet type" << type
+            << "that will remove a previously registered handler";
+    }
+    
     // add the mapping
     _packetListenerMap[type] = ObjectMethodPair(QPointer<QObject>(object), slot);
 }
 
+bool PacketReceiver::registerDirectHandlerForTypes(PacketTypeList types, QObject* listener, PacketHandler handler) {
+    Q_ASSERT_X(!types.empty(), "PacketReceiver::registerDirectHandlerForTypes", "No types to register");
+    Q_ASSERT_X(listener, "PacketReceiver::registerDirectHandlerForTypes", "No object to register");
+    Q_ASSERT_X(handler, "PacketReceiver::registerDirectHandlerForTypes", "No handler to register");
+    
+    for (auto type : types) {
+        registerDirectHandler(type, listener, handler);
+    }
+    
+    return true;
+}
+
+bool PacketReceiver::registerDirectHandler(PacketType type, QObject* listener, PacketHandler handler) {
+    Q_ASSERT_X(listener, "PacketReceiver::registerDirectHandler", "No object to register");
+    Q_ASSERT_X(handler, "PacketReceiver::registerDirectHandler", "No handler to register");
+    
+    QMutexLocker locker(&_packetListenerLock);
+    
+    if (_packetHandlerMap.contains(type) || (_packetListenerMap.contains(type) && _packetListenerMap[type].second.isValid())) {
+        qCWarning(networking) << "Registering a packet handler for packet type" << type
+            << "that will remove a previously registered listener";
+    }
+    
+    // a type is either dispatched to a slot or a direct handler, not both
+    _packetListenerMap.remove(type);
+    _packetHandlerMap[type] = ObjectHandlerPair(QPointer<QObject>(listener), std::move(handler));
+    
+    return true;
+}
+
+bool PacketReceiver::registerDirectMessageHandler(PacketType type, QObject* listener, PacketListHandler handler) {
+    Q_ASSERT_X(listener, "PacketReceiver::registerDirectMessageHandler", "No object to register");
+    Q_ASSERT_X(handler, "PacketReceiver::registerDirectMessageHandler", "No handler to register");
+    
+    QMutexLocker locker(&_packetListenerLock);
+    
+    if (_packetListHandlerMap.contains(type)
+        || (_packetListListenerMap.contains(type) && _packetListListenerMap[type].second.isValid())) {
+        qCWarning(networking) << "Registering a packet list handler for packet type" << type
+            << "that will remove a previously registered listener";
+    }
+    
+    // a type is either dispatched to a slot or a direct handler, not both
+    _packetListListenerMap.remove(type);
+    _streamedMessageTypes.remove(type);
+    _packetListHandlerMap[type] = ObjectListHandlerPair(QPointer<QObject>(listener), std::move(handler));
+    
+    return true;
+}
+
 void PacketReceiver::unregisterListener(QObject* listener) {
     Q_ASSERT_X(listener, "PacketReceiver::unregisterListener", "No listener to unregister");
     
@@ -234,6 +325,27 @@ void PacketReceiver::unregisterListener(QObject* listener) {
                 ++listIt;
             }
         }
+        
+        // clear any direct handlers registered for this listener
+        auto handlerIt = _packetHandlerMap.begin();
+        
+        while (handlerIt != _packetHandlerMap.end()) {
+            if (handlerIt.value().first == listener) {
+                handlerIt = _packetHandlerMap.erase(handlerIt);
+            } else {
+                ++handlerIt;
+            }
+        }
+        
+        auto listHandlerIt = _packetListHandlerMap.begin();
+        
+        while (listHandlerIt != _packetListHandlerMap.end()) {
+            if (listHandlerIt.value().first == listener) {
+                listHandlerIt = _packetListHandlerMap.erase(listHandlerIt);
+            } else {
+                ++listHandlerIt;
+            }
+        }
     }
     
     QMutexLocker directConnectSetLocker(&_directConnectSetMutex);
@@ -262,6 +374,31 @@ void PacketReceiver::handleVerifiedPacketList(std::unique_ptr<udt::PacketList> p
     
     QMutexLocker packetListenerLocker(&_packetListenerLock);
     
+    // check for a direct handler first, those are called right here with no meta-call
+    auto handlerIt = _packetListHandlerMap.find(nlPacketList->getType());
+    
+    if (handlerIt != _packetListHandlerMap.end()) {
+        PacketType packetType = nlPacketList->getType();
+        
+        if (handlerIt.value().first) {
+            emit dataReceived(matchingNode ? matchingNode->getType() : NodeType::Unassigned,
+                              nlPacketList->getDataSize());
+            
+            if (matchingNode || NON_SOURCED_PACKETS.contains(packetType)) {
+                handlerIt.value().second(QSharedPointer<NLPacketList>(nlPacketList.release()), matchingNode);
+            } else {
+                qCDebug(networking).nospace() << "Error delivering packet " << packetType << " to handler for "
+                    << handlerIt.value().first << " - no matching node for sourced packet";
+            }
+        } else {
+            qCDebug(networking).nospace() << "Handler for packet " << packetType
+                << " has been destroyed. Removing from handler map.";
+            _packetListHandlerMap.erase(handlerIt);
+        }
+        
+        return;
+    }
+    
     bool listenerIsDead = false;
     
     auto it = _packetListListenerMap.find(nlPacketList->getType());
@@ -382,6 +519,35 @@ void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
     
     QMutexLocker packetListenerLocker(&_packetListenerLock);
     
+    // check for a direct handler first, those are called right here with no meta-call
+    auto handlerIt = _packetHandlerMap.find(nlPacket->getType());
+    
+    if (handlerIt != _packetHandlerMap.end()) {
+        PacketType packetType = nlPacket->getType();
+        
+        if (handlerIt.value().first) {
+            if (matchingNode) {
+                emit dataReceived(matchingNode->getType(), nlPacket->getDataSize());
+                matchingNode->recordBytesReceived(nlPacket->getDataSize());
+            } else {
+                emit dataReceived(NodeType::Unassigned, nlPacket->getDataSize());
+            }
+            
+            if (matchingNode || NON_SOURCED_PACKETS.contains(packetType)) {
+                handlerIt.value().second(QSharedPointer<NLPacket>(nlPacket.release()), matchingNode);
+            } else {
+                qCDebug(networking).nospace() << "Error delivering packet " << packetType << " to handler for "
+                    << handlerIt.value().first << " - no matching node for sourced packet";
+            }
+        } else {
+            qCDebug(networking).nospace() << "Handler for packet " << packetType
+                << " has been destroyed. Removing from handler map.";
+            _packetHandlerMap.erase(handlerIt);
+        }
+        
+        return;
+    }
+    
     bool listenerIsDead = false;
     
     auto it = _packetListenerMap.find(nlPacket->getType());
@@ -13,6 +13,7 @@
 #ifndef hifi_PacketReceiver_h
 #define hifi_PacketReceiver_h
 
+#include <functional>
 #include <vector>
 
 #include <QtCore/QMap>
@@ -24,6 +25,7 @@
 
 #include "NLPacket.h"
 #include "NLPacketList.h"
+#include "Node.h"
 #include "udt/PacketHeaders.h"
 
 class EntityEditPacketSender;
@@ -34,6 +36,10 @@ class PacketReceiver : public QObject {
 public:
     using PacketTypeList = std::vector<PacketType>;
     
+    // sendingNode is null for non sourced packet types
+    using PacketHandler = std::function<void(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode)>;
+    using PacketListHandler = std::function<void(QSharedPointer<NLPacketList> packetList, SharedNodePointer sendingNode)>;
+    
     PacketReceiver(QObject* parent = 0);
     PacketReceiver(const PacketReceiver&) = delete;
 
@@ -51,6 +57,29 @@ public:
     bool registerListener(PacketType type, QObject* listener, const char* slot);
     void unregisterListener(QObject* listener);
     
+    // A message stream listener has a packet slot that is given every packet of a reliable message as soon as the
+    // packets before it have arrived, instead of waiting for the whole message to be reassembled into an NLPacketList.
+    // The packets of a message arrive in order and the last one has the LAST or ONLY packet position.
+    bool registerMessageStreamListener(PacketType type, QObject* listener, const char* slot);
+    bool isMessageStreamed(PacketType type);
+    
+    // Direct handlers are called straight from the thread that receives the packets, without going through the
+    // meta-object system. Only use these for listeners that are safe to call from that thread - listeners living
+    // on another thread should use the slot based registration above.
+    // The listener only scopes the registration: it will be dropped once the listener is destroyed or unregistered.
+    bool registerDirectHandlerForTypes(PacketTypeList types, QObject* listener, PacketHandler handler);
+    bool registerDirectHandler(PacketType type, QObject* listener, PacketHandler handler);
+    bool registerDirectMessageHandler(PacketType type, QObject* listener, PacketListHandler handler);
+    
+    template <typename T>
+    bool registerDirectHandlerForTypes(PacketTypeList types, T* listener,
+                                       void (T::*method)(QSharedPointer<NLPacket>, SharedNodePointer));
+    template <typename T>
+    bool registerDirectHandler(PacketType type, T* listener, void (T::*method)(QSharedPointer<NLPacket>, SharedNodePointer));
+    template <typename T>
+    bool registerDirectMessageHandler(PacketType type, T* listener,
+                                      void (T::*method)(QSharedPointer<NLPacketList>, SharedNodePointer));
+    
     void handleVerifiedPacket(std::unique_ptr<udt::Packet> packet);
     void handleVerifiedPacketList(std::unique_ptr<udt::PacketList> packetList);
 
@@ -67,11 +96,16 @@ private:
     void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot);
     
     using ObjectMethodPair = std::pair<QPointer<QObject>, QMetaMethod>;
+    using ObjectHandlerPair = std::pair<QPointer<QObject>, PacketHandler>;
+    using ObjectListHandlerPair = std::pair<QPointer<QObject>, PacketListHandler>;
 
     QMutex _packetListenerLock;
     // TODO: replace the two following hashes with an std::vector once we switch Packet/PacketList to Message
     QHash<PacketType, ObjectMethodPair> _packetListenerMap;
     QHash<PacketType, ObjectMethodPair> _packetListListenerMap;
+    QHash<PacketType, ObjectHandlerPair> _packetHandlerMap;
+    QHash<PacketType, ObjectListHandlerPair> _packetListHandlerMap;
+    QSet<PacketType> _streamedMessageTypes; // messages of these types go to the listener in _packetListenerMap
     int _inPacketCount = 0;
     int _inByteCount = 0;
     bool _shouldDropPackets = false;
@@ -82,4 +116,31 @@ private:
     friend class OctreePacketProcessor;
 };
 
+template <typename T>
+bool PacketReceiver::registerDirectHandlerForTypes(PacketTypeList types, T* listener,
+                                                   void (T::*method)(QSharedPointer<NLPacket>, SharedNodePointer)) {
+    return registerDirectHandlerForTypes(std::move(types), listener,
+        [listener, method](QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
+            (listener->*method)(packet, sendingNode);
+        });
+}
+
+template <typename T>
+bool PacketReceiver::registerDirectHandler(PacketType type, T* listener,
+                                           void (T::*method)(QSharedPointer<NLPacket>, SharedNodePointer)) {
+    return registerDirectHandler(type, listener,
+        [listener, method](QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
+            (listener->*method)(packet, sendingNode);
+        });
+}
+
+template <typename T>
+bool PacketReceiver::registerDirectMessageHandler(PacketType type, T* listener,
+                                                  void (T::*method)(QSharedPointer<NLPacketList>, SharedNodePointer)) {
+    return registerDirectMessageHandler(type, listener,
+        [listener, method](QSharedPointer<NLPacketList> packetList, SharedNodePointer sendingNode) {
+            (listener->*method)(packetList, sendingNode);
+        });
+}
+
 #endif // hifi_PacketReceiver_h
@@ -21,18 +21,25 @@ ReceivedPacketProcessor::ReceivedPacketProcessor() {
 
 
 void ReceivedPacketProcessor::terminating() {
-    _hasPackets.wakeAll();
+    _packetsParker.wakeAll();
 }
 
 void ReceivedPacketProcessor::queueReceivedPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
-    lock();
-    _packets.push_back({ sendingNode, packet });
-    _nodePacketCounts[sendingNode->getUUID()]++;
+    _packetCount++;
+    _undrainedPacketCount++;
     _lastWindowIncomingPackets++;
-    unlock();
+    _packets.push({ sendingNode, packet });
 
     // Make sure to wake our actual processing thread because we now have packets for it to process.
-    _hasPackets.wakeAll();
+    _packetsParker.notify();
+}
+
+bool ReceivedPacketProcessor::hasPacketsToProcessFrom(const QUuid& nodeUUID) const {
+    if (_undrainedPacketCount.load() > 0) {
+        return true;
+    }
+    QMutexLocker locker(&_nodePacketCountsMutex);
+    return _nodePacketCounts.value(nodeUUID) > 0;
 }
 
 bool ReceivedPacketProcessor::process() {
@@ -40,54 +47,58 @@ bool ReceivedPacketProcessor::process() {
     quint64 sinceLastWindow = now - _lastWindowAt;
 
     if (sinceLastWindow > USECS_PER_SECOND) {
-        lock();
         float secondsSinceLastWindow = sinceLastWindow / USECS_PER_SECOND;
-        float incomingPacketsPerSecondInWindow = (float)_lastWindowIncomingPackets / secondsSinceLastWindow;
+        float incomingPacketsPerSecondInWindow = (float)_lastWindowIncomingPackets.exchange(0) / secondsSinceLastWindow;
         _incomingPPS.updateAverage(incomingPacketsPerSecondInWindow);
 
         float processedPacketsPerSecondInWindow = (float)_lastWindowProcessedPackets / secondsSinceLastWindow;
         _processedPPS.updateAverage(processedPacketsPerSecondInWindow);
 
         _lastWindowAt = now;
-        _lastWindowIncomingPackets = 0;
         _lastWindowProcessedPackets = 0;
-        unlock();
     }
 
-    if (_packets.size() == 0) {
-        _waitingOnPacketsMutex.lock();
-        _hasPackets.wait(&_waitingOnPacketsMutex, getMaxWait());
-        _waitingOnPacketsMutex.unlock();
-    }
+    _packetsParker.wait([this] { return !_packets.isEmpty() || !isStillRunning(); }, getSpinCount(), getMaxWait());
 
     preProcess();
-    if (!_packets.size()) {
+
+    _currentPackets.clear();
+    int drainedCount = _packets.drain(_currentPackets, getMaxBatchSize());
+    if (!drainedCount) {
         return isStillRunning();
     }
 
-    lock();
-    std::list<NodeSharedPacketPair> currentPackets;
-    currentPackets.swap(_packets);
-    unlock();
+    {
+        QMutexLocker locker(&_nodePacketCountsMutex);
+        for (auto& packetPair : _currentPackets) {
+            _nodePacketCounts[packetPair.first->getUUID()]++;
+        }
+    }
+    _undrainedPacketCount -= drainedCount;
 
-    for(auto& packetPair : currentPackets) {
+    for (auto& packetPair : _currentPackets) {
         processPacket(packetPair.second, packetPair.first);
         _lastWindowProcessedPackets++;
         midProcess();
     }
 
-    lock();
-    for(auto& packetPair : currentPackets) {
-        _nodePacketCounts[packetPair.first->getUUID()]--;
+    {
+        QMutexLocker locker(&_nodePacketCountsMutex);
+        for (auto& packetPair : _currentPackets) {
+            auto it = _nodePacketCounts.find(packetPair.first->getUUID());
+            if (it != _nodePacketCounts.end()) {
+                --it.value();
+            }
+        }
     }
-    unlock();
+    _packetCount -= drainedCount;
+    _currentPackets.clear();
 
     postProcess();
     return isStillRunning();  // keep running till they terminate us
 }
 
 void ReceivedPacketProcessor::nodeKilled(SharedNodePointer node) {
-    lock();
+    QMutexLocker locker(&_nodePacketCountsMutex);
     _nodePacketCounts.remove(node->getUUID());
-    unlock();
 }
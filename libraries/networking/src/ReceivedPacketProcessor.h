@@ -12,11 +12,18 @@
 #ifndef hifi_ReceivedPacketProcessor_h
 #define hifi_ReceivedPacketProcessor_h
 
-#include <QWaitCondition>
+#include <atomic>
+#include <climits>
+#include <vector>
+
+#include <QMutex>
+
+#include <MPSCQueue.h>
 
 #include "GenericThread.h"
 
-/// Generalized threaded processor for handling received inbound packets.
+/// Generalized threaded processor for handling received inbound packets. The receive thread queues packets without
+/// taking a lock, and the processing thread drains them in batches.
 class ReceivedPacketProcessor : public GenericThread {
     Q_OBJECT
 public:
@@ -26,10 +33,11 @@ public:
     void queueReceivedPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
 
     /// Are there received packets waiting to be processed
-    bool hasPacketsToProcess() const { return _packets.size() > 0; }
+    bool hasPacketsToProcess() const { return _packetCount.load() > 0; }
 
     /// Is a specified node still alive?
     bool isAlive(const QUuid& nodeUUID) const {
+        QMutexLocker locker(&_nodePacketCountsMutex);
         return _nodePacketCounts.contains(nodeUUID);
     }
 
@@ -38,13 +46,12 @@ public:
         return hasPacketsToProcessFrom(sendingNode->getUUID());
     }
 
-    /// Are there received packets waiting to be processed from a specified node
-    bool hasPacketsToProcessFrom(const QUuid& nodeUUID) const {
-        return _nodePacketCounts[nodeUUID] > 0;
-    }
+    /// Are there received packets waiting to be processed from a specified node, the packets that haven't been taken
+    /// off the queue yet aren't counted by node, so this is true whenever there are any
+    bool hasPacketsToProcessFrom(const QUuid& nodeUUID) const;
 
     /// How many received packets waiting are to be processed
-    int packetsToProcessCount() const { return _packets.size(); }
+    int packetsToProcessCount() const { return _packetCount.load(); }
 
     float getIncomingPPS() const { return _incomingPPS.getAverage(); }
     float getProcessedPPS() const { return _processedPPS.getAverage(); }
@@ -66,6 +73,12 @@ protected:
     /// Determines the timeout of the wait when there are no packets to process. Default value means no timeout
     virtual unsigned long getMaxWait() const { return ULONG_MAX; }
 
+    /// Determines the most packets taken off the queue and processed in one pass. Default value means no limit
+    virtual int getMaxBatchSize() const { return INT_MAX; }
+
+    /// Determines the times the queue is checked before the thread waits for packets. Default never spins
+    virtual int getSpinCount() const { return 0; }
+
     /// Override to do work before the packets processing loop. Default does nothing.
     virtual void preProcess() { }
 
@@ -76,14 +89,19 @@ protected:
     virtual void postProcess() { }
 
 protected:
-    std::list<NodeSharedPacketPair> _packets;
-    QHash<QUuid, int> _nodePacketCounts;
+    MPSCQueue<NodeSharedPacketPair> _packets;
+    ConsumerParker _packetsParker;
+    std::vector<NodeSharedPacketPair> _currentPackets; // kept between passes for its capacity
 
-    QWaitCondition _hasPackets;
-    QMutex _waitingOnPacketsMutex;
+    std::atomic<int> _packetCount { 0 }; // queued and not processed yet
+    std::atomic<int> _undrainedPacketCount { 0 }; // queued and not taken off the queue yet
+
+    // the packets taken off the queue and not processed yet, by node
+    QHash<QUuid, int> _nodePacketCounts;
+    mutable QMutex _nodePacketCountsMutex;
 
     quint64 _lastWindowAt = 0;
-    int _lastWindowIncomingPackets = 0;
+    std::atomic<int> _lastWindowIncomingPackets { 0 };
     int _lastWindowProcessedPackets = 0;
     SimpleMovingAverage _incomingPPS;
     SimpleMovingAverage _processedPPS;
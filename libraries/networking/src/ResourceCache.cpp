@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 
@@ -20,6 +21,7 @@
 
 #include "NetworkAccessManager.h"
 #include "NetworkLogging.h"
+#include "ResourceDiskCache.h"
 
 #include "ResourceCache.h"
 
@@ -150,18 +152,50 @@ void ResourceCache::clearUnusedResource() {
     }
 }
 
+const int DEFAULT_HOST_REQUEST_LIMIT = 6;
+const int DEFAULT_TYPE_REQUEST_LIMIT = 4;
+int ResourceCache::_hostRequestLimit = DEFAULT_HOST_REQUEST_LIMIT;
+QHash<QString, int> ResourceCache::_typeRequestLimits;
+
+// The owners move with the camera, the priorities of the pending requests get evaluated again that often
+const qint64 PRIORITIZATION_INTERVAL_MSECS = 500;
+
+int ResourceCache::getTypeRequestLimit(const QString& type) {
+    return _typeRequestLimits.value(type, DEFAULT_TYPE_REQUEST_LIMIT);
+}
+
+bool ResourceCache::canStartRequest(const QString& host, const QString& type) {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    return sharedItems->_hostRequestCounts.value(host) < _hostRequestLimit &&
+        sharedItems->_typeRequestCounts.value(type) < getTypeRequestLimit(type);
+}
+
 void ResourceCache::attemptRequest(Resource* resource) {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
 
-    // Disable request limiting for ATP
-    if (resource->getURL().scheme() != URL_SCHEME_ATP) {
-        if (_requestLimit <= 0) {
+    // Disable request limiting for ATP, and for what the disk cache serves without asking the server
+    resource->_requestHost.clear();
+    resource->_requestType.clear();
+    if (resource->getURL().scheme() != URL_SCHEME_ATP &&
+            !ResourceDiskCache::isFresh(ResourceManager::normalizeURL(resource->getURL()))) {
+        QString host = resource->getURL().host();
+        QString type = resource->metaObject()->className();
+        if (!canStartRequest(host, type)) {
             // wait until a slot becomes available
-            sharedItems->_pendingRequests.append(resource);
+            auto& pendingRequests = sharedItems->_pendingRequests[ResourceCacheSharedItems::RequestKey(host, type)];
+            ResourceCacheSharedItems::PendingRequest pending = { resource, resource->getLoadPriority() };
+            pendingRequests.push_back(pending);
+            std::push_heap(pendingRequests.begin(), pendingRequests.end());
+            sharedItems->_pendingRequestCount++;
             return;
         }
 
-        --_requestLimit;
+        // the request counts against its host and type until it completes, when the resource may be getting destroyed
+        // and no longer tell its own class
+        resource->_requestHost = host;
+        resource->_requestType = type;
+        ++sharedItems->_hostRequestCounts[host];
+        ++sharedItems->_typeRequestCounts[type];
     }
 
     sharedItems->_loadingRequests.append(resource);
@@ -170,35 +204,69 @@ void ResourceCache::attemptRequest(Resource* resource) {
 
 void ResourceCache::requestCompleted(Resource* resource) {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
-    sharedItems->_loadingRequests.removeOne(resource);
-    if (resource->getURL().scheme() != URL_SCHEME_ATP) {
-        ++_requestLimit;
+    if (sharedItems->_loadingRequests.removeOne(resource) && !resource->_requestType.isEmpty()) {
+        --sharedItems->_hostRequestCounts[resource->_requestHost];
+        --sharedItems->_typeRequestCounts[resource->_requestType];
+        resource->_requestHost.clear();
+        resource->_requestType.clear();
     }
     
-    // look for the highest priority pending request
-    int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    for (int i = 0; i < sharedItems->_pendingRequests.size(); ) {
-        Resource* resource = sharedItems->_pendingRequests.at(i).data();
-        if (!resource) {
-            sharedItems->_pendingRequests.removeAt(i);
-            continue;
-        }
-        float priority = resource->getLoadPriority();
-        if (priority >= highestPriority) {
-            highestPriority = priority;
-            highestIndex = i;
+    startPendingRequests();
+}
+
+void ResourceCache::startPendingRequests() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    auto& pendingRequests = sharedItems->_pendingRequests;
+
+    // evaluate the priorities again once in a while, dropping the requests of the resources gone meanwhile
+    if (!sharedItems->_lastPrioritization.isValid() ||
+            sharedItems->_lastPrioritization.elapsed() > PRIORITIZATION_INTERVAL_MSECS) {
+        sharedItems->_pendingRequestCount = 0;
+        for (auto it = pendingRequests.begin(); it != pendingRequests.end(); ) {
+            auto& requests = it.value();
+            requests.erase(std::remove_if(requests.begin(), requests.end(),
+                [](const ResourceCacheSharedItems::PendingRequest& pending) { return pending.resource.isNull(); }),
+                requests.end());
+            if (requests.empty()) {
+                it = pendingRequests.erase(it);
+                continue;
+            }
+            for (auto& pending : requests) {
+                pending.priority = pending.resource->getLoadPriority();
+            }
+            std::make_heap(requests.begin(), requests.end());
+            sharedItems->_pendingRequestCount += (int)requests.size();
+            it++;
         }
-        i++;
+        sharedItems->_lastPrioritization.start();
     }
-    if (highestIndex >= 0) {
-        attemptRequest(sharedItems->_pendingRequests.takeAt(highestIndex));
+
+    // start the highest priority among the tops of the heaps whose host and type have a slot, until none does
+    while (true) {
+        auto highest = pendingRequests.end();
+        for (auto it = pendingRequests.begin(); it != pendingRequests.end(); it++) {
+            if (canStartRequest(it.key().first, it.key().second) &&
+                    (highest == pendingRequests.end() || it.value().front().priority > highest.value().front().priority)) {
+                highest = it;
+            }
+        }
+        if (highest == pendingRequests.end()) {
+            break;
+        }
+        auto& requests = highest.value();
+        std::pop_heap(requests.begin(), requests.end());
+        QPointer<Resource> resource = requests.back().resource;
+        requests.pop_back();
+        sharedItems->_pendingRequestCount--;
+        if (requests.empty()) {
+            pendingRequests.erase(highest);
+        }
+        if (resource) {
+            attemptRequest(resource.data());
+        }
     }
 }
 
-const int DEFAULT_REQUEST_LIMIT = 10;
-int ResourceCache::_requestLimit = DEFAULT_REQUEST_LIMIT;
-
 Resource::Resource(const QUrl& url, bool delayLoad) :
     _url(url),
     _activeUrl(url),
@@ -242,9 +310,16 @@ void Resource::setLoadPriorities(const QHash<QPointer<QObject>, float>& prioriti
     }
 }
 
+void Resource::setLoadPriorityOperator(const QPointer<QObject>& owner, std::function<float()> priorityOperator) {
+    if (!(_failedToLoad || _loaded)) {
+        _loadPriorityOperators.insert(owner, priorityOperator);
+    }
+}
+
 void Resource::clearLoadPriority(const QPointer<QObject>& owner) {
     if (!(_failedToLoad || _loaded)) {
         _loadPriorities.remove(owner);
+        _loadPriorityOperators.remove(owner);
     }
 }
 
@@ -258,6 +333,14 @@ float Resource::getLoadPriority() {
         highestPriority = qMax(highestPriority, it.value());
         it++;
     }
+    for (auto it = _loadPriorityOperators.begin(); it != _loadPriorityOperators.end(); ) {
+        if (it.key().isNull()) {
+            it = _loadPriorityOperators.erase(it);
+            continue;
+        }
+        highestPriority = qMax(highestPriority, it.value()());
+        it++;
+    }
     return highestPriority;
 }
 
@@ -326,6 +409,7 @@ void Resource::finishedLoading(bool success) {
         _failedToLoad = true;
     }
     _loadPriorities.clear();
+    _loadPriorityOperators.clear();
 }
 
 void Resource::reinsert() {
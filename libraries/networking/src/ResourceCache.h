@@ -12,9 +12,14 @@
 #ifndef hifi_ResourceCache_h
 #define hifi_ResourceCache_h
 
+#include <functional>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QObject>
+#include <QtCore/QPair>
 #include <QtCore/QPointer>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QUrl>
@@ -54,8 +59,26 @@ static const qint64 MAX_UNUSED_MAX_SIZE = 10 * BYTES_PER_GIGABYTES;
 class ResourceCacheSharedItems : public Dependency  {
     SINGLETON_DEPENDENCY
 public:
-    QList<QPointer<Resource>> _pendingRequests;
+    class PendingRequest {
+    public:
+        QPointer<Resource> resource;
+        float priority;
+
+        bool operator<(const PendingRequest& other) const { return priority < other.priority; }
+    };
+
+    // The host and the type of resource of the requests
+    typedef QPair<QString, QString> RequestKey;
+
+    // The heaps of the requests waiting for a slot for each host and type, on the priorities they had when last evaluated
+    QHash<RequestKey, std::vector<PendingRequest>> _pendingRequests;
+    int _pendingRequestCount = 0;
+    QElapsedTimer _lastPrioritization;
     QList<Resource*> _loadingRequests;
+
+    // The requests loading from each host and for each type of resource
+    QHash<QString, int> _hostRequestCounts;
+    QHash<QString, int> _typeRequestCounts;
 private:
     ResourceCacheSharedItems() { }
     virtual ~ResourceCacheSharedItems() { }
@@ -67,8 +90,13 @@ class ResourceCache : public QObject {
     Q_OBJECT
     
 public:
-    static void setRequestLimit(int limit) { _requestLimit = limit; }
-    static int getRequestLimit() { return _requestLimit; }
+    /// The requests loading at once from the same host.
+    static void setHostRequestLimit(int limit) { _hostRequestLimit = limit; }
+    static int getHostRequestLimit() { return _hostRequestLimit; }
+
+    /// The requests loading at once for a type of resource, the class name of the resource.
+    static void setTypeRequestLimit(const QString& type, int limit) { _typeRequestLimits.insert(type, limit); }
+    static int getTypeRequestLimit(const QString& type);
     
     void setUnusedResourceCacheSize(qint64 unusedResourcesMaxSize);
     qint64 getUnusedResourceCacheSize() const { return _unusedResourcesMaxSize; }
@@ -77,7 +105,7 @@ public:
         { return DependencyManager::get<ResourceCacheSharedItems>()->_loadingRequests; }
 
     static int getPendingRequestCount() 
-        { return DependencyManager::get<ResourceCacheSharedItems>()->_pendingRequests.size(); }
+        { return DependencyManager::get<ResourceCacheSharedItems>()->_pendingRequestCount; }
 
     ResourceCache(QObject* parent = NULL);
     virtual ~ResourceCache();
@@ -108,13 +136,19 @@ protected:
     Q_INVOKABLE static void attemptRequest(Resource* resource);
     static void requestCompleted(Resource* resource);
 
+    /// Start the pending requests with the highest priorities, as long as their host and type have a slot left.
+    static void startPendingRequests();
+
 private:
     friend class Resource;
 
     QHash<QUrl, QWeakPointer<Resource>> _resources;
     int _lastLRUKey = 0;
     
-    static int _requestLimit;
+    static int _hostRequestLimit;
+    static QHash<QString, int> _typeRequestLimits;
+
+    static bool canStartRequest(const QString& host, const QString& type);
 
     void getResourceAsynchronously(const QUrl& url);
     QReadWriteLock _resourcesToBeGottenLock;
@@ -146,6 +180,9 @@ public:
     /// Sets a set of priorities at once.
     virtual void setLoadPriorities(const QHash<QPointer<QObject>, float>& priorities);
     
+    /// Sets a priority evaluated again each time the pending requests get sorted, for owners that move around.
+    virtual void setLoadPriorityOperator(const QPointer<QObject>& owner, std::function<float()> priorityOperator);
+
     /// Clears the load priority for one owner.
     virtual void clearLoadPriority(const QPointer<QObject>& owner);
     
@@ -207,6 +244,7 @@ protected:
     bool _failedToLoad = false;
     bool _loaded = false;
     QHash<QPointer<QObject>, float> _loadPriorities;
+    QHash<QPointer<QObject>, std::function<float()>> _loadPriorityOperators;
     QWeakPointer<Resource> _self;
     QPointer<ResourceCache> _cache;
     QByteArray _data;
@@ -225,6 +263,10 @@ private:
     
     ResourceRequest* _request = nullptr;
     int _lruKey = 0;
+
+    // The host and type the request counts against while loading
+    QString _requestHost;
+    QString _requestType;
     QTimer* _replyTimer = nullptr;
     qint64 _bytesReceived = 0;
     qint64 _bytesTotal = 0;
@@ -0,0 +1,295 @@
+//
+//  ResourceDiskCache.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceDiskCache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QLocale>
+#include <QtCore/QRegExp>
+#include <QtCore/QSaveFile>
+#include <QtNetwork/QNetworkReply>
+
+#include "NetworkLogging.h"
+
+// The file of an entry starts with the times it gets updated in place, then the url and the validators before the data
+const quint32 CACHE_FILE_MAGIC = 0x48524443; // HRDC
+const quint32 CACHE_FILE_VERSION = 1;
+const qint64 TIMES_OFFSET = 2 * sizeof(quint32);
+const QString CACHE_FILE_SUFFIX = ".cache";
+
+const qint64 DEFAULT_MAXIMUM_SIZE = 2048LL * 1024 * 1024;
+
+QMutex ResourceDiskCache::_lock;
+QString ResourceDiskCache::_directory;
+qint64 ResourceDiskCache::_maximumSize = DEFAULT_MAXIMUM_SIZE;
+qint64 ResourceDiskCache::_size = 0;
+QHash<QString, ResourceDiskCache::Entry> ResourceDiskCache::_entries;
+
+static qint64 toMSecs(const QDateTime& time) {
+    return time.isValid() ? time.toMSecsSinceEpoch() : -1;
+}
+
+static QDateTime fromMSecs(qint64 msecs) {
+    return (msecs < 0) ? QDateTime() : QDateTime::fromMSecsSinceEpoch(msecs).toUTC();
+}
+
+void ResourceDiskCache::setCacheDirectory(const QString& directory) {
+    QMutexLocker locker(&_lock);
+    _directory = directory;
+    _entries.clear();
+    _size = 0;
+
+    QDir dir(directory);
+    if (!dir.mkpath(".")) {
+        qCWarning(networking) << "Could not create the resource disk cache at" << directory;
+        _directory.clear();
+        return;
+    }
+    foreach (const QFileInfo& info, dir.entryInfoList(QStringList() << "*" + CACHE_FILE_SUFFIX, QDir::Files)) {
+        Entry entry;
+        qint64 dataOffset;
+        if (readHeader(info.filePath(), entry, dataOffset)) {
+            _entries.insert(info.completeBaseName(), entry);
+            _size += entry.size;
+        } else {
+            QFile::remove(info.filePath());
+        }
+    }
+    reserve(0);
+    qCDebug(networking) << "Resource disk cache at" << directory << "with" << _entries.size() << "entries of"
+        << _size / (1024 * 1024) << "MB";
+}
+
+QString ResourceDiskCache::getCacheDirectory() {
+    QMutexLocker locker(&_lock);
+    return _directory;
+}
+
+bool ResourceDiskCache::isEnabled() {
+    QMutexLocker locker(&_lock);
+    return !_directory.isEmpty();
+}
+
+void ResourceDiskCache::setMaximumSize(qint64 maximumSize) {
+    QMutexLocker locker(&_lock);
+    _maximumSize = maximumSize;
+    reserve(0);
+}
+
+qint64 ResourceDiskCache::getMaximumSize() {
+    QMutexLocker locker(&_lock);
+    return _maximumSize;
+}
+
+qint64 ResourceDiskCache::getSize() {
+    QMutexLocker locker(&_lock);
+    return _size;
+}
+
+bool ResourceDiskCache::getValidators(const QUrl& url, Validators& validators) {
+    QMutexLocker locker(&_lock);
+    auto entry = _entries.constFind(getKey(url));
+    if (entry == _entries.constEnd()) {
+        return false;
+    }
+    validators = entry->validators;
+    return true;
+}
+
+bool ResourceDiskCache::isFresh(const QUrl& url) {
+    QMutexLocker locker(&_lock);
+    auto entry = _entries.constFind(getKey(url));
+    return entry != _entries.constEnd() && entry->validators.expiration > QDateTime::currentDateTimeUtc();
+}
+
+bool ResourceDiskCache::load(const QUrl& url, QByteArray& data) {
+    QMutexLocker locker(&_lock);
+    QString key = getKey(url);
+    auto entry = _entries.find(key);
+    if (entry == _entries.end()) {
+        return false;
+    }
+    Entry header;
+    qint64 dataOffset;
+    QFile file(getPath(key));
+    if (!readHeader(file.fileName(), header, dataOffset) || !file.open(QIODevice::ReadOnly) || !file.seek(dataOffset)) {
+        _size -= entry->size;
+        _entries.erase(entry);
+        file.remove();
+        return false;
+    }
+    data = file.readAll();
+    file.close();
+
+    entry->lastAccess = QDateTime::currentMSecsSinceEpoch();
+    writeHeaderTimes(key, *entry);
+    return true;
+}
+
+void ResourceDiskCache::store(const QUrl& url, const QByteArray& data, const Validators& validators) {
+    QMutexLocker locker(&_lock);
+    if (_directory.isEmpty()) {
+        return;
+    }
+    QString key = getKey(url);
+    auto previous = _entries.find(key);
+    if (previous != _entries.end()) {
+        _size -= previous->size;
+        _entries.erase(previous);
+    }
+
+    Entry entry;
+    entry.lastAccess = QDateTime::currentMSecsSinceEpoch();
+    entry.validators = validators;
+
+    QSaveFile file(getPath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << CACHE_FILE_MAGIC << CACHE_FILE_VERSION << entry.lastAccess << toMSecs(validators.expiration);
+    stream << url.toEncoded() << validators.eTag << validators.lastModified;
+    stream.writeRawData(data.constData(), data.size());
+    entry.size = file.pos();
+    if (stream.status() != QDataStream::Ok || entry.size > _maximumSize) {
+        file.cancelWriting();
+        return;
+    }
+    reserve(entry.size);
+    if (!file.commit()) {
+        qCWarning(networking) << "Could not write the resource disk cache entry for" << url;
+        return;
+    }
+    _entries.insert(key, entry);
+    _size += entry.size;
+}
+
+void ResourceDiskCache::revalidate(const QUrl& url, const QDateTime& expiration) {
+    QMutexLocker locker(&_lock);
+    QString key = getKey(url);
+    auto entry = _entries.find(key);
+    if (entry != _entries.end()) {
+        entry->validators.expiration = expiration;
+        writeHeaderTimes(key, *entry);
+    }
+}
+
+void ResourceDiskCache::remove(const QUrl& url) {
+    QMutexLocker locker(&_lock);
+    QString key = getKey(url);
+    auto entry = _entries.find(key);
+    if (entry != _entries.end()) {
+        _size -= entry->size;
+        _entries.erase(entry);
+        QFile::remove(getPath(key));
+    }
+}
+
+void ResourceDiskCache::clear() {
+    QMutexLocker locker(&_lock);
+    for (auto it = _entries.constBegin(); it != _entries.constEnd(); it++) {
+        QFile::remove(getPath(it.key()));
+    }
+    _entries.clear();
+    _size = 0;
+}
+
+bool ResourceDiskCache::evalValidators(const QNetworkReply& reply, Validators& validators) {
+    QByteArray cacheControl = reply.rawHeader("Cache-Control").toLower();
+    if (cacheControl.contains("no-store")) {
+        return false;
+    }
+    validators.eTag = reply.rawHeader("ETag");
+    validators.lastModified = reply.rawHeader("Last-Modified");
+
+    // without a lifetime the entry gets revalidated each time
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    validators.expiration = now;
+    if (!cacheControl.contains("no-cache")) {
+        QRegExp maxAge("max-age=(\\d+)");
+        if (maxAge.indexIn(QString::fromLatin1(cacheControl)) >= 0) {
+            validators.expiration = now.addSecs(maxAge.cap(1).toLongLong());
+        } else if (reply.hasRawHeader("Expires")) {
+            QDateTime expires = QLocale::c().toDateTime(QString::fromLatin1(reply.rawHeader("Expires")),
+                                                        "ddd, dd MMM yyyy hh:mm:ss 'GMT'");
+            if (expires.isValid()) {
+                expires.setTimeSpec(Qt::UTC);
+                validators.expiration = expires;
+            }
+        }
+    }
+    return !validators.eTag.isEmpty() || !validators.lastModified.isEmpty() || validators.expiration > now;
+}
+
+QString ResourceDiskCache::getKey(const QUrl& url) {
+    return QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex();
+}
+
+QString ResourceDiskCache::getPath(const QString& key) {
+    return _directory + "/" + key + CACHE_FILE_SUFFIX;
+}
+
+bool ResourceDiskCache::readHeader(const QString& path, Entry& entry, qint64& dataOffset) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version;
+    qint64 expiration;
+    QByteArray url;
+    stream >> magic >> version >> entry.lastAccess >> expiration;
+    stream >> url >> entry.validators.eTag >> entry.validators.lastModified;
+    if (stream.status() != QDataStream::Ok || magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION) {
+        return false;
+    }
+    entry.validators.expiration = fromMSecs(expiration);
+    entry.size = file.size();
+    dataOffset = file.pos();
+    return true;
+}
+
+void ResourceDiskCache::writeHeaderTimes(const QString& key, const Entry& entry) {
+    QFile file(getPath(key));
+    if (file.open(QIODevice::ReadWrite) && file.seek(TIMES_OFFSET)) {
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_5_0);
+        stream << entry.lastAccess << toMSecs(entry.validators.expiration);
+    }
+}
+
+void ResourceDiskCache::reserve(qint64 size) {
+    if (_size + size <= _maximumSize) {
+        return;
+    }
+    // drop the entries used the longest ago first
+    std::vector<std::pair<qint64, QString>> entries;
+    entries.reserve(_entries.size());
+    for (auto it = _entries.constBegin(); it != _entries.constEnd(); it++) {
+        entries.push_back(std::make_pair(it->lastAccess, it.key()));
+    }
+    std::sort(entries.begin(), entries.end());
+    for (auto& entry : entries) {
+        if (_size + size <= _maximumSize) {
+            break;
+        }
+        _size -= _entries.value(entry.second).size;
+        _entries.remove(entry.second);
+        QFile::remove(getPath(entry.second));
+    }
+}
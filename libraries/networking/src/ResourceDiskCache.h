@@ -0,0 +1,87 @@
+//
+//  ResourceDiskCache.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceDiskCache_h
+#define hifi_ResourceDiskCache_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+class QNetworkReply;
+
+/// The downloaded resources kept on disk across the sessions, for the requests of every thread. Each entry keeps the
+/// validators of its response to be revalidated once stale, and the least recently used go past the size limit.
+class ResourceDiskCache {
+public:
+    class Validators {
+    public:
+        QByteArray eTag;
+        QByteArray lastModified;
+        QDateTime expiration; // fresh until then, no need to ask the server
+    };
+
+    /// Sets the directory of the cache, and loads the entries already there. The cache is disabled until then.
+    static void setCacheDirectory(const QString& directory);
+    static QString getCacheDirectory();
+    static bool isEnabled();
+
+    static void setMaximumSize(qint64 maximumSize);
+    static qint64 getMaximumSize();
+    static qint64 getSize();
+
+    /// Returns true if there's an entry for the url, with its validators.
+    static bool getValidators(const QUrl& url, Validators& validators);
+
+    /// Returns true if there's an entry for the url that doesn't need to be revalidated.
+    static bool isFresh(const QUrl& url);
+
+    /// Reads the data of the entry, marking it as just used.
+    static bool load(const QUrl& url, QByteArray& data);
+
+    /// Stores the response, evicting the least recently used entries beyond the size limit.
+    static void store(const QUrl& url, const QByteArray& data, const Validators& validators);
+
+    /// The server told the entry is still valid, until the new expiration.
+    static void revalidate(const QUrl& url, const QDateTime& expiration);
+
+    static void remove(const QUrl& url);
+
+    /// Removes every entry of the cache.
+    static void clear();
+
+    /// Returns the validators of a response, false if it can't be stored.
+    static bool evalValidators(const QNetworkReply& reply, Validators& validators);
+
+private:
+    class Entry {
+    public:
+        qint64 size; // of the whole file
+        qint64 lastAccess; // msecs since epoch
+        Validators validators;
+    };
+
+    static QString getKey(const QUrl& url);
+    static QString getPath(const QString& key);
+    static bool readHeader(const QString& path, Entry& entry, qint64& dataOffset);
+    static void writeHeaderTimes(const QString& key, const Entry& entry);
+    static void reserve(qint64 size);
+
+    static QMutex _lock;
+    static QString _directory;
+    static qint64 _maximumSize;
+    static qint64 _size;
+    static QHash<QString, Entry> _entries;
+};
+
+#endif // hifi_ResourceDiskCache_h
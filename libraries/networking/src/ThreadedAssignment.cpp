@@ -15,8 +15,10 @@
 #include <QtCore/QTimer>
 
 #include <LogHandler.h>
+#include <SharedUtil.h>
 
 #include "ThreadedAssignment.h"
+#include "udt/PacketBufferPool.h"
 
 ThreadedAssignment::ThreadedAssignment(NLPacket& packet) :
     Assignment(packet),
@@ -95,6 +97,19 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject &statsObje
     statsObject["packets_per_second"] = packetsPerSecond;
     statsObject["bytes_per_second"] = bytesPerSecond;
 
+    auto bufferPoolStats = udt::PacketBufferPool::getStats();
+    QJsonObject bufferPoolObject;
+    bufferPoolObject["hits"] = (double) bufferPoolStats.hits;
+    bufferPoolObject["misses"] = (double) bufferPoolStats.misses;
+    bufferPoolObject["num_buffers"] = bufferPoolStats.numBuffers;
+    bufferPoolObject["high_water_mark"] = bufferPoolStats.highWaterMark;
+    statsObject["packet_buffer_pool"] = bufferPoolObject;
+
+    quint64 residentMemoryBytes = getResidentMemoryBytes();
+    if (residentMemoryBytes > 0) {
+        statsObject["resident_memory_bytes"] = (double) residentMemoryBytes;
+    }
+
     nodeList->sendStatsToDomainServer(statsObject);
 }
 
@@ -11,6 +11,8 @@
 
 #include "BasePacket.h"
 
+#include <SharedUtil.h>
+
 using namespace udt;
 
 const qint64 BasePacket::PACKET_WRITE_ERROR = -1;
@@ -33,7 +35,7 @@ std::unique_ptr<BasePacket> BasePacket::create(qint64 size) {
     return packet;
 }
 
-std::unique_ptr<BasePacket> BasePacket::fromReceivedPacket(std::unique_ptr<char[]> data,
+std::unique_ptr<BasePacket> BasePacket::fromReceivedPacket(PacketBuffer data,
                                                            qint64 size, const HifiSockAddr& senderSockAddr) {
     // Fail with invalid size
     Q_ASSERT(size >= 0);
@@ -58,19 +60,20 @@ BasePacket::BasePacket(qint64 size) {
     Q_ASSERT(size >= 0 || size < maxPayload);
     
     _packetSize = size;
-    _packet.reset(new char[_packetSize]);
+    _packet = PacketBufferPool::allocate(_packetSize);
     _payloadCapacity = _packetSize;
     _payloadSize = 0;
     _payloadStart = _packet.get();
 }
 
-BasePacket::BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+BasePacket::BasePacket(PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     _packetSize(size),
     _packet(std::move(data)),
     _payloadStart(_packet.get()),
     _payloadCapacity(size),
     _payloadSize(size),
-    _senderSockAddr(senderSockAddr)
+    _senderSockAddr(senderSockAddr),
+    _receiveTime(usecTimestampNow())
 {
     
 }
@@ -83,7 +86,7 @@ BasePacket::BasePacket(const BasePacket& other) :
 
 BasePacket& BasePacket::operator=(const BasePacket& other) {
     _packetSize = other._packetSize;
-    _packet = std::unique_ptr<char[]>(new char[_packetSize]);
+    _packet = PacketBufferPool::allocate(_packetSize);
     memcpy(_packet.get(), other._packet.get(), _packetSize);
     
     _payloadStart = _packet.get() + (other._payloadStart - other._packet.get());
@@ -93,6 +96,9 @@ BasePacket& BasePacket::operator=(const BasePacket& other) {
     
     _senderSockAddr = other._senderSockAddr;
     
+    _receiveTime = other._receiveTime;
+    _queueTime = other._queueTime;
+    
     if (other.isOpen() && !isOpen()) {
         open(other.openMode());
     }
@@ -117,6 +123,9 @@ BasePacket& BasePacket::operator=(BasePacket&& other) {
     
     _senderSockAddr = std::move(other._senderSockAddr);
     
+    _receiveTime = other._receiveTime;
+    _queueTime = other._queueTime;
+    
     if (other.isOpen() && !isOpen()) {
         open(other.openMode());
     }
@@ -20,6 +20,7 @@
 
 #include "../HifiSockAddr.h"
 #include "Constants.h"
+#include "PacketBufferPool.h"
 
 namespace udt {
     
@@ -29,7 +30,7 @@ public:
     static const qint64 PACKET_WRITE_ERROR;
     
     static std::unique_ptr<BasePacket> create(qint64 size = -1);
-    static std::unique_ptr<BasePacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+    static std::unique_ptr<BasePacket> fromReceivedPacket(PacketBuffer data, qint64 size,
                                                           const HifiSockAddr& senderSockAddr);
     
     // Current level's header size
@@ -65,6 +66,11 @@ public:
     qint64 bytesLeftToRead() const { return _payloadSize - pos(); }
     qint64 bytesAvailableForWrite() const { return _payloadCapacity - pos(); }
     
+    // usecTimestampNow when the packet was read from the socket, or queued in a SendQueue, for latency stats
+    quint64 getReceiveTime() const { return _receiveTime; }
+    quint64 getQueueTime() const { return _queueTime; }
+    void setQueueTime(quint64 queueTime) { _queueTime = queueTime; }
+    
     HifiSockAddr& getSenderSockAddr() { return _senderSockAddr; }
     const HifiSockAddr& getSenderSockAddr() const { return _senderSockAddr; }
     
@@ -84,7 +90,7 @@ public:
     
 protected:
     BasePacket(qint64 size);
-    BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr);
+    BasePacket(PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr);
     BasePacket(const BasePacket& other);
     BasePacket& operator=(const BasePacket& other);
     BasePacket(BasePacket&& other);
@@ -97,7 +103,7 @@ protected:
     void adjustPayloadStartAndCapacity(qint64 headerSize, bool shouldDecreasePayloadSize = false);
     
     qint64 _packetSize = 0;        // Total size of the allocated memory
-    std::unique_ptr<char[]> _packet; // Allocated memory
+    PacketBuffer _packet; // Allocated memory, drawn from the PacketBufferPool
     
     char* _payloadStart = nullptr; // Start of the payload
     qint64 _payloadCapacity = 0;          // Total capacity of the payload
@@ -105,6 +111,9 @@ protected:
     qint64 _payloadSize = 0;          // How much of the payload is actually used
     
     HifiSockAddr _senderSockAddr;  // sender address for packet (only used on receiving end)
+    
+    quint64 _receiveTime { 0 };
+    quint64 _queueTime { 0 };
 };
 
 template<typename T> qint64 BasePacket::peekPrimitive(T* data) {
@@ -11,6 +11,8 @@
 
 #include "CongestionControl.h"
 
+#include <algorithm>
+#include <iterator>
 #include <random>
 
 #include "Packet.h"
@@ -207,3 +209,165 @@ void DefaultCC::stopSlowStart() {
         _packetSendPeriod = _congestionWindowSize / (_rtt + synInterval());
     }
 }
+
+// 2 / ln(2), the smallest gain that lets the send rate double each round in startup
+static const double BBR_HIGH_GAIN = 2.885;
+static const double BBR_WINDOW_GAIN = 2.0;
+static const double BBR_PACING_GAIN_CYCLE[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int BBR_PACING_GAIN_CYCLE_LENGTH = sizeof(BBR_PACING_GAIN_CYCLE) / sizeof(BBR_PACING_GAIN_CYCLE[0]);
+
+// startup is over once the bandwidth failed to grow by 25% for 3 rounds
+static const double BBR_FULL_BANDWIDTH_GROWTH = 1.25;
+static const int BBR_FULL_BANDWIDTH_ROUNDS = 3;
+
+static const auto BBR_MIN_RTT_EXPIRY = seconds(10);
+static const auto BBR_PROBE_RTT_DURATION = milliseconds(200);
+
+static const double BBR_MIN_CONGESTION_WINDOW_SIZE = 16.0;
+static const double BBR_PROBE_RTT_CONGESTION_WINDOW_SIZE = 4.0;
+
+BBRCC::BBRCC() :
+    _lastAck(_sendCurrSeqNum),
+    _roundEndSequenceNumber(_sendCurrSeqNum),
+    _roundMaxBandwidth(),
+    _pacingGain(BBR_HIGH_GAIN),
+    _windowGain(BBR_HIGH_GAIN)
+{
+    _mss = udt::MAX_PACKET_SIZE_WITH_UDP_HEADER;
+    
+    _congestionWindowSize = BBR_MIN_CONGESTION_WINDOW_SIZE;
+    _packetSendPeriod = 1.0;
+}
+
+void BBRCC::onACK(SequenceNumber ackNum) {
+    auto now = p_high_resolution_clock::now();
+    
+    updateBandwidth(ackNum);
+    updateMinRTT(now);
+    updateMode(ackNum, now);
+    updateSendPeriodAndWindow(ackNum);
+    
+    _lastAck = ackNum;
+}
+
+void BBRCC::updateBandwidth(SequenceNumber ackNum) {
+    _isRoundStart = false;
+    
+    if (ackNum >= _roundEndSequenceNumber) {
+        // everything sent since the last round started is now ACKed, start a new round
+        _roundEndSequenceNumber = _sendCurrSeqNum;
+        ++_roundCount;
+        _isRoundStart = true;
+        
+        _roundMaxBandwidth[_roundCount % BANDWIDTH_WINDOW_ROUNDS] = 0;
+    }
+    
+    // the receive rate is the delivery rate measured by the receiver's PacketTimeWindow
+    int& roundMax = _roundMaxBandwidth[_roundCount % BANDWIDTH_WINDOW_ROUNDS];
+    roundMax = std::max(roundMax, _receiveRate);
+    
+    _bottleneckBandwidth = *std::max_element(std::begin(_roundMaxBandwidth), std::end(_roundMaxBandwidth));
+}
+
+void BBRCC::updateMinRTT(p_high_resolution_clock::time_point now) {
+    if (_rtt <= 0) {
+        return;
+    }
+    
+    // the RTT we are given is already smoothed by the connection, so its min tracks the propagation delay closely enough
+    if (_minRTT == 0 || _rtt <= _minRTT) {
+        _minRTT = _rtt;
+        _minRTTTimestamp = now;
+    } else if (now - _minRTTTimestamp > BBR_MIN_RTT_EXPIRY && _mode != Mode::ProbeRTT && _mode != Mode::Startup) {
+        // we haven't seen the min RTT in a while, the queue may just never have drained - probe for it
+        _modeBeforeProbeRTT = _mode;
+        _mode = Mode::ProbeRTT;
+        _probeRTTDoneTimestamp = now + BBR_PROBE_RTT_DURATION;
+        _hasProbeRTTRoundPassed = false;
+    }
+}
+
+void BBRCC::updateMode(SequenceNumber ackNum, p_high_resolution_clock::time_point now) {
+    switch (_mode) {
+        case Mode::Startup:
+            if (_isRoundStart && _bottleneckBandwidth > 0) {
+                if (_bottleneckBandwidth >= _fullBandwidth * BBR_FULL_BANDWIDTH_GROWTH) {
+                    _fullBandwidth = _bottleneckBandwidth;
+                    _numRoundsWithoutGrowth = 0;
+                } else if (++_numRoundsWithoutGrowth >= BBR_FULL_BANDWIDTH_ROUNDS) {
+                    _mode = Mode::Drain;
+                }
+            }
+            break;
+        case Mode::Drain:
+            if (seqoff(ackNum, _sendCurrSeqNum) <= getBandwidthDelayProduct()) {
+                _mode = Mode::ProbeBandwidth;
+                _cycleIndex = 0;
+                _cycleTimestamp = now;
+            }
+            break;
+        case Mode::ProbeBandwidth:
+            // move through the gain cycle once per min RTT
+            if (now - _cycleTimestamp > microseconds(_minRTT)) {
+                _cycleIndex = (_cycleIndex + 1) % BBR_PACING_GAIN_CYCLE_LENGTH;
+                _cycleTimestamp = now;
+            }
+            break;
+        case Mode::ProbeRTT:
+            _hasProbeRTTRoundPassed = _hasProbeRTTRoundPassed || _isRoundStart;
+            
+            if (now >= _probeRTTDoneTimestamp && _hasProbeRTTRoundPassed) {
+                // whatever RTT we have now is our new min
+                _minRTT = _rtt;
+                _minRTTTimestamp = now;
+                
+                _mode = _modeBeforeProbeRTT == Mode::Drain ? Mode::Drain : Mode::ProbeBandwidth;
+                _cycleTimestamp = now;
+            }
+            break;
+    }
+    
+    switch (_mode) {
+        case Mode::Startup:
+            _pacingGain = BBR_HIGH_GAIN;
+            _windowGain = BBR_HIGH_GAIN;
+            break;
+        case Mode::Drain:
+            _pacingGain = 1.0 / BBR_HIGH_GAIN;
+            _windowGain = BBR_HIGH_GAIN;
+            break;
+        case Mode::ProbeBandwidth:
+            _pacingGain = BBR_PACING_GAIN_CYCLE[_cycleIndex];
+            _windowGain = BBR_WINDOW_GAIN;
+            break;
+        case Mode::ProbeRTT:
+            _pacingGain = 1.0;
+            _windowGain = 1.0;
+            break;
+    }
+}
+
+void BBRCC::updateSendPeriodAndWindow(SequenceNumber ackNum) {
+    if (_bottleneckBandwidth <= 0 || _minRTT <= 0) {
+        // until the receiver reports a delivery rate, grow the window with every packet ACKed like a slow start would
+        _congestionWindowSize += seqlen(_lastAck, ackNum);
+    } else {
+        setPacketSendPeriod(USECS_PER_SECOND / (_pacingGain * _bottleneckBandwidth));
+        
+        if (_mode == Mode::ProbeRTT) {
+            _congestionWindowSize = BBR_PROBE_RTT_CONGESTION_WINDOW_SIZE;
+            return;
+        }
+        
+        _congestionWindowSize = std::max(_windowGain * getBandwidthDelayProduct(), BBR_MIN_CONGESTION_WINDOW_SIZE);
+    }
+    
+    if (_maxCongestionWindowSize > 0) {
+        _congestionWindowSize = std::min(_congestionWindowSize, _maxCongestionWindowSize);
+    }
+}
+
+double BBRCC::getBandwidthDelayProduct() const {
+    // ACKs only go out every sync interval, so that is part of the round trip as far as the window is concerned
+    return _bottleneckBandwidth * (_minRTT + synInterval()) / USECS_PER_SECOND;
+}
@@ -14,7 +14,6 @@
 
 #include <memory>
 #include <vector>
-#include <memory>
 
 #include <PortableHighResolutionClock.h>
 
@@ -120,6 +119,64 @@ private:
     int _avgNAKNum { 0 }; // average number of NAKs per congestion
     int _decreaseCount { 0 }; // number of decreases in a congestion epoch
 };
+
+// Delay based congestion control modeled on BBR. Instead of backing off on loss, it paces at the bottleneck bandwidth
+// (the max delivery rate reported by the receiver over the last rounds) and keeps about two bandwidth-delay products
+// in flight (using the min RTT over the last seconds), so random loss on links like wifi doesn't collapse the send rate.
+class BBRCC: public CongestionControl {
+public:
+    enum class Mode {
+        Startup, // doubling the send rate each round until the bandwidth stops growing
+        Drain, // draining the queue built up during startup
+        ProbeBandwidth, // cycling around the estimated bandwidth to discover more of it
+        ProbeRTT // shrinking the window for a moment so that the min RTT can be refreshed
+    };
+    
+    BBRCC();
+    
+    virtual void onACK(SequenceNumber ackNum);
+    virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) {} // loss is not a congestion signal here
+    
+    Mode getMode() const { return _mode; }
+    int getBottleneckBandwidth() const { return _bottleneckBandwidth; }
+    int getMinRTT() const { return _minRTT; }
+    
+private:
+    static const int BANDWIDTH_WINDOW_ROUNDS = 10;
+    
+    void updateBandwidth(SequenceNumber ackNum);
+    void updateMinRTT(p_high_resolution_clock::time_point now);
+    void updateMode(SequenceNumber ackNum, p_high_resolution_clock::time_point now);
+    void updateSendPeriodAndWindow(SequenceNumber ackNum);
+    
+    double getBandwidthDelayProduct() const; // in packets
+    
+    Mode _mode { Mode::Startup };
+    
+    SequenceNumber _lastAck; // last ACKed seq num, to grow the window before we have a bandwidth sample
+    SequenceNumber _roundEndSequenceNumber; // a round ends once the packets sent at its start are ACKed
+    int _roundCount { 0 };
+    bool _isRoundStart { false };
+    
+    int _roundMaxBandwidth[BANDWIDTH_WINDOW_ROUNDS]; // max delivery rate seen in each of the last rounds, packets per second
+    int _bottleneckBandwidth { 0 }; // max of the above, packets per second
+    
+    int _fullBandwidth { 0 }; // bandwidth at the last round it grew significantly during startup
+    int _numRoundsWithoutGrowth { 0 };
+    
+    int _minRTT { 0 }; // microseconds
+    p_high_resolution_clock::time_point _minRTTTimestamp = p_high_resolution_clock::now();
+    
+    int _cycleIndex { 0 }; // index in the ProbeBandwidth pacing gain cycle
+    p_high_resolution_clock::time_point _cycleTimestamp = p_high_resolution_clock::now();
+    
+    p_high_resolution_clock::time_point _probeRTTDoneTimestamp;
+    bool _hasProbeRTTRoundPassed { false };
+    Mode _modeBeforeProbeRTT { Mode::Startup };
+    
+    double _pacingGain;
+    double _windowGain;
+};
     
 }
 
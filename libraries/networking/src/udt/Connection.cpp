@@ -11,9 +11,11 @@
 
 #include "Connection.h"
 
-#include <QtCore/QThread>
+#include <algorithm>
+#include <cstring>
 
 #include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 #include "../HifiSockAddr.h"
 #include "../NetworkLogging.h"
@@ -27,6 +29,12 @@
 using namespace udt;
 using namespace std::chrono;
 
+// the datagram sizes the path to the peer is probed for, largest first: jumbo frames, then the smaller high MTU links
+static const int MTU_PROBE_SIZES[] = { MAX_JUMBO_PACKET_SIZE, 4470 - UDP_IPV4_HEADER_SIZE };
+static const int NUM_MTU_PROBE_SIZES = sizeof(MTU_PROBE_SIZES) / sizeof(MTU_PROBE_SIZES[0]);
+static const int MAX_MTU_PROBE_ATTEMPTS = 3; // probes can be lost like any packet
+static const int MIN_MTU_PROBE_INTERVAL_USECS = 100 * USECS_PER_MSEC;
+
 Connection::Connection(Socket* parentSocket, HifiSockAddr destination, std::unique_ptr<CongestionControl> congestionControl) :
     _parentSocket(parentSocket),
     _destination(destination),
@@ -53,20 +61,12 @@ Connection::~Connection() {
 
 void Connection::stopSendQueue() {
     if (auto sendQueue = _sendQueue.release()) {
-        // grab the send queue thread so we can wait on it
-        QThread* sendQueueThread = sendQueue->thread();
-        
-        // tell the send queue to stop and be deleted
-        
+        // tell the send queue to stop and delete it, the deletion waits for the scheduler to be done with it
         sendQueue->stop();
-        sendQueue->deleteLater();
+        delete sendQueue;
         
         // since we're stopping the send queue we should consider our handshake ACK not receieved
         _hasReceivedHandshakeACK = false;
-        
-        // wait on the send queue thread so we know the send queue is gone
-        sendQueueThread->quit();
-        sendQueueThread->wait();
     }
 }
 
@@ -116,6 +116,11 @@ void Connection::queueInactive() {
     }
 }
 
+void Connection::startHandshake() {
+    // the send queue handshakes as soon as it is made, and holds the packets queued on it until that is done
+    getSendQueue();
+}
+
 void Connection::sendReliablePacket(std::unique_ptr<Packet> packet) {
     Q_ASSERT_X(packet->isReliable(), "Connection::send", "Trying to send an unreliable packet reliably.");
     getSendQueue().queuePacket(std::move(packet));
@@ -130,11 +135,39 @@ void Connection::queueReceivedMessagePacket(std::unique_ptr<Packet> packet) {
     Q_ASSERT(packet->isPartOfMessage());
 
     auto messageNumber = packet->getMessageNumber();
+    bool isNewMessage = _pendingReceivedMessages.find(messageNumber) == _pendingReceivedMessages.end();
     PendingReceivedMessage& pendingMessage = _pendingReceivedMessages[messageNumber];
+    
+    if (isNewMessage && _parentSocket) {
+        // every packet of a message has the same type, so whichever arrives first decides how it is delivered
+        pendingMessage._isStreamed = _parentSocket->shouldStreamMessage(*packet);
+    }
 
     pendingMessage.enqueuePacket(std::move(packet));
 
-    if (pendingMessage.isComplete()) {
+    if (pendingMessage._isStreamed) {
+        auto packets = pendingMessage.takeNextPackets();
+        
+        if (pendingMessage.hasDeliveredAllPackets()) {
+            _pendingReceivedMessages.erase(messageNumber);
+        }
+        
+        for (auto& messagePacket : packets) {
+            recordReceiveLatency(messagePacket->getReceiveTime());
+        }
+        
+        // the handler is allowed to clean up this connection, so don't touch it once we start delivering
+        auto parentSocket = _parentSocket;
+        
+        for (auto& messagePacket : packets) {
+            parentSocket->messagePacketReceived(std::move(messagePacket));
+        }
+    } else if (pendingMessage.isComplete()) {
+        // every packet has waited for the whole message
+        for (auto& messagePacket : pendingMessage._packets) {
+            recordReceiveLatency(messagePacket->getReceiveTime());
+        }
+        
         // All messages have been received, create PacketList
         auto packetList = PacketList::fromReceivedPackets(std::move(pendingMessage._packets));
         
@@ -181,18 +214,27 @@ void Connection::sync() {
         _lightACKsDuringSYN = 1;
         _acksDuringSYN = 1;
         
-        // we send out a periodic ACK every rate control interval
-        sendACK();
+        // check if we need to re-transmit a loss list
+        // we do this if it has been longer than the current nakInterval since we last sent
+        bool isTimeoutNAKDue = _lossList.getLength() > 0
+            && duration_cast<microseconds>(now - _lastNAKTime).count() >= _nakInterval;
         
-        if (_lossList.getLength() > 0) {
-            // check if we need to re-transmit a loss list
-            // we do this if it has been longer than the current nakInterval since we last sent
-            auto now = p_high_resolution_clock::now();
-            
-            if (duration_cast<microseconds>(now - _lastNAKTime).count() >= _nakInterval) {
-                // Send a timeout NAK packet
-                sendTimeoutNAK();
-            }
+        // we send out a periodic ACK every rate control interval, unless only a few packets came in since the last one
+        // in which case it is held back for a couple intervals so that slow connections don't ACK every packet
+        bool shouldDelayACK = !isTimeoutNAKDue
+            && _packetsSinceACK > 0 && _packetsSinceACK < MIN_PACKETS_PER_PERIODIC_ACK
+            && duration_cast<microseconds>(now - _lastACKTime).count() < _synInterval * MAX_ACK_DELAY_SYN_INTERVALS;
+        
+        bool didSendLossList = false;
+        
+        if (!shouldDelayACK) {
+            // a due loss list goes out in the same packet as the ACK
+            didSendLossList = sendACK(true, isTimeoutNAKDue) && isTimeoutNAKDue;
+        }
+        
+        if (isTimeoutNAKDue && !didSendLossList) {
+            // Send a timeout NAK packet
+            sendTimeoutNAK();
         }
     } else if (!_sendQueue) {
         // we haven't received a packet and we're not sending
@@ -215,18 +257,62 @@ void Connection::sync() {
             return;
         }
     }
+    
+    if (_sendQueue && _hasReceivedHandshakeACK) {
+        probeMTU();
+    }
 }
 
-void Connection::recordSentPackets(int dataSize, int payloadSize) {
+void Connection::probeMTU() {
+    if (_mtuProbeIndex >= NUM_MTU_PROBE_SIZES || !_parentSocket->canProbeMTU()) {
+        return;
+    }
+    
+    auto now = p_high_resolution_clock::now();
+    
+    if (_mtuProbeAttempts > 0) {
+        // give the last probe the time to be answered
+        int probeInterval = std::max(estimatedTimeout(), MIN_MTU_PROBE_INTERVAL_USECS);
+        if (duration_cast<microseconds>(now - _lastMTUProbeTime).count() < probeInterval) {
+            return;
+        }
+        
+        if (_mtuProbeAttempts == MAX_MTU_PROBE_ATTEMPTS) {
+            // the path does not carry this size, try the next one
+            _mtuProbeAttempts = 0;
+            if (++_mtuProbeIndex >= NUM_MTU_PROBE_SIZES) {
+                return;
+            }
+        }
+    }
+    
+    // the probe is padded to the size it probes for, and not fragmented on the way
+    int probeSize = MTU_PROBE_SIZES[_mtuProbeIndex];
+    auto probePacket = ControlPacket::create(ControlPacket::MTUProbe, probeSize - ControlPacket::localHeaderSize());
+    memset(probePacket->getPayload(), 0, probePacket->getPayloadCapacity());
+    probePacket->setPayloadSize(probePacket->getPayloadCapacity());
+    
+    _parentSocket->writeUnfragmentedDatagram(probePacket->getData(), probePacket->getDataSize(), _destination);
+    
+    ++_mtuProbeAttempts;
+    _lastMTUProbeTime = now;
+}
+
+void Connection::recordSentPackets(int dataSize, int payloadSize, quint64 queueLatency) {
     _stats.recordSentPackets(payloadSize, dataSize);
+    _stats.recordSendQueueLatency(queueLatency);
+}
+
+void Connection::recordReceiveLatency(quint64 receiveTime) {
+    auto now = usecTimestampNow();
+    _stats.recordReceiveLatency((now > receiveTime) ? now - receiveTime : 0);
 }
 
 void Connection::recordRetransmission() {
     _stats.record(ConnectionStats::Stats::Retransmission);
 }
 
-void Connection::sendACK(bool wasCausedBySyncTimeout) {
-    static p_high_resolution_clock::time_point lastACKSendTime;
+bool Connection::sendACK(bool wasCausedBySyncTimeout, bool shouldIncludeLossList) {
     auto currentTime = p_high_resolution_clock::now();
     
     SequenceNumber nextACKNumber = nextACK();
@@ -236,14 +322,14 @@ void Connection::sendACK(bool wasCausedBySyncTimeout) {
         // We already sent this ACK, but check if we should re-send it.
         if (nextACKNumber < _lastReceivedAcknowledgedACK) {
             // we already got an ACK2 for this ACK we would be sending, don't bother
-            return;
+            return false;
         }
         
         // We will re-send if it has been more than the estimated timeout since the last ACK
-        microseconds sinceLastACK = duration_cast<microseconds>(currentTime - lastACKSendTime);
+        microseconds sinceLastACK = duration_cast<microseconds>(currentTime - _lastACKTime);
         
         if (sinceLastACK.count() < estimatedTimeout()) {
-            return;
+            return false;
         }
     }
     // we have received new packets since the last sent ACK
@@ -254,8 +340,28 @@ void Connection::sendACK(bool wasCausedBySyncTimeout) {
     // setup the ACK packet, make it static so we can re-use it
     static const int ACK_PACKET_PAYLOAD_BYTES = sizeof(_lastSentACK) + sizeof(_currentACKSubSequenceNumber)
                                                 + sizeof(_rtt) + sizeof(int32_t) + sizeof(int32_t) + sizeof(int32_t);
-    static auto ackPacket = ControlPacket::create(ControlPacket::ACK, ACK_PACKET_PAYLOAD_BYTES);
-    ackPacket->reset(); // We need to reset it every time.
+    static auto sharedACKPacket = ControlPacket::create(ControlPacket::ACK, ACK_PACKET_PAYLOAD_BYTES);
+    sharedACKPacket->reset(); // We need to reset it every time.
+    
+    std::unique_ptr<ControlPacket> compoundPacket;
+    
+    if (shouldIncludeLossList && _lossList.getLength() > 0) {
+        // the loss list is put first, with its size, so that the rest of the packet reads like an ACK
+        int maxLossListSize = std::min(_lossList.getMaxWriteSize(),
+                                       ControlPacket::maxPayloadSize() - (int)sizeof(uint16_t) - ACK_PACKET_PAYLOAD_BYTES);
+        
+        compoundPacket = ControlPacket::create(ControlPacket::CompoundACK,
+                                               sizeof(uint16_t) + maxLossListSize + ACK_PACKET_PAYLOAD_BYTES);
+        
+        compoundPacket->seek(sizeof(uint16_t));
+        uint16_t lossListSize = (uint16_t)_lossList.write(*compoundPacket, maxLossListSize);
+        
+        compoundPacket->seek(0);
+        compoundPacket->writePrimitive(lossListSize);
+        compoundPacket->seek(sizeof(uint16_t) + lossListSize);
+    }
+    
+    ControlPacket* ackPacket = compoundPacket ? compoundPacket.get() : sharedACKPacket.get();
     
     // pack in the ACK sub-sequence number
     ackPacket->writePrimitive(++_currentACKSubSequenceNumber);
@@ -285,11 +391,18 @@ void Connection::sendACK(bool wasCausedBySyncTimeout) {
     }
     
     // record this as the last ACK send time
-    lastACKSendTime = p_high_resolution_clock::now();
+    _lastACKTime = p_high_resolution_clock::now();
     
     // have the socket send off our packet
     _parentSocket->writeBasePacket(*ackPacket, _destination);
     
+    if (compoundPacket) {
+        // record this as the last NAK time
+        _lastNAKTime = _lastACKTime;
+        
+        _stats.record(ConnectionStats::Stats::SentTimeoutNAK);
+    }
+    
     Q_ASSERT_X(_sentACKs.empty() || _sentACKs.back().first + 1 == _currentACKSubSequenceNumber,
                "Connection::sendACK", "Adding an invalid ACK to _sentACKs");
     
@@ -300,6 +413,8 @@ void Connection::sendACK(bool wasCausedBySyncTimeout) {
     _packetsSinceACK = 0;
     
     _stats.record(ConnectionStats::Stats::SentACK);
+    
+    return true;
 }
 
 void Connection::sendLightACK() {
@@ -370,14 +485,13 @@ void Connection::sendNAK(SequenceNumber sequenceNumberRecieved) {
 void Connection::sendTimeoutNAK() {
     if (_lossList.getLength() > 0) {
         
-        int timeoutPayloadSize = std::min((int) (_lossList.getLength() * 2 * sizeof(SequenceNumber)),
-                                          ControlPacket::maxPayloadSize());
+        int timeoutPayloadSize = std::min(_lossList.getMaxWriteSize(), ControlPacket::maxPayloadSize());
         
-        // construct a NAK packet that will hold all of the lost sequence numbers
+        // construct a NAK packet that will hold as many of the lost sequence numbers as fit
         auto lossListPacket = ControlPacket::create(ControlPacket::TimeoutNAK, timeoutPayloadSize);
         
         // Pack in the lost sequence numbers
-        _lossList.write(*lossListPacket, timeoutPayloadSize / (2 * sizeof(SequenceNumber)));
+        _lossList.write(*lossListPacket, timeoutPayloadSize);
         
         // have our parent socket send off this control packet
         _parentSocket->writeBasePacket(*lossListPacket, _destination);
@@ -526,6 +640,24 @@ void Connection::processControl(std::unique_ptr<ControlPacket> controlPacket) {
                 processProbeTail(move(controlPacket));
             }
             break;
+        case ControlPacket::CompoundACK:
+            if (_hasReceivedHandshakeACK) {
+                processCompoundACK(move(controlPacket));
+            }
+            break;
+        case ControlPacket::MTUProbe:
+            if (_hasReceivedHandshake) {
+                processMTUProbe(move(controlPacket));
+            }
+            break;
+        case ControlPacket::MTUProbeACK:
+            if (_hasReceivedHandshakeACK) {
+                processMTUProbeACK(move(controlPacket));
+            }
+            break;
+        case ControlPacket::FECParity:
+            // parity packets are consumed by the Socket, they are not part of a connection
+            break;
     }
 }
 
@@ -675,6 +807,7 @@ void Connection::processACK2(std::unique_ptr<ControlPacket> controlPacket) {
             updateRTT(rtt);
             // write this RTT to stats
             _stats.recordRTT(rtt);
+            _stats.recordRTTLatency(rtt);
             
             // set the RTT for congestion control
             _congestionControl->setRTT(_rtt);
@@ -743,9 +876,39 @@ void Connection::processHandshakeACK(std::unique_ptr<ControlPacket> controlPacke
     }
 }
 
+void Connection::processMTUProbe(std::unique_ptr<ControlPacket> controlPacket) {
+    // tell the sender the size of the probe that made it through
+    static const int MTU_PROBE_ACK_PAYLOAD_BYTES = sizeof(int32_t);
+    auto probeACKPacket = ControlPacket::create(ControlPacket::MTUProbeACK, MTU_PROBE_ACK_PAYLOAD_BYTES);
+    probeACKPacket->writePrimitive((int32_t) controlPacket->getDataSize());
+    
+    _parentSocket->writeBasePacket(*probeACKPacket, _destination);
+}
+
+void Connection::processMTUProbeACK(std::unique_ptr<ControlPacket> controlPacket) {
+    int32_t probeSize = 0;
+    if (controlPacket->bytesLeftToRead() < (qint64) sizeof(probeSize)) {
+        return;
+    }
+    controlPacket->readPrimitive(&probeSize);
+    
+    if (probeSize > _maxPacketSize && probeSize <= MAX_JUMBO_PACKET_SIZE) {
+        // the sizes are probed largest first, there won't be a larger one
+        _maxPacketSize = probeSize;
+        _mtuProbeIndex = NUM_MTU_PROBE_SIZES;
+        
+        _congestionControl->setMSS(_maxPacketSize + UDP_IPV4_HEADER_SIZE);
+        _parentSocket->setMaxPacketSize(_destination, _maxPacketSize);
+        
+#ifdef UDT_CONNECTION_DEBUG
+        qCDebug(networking) << "The path to" << _destination << "carries packets of" << _maxPacketSize << "bytes";
+#endif
+    }
+}
+
 void Connection::processTimeoutNAK(std::unique_ptr<ControlPacket> controlPacket) {
     // Override SendQueue's LossList with the timeout NAK list
-    getSendQueue().overrideNAKListFromPacket(*controlPacket);
+    getSendQueue().overrideNAKListFromPacket(*controlPacket, controlPacket->bytesLeftToRead());
     
     // we don't tell the congestion control object there was loss here - this matches UDTs implementation
     // a possible improvement would be to tell it which new loss this timeout packet told us about
@@ -753,6 +916,20 @@ void Connection::processTimeoutNAK(std::unique_ptr<ControlPacket> controlPacket)
     _stats.record(ConnectionStats::Stats::ReceivedTimeoutNAK);
 }
 
+void Connection::processCompoundACK(std::unique_ptr<ControlPacket> controlPacket) {
+    // a compound ACK is a timeout NAK loss list followed by a full ACK
+    uint16_t lossListSize;
+    controlPacket->readPrimitive(&lossListSize);
+    
+    if (lossListSize > 0) {
+        getSendQueue().overrideNAKListFromPacket(*controlPacket, lossListSize);
+        
+        _stats.record(ConnectionStats::Stats::ReceivedTimeoutNAK);
+    }
+    
+    processACK(move(controlPacket));
+}
+
 void Connection::processProbeTail(std::unique_ptr<ControlPacket> controlPacket) {
     if (((uint32_t) _lastReceivedSequenceNumber & 0xF) == 0) {
         // this is the second packet in a probe set so we can estimate bandwidth
@@ -870,10 +1047,24 @@ void PendingReceivedMessage::enqueuePacket(std::unique_ptr<Packet> packet) {
     auto it = std::find_if(_packets.rbegin(), _packets.rend(),
         [&](const std::unique_ptr<Packet>& value) { return messagePartNumber >= value->getMessagePartNumber(); });
 
-    if (it != _packets.rend() && ((*it)->getMessagePartNumber() == messagePartNumber)) {
+    if ((it != _packets.rend() && ((*it)->getMessagePartNumber() == messagePartNumber))
+        || messagePartNumber < _nextPartNumber) {
         qCDebug(networking) << "PendingReceivedMessage::enqueuePacket: This is a duplicate packet";
         return;
     }
     
     _packets.insert(it.base(), std::move(packet));
 }
+
+std::list<std::unique_ptr<Packet>> PendingReceivedMessage::takeNextPackets() {
+    std::list<std::unique_ptr<Packet>> nextPackets;
+    
+    // the list is sorted, so the packets that are ready are at its front
+    while (!_packets.empty() && _packets.front()->getMessagePartNumber() == _nextPartNumber) {
+        nextPackets.push_back(std::move(_packets.front()));
+        _packets.pop_front();
+        ++_nextPartNumber;
+    }
+    
+    return nextPackets;
+}
@@ -39,11 +39,17 @@ public:
     void enqueuePacket(std::unique_ptr<Packet> packet);
     bool isComplete() const { return _hasLastPacket && _numPackets == _packets.size(); }
     
+    // for streamed messages, takes the packets that continue what was already delivered, in order
+    std::list<std::unique_ptr<Packet>> takeNextPackets();
+    bool hasDeliveredAllPackets() const { return _hasLastPacket && _nextPartNumber == _numPackets; }
+    
     std::list<std::unique_ptr<Packet>> _packets;
+    bool _isStreamed { false };
 
 private:
     bool _hasLastPacket { false };
     unsigned int _numPackets { 0 };
+    unsigned int _nextPartNumber { 0 }; // part number of the next packet of a streamed message to deliver
 };
 
 class Connection : public QObject {
@@ -56,6 +62,7 @@ public:
     Connection(Socket* parentSocket, HifiSockAddr destination, std::unique_ptr<CongestionControl> congestionControl);
     ~Connection();
 
+    void startHandshake();
     void sendReliablePacket(std::unique_ptr<Packet> packet);
     void sendReliablePacketList(std::unique_ptr<PacketList> packet);
 
@@ -67,6 +74,9 @@ public:
 
     void queueReceivedMessagePacket(std::unique_ptr<Packet> packet);
     
+    // records how long a reliable packet took from the socket to the packet handler
+    void recordReceiveLatency(quint64 receiveTime);
+    
     ConnectionStats::Stats sampleStats() { return _stats.sample(); }
     
     bool isActive() const { return _isActive; }
@@ -76,12 +86,12 @@ signals:
     void connectionInactive(const HifiSockAddr& sockAddr);
     
 private slots:
-    void recordSentPackets(int payload, int total);
+    void recordSentPackets(int payload, int total, quint64 queueLatency);
     void recordRetransmission();
     void queueInactive();
     
 private:
-    void sendACK(bool wasCausedBySyncTimeout = true);
+    bool sendACK(bool wasCausedBySyncTimeout = true, bool shouldIncludeLossList = false); // true if an ACK was sent
     void sendLightACK();
     void sendACK2(SequenceNumber currentACKSubSequenceNumber);
     void sendNAK(SequenceNumber sequenceNumberRecieved);
@@ -92,9 +102,14 @@ private:
     void processACK2(std::unique_ptr<ControlPacket> controlPacket);
     void processNAK(std::unique_ptr<ControlPacket> controlPacket);
     void processTimeoutNAK(std::unique_ptr<ControlPacket> controlPacket);
+    void processCompoundACK(std::unique_ptr<ControlPacket> controlPacket);
     void processHandshake(std::unique_ptr<ControlPacket> controlPacket);
     void processHandshakeACK(std::unique_ptr<ControlPacket> controlPacket);
     void processProbeTail(std::unique_ptr<ControlPacket> controlPacket);
+    void processMTUProbe(std::unique_ptr<ControlPacket> controlPacket);
+    void processMTUProbeACK(std::unique_ptr<ControlPacket> controlPacket);
+    
+    void probeMTU(); // sends the next path MTU probe, if one is due
     
     void resetReceiveState();
     void resetRTT();
@@ -116,6 +131,7 @@ private:
     int _nakInterval { -1 }; // NAK timeout interval, in microseconds, set on loss
     int _minNAKInterval { 100000 }; // NAK timeout interval lower bound, default of 100ms
     p_high_resolution_clock::time_point _lastNAKTime = p_high_resolution_clock::now();
+    p_high_resolution_clock::time_point _lastACKTime; // time the last full ACK was sent
     
     bool _hasReceivedHandshake { false }; // flag for receipt of handshake from server
     bool _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
@@ -145,6 +161,11 @@ private:
     int _bandwidth { 1 }; // Exponential moving average for estimated bandwidth, in packets per second
     int _deliveryRate { 16 }; // Exponential moving average for receiver's receive rate, in packets per second
     
+    int _maxPacketSize { udt::MAX_PACKET_SIZE }; // Largest datagram the path to the peer was found to carry
+    int _mtuProbeIndex { 0 }; // Size being probed, past the end of the probed sizes once probing is over
+    int _mtuProbeAttempts { 0 }; // Probes sent for the size being probed
+    p_high_resolution_clock::time_point _lastMTUProbeTime; // time the last path MTU probe was sent
+    
     SentACKList _sentACKs; // Map of ACK sub-sequence numbers to ACKed sequence number and sent time
     
     Socket* _parentSocket { nullptr };
@@ -112,3 +112,18 @@ void ConnectionStats::recordPacketSendPeriod(int sample) {
     _currentSample.packetSendPeriod = sample;
     _total.packetSendPeriod = (int)((_total.packetSendPeriod * EWMA_PREVIOUS_SAMPLES_WEIGHT) + (sample * EWMA_CURRENT_SAMPLE_WEIGHT));
 }
+
+void ConnectionStats::recordSendQueueLatency(quint64 usecs) {
+    _currentSample.sendQueueLatency.record(usecs);
+    _total.sendQueueLatency.record(usecs);
+}
+
+void ConnectionStats::recordRTTLatency(quint64 usecs) {
+    _currentSample.rttLatency.record(usecs);
+    _total.rttLatency.record(usecs);
+}
+
+void ConnectionStats::recordReceiveLatency(quint64 usecs) {
+    _currentSample.receiveLatency.record(usecs);
+    _total.receiveLatency.record(usecs);
+}
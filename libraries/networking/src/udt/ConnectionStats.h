@@ -15,6 +15,8 @@
 #include <chrono>
 #include <array>
 
+#include "LatencyHistogram.h"
+
 namespace udt {
 
 class ConnectionStats {
@@ -70,6 +72,11 @@ public:
         int congestionWindowSize { 0 };
         int packetSendPeriod { 0 };
         
+        // latency distributions, in microseconds
+        LatencyHistogram sendQueueLatency; // reliable packet queued in the SendQueue to its first send
+        LatencyHistogram rttLatency; // ACK to ACK2 round trips measured on this end
+        LatencyHistogram receiveLatency; // reliable packet read from the socket to its handoff to the packet handler
+        
         // TODO: Remove once Win build supports brace initialization: `Events events {{ 0 }};`
         Stats() { events.fill(0); }
     };
@@ -94,6 +101,10 @@ public:
     void recordCongestionWindowSize(int sample);
     void recordPacketSendPeriod(int sample);
     
+    void recordSendQueueLatency(quint64 usecs);
+    void recordRTTLatency(quint64 usecs);
+    void recordReceiveLatency(quint64 usecs);
+    
 private:
     Stats _currentSample;
     Stats _total;
@@ -20,12 +20,17 @@ namespace udt {
     static const int UDP_IPV4_HEADER_SIZE = 28;
     static const int MAX_PACKET_SIZE_WITH_UDP_HEADER = 1500;
     static const int MAX_PACKET_SIZE = MAX_PACKET_SIZE_WITH_UDP_HEADER - UDP_IPV4_HEADER_SIZE;
+    // the largest datagrams received, and sent on the connections whose path was probed to carry them
+    static const int MAX_JUMBO_PACKET_SIZE_WITH_UDP_HEADER = 9000;
+    static const int MAX_JUMBO_PACKET_SIZE = MAX_JUMBO_PACKET_SIZE_WITH_UDP_HEADER - UDP_IPV4_HEADER_SIZE;
     static const int MAX_PACKETS_IN_FLIGHT = 25600;
     static const int CONNECTION_RECEIVE_BUFFER_SIZE_PACKETS = 8192;
     static const int CONNECTION_SEND_BUFFER_SIZE_PACKETS = 8192;
     static const int UDP_SEND_BUFFER_SIZE_BYTES = 1048576;
     static const int UDP_RECEIVE_BUFFER_SIZE_BYTES = 1048576;
     static const int DEFAULT_SYN_INTERVAL_USECS = 10 * 1000;
+    static const int MIN_PACKETS_PER_PERIODIC_ACK = 4; // fewer packets than this since the last ACK may delay the next
+    static const int MAX_ACK_DELAY_SYN_INTERVALS = 4; // how long a receiver may hold back its periodic ACK
     static const int SEQUENCE_NUMBER_BITS = sizeof(SequenceNumber) * 8;
     static const int MESSAGE_LINE_NUMBER_BITS = 32;
     static const int MESSAGE_NUMBER_BITS = 30;
@@ -25,7 +25,7 @@ int ControlPacket::maxPayloadSize() {
     return BasePacket::maxPayloadSize() - ControlPacket::localHeaderSize();
 }
 
-std::unique_ptr<ControlPacket> ControlPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+std::unique_ptr<ControlPacket> ControlPacket::fromReceivedPacket(PacketBuffer data, qint64 size,
                                                                  const HifiSockAddr &senderSockAddr) {
     // Fail with null data
     Q_ASSERT(data);
@@ -56,7 +56,7 @@ ControlPacket::ControlPacket(Type type, qint64 size) :
     writeType();
 }
 
-ControlPacket::ControlPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+ControlPacket::ControlPacket(PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     BasePacket(std::move(data), size, senderSockAddr)
 {
     // sanity check before we decrease the payloadSize with the payloadCapacity
@@ -100,7 +100,7 @@ void ControlPacket::readType() {
     Q_ASSERT_X(bitAndType & CONTROL_BIT_MASK, "ControlPacket::readHeader()", "This should be a control packet");
     
     uint16_t packetType = (bitAndType & ~CONTROL_BIT_MASK) >> (8 * sizeof(Type));
-    Q_ASSERT_X(packetType <= ControlPacket::Type::ProbeTail, "ControlPacket::readType()", "Received a control packet with wrong type");
+    Q_ASSERT_X(packetType <= ControlPacket::Type::MTUProbeACK, "ControlPacket::readType()", "Received a control packet with wrong type");
     
     // read the type
     _type = (Type) packetType;
@@ -0,0 +1,249 @@
+//
+//  ForwardErrorCorrection.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ForwardErrorCorrection.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include <SharedUtil.h>
+
+#include "ControlPacket.h"
+#include "Packet.h"
+
+using namespace udt;
+
+static const int MAX_SEQUENCE_OFFSET = 255;
+
+static int parityHeaderSize(int numCovered) {
+    return sizeof(SequenceNumber::Type) + sizeof(uint8_t) + (numCovered - 1) * sizeof(uint8_t) + sizeof(uint16_t);
+}
+
+static int clampInt(int value, int low, int high) {
+    return (value < low) ? low : ((value > high) ? high : value);
+}
+
+static void xorBytes(char* destination, const char* source, qint64 size) {
+    for (qint64 i = 0; i < size; ++i) {
+        destination[i] ^= source[i];
+    }
+}
+
+FECEncoder::FECEncoder(int groupSize, int numParityPackets) :
+    _groupSize(clampInt(groupSize, 1, MAX_GROUP_SIZE)),
+    _numParityPackets(clampInt(numParityPackets, 1, MAX_PARITY_PACKETS))
+{
+    if (_numParityPackets > _groupSize) {
+        _numParityPackets = _groupSize;
+    }
+
+    _parities.resize(_numParityPackets);
+}
+
+bool FECEncoder::canProtect(const Packet& packet) const {
+    if (packet.isReliable() || packet.isPartOfMessage()) {
+        return false;
+    }
+
+    int maxCovered = (_groupSize + _numParityPackets - 1) / _numParityPackets;
+    qint64 protectedSize = packet.getDataSize() - Packet::localHeaderSize();
+
+    return protectedSize + parityHeaderSize(maxCovered) <= ControlPacket::maxPayloadSize();
+}
+
+FECEncoder::ParityPackets FECEncoder::addPacket(const Packet& packet) {
+    ParityPackets parityPackets;
+
+    SequenceNumber sequenceNumber = packet.getSequenceNumber();
+
+    if (_numPacketsInGroup > 0) {
+        // other unreliable packets to this destination take sequence numbers too, close the group before the
+        // offsets stop fitting in a byte
+        int offset = seqlen(_parities[0].firstSequenceNumber, sequenceNumber) - 1;
+        if (offset <= 0 || offset > MAX_SEQUENCE_OFFSET) {
+            parityPackets = flush();
+        }
+    }
+
+    if (_numPacketsInGroup == 0) {
+        _groupStartTime = usecTimestampNow();
+    }
+
+    Parity& parity = _parities[_numPacketsInGroup % _numParityPackets];
+
+    if (parity.numCovered == 0) {
+        parity.firstSequenceNumber = sequenceNumber;
+    } else {
+        parity.sequenceOffsets.push_back((uint8_t)(seqlen(parity.firstSequenceNumber, sequenceNumber) - 1));
+    }
+
+    const char* protectedBytes = packet.getData() + Packet::localHeaderSize();
+    qint64 protectedSize = packet.getDataSize() - Packet::localHeaderSize();
+
+    if ((qint64)parity.bytes.size() < protectedSize) {
+        parity.bytes.resize(protectedSize, 0);
+    }
+
+    xorBytes(parity.bytes.data(), protectedBytes, protectedSize);
+    parity.sizeXOR ^= (uint16_t)protectedSize;
+    ++parity.numCovered;
+
+    if (++_numPacketsInGroup == _groupSize) {
+        auto completedParityPackets = flush();
+
+        for (auto& parityPacket : completedParityPackets) {
+            parityPackets.push_back(std::move(parityPacket));
+        }
+    }
+
+    return parityPackets;
+}
+
+FECEncoder::ParityPackets FECEncoder::flush() {
+    ParityPackets parityPackets;
+
+    for (auto& parity : _parities) {
+        if (parity.numCovered == 0) {
+            continue;
+        }
+
+        auto parityPacket = ControlPacket::create(ControlPacket::FECParity,
+                                                  parityHeaderSize(parity.numCovered) + parity.bytes.size());
+
+        parityPacket->writePrimitive((SequenceNumber::Type)parity.firstSequenceNumber);
+        parityPacket->writePrimitive((uint8_t)parity.numCovered);
+        parityPacket->write(reinterpret_cast<const char*>(parity.sequenceOffsets.data()), parity.sequenceOffsets.size());
+        parityPacket->writePrimitive(parity.sizeXOR);
+        parityPacket->write(parity.bytes.data(), parity.bytes.size());
+
+        parityPackets.push_back(std::move(parityPacket));
+
+        // keep the allocations around for the next group
+        parity.sequenceOffsets.clear();
+        parity.bytes.clear();
+        parity.sizeXOR = 0;
+        parity.numCovered = 0;
+    }
+
+    _numPacketsInGroup = 0;
+
+    return parityPackets;
+}
+
+FECDecoder::FECDecoder() :
+    _history(HISTORY_SIZE)
+{
+}
+
+FECDecoder::HistoryEntry* FECDecoder::findEntry(SequenceNumber sequenceNumber, quint64 now) {
+    HistoryEntry& entry = _history[(SequenceNumber::UType)sequenceNumber % HISTORY_SIZE];
+
+    if (entry.isValid && entry.sequenceNumber == sequenceNumber && now - entry.receiveTime < HISTORY_TIMEOUT_USECS) {
+        return &entry;
+    }
+
+    return nullptr;
+}
+
+void FECDecoder::storeEntry(SequenceNumber sequenceNumber, const char* payload, qint64 payloadSize, quint64 now) {
+    HistoryEntry& entry = _history[(SequenceNumber::UType)sequenceNumber % HISTORY_SIZE];
+
+    entry.sequenceNumber = sequenceNumber;
+    entry.receiveTime = now;
+    entry.isValid = true;
+    entry.bytes.assign(payload, payload + payloadSize);
+}
+
+bool FECDecoder::addReceivedPacket(SequenceNumber sequenceNumber, const char* payload, qint64 payloadSize) {
+    quint64 now = usecTimestampNow();
+
+    if (findEntry(sequenceNumber, now)) {
+        return false;
+    }
+
+    storeEntry(sequenceNumber, payload, payloadSize, now);
+    return true;
+}
+
+bool FECDecoder::recover(const ControlPacket& parityPacket, PacketBuffer& buffer, qint64& size) {
+    const char* payload = parityPacket.getPayload();
+    qint64 payloadSize = parityPacket.getPayloadSize();
+
+    if (payloadSize < parityHeaderSize(1)) {
+        return false;
+    }
+
+    SequenceNumber::Type firstSequenceNumberValue;
+    memcpy(&firstSequenceNumberValue, payload, sizeof(firstSequenceNumberValue));
+    SequenceNumber firstSequenceNumber { firstSequenceNumberValue };
+
+    int numCovered = (uint8_t)payload[sizeof(SequenceNumber::Type)];
+    if (numCovered == 0 || numCovered > FECEncoder::MAX_GROUP_SIZE || payloadSize < parityHeaderSize(numCovered)) {
+        return false;
+    }
+
+    const uint8_t* sequenceOffsets = reinterpret_cast<const uint8_t*>(payload + sizeof(SequenceNumber::Type) + sizeof(uint8_t));
+
+    uint16_t sizeXOR;
+    memcpy(&sizeXOR, payload + parityHeaderSize(numCovered) - sizeof(uint16_t), sizeof(sizeXOR));
+
+    const char* parityBytes = payload + parityHeaderSize(numCovered);
+    qint64 numParityBytes = payloadSize - parityHeaderSize(numCovered);
+
+    quint64 now = usecTimestampNow();
+
+    HistoryEntry* entries[FECEncoder::MAX_GROUP_SIZE];
+    SequenceNumber missingSequenceNumber;
+    int numMissing = 0;
+
+    for (int i = 0; i < numCovered; ++i) {
+        SequenceNumber sequenceNumber = (i == 0) ? firstSequenceNumber : firstSequenceNumber + sequenceOffsets[i - 1];
+
+        entries[i] = findEntry(sequenceNumber, now);
+
+        if (!entries[i]) {
+            // a parity packet can only rebuild one of the packets it covers
+            if (++numMissing > 1) {
+                return false;
+            }
+
+            missingSequenceNumber = sequenceNumber;
+        } else {
+            sizeXOR ^= (uint16_t)entries[i]->bytes.size();
+        }
+    }
+
+    if (numMissing == 0 || sizeXOR > numParityBytes) {
+        return false;
+    }
+
+    qint64 missingSize = sizeXOR;
+
+    size = Packet::localHeaderSize() + missingSize;
+    buffer = PacketBufferPool::allocate(size);
+
+    // the lost packet was unreliable and not part of a message, so its header is only the sequence number
+    Packet::SequenceNumberAndBitField header = (SequenceNumber::Type)missingSequenceNumber;
+    memcpy(buffer.get(), &header, sizeof(header));
+
+    char* missingBytes = buffer.get() + Packet::localHeaderSize();
+    memcpy(missingBytes, parityBytes, missingSize);
+
+    for (int i = 0; i < numCovered; ++i) {
+        if (entries[i]) {
+            xorBytes(missingBytes, entries[i]->bytes.data(), std::min((qint64)entries[i]->bytes.size(), missingSize));
+        }
+    }
+
+    storeEntry(missingSequenceNumber, missingBytes, missingSize, now);
+
+    return true;
+}
@@ -0,0 +1,114 @@
+//
+//  ForwardErrorCorrection.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_ForwardErrorCorrection_h
+#define hifi_ForwardErrorCorrection_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QtGlobal>
+
+#include "PacketBufferPool.h"
+#include "SequenceNumber.h"
+
+namespace udt {
+
+class ControlPacket;
+class Packet;
+
+// Unreliable packets are protected in groups of up to MAX_GROUP_SIZE. Every group is followed by a number of
+// FECParity control packets, parity packet j is the XOR of the group packets at positions j, j + P, j + 2P...
+// so that a burst of up to P consecutive losses inside a group can be rebuilt on the receiving side.
+//
+// A parity payload is laid out as:
+//     first covered sequence number               (SequenceNumber::Type)
+//     number of covered packets                   (uint8_t)
+//     sequence offset of every other covered packet from the first (uint8_t each)
+//     XOR of the sizes of the covered packets     (uint16_t)
+//     XOR of the covered packets, without their udt header
+// Protected packets are unreliable and not part of a message, so their udt header is only the sequence number.
+
+class FECEncoder {
+public:
+    static const int MAX_GROUP_SIZE = 16;
+    static const int MAX_PARITY_PACKETS = 4;
+
+    using ParityPackets = std::vector<std::unique_ptr<ControlPacket>>;
+
+    FECEncoder(int groupSize, int numParityPackets);
+
+    // true if the packet can be covered by a parity packet, which must fit in an MTU
+    bool canProtect(const Packet& packet) const;
+
+    // adds a packet the caller has already given its sequence number to the current group
+    // returns the parity packets for every group this completes
+    ParityPackets addPacket(const Packet& packet);
+
+    // closes the current group early, returning its parity packets
+    ParityPackets flush();
+
+    bool hasPendingGroup() const { return _numPacketsInGroup > 0; }
+    quint64 getGroupStartTime() const { return _groupStartTime; }
+
+private:
+    struct Parity {
+        SequenceNumber firstSequenceNumber;
+        std::vector<uint8_t> sequenceOffsets;
+        uint16_t sizeXOR { 0 };
+        std::vector<char> bytes;
+        int numCovered { 0 };
+    };
+
+    int _groupSize;
+    int _numParityPackets;
+    std::vector<Parity> _parities;
+    int _numPacketsInGroup { 0 };
+    quint64 _groupStartTime { 0 };
+};
+
+class FECDecoder {
+public:
+    // how many of the latest protected packets from a sender are kept to rebuild a lost one
+    static const int HISTORY_SIZE = 256;
+
+    // packets older than this are not used for recovery or duplicate detection, which covers a sender that restarts
+    // its sequence numbers from the same address
+    static const quint64 HISTORY_TIMEOUT_USECS = 1000 * 1000;
+
+    FECDecoder();
+
+    // keeps a copy of a protected packet, without its udt header
+    // returns false if a packet with this sequence number was already received or rebuilt
+    bool addReceivedPacket(SequenceNumber sequenceNumber, const char* payload, qint64 payloadSize);
+
+    // rebuilds the datagram covered by the parity packet if it is the only one missing
+    // on success the rebuilt datagram (with its udt header) is put in buffer and size, and recorded as received
+    bool recover(const ControlPacket& parityPacket, PacketBuffer& buffer, qint64& size);
+
+private:
+    struct HistoryEntry {
+        SequenceNumber sequenceNumber;
+        quint64 receiveTime { 0 };
+        bool isValid { false };
+        std::vector<char> bytes;
+    };
+
+    HistoryEntry* findEntry(SequenceNumber sequenceNumber, quint64 now);
+    void storeEntry(SequenceNumber sequenceNumber, const char* payload, qint64 payloadSize, quint64 now);
+
+    std::vector<HistoryEntry> _history;
+};
+
+} // namespace udt
+
+#endif // hifi_ForwardErrorCorrection_h
@@ -0,0 +1,95 @@
+//
+//  LatencyHistogram.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LatencyHistogram.h"
+
+#include <cmath>
+
+using namespace udt;
+
+int LatencyHistogram::bucketIndex(quint64 value) {
+    if (value < 2 * SUB_BUCKET_COUNT) {
+        // the first two powers of two are kept exactly
+        return (int)value;
+    }
+    
+    int highestBit = 0;
+    for (quint64 remaining = value; remaining > 1; remaining >>= 1) {
+        ++highestBit;
+    }
+    
+    // keep the SUB_BUCKET_BITS bits below the highest one
+    int shift = highestBit - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKET_COUNT + (int)((value >> shift) - SUB_BUCKET_COUNT);
+}
+
+quint64 LatencyHistogram::bucketHighestValue(int index) {
+    if (index < 2 * SUB_BUCKET_COUNT) {
+        return index;
+    }
+    
+    int shift = index / SUB_BUCKET_COUNT - 1;
+    quint64 subBucket = (index % SUB_BUCKET_COUNT) + SUB_BUCKET_COUNT;
+    
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(quint64 value) {
+    if (value > MAX_VALUE) {
+        value = MAX_VALUE;
+    }
+    
+    ++_buckets[bucketIndex(value)];
+    ++_count;
+    
+    if (value > _max) {
+        _max = value;
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    
+    _count += other._count;
+    
+    if (other._max > _max) {
+        _max = other._max;
+    }
+}
+
+quint64 LatencyHistogram::getPercentile(double percentile) const {
+    if (_count == 0) {
+        return 0;
+    }
+    
+    percentile = (percentile < 0.0) ? 0.0 : ((percentile > 100.0) ? 100.0 : percentile);
+    
+    // the rank of the value we are looking for, starting at 1
+    quint64 rank = (quint64)std::ceil(percentile / 100.0 * _count);
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    quint64 seen = 0;
+    
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        seen += _buckets[i];
+        
+        if (seen >= rank) {
+            // the top of the bucket can't be reported above the largest value we actually saw
+            quint64 highestValue = bucketHighestValue(i);
+            return (highestValue < _max) ? highestValue : _max;
+        }
+    }
+    
+    return _max;
+}
@@ -0,0 +1,59 @@
+//
+//  LatencyHistogram.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LatencyHistogram_h
+#define hifi_LatencyHistogram_h
+
+#include <array>
+
+#include <QtCore/QtGlobal>
+
+namespace udt {
+
+// Fixed size histogram of latencies in microseconds, with a log linear bucket layout like HdrHistogram:
+// every power of two is split in SUB_BUCKET_COUNT buckets, so a value is kept with about 12% precision
+// from 16 usecs up to MAX_VALUE, and exactly below that. Recording a value never allocates.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 3;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int MAX_VALUE_BITS = 26; // a little over a minute
+    static const quint64 MAX_VALUE = (quint64(1) << MAX_VALUE_BITS) - 1;
+    static const int NUM_BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+    
+    // TODO: Remove once Win build supports brace initialization: `Buckets _buckets {{ 0 }};`
+    LatencyHistogram() { _buckets.fill(0); }
+    
+    void record(quint64 value); // values above MAX_VALUE are recorded as MAX_VALUE
+    void merge(const LatencyHistogram& other);
+    
+    int getCount() const { return _count; }
+    quint64 getMax() const { return _max; }
+    
+    // the value at or below which the given percentage (0 to 100) of the recorded values are, rounded up to the
+    // top of its bucket, 0 if nothing was recorded
+    quint64 getPercentile(double percentile) const;
+    
+private:
+    using Buckets = std::array<uint32_t, NUM_BUCKETS>;
+    
+    static int bucketIndex(quint64 value);
+    static quint64 bucketHighestValue(int index);
+    
+    Buckets _buckets;
+    int _count { 0 };
+    quint64 _max { 0 };
+};
+    
+}
+
+#endif // hifi_LatencyHistogram_h
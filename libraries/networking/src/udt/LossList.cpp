@@ -11,6 +11,8 @@
 
 #include "LossList.h"
 
+#include <algorithm>
+
 #include "ControlPacket.h"
 
 using namespace udt;
@@ -167,18 +169,126 @@ SequenceNumber LossList::popFirstSequenceNumber() {
     return front;
 }
 
-void LossList::write(ControlPacket& packet, int maxPairs) {
-    int writtenPairs = 0;
+// sequence numbers are 29 bits, which never take more than 5 bytes as a varint
+static const int MAX_VARINT_BYTES = 5;
+
+static int varintSize(uint32_t value) {
+    int size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+static void writeVarint(ControlPacket& packet, uint32_t value) {
+    char bytes[MAX_VARINT_BYTES];
+    int size = 0;
+    
+    while (value >= 0x80) {
+        bytes[size++] = (char)((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    bytes[size++] = (char)value;
+    
+    packet.write(bytes, size);
+}
+
+static bool readVarint(ControlPacket& packet, qint64 endPosition, uint32_t& value) {
+    value = 0;
     
-    for (const auto& pair : _lossList) {
-        packet.writePrimitive(pair.first);
-        packet.writePrimitive(pair.second);
+    for (int i = 0; i < MAX_VARINT_BYTES && packet.pos() < endPosition; ++i) {
+        uint8_t byte;
+        packet.readPrimitive(&byte);
         
-        ++writtenPairs;
+        value |= (uint32_t)(byte & 0x7F) << (7 * i);
         
-        // check if we've written the maximum number we were told to write
-        if (maxPairs != -1 && writtenPairs >= maxPairs) {
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+int LossList::write(ControlPacket& packet, int maxBytes) {
+    if (_lossList.empty() || maxBytes < (int)sizeof(SequenceNumber) + 1) {
+        return 0;
+    }
+    
+    int writtenBytes = 0;
+    SequenceNumber previousEnd;
+    
+    for (auto it = _lossList.begin(); it != _lossList.end(); ++it) {
+        uint32_t rangeLength = (uint32_t)(seqlen(it->first, it->second) - 1);
+        
+        if (it == _lossList.begin()) {
+            int size = sizeof(SequenceNumber) + varintSize(rangeLength);
+            if (size > maxBytes) {
+                break;
+            }
+            
+            packet.writePrimitive(it->first);
+            writeVarint(packet, rangeLength);
+            writtenBytes += size;
+        } else {
+            // ranges are never adjacent, so there is always at least one received packet between them
+            uint32_t numReceived = (uint32_t)(seqlen(previousEnd, it->first) - 3);
+            
+            int size = varintSize(numReceived) + varintSize(rangeLength);
+            if (writtenBytes + size > maxBytes) {
+                break;
+            }
+            
+            writeVarint(packet, numReceived);
+            writeVarint(packet, rangeLength);
+            writtenBytes += size;
+        }
+        
+        previousEnd = it->second;
+    }
+    
+    return writtenBytes;
+}
+
+void LossList::read(ControlPacket& packet, qint64 numBytes) {
+    qint64 endPosition = packet.pos() + std::min(numBytes, packet.bytesLeftToRead());
+    
+    if (endPosition - packet.pos() < (qint64)sizeof(SequenceNumber)) {
+        packet.seek(endPosition);
+        return;
+    }
+    
+    SequenceNumber start;
+    packet.readPrimitive(&start);
+    
+    uint32_t rangeLength;
+    if (!readVarint(packet, endPosition, rangeLength)) {
+        return;
+    }
+    
+    while (true) {
+        // anything that would wrap around the sequence number space is garbage
+        if (rangeLength >= (uint32_t)SequenceNumber::THRESHOLD) {
             break;
         }
+        
+        SequenceNumber end = start + (SequenceNumber::Type)rangeLength;
+        append(start, end);
+        
+        uint32_t numReceived;
+        if (!readVarint(packet, endPosition, numReceived) || !readVarint(packet, endPosition, rangeLength)
+            || numReceived >= (uint32_t)SequenceNumber::THRESHOLD) {
+            break;
+        }
+        
+        start = end + (SequenceNumber::Type)(numReceived + 2);
     }
+    
+    packet.seek(endPosition);
+}
+
+int LossList::getMaxWriteSize() const {
+    // every range takes two varints, the first sequence number is sent as is
+    return _lossList.empty() ? 0 : (int)sizeof(SequenceNumber) + getNumRanges() * 2 * MAX_VARINT_BYTES;
 }
@@ -14,6 +14,8 @@
 
 #include <list>
 
+#include <QtCore/QtGlobal>
+
 #include "SequenceNumber.h"
 
 namespace udt {
@@ -41,7 +43,18 @@ public:
     SequenceNumber getFirstSequenceNumber() const;
     SequenceNumber popFirstSequenceNumber();
     
-    void write(ControlPacket& packet, int maxPairs = -1);
+    int getNumRanges() const { return (int)_lossList.size(); }
+    
+    // Loss lists are sent in a compact form: the first lost sequence number, the length of the first range and
+    // then for every following range the number of received packets before it and its length, as 7 bit varints.
+    // write stops at the last range that fits in maxBytes and returns the number of bytes written,
+    // read appends the ranges found in the next numBytes of the packet
+    int write(ControlPacket& packet, int maxBytes);
+    void read(ControlPacket& packet, qint64 numBytes);
+    
+    // upper bound of the size write would need for the whole list
+    int getMaxWriteSize() const;
+    
     
 private:
     std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
@@ -0,0 +1,261 @@
+//
+//  NativeSocket.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NativeSocket.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include "Constants.h"
+
+using namespace udt;
+
+#ifdef Q_OS_LINUX
+
+static const int OVERFLOW_SIZE = MAX_JUMBO_PACKET_SIZE - MAX_PACKET_SIZE;
+
+struct NativeSocket::Messages {
+    mmsghdr headers[MAX_DATAGRAMS_PER_BATCH];
+    iovec vectors[MAX_DATAGRAMS_PER_BATCH][2];
+    sockaddr_storage addresses[MAX_DATAGRAMS_PER_BATCH];
+    char overflows[MAX_DATAGRAMS_PER_BATCH][OVERFLOW_SIZE];
+};
+
+static void setupSockAddr(const HifiSockAddr& sockAddr, sockaddr_in& destination) {
+    memset(&destination, 0, sizeof(destination));
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = htonl(sockAddr.getAddress().toIPv4Address());
+    destination.sin_port = htons(sockAddr.getPort());
+}
+
+bool NativeSocket::isSupported() {
+    return true;
+}
+
+NativeSocket::NativeSocket() :
+    _messages(new Messages)
+{
+    memset(_datagramSizes, 0, sizeof(_datagramSizes));
+}
+
+NativeSocket::~NativeSocket() {
+    close();
+}
+
+bool NativeSocket::open(qintptr socketDescriptor) {
+    close();
+
+    if (socketDescriptor == -1) {
+        return false;
+    }
+
+    _descriptor = dup((int) socketDescriptor);
+
+    return _descriptor != -1;
+}
+
+void NativeSocket::close() {
+    if (_descriptor != -1) {
+        ::close(_descriptor);
+        _descriptor = -1;
+    }
+}
+
+int NativeSocket::receiveBatch() {
+    for (int i = 0; i < MAX_DATAGRAMS_PER_BATCH; ++i) {
+        if (!_datagramBuffers[i]) {
+            _datagramBuffers[i] = PacketBufferPool::allocate(MAX_PACKET_SIZE);
+        }
+
+        _messages->vectors[i][0].iov_base = _datagramBuffers[i].get();
+        _messages->vectors[i][0].iov_len = MAX_PACKET_SIZE;
+        _messages->vectors[i][1].iov_base = _messages->overflows[i];
+        _messages->vectors[i][1].iov_len = OVERFLOW_SIZE;
+
+        msghdr& header = _messages->headers[i].msg_hdr;
+        memset(&header, 0, sizeof(header));
+        header.msg_name = &_messages->addresses[i];
+        header.msg_namelen = sizeof(_messages->addresses[i]);
+        header.msg_iov = _messages->vectors[i];
+        header.msg_iovlen = 2;
+    }
+
+    int numReceived = recvmmsg(_descriptor, _messages->headers, MAX_DATAGRAMS_PER_BATCH, MSG_DONTWAIT, nullptr);
+
+    if (numReceived < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+
+        _lastError = errno;
+        return -1;
+    }
+
+    for (int i = 0; i < numReceived; ++i) {
+        const msghdr& header = _messages->headers[i].msg_hdr;
+
+        if (header.msg_flags & MSG_TRUNC) {
+            // this datagram did not fit in a udt packet, it can't be one of ours
+            _datagramSizes[i] = -1;
+        } else {
+            _datagramSizes[i] = _messages->headers[i].msg_len;
+        }
+
+        if (_datagramSizes[i] > MAX_PACKET_SIZE) {
+            // a jumbo datagram, move it to a buffer that holds all of it
+            auto buffer = PacketBufferPool::allocate(_datagramSizes[i]);
+            memcpy(buffer.get(), _datagramBuffers[i].get(), MAX_PACKET_SIZE);
+            memcpy(buffer.get() + MAX_PACKET_SIZE, _messages->overflows[i], _datagramSizes[i] - MAX_PACKET_SIZE);
+            _datagramBuffers[i] = std::move(buffer);
+        }
+
+        _datagramSenders[i] = HifiSockAddr(reinterpret_cast<const sockaddr*>(header.msg_name));
+    }
+
+    return numReceived;
+}
+
+qint64 NativeSocket::writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    sockaddr_in destination;
+    setupSockAddr(sockAddr, destination);
+
+    ssize_t bytesWritten = sendto(_descriptor, data, size, 0,
+                                  reinterpret_cast<const sockaddr*>(&destination), sizeof(destination));
+
+    if (bytesWritten < 0) {
+        _lastError = errno;
+    }
+
+    return bytesWritten;
+}
+
+qint64 NativeSocket::writeUnfragmentedDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    // only this datagram ignores the path MTU, the socket goes back to the mode it was in right after
+    int mode = IP_PMTUDISC_WANT;
+    socklen_t modeLength = sizeof(mode);
+    getsockopt(_descriptor, IPPROTO_IP, IP_MTU_DISCOVER, &mode, &modeLength);
+
+    int probeMode = IP_PMTUDISC_PROBE;
+    if (setsockopt(_descriptor, IPPROTO_IP, IP_MTU_DISCOVER, &probeMode, sizeof(probeMode)) != 0) {
+        _lastError = errno;
+        return -1;
+    }
+
+    qint64 bytesWritten = writeDatagram(data, size, sockAddr);
+
+    setsockopt(_descriptor, IPPROTO_IP, IP_MTU_DISCOVER, &mode, sizeof(mode));
+
+    return bytesWritten;
+}
+
+qint64 NativeSocket::writeDatagrams(const std::vector<Datagram>& datagrams, const HifiSockAddr& sockAddr) {
+    sockaddr_in destination;
+    setupSockAddr(sockAddr, destination);
+
+    // the packets of a list can be written from any thread, so these live on the stack rather than in _messages
+    mmsghdr headers[MAX_DATAGRAMS_PER_BATCH];
+    iovec vectors[MAX_DATAGRAMS_PER_BATCH];
+
+    qint64 totalBytesWritten = 0;
+    bool hasWritten = false;
+
+    size_t numWritten = 0;
+    while (numWritten < datagrams.size()) {
+        int numInBatch = (int) std::min(datagrams.size() - numWritten, (size_t) MAX_DATAGRAMS_PER_BATCH);
+
+        for (int i = 0; i < numInBatch; ++i) {
+            const Datagram& datagram = datagrams[numWritten + i];
+
+            vectors[i].iov_base = const_cast<char*>(datagram.first);
+            vectors[i].iov_len = datagram.second;
+
+            msghdr& header = headers[i].msg_hdr;
+            memset(&header, 0, sizeof(header));
+            header.msg_name = &destination;
+            header.msg_namelen = sizeof(destination);
+            header.msg_iov = &vectors[i];
+            header.msg_iovlen = 1;
+        }
+
+        int numSent = sendmmsg(_descriptor, headers, numInBatch, 0);
+
+        if (numSent <= 0) {
+            // the caller drops the rest, the same as it would drop a datagram the QUdpSocket failed to write
+            _lastError = errno;
+            break;
+        }
+
+        for (int i = 0; i < numSent; ++i) {
+            totalBytesWritten += headers[i].msg_len;
+        }
+
+        hasWritten = true;
+        numWritten += numSent;
+    }
+
+    return hasWritten ? totalBytesWritten : -1;
+}
+
+QString NativeSocket::getErrorString() const {
+    return QString(strerror(_lastError));
+}
+
+#else
+
+struct NativeSocket::Messages {};
+
+bool NativeSocket::isSupported() {
+    return false;
+}
+
+NativeSocket::NativeSocket() {
+    memset(_datagramSizes, 0, sizeof(_datagramSizes));
+}
+
+NativeSocket::~NativeSocket() {}
+
+bool NativeSocket::open(qintptr socketDescriptor) {
+    return false;
+}
+
+void NativeSocket::close() {}
+
+int NativeSocket::receiveBatch() {
+    return -1;
+}
+
+qint64 NativeSocket::writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    return -1;
+}
+
+qint64 NativeSocket::writeUnfragmentedDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    return -1;
+}
+
+qint64 NativeSocket::writeDatagrams(const std::vector<Datagram>& datagrams, const HifiSockAddr& sockAddr) {
+    return -1;
+}
+
+QString NativeSocket::getErrorString() const {
+    return QString("Native sockets are not supported on this platform");
+}
+
+#endif
+
+PacketBuffer NativeSocket::takeDatagram(int index) {
+    return std::move(_datagramBuffers[index]);
+}
@@ -0,0 +1,90 @@
+//
+//  NativeSocket.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_NativeSocket_h
+#define hifi_NativeSocket_h
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <QtCore/QtGlobal>
+
+#include "../HifiSockAddr.h"
+#include "PacketBufferPool.h"
+
+namespace udt {
+
+/// Reads and writes datagrams in batches directly on the descriptor of a bound UDP socket, with one recvmmsg or
+/// sendmmsg call per batch instead of one call per datagram. Only supported on Linux, the Socket keeps
+/// going through its QUdpSocket everywhere else.
+class NativeSocket {
+public:
+    static const int MAX_DATAGRAMS_PER_BATCH = 64;
+
+    using Datagram = std::pair<const char*, qint64>;
+
+    static bool isSupported();
+
+    NativeSocket();
+    ~NativeSocket();
+
+    /// duplicates the descriptor so that the QUdpSocket it belongs to keeps ownership of the original
+    bool open(qintptr socketDescriptor);
+    void close();
+
+    bool isOpen() const { return _descriptor != -1; }
+    int getDescriptor() const { return _descriptor; }
+
+    /// receives the datagrams waiting on the socket without blocking, up to MAX_DATAGRAMS_PER_BATCH of them
+    /// \return the number of datagrams received, 0 if there were none and -1 on error
+    int receiveBatch();
+
+    /// hands over the buffer of a datagram from the last receiveBatch, its slot gets a fresh buffer on the next one
+    PacketBuffer takeDatagram(int index);
+    qint64 getDatagramSize(int index) const { return _datagramSizes[index]; }
+    const HifiSockAddr& getDatagramSender(int index) const { return _datagramSenders[index]; }
+
+    /// \return the number of bytes written, -1 on error
+    qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+
+    /// writes the datagram with the don't fragment bit set whatever the path MTU the system knows of, so that it is
+    /// dropped rather than fragmented on the way if it is larger than the path carries; for path MTU probes
+    /// \return the number of bytes written, -1 on error
+    qint64 writeUnfragmentedDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+
+    /// writes every datagram to the same address, as few system calls as possible
+    /// \return the number of bytes written, -1 if nothing could be written
+    qint64 writeDatagrams(const std::vector<Datagram>& datagrams, const HifiSockAddr& sockAddr);
+
+    /// \return a description of the last error of the socket
+    QString getErrorString() const;
+
+private:
+    struct Messages;
+
+    int _descriptor { -1 };
+    int _lastError { 0 };
+
+    // buffers received datagrams are read into, each one is drawn from the pool and then owned by the packet built from it
+    // the datagrams larger than a pooled buffer get the rest of their bytes in the overflow of their slot in _messages
+    PacketBuffer _datagramBuffers[MAX_DATAGRAMS_PER_BATCH];
+    qint64 _datagramSizes[MAX_DATAGRAMS_PER_BATCH];
+    HifiSockAddr _datagramSenders[MAX_DATAGRAMS_PER_BATCH];
+
+    // the system message headers, kept here so that none of the system headers leak out of NativeSocket.cpp
+    std::unique_ptr<Messages> _messages;
+};
+
+} // namespace udt
+
+#endif // hifi_NativeSocket_h
@@ -0,0 +1,48 @@
+//
+//  NetworkShaper.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkShaper.h"
+
+using namespace udt;
+
+void NetworkShaper::setConditions(const NetworkConditions& conditions, uint32_t seed) {
+    _conditions = conditions;
+    _generator.seed(seed);
+    _numDroppedDatagrams = 0;
+}
+
+bool NetworkShaper::addDatagram(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr, quint64 now) {
+    if (_conditions.lossRate > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(_generator) < _conditions.lossRate) {
+        ++_numDroppedDatagrams;
+        return false;
+    }
+
+    quint64 delay = _conditions.latencyUsecs;
+    if (_conditions.jitterUsecs > 0) {
+        delay += std::uniform_int_distribution<quint64>(0, _conditions.jitterUsecs)(_generator);
+    }
+
+    _delayedDatagrams.emplace(now + delay, DelayedDatagram { std::move(buffer), size, senderSockAddr });
+    return true;
+}
+
+void NetworkShaper::releaseDatagrams(quint64 now, const DatagramHandler& handler) {
+    while (!_delayedDatagrams.empty() && _delayedDatagrams.begin()->first <= now) {
+        // taken out first, the handler can add datagrams of its own
+        auto delayedDatagram = std::move(_delayedDatagrams.begin()->second);
+        _delayedDatagrams.erase(_delayedDatagrams.begin());
+
+        handler(std::move(delayedDatagram.buffer), delayedDatagram.size, delayedDatagram.senderSockAddr);
+    }
+}
+
+quint64 NetworkShaper::getNextReleaseTime() const {
+    return _delayedDatagrams.empty() ? 0 : _delayedDatagrams.begin()->first;
+}
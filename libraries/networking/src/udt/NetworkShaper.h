@@ -0,0 +1,77 @@
+//
+//  NetworkShaper.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_NetworkShaper_h
+#define hifi_NetworkShaper_h
+
+#include <functional>
+#include <map>
+#include <random>
+
+#include <QtCore/QtGlobal>
+
+#include "../HifiSockAddr.h"
+#include "PacketBufferPool.h"
+
+namespace udt {
+
+// the network a Socket pretends its received datagrams came over
+struct NetworkConditions {
+    double lossRate { 0.0 }; // the chance each datagram is dropped, from 0 to 1
+    quint64 latencyUsecs { 0 }; // the delay added to every datagram
+    quint64 jitterUsecs { 0 }; // the most a datagram is delayed further, picked evenly, which can reorder them
+
+    bool isIdeal() const { return lossRate <= 0.0 && latencyUsecs == 0 && jitterUsecs == 0; }
+};
+
+// Drops and delays received datagrams according to NetworkConditions, on the Socket thread, so that congestion control
+// and the send queue can be measured against loss and latency on a local network. The random generator is seeded so
+// that a run can be repeated.
+class NetworkShaper {
+public:
+    using DatagramHandler = std::function<void(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr)>;
+
+    static const uint32_t DEFAULT_SEED = 742272;
+
+    void setConditions(const NetworkConditions& conditions, uint32_t seed = DEFAULT_SEED);
+    const NetworkConditions& getConditions() const { return _conditions; }
+
+    // true while the datagrams go through the shaper
+    bool isShaping() const { return !_conditions.isIdeal() || !_delayedDatagrams.empty(); }
+
+    // takes a datagram that arrived at the given time, returns false if it was dropped
+    bool addDatagram(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr, quint64 now);
+
+    // hands the datagrams due by the given time to the handler, earliest first
+    void releaseDatagrams(quint64 now, const DatagramHandler& handler);
+
+    // when the next datagram is due, 0 if none is waiting
+    quint64 getNextReleaseTime() const;
+
+    int getNumDroppedDatagrams() const { return _numDroppedDatagrams; }
+
+private:
+    struct DelayedDatagram {
+        PacketBuffer buffer;
+        qint64 size;
+        HifiSockAddr senderSockAddr;
+    };
+
+    NetworkConditions _conditions;
+    std::mt19937 _generator;
+    std::multimap<quint64, DelayedDatagram> _delayedDatagrams; // by the time they are due, in arrival order for ties
+    int _numDroppedDatagrams { 0 };
+};
+
+}
+
+#endif // hifi_NetworkShaper_h
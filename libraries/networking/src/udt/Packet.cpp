@@ -37,7 +37,7 @@ std::unique_ptr<Packet> Packet::create(qint64 size, bool isReliable, bool isPart
     return packet;
 }
 
-std::unique_ptr<Packet> Packet::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) {
+std::unique_ptr<Packet> Packet::fromReceivedPacket(PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) {
     // Fail with invalid size
     Q_ASSERT(size >= 0);
 
@@ -54,7 +54,7 @@ std::unique_ptr<Packet> Packet::createCopy(const Packet& other) {
 }
 
 Packet::Packet(qint64 size, bool isReliable, bool isPartOfMessage) :
-    BasePacket((size == -1) ? -1 : (Packet::localHeaderSize() + size)),
+    BasePacket((size == -1) ? -1 : (Packet::localHeaderSize(isPartOfMessage) + size)),
     _isReliable(isReliable),
     _isPartOfMessage(isPartOfMessage)
 {
@@ -63,7 +63,7 @@ Packet::Packet(qint64 size, bool isReliable, bool isPartOfMessage) :
     writeHeader();
 }
 
-Packet::Packet(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+Packet::Packet(PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     BasePacket(std::move(data), size, senderSockAddr)
 {
     readHeader();
@@ -97,6 +97,7 @@ Packet::Packet(Packet&& other) :
     _sequenceNumber = other._sequenceNumber;
     _packetPosition = other._packetPosition;
     _messageNumber = other._messageNumber;
+    _messagePartNumber = other._messagePartNumber;
 }
 
 Packet& Packet::operator=(Packet&& other) {
@@ -107,6 +108,7 @@ Packet& Packet::operator=(Packet&& other) {
     _sequenceNumber = other._sequenceNumber;
     _packetPosition = other._packetPosition;
     _messageNumber = other._messageNumber;
+    _messagePartNumber = other._messagePartNumber;
 
     return *this;
 }
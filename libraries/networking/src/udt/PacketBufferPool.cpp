@@ -0,0 +1,198 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QThreadStorage>
+
+#include <tbb/concurrent_queue.h>
+
+using namespace udt;
+
+static const int MAX_CACHED_BUFFERS_PER_THREAD = 128;
+static const int BUFFERS_PER_TRANSFER = 64; // moved between a thread's free list and the shared queue at once
+static const int MAX_SHARED_FREE_BUFFERS = 8192;
+
+namespace {
+
+    // the free list of one thread, only its own thread touches the buffers
+    class PacketBufferCache {
+    public:
+        PacketBufferCache();
+        ~PacketBufferCache();
+
+        std::vector<char*> freeBuffers;
+
+        // written by the owning thread only, read by getStats from any thread
+        std::atomic<quint64> hits { 0 };
+        std::atomic<quint64> misses { 0 };
+    };
+
+    tbb::concurrent_queue<char*> sharedFreeBuffers;
+    std::atomic<int> numSharedFreeBuffers { 0 };
+
+    std::atomic<int> numBuffers { 0 };
+    std::atomic<int> highWaterMark { 0 };
+
+    QMutex cachesMutex;
+    std::vector<PacketBufferCache*> caches;
+    quint64 retiredHits = 0;
+    quint64 retiredMisses = 0;
+
+    // packets destroyed during static destruction, after the caches are gone, just delete their buffers
+    bool isPoolAlive = false;
+
+    QThreadStorage<PacketBufferCache*> threadCaches;
+
+    void deleteBuffer(char* buffer) {
+        delete[] buffer;
+        --numBuffers;
+    }
+
+    // declared last so that it is destroyed before everything above
+    struct PoolLifetime {
+        PoolLifetime() { isPoolAlive = true; }
+        ~PoolLifetime() {
+            isPoolAlive = false;
+
+            char* buffer = nullptr;
+            while (sharedFreeBuffers.try_pop(buffer)) {
+                deleteBuffer(buffer);
+            }
+        }
+    } poolLifetime;
+
+    void pushSharedFreeBuffer(char* buffer) {
+        if (isPoolAlive && numSharedFreeBuffers.load(std::memory_order_relaxed) < MAX_SHARED_FREE_BUFFERS) {
+            sharedFreeBuffers.push(buffer);
+            ++numSharedFreeBuffers;
+        } else {
+            deleteBuffer(buffer);
+        }
+    }
+
+    PacketBufferCache::PacketBufferCache() {
+        freeBuffers.reserve(MAX_CACHED_BUFFERS_PER_THREAD + 1);
+
+        QMutexLocker locker(&cachesMutex);
+        caches.push_back(this);
+    }
+
+    PacketBufferCache::~PacketBufferCache() {
+        // hand the buffers of this thread to the others
+        for (char* buffer : freeBuffers) {
+            pushSharedFreeBuffer(buffer);
+        }
+
+        QMutexLocker locker(&cachesMutex);
+        caches.erase(std::remove(caches.begin(), caches.end(), this), caches.end());
+        retiredHits += hits;
+        retiredMisses += misses;
+    }
+
+    PacketBufferCache& localCache() {
+        if (!threadCaches.hasLocalData()) {
+            threadCaches.setLocalData(new PacketBufferCache());
+        }
+
+        return *threadCaches.localData();
+    }
+
+    void increment(std::atomic<quint64>& counter) {
+        // only the owning thread writes the counters, so this needs no read-modify-write
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+void PacketBufferDeleter::operator()(char* buffer) const {
+    if (_isPooled) {
+        PacketBufferPool::release(buffer);
+    } else {
+        delete[] buffer;
+    }
+}
+
+PacketBuffer PacketBufferPool::allocate(qint64 size) {
+    if (size > BUFFER_SIZE || !isPoolAlive) {
+        return PacketBuffer(new char[size], PacketBufferDeleter(false));
+    }
+
+    PacketBufferCache& cache = localCache();
+
+    if (cache.freeBuffers.empty()) {
+        // take a batch of the buffers other threads have left
+        char* buffer = nullptr;
+        while ((int) cache.freeBuffers.size() < BUFFERS_PER_TRANSFER && sharedFreeBuffers.try_pop(buffer)) {
+            --numSharedFreeBuffers;
+            cache.freeBuffers.push_back(buffer);
+        }
+    }
+
+    if (!cache.freeBuffers.empty()) {
+        char* buffer = cache.freeBuffers.back();
+        cache.freeBuffers.pop_back();
+        increment(cache.hits);
+
+        return PacketBuffer(buffer, PacketBufferDeleter(true));
+    }
+
+    increment(cache.misses);
+
+    int currentNumBuffers = ++numBuffers;
+    int currentHighWaterMark = highWaterMark.load();
+    while (currentNumBuffers > currentHighWaterMark
+           && !highWaterMark.compare_exchange_weak(currentHighWaterMark, currentNumBuffers)) {}
+
+    return PacketBuffer(new char[BUFFER_SIZE], PacketBufferDeleter(true));
+}
+
+void PacketBufferPool::release(char* buffer) {
+    if (!isPoolAlive) {
+        deleteBuffer(buffer);
+        return;
+    }
+
+    PacketBufferCache& cache = localCache();
+    cache.freeBuffers.push_back(buffer);
+
+    if ((int) cache.freeBuffers.size() > MAX_CACHED_BUFFERS_PER_THREAD) {
+        // this thread frees more than it allocates, share the surplus
+        for (int i = 0; i < BUFFERS_PER_TRANSFER; ++i) {
+            pushSharedFreeBuffer(cache.freeBuffers.back());
+            cache.freeBuffers.pop_back();
+        }
+    }
+}
+
+PacketBufferPool::Stats PacketBufferPool::getStats() {
+    Stats stats;
+
+    {
+        QMutexLocker locker(&cachesMutex);
+
+        stats.hits = retiredHits;
+        stats.misses = retiredMisses;
+
+        for (PacketBufferCache* cache : caches) {
+            stats.hits += cache->hits.load(std::memory_order_relaxed);
+            stats.misses += cache->misses.load(std::memory_order_relaxed);
+        }
+    }
+
+    stats.numBuffers = numBuffers;
+    stats.highWaterMark = highWaterMark;
+
+    return stats;
+}
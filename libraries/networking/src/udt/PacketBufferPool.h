@@ -0,0 +1,64 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <memory>
+
+#include <QtCore/QtGlobal>
+
+#include "Constants.h"
+
+namespace udt {
+
+/// Gives a packet buffer back to the PacketBufferPool it came from, or deletes it if it was not pooled
+class PacketBufferDeleter {
+public:
+    PacketBufferDeleter(bool isPooled = false) : _isPooled(isPooled) {}
+
+    void operator()(char* buffer) const;
+
+private:
+    bool _isPooled;
+};
+
+using PacketBuffer = std::unique_ptr<char[], PacketBufferDeleter>;
+
+/// MTU sized buffers for packets, recycled through a free list per thread so that creating and destroying packets
+/// does not go through the allocator. Threads that free more buffers than they allocate (the ones that handle
+/// received packets) pass the surplus to the threads that allocate more than they free through a shared lock-free queue.
+class PacketBufferPool {
+public:
+    static const qint64 BUFFER_SIZE = MAX_PACKET_SIZE;
+
+    struct Stats {
+        quint64 hits { 0 }; // allocations served from a free list
+        quint64 misses { 0 }; // allocations that had to create a buffer
+        int numBuffers { 0 }; // buffers that currently exist, in use or free
+        int highWaterMark { 0 }; // the most buffers that existed at once
+    };
+
+    /// \return a buffer of at least size bytes, only requests that fit in BUFFER_SIZE are pooled
+    static PacketBuffer allocate(qint64 size);
+
+    static Stats getStats();
+
+private:
+    friend class PacketBufferDeleter;
+
+    static void release(char* buffer);
+};
+
+} // namespace udt
+
+#endif // hifi_PacketBufferPool_h
@@ -0,0 +1,71 @@
+//
+//  PacketCapture.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketCapture.h"
+
+#include "../NetworkLogging.h"
+
+using namespace udt;
+
+bool PacketCaptureWriter::open(const QString& path) {
+    close();
+
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(networking) << "Could not open" << path << "to capture packets -" << _file.errorString();
+        return false;
+    }
+
+    _stream.setDevice(&_file);
+    _stream << CAPTURE_MAGIC << CAPTURE_VERSION;
+    _startTime = 0;
+    return true;
+}
+
+void PacketCaptureWriter::close() {
+    if (_file.isOpen()) {
+        _stream.setDevice(nullptr);
+        _file.close();
+    }
+}
+
+void PacketCaptureWriter::addDatagram(const char* data, qint64 size, const HifiSockAddr& senderSockAddr, quint64 now) {
+    if (_startTime == 0) {
+        _startTime = now;
+    }
+    _stream << (quint64)(now - _startTime) << senderSockAddr << QByteArray::fromRawData(data, size);
+}
+
+bool PacketCaptureReader::open(const QString& path) {
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        qCWarning(networking) << "Could not open the packet capture" << path << "-" << _file.errorString();
+        return false;
+    }
+
+    _stream.setDevice(&_file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    _stream >> magic >> version;
+    if (magic != CAPTURE_MAGIC || version != CAPTURE_VERSION) {
+        qCWarning(networking) << path << "is not a packet capture this build can read";
+        _file.close();
+        return false;
+    }
+    return true;
+}
+
+bool PacketCaptureReader::readNext(Datagram& datagram) {
+    if (!_file.isOpen() || _stream.atEnd()) {
+        return false;
+    }
+    _stream >> datagram.timeUsecs >> datagram.senderSockAddr >> datagram.data;
+    return _stream.status() == QDataStream::Ok;
+}
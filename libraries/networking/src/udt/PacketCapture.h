@@ -0,0 +1,67 @@
+//
+//  PacketCapture.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketCapture_h
+#define hifi_PacketCapture_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+// A capture file holds the datagrams a Socket received, as they came off the wire, so that a session with real
+// clients can be replayed against a server later. It starts with CAPTURE_MAGIC and CAPTURE_VERSION, then has for
+// every datagram, in a QDataStream:
+//     usecs since the capture started             (quint64)
+//     sender                                      (HifiSockAddr)
+//     datagram                                    (QByteArray)
+const quint32 CAPTURE_MAGIC = 0x48465043; // HFPC
+const quint32 CAPTURE_VERSION = 1;
+
+class PacketCaptureWriter {
+public:
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return _file.isOpen(); }
+
+    void addDatagram(const char* data, qint64 size, const HifiSockAddr& senderSockAddr, quint64 now);
+
+private:
+    QFile _file;
+    QDataStream _stream;
+    quint64 _startTime { 0 };
+};
+
+class PacketCaptureReader {
+public:
+    struct Datagram {
+        quint64 timeUsecs { 0 };
+        HifiSockAddr senderSockAddr;
+        QByteArray data;
+    };
+
+    bool open(const QString& path);
+
+    // false once the capture is done, or cut short
+    bool readNext(Datagram& datagram);
+
+private:
+    QFile _file;
+    QDataStream _stream;
+};
+
+}
+
+#endif // hifi_PacketCapture_h
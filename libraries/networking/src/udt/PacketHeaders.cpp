@@ -31,6 +31,11 @@ const QSet<PacketType> NON_SOURCED_PACKETS = QSet<PacketType>()
     << PacketType::ICEPing << PacketType::ICEPingReply
     << PacketType::AssignmentClientStatus << PacketType::StopNode;
 
+const QSet<PacketType> SIP_HASH_VERIFIED_PACKETS = QSet<PacketType>()
+    << PacketType::MicrophoneAudioNoEcho << PacketType::MicrophoneAudioWithEcho
+    << PacketType::InjectAudio << PacketType::SilentAudioFrame << PacketType::MixedAudio
+    << PacketType::AvatarData << PacketType::BulkAvatarData;
+
 const QSet<PacketType> RELIABLE_PACKETS = QSet<PacketType>();
 
 PacketVersion versionForPacketType(PacketType packetType) {
@@ -38,9 +43,22 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::EntityAdd:
         case PacketType::EntityEdit:
         case PacketType::EntityData:
-            return VERSION_ENTITIES_PARTICLES_ADDITIVE_BLENDING;
+        case PacketType::EntitySimulationUpdate:
+            return VERSION_ENTITIES_COMPRESSION_DICTIONARY;
         case PacketType::AvatarData:
         case PacketType::BulkAvatarData:
+            return VERSION_AVATAR_DATA_SIP_HASH;
+        case PacketType::MicrophoneAudioNoEcho:
+        case PacketType::MicrophoneAudioWithEcho:
+        case PacketType::InjectAudio:
+        case PacketType::SilentAudioFrame:
+        case PacketType::MixedAudio:
+            return VERSION_AUDIO_STREAM_SIP_HASH;
+        case PacketType::AudioStreamStats:
+            return VERSION_AUDIO_STREAM_STATS_LATENCY;
+        case PacketType::DomainList:
+        case PacketType::DomainListRequest:
+            return VERSION_DOMAIN_LIST_INCREMENTAL;
         default:
             return 16;
     }
@@ -93,6 +111,12 @@ QString nameForPacketType(PacketType packetType) {
         PACKET_TYPE_NAME_LOOKUP(PacketType::EntityAdd);
         PACKET_TYPE_NAME_LOOKUP(PacketType::EntityEdit);
         PACKET_TYPE_NAME_LOOKUP(PacketType::DomainServerConnectionToken);
+        PACKET_TYPE_NAME_LOOKUP(PacketType::NegotiateAudioFormat);
+        PACKET_TYPE_NAME_LOOKUP(PacketType::SelectedAudioFormat);
+        PACKET_TYPE_NAME_LOOKUP(PacketType::EntitySimulationUpdate);
+        PACKET_TYPE_NAME_LOOKUP(PacketType::EntityFind);
+        PACKET_TYPE_NAME_LOOKUP(PacketType::EntityFindReply);
+        PACKET_TYPE_NAME_LOOKUP(PacketType::SimulatorLoad);
         default:
             return QString("Type: ") + QString::number((int)packetType);
     }
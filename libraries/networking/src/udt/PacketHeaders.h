@@ -79,7 +79,13 @@ enum class PacketType : uint8_t {
     AssetUpload,
     AssetUploadReply,
     AssetGetInfo,
-    AssetGetInfoReply
+    AssetGetInfoReply,
+    NegotiateAudioFormat,
+    SelectedAudioFormat,
+    EntitySimulationUpdate,
+    EntityFind,
+    EntityFindReply,
+    SimulatorLoad
 };
 
 const int NUM_BYTES_MD5_HASH = 16;
@@ -88,6 +94,7 @@ typedef char PacketVersion;
 
 extern const QSet<PacketType> NON_VERIFIED_PACKETS;
 extern const QSet<PacketType> NON_SOURCED_PACKETS;
+extern const QSet<PacketType> SIP_HASH_VERIFIED_PACKETS; // high rate streams verified with a SipHash MAC, not MD5
 extern const QSet<PacketType> RELIABLE_PACKETS;
 
 QString nameForPacketType(PacketType packetType);
@@ -146,5 +153,16 @@ const PacketVersion VERSION_ENTITIES_ANIMATION_PROPERTIES_GROUP = 46;
 const PacketVersion VERSION_ENTITIES_KEYLIGHT_PROPERTIES_GROUP = 47;
 const PacketVersion VERSION_ENTITIES_KEYLIGHT_PROPERTIES_GROUP_BIS = 48;
 const PacketVersion VERSION_ENTITIES_PARTICLES_ADDITIVE_BLENDING = 49;
+const PacketVersion VERSION_ENTITIES_SIMULATION_UPDATES = 50;
+const PacketVersion VERSION_ENTITIES_POLYVOX_EDITS = 51;
+const PacketVersion VERSION_ENTITIES_COMPRESSION_DICTIONARY = 52;
+
+const PacketVersion VERSION_AVATAR_DATA_JOINT_DETAIL = 17;
+const PacketVersion VERSION_AVATAR_DATA_SIP_HASH = 18;
+
+const PacketVersion VERSION_AUDIO_STREAM_STATS_LATENCY = 17;
+const PacketVersion VERSION_AUDIO_STREAM_SIP_HASH = 17;
+
+const PacketVersion VERSION_DOMAIN_LIST_INCREMENTAL = 17;
 
 #endif // hifi_PacketHeaders_h
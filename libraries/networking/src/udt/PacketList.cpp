@@ -46,6 +46,7 @@ PacketList::PacketList(PacketList&& other) :
     _packets(std::move(other._packets)),
     _isReliable(other._isReliable),
     _isOrdered(other._isOrdered),
+    _priority(other._priority),
     _extendedHeader(std::move(other._extendedHeader))
 {
 }
@@ -88,7 +89,8 @@ std::unique_ptr<Packet> PacketList::createPacket() {
     // use the static create method to create a new packet
     // If this packet list is supposed to be ordered then we consider this to be part of a message
     bool isPartOfMessage = _isOrdered;
-    return Packet::create(-1, _isReliable, isPartOfMessage);
+    qint64 payloadSize = (_maxPacketSize == -1) ? -1 : _maxPacketSize - Packet::totalHeaderSize(isPartOfMessage);
+    return Packet::create(payloadSize, _isReliable, isPartOfMessage);
 }
 
 std::unique_ptr<Packet> PacketList::createPacketWithExtendedHeader() {
@@ -117,6 +119,26 @@ void PacketList::closeCurrentPacket(bool shouldSendEmpty) {
     }
 }
 
+void PacketList::resizePackets(int maxPacketSize) {
+    Q_ASSERT_X(!_currentPacket, "PacketList::resizePackets", "The current packet must be closed first");
+    
+    // the packets of an unordered list are read on their own, and the receivers of an ordered one read every packet
+    // of it as starting with the extended header
+    int packetSize = (_maxPacketSize == -1) ? MAX_PACKET_SIZE : _maxPacketSize;
+    if (!_isOrdered || !_extendedHeader.isEmpty() || maxPacketSize == packetSize || _packets.size() < 2) {
+        return;
+    }
+    
+    auto packets = std::move(_packets);
+    _packets.clear();
+    _maxPacketSize = maxPacketSize;
+    
+    for (const auto& packet : packets) {
+        writeData(packet->getPayload(), packet->getPayloadSize());
+    }
+    closeCurrentPacket();
+}
+
 QByteArray PacketList::getMessage() {
     size_t sizeBytes = 0;
 
@@ -31,6 +31,14 @@ public:
     using MessageNumber = uint32_t;
     using PacketPointer = std::unique_ptr<Packet>;
     
+    // How many packets of the list the send queue takes in turn with each of the other messages queued on the
+    // connection, so that bulk transfers don't hold back the small messages queued after them
+    enum class Priority : uint8_t {
+        Bulk = 1,
+        Normal = 4,
+        Urgent = 16
+    };
+    
     static std::unique_ptr<PacketList> create(PacketType packetType, QByteArray extendedHeader = QByteArray(),
                                               bool isReliable = false, bool isOrdered = false);
     static std::unique_ptr<PacketList> fromReceivedPackets(std::list<std::unique_ptr<Packet>>&& packets);
@@ -39,6 +47,9 @@ public:
     bool isReliable() const { return _isReliable; }
     bool isOrdered() const { return _isOrdered; }
     
+    Priority getPriority() const { return _priority; }
+    void setPriority(Priority priority) { _priority = priority; }
+    
     int getNumPackets() const { return _packets.size() + (_currentPacket ? 1 : 0); }
     size_t getDataSize() const;
     size_t getMessageSize() const;
@@ -50,6 +61,10 @@ public:
     void endSegment();
     
     void closeCurrentPacket(bool shouldSendEmpty = false);
+    
+    // Cuts the closed packets of an ordered list again into packets of up to maxPacketSize bytes, headers included,
+    // for paths that carry more than MAX_PACKET_SIZE. Lists with an extended header are left as they are
+    void resizePackets(int maxPacketSize);
 
     // QIODevice virtual functions
     virtual bool isSequential() const  { return false; }
@@ -70,6 +85,7 @@ protected:
     
     PacketType _packetType;
     std::list<std::unique_ptr<Packet>> _packets;
+    int _maxPacketSize = -1; // Size of the packets createPacket makes, headers included, -1 for the default
     
 private:
     friend class ::LimitedNodeList;
@@ -90,6 +106,7 @@ private:
     Packet::MessageNumber _messageNumber;
     bool _isReliable = false;
     bool _isOrdered = false;
+    Priority _priority = Priority::Normal;
     
     std::unique_ptr<Packet> _currentPacket;
     
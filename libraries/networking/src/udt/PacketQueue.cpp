@@ -11,7 +11,7 @@
 
 #include "PacketQueue.h"
 
-#include "PacketList.h"
+#include <SharedUtil.h>
 
 using namespace udt;
 
@@ -24,7 +24,7 @@ MessageNumber PacketQueue::getNextMessageNumber() {
 bool PacketQueue::isEmpty() const {
     LockGuard locker(_packetsLock);
     // Only the main channel and it is empty
-    return (_channels.size() == 1) && _channels.front().empty();
+    return (_channels.size() == 1) && _channels.front().packets.empty();
 }
 
 PacketQueue::PacketPointer PacketQueue::takePacket() {
@@ -33,22 +33,28 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
         return PacketPointer();
     }
     
-    // Find next non empty channel
-    if (_channels[nextIndex()].empty()) {
-        nextIndex();
+    // Once the current channel used up its turn, find next non empty channel
+    // (only the main channel can be empty, the others are removed with their last packet)
+    if (_currentCredit == 0 || _channels[_currentIndex].packets.empty()) {
+        if (_channels[nextIndex()].packets.empty()) {
+            nextIndex();
+        }
+        _currentCredit = _channels[_currentIndex].weight;
     }
     auto& channel = _channels[_currentIndex];
-    Q_ASSERT(!channel.empty());
+    Q_ASSERT(!channel.packets.empty());
     
     // Take front packet
-    auto packet = std::move(channel.front());
-    channel.pop_front();
+    auto packet = std::move(channel.packets.front());
+    channel.packets.pop_front();
+    --_currentCredit;
     
     // Remove now empty channel (Don't remove the main channel)
-    if (channel.empty() && _currentIndex != 0) {
-        channel.swap(_channels.back());
+    if (channel.packets.empty() && _currentIndex != 0) {
+        std::swap(channel, _channels.back());
         _channels.pop_back();
         --_currentIndex;
+        _currentCredit = 0;
     }
     
     return std::move(packet);
@@ -60,13 +66,20 @@ unsigned int PacketQueue::nextIndex() {
 }
 
 void PacketQueue::queuePacket(PacketPointer packet) {
+    packet->setQueueTime(usecTimestampNow());
+    
     LockGuard locker(_packetsLock);
-    _channels.front().push_back(std::move(packet));
+    _channels.front().packets.push_back(std::move(packet));
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
     packetList->preparePackets(getNextMessageNumber());
     
+    auto now = usecTimestampNow();
+    for (auto& packet : packetList->_packets) {
+        packet->setQueueTime(now);
+    }
+    
     LockGuard locker(_packetsLock);
-    _channels.push_back(std::move(packetList->_packets));
+    _channels.push_back(Channel { std::move(packetList->_packets), (unsigned int)packetList->getPriority() });
 }
@@ -18,11 +18,10 @@
 #include <mutex>
 
 #include "Packet.h"
+#include "PacketList.h"
 
 namespace udt {
     
-class PacketList;
-    
 using MessageNumber = uint32_t;
     
 class PacketQueue {
@@ -30,10 +29,17 @@ class PacketQueue {
     using LockGuard = std::lock_guard<Mutex>;
     using PacketPointer = std::unique_ptr<Packet>;
     using PacketListPointer = std::unique_ptr<PacketList>;
-    using Channel = std::list<PacketPointer>;
+    
+    struct Channel {
+        std::list<PacketPointer> packets;
+        unsigned int weight; // Packets taken from the channel in a row before the next one gets its turn
+    };
     using Channels = std::vector<Channel>;
     
 public:
+    // The main channel carries the single packets, mostly small control messages that should not wait on packet lists
+    static const unsigned int MAIN_CHANNEL_WEIGHT = (unsigned int)PacketList::Priority::Urgent;
+    
     void queuePacket(PacketPointer packet);
     void queuePacketList(PacketListPointer packetList);
     
@@ -49,8 +55,9 @@ private:
     MessageNumber _currentMessageNumber { 0 };
     
     mutable Mutex _packetsLock; // Protects the packets to be sent.
-    Channels _channels = Channels(1); // One channel per packet list + Main channel
+    Channels _channels = Channels(1, Channel { {}, MAIN_CHANNEL_WEIGHT }); // One channel per packet list + Main channel
     unsigned int _currentIndex { 0 };
+    unsigned int _currentCredit { 0 }; // Packets the current channel can still send before the next one gets its turn
 };
 
 }
@@ -12,64 +12,28 @@
 #include "SendQueue.h"
 
 #include <algorithm>
-#include <thread>
 
-#include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
-#include <QtCore/QThread>
 
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 
 #include "../NetworkLogging.h"
 #include "ControlPacket.h"
 #include "Packet.h"
 #include "PacketList.h"
+#include "SendQueueScheduler.h"
 #include "Socket.h"
 
 using namespace udt;
 
-template <typename Mutex1, typename Mutex2>
-class DoubleLock {
-public:
-    using Lock = std::unique_lock<DoubleLock<Mutex1, Mutex2>>;
-    
-    DoubleLock(Mutex1& mutex1, Mutex2& mutex2) : _mutex1(mutex1), _mutex2(mutex2) { }
-    
-    DoubleLock(const DoubleLock&) = delete;
-    DoubleLock& operator=(const DoubleLock&) = delete;
-    
-    // Either locks all the mutexes or none of them
-    bool try_lock() { return (std::try_lock(_mutex1, _mutex2) == -1); }
-    
-    // Locks all the mutexes
-    void lock() { std::lock(_mutex1, _mutex2); }
-    
-     // Undefined behavior if not locked
-    void unlock() { _mutex1.unlock(); _mutex2.unlock(); }
-    
-private:
-    Mutex1& _mutex1;
-    Mutex2& _mutex2;
-};
-
 std::unique_ptr<SendQueue> SendQueue::create(Socket* socket, HifiSockAddr destination) {
     Q_ASSERT_X(socket, "SendQueue::create", "Must be called with a valid Socket*");
     
     auto queue = std::unique_ptr<SendQueue>(new SendQueue(socket, destination));
     
-    // Setup queue private thread
-    QThread* thread = new QThread;
-    thread->setObjectName("Networking: SendQueue " + destination.objectName()); // Name thread for easier debug
-    
-    connect(thread, &QThread::started, queue.get(), &SendQueue::run);
-    
-    connect(queue.get(), &QObject::destroyed, thread, &QThread::quit); // Thread auto cleanup
-    connect(thread, &QThread::finished, thread, &QThread::deleteLater); // Thread auto cleanup
-    
-    // Move queue to private thread and start it
-    queue->moveToThread(thread);
-    
-    thread->start();
+    // the queue doesn't get a thread of its own, it is serviced by the shared scheduler threads
+    SendQueueScheduler::getInstance().add(queue.get());
     
     return queue;
 }
@@ -80,35 +44,35 @@ SendQueue::SendQueue(Socket* socket, HifiSockAddr dest) :
 {
 }
 
+SendQueue::~SendQueue() {
+    // make sure the scheduler is done with us before we go away
+    SendQueueScheduler::getInstance().remove(this);
+}
+
+void SendQueue::wake() {
+    SendQueueScheduler::getInstance().wake(this);
+}
+
 void SendQueue::queuePacket(std::unique_ptr<Packet> packet) {
     _packets.queuePacket(std::move(packet));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wake();
 }
 
 void SendQueue::queuePacketList(std::unique_ptr<PacketList> packetList) {
     _packets.queuePacketList(std::move(packetList));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wake();
 }
 
 void SendQueue::stop() {
     
     _state = State::Stopped;
     
-    // Notify all conditions in case we're waiting somewhere
-    _handshakeACKCondition.notify_one();
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting somewhere, so the scheduler sees it has stopped
+    wake();
 }
     
 void SendQueue::sendPacket(const Packet& packet) {
@@ -153,11 +117,11 @@ void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
         _naks.insert(start, end);
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
-void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
+void SendQueue::overrideNAKListFromPacket(ControlPacket& packet, qint64 lossListSize) {
     // this is a response from the client, re-set our timeout expiry
     _timeoutExpiryCount = 0;
     _lastReceiverResponse = uint64_t(QDateTime::currentMSecsSinceEpoch());
@@ -165,45 +129,24 @@ void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
     {
         std::lock_guard<std::mutex> nakLocker(_naksLock);
         _naks.clear();
-        
-        SequenceNumber first, second;
-        while (packet.bytesLeftToRead() >= (qint64)(2 * sizeof(SequenceNumber))) {
-            packet.readPrimitive(&first);
-            packet.readPrimitive(&second);
-            
-            if (first == second) {
-                _naks.append(first);
-            } else {
-                _naks.append(first, second);
-            }
-        }
+        _naks.read(packet, lossListSize);
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::sendHandshake() {
-    std::unique_lock<std::mutex> handshakeLock { _handshakeMutex };
-    if (!_hasReceivedHandshakeACK) {
-        // we haven't received a handshake ACK from the client, send another now
-        static const auto handshakePacket = ControlPacket::create(ControlPacket::Handshake, 0);
-        _socket->writeBasePacket(*handshakePacket, _destination);
-        
-        // we wait for the ACK or the re-send interval to expire
-        static const auto HANDSHAKE_RESEND_INTERVAL = std::chrono::milliseconds(100);
-        _handshakeACKCondition.wait_for(handshakeLock, HANDSHAKE_RESEND_INTERVAL);
-    }
+    // we haven't received a handshake ACK from the client, send another now
+    static const auto handshakePacket = ControlPacket::create(ControlPacket::Handshake, 0);
+    _socket->writeBasePacket(*handshakePacket, _destination);
 }
 
 void SendQueue::handshakeACK() {
-    {
-        std::lock_guard<std::mutex> locker { _handshakeMutex };
-        _hasReceivedHandshakeACK = true;
-    }
+    _hasReceivedHandshakeACK = true;
     
-    // Notify on the handshake ACK condition
-    _handshakeACKCondition.notify_one();
+    // wake the queue so it can start sending
+    wake();
 }
 
 SequenceNumber SendQueue::getNextSequenceNumber() {
@@ -216,9 +159,11 @@ void SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     newPacket->writeSequenceNumber(sequenceNumber);
     sendPacket(*newPacket);
     
-    // Save packet/payload size before we move it
+    // Save packet/payload size and the time it waited in the queue before we move it
     auto packetSize = newPacket->getDataSize();
     auto payloadSize = newPacket->getPayloadSize();
+    auto now = usecTimestampNow();
+    quint64 queueLatency = (now > newPacket->getQueueTime()) ? now - newPacket->getQueueTime() : 0;
     
     {
         // Insert the packet we have just sent in the sent list
@@ -227,65 +172,69 @@ void SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     }
     Q_ASSERT_X(!newPacket, "SendQueue::sendNewPacketAndAddToSentList()", "Overriden packet in sent list");
     
-    emit packetSent(packetSize, payloadSize);
+    emit packetSent(packetSize, payloadSize, queueLatency);
 }
 
-void SendQueue::run() {
+uint64_t SendQueue::service(uint64_t now) {
     if (_state == State::Stopped) {
-        // we've already been asked to stop before we even got a chance to start
-        // don't start now
-#ifdef UDT_CONNECTION_DEBUG
-        qDebug() << "SendQueue asked to run after being told to stop. Will not run.";
-#endif
-        return;
-    } else if (_state == State::Running) {
-#ifdef UDT_CONNECTION_DEBUG
-        qDebug() << "SendQueue asked to run but is already running (according to state). Will not re-run.";
-#endif
-        return;
+        // we've been asked to stop, the scheduler doesn't need to come back to us
+        return 0;
     }
     
     _state = State::Running;
     
-    // Wait for handshake to be complete
-    while (_state == State::Running && !_hasReceivedHandshakeACK) {
-        sendHandshake();
-
-        // Keep processing events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // Once we're here we've either received the handshake ACK or it's going to be time to re-send a handshake.
-        // Either way let's continue processing - no packets will be sent if no handshake ACK has been received.
-    }
-        
-    while (_state == State::Running) {
-        // Record how long the loop takes to execute
-        const auto loopStartTimestamp = p_high_resolution_clock::now();
+    if (!_hasReceivedHandshakeACK) {
+        // re-send the handshake every interval until we get the ACK - no packets will be sent until then
+        static const uint64_t HANDSHAKE_RESEND_INTERVAL_USECS = 100 * USECS_PER_MSEC;
         
-        bool sentAPacket = maybeResendPacket();
+        if (now >= _nextHandshakeTime) {
+            sendHandshake();
+            _nextHandshakeTime = now + HANDSHAKE_RESEND_INTERVAL_USECS;
+        }
         
+        return _nextHandshakeTime;
+    }
+    
+    // don't let a late wake up turn into an unbounded burst, we forget about time we could not use
+    const uint64_t earliestPacketTime = now > SendQueueScheduler::RESOLUTION_USECS
+        ? now - SendQueueScheduler::RESOLUTION_USECS : 0;
+    _nextPacketTime = std::max(_nextPacketTime, earliestPacketTime);
+    
+    // if we were woken late we send what was due since, but only up to a bounded number of packets per service
+    // so that one queue can't hold on to a scheduler thread
+    static const int MAX_PACKETS_PER_SERVICE = 32;
+    int numPacketsSent = 0;
+    
+    while (_state == State::Running && _nextPacketTime <= now && numPacketsSent < MAX_PACKETS_PER_SERVICE) {
         // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
         // (this is according to the current flow window size) then we send out a new packet
-        if (!sentAPacket) {
-            sentAPacket = maybeSendNewPacket();
-        }
-        
-        // since we're a while loop, give the thread a chance to process events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // we just processed events so check now if we were just told to stop
-        // If the send queue has been innactive, skip the sleep for
-        // Either _isRunning will have been set to false and we'll break
-        // Or something happened and we'll keep going
-        if (_state != State::Running || isInactive(sentAPacket)) {
-            return;
+        if (!maybeResendPacket() && !maybeSendNewPacket()) {
+            break;
         }
         
-        // sleep as long as we need until next packet send, if we can
-        const auto loopEndTimestamp = p_high_resolution_clock::now();
-        const auto timeToSleep = (loopStartTimestamp + std::chrono::microseconds(_packetSendPeriod)) - loopEndTimestamp;
-        std::this_thread::sleep_for(timeToSleep);
+        ++numPacketsSent;
+        _nextPacketTime += _packetSendPeriod;
+    }
+    
+    if (_state != State::Running) {
+        return 0;
+    }
+    
+    if (numPacketsSent > 0) {
+        // we're sending, whatever we were waiting on is over
+        _waitReason = WaitReason::None;
+        return std::max(_nextPacketTime, now);
     }
+    
+    // we had nothing to send, the next packet can go as soon as there is one
+    _nextPacketTime = now;
+    
+    uint64_t nextServiceTime = 0;
+    if (isInactive(now, nextServiceTime)) {
+        return 0;
+    }
+    
+    return nextServiceTime;
 }
 
 bool SendQueue::maybeSendNewPacket() {
@@ -380,87 +329,88 @@ bool SendQueue::maybeResendPacket() {
     return false;
 }
 
-bool SendQueue::isInactive(bool sentAPacket) {
-    if (!sentAPacket) {
-        // check if it is time to break this connection
+bool SendQueue::isInactive(uint64_t now, uint64_t& nextServiceTime) {
+    // We didn't send any packets, check if it is time to break this connection
+    
+    // that will be the case if we have had 16 timeouts since hearing back from the client, and it has been
+    // at least 5 seconds
+    static const int NUM_TIMEOUTS_BEFORE_INACTIVE = 16;
+    static const int MIN_SECONDS_BEFORE_INACTIVE_MS = 5 * 1000;
+    if (_timeoutExpiryCount >= NUM_TIMEOUTS_BEFORE_INACTIVE &&
+        (QDateTime::currentMSecsSinceEpoch() - _lastReceiverResponse) > MIN_SECONDS_BEFORE_INACTIVE_MS) {
+        // If the flow window has been full for over CONSIDER_INACTIVE_AFTER,
+        // then signal the queue is inactive and return so it can be cleaned up
         
-        // that will be the case if we have had 16 timeouts since hearing back from the client, and it has been
-        // at least 5 seconds
-        static const int NUM_TIMEOUTS_BEFORE_INACTIVE = 16;
-        static const int MIN_SECONDS_BEFORE_INACTIVE_MS = 5 * 1000;
-        if (_timeoutExpiryCount >= NUM_TIMEOUTS_BEFORE_INACTIVE &&
-            (QDateTime::currentMSecsSinceEpoch() - _lastReceiverResponse) > MIN_SECONDS_BEFORE_INACTIVE_MS) {
-            // If the flow window has been full for over CONSIDER_INACTIVE_AFTER,
-            // then signal the queue is inactive and return so it can be cleaned up
-            
 #ifdef UDT_CONNECTION_DEBUG
-            qCDebug(networking) << "SendQueue to" << _destination << "reached" << NUM_TIMEOUTS_BEFORE_INACTIVE << "timeouts"
-            << "and 5s before receiving any ACK/NAK and is now inactive. Stopping.";
+        qCDebug(networking) << "SendQueue to" << _destination << "reached" << NUM_TIMEOUTS_BEFORE_INACTIVE << "timeouts"
+        << "and 5s before receiving any ACK/NAK and is now inactive. Stopping.";
+#endif
+        
+        deactivate();
+        return true;
+    }
+    
+    bool hasLosses = false;
+    {
+        std::lock_guard<std::mutex> nakLocker(_naksLock);
+        hasLosses = !_naks.isEmpty();
+    }
+    
+    if (!_packets.isEmpty() || hasLosses) {
+        // we have something to send but couldn't (likely the flow window is full), try again next period.
+        // Anything queued or NAKed after our check wakes us again, so there is no wait to track here
+        _waitReason = WaitReason::None;
+        nextServiceTime = now + std::max(_packetSendPeriod.load(), 1);
+        return false;
+    }
+    
+    if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
+        // we've sent the client as much data as we have (and they've ACKed it)
+        // either wait for new data to send or 5 seconds before cleaning up the queue
+        static const uint64_t EMPTY_QUEUES_INACTIVE_TIMEOUT_USECS = 5 * USECS_PER_SECOND;
+        
+        if (_waitReason != WaitReason::Empty) {
+            _waitReason = WaitReason::Empty;
+            _waitDeadline = now + EMPTY_QUEUES_INACTIVE_TIMEOUT_USECS;
+        } else if (now >= _waitDeadline) {
+#ifdef UDT_CONNECTION_DEBUG
+            qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
+            << EMPTY_QUEUES_INACTIVE_TIMEOUT_USECS / USECS_PER_SECOND
+            << "seconds and receiver has ACKed all packets."
+            << "The queue is now inactive and will be stopped.";
 #endif
             
+            // Deactivate queue
             deactivate();
             return true;
         }
-        
-        // During our processing above we didn't send any packets
-        
-        // If that is still the case we should use a condition_variable_any to sleep until we have data to handle.
-        // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock
-        using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
-        DoubleLock doubleLock(_packets.getLock(), _naksLock);
-        DoubleLock::Lock locker(doubleLock, std::try_to_lock);
-        
-        if (locker.owns_lock() && _packets.isEmpty() && _naks.isEmpty()) {
-            // The packets queue and loss list mutexes are now both locked and they're both empty
+    } else {
+        // We think the client is still waiting for data (based on the sequence number gap)
+        // Let's wait either for a response from the client or until the estimated timeout
+        // (plus the time the client can hold back its ACK at low data rates) has elapsed
+        if (_waitReason != WaitReason::ACK) {
+            _waitReason = WaitReason::ACK;
+            _waitDeadline = now + _estimatedTimeout + _syncInterval * MAX_ACK_DELAY_SYN_INTERVALS;
+        } else if (now >= _waitDeadline) {
+            // increase the number of timeouts
+            ++_timeoutExpiryCount;
+            _waitReason = WaitReason::None;
             
-            if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
-                // we've sent the client as much data as we have (and they've ACKed it)
-                // either wait for new data to send or 5 seconds before cleaning up the queue
-                static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, EMPTY_QUEUES_INACTIVE_TIMEOUT);
-                
-                // we have the lock again - Make sure to unlock it
-                locker.unlock();
-                
-                if (cvStatus == std::cv_status::timeout) {
-#ifdef UDT_CONNECTION_DEBUG
-                    qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
-                    << EMPTY_QUEUES_INACTIVE_TIMEOUT.count()
-                    << "seconds and receiver has ACKed all packets."
-                    << "The queue is now inactive and will be stopped.";
-#endif
-                    
-                    // Deactivate queue
-                    deactivate();
-                    return true;
-                }
-            } else {
-                // We think the client is still waiting for data (based on the sequence number gap)
-                // Let's wait either for a response from the client or until the estimated timeout
-                // (plus the sync interval to allow the client to respond) has elapsed
-                auto waitDuration = std::chrono::microseconds(_estimatedTimeout + _syncInterval);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, waitDuration);
-                
-                if (cvStatus == std::cv_status::timeout) {
-                    // increase the number of timeouts
-                    ++_timeoutExpiryCount;
-                    
-                    if (SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
-                        // after a timeout if we still have sent packets that the client hasn't ACKed we
-                        // add them to the loss list
-                        
-                        // Note that thanks to the DoubleLock we have the _naksLock right now
-                        _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
-                    }
-                }
+            if (SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
+                // after a timeout if we still have sent packets that the client hasn't ACKed we
+                // add them to the loss list
+                std::lock_guard<std::mutex> nakLocker(_naksLock);
+                _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
             }
+            
+            // come right back to re-send what was lost
+            nextServiceTime = now;
+            return false;
         }
     }
     
+    // sleep until the wait expires, we'll be woken earlier if packets are queued or the receiver responds
+    nextServiceTime = _waitDeadline;
     return false;
 }
 
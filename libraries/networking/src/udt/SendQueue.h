@@ -13,7 +13,6 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -52,6 +51,8 @@ public:
     
     static std::unique_ptr<SendQueue> create(Socket* socket, HifiSockAddr destination);
     
+    virtual ~SendQueue();
+    
     void queuePacket(std::unique_ptr<Packet> packet);
     void queuePacketList(std::unique_ptr<PacketList> packetList);
 
@@ -70,23 +71,34 @@ public slots:
     
     void ack(SequenceNumber ack);
     void nak(SequenceNumber start, SequenceNumber end);
-    void overrideNAKListFromPacket(ControlPacket& packet);
+    void overrideNAKListFromPacket(ControlPacket& packet, qint64 lossListSize);
     void handshakeACK();
 
 signals:
-    void packetSent(int dataSize, int payloadSize);
+    void packetSent(int dataSize, int payloadSize, quint64 queueLatency);
     void packetRetransmitted();
     
     void queueInactive();
     
-private slots:
-    void run();
-    
 private:
+    friend class SendQueueScheduler;
+    
+    enum class WaitReason {
+        None,
+        Empty, // everything was sent and ACKed, waiting for new packets
+        ACK // waiting on the receiver to ACK/NAK what we have sent
+    };
+    
     SendQueue(Socket* socket, HifiSockAddr dest);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
+    // Called by the SendQueueScheduler when the queue is due, returns the time (in usecs) it next needs to be
+    // serviced or 0 if it no longer needs to be
+    uint64_t service(uint64_t now);
+    
+    void wake(); // asks the scheduler to service the queue as soon as possible
+    
     void sendHandshake();
     
     void sendPacket(const Packet& packet);
@@ -95,7 +107,7 @@ private:
     bool maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool sentAPacket);
+    bool isInactive(uint64_t now, uint64_t& nextServiceTime);
     void deactivate(); // makes the queue inactive and cleans it up
     
     // Increments current sequence number and return it
@@ -127,11 +139,13 @@ private:
     mutable QReadWriteLock _sentLock; // Protects the sent packet list
     std::unordered_map<SequenceNumber, std::unique_ptr<Packet>> _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
     
-    std::condition_variable_any _emptyCondition;
+    // the following are only touched from service, which is never run concurrently for the same queue
+    uint64_t _nextHandshakeTime { 0 }; // Time at which we re-send the handshake if it still hasn't been ACKed
+    uint64_t _nextPacketTime { 0 }; // Time at which the next packet is due, following the packet send period
+    WaitReason _waitReason { WaitReason::None };
+    uint64_t _waitDeadline { 0 }; // Time at which the current wait expires
 };
     
 }
@@ -0,0 +1,206 @@
+//
+//  SendQueueScheduler.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueueScheduler.h"
+
+#include <algorithm>
+
+#include <PortableHighResolutionClock.h>
+
+#include "SendQueue.h"
+
+using namespace udt;
+
+static const int MAX_NUM_SCHEDULER_THREADS = 4;
+
+SendQueueScheduler& SendQueueScheduler::getInstance() {
+    // half of the cores is plenty, sending is mostly waiting on the pacing of each queue
+    static SendQueueScheduler instance(std::max(1, std::min((int) std::thread::hardware_concurrency() / 2,
+                                                            MAX_NUM_SCHEDULER_THREADS)));
+    return instance;
+}
+
+uint64_t SendQueueScheduler::now() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+}
+
+SendQueueScheduler::SendQueueScheduler(int numThreads) :
+    _slots(NUM_SLOTS)
+{
+    _currentTick = now() / RESOLUTION_USECS;
+
+    for (int i = 0; i < numThreads; ++i) {
+        _threads.emplace_back(&SendQueueScheduler::run, this);
+    }
+}
+
+SendQueueScheduler::~SendQueueScheduler() {
+    {
+        std::lock_guard<std::mutex> locker(_mutex);
+        _isStopping = true;
+    }
+    _workCondition.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void SendQueueScheduler::add(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> locker(_mutex);
+        schedule(queue, _queues[queue], 0);
+    }
+    _workCondition.notify_one();
+}
+
+void SendQueueScheduler::wake(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> locker(_mutex);
+
+        auto it = _queues.find(queue);
+        if (it == _queues.end()) {
+            return;
+        }
+
+        QueueState& state = it->second;
+        if (state.isServicing) {
+            // the thread servicing it will put it straight back in the ready list
+            state.wasWokenWhileServicing = true;
+            return;
+        }
+
+        if (state.isScheduled && state.deadlineTick < _currentTick) {
+            // already due
+            return;
+        }
+
+        schedule(queue, state, 0);
+    }
+    _workCondition.notify_one();
+}
+
+void SendQueueScheduler::remove(SendQueue* queue) {
+    std::unique_lock<std::mutex> locker(_mutex);
+
+    auto it = _queues.find(queue);
+    if (it == _queues.end()) {
+        return;
+    }
+
+    _servicedCondition.wait(locker, [&]{ return !_queues[queue].isServicing; });
+
+    // any entries left in the wheel are now stale
+    _queues.erase(queue);
+}
+
+void SendQueueScheduler::schedule(SendQueue* queue, QueueState& state, uint64_t time) {
+    Entry entry { queue, _nextGeneration++, time / RESOLUTION_USECS };
+
+    state.generation = entry.generation;
+    state.deadlineTick = entry.deadlineTick;
+    state.isScheduled = true;
+
+    if (entry.deadlineTick < _currentTick) {
+        _readyEntries.push_back(entry);
+    } else {
+        _slots[entry.deadlineTick % NUM_SLOTS].push_back(entry);
+        ++_numWheelEntries;
+    }
+}
+
+void SendQueueScheduler::advanceWheel(uint64_t nowTick) {
+    if (nowTick >= _currentTick + NUM_SLOTS) {
+        // we fell more than a whole turn behind, every slot only needs to be visited once
+        _currentTick = nowTick - NUM_SLOTS + 1;
+    }
+
+    for (; _currentTick <= nowTick && _numWheelEntries > 0; ++_currentTick) {
+        auto& slot = _slots[_currentTick % NUM_SLOTS];
+
+        // entries with a later deadline are for a later turn of the wheel
+        auto due = std::stable_partition(slot.begin(), slot.end(), [nowTick](const Entry& entry) {
+            return entry.deadlineTick > nowTick;
+        });
+
+        _numWheelEntries -= (int) (slot.end() - due);
+        _readyEntries.insert(_readyEntries.end(), due, slot.end());
+        slot.erase(due, slot.end());
+    }
+
+    _currentTick = std::max(_currentTick, nowTick + 1);
+}
+
+uint64_t SendQueueScheduler::getNextDeadlineTick() const {
+    // the first slot with an entry has the earliest deadline unless all of its entries are for later turns,
+    // in which case we wake up early, find nothing due and look again
+    for (int i = 0; i < NUM_SLOTS; ++i) {
+        uint64_t tick = _currentTick + i;
+        if (!_slots[tick % NUM_SLOTS].empty()) {
+            return tick;
+        }
+    }
+
+    return _currentTick + NUM_SLOTS;
+}
+
+void SendQueueScheduler::run() {
+    std::unique_lock<std::mutex> locker(_mutex);
+
+    while (!_isStopping) {
+        advanceWheel(now() / RESOLUTION_USECS);
+
+        if (_readyEntries.empty()) {
+            if (_numWheelEntries > 0) {
+                auto wakeTime = std::chrono::microseconds(getNextDeadlineTick() * RESOLUTION_USECS);
+                _workCondition.wait_until(locker, p_high_resolution_clock::time_point(wakeTime));
+            } else {
+                _workCondition.wait(locker);
+            }
+            continue;
+        }
+
+        Entry entry = _readyEntries.front();
+        _readyEntries.pop_front();
+
+        auto it = _queues.find(entry.queue);
+        if (it == _queues.end() || it->second.generation != entry.generation || it->second.isServicing) {
+            // this queue was removed or rescheduled since this entry was made
+            continue;
+        }
+
+        QueueState& state = it->second;
+        state.isScheduled = false;
+        state.isServicing = true;
+        state.wasWokenWhileServicing = false;
+
+        // let another thread pick up the rest of the ready queues
+        if (!_readyEntries.empty()) {
+            _workCondition.notify_one();
+        }
+
+        locker.unlock();
+        uint64_t nextServiceTime = entry.queue->service(now());
+        locker.lock();
+
+        // the queue can't have been removed, remove waits for us
+        QueueState& servicedState = _queues[entry.queue];
+        servicedState.isServicing = false;
+
+        if (servicedState.wasWokenWhileServicing) {
+            schedule(entry.queue, servicedState, 0);
+        } else if (nextServiceTime > 0) {
+            schedule(entry.queue, servicedState, nextServiceTime);
+        }
+
+        _servicedCondition.notify_all();
+    }
+}
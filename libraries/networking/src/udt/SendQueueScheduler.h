@@ -0,0 +1,94 @@
+//
+//  SendQueueScheduler.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendQueueScheduler_h
+#define hifi_SendQueueScheduler_h
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace udt {
+
+class SendQueue;
+
+/// Drives every SendQueue from a small fixed pool of threads, so the number of threads does not grow with the
+/// number of connections. Queues are kept in a timer wheel keyed on the time they next need to be serviced
+/// (their next packet send time, handshake re-send or timeout) and a queue is only ever serviced by one thread at a time.
+class SendQueueScheduler {
+public:
+    // time covered by one slot of the wheel, queues due within the same slot are serviced together
+    static const uint64_t RESOLUTION_USECS = 100;
+    static const int NUM_SLOTS = 1024;
+
+    static SendQueueScheduler& getInstance();
+
+    static uint64_t now();
+
+    ~SendQueueScheduler();
+
+    /// starts servicing the queue right away
+    void add(SendQueue* queue);
+
+    /// services the queue as soon as possible, whether or not it is due
+    void wake(SendQueue* queue);
+
+    /// stops servicing the queue, waits for a thread that is servicing it to be done with it
+    void remove(SendQueue* queue);
+
+    int getNumThreads() const { return (int) _threads.size(); }
+
+private:
+    struct Entry {
+        SendQueue* queue;
+        uint64_t generation;
+        uint64_t deadlineTick;
+    };
+
+    struct QueueState {
+        uint64_t generation { 0 }; // entries of an older generation are stale and skipped
+        uint64_t deadlineTick { 0 };
+        bool isScheduled { false };
+        bool isServicing { false };
+        bool wasWokenWhileServicing { false };
+    };
+
+    SendQueueScheduler(int numThreads);
+
+    void run();
+
+    // all of these expect _mutex to be held
+    void schedule(SendQueue* queue, QueueState& state, uint64_t time);
+    void advanceWheel(uint64_t nowTick);
+    uint64_t getNextDeadlineTick() const;
+
+    std::mutex _mutex;
+    std::condition_variable _workCondition;
+    std::condition_variable _servicedCondition;
+
+    std::unordered_map<SendQueue*, QueueState> _queues;
+    std::vector<std::vector<Entry>> _slots;
+    std::deque<Entry> _readyEntries;
+    int _numWheelEntries { 0 };
+
+    uint64_t _currentTick { 0 }; // the next tick of the wheel that has not been visited
+    uint64_t _nextGeneration { 1 };
+
+    bool _isStopping { false };
+    std::vector<std::thread> _threads;
+};
+
+}
+
+#endif // hifi_SendQueueScheduler_h
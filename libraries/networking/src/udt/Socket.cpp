@@ -11,9 +11,14 @@
 
 #include "Socket.h"
 
+#include <algorithm>
+
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QThread>
 
 #include <LogHandler.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 #include "../NetworkLogging.h"
 #include "Connection.h"
@@ -24,26 +29,92 @@
 
 using namespace udt;
 
+// partial groups are closed after this long so that a lost packet is not waiting on parity that never comes
+static const quint64 MAX_FEC_GROUP_AGE_USECS = 40 * 1000;
+
 Socket::Socket(QObject* parent) :
     QObject(parent),
-    _synTimer(new QTimer(this))
+    _synTimer(new QTimer(this)),
+    _shapingTimer(new QTimer(this))
 {
     connect(&_udpSocket, &QUdpSocket::readyRead, this, &Socket::readPendingDatagrams);
+
+    if (QProcessEnvironment::systemEnvironment().contains(UDT_USE_QT_SOCKET_ENV)) {
+        _shouldUseNativeSocket = false;
+    }
     
     // make sure our synchronization method is called every SYN interval
     connect(_synTimer, &QTimer::timeout, this, &Socket::rateControlSync);
     
     // start our timer for the synchronization time interval
     _synTimer->start(_synInterval);
+    
+    // the shaped datagrams are released as they come due, the delays are often under a millisecond apart
+    _shapingTimer->setSingleShot(true);
+    _shapingTimer->setTimerType(Qt::PreciseTimer);
+    connect(_shapingTimer, &QTimer::timeout, this, &Socket::releaseShapedDatagrams);
+}
+
+void Socket::bind(const QHostAddress& address, quint16 port) {
+    _udpSocket.bind(address, port);
+    setSystemBufferSizes();
+    setupNativeSocket();
+    
+    QString capturePath = QProcessEnvironment::systemEnvironment().value(UDT_CAPTURE_FILE_ENV);
+    if (!capturePath.isEmpty() && !_captureWriter.isOpen() && startCapture(capturePath + "." + QString::number(localPort()))) {
+        qCDebug(networking) << "Capturing the datagrams received on port" << localPort();
+    }
 }
 
 void Socket::rebind() {
     quint16 oldPort = _udpSocket.localPort();
     
+    // the duplicate descriptor would keep the old port bound
+    closeNativeSocket();
+    
     _udpSocket.close();
     bind(QHostAddress::AnyIPv4, oldPort);
 }
 
+void Socket::setUseNativeSocket(bool useNativeSocket) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "setUseNativeSocket", Qt::BlockingQueuedConnection,
+                                  Q_ARG(bool, useNativeSocket));
+        return;
+    }
+    
+    _shouldUseNativeSocket = useNativeSocket && NativeSocket::isSupported();
+    setupNativeSocket();
+}
+
+void Socket::setupNativeSocket() {
+    closeNativeSocket();
+    
+    if (!_shouldUseNativeSocket || _udpSocket.state() != QAbstractSocket::BoundState) {
+        return;
+    }
+    
+    if (_nativeSocket.open(_udpSocket.socketDescriptor())) {
+        // the QUdpSocket stops notifying once readyRead goes unanswered by readDatagram, so watch the duplicate
+        _nativeReadNotifier = new QSocketNotifier(_nativeSocket.getDescriptor(), QSocketNotifier::Read, this);
+        connect(_nativeReadNotifier, &QSocketNotifier::activated, this, &Socket::readPendingDatagrams);
+        
+        qCDebug(networking) << "Using batched native datagram I/O on port" << _udpSocket.localPort();
+    } else {
+        qCDebug(networking) << "Could not set up batched native datagram I/O -" << qPrintable(_nativeSocket.getErrorString())
+            << "- falling back to QUdpSocket";
+    }
+}
+
+void Socket::closeNativeSocket() {
+    if (_nativeReadNotifier) {
+        delete _nativeReadNotifier;
+        _nativeReadNotifier = nullptr;
+    }
+    
+    _nativeSocket.close();
+}
+
 void Socket::setSystemBufferSizes() {
     for (int i = 0; i < 2; i++) {
         QAbstractSocket::SocketOption bufferOpt;
@@ -94,7 +165,11 @@ qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
     // write the correct sequence number to the Packet here
     packet.writeSequenceNumber(++_unreliableSequenceNumbers[sockAddr]);
     
-    return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+    qint64 bytesWritten = writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+    
+    protectPacket(packet, sockAddr);
+    
+    return bytesWritten;
 }
 
 qint64 Socket::writePacket(std::unique_ptr<Packet> packet, const HifiSockAddr& sockAddr) {
@@ -134,6 +209,35 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
     }
 
     // Unerliable and Unordered
+    if (_nativeSocket.isOpen()) {
+        // hand every packet of the list to the system at once
+        std::vector<std::unique_ptr<Packet>> packets;
+        std::vector<NativeSocket::Datagram> datagrams;
+        packets.reserve(packetList->_packets.size());
+        datagrams.reserve(packetList->_packets.size());
+        
+        while (!packetList->_packets.empty()) {
+            auto packet = packetList->takeFront<Packet>();
+            
+            // write the correct sequence number to the Packet here
+            packet->writeSequenceNumber(++_unreliableSequenceNumbers[sockAddr]);
+            
+            datagrams.emplace_back(packet->getData(), packet->getDataSize());
+            packets.push_back(std::move(packet));
+        }
+        
+        qint64 bytesWritten = _nativeSocket.writeDatagrams(datagrams, sockAddr);
+        if (bytesWritten < 0) {
+            qCDebug(networking) << "Socket::writePacketList" << qPrintable(_nativeSocket.getErrorString());
+        }
+        
+        for (auto& packet : packets) {
+            protectPacket(*packet, sockAddr);
+        }
+        
+        return bytesWritten;
+    }
+    
     qint64 totalBytesSent = 0;
     while (!packetList->_packets.empty()) {
         totalBytesSent += writePacket(packetList->takeFront<Packet>(), sockAddr);
@@ -142,6 +246,85 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
     return totalBytesSent;
 }
 
+void Socket::setForwardErrorCorrection(PacketFilterOperator filterOperator, int groupSize, int numParityPackets) {
+    std::lock_guard<std::mutex> locker(_fecLock);
+    
+    _fecFilterOperator = filterOperator;
+    _fecGroupSize = std::max(groupSize, 0);
+    _fecNumParityPackets = numParityPackets;
+    
+    // groups in progress were started with the old settings
+    _fecEncoders.clear();
+}
+
+void Socket::protectPacket(const Packet& packet, const HifiSockAddr& sockAddr) {
+    if (_fecGroupSize == 0) {
+        return;
+    }
+    
+    FECEncoder::ParityPackets parityPackets;
+    
+    {
+        std::lock_guard<std::mutex> locker(_fecLock);
+        
+        if (_fecGroupSize == 0 || !_fecFilterOperator || !_fecFilterOperator(packet)) {
+            return;
+        }
+        
+        auto& encoder = _fecEncoders[sockAddr];
+        if (!encoder) {
+            encoder.reset(new FECEncoder(_fecGroupSize, _fecNumParityPackets));
+        }
+        
+        if (!encoder->canProtect(packet)) {
+            return;
+        }
+        
+        parityPackets = encoder->addPacket(packet);
+    }
+    
+    for (auto& parityPacket : parityPackets) {
+        writeBasePacket(*parityPacket, sockAddr);
+    }
+}
+
+void Socket::flushStaleForwardErrorCorrectionGroups() {
+    if (_fecGroupSize == 0) {
+        return;
+    }
+    
+    std::vector<std::pair<HifiSockAddr, std::unique_ptr<ControlPacket>>> parityPackets;
+    
+    {
+        std::lock_guard<std::mutex> locker(_fecLock);
+        
+        quint64 now = usecTimestampNow();
+        
+        for (auto& encoderPair : _fecEncoders) {
+            auto& encoder = encoderPair.second;
+            
+            if (encoder->hasPendingGroup() && now - encoder->getGroupStartTime() >= MAX_FEC_GROUP_AGE_USECS) {
+                for (auto& parityPacket : encoder->flush()) {
+                    parityPackets.emplace_back(encoderPair.first, std::move(parityPacket));
+                }
+            }
+        }
+    }
+    
+    for (auto& parityPair : parityPackets) {
+        writeBasePacket(*parityPair.second, parityPair.first);
+    }
+}
+
+void Socket::startHandshake(const HifiSockAddr& sockAddr) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "startHandshake", Qt::QueuedConnection, Q_ARG(HifiSockAddr, sockAddr));
+        return;
+    }
+
+    findOrCreateConnection(sockAddr).startHandshake();
+}
+
 void Socket::writeReliablePacket(Packet* packet, const HifiSockAddr& sockAddr) {
     findOrCreateConnection(sockAddr).sendReliablePacket(std::unique_ptr<Packet>(packet));
 }
@@ -151,10 +334,53 @@ void Socket::writeReliablePacketList(PacketList* packetList, const HifiSockAddr&
 }
 
 qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
-    return writeDatagram(QByteArray::fromRawData(data, size), sockAddr);
+    if (!_nativeSocket.isOpen()) {
+        return writeDatagram(QByteArray::fromRawData(data, size), sockAddr);
+    }
+    
+    qint64 bytesWritten = _nativeSocket.writeDatagram(data, size, sockAddr);
+    
+    if (bytesWritten < 0) {
+        qCDebug(networking) << "Socket::writeDatagram" << qPrintable(_nativeSocket.getErrorString());
+    }
+    
+    return bytesWritten;
+}
+
+qint64 Socket::writeUnfragmentedDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    if (!_nativeSocket.isOpen()) {
+        return -1;
+    }
+    
+    qint64 bytesWritten = _nativeSocket.writeUnfragmentedDatagram(data, size, sockAddr);
+    
+    if (bytesWritten < 0) {
+        // a probe larger than the MTU of our own interface already fails here, that's an answer too
+        qCDebug(networking) << "Socket::writeUnfragmentedDatagram" << qPrintable(_nativeSocket.getErrorString());
+    }
+    
+    return bytesWritten;
+}
+
+int Socket::getMaxPacketSize(const HifiSockAddr& sockAddr) const {
+    std::lock_guard<std::mutex> locker(_maxPacketSizesLock);
+    auto it = _maxPacketSizes.find(sockAddr);
+    return it != _maxPacketSizes.end() ? it->second : MAX_PACKET_SIZE;
+}
+
+void Socket::setMaxPacketSize(const HifiSockAddr& sockAddr, int maxPacketSize) {
+    std::lock_guard<std::mutex> locker(_maxPacketSizesLock);
+    if (maxPacketSize > MAX_PACKET_SIZE) {
+        _maxPacketSizes[sockAddr] = maxPacketSize;
+    } else {
+        _maxPacketSizes.erase(sockAddr);
+    }
 }
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+    if (_nativeSocket.isOpen()) {
+        return writeDatagram(datagram.constData(), datagram.size(), sockAddr);
+    }
     
     qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
     
@@ -198,6 +424,16 @@ void Socket::clearConnections() {
     // clear all of the current connections in the socket
     qDebug() << "Clearing all remaining connections in Socket.";
     _connectionsHash.clear();
+    
+    {
+        std::lock_guard<std::mutex> locker(_maxPacketSizesLock);
+        _maxPacketSizes.clear();
+    }
+    
+    _fecDecoders.clear();
+    
+    std::lock_guard<std::mutex> locker(_fecLock);
+    _fecEncoders.clear();
 }
 
 void Socket::cleanupConnection(HifiSockAddr sockAddr) {
@@ -208,6 +444,14 @@ void Socket::cleanupConnection(HifiSockAddr sockAddr) {
         qCDebug(networking) << "Socket::cleanupConnection called for UDT connection to" << sockAddr;
 #endif
     }
+    
+    // a new connection probes the path again
+    setMaxPacketSize(sockAddr, MAX_PACKET_SIZE);
+    
+    _fecDecoders.erase(sockAddr);
+    
+    std::lock_guard<std::mutex> locker(_fecLock);
+    _fecEncoders.erase(sockAddr);
 }
 
 void Socket::messageReceived(std::unique_ptr<PacketList> packetList) {
@@ -216,68 +460,185 @@ void Socket::messageReceived(std::unique_ptr<PacketList> packetList) {
     }
 }
 
+void Socket::messagePacketReceived(std::unique_ptr<Packet> packet) {
+    if (_packetHandler) {
+        _packetHandler(std::move(packet));
+    }
+}
+
 void Socket::readPendingDatagrams() {
+    if (_nativeSocket.isOpen()) {
+        readPendingNativeDatagrams();
+        return;
+    }
+    
     int packetSizeWithHeader = -1;
     while ((packetSizeWithHeader = _udpSocket.pendingDatagramSize()) != -1) {
         // setup a HifiSockAddr to read into
         HifiSockAddr senderSockAddr;
         
         // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        auto buffer = PacketBufferPool::allocate(packetSizeWithHeader);
        
         // pull the datagram
         _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
                                 senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
         
-        auto it = _unfilteredHandlers.find(senderSockAddr);
-        
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                it->second(std::move(basePacket));
-            }
+        receiveDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+    }
+}
+
+void Socket::readPendingNativeDatagrams() {
+    int numDatagrams = 0;
+    
+    // a handler can switch us back to the QUdpSocket, so check that the native socket is still open for every batch
+    while (_nativeSocket.isOpen() && (numDatagrams = _nativeSocket.receiveBatch()) > 0) {
+        for (int i = 0; i < numDatagrams; ++i) {
+            qint64 datagramSize = _nativeSocket.getDatagramSize(i);
             
+            if (datagramSize >= 0) {
+                receiveDatagram(_nativeSocket.takeDatagram(i), datagramSize, _nativeSocket.getDatagramSender(i));
+            }
+        }
+        
+        if (numDatagrams < NativeSocket::MAX_DATAGRAMS_PER_BATCH) {
+            // a partial batch means the socket was drained
+            break;
+        }
+    }
+    
+    if (numDatagrams < 0) {
+        qCDebug(networking) << "Socket::readPendingNativeDatagrams" << qPrintable(_nativeSocket.getErrorString());
+    }
+}
+
+void Socket::setNetworkConditions(const NetworkConditions& conditions, uint32_t seed) {
+    _networkShaper.setConditions(conditions, seed);
+}
+
+void Socket::receiveDatagram(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr) {
+    if (_captureWriter.isOpen()) {
+        _captureWriter.addDatagram(buffer.get(), size, senderSockAddr, usecTimestampNow());
+    }
+    
+    if (!_networkShaper.isShaping()) {
+        processDatagram(std::move(buffer), size, senderSockAddr);
+        return;
+    }
+    
+    if (_networkShaper.addDatagram(std::move(buffer), size, senderSockAddr, usecTimestampNow())) {
+        releaseShapedDatagrams();
+    }
+}
+
+void Socket::releaseShapedDatagrams() {
+    _networkShaper.releaseDatagrams(usecTimestampNow(), [this](PacketBuffer buffer, qint64 size, const HifiSockAddr& sender) {
+        processDatagram(std::move(buffer), size, sender);
+    });
+    
+    quint64 nextReleaseTime = _networkShaper.getNextReleaseTime();
+    if (nextReleaseTime > 0) {
+        quint64 now = usecTimestampNow();
+        int msecsToRelease = nextReleaseTime > now ? (int)((nextReleaseTime - now + USECS_PER_MSEC - 1) / USECS_PER_MSEC) : 0;
+        _shapingTimer->start(msecsToRelease);
+    }
+}
+
+void Socket::processDatagram(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+    
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+            it->second(std::move(basePacket));
+        }
+        
+        return;
+    }
+    
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+    
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        
+        if (controlPacket->getType() == ControlPacket::FECParity) {
+            // parity for unreliable packets is handled here, there may not be a connection with this sender
+            processParityPacket(std::move(controlPacket));
             return;
         }
         
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        // move this control packet to the matching connection
+        auto& connection = findOrCreateConnection(senderSockAddr);
+        connection.processControl(move(controlPacket));
         
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            
-            // move this control packet to the matching connection
-            auto& connection = findOrCreateConnection(senderSockAddr);
-            connection.processControl(move(controlPacket));
-            
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto& connection = findOrCreateConnection(senderSockAddr);
-                    
-                    if (!connection.processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                  packet->getDataSize(),
-                                                                  packet->getPayloadSize())) {
-                        // the connection indicated that we should not continue processing this packet
-                        return;
-                    }
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto& connection = findOrCreateConnection(senderSockAddr);
+                
+                if (!connection.processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                              packet->getDataSize(),
+                                                              packet->getPayloadSize())) {
+                    // the connection indicated that we should not continue processing this packet
+                    return;
                 }
-
-                if (packet->isPartOfMessage()) {
-                    auto& connection = findOrCreateConnection(senderSockAddr);
-                    connection.queueReceivedMessagePacket(std::move(packet));
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+                
+                if (!packet->isPartOfMessage()) {
+                    // this goes to the handler right away, message packets are recorded when their message is
+                    connection.recordReceiveLatency(packet->getReceiveTime());
                 }
             }
+
+            if (packet->isPartOfMessage()) {
+                auto& connection = findOrCreateConnection(senderSockAddr);
+                connection.queueReceivedMessagePacket(std::move(packet));
+            } else if (!packet->isReliable() && !recordProtectedPacket(*packet)) {
+                // the packet was late and we already rebuilt it from parity
+                return;
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
+            }
+        }
+    }
+}
+
+bool Socket::recordProtectedPacket(const Packet& packet) {
+    auto it = _fecDecoders.find(packet.getSenderSockAddr());
+    
+    if (it == _fecDecoders.end()) {
+        // this sender has not sent us parity, so there is nothing to rebuild
+        return true;
+    }
+    
+    return it->second->addReceivedPacket(packet.getSequenceNumber(),
+                                         packet.getData() + Packet::localHeaderSize(),
+                                         packet.getDataSize() - Packet::localHeaderSize());
+}
+
+void Socket::processParityPacket(std::unique_ptr<ControlPacket> parityPacket) {
+    auto& decoder = _fecDecoders[parityPacket->getSenderSockAddr()];
+    if (!decoder) {
+        // start keeping the packets from this sender, this first parity packet cannot rebuild anything
+        decoder.reset(new FECDecoder());
+    }
+    
+    PacketBuffer buffer;
+    qint64 size = 0;
+    
+    if (decoder->recover(*parityPacket, buffer, size)) {
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, parityPacket->getSenderSockAddr());
+        
+        if ((!_packetFilterOperator || _packetFilterOperator(*packet)) && _packetHandler) {
+            _packetHandler(std::move(packet));
         }
     }
 }
@@ -289,6 +650,13 @@ void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* r
     }
 }
 
+void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* context, std::function<void()> functor) {
+    auto it = _connectionsHash.find(destinationAddr);
+    if (it != _connectionsHash.end()) {
+        connect(it->second.get(), &Connection::packetSent, context, functor);
+    }
+}
+
 void Socket::rateControlSync() {
     
     // enumerate our list of connections and ask each of them to send off periodic ACK packet for rate control
@@ -319,6 +687,8 @@ void Socket::rateControlSync() {
         }
     }
     
+    flushStaleForwardErrorCorrectionGroups();
+    
     if (_synTimer->interval() != _synInterval) {
         // if the _synTimer interval doesn't match the current _synInterval (changes when the CC factory is changed)
         // then restart it now with the right interval
@@ -14,16 +14,23 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 
 #include <QtCore/QObject>
+#include <QtCore/QSocketNotifier>
 #include <QtCore/QTimer>
 #include <QtNetwork/QUdpSocket>
 
 #include "../HifiSockAddr.h"
 #include "CongestionControl.h"
 #include "Connection.h"
+#include "ForwardErrorCorrection.h"
+#include "NativeSocket.h"
+#include "NetworkShaper.h"
+#include "PacketCapture.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -32,11 +39,18 @@ class UDTTest;
 namespace udt {
 
 class BasePacket;
+class ControlPacket;
 class ControlSender;
 class Packet;
 class PacketList;
 class SequenceNumber;
 
+// set this in the environment to keep all datagram I/O on the QUdpSocket where batched native I/O is supported
+const QString UDT_USE_QT_SOCKET_ENV = "HIFI_UDT_USE_QT_SOCKET";
+
+// set this in the environment to capture the datagrams every socket receives, to the path with its port appended
+const QString UDT_CAPTURE_FILE_ENV = "HIFI_UDT_CAPTURE_FILE";
+
 using PacketFilterOperator = std::function<bool(const Packet&)>;
 
 using BasePacketHandler = std::function<void(std::unique_ptr<BasePacket>)>;
@@ -60,8 +74,20 @@ public:
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
     
-    void bind(const QHostAddress& address, quint16 port = 0) { _udpSocket.bind(address, port); setSystemBufferSizes(); }
+    void bind(const QHostAddress& address, quint16 port = 0);
     void rebind();
+
+    bool isUsingNativeSocket() const { return _nativeSocket.isOpen(); }
+    
+    /// the path MTU can only be probed through the native socket, the QUdpSocket can't keep datagrams from being fragmented
+    bool canProbeMTU() const { return _nativeSocket.isOpen(); }
+    qint64 writeUnfragmentedDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+    
+    /// the largest packet, headers included, reliable messages to the address are cut into; the connection to the
+    /// address raises it from MAX_PACKET_SIZE once it found the path carries more. Unreliable packets are kept to
+    /// MAX_PACKET_SIZE, they are not worth losing several times the data for. Can be called from any thread
+    int getMaxPacketSize(const HifiSockAddr& sockAddr) const;
+    void setMaxPacketSize(const HifiSockAddr& sockAddr, int maxPacketSize);
     
     void setPacketFilterOperator(PacketFilterOperator filterOperator) { _packetFilterOperator = filterOperator; }
     void setPacketHandler(PacketHandler handler) { _packetHandler = handler; }
@@ -72,33 +98,83 @@ public:
     
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
 
+    // starts the handshake of the reliable connection to this address ahead of its first reliable packet
+    Q_INVOKABLE void startHandshake(const HifiSockAddr& sockAddr);
+
+    /// sends FECParity packets after every group of groupSize unreliable packets the filter accepts, so that receivers
+    /// can rebuild up to numParityPackets lost packets per group before they reach the packet handler
+    /// a groupSize of 0 turns forward error correction off
+    void setForwardErrorCorrection(PacketFilterOperator filterOperator, int groupSize, int numParityPackets);
+
     void messageReceived(std::unique_ptr<PacketList> packetList);
     
+    /// reliable messages the operator accepts are not reassembled, their packets go to the packet handler one by one,
+    /// in order, as soon as the packets before them have arrived
+    void setMessageStreamFilterOperator(PacketFilterOperator filterOperator)
+        { _messageStreamFilterOperator = filterOperator; }
+    bool shouldStreamMessage(const Packet& packet) const
+        { return _messageStreamFilterOperator && _messageStreamFilterOperator(packet); }
+    void messagePacketReceived(std::unique_ptr<Packet> packet);
+    
+    /// drops and delays the received datagrams as if they came over the given network, to measure the protocol
+    /// against it, only meant for tests and benchmarks
+    void setNetworkConditions(const NetworkConditions& conditions, uint32_t seed = NetworkShaper::DEFAULT_SEED);
+    int getNumShapingDroppedDatagrams() const { return _networkShaper.getNumDroppedDatagrams(); }
+    
+    /// records every received datagram to the file, for a replay of the session
+    bool startCapture(const QString& path) { return _captureWriter.open(path); }
+    void stopCapture() { _captureWriter.close(); }
+    
     StatsVector sampleStatsForAllConnections();
 
 public slots:
     void cleanupConnection(HifiSockAddr sockAddr);
     void clearConnections();
+
+    /// switches datagram I/O between batched native calls (where supported) and the QUdpSocket
+    void setUseNativeSocket(bool useNativeSocket);
     
 private slots:
     void readPendingDatagrams();
     void rateControlSync();
+    void releaseShapedDatagrams();
     
 private:
     void setSystemBufferSizes();
+    void setupNativeSocket();
+    void closeNativeSocket();
+    void receiveDatagram(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr);
+    void processDatagram(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr);
+    void readPendingNativeDatagrams();
     Connection& findOrCreateConnection(const HifiSockAddr& sockAddr);
+
+    // called with the sequence number already written, sends any parity packets the packet completes
+    void protectPacket(const Packet& packet, const HifiSockAddr& sockAddr);
+    void flushStaleForwardErrorCorrectionGroups();
+    void processParityPacket(std::unique_ptr<ControlPacket> parityPacket);
+
+    // keeps a copy of an unreliable packet from a sender that protects its packets, returns false for a duplicate
+    // of a packet that was already rebuilt from parity
+    bool recordProtectedPacket(const Packet& packet);
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
     ConnectionStats::Stats sampleStatsForConnection(const HifiSockAddr& destination);
     
     std::vector<HifiSockAddr> getConnectionSockAddrs();
     void connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* receiver, const char* slot);
+    void connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* context, std::function<void()> functor);
     
     Q_INVOKABLE void writeReliablePacket(Packet* packet, const HifiSockAddr& sockAddr);
     Q_INVOKABLE void writeReliablePacketList(PacketList* packetList, const HifiSockAddr& sockAddr);
     
     QUdpSocket _udpSocket { this };
+
+    // batched reads and writes on a duplicate of the _udpSocket descriptor, with its own read notifier
+    bool _shouldUseNativeSocket { NativeSocket::isSupported() };
+    NativeSocket _nativeSocket;
+    QSocketNotifier* _nativeReadNotifier { nullptr };
     PacketFilterOperator _packetFilterOperator;
+    PacketFilterOperator _messageStreamFilterOperator;
     PacketHandler _packetHandler;
     PacketListHandler _packetListHandler;
     
@@ -106,9 +182,26 @@ private:
     std::unordered_map<HifiSockAddr, SequenceNumber> _unreliableSequenceNumbers;
     std::unordered_map<HifiSockAddr, std::unique_ptr<Connection>> _connectionsHash;
     
+    // set by the connections on the Socket thread, read by every thread sending messages
+    mutable std::mutex _maxPacketSizesLock;
+    std::unordered_map<HifiSockAddr, int> _maxPacketSizes;
+
+    // the encoders are used by every thread writing unreliable packets, the decoders only on the Socket thread
+    std::mutex _fecLock;
+    PacketFilterOperator _fecFilterOperator;
+    std::atomic<int> _fecGroupSize { 0 };
+    int _fecNumParityPackets { 0 };
+    std::unordered_map<HifiSockAddr, std::unique_ptr<FECEncoder>> _fecEncoders;
+    std::unordered_map<HifiSockAddr, std::unique_ptr<FECDecoder>> _fecDecoders;
+    
     int _synInterval = 10; // 10ms
     QTimer* _synTimer;
     
+    NetworkShaper _networkShaper;
+    QTimer* _shapingTimer;
+    
+    PacketCaptureWriter _captureWriter;
+    
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<DefaultCC>() };
     
     friend UDTTest;
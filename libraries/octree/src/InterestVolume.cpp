@@ -0,0 +1,167 @@
+//
+//  InterestVolume.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include <NumericalConstants.h>
+
+#include "InterestVolume.h"
+
+InterestVolume::InterestVolume() :
+    _shape(SPHERE),
+    _bounds(glm::vec3(0.0f), 0.0f),
+    _radius(0.0f),
+    _priority(DEFAULT_INTEREST_PRIORITY)
+{
+}
+
+InterestVolume::InterestVolume(const glm::vec3& center, float radius, float priority) :
+    _shape(SPHERE),
+    _bounds(center - glm::vec3(glm::max(radius, 0.0f)), 2.0f * glm::max(radius, 0.0f)),
+    _radius(glm::max(radius, 0.0f)),
+    _priority(glm::max(priority, MIN_INTEREST_PRIORITY))
+{
+}
+
+InterestVolume::InterestVolume(const AABox& box, float priority) :
+    _shape(BOX),
+    _bounds(box),
+    _radius(0.5f * glm::length(box.getDimensions())),
+    _priority(glm::max(priority, MIN_INTEREST_PRIORITY))
+{
+}
+
+bool InterestVolume::contains(const glm::vec3& point) const {
+    if (_shape == BOX) {
+        return _bounds.contains(point);
+    }
+    return glm::distance(point, getCenter()) <= _radius;
+}
+
+bool InterestVolume::contains(const AABox& box) const {
+    if (_shape == BOX) {
+        return _bounds.contains(box);
+    }
+    // the corner of the box furthest from the center has to be in the sphere
+    glm::vec3 center = getCenter();
+    glm::vec3 furthest = glm::max(glm::abs(box.getMinimum() - center), glm::abs(box.getMaximum() - center));
+    return glm::length(furthest) <= _radius;
+}
+
+bool InterestVolume::touches(const AABox& box) const {
+    if (!_bounds.touches(box)) {
+        return false;
+    }
+    if (_shape == BOX) {
+        return true;
+    }
+    glm::vec3 center = getCenter();
+    glm::vec3 closest = glm::clamp(center, box.getMinimum(), box.getMaximum());
+    return glm::distance(closest, center) <= _radius;
+}
+
+bool InterestVolume::containsSphere(const glm::vec3& center, float radius) const {
+    if (_shape == BOX) {
+        return _bounds.contains(AABox(center - glm::vec3(radius), 2.0f * radius));
+    }
+    return glm::distance(center, getCenter()) + radius <= _radius;
+}
+
+bool InterestVolume::touchesSphere(const glm::vec3& center, float radius) const {
+    if (_shape == BOX) {
+        glm::vec3 closest = glm::clamp(center, _bounds.getMinimum(), _bounds.getMaximum());
+        return glm::distance(closest, center) <= radius;
+    }
+    return glm::distance(center, getCenter()) <= radius + _radius;
+}
+
+float InterestVolume::lodDistance(const glm::vec3& point) const {
+    return glm::distance(point, getCenter()) / _priority;
+}
+
+bool InterestVolume::isVerySimilar(const InterestVolume& other, float positionTolerance) const {
+    return _shape == other._shape &&
+        glm::distance(_bounds.getMinimum(), other._bounds.getMinimum()) <= positionTolerance &&
+        glm::distance(_bounds.getMaximum(), other._bounds.getMaximum()) <= positionTolerance &&
+        fabsf(_priority - other._priority) <= EPSILON;
+}
+
+bool InterestVolume::operator==(const InterestVolume& other) const {
+    return _shape == other._shape && _bounds == other._bounds && _radius == other._radius &&
+        _priority == other._priority;
+}
+
+int InterestVolume::pack(unsigned char* destinationBuffer) const {
+    unsigned char* bufferStart = destinationBuffer;
+
+    *destinationBuffer++ = (unsigned char)_shape;
+
+    if (_shape == BOX) {
+        memcpy(destinationBuffer, &_bounds.getCorner(), sizeof(glm::vec3));
+        destinationBuffer += sizeof(glm::vec3);
+        memcpy(destinationBuffer, &_bounds.getDimensions(), sizeof(glm::vec3));
+        destinationBuffer += sizeof(glm::vec3);
+    } else {
+        glm::vec3 center = getCenter();
+        memcpy(destinationBuffer, &center, sizeof(center));
+        destinationBuffer += sizeof(center);
+        memcpy(destinationBuffer, &_radius, sizeof(_radius));
+        destinationBuffer += sizeof(_radius);
+    }
+
+    memcpy(destinationBuffer, &_priority, sizeof(_priority));
+    destinationBuffer += sizeof(_priority);
+
+    return destinationBuffer - bufferStart;
+}
+
+int InterestVolume::unpack(const unsigned char* sourceBuffer, int bytesLeftToRead) {
+    const unsigned char* startPosition = sourceBuffer;
+
+    if (bytesLeftToRead < 1) {
+        return 0;
+    }
+    unsigned char shape = *sourceBuffer++;
+
+    int shapeBytes;
+    if (shape == BOX) {
+        shapeBytes = 2 * sizeof(glm::vec3);
+    } else if (shape == SPHERE) {
+        shapeBytes = sizeof(glm::vec3) + sizeof(float);
+    } else {
+        return 0;
+    }
+    if (bytesLeftToRead < 1 + shapeBytes + (int)sizeof(float)) {
+        return 0;
+    }
+
+    glm::vec3 position;
+    memcpy(&position, sourceBuffer, sizeof(position));
+    sourceBuffer += sizeof(position);
+
+    float priority;
+    if (shape == BOX) {
+        glm::vec3 dimensions;
+        memcpy(&dimensions, sourceBuffer, sizeof(dimensions));
+        sourceBuffer += sizeof(dimensions);
+        memcpy(&priority, sourceBuffer, sizeof(priority));
+        sourceBuffer += sizeof(priority);
+        *this = InterestVolume(AABox(position, glm::max(dimensions, glm::vec3(0.0f))), priority);
+    } else {
+        float radius;
+        memcpy(&radius, sourceBuffer, sizeof(radius));
+        sourceBuffer += sizeof(radius);
+        memcpy(&priority, sourceBuffer, sizeof(priority));
+        sourceBuffer += sizeof(priority);
+        *this = InterestVolume(position, radius, priority);
+    }
+
+    return sourceBuffer - startPosition;
+}
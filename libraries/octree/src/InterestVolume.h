@@ -0,0 +1,64 @@
+//
+//  InterestVolume.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_InterestVolume_h
+#define hifi_InterestVolume_h
+
+#include <glm/glm.hpp>
+
+#include "AABox.h"
+#include "AACube.h"
+
+const int MAX_INTEREST_VOLUMES = 16;
+const float DEFAULT_INTEREST_PRIORITY = 1.0f;
+const float MIN_INTEREST_PRIORITY = 0.01f;
+
+// A sphere or box a client asks an octree server to send, in addition to what is in its view frustum.
+// Inside the volume, elements get the level of detail they would have for a camera at its center, with the distance
+// to that center divided by the priority: a priority of 2 gets the detail of a camera twice as close.
+class InterestVolume {
+public:
+    enum Shape { SPHERE = 0, BOX };
+
+    InterestVolume();
+    InterestVolume(const glm::vec3& center, float radius, float priority = DEFAULT_INTEREST_PRIORITY);
+    InterestVolume(const AABox& box, float priority = DEFAULT_INTEREST_PRIORITY);
+
+    Shape getShape() const { return _shape; }
+    glm::vec3 getCenter() const { return _bounds.calcCenter(); }
+    float getRadius() const { return _radius; }
+    const AABox& getBounds() const { return _bounds; } // the box, or the bounding box of the sphere
+    float getPriority() const { return _priority; }
+
+    bool contains(const glm::vec3& point) const;
+    bool contains(const AABox& box) const;
+    bool touches(const AABox& box) const;
+    bool containsSphere(const glm::vec3& center, float radius) const;
+    bool touchesSphere(const glm::vec3& center, float radius) const;
+
+    /// the distance used for the level of detail of a point in the volume
+    float lodDistance(const glm::vec3& point) const;
+
+    bool isVerySimilar(const InterestVolume& other, float positionTolerance) const;
+    bool operator==(const InterestVolume& other) const;
+    bool operator!=(const InterestVolume& other) const { return !(*this == other); }
+
+    int pack(unsigned char* destinationBuffer) const;
+    /// \return the number of bytes read, or 0 if the data was not a valid volume
+    int unpack(const unsigned char* sourceBuffer, int bytesLeftToRead);
+
+private:
+    Shape _shape;
+    AABox _bounds;
+    float _radius;
+    float _priority;
+};
+
+#endif // hifi_InterestVolume_h
@@ -29,9 +29,11 @@ JurisdictionListener::JurisdictionListener(NodeType_t type) :
 }
 
 void JurisdictionListener::nodeKilled(SharedNodePointer node) {
-    if (_jurisdictions.find(node->getUUID()) != _jurisdictions.end()) {
-        _jurisdictions.erase(_jurisdictions.find(node->getUUID()));
-    }
+    _jurisdictions.withWriteLock([&] {
+        if (_jurisdictions.find(node->getUUID()) != _jurisdictions.end()) {
+            _jurisdictions.erase(_jurisdictions.find(node->getUUID()));
+        }
+    });
 }
 
 bool JurisdictionListener::queueJurisdictionRequest() {
@@ -62,7 +64,11 @@ void JurisdictionListener::processPacket(QSharedPointer<NLPacket> packet, Shared
     if (packet->getType() == PacketType::Jurisdiction) {
         JurisdictionMap map;
         map.unpackFromPacket(*packet);
-        _jurisdictions[packet->getSourceID()] = map;
+
+        // the edit packet senders read these from their own threads, and follow a server whose jurisdiction changes
+        _jurisdictions.withWriteLock([&] {
+            _jurisdictions[packet->getSourceID()] = map;
+        });
     }
 }
 
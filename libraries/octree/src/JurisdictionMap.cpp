@@ -18,7 +18,9 @@
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 #include <OctalCode.h>
+#include <SharedUtil.h>
 
+#include "OctreeConstants.h"
 #include "OctreeLogging.h"
 #include "JurisdictionMap.h"
 
@@ -193,6 +195,22 @@ JurisdictionMap::Area JurisdictionMap::isMyJurisdiction(const unsigned char* nod
     return isInJurisdiction ? WITHIN : BELOW;
 }
 
+JurisdictionMap::Area JurisdictionMap::isMyJurisdiction(const glm::vec3& position) const {
+    unsigned char* octalCode = routingOctalCodeForPosition(position);
+    Area area = isMyJurisdiction(octalCode, CHECK_NODE_ONLY);
+    delete[] octalCode;
+    return area;
+}
+
+unsigned char* JurisdictionMap::routingOctalCodeForPosition(const glm::vec3& position) {
+    // octal codes are in the 0.0 to 1.0 space of the tree, where the tree is centered on the origin
+    // positions outside of the tree are routed to the cells on its edge
+    float scale = 1.0f / (float)(1 << ROUTING_OCTAL_CODE_DEPTH);
+    glm::vec3 treePosition = glm::clamp((position + (float)HALF_TREE_SCALE) / (float)TREE_SCALE,
+                                        glm::vec3(0.0f), glm::vec3(1.0f - scale));
+    return pointToOctalCode(treePosition.x, treePosition.y, treePosition.z, scale);
+}
+
 
 bool JurisdictionMap::readFromFile(const char* filename) {
     QString settingsFile(filename);
@@ -272,8 +290,8 @@ std::unique_ptr<NLPacket> JurisdictionMap::packIntoPacket() {
 
     // add the root jurisdiction
     if (_rootOctalCode) {
-        size_t bytes = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(_rootOctalCode));
-        // No root or end node details to pack!
+        // sizes are ints, like unpackFromPacket() reads them
+        int bytes = (int)bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(_rootOctalCode));
         packet->writePrimitive(bytes);
         packet->write(reinterpret_cast<char*>(_rootOctalCode), bytes);
 
@@ -283,9 +301,9 @@ std::unique_ptr<NLPacket> JurisdictionMap::packIntoPacket() {
 
         for (int i=0; i < endNodeCount; i++) {
             unsigned char* endNodeCode = _endNodes[i];
-            size_t bytes = 0;
+            int bytes = 0;
             if (endNodeCode) {
-                bytes = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(endNodeCode));
+                bytes = (int)bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(endNodeCode));
             }
             packet->writePrimitive(bytes);
             packet->write(reinterpret_cast<char*>(endNodeCode), bytes);
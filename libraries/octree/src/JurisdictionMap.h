@@ -16,6 +16,8 @@
 #include <stdint.h>
 #include <vector>
 
+#include <glm/glm.hpp>
+
 #include <QtCore/QString>
 #include <QtCore/QUuid>
 
@@ -24,6 +26,10 @@
 #include <NLPacket.h>
 #include <Node.h>
 
+// edit messages for a position carry the octal code of the cell of this depth that contains it, about 8 meters wide,
+// so jurisdictions need to be coarser than that for their edits to be routed to them
+const int ROUTING_OCTAL_CODE_DEPTH = 12;
+
 class JurisdictionMap {
 public:
     enum Area {
@@ -47,6 +53,13 @@ public:
 
     Area isMyJurisdiction(const unsigned char* nodeOctalCode, int childIndex) const;
 
+    /// \return the area of the position in meters, which is WITHIN for exactly one of a set of jurisdictions that cover
+    /// the whole tree
+    Area isMyJurisdiction(const glm::vec3& position) const;
+
+    /// the octal code edit messages use to be sent to the server with a position in meters, which the caller must delete[]
+    static unsigned char* routingOctalCodeForPosition(const glm::vec3& position);
+
     bool writeToFile(const char* filename);
     bool readFromFile(const char* filename);
 
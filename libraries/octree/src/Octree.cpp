@@ -49,7 +49,7 @@
 #include "OctreeLogging.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz", "entities"};
 
 float boundaryDistanceForRenderLevel(unsigned int renderLevel, float voxelSizeScale) {
     return voxelSizeScale / powf(2, renderLevel);
@@ -76,7 +76,7 @@ Octree::~Octree() {
 // non-sorted array
 // returns -1 if size exceeded
 // originalIndexArray is optional
-int insertOctreeElementIntoSortedArrays(OctreeElementPointer value, float key, int originalIndex,
+int insertOctreeElementIntoSortedArrays(const OctreeElementPointer& value, float key, int originalIndex,
                                         OctreeElementPointer* valueArray, float* keyArray, int* originalIndexArray,
                                         int currentCount, int maxCount) {
 
@@ -120,7 +120,7 @@ void Octree::recurseTreeWithPostOperation(RecurseOctreeOperation operation, void
 }
 
 // Recurses voxel element with an operation function
-void Octree::recurseElementWithOperation(OctreeElementPointer element, RecurseOctreeOperation operation, void* extraData,
+void Octree::recurseElementWithOperation(const OctreeElementPointer& element, RecurseOctreeOperation operation, void* extraData,
                         int recursionCount) {
     if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
         static QString repeatedMessage
@@ -142,7 +142,7 @@ void Octree::recurseElementWithOperation(OctreeElementPointer element, RecurseOc
 }
 
 // Recurses voxel element with an operation function
-void Octree::recurseElementWithPostOperation(OctreeElementPointer element, RecurseOctreeOperation operation,
+void Octree::recurseElementWithPostOperation(const OctreeElementPointer& element, RecurseOctreeOperation operation,
                                              void* extraData, int recursionCount) {
     if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
         static QString repeatedMessage
@@ -171,7 +171,7 @@ void Octree::recurseTreeWithOperationDistanceSorted(RecurseOctreeOperation opera
 }
 
 // Recurses voxel element with an operation function
-void Octree::recurseElementWithOperationDistanceSorted(OctreeElementPointer element, RecurseOctreeOperation operation,
+void Octree::recurseElementWithOperationDistanceSorted(const OctreeElementPointer& element, RecurseOctreeOperation operation,
                                                        const glm::vec3& point, void* extraData, int recursionCount) {
 
     if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
@@ -214,7 +214,7 @@ void Octree::recurseTreeWithOperator(RecurseOctreeOperator* operatorObject) {
     recurseElementWithOperator(_rootElement, operatorObject);
 }
 
-bool Octree::recurseElementWithOperator(OctreeElementPointer element,
+bool Octree::recurseElementWithOperator(const OctreeElementPointer& element,
                                         RecurseOctreeOperator* operatorObject, int recursionCount) {
     if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
         static QString repeatedMessage
@@ -254,6 +254,26 @@ OctreeElementPointer Octree::nodeForOctalCode(OctreeElementPointer ancestorEleme
         return _rootElement;
     }
 
+    // walk down by the sections of the packed key, and only parse the bytes for codes too deep to pack
+    OctalKey needleKey = OctalKey::fromOctalCode(needleCode);
+    if (needleKey.isValid()) {
+        int needleSections = needleKey.getSections();
+        int sections = numberOfThreeBitSectionsInCode(ancestorElement->getOctalCode());
+        OctreeElementPointer element = ancestorElement;
+        while (sections < needleSections) {
+            OctreeElementPointer childElement = element->getChildAtIndex(needleKey.getSection(sections));
+            if (!childElement) {
+                break;
+            }
+            sections++;
+            if (sections == needleSections && parentOfFoundElement) {
+                *parentOfFoundElement = element;
+            }
+            element = childElement;
+        }
+        return element;
+    }
+
     // find the appropriate branch index based on this ancestorElement
     if (*needleCode > 0) {
         int branchForNeedle = branchIndexWithDescendant(ancestorElement->getOctalCode(), needleCode);
@@ -294,6 +314,25 @@ OctreeElementPointer Octree::createMissingElement(OctreeElementPointer lastParen
         qCDebug(octree) << "Octree::createMissingElement() reached DANGEROUSLY_DEEP_RECURSION, bailing!";
         return lastParentElement;
     }
+
+    OctalKey keyToReach = OctalKey::fromOctalCode(codeToReach);
+    if (keyToReach.isValid()) {
+        int sectionsToReach = keyToReach.getSections();
+        int sections = numberOfThreeBitSectionsInCode(lastParentElement->getOctalCode());
+        OctreeElementPointer element = lastParentElement;
+        while (sections < sectionsToReach) {
+            int indexOfNewChild = keyToReach.getSection(sections);
+            if (element->requiresSplit()) {
+                element->splitChildren();
+            } else if (!element->getChildAtIndex(indexOfNewChild)) {
+                element->addChildAtIndex(indexOfNewChild);
+            }
+            element = element->getChildAtIndex(indexOfNewChild);
+            sections++;
+        }
+        return element;
+    }
+
     int indexOfNewChild = branchIndexWithDescendant(lastParentElement->getOctalCode(), codeToReach);
 
     // If this parent element is a leaf, then you know the child path doesn't exist, so deal with
@@ -499,6 +538,97 @@ void Octree::readBitstreamToTree(const unsigned char * bitstream, unsigned long
     }
 }
 
+PredecodedBitstreamPointer Octree::predecodeBitstream(const unsigned char* bitstream, unsigned long int bufferSizeBytes,
+                                                      const ReadBitstreamToTreeParams& args) const {
+    // the bitstreams are read relative to the root, and the entity counts of the args are left to readBitstreamToTree
+    if (args.destinationElement) {
+        return PredecodedBitstreamPointer();
+    }
+    ReadBitstreamToTreeParams predecodeArgs = args;
+    PredecodedBitstreamPointer predecoded;
+
+    int bytesRead = 0;
+    const unsigned char* bitstreamAt = bitstream;
+    while (bitstreamAt < bitstream + bufferSizeBytes) {
+        int numberOfThreeBitSectionsInStream = numberOfThreeBitSectionsInCode(bitstreamAt, bufferSizeBytes);
+        if (numberOfThreeBitSectionsInStream > UNREASONABLY_DEEP_RECURSION ||
+            numberOfThreeBitSectionsInStream == OVERFLOWED_OCTCODE_BUFFER) {
+            break; // readBitstreamToTree stops here too
+        }
+
+        int octalCodeBytes = bytesRequiredForCodeLength(numberOfThreeBitSectionsInStream);
+        int lowerLevelBytes = predecodeElement(numberOfThreeBitSectionsInStream, numberOfThreeBitSectionsInStream == 0,
+                                               bitstreamAt + octalCodeBytes,
+                                               bufferSizeBytes - (bytesRead + octalCodeBytes), predecodeArgs, predecoded);
+        if (lowerLevelBytes < 0) {
+            return PredecodedBitstreamPointer();
+        }
+
+        bitstreamAt += octalCodeBytes + lowerLevelBytes;
+        bytesRead += octalCodeBytes + lowerLevelBytes;
+    }
+    return predecoded;
+}
+
+int Octree::predecodeElement(int level, bool isRootElement, const unsigned char* nodeData, int bytesAvailable,
+                             ReadBitstreamToTreeParams& args, PredecodedBitstreamPointer& predecoded) const {
+    int bytesLeftToRead = bytesAvailable;
+    int bytesRead = 0;
+
+    if ((size_t)bytesLeftToRead < sizeof(unsigned char) ||
+        (float)TREE_SCALE / powf(2.0f, level) < SCALE_AT_DANGEROUSLY_DEEP_RECURSION) {
+        return bytesAvailable;
+    }
+
+    unsigned char colorInPacketMask = *nodeData;
+    bytesRead += sizeof(colorInPacketMask);
+    bytesLeftToRead -= sizeof(colorInPacketMask);
+
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        if (oneAtBit(colorInPacketMask, i)) {
+            int childElementDataRead = predecodeElementData(nodeData + bytesRead, bytesLeftToRead, false, args, predecoded);
+            if (childElementDataRead < 0) {
+                return -1;
+            }
+            bytesRead += childElementDataRead;
+            bytesLeftToRead -= childElementDataRead;
+        }
+    }
+
+    unsigned char childInBufferMask = 0;
+    int bytesForMasks = args.includeExistsBits ? sizeof(unsigned char) + sizeof(childInBufferMask)
+                                                : sizeof(childInBufferMask);
+    if (bytesLeftToRead < bytesForMasks) {
+        return bytesAvailable;
+    }
+
+    childInBufferMask = *(nodeData + bytesRead + (args.includeExistsBits ? sizeof(unsigned char) : 0));
+    bytesRead += bytesForMasks;
+    bytesLeftToRead -= bytesForMasks;
+
+    for (int childIndex = 0; bytesLeftToRead > 0 && childIndex < NUMBER_OF_CHILDREN; childIndex++) {
+        if (oneAtBit(childInBufferMask, childIndex)) {
+            int lowerLevelBytes = predecodeElement(level + 1, false, nodeData + bytesRead, bytesLeftToRead, args,
+                                                   predecoded);
+            if (lowerLevelBytes < 0) {
+                return -1;
+            }
+            bytesRead += lowerLevelBytes;
+            bytesLeftToRead -= lowerLevelBytes;
+        }
+    }
+
+    if (isRootElement && rootElementHasData() && bytesLeftToRead > 0) {
+        int rootDataSize = predecodeElementData(nodeData + bytesRead, bytesLeftToRead, true, args, predecoded);
+        if (rootDataSize < 0) {
+            return -1;
+        }
+        bytesRead += rootDataSize;
+    }
+
+    return bytesRead;
+}
+
 void Octree::deleteOctreeElementAt(float x, float y, float z, float s) {
     unsigned char* octalCode = pointToOctalCode(x,y,z,s);
     deleteOctalCodeFromTree(octalCode);
@@ -531,7 +661,7 @@ void Octree::deleteOctalCodeFromTree(const unsigned char* codeBuffer, bool colla
     });
 }
 
-void Octree::deleteOctalCodeFromTreeRecursion(OctreeElementPointer element, void* extraData) {
+void Octree::deleteOctalCodeFromTreeRecursion(const OctreeElementPointer& element, void* extraData) {
     DeleteOctalCodeFromTreeArgs* args = (DeleteOctalCodeFromTreeArgs*)extraData;
 
     int lengthOfElementCode = numberOfThreeBitSectionsInCode(element->getOctalCode());
@@ -705,7 +835,7 @@ public:
     void* penetratedObject; /// the type is defined by the type of Octree, the caller is assumed to know the type
 };
 
-bool findSpherePenetrationOp(OctreeElementPointer element, void* extraData) {
+bool findSpherePenetrationOp(const OctreeElementPointer& element, void* extraData) {
     SphereArgs* args = static_cast<SphereArgs*>(extraData);
 
     // coarse check against bounds
@@ -767,7 +897,7 @@ public:
     CubeList* cubes;
 };
 
-bool findCapsulePenetrationOp(OctreeElementPointer element, void* extraData) {
+bool findCapsulePenetrationOp(const OctreeElementPointer& element, void* extraData) {
     CapsuleArgs* args = static_cast<CapsuleArgs*>(extraData);
 
     // coarse check against bounds
@@ -800,7 +930,7 @@ uint qHash(const glm::vec3& point) {
         (((quint64)(point.z * RESOLUTION_PER_METER)) % MAX_SCALED_COMPONENT << 2 * BITS_PER_COMPONENT));
 }
 
-bool findContentInCubeOp(OctreeElementPointer element, void* extraData) {
+bool findContentInCubeOp(const OctreeElementPointer& element, void* extraData) {
     ContentArgs* args = static_cast<ContentArgs*>(extraData);
 
     // coarse check against bounds
@@ -853,7 +983,7 @@ public:
 };
 
 // Find the smallest colored voxel enclosing a point (if there is one)
-bool getElementEnclosingOperation(OctreeElementPointer element, void* extraData) {
+bool getElementEnclosingOperation(const OctreeElementPointer& element, void* extraData) {
     GetElementEnclosingArgs* args = static_cast<GetElementEnclosingArgs*>(extraData);
     if (element->getAACube().contains(args->point)) {
         if (element->hasContent() && element->isLeaf()) {
@@ -976,10 +1106,11 @@ int Octree::encodeTreeBitstream(OctreeElementPointer element,
     return bytesWritten;
 }
 
-int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
+int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
                                          OctreePacketData* packetData, OctreeElementBag& bag,
                                          EncodeBitstreamParams& params, int& currentEncodeLevel,
-                                         const ViewFrustum::location& parentLocationThisView) const {
+                                         const ViewFrustum::location& parentLocationThisView,
+                                         ViewFrustum::PlaneMask parentPlaneMask) const {
 
 
     const bool wantDebug = false;
@@ -1019,6 +1150,7 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
     }
 
     ViewFrustum::location nodeLocationThisView = ViewFrustum::INSIDE; // assume we're inside
+    ViewFrustum::PlaneMask planeMask = parentPlaneMask; // the planes this element may cross, narrowed below
 
     // caller can pass NULL as viewFrustum if they want everything
     if (params.viewFrustum) {
@@ -1039,7 +1171,7 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
         // if we are INSIDE, INTERSECT, or OUTSIDE
         if (parentLocationThisView != ViewFrustum::INSIDE) {
             assert(parentLocationThisView != ViewFrustum::OUTSIDE); // we shouldn't be here if our parent was OUTSIDE!
-            nodeLocationThisView = element->inFrustum(*params.viewFrustum);
+            nodeLocationThisView = element->inFrustum(*params.viewFrustum, planeMask);
         }
 
         // If we're at a element that is out of view, then we can return, because no nodes below us will be in view!
@@ -1212,6 +1344,22 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
         }
     }
 
+    // when this element crosses the frustum, test all of its children at once against the planes it crosses
+    ViewFrustum::location childLocations[NUMBER_OF_CHILDREN];
+    bool testChildrenInView = params.viewFrustum && nodeLocationThisView == ViewFrustum::INTERSECT;
+    if (testChildrenInView) {
+        RayIntersectionKernels::BoxBatch childBoxes;
+        for (int i = 0; i < currentCount; i++) {
+            if (sortedChildren[i]) {
+                const AACube& childCube = sortedChildren[i]->getAACube();
+                childBoxes.add(childCube.getMinimumPoint(), childCube.getMaximumPoint());
+            } else {
+                childBoxes.add(glm::vec3(0.0f), glm::vec3(0.0f));
+            }
+        }
+        params.viewFrustum->boxesInFrustum(childBoxes, planeMask, childLocations);
+    }
+
     // for each child element in Distance sorted order..., check to see if they exist, are colored, and in view, and if so
     // add them to our distance ordered array of children
     for (int i = 0; i < currentCount; i++) {
@@ -1221,8 +1369,8 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
         bool childIsInView  = (childElement &&
                 ( !params.viewFrustum || // no view frustum was given, everything is assumed in view
                   (nodeLocationThisView == ViewFrustum::INSIDE) || // parent was fully in view, we can assume ALL children are
-                  (nodeLocationThisView == ViewFrustum::INTERSECT &&
-                        childElement->isInView(*params.viewFrustum)) // the parent intersects and the child is in view
+                  (testChildrenInView &&
+                        childLocations[i] != ViewFrustum::OUTSIDE) // the parent intersects and the child is in view
                 ));
 
         if (!childIsInView) {
@@ -1540,7 +1688,7 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
                     // will be true. But if the tree has already been encoded, we will skip this.
                     if (element->shouldRecurseChildTree(originalIndex, params)) {
                         childTreeBytesOut = encodeTreeBitstreamRecursion(childElement, packetData, bag, params,
-                                                                                thisLevel, nodeLocationThisView);
+                                                                                thisLevel, nodeLocationThisView, planeMask);
                     } else {
                         childTreeBytesOut = 0;
                     }
@@ -1749,6 +1897,10 @@ bool Octree::readFromFile(const char* fileName) {
         return readJSONFromGzippedFile(qFileName);
     }
 
+    if (qFileName.endsWith(".entities")) {
+        return readFromBinaryFile(qFileName);
+    }
+
     QFile file(qFileName);
 
     if (!file.open(QIODevice::ReadOnly)) {
@@ -2011,6 +2163,11 @@ void Octree::writeToFile(const char* fileName, OctreeElementPointer element, QSt
         writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "entities") {
+        QVariantMap entityDescription;
+        if (writeToJSONMap(entityDescription, element)) {
+            writeBinaryMapToFile(cFileName, entityDescription);
+        }
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
@@ -2021,6 +2178,12 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
 
     qCDebug(octree, "Saving JSON SVO to file %s...", fileName);
 
+    if (writeToJSONMap(entityDescription, element)) {
+        writeJSONMapToFile(fileName, entityDescription, doGzip);
+    }
+}
+
+bool Octree::writeToJSONMap(QVariantMap& entityDescription, OctreeElementPointer element) {
     OctreeElementPointer top;
     if (element) {
         top = element;
@@ -2037,9 +2200,12 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
     bool entityDescriptionSuccess = writeToMap(entityDescription, top, true);
     if (!entityDescriptionSuccess) {
         qCritical("Failed to convert Entities to QVariantMap while saving to json.");
-        return;
+        return false;
     }
+    return true;
+}
 
+bool Octree::writeJSONMapToFile(const char* fileName, const QVariantMap& entityDescription, bool doGzip) {
     // convert the QVariantMap to JSON
     QByteArray jsonData = QJsonDocument::fromVariant(entityDescription).toJson();
     QByteArray jsonDataForFile;
@@ -2047,7 +2213,7 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
     if (doGzip) {
         if (!gzip(jsonData, jsonDataForFile, -1)) {
             qCritical("unable to gzip data while saving to json.");
-            return;
+            return false;
         }
     } else {
         jsonDataForFile = jsonData;
@@ -2055,9 +2221,10 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
 
     QFile persistFile(fileName);
     if (persistFile.open(QIODevice::WriteOnly)) {
-        persistFile.write(jsonDataForFile);
+        return persistFile.write(jsonDataForFile) == jsonDataForFile.size();
     } else {
         qCritical("Could not write to JSON description of entities.");
+        return false;
     }
 }
 
@@ -2150,7 +2317,7 @@ unsigned long Octree::getOctreeElementsCount() {
     return nodeCount;
 }
 
-bool Octree::countOctreeElementsOperation(OctreeElementPointer element, void* extraData) {
+bool Octree::countOctreeElementsOperation(const OctreeElementPointer& element, void* extraData) {
     (*(unsigned long*)extraData)++;
     return true; // keep going
 }
@@ -12,6 +12,7 @@
 #ifndef hifi_Octree_h
 #define hifi_Octree_h
 
+#include <functional>
 #include <memory>
 #include <set>
 
@@ -44,13 +45,13 @@ extern QVector<QString> PERSIST_EXTENSIONS;
 /// derive from this class to use the Octree::recurseTreeWithOperator() method
 class RecurseOctreeOperator {
 public:
-    virtual bool preRecursion(OctreeElementPointer element) = 0;
-    virtual bool postRecursion(OctreeElementPointer element) = 0;
-    virtual OctreeElementPointer possiblyCreateChildAt(OctreeElementPointer element, int childIndex) { return NULL; }
+    virtual bool preRecursion(const OctreeElementPointer& element) = 0;
+    virtual bool postRecursion(const OctreeElementPointer& element) = 0;
+    virtual OctreeElementPointer possiblyCreateChildAt(const OctreeElementPointer& element, int childIndex) { return NULL; }
 };
 
 // Callback function, for recuseTreeWithOperation
-typedef bool (*RecurseOctreeOperation)(OctreeElementPointer element, void* extraData);
+typedef bool (*RecurseOctreeOperation)(const OctreeElementPointer& element, void* extraData);
 typedef enum {GRADIENT, RANDOM, NATURAL} creationMode;
 typedef QHash<uint, AACube> CubeList;
 
@@ -189,6 +190,13 @@ public:
     bool pathChanged;
 };
 
+/// The element data of a bitstream read ahead of the tree by Octree::predecodeBitstream, trees that read ahead subclass it
+class PredecodedBitstream {
+public:
+    virtual ~PredecodedBitstream() { }
+};
+typedef std::shared_ptr<PredecodedBitstream> PredecodedBitstreamPointer;
+
 class ReadBitstreamToTreeParams {
 public:
     bool includeColor;
@@ -200,6 +208,7 @@ public:
     PacketVersion bitstreamVersion;
     int elementsPerPacket = 0;
     int entitiesPerPacket = 0;
+    PredecodedBitstreamPointer predecoded; // from predecodeBitstream on the same bitstream, if it was read ahead
 
     ReadBitstreamToTreeParams(
         bool includeColor = WANT_COLOR,
@@ -238,6 +247,15 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(NLPacket& packet, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+
+    // Implement this to decode edits without the tree lock. Fill in applyEdit to make the change, it is called later
+    // with the write lock held. Edits left without an applyEdit go through processEditPacketData instead.
+    virtual int decodeEditPacketData(NLPacket& packet, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& sourceNode, std::function<void()>& applyEdit) { return 0; }
+
+    // Edits made between these two calls may share their traversals of the tree, callers hold the write lock throughout
+    virtual void startEditBatch() { }
+    virtual void finishEditBatch() { }
                     
     virtual bool recurseChildrenWithData() const { return true; }
     virtual bool rootElementHasData() const { return false; }
@@ -258,6 +276,12 @@ public:
     virtual void eraseAllOctreeElements(bool createNewRoot = true);
 
     void readBitstreamToTree(const unsigned char* bitstream,  unsigned long int bufferSizeBytes, ReadBitstreamToTreeParams& args);
+
+    /// Reads as much of a bitstream as can be read without the tree, so packets can be decoded on any thread before
+    /// readBitstreamToTree reads them into the tree under the write lock. Pass the result in the args of that call, it is
+    /// null if the tree doesn't read ahead.
+    PredecodedBitstreamPointer predecodeBitstream(const unsigned char* bitstream, unsigned long int bufferSizeBytes,
+                                                  const ReadBitstreamToTreeParams& args) const;
     void deleteOctalCodeFromTree(const unsigned char* codeBuffer, bool collapseEmptyTrees = DONT_COLLAPSE);
     void reaverageOctreeElements(OctreeElementPointer startElement = NULL);
 
@@ -324,6 +348,24 @@ public:
     void writeToSVOFile(const char* filename, OctreeElementPointer element = NULL);
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues) = 0;
 
+    // writeToJSONFile() in two steps, so that only the first one has to see a stable tree
+    bool writeToJSONMap(QVariantMap& entityDescription, OctreeElementPointer element = NULL);
+    bool writeJSONMapToFile(const char* filename, const QVariantMap& entityDescription, bool doGzip = false);
+
+    // binary persist files, which are much faster to load than json, trees that don't have one return false
+    virtual bool writeBinaryMapToFile(const char* filename, const QVariantMap& entityDescription) { return false; }
+    virtual bool readFromBinaryFile(const QString& filename) { return false; }
+
+    // Trees that track their own changes can be persisted as a journal of those changes between full snapshots,
+    // see OctreePersistThread.
+    /// starts tracking changes for takeJournalEntries(), returns false if this tree can't be journaled
+    virtual bool startJournal() { return false; }
+    /// moves the changes made since the last call into entries, callers must hold at least the read lock and only
+    /// one thread may take the entries
+    virtual void takeJournalEntries(QVariantList& entries) { }
+    /// applies an entry made by takeJournalEntries(), callers must hold the write lock
+    virtual bool readJournalEntry(const QVariantMap& entry) { return false; }
+
     // Octree importers
     bool readFromFile(const char* filename);
     bool readFromURL(const QString& url); // will support file urls as well...
@@ -337,18 +379,18 @@ public:
 
     bool getShouldReaverage() const { return _shouldReaverage; }
 
-    void recurseElementWithOperation(OctreeElementPointer element, RecurseOctreeOperation operation,
+    void recurseElementWithOperation(const OctreeElementPointer& element, RecurseOctreeOperation operation,
                 void* extraData, int recursionCount = 0);
 
     /// Traverse child nodes of node applying operation in post-fix order
     ///
-    void recurseElementWithPostOperation(OctreeElementPointer element, RecurseOctreeOperation operation,
+    void recurseElementWithPostOperation(const OctreeElementPointer& element, RecurseOctreeOperation operation,
                 void* extraData, int recursionCount = 0);
 
-    void recurseElementWithOperationDistanceSorted(OctreeElementPointer element, RecurseOctreeOperation operation,
+    void recurseElementWithOperationDistanceSorted(const OctreeElementPointer& element, RecurseOctreeOperation operation,
                 const glm::vec3& point, void* extraData, int recursionCount = 0);
 
-    bool recurseElementWithOperator(OctreeElementPointer element, RecurseOctreeOperator* operatorObject, int recursionCount = 0);
+    bool recurseElementWithOperator(const OctreeElementPointer& element, RecurseOctreeOperator* operatorObject, int recursionCount = 0);
 
     bool getIsViewing() const { return _isViewing; } /// This tree is receiving inbound viewer datagrams.
     void setIsViewing(bool isViewing) { _isViewing = isViewing; }
@@ -379,20 +421,32 @@ public slots:
 
 
 protected:
-    void deleteOctalCodeFromTreeRecursion(OctreeElementPointer element, void* extraData);
+    void deleteOctalCodeFromTreeRecursion(const OctreeElementPointer& element, void* extraData);
 
-    int encodeTreeBitstreamRecursion(OctreeElementPointer element,
+    int encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
                                      OctreePacketData* packetData, OctreeElementBag& bag,
                                      EncodeBitstreamParams& params, int& currentEncodeLevel,
-                                     const ViewFrustum::location& parentLocationThisView) const;
+                                     const ViewFrustum::location& parentLocationThisView,
+                                     ViewFrustum::PlaneMask parentPlaneMask = ViewFrustum::ALL_PLANES) const;
 
-    static bool countOctreeElementsOperation(OctreeElementPointer element, void* extraData);
+    static bool countOctreeElementsOperation(const OctreeElementPointer& element, void* extraData);
 
     OctreeElementPointer nodeForOctalCode(OctreeElementPointer ancestorElement, const unsigned char* needleCode, OctreeElementPointer* parentOfFoundElement) const;
     OctreeElementPointer createMissingElement(OctreeElementPointer lastParentElement, const unsigned char* codeToReach, int recursionCount = 0);
     int readElementData(OctreeElementPointer destinationElement, const unsigned char* nodeData,
                 int bufferSizeBytes, ReadBitstreamToTreeParams& args);
 
+    // Override to read the data of one element ahead of the tree, creating predecoded on the first call. Returns the bytes
+    // the element data takes, which must match readElementDataFromBuffer, or -1 if the tree doesn't read ahead.
+    virtual int predecodeElementData(const unsigned char* data, int bytesLeftToRead, bool isRootElement,
+                                     ReadBitstreamToTreeParams& args, PredecodedBitstreamPointer& predecoded) const {
+        return -1;
+    }
+
+    // walks the bitstream of one element and its children the way readElementData does, -1 if it can't be read ahead
+    int predecodeElement(int level, bool isRootElement, const unsigned char* nodeData, int bytesAvailable,
+                         ReadBitstreamToTreeParams& args, PredecodedBitstreamPointer& predecoded) const;
+
     OctreeElementPointer _rootElement = nullptr;
 
     bool _isDirty;
@@ -180,7 +180,7 @@ void OctreeEditPacketSender::queuePacketToNodes(std::unique_ptr<NLPacket> packet
             // here we need to get the "pending packet" for this server
             _serverJurisdictions->withReadLock([&] {
                 const JurisdictionMap& map = (*_serverJurisdictions)[nodeUUID];
-                isMyJurisdiction = (map.isMyJurisdiction(octCode, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
+                isMyJurisdiction = (map.isMyJurisdiction(octCode, CHECK_NODE_ONLY) != JurisdictionMap::BELOW);
             });
 
             if (isMyJurisdiction) {
@@ -238,9 +238,11 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, QByteArray&
                 // here we need to get the "pending packet" for this server
                 _serverJurisdictions->withReadLock([&] {
                     if ((*_serverJurisdictions).find(nodeUUID) != (*_serverJurisdictions).end()) {
+                        // an octal code above the root of the server covers its jurisdiction too, like the root
+                        // octal code of the edits that go to every server
                         const JurisdictionMap& map = (*_serverJurisdictions)[nodeUUID];
                         isMyJurisdiction = (map.isMyJurisdiction(reinterpret_cast<const unsigned char*>(editMessage.data()),
-                            CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
+                            CHECK_NODE_ONLY) != JurisdictionMap::BELOW);
                     } else {
                         isMyJurisdiction = false;
                     }
@@ -283,6 +285,8 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, QByteArray&
 }
 
 void OctreeEditPacketSender::releaseQueuedMessages() {
+    releaseCoalescedMessages();
+
     // if we don't yet have jurisdictions then we can't actually release messages yet because we don't
     // know where to send them to. Instead, just remember this request and when we eventually get jurisdictions
     // call release again at that time.
@@ -94,6 +94,10 @@ protected:
 
     void processPreServerExistsPackets();
 
+    /// Subclasses that hold back edit messages to merge the ones that supersede each other queue them here, this is
+    /// called before the queued messages are released
+    virtual void releaseCoalescedMessages() { }
+
     // These are packets which are destined from know servers but haven't been released because they're still too small
     std::unordered_map<QUuid, std::unique_ptr<NLPacket>> _pendingEditPackets;
 
@@ -504,10 +504,8 @@ float OctreeElement::furthestDistanceToCamera(const ViewFrustum& viewFrustum) co
 }
 
 float OctreeElement::distanceToCamera(const ViewFrustum& viewFrustum) const {
-    glm::vec3 center = _cube.calcCenter();
-    glm::vec3 temp = viewFrustum.getPosition() - center;
-    float distanceToVoxelCenter = sqrtf(glm::dot(temp, temp));
-    return distanceToVoxelCenter;
+    // the frustum brings elements in its interest volumes closer
+    return viewFrustum.distanceToCamera(_cube.calcCenter());
 }
 
 float OctreeElement::distanceSquareToPoint(const glm::vec3& point) const {
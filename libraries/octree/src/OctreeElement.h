@@ -149,6 +149,10 @@ public:
     float getEnclosingRadius() const;
     bool isInView(const ViewFrustum& viewFrustum) const { return inFrustum(viewFrustum) != ViewFrustum::OUTSIDE; }
     ViewFrustum::location inFrustum(const ViewFrustum& viewFrustum) const;
+    /// tests only the planes in planeMask, and clears the ones the element is fully inside of, see ViewFrustum::PlaneMask
+    ViewFrustum::location inFrustum(const ViewFrustum& viewFrustum, ViewFrustum::PlaneMask& planeMask) const {
+        return viewFrustum.cubeInFrustum(_cube, planeMask);
+    }
     float distanceToCamera(const ViewFrustum& viewFrustum) const;
     float furthestDistanceToCamera(const ViewFrustum& viewFrustum) const;
 
@@ -10,8 +10,16 @@
 //
 
 #include "OctreeElementBag.h"
+
+#include <algorithm>
+
 #include <OctalCode.h>
 
+#include "ViewFrustum.h"
+
+// keeps elements containing the camera from dividing by zero, they all come out first anyway
+static const float MIN_PRIORITY_DISTANCE = 0.001f;
+
 OctreeElementBag::OctreeElementBag() : 
     _bagElements()
 {
@@ -38,16 +46,38 @@ void OctreeElementBag::elementDeleted(OctreeElementPointer element) {
 
 void OctreeElementBag::deleteAll() {
     _bagElements.clear();
+    _priorityQueue = std::priority_queue<PrioritizedElement, std::vector<PrioritizedElement>>();
 }
 
 
-void OctreeElementBag::insert(OctreeElementPointer element) {
+void OctreeElementBag::insert(const OctreeElementPointer& element) {
+    if (_priorityView) {
+        if (_bagElements.contains(element)) {
+            return;
+        }
+        float distance = std::max(element->distanceToCamera(*_priorityView), MIN_PRIORITY_DISTANCE);
+        _priorityQueue.push({ element->getScale() / distance, element });
+    }
     _bagElements.insert(element);
 }
 
 OctreeElementPointer OctreeElementBag::extract() {
     OctreeElementPointer result = NULL;
 
+    if (_priorityView) {
+        while (!_priorityQueue.empty()) {
+            OctreeElementPointer element = _priorityQueue.top().element;
+            _priorityQueue.pop();
+
+            // skip the entries of elements that were removed from the bag since they were queued
+            if (_bagElements.remove(element)) {
+                result = element;
+                break;
+            }
+        }
+        return result;
+    }
+
     if (_bagElements.size() > 0) {
         QSet<OctreeElementPointer>::iterator front = _bagElements.begin();
         result = *front;
@@ -56,10 +86,10 @@ OctreeElementPointer OctreeElementBag::extract() {
     return result;
 }
 
-bool OctreeElementBag::contains(OctreeElementPointer element) {
+bool OctreeElementBag::contains(const OctreeElementPointer& element) {
     return _bagElements.contains(element);
 }
 
-void OctreeElementBag::remove(OctreeElementPointer element) {
+void OctreeElementBag::remove(const OctreeElementPointer& element) {
     _bagElements.remove(element);
 }
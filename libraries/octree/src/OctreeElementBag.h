@@ -16,18 +16,23 @@
 #ifndef hifi_OctreeElementBag_h
 #define hifi_OctreeElementBag_h
 
+#include <queue>
+#include <vector>
+
 #include "OctreeElement.h"
 
+class ViewFrustum;
+
 class OctreeElementBag : public OctreeElementDeleteHook {
 
 public:
     OctreeElementBag();
     ~OctreeElementBag();
 
-    void insert(OctreeElementPointer element); // put a element into the bag
-    OctreeElementPointer extract(); // pull a element out of the bag (could come in any order)
-    bool contains(OctreeElementPointer element); // is this element in the bag?
-    void remove(OctreeElementPointer element); // remove a specific element from the bag
+    void insert(const OctreeElementPointer& element); // put a element into the bag
+    OctreeElementPointer extract(); // pull a element out of the bag (could come in any order, see setPriorityView())
+    bool contains(const OctreeElementPointer& element); // is this element in the bag?
+    void remove(const OctreeElementPointer& element); // remove a specific element from the bag
     bool isEmpty() const { return _bagElements.isEmpty(); }
     int count() const { return _bagElements.size(); }
 
@@ -36,9 +41,25 @@ public:
 
     void unhookNotifications();
 
+    /// When set, extract() hands out the elements that look biggest from this view first (largest scale over
+    /// distance), so the nearest and largest content of a scene goes out before the far away details. The priority
+    /// of an element is taken from the view at the time it is inserted. The view must outlive the bag.
+    void setPriorityView(const ViewFrustum* viewFrustum) { _priorityView = viewFrustum; }
+
 private:
+    struct PrioritizedElement {
+        float priority;
+        OctreeElementPointer element;
+
+        bool operator<(const PrioritizedElement& other) const { return priority < other.priority; }
+    };
+
     QSet<OctreeElementPointer> _bagElements;
     bool _hooked;
+
+    // removed elements are left in the queue and skipped when they come up, _bagElements is what is in the bag
+    const ViewFrustum* _priorityView { nullptr };
+    std::priority_queue<PrioritizedElement, std::vector<PrioritizedElement>> _priorityQueue;
 };
 
 typedef QMap<const OctreeElement*, void*> OctreeElementExtraEncodeData;
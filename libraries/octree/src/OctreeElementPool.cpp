@@ -0,0 +1,78 @@
+//
+//  OctreeElementPool.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeElementPool.h"
+
+#include <algorithm>
+#include <new>
+
+// the blocks keep the alignment operator new gives, which elements holding glm and Qt members rely on
+static const size_t BLOCK_ALIGNMENT = 16;
+
+OctreeElementPool::OctreeElementPool(size_t blockSize) :
+    _requestedSize(blockSize),
+    _blockSize((std::max(blockSize, sizeof(FreeBlock)) + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1))
+{
+}
+
+void* OctreeElementPool::allocate(size_t size) {
+    if (size != _requestedSize) {
+        return ::operator new(size);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_freeBlocks) {
+        // new[] of char only promises the alignment of the largest fundamental type, so the slab is padded to start
+        // the first block on the alignment of the blocks
+        char* slab = new char[_blockSize * BLOCKS_PER_SLAB + BLOCK_ALIGNMENT];
+        _slabs.emplace_back(slab);
+        char* firstBlock = reinterpret_cast<char*>(
+            (reinterpret_cast<quintptr>(slab) + BLOCK_ALIGNMENT - 1) & ~(quintptr)(BLOCK_ALIGNMENT - 1));
+
+        // link the blocks from the end so that the tree takes them in address order
+        for (int i = BLOCKS_PER_SLAB - 1; i >= 0; i--) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(firstBlock + i * _blockSize);
+            block->next = _freeBlocks;
+            _freeBlocks = block;
+        }
+        _freeBlockCount += BLOCKS_PER_SLAB;
+    }
+
+    FreeBlock* block = _freeBlocks;
+    _freeBlocks = block->next;
+    _freeBlockCount--;
+    return block;
+}
+
+void OctreeElementPool::release(void* block, size_t size) {
+    if (!block) {
+        return;
+    }
+    if (size != _requestedSize) {
+        ::operator delete(block);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = _freeBlocks;
+    _freeBlocks = freeBlock;
+    _freeBlockCount++;
+}
+
+int OctreeElementPool::getSlabCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_slabs.size();
+}
+
+int OctreeElementPool::getFreeBlockCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _freeBlockCount;
+}
@@ -0,0 +1,50 @@
+//
+//  OctreeElementPool.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeElementPool_h
+#define hifi_OctreeElementPool_h
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QtGlobal>
+
+/// Blocks of one size for the elements of a type, carved out of slabs so the elements of a tree sit close together in
+/// memory and creating one doesn't go through the allocator. Element types hand their operator new and delete to a
+/// pool of their own. Blocks can be freed from any thread, the slabs are kept for the life of the process.
+class OctreeElementPool {
+public:
+    static const int BLOCKS_PER_SLAB = 256;
+
+    OctreeElementPool(size_t blockSize);
+
+    /// sizes other than the block size, like the ones of subclasses, go to the allocator
+    void* allocate(size_t size);
+    void release(void* block, size_t size);
+
+    int getSlabCount() const;
+    int getFreeBlockCount() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    const size_t _requestedSize;
+    const size_t _blockSize;
+
+    mutable std::mutex _mutex;
+    FreeBlock* _freeBlocks { nullptr };
+    int _freeBlockCount { 0 };
+    std::vector<std::unique_ptr<char[]>> _slabs;
+};
+
+#endif // hifi_OctreeElementPool_h
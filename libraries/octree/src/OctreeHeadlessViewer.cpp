@@ -66,6 +66,7 @@ void OctreeHeadlessViewer::queryOctree() {
 
     _octreeQuery.setOctreeSizeScale(getVoxelSizeScale());
     _octreeQuery.setBoundaryLevelAdjust(getBoundaryLevelAdjust());
+    _octreeQuery.setInterestVolumes(_viewFrustum.getInterestVolumes());
 
     // Iterate all of the nodes, and get a count of how many voxel servers we have...
     int totalServers = 0;
@@ -204,6 +205,7 @@ void OctreeHeadlessViewer::queryOctree() {
                     _octreeQuery.setCameraOrientation(OFF_IN_NEGATIVE_SPACE);
                     _octreeQuery.setCameraNearClip(0.1f);
                     _octreeQuery.setCameraFarClip(0.1f);
+                    _octreeQuery.setInterestVolumes(QVector<InterestVolume>());
                     if (wantExtraDebugging) {
                         qCDebug(octree) << "Using 'minimal' camera position for node" << *node;
                     }
@@ -231,6 +233,28 @@ void OctreeHeadlessViewer::queryOctree() {
 }
 
 
+void OctreeHeadlessViewer::addInterestSphere(const glm::vec3& center, float radius, float priority) {
+    QVector<InterestVolume> interestVolumes = _viewFrustum.getInterestVolumes();
+    if (interestVolumes.size() >= MAX_INTEREST_VOLUMES) {
+        qCDebug(octree) << "OctreeHeadlessViewer::addInterestSphere() already has" << MAX_INTEREST_VOLUMES
+                        << "interest volumes, ignoring sphere";
+        return;
+    }
+    interestVolumes.push_back(InterestVolume(center, radius, priority));
+    _viewFrustum.setInterestVolumes(interestVolumes);
+}
+
+void OctreeHeadlessViewer::addInterestBox(const glm::vec3& corner, const glm::vec3& dimensions, float priority) {
+    QVector<InterestVolume> interestVolumes = _viewFrustum.getInterestVolumes();
+    if (interestVolumes.size() >= MAX_INTEREST_VOLUMES) {
+        qCDebug(octree) << "OctreeHeadlessViewer::addInterestBox() already has" << MAX_INTEREST_VOLUMES
+                        << "interest volumes, ignoring box";
+        return;
+    }
+    interestVolumes.push_back(InterestVolume(AABox(corner, dimensions), priority));
+    _viewFrustum.setInterestVolumes(interestVolumes);
+}
+
 int OctreeHeadlessViewer::parseOctreeStats(QSharedPointer<NLPacket> packet, SharedNodePointer sourceNode) {
 
     OctreeSceneStats temp;
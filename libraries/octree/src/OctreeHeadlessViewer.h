@@ -48,6 +48,11 @@ public slots:
     void setOrientation(const glm::quat& orientation) { _viewFrustum.setOrientation(orientation); }
     void setKeyholeRadius(float keyholdRadius) { _viewFrustum.setKeyholeRadius(keyholdRadius); }
 
+    // interest volumes the servers send in addition to the view, so that a script can subscribe to just a region
+    void addInterestSphere(const glm::vec3& center, float radius, float priority = DEFAULT_INTEREST_PRIORITY);
+    void addInterestBox(const glm::vec3& corner, const glm::vec3& dimensions, float priority = DEFAULT_INTEREST_PRIORITY);
+    void clearInterestVolumes() { _viewFrustum.setInterestVolumes(QVector<InterestVolume>()); }
+
     // setters for LOD and PPS
     void setVoxelSizeScale(float sizeScale) { _voxelSizeScale = sizeScale; }
     void setBoundaryLevelAdjust(int boundaryLevelAdjust) { _boundaryLevelAdjust = boundaryLevelAdjust; }
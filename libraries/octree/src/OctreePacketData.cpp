@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <zlib.h>
+
 #include <GLMHelpers.h>
 #include <PerfStat.h>
 
@@ -23,16 +25,31 @@ AtomicUIntStat OctreePacketData::_totalBytesOfValues { 0 };
 AtomicUIntStat OctreePacketData::_totalBytesOfPositions { 0 };
 AtomicUIntStat OctreePacketData::_totalBytesOfRawData { 0 };
 
-OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) {
+OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) :
+    _uncompressed(_uncompressedBuffer)
+{
     changeSettings(enableCompression, targetSize); // does reset...
 }
 
 void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize) {
     _enableCompression = enableCompression;
     _targetSize = std::min(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE, targetSize);
+    bindUncompressedBuffer();
     reset();
 }
 
+void OctreePacketData::setTargetPacket(NLPacket* packet) {
+    _targetPacket = packet;
+}
+
+void OctreePacketData::bindUncompressedBuffer() {
+    _uncompressed = _uncompressedBuffer;
+
+    if (_targetPacket && !_enableCompression && _targetPacket->bytesAvailableForWrite() >= (qint64)_targetSize) {
+        _uncompressed = reinterpret_cast<unsigned char*>(_targetPacket->getPayload() + _targetPacket->pos());
+    }
+}
+
 void OctreePacketData::reset() {
     _bytesInUse = 0;
     _bytesAvailable = _targetSize;
@@ -49,6 +66,10 @@ void OctreePacketData::reset() {
 }
 
 OctreePacketData::~OctreePacketData() {
+    if (_deflateStream) {
+        deflateEnd(_deflateStream);
+        delete _deflateStream;
+    }
 }
 
 bool OctreePacketData::append(const unsigned char* data, int length) {
@@ -488,6 +509,30 @@ bool OctreePacketData::appendRawData(QByteArray data) {
 }
 
 
+// The sections are small, so deflate starts each of them from a preset dictionary of what the entities encode the most:
+// the strings of their urls and user data, and the floats of their default properties. zlib matches best against the
+// end of the dictionary, where the most common of them are. The server and the viewers must use the same dictionary, any
+// change to it needs a new entity packet version.
+static const char COMPRESSION_DICTIONARY[] =
+    "file:///atp:.obj.jpg.wav.json.mp3.svo.js?"
+    "\"textures\":{\"tex.\":\"http://hifi-public.s3.amazonaws.com/"
+    "{\"wantsTrigger\":true}{\"resetMe\":{\"resetMe\":true}}"
+    "{\"grabbableKey\":{\"grabbable\":false}}"
+    "{\"grabbableKey\":{\"grabbable\":true,\"invertSolidWhileHeld\":true}}"
+    "SphereCubeBoxModelTextLightZoneWebLineParticlesPolyVox"
+    "https://.png.fbx"
+    "\xcd\xcc\x1c\xc1" // -9.8
+    "\x00\x00\x00\x3f" // 0.5
+    "\xcd\xcc\xcc\x3d" // 0.1
+    "\x00\x00\x80\xbf" // -1.0
+    "\x00\x00\x80\x3f\x00\x00\x80\x3f\x00\x00\x80\x3f" // 1.0, 1.0, 1.0
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"; // 0.0, 0.0, 0.0
+static const uInt COMPRESSION_DICTIONARY_SIZE = sizeof(COMPRESSION_DICTIONARY) - 1; // without the null
+
+// a window of the size of the sections and the dictionary, rather than zlib's 32 KB one
+static const int COMPRESSION_WINDOW_BITS = 12;
+static const int COMPRESSION_LEVEL = 9;
+
 AtomicUIntStat OctreePacketData::_compressContentTime { 0 };
 AtomicUIntStat OctreePacketData::_compressContentCalls { 0 };
 
@@ -501,24 +546,33 @@ bool OctreePacketData::compressContent() {
 
     _bytesInUseLastCheck = _bytesInUse;
 
-    bool success = false;
-    const int MAX_COMPRESSION = 9;
-
-    // we only want to compress the data payload, not the message header
-    const uchar* uncompressedData = &_uncompressed[0];
-    int uncompressedSize = _bytesInUse;
+    if (!_deflateStream) {
+        _deflateStream = new z_stream_s();
+        if (deflateInit2(_deflateStream, COMPRESSION_LEVEL, Z_DEFLATED, COMPRESSION_WINDOW_BITS, MAX_MEM_LEVEL,
+                         Z_DEFAULT_STRATEGY) != Z_OK) {
+            delete _deflateStream;
+            _deflateStream = nullptr;
+            return false;
+        }
+    } else if (deflateReset(_deflateStream) != Z_OK) {
+        return false;
+    }
+    deflateSetDictionary(_deflateStream, reinterpret_cast<const Bytef*>(COMPRESSION_DICTIONARY),
+                         COMPRESSION_DICTIONARY_SIZE);
 
-    QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
+    // we only want to compress the data payload, not the message header, straight into our buffer
+    _deflateStream->next_in = &_uncompressed[0];
+    _deflateStream->avail_in = _bytesInUse;
+    _deflateStream->next_out = &_compressed[0];
+    _deflateStream->avail_out = MAX_OCTREE_PACKET_DATA_SIZE - 1;
 
-    if (compressedData.size() < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
-        _compressedBytes = compressedData.size();
-        for (int i = 0; i < _compressedBytes; i++) {
-            _compressed[i] = compressedData[i];
-        }
-        _dirty = false;
-        success = true;
+    // it does not fit if it could not finish in the space
+    if (deflate(_deflateStream, Z_FINISH) != Z_STREAM_END) {
+        return false;
     }
-    return success;
+    _compressedBytes = (int)_deflateStream->total_out;
+    _dirty = false;
+    return true;
 }
 
 
@@ -528,25 +582,34 @@ void OctreePacketData::loadFinalizedContent(const unsigned char* data, int lengt
     if (data && length > 0) {
 
         if (_enableCompression) {
-            QByteArray compressedData;
-            for (int i = 0; i < length; i++) {
-                compressedData[i] = data[i];
-                _compressed[i] = compressedData[i];
-            }
+            memcpy(_compressed, data, std::min(length, (int)sizeof(_compressed)));
             _compressedBytes = length;
-            QByteArray uncompressedData = qUncompress(compressedData);
-            if (uncompressedData.size() <= _bytesAvailable) {
-                _bytesInUse = uncompressedData.size();
-                _bytesAvailable -= uncompressedData.size();
 
-                for (int i = 0; i < _bytesInUse; i++) {
-                    _uncompressed[i] = uncompressedData[i];
-                }
+            z_stream stream = z_stream();
+            if (inflateInit2(&stream, COMPRESSION_WINDOW_BITS) != Z_OK) {
+                return;
             }
-        } else {
-            for (int i = 0; i < length; i++) {
-                _uncompressed[i] = _compressed[i] = data[i];
+            stream.next_in = const_cast<Bytef*>(data);
+            stream.avail_in = length;
+            stream.next_out = &_uncompressed[0];
+            stream.avail_out = _bytesAvailable;
+
+            int result = inflate(&stream, Z_FINISH);
+            if (result == Z_NEED_DICT) {
+                inflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(COMPRESSION_DICTIONARY),
+                                     COMPRESSION_DICTIONARY_SIZE);
+                result = inflate(&stream, Z_FINISH);
             }
+            if (result == Z_STREAM_END) {
+                _bytesInUse = (int)stream.total_out;
+                _bytesAvailable -= _bytesInUse;
+            } else if (_debug) {
+                qCDebug(octree, "OctreePacketData::loadFinalizedContent()... could not uncompress, result = %d", result);
+            }
+            inflateEnd(&stream);
+        } else {
+            memcpy(_uncompressed, data, length);
+            memcpy(_compressed, data, length);
             _bytesInUse = _compressedBytes = length;
         }
     } else {
@@ -37,6 +37,8 @@
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
 
+struct z_stream_s;
+
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
 typedef unsigned char OCTREE_PACKET_FLAGS;
@@ -85,10 +87,19 @@ class OctreePacketData {
 public:
     OctreePacketData(bool enableCompression = false, int maxFinalizedSize = MAX_OCTREE_PACKET_DATA_SIZE);
     ~OctreePacketData();
+    OctreePacketData(const OctreePacketData&) = delete;
+    OctreePacketData& operator=(const OctreePacketData&) = delete;
 
     /// change compression and target size settings
     void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE);
 
+    /// encode uncompressed content straight into the packet at its write position instead of our own buffer, the packet
+    /// owner commits it with NLPacket::setPayloadSize once finalized. Takes effect on the next changeSettings, which must
+    /// be called while the packet is ready for new content. nullptr goes back to the internal buffer. Compressed content
+    /// is always built in our own buffers.
+    void setTargetPacket(NLPacket* packet);
+    bool isEncodingInPlace() const { return _uncompressed != _uncompressedBuffer; }
+
     /// reset completely, all data is discarded
     void reset();
     
@@ -218,7 +229,7 @@ public:
     /// load finalized content to allow access to decoded content for parsing
     void loadFinalizedContent(const unsigned char* data, int length);
     
-    /// returns whether or not zlib compression enabled on finalization
+    /// returns whether or not zlib compression, with the preset dictionary, enabled on finalization
     bool isCompressed() const { return _enableCompression; }
     
     /// returns the target uncompressed size
@@ -264,7 +275,11 @@ private:
     unsigned int _targetSize;
     bool _enableCompression;
     
-    unsigned char _uncompressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
+    void bindUncompressedBuffer();
+
+    NLPacket* _targetPacket { nullptr };
+    unsigned char* _uncompressed; // points at _uncompressedBuffer or into the payload of _targetPacket
+    unsigned char _uncompressedBuffer[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
     int _bytesInUse;
     int _bytesAvailable;
     int _subTreeAt;
@@ -272,7 +287,8 @@ private:
     int _subTreeBytesReserved; // the number of reserved bytes at start of a subtree
 
     bool compressContent();
-    
+
+    z_stream_s* _deflateStream { nullptr }; // kept from packet to packet, rather than allocated for each
     unsigned char _compressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
     int _compressedBytes;
     int _bytesInUseLastCheck;
@@ -30,6 +30,8 @@
 #include "OctreePersistThread.h"
 
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
+const int OctreePersistThread::DEFAULT_JOURNAL_INTERVAL = 1000; // every second
+const int OctreePersistThread::DEFAULT_COMPACT_INTERVAL = 1000 * 60 * 10; // every 10 minutes
 
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, int persistInterval,
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
@@ -43,16 +45,34 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _wantBackup(wantBackup),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _journalInterval(DEFAULT_JOURNAL_INTERVAL),
+    _compactInterval(DEFAULT_COMPACT_INTERVAL),
+    _journaling(false),
+    _lastJournalWrite(0)
 {
     parseSettings(settings);
 
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
     _filename = sansExt + "." + _persistAsFileType;
+    _journalFilename = _filename + ".journal";
+}
+
+static int readIntSetting(const QJsonValue& value, int defaultValue) {
+    if (value.isString()) {
+        return value.toString().toInt();
+    } else if (value.isDouble()) {
+        return value.toInt();
+    }
+    return defaultValue;
 }
 
 void OctreePersistThread::parseSettings(const QJsonObject& settings) {
+    _journalInterval = readIntSetting(settings["journalInterval"], DEFAULT_JOURNAL_INTERVAL);
+    _compactInterval = readIntSetting(settings["compactInterval"], DEFAULT_COMPACT_INTERVAL);
+    qCDebug(octree) << "journalInterval:" << _journalInterval << "compactInterval:" << _compactInterval;
+
     if (settings["backups"].isArray()) {
         const QJsonArray& backupRules = settings["backups"].toArray();
         qCDebug(octree) << "BACKUP RULES:";
@@ -149,13 +169,23 @@ bool OctreePersistThread::process() {
             }
 
             persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+
+            // the svo format can't be written in pieces, and a zero interval asks for the old full rewrites
+            if (_persistAsFileType != "svo" && _journalInterval > 0) {
+                replayJournal();
+                _journaling = _tree->startJournal();
+            }
+
             _tree->pruneTree();
         });
 
         quint64 loadDone = usecTimestampNow();
         _loadTimeUSecs = loadDone - loadStarted;
 
-        _tree->clearDirtyBit(); // the tree is clean since we just loaded it
+        // the tree is clean since we just loaded it, unless the journal still has to be compacted into the file
+        if (!QFile::exists(_journalFilename)) {
+            _tree->clearDirtyBit();
+        }
         qCDebug(octree, "DONE loading Octrees from file... fileRead=%s", debug::valueOf(persistantFileRead));
 
         unsigned long nodeCount = OctreeElement::getNodeCount();
@@ -180,6 +210,7 @@ bool OctreePersistThread::process() {
 
         // Since we just loaded the persistent file, we can consider ourselves as having "just checked" for persistance.
         _lastCheck = usecTimestampNow(); // we just loaded, no need to save again
+        _lastJournalWrite = _lastCheck;
         
         // This last persist time is not really used until the file is actually persisted. It is only
         // used in formatting the backup filename in cases of non-rolling backup names. However, we don't
@@ -198,8 +229,14 @@ bool OctreePersistThread::process() {
         _tree->update();
 
         quint64 now = usecTimestampNow();
+
+        if (_journaling && now - _lastJournalWrite > (quint64)_journalInterval * MSECS_TO_USECS) {
+            _lastJournalWrite = now;
+            writeJournal();
+        }
+
         quint64 sinceLastSave = now - _lastCheck;
-        quint64 intervalToCheck = _persistInterval * MSECS_TO_USECS;
+        quint64 intervalToCheck = (_journaling ? _compactInterval : _persistInterval) * MSECS_TO_USECS;
 
         if (sinceLastSave > intervalToCheck) {
             _lastCheck = now;
@@ -224,12 +261,22 @@ bool OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
-    persist();
+    if (_journaling) {
+        // the journal is as good as a save, leave the compaction for the next start
+        writeJournal();
+    } else {
+        persist();
+    }
     qCDebug(octree) << "Persist thread done with about to finish...";
     _stopThread = true;
 }
 
 void OctreePersistThread::persist() {
+    if (_journaling) {
+        compact();
+        return;
+    }
+
     if (_tree->isDirty()) {
 
         _tree->withWriteLock([&] {
@@ -262,6 +309,121 @@ void OctreePersistThread::persist() {
     }
 }
 
+void OctreePersistThread::writeJournal() {
+    QVariantList entries;
+    _tree->withReadLock([&] {
+        _tree->takeJournalEntries(entries);
+    });
+
+    if (!entries.isEmpty()) {
+        appendToJournal(entries);
+    }
+}
+
+bool OctreePersistThread::appendToJournal(const QVariantList& entries) {
+    QFile journalFile(_journalFilename);
+    if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCDebug(octree) << "ERROR could not open Octree journal:" << _journalFilename;
+        return false;
+    }
+
+    // one compact JSON document per line, so a line cut short by a crash only loses itself
+    QByteArray journalData;
+    foreach (const QVariant& entry, entries) {
+        journalData += QJsonDocument::fromVariant(entry).toJson(QJsonDocument::Compact);
+        journalData += '\n';
+    }
+
+    bool written = journalFile.write(journalData) == journalData.size() && journalFile.flush();
+    if (!written) {
+        qCDebug(octree) << "ERROR while writing Octree journal:" << _journalFilename;
+    }
+    return written;
+}
+
+void OctreePersistThread::replayJournal() {
+    QFile journalFile(_journalFilename);
+    if (!journalFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    qCDebug(octree) << "replaying Octree journal:" << _journalFilename << "...";
+
+    int entriesRead = 0;
+    int entriesSkipped = 0;
+    while (!journalFile.atEnd()) {
+        QByteArray line = journalFile.readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonDocument entry = QJsonDocument::fromJson(line);
+        if (entry.isObject() && _tree->readJournalEntry(entry.toVariant().toMap())) {
+            ++entriesRead;
+        } else {
+            ++entriesSkipped;
+        }
+    }
+
+    qCDebug(octree) << "DONE replaying Octree journal... entries:" << entriesRead << "skipped:" << entriesSkipped;
+}
+
+void OctreePersistThread::compact() {
+    if (!_tree->isDirty()) {
+        return;
+    }
+
+    _tree->withWriteLock([&] {
+        _tree->pruneTree();
+    });
+
+    backup(); // handle backup if requested
+
+    // create our "lock" file to indicate we're saving.
+    QString lockFileName = _filename + ".lock";
+    std::ofstream lockFile(qPrintable(lockFileName), std::ios::out|std::ios::binary);
+    if (!lockFile.is_open()) {
+        return;
+    }
+
+    PerformanceWarning warn(true, "Compacting Octree journal", true);
+
+    // the snapshot and the last journal entries are taken together so that replaying the whole journal over the
+    // snapshot gives back the snapshot, only this part has to see a stable tree
+    QVariantMap entityDescription;
+    QVariantList entries;
+    bool mapped = false;
+    _tree->withReadLock([&] {
+        _tree->takeJournalEntries(entries);
+        mapped = _tree->writeToJSONMap(entityDescription);
+    });
+
+    // if we die before the snapshot is written, a backup gets restored at startup and needs these entries
+    bool journaled = entries.isEmpty() || appendToJournal(entries);
+
+    bool written = false;
+    if (mapped && journaled) {
+        if (_persistAsFileType == "entities") {
+            written = _tree->writeBinaryMapToFile(qPrintable(_filename), entityDescription);
+        } else {
+            written = _tree->writeJSONMapToFile(qPrintable(_filename), entityDescription, _persistAsFileType == "json.gz");
+        }
+    }
+
+    if (written) {
+        // everything in the journal is in the snapshot now
+        QFile::remove(_journalFilename);
+        time(&_lastPersistTime);
+        _tree->clearDirtyBit();
+        qCDebug(octree) << "DONE compacting Octree journal into" << _filename;
+    } else {
+        qCDebug(octree) << "ERROR while compacting Octree journal into" << _filename;
+    }
+
+    lockFile.close();
+    remove(qPrintable(lockFileName));
+}
+
 void OctreePersistThread::restoreFromMostRecentBackup() {
     qCDebug(octree) << "Restoring from most recent backup...";
     
@@ -32,6 +32,8 @@ public:
     };
 
     static const int DEFAULT_PERSIST_INTERVAL;
+    static const int DEFAULT_JOURNAL_INTERVAL;
+    static const int DEFAULT_COMPACT_INTERVAL;
 
     OctreePersistThread(OctreePointer tree, const QString& filename, int persistInterval = DEFAULT_PERSIST_INTERVAL,
                         bool wantBackup = false, const QJsonObject& settings = QJsonObject(),
@@ -50,6 +52,10 @@ protected:
     virtual bool process();
 
     void persist();
+    void compact();
+    void writeJournal();
+    bool appendToJournal(const QVariantList& entries);
+    void replayJournal();
     void backup();
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
@@ -74,6 +80,14 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    // with a journal the changes are appended to it as they happen, and the full file is only rewritten when the
+    // journal is compacted into it
+    int _journalInterval;
+    int _compactInterval;
+    bool _journaling;
+    QString _journalFilename;
+    quint64 _lastJournalWrite;
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -9,6 +9,10 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
+#include <glm/gtc/matrix_transform.hpp>
+
 #include <GLMHelpers.h>
 #include <udt/PacketHeaders.h>
 
@@ -59,6 +63,27 @@ int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
     // desired boundaryLevelAdjust
     memcpy(destinationBuffer, &_boundaryLevelAdjust, sizeof(_boundaryLevelAdjust));
     destinationBuffer += sizeof(_boundaryLevelAdjust);
+
+    // interest volumes, last so that servers that don't know about them can ignore them
+    int numberOfVolumes = std::min(_interestVolumes.size(), MAX_INTEREST_VOLUMES);
+    *destinationBuffer++ = (unsigned char)numberOfVolumes;
+    for (int i = 0; i < numberOfVolumes; i++) {
+        destinationBuffer += _interestVolumes[i].pack(destinationBuffer);
+    }
+
+    // the scene the client kept, after the interest volumes for the same reason
+    memcpy(destinationBuffer, &_cachedSceneTime, sizeof(_cachedSceneTime));
+    destinationBuffer += sizeof(_cachedSceneTime);
+    if (_cachedSceneTime > 0) {
+        glm::vec3 position = _cachedSceneView.getPosition();
+        memcpy(destinationBuffer, &position, sizeof(position));
+        destinationBuffer += sizeof(position);
+        destinationBuffer += packOrientationQuatToBytes(destinationBuffer, _cachedSceneView.getOrientation());
+        destinationBuffer += packFloatAngleToTwoByte(destinationBuffer, _cachedSceneView.getFieldOfView());
+        destinationBuffer += packFloatRatioToTwoByte(destinationBuffer, _cachedSceneView.getAspectRatio());
+        destinationBuffer += packClipValueToTwoByte(destinationBuffer, _cachedSceneView.getNearClip());
+        destinationBuffer += packClipValueToTwoByte(destinationBuffer, _cachedSceneView.getFarClip());
+    }
     
     return destinationBuffer - bufferStart;
 }
@@ -101,6 +126,55 @@ int OctreeQuery::parseData(NLPacket& packet) {
     memcpy(&_boundaryLevelAdjust, sourceBuffer, sizeof(_boundaryLevelAdjust));
     sourceBuffer += sizeof(_boundaryLevelAdjust);
 
+    // interest volumes, which queries from older clients don't have
+    _interestVolumes.clear();
+    _cachedSceneTime = 0;
+    int bytesLeftToRead = (int)packet.getPayloadSize() - (int)(sourceBuffer - startPosition);
+    if (bytesLeftToRead > 0) {
+        int numberOfVolumes = std::min((int)*sourceBuffer++, MAX_INTEREST_VOLUMES);
+        bytesLeftToRead--;
+        for (int i = 0; i < numberOfVolumes; i++) {
+            InterestVolume volume;
+            int bytesRead = volume.unpack(sourceBuffer, bytesLeftToRead);
+            if (bytesRead == 0) {
+                break;
+            }
+            _interestVolumes.push_back(volume);
+            sourceBuffer += bytesRead;
+            bytesLeftToRead -= bytesRead;
+        }
+    }
+
+    // the scene the client kept, which only newer clients send
+    const int CAMERA_BYTES = sizeof(glm::vec3) + 8 * sizeof(uint16_t); // the orientation packs in four of them
+    quint64 cachedSceneTime = 0;
+    bytesLeftToRead = (int)packet.getPayloadSize() - (int)(sourceBuffer - startPosition);
+    if (bytesLeftToRead >= (int)sizeof(cachedSceneTime)) {
+        memcpy(&cachedSceneTime, sourceBuffer, sizeof(cachedSceneTime));
+        sourceBuffer += sizeof(cachedSceneTime);
+        bytesLeftToRead -= sizeof(cachedSceneTime);
+    }
+    if (cachedSceneTime > 0 && bytesLeftToRead >= CAMERA_BYTES) {
+        glm::vec3 position;
+        glm::quat orientation;
+        float fov, aspectRatio, nearClip, farClip;
+        memcpy(&position, sourceBuffer, sizeof(position));
+        sourceBuffer += sizeof(position);
+        sourceBuffer += unpackOrientationQuatFromBytes(sourceBuffer, orientation);
+        sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &fov);
+        sourceBuffer += unpackFloatRatioFromTwoByte(sourceBuffer, aspectRatio);
+        sourceBuffer += unpackClipValueFromTwoByte(sourceBuffer, nearClip);
+        sourceBuffer += unpackClipValueFromTwoByte(sourceBuffer, farClip);
+
+        if (aspectRatio > 0.0f && nearClip > 0.0f && nearClip < farClip) {
+            _cachedSceneTime = cachedSceneTime;
+            _cachedSceneView = ViewFrustum();
+            _cachedSceneView.setPosition(position);
+            _cachedSceneView.setOrientation(orientation);
+            _cachedSceneView.setProjection(glm::perspective(glm::radians(fov), aspectRatio, nearClip, farClip));
+        }
+    }
+
     return sourceBuffer - startPosition;
 }
 
@@ -31,8 +31,13 @@ typedef unsigned long long quint64;
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <QVector>
+
 #include <NodeData.h>
 
+#include "InterestVolume.h"
+#include "ViewFrustum.h"
+
 // First bitset
 const int WANT_LOW_RES_MOVING_BIT = 0;
 const int WANT_COLOR_AT_BIT = 1;
@@ -80,6 +85,16 @@ public:
     float getOctreeSizeScale() const { return _octreeElementSizeScale; }
     int getBoundaryLevelAdjust() const { return _boundaryLevelAdjust; }
 
+    // volumes the server sends in addition to the camera frustum, up to MAX_INTEREST_VOLUMES of them
+    const QVector<InterestVolume>& getInterestVolumes() const { return _interestVolumes; }
+    void setInterestVolumes(const QVector<InterestVolume>& interestVolumes) { _interestVolumes = interestVolumes; }
+
+    // the scene the client kept from an earlier visit: the start, in the server's time, of the last scene it was sent
+    // and the view that scene was for, with a time of 0 when it has none
+    quint64 getCachedSceneTime() const { return _cachedSceneTime; }
+    const ViewFrustum& getCachedSceneView() const { return _cachedSceneView; }
+    void setCachedScene(quint64 sceneTime, const ViewFrustum& view) { _cachedSceneTime = sceneTime; _cachedSceneView = view; }
+
 public slots:
     void setWantLowResMoving(bool wantLowResMoving) { _wantLowResMoving = wantLowResMoving; }
     void setWantColor(bool wantColor) { _wantColor = wantColor; }
@@ -109,6 +124,9 @@ protected:
     int _maxQueryPPS = DEFAULT_MAX_OCTREE_PPS;
     float _octreeElementSizeScale = DEFAULT_OCTREE_SIZE_SCALE; /// used for LOD calculations
     int _boundaryLevelAdjust = 0; /// used for LOD calculations
+    QVector<InterestVolume> _interestVolumes;
+    quint64 _cachedSceneTime = 0;
+    ViewFrustum _cachedSceneView;
 
 private:
     // privatize the copy constructor and assignment operator so they cannot be called
@@ -42,12 +42,6 @@ void OctreeRenderer::setTree(OctreePointer newTree) {
 }
 
 void OctreeRenderer::processDatagram(NLPacket& packet, SharedNodePointer sourceNode) {
-    bool extraDebugging = false;
-
-    if (extraDebugging) {
-        qCDebug(octree) << "OctreeRenderer::processDatagram()";
-    }
-
     if (!_tree) {
         qCDebug(octree) << "OctreeRenderer::processDatagram() called before init, calling init()...";
         this->init();
@@ -55,144 +49,137 @@ void OctreeRenderer::processDatagram(NLPacket& packet, SharedNodePointer sourceN
 
     bool showTimingDetails = false; // Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showTimingDetails, "OctreeRenderer::processDatagram()", showTimingDetails);
-    
-    if (packet.getType() == getExpectedPacketType()) {
-        PerformanceWarning warn(showTimingDetails, "OctreeRenderer::processDatagram expected PacketType", showTimingDetails);
-        // if we are getting inbound packets, then our tree is also viewing, and we should remember that fact.
-        _tree->setIsViewing(true);
-        
-        OCTREE_PACKET_FLAGS flags;
-        packet.readPrimitive(&flags);
-        
-        OCTREE_PACKET_SEQUENCE sequence;
-        packet.readPrimitive(&sequence);
-
-        OCTREE_PACKET_SENT_TIME sentAt;
-        packet.readPrimitive(&sentAt);
-
-        bool packetIsColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
-        bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
-        
-        OCTREE_PACKET_SENT_TIME arrivedAt = usecTimestampNow();
-        int clockSkew = sourceNode ? sourceNode->getClockSkewUsec() : 0;
-        int flightTime = arrivedAt - sentAt + clockSkew;
-
-        OCTREE_PACKET_INTERNAL_SECTION_SIZE sectionLength = 0;
-
-        if (extraDebugging) {
-            qCDebug(octree, "OctreeRenderer::processDatagram() ... Got Packet Section"
-                   " color:%s compressed:%s sequence: %u flight:%d usec size:%lld data:%lld",
-                   debug::valueOf(packetIsColored), debug::valueOf(packetIsCompressed),
-                   sequence, flightTime, packet.getDataSize(), packet.bytesLeftToRead());
-        }
-        
-        _packetsInLastWindow++;
-        
-        int elementsPerPacket = 0;
-        int entitiesPerPacket = 0;
-        
-        quint64 totalWaitingForLock = 0;
-        quint64 totalUncompress = 0;
-        quint64 totalReadBitsteam = 0;
-
-        const QUuid& sourceUUID = packet.getSourceID();
-        
-        int subsection = 1;
-        
-        bool error = false;
-        
-        while (packet.bytesLeftToRead() > 0 && !error) {
-            if (packetIsCompressed) {
-                if (packet.bytesLeftToRead() > (qint64) sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE)) {
-                    packet.readPrimitive(&sectionLength);
-                } else {
-                    sectionLength = 0;
-                    error = true;
-                }
+
+    auto decodedPacket = decodeDatagram(packet, sourceNode);
+    if (decodedPacket) {
+        quint64 startLock = usecTimestampNow();
+        _tree->withWriteLock([&] {
+            applyDecodedPacket(*decodedPacket, usecTimestampNow() - startLock);
+        });
+    }
+}
+
+std::shared_ptr<DecodedOctreePacket> OctreeRenderer::decodeDatagram(NLPacket& packet, SharedNodePointer sourceNode) const {
+    if (packet.getType() != getExpectedPacketType()) {
+        return std::shared_ptr<DecodedOctreePacket>();
+    }
+    OctreePointer tree = _tree;
+
+    OCTREE_PACKET_FLAGS flags;
+    packet.readPrimitive(&flags);
+
+    OCTREE_PACKET_SEQUENCE sequence;
+    packet.readPrimitive(&sequence);
+
+    OCTREE_PACKET_SENT_TIME sentAt;
+    packet.readPrimitive(&sentAt);
+
+    bool packetIsColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
+    bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
+
+    auto decodedPacket = std::make_shared<DecodedOctreePacket>();
+    decodedPacket->sourceUUID = packet.getSourceID();
+    decodedPacket->sourceNode = sourceNode;
+    decodedPacket->version = packet.getVersion();
+    decodedPacket->isColored = packetIsColored;
+
+    quint64 startUncompress = usecTimestampNow();
+    OCTREE_PACKET_INTERNAL_SECTION_SIZE sectionLength = 0;
+    bool error = false;
+
+    while (packet.bytesLeftToRead() > 0 && !error) {
+        if (packetIsCompressed) {
+            if (packet.bytesLeftToRead() > (qint64) sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE)) {
+                packet.readPrimitive(&sectionLength);
             } else {
-                sectionLength = packet.bytesLeftToRead();
+                sectionLength = 0;
+                error = true;
             }
-            
-            if (sectionLength) {
-                // ask the VoxelTree to read the bitstream into the tree
-                ReadBitstreamToTreeParams args(packetIsColored ? WANT_COLOR : NO_COLOR, WANT_EXISTS_BITS, NULL,
-                                                sourceUUID, sourceNode, false, packet.getVersion());
-                quint64 startUncompress, startLock = usecTimestampNow();
-                quint64 startReadBitsteam, endReadBitsteam;
-                // FIXME STUTTER - there may be an opportunity to bump this lock outside of the
-                // loop to reduce the amount of locking/unlocking we're doing
-                _tree->withWriteLock([&] {
-                    startUncompress = usecTimestampNow();
-
-                    OctreePacketData packetData(packetIsCompressed);
-                    packetData.loadFinalizedContent(reinterpret_cast<unsigned char*>(packet.getPayload() + packet.pos()),
-                        sectionLength);
-                    if (extraDebugging) {
-                        qCDebug(octree, "OctreeRenderer::processDatagram() ... Got Packet Section"
-                            " color:%s compressed:%s sequence: %u flight:%d usec size:%lld data:%lld"
-                            " subsection:%d sectionLength:%d uncompressed:%d",
-                            debug::valueOf(packetIsColored), debug::valueOf(packetIsCompressed),
-                            sequence, flightTime, packet.getDataSize(), packet.bytesLeftToRead(), subsection, sectionLength,
-                            packetData.getUncompressedSize());
-                    }
-
-                    if (extraDebugging) {
-                        qCDebug(octree) << "OctreeRenderer::processDatagram() ******* START _tree->readBitstreamToTree()...";
-                    }
-                    startReadBitsteam = usecTimestampNow();
-                    _tree->readBitstreamToTree(packetData.getUncompressedData(), packetData.getUncompressedSize(), args);
-                    endReadBitsteam = usecTimestampNow();
-                    if (extraDebugging) {
-                        qCDebug(octree) << "OctreeRenderer::processDatagram() ******* END _tree->readBitstreamToTree()...";
-                    }
-                });
-                
-                // seek forwards in packet
-                packet.seek(packet.pos() + sectionLength);
-
-                elementsPerPacket += args.elementsPerPacket;
-                entitiesPerPacket += args.entitiesPerPacket;
-
-                _elementsInLastWindow += args.elementsPerPacket;
-                _entitiesInLastWindow += args.entitiesPerPacket;
-
-                totalWaitingForLock += (startUncompress - startLock);
-                totalUncompress += (startReadBitsteam - startUncompress);
-                totalReadBitsteam += (endReadBitsteam - startReadBitsteam);
+        } else {
+            sectionLength = packet.bytesLeftToRead();
+        }
 
+        if (sectionLength) {
+            OctreePacketData packetData(packetIsCompressed);
+            packetData.loadFinalizedContent(reinterpret_cast<unsigned char*>(packet.getPayload() + packet.pos()),
+                sectionLength);
+
+            DecodedOctreePacket::Section section;
+            section.bitstream = QByteArray(reinterpret_cast<const char*>(packetData.getUncompressedData()),
+                                           packetData.getUncompressedSize());
+            if (tree) {
+                ReadBitstreamToTreeParams args(packetIsColored ? WANT_COLOR : NO_COLOR, WANT_EXISTS_BITS, NULL,
+                                               decodedPacket->sourceUUID, sourceNode, false, decodedPacket->version);
+                section.predecoded = tree->predecodeBitstream(reinterpret_cast<const unsigned char*>(section.bitstream.constData()),
+                                                              section.bitstream.size(), args);
             }
-            subsection++;
-        }
-        _elementsPerPacket.updateAverage(elementsPerPacket);
-        _entitiesPerPacket.updateAverage(entitiesPerPacket);
-
-        _waitLockPerPacket.updateAverage(totalWaitingForLock);
-        _uncompressPerPacket.updateAverage(totalUncompress);
-        _readBitstreamPerPacket.updateAverage(totalReadBitsteam);
-        
-        quint64 now = usecTimestampNow();
-        if (_lastWindowAt == 0) {
-            _lastWindowAt = now;
-        }
-        quint64 sinceLastWindow = now - _lastWindowAt;
-        
-        if (sinceLastWindow > USECS_PER_SECOND) {
-            float packetsPerSecondInWindow = (float)_packetsInLastWindow / (float)(sinceLastWindow / USECS_PER_SECOND);
-            float elementsPerSecondInWindow = (float)_elementsInLastWindow / (float)(sinceLastWindow / USECS_PER_SECOND);
-            float entitiesPerSecondInWindow = (float)_entitiesInLastWindow / (float)(sinceLastWindow / USECS_PER_SECOND);
-            _packetsPerSecond.updateAverage(packetsPerSecondInWindow);
-            _elementsPerSecond.updateAverage(elementsPerSecondInWindow);
-            _entitiesPerSecond.updateAverage(entitiesPerSecondInWindow);
-
-            _lastWindowAt = now;
-            _packetsInLastWindow = 0;
-            _elementsInLastWindow = 0;
-            _entitiesInLastWindow = 0;
+            decodedPacket->sections.push_back(section);
+
+            // seek forwards in packet
+            packet.seek(packet.pos() + sectionLength);
         }
     }
+    decodedPacket->decodeUsecs = usecTimestampNow() - startUncompress;
+    return decodedPacket;
+}
+
+void OctreeRenderer::applyDecodedPacket(const DecodedOctreePacket& decodedPacket, quint64 waitedForLockUsecs) {
+    // if we are getting inbound packets, then our tree is also viewing, and we should remember that fact.
+    _tree->setIsViewing(true);
+
+    _packetsInLastWindow++;
+
+    int elementsPerPacket = 0;
+    int entitiesPerPacket = 0;
+    quint64 totalReadBitsteam = 0;
+
+    for (auto& section : decodedPacket.sections) {
+        // ask the tree to read the bitstream, using what was read ahead of it
+        ReadBitstreamToTreeParams args(decodedPacket.isColored ? WANT_COLOR : NO_COLOR, WANT_EXISTS_BITS, NULL,
+                                       decodedPacket.sourceUUID, decodedPacket.sourceNode, false, decodedPacket.version);
+        args.predecoded = section.predecoded;
+
+        quint64 startReadBitsteam = usecTimestampNow();
+        _tree->readBitstreamToTree(reinterpret_cast<const unsigned char*>(section.bitstream.constData()),
+                                   section.bitstream.size(), args);
+        totalReadBitsteam += usecTimestampNow() - startReadBitsteam;
+
+        elementsPerPacket += args.elementsPerPacket;
+        entitiesPerPacket += args.entitiesPerPacket;
+    }
+
+    _elementsInLastWindow += elementsPerPacket;
+    _entitiesInLastWindow += entitiesPerPacket;
+
+    _elementsPerPacket.updateAverage(elementsPerPacket);
+    _entitiesPerPacket.updateAverage(entitiesPerPacket);
+
+    _waitLockPerPacket.updateAverage(waitedForLockUsecs);
+    _uncompressPerPacket.updateAverage(decodedPacket.decodeUsecs);
+    _readBitstreamPerPacket.updateAverage(totalReadBitsteam);
+
+    quint64 now = usecTimestampNow();
+    if (_lastWindowAt == 0) {
+        _lastWindowAt = now;
+    }
+    quint64 sinceLastWindow = now - _lastWindowAt;
+
+    if (sinceLastWindow > USECS_PER_SECOND) {
+        float packetsPerSecondInWindow = (float)_packetsInLastWindow / (float)(sinceLastWindow / USECS_PER_SECOND);
+        float elementsPerSecondInWindow = (float)_elementsInLastWindow / (float)(sinceLastWindow / USECS_PER_SECOND);
+        float entitiesPerSecondInWindow = (float)_entitiesInLastWindow / (float)(sinceLastWindow / USECS_PER_SECOND);
+        _packetsPerSecond.updateAverage(packetsPerSecondInWindow);
+        _elementsPerSecond.updateAverage(elementsPerSecondInWindow);
+        _entitiesPerSecond.updateAverage(entitiesPerSecondInWindow);
+
+        _lastWindowAt = now;
+        _packetsInLastWindow = 0;
+        _elementsInLastWindow = 0;
+        _entitiesInLastWindow = 0;
+    }
 }
 
-bool OctreeRenderer::renderOperation(OctreeElementPointer element, void* extraData) {
+bool OctreeRenderer::renderOperation(const OctreeElementPointer& element, void* extraData) {
     RenderArgs* args = static_cast<RenderArgs*>(extraData);
     if (element->isInView(*args->_viewFrustum)) {
         if (element->hasContent()) {
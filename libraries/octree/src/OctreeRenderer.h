@@ -13,7 +13,9 @@
 #define hifi_OctreeRenderer_h
 
 #include <glm/glm.hpp>
+#include <memory>
 #include <stdint.h>
+#include <vector>
 
 #include <QObject>
 
@@ -27,6 +29,21 @@
 
 class OctreeRenderer;
 
+/// An octree data packet uncompressed and read ahead of the tree by OctreeRenderer::decodeDatagram, on any thread
+class DecodedOctreePacket {
+public:
+    struct Section {
+        QByteArray bitstream; // uncompressed
+        PredecodedBitstreamPointer predecoded;
+    };
+
+    QUuid sourceUUID;
+    SharedNodePointer sourceNode;
+    PacketVersion version { 0 };
+    bool isColored { false };
+    std::vector<Section> sections;
+    quint64 decodeUsecs { 0 };
+};
 
 // Generic client side Octree renderer class.
 class OctreeRenderer : public QObject {
@@ -47,6 +64,13 @@ public:
     /// process incoming data
     virtual void processDatagram(NLPacket& packet, SharedNodePointer sourceNode);
 
+    /// Reads a data packet apart from the tree without locking it, so it can be called from any thread, null if the
+    /// packet isn't of the expected type. The tree should be initialized first, or nothing is read ahead of it.
+    std::shared_ptr<DecodedOctreePacket> decodeDatagram(NLPacket& packet, SharedNodePointer sourceNode) const;
+
+    /// Reads a decoded packet into the tree, the caller holds the write lock of the tree
+    void applyDecodedPacket(const DecodedOctreePacket& decodedPacket, quint64 waitedForLockUsecs = 0);
+
     /// initialize and GPU/rendering related resources
     virtual void init();
 
@@ -56,7 +80,7 @@ public:
     ViewFrustum* getViewFrustum() const { return _viewFrustum; }
     void setViewFrustum(ViewFrustum* viewFrustum) { _viewFrustum = viewFrustum; }
 
-    static bool renderOperation(OctreeElementPointer element, void* extraData);
+    static bool renderOperation(const OctreeElementPointer& element, void* extraData);
 
     /// clears the tree
     virtual void clear();
@@ -108,6 +108,7 @@ void OctreeSceneStats::copyFromOther(const OctreeSceneStats& other) {
     _existsBitsWritten = other._existsBitsWritten;
     _existsInPacketBitsWritten = other._existsInPacketBitsWritten;
     _treesRemoved = other._treesRemoved;
+    _resumedSceneTime = other._resumedSceneTime;
 
     // before copying the jurisdictions, delete any current values...
     if (_jurisdictionRoot) {
@@ -440,6 +441,9 @@ int OctreeSceneStats::packIntoPacket() {
         _statsPacket->writePrimitive(bytes);
     }
 
+    // last so that clients that don't know about it can ignore it
+    _statsPacket->writePrimitive(_resumedSceneTime);
+
     return _statsPacket->getPayloadSize();
 }
 
@@ -544,6 +548,12 @@ int OctreeSceneStats::unpackFromPacket(NLPacket& packet) {
         }
     }
 
+    // which stats from older servers don't have
+    _resumedSceneTime = 0;
+    if (packet.bytesLeftToRead() >= (qint64)sizeof(_resumedSceneTime)) {
+        packet.readPrimitive(&_resumedSceneTime);
+    }
+
     // running averages
     _elapsedAverage.updateAverage((float)_elapsed);
     unsigned long total = _existsInPacketBitsWritten + _colorSent;
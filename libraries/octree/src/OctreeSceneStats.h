@@ -149,11 +149,13 @@ public:
     const std::vector<unsigned char*>& getJurisdictionEndNodes() const { return _jurisdictionEndNodes; }
 
     bool isMoving() const { return _isMoving; }
+    quint64 getStartTime() const { return _start; }
     quint64 getTotalElements() const { return _totalElements; }
     quint64 getTotalInternal() const { return _totalInternal; }
     quint64 getTotalLeaves() const { return _totalLeaves; }
     quint64 getTotalEncodeTime() const { return _totalEncodeTime; }
     quint64 getElapsedTime() const { return _elapsed; }
+    quint64 getColorSent() const { return _colorSent; } // elements sent with their data so far this scene
 
     quint64 getLastFullElapsedTime() const { return _lastFullElapsed; }
     quint64 getLastFullTotalEncodeTime() const { return _lastFullTotalEncodeTime; }
@@ -171,6 +173,10 @@ public:
     const SequenceNumberStats& getIncomingOctreeSequenceNumberStats() const { return _incomingOctreeSequenceNumberStats; }
     SequenceNumberStats& getIncomingOctreeSequenceNumberStats() { return _incomingOctreeSequenceNumberStats; }
 
+    /// The cached scene of the client the server resumed from, see OctreeQuery::getCachedSceneTime, 0 when it did not
+    quint64 getResumedSceneTime() const { return _resumedSceneTime; }
+    void setResumedSceneTime(quint64 resumedSceneTime) { _resumedSceneTime = resumedSceneTime; }
+
 private:
 
     void copyFromOther(const OctreeSceneStats& other);
@@ -278,6 +284,8 @@ private:
 
     unsigned char* _jurisdictionRoot;
     std::vector<unsigned char*> _jurisdictionEndNodes;
+
+    quint64 _resumedSceneTime { 0 };
 };
 
 /// Map between element IDs and their reported OctreeSceneStats. Typically used by classes that need to know which elements sent
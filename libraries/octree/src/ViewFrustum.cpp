@@ -241,6 +241,39 @@ ViewFrustum::location ViewFrustum::boxInKeyhole(const AABox& box) const {
     return result;
 }
 
+ViewFrustum::location ViewFrustum::pointInInterestVolumes(const glm::vec3& point) const {
+    for (const auto& volume : _interestVolumes) {
+        if (volume.contains(point)) {
+            return INSIDE;
+        }
+    }
+    return OUTSIDE;
+}
+
+ViewFrustum::location ViewFrustum::sphereInInterestVolumes(const glm::vec3& center, float radius) const {
+    ViewFrustum::location result = OUTSIDE;
+    for (const auto& volume : _interestVolumes) {
+        if (volume.containsSphere(center, radius)) {
+            return INSIDE;
+        } else if (volume.touchesSphere(center, radius)) {
+            result = INTERSECT;
+        }
+    }
+    return result;
+}
+
+ViewFrustum::location ViewFrustum::boxInInterestVolumes(const AABox& box) const {
+    ViewFrustum::location result = OUTSIDE;
+    for (const auto& volume : _interestVolumes) {
+        if (volume.contains(box)) {
+            return INSIDE;
+        } else if (volume.touches(box)) {
+            result = INTERSECT;
+        }
+    }
+    return result;
+}
+
 ViewFrustum::location ViewFrustum::pointInFrustum(const glm::vec3& point, bool ignoreKeyhole) const {
     ViewFrustum::location regularResult = INSIDE;
     ViewFrustum::location keyholeResult = OUTSIDE;
@@ -254,6 +287,15 @@ ViewFrustum::location ViewFrustum::pointInFrustum(const glm::vec3& point, bool i
         }
     }
 
+    // Interest volumes are in view the same way the keyhole is
+    if (!ignoreKeyhole && !_interestVolumes.isEmpty()) {
+        keyholeResult = std::max(keyholeResult, pointInInterestVolumes(point));
+
+        if (keyholeResult == INSIDE) {
+            return keyholeResult;
+        }
+    }
+
     // If we're not known to be INSIDE the keyhole, then check the regular frustum
     for(int i = 0; i < 6; ++i) {
         float distance = _planes[i].distance(point);
@@ -272,6 +314,10 @@ ViewFrustum::location ViewFrustum::sphereInFrustum(const glm::vec3& center, floa
     if (_keyholeRadius >= 0.0f) {
         keyholeResult = sphereInKeyhole(center, radius);
     }
+    // Interest volumes are in view the same way the keyhole is
+    if (keyholeResult != INSIDE && !_interestVolumes.isEmpty()) {
+        keyholeResult = std::max(keyholeResult, sphereInInterestVolumes(center, radius));
+    }
     if (keyholeResult == INSIDE) {
         return keyholeResult;
     }
@@ -292,75 +338,175 @@ ViewFrustum::location ViewFrustum::sphereInFrustum(const glm::vec3& center, floa
 
 
 ViewFrustum::location ViewFrustum::cubeInFrustum(const AACube& cube) const {
+    PlaneMask planeMask = ALL_PLANES;
+    return cubeInFrustum(cube, planeMask);
+}
+
+ViewFrustum::location ViewFrustum::boxInFrustum(const AABox& box) const {
+    PlaneMask planeMask = ALL_PLANES;
+    return boxInFrustum(box, planeMask);
+}
+
+ViewFrustum::location ViewFrustum::cubeInFrustum(const AACube& cube, PlaneMask& planeMask) const {
 
-    ViewFrustum::location regularResult = INSIDE;
     ViewFrustum::location keyholeResult = OUTSIDE;
 
     // If we have a keyholeRadius, check that first, since it's cheaper
     if (_keyholeRadius >= 0.0f) {
         keyholeResult = cubeInKeyhole(cube);
     }
+    // Interest volumes are in view the same way the keyhole is
+    if (keyholeResult != INSIDE && !_interestVolumes.isEmpty()) {
+        keyholeResult = std::max(keyholeResult, boxInInterestVolumes(AABox(cube)));
+    }
     if (keyholeResult == INSIDE) {
         return keyholeResult;
     }
 
-    // TODO: These calculations are expensive, taking up 80% of our time in this function.
-    // This appears to be expensive because we have to test the distance to each plane.
-    // One suggested optimization is to first check against the approximated cone. We might
-    // also be able to test against the cone to the bounding sphere of the box.
-    for(int i=0; i < 6; i++) {
-        const glm::vec3& normal = _planes[i].getNormal();
-        const glm::vec3& boxVertexP = cube.getVertexP(normal);
-        float planeToBoxVertexPDistance = _planes[i].distance(boxVertexP);
-
-        const glm::vec3& boxVertexN = cube.getVertexN(normal);
-        float planeToBoxVertexNDistance = _planes[i].distance(boxVertexN);
-
-        if (planeToBoxVertexPDistance < 0) {
-            // This is outside the regular frustum, so just return the value from checking the keyhole
-            return keyholeResult;
-        } else if (planeToBoxVertexNDistance < 0) {
-            regularResult =  INTERSECT;
-        }
-    }
-    return regularResult;
+    // outside of the regular frustum it is only in view as far as the keyhole is
+    ViewFrustum::location regularResult = boxInPlanes(cube.getMinimumPoint(), cube.getMaximumPoint(), planeMask);
+    return (regularResult == OUTSIDE) ? keyholeResult : regularResult;
 }
 
-ViewFrustum::location ViewFrustum::boxInFrustum(const AABox& box) const {
+ViewFrustum::location ViewFrustum::boxInFrustum(const AABox& box, PlaneMask& planeMask) const {
 
-    ViewFrustum::location regularResult = INSIDE;
     ViewFrustum::location keyholeResult = OUTSIDE;
 
     // If we have a keyholeRadius, check that first, since it's cheaper
     if (_keyholeRadius >= 0.0f) {
         keyholeResult = boxInKeyhole(box);
     }
+    // Interest volumes are in view the same way the keyhole is
+    if (keyholeResult != INSIDE && !_interestVolumes.isEmpty()) {
+        keyholeResult = std::max(keyholeResult, boxInInterestVolumes(box));
+    }
     if (keyholeResult == INSIDE) {
         return keyholeResult;
     }
 
-    // TODO: These calculations are expensive, taking up 80% of our time in this function.
-    // This appears to be expensive because we have to test the distance to each plane.
-    // One suggested optimization is to first check against the approximated cone. We might
-    // also be able to test against the cone to the bounding sphere of the box.
-    for(int i=0; i < 6; i++) {
+    ViewFrustum::location regularResult = boxInPlanes(box.getMinimumPoint(), box.getMaximumPoint(), planeMask);
+    return (regularResult == OUTSIDE) ? keyholeResult : regularResult;
+}
+
+// A box is outside of a plane when its corner furthest along the normal (the P vertex) is, and fully inside of it
+// when the nearest corner (the N vertex) is inside too.
+ViewFrustum::location ViewFrustum::boxInPlanes(const glm::vec3& minimum, const glm::vec3& maximum,
+                                               PlaneMask& planeMask) const {
+    ViewFrustum::location result = INSIDE;
+    for (int i = 0; i < 6; i++) {
+        if (!(planeMask & (1 << i))) {
+            continue;
+        }
         const glm::vec3& normal = _planes[i].getNormal();
-        const glm::vec3& boxVertexP = box.getVertexP(normal);
-        float planeToBoxVertexPDistance = _planes[i].distance(boxVertexP);
+        glm::vec3 boxVertexP(normal.x > 0.0f ? maximum.x : minimum.x, normal.y > 0.0f ? maximum.y : minimum.y,
+                             normal.z > 0.0f ? maximum.z : minimum.z);
+        if (_planes[i].distance(boxVertexP) < 0.0f) {
+            return OUTSIDE;
+        }
+        glm::vec3 boxVertexN(normal.x < 0.0f ? maximum.x : minimum.x, normal.y < 0.0f ? maximum.y : minimum.y,
+                             normal.z < 0.0f ? maximum.z : minimum.z);
+        if (_planes[i].distance(boxVertexN) < 0.0f) {
+            result = INTERSECT;
+        } else {
+            planeMask &= ~(1 << i);
+        }
+    }
+    return result;
+}
 
-        const glm::vec3& boxVertexN = box.getVertexN(normal);
-        float planeToBoxVertexNDistance = _planes[i].distance(boxVertexN);
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
 
-        if (planeToBoxVertexPDistance < 0) {
-            // This is outside the regular frustum, so just return the value from checking the keyhole
-            return keyholeResult;
-        } else if (planeToBoxVertexNDistance < 0) {
-            regularResult =  INTERSECT;
+#include <emmintrin.h>
+
+// the four lanes of a box corner along one axis, the maximum where the normal asks for it and the minimum otherwise
+static inline __m128 selectVertex(bool wantMaximum, const float* minimum, const float* maximum) {
+    return _mm_loadu_ps(wantMaximum ? maximum : minimum);
+}
+
+void ViewFrustum::boxesInFrustum(const RayIntersectionKernels::BoxBatch& boxes, PlaneMask planeMask,
+                                 location* locations) const {
+    __m128 zero = _mm_setzero_ps();
+
+    // the lanes past numBoxes are computed too and ignored
+    for (int i = 0; i < boxes.numBoxes; i += 4) {
+        __m128 outside = zero;
+        __m128 intersect = zero;
+
+        for (int plane = 0; plane < 6; plane++) {
+            if (!(planeMask & (1 << plane))) {
+                continue;
+            }
+            const glm::vec3& normal = _planes[plane].getNormal();
+            __m128 normalX = _mm_set1_ps(normal.x);
+            __m128 normalY = _mm_set1_ps(normal.y);
+            __m128 normalZ = _mm_set1_ps(normal.z);
+            __m128 dCoefficient = _mm_set1_ps(_planes[plane].getDCoefficient());
+
+            // summed in the order of Plane::distance, so the batch agrees with boxInFrustum to the bit
+            __m128 distanceP = _mm_add_ps(dCoefficient, _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(normalX, selectVertex(normal.x > 0.0f, &boxes.minX[i], &boxes.maxX[i])),
+                _mm_mul_ps(normalY, selectVertex(normal.y > 0.0f, &boxes.minY[i], &boxes.maxY[i]))),
+                _mm_mul_ps(normalZ, selectVertex(normal.z > 0.0f, &boxes.minZ[i], &boxes.maxZ[i]))));
+            __m128 distanceN = _mm_add_ps(dCoefficient, _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(normalX, selectVertex(normal.x < 0.0f, &boxes.minX[i], &boxes.maxX[i])),
+                _mm_mul_ps(normalY, selectVertex(normal.y < 0.0f, &boxes.minY[i], &boxes.maxY[i]))),
+                _mm_mul_ps(normalZ, selectVertex(normal.z < 0.0f, &boxes.minZ[i], &boxes.maxZ[i]))));
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distanceP, zero));
+            intersect = _mm_or_ps(intersect, _mm_cmplt_ps(distanceN, zero));
+            if (_mm_movemask_ps(outside) == 0xf) {
+                break;
+            }
+        }
+
+        int outsideBits = _mm_movemask_ps(outside);
+        int intersectBits = _mm_movemask_ps(intersect);
+        for (int lane = 0; lane < 4 && i + lane < boxes.numBoxes; lane++) {
+            locations[i + lane] = (outsideBits & (1 << lane)) ? OUTSIDE :
+                ((intersectBits & (1 << lane)) ? INTERSECT : INSIDE);
         }
     }
-    return regularResult;
+
+    if (_keyholeRadius < 0.0f && _interestVolumes.isEmpty()) {
+        return;
+    }
+    // the keyhole and interest volumes only change the boxes that aren't fully inside the planes
+    for (int i = 0; i < boxes.numBoxes; i++) {
+        if (locations[i] == INSIDE) {
+            continue;
+        }
+        glm::vec3 minimum(boxes.minX[i], boxes.minY[i], boxes.minZ[i]);
+        AABox box(minimum, glm::vec3(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]) - minimum);
+        ViewFrustum::location keyholeResult = OUTSIDE;
+        if (_keyholeRadius >= 0.0f) {
+            keyholeResult = boxInKeyhole(box);
+        }
+        if (keyholeResult != INSIDE && !_interestVolumes.isEmpty()) {
+            keyholeResult = std::max(keyholeResult, boxInInterestVolumes(box));
+        }
+        if (keyholeResult == INSIDE || locations[i] == OUTSIDE) {
+            locations[i] = keyholeResult;
+        }
+    }
+}
+
+#else
+
+void ViewFrustum::boxesInFrustum(const RayIntersectionKernels::BoxBatch& boxes, PlaneMask planeMask,
+                                 location* locations) const {
+    for (int i = 0; i < boxes.numBoxes; i++) {
+        glm::vec3 minimum(boxes.minX[i], boxes.minY[i], boxes.minZ[i]);
+        AABox box(minimum, glm::vec3(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]) - minimum);
+        PlaneMask boxPlaneMask = planeMask;
+        locations[i] = boxInFrustum(box, boxPlaneMask);
+    }
 }
 
+#endif
+
 bool testMatches(glm::quat lhs, glm::quat rhs, float epsilon = EPSILON) {
     return (fabs(lhs.x - rhs.x) <= epsilon && fabs(lhs.y - rhs.y) <= epsilon && fabs(lhs.z - rhs.z) <= epsilon
             && fabs(lhs.w - rhs.w) <= epsilon);
@@ -384,7 +530,8 @@ bool ViewFrustum::matches(const ViewFrustum& compareTo, bool debug) const {
            testMatches(compareTo._aspectRatio, _aspectRatio) &&
            testMatches(compareTo._nearClip, _nearClip) &&
            testMatches(compareTo._farClip, _farClip) &&
-           testMatches(compareTo._focalLength, _focalLength);
+           testMatches(compareTo._focalLength, _focalLength) &&
+           compareTo._interestVolumes == _interestVolumes;
 
     if (!result && debug) {
         qCDebug(octree, "ViewFrustum::matches()... result=%s", debug::valueOf(result));
@@ -423,6 +570,19 @@ bool ViewFrustum::matches(const ViewFrustum& compareTo, bool debug) const {
     return result;
 }
 
+static bool interestVolumesAreSimilar(const QVector<InterestVolume>& lhs, const QVector<InterestVolume>& rhs,
+                                      float positionTolerance) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (int i = 0; i < lhs.size(); i++) {
+        if (!lhs[i].isVerySimilar(rhs[i], positionTolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool ViewFrustum::isVerySimilar(const ViewFrustum& compareTo, bool debug) const {
 
     //  Compute distance between the two positions
@@ -444,7 +604,8 @@ bool ViewFrustum::isVerySimilar(const ViewFrustum& compareTo, bool debug) const
            testMatches(compareTo._aspectRatio, _aspectRatio) &&
            testMatches(compareTo._nearClip, _nearClip) &&
            testMatches(compareTo._farClip, _farClip) &&
-           testMatches(compareTo._focalLength, _focalLength);
+           testMatches(compareTo._focalLength, _focalLength) &&
+           interestVolumesAreSimilar(compareTo._interestVolumes, _interestVolumes, POSITION_SIMILAR_ENOUGH);
 
 
     if (!result && debug) {
@@ -541,6 +702,7 @@ void ViewFrustum::printDebugDetails() const {
     qCDebug(octree, "_fieldOfView=%f", (double)_fieldOfView);
     qCDebug(octree, "_aspectRatio=%f", (double)_aspectRatio);
     qCDebug(octree, "_keyHoleRadius=%f", (double)_keyholeRadius);
+    qCDebug(octree, "_interestVolumes=%d", _interestVolumes.size());
     qCDebug(octree, "_nearClip=%f", (double)_nearClip);
     qCDebug(octree, "_farClip=%f", (double)_farClip);
     qCDebug(octree, "_focalLength=%f", (double)_focalLength);
@@ -739,6 +901,13 @@ void ViewFrustum::getFurthestPointFromCamera(const AACube& box, glm::vec3& furth
 float ViewFrustum::distanceToCamera(const glm::vec3& point) const {
     glm::vec3 temp = getPosition() - point;
     float distanceToPoint = sqrtf(glm::dot(temp, temp));
+
+    // points in interest volumes are as close as the volumes they are in make them
+    for (const auto& volume : _interestVolumes) {
+        if (volume.contains(point)) {
+            distanceToPoint = std::min(distanceToPoint, volume.lodDistance(point));
+        }
+    }
     return distanceToPoint;
 }
 
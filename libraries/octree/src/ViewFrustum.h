@@ -17,12 +17,16 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <QVector>
+
 #include <GLMHelpers.h>
+#include <RayIntersectionKernels.h>
 #include <RegisteredMetaTypes.h>
 
 #include "Transform.h"
 #include "AABox.h"
 #include "AACube.h"
+#include "InterestVolume.h"
 #include "Plane.h"
 #include "OctreeConstants.h"
 #include "OctreeProjectedPolygon.h"
@@ -75,6 +79,10 @@ public:
     void  setKeyholeRadius(float keyholdRadius) { _keyholeRadius = keyholdRadius; }
     float getKeyholeRadius() const { return _keyholeRadius; }
 
+    // get/set for interest volumes, which are in view like the keyhole is and have their own level of detail
+    void setInterestVolumes(const QVector<InterestVolume>& interestVolumes) { _interestVolumes = interestVolumes; }
+    const QVector<InterestVolume>& getInterestVolumes() const { return _interestVolumes; }
+
     void calculate();
 
     typedef enum {OUTSIDE, INTERSECT, INSIDE} location;
@@ -84,6 +92,20 @@ public:
     ViewFrustum::location cubeInFrustum(const AACube& cube) const;
     ViewFrustum::location boxInFrustum(const AABox& box) const;
 
+    /// The six planes of the frustum as bits. A box that is fully inside some of the planes is only crossed by the rest,
+    /// and so are the boxes within it, like the children of an octree element, so those only need testing against them.
+    typedef uint8_t PlaneMask;
+    static const PlaneMask ALL_PLANES = (1 << 6) - 1;
+
+    /// like cubeInFrustum and boxInFrustum, testing only the planes in planeMask and clearing the ones the box is fully
+    /// inside of, so that boxes within it can be tested with what is left
+    ViewFrustum::location cubeInFrustum(const AACube& cube, PlaneMask& planeMask) const;
+    ViewFrustum::location boxInFrustum(const AABox& box, PlaneMask& planeMask) const;
+
+    /// like boxInFrustum for each box of the batch, testing four boxes at once against the planes in planeMask, which
+    /// all the boxes are known to be inside of, locations must have room for BOX_BATCH_SIZE values
+    void boxesInFrustum(const RayIntersectionKernels::BoxBatch& boxes, PlaneMask planeMask, location* locations) const;
+
     // some frustum comparisons
     bool matches(const ViewFrustum& compareTo, bool debug = false) const;
     bool matches(const ViewFrustum* compareTo, bool debug = false) const { return matches(*compareTo, debug); }
@@ -115,6 +137,14 @@ private:
     ViewFrustum::location cubeInKeyhole(const AACube& cube) const;
     ViewFrustum::location boxInKeyhole(const AABox& box) const;
 
+    // Used for interest volume calculations
+    ViewFrustum::location pointInInterestVolumes(const glm::vec3& point) const;
+    ViewFrustum::location sphereInInterestVolumes(const glm::vec3& center, float radius) const;
+    ViewFrustum::location boxInInterestVolumes(const AABox& box) const;
+
+    // the planes alone, for the box from minimum to maximum
+    ViewFrustum::location boxInPlanes(const glm::vec3& minimum, const glm::vec3& maximum, PlaneMask& planeMask) const;
+
     // camera location/orientation attributes
     glm::vec3 _position; // the position in world-frame
     glm::quat _orientation;
@@ -132,6 +162,8 @@ private:
     float _keyholeRadius = DEFAULT_KEYHOLE_RADIUS;
     AACube _keyholeBoundingCube;
 
+    QVector<InterestVolume> _interestVolumes;
+
     // Calculated values
     glm::mat4 _inverseProjection;
     float _width = 1.0f;
@@ -14,6 +14,7 @@
 #include <EntityItem.h>
 #include <EntityItemProperties.h>
 #include <EntityEditPacketSender.h>
+#include <EntitySimulationUpdate.h>
 #include <PhysicsCollisionGroups.h>
 
 #include "BulletUtil.h"
@@ -149,11 +150,33 @@ MotionType EntityMotionState::computeObjectMotionType() const {
     }
     assert(entityTreeIsLocked());
     if (_entity->getCollisionsWillMove()) {
-        return MOTION_TYPE_DYNAMIC;
+        return isDrivenRemotely() ? MOTION_TYPE_KINEMATIC : MOTION_TYPE_DYNAMIC;
     }
     return (_entity->isMoving() || _entity->hasActions()) ?  MOTION_TYPE_KINEMATIC : MOTION_TYPE_STATIC;
 }
 
+// a remote body stays in the solver this long after a locally simulated body was last near it
+const uint32_t STEPS_NEAR_LOCAL_BODY = (uint32_t)(1.5f / PHYSICS_ENGINE_FIXED_SUBSTEP);
+
+bool EntityMotionState::isDrivenRemotely() const {
+    QUuid simulatorID = _entity->getSimulatorID();
+    bool isRemotelyOwned = !simulatorID.isNull() && simulatorID != ObjectMotionState::getWorldSessionID();
+    if (isRemotelyOwned && _entity->getSimulationPriority() == AUTHORITATIVE_SIMULATION_PRIORITY &&
+        !_entity->hasActions()) {
+        // the physics-simulator of the domain owns it, we only follow its updates
+        return true;
+    }
+    if (!ObjectMotionState::getKinematicRemoteBodies() || _entity->hasActions() || _outgoingPriority != NO_PRORITY) {
+        // actions need the solver, and we are about to bid for the simulation of the entity
+        return false;
+    }
+    if (!isRemotelyOwned) {
+        return false;
+    }
+    return !_nearLocalBody ||
+        ObjectMotionState::getWorldSimulationStep() - _lastStepNearLocalBody > STEPS_NEAR_LOCAL_BODY;
+}
+
 bool EntityMotionState::isMoving() const {
     assert(entityTreeIsLocked());
     return _entity && _entity->isMoving();
@@ -198,7 +221,14 @@ void EntityMotionState::setWorldTransform(const btTransform& worldTrans) {
     _entity->setAngularVelocity(getBodyAngularVelocity());
     _entity->setLastSimulated(usecTimestampNow());
 
-    if (_entity->getSimulatorID().isNull()) {
+    if (ObjectMotionState::getAuthoritativeSimulation()) {
+        // the physics-simulator owns everything that moves, except what the clients drive with actions
+        bool ownsIt = _entity->getSimulatorID() == ObjectMotionState::getWorldSessionID() &&
+            _entity->getSimulationPriority() == AUTHORITATIVE_SIMULATION_PRIORITY;
+        if (!ownsIt && !_entity->hasActions() && usecTimestampNow() > _nextOwnershipBid) {
+            setOutgoingPriority(AUTHORITATIVE_SIMULATION_PRIORITY);
+        }
+    } else if (_entity->getSimulatorID().isNull()) {
         _loopsWithoutOwner++;
 
         if (_loopsWithoutOwner > LOOPS_FOR_SIMULATION_ORPHAN && usecTimestampNow() > _nextOwnershipBid) {
@@ -440,23 +470,32 @@ void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, const Q
         _sentInactive = false;
     }
 
-    // remember properties for local server prediction
-    _serverPosition = _entity->getPosition();
-    _serverRotation = _entity->getRotation();
-    _serverVelocity = _entity->getVelocity();
-    _serverAcceleration = _entity->getAcceleration();
-    _serverAngularVelocity = _entity->getAngularVelocity();
-    _serverActionData = _entity->getActionData();
-
     EntityItemProperties properties;
 
     // explicitly set the properties that changed so that they will be packed
-    properties.setPosition(_serverPosition);
-    properties.setRotation(_serverRotation);
-    properties.setVelocity(_serverVelocity);
-    properties.setAcceleration(_serverAcceleration);
-    properties.setAngularVelocity(_serverAngularVelocity);
-    properties.setActionData(_serverActionData);
+    properties.setPosition(_entity->getPosition());
+    properties.setRotation(_entity->getRotation());
+    properties.setVelocity(_entity->getVelocity());
+    properties.setAcceleration(_entity->getAcceleration());
+    properties.setAngularVelocity(_entity->getAngularVelocity());
+    properties.setActionData(_entity->getActionData());
+
+    // the update goes to the server that has the entity where it predicts the entity to be
+    glm::vec3 routingPosition = _serverPosition;
+
+    // remember properties for local server prediction, as the server will decode them
+    _serverPosition = _entity->getPosition();
+    _serverAcceleration = _entity->getAcceleration();
+    _serverActionData = _entity->getActionData();
+    if (EntitySimulationUpdate::canEncode(properties, _entity->getGravity())) {
+        _serverRotation = EntitySimulationUpdate::quantizeRotation(_entity->getRotation());
+        _serverVelocity = EntitySimulationUpdate::quantizeVelocity(_entity->getVelocity());
+        _serverAngularVelocity = EntitySimulationUpdate::quantizeAngularVelocity(_entity->getAngularVelocity());
+    } else {
+        _serverRotation = _entity->getRotation();
+        _serverVelocity = _entity->getVelocity();
+        _serverAngularVelocity = _entity->getAngularVelocity();
+    }
 
     // set the LastEdited of the properties but NOT the entity itself
     quint64 now = usecTimestampNow();
@@ -489,10 +528,10 @@ void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, const Q
         EntityItemID id(_entity->getID());
         EntityEditPacketSender* entityPacketSender = static_cast<EntityEditPacketSender*>(packetSender);
         #ifdef WANT_DEBUG
-            qCDebug(physics) << "EntityMotionState::sendUpdate()... calling queueEditEntityMessage()...";
+            qCDebug(physics) << "EntityMotionState::sendUpdate()... calling queueSimulationUpdateMessage()...";
         #endif
 
-        entityPacketSender->queueEditEntityMessage(PacketType::EntityEdit, id, properties);
+        entityPacketSender->queueSimulationUpdateMessage(id, properties, _entity->getGravity(), routingPosition);
         _entity->setLastBroadcast(usecTimestampNow());
     } else {
         #ifdef WANT_DEBUG
@@ -512,8 +551,15 @@ uint32_t EntityMotionState::getIncomingDirtyFlags() {
         int bodyFlags = _body->getCollisionFlags();
         bool isMoving = _entity->isMoving();
         if (((bodyFlags & btCollisionObject::CF_STATIC_OBJECT) && isMoving) ||
-                (bodyFlags & btCollisionObject::CF_KINEMATIC_OBJECT && !isMoving)) {
+                (bodyFlags & btCollisionObject::CF_KINEMATIC_OBJECT && !isMoving && !isKinematicRemoteBody())) {
             dirtyFlags |= Simulation::DIRTY_MOTION_TYPE;
+        } else if (_entity->getCollisionsWillMove() && _motionType != computeObjectMotionType()) {
+            // the simulation of the entity moved between a remote simulator and this one
+            dirtyFlags |= Simulation::DIRTY_MOTION_TYPE;
+        }
+        if (getShapeManager()->isOutdatedPlaceholder(_shape)) {
+            // the shape the body stood in for has been built
+            dirtyFlags |= Simulation::DIRTY_SHAPE;
         }
     }
     return dirtyFlags;
@@ -550,6 +596,18 @@ void EntityMotionState::bump(quint8 priority) {
     }
 }
 
+// virtual
+void EntityMotionState::markNearLocalBody() {
+    _nearLocalBody = true;
+    _lastStepNearLocalBody = ObjectMotionState::getWorldSimulationStep();
+}
+
+// virtual
+bool EntityMotionState::isKinematicRemoteBody() const {
+    // a body whose collisions move it is only kinematic while its remote simulator drives it
+    return _entity && _motionType == MOTION_TYPE_KINEMATIC && _entity->getCollisionsWillMove();
+}
+
 void EntityMotionState::resetMeasuredBodyAcceleration() {
     _lastMeasureStep = ObjectMotionState::getWorldSimulationStep();
     if (_body) {
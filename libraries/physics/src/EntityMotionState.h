@@ -73,6 +73,9 @@ public:
     virtual QUuid getSimulatorID() const;
     virtual void bump(quint8 priority);
 
+    virtual void markNearLocalBody();
+    virtual bool isKinematicRemoteBody() const;
+
     EntityItemPointer getEntity() const { return _entity; }
 
     void resetMeasuredBodyAcceleration();
@@ -97,6 +100,9 @@ protected:
     virtual void clearObjectBackPointer();
     virtual void setMotionType(MotionType motionType);
 
+    /// \return true if the body should follow the updates of its remote simulator kinematically
+    bool isDrivenRemotely() const;
+
     EntityItemPointer _entity;
 
     bool _sentInactive;   // true if body was inactive when we sent last update
@@ -120,6 +126,9 @@ protected:
     quint64 _nextOwnershipBid = NO_PRORITY;
     uint32_t _loopsWithoutOwner;
     quint8 _outgoingPriority = NO_PRORITY;
+
+    bool _nearLocalBody = false;
+    uint32_t _lastStepNearLocalBody = 0;
 };
 
 #endif // hifi_EntityMotionState_h
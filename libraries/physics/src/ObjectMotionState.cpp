@@ -53,6 +53,36 @@ ShapeManager* ObjectMotionState::getShapeManager() {
     return shapeManager;
 }
 
+// static
+QUuid worldSessionID;
+void ObjectMotionState::setWorldSessionID(const QUuid& sessionID) {
+    worldSessionID = sessionID;
+}
+
+const QUuid& ObjectMotionState::getWorldSessionID() {
+    return worldSessionID;
+}
+
+// static
+bool kinematicRemoteBodies = false;
+void ObjectMotionState::setKinematicRemoteBodies(bool kinematic) {
+    kinematicRemoteBodies = kinematic;
+}
+
+bool ObjectMotionState::getKinematicRemoteBodies() {
+    return kinematicRemoteBodies;
+}
+
+// static
+bool authoritativeSimulation = false;
+void ObjectMotionState::setAuthoritativeSimulation(bool authoritative) {
+    authoritativeSimulation = authoritative;
+}
+
+bool ObjectMotionState::getAuthoritativeSimulation() {
+    return authoritativeSimulation;
+}
+
 ObjectMotionState::ObjectMotionState(btCollisionShape* shape) :
     _motionType(MOTION_TYPE_STATIC),
     _shape(shape),
@@ -77,6 +77,17 @@ public:
     static void setShapeManager(ShapeManager* manager);
     static ShapeManager* getShapeManager();
 
+    static void setWorldSessionID(const QUuid& sessionID);
+    static const QUuid& getWorldSessionID();
+
+    // when true the bodies other simulators own follow their updates kinematically, outside of the solver
+    static void setKinematicRemoteBodies(bool kinematic);
+    static bool getKinematicRemoteBodies();
+
+    // when true this is the physics-simulator of the domain, it claims every moving body at AUTHORITATIVE priority
+    static void setAuthoritativeSimulation(bool authoritative);
+    static bool getAuthoritativeSimulation();
+
     ObjectMotionState(btCollisionShape* shape);
     ~ObjectMotionState();
 
@@ -134,6 +145,10 @@ public:
     virtual QUuid getSimulatorID() const = 0;
     virtual void bump(quint8 priority) {}
 
+    // a locally simulated body is in the broadphase pair set of this remotely owned body
+    virtual void markNearLocalBody() {}
+    virtual bool isKinematicRemoteBody() const { return false; }
+
     virtual QString getName() { return ""; }
 
     virtual int16_t computeCollisionGroup() = 0;
@@ -183,6 +183,15 @@ void PhysicalEntitySimulation::setObjectsToChange(const VectorOfMotionStates& ob
 void PhysicalEntitySimulation::getObjectsToChange(VectorOfMotionStates& result) {
     result.clear();
     QMutexLocker lock(&_mutex);
+    ShapeManager* shapeManager = ObjectMotionState::getShapeManager();
+    if (shapeManager->collectBuiltShapes()) {
+        // the bodies with a placeholder switch to the shape that was built for them
+        for (auto object : _physicalObjects) {
+            if (shapeManager->isOutdatedPlaceholder(object->getShape())) {
+                _pendingChanges.insert(static_cast<EntityMotionState*>(object));
+            }
+        }
+    }
     for (auto stateItr : _pendingChanges) {
         EntityMotionState* motionState = &(*stateItr);
         result.push_back(motionState);
@@ -208,7 +217,7 @@ void PhysicalEntitySimulation::handleOutgoingChanges(const VectorOfMotionStates&
     }
 
     uint32_t numSubsteps = _physicsEngine->getNumSubsteps();
-    if (_lastStepSendPackets != numSubsteps) {
+    if (numSubsteps - _lastStepSendPackets >= _substepsBetweenUpdates) {
         _lastStepSendPackets = numSubsteps;
 
         if (sessionID.isNull()) {
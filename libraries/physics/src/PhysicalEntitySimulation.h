@@ -54,6 +54,9 @@ public:
 
     EntityEditPacketSender* getPacketSender() { return _entityPacketSender; }
 
+    /// the updates of the owned entities are only sent every this many substeps, one sends them after every substep
+    void setSubstepsBetweenUpdates(uint32_t substeps) { _substepsBetweenUpdates = glm::max(substeps, 1u); }
+
 private:
     // incoming changes
     SetOfEntityMotionStates _pendingRemoves; // EntityMotionStates to be removed from PhysicsEngine (and deleted)
@@ -69,6 +72,7 @@ private:
     EntityEditPacketSender* _entityPacketSender = nullptr;
 
     uint32_t _lastStepSendPackets = 0;
+    uint32_t _substepsBetweenUpdates = 1;
 };
 
 
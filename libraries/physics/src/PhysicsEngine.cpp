@@ -24,7 +24,11 @@ uint32_t PhysicsEngine::getNumSubsteps() {
 
 PhysicsEngine::PhysicsEngine(const glm::vec3& offset) :
         _originOffset(offset),
-        _myAvatarController(nullptr) {
+        _myAvatarController(nullptr),
+        // the simulation steps of the motion states keep counting up from those of an earlier engine
+        _numSubsteps(ObjectMotionState::getWorldSimulationStep()) {
+    _contactMaps.resize(1);
+
     // build table of masks with their group as the key
     _collisionMasks.insert(btHashInt((int)COLLISION_GROUP_DEFAULT), COLLISION_MASK_DEFAULT);
     _collisionMasks.insert(btHashInt((int)COLLISION_GROUP_STATIC), COLLISION_MASK_STATIC);
@@ -67,6 +71,11 @@ void PhysicsEngine::init() {
     }
 }
 
+void PhysicsEngine::setSessionUUID(const QUuid& sessionID) {
+    _sessionID = sessionID;
+    ObjectMotionState::setWorldSessionID(sessionID);
+}
+
 void PhysicsEngine::addObject(ObjectMotionState* motionState) {
     assert(motionState);
 
@@ -217,19 +226,60 @@ void PhysicsEngine::reinsertObject(ObjectMotionState* object) {
 
 void PhysicsEngine::removeContacts(ObjectMotionState* motionState) {
     // trigger events for new/existing/old contacts
-    ContactMap::iterator contactItr = _contactMap.begin();
-    while (contactItr != _contactMap.end()) {
-        if (contactItr->first._a == motionState || contactItr->first._b == motionState) {
-            ContactMap::iterator iterToDelete = contactItr;
-            ++contactItr;
-            _contactMap.erase(iterToDelete);
-        } else {
-            ++contactItr;
+    for (auto& contactMap : _contactMaps) {
+        ContactMap::iterator contactItr = contactMap.begin();
+        while (contactItr != contactMap.end()) {
+            if (contactItr->first._a == motionState || contactItr->first._b == motionState) {
+                ContactMap::iterator iterToDelete = contactItr;
+                ++contactItr;
+                contactMap.erase(iterToDelete);
+            } else {
+                ++contactItr;
+            }
         }
     }
 }
 
+// the shard of the contact maps that has the contact of a pair of objects
+static size_t contactShard(const ContactKey& key, size_t numShards) {
+    // the motion states are aligned, their low bits don't tell them apart
+    size_t hash = (reinterpret_cast<size_t>(key._a) >> 4) * 31 + (reinterpret_cast<size_t>(key._b) >> 4);
+    return hash % numShards;
+}
+
+ContactInfo& PhysicsEngine::getContact(const ContactKey& key) {
+    return _contactMaps[contactShard(key, _contactMaps.size())][key];
+}
+
+void PhysicsEngine::setNumThreads(int numThreads) {
+    _threadPool.setNumThreads(numThreads);
+    size_t numShards = (size_t)_threadPool.getNumThreads();
+    if (numShards == _contactMaps.size()) {
+        return;
+    }
+
+    // the existing contacts move to their new shards, so that they keep their events
+    std::vector<ContactMap> oldContactMaps;
+    oldContactMaps.swap(_contactMaps);
+    _contactMaps.resize(numShards);
+    for (auto& contactMap : oldContactMaps) {
+        for (auto& contact : contactMap) {
+            _contactMaps[contactShard(contact.first, numShards)].insert(contact);
+        }
+    }
+    _manifoldRanges.resize(numShards);
+    for (auto& range : _manifoldRanges) {
+        range.contactsByShard.resize(numShards);
+    }
+}
+
 void PhysicsEngine::stepSimulation() {
+    float dt = 1.0e-6f * (float)(_clock.getTimeMicroseconds());
+    _clock.reset();
+    stepSimulation(dt);
+}
+
+void PhysicsEngine::stepSimulation(float deltaTime) {
     CProfileManager::Reset();
     BT_PROFILE("stepSimulation");
     // NOTE: the grand order of operations is:
@@ -239,11 +289,10 @@ void PhysicsEngine::stepSimulation() {
     // (4) send outgoing packets
 
     const float MAX_TIMESTEP = (float)PHYSICS_ENGINE_MAX_NUM_SUBSTEPS * PHYSICS_ENGINE_FIXED_SUBSTEP;
-    float dt = 1.0e-6f * (float)(_clock.getTimeMicroseconds());
-    _clock.reset();
-    float timeStep = btMin(dt, MAX_TIMESTEP);
+    float timeStep = btMin(deltaTime, MAX_TIMESTEP);
 
     if (_myAvatarController) {
+        BT_PROFILE("preSimulation");
         // ADEBUG TODO: move this stuff outside and in front of stepSimulation, because
         // the updateShapeIfNecessary() call needs info from MyAvatar and should
         // be done on the main thread during the pre-simulation stuff
@@ -264,6 +313,9 @@ void PhysicsEngine::stepSimulation() {
 
     auto onSubStep = [this]() {
         updateContactMap();
+        if (ObjectMotionState::getKinematicRemoteBodies() && !_sessionID.isNull()) {
+            findRemoteBodiesNearLocalBodies();
+        }
     };
 
     int numSubsteps = _dynamicsWorld->stepSimulationWithSubstepCallback(timeStep, PHYSICS_ENGINE_MAX_NUM_SUBSTEPS,
@@ -279,11 +331,21 @@ void PhysicsEngine::stepSimulation() {
 
         _hasOutgoingChanges = true;
     }
+    wakeRemoteBodiesNearLocalBodies();
 }
 
 void PhysicsEngine::doOwnershipInfection(const btCollisionObject* objectA, const btCollisionObject* objectB) {
     BT_PROFILE("ownershipInfection");
 
+    quint8 priority;
+    ObjectMotionState* infectedMotionState = findOwnershipInfection(objectA, objectB, priority);
+    if (infectedMotionState) {
+        infectedMotionState->bump(priority);
+    }
+}
+
+ObjectMotionState* PhysicsEngine::findOwnershipInfection(const btCollisionObject* objectA,
+                                                         const btCollisionObject* objectB, quint8& priority) const {
     const btCollisionObject* characterObject = _myAvatarController ? _myAvatarController->getCollisionObject() : nullptr;
 
     ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(objectA->getUserPointer());
@@ -295,8 +357,8 @@ void PhysicsEngine::doOwnershipInfection(const btCollisionObject* objectA, const
         // NOTE: we might own the simulation of a kinematic object (A)
         // but we don't claim ownership of kinematic objects (B) based on collisions here.
         if (!objectB->isStaticOrKinematicObject() && motionStateB->getSimulatorID() != _sessionID) {
-            quint8 priority = motionStateA ? motionStateA->getSimulationPriority() : PERSONAL_SIMULATION_PRIORITY;
-            motionStateB->bump(priority);
+            priority = motionStateA ? motionStateA->getSimulationPriority() : PERSONAL_SIMULATION_PRIORITY;
+            return motionStateB;
         }
     } else if (motionStateA &&
                ((motionStateB && motionStateB->getSimulatorID() == _sessionID && !objectB->isStaticObject()) ||
@@ -304,18 +366,27 @@ void PhysicsEngine::doOwnershipInfection(const btCollisionObject* objectA, const
         // SIMILARLY: we might own the simulation of a kinematic object (B)
         // but we don't claim ownership of kinematic objects (A) based on collisions here.
         if (!objectA->isStaticOrKinematicObject() && motionStateA->getSimulatorID() != _sessionID) {
-            quint8 priority = motionStateB ? motionStateB->getSimulationPriority() : PERSONAL_SIMULATION_PRIORITY;
-            motionStateA->bump(priority);
+            priority = motionStateB ? motionStateB->getSimulationPriority() : PERSONAL_SIMULATION_PRIORITY;
+            return motionStateA;
         }
     }
+    return nullptr;
 }
 
+// below this many manifolds for each thread the contacts are updated serially
+const int MIN_MANIFOLDS_PER_THREAD = 64;
+
 void PhysicsEngine::updateContactMap() {
     BT_PROFILE("updateContactMap");
     ++_numContactFrames;
 
     // update all contacts every frame
     int numManifolds = _collisionDispatcher->getNumManifolds();
+    if (_threadPool.getNumThreads() > 1 && numManifolds >= MIN_MANIFOLDS_PER_THREAD * _threadPool.getNumThreads()) {
+        updateContactMapInParallel(numManifolds);
+        return;
+    }
+
     for (int i = 0; i < numManifolds; ++i) {
         btPersistentManifold* contactManifold =  _collisionDispatcher->getManifoldByIndexInternal(i);
         if (contactManifold->getNumContacts() > 0) {
@@ -334,7 +405,7 @@ void PhysicsEngine::updateContactMap() {
             ObjectMotionState* b = static_cast<ObjectMotionState*>(objectB->getUserPointer());
             if (a || b) {
                 // the manifold has up to 4 distinct points, but only extract info from the first
-                _contactMap[ContactKey(a, b)].update(_numContactFrames, contactManifold->getContactPoint(0));
+                getContact(ContactKey(a, b)).update(_numContactFrames, contactManifold->getContactPoint(0));
             }
 
             if (!_sessionID.isNull()) {
@@ -344,47 +415,180 @@ void PhysicsEngine::updateContactMap() {
     }
 }
 
+void PhysicsEngine::updateContactMapInParallel(int numManifolds) {
+    int numThreads = _threadPool.getNumThreads();
+    size_t numShards = _contactMaps.size();
+    bool checkOwnership = !_sessionID.isNull();
+
+    {
+        // each thread sorts the manifolds of its range by the shard of their contact...
+        BT_PROFILE("sortManifolds");
+        _threadPool.run([&](int rangeIndex) {
+            ManifoldRange& range = _manifoldRanges[rangeIndex];
+            for (auto& contacts : range.contactsByShard) {
+                contacts.clear();
+            }
+            range.infections.clear();
+
+            int end = (int)(((int64_t)numManifolds * (rangeIndex + 1)) / numThreads);
+            for (int i = (int)(((int64_t)numManifolds * rangeIndex) / numThreads); i < end; ++i) {
+                btPersistentManifold* contactManifold = _collisionDispatcher->getManifoldByIndexInternal(i);
+                if (contactManifold->getNumContacts() == 0) {
+                    continue;
+                }
+                const btCollisionObject* objectA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
+                const btCollisionObject* objectB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
+                if (!(objectA->isActive() || objectB->isActive())) {
+                    continue;
+                }
+
+                ObjectMotionState* a = static_cast<ObjectMotionState*>(objectA->getUserPointer());
+                ObjectMotionState* b = static_cast<ObjectMotionState*>(objectB->getUserPointer());
+                if (a || b) {
+                    ManifoldContact contact = { ContactKey(a, b), contactManifold };
+                    range.contactsByShard[contactShard(contact.key, numShards)].push_back(contact);
+                }
+
+                if (checkOwnership) {
+                    OwnershipInfection infection;
+                    infection.motionState = findOwnershipInfection(objectA, objectB, infection.priority);
+                    if (infection.motionState) {
+                        range.infections.push_back(infection);
+                    }
+                }
+            }
+        });
+    }
+
+    {
+        // ...then each thread updates the contacts of its shard
+        BT_PROFILE("updateContacts");
+        _threadPool.run([&](int shardIndex) {
+            ContactMap& contactMap = _contactMaps[shardIndex];
+            for (auto& range : _manifoldRanges) {
+                for (auto& contact : range.contactsByShard[shardIndex]) {
+                    contactMap[contact.key].update(_numContactFrames, contact.manifold->getContactPoint(0));
+                }
+            }
+        });
+    }
+
+    if (checkOwnership) {
+        // the bumps change the motion states, they are done serially in the order of the manifolds
+        BT_PROFILE("ownershipInfection");
+        for (auto& range : _manifoldRanges) {
+            for (auto& infection : range.infections) {
+                infection.motionState->bump(infection.priority);
+            }
+        }
+    }
+}
+
+// a body this simulation moves: one we own or nobody owns, or our avatar
+static bool isLocalBody(const btCollisionObject* object, const ObjectMotionState* motionState,
+                        const btCollisionObject* characterObject, const QUuid& sessionID) {
+    if (object == characterObject) {
+        return true;
+    }
+    if (!motionState || object->isStaticObject()) {
+        return false;
+    }
+    QUuid simulatorID = motionState->getSimulatorID();
+    return simulatorID.isNull() || simulatorID == sessionID;
+}
+
+static bool isRemoteBody(const ObjectMotionState* motionState, const QUuid& sessionID) {
+    if (!motionState || motionState->getType() != MOTIONSTATE_TYPE_ENTITY) {
+        return false;
+    }
+    QUuid simulatorID = motionState->getSimulatorID();
+    return !simulatorID.isNull() && simulatorID != sessionID;
+}
+
+void PhysicsEngine::findRemoteBodiesNearLocalBodies() {
+    BT_PROFILE("findRemoteBodies");
+    const btCollisionObject* characterObject = _myAvatarController ? _myAvatarController->getCollisionObject() : nullptr;
+
+    // every pair of the broadphase that passes the collision filters has a manifold, even before it has contacts
+    int numManifolds = _collisionDispatcher->getNumManifolds();
+    for (int i = 0; i < numManifolds; ++i) {
+        btPersistentManifold* manifold = _collisionDispatcher->getManifoldByIndexInternal(i);
+        const btCollisionObject* objectA = static_cast<const btCollisionObject*>(manifold->getBody0());
+        const btCollisionObject* objectB = static_cast<const btCollisionObject*>(manifold->getBody1());
+        ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(objectA->getUserPointer());
+        ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(objectB->getUserPointer());
+
+        ObjectMotionState* remoteMotionState = nullptr;
+        if (isRemoteBody(motionStateB, _sessionID) && isLocalBody(objectA, motionStateA, characterObject, _sessionID)) {
+            remoteMotionState = motionStateB;
+        } else if (isRemoteBody(motionStateA, _sessionID) &&
+                   isLocalBody(objectB, motionStateB, characterObject, _sessionID)) {
+            remoteMotionState = motionStateA;
+        }
+        if (remoteMotionState) {
+            remoteMotionState->markNearLocalBody();
+            if (remoteMotionState->isKinematicRemoteBody()) {
+                _remoteBodiesNearLocalBodies.insert(remoteMotionState);
+            }
+        }
+    }
+}
+
+void PhysicsEngine::wakeRemoteBodiesNearLocalBodies() {
+    if (_remoteBodiesNearLocalBodies.isEmpty()) {
+        return;
+    }
+    // the bodies can't change their motion type during the step, they join the solver as dynamic bodies now
+    BT_PROFILE("wakeRemoteBodies");
+    for (auto motionState : _remoteBodiesNearLocalBodies) {
+        reinsertObject(motionState);
+    }
+    _remoteBodiesNearLocalBodies.clear();
+}
+
 const CollisionEvents& PhysicsEngine::getCollisionEvents() {
     const uint32_t CONTINUE_EVENT_FILTER_FREQUENCY = 10;
     _collisionEvents.clear();
 
     // scan known contacts and trigger events
-    ContactMap::iterator contactItr = _contactMap.begin();
-
-    while (contactItr != _contactMap.end()) {
-        ContactInfo& contact = contactItr->second;
-        ContactEventType type = contact.computeType(_numContactFrames);
-        if(type != CONTACT_EVENT_TYPE_CONTINUE || _numSubsteps % CONTINUE_EVENT_FILTER_FREQUENCY == 0) {
-            ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(contactItr->first._a);
-            ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(contactItr->first._b);
-            glm::vec3 velocityChange = (motionStateA ? motionStateA->getObjectLinearVelocityChange() : glm::vec3(0.0f)) +
-                (motionStateB ? motionStateB->getObjectLinearVelocityChange() : glm::vec3(0.0f));
-
-            if (motionStateA) {
-                QUuid idA = motionStateA->getObjectID();
-                QUuid idB;
-                if (motionStateB) {
-                    idB = motionStateB->getObjectID();
+    for (auto& contactMap : _contactMaps) {
+        ContactMap::iterator contactItr = contactMap.begin();
+
+        while (contactItr != contactMap.end()) {
+            ContactInfo& contact = contactItr->second;
+            ContactEventType type = contact.computeType(_numContactFrames);
+            if(type != CONTACT_EVENT_TYPE_CONTINUE || _numSubsteps % CONTINUE_EVENT_FILTER_FREQUENCY == 0) {
+                ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(contactItr->first._a);
+                ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(contactItr->first._b);
+                glm::vec3 velocityChange = (motionStateA ? motionStateA->getObjectLinearVelocityChange() : glm::vec3(0.0f)) +
+                    (motionStateB ? motionStateB->getObjectLinearVelocityChange() : glm::vec3(0.0f));
+
+                if (motionStateA) {
+                    QUuid idA = motionStateA->getObjectID();
+                    QUuid idB;
+                    if (motionStateB) {
+                        idB = motionStateB->getObjectID();
+                    }
+                    glm::vec3 position = bulletToGLM(contact.getPositionWorldOnB()) + _originOffset;
+                    glm::vec3 penetration = bulletToGLM(contact.distance * contact.normalWorldOnB);
+                    _collisionEvents.push_back(Collision(type, idA, idB, position, penetration, velocityChange));
+                } else if (motionStateB) {
+                    QUuid idB = motionStateB->getObjectID();
+                    glm::vec3 position = bulletToGLM(contact.getPositionWorldOnA()) + _originOffset;
+                    // NOTE: we're flipping the order of A and B (so that the first objectID is never NULL)
+                    // hence we must negate the penetration.
+                    glm::vec3 penetration = - bulletToGLM(contact.distance * contact.normalWorldOnB);
+                    _collisionEvents.push_back(Collision(type, idB, QUuid(), position, penetration, velocityChange));
                 }
-                glm::vec3 position = bulletToGLM(contact.getPositionWorldOnB()) + _originOffset;
-                glm::vec3 penetration = bulletToGLM(contact.distance * contact.normalWorldOnB);
-                _collisionEvents.push_back(Collision(type, idA, idB, position, penetration, velocityChange));
-            } else if (motionStateB) {
-                QUuid idB = motionStateB->getObjectID();
-                glm::vec3 position = bulletToGLM(contact.getPositionWorldOnA()) + _originOffset;
-                // NOTE: we're flipping the order of A and B (so that the first objectID is never NULL)
-                // hence we must negate the penetration.
-                glm::vec3 penetration = - bulletToGLM(contact.distance * contact.normalWorldOnB);
-                _collisionEvents.push_back(Collision(type, idB, QUuid(), position, penetration, velocityChange));
             }
-        }
 
-        if (type == CONTACT_EVENT_TYPE_END) {
-            ContactMap::iterator iterToDelete = contactItr;
-            ++contactItr;
-            _contactMap.erase(iterToDelete);
-        } else {
-            ++contactItr;
+            if (type == CONTACT_EVENT_TYPE_END) {
+                ContactMap::iterator iterToDelete = contactItr;
+                ++contactItr;
+                contactMap.erase(iterToDelete);
+            } else {
+                ++contactItr;
+            }
         }
     }
     return _collisionEvents;
@@ -481,18 +685,21 @@ void PhysicsEngine::addAction(EntityActionPointer action) {
         removeAction(action->getID());
     }
 
-    _objectActions[actionID] = action;
-
     // bullet needs a pointer to the action, but it doesn't use shared pointers.
     // is there a way to bump the reference count?
-    ObjectAction* objectAction = static_cast<ObjectAction*>(action.get());
+    ObjectAction* objectAction = dynamic_cast<ObjectAction*>(action.get());
+    if (!objectAction) {
+        // the actions of an assignment-client only carry their arguments, there is nothing for bullet to step
+        return;
+    }
+    _objectActions[actionID] = action;
     _dynamicsWorld->addAction(objectAction);
 }
 
 void PhysicsEngine::removeAction(const QUuid actionID) {
     if (_objectActions.contains(actionID)) {
         EntityActionPointer action = _objectActions[actionID];
-        ObjectAction* objectAction = static_cast<ObjectAction*>(action.get());
+        ObjectAction* objectAction = dynamic_cast<ObjectAction*>(action.get());
         _dynamicsWorld->removeAction(objectAction);
         _objectActions.remove(actionID);
     }
@@ -22,6 +22,7 @@
 #include "BulletUtil.h"
 #include "ContactInfo.h"
 #include "ObjectMotionState.h"
+#include "PhysicsThreadPool.h"
 #include "ThreadSafeDynamicsWorld.h"
 #include "ObjectAction.h"
 
@@ -51,7 +52,7 @@ public:
     ~PhysicsEngine();
     void init();
 
-    void setSessionUUID(const QUuid& sessionID) { _sessionID = sessionID; }
+    void setSessionUUID(const QUuid& sessionID);
     const QUuid& getSessionID() const { return _sessionID; }
 
     void addObject(ObjectMotionState* motionState);
@@ -64,8 +65,23 @@ public:
     void reinsertObject(ObjectMotionState* object);
 
     void stepSimulation();
+    /// steps the simulation by deltaTime instead of the time since the last step, for repeatable runs
+    void stepSimulation(float deltaTime);
     void updateContactMap();
 
+    /// \param numThreads the number of threads that update the contacts of a substep, one updates them serially
+    void setNumThreads(int numThreads);
+    int getNumThreads() const { return _threadPool.getNumThreads(); }
+
+    /// \param kinematic true if the bodies other simulators own follow their updates kinematically until a body
+    /// simulated here comes into their broadphase pair set, only applies to bodies added after the call
+    void setKinematicRemoteBodies(bool kinematic) { ObjectMotionState::setKinematicRemoteBodies(kinematic); }
+    bool getKinematicRemoteBodies() const { return ObjectMotionState::getKinematicRemoteBodies(); }
+
+    /// \param authoritative true if this engine is the physics-simulator of the domain and owns its moving bodies
+    void setAuthoritativeSimulation(bool authoritative) { ObjectMotionState::setAuthoritativeSimulation(authoritative); }
+    bool getAuthoritativeSimulation() const { return ObjectMotionState::getAuthoritativeSimulation(); }
+
     bool hasOutgoingChanges() const { return _hasOutgoingChanges; }
 
     /// \return reference to list of changed MotionStates.  The list is only valid until beginning of next simulation loop.
@@ -103,6 +119,16 @@ private:
 
     void doOwnershipInfection(const btCollisionObject* objectA, const btCollisionObject* objectB);
 
+    /// \return the object of the pair that catches the simulation ownership of the other one, or nullptr
+    ObjectMotionState* findOwnershipInfection(const btCollisionObject* objectA, const btCollisionObject* objectB,
+                                              quint8& priority) const;
+
+    void findRemoteBodiesNearLocalBodies();
+    void wakeRemoteBodiesNearLocalBodies();
+
+    ContactInfo& getContact(const ContactKey& key);
+    void updateContactMapInParallel(int numManifolds);
+
     btClock _clock;
     btDefaultCollisionConfiguration* _collisionConfig = NULL;
     btCollisionDispatcher* _collisionDispatcher = NULL;
@@ -113,7 +139,27 @@ private:
 
     glm::vec3 _originOffset;
 
-    ContactMap _contactMap;
+    // the contacts are split in shards, one for each thread, so that the threads update them without locks
+    std::vector<ContactMap> _contactMaps;
+
+    // the manifolds a thread found in its range, sorted by the shard of their contact
+    struct ManifoldContact {
+        ContactKey key;
+        btPersistentManifold* manifold;
+    };
+    struct OwnershipInfection {
+        ObjectMotionState* motionState;
+        quint8 priority;
+    };
+    struct ManifoldRange {
+        std::vector<std::vector<ManifoldContact>> contactsByShard;
+        std::vector<OwnershipInfection> infections;
+    };
+    std::vector<ManifoldRange> _manifoldRanges;
+    PhysicsThreadPool _threadPool;
+
+    SetOfMotionStates _remoteBodiesNearLocalBodies; // kinematic remote bodies to add back to the solver
+
     uint32_t _numContactFrames = 0;
     uint32_t _lastNumSubstepsAtUpdateInternal = 0;
 
@@ -0,0 +1,82 @@
+//
+//  PhysicsThreadPool.cpp
+//  libraries/physics/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "PhysicsThreadPool.h"
+
+PhysicsThreadPool::~PhysicsThreadPool() {
+    stopThreads();
+}
+
+void PhysicsThreadPool::setNumThreads(int numThreads) {
+    numThreads = std::max(1, std::min(numThreads, MAX_PHYSICS_THREADS));
+    if (numThreads == getNumThreads()) {
+        return;
+    }
+    stopThreads();
+    for (int i = 1; i < numThreads; ++i) {
+        _threads.emplace_back(&PhysicsThreadPool::workerLoop, this, i, _generation);
+    }
+}
+
+void PhysicsThreadPool::run(const std::function<void(int)>& task) {
+    if (_threads.empty()) {
+        task(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = &task;
+        _numPending = (int)_threads.size();
+        ++_generation;
+    }
+    _startCondition.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this] { return _numPending == 0; });
+    _task = nullptr;
+}
+
+void PhysicsThreadPool::stopThreads() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _startCondition.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+    _stopping = false;
+}
+
+void PhysicsThreadPool::workerLoop(int index, uint32_t generation) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _startCondition.wait(lock, [&] { return _stopping || _generation != generation; });
+        if (_stopping) {
+            return;
+        }
+        generation = _generation;
+        const std::function<void(int)>* task = _task;
+
+        lock.unlock();
+        (*task)(index);
+        lock.lock();
+
+        if (--_numPending == 0) {
+            _doneCondition.notify_one();
+        }
+    }
+}
@@ -0,0 +1,52 @@
+//
+//  PhysicsThreadPool.h
+//  libraries/physics/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsThreadPool_h
+#define hifi_PhysicsThreadPool_h
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+const int MAX_PHYSICS_THREADS = 16;
+
+// Threads that stay around between simulation steps, so that the parts of a step that are split between them don't
+// pay for starting threads several times per frame. The calling thread takes the first part.
+class PhysicsThreadPool {
+public:
+    PhysicsThreadPool() {}
+    ~PhysicsThreadPool();
+
+    /// \param numThreads the number of threads running a task, including the calling thread
+    void setNumThreads(int numThreads);
+    int getNumThreads() const { return (int)_threads.size() + 1; }
+
+    /// runs task(0) to task(getNumThreads() - 1) at the same time, and returns when they are all done
+    /// NOTE: the tasks must not use BT_PROFILE, the profiler of Bullet is only for the calling thread
+    void run(const std::function<void(int)>& task);
+
+private:
+    void stopThreads();
+    void workerLoop(int index, uint32_t generation);
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _startCondition;
+    std::condition_variable _doneCondition;
+    const std::function<void(int)>* _task = nullptr;
+    uint32_t _generation = 0; // counts the runs, so that each worker runs each task once
+    int _numPending = 0;
+    bool _stopping = false;
+};
+
+#endif // hifi_PhysicsThreadPool_h
@@ -13,6 +13,8 @@
 
 #include <SharedUtil.h> // for MILLIMETERS_PER_METER
 
+#include <LinearMath/btConvexHullComputer.h>
+
 #include "ShapeFactory.h"
 #include "BulletUtil.h"
 
@@ -120,3 +122,48 @@ btCollisionShape* ShapeFactory::createShapeFromInfo(const ShapeInfo& info) {
     }
     return shape;
 }
+
+QVector<glm::vec3> ShapeFactory::computeHullPoints(const QVector<glm::vec3>& points) {
+    const int MIN_HULL_POINTS = 4;
+    if (points.size() <= MIN_HULL_POINTS) {
+        return points;
+    }
+    btConvexHullComputer computer;
+    const btScalar NO_SHRINK = 0.0f;
+    computer.compute(&(points[0].x), sizeof(glm::vec3), points.size(), NO_SHRINK, NO_SHRINK);
+    if (computer.vertices.size() < MIN_HULL_POINTS) {
+        // the points are flat, or too few to compute a hull from: keep them all
+        return points;
+    }
+    QVector<glm::vec3> hullPoints;
+    hullPoints.reserve(computer.vertices.size());
+    for (int i = 0; i < computer.vertices.size(); ++i) {
+        hullPoints.push_back(bulletToGLM(computer.vertices[i]));
+    }
+    return hullPoints;
+}
+
+btCollisionShape* ShapeFactory::createPlaceholderShape(const ShapeInfo& info) {
+    const QVector<QVector<glm::vec3>>& points = info.getPoints();
+    if (points.isEmpty() || points[0].isEmpty()) {
+        return nullptr;
+    }
+    glm::vec3 minCorner = points[0][0];
+    glm::vec3 maxCorner = minCorner;
+    foreach (const QVector<glm::vec3>& hullPoints, points) {
+        foreach (const glm::vec3& point, hullPoints) {
+            minCorner = glm::min(minCorner, point);
+            maxCorner = glm::max(maxCorner, point);
+        }
+    }
+    const float MIN_HALF_EXTENT = 0.005f;
+    glm::vec3 halfExtents = glm::max(0.5f * (maxCorner - minCorner), glm::vec3(MIN_HALF_EXTENT));
+
+    // the hulls are in the frame of the compound, so the box is offset to their center
+    auto compound = new btCompoundShape();
+    btTransform trans;
+    trans.setIdentity();
+    trans.setOrigin(glmToBullet(0.5f * (minCorner + maxCorner)));
+    compound->addChildShape(trans, new btBoxShape(glmToBullet(halfExtents)));
+    return compound;
+}
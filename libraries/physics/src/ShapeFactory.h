@@ -22,6 +22,12 @@
 namespace ShapeFactory {
     btConvexHullShape* createConvexHull(const QVector<glm::vec3>& points);
     btCollisionShape* createShapeFromInfo(const ShapeInfo& info);
+
+    /// \return the points of the convex hull of points, without the ones inside it
+    QVector<glm::vec3> computeHullPoints(const QVector<glm::vec3>& points);
+
+    /// \return a box around the points of a compound shape, to use until the shape is built
+    btCollisionShape* createPlaceholderShape(const ShapeInfo& info);
 };
 
 #endif // hifi_ShapeFactory_h
@@ -9,14 +9,139 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QDataStream>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QPair>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QThreadPool>
 
 #include <glm/gtx/norm.hpp>
 
+#include <StreamUtils.h>
+
+#include "PhysicsLogging.h"
 #include "ShapeFactory.h"
 #include "ShapeManager.h"
 
-ShapeManager::ShapeManager() {
+// compound shapes with at least this many points are built in the background
+const int MIN_POINTS_TO_BUILD_IN_BACKGROUND = 256;
+
+const quint32 HULL_CACHE_VERSION = 1;
+
+static void deleteShape(const btCollisionShape* shape) {
+    // if the shape we're about to delete is compound, delete the children first.
+    if (shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE) {
+        const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(shape);
+        const int numChildShapes = compoundShape->getNumChildShapes();
+        for (int i = 0; i < numChildShapes; i ++) {
+            const btCollisionShape* childShape = compoundShape->getChildShape(i);
+            delete childShape;
+        }
+    }
+    delete shape;
+}
+
+// the shapes the background threads built, until the manager collects them
+class BuiltShapes {
+public:
+    ~BuiltShapes() {
+        // the manager is gone, nobody will collect these
+        for (auto& builtShape : shapes) {
+            if (builtShape.second) {
+                deleteShape(builtShape.second);
+            }
+        }
+    }
+
+    QMutex mutex;
+    QVector<QPair<DoubleHashKey, btCollisionShape*>> shapes;
+};
+
+static bool readCachedHulls(const QString& path, int numHulls, QVector<QVector<glm::vec3>>& hulls) {
+    if (path.isEmpty()) {
+        return false;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    quint32 version;
+    qint32 numCachedHulls;
+    in >> version >> numCachedHulls;
+    if (in.status() != QDataStream::Ok || version != HULL_CACHE_VERSION || numCachedHulls != numHulls) {
+        return false;
+    }
+    in >> hulls;
+    return in.status() == QDataStream::Ok && hulls.size() == numHulls;
+}
+
+static void writeCachedHulls(const QString& path, const QVector<QVector<glm::vec3>>& hulls) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(physics) << "Could not cache convex hulls in" << path;
+        return;
+    }
+    QDataStream out(&file);
+    out << HULL_CACHE_VERSION << (qint32)hulls.size() << hulls;
+    file.commit();
+}
+
+// builds the hulls of a compound shape, or reads them from the cache
+class ShapeBuilder : public QRunnable {
+public:
+    ShapeBuilder(const ShapeInfo& info, const DoubleHashKey& key, const QString& cachePath,
+                 const std::shared_ptr<BuiltShapes>& builtShapes);
+
+    virtual void run();
+
+private:
+    ShapeInfo _info;
+    DoubleHashKey _key;
+    QString _cachePath;
+    std::shared_ptr<BuiltShapes> _builtShapes;
+};
+
+ShapeBuilder::ShapeBuilder(const ShapeInfo& info, const DoubleHashKey& key, const QString& cachePath,
+                           const std::shared_ptr<BuiltShapes>& builtShapes) :
+    _info(info),
+    _key(key),
+    _cachePath(cachePath),
+    _builtShapes(builtShapes)
+{
+}
+
+void ShapeBuilder::run() {
+    const QVector<QVector<glm::vec3>>& points = _info.getPoints();
+    QVector<QVector<glm::vec3>> hulls;
+    if (!readCachedHulls(_cachePath, points.size(), hulls)) {
+        // only the points on the hulls are worth keeping: the others make every collision test slower
+        hulls.clear();
+        hulls.reserve(points.size());
+        foreach (const QVector<glm::vec3>& hullPoints, points) {
+            hulls.push_back(ShapeFactory::computeHullPoints(hullPoints));
+        }
+        if (!_cachePath.isEmpty()) {
+            writeCachedHulls(_cachePath, hulls);
+        }
+    }
+
+    // the hulls keep the key of the points they were built from
+    ShapeInfo info = _info;
+    info.setConvexHulls(hulls);
+    btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+
+    QMutexLocker locker(&_builtShapes->mutex);
+    _builtShapes->shapes.push_back(qMakePair(_key, shape));
+}
+
+ShapeManager::ShapeManager() :
+    _builtShapes(std::make_shared<BuiltShapes>())
+{
 }
 
 ShapeManager::~ShapeManager() {
@@ -26,6 +151,20 @@ ShapeManager::~ShapeManager() {
         delete shapeRef->shape;
     }
     _shapeMap.clear();
+
+    int numPlaceholders = _placeholderMap.size();
+    for (int i = 0; i < numPlaceholders; ++i) {
+        deleteShape(_placeholderMap.getAtIndex(i)->shape);
+    }
+    _placeholderMap.clear();
+}
+
+void ShapeManager::setCacheDirectory(const QString& directory) {
+    _cacheDirectory = directory;
+    if (!_cacheDirectory.isEmpty() && !QDir().mkpath(_cacheDirectory)) {
+        qCDebug(physics) << "Could not create the convex hull cache in" << _cacheDirectory;
+        _cacheDirectory.clear();
+    }
 }
 
 btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
@@ -46,6 +185,15 @@ btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         shapeRef->refCount++;
         return shapeRef->shape;
     }
+    if (_buildInBackground && info.getType() == SHAPE_TYPE_COMPOUND) {
+        int numPoints = 0;
+        foreach (const QVector<glm::vec3>& hullPoints, info.getPoints()) {
+            numPoints += hullPoints.size();
+        }
+        if (numPoints >= MIN_POINTS_TO_BUILD_IN_BACKGROUND) {
+            return getPlaceholder(info, key);
+        }
+    }
     btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
     if (shape) {
         ShapeReference newRef;
@@ -57,6 +205,51 @@ btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
     return shape;
 }
 
+// private helper method
+btCollisionShape* ShapeManager::getPlaceholder(const ShapeInfo& info, const DoubleHashKey& key) {
+    ShapeReference* placeholderRef = _placeholderMap.find(key);
+    if (placeholderRef && !placeholderRef->isBuilt) {
+        // the shape is still being built
+        placeholderRef->refCount++;
+        return placeholderRef->shape;
+    }
+
+    QString cachePath;
+    if (!_cacheDirectory.isEmpty()) {
+        cachePath = QString("%1/%2-%3.hulls").arg(_cacheDirectory)
+            .arg(key.getHash(), 8, 16, QChar('0')).arg(key.getHash2(), 8, 16, QChar('0'));
+    }
+    QThreadPool::globalInstance()->start(new ShapeBuilder(info, key, cachePath, _builtShapes));
+
+    if (placeholderRef) {
+        // the shape was collected while bodies still had its old placeholder, which stands in again
+        placeholderRef->isBuilt = false;
+        placeholderRef->refCount++;
+        return placeholderRef->shape;
+    }
+    btCollisionShape* placeholder = ShapeFactory::createPlaceholderShape(info);
+    if (placeholder) {
+        ShapeReference newRef;
+        newRef.refCount = 1;
+        newRef.shape = placeholder;
+        newRef.key = key;
+        _placeholderMap.insert(key, newRef);
+    }
+    return placeholder;
+}
+
+// private helper method
+void ShapeManager::releasePlaceholder(const DoubleHashKey& key) {
+    ShapeReference* placeholderRef = _placeholderMap.find(key);
+    assert(placeholderRef && placeholderRef->refCount > 0);
+    placeholderRef->refCount--;
+    if (placeholderRef->refCount == 0 && placeholderRef->isBuilt) {
+        // a placeholder that is still building is kept for the next body that asks for the shape
+        deleteShape(placeholderRef->shape);
+        _placeholderMap.remove(key);
+    }
+}
+
 // private helper method
 bool ShapeManager::releaseShape(const DoubleHashKey& key) {
     ShapeReference* shapeRef = _shapeMap.find(key);
@@ -94,6 +287,14 @@ bool ShapeManager::releaseShape(const btCollisionShape* shape) {
             return releaseShape(shapeRef->key);
         }
     }
+    int numPlaceholders = _placeholderMap.size();
+    for (int i = 0; i < numPlaceholders; ++i) {
+        ShapeReference* placeholderRef = _placeholderMap.getAtIndex(i);
+        if (shape == placeholderRef->shape) {
+            releasePlaceholder(placeholderRef->key);
+            return true;
+        }
+    }
     return false;
 }
 
@@ -103,23 +304,65 @@ void ShapeManager::collectGarbage() {
         DoubleHashKey& key = _pendingGarbage[i];
         ShapeReference* shapeRef = _shapeMap.find(key);
         if (shapeRef && shapeRef->refCount == 0) {
-            // if the shape we're about to delete is compound, delete the children first.
-            if (shapeRef->shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE) {
-                const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(shapeRef->shape);
-                const int numChildShapes = compoundShape->getNumChildShapes();
-                for (int i = 0; i < numChildShapes; i ++) {
-                    const btCollisionShape* childShape = compoundShape->getChildShape(i);
-                    delete childShape;
-                }
-            }
-
-            delete shapeRef->shape;
+            deleteShape(shapeRef->shape);
             _shapeMap.remove(key);
         }
     }
     _pendingGarbage.clear();
 }
 
+bool ShapeManager::collectBuiltShapes() {
+    QVector<QPair<DoubleHashKey, btCollisionShape*>> builtShapes;
+    {
+        QMutexLocker locker(&_builtShapes->mutex);
+        builtShapes.swap(_builtShapes->shapes);
+    }
+
+    bool hasOutdatedPlaceholders = false;
+    for (auto& builtShape : builtShapes) {
+        const DoubleHashKey& key = builtShape.first;
+        btCollisionShape* shape = builtShape.second;
+        if (!shape) {
+            qCDebug(physics) << "Warning: failed to build shape, its placeholder stays in use";
+            continue;
+        }
+        if (_shapeMap.find(key)) {
+            deleteShape(shape);
+        } else {
+            // nothing references the shape until the bodies with its placeholder ask for it
+            ShapeReference newRef;
+            newRef.refCount = 0;
+            newRef.shape = shape;
+            newRef.key = key;
+            _shapeMap.insert(key, newRef);
+            _pendingGarbage.push_back(key);
+        }
+
+        ShapeReference* placeholderRef = _placeholderMap.find(key);
+        if (placeholderRef) {
+            placeholderRef->isBuilt = true;
+            if (placeholderRef->refCount == 0) {
+                deleteShape(placeholderRef->shape);
+                _placeholderMap.remove(key);
+            } else {
+                hasOutdatedPlaceholders = true;
+            }
+        }
+    }
+    return hasOutdatedPlaceholders;
+}
+
+bool ShapeManager::isOutdatedPlaceholder(const btCollisionShape* shape) const {
+    int numPlaceholders = _placeholderMap.size();
+    for (int i = 0; i < numPlaceholders; ++i) {
+        const ShapeReference* placeholderRef = _placeholderMap.getAtIndex(i);
+        if (shape == placeholderRef->shape) {
+            return placeholderRef->isBuilt;
+        }
+    }
+    return false;
+}
+
 int ShapeManager::getNumReferences(const ShapeInfo& info) const {
     DoubleHashKey key = info.getHash();
     const ShapeReference* shapeRef = _shapeMap.find(key);
@@ -148,5 +391,11 @@ bool ShapeManager::hasShape(const btCollisionShape* shape) const {
             return true;
         }
     }
+    int numPlaceholders = _placeholderMap.size();
+    for (int i = 0; i < numPlaceholders; ++i) {
+        if (shape == _placeholderMap.getAtIndex(i)->shape) {
+            return true;
+        }
+    }
     return false;
 }
@@ -12,20 +12,27 @@
 #ifndef hifi_ShapeManager_h
 #define hifi_ShapeManager_h
 
+#include <memory>
+
 #include <btBulletDynamicsCommon.h>
 #include <LinearMath/btHashMap.h>
 
+#include <QString>
+
 #include <ShapeInfo.h>
 
 #include "DoubleHashKey.h"
 
+class BuiltShapes;
+
 class ShapeManager {
 public:
 
     ShapeManager();
     ~ShapeManager();
 
-    /// \return pointer to shape
+    /// \return pointer to shape, or to a placeholder box while the hulls of a large compound shape are built
+    /// in the background
     btCollisionShape* getShape(const ShapeInfo& info);
 
     /// \return true if shape was found and released
@@ -35,24 +42,46 @@ public:
     /// delete shapes that have zero references
     void collectGarbage();
 
+    /// adds the shapes that were built in the background since the last call
+    /// \return true if any placeholder is now outdated
+    bool collectBuiltShapes();
+
+    /// \return true if shape is a placeholder whose shape was built, and that getShape() no longer returns
+    bool isOutdatedPlaceholder(const btCollisionShape* shape) const;
+
+    /// \param buildInBackground false to build every shape in getShape(), without a placeholder
+    void setBuildInBackground(bool buildInBackground) { _buildInBackground = buildInBackground; }
+
+    /// \param directory where the hulls that were built in the background are cached, empty for no cache
+    void setCacheDirectory(const QString& directory);
+
     // validation methods
     int getNumShapes() const { return _shapeMap.size(); }
+    int getNumPlaceholders() const { return _placeholderMap.size(); }
     int getNumReferences(const ShapeInfo& info) const;
     int getNumReferences(const btCollisionShape* shape) const;
     bool hasShape(const btCollisionShape* shape) const; 
 
 private:
     bool releaseShape(const DoubleHashKey& key);
+    void releasePlaceholder(const DoubleHashKey& key);
+    btCollisionShape* getPlaceholder(const ShapeInfo& info, const DoubleHashKey& key);
 
     struct ShapeReference {
         int refCount;
         btCollisionShape* shape;
         DoubleHashKey key;
-        ShapeReference() : refCount(0), shape(NULL) {}
+        bool isBuilt; // for placeholders: the shape they stand in for was built
+        ShapeReference() : refCount(0), shape(NULL), isBuilt(false) {}
     };
 
     btHashMap<DoubleHashKey, ShapeReference> _shapeMap;
     btAlignedObjectArray<DoubleHashKey> _pendingGarbage;
+
+    btHashMap<DoubleHashKey, ShapeReference> _placeholderMap;
+    std::shared_ptr<BuiltShapes> _builtShapes;
+    bool _buildInBackground = true;
+    QString _cacheDirectory;
 };
 
 #endif // hifi_ShapeManager_h
@@ -0,0 +1,190 @@
+//
+//  BuiltinCodecs.cpp
+//  plugins/src/plugins
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "BuiltinCodecs.h"
+
+#include <stdint.h>
+#include <string.h>
+
+const QString PCMCodec::NAME = "pcm";
+const QString ADPCMCodec::NAME = "adpcm";
+
+class PCMCoder : public Encoder, public Decoder {
+public:
+    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
+        encodedBuffer = decodedBuffer;
+    }
+
+    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
+        decodedBuffer = encodedBuffer;
+    }
+};
+
+Encoder* PCMCodec::createEncoder(int sampleRate, int numChannels) {
+    return new PCMCoder();
+}
+
+Decoder* PCMCodec::createDecoder(int sampleRate, int numChannels) {
+    return new PCMCoder();
+}
+
+static const int ADPCM_STEP_TABLE[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+    4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767
+};
+
+static const int ADPCM_INDEX_TABLE[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static const int ADPCM_MAX_STEP_INDEX = 88;
+
+// per channel: the int16 predictor, the step index, and a byte of padding
+static const int ADPCM_CHANNEL_HEADER_BYTES = 4;
+
+struct ADPCMState {
+    int predictor { 0 };
+    int stepIndex { 0 };
+
+    // applies a nibble to the state, the encoder and decoder share this so they can never drift apart
+    void update(int nibble) {
+        int step = ADPCM_STEP_TABLE[stepIndex];
+
+        int delta = step >> 3;
+        if (nibble & 4) {
+            delta += step;
+        }
+        if (nibble & 2) {
+            delta += step >> 1;
+        }
+        if (nibble & 1) {
+            delta += step >> 2;
+        }
+
+        predictor += (nibble & 8) ? -delta : delta;
+        predictor = predictor < INT16_MIN ? INT16_MIN : (predictor > INT16_MAX ? INT16_MAX : predictor);
+
+        stepIndex += ADPCM_INDEX_TABLE[nibble];
+        stepIndex = stepIndex < 0 ? 0 : (stepIndex > ADPCM_MAX_STEP_INDEX ? ADPCM_MAX_STEP_INDEX : stepIndex);
+    }
+
+    int encode(int sample) {
+        int step = ADPCM_STEP_TABLE[stepIndex];
+        int difference = sample - predictor;
+
+        int nibble = 0;
+        if (difference < 0) {
+            nibble = 8;
+            difference = -difference;
+        }
+        if (difference >= step) {
+            nibble |= 4;
+            difference -= step;
+        }
+        step >>= 1;
+        if (difference >= step) {
+            nibble |= 2;
+            difference -= step;
+        }
+        step >>= 1;
+        if (difference >= step) {
+            nibble |= 1;
+        }
+
+        update(nibble);
+        return nibble;
+    }
+};
+
+class ADPCMEncoder : public Encoder {
+public:
+    ADPCMEncoder(int numChannels) : _numChannels(numChannels), _states(new ADPCMState[numChannels]) {}
+    ~ADPCMEncoder() { delete[] _states; }
+
+    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
+        const int16_t* samples = reinterpret_cast<const int16_t*>(decodedBuffer.constData());
+        int numSamples = decodedBuffer.size() / sizeof(int16_t);
+
+        encodedBuffer.resize(ADPCM_CHANNEL_HEADER_BYTES * _numChannels + (numSamples + 1) / 2);
+        uint8_t* output = reinterpret_cast<uint8_t*>(encodedBuffer.data());
+
+        // write the state each channel starts this frame with
+        for (int c = 0; c < _numChannels; c++) {
+            int16_t predictor = (int16_t)_states[c].predictor;
+            memcpy(output, &predictor, sizeof(predictor));
+            output[2] = (uint8_t)_states[c].stepIndex;
+            output[3] = 0;
+            output += ADPCM_CHANNEL_HEADER_BYTES;
+        }
+
+        // two interleaved samples per byte, low nibble first
+        for (int i = 0; i < numSamples; i++) {
+            int nibble = _states[i % _numChannels].encode(samples[i]);
+            if (i & 1) {
+                output[i >> 1] |= (uint8_t)(nibble << 4);
+            } else {
+                output[i >> 1] = (uint8_t)nibble;
+            }
+        }
+    }
+
+private:
+    int _numChannels;
+    ADPCMState* _states;
+};
+
+class ADPCMDecoder : public Decoder {
+public:
+    ADPCMDecoder(int numChannels) : _numChannels(numChannels), _states(new ADPCMState[numChannels]) {}
+    ~ADPCMDecoder() { delete[] _states; }
+
+    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
+        int headerBytes = ADPCM_CHANNEL_HEADER_BYTES * _numChannels;
+        if (encodedBuffer.size() < headerBytes) {
+            decodedBuffer.clear();
+            return;
+        }
+
+        const uint8_t* input = reinterpret_cast<const uint8_t*>(encodedBuffer.constData());
+
+        for (int c = 0; c < _numChannels; c++) {
+            int16_t predictor;
+            memcpy(&predictor, input, sizeof(predictor));
+            _states[c].predictor = predictor;
+            _states[c].stepIndex = input[2] > ADPCM_MAX_STEP_INDEX ? ADPCM_MAX_STEP_INDEX : input[2];
+            input += ADPCM_CHANNEL_HEADER_BYTES;
+        }
+
+        int numSamples = (encodedBuffer.size() - headerBytes) * 2;
+        numSamples -= numSamples % _numChannels;
+
+        decodedBuffer.resize(numSamples * sizeof(int16_t));
+        int16_t* samples = reinterpret_cast<int16_t*>(decodedBuffer.data());
+
+        for (int i = 0; i < numSamples; i++) {
+            int nibble = (i & 1) ? (input[i >> 1] >> 4) : (input[i >> 1] & 0x0f);
+            ADPCMState& state = _states[i % _numChannels];
+            state.update(nibble);
+            samples[i] = (int16_t)state.predictor;
+        }
+    }
+
+private:
+    int _numChannels;
+    ADPCMState* _states;
+};
+
+Encoder* ADPCMCodec::createEncoder(int sampleRate, int numChannels) {
+    return new ADPCMEncoder(numChannels);
+}
+
+Decoder* ADPCMCodec::createDecoder(int sampleRate, int numChannels) {
+    return new ADPCMDecoder(numChannels);
+}
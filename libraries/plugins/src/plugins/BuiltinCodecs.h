@@ -0,0 +1,35 @@
+//
+//  BuiltinCodecs.h
+//  plugins/src/plugins
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include "CodecPlugin.h"
+
+/// Raw 16-bit PCM, the fallback every audio-mixer and client supports
+class PCMCodec : public CodecPlugin {
+public:
+    static const QString NAME;
+
+    virtual const QString& getName() const override { return NAME; }
+
+    virtual Encoder* createEncoder(int sampleRate, int numChannels) override;
+    virtual Decoder* createDecoder(int sampleRate, int numChannels) override;
+};
+
+/// IMA ADPCM, 4 bits per sample. Every encoded frame carries the predictor state it starts from,
+/// so a lost packet never desynchronizes the decoder.
+class ADPCMCodec : public CodecPlugin {
+public:
+    static const QString NAME;
+
+    virtual const QString& getName() const override { return NAME; }
+
+    virtual Encoder* createEncoder(int sampleRate, int numChannels) override;
+    virtual Decoder* createDecoder(int sampleRate, int numChannels) override;
+};
@@ -0,0 +1,41 @@
+//
+//  CodecPlugin.h
+//  plugins/src/plugins
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <QByteArray>
+
+#include "Plugin.h"
+
+class Encoder {
+public:
+    virtual ~Encoder() {}
+
+    /// encodes one network frame of interleaved int16 samples
+    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) = 0;
+};
+
+class Decoder {
+public:
+    virtual ~Decoder() {}
+
+    /// decodes one network frame back into interleaved int16 samples
+    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) = 0;
+};
+
+/// An audio codec that can be negotiated between the audio-mixer and its clients.
+/// Codecs are identified on the wire by their name, so getName() must be stable across versions.
+class CodecPlugin : public Plugin {
+public:
+    virtual Encoder* createEncoder(int sampleRate, int numChannels) = 0;
+    virtual Decoder* createDecoder(int sampleRate, int numChannels) = 0;
+
+    virtual void releaseEncoder(Encoder* encoder) { delete encoder; }
+    virtual void releaseDecoder(Decoder* decoder) { delete decoder; }
+};
@@ -0,0 +1,60 @@
+//
+//  CodecPlugins.cpp
+//  plugins/src/plugins
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "CodecPlugins.h"
+
+#include <mutex>
+
+#include "BuiltinCodecs.h"
+#include "RuntimePlugin.h"
+
+const CodecPluginList& getCodecPlugins() {
+    static CodecPluginList codecPlugins;
+    static std::once_flag once;
+    std::call_once(once, [&] {
+        // dynamic codecs are usually better than what we ship with, so they are preferred
+        for (auto loader : getLoadedPlugins()) {
+            CodecProvider* codecProvider = qobject_cast<CodecProvider*>(loader->instance());
+            if (codecProvider) {
+                for (auto codecPlugin : codecProvider->getCodecPlugins()) {
+                    if (codecPlugin->isSupported()) {
+                        codecPlugins.push_back(codecPlugin);
+                    }
+                }
+            }
+        }
+
+        codecPlugins.push_back(std::make_shared<ADPCMCodec>());
+
+        // PCM is always last, it's the fallback when nothing else is shared by both sides
+        codecPlugins.push_back(std::make_shared<PCMCodec>());
+
+        for (auto codecPlugin : codecPlugins) {
+            codecPlugin->init();
+        }
+    });
+    return codecPlugins;
+}
+
+CodecPluginPointer getCodecPlugin(const QString& name) {
+    for (auto codecPlugin : getCodecPlugins()) {
+        if (codecPlugin->getName() == name) {
+            return codecPlugin;
+        }
+    }
+    return CodecPluginPointer();
+}
+
+QStringList getCodecPluginNames() {
+    QStringList names;
+    for (auto codecPlugin : getCodecPlugins()) {
+        names << codecPlugin->getName();
+    }
+    return names;
+}
@@ -0,0 +1,26 @@
+//
+//  CodecPlugins.h
+//  plugins/src/plugins
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <QStringList>
+
+#include "Forward.h"
+
+// Kept apart from PluginManager so that processes without display or input plugins (the assignment-client)
+// can use codecs without linking the display-plugins and input-plugins libraries.
+
+/// the supported codecs in order of preference: runtime CodecProvider plugins first, then the built-in codecs
+const CodecPluginList& getCodecPlugins();
+
+/// \return the supported codec with the given name, or nullptr if there is none
+CodecPluginPointer getCodecPlugin(const QString& name);
+
+/// \return the names of the supported codecs in order of preference
+QStringList getCodecPluginNames();
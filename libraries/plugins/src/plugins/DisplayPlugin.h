@@ -120,6 +120,10 @@ public:
         static const glm::mat4 pose; return pose;
     }
 
+    // Samples the head pose again, as late as possible before the frame's views are set up, so that the pose the frame is
+    // rendered with and reported with in setEyeRenderPose is as close as possible to the one the HMD corrects it to
+    virtual void updateHeadPose() {}
+
     // Needed for timewarp style features
     virtual void setEyeRenderPose(Eye eye, const glm::mat4& pose) {
         // NOOP
@@ -10,6 +10,7 @@
 #include <vector>
 #include <memory>
 
+class CodecPlugin;
 class DisplayPlugin;
 class InputPlugin;
 class Plugin;
@@ -20,4 +21,6 @@ using DisplayPluginPointer = std::shared_ptr<DisplayPlugin>;
 using DisplayPluginList = std::vector<DisplayPluginPointer>;
 using InputPluginPointer = std::shared_ptr<InputPlugin>;
 using InputPluginList = std::vector<InputPluginPointer>;
+using CodecPluginPointer = std::shared_ptr<CodecPlugin>;
+using CodecPluginList = std::vector<CodecPluginPointer>;
 
@@ -0,0 +1,48 @@
+//
+//  InputPlugin.cpp
+//  libraries/plugins/src/plugins
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "InputPlugin.h"
+
+#include <chrono>
+
+void InputPlugin::startPolling(int pollsPerSecond) {
+    if (_isPolling) {
+        return;
+    }
+    _isPolling = true;
+    _pollingThread = std::thread(&InputPlugin::runPolling, this, pollsPerSecond);
+}
+
+void InputPlugin::stopPolling() {
+    _isPolling = false;
+    if (_pollingThread.joinable()) {
+        _pollingThread.join();
+    }
+}
+
+void InputPlugin::runPolling(int pollsPerSecond) {
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / pollsPerSecond;
+
+    auto lastPoll = Clock::now();
+    auto nextPoll = lastPoll + period;
+    while (_isPolling) {
+        std::this_thread::sleep_until(nextPoll);
+        auto now = Clock::now();
+        pollDevice(std::chrono::duration<float>(now - lastPoll).count());
+        lastPoll = now;
+
+        // a poll that blocked for longer than a period starts the schedule again, rather than polling to catch up
+        nextPoll += period;
+        if (nextPoll < now) {
+            nextPoll = now + period;
+        }
+    }
+}
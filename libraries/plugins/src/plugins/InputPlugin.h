@@ -10,6 +10,9 @@
 //
 #pragma once
 
+#include <atomic>
+#include <thread>
+
 #include "Plugin.h"
 
 class InputPlugin : public Plugin {
@@ -19,5 +22,21 @@ public:
     virtual void pluginFocusOutEvent() = 0;
 
     virtual void pluginUpdate(float deltaTime, bool jointsCaptured) = 0;
+
+protected:
+    /// Calls pollDevice from a thread of its own at a fixed rate, so that the device is read as soon as it has new
+    /// data and a blocking SDK call does not hold up the frame. Must be stopped before the plugin is deactivated.
+    void startPolling(int pollsPerSecond);
+    void stopPolling();
+    bool isPolling() const { return _isPolling; }
+
+    /// Called from the polling thread, with the time since the last poll
+    virtual void pollDevice(float deltaTime) { }
+
+private:
+    void runPolling(int pollsPerSecond);
+
+    std::thread _pollingThread;
+    std::atomic<bool> _isPolling { false };
 };
 
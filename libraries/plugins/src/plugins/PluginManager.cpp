@@ -9,11 +9,6 @@
 
 #include <mutex>
 
-#include <QtCore/QCoreApplication>
-#include <QtCore/QDir>
-#include <QtCore/QDebug>
-#include <QtCore/QPluginLoader>
-
 #include "RuntimePlugin.h"
 #include "DisplayPlugin.h"
 #include "InputPlugin.h"
@@ -25,32 +20,6 @@ PluginManager* PluginManager::getInstance() {
     return &_manager;
 }
 
-using Loader = QSharedPointer<QPluginLoader>;
-using LoaderList = QList<Loader>;
-
-const LoaderList& getLoadedPlugins() {
-    static std::once_flag once;
-    static LoaderList loadedPlugins;
-    std::call_once(once, [&] {
-        QString pluginPath = QCoreApplication::applicationDirPath() + "/plugins/";
-        QDir pluginDir(pluginPath);
-        pluginDir.setFilter(QDir::Files);
-        if (pluginDir.exists()) {
-            qDebug() << "Loading runtime plugins from " << pluginPath;
-            auto candidates = pluginDir.entryList();
-            for (auto plugin : candidates) {
-                qDebug() << "Attempting plugins " << plugin;
-                QSharedPointer<QPluginLoader> loader(new QPluginLoader(pluginPath + plugin));
-                if (loader->load()) {
-                    qDebug() << "Plugins " << plugin << " success";
-                    loadedPlugins.push_back(loader);
-                }
-            }
-        }
-    });
-    return loadedPlugins;
-}
-
 PluginManager::PluginManager() {
 }
 
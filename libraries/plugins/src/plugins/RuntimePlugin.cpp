@@ -0,0 +1,36 @@
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "RuntimePlugin.h"
+
+#include <mutex>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QDebug>
+
+const LoaderList& getLoadedPlugins() {
+    static std::once_flag once;
+    static LoaderList loadedPlugins;
+    std::call_once(once, [&] {
+        QString pluginPath = QCoreApplication::applicationDirPath() + "/plugins/";
+        QDir pluginDir(pluginPath);
+        pluginDir.setFilter(QDir::Files);
+        if (pluginDir.exists()) {
+            qDebug() << "Loading runtime plugins from " << pluginPath;
+            auto candidates = pluginDir.entryList();
+            for (auto plugin : candidates) {
+                qDebug() << "Attempting plugins " << plugin;
+                QSharedPointer<QPluginLoader> loader(new QPluginLoader(pluginPath + plugin));
+                if (loader->load()) {
+                    qDebug() << "Plugins " << plugin << " success";
+                    loadedPlugins.push_back(loader);
+                }
+            }
+        }
+    });
+    return loadedPlugins;
+}
@@ -11,6 +11,8 @@
 
 #include <QString>
 #include <QObject>
+#include <QSharedPointer>
+#include <QPluginLoader>
 
 #include "Forward.h"
 
@@ -34,3 +36,19 @@ public:
 #define InputProvider_iid "com.highfidelity.plugins.input"
 Q_DECLARE_INTERFACE(InputProvider, InputProvider_iid)
 
+
+
+class CodecProvider {
+public:
+    virtual ~CodecProvider() {}
+    virtual CodecPluginList getCodecPlugins() = 0;
+};
+
+#define CodecProvider_iid "com.highfidelity.plugins.codec"
+Q_DECLARE_INTERFACE(CodecProvider, CodecProvider_iid)
+
+using Loader = QSharedPointer<QPluginLoader>;
+using LoaderList = QList<Loader>;
+
+/// the runtime plugins found in the plugins directory beside the executable, loaded once on first use
+const LoaderList& getLoadedPlugins();
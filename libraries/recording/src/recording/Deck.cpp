@@ -8,6 +8,10 @@
 
 #include "Deck.h"
  
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
 #include <NumericalConstants.h>
 #include <SharedUtil.h>
 
@@ -17,7 +21,72 @@
 
 using namespace recording;
 
-void Deck::queueClip(ClipPointer clip, Time timeOffset) {
+namespace recording {
+
+// The decks on the shared tick, processed one after the other by one timer, at the same time
+class DeckTicker {
+public:
+    void add(const Deck::Pointer& deck);
+    void tick();
+
+private:
+    using Mutex = std::mutex;
+    using Locker = std::unique_lock<Mutex>;
+
+    Mutex _mutex;
+    std::vector<std::weak_ptr<Deck>> _decks;
+    QTimer* _timer { nullptr };
+};
+
+}
+
+static DeckTicker deckTicker;
+
+void DeckTicker::add(const Deck::Pointer& deck) {
+    Locker lock(_mutex);
+    for (const auto& weakDeck : _decks) {
+        if (weakDeck.lock() == deck) {
+            return;
+        }
+    }
+    _decks.push_back(deck);
+
+    // the timer only runs while there are decks on it, on the thread of the deck that started it
+    if (!_timer) {
+        _timer = new QTimer();
+        QObject::connect(_timer, &QTimer::timeout, [this] { tick(); });
+        _timer->start(Deck::SHARED_TICK_INTERVAL_MS);
+    }
+}
+
+void DeckTicker::tick() {
+    std::vector<std::weak_ptr<Deck>> decks;
+    {
+        Locker lock(_mutex);
+        decks = _decks;
+    }
+
+    quint64 now = usecTimestampNow();
+    for (const auto& weakDeck : decks) {
+        auto deck = weakDeck.lock();
+        if (deck && deck->_sharedTick && !deck->_pause) {
+            deck->processDueFrames(now);
+        }
+    }
+
+    Locker lock(_mutex);
+    _decks.erase(std::remove_if(_decks.begin(), _decks.end(), [](const std::weak_ptr<Deck>& weakDeck) {
+        auto deck = weakDeck.lock();
+        return !deck || !deck->_sharedTick || deck->_pause;
+    }), _decks.end());
+    if (_decks.empty() && _timer) {
+        _timer->stop();
+        _timer->deleteLater();
+        _timer = nullptr;
+    }
+}
+
+void Deck::queueClip(ClipPointer clip, Time timeOffset, FrameHandler handler) {
     if (!clip) {
         qCWarning(recordingLog) << "Clip invalid, ignoring";
         return;
@@ -25,6 +94,9 @@ void Deck::queueClip(ClipPointer clip, Time timeOffset) {
 
     // FIXME if the time offset is not zero, wrap the clip in a OffsetClip wrapper
     _clips.push_back(clip);
+    if (handler) {
+        _clipHandlers[clip] = handler;
+    }
 
     _length = std::max(_length, clip->duration());
 }
@@ -34,7 +106,11 @@ void Deck::play() {
         _pause = false;
         _startEpoch = usecTimestampNow() - (_position * USECS_PER_MSEC);
         emit playbackStateChanged();
-        processFrames();
+        if (_sharedTick) {
+            deckTicker.add(shared_from_this());
+        } else {
+            processFrames();
+        }
     }
 }
 
@@ -66,8 +142,12 @@ void Deck::seek(Time position) {
     }
 
     if (!_pause) {
-        // FIXME what if the timer is already running?
-        processFrames();
+        // carry on playing from the new position
+        _startEpoch = usecTimestampNow() - (_position * USECS_PER_MSEC);
+        if (!_sharedTick) {
+            // FIXME what if the timer is already running?
+            processFrames();
+        }
     }
 }
 
@@ -96,21 +176,12 @@ void Deck::processFrames() {
         }
 
         // Handle the frame and advance the clip
-        Frame::handleFrame(nextClip->nextFrame());
+        handleFrame(nextClip, nextClip->nextFrame());
     }
 
 
     if (!nextClip) {
-        qCDebug(recordingLog) << "No more frames available";
-        // No more frames available, so handle the end of playback
-        if (_loop) {
-            qCDebug(recordingLog) << "Looping enabled, seeking back to beginning";
-            // If we have looping enabled, start the playback over
-            seek(0);
-        } else {
-            // otherwise pause playback
-            pause();
-        }
+        endPlayback();
         return;
     } 
 
@@ -121,3 +192,45 @@ void Deck::processFrames() {
         processFrames();
     });
 }
+
+void Deck::handleFrame(const ClipPointer& clip, FrameConstPointer frame) {
+    auto handler = _clipHandlers.find(clip);
+    if (handler != _clipHandlers.end()) {
+        handler->second(frame);
+    } else {
+        Frame::handleFrame(frame);
+    }
+}
+
+void Deck::processDueFrames(quint64 now) {
+    _position = (now - _startEpoch) / USECS_PER_MSEC;
+
+    // every clip is drained of its frames up to now in turn, rather than the soonest frame of all being looked for
+    bool hasMoreFrames = false;
+    for (const auto& clip : _clips) {
+        for (Time framePosition = clip->position(); framePosition <= _position && !_pause;
+             framePosition = clip->position()) {
+            handleFrame(clip, clip->nextFrame());
+        }
+        if (clip->position() != INVALID_TIME) {
+            hasMoreFrames = true;
+        }
+    }
+
+    if (!hasMoreFrames && !_pause) {
+        endPlayback();
+    }
+}
+
+void Deck::endPlayback() {
+    qCDebug(recordingLog) << "No more frames available";
+    // No more frames available, so handle the end of playback
+    if (_loop) {
+        qCDebug(recordingLog) << "Looping enabled, seeking back to beginning";
+        // If we have looping enabled, start the playback over
+        seek(0);
+    } else {
+        // otherwise pause playback
+        pause();
+    }
+}
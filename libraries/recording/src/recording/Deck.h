@@ -10,8 +10,10 @@
 #ifndef hifi_Recording_Deck_h
 #define hifi_Recording_Deck_h
 
+#include <functional>
 #include <utility>
 #include <list>
+#include <map>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -21,14 +23,23 @@
 
 namespace recording {
 
-class Deck : public QObject {
+class Deck : public QObject, public std::enable_shared_from_this<Deck> {
     Q_OBJECT
 public:
     using Pointer = std::shared_ptr<Deck>;
+    using FrameHandler = std::function<void(FrameConstPointer frame)>;
     Deck(QObject* parent = nullptr) : QObject(parent) {}
 
-    // Place a clip on the deck for recording or playback
-    void queueClip(ClipPointer clip, Time timeOffset = 0.0f);
+    // Place a clip on the deck for recording or playback, its frames go to the handler if there is one, and to the
+    // handler registered for their type otherwise
+    void queueClip(ClipPointer clip, Time timeOffset = 0.0f, FrameHandler handler = FrameHandler());
+
+    // Decks on the shared tick are all processed by one timer, every SHARED_TICK_INTERVAL_MS, the frames that came due
+    // since the last tick handled in one batch, instead of each deck waking up for the next frame of its clips.
+    // Such a deck must be held by a Deck::Pointer while it plays.
+    static const Time SHARED_TICK_INTERVAL_MS = 16;
+    void setSharedTick(bool sharedTick) { _sharedTick = sharedTick; }
+    bool hasSharedTick() const { return _sharedTick; }
 
     void play();
     bool isPlaying() { return !_pause; }
@@ -50,18 +61,24 @@ signals:
     void playbackStateChanged();
 
 private:
+    friend class DeckTicker;
     using Clips = std::list<ClipPointer>;
 
     ClipPointer getNextClip();
+    void handleFrame(const ClipPointer& clip, FrameConstPointer frame);
     void processFrames();
+    void processDueFrames(quint64 now);
+    void endPlayback();
 
     QTimer _timer;
     Clips _clips;
+    std::map<ClipPointer, FrameHandler> _clipHandlers;
     quint64 _startEpoch { 0 };
     Time _position { 0 };
     bool _pause { true };
     bool _loop { false };
     Time _length { 0 };
+    bool _sharedTick { false };
 };
 
 }
@@ -81,6 +81,9 @@ FrameType Frame::registerFrameType(const QString& frameTypeName) {
         auto headerType = frameTypes.registerValue("com.highfidelity.recording.Header");
         Q_ASSERT(headerType == Frame::TYPE_HEADER);
         Q_UNUSED(headerType); // FIXME - build system on unix still not upgraded to Qt 5.5.1 so Q_ASSERT still produces warnings
+        auto indexType = frameTypes.registerValue("com.highfidelity.recording.Index");
+        Q_ASSERT(indexType == Frame::TYPE_INDEX);
+        Q_UNUSED(indexType);
     });
     auto result = frameTypes.registerValue(frameTypeName);
     return result;
@@ -26,6 +26,7 @@ public:
 
     static const FrameType TYPE_INVALID = 0xFFFF;
     static const FrameType TYPE_HEADER = 0x0;
+    static const FrameType TYPE_INDEX = 0x1; // where every frame of a clip file is, after its last frame
     FrameType type { TYPE_INVALID };
     Time timeOffset { 0 }; // milliseconds
     QByteArray data;
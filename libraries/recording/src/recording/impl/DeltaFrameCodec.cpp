@@ -0,0 +1,148 @@
+//
+//  DeltaFrameCodec.cpp
+//  libraries/recording/src/recording/impl
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DeltaFrameCodec.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace recording;
+
+const QString DeltaFrameCodec::NAME = QStringLiteral("delta");
+
+// a run of matching bytes shorter than this is kept with the bytes around it, the lengths would take as much room
+static const int MIN_MATCHING_RUN = 4;
+
+static void appendVarInt(QByteArray& output, uint32_t value) {
+    while (value >= 0x80) {
+        output.append((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    output.append((char)value);
+}
+
+static bool readVarInt(const uchar*& current, const uchar* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        if (current == end) {
+            return false;
+        }
+        uchar byte = *current++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DeltaFrameCodec::encodeKeyFrame(const QByteArray& frame, QByteArray& encoded) {
+    encoded.resize(0);
+    encoded.reserve(frame.size() + 1);
+    encoded.append((char)KEY_FRAME);
+    encoded.append(frame);
+}
+
+bool DeltaFrameCodec::encodeDelta(const QByteArray& keyFrame, const QByteArray& frame, QByteArray& encoded) {
+    QByteArray delta;
+    delta.reserve(frame.size() + 1);
+    delta.append((char)DELTA_FRAME);
+    appendVarInt(delta, frame.size());
+
+    const char* key = keyFrame.constData();
+    const char* data = frame.constData();
+    const int keySize = keyFrame.size();
+    const int size = frame.size();
+
+    // the frame is a run of bytes matching the key frame, then a run of bytes that don't, and so on
+    int position = 0;
+    while (position < size) {
+        int matching = 0;
+        while (position + matching < size && position + matching < keySize &&
+               data[position + matching] == key[position + matching]) {
+            ++matching;
+        }
+        int differing = 0;
+        int start = position + matching;
+        while (start + differing < size) {
+            // look for the next run long enough to be worth ending this one
+            int run = 0;
+            while (start + differing + run < size && start + differing + run < keySize &&
+                   data[start + differing + run] == key[start + differing + run] && run < MIN_MATCHING_RUN) {
+                ++run;
+            }
+            if (run >= MIN_MATCHING_RUN) {
+                break;
+            }
+            differing += run + 1;
+        }
+        differing = std::min(differing, size - start);
+
+        appendVarInt(delta, matching);
+        appendVarInt(delta, differing);
+        delta.append(data + start, differing);
+        position = start + differing;
+
+        if (delta.size() > size) {
+            return false;
+        }
+    }
+
+    if (delta.size() > size) {
+        return false;
+    }
+    encoded = delta;
+    return true;
+}
+
+bool DeltaFrameCodec::isKeyFrame(const char* encoded, int size) {
+    return size > 0 && (uint8_t)encoded[0] == KEY_FRAME;
+}
+
+bool DeltaFrameCodec::decode(const QByteArray& keyFrame, const char* encoded, int size, QByteArray& frame) {
+    if (size < 1) {
+        return false;
+    }
+    if ((uint8_t)encoded[0] == KEY_FRAME) {
+        frame.resize(size - 1);
+        memcpy(frame.data(), encoded + 1, size - 1);
+        return true;
+    }
+    if ((uint8_t)encoded[0] != DELTA_FRAME) {
+        return false;
+    }
+
+    const uchar* current = reinterpret_cast<const uchar*>(encoded) + 1;
+    const uchar* end = reinterpret_cast<const uchar*>(encoded) + size;
+    uint32_t frameSize;
+    if (!readVarInt(current, end, frameSize)) {
+        return false;
+    }
+    frame.resize(frameSize);
+    char* data = frame.data();
+
+    uint32_t position = 0;
+    while (position < frameSize) {
+        uint32_t matching, differing;
+        if (!readVarInt(current, end, matching) || !readVarInt(current, end, differing)) {
+            return false;
+        }
+        if (matching > frameSize - position || position + matching > (uint32_t)keyFrame.size() ||
+            differing > frameSize - position - matching || differing > (uint32_t)(end - current)) {
+            return false;
+        }
+        memcpy(data + position, keyFrame.constData() + position, matching);
+        position += matching;
+        memcpy(data + position, current, differing);
+        current += differing;
+        position += differing;
+    }
+    return true;
+}
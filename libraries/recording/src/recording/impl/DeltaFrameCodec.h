@@ -0,0 +1,51 @@
+//
+//  DeltaFrameCodec.h
+//  libraries/recording/src/recording/impl
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_DeltaFrameCodec_h
+#define hifi_Recording_Impl_DeltaFrameCodec_h
+
+#include <stdint.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+namespace recording {
+
+// Encodes the frames of a track, all the frames of one type, against the last key frame of the track. A delta keeps
+// the bytes that differ from the key frame and the lengths of the runs that don't, which for frames with the same
+// layout is most of them. Every delta only needs its key frame to be decoded, so a clip can be read from any frame.
+class DeltaFrameCodec {
+public:
+    static const QString NAME;
+
+    // the most frames of a track between its key frames
+    static const int KEY_FRAME_INTERVAL = 60;
+
+    static void encodeKeyFrame(const QByteArray& frame, QByteArray& encoded);
+
+    // false if the delta would be no smaller than a key frame, encoded is then left as it was
+    static bool encodeDelta(const QByteArray& keyFrame, const QByteArray& frame, QByteArray& encoded);
+
+    static bool isKeyFrame(const char* encoded, int size);
+
+    // the frame the encoded one was made from, keyFrame is ignored for key frames, false if the data is invalid
+    static bool decode(const QByteArray& keyFrame, const char* encoded, int size, QByteArray& frame);
+
+private:
+    enum Kind : uint8_t {
+        KEY_FRAME = 0,
+        DELTA_FRAME = 1
+    };
+};
+
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include "FileClip.h"
 
 #include <algorithm>
+#include <limits>
 
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
@@ -18,6 +19,7 @@
 
 #include "../Frame.h"
 #include "../Logging.h"
+#include "DeltaFrameCodec.h"
 
 
 using namespace recording;
@@ -25,6 +27,9 @@ using namespace recording;
 static const qint64 MINIMUM_FRAME_SIZE = sizeof(FrameType) + sizeof(Time) + sizeof(FrameSize);
 
 static const QString FRAME_TYPE_MAP = QStringLiteral("frameTypes");
+static const QString FRAME_CODEC = QStringLiteral("frameCodec");
+
+static const QByteArray NO_KEY_FRAME;
 
 using FrameHeaderList = std::list<FileClip::FrameHeader>;
 using FrameTranslationMap = QMap<FrameType, FrameType>;
@@ -49,32 +54,89 @@ FrameTranslationMap parseTranslationMap(const QJsonDocument& doc) {
 }
 
 
+bool parseFrameHeader(uchar* const start, uchar* const current, uchar* const end, FileClip::FrameHeader& header) {
+    if (end - current < MINIMUM_FRAME_SIZE) {
+        return false;
+    }
+    auto data = current;
+    memcpy(&(header.type), data, sizeof(FrameType));
+    data += sizeof(FrameType);
+    memcpy(&(header.timeOffset), data, sizeof(Time));
+    data += sizeof(Time);
+    memcpy(&(header.size), data, sizeof(FrameSize));
+    data += sizeof(FrameSize);
+    header.fileOffset = data - start;
+    return end - data >= header.size;
+}
+
 FrameHeaderList parseFrameHeaders(uchar* const start, const qint64& size) {
     using FrameHeader = FileClip::FrameHeader;
     FrameHeaderList results;
-    auto current = start;
-    auto end = current + size;
+    auto end = start + size;
     // Read all the frame headers
     // FIXME move to Frame::readHeader?
-    while (end - current >= MINIMUM_FRAME_SIZE) {
-        FrameHeader header;
-        memcpy(&(header.type), current, sizeof(FrameType));
-        current += sizeof(FrameType);
-        memcpy(&(header.timeOffset), current, sizeof(Time));
-        current += sizeof(Time);
-        memcpy(&(header.size), current, sizeof(FrameSize));
-        current += sizeof(FrameSize);
-        header.fileOffset = current - start;
-        if (end - current < header.size) {
-            current = end;
-            break;
-        }
-        current += header.size;
+    FrameHeader header;
+    for (auto current = start; parseFrameHeader(start, current, end, header); current = start + header.fileOffset + header.size) {
         results.push_back(header);
     }
     return results;
 }
 
+// The index of a clip file is a run of index frames after its last frame, each holding the headers of as many frames
+// as fit in one, then a last index frame, the footer, that holds where the run starts.
+static const qint64 INDEX_ENTRY_SIZE = sizeof(FrameType) + sizeof(Time) + sizeof(FrameSize) + sizeof(quint64);
+static const size_t MAX_INDEX_ENTRIES_PER_FRAME = std::numeric_limits<FrameSize>::max() / INDEX_ENTRY_SIZE;
+static const uint32_t INDEX_FOOTER_MAGIC = 0x78646E49; // "Indx"
+static const FrameSize INDEX_FOOTER_SIZE = sizeof(quint64) + sizeof(uint32_t);
+
+// reads the frame headers from the index without touching the frames, false if the file has no valid index
+bool parseFrameIndex(uchar* const start, const qint64& size, FrameType indexType, FrameHeaderList& results) {
+    using FrameHeader = FileClip::FrameHeader;
+    auto end = start + size;
+    if (size < MINIMUM_FRAME_SIZE + INDEX_FOOTER_SIZE) {
+        return false;
+    }
+    auto footerStart = end - (MINIMUM_FRAME_SIZE + INDEX_FOOTER_SIZE);
+    FrameHeader footer;
+    if (!parseFrameHeader(start, footerStart, end, footer) || footer.type != indexType || footer.size != INDEX_FOOTER_SIZE) {
+        return false;
+    }
+    quint64 indexOffset;
+    uint32_t magic;
+    memcpy(&indexOffset, start + footer.fileOffset, sizeof(quint64));
+    memcpy(&magic, start + footer.fileOffset + sizeof(quint64), sizeof(uint32_t));
+    if (magic != INDEX_FOOTER_MAGIC || indexOffset > (quint64)(footerStart - start)) {
+        return false;
+    }
+
+    FrameHeader indexHeader;
+    for (auto current = start + indexOffset; current < footerStart; current = start + indexHeader.fileOffset + indexHeader.size) {
+        if (!parseFrameHeader(start, current, footerStart, indexHeader) || indexHeader.type != indexType) {
+            results.clear();
+            return false;
+        }
+        auto entry = start + indexHeader.fileOffset;
+        auto entriesEnd = entry + (indexHeader.size / INDEX_ENTRY_SIZE) * INDEX_ENTRY_SIZE;
+        for (; entry < entriesEnd; entry += INDEX_ENTRY_SIZE) {
+            FrameHeader header;
+            auto field = entry;
+            memcpy(&(header.type), field, sizeof(FrameType));
+            field += sizeof(FrameType);
+            memcpy(&(header.timeOffset), field, sizeof(Time));
+            field += sizeof(Time);
+            memcpy(&(header.size), field, sizeof(FrameSize));
+            field += sizeof(FrameSize);
+            memcpy(&(header.fileOffset), field, sizeof(quint64));
+            if (header.fileOffset + header.size > indexOffset) {
+                results.clear();
+                return false;
+            }
+            results.push_back(header);
+        }
+    }
+    return true;
+}
+
 
 FileClip::FileClip(const QString& fileName) : _file(fileName) {
     auto size = _file.size();
@@ -89,18 +151,13 @@ FileClip::FileClip(const QString& fileName) : _file(fileName) {
         return;
     }
 
-    FrameHeaderList parsedFrameHeaders = parseFrameHeaders(_map, size);
-
-    // Verify that at least one frame exists and that the first frame is a header
-    if (0 == parsedFrameHeaders.size()) {
-        qWarning() << "No frames found, invalid file";
-        return;
-    }
-
-    // Grab the file header
+    // Grab the file header, the first frame
     {
-        auto fileHeaderFrameHeader = *parsedFrameHeaders.begin();
-        parsedFrameHeaders.pop_front();
+        FrameHeader fileHeaderFrameHeader;
+        if (!parseFrameHeader(_map, _map, _map + size, fileHeaderFrameHeader)) {
+            qWarning() << "No frames found, invalid file";
+            return;
+        }
         if (fileHeaderFrameHeader.type != Frame::TYPE_HEADER) {
             qWarning() << "Missing header frame, invalid file";
             return;
@@ -119,6 +176,17 @@ FileClip::FileClip(const QString& fileName) : _file(fileName) {
         }
         qDebug() << translationMap;
 
+        // files written before the frames were delta encoded hold them as they were recorded
+        _isDeltaEncoded = _fileHeader.object()[FRAME_CODEC].toString() == DeltaFrameCodec::NAME;
+
+        // files written before the index was added are scanned for their frames
+        FrameHeaderList parsedFrameHeaders;
+        FrameType indexType = translationMap.key(Frame::TYPE_INDEX, Frame::TYPE_INVALID);
+        if (indexType == Frame::TYPE_INVALID || !parseFrameIndex(_map, size, indexType, parsedFrameHeaders)) {
+            parsedFrameHeaders = parseFrameHeaders(_map, size);
+            parsedFrameHeaders.pop_front();
+        }
+
         // Update the loaded headers with the frame data
         _frameHeaders.reserve(parsedFrameHeaders.size());
         for (auto& frameHeader : parsedFrameHeaders) {
@@ -126,6 +194,9 @@ FileClip::FileClip(const QString& fileName) : _file(fileName) {
                 continue;
             }
             frameHeader.type = translationMap[frameHeader.type];
+            if (frameHeader.type == Frame::TYPE_INDEX) {
+                continue;
+            }
             _frameHeaders.push_back(frameHeader);
         }
     }
@@ -182,15 +253,74 @@ bool FileClip::write(const QString& fileName, Clip::Pointer clip) {
 
         QJsonObject rootObject;
         rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
+        rootObject.insert(FRAME_CODEC, DeltaFrameCodec::NAME);
         QByteArray headerFrameData = QJsonDocument(rootObject).toBinaryData();
         if (!writeFrame(outputFile, Frame({ Frame::TYPE_HEADER, 0, headerFrameData }))) {
             return false;
         }
     }
 
+    // every frame type is a track of its own, delta encoded against its last key frame
+    struct Track {
+        QByteArray keyFrame;
+        int framesSinceKeyFrame { DeltaFrameCodec::KEY_FRAME_INTERVAL };
+    };
+    QHash<FrameType, Track> tracks;
+
+    FrameHeaderVector frameHeaders;
+    frameHeaders.reserve(clip->frameCount());
     clip->seek(0);
+    Frame encodedFrame;
     for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
-        if (!writeFrame(outputFile, *frame)) {
+        Track& track = tracks[frame->type];
+        if (track.framesSinceKeyFrame < DeltaFrameCodec::KEY_FRAME_INTERVAL &&
+            DeltaFrameCodec::encodeDelta(track.keyFrame, frame->data, encodedFrame.data)) {
+            ++track.framesSinceKeyFrame;
+        } else {
+            DeltaFrameCodec::encodeKeyFrame(frame->data, encodedFrame.data);
+            track.keyFrame = frame->data;
+            track.framesSinceKeyFrame = 0;
+        }
+        encodedFrame.type = frame->type;
+        encodedFrame.timeOffset = frame->timeOffset;
+
+        FrameHeader header;
+        header.type = encodedFrame.type;
+        header.timeOffset = encodedFrame.timeOffset;
+        header.size = encodedFrame.data.size();
+        header.fileOffset = outputFile.pos() + MINIMUM_FRAME_SIZE;
+        if (!writeFrame(outputFile, encodedFrame)) {
+            return false;
+        }
+        if (frame->type != Frame::TYPE_INVALID) {
+            frameHeaders.push_back(header);
+        }
+    }
+
+    // the index frames have the time of the last frame, so that readers that scan the frames don't see a longer clip
+    {
+        Time lastTimeOffset = frameHeaders.empty() ? 0 : frameHeaders.rbegin()->timeOffset;
+        quint64 indexOffset = outputFile.pos();
+        for (size_t first = 0; first < frameHeaders.size(); first += MAX_INDEX_ENTRIES_PER_FRAME) {
+            size_t last = std::min(frameHeaders.size(), first + MAX_INDEX_ENTRIES_PER_FRAME);
+            QByteArray entries;
+            entries.reserve((int)((last - first) * INDEX_ENTRY_SIZE));
+            for (size_t i = first; i < last; i++) {
+                const FrameHeader& header = frameHeaders[i];
+                entries.append((const char*)&(header.type), sizeof(FrameType));
+                entries.append((const char*)&(header.timeOffset), sizeof(Time));
+                entries.append((const char*)&(header.size), sizeof(FrameSize));
+                entries.append((const char*)&(header.fileOffset), sizeof(quint64));
+            }
+            if (!writeFrame(outputFile, Frame({ Frame::TYPE_INDEX, (float)lastTimeOffset, entries }))) {
+                return false;
+            }
+        }
+
+        QByteArray footer;
+        footer.append((const char*)&indexOffset, sizeof(quint64));
+        footer.append((const char*)&INDEX_FOOTER_MAGIC, sizeof(uint32_t));
+        if (!writeFrame(outputFile, Frame({ Frame::TYPE_INDEX, (float)lastTimeOffset, footer }))) {
             return false;
         }
     }
@@ -229,17 +359,57 @@ Time FileClip::position() const {
 FramePointer FileClip::readFrame(uint32_t frameIndex) const {
     FramePointer result;
     if (frameIndex < _frameHeaders.size()) {
-        result = std::make_shared<Frame>();
+        // playback hands each frame to its handler and lets go of it, so the frame and its data are usually reused
+        if (!_frame || !_frame.unique()) {
+            _frame = std::make_shared<Frame>();
+        }
+        result = _frame;
         const FrameHeader& header = _frameHeaders[frameIndex];
         result->type = header.type;
         result->timeOffset = header.timeOffset;
-        if (header.size) {
-            result->data.insert(0, reinterpret_cast<char*>(_map)+header.fileOffset, header.size);
+        const char* data = reinterpret_cast<char*>(_map) + header.fileOffset;
+        if (_isDeltaEncoded) {
+            const QByteArray& keyFrame = DeltaFrameCodec::isKeyFrame(data, header.size) ?
+                NO_KEY_FRAME : findKeyFrame(frameIndex);
+            if (!DeltaFrameCodec::decode(keyFrame, data, header.size, result->data)) {
+                qCWarning(recordingLog) << "Unable to decode frame" << frameIndex;
+                result->data.resize(0);
+            }
+        } else {
+            result->data.resize(header.size);
+            if (header.size) {
+                memcpy(result->data.data(), data, header.size);
+            }
         }
     }
     return result;
 }
 
+const QByteArray& FileClip::findKeyFrame(uint32_t frameIndex) const {
+    FrameType type = _frameHeaders[frameIndex].type;
+    KeyFrame& keyFrame = _keyFrames[type];
+
+    // the key frames of a track are at most DeltaFrameCodec::KEY_FRAME_INTERVAL of its frames apart
+    for (uint32_t index = frameIndex; index-- > 0; ) {
+        const FrameHeader& header = _frameHeaders[index];
+        if (header.type != type) {
+            continue;
+        }
+        const char* data = reinterpret_cast<char*>(_map) + header.fileOffset;
+        if (!DeltaFrameCodec::isKeyFrame(data, header.size)) {
+            continue;
+        }
+        if (keyFrame.frameIndex != index) {
+            keyFrame.frameIndex = index;
+            keyFrame.data = QByteArray(data + 1, header.size - 1);
+        }
+        return keyFrame.data;
+    }
+    keyFrame.frameIndex = INVALID_KEY_FRAME;
+    keyFrame.data.clear();
+    return keyFrame.data;
+}
+
 FrameConstPointer FileClip::peekFrame() const {
     Locker lock(_mutex);
     return readFrame(_frameIndex);
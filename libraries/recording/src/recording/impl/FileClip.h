@@ -13,6 +13,7 @@
 #include "../Clip.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QHash>
 #include <QtCore/QJsonDocument>
 
 #include <mutex>
@@ -64,6 +65,19 @@ private:
     uint32_t _frameIndex { 0 };
     uchar* _map { nullptr };
     FrameHeaderVector _frameHeaders;
+
+    // the last frame read, filled in again by the next read once nothing else holds on to it
+    mutable FramePointer _frame;
+
+    // the last key frame of each track that a delta was decoded against
+    static const uint32_t INVALID_KEY_FRAME = (uint32_t)-1;
+    struct KeyFrame {
+        uint32_t frameIndex { INVALID_KEY_FRAME };
+        QByteArray data;
+    };
+    const QByteArray& findKeyFrame(uint32_t frameIndex) const;
+    bool _isDeltaEncoded { false };
+    mutable QHash<FrameType, KeyFrame> _keyFrames;
 };
 
 }
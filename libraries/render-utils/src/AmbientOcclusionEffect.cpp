@@ -30,6 +30,7 @@
 #include "gaussian_blur_horizontal_vert.h"
 #include "gaussian_blur_frag.h"
 #include "occlusion_blend_frag.h"
+#include "occlusion_temporal_frag.h"
 
 
 AmbientOcclusion::AmbientOcclusion() {
@@ -58,6 +59,7 @@ const gpu::PipelinePointer& AmbientOcclusion::getOcclusionPipeline() {
         _depthTexCoordScaleLoc = program->getUniforms().findLocation("depthTexCoordScale");
         _renderTargetResLoc = program->getUniforms().findLocation("renderTargetRes");
         _renderTargetResInvLoc = program->getUniforms().findLocation("renderTargetResInv");
+        _frameJitterLoc = program->getUniforms().findLocation("frameJitter");
 
         gpu::StatePointer state = gpu::StatePointer(new gpu::State());
 
@@ -68,14 +70,6 @@ const gpu::PipelinePointer& AmbientOcclusion::getOcclusionPipeline() {
             gpu::State::SRC_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::INV_SRC_ALPHA,
             gpu::State::DEST_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::ZERO);
 
-        // Link the occlusion FBO to texture
-        _occlusionBuffer = gpu::FramebufferPointer(gpu::Framebuffer::create(gpu::Element::COLOR_RGBA_32,
-            DependencyManager::get<FramebufferCache>()->getFrameBufferSize().width(), DependencyManager::get<FramebufferCache>()->getFrameBufferSize().height()));
-        auto format = gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA);
-        auto width = _occlusionBuffer->getWidth();
-        auto height = _occlusionBuffer->getHeight();
-        auto defaultSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT);
-        _occlusionTexture = gpu::TexturePointer(gpu::Texture::create2D(format, width, height, defaultSampler));
 
         // Good to go add the brand new pipeline
         _occlusionPipeline.reset(gpu::Pipeline::create(program, state));
@@ -101,14 +95,6 @@ const gpu::PipelinePointer& AmbientOcclusion::getVBlurPipeline() {
             gpu::State::SRC_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::INV_SRC_ALPHA,
             gpu::State::DEST_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::ZERO);
 
-        // Link the horizontal blur FBO to texture
-        _vBlurBuffer = gpu::FramebufferPointer(gpu::Framebuffer::create(gpu::Element::COLOR_RGBA_32,
-            DependencyManager::get<FramebufferCache>()->getFrameBufferSize().width(), DependencyManager::get<FramebufferCache>()->getFrameBufferSize().height()));
-        auto format = gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA);
-        auto width = _vBlurBuffer->getWidth();
-        auto height = _vBlurBuffer->getHeight();
-        auto defaultSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT);
-        _vBlurTexture = gpu::TexturePointer(gpu::Texture::create2D(format, width, height, defaultSampler));
 
         // Good to go add the brand new pipeline
         _vBlurPipeline.reset(gpu::Pipeline::create(program, state));
@@ -134,14 +120,6 @@ const gpu::PipelinePointer& AmbientOcclusion::getHBlurPipeline() {
             gpu::State::SRC_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::INV_SRC_ALPHA,
             gpu::State::DEST_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::ZERO);
 
-        // Link the horizontal blur FBO to texture
-        _hBlurBuffer = gpu::FramebufferPointer(gpu::Framebuffer::create(gpu::Element::COLOR_RGBA_32,
-            DependencyManager::get<FramebufferCache>()->getFrameBufferSize().width(), DependencyManager::get<FramebufferCache>()->getFrameBufferSize().height()));
-        auto format = gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA);
-        auto width = _hBlurBuffer->getWidth();
-        auto height = _hBlurBuffer->getHeight();
-        auto defaultSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT);
-        _hBlurTexture = gpu::TexturePointer(gpu::Texture::create2D(format, width, height, defaultSampler));
 
         // Good to go add the brand new pipeline
         _hBlurPipeline.reset(gpu::Pipeline::create(program, state));
@@ -149,6 +127,37 @@ const gpu::PipelinePointer& AmbientOcclusion::getHBlurPipeline() {
     return _hBlurPipeline;
 }
 
+const gpu::PipelinePointer& AmbientOcclusion::getTemporalPipeline() {
+    if (!_temporalPipeline) {
+        auto vs = gpu::ShaderPointer(gpu::Shader::createVertex(std::string(ambient_occlusion_vert)));
+        auto ps = gpu::ShaderPointer(gpu::Shader::createPixel(std::string(occlusion_temporal_frag)));
+        gpu::ShaderPointer program = gpu::ShaderPointer(gpu::Shader::createProgram(vs, ps));
+
+        gpu::Shader::BindingSet slotBindings;
+        slotBindings.insert(gpu::Shader::Binding(std::string("occlusionTexture"), 0));
+        slotBindings.insert(gpu::Shader::Binding(std::string("historyTexture"), 1));
+        slotBindings.insert(gpu::Shader::Binding(std::string("depthTexture"), 2));
+
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        _temporalNearLoc = program->getUniforms().findLocation("near");
+        _temporalDepthScaleLoc = program->getUniforms().findLocation("depthScale");
+        _temporalDepthTexCoordOffsetLoc = program->getUniforms().findLocation("depthTexCoordOffset");
+        _temporalDepthTexCoordScaleLoc = program->getUniforms().findLocation("depthTexCoordScale");
+        _reprojectionLoc = program->getUniforms().findLocation("reprojection");
+        _feedbackLoc = program->getUniforms().findLocation("feedback");
+        _temporalOcclusionResInvLoc = program->getUniforms().findLocation("occlusionTextureResInv");
+
+        gpu::StatePointer state = gpu::StatePointer(new gpu::State());
+
+        state->setDepthTest(false, false, gpu::LESS_EQUAL);
+
+        // Good to go add the brand new pipeline
+        _temporalPipeline.reset(gpu::Pipeline::create(program, state));
+    }
+    return _temporalPipeline;
+}
+
 const gpu::PipelinePointer& AmbientOcclusion::getBlendPipeline() {
     if (!_blendPipeline) {
         auto vs = gpu::ShaderPointer(gpu::Shader::createVertex(std::string(ambient_occlusion_vert)));
@@ -157,9 +166,14 @@ const gpu::PipelinePointer& AmbientOcclusion::getBlendPipeline() {
 
         gpu::Shader::BindingSet slotBindings;
         slotBindings.insert(gpu::Shader::Binding(std::string("blurredOcclusionTexture"), 0));
+        slotBindings.insert(gpu::Shader::Binding(std::string("depthTexture"), 1));
 
         gpu::Shader::makeProgram(*program, slotBindings);
 
+        _blendNearLoc = program->getUniforms().findLocation("near");
+        _blendDepthScaleLoc = program->getUniforms().findLocation("depthScale");
+        _blendOcclusionResLoc = program->getUniforms().findLocation("occlusionTextureRes");
+
         gpu::StatePointer state = gpu::StatePointer(new gpu::State());
 
         state->setDepthTest(false, false, gpu::LESS_EQUAL);
@@ -174,13 +188,55 @@ const gpu::PipelinePointer& AmbientOcclusion::getBlendPipeline() {
     return _blendPipeline;
 }
 
+void AmbientOcclusion::updateBuffers(const QSize& frameBufferSize, int resolutionLevel) {
+    if (_occlusionBuffer && frameBufferSize == _frameBufferSize && resolutionLevel == _resolutionLevel) {
+        return;
+    }
+    _frameBufferSize = frameBufferSize;
+    _resolutionLevel = resolutionLevel;
+    _hasHistory = false;
+
+    auto format = gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA);
+    auto width = std::max(frameBufferSize.width() >> resolutionLevel, 1);
+    auto height = std::max(frameBufferSize.height() >> resolutionLevel, 1);
+    auto defaultSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT);
+
+    // Link the FBOs to their textures
+    _occlusionTexture = gpu::TexturePointer(gpu::Texture::create2D(format, width, height, defaultSampler));
+    _occlusionBuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
+    _occlusionBuffer->setRenderBuffer(0, _occlusionTexture);
+
+    _vBlurTexture = gpu::TexturePointer(gpu::Texture::create2D(format, width, height, defaultSampler));
+    _vBlurBuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
+    _vBlurBuffer->setRenderBuffer(0, _vBlurTexture);
+
+    _hBlurTexture = gpu::TexturePointer(gpu::Texture::create2D(format, width, height, defaultSampler));
+    _hBlurBuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
+    _hBlurBuffer->setRenderBuffer(0, _hBlurTexture);
+
+    for (int i = 0; i < 2; i++) {
+        _historyTextures[i] = gpu::TexturePointer(gpu::Texture::create2D(format, width, height, defaultSampler));
+        _historyBuffers[i] = gpu::FramebufferPointer(gpu::Framebuffer::create());
+        _historyBuffers[i]->setRenderBuffer(0, _historyTextures[i]);
+    }
+}
+
 void AmbientOcclusion::run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext) {
     assert(renderContext->args);
     assert(renderContext->args->_viewFrustum);
 
     RenderArgs* args = renderContext->args;
+
+    auto framebufferCache = DependencyManager::get<FramebufferCache>();
+    int resolutionLevel = glm::clamp(renderContext->_occlusionResolutionLevel, 0, MAX_RESOLUTION_LEVEL);
+    updateBuffers(framebufferCache->getFrameBufferSize(), resolutionLevel);
+
+    bool isTemporal = renderContext->_occlusionTemporal;
+    if (!isTemporal) {
+        _hasHistory = false;
+    }
+
     gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
-        auto framebufferCache = DependencyManager::get<FramebufferCache>();
         QSize framebufferSize = framebufferCache->getFrameBufferSize();
         float fbWidth = framebufferSize.width();
         float fbHeight = framebufferSize.height();
@@ -189,6 +245,11 @@ void AmbientOcclusion::run(const render::SceneContextPointer& sceneContext, cons
         float tMin = args->_viewport.y / fbHeight;
         float tHeight = args->_viewport.w / fbHeight;
 
+        // The occlusion, blur and accumulation steps run in the viewport scaled down to the occlusion buffers
+        float occlusionWidth = _occlusionTexture->getWidth();
+        float occlusionHeight = _occlusionTexture->getHeight();
+        glm::ivec4 occlusionViewport(args->_viewport.x >> resolutionLevel, args->_viewport.y >> resolutionLevel,
+            std::max(args->_viewport.z >> resolutionLevel, 1), std::max(args->_viewport.w >> resolutionLevel, 1));
 
         glm::mat4 projMat;
         Transform viewMat;
@@ -197,12 +258,12 @@ void AmbientOcclusion::run(const render::SceneContextPointer& sceneContext, cons
         batch.setProjectionTransform(projMat);
         batch.setViewTransform(viewMat);
         batch.setModelTransform(Transform());
+        batch.setViewportTransform(occlusionViewport);
 
         // Occlusion step
         getOcclusionPipeline();
         batch.setResourceTexture(0, framebufferCache->getPrimaryDepthTexture());
         batch.setResourceTexture(1, framebufferCache->getPrimaryNormalTexture());
-        _occlusionBuffer->setRenderBuffer(0, _occlusionTexture);
         batch.setFramebuffer(_occlusionBuffer);
 
         // Occlusion uniforms
@@ -241,8 +302,16 @@ void AmbientOcclusion::run(const render::SceneContextPointer& sceneContext, cons
         batch._glUniform2f(_depthTexCoordOffsetLoc, depthTexCoordOffsetS, depthTexCoordOffsetT);
         batch._glUniform2f(_depthTexCoordScaleLoc, depthTexCoordScaleS, depthTexCoordScaleT);
 
-        batch._glUniform2f(_renderTargetResLoc, fbWidth, fbHeight);
-        batch._glUniform2f(_renderTargetResInvLoc, 1.0f / fbWidth, 1.0f / fbHeight);
+        // the sample steps are in the pixels of the occlusion buffer
+        batch._glUniform2f(_renderTargetResLoc, occlusionWidth, occlusionHeight);
+        batch._glUniform2f(_renderTargetResInvLoc, 1.0f / occlusionWidth, 1.0f / occlusionHeight);
+
+        // the noise only moves when the frames are averaged
+        const float GOLDEN_RATIO_FRACTION = 0.618034f;
+        const float SILVER_RATIO_FRACTION = 0.414214f;
+        float jitter = isTemporal ? (float)(_frameCount % 64) : 0.0f;
+        batch._glUniform2f(_frameJitterLoc, glm::fract(jitter * GOLDEN_RATIO_FRACTION),
+            glm::fract(jitter * SILVER_RATIO_FRACTION));
 
         glm::vec4 color(0.0f, 0.0f, 0.0f, 1.0f);
         glm::vec2 bottomLeft(-1.0f, -1.0f);
@@ -254,7 +323,6 @@ void AmbientOcclusion::run(const render::SceneContextPointer& sceneContext, cons
         // Vertical blur step
         getVBlurPipeline();
         batch.setResourceTexture(0, _occlusionTexture);
-        _vBlurBuffer->setRenderBuffer(0, _vBlurTexture);
         batch.setFramebuffer(_vBlurBuffer);
 
         // Bind the second gpu::Pipeline we need - for calculating blur buffer
@@ -265,7 +333,6 @@ void AmbientOcclusion::run(const render::SceneContextPointer& sceneContext, cons
         // Horizontal blur step
         getHBlurPipeline();
         batch.setResourceTexture(0, _vBlurTexture);
-        _hBlurBuffer->setRenderBuffer(0, _hBlurTexture);
         batch.setFramebuffer(_hBlurBuffer);
 
         // Bind the third gpu::Pipeline we need - for calculating blur buffer
@@ -273,14 +340,58 @@ void AmbientOcclusion::run(const render::SceneContextPointer& sceneContext, cons
 
         DependencyManager::get<GeometryCache>()->renderQuad(batch, bottomLeft, topRight, texCoordTopLeft, texCoordBottomRight, color);
 
-        // Blend step
+        gpu::TexturePointer blurredOcclusionTexture = _hBlurTexture;
+
+        // Temporal step, the occlusion of this frame mixed into the one of the last frame where the pixels were then
+        if (isTemporal) {
+            int lastIndex = _historyIndex;
+            int index = 1 - lastIndex;
+            glm::mat4 viewProjection = projMat * glm::inverse(viewMat.getMatrix());
+            glm::mat4 reprojection = (_hasHistory ? _lastViewProjection : viewProjection) * viewMat.getMatrix();
+
+            batch.setResourceTexture(0, _hBlurTexture);
+            batch.setResourceTexture(1, _historyTextures[lastIndex]);
+            batch.setResourceTexture(2, framebufferCache->getPrimaryDepthTexture());
+            batch.setFramebuffer(_historyBuffers[index]);
+
+            batch.setPipeline(getTemporalPipeline());
+            batch._glUniform1f(_temporalNearLoc, nearVal);
+            batch._glUniform1f(_temporalDepthScaleLoc, depthScale);
+            batch._glUniform2f(_temporalDepthTexCoordOffsetLoc, depthTexCoordOffsetS, depthTexCoordOffsetT);
+            batch._glUniform2f(_temporalDepthTexCoordScaleLoc, depthTexCoordScaleS, depthTexCoordScaleT);
+            batch._glUniformMatrix4fv(_reprojectionLoc, 1, false, reinterpret_cast< const float* >(&reprojection));
+            const float HISTORY_FEEDBACK = 0.9f;
+            batch._glUniform1f(_feedbackLoc, _hasHistory ? HISTORY_FEEDBACK : 0.0f);
+            batch._glUniform2f(_temporalOcclusionResInvLoc, 1.0f / occlusionWidth, 1.0f / occlusionHeight);
+
+            DependencyManager::get<GeometryCache>()->renderQuad(batch, bottomLeft, topRight, texCoordTopLeft, texCoordBottomRight, color);
+
+            batch.setResourceTexture(1, nullptr);
+            batch.setResourceTexture(2, nullptr);
+
+            blurredOcclusionTexture = _historyTextures[index];
+            _historyIndex = index;
+            _lastViewProjection = viewProjection;
+            _hasHistory = true;
+        }
+
+        // Blend step, upsampled to the framebuffer
         getBlendPipeline();
-        batch.setResourceTexture(0, _hBlurTexture);
+        batch.setViewportTransform(args->_viewport);
+        batch.setResourceTexture(0, blurredOcclusionTexture);
+        batch.setResourceTexture(1, framebufferCache->getPrimaryDepthTexture());
         batch.setFramebuffer(framebufferCache->getPrimaryFramebuffer());
 
         // Bind the fourth gpu::Pipeline we need - for blending the primary color buffer with blurred occlusion texture
         batch.setPipeline(getBlendPipeline());
+        batch._glUniform1f(_blendNearLoc, nearVal);
+        batch._glUniform1f(_blendDepthScaleLoc, depthScale);
+        batch._glUniform2f(_blendOcclusionResLoc, occlusionWidth, occlusionHeight);
 
         DependencyManager::get<GeometryCache>()->renderQuad(batch, bottomLeft, topRight, texCoordTopLeft, texCoordBottomRight, color);
+
+        batch.setResourceTexture(1, nullptr);
     });
+
+    _frameCount++;
 }
@@ -12,10 +12,15 @@
 #ifndef hifi_AmbientOcclusionEffect_h
 #define hifi_AmbientOcclusionEffect_h
 
+#include <QSize>
+
 #include <DependencyManager.h>
 
 #include "render/DrawTask.h"
 
+// The occlusion is computed and blurred at the resolution level of the render context, full, half or quarter, and
+// upsampled to the framebuffer with a weight on the depth. It can be accumulated over the frames too, reprojecting
+// the occlusion of the last frame to where the pixels are now.
 class AmbientOcclusion {
 public:
 
@@ -27,10 +32,16 @@ public:
     const gpu::PipelinePointer& getOcclusionPipeline();
     const gpu::PipelinePointer& getHBlurPipeline();
     const gpu::PipelinePointer& getVBlurPipeline();
+    const gpu::PipelinePointer& getTemporalPipeline();
     const gpu::PipelinePointer& getBlendPipeline();
 
+    static const int MAX_RESOLUTION_LEVEL = 2;
+
 private:
 
+    // Size the buffers for the framebuffer at the resolution level, the history starts over when they change
+    void updateBuffers(const QSize& frameBufferSize, int resolutionLevel);
+
     // Uniforms for AO
     gpu::int32 _gScaleLoc;
     gpu::int32 _gBiasLoc;
@@ -43,7 +54,21 @@ private:
     gpu::int32 _depthTexCoordScaleLoc;
     gpu::int32 _renderTargetResLoc;
     gpu::int32 _renderTargetResInvLoc;
-
+    gpu::int32 _frameJitterLoc;
+
+    // Uniforms for the temporal accumulation
+    gpu::int32 _temporalNearLoc;
+    gpu::int32 _temporalDepthScaleLoc;
+    gpu::int32 _temporalDepthTexCoordOffsetLoc;
+    gpu::int32 _temporalDepthTexCoordScaleLoc;
+    gpu::int32 _reprojectionLoc;
+    gpu::int32 _feedbackLoc;
+    gpu::int32 _temporalOcclusionResInvLoc;
+
+    // Uniforms for the upsampling blend
+    gpu::int32 _blendNearLoc;
+    gpu::int32 _blendDepthScaleLoc;
+    gpu::int32 _blendOcclusionResLoc;
 
     float g_scale;
     float g_bias;
@@ -53,15 +78,26 @@ private:
     gpu::PipelinePointer _occlusionPipeline;
     gpu::PipelinePointer _hBlurPipeline;
     gpu::PipelinePointer _vBlurPipeline;
+    gpu::PipelinePointer _temporalPipeline;
     gpu::PipelinePointer _blendPipeline;
 
+    QSize _frameBufferSize;
+    int _resolutionLevel = -1;
+
     gpu::FramebufferPointer _occlusionBuffer;
     gpu::FramebufferPointer _hBlurBuffer;
     gpu::FramebufferPointer _vBlurBuffer;
+    gpu::FramebufferPointer _historyBuffers[2];
 
     gpu::TexturePointer _occlusionTexture;
     gpu::TexturePointer _hBlurTexture;
     gpu::TexturePointer _vBlurTexture;
+    gpu::TexturePointer _historyTextures[2]; // written in turn, the one of the last frame is read
+
+    int _historyIndex = 0;
+    bool _hasHistory = false;
+    glm::mat4 _lastViewProjection;
+    quint64 _frameCount = 0;
 
 };
 
@@ -11,6 +11,8 @@
 
 #include "DeferredLightingEffect.h"
 
+#include <algorithm>
+
 #include <GLMHelpers.h>
 #include <PathUtils.h>
 #include <ViewFrustum.h>
@@ -47,6 +49,7 @@
 
 #include "point_light_frag.h"
 #include "spot_light_frag.h"
+#include "tiled_light_frag.h"
 
 static const std::string glowIntensityShaderHandle = "glowIntensity";
 
@@ -60,10 +63,19 @@ struct LightLocations {
     int texcoordMat;
     int coneParam;
     int deferredTransformBuffer;
+    int tiledLightBuffer;
+    int numTileLights;
+    int tileLights;
 };
 
 static void loadLightProgram(const char* vertSource, const char* fragSource, bool lightVolume, gpu::PipelinePointer& program, LightLocationsPtr& locations);
 
+// Must match the sizes declared in tiled_light.slf
+static const int MAX_TILED_LIGHTS = 128;
+static const int MAX_TILE_LIGHTS = 32;
+
+static const int TILE_SIZE = 32; // pixels
+
 
 gpu::PipelinePointer DeferredLightingEffect::getPipeline(SimpleProgramKey config) {
     auto it = _simplePrograms.find(config);
@@ -117,6 +129,7 @@ void DeferredLightingEffect::init(AbstractViewStateInterface* viewState) {
     _directionalSkyboxLightCascadedShadowMapLocations = std::make_shared<LightLocations>();
     _pointLightLocations = std::make_shared<LightLocations>();
     _spotLightLocations = std::make_shared<LightLocations>();
+    _tiledLightLocations = std::make_shared<LightLocations>();
 
     loadLightProgram(deferred_light_vert, directional_light_frag, false, _directionalLight, _directionalLightLocations);
     loadLightProgram(deferred_light_vert, directional_light_shadow_map_frag, false, _directionalLightShadowMap,
@@ -140,6 +153,17 @@ void DeferredLightingEffect::init(AbstractViewStateInterface* viewState) {
     loadLightProgram(deferred_light_limited_vert, point_light_frag, true, _pointLight, _pointLightLocations);
     loadLightProgram(deferred_light_spot_vert, spot_light_frag, true, _spotLight, _spotLightLocations);
 
+    {
+        loadLightProgram(deferred_light_vert, tiled_light_frag, false, _tiledLight, _tiledLightLocations);
+
+        // a full screen quad per tile, clipped to the tile by the scissor, adding up on the light buffer
+        auto tiledState = std::make_shared<gpu::State>();
+        tiledState->setCullMode(gpu::State::CULL_BACK);
+        tiledState->setScissorEnable(true);
+        tiledState->setBlendFunction(true, gpu::State::ONE, gpu::State::BLEND_OP_ADD, gpu::State::ONE);
+        _tiledLight.reset(gpu::Pipeline::create(_tiledLight->getProgram(), tiledState));
+    }
+
     {
         //auto VSFS = gpu::StandardShaderLib::getDrawViewportQuadTransformTexcoordVS();
         //auto PSBlit = gpu::StandardShaderLib::getDrawTexturePS();
@@ -476,6 +500,9 @@ void DeferredLightingEffect::render(RenderArgs* args) {
         auto eyePoint = viewFrustum->getPosition();
         float nearRadius = glm::distance(eyePoint, viewFrustum->getNearTopLeft());
 
+        // The lights are the same for both sides, pack them once
+        bool useTiledLights = _tiledLighting && updateTiledLightBuffers();
+
 
         for (int side = 0; side < numPasses; side++) {
             // Render in this side's viewport
@@ -559,6 +586,13 @@ void DeferredLightingEffect::render(RenderArgs* args) {
             texcoordMat[2] = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
             texcoordMat[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 
+            // Light the point and spot lights per tile
+            if (useTiledLights) {
+                renderTiledLights(batch, projMats[side], viewTransforms[side], viewFrustum->getNearClip(), viewports[side],
+                                  texCoordTopLeft, texCoordBottomRight);
+                continue;
+            }
+
             // enlarge the scales slightly to account for tesselation
             const float SCALE_EXPANSION = 0.05f;
 
@@ -680,6 +714,145 @@ void DeferredLightingEffect::render(RenderArgs* args) {
 }
 
 
+bool DeferredLightingEffect::updateTiledLightBuffers() {
+    _tiledLights.clear();
+    if (!_tiledLight || _tiledLightLocations->tiledLightBuffer < 0) {
+        return false;
+    }
+    _tiledLights.insert(_tiledLights.end(), _pointLights.begin(), _pointLights.end());
+    _tiledLights.insert(_tiledLights.end(), _spotLights.begin(), _spotLights.end());
+    if (_tiledLights.empty()) {
+        return false;
+    }
+
+    // The lights go by chunks of the size of the uniform block, each buffer holding a full block
+    const size_t CHUNK_SIZE = MAX_TILED_LIGHTS * sizeof(model::Light::Schema);
+    size_t numChunks = (_tiledLights.size() + MAX_TILED_LIGHTS - 1) / MAX_TILED_LIGHTS;
+    while (_tiledLightBuffers.size() < numChunks) {
+        auto buffer = std::make_shared<gpu::Buffer>();
+        buffer->resize(CHUNK_SIZE);
+        _tiledLightBuffers.push_back(buffer);
+    }
+    for (size_t i = 0; i < _tiledLights.size(); i++) {
+        const auto& schema = _allocatedLights[_tiledLights[i]]->getSchemaBuffer().get<model::Light::Schema>();
+        _tiledLightBuffers[i / MAX_TILED_LIGHTS]->setSubData((i % MAX_TILED_LIGHTS) * sizeof(model::Light::Schema),
+            sizeof(model::Light::Schema), (const gpu::Byte*) &schema);
+    }
+    return true;
+}
+
+// The rectangle of pixels of the viewport covered by the sphere in view space, false if the sphere is out of view
+static bool evalSphereRect(const glm::vec3& center, float radius, const glm::mat4& projection, float nearClip,
+                           const glm::ivec4& viewport, glm::ivec4& rect) {
+    if (center.z - radius > -nearClip) {
+        return false;
+    }
+    glm::vec2 minCorner(-1.0f);
+    glm::vec2 maxCorner(1.0f);
+
+    // a sphere crossing the near plane may cover any part of the screen
+    if (center.z + radius < -nearClip) {
+        minCorner = glm::vec2(1.0f);
+        maxCorner = glm::vec2(-1.0f);
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner = center + radius * glm::vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+            glm::vec4 clipCorner = projection * glm::vec4(corner, 1.0f);
+            glm::vec2 ndcCorner = glm::vec2(clipCorner) / clipCorner.w;
+            minCorner = glm::min(minCorner, ndcCorner);
+            maxCorner = glm::max(maxCorner, ndcCorner);
+        }
+        minCorner = glm::max(minCorner, glm::vec2(-1.0f));
+        maxCorner = glm::min(maxCorner, glm::vec2(1.0f));
+        if (minCorner.x >= maxCorner.x || minCorner.y >= maxCorner.y) {
+            return false;
+        }
+    }
+
+    glm::vec2 size(viewport.z, viewport.w);
+    glm::vec2 minPixel = glm::floor((minCorner * 0.5f + 0.5f) * size);
+    glm::vec2 maxPixel = glm::ceil((maxCorner * 0.5f + 0.5f) * size);
+    rect = glm::ivec4(minPixel.x, minPixel.y, maxPixel.x, maxPixel.y);
+    rect = glm::clamp(rect, glm::ivec4(0), glm::ivec4(viewport.z, viewport.w, viewport.z, viewport.w));
+    return rect.x < rect.z && rect.y < rect.w;
+}
+
+void DeferredLightingEffect::renderTiledLights(gpu::Batch& batch, const glm::mat4& projection, const Transform& viewTransform,
+                                               float nearClip, const glm::ivec4& viewport,
+                                               const glm::vec2& texCoordTopLeft, const glm::vec2& texCoordBottomRight) {
+    // enlarge the radius slightly like the light volumes do
+    const float SCALE_EXPANSION = 0.05f;
+
+    glm::mat4 viewMat;
+    viewTransform.getInverseMatrix(viewMat);
+
+    int numTilesX = (viewport.z + TILE_SIZE - 1) / TILE_SIZE;
+    int numTilesY = (viewport.w + TILE_SIZE - 1) / TILE_SIZE;
+    _tileLights.resize(numTilesX * numTilesY);
+
+    batch.setPipeline(_tiledLight);
+    batch.setModelTransform(Transform());
+    batch.setProjectionTransform(glm::mat4());
+    batch.setViewTransform(Transform());
+
+    auto geometryCache = DependencyManager::get<GeometryCache>();
+    glm::vec2 topLeft(-1.0f, -1.0f);
+    glm::vec2 bottomRight(1.0f, 1.0f);
+    glm::vec4 color(1.0f, 1.0f, 1.0f, 1.0f);
+
+    for (size_t chunk = 0; chunk * MAX_TILED_LIGHTS < _tiledLights.size(); chunk++) {
+        for (auto& tileLights : _tileLights) {
+            tileLights.clear();
+        }
+
+        // Bin the lights of the chunk in the tiles their sphere covers
+        size_t chunkBegin = chunk * MAX_TILED_LIGHTS;
+        size_t chunkEnd = std::min(chunkBegin + MAX_TILED_LIGHTS, _tiledLights.size());
+        for (size_t i = chunkBegin; i < chunkEnd; i++) {
+            const auto& light = _allocatedLights[_tiledLights[i]];
+            glm::vec3 center = glm::vec3(viewMat * glm::vec4(light->getPosition(), 1.0f));
+            float radius = light->getMaximumRadius() * (1.0f + SCALE_EXPANSION);
+
+            glm::ivec4 rect;
+            if (!evalSphereRect(center, radius, projection, nearClip, viewport, rect)) {
+                continue;
+            }
+            for (int y = rect.y / TILE_SIZE; y <= (rect.w - 1) / TILE_SIZE; y++) {
+                for (int x = rect.x / TILE_SIZE; x <= (rect.z - 1) / TILE_SIZE; x++) {
+                    _tileLights[y * numTilesX + x].push_back((int)(i - chunkBegin));
+                }
+            }
+        }
+
+        batch.setUniformBuffer(_tiledLightLocations->tiledLightBuffer, _tiledLightBuffers[chunk], 0,
+                               MAX_TILED_LIGHTS * sizeof(model::Light::Schema));
+
+        for (int y = 0; y < numTilesY; y++) {
+            for (int x = 0; x < numTilesX; x++) {
+                const auto& tileLights = _tileLights[y * numTilesX + x];
+                if (tileLights.empty()) {
+                    continue;
+                }
+                batch.setStateScissorRect(glm::ivec4(viewport.x + x * TILE_SIZE, viewport.y + y * TILE_SIZE,
+                    std::min(TILE_SIZE, viewport.z - x * TILE_SIZE), std::min(TILE_SIZE, viewport.w - y * TILE_SIZE)));
+
+                // A tile lit by more lights than the shader takes gets drawn again for the rest
+                for (size_t first = 0; first < tileLights.size(); first += MAX_TILE_LIGHTS) {
+                    int numLights = (int)std::min(tileLights.size() - first, (size_t)MAX_TILE_LIGHTS);
+                    int indices[MAX_TILE_LIGHTS] = { 0 };
+                    std::copy(tileLights.begin() + first, tileLights.begin() + first + numLights, indices);
+
+                    batch._glUniform1i(_tiledLightLocations->numTileLights, numLights);
+                    batch._glUniform4iv(_tiledLightLocations->tileLights, (numLights + 3) / 4, indices);
+                    geometryCache->renderQuad(batch, topLeft, bottomRight, texCoordTopLeft, texCoordBottomRight, color);
+                }
+            }
+        }
+    }
+
+    batch.setStateScissorRect(viewport);
+    batch.setUniformBuffer(_tiledLightLocations->tiledLightBuffer, nullptr);
+}
+
 void DeferredLightingEffect::copyBack(RenderArgs* args) {
     auto framebufferCache = DependencyManager::get<FramebufferCache>();
     gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
@@ -739,6 +912,8 @@ static void loadLightProgram(const char* vertSource, const char* fragSource, boo
     slotBindings.insert(gpu::Shader::Binding(std::string("atmosphereBufferUnit"), ATMOSPHERE_GPU_SLOT));
 
     slotBindings.insert(gpu::Shader::Binding(std::string("deferredTransformBuffer"), DeferredLightingEffect::DEFERRED_TRANSFORM_BUFFER_SLOT));
+    const int TILED_LIGHT_GPU_SLOT = 5;
+    slotBindings.insert(gpu::Shader::Binding(std::string("tiledLightBuffer"), TILED_LIGHT_GPU_SLOT));
 
     gpu::Shader::makeProgram(*program, slotBindings);
 
@@ -755,6 +930,10 @@ static void loadLightProgram(const char* vertSource, const char* fragSource, boo
     locations->atmosphereBufferUnit = program->getBuffers().findLocation("atmosphereBufferUnit");
     locations->deferredTransformBuffer = program->getBuffers().findLocation("deferredTransformBuffer");
 
+    locations->tiledLightBuffer = program->getBuffers().findLocation("tiledLightBuffer");
+    locations->numTileLights = program->getUniforms().findLocation("numTileLights");
+    locations->tileLights = program->getUniforms().findLocation("tileLights");
+
     auto state = std::make_shared<gpu::State>();
     if (lightVolume) {
         state->setCullMode(gpu::State::CULL_BACK);
@@ -89,6 +89,10 @@ public:
 
     void setGlobalSkybox(const model::SkyboxPointer& skybox);
 
+    /// Lights the point and spot lights per screen tile in one pass, instead of drawing one volume per light.
+    void setTiledLighting(bool tiledLighting) { _tiledLighting = tiledLighting; }
+    bool isTiledLighting() const { return _tiledLighting; }
+
 private:
     DeferredLightingEffect() {}
     virtual ~DeferredLightingEffect() { }
@@ -97,6 +101,11 @@ private:
     model::MeshPointer getSpotLightMesh();
 
     gpu::PipelinePointer getPipeline(SimpleProgramKey config);
+
+    // Pack the point and spot lights of the frame in the tiled light buffers, return true if the tiled pass can light them
+    bool updateTiledLightBuffers();
+    void renderTiledLights(gpu::Batch& batch, const glm::mat4& projection, const Transform& viewTransform, float nearClip,
+                           const glm::ivec4& viewport, const glm::vec2& texCoordTopLeft, const glm::vec2& texCoordBottomRight);
     
     gpu::ShaderPointer _simpleShader;
     gpu::ShaderPointer _emissiveShader;
@@ -129,6 +138,13 @@ private:
     LightLocationsPtr _pointLightLocations;
     gpu::PipelinePointer _spotLight;
     LightLocationsPtr _spotLightLocations;
+    gpu::PipelinePointer _tiledLight;
+    LightLocationsPtr _tiledLightLocations;
+
+    bool _tiledLighting = true;
+    std::vector<int> _tiledLights;
+    std::vector<gpu::BufferPointer> _tiledLightBuffers;
+    std::vector<std::vector<int>> _tileLights;
 
     class PointLight {
     public:
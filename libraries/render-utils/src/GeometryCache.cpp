@@ -12,6 +12,7 @@
 #include "GeometryCache.h"
 
 #include <cmath>
+#include <cstddef>
 
 #include <QNetworkReply>
 #include <QThreadPool>
@@ -948,12 +949,69 @@ void GeometryCache::renderVertices(gpu::Batch& batch, gpu::Primitive primitiveTy
 }
 
 
+// a frame drawing more starts new buffers
+static const int MAX_IMMEDIATE_VERTICES = 64 * 1024;
+
+void GeometryCache::beginFrame() {
+    // the batches of the earlier frames keep their buffers as long as they need them
+    _immediateVertices.reset();
+}
+
+void GeometryCache::renderImmediateVertices(gpu::Batch& batch, const ImmediateVertex* vertices, int numVertices,
+                                            const glm::vec4& color) {
+    if (!_immediateStreamFormat) {
+        _immediateStreamFormat = std::make_shared<gpu::Stream::Format>();
+        _immediateStreamFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ),
+                                             offsetof(ImmediateVertex, position));
+        _immediateStreamFormat->setAttribute(gpu::Stream::TEXCOORD, 0, gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV),
+                                             offsetof(ImmediateVertex, texCoord));
+        _immediateStreamFormat->setAttribute(gpu::Stream::COLOR, 1, gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA));
+    }
+    if (!_immediateVertices || _numImmediateVertices + numVertices > MAX_IMMEDIATE_VERTICES) {
+        _immediateVertices = std::make_shared<gpu::Buffer>();
+        _immediateColors = std::make_shared<gpu::Buffer>();
+        _immediateStream = std::make_shared<gpu::BufferStream>();
+        _immediateStream->addBuffer(_immediateVertices, 0, _immediateStreamFormat->getChannels().at(0)._stride);
+        _immediateStream->addBuffer(_immediateColors, 0, _immediateStreamFormat->getChannels().at(1)._stride);
+        _numImmediateVertices = 0;
+    }
+
+    int compactColor = ((int(color.x * 255.0f) & 0xFF)) |
+                        ((int(color.y * 255.0f) & 0xFF) << 8) |
+                        ((int(color.z * 255.0f) & 0xFF) << 16) |
+                        ((int(color.w * 255.0f) & 0xFF) << 24);
+    _immediateVertices->append(numVertices * sizeof(ImmediateVertex), (const gpu::Byte*)vertices);
+    for (int i = 0; i < numVertices; i++) {
+        _immediateColors->append(compactColor);
+    }
+
+    batch.setInputFormat(_immediateStreamFormat);
+    batch.setInputStream(0, *_immediateStream);
+    batch.draw(gpu::TRIANGLE_STRIP, numVertices, _numImmediateVertices);
+    _numImmediateVertices += numVertices;
+}
+
 void GeometryCache::renderBevelCornersRect(gpu::Batch& batch, int x, int y, int width, int height, int bevelDistance, const glm::vec4& color, int id) {
-    bool registered = (id != UNKNOWN_ID);
+    if (id == UNKNOWN_ID) {
+        // the same triangle strip as below
+        ImmediateVertex vertices[] = {
+            { glm::vec3(x, y + height - bevelDistance, 0.0f) },
+            { glm::vec3(x, y + bevelDistance, 0.0f) },
+            { glm::vec3(x + bevelDistance, y + height, 0.0f) },
+            { glm::vec3(x + bevelDistance, y, 0.0f) },
+            { glm::vec3(x + width - bevelDistance, y + height, 0.0f) },
+            { glm::vec3(x + width - bevelDistance, y, 0.0f) },
+            { glm::vec3(x + width, y + height - bevelDistance, 0.0f) },
+            { glm::vec3(x + width, y + bevelDistance, 0.0f) }
+        };
+        renderImmediateVertices(batch, vertices, 8, color);
+        return;
+    }
+
     Vec3Pair key(glm::vec3(x, y, 0.0f), glm::vec3(width, height, bevelDistance));
-    BatchItemDetails& details = registered ? _registeredBevelRects[id] : _bevelRects[key];
-    // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
-    if (registered && details.isCreated) {
+    BatchItemDetails& details = _registeredBevelRects[id];
+    // if we have buffers, then check to see if the geometry changed and rebuild if needed
+    if (details.isCreated) {
         Vec3Pair& lastKey = _lastRegisteredBevelRects[id];
         if (lastKey != key) {
             details.clear();
@@ -1050,12 +1108,22 @@ void GeometryCache::renderBevelCornersRect(gpu::Batch& batch, int x, int y, int
 }
 
 void GeometryCache::renderQuad(gpu::Batch& batch, const glm::vec2& minCorner, const glm::vec2& maxCorner, const glm::vec4& color, int id) {
-    bool registered = (id != UNKNOWN_ID);
+    if (id == UNKNOWN_ID) {
+        ImmediateVertex vertices[] = {
+            { glm::vec3(minCorner.x, minCorner.y, 0.0f) },
+            { glm::vec3(maxCorner.x, minCorner.y, 0.0f) },
+            { glm::vec3(minCorner.x, maxCorner.y, 0.0f) },
+            { glm::vec3(maxCorner.x, maxCorner.y, 0.0f) }
+        };
+        renderImmediateVertices(batch, vertices, 4, color);
+        return;
+    }
+
     Vec4Pair key(glm::vec4(minCorner.x, minCorner.y, maxCorner.x, maxCorner.y), color);
-    BatchItemDetails& details = registered ? _registeredQuad2D[id] : _quad2D[key];
+    BatchItemDetails& details = _registeredQuad2D[id];
 
-    // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
-    if (registered && details.isCreated) {
+    // if we have buffers, then check to see if the geometry changed and rebuild if needed
+    if (details.isCreated) {
         Vec4Pair & lastKey = _lastRegisteredQuad2D[id];
         if (lastKey != key) {
             details.clear();
@@ -1133,14 +1201,24 @@ void GeometryCache::renderQuad(gpu::Batch& batch, const glm::vec2& minCorner, co
                     const glm::vec2& texCoordMinCorner, const glm::vec2& texCoordMaxCorner, 
                     const glm::vec4& color, int id) {
 
-    bool registered = (id != UNKNOWN_ID);
+    if (id == UNKNOWN_ID) {
+        ImmediateVertex vertices[] = {
+            { glm::vec3(minCorner.x, minCorner.y, 0.0f), glm::vec2(texCoordMinCorner.x, texCoordMinCorner.y) },
+            { glm::vec3(maxCorner.x, minCorner.y, 0.0f), glm::vec2(texCoordMaxCorner.x, texCoordMinCorner.y) },
+            { glm::vec3(minCorner.x, maxCorner.y, 0.0f), glm::vec2(texCoordMinCorner.x, texCoordMaxCorner.y) },
+            { glm::vec3(maxCorner.x, maxCorner.y, 0.0f), glm::vec2(texCoordMaxCorner.x, texCoordMaxCorner.y) }
+        };
+        renderImmediateVertices(batch, vertices, 4, color);
+        return;
+    }
+
     Vec4PairVec4 key(Vec4Pair(glm::vec4(minCorner.x, minCorner.y, maxCorner.x, maxCorner.y),
                               glm::vec4(texCoordMinCorner.x, texCoordMinCorner.y, texCoordMaxCorner.x, texCoordMaxCorner.y)), 
                               color);
-    BatchItemDetails& details = registered ? _registeredQuad2DTextures[id] : _quad2DTextures[key];
+    BatchItemDetails& details = _registeredQuad2DTextures[id];
 
-    // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
-    if (registered && details.isCreated) {
+    // if we have buffers, then check to see if the geometry changed and rebuild if needed
+    if (details.isCreated) {
         Vec4PairVec4& lastKey = _lastRegisteredQuad2DTexture[id];
         if (lastKey != key) {
             details.clear();
@@ -1212,12 +1290,22 @@ void GeometryCache::renderQuad(gpu::Batch& batch, const glm::vec2& minCorner, co
 }
 
 void GeometryCache::renderQuad(gpu::Batch& batch, const glm::vec3& minCorner, const glm::vec3& maxCorner, const glm::vec4& color, int id) {
-    bool registered = (id != UNKNOWN_ID);
+    if (id == UNKNOWN_ID) {
+        ImmediateVertex vertices[] = {
+            { glm::vec3(minCorner.x, minCorner.y, minCorner.z) },
+            { glm::vec3(maxCorner.x, minCorner.y, minCorner.z) },
+            { glm::vec3(minCorner.x, maxCorner.y, maxCorner.z) },
+            { glm::vec3(maxCorner.x, maxCorner.y, maxCorner.z) }
+        };
+        renderImmediateVertices(batch, vertices, 4, color);
+        return;
+    }
+
     Vec3PairVec4 key(Vec3Pair(minCorner, maxCorner), color);
-    BatchItemDetails& details = registered ? _registeredQuad3D[id] : _quad3D[key];
+    BatchItemDetails& details = _registeredQuad3D[id];
 
-    // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
-    if (registered && details.isCreated) {
+    // if we have buffers, then check to see if the geometry changed and rebuild if needed
+    if (details.isCreated) {
         Vec3PairVec4& lastKey = _lastRegisteredQuad3D[id];
         if (lastKey != key) {
             details.clear();
@@ -1301,15 +1389,25 @@ void GeometryCache::renderQuad(gpu::Batch& batch, const glm::vec3& topLeft, cons
         qCDebug(renderutils) << "    color:" << color;
     #endif //def WANT_DEBUG
     
-    bool registered = (id != UNKNOWN_ID);
+    if (id == UNKNOWN_ID) {
+        ImmediateVertex vertices[] = {
+            { bottomLeft, texCoordBottomLeft },
+            { bottomRight, texCoordBottomRight },
+            { topLeft, texCoordTopLeft },
+            { topRight, texCoordTopRight }
+        };
+        renderImmediateVertices(batch, vertices, 4, color);
+        return;
+    }
+
     Vec3PairVec4Pair key(Vec3Pair(topLeft, bottomRight),
                             Vec4Pair(glm::vec4(texCoordTopLeft.x,texCoordTopLeft.y,texCoordBottomRight.x,texCoordBottomRight.y),
                                     color));
                                     
-    BatchItemDetails& details = registered ? _registeredQuad3DTextures[id] : _quad3DTextures[key];
+    BatchItemDetails& details = _registeredQuad3DTextures[id];
 
-    // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
-    if (registered && details.isCreated) {
+    // if we have buffers, then check to see if the geometry changed and rebuild if needed
+    if (details.isCreated) {
         Vec3PairVec4Pair& lastKey = _lastRegisteredQuad3DTexture[id];
         if (lastKey != key) {
             details.clear();
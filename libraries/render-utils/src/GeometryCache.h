@@ -147,6 +147,9 @@ public:
     int allocateID() { return _nextID++; }
     static const int UNKNOWN_ID;
 
+    /// the shapes drawn without an ID since the last frame were drawn, their vertices can go
+    void beginFrame();
+
     void renderShapeInstances(gpu::Batch& batch, Shape shape, size_t count, gpu::BufferPointer& transformBuffer, gpu::BufferPointer& colorBuffer);
     void renderWireShapeInstances(gpu::Batch& batch, Shape shape, size_t count, gpu::BufferPointer& transformBuffer, gpu::BufferPointer& colorBuffer);
     void renderShape(gpu::Batch& batch, Shape shape);
@@ -287,28 +290,39 @@ private:
         void clear();
     };
 
+    // the quads and bevel rects drawn without an ID go in the buffers of the frame, one upload for all of them
+    struct ImmediateVertex {
+        ImmediateVertex(const glm::vec3& position, const glm::vec2& texCoord = glm::vec2(0.0f)) :
+            position(position), texCoord(texCoord) {}
+        glm::vec3 position;
+        glm::vec2 texCoord;
+    };
+    void renderImmediateVertices(gpu::Batch& batch, const ImmediateVertex* vertices, int numVertices,
+                                 const glm::vec4& color);
+
+    gpu::Stream::FormatPointer _immediateStreamFormat;
+    gpu::BufferPointer _immediateVertices;
+    gpu::BufferPointer _immediateColors;
+    gpu::BufferStreamPointer _immediateStream;
+    int _numImmediateVertices { 0 };
+
     QHash<IntPair, VerticesIndices> _coneVBOs;
 
     int _nextID{ 0 };
 
     QHash<int, Vec3PairVec4Pair> _lastRegisteredQuad3DTexture;
-    QHash<Vec3PairVec4Pair, BatchItemDetails> _quad3DTextures;
     QHash<int, BatchItemDetails> _registeredQuad3DTextures;
 
     QHash<int, Vec4PairVec4> _lastRegisteredQuad2DTexture;
-    QHash<Vec4PairVec4, BatchItemDetails> _quad2DTextures;
     QHash<int, BatchItemDetails> _registeredQuad2DTextures;
 
     QHash<int, Vec3PairVec4> _lastRegisteredQuad3D;
-    QHash<Vec3PairVec4, BatchItemDetails> _quad3D;
     QHash<int, BatchItemDetails> _registeredQuad3D;
 
     QHash<int, Vec4Pair> _lastRegisteredQuad2D;
-    QHash<Vec4Pair, BatchItemDetails> _quad2D;
     QHash<int, BatchItemDetails> _registeredQuad2D;
 
     QHash<int, Vec3Pair> _lastRegisteredBevelRects;
-    QHash<Vec3Pair, BatchItemDetails> _bevelRects;
     QHash<int, BatchItemDetails> _registeredBevelRects;
 
     QHash<int, Vec3Pair> _lastRegisteredLine3D;
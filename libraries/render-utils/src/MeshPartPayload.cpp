@@ -12,6 +12,7 @@
 #include "MeshPartPayload.h"
 
 #include <PerfStat.h>
+#include <ViewFrustum.h>
 
 #include "DeferredLightingEffect.h"
 
@@ -35,10 +36,20 @@ namespace render {
     template <> void payloadRender(const MeshPartPayload::Pointer& payload, RenderArgs* args) {
         return payload->render(args);
     }
+    // once ModelRender::prepareConcurrentRender is done, a part only records into the batch of the args
+    template <> bool payloadCanRenderConcurrently(const MeshPartPayload::Pointer& payload) {
+        return true;
+    }
 }
 
 using namespace render;
 
+static const size_t INSTANCE_TRANSFORM_BUFFER = 0;
+static const gpu::Element INSTANCE_TRANSFORM_ELEMENT{ gpu::MAT4, gpu::FLOAT, gpu::XYZW };
+
+// the levels of detail that move the surface by less than this on screen don't show
+static const float MAX_LOD_PIXEL_ERROR = 1.0f;
+
 MeshPartPayload::MeshPartPayload(Model* model, int meshIndex, int partIndex, int shapeIndex) :
     model(model), meshIndex(meshIndex), partIndex(partIndex), _shapeID(shapeIndex)
 {
@@ -59,11 +70,35 @@ void MeshPartPayload::initCache() {
 
     _drawPart = _drawMesh->getPartBuffer().get<model::Mesh::Part>(partIndex);
 
+    _lodParts.clear();
+    _lodErrors.clear();
+    int numParts = mesh.parts.size();
+    for (int lod = 0; lod < mesh.lodErrors.size(); lod++) {
+        int lodPartIndex = partIndex + (lod + 1) * numParts;
+        if (lodPartIndex >= (int)_drawMesh->getNumParts()) {
+            break;
+        }
+        _lodParts.push_back(_drawMesh->getPartBuffer().get<model::Mesh::Part>(lodPartIndex));
+        _lodErrors.push_back(mesh.lodErrors.at(lod));
+    }
+
     auto networkMaterial = model->_geometry->getShapeMaterial(_shapeID);
     if (networkMaterial) {
         _drawMaterial = networkMaterial->_material;
     };
 
+    // The models of the same url share their meshes and materials, unless they override the textures
+    _instanceNames.clear();
+    if (!_isSkinned && !_isBlendShaped) {
+        std::string instanceName = "MeshPartPayload/" + std::to_string((unsigned long long)_drawMesh.get()) + "/" +
+            std::to_string(partIndex) + "/" + std::to_string((unsigned long long)_drawMaterial.get());
+        for (size_t lod = 0; lod <= _lodParts.size(); lod++) {
+            _instanceNames.push_back(instanceName + "/" + std::to_string((unsigned long long)lod));
+        }
+        _instancedVertexFormat = std::make_shared<gpu::Stream::Format>(*_drawMesh->getVertexFormat());
+        _instancedVertexFormat->setAttribute(gpu::Stream::INSTANCE_XFM, gpu::Stream::INSTANCE_XFM,
+            INSTANCE_TRANSFORM_ELEMENT, 0, gpu::Stream::PER_INSTANCE);
+    }
 }
 
 render::ItemKey MeshPartPayload::getKey() const {
@@ -74,6 +109,10 @@ render::ItemKey MeshPartPayload::getKey() const {
         builder.withInvisible();
     }
 
+    if (model->isMoving()) {
+        builder.withDynamic();
+    }
+
     if (_isBlendShaped || _isSkinned) {
         builder.withDeformed();
     }
@@ -94,8 +133,36 @@ render::Item::Bound MeshPartPayload::getBound() const {
     return model->getPartBounds(meshIndex, partIndex);
 }
 
-void MeshPartPayload::drawCall(gpu::Batch& batch) const {
-    batch.drawIndexed(gpu::TRIANGLES, _drawPart._numIndices, _drawPart._startIndex);
+void MeshPartPayload::drawCall(gpu::Batch& batch, const model::Mesh::Part& part) const {
+    batch.drawIndexed(gpu::TRIANGLES, part._numIndices, part._startIndex);
+}
+
+int MeshPartPayload::selectLOD(const RenderArgs* args) const {
+    if (_lodParts.empty() || !args->_viewFrustum) {
+        return 0;
+    }
+    const Model::MeshState& state = model->_meshStates.at(meshIndex);
+    if (state.clusterMatrices.isEmpty()) {
+        return 0;
+    }
+
+    AABox bound = getBound();
+    float distance = glm::distance(args->_viewFrustum->getPosition(), bound.calcCenter()) -
+        0.5f * glm::length(bound.getDimensions());
+    if (distance <= 0.0f) {
+        return 0;
+    }
+
+    // the error of a level grows with the scale of the mesh, and shrinks with the distance over the height of a pixel
+    float scale = glm::length(glm::vec3(state.clusterMatrices[0][0]));
+    float pixelsPerRadian = (float)args->_viewport.w / glm::radians(args->_viewFrustum->getFieldOfView());
+    float pixelsPerError = scale * pixelsPerRadian / distance;
+
+    int lod = 0;
+    while (lod < (int)_lodErrors.size() && _lodErrors[lod] * pixelsPerError <= MAX_LOD_PIXEL_ERROR) {
+        lod++;
+    }
+    return lod;
 }
 
 void MeshPartPayload::bindMesh(gpu::Batch& batch) const {
@@ -226,6 +293,57 @@ void MeshPartPayload::bindTransform(gpu::Batch& batch, const ModelRender::Locati
     batch.setModelTransform(transform);
 }
 
+bool MeshPartPayload::canRenderInstance() const {
+    // only the parts with a single cluster have all of their transform in the model transform
+    return !_instanceNames.empty() && !model->_cauterizeBones && !model->_meshStates.at(meshIndex).clusterBuffer;
+}
+
+void MeshPartPayload::renderInstance(RenderArgs* args, bool hasLightmap, bool hasTangents, bool hasSpecular) const {
+    gpu::Batch& batch = *(args->_batch);
+    const Model::MeshState& state = model->_meshStates.at(meshIndex);
+
+    Transform transform(state.clusterMatrices[0]);
+    transform.preTranslate(model->_translation);
+
+    int lod = selectLOD(args);
+    const model::Mesh::Part& part = getLODPart(lod);
+    const std::string& instanceName = _instanceNames[lod];
+
+    gpu::BufferPointer instanceTransformBuffer = batch.getNamedBuffer(instanceName, INSTANCE_TRANSFORM_BUFFER);
+    if (instanceTransformBuffer->getSize() == 0) {
+        args->_details._materialSwitches++;
+    }
+    glm::mat4 instanceTransform;
+    instanceTransformBuffer->append(transform.getMatrix(instanceTransform));
+
+    const int INDICES_PER_TRIANGLE = 3;
+    args->_details._trianglesRendered += part._numIndices / INDICES_PER_TRIANGLE;
+
+    // Every instance sets up the same call, which draws all of them once the batch gets executed
+    auto mode = args->_renderMode;
+    auto alphaThreshold = args->_alphaThreshold;
+    model::Mesh::Part drawPart = part;
+    batch.setupNamedCalls(instanceName, [=](gpu::Batch& batch, gpu::Batch::NamedBatchData& data) {
+        ModelRender::Locations* locations = nullptr;
+        ModelRender::pickPrograms(batch, mode, false, alphaThreshold, hasLightmap, hasTangents, hasSpecular, false, false,
+                                  nullptr, locations);
+        if (!locations) {
+            return;
+        }
+
+        bindMesh(batch);
+        batch.setInputFormat(_instancedVertexFormat);
+        auto& transformBuffer = data._buffers[INSTANCE_TRANSFORM_BUFFER];
+        batch.setInputBuffer(gpu::Stream::INSTANCE_XFM,
+            gpu::BufferView(transformBuffer, 0, transformBuffer->getSize(), INSTANCE_TRANSFORM_ELEMENT));
+
+        bindMaterial(batch, locations);
+
+        batch._glUniform1i(locations->instanced, 1);
+        batch.drawIndexedInstanced(data._count, gpu::TRIANGLES, drawPart._numIndices, drawPart._startIndex);
+        batch._glUniform1i(locations->instanced, 0);
+    });
+}
 
 void MeshPartPayload::render(RenderArgs* args) const {
     PerformanceTimer perfTimer("MeshPartPayload::render");
@@ -304,13 +422,18 @@ void MeshPartPayload::render(RenderArgs* args) const {
         transform.setTranslation(partBounds.calcCenter());
         transform.setScale(partBounds.getDimensions());
         batch.setModelTransform(transform);
-        DependencyManager::get<DeferredLightingEffect>()->renderWireCube(batch, 1.0f, cubeColor);
+        DependencyManager::getRaw<DeferredLightingEffect>()->renderWireCube(batch, 1.0f, cubeColor);
     }
 #endif //def DEBUG_BOUNDING_PARTS
     
     if (wireframe) {
         translucentMesh = hasTangents = hasSpecular = hasLightmap = isSkinned = false;
     }
+
+    if (args->_enableInstancing && !translucentMesh && !wireframe && canRenderInstance()) {
+        renderInstance(args, hasLightmap, hasTangents, hasSpecular);
+        return;
+    }
     
     ModelRender::Locations* locations = nullptr;
     ModelRender::pickPrograms(batch, mode, translucentMesh, alphaThreshold, hasLightmap, hasTangents, hasSpecular, isSkinned, wireframe,
@@ -331,21 +454,22 @@ void MeshPartPayload::render(RenderArgs* args) const {
     if (translucentMesh && locations->lightBufferUnit >= 0) {
         PerformanceTimer perfTimer("DLE->setupTransparent()");
             
-        DependencyManager::get<DeferredLightingEffect>()->setupTransparent(args, locations->lightBufferUnit);
+        DependencyManager::getRaw<DeferredLightingEffect>()->setupTransparent(args, locations->lightBufferUnit);
     }
     if (args) {
         args->_details._materialSwitches++;
     }
     
     // Draw!
+    const model::Mesh::Part& part = getLODPart(selectLOD(args));
     {
         PerformanceTimer perfTimer("batch.drawIndexed()");
-        drawCall(batch);
+        drawCall(batch, part);
     }
     
     if (args) {
         const int INDICES_PER_TRIANGLE = 3;
-        args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
+        args->_details._trianglesRendered += part._numIndices / INDICES_PER_TRIANGLE;
     }
 }
 
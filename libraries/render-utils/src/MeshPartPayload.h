@@ -40,11 +40,19 @@ public:
     void render(RenderArgs* args) const;
     
     // MeshPartPayload functions to perform render
-    void drawCall(gpu::Batch& batch) const;
+    void drawCall(gpu::Batch& batch, const model::Mesh::Part& part) const;
     void bindMesh(gpu::Batch& batch) const;
     void bindMaterial(gpu::Batch& batch, const ModelRender::Locations* locations) const;
     void bindTransform(gpu::Batch& batch, const ModelRender::Locations* locations) const;
 
+    // Add the part as one more instance to the instanced draw call of its mesh part and material in the batch
+    bool canRenderInstance() const;
+    void renderInstance(RenderArgs* args, bool hasLightmap, bool hasTangents, bool hasSpecular) const;
+
+
+    // The level of detail whose error projects to less than a pixel, 0 being the full part
+    int selectLOD(const RenderArgs* args) const;
+    const model::Mesh::Part& getLODPart(int lod) const { return lod > 0 ? _lodParts[lod - 1] : _drawPart; }
 
     void initCache();
 
@@ -55,12 +63,21 @@ public:
     bool _hasColorAttrib = false;
     bool _isSkinned = false;
     bool _isBlendShaped = false;
+
+    // The simplified levels of the part and the largest distance each moves the surface by, in mesh space
+    std::vector<model::Mesh::Part> _lodParts;
+    std::vector<float> _lodErrors;
+
+    // The names of the instanced draw calls of each level, shared by the parts of the same mesh part and material
+    std::vector<std::string> _instanceNames;
+    gpu::Stream::FormatPointer _instancedVertexFormat;
 };
 
 namespace render {
     template <> const ItemKey payloadGetKey(const MeshPartPayload::Pointer& payload);
     template <> const Item::Bound payloadGetBound(const MeshPartPayload::Pointer& payload);
     template <> void payloadRender(const MeshPartPayload::Pointer& payload, RenderArgs* args);
+    template <> bool payloadCanRenderConcurrently(const MeshPartPayload::Pointer& payload);
 }
 
 #endif // hifi_MeshPartPayload_h
\ No newline at end of file
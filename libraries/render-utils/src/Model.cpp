@@ -19,6 +19,7 @@
 #include <GeometryUtil.h>
 #include <PathUtils.h>
 #include <PerfStat.h>
+#include <RayIntersectionKernels.h>
 #include <ViewFrustum.h>
 
 #include "AbstractViewStateInterface.h"
@@ -52,9 +53,7 @@ Model::Model(RigPointer rig, QObject* parent) :
     _isVisible(true),
     _blendNumber(0),
     _appliedBlendNumber(0),
-    _calculatedMeshPartBoxesValid(false),
     _calculatedMeshBoxesValid(false),
-    _calculatedMeshTrianglesValid(false),
     _meshGroupsKnown(false),
     _isWireframe(false),
     _renderCollisionHull(false),
@@ -144,6 +143,7 @@ bool Model::updateGeometry() {
     }
 
     _needsReload = false;
+    _geometryLevel = _geometry->getNumLoadedLevels();
 
     QSharedPointer<NetworkGeometry> geometry = _geometry;
     if (_rig->jointStatesEmpty()) {
@@ -162,15 +162,31 @@ bool Model::updateGeometry() {
             state.cauterizedClusterMatrices.resize(mesh.clusters.size());
 
             _meshStates.append(state);
+            _jointPalette.clear();
 
             auto buffer = std::make_shared<gpu::Buffer>();
+            BlendedVertices blendedVertices;
             if (!mesh.blendshapes.isEmpty()) {
                 buffer->resize((mesh.vertices.size() + mesh.normals.size()) * sizeof(glm::vec3));
                 buffer->setSubData(0, mesh.vertices.size() * sizeof(glm::vec3), (gpu::Byte*) mesh.vertices.constData());
                 buffer->setSubData(mesh.vertices.size() * sizeof(glm::vec3),
                                    mesh.normals.size() * sizeof(glm::vec3), (gpu::Byte*) mesh.normals.constData());
+
+                blendedVertices.slots.fill(-1, mesh.vertices.size());
+                foreach (const FBXBlendshape& blendshape, mesh.blendshapes) {
+                    foreach (int index, blendshape.indices) {
+                        blendedVertices.slots[index] = 0;
+                    }
+                }
+                for (int i = 0; i < blendedVertices.slots.size(); i++) {
+                    if (blendedVertices.slots[i] == 0) {
+                        blendedVertices.slots[i] = blendedVertices.indices.size();
+                        blendedVertices.indices.append(i);
+                    }
+                }
             }
             _blendedVertexBuffers.push_back(buffer);
+            _blendedVertices.append(blendedVertices);
         }
         needFullUpdate = true;
     }
@@ -238,38 +254,43 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
         int subMeshIndex = 0;
 
         const FBXGeometry& geometry = _geometry->getFBXGeometry();
+        GeometryPickDataPointer pickData;
+        glm::vec3 geometryFrameOrigin;
+        glm::vec3 geometryFrameDirection;
+        if (pickAgainstTriangles) {
+            // the triangles are shared, so the ray goes into their frame rather than them into the world
+            pickData = _geometry->getPickData();
+            if (!pickData) {
+                return false;
+            }
+            geometryFrameOrigin = calculateGeometryFramePoint(origin);
+            geometryFrameDirection = calculateGeometryFrameDirection(direction);
+        }
 
         // If we hit the models box, then consider the submeshes...
         _mutex.lock();
 
         if (!_calculatedMeshBoxesValid) {
-            recalculateMeshBoxes(pickAgainstTriangles);
+            recalculateMeshBoxes();
         }
 
         foreach (const AABox& subMeshBox, _calculatedMeshBoxes) {
 
             if (subMeshBox.findRayIntersection(origin, direction, distanceToSubMesh, subMeshFace, subMeshSurfaceNormal)) {
                 if (distanceToSubMesh < bestDistance) {
-                    if (pickAgainstTriangles) {
-                        if (!_calculatedMeshTrianglesValid) {
-                            recalculateMeshBoxes(pickAgainstTriangles);
-                        }
-                        // check our triangles here....
-                        const QVector<Triangle>& meshTriangles = _calculatedMeshTriangles[subMeshIndex];
-                        int t = 0;
-                        foreach (const Triangle& triangle, meshTriangles) {
-                            t++;
-
-                            float thisTriangleDistance;
-                            if (findRayTriangleIntersection(origin, direction, triangle, thisTriangleDistance)) {
-                                if (thisTriangleDistance < bestDistance) {
-                                    bestDistance = thisTriangleDistance;
-                                    intersectedSomething = true;
-                                    face = subMeshFace;
-                                    surfaceNormal = triangle.getNormal();
-                                    extraInfo = geometry.getModelNameOfMesh(subMeshIndex);
-                                }
-                            }
+                    if (pickAgainstTriangles && subMeshIndex < pickData->meshTriangles.size()) {
+                        // check our triangles here, the distance along the ray is the same in either frame
+                        const QVector<Triangle>& meshTriangles = pickData->meshTriangles[subMeshIndex];
+
+                        float thisTriangleDistance;
+                        int closestTriangle = RayIntersectionKernels::findRayTrianglesIntersection(geometryFrameOrigin,
+                            geometryFrameDirection, meshTriangles.constData(), meshTriangles.size(), thisTriangleDistance);
+                        if (closestTriangle >= 0 && thisTriangleDistance < bestDistance) {
+                            bestDistance = thisTriangleDistance;
+                            intersectedSomething = true;
+                            face = subMeshFace;
+                            surfaceNormal = glm::normalize(_rotation * (meshTriangles[closestTriangle].getNormal() / _scale));
+                            extraInfo = geometry.getModelNameOfMesh(subMeshIndex);
                         }
                     } else {
                         // this is the non-triangle picking case...
@@ -319,20 +340,26 @@ bool Model::convexHullContains(glm::vec3 point) {
     // we can use the AABox's contains() by mapping our point into the model frame
     // and testing there.
     if (modelFrameBox.contains(modelFramePoint)){
+        GeometryPickDataPointer pickData = _geometry->getPickData();
+        if (!pickData) {
+            return false;
+        }
+        glm::vec3 geometryFramePoint = calculateGeometryFramePoint(point);
+
         _mutex.lock();
-        if (!_calculatedMeshTrianglesValid) {
-            recalculateMeshBoxes(true);
+        if (!_calculatedMeshBoxesValid) {
+            recalculateMeshBoxes();
         }
 
         // If we are inside the models box, then consider the submeshes...
         int subMeshIndex = 0;
         foreach(const AABox& subMeshBox, _calculatedMeshBoxes) {
-            if (subMeshBox.contains(point)) {
+            if (subMeshBox.contains(point) && subMeshIndex < pickData->meshTriangles.size()) {
                 bool insideMesh = true;
                 // To be inside the sub mesh, we need to be behind every triangles' planes
-                const QVector<Triangle>& meshTriangles = _calculatedMeshTriangles[subMeshIndex];
+                const QVector<Triangle>& meshTriangles = pickData->meshTriangles[subMeshIndex];
                 foreach (const Triangle& triangle, meshTriangles) {
-                    if (!isPointBehindTrianglesPlane(point, triangle.v0, triangle.v1, triangle.v2)) {
+                    if (!isPointBehindTrianglesPlane(geometryFramePoint, triangle.v0, triangle.v1, triangle.v2)) {
                         // it's not behind at least one so we bail
                         insideMesh = false;
                         break;
@@ -353,122 +380,19 @@ bool Model::convexHullContains(glm::vec3 point) {
     return false;
 }
 
-// TODO: we seem to call this too often when things haven't actually changed... look into optimizing this
-// Any script might trigger findRayIntersectionAgainstSubMeshes (and maybe convexHullContains), so these
-// can occur multiple times. In addition, rendering does it's own ray picking in order to decide which
-// entity-scripts to call.  I think it would be best to do the picking once-per-frame (in cpu, or gpu if possible)
-// and then the calls use the most recent such result.
-void Model::recalculateMeshBoxes(bool pickAgainstTriangles) {
+// The boxes are all that is recalculated for each model as it moves, the triangles are shared by all the models of the
+// geometry and picked against in its frame.
+void Model::recalculateMeshBoxes() {
     PROFILE_RANGE(__FUNCTION__);
-    bool calculatedMeshTrianglesNeeded = pickAgainstTriangles && !_calculatedMeshTrianglesValid;
-
-    if (!_calculatedMeshBoxesValid || calculatedMeshTrianglesNeeded || (!_calculatedMeshPartBoxesValid && pickAgainstTriangles) ) {
+    if (!_calculatedMeshBoxesValid) {
         const FBXGeometry& geometry = _geometry->getFBXGeometry();
         int numberOfMeshes = geometry.meshes.size();
         _calculatedMeshBoxes.resize(numberOfMeshes);
-        _calculatedMeshTriangles.clear();
-        _calculatedMeshTriangles.resize(numberOfMeshes);
-        _calculatedMeshPartBoxes.clear();
         for (int i = 0; i < numberOfMeshes; i++) {
             const FBXMesh& mesh = geometry.meshes.at(i);
-            Extents scaledMeshExtents = calculateScaledOffsetExtents(mesh.meshExtents);
-
-            _calculatedMeshBoxes[i] = AABox(scaledMeshExtents);
-
-            if (pickAgainstTriangles) {
-                QVector<Triangle> thisMeshTriangles;
-                for (int j = 0; j < mesh.parts.size(); j++) {
-                    const FBXMeshPart& part = mesh.parts.at(j);
-
-                    bool atLeastOnePointInBounds = false;
-                    AABox thisPartBounds;
-
-                    const int INDICES_PER_TRIANGLE = 3;
-                    const int INDICES_PER_QUAD = 4;
-
-                    if (part.quadIndices.size() > 0) {
-                        int numberOfQuads = part.quadIndices.size() / INDICES_PER_QUAD;
-                        int vIndex = 0;
-                        for (int q = 0; q < numberOfQuads; q++) {
-                            int i0 = part.quadIndices[vIndex++];
-                            int i1 = part.quadIndices[vIndex++];
-                            int i2 = part.quadIndices[vIndex++];
-                            int i3 = part.quadIndices[vIndex++];
-
-                            glm::vec3 mv0 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i0], 1.0f));
-                            glm::vec3 mv1 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i1], 1.0f));
-                            glm::vec3 mv2 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i2], 1.0f));
-                            glm::vec3 mv3 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i3], 1.0f));
-
-                            // track the mesh parts in model space
-                            if (!atLeastOnePointInBounds) {
-                                thisPartBounds.setBox(mv0, 0.0f);
-                                atLeastOnePointInBounds = true;
-                            } else {
-                                thisPartBounds += mv0;
-                            }
-                            thisPartBounds += mv1;
-                            thisPartBounds += mv2;
-                            thisPartBounds += mv3;
-
-                            glm::vec3 v0 = calculateScaledOffsetPoint(mv0);
-                            glm::vec3 v1 = calculateScaledOffsetPoint(mv1);
-                            glm::vec3 v2 = calculateScaledOffsetPoint(mv2);
-                            glm::vec3 v3 = calculateScaledOffsetPoint(mv3);
-
-                            // Sam's recommended triangle slices
-                            Triangle tri1 = { v0, v1, v3 };
-                            Triangle tri2 = { v1, v2, v3 };
-
-                            // NOTE: Random guy on the internet's recommended triangle slices
-                            //Triangle tri1 = { v0, v1, v2 };
-                            //Triangle tri2 = { v2, v3, v0 };
-
-                            thisMeshTriangles.push_back(tri1);
-                            thisMeshTriangles.push_back(tri2);
-
-                        }
-                    }
-
-                    if (part.triangleIndices.size() > 0) {
-                        int numberOfTris = part.triangleIndices.size() / INDICES_PER_TRIANGLE;
-                        int vIndex = 0;
-                        for (int t = 0; t < numberOfTris; t++) {
-                            int i0 = part.triangleIndices[vIndex++];
-                            int i1 = part.triangleIndices[vIndex++];
-                            int i2 = part.triangleIndices[vIndex++];
-
-                            glm::vec3 mv0 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i0], 1.0f));
-                            glm::vec3 mv1 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i1], 1.0f));
-                            glm::vec3 mv2 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i2], 1.0f));
-
-                            // track the mesh parts in model space
-                            if (!atLeastOnePointInBounds) {
-                                thisPartBounds.setBox(mv0, 0.0f);
-                                atLeastOnePointInBounds = true;
-                            } else {
-                                thisPartBounds += mv0;
-                            }
-                            thisPartBounds += mv1;
-                            thisPartBounds += mv2;
-
-                            glm::vec3 v0 = calculateScaledOffsetPoint(mv0);
-                            glm::vec3 v1 = calculateScaledOffsetPoint(mv1);
-                            glm::vec3 v2 = calculateScaledOffsetPoint(mv2);
-
-                            Triangle tri = { v0, v1, v2 };
-
-                            thisMeshTriangles.push_back(tri);
-                        }
-                    }
-                    _calculatedMeshPartBoxes[QPair<int,int>(i, j)] = thisPartBounds;
-                }
-                _calculatedMeshTriangles[i] = thisMeshTriangles;
-                _calculatedMeshPartBoxesValid = true;
-            }
+            _calculatedMeshBoxes[i] = AABox(calculateScaledOffsetExtents(mesh.meshExtents));
         }
         _calculatedMeshBoxesValid = true;
-        _calculatedMeshTrianglesValid = pickAgainstTriangles;
     }
 }
 
@@ -682,6 +606,16 @@ glm::vec3 Model::calculateScaledOffsetPoint(const glm::vec3& point) const {
     return translatedPoint;
 }
 
+glm::vec3 Model::calculateGeometryFramePoint(const glm::vec3& point) const {
+    // the inverse of calculateScaledOffsetPoint, short of the offset matrix the pick triangles already include
+    return (glm::inverse(_rotation) * (point - _translation)) / _scale - _offset;
+}
+
+glm::vec3 Model::calculateGeometryFrameDirection(const glm::vec3& direction) const {
+    // not normalized, so that a distance along it is the same as along the direction in the world
+    return (glm::inverse(_rotation) * direction) / _scale;
+}
+
 bool Model::getJointState(int index, glm::quat& rotation) const {
     return _rig->getJointStateRotation(index, rotation);
 }
@@ -731,9 +665,46 @@ void Model::setURL(const QUrl& url) {
     deleteGeometry();
 
     _geometry.reset(new NetworkGeometry(url, false, QVariantHash()));
+    _geometry->setLoadPriorityOperator(this, [this]() { return evalLoadPriority(); });
+    _geometryLevel = 0;
+    connect(_geometry.data(), &NetworkGeometry::onRefined, this, &Model::geometryLevelLoaded);
+    connect(_geometry.data(), &NetworkGeometry::onSuccess, this, &Model::geometryLevelLoaded);
     onInvalidate();
 }
 
+void Model::geometryLevelLoaded() {
+    if (_geometryLevel == 0 || !_geometry || _geometryLevel == _geometry->getNumLoadedLevels()) {
+        return;
+    }
+    // the states and render items point into the level that just went away, so they get rebuilt the way a new url
+    // rebuilds them
+    {
+        render::PendingChanges pendingChanges;
+        render::ScenePointer scene = AbstractViewStateInterface::instance()->getMain3DScene();
+        removeFromScene(scene, pendingChanges);
+        scene->enqueuePendingChanges(pendingChanges);
+    }
+    _needsReload = true;
+    _meshGroupsKnown = false;
+    invalidCalculatedMeshBoxes();
+    deleteGeometry();
+
+    // drop the blends of the last level still running
+    _appliedBlendNumber = _blendNumber + 1;
+}
+
+float Model::evalLoadPriority() const {
+    ViewFrustum* frustum = _viewState ? _viewState->getCurrentViewFrustum() : nullptr;
+    if (!frustum) {
+        return 0.0f;
+    }
+    // the size over the distance, as the angle the model takes on screen
+    const float MIN_DISTANCE = 0.1f; // meters
+    float size = glm::length(_scaleToFit ? _scaleToFitDimensions : _scale);
+    float distance = glm::max(glm::distance(frustum->getPosition(), _translation), MIN_DISTANCE);
+    return size / distance;
+}
+
 const QSharedPointer<NetworkGeometry> Model::getCollisionGeometry(bool delayLoad)
 {
     if (_collisionGeometry.isNull() && !_collisionUrl.isEmpty()) {
@@ -793,7 +764,8 @@ class Blender : public QRunnable {
 public:
 
     Blender(Model* model, int blendNumber, const QWeakPointer<NetworkGeometry>& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients);
+        const QVector<FBXMesh>& meshes, const QVector<Model::BlendedVertices>& blendedVertices,
+        const QVector<float>& blendshapeCoefficients);
 
     virtual void run();
 
@@ -803,32 +775,44 @@ private:
     int _blendNumber;
     QWeakPointer<NetworkGeometry> _geometry;
     QVector<FBXMesh> _meshes;
+    QVector<Model::BlendedVertices> _blendedVertices;
     QVector<float> _blendshapeCoefficients;
 };
 
 Blender::Blender(Model* model, int blendNumber, const QWeakPointer<NetworkGeometry>& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients) :
+        const QVector<FBXMesh>& meshes, const QVector<Model::BlendedVertices>& blendedVertices,
+        const QVector<float>& blendshapeCoefficients) :
     _model(model),
     _blendNumber(blendNumber),
     _geometry(geometry),
     _meshes(meshes),
+    _blendedVertices(blendedVertices),
     _blendshapeCoefficients(blendshapeCoefficients) {
 }
 
 void Blender::run() {
     PROFILE_RANGE(__FUNCTION__);
     QVector<glm::vec3> vertices, normals;
-    if (!_model.isNull()) {
+    if (!_model.isNull() && _blendedVertices.size() == _meshes.size()) {
         int offset = 0;
-        foreach (const FBXMesh& mesh, _meshes) {
+        for (int m = 0; m < _meshes.size(); m++) {
+            const FBXMesh& mesh = _meshes.at(m);
             if (mesh.blendshapes.isEmpty()) {
                 continue;
             }
-            vertices += mesh.vertices;
-            normals += mesh.normals;
+            // only the vertices the blendshapes move, starting from where they are without them
+            const Model::BlendedVertices& blendedVertices = _blendedVertices.at(m);
+            int blendedCount = blendedVertices.indices.size();
+            vertices.resize(offset + blendedCount);
+            normals.resize(offset + blendedCount);
             glm::vec3* meshVertices = vertices.data() + offset;
             glm::vec3* meshNormals = normals.data() + offset;
-            offset += mesh.vertices.size();
+            for (int i = 0; i < blendedCount; i++) {
+                int index = blendedVertices.indices.at(i);
+                meshVertices[i] = mesh.vertices.at(index);
+                meshNormals[i] = mesh.normals.at(index);
+            }
+            offset += blendedCount;
             const float NORMAL_COEFFICIENT_SCALE = 0.01f;
             for (int i = 0, n = qMin(_blendshapeCoefficients.size(), mesh.blendshapes.size()); i < n; i++) {
                 float vertexCoefficient = _blendshapeCoefficients.at(i);
@@ -838,9 +822,9 @@ void Blender::run() {
                 float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
                 const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
                 for (int j = 0; j < blendshape.indices.size(); j++) {
-                    int index = blendshape.indices.at(j);
-                    meshVertices[index] += blendshape.vertices.at(j) * vertexCoefficient;
-                    meshNormals[index] += blendshape.normals.at(j) * normalCoefficient;
+                    int slot = blendedVertices.slots.at(blendshape.indices.at(j));
+                    meshVertices[slot] += blendshape.vertices.at(j) * vertexCoefficient;
+                    meshNormals[slot] += blendshape.normals.at(j) * normalCoefficient;
                 }
             }
         }
@@ -929,6 +913,12 @@ void Model::snapToRegistrationPoint() {
 
 void Model::simulate(float deltaTime, bool fullUpdate) {
     PROFILE_RANGE(__FUNCTION__);
+    if (prepareSimulate(fullUpdate)) {
+        simulateInternal(deltaTime);
+    }
+}
+
+bool Model::prepareSimulate(bool fullUpdate) {
     fullUpdate = updateGeometry() || fullUpdate || (_scaleToFit && !_scaledToFit)
                     || (_snapModelToRegistrationPoint && !_snappedToRegistrationPoint);
 
@@ -938,7 +928,6 @@ void Model::simulate(float deltaTime, bool fullUpdate) {
         //       not too bad at this point, because it doesn't impact rendering. However it does slow down ray picking
         //       because ray picking needs valid boxes to work
         _calculatedMeshBoxesValid = false;
-        _calculatedMeshTrianglesValid = false;
         onInvalidate();
 
         // check for scale to fit
@@ -948,14 +937,17 @@ void Model::simulate(float deltaTime, bool fullUpdate) {
         if (_snapModelToRegistrationPoint && !_snappedToRegistrationPoint) {
             snapToRegistrationPoint();
         }
-        simulateInternal(deltaTime);
+        return true;
     }
+    return false;
 }
 
 //virtual
 void Model::updateRig(float deltaTime, glm::mat4 parentTransform) {
-    _needsUpdateClusterMatrices = true;
-     _rig->updateAnimations(deltaTime, parentTransform);
+    // the cluster matrices only change when the animation LOD let the rig update its joints
+    if (_rig->updateAnimations(deltaTime, parentTransform)) {
+        _needsUpdateClusterMatrices = true;
+    }
 }
 void Model::simulateInternal(float deltaTime) {
     // update the world space transforms for all joints
@@ -965,10 +957,17 @@ void Model::simulateInternal(float deltaTime) {
     updateRig(deltaTime, parentTransform);
 }
 void Model::updateClusterMatrices() {
+    if (computeClusterMatrices()) {
+        requestBlend();
+    }
+}
+
+bool Model::computeClusterMatrices() {
     PerformanceTimer perfTimer("Model::updateClusterMatrices");
 
+    QMutexLocker locker(&_clusterMatricesMutex);
     if (!_needsUpdateClusterMatrices) {
-        return;
+        return false;
     }
     _needsUpdateClusterMatrices = false;
     const FBXGeometry& geometry = _geometry->getFBXGeometry();
@@ -978,22 +977,45 @@ void Model::updateClusterMatrices() {
         glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
     auto cauterizeMatrix = _rig->getJointTransform(geometry.neckJointIndex) * zeroScale;
 
+    // The palette is built once for the pose, the joints shared by several meshes don't get transformed again for
+    // each of their clusters
     glm::mat4 modelToWorld = glm::mat4_cast(_rotation);
-    for (int i = 0; i < _meshStates.size(); i++) {
+    int numJoints = geometry.joints.size();
+    QVector<glm::mat4> palette(numJoints);
+    for (int i = 0; i < numJoints; i++) {
+        palette[i] = modelToWorld * _rig->getJointTransform(i);
+    }
+    // as an optimization, don't build the cauterized palette if the boneSet is empty.
+    QVector<glm::mat4> cauterizedPalette;
+    if (!_cauterizeBoneSet.empty()) {
+        cauterizedPalette = palette;
+        glm::mat4 cauterizedJointMatrix = modelToWorld * cauterizeMatrix;
+        for (int jointIndex : _cauterizeBoneSet) {
+            if (jointIndex >= 0 && jointIndex < numJoints) {
+                cauterizedPalette[jointIndex] = cauterizedJointMatrix;
+            }
+        }
+    }
+
+    // A model that didn't move nor change its pose keeps its matrices, and its buffers don't get uploaded again
+    bool isSamePose = !_jointPalette.isEmpty() && palette == _jointPalette && cauterizedPalette == _cauterizedJointPalette;
+    _jointPalette = palette;
+    _cauterizedJointPalette = cauterizedPalette;
+
+    for (int i = 0; i < _meshStates.size() && !isSamePose; i++) {
         MeshState& state = _meshStates[i];
         const FBXMesh& mesh = geometry.meshes.at(i);
 
         for (int j = 0; j < mesh.clusters.size(); j++) {
             const FBXCluster& cluster = mesh.clusters.at(j);
-            auto jointMatrix = _rig->getJointTransform(cluster.jointIndex);
-            state.clusterMatrices[j] = modelToWorld * jointMatrix * cluster.inverseBindMatrix;
-
-            // as an optimization, don't build cautrizedClusterMatrices if the boneSet is empty.
-            if (!_cauterizeBoneSet.empty()) {
-                if (_cauterizeBoneSet.find(cluster.jointIndex) != _cauterizeBoneSet.end()) {
-                    jointMatrix = cauterizeMatrix;
-                }
-                state.cauterizedClusterMatrices[j] = modelToWorld * jointMatrix * cluster.inverseBindMatrix;
+            // as with Rig::getJointTransform, a joint out of range has the identity transform
+            bool isValidJoint = (cluster.jointIndex >= 0 && cluster.jointIndex < numJoints);
+            const glm::mat4& jointMatrix = isValidJoint ? palette[cluster.jointIndex] : modelToWorld;
+            state.clusterMatrices[j] = jointMatrix * cluster.inverseBindMatrix;
+
+            if (!cauterizedPalette.isEmpty()) {
+                const glm::mat4& cauterizedJointMatrix = isValidJoint ? cauterizedPalette[cluster.jointIndex] : modelToWorld;
+                state.cauterizedClusterMatrices[j] = cauterizedJointMatrix * cluster.inverseBindMatrix;
             }
         }
 
@@ -1014,8 +1036,12 @@ void Model::updateClusterMatrices() {
             }
         }
     }
+    return true;
+}
 
+void Model::requestBlend() {
     // post the blender if we're not currently waiting for one to finish
+    const FBXGeometry& geometry = _geometry->getFBXGeometry();
     if (geometry.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
         _blendedBlendshapeCoefficients = _blendshapeCoefficients;
         DependencyManager::get<ModelBlender>()->noteRequiresBlend(this);
@@ -1057,7 +1083,7 @@ bool Model::maybeStartBlender() {
     const FBXGeometry& fbxGeometry = _geometry->getFBXGeometry();
     if (fbxGeometry.hasBlendedMeshes()) {
         QThreadPool::globalInstance()->start(new Blender(this, ++_blendNumber, _geometry,
-            fbxGeometry.meshes, _blendshapeCoefficients));
+            fbxGeometry.meshes, _blendedVertices, _blendshapeCoefficients));
         return true;
     }
     return false;
@@ -1070,19 +1096,32 @@ void Model::setBlendedVertices(int blendNumber, const QWeakPointer<NetworkGeomet
     }
     _appliedBlendNumber = blendNumber;
     const FBXGeometry& fbxGeometry = _geometry->getFBXGeometry();
-    int index = 0;
+    int offset = 0;
     for (int i = 0; i < fbxGeometry.meshes.size(); i++) {
         const FBXMesh& mesh = fbxGeometry.meshes.at(i);
         if (mesh.blendshapes.isEmpty()) {
             continue;
         }
+        const QVector<int>& indices = _blendedVertices.at(i).indices;
+        if (offset + indices.size() > vertices.size()) {
+            return;
+        }
 
+        // each run of consecutive vertices is one edit, so that the buffer only uploads the ranges that moved
         gpu::BufferPointer& buffer = _blendedVertexBuffers[i];
-        buffer->setSubData(0, mesh.vertices.size() * sizeof(glm::vec3), (gpu::Byte*) vertices.constData() + index*sizeof(glm::vec3));
-        buffer->setSubData(mesh.vertices.size() * sizeof(glm::vec3),
-            mesh.normals.size() * sizeof(glm::vec3), (gpu::Byte*) normals.constData() + index*sizeof(glm::vec3));
-
-        index += mesh.vertices.size();
+        gpu::Buffer::Size normalsOffset = mesh.vertices.size() * sizeof(glm::vec3);
+        for (int start = 0; start < indices.size();) {
+            int end = start + 1;
+            while (end < indices.size() && indices.at(end) == indices.at(end - 1) + 1) {
+                end++;
+            }
+            gpu::Buffer::Size runOffset = indices.at(start) * sizeof(glm::vec3);
+            gpu::Buffer::Size runSize = (end - start) * sizeof(glm::vec3);
+            buffer->setSubData(runOffset, runSize, (gpu::Byte*) (vertices.constData() + offset + start));
+            buffer->setSubData(normalsOffset + runOffset, runSize, (gpu::Byte*) (normals.constData() + offset + start));
+            start = end;
+        }
+        offset += indices.size();
     }
 }
 
@@ -1095,7 +1134,9 @@ void Model::setGeometry(const QSharedPointer<NetworkGeometry>& newGeometry) {
 
 void Model::deleteGeometry() {
     _blendedVertexBuffers.clear();
+    _blendedVertices.clear();
     _meshStates.clear();
+    _jointPalette.clear();
     if (_rig) {
         _rig->clearJointStates();
         _rig->deleteAnimations();
@@ -69,6 +69,9 @@ public:
     Q_INVOKABLE void setURL(const QUrl& url);
     const QUrl& getURL() const { return _url; }
 
+    /// The load priority of the geometry and textures, the larger the model looks from the camera the sooner they load
+    float evalLoadPriority() const;
+
     // new Scene/Engine rendering support
     void setVisibleInScene(bool newValue, std::shared_ptr<render::Scene> scene);
     bool needsFixupInScene() { return !_readyWhenAdded && readyToAddToScene(); }
@@ -86,14 +89,25 @@ public:
 
     bool isVisible() const { return _isVisible; }
 
+    /// Whether the owner moves or animates the model, its parts are then dynamic items of the scene
+    void setMoving(bool isMoving) { _isMoving = isMoving; }
+    bool isMoving() const { return _isMoving; }
+
     AABox getPartBounds(int meshIndex, int partIndex);
 
     bool maybeStartBlender();
 
-    /// Sets blended vertices computed in a separate thread.
+    /// Sets blended vertices computed in a separate thread, only those of the blended vertices of each mesh
     void setBlendedVertices(int blendNumber, const QWeakPointer<NetworkGeometry>& geometry,
         const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals);
 
+    /// The vertices of a mesh that any of its blendshapes moves, which are all that the blender computes and uploads
+    class BlendedVertices {
+    public:
+        QVector<int> indices; // sorted
+        QVector<int> slots; // for each vertex of the mesh, where it is in the indices, -1 if no blendshape moves it
+    };
+
     bool isLoaded() const { return _geometry && _geometry->isLoaded(); }
     bool isLoadedWithTextures() const { return _geometry && _geometry->isLoadedWithTextures(); }
 
@@ -111,6 +125,10 @@ public:
     virtual void simulate(float deltaTime, bool fullUpdate = true);
     void updateClusterMatrices();
 
+    /// the cluster matrices of the current pose, without asking for blended vertices so that it may run off the main
+    /// thread, returns whether they had to be computed
+    bool computeClusterMatrices();
+
     /// Returns a reference to the shared geometry.
     const QSharedPointer<NetworkGeometry>& getGeometry() const { return _geometry; }
 
@@ -222,6 +240,10 @@ protected:
     /// Returns the scaled equivalent of a point in model space.
     glm::vec3 calculateScaledOffsetPoint(const glm::vec3& point) const;
 
+    /// Returns the point in the frame of the geometry, where its shared pick triangles are, of a point in the world.
+    glm::vec3 calculateGeometryFramePoint(const glm::vec3& point) const;
+    glm::vec3 calculateGeometryFrameDirection(const glm::vec3& direction) const;
+
     /// Fetches the joint state at the specified index.
     /// \return whether or not the joint state is "valid" (that is, non-default)
     bool getJointState(int index, glm::quat& rotation) const;
@@ -265,6 +287,11 @@ protected:
     };
 
     QVector<MeshState> _meshStates;
+
+    // The joint to world transforms of the pose the cluster matrices were last built from, shared by all the meshes
+    QVector<glm::mat4> _jointPalette;
+    QVector<glm::mat4> _cauterizedJointPalette;
+
     std::unordered_set<int> _cauterizeBoneSet;
     bool _cauterizeBones;
 
@@ -277,9 +304,14 @@ protected:
     void scaleToFit();
     void snapToRegistrationPoint();
 
+    /// the part of simulate() that runs on the main thread, returns whether simulateInternal() has to follow
+    bool prepareSimulate(bool fullUpdate);
     void simulateInternal(float deltaTime);
     virtual void updateRig(float deltaTime, glm::mat4 parentTransform);
 
+    /// asks the blender for new vertices if the blendshapes changed, on the main thread
+    void requestBlend();
+
     /// \param jointIndex index of joint in model structure
     /// \param position position of joint in model-frame
     /// \param rotation rotation of joint in model-frame
@@ -305,13 +337,15 @@ protected:
     /// Allow sub classes to force invalidating the bboxes
     void invalidCalculatedMeshBoxes() {
         _calculatedMeshBoxesValid = false;
-        _calculatedMeshPartBoxesValid = false;
-        _calculatedMeshTrianglesValid = false;
     }
 
     // hook for derived classes to be notified when setUrl invalidates the current model.
     virtual void onInvalidate() {};
 
+private slots:
+    // a finer level of the model replaced the one in use
+    void geometryLevelLoaded();
+
 private:
 
     void deleteGeometry();
@@ -326,26 +360,24 @@ private:
     QUrl _url;
     QUrl _collisionUrl;
     bool _isVisible;
+    bool _isMoving = false;
 
     gpu::Buffers _blendedVertexBuffers;
+    QVector<BlendedVertices> _blendedVertices; // for each mesh, empty for the meshes without blendshapes
 
     QVector<QVector<QSharedPointer<Texture> > > _dilatedTextures;
 
     QVector<float> _blendedBlendshapeCoefficients;
     int _blendNumber;
     int _appliedBlendNumber;
+    int _geometryLevel = 0; // the number of levels of the geometry loaded when the states were built
 
-    QHash<QPair<int,int>, AABox> _calculatedMeshPartBoxes; // world coordinate AABoxes for all sub mesh part boxes
-
-    bool _calculatedMeshPartBoxesValid;
+    // the triangles and the part boxes are the same for every model of the geometry, see NetworkGeometry::getPickData
     QVector<AABox> _calculatedMeshBoxes; // world coordinate AABoxes for all sub mesh boxes
     bool _calculatedMeshBoxesValid;
-
-    QVector< QVector<Triangle> > _calculatedMeshTriangles; // world coordinate triangles for all sub meshes
-    bool _calculatedMeshTrianglesValid;
     QMutex _mutex;
 
-    void recalculateMeshBoxes(bool pickAgainstTriangles = false);
+    void recalculateMeshBoxes();
 
     void segregateMeshGroups(); // used to calculate our list of translucent vs opaque meshes
 
@@ -368,6 +400,7 @@ private:
     bool _readyWhenAdded = false;
     bool _needsReload = true;
     bool _needsUpdateClusterMatrices = true;
+    QMutex _clusterMatricesMutex; // the parts of the model may be rendered on several threads
 
     friend class MeshPartPayload;
 protected:
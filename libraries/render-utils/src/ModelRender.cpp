@@ -240,10 +240,22 @@ void ModelRender::RenderPipelineLib::initLocations(gpu::ShaderPointer& program,
     locations.skinClusterBufferUnit = program->getBuffers().findLocation("skinClusterBuffer");
     locations.materialBufferUnit = program->getBuffers().findLocation("materialBuffer");
     locations.lightBufferUnit = program->getBuffers().findLocation("lightBuffer");
+    locations.instanced = program->getUniforms().findLocation("Instanced");
 
 }
 
 
+void ModelRender::prepareConcurrentRender() {
+    getRenderPipelineLib();
+
+    auto textureCache = DependencyManager::get<TextureCache>();
+    textureCache->getWhiteTexture();
+    textureCache->getGrayTexture();
+    textureCache->getBlueTexture();
+    textureCache->getBlackTexture();
+    textureCache->getNormalFittingTexture();
+}
+
 void ModelRender::pickPrograms(gpu::Batch& batch, RenderArgs::RenderMode mode, bool translucent, float alphaThreshold,
     bool hasLightmap, bool hasTangents, bool hasSpecular, bool isSkinned, bool isWireframe, RenderArgs* args,
     Locations*& locations) {
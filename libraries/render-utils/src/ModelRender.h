@@ -41,12 +41,17 @@ public:
         int skinClusterBufferUnit;
         int materialBufferUnit;
         int lightBufferUnit;
+        int instanced;
     };
 
     static void pickPrograms(gpu::Batch& batch, RenderArgs::RenderMode mode, bool translucent, float alphaThreshold,
         bool hasLightmap, bool hasTangents, bool hasSpecular, bool isSkinned, bool isWireframe, RenderArgs* args,
         Locations*& locations);
 
+    // Create the pipelines and textures pickPrograms and MeshPartPayload bind lazily, so that the model parts can then
+    // be recorded on several threads at once
+    static void prepareConcurrentRender();
+
     class RenderKey {
     public:
         enum FlagBit {
@@ -21,8 +21,10 @@
 #include "DeferredLightingEffect.h"
 #include "TextureCache.h"
 #include "HitEffect.h"
+#include "ModelRender.h"
 
 #include "render/DrawStatus.h"
+#include "render/OcclusionCulling.h"
 #include "AmbientOcclusionEffect.h"
 #include "AntialiasingEffect.h"
 
@@ -71,16 +73,25 @@ RenderDeferredTask::RenderDeferredTask() : Task() {
     _jobs.push_back(Job(new PrepareDeferred::JobModel("PrepareDeferred")));
     _jobs.push_back(Job(new FetchItems::JobModel("FetchOpaque",
         FetchItems(
-            [] (const RenderContextPointer& context, int count) {
-                context->_numFeedOpaqueItems = count; 
+            [] (const RenderContextPointer& context, int count, int numTested) {
+                context->_numFeedOpaqueItems = count;
+                context->_numTestedOpaqueItems = numTested;
             }
         )
     )));
-    _jobs.push_back(Job(new CullItemsOpaque::JobModel("CullOpaque", _jobs.back().getOutput())));
+    _jobs.back().setConcurrent(true);
+    auto& fetchedOpaques = _jobs.back().getOutput();
+    _itemOcclusion = std::make_shared<ItemOcclusion>();
+    _jobs.push_back(Job(new CullItemsOpaque::JobModel("CullOpaque", _jobs.back().getOutput(), CullItemsOpaque(_itemOcclusion))));
+    _jobs.back().setConcurrent(true);
     _jobs.push_back(Job(new DepthSortItems::JobModel("DepthSortOpaque", _jobs.back().getOutput())));
+    _jobs.back().setConcurrent(true);
     auto& renderedOpaques = _jobs.back().getOutput();
     _jobs.push_back(Job(new DrawOpaqueDeferred::JobModel("DrawOpaqueDeferred", _jobs.back().getOutput())));
 
+    // the bounds of the fetched items get tested against the depth of the opaque ones, for the culling of the next frame
+    _jobs.push_back(Job(new TestOcclusion::JobModel("TestOcclusion", fetchedOpaques, TestOcclusion(_itemOcclusion))));
+
     _jobs.push_back(Job(new DrawStencilDeferred::JobModel("DrawOpaqueStencil")));
     _jobs.push_back(Job(new DrawBackgroundDeferred::JobModel("DrawBackgroundDeferred")));
 
@@ -100,15 +111,19 @@ RenderDeferredTask::RenderDeferredTask() : Task() {
     _jobs.push_back(Job(new FetchItems::JobModel("FetchTransparent",
          FetchItems(
             ItemFilter::Builder::transparentShape().withoutLayered(),
-            [] (const RenderContextPointer& context, int count) {
-                context->_numFeedTransparentItems = count; 
+            [] (const RenderContextPointer& context, int count, int numTested) {
+                context->_numFeedTransparentItems = count;
+                context->_numTestedTransparentItems = numTested;
             }
          )
      )));
+    _jobs.back().setConcurrent(true);
     _jobs.push_back(Job(new CullItemsTransparent::JobModel("CullTransparent", _jobs.back().getOutput())));
+    _jobs.back().setConcurrent(true);
 
 
     _jobs.push_back(Job(new DepthSortItems::JobModel("DepthSortTransparent", _jobs.back().getOutput(), DepthSortItems(false))));
+    _jobs.back().setConcurrent(true);
     _jobs.push_back(Job(new DrawTransparentDeferred::JobModel("TransparentDeferred", _jobs.back().getOutput())));
     
     _jobs.push_back(Job(new render::DrawStatus::JobModel("DrawStatus", renderedOpaques)));
@@ -161,39 +176,45 @@ void RenderDeferredTask::run(const SceneContextPointer& sceneContext, const Rend
 
     renderContext->args->_context->syncCache();
 
-    for (auto job : _jobs) {
-        job.run(sceneContext, renderContext);
-    }
+    // fetching, culling and sorting the opaque and transparent items overlap, the drawing stays in order
+    runJobs(_jobs, sceneContext, renderContext);
 
 };
 
+// Every batch of the opaque and transparent items starts from the same view
+static void setupItemBatch(RenderArgs* args, gpu::Batch& batch) {
+    batch.setViewportTransform(args->_viewport);
+    batch.setStateScissorRect(args->_viewport);
+
+    glm::mat4 projMat;
+    Transform viewMat;
+    args->_viewFrustum->evalProjectionMatrix(projMat);
+    args->_viewFrustum->evalViewTransform(viewMat);
+
+    batch.setProjectionTransform(projMat);
+    batch.setViewTransform(viewMat);
+}
+
 void DrawOpaqueDeferred::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems) {
     assert(renderContext->args);
     assert(renderContext->args->_viewFrustum);
 
     RenderArgs* args = renderContext->args;
-    gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
-        batch.setViewportTransform(args->_viewport);
-        batch.setStateScissorRect(args->_viewport);
-        args->_batch = &batch;
+    renderContext->_numDrawnOpaqueItems = inItems.size();
 
-        renderContext->_numDrawnOpaqueItems = inItems.size();
-
-        glm::mat4 projMat;
-        Transform viewMat;
-        args->_viewFrustum->evalProjectionMatrix(projMat);
-        args->_viewFrustum->evalViewTransform(viewMat);
-
-        batch.setProjectionTransform(projMat);
-        batch.setViewTransform(viewMat);
+    {
+        const float OPAQUE_ALPHA_THRESHOLD = 0.5f;
+        args->_alphaThreshold = OPAQUE_ALPHA_THRESHOLD;
+    }
 
-        {
-            const float OPAQUE_ALPHA_THRESHOLD = 0.5f;
-            args->_alphaThreshold = OPAQUE_ALPHA_THRESHOLD;
-        }
-        renderItems(sceneContext, renderContext, inItems, renderContext->_maxDrawnOpaqueItems);
-        args->_batch = nullptr;
-    });
+    // the model parts get recorded on the worker threads, the static parts of the same mesh and material get drawn
+    // as instances at the end of each batch
+    ModelRender::prepareConcurrentRender();
+    args->_enableInstancing = true;
+    renderItemsInBatches(sceneContext, renderContext, inItems, [=](gpu::Batch& batch) {
+        setupItemBatch(args, batch);
+    }, renderContext->_maxDrawnOpaqueItems);
+    args->_enableInstancing = false;
 }
 
 void DrawTransparentDeferred::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems) {
@@ -201,27 +222,15 @@ void DrawTransparentDeferred::run(const SceneContextPointer& sceneContext, const
     assert(renderContext->args->_viewFrustum);
 
     RenderArgs* args = renderContext->args;
-    gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
-        batch.setViewportTransform(args->_viewport);
-        batch.setStateScissorRect(args->_viewport);
-        args->_batch = &batch;
-    
-        renderContext->_numDrawnTransparentItems = inItems.size();
+    renderContext->_numDrawnTransparentItems = inItems.size();
 
-        glm::mat4 projMat;
-        Transform viewMat;
-        args->_viewFrustum->evalProjectionMatrix(projMat);
-        args->_viewFrustum->evalViewTransform(viewMat);
+    const float TRANSPARENT_ALPHA_THRESHOLD = 0.0f;
+    args->_alphaThreshold = TRANSPARENT_ALPHA_THRESHOLD;
 
-        batch.setProjectionTransform(projMat);
-        batch.setViewTransform(viewMat);
-    
-        const float TRANSPARENT_ALPHA_THRESHOLD = 0.0f;
-        args->_alphaThreshold = TRANSPARENT_ALPHA_THRESHOLD;
-    
-        renderItems(sceneContext, renderContext, inItems, renderContext->_maxDrawnTransparentItems);
-        args->_batch = nullptr;
-    });
+    ModelRender::prepareConcurrentRender();
+    renderItemsInBatches(sceneContext, renderContext, inItems, [=](gpu::Batch& batch) {
+        setupItemBatch(args, batch);
+    }, renderContext->_maxDrawnTransparentItems);
 }
 
 gpu::PipelinePointer DrawOverlay3D::_opaquePipeline;
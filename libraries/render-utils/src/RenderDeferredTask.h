@@ -118,6 +118,9 @@ public:
 
     gpu::Queries _timerQueries;
     int _currentTimerQueryIndex = 0;
+
+    // Shared by the test of the occlusion of the opaque items and their culling in the next frame
+    render::ItemOcclusionPointer _itemOcclusion;
 };
 
 
@@ -33,6 +33,9 @@
 
 const float TextRenderer3D::DEFAULT_POINT_SIZE = 12;
 
+// past this many strings the renderer forgets all the vertices it kept and starts over
+static const int MAX_CACHED_STRINGS = 64;
+
 TextRenderer3D* TextRenderer3D::getInstance(const char* family, float pointSize,
     bool bold, bool italic, EffectType effect, int effectThickness) {
     return new TextRenderer3D(family, pointSize, false, italic, effect, effectThickness);
@@ -78,7 +81,10 @@ void TextRenderer3D::draw(gpu::Batch& batch, float x, float y, const QString& st
     if (_font) {
         // Cache color so that the pointer stays valid.
         _color = color;
-        _font->drawString(batch, x, y, str, &_color, _effectType, bounds);
+        if (_drawInfos.size() >= MAX_CACHED_STRINGS && !_drawInfos.contains(str)) {
+            _drawInfos.clear();
+        }
+        _font->drawString(batch, _drawInfos[str], x, y, str, &_color, _effectType, bounds);
     }
 }
 
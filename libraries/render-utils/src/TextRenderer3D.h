@@ -14,15 +14,10 @@
 
 #include <glm/glm.hpp>
 #include <QColor>
-
-
-
-namespace gpu {
-class Batch;
-}
-class Font;
+#include <QHash>
 
 #include "text/EffectType.h"
+#include "text/Font.h"
 #include "text/FontFamilies.h"
 
 // TextRenderer3D is actually a fairly thin wrapper around a Font class
@@ -56,6 +51,9 @@ private:
     glm::vec4 _color;
 
     Font* _font;
+
+    // the vertices of the strings drawn lately, renderers shared by many objects draw many strings
+    QHash<QString, Font::DrawInfo> _drawInfos;
 };
 
 
@@ -1,5 +1,7 @@
 #include "Font.h"
 
+#include <limits>
+
 #include <QFile>
 #include <QImage>
 
@@ -250,14 +252,44 @@ void Font::setupGPU() {
     }
 }
 
-void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2& bounds) {
-    _verticesBuffer = std::make_shared<gpu::Buffer>();
-    _numVertices = 0;
-    _indicesBuffer = std::make_shared<gpu::Buffer>();
-    _numIndices = 0;
+static const unsigned int MAX_QUADS = std::numeric_limits<quint16>::max() / VERTICES_PER_QUAD;
+
+void Font::growIndices(unsigned int numQuads) {
+    if (numQuads <= _numQuads) {
+        return;
+    }
+    std::vector<quint16> indices(numQuads * NUMBER_OF_INDICES_PER_QUAD);
+    for (unsigned int quad = 0; quad < numQuads; quad++) {
+        quint16 verticesOffset = quad * VERTICES_PER_QUAD;
+
+        // The 4 vertices are { ll, lr, ul, ur }, a Z pattern, and the shared side vertices are used
+        // sequentially to improve cache locality
+        //
+        //  2 -- 3
+        //  |    |
+        //  |    |
+        //  0 -- 1
+        //
+        //  { 0, 1, 2 } -> { 2, 1, 3 }
+        quint16* quadIndices = &indices[quad * NUMBER_OF_INDICES_PER_QUAD];
+        quadIndices[0] = verticesOffset + 0;
+        quadIndices[1] = verticesOffset + 1;
+        quadIndices[2] = verticesOffset + 2;
+        quadIndices[3] = verticesOffset + 2;
+        quadIndices[4] = verticesOffset + 1;
+        quadIndices[5] = verticesOffset + 3;
+    }
+    _indicesBuffer = std::make_shared<gpu::Buffer>(indices.size() * sizeof(quint16), (const gpu::Byte*)indices.data());
+    _numQuads = numQuads;
+}
+
+void Font::rebuildVertices(DrawInfo& drawInfo, float x, float y, const QString& str, const glm::vec2& bounds) {
+    drawInfo.string = str;
+    drawInfo.origin = glm::vec2(x, y);
+    drawInfo.bounds = bounds;
 
-    _lastStringRendered = str;
-    _lastBounds = bounds;
+    std::vector<QuadBuilder> quads;
+    quads.reserve(str.size());
 
     // Top left of text
     glm::vec2 advance = glm::vec2(x, y);
@@ -290,40 +322,10 @@ void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2
         // Draw the token
         if (!isNewLine) {
             for (auto c : token) {
-                auto glyph = _glyphs[c];
-                quint16 verticesOffset = _numVertices;
-
-                QuadBuilder qd(glyph, advance - glm::vec2(0.0f, _ascent));
-                _verticesBuffer->append(sizeof(QuadBuilder), (const gpu::Byte*)&qd);
-                _numVertices += 4;
-                
-                // Sam's recommended triangle slices
-                // Triangle tri1 = { v0, v1, v3 };
-                // Triangle tri2 = { v1, v2, v3 };
-                // NOTE: Random guy on the internet's recommended triangle slices
-                // Triangle tri1 = { v0, v1, v2 };
-                // Triangle tri2 = { v2, v3, v0 };
-
-                // The problem here being that the 4 vertices are { ll, lr, ul, ur }, a Z pattern
-                // Additionally, you want to ensure that the shared side vertices are used sequentially
-                // to improve cache locality
-                //
-                //  2 -- 3
-                //  |    |
-                //  |    |
-                //  0 -- 1
-                //
-                //  { 0, 1, 2 } -> { 2, 1, 3 }
-                quint16 indices[NUMBER_OF_INDICES_PER_QUAD];
-                indices[0] = verticesOffset + 0;
-                indices[1] = verticesOffset + 1;
-                indices[2] = verticesOffset + 2;
-                indices[3] = verticesOffset + 2;
-                indices[4] = verticesOffset + 1;
-                indices[5] = verticesOffset + 3;
-                _indicesBuffer->append(sizeof(indices), (const gpu::Byte*)indices);
-                _numIndices += NUMBER_OF_INDICES_PER_QUAD;
-                
+                const Glyph& glyph = _glyphs[c];
+                if (quads.size() < MAX_QUADS) {
+                    quads.push_back(QuadBuilder(glyph, advance - glm::vec2(0.0f, _ascent)));
+                }
 
                 // Advance by glyph size
                 advance.x += glyph.d;
@@ -333,16 +335,26 @@ void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2
             advance.x += _spaceWidth;
         }
     }
+
+    // the buffer is replaced rather than refilled, batches of earlier frames may still hold the old one
+    drawInfo.verticesBuffer = std::make_shared<gpu::Buffer>(quads.size() * sizeof(QuadBuilder),
+                                                            (const gpu::Byte*)quads.data());
+    drawInfo.numIndices = (unsigned int)quads.size() * NUMBER_OF_INDICES_PER_QUAD;
+    growIndices((unsigned int)quads.size());
 }
 
-void Font::drawString(gpu::Batch& batch, float x, float y, const QString& str, const glm::vec4* color,
-                      EffectType effectType, const glm::vec2& bounds) {
+void Font::drawString(gpu::Batch& batch, DrawInfo& drawInfo, float x, float y, const QString& str,
+                      const glm::vec4* color, EffectType effectType, const glm::vec2& bounds) {
     if (str == "") {
         return;
     }
 
-    if (str != _lastStringRendered || bounds != _lastBounds) {
-        rebuildVertices(x, y, str, bounds);
+    if (str != drawInfo.string || bounds != drawInfo.bounds || glm::vec2(x, y) != drawInfo.origin ||
+        !drawInfo.verticesBuffer) {
+        rebuildVertices(drawInfo, x, y, str, bounds);
+    }
+    if (drawInfo.numIndices == 0) {
+        return;
     }
 
     setupGPU();
@@ -353,7 +365,7 @@ void Font::drawString(gpu::Batch& batch, float x, float y, const QString& str, c
     batch._glUniform4fv(_colorLoc, 1, (const float*)color);
 
     batch.setInputFormat(_format);
-    batch.setInputBuffer(0, _verticesBuffer, 0, _format->getChannels().at(0)._stride);
+    batch.setInputBuffer(0, drawInfo.verticesBuffer, 0, _format->getChannels().at(0)._stride);
     batch.setIndexBuffer(gpu::UINT16, _indicesBuffer, 0);
-    batch.drawIndexed(gpu::TRIANGLES, _numIndices, 0);
+    batch.drawIndexed(gpu::TRIANGLES, drawInfo.numIndices, 0);
 }
@@ -17,6 +17,17 @@
 
 class Font {
 public:
+    // The vertices of a string drawn with the font, kept by whoever draws it so that they are only rebuilt when the
+    // string, where it starts or its bounds change
+    struct DrawInfo {
+        gpu::BufferPointer verticesBuffer;
+        unsigned int numIndices = 0;
+
+        QString string;
+        glm::vec2 origin;
+        glm::vec2 bounds;
+    };
+
     Font();
 
     void read(QIODevice& path);
@@ -25,7 +36,7 @@ public:
     float getFontSize() const { return _fontSize; }
 
     // Render string to batch
-    void drawString(gpu::Batch& batch, float x, float y, const QString& str,
+    void drawString(gpu::Batch& batch, DrawInfo& drawInfo, float x, float y, const QString& str,
         const glm::vec4* color, EffectType effectType,
         const glm::vec2& bound);
 
@@ -38,7 +49,8 @@ private:
     glm::vec2 computeTokenExtent(const QString& str) const;
 
     const Glyph& getGlyph(const QChar& c) const;
-    void rebuildVertices(float x, float y, const QString& str, const glm::vec2& bounds);
+    void rebuildVertices(DrawInfo& drawInfo, float x, float y, const QString& str, const glm::vec2& bounds);
+    void growIndices(unsigned int numQuads);
 
     void setupGPU();
 
@@ -63,19 +75,13 @@ private:
     gpu::PipelinePointer _pipeline;
     gpu::TexturePointer _texture;
     gpu::Stream::FormatPointer _format;
-    gpu::BufferPointer _verticesBuffer;
+    // every string's quads are indexed the same way, so the strings share the indices of the longest one
     gpu::BufferPointer _indicesBuffer;
-    gpu::BufferStreamPointer _stream;
-    unsigned int _numVertices = 0;
-    unsigned int _numIndices = 0;
+    unsigned int _numQuads = 0;
 
     int _fontLoc = -1;
     int _outlineLoc = -1;
     int _colorLoc = -1;
-
-    // last string render characteristics
-    QString _lastStringRendered;
-    glm::vec2 _lastBounds;
 };
 
 #endif
@@ -13,12 +13,18 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <condition_variable>
+#include <mutex>
+
+#include <QRunnable>
+#include <QThreadPool>
 
 #include <PerfStat.h>
 #include <RenderArgs.h>
 #include <ViewFrustum.h>
 #include <gpu/Context.h>
 
+#include "OcclusionCulling.h"
 
 using namespace render;
 
@@ -41,54 +47,211 @@ void DrawSceneTask::run(const SceneContextPointer& sceneContext, const RenderCon
         return;
     }
 
-    for (auto job : _jobs) {
-        job.run(sceneContext, renderContext);
-    }
+    runJobs(_jobs, sceneContext, renderContext);
 };
 
 Job::~Job() {
 }
 
+// The jobs of one run of runJobs and their progress, shared with the runnables of the concurrent jobs
+class JobGraph : public std::enable_shared_from_this<JobGraph> {
+public:
+    JobGraph(const Jobs& jobs, const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext);
+
+    void run();
+    void runConcurrentJob(size_t index);
+
+private:
+    enum Status { WAITING, QUEUED, RUNNING, DONE };
+
+    void runJob(size_t index, std::unique_lock<std::mutex>& lock);
+    void queueReadyJobs();
+    void waitForJobs(const std::vector<size_t>& indices, std::unique_lock<std::mutex>& lock);
+
+    Jobs _jobs;
+    SceneContextPointer _sceneContext;
+    RenderContextPointer _renderContext;
+    std::vector<std::vector<size_t>> _producers;
+    std::vector<Status> _status;
+    std::mutex _mutex;
+    std::condition_variable _jobDone;
+};
+
+class ConcurrentJobRunner : public QRunnable {
+public:
+    ConcurrentJobRunner(const std::shared_ptr<JobGraph>& graph, size_t index) : _graph(graph), _index(index) {}
+
+    void run() { _graph->runConcurrentJob(_index); }
+
+private:
+    std::shared_ptr<JobGraph> _graph;
+    size_t _index;
+};
+
+// The render jobs get their own pool so that they never queue behind the texture readers in the global one
+static QThreadPool* getJobThreadPool() {
+    static QThreadPool* pool = nullptr;
+    if (!pool) {
+        pool = new QThreadPool();
+    }
+    return pool;
+}
+
+JobGraph::JobGraph(const Jobs& jobs, const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) :
+    _jobs(jobs),
+    _sceneContext(sceneContext),
+    _renderContext(renderContext),
+    _producers(jobs.size()),
+    _status(jobs.size(), WAITING)
+{
+    for (size_t i = 0; i < _jobs.size(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            if (_jobs[i].dependsOn(_jobs[j])) {
+                _producers[i].push_back(j);
+            }
+        }
+    }
+}
+
+void JobGraph::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    queueReadyJobs();
+
+    std::vector<size_t> concurrentJobs;
+    for (size_t i = 0; i < _jobs.size(); ++i) {
+        if (_jobs[i].isConcurrent()) {
+            concurrentJobs.push_back(i);
+            continue;
+        }
+        waitForJobs(_producers[i], lock);
+        runJob(i, lock);
+    }
+
+    // the concurrent jobs hold on to the RenderArgs of this frame
+    waitForJobs(concurrentJobs, lock);
+}
+
+void JobGraph::runConcurrentJob(size_t index) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    // the render thread may have picked the job up already while waiting for it
+    if (_status[index] == QUEUED) {
+        runJob(index, lock);
+    }
+}
+
+void JobGraph::runJob(size_t index, std::unique_lock<std::mutex>& lock) {
+    _status[index] = RUNNING;
+    lock.unlock();
+    _jobs[index].run(_sceneContext, _renderContext);
+    lock.lock();
+    _status[index] = DONE;
+    queueReadyJobs();
+    _jobDone.notify_all();
+}
+
+void JobGraph::queueReadyJobs() {
+    for (size_t i = 0; i < _jobs.size(); ++i) {
+        if (_status[i] != WAITING || !_jobs[i].isConcurrent()) {
+            continue;
+        }
+        bool isReady = true;
+        for (auto producer : _producers[i]) {
+            if (_status[producer] != DONE) {
+                isReady = false;
+                break;
+            }
+        }
+        if (isReady) {
+            _status[i] = QUEUED;
+            getJobThreadPool()->start(new ConcurrentJobRunner(shared_from_this(), i));
+        }
+    }
+}
+
+void JobGraph::waitForJobs(const std::vector<size_t>& indices, std::unique_lock<std::mutex>& lock) {
+    while (true) {
+        bool isDone = true;
+        for (auto index : indices) {
+            if (_status[index] != DONE) {
+                isDone = false;
+                break;
+            }
+        }
+        if (isDone) {
+            return;
+        }
+
+        // rather than block, help with the queued jobs the pool hasn't started yet
+        auto queued = std::find(_status.begin(), _status.end(), QUEUED);
+        if (queued != _status.end()) {
+            runJob((size_t)(queued - _status.begin()), lock);
+        } else {
+            _jobDone.wait(lock);
+        }
+    }
+}
+
+void render::runJobs(const Jobs& jobs, const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
+    auto graph = std::make_shared<JobGraph>(jobs, sceneContext, renderContext);
+    graph->run();
+}
+
 
 
 
 
-void render::cullItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outItems) {
+void render::cullItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outItems,
+        RenderDetails::Type detailsType, const ItemOcclusion* occlusion) {
     assert(renderContext->args);
     assert(renderContext->args->_viewFrustum);
 
     RenderArgs* args = renderContext->args;
-    auto renderDetails = renderContext->args->_details._item;
+    auto renderDetails = &args->_details.getItem(detailsType);
 
     renderDetails->_considered += inItems.size();
     
-    // Culling / LOD
-    for (auto item : inItems) {
-        if (item.bounds.isNull()) {
-            outItems.emplace_back(item); // One more Item to render
-            continue;
+    // Culling / LOD, the items are tested against the frustum a batch at a time
+    const size_t BATCH_SIZE = RayIntersectionKernels::BOX_BATCH_SIZE;
+    RayIntersectionKernels::BoxBatch batch;
+    ViewFrustum::location locations[BATCH_SIZE];
+    for (size_t start = 0; start < inItems.size(); start += BATCH_SIZE) {
+        size_t end = std::min(start + BATCH_SIZE, inItems.size());
+        batch.clear();
+        for (size_t i = start; i < end; i++) {
+            const AABox& bounds = inItems[i].bounds;
+            batch.add(bounds.getMinimumPoint(), bounds.getMaximumPoint());
         }
-
-        // TODO: some entity types (like lights) might want to be rendered even
-        // when they are outside of the view frustum...
-        bool outOfView;
         {
             PerformanceTimer perfTimer("boxInFrustum");
-            outOfView = args->_viewFrustum->boxInFrustum(item.bounds) == ViewFrustum::OUTSIDE;
+            args->_viewFrustum->boxesInFrustum(batch, ViewFrustum::ALL_PLANES, locations);
         }
-        if (!outOfView) {
-            bool bigEnoughToRender;
-            {
-                PerformanceTimer perfTimer("shouldRender");
-                bigEnoughToRender = (args->_shouldRender) ? args->_shouldRender(args, item.bounds) : true;
-            }
-            if (bigEnoughToRender) {
+
+        for (size_t i = start; i < end; i++) {
+            const ItemIDAndBounds& item = inItems[i];
+            if (item.bounds.isNull()) {
                 outItems.emplace_back(item); // One more Item to render
+                continue;
+            }
+
+            // TODO: some entity types (like lights) might want to be rendered even
+            // when they are outside of the view frustum...
+            bool outOfView = locations[i - start] == ViewFrustum::OUTSIDE;
+            if (!outOfView) {
+                bool bigEnoughToRender;
+                {
+                    PerformanceTimer perfTimer("shouldRender");
+                    bigEnoughToRender = (args->_shouldRender) ? args->_shouldRender(args, item.bounds) : true;
+                }
+                if (!bigEnoughToRender) {
+                    renderDetails->_tooSmall++;
+                } else if (occlusion && occlusion->isOccluded(item.id)) {
+                    renderDetails->_occluded++;
+                } else {
+                    outItems.emplace_back(item); // One more Item to render
+                }
             } else {
-                renderDetails->_tooSmall++;
+                renderDetails->_outOfView++;
             }
-        } else {
-            renderDetails->_outOfView++;
         }
     }
     renderDetails->_rendered += outItems.size();
@@ -97,17 +260,30 @@ void render::cullItems(const SceneContextPointer& sceneContext, const RenderCont
 
 void FetchItems::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, ItemIDsBounds& outItems) {
     auto& scene = sceneContext->_scene;
-    auto& items = scene->getMasterBucket().at(_filter);
+    RenderArgs* args = renderContext->args;
 
     outItems.clear();
-    outItems.reserve(items.size());
-    for (auto id : items) {
-        auto& item = scene->getItem(id);
-        outItems.emplace_back(ItemIDAndBounds(id, item.getBound()));
+    int numTested = 0;
+    if (args && args->_viewFrustum) {
+        PerformanceTimer perfTimer("selectItems");
+        ViewFrustum* frustum = args->_viewFrustum;
+        ItemSpatialTree::Stats stats;
+        scene->getSpatialTree().select(_filter, [frustum] (const AABox& bound) {
+            return (ItemSpatialTree::Location)frustum->boxInFrustum(bound);
+        }, outItems, stats);
+        numTested = stats._numTestedCells + stats._numTestedItems;
+    } else {
+        auto& items = scene->getMasterBucket().at(_filter);
+        outItems.reserve(items.size());
+        for (auto id : items) {
+            auto& item = scene->getItem(id);
+            outItems.emplace_back(ItemIDAndBounds(id, item.getBound()));
+        }
+        numTested = (int)outItems.size();
     }
 
     if (_probeNumItems) {
-        _probeNumItems(renderContext, outItems.size());
+        _probeNumItems(renderContext, outItems.size(), numTested);
     }
 }
 
@@ -115,27 +291,26 @@ void CullItems::run(const SceneContextPointer& sceneContext, const RenderContext
 
     outItems.clear();
     outItems.reserve(inItems.size());
-    RenderArgs* args = renderContext->args;
-    args->_details.pointTo(RenderDetails::OTHER_ITEM);
-    cullItems(sceneContext, renderContext, inItems, outItems);
+    cullItems(sceneContext, renderContext, inItems, outItems, RenderDetails::OTHER_ITEM);
 }
 
 void CullItemsOpaque::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outItems) {
 
     outItems.clear();
     outItems.reserve(inItems.size());
-    RenderArgs* args = renderContext->args;
-    args->_details.pointTo(RenderDetails::OPAQUE_ITEM);
-    cullItems(sceneContext, renderContext, inItems, outItems);
+    // the occlusion of the items only holds for the main view
+    const ItemOcclusion* occlusion = nullptr;
+    if (renderContext->args->_renderMode == RenderArgs::DEFAULT_RENDER_MODE) {
+        occlusion = _occlusion.get();
+    }
+    cullItems(sceneContext, renderContext, inItems, outItems, RenderDetails::OPAQUE_ITEM, occlusion);
 }
 
 void CullItemsTransparent::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outItems) {
 
     outItems.clear();
     outItems.reserve(inItems.size());
-    RenderArgs* args = renderContext->args;
-    args->_details.pointTo(RenderDetails::TRANSLUCENT_ITEM);
-    cullItems(sceneContext, renderContext, inItems, outItems);
+    cullItems(sceneContext, renderContext, inItems, outItems, RenderDetails::TRANSLUCENT_ITEM);
 }
 
 
@@ -235,6 +410,205 @@ void render::renderItems(const SceneContextPointer& sceneContext, const RenderCo
     }
 }
 
+// Below this many items per batch, splitting the items costs more than it saves
+const size_t MIN_ITEMS_PER_BATCH = 64;
+
+// The batches of one call of renderItemsInBatches, shared with the runnables recording the concurrent chunks
+class ItemBatches {
+public:
+    class Chunk {
+    public:
+        size_t begin = 0;
+        size_t end = 0;
+        bool isConcurrent = false;
+        std::shared_ptr<gpu::Batch> batch;
+        int materialSwitches = 0;
+        int trianglesRendered = 0;
+    };
+
+    ItemBatches(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& items,
+        size_t numItems, const BatchSetup& setupBatch);
+
+    size_t getNumConcurrentChunks() const { return _concurrentChunks.size(); }
+
+    void recordSerialChunks();
+    void recordConcurrentChunks();
+    void waitForConcurrentChunks();
+    void render();
+
+private:
+    void addChunk(size_t begin, size_t end, bool isConcurrent);
+    void recordChunk(Chunk& chunk);
+
+    SceneContextPointer _sceneContext;
+    RenderContextPointer _renderContext;
+    const ItemIDsBounds& _items; // only read while chunks are left to record, which renderItemsInBatches waits for
+    BatchSetup _setupBatch;
+    RenderArgs _concurrentArgs; // copied before the calling thread starts using its args to record
+    std::vector<Chunk> _chunks;
+    std::vector<size_t> _concurrentChunks;
+    std::atomic<size_t> _nextConcurrentChunk;
+    size_t _numRecordedConcurrentChunks = 0;
+    std::mutex _mutex;
+    std::condition_variable _chunkRecorded;
+};
+
+class ItemBatchRecorder : public QRunnable {
+public:
+    ItemBatchRecorder(const std::shared_ptr<ItemBatches>& batches) : _batches(batches) {}
+
+    void run() { _batches->recordConcurrentChunks(); }
+
+private:
+    std::shared_ptr<ItemBatches> _batches;
+};
+
+ItemBatches::ItemBatches(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& items,
+        size_t numItems, const BatchSetup& setupBatch) :
+    _sceneContext(sceneContext),
+    _renderContext(renderContext),
+    _items(items),
+    _setupBatch(setupBatch),
+    _concurrentArgs(*renderContext->args),
+    _nextConcurrentChunk(0)
+{
+    _concurrentArgs._details = RenderDetails();
+
+    auto& scene = sceneContext->_scene;
+    std::vector<bool> canRenderConcurrently(numItems);
+    size_t numConcurrentItems = 0;
+    for (size_t i = 0; i < numItems; ++i) {
+        canRenderConcurrently[i] = scene->getItem(items[i].id).canRenderConcurrently();
+        if (canRenderConcurrently[i]) {
+            ++numConcurrentItems;
+        }
+    }
+
+    // one chunk per thread, including the calling one
+    size_t numThreads = (size_t)getJobThreadPool()->maxThreadCount() + 1;
+    size_t chunkSize = std::max(MIN_ITEMS_PER_BATCH, (numConcurrentItems + numThreads - 1) / numThreads);
+
+    // split the runs of items sharing the same thread requirement, keeping the order of the items
+    size_t begin = 0;
+    for (size_t i = 1; i <= numItems; ++i) {
+        bool isConcurrent = canRenderConcurrently[begin];
+        if (i == numItems || canRenderConcurrently[i] != isConcurrent || (isConcurrent && i - begin == chunkSize)) {
+            addChunk(begin, i, isConcurrent);
+            begin = i;
+        }
+    }
+}
+
+void ItemBatches::addChunk(size_t begin, size_t end, bool isConcurrent) {
+    Chunk chunk;
+    chunk.begin = begin;
+    chunk.end = end;
+    chunk.isConcurrent = isConcurrent;
+    if (isConcurrent) {
+        _concurrentChunks.push_back(_chunks.size());
+    }
+    _chunks.push_back(chunk);
+}
+
+void ItemBatches::recordChunk(Chunk& chunk) {
+    auto& scene = _sceneContext->_scene;
+    RenderArgs* args = _renderContext->args;
+
+    chunk.batch = std::make_shared<gpu::Batch>();
+    _setupBatch(*chunk.batch);
+
+    if (chunk.isConcurrent) {
+        // the worker threads record through their own copy of the args
+        RenderArgs chunkArgs(_concurrentArgs);
+        chunkArgs._batch = chunk.batch.get();
+        for (size_t i = chunk.begin; i < chunk.end; ++i) {
+            auto item = scene->getItem(_items[i].id);
+            item.render(&chunkArgs);
+        }
+        chunk.materialSwitches = chunkArgs._details._materialSwitches;
+        chunk.trianglesRendered = chunkArgs._details._trianglesRendered;
+    } else {
+        args->_batch = chunk.batch.get();
+        for (size_t i = chunk.begin; i < chunk.end; ++i) {
+            auto item = scene->getItem(_items[i].id);
+            item.render(args);
+        }
+        args->_batch = nullptr;
+    }
+}
+
+void ItemBatches::recordSerialChunks() {
+    for (auto& chunk : _chunks) {
+        if (!chunk.isConcurrent) {
+            recordChunk(chunk);
+        }
+    }
+}
+
+void ItemBatches::recordConcurrentChunks() {
+    size_t index;
+    while ((index = _nextConcurrentChunk++) < _concurrentChunks.size()) {
+        recordChunk(_chunks[_concurrentChunks[index]]);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        ++_numRecordedConcurrentChunks;
+        _chunkRecorded.notify_all();
+    }
+}
+
+void ItemBatches::waitForConcurrentChunks() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_numRecordedConcurrentChunks < _concurrentChunks.size()) {
+        _chunkRecorded.wait(lock);
+    }
+}
+
+void ItemBatches::render() {
+    RenderArgs* args = _renderContext->args;
+    for (auto& chunk : _chunks) {
+        args->_context->render(*chunk.batch);
+        args->_details._materialSwitches += chunk.materialSwitches;
+        args->_details._trianglesRendered += chunk.trianglesRendered;
+    }
+}
+
+void render::renderItemsInBatches(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems,
+        const BatchSetup& setupBatch, int maxDrawnItems) {
+    RenderArgs* args = renderContext->args;
+
+    // renderItems draws at least one item, whatever maxDrawnItems
+    size_t numItems = inItems.size();
+    if (maxDrawnItems >= 0) {
+        numItems = std::min(numItems, (size_t)std::max(maxDrawnItems, 1));
+    }
+
+    if (numItems < 2 * MIN_ITEMS_PER_BATCH) {
+        gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
+            args->_batch = &batch;
+            setupBatch(batch);
+            renderItems(sceneContext, renderContext, inItems, maxDrawnItems);
+            args->_batch = nullptr;
+        });
+        return;
+    }
+
+    auto batches = std::make_shared<ItemBatches>(sceneContext, renderContext, inItems, numItems, setupBatch);
+
+    // the calling thread records a share of the concurrent chunks too
+    size_t numWorkers = std::min((size_t)getJobThreadPool()->maxThreadCount(), batches->getNumConcurrentChunks());
+    if (numWorkers > 0) {
+        --numWorkers;
+    }
+    for (size_t i = 0; i < numWorkers; ++i) {
+        getJobThreadPool()->start(new ItemBatchRecorder(batches));
+    }
+
+    batches->recordSerialChunks();
+    batches->recordConcurrentChunks();
+    batches->waitForConcurrentChunks();
+    batches->render();
+}
+
 void DrawLight::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
     assert(renderContext->args);
     assert(renderContext->args->_viewFrustum);
@@ -254,8 +628,7 @@ void DrawLight::run(const SceneContextPointer& sceneContext, const RenderContext
     ItemIDsBounds culledItems;
     culledItems.reserve(inItems.size());
     RenderArgs* args = renderContext->args;
-    args->_details.pointTo(RenderDetails::OTHER_ITEM);
-    cullItems(sceneContext, renderContext, inItems, culledItems);
+    cullItems(sceneContext, renderContext, inItems, culledItems, RenderDetails::OTHER_ITEM);
 
     gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
         args->_batch = &batch;
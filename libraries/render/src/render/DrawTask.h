@@ -15,6 +15,7 @@
 #include "Engine.h"
 #include "gpu/Batch.h"
 #include <PerfStat.h>
+#include <Trace.h>
 
 
 namespace render {
@@ -80,12 +81,25 @@ public:
     bool isEnabled() const { return _concept->isEnabled(); }
     void setEnabled(bool isEnabled) { _concept->setEnabled(isEnabled); }
 
+    // A concurrent job runs on a worker thread as soon as the job producing its input is done, possibly ahead of
+    // the jobs before it in the list, so it may only touch its input, its output and state that is constant
+    // during the frame. Jobs recording gpu batches must stay on the render thread.
+    bool isConcurrent() const { return _concept->isConcurrent(); }
+    void setConcurrent(bool isConcurrent) { _concept->setConcurrent(isConcurrent); }
+
+    // True if the input of this job is the output of the producer
+    bool dependsOn(const Job& producer) const {
+        const Varying input = getInput();
+        return input._concept && input._concept == producer.getOutput()._concept;
+    }
+
     const std::string& getName() const { return _concept->getName(); }
     const Varying getInput() const { return _concept->getInput(); }
     const Varying getOutput() const { return _concept->getOutput(); }
 
     void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
         PerformanceTimer perfTimer(getName().c_str());
+        TRACE_ZONE_STRING(getName());
         PROFILE_RANGE(getName().c_str());
         _concept->run(sceneContext, renderContext);
     }
@@ -96,6 +110,7 @@ public:
     class Concept {
         std::string _name;
         bool _isEnabled = true;
+        bool _isConcurrent = false;
     public:
         Concept() : _name() {}
         Concept(const std::string& name) : _name(name) {}
@@ -107,6 +122,9 @@ public:
         bool isEnabled() const { return _isEnabled; }
         void setEnabled(bool isEnabled) { _isEnabled = isEnabled; }
 
+        bool isConcurrent() const { return _isConcurrent; }
+        void setConcurrent(bool isConcurrent) { _isConcurrent = isConcurrent; }
+
         virtual const Varying getInput() const { return Varying(); }
         virtual const Varying getOutput() const { return Varying(); }
         virtual void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) = 0;
@@ -143,7 +161,7 @@ public:
 
         const Varying getInput() const { return _input; }
 
-        ModelI(const std::string& name, const Varying& input): Concept(name), _input(input) {}
+        ModelI(const std::string& name, const Varying& input, Data data = Data()): Concept(name), _data(data), _input(input) {}
         ModelI(const std::string& name, Data data): Concept(name), _data(data) {}
 
         void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
@@ -209,14 +227,35 @@ public:
 
 typedef std::vector<Job> Jobs;
 
-void cullItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outITems);
+// Run the jobs in order on the calling thread, except for the concurrent ones which are scheduled on worker threads
+// following the dependencies between the Varyings. A job waits for the job producing its input, and all the jobs
+// are done when this returns.
+void runJobs(const Jobs& jobs, const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext);
+
+class ItemOcclusion;
+typedef std::shared_ptr<ItemOcclusion> ItemOcclusionPointer;
+
+// The items of occlusion, if any, that were hidden in the last frame get culled too
+void cullItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outITems,
+    RenderDetails::Type detailsType = RenderDetails::OTHER_ITEM, const ItemOcclusion* occlusion = nullptr);
 void depthSortItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, bool frontToBack, const ItemIDsBounds& inItems, ItemIDsBounds& outITems);
 void renderItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, int maxDrawnItems = -1);
 
+// Records the state every batch of renderItemsInBatches starts with, possibly on a worker thread
+typedef std::function<void (gpu::Batch& batch)> BatchSetup;
+
+// Render the items like renderItems, but in several batches: the items that can render concurrently are split in chunks
+// recorded in batches of their own on worker threads, the others are recorded on the calling thread. The batches all
+// start with setupBatch and are rendered in the order of the items.
+void renderItemsInBatches(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems,
+    const BatchSetup& setupBatch, int maxDrawnItems = -1);
+
 
+// Fetch the items of the filter in the view frustum from the spatial tree of the scene, numTested counts the cells and
+// items whose bound got tested
 class FetchItems {
 public:
-    typedef std::function<void (const RenderContextPointer& context, int count)> ProbeNumItems;
+    typedef std::function<void (const RenderContextPointer& context, int count, int numTested)> ProbeNumItems;
     FetchItems(const ProbeNumItems& probe): _probeNumItems(probe) {}
     FetchItems(const ItemFilter& filter, const ProbeNumItems& probe): _filter(filter), _probeNumItems(probe) {}
 
@@ -236,6 +275,11 @@ public:
 
 class CullItemsOpaque {
 public:
+    CullItemsOpaque() {}
+    CullItemsOpaque(const ItemOcclusionPointer& occlusion) : _occlusion(occlusion) {}
+
+    ItemOcclusionPointer _occlusion;
+
     void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outItems);
     typedef Job::ModelIO<CullItemsOpaque, ItemIDsBounds, ItemIDsBounds> JobModel;
 };
@@ -38,10 +38,12 @@ public:
     bool _renderTransparent = true;
 
     int _numFeedOpaqueItems = 0;
+    int _numTestedOpaqueItems = 0;
     int _numDrawnOpaqueItems = 0;
     int _maxDrawnOpaqueItems = -1;
     
     int _numFeedTransparentItems = 0;
+    int _numTestedTransparentItems = 0;
     int _numDrawnTransparentItems = 0;
     int _maxDrawnTransparentItems = -1;
 
@@ -53,6 +55,8 @@ public:
     bool _drawHitEffect = false;
 
     bool _occlusionStatus = false;
+    int _occlusionResolutionLevel = 0; // the occlusion is computed at the resolution divided by 2 to the level
+    bool _occlusionTemporal = false; // the occlusion is accumulated over the frames
     bool _fxaaStatus = false;
 
     RenderContext() {}
@@ -0,0 +1,155 @@
+//
+//  OcclusionCulling.cpp
+//  render/src/render
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OcclusionCulling.h"
+
+#include <assert.h>
+
+#include <PerfStat.h>
+#include <ViewFrustum.h>
+#include <RenderArgs.h>
+
+#include <gpu/Context.h>
+
+#include "drawOcclusionBounds_vert.h"
+#include "drawOcclusionBounds_frag.h"
+
+using namespace render;
+
+// the bounds get pushed out a little, so that the surfaces lying on them don't hide their own item
+const float BOUND_EXPANSION = 0.01f;
+const float MIN_BOUND_EXPANSION = 0.01f; // meters
+
+// the near plane clips the bounds the camera is about to enter, those can't tell if the item is hidden
+const float NEAR_CLIP_EXPANSION = 2.0f;
+
+// the entries of the items that go untested for that many frames get dropped along with their query
+const int MAX_UNTESTED_FRAMES = 60;
+
+const int NUM_BOUND_VERTICES = 36;
+
+bool ItemOcclusion::isOccluded(ItemID id) const {
+    auto entry = _entries.find(id);
+    return entry != _entries.end() && entry->second.isOccluded && entry->second.testedFrame == _frame;
+}
+
+const gpu::PipelinePointer& TestOcclusion::getPipeline() {
+    if (!_pipeline) {
+        auto vs = gpu::ShaderPointer(gpu::Shader::createVertex(std::string(drawOcclusionBounds_vert)));
+        auto ps = gpu::ShaderPointer(gpu::Shader::createPixel(std::string(drawOcclusionBounds_frag)));
+        gpu::ShaderPointer program = gpu::ShaderPointer(gpu::Shader::createProgram(vs, ps));
+
+        gpu::Shader::BindingSet slotBindings;
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        _boundPosLoc = program->getUniforms().findLocation("inBoundPos");
+        _boundDimLoc = program->getUniforms().findLocation("inBoundDim");
+
+        auto state = std::make_shared<gpu::State>();
+
+        // test against the depth of the opaque items without touching it or the color
+        state->setDepthTest(true, false, gpu::LESS_EQUAL);
+        state->setCullMode(gpu::State::CULL_NONE);
+        state->setColorWriteMask(false, false, false, false);
+
+        _pipeline.reset(gpu::Pipeline::create(program, state));
+    }
+    return _pipeline;
+}
+
+void TestOcclusion::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems) {
+    assert(renderContext->args);
+    assert(renderContext->args->_viewFrustum);
+    RenderArgs* args = renderContext->args;
+
+    // the mirror and the shadows look from elsewhere, their depth says nothing about the main view
+    if (!_occlusion || args->_renderMode != RenderArgs::DEFAULT_RENDER_MODE) {
+        return;
+    }
+
+    auto& entries = _occlusion->_entries;
+    int frame = ++_occlusion->_frame;
+
+    const glm::vec3& eye = args->_viewFrustum->getPosition();
+    float nearExpansion = NEAR_CLIP_EXPANSION * args->_viewFrustum->getNearClip();
+
+    // the queried items and their expanded bounds
+    std::vector<ItemOcclusion::Entry*> testedEntries;
+    std::vector<AABox> testedBounds;
+    testedEntries.reserve(inItems.size());
+    testedBounds.reserve(inItems.size());
+    for (auto& item : inItems) {
+        if (item.bounds.isNull() || item.bounds.isInvalid()) {
+            continue;
+        }
+        auto& entry = entries[item.id];
+        entry.testedFrame = frame;
+
+        glm::vec3 expansion = BOUND_EXPANSION * item.bounds.getDimensions() + glm::vec3(MIN_BOUND_EXPANSION);
+        AABox bounds(item.bounds.getCorner() - expansion, item.bounds.getDimensions() + 2.0f * expansion);
+        if (bounds.expandedContains(eye, nearExpansion) ||
+                args->_viewFrustum->boxInFrustum(bounds) == ViewFrustum::OUTSIDE) {
+            entry.isOccluded = false;
+            continue;
+        }
+        if (!entry.query) {
+            entry.query = std::make_shared<gpu::Query>(gpu::Query::ANY_SAMPLES_PASSED);
+        }
+        entry.query->isResultReady = false;
+        testedEntries.push_back(&entry);
+        testedBounds.push_back(bounds);
+    }
+
+    if (!testedEntries.empty()) {
+        gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+            glm::mat4 projMat;
+            Transform viewMat;
+            args->_viewFrustum->evalProjectionMatrix(projMat);
+            args->_viewFrustum->evalViewTransform(viewMat);
+
+            batch.setViewportTransform(args->_viewport);
+            batch.setProjectionTransform(projMat);
+            batch.setViewTransform(viewMat);
+            batch.setModelTransform(Transform());
+
+            batch.setPipeline(getPipeline());
+
+            const unsigned int VEC3_ADRESS_OFFSET = 3;
+            for (size_t i = 0; i < testedEntries.size(); i++) {
+                const gpu::QueryPointer& query = testedEntries[i]->query;
+
+                // pick up the result of the frame before, if the gpu is done with it, before reusing the query
+                batch.getQuery(query);
+
+                batch._glUniform3fv(_boundPosLoc, 1, (const float*) &testedBounds[i]);
+                batch._glUniform3fv(_boundDimLoc, 1, ((const float*) &testedBounds[i]) + VEC3_ADRESS_OFFSET);
+
+                batch.beginQuery(query);
+                batch.draw(gpu::TRIANGLES, NUM_BOUND_VERTICES, 0);
+                batch.endQuery(query);
+            }
+        });
+    }
+
+    // the results still in flight leave the items as they were
+    for (auto entry : testedEntries) {
+        if (entry->query->isResultReady) {
+            entry->isOccluded = (entry->query->queryResult == 0);
+        }
+    }
+
+    for (auto entry = entries.begin(); entry != entries.end();) {
+        if (frame - entry->second.testedFrame > MAX_UNTESTED_FRAMES) {
+            entry = entries.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+}
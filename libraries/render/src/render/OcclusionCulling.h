@@ -0,0 +1,65 @@
+//
+//  OcclusionCulling.h
+//  render/src/render
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_OcclusionCulling_h
+#define hifi_render_OcclusionCulling_h
+
+#include <unordered_map>
+
+#include "DrawTask.h"
+#include "gpu/Batch.h"
+
+namespace render {
+
+// The opaque items whose bounds were hidden by the depth of the opaque items in the last frame a query came back for
+class ItemOcclusion {
+public:
+    // Only an item tested in the last frame, with no sample of its bounds passing, is occluded
+    bool isOccluded(ItemID id) const;
+
+protected:
+    friend class TestOcclusion;
+
+    class Entry {
+    public:
+        gpu::QueryPointer query;
+        int testedFrame { -1 };
+        bool isOccluded { false };
+    };
+
+    std::unordered_map<ItemID, Entry> _entries;
+    int _frame { 0 };
+};
+typedef std::shared_ptr<ItemOcclusion> ItemOcclusionPointer;
+
+// Draws the bounds of the items against the depth of the framebuffer bound, with an occlusion query each, and reads
+// the queries of the frame before back into the ItemOcclusion. The results only get read once the gpu made them
+// available, so CullItemsOpaque sees them a frame later.
+class TestOcclusion {
+    int _boundPosLoc = -1;
+    int _boundDimLoc = -1;
+
+    gpu::PipelinePointer _pipeline;
+    ItemOcclusionPointer _occlusion;
+
+public:
+    TestOcclusion() {}
+    TestOcclusion(const ItemOcclusionPointer& occlusion) : _occlusion(occlusion) {}
+
+    void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems);
+
+    typedef Job::ModelI<TestOcclusion, ItemIDsBounds> JobModel;
+
+    const gpu::PipelinePointer& getPipeline();
+};
+
+}
+
+#endif // hifi_render_OcclusionCulling_h
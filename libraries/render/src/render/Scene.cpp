@@ -56,6 +56,173 @@ void ItemBucketMap::allocateStandardOpaqueTranparentBuckets() {
     (*this)[ItemFilter::Builder::transparentShape().withLayered()];
 }
 
+// The tree spans the domain, TREE_SCALE meters centered on the origin
+const float SPATIAL_TREE_SCALE = 32768.0f;
+// Down to cells of a meter
+const int MAX_SPATIAL_TREE_DEPTH = 15;
+
+ItemSpatialTree::ItemSpatialTree() {
+    Cell root;
+    root._corner = glm::vec3(-0.5f * SPATIAL_TREE_SCALE);
+    root._size = SPATIAL_TREE_SCALE;
+    _cells.push_back(root);
+}
+
+int ItemSpatialTree::findCell(const AABox& bound) {
+    if (bound.isNull()) {
+        return OUTSIDE_CELL;
+    }
+    glm::vec3 center = bound.calcCenter();
+    float size = bound.getLargestDimension();
+    glm::vec3 offset = center - _cells[0]._corner;
+    if (size > SPATIAL_TREE_SCALE || glm::any(glm::lessThan(offset, glm::vec3(0.0f))) ||
+            glm::any(glm::greaterThanEqual(offset, glm::vec3(SPATIAL_TREE_SCALE)))) {
+        return OUTSIDE_CELL;
+    }
+
+    // go down to the smallest cell the item fits in, creating the cells on the way
+    int index = 0;
+    for (int depth = 0; depth < MAX_SPATIAL_TREE_DEPTH; depth++) {
+        float childSize = 0.5f * _cells[index]._size;
+        if (size > childSize) {
+            break;
+        }
+        offset = center - _cells[index]._corner;
+        int octant = (offset.x >= childSize ? 1 : 0) | (offset.y >= childSize ? 2 : 0) | (offset.z >= childSize ? 4 : 0);
+        int child = _cells[index]._children[octant];
+        if (child == NO_CELL) {
+            Cell cell;
+            cell._corner = _cells[index]._corner + childSize * glm::vec3(octant & 1 ? 1.0f : 0.0f, octant & 2 ? 1.0f : 0.0f,
+                octant & 4 ? 1.0f : 0.0f);
+            cell._size = childSize;
+            cell._parent = index;
+            if (_freeCells.empty()) {
+                child = (int)_cells.size();
+                _cells.push_back(cell);
+            } else {
+                child = _freeCells.back();
+                _freeCells.pop_back();
+                _cells[child] = cell;
+            }
+            _cells[index]._children[octant] = child;
+        }
+        index = child;
+    }
+    return index;
+}
+
+void ItemSpatialTree::addToCell(ItemID id, int index) {
+    Entry& entry = _entries[id];
+    Cell& cell = getCell(index);
+    entry._cell = index;
+    entry._slot = cell._items.size();
+    cell._items.push_back(id);
+    for (int i = index; i >= 0; i = _cells[i]._parent) {
+        _cells[i]._numSubtreeItems++;
+    }
+}
+
+void ItemSpatialTree::removeFromCell(ItemID id) {
+    Entry& entry = _entries[id];
+    Cell& cell = getCell(entry._cell);
+    ItemID lastID = cell._items.back();
+    cell._items[entry._slot] = lastID;
+    _entries[lastID]._slot = entry._slot;
+    cell._items.pop_back();
+    for (int i = entry._cell; i >= 0; i = _cells[i]._parent) {
+        _cells[i]._numSubtreeItems--;
+    }
+    entry._cell = NO_CELL;
+}
+
+void ItemSpatialTree::pruneCells(int index) {
+    // the cells left without items below them go back to the free list, the root and the outside cell stay
+    while (index > 0 && _cells[index]._numSubtreeItems == 0) {
+        Cell& cell = _cells[index];
+        int* children = _cells[cell._parent]._children;
+        *std::find(children, children + 8, index) = NO_CELL;
+        _freeCells.push_back(index);
+        index = cell._parent;
+        cell._items.clear();
+    }
+}
+
+void ItemSpatialTree::insert(ItemID id, const ItemKey& key, const AABox& bound) {
+    if (id >= _entries.size()) {
+        _entries.resize(id + 1);
+    }
+    int index = findCell(bound);
+    Entry& entry = _entries[id];
+    if (entry._cell != index) {
+        int oldIndex = entry._cell;
+        if (oldIndex == NO_CELL) {
+            _numItems++;
+        } else {
+            removeFromCell(id);
+        }
+        addToCell(id, index);
+        // pruned only now, the new cell may be a fresh child of the old one
+        pruneCells(oldIndex);
+    }
+    entry._key = key;
+    entry._bound = bound;
+}
+
+void ItemSpatialTree::erase(ItemID id) {
+    if (contains(id)) {
+        int index = _entries[id]._cell;
+        removeFromCell(id);
+        pruneCells(index);
+        _numItems--;
+    }
+}
+
+void ItemSpatialTree::select(const ItemFilter& filter, const BoundTest& test, ItemIDsBounds& outItems, Stats& stats) const {
+    size_t numItems = outItems.size();
+    selectItems(_outsideCell, false, filter, test, outItems, stats);
+    selectCell(0, false, filter, test, outItems, stats);
+    stats._numSelectedItems += (int)(outItems.size() - numItems);
+}
+
+void ItemSpatialTree::selectItems(const Cell& cell, bool isInside, const ItemFilter& filter, const BoundTest& test,
+        ItemIDsBounds& outItems, Stats& stats) const {
+    for (auto id : cell._items) {
+        const Entry& entry = _entries[id];
+        if (!filter.test(entry._key)) {
+            continue;
+        }
+        if (!isInside && !entry._bound.isNull()) {
+            stats._numTestedItems++;
+            if (test(entry._bound) == OUTSIDE) {
+                continue;
+            }
+        }
+        outItems.emplace_back(ItemIDAndBounds(id, entry._bound));
+    }
+}
+
+void ItemSpatialTree::selectCell(int index, bool isInside, const ItemFilter& filter, const BoundTest& test,
+        ItemIDsBounds& outItems, Stats& stats) const {
+    const Cell& cell = _cells[index];
+    if (cell._numSubtreeItems == 0) {
+        return;
+    }
+    if (!isInside) {
+        stats._numTestedCells++;
+        Location location = test(cell.getLooseBound());
+        if (location == OUTSIDE) {
+            return;
+        }
+        isInside = (location == INSIDE);
+    }
+    selectItems(cell, isInside, filter, test, outItems, stats);
+    for (auto child : cell._children) {
+        if (child != NO_CELL) {
+            selectCell(child, isInside, filter, test, outItems, stats);
+        }
+    }
+}
+
 const Item::Status::Value Item::Status::Value::INVALID = Item::Status::Value();
 
 const float Item::Status::Value::RED = 0.0f;
@@ -186,6 +353,7 @@ void Scene::processPendingChangesQueue() {
         resetItems(consolidatedPendingChanges._resetItems, consolidatedPendingChanges._resetPayloads);
         updateItems(consolidatedPendingChanges._updatedItems, consolidatedPendingChanges._updateFunctors);
         removeItems(consolidatedPendingChanges._removedItems);
+        updateSpatialTree();
 
      // ready to go back to rendering activities
     _itemsMutex.unlock();
@@ -200,6 +368,11 @@ void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
         item.resetPayload(*resetPayload);
 
         _masterBucketMap.reset((*resetID), oldKey, item.getKey());
+        if (item._payload) {
+            _spatialTree.insert((*resetID), item.getKey(), item.getBound());
+        } else {
+            _spatialTree.erase(*resetID);
+        }
     }
 
 }
@@ -207,6 +380,7 @@ void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
 void Scene::removeItems(const ItemIDs& ids) {
     for (auto removedID :ids) {
         _masterBucketMap.erase(removedID, _items[removedID].getKey());
+        _spatialTree.erase(removedID);
         _items[removedID].kill();
     }
 }
@@ -218,3 +392,25 @@ void Scene::updateItems(const ItemIDs& ids, UpdateFunctors& functors) {
         _items[(*updateID)].update((*updateFunctor));
     }
 }
+
+void Scene::updateSpatialTree() {
+    PROFILE_RANGE(__FUNCTION__);
+    // Most items move without telling the scene, so all the bounds get refreshed. An item only changes cell once it
+    // leaves the region of its cell.
+    // The items that moved, or were dynamic last frame, get their key again too, so that an item starting or stopping
+    // to move goes between the static and the dynamic buckets, for the passes that keep what the static items draw.
+    for (ItemID id = 1; id < (ItemID)_items.size(); id++) {
+        if (_spatialTree.contains(id)) {
+            auto& item = _items[id];
+            auto bound = item.getBound();
+            if (item._key.isDynamic() || !(bound == _spatialTree.getBound(id))) {
+                auto oldKey = item._key;
+                item._key = item._payload->getKey();
+                if (item._key._flags != oldKey._flags) {
+                    _masterBucketMap.reset(id, oldKey, item._key);
+                }
+            }
+            _spatialTree.insert(id, item.getKey(), bound);
+        }
+    }
+}
@@ -12,8 +12,10 @@
 #ifndef hifi_render_Scene_h
 #define hifi_render_Scene_h
 
+#include <algorithm>
 #include <atomic>
 #include <bitset>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -257,6 +259,10 @@ public:
 
         virtual void render(RenderArgs* args) = 0;
 
+        // True if render only records into args->_batch and reads state that doesn't change during the frame,
+        // so that the item can be recorded on a worker thread alongside other items
+        virtual bool canRenderConcurrently() const = 0;
+
         virtual const model::MaterialKey getMaterialKey() const = 0;
 
         ~PayloadInterface() {}
@@ -295,6 +301,7 @@ public:
 
     // Render call for the item
     void render(RenderArgs* args) { _payload->render(args); }
+    bool canRenderConcurrently() const { return _payload && _payload->canRenderConcurrently(); }
 
     // Shape Type Interface
     const model::MaterialKey getMaterialKey() const { return _payload->getMaterialKey(); }
@@ -338,6 +345,7 @@ template <class T> const ItemKey payloadGetKey(const std::shared_ptr<T>& payload
 template <class T> const Item::Bound payloadGetBound(const std::shared_ptr<T>& payloadData) { return Item::Bound(); }
 template <class T> int payloadGetLayer(const std::shared_ptr<T>& payloadData) { return 0; }
 template <class T> void payloadRender(const std::shared_ptr<T>& payloadData, RenderArgs* args) { }
+template <class T> bool payloadCanRenderConcurrently(const std::shared_ptr<T>& payloadData) { return false; }
     
 // Shape type interface
 template <class T> const model::MaterialKey shapeGetMaterialKey(const std::shared_ptr<T>& payloadData) { return model::MaterialKey(); }
@@ -356,6 +364,7 @@ public:
 
 
     virtual void render(RenderArgs* args) { payloadRender<T>(_data, args); } 
+    virtual bool canRenderConcurrently() const { return payloadCanRenderConcurrently<T>(_data); }
 
     // Shape Type interface
     virtual const model::MaterialKey getMaterialKey() const { return shapeGetMaterialKey<T>(_data); }
@@ -437,6 +446,86 @@ public:
     
 };
 
+// A loose octree of the bounds of the items, to select the items in view without testing them one by one.
+// A cell holds the items whose center is in its region and which are no larger than the region, and its loose bound,
+// twice the size of the region, contains them whole. The items with a null bound or outside of the tree are kept aside
+// and always tested.
+class ItemSpatialTree {
+public:
+    // In the order of ViewFrustum::location
+    enum Location {
+        OUTSIDE = 0,
+        INTERSECT,
+        INSIDE,
+    };
+    typedef std::function<Location (const AABox& bound)> BoundTest;
+
+    // The bound tests a selection did and what it selected
+    class Stats {
+    public:
+        int _numTestedCells = 0;
+        int _numTestedItems = 0;
+        int _numSelectedItems = 0;
+    };
+
+    ItemSpatialTree();
+
+    // Insert the item, or move it if it is in the tree already
+    void insert(ItemID id, const ItemKey& key, const AABox& bound);
+    void erase(ItemID id);
+    bool contains(ItemID id) const { return id < _entries.size() && _entries[id]._cell != NO_CELL; }
+    const AABox& getBound(ItemID id) const { return _entries[id]._bound; }
+
+    // Select the items passing the filter whose bound the test doesn't find OUTSIDE, the items with a null bound always
+    // pass. The cells found INSIDE have all their items selected without testing them.
+    void select(const ItemFilter& filter, const BoundTest& test, ItemIDsBounds& outItems, Stats& stats) const;
+
+    size_t getNumItems() const { return _numItems; }
+    size_t getNumCells() const { return _cells.size() - _freeCells.size(); }
+
+private:
+    static const int NO_CELL = -1;
+    static const int OUTSIDE_CELL = -2;
+
+    class Cell {
+    public:
+        glm::vec3 _corner; // of the region
+        float _size = 0.0f; // of the region
+        int _parent = NO_CELL;
+        int _children[8];
+        ItemIDs _items;
+        int _numSubtreeItems = 0;
+
+        Cell() { std::fill(_children, _children + 8, (int)NO_CELL); }
+
+        AABox getLooseBound() const { return AABox(_corner - glm::vec3(0.5f * _size), 2.0f * _size); }
+    };
+
+    class Entry {
+    public:
+        int _cell = NO_CELL;
+        size_t _slot = 0; // in the items of the cell
+        ItemKey _key;
+        AABox _bound;
+    };
+
+    Cell& getCell(int index) { return (index == OUTSIDE_CELL) ? _outsideCell : _cells[index]; }
+    int findCell(const AABox& bound);
+    void addToCell(ItemID id, int index);
+    void removeFromCell(ItemID id);
+    void pruneCells(int index);
+    void selectItems(const Cell& cell, bool isInside, const ItemFilter& filter, const BoundTest& test,
+        ItemIDsBounds& outItems, Stats& stats) const;
+    void selectCell(int index, bool isInside, const ItemFilter& filter, const BoundTest& test,
+        ItemIDsBounds& outItems, Stats& stats) const;
+
+    std::vector<Cell> _cells; // the root first
+    std::vector<int> _freeCells; // the cells pruned off the tree, to reuse
+    Cell _outsideCell;
+    std::vector<Entry> _entries; // indexed by ItemID
+    size_t _numItems = 0;
+};
+
 class Engine;
 
 class PendingChanges {
@@ -485,6 +574,9 @@ public:
     /// Access the main bucketmap of items
     const ItemBucketMap& getMasterBucket() const { return _masterBucketMap; }
 
+    /// Access the spatial tree of the items, with their bounds as of the last processPendingChangesQueue
+    const ItemSpatialTree& getSpatialTree() const { return _spatialTree; }
+
     /// Access a particular item form its ID
     /// WARNING, There is No check on the validity of the ID, so this could return a bad Item
     const Item& getItem(const ItemID& id) const { return _items[id]; }
@@ -505,10 +597,12 @@ protected:
     std::mutex _itemsMutex;
     Item::Vector _items;
     ItemBucketMap _masterBucketMap;
+    ItemSpatialTree _spatialTree;
 
     void resetItems(const ItemIDs& ids, Payloads& payloads);
     void removeItems(const ItemIDs& ids);
     void updateItems(const ItemIDs& ids, UpdateFunctors& functors);
+    void updateSpatialTree();
 
     friend class Engine;
 };
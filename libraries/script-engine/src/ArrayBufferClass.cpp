@@ -73,6 +73,7 @@ QScriptValue ArrayBufferClass::newInstance(qint32 size) {
     }
     
     engine()->reportAdditionalMemoryCost(size);
+    _allocatedBytes += size;
     QScriptEngine* eng = engine();
     QVariant variant = QVariant::fromValue(QByteArray(size, 0));
     QScriptValue data =  eng->newVariant(variant);
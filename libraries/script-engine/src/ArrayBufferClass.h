@@ -41,6 +41,9 @@ public:
     QScriptValue prototype() const;
     
     ScriptEngine* getEngine() { return _scriptEngine; }
+
+    // the bytes of the buffers the script has made, which are reported to the engine as memory it doesn't see
+    quint64 getAllocatedBytes() const { return _allocatedBytes; }
     
 private:
     static QScriptValue construct(QScriptContext* context, QScriptEngine* engine);
@@ -56,6 +59,7 @@ private:
     QScriptString _byteLength;
     
     ScriptEngine* _scriptEngine;
+    quint64 _allocatedBytes { 0 };
 };
 
 #endif // hifi_ArrayBufferClass_h
\ No newline at end of file
@@ -46,7 +46,7 @@ ScriptAudioInjector* AudioScriptingInterface::playSound(Sound* sound, const Audi
         AudioInjectorOptions optionsCopy = injectorOptions;
         optionsCopy.stereo = sound->isStereo();
 
-        return new ScriptAudioInjector(AudioInjector::playSound(sound->getByteArray(), optionsCopy, _localAudioInterface));
+        return new ScriptAudioInjector(AudioInjector::playSound(sound->getAudioData(), optionsCopy, _localAudioInterface));
 
     } else {
         qCDebug(scriptengine) << "AudioScriptingInterface::playSound called with null Sound object.";
@@ -54,6 +54,27 @@ ScriptAudioInjector* AudioScriptingInterface::playSound(Sound* sound, const Audi
     }
 }
 
+ScriptAudioInjector* AudioScriptingInterface::playSamples(const QByteArray& samples,
+                                                          const AudioInjectorOptions& injectorOptions) {
+    if (QThread::currentThread() != thread()) {
+        ScriptAudioInjector* injector = NULL;
+
+        QMetaObject::invokeMethod(this, "playSamples", Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(ScriptAudioInjector*, injector),
+                                  Q_ARG(const QByteArray&, samples), Q_ARG(const AudioInjectorOptions&, injectorOptions));
+        return injector;
+    }
+
+    if (samples.isEmpty()) {
+        qCDebug(scriptengine) << "AudioScriptingInterface::playSamples called with no samples.";
+        return NULL;
+    }
+
+    AudioInjectorOptions optionsCopy = injectorOptions;
+    optionsCopy.stereo = false;
+    return new ScriptAudioInjector(AudioInjector::playSound(SoundData(samples), optionsCopy, _localAudioInterface));
+}
+
 void AudioScriptingInterface::injectGeneratedNoise(bool inject) {
     if (_localAudioInterface) {
         _localAudioInterface->enableAudioSourceInject(inject);
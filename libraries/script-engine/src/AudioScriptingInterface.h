@@ -29,6 +29,10 @@ protected:
     // this method is protected to stop C++ callers from calling, but invokable from script
     Q_INVOKABLE ScriptAudioInjector* playSound(Sound* sound, const AudioInjectorOptions& injectorOptions = AudioInjectorOptions());
 
+    // plays mono network samples from an ArrayBuffer, which the injector shares rather than copies
+    Q_INVOKABLE ScriptAudioInjector* playSamples(const QByteArray& samples,
+                                                 const AudioInjectorOptions& injectorOptions = AudioInjectorOptions());
+
     Q_INVOKABLE void injectGeneratedNoise(bool inject);
     Q_INVOKABLE void selectPinkNoise();
     Q_INVOKABLE void selectSine440();
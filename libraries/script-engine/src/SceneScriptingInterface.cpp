@@ -161,8 +161,10 @@ void SceneScriptingInterface::setEngineSortTransparent(bool sortTransparent) {
 
 void SceneScriptingInterface::clearEngineCounters() {
     _numFeedOpaqueItems = 0;
+    _numTestedOpaqueItems = 0;
     _numDrawnOpaqueItems = 0;
     _numFeedTransparentItems = 0;
+    _numTestedTransparentItems = 0;
     _numDrawnTransparentItems = 0;
     _numFeedOverlay3DItems = 0;
     _numDrawnOverlay3DItems = 0;
@@ -100,6 +100,12 @@ public:
     void setEngineFeedOverlay3DItems(int count) { _numFeedOverlay3DItems = count; }
     Q_INVOKABLE int getEngineNumFeedOverlay3DItems() { return _numFeedOverlay3DItems; }
 
+    // The bound tests of the cells and items the fetch did to find the items feeding the engine
+    void setEngineTestedOpaqueItems(int count) { _numTestedOpaqueItems = count; }
+    Q_INVOKABLE int getEngineNumTestedOpaqueItems() { return _numTestedOpaqueItems; }
+    void setEngineTestedTransparentItems(int count) { _numTestedTransparentItems = count; }
+    Q_INVOKABLE int getEngineNumTestedTransparentItems() { return _numTestedTransparentItems; }
+
     Q_INVOKABLE void setEngineMaxDrawnOpaqueItems(int count) { _maxDrawnOpaqueItems = count; }
     Q_INVOKABLE int getEngineMaxDrawnOpaqueItems() { return _maxDrawnOpaqueItems; }
     Q_INVOKABLE void setEngineMaxDrawnTransparentItems(int count) { _maxDrawnTransparentItems = count; }
@@ -113,6 +119,13 @@ public:
     Q_INVOKABLE void setEngineDisplayHitEffect(bool display) { _drawHitEffect = display; }
     Q_INVOKABLE bool doEngineDisplayHitEffect() { return _drawHitEffect; }
 
+    // 0 computes the ambient occlusion at full resolution, 1 at half and 2 at quarter resolution
+    Q_INVOKABLE void setEngineOcclusionResolutionLevel(int level) { _occlusionResolutionLevel = level; }
+    Q_INVOKABLE int getEngineOcclusionResolutionLevel() { return _occlusionResolutionLevel; }
+
+    Q_INVOKABLE void setEngineOcclusionTemporal(bool temporal) { _occlusionTemporal = temporal; }
+    Q_INVOKABLE bool doEngineOcclusionTemporal() { return _occlusionTemporal; }
+
 signals:
     void shouldRenderAvatarsChanged(bool shouldRenderAvatars);
     void shouldRenderEntitiesChanged(bool shouldRenderEntities);
@@ -133,8 +146,10 @@ protected:
     bool _engineSortTransparent = true;
 
     int _numFeedOpaqueItems = 0;
+    int _numTestedOpaqueItems = 0;
     int _numDrawnOpaqueItems = 0;
     int _numFeedTransparentItems = 0;
+    int _numTestedTransparentItems = 0;
     int _numDrawnTransparentItems = 0;
     int _numFeedOverlay3DItems = 0;
     int _numDrawnOverlay3DItems = 0;
@@ -147,6 +162,9 @@ protected:
     
     bool _drawHitEffect = false;
 
+    int _occlusionResolutionLevel = 0;
+    bool _occlusionTemporal = false;
+
 };
 
 #endif // hifi_SceneScriptingInterface_h
@@ -29,6 +29,9 @@ ScriptCache::ScriptCache(QObject* parent) {
 
 void ScriptCache::clearCache() {
     _scriptCache.clear();
+
+    QMutexLocker locker(&_programsMutex);
+    _programs.clear();
 }
 
 QString ScriptCache::getScript(const QUrl& unnormalizedURL, ScriptUser* scriptUser, bool& isPending, bool reload) {
@@ -123,6 +126,28 @@ void ScriptCache::getScriptContents(const QString& scriptOrURL, contentAvailable
     }
 }
 
+QScriptProgram ScriptCache::getProgram(const QString& scriptOrURL, const QString& contents, const QString& fileName,
+                                       bool& isChecked) {
+    QMutexLocker locker(&_programsMutex);
+    auto cached = _programs.find(scriptOrURL);
+    if (cached == _programs.end() || cached->program.sourceCode() != contents || cached->program.fileName() != fileName) {
+        // the script is new or was downloaded again
+        CachedProgram newProgram;
+        newProgram.program = QScriptProgram(contents, fileName);
+        cached = _programs.insert(scriptOrURL, newProgram);
+    }
+    isChecked = cached->isChecked;
+    return cached->program;
+}
+
+void ScriptCache::setProgramChecked(const QString& scriptOrURL, const QScriptProgram& program) {
+    QMutexLocker locker(&_programsMutex);
+    auto cached = _programs.find(scriptOrURL);
+    if (cached != _programs.end() && cached->program == program) {
+        cached->isChecked = true;
+    }
+}
+
 void ScriptCache::scriptContentAvailable() {
     #ifdef THREAD_DEBUGGING
     qCDebug(scriptengine) << "ScriptCache::scriptContentAvailable() on thread [" << QThread::currentThread() << "] expected thread [" << thread() << "]";
@@ -12,6 +12,9 @@
 #ifndef hifi_ScriptCache_h
 #define hifi_ScriptCache_h
 
+#include <QtCore/QMutex>
+#include <QtScript/QScriptProgram>
+
 #include <ResourceCache.h>
 
 class ScriptUser {
@@ -38,6 +41,12 @@ public:
     // FIXME - how do we remove a script from the bad script list in the case of a redownload?
     void addScriptToBadScriptList(const QUrl& url) { _badScripts.insert(url); }
     bool isInBadScriptList(const QUrl& url) { return _badScripts.contains(url); }
+
+    // the program of the contents of an entity script, shared by all the entities that use it so that it is only
+    // compiled once, isChecked is whether it was already found to evaluate to a constructor
+    QScriptProgram getProgram(const QString& scriptOrURL, const QString& contents, const QString& fileName,
+                              bool& isChecked);
+    void setProgramChecked(const QString& scriptOrURL, const QScriptProgram& program);
     
 private slots:
     void scriptDownloaded(); // old version
@@ -51,6 +60,16 @@ private:
     QHash<QUrl, QString> _scriptCache;
     QMultiMap<QUrl, ScriptUser*> _scriptUsers;
     QSet<QUrl> _badScripts;
+
+    class CachedProgram {
+    public:
+        QScriptProgram program;
+        bool isChecked { false };
+    };
+
+    // the entity script engines run on their own threads
+    QMutex _programsMutex;
+    QHash<QString, CachedProgram> _programs;
 };
 
 #endif // hifi_ScriptCache_h
\ No newline at end of file
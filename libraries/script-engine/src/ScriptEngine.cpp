@@ -12,7 +12,6 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QEventLoop>
 #include <QtCore/QFileInfo>
-#include <QtCore/QTimer>
 #include <QtCore/QThread>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
@@ -26,6 +25,7 @@
 #include <EntityScriptingInterface.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
+#include <Trace.h>
 #include <udt/PacketHeaders.h>
 #include <UUID.h>
 
@@ -334,6 +334,7 @@ void ScriptEngine::init() {
     qScriptRegisterMetaType(this, RayToEntityIntersectionResultToScriptValue, RayToEntityIntersectionResultFromScriptValue);
     qScriptRegisterSequenceMetaType<QVector<QUuid>>(this);
     qScriptRegisterSequenceMetaType<QVector<EntityItemID>>(this);
+    qScriptRegisterSequenceMetaType<QVector<EntityItemProperties>>(this);
 
     qScriptRegisterSequenceMetaType<QVector<glm::vec2> >(this);
     qScriptRegisterSequenceMetaType<QVector<glm::quat> >(this);
@@ -634,7 +635,10 @@ QScriptValue ScriptEngine::evaluate(const QString& sourceCode, const QString& fi
     if (!hasCorrectSyntax(program)) {
         return QScriptValue();
     }
+    return evaluateProgram(program);
+}
 
+QScriptValue ScriptEngine::evaluateProgram(const QScriptProgram& program) {
     ++_evaluatesPending;
     const auto result = QScriptEngine::evaluate(program);
     --_evaluatesPending;
@@ -661,7 +665,10 @@ void ScriptEngine::run() {
         emit runningStateChanged();
     }
 
-    QScriptValue result = evaluate(_scriptContents, _fileNameString);
+    {
+        ScriptProfile::Section section(_profile, ScriptProfile::LOADS);
+        evaluate(_scriptContents, _fileNameString);
+    }
 
     QElapsedTimer startTime;
     startTime.start();
@@ -689,6 +696,19 @@ void ScriptEngine::run() {
             break;
         }
 
+        // the timers are fired together once a frame, rather than each waking the thread on its own
+        fireDueTimers();
+
+        if (_isFinished) {
+            break;
+        }
+
+        preloadReadyEntityScripts();
+
+        if (_isFinished) {
+            break;
+        }
+
         if (!_isFinished && entityScriptingInterface->getEntityPacketSender()->serversExist()) {
             // release the queue of edit entity messages.
             entityScriptingInterface->getEntityPacketSender()->releaseQueuedMessages();
@@ -704,6 +724,8 @@ void ScriptEngine::run() {
 
         if (!_isFinished) {
             if (_wantSignals) {
+                ScriptProfile::Section section(_profile, ScriptProfile::UPDATE);
+                TRACE_ZONE("ScriptEngine::update");
                 emit update(deltaTime);
             }
         }
@@ -711,7 +733,13 @@ void ScriptEngine::run() {
 
         // Debug and clear exceptions
         hadUncaughtExceptions(*this, _fileNameString);
+
+        if (now - _lastProfileStatsPublish >= PROFILE_STATS_PUBLISH_INTERVAL_USECS) {
+            publishProfileStats();
+            _lastProfileStatsPublish = now;
+        }
     }
+    publishProfileStats();
 
     stopAllTimers(); // make sure all our timers are stopped if the script is ending
     if (_wantSignals) {
@@ -750,12 +778,8 @@ void ScriptEngine::run() {
 // NOTE: This is private because it must be called on the same thread that created the timers, which is why
 // we want to only call it in our own run "shutdown" processing.
 void ScriptEngine::stopAllTimers() {
-    QMutableHashIterator<QTimer*, QScriptValue> i(_timerFunctionMap);
-    while (i.hasNext()) {
-        i.next();
-        QTimer* timer = i.key();
-        stopTimer(timer);
-    }
+    _timerFunctionMap.clear();
+    _timerWheel.clear();
 }
 
 void ScriptEngine::stop() {
@@ -788,61 +812,104 @@ void ScriptEngine::callAnimationStateHandler(QScriptValue callback, AnimVariantM
     resultHandler(result);
 }
 
-void ScriptEngine::timerFired() {
-    QTimer* callingTimer = reinterpret_cast<QTimer*>(sender());
-    QScriptValue timerFunction = _timerFunctionMap.value(callingTimer);
-
-    if (!callingTimer->isActive()) {
-        // this timer is done, we can kill it
-        _timerFunctionMap.remove(callingTimer);
-        delete callingTimer;
+void ScriptEngine::fireDueTimers() {
+    if (_timerWheel.isEmpty()) {
+        return;
     }
+    TRACE_ZONE("ScriptEngine::fireDueTimers");
+    _timerWheel.advance(usecTimestampNow() / USECS_PER_MSEC, _dueTimers);
+
+    for (auto timerID : _dueTimers) {
+        // an earlier callback of the batch may have cleared this timer
+        auto timerFunction = _timerFunctionMap.find(timerID);
+        if (timerFunction == _timerFunctionMap.end()) {
+            continue;
+        }
+        QScriptValue function = timerFunction.value();
+        if (!_timerWheel.hasTimer(timerID)) {
+            // this timer is done, we can forget it
+            _timerFunctionMap.erase(timerFunction);
+        }
 
-    // call the associated JS function, if it exists
-    if (timerFunction.isValid()) {
-        timerFunction.call();
+        // call the associated JS function, if it exists
+        if (function.isValid()) {
+            ScriptProfile::Section section(_profile, ScriptProfile::TIMERS);
+            function.call();
+        }
     }
+    _dueTimers.clear();
 }
 
-QObject* ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
-    // create the timer, add it to the map, and start it
-    QTimer* newTimer = new QTimer(this);
-    newTimer->setSingleShot(isSingleShot);
+void ScriptEngine::publishProfileStats() {
+    QVariantMap stats = _profile.toVariantMap();
+    stats["array_buffer_bytes"] = _arrayBufferClass->getAllocatedBytes();
+    stats["timer_count"] = _timerFunctionMap.size();
+    stats["entity_script_count"] = _entityScripts.size();
 
-    connect(newTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
+    QVariantMap samplingStats;
+    samplingStats["enabled"] = _samplingProfiler != nullptr;
+    if (_samplingProfiler) {
+        const int TOP_STACK_COUNT = 10;
+        samplingStats["samples"] = _samplingProfiler->getSampleCount();
+        samplingStats["top_stacks"] = _samplingProfiler->getTopStacks(TOP_STACK_COUNT);
+    }
+    stats["sampling_profiler"] = samplingStats;
 
-    // make sure the timer stops when the script does
-    connect(this, &ScriptEngine::scriptEnding, newTimer, &QTimer::stop);
+    QMutexLocker locker(&_profileStatsMutex);
+    _profileStats = stats;
+}
 
-    _timerFunctionMap.insert(newTimer, function);
+QVariantMap ScriptEngine::getProfileStats() const {
+    QMutexLocker locker(&_profileStatsMutex);
+    return _profileStats;
+}
 
-    newTimer->start(intervalMS);
-    return newTimer;
+void ScriptEngine::setSamplingProfilerEnabled(bool enabled) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "setSamplingProfilerEnabled", Q_ARG(bool, enabled));
+        return;
+    }
+    if (enabled == (_samplingProfiler != nullptr)) {
+        return;
+    }
+    if (enabled) {
+        _samplingProfiler = new ScriptSamplingProfiler(this);
+        setAgent(_samplingProfiler);
+    } else {
+        setAgent(nullptr);
+        delete _samplingProfiler;
+        _samplingProfiler = nullptr;
+    }
+}
+
+int ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
+    // add the timer to the wheel and the map, the run loop fires it
+    auto timerID = _timerWheel.addTimer(usecTimestampNow() / USECS_PER_MSEC, intervalMS, isSingleShot);
+    _timerFunctionMap.insert(timerID, function);
+    return timerID;
 }
 
-QObject* ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
+int ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
     if (_stoppingAllScripts) {
         qCDebug(scriptengine) << "Script.setInterval() while shutting down is ignored... parent script:" << getFilename();
-        return NULL; // bail early
+        return ScriptTimerWheel::INVALID_TIMER_ID; // bail early
     }
 
     return setupTimerWithInterval(function, intervalMS, false);
 }
 
-QObject* ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
+int ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
     if (_stoppingAllScripts) {
         qCDebug(scriptengine) << "Script.setTimeout() while shutting down is ignored... parent script:" << getFilename();
-        return NULL; // bail early
+        return ScriptTimerWheel::INVALID_TIMER_ID; // bail early
     }
 
     return setupTimerWithInterval(function, timeoutMS, true);
 }
 
-void ScriptEngine::stopTimer(QTimer *timer) {
-    if (_timerFunctionMap.contains(timer)) {
-        timer->stop();
-        _timerFunctionMap.remove(timer);
-        delete timer;
+void ScriptEngine::stopTimer(int timerID) {
+    if (_timerFunctionMap.remove(timerID) > 0) {
+        _timerWheel.removeTimer(timerID);
     }
 }
 
@@ -902,6 +969,7 @@ void ScriptEngine::include(const QStringList& includeFiles, QScriptValue callbac
     BatchLoader* loader = new BatchLoader(urls);
 
     auto evaluateScripts = [=](const QMap<QUrl, QString>& data) {
+        ScriptProfile::Section section(_profile, ScriptProfile::LOADS);
         auto parentURL = _parentURL;
         for (QUrl url : urls) {
             QString contents = data[url];
@@ -990,14 +1058,15 @@ void ScriptEngine::forwardHandlerCall(const EntityItemID& entityID, const QStrin
     QScriptValueList handlersForEvent = handlersOnEntity[eventName];
     if (!handlersForEvent.isEmpty()) {
         for (int i = 0; i < handlersForEvent.count(); ++i) {
-            handlersForEvent[i].call(QScriptValue(), eventHanderArgs);
+            callEntityScriptFunction(entityID, handlersForEvent[i], QScriptValue(), eventHanderArgs);
         }
     }
 }
 
 // since all of these operations can be asynch we will always do the actual work in the response handler
 // for the download
-void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString& entityScript, bool forceRedownload) {
+void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString& entityScript, bool forceRedownload,
+                                    float priority) {
     if (QThread::currentThread() != thread()) {
         #ifdef THREAD_DEBUGGING
         qDebug() << "*** WARNING *** ScriptEngine::loadEntityScript() called on wrong thread [" << QThread::currentThread() << "], invoking on correct thread [" << thread() << "]  "
@@ -1007,7 +1076,8 @@ void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString&
         QMetaObject::invokeMethod(this, "loadEntityScript",
             Q_ARG(const EntityItemID&, entityID),
             Q_ARG(const QString&, entityScript),
-            Q_ARG(bool, forceRedownload));
+            Q_ARG(bool, forceRedownload),
+            Q_ARG(float, priority));
         return;
     }
     #ifdef THREAD_DEBUGGING
@@ -1018,6 +1088,13 @@ void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString&
     // If we've been called our known entityScripts should not know about us..
     assert(!_entityScripts.contains(entityID));
 
+    // a download of an earlier load of the entity's script is ignored when it completes
+    quint64 loadSequence = ++_lastEntityScriptLoadSequence;
+    PendingEntityScript& pending = _pendingEntityScripts[entityID];
+    pending = PendingEntityScript();
+    pending.loadSequence = loadSequence;
+    pending.priority = priority;
+
     #ifdef THREAD_DEBUGGING
     qDebug() << "ScriptEngine::loadEntityScript() calling scriptCache->getScriptContents() on thread [" << QThread::currentThread() << "] expected thread [" << thread() << "]";
     #endif
@@ -1026,13 +1103,13 @@ void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString&
             qDebug() << "ScriptEngine::entityScriptContentAvailable() IN LAMBDA contentAvailable on thread [" << QThread::currentThread() << "] expected thread [" << thread() << "]";
             #endif
 
-            this->entityScriptContentAvailable(entityID, scriptOrURL, contents, isURL, success);
+            this->entityScriptContentAvailable(entityID, loadSequence, scriptOrURL, contents, isURL, success);
         }, forceRedownload);
 }
 
 // since all of these operations can be asynch we will always do the actual work in the response handler
-// for the download
-void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, const QString& scriptOrURL, const QString& contents, bool isURL, bool success) {
+// for the download, which queues the script to be preloaded by the run loop
+void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, quint64 loadSequence, const QString& scriptOrURL, const QString& contents, bool isURL, bool success) {
     if (QThread::currentThread() != thread()) {
         #ifdef THREAD_DEBUGGING
         qDebug() << "*** WARNING *** ScriptEngine::entityScriptContentAvailable() called on wrong thread [" << QThread::currentThread() << "], invoking on correct thread [" << thread() << "]  "
@@ -1041,6 +1118,7 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
 
         QMetaObject::invokeMethod(this, "entityScriptContentAvailable",
             Q_ARG(const EntityItemID&, entityID),
+            Q_ARG(quint64, loadSequence),
             Q_ARG(const QString&, scriptOrURL),
             Q_ARG(const QString&, contents),
             Q_ARG(bool, isURL),
@@ -1052,47 +1130,100 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
     qDebug() << "ScriptEngine::entityScriptContentAvailable() thread [" << QThread::currentThread() << "] expected thread [" << thread() << "]";
     #endif
 
+    auto pending = _pendingEntityScripts.find(entityID);
+    if (pending == _pendingEntityScripts.end() || pending->loadSequence != loadSequence) {
+        return; // the script was unloaded, or loaded again, while it was downloading
+    }
+    pending->scriptOrURL = scriptOrURL;
+    pending->contents = contents;
+    pending->isURL = isURL;
+
+    ReadyEntityScript ready;
+    ready.priority = pending->priority;
+    ready.loadSequence = loadSequence;
+    ready.entityID = entityID;
+    _readyEntityScripts.push(ready);
+}
+
+void ScriptEngine::preloadReadyEntityScripts() {
+    if (_readyEntityScripts.empty()) {
+        return;
+    }
+    quint64 start = usecTimestampNow();
+    while (!_readyEntityScripts.empty() && !_isFinished) {
+        ReadyEntityScript ready = _readyEntityScripts.top();
+        _readyEntityScripts.pop();
+
+        auto pending = _pendingEntityScripts.find(ready.entityID);
+        if (pending == _pendingEntityScripts.end() || pending->loadSequence != ready.loadSequence) {
+            continue; // unloaded since it was queued
+        }
+        PendingEntityScript script = pending.value();
+        _pendingEntityScripts.erase(pending);
+        loadEntityScriptContents(ready.entityID, script.scriptOrURL, script.contents, script.isURL);
+
+        if (usecTimestampNow() - start >= ENTITY_SCRIPT_PRELOAD_BUDGET_USECS) {
+            break; // the rest wait for the next frame
+        }
+    }
+}
+
+void ScriptEngine::loadEntityScriptContents(const EntityItemID& entityID, const QString& scriptOrURL,
+                                            const QString& contents, bool isURL) {
     auto scriptCache = DependencyManager::get<ScriptCache>();
     bool isFileUrl = isURL && scriptOrURL.startsWith("file://");
-    auto fileName = QString("(EntityID:%1, %2)").arg(entityID.toString(), isURL ? scriptOrURL : "EmbededEntityScript");
+    // the program is shared by the entities that use the script, so the file name can't name the entity
+    auto fileName = isURL ? scriptOrURL : QString("EmbededEntityScript");
+
+    bool isChecked;
+    QScriptProgram program = scriptCache->getProgram(scriptOrURL, contents, fileName, isChecked);
+    if (!isChecked) {
+        if (!hasCorrectSyntax(program)) {
+            qCDebug(scriptengine) << "ScriptEngine::loadEntityScript() entity:" << entityID << "has a syntax error";
+            if (!isFileUrl) {
+                scriptCache->addScriptToBadScriptList(scriptOrURL);
+            }
+            return; // done processing script
+        }
 
-    QScriptProgram program(contents, fileName);
-    if (!hasCorrectSyntax(program)) {
-        if (!isFileUrl) {
-            scriptCache->addScriptToBadScriptList(scriptOrURL);
+        QScriptEngine sandbox;
+        QScriptValue testConstructor = sandbox.evaluate(program);
+        if (hadUncaughtExceptions(sandbox, program.fileName())) {
+            return;
         }
-        return; // done processing script
+
+        if (!testConstructor.isFunction()) {
+            qCDebug(scriptengine) << "ScriptEngine::loadEntityScript() entity:" << entityID << "\n"
+                                     "    NOT CONSTRUCTOR\n"
+                                     "    SCRIPT:" << scriptOrURL;
+            if (!isFileUrl) {
+                scriptCache->addScriptToBadScriptList(scriptOrURL);
+            }
+            return; // done processing script
+        }
+        scriptCache->setProgramChecked(scriptOrURL, program);
     }
 
     if (isURL) {
         setParentURL(scriptOrURL);
     }
 
-    QScriptEngine sandbox;
-    QScriptValue testConstructor = sandbox.evaluate(program);
-    if (hadUncaughtExceptions(sandbox, program.fileName())) {
-        return;
-    }
-    
-    if (!testConstructor.isFunction()) {
-        qCDebug(scriptengine) << "ScriptEngine::loadEntityScript() entity:" << entityID << "\n"
-                                 "    NOT CONSTRUCTOR\n"
-                                 "    SCRIPT:" << scriptOrURL;
-        if (!isFileUrl) {
-            scriptCache->addScriptToBadScriptList(scriptOrURL);
-        }
-        return; // done processing script
-    }
-
     int64_t lastModified = 0;
     if (isFileUrl) {
         QString file = QUrl(scriptOrURL).toLocalFile();
         lastModified = (quint64)QFileInfo(file).lastModified().toMSecsSinceEpoch();
     }
 
-    QScriptValue entityScriptConstructor = evaluate(contents, fileName);
-    QScriptValue entityScriptObject = entityScriptConstructor.construct();
-    EntityScriptDetails newDetails = { scriptOrURL, entityScriptObject, lastModified };
+    QScriptValue entityScriptObject;
+    {
+        ScriptProfile::Section section(_profile, ScriptProfile::LOADS);
+        QScriptValue entityScriptConstructor = evaluateProgram(program);
+        entityScriptObject = entityScriptConstructor.construct();
+    }
+    EntityScriptDetails newDetails;
+    newDetails.scriptText = scriptOrURL;
+    newDetails.scriptObject = entityScriptObject;
+    newDetails.lastModified = lastModified;
     _entityScripts[entityID] = newDetails;
     if (isURL) {
         setParentURL("");
@@ -1118,6 +1249,7 @@ void ScriptEngine::unloadEntityScript(const EntityItemID& entityID) {
         "entityID:" << entityID;
     #endif
 
+    _pendingEntityScripts.remove(entityID);
     if (_entityScripts.contains(entityID)) {
         callEntityScriptMethod(entityID, "unload");
         _entityScripts.remove(entityID);
@@ -1136,6 +1268,8 @@ void ScriptEngine::unloadAllEntityScripts() {
 #ifdef THREAD_DEBUGGING
     qDebug() << "ScriptEngine::unloadAllEntityScripts() called on correct thread [" << thread() << "]";
 #endif
+    _pendingEntityScripts.clear();
+    _readyEntityScripts = std::priority_queue<ReadyEntityScript>();
     foreach(const EntityItemID& entityID, _entityScripts.keys()) {
         callEntityScriptMethod(entityID, "unload");
     }
@@ -1165,7 +1299,7 @@ void ScriptEngine::refreshFileScript(const EntityItemID& entityID) {
             file.open(QIODevice::ReadOnly);
             QString scriptContents = QTextStream(&file).readAll();
             this->unloadEntityScript(entityID);
-            this->entityScriptContentAvailable(entityID, details.scriptText, scriptContents, true, true);
+            this->loadEntityScriptContents(entityID, details.scriptText, scriptContents, true);
             if (!_entityScripts.contains(entityID)) {
                 qWarning() << "Reload script " << details.scriptText << " failed";
             } else {
@@ -1202,7 +1336,9 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             QScriptValueList args;
             args << entityID.toScriptValue(this);
             args << qScriptValueFromSequence(this, params);
-            entityScript.property(methodName).call(entityScript, args);
+            // the script always gets to set itself up and clean up after itself
+            bool canBeSkipped = methodName != "preload" && methodName != "unload";
+            callEntityScriptFunction(entityID, entityScript.property(methodName), entityScript, args, canBeSkipped);
         }
 
     }
@@ -1234,7 +1370,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             QScriptValueList args;
             args << entityID.toScriptValue(this);
             args << event.toScriptValue(this);
-            entityScript.property(methodName).call(entityScript, args);
+            callEntityScriptFunction(entityID, entityScript.property(methodName), entityScript, args);
         }
     }
 }
@@ -1268,7 +1404,46 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             args << entityID.toScriptValue(this);
             args << otherID.toScriptValue(this);
             args << collisionToScriptValue(this, collision);
-            entityScript.property(methodName).call(entityScript, args);
+            callEntityScriptFunction(entityID, entityScript.property(methodName), entityScript, args);
         }
     }
 }
+
+void ScriptEngine::callEntityScriptFunction(const EntityItemID& entityID, QScriptValue function,
+                                            const QScriptValue& thisObject, const QScriptValueList& args,
+                                            bool canBeSkipped) {
+    auto details = _entityScripts.find(entityID);
+    ScriptProfile::Section section(_profile, ScriptProfile::ENTITY_EVENTS);
+    if (details == _entityScripts.end()) {
+        // a handler that isn't from an entity script
+        function.call(thisObject, args);
+        return;
+    }
+
+    quint64 start = usecTimestampNow();
+    if (start - details->budgetWindowStart >= ENTITY_SCRIPT_BUDGET_WINDOW_USECS) {
+        details->budgetWindowStart = start;
+        details->budgetWindowUsecs = 0;
+        details->isOverBudget = false;
+    }
+    if (details->isOverBudget && canBeSkipped) {
+        return;
+    }
+
+    function.call(thisObject, args);
+
+    // the script may have unloaded itself
+    details = _entityScripts.find(entityID);
+    if (details == _entityScripts.end()) {
+        return;
+    }
+    quint64 elapsed = usecTimestampNow() - start;
+    details->cpuUsecs += elapsed;
+    details->budgetWindowUsecs += elapsed;
+    if (_entityScriptBudgetUsecs > 0 && details->budgetWindowUsecs > _entityScriptBudgetUsecs && !details->isOverBudget) {
+        details->isOverBudget = true;
+        qCDebug(scriptengine) << "Entity script of" << entityID << "spent" << details->budgetWindowUsecs
+            << "usecs, over its budget of" << _entityScriptBudgetUsecs << "usecs, skipping its calls for the rest of the"
+            << ENTITY_SCRIPT_BUDGET_WINDOW_USECS << "usecs window";
+    }
+}
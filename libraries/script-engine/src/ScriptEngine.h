@@ -12,6 +12,7 @@
 #ifndef hifi_ScriptEngine_h
 #define hifi_ScriptEngine_h
 
+#include <queue>
 #include <vector>
 
 #include <QtCore/QObject>
@@ -26,6 +27,7 @@
 #include <AvatarData.h>
 #include <AvatarHashMap.h>
 #include <LimitedNodeList.h>
+#include <NumericalConstants.h>
 #include <EntityItemID.h>
 #include <EntitiesScriptEngineProvider.h>
 
@@ -34,6 +36,9 @@
 #include "AudioScriptingInterface.h"
 #include "Quat.h"
 #include "ScriptCache.h"
+#include "ScriptProfile.h"
+#include "ScriptSamplingProfiler.h"
+#include "ScriptTimerWheel.h"
 #include "ScriptUUID.h"
 #include "Vec3.h"
 
@@ -41,6 +46,18 @@ const QString NO_SCRIPT("");
 
 const unsigned int SCRIPT_DATA_CALLBACK_USECS = floor(((1.0f / 60.0f) * 1000 * 1000) + 0.5f);
 
+// an entity script that spends more than its budget in the calls of a window has the rest of them skipped, so that the
+// other entity scripts of the engine still get to run
+const quint64 ENTITY_SCRIPT_BUDGET_WINDOW_USECS = USECS_PER_SECOND;
+const quint64 DEFAULT_ENTITY_SCRIPT_BUDGET_USECS = USECS_PER_SECOND / 10;
+
+// the entity scripts that were downloaded are preloaded nearest first, and the run loop stops preloading them for the
+// frame once it spent this long, so that entering a domain full of scripted entities doesn't hold up their events
+const quint64 ENTITY_SCRIPT_PRELOAD_BUDGET_USECS = 4 * USECS_PER_MSEC;
+
+// how often the run loop publishes the profile of the script for other threads to read
+const quint64 PROFILE_STATS_PUBLISH_INTERVAL_USECS = USECS_PER_SECOND;
+
 typedef QHash<QString, QScriptValueList> RegisteredEventHandlers;
 
 class EntityScriptDetails {
@@ -48,6 +65,33 @@ public:
     QString scriptText;
     QScriptValue scriptObject;
     int64_t lastModified;
+
+    quint64 cpuUsecs { 0 }; // spent in the calls to the script since it was loaded
+    quint64 budgetWindowStart { 0 };
+    quint64 budgetWindowUsecs { 0 };
+    bool isOverBudget { false };
+};
+
+// an entity script that was asked to be loaded and isn't yet
+class PendingEntityScript {
+public:
+    quint64 loadSequence { 0 }; // tells the load apart from earlier ones of the same entity
+    float priority { 0.0f };
+    QString scriptOrURL;
+    QString contents;
+    bool isURL { false };
+};
+
+// an entity script that was downloaded, ordered so that the queue preloads the lowest priority first
+class ReadyEntityScript {
+public:
+    float priority;
+    quint64 loadSequence;
+    EntityItemID entityID;
+
+    bool operator<(const ReadyEntityScript& other) const {
+        return priority > other.priority || (priority == other.priority && loadSequence > other.loadSequence);
+    }
 };
 
 class ScriptEngine : public QScriptEngine, public ScriptUser, public EntitiesScriptEngineProvider {
@@ -105,15 +149,17 @@ public:
     Q_INVOKABLE void include(const QStringList& includeFiles, QScriptValue callback = QScriptValue());
     Q_INVOKABLE void include(const QString& includeFile, QScriptValue callback = QScriptValue());
 
-    Q_INVOKABLE QObject* setInterval(const QScriptValue& function, int intervalMS);
-    Q_INVOKABLE QObject* setTimeout(const QScriptValue& function, int timeoutMS);
-    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
-    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    Q_INVOKABLE int setInterval(const QScriptValue& function, int intervalMS);
+    Q_INVOKABLE int setTimeout(const QScriptValue& function, int timeoutMS);
+    Q_INVOKABLE void clearInterval(int timerID) { stopTimer(timerID); }
+    Q_INVOKABLE void clearTimeout(int timerID) { stopTimer(timerID); }
     Q_INVOKABLE void print(const QString& message);
     Q_INVOKABLE QUrl resolvePath(const QString& path) const;
 
     // Entity Script Related methods
-    Q_INVOKABLE void loadEntityScript(const EntityItemID& entityID, const QString& entityScript, bool forceRedownload = false); // will call the preload method once loaded
+    // will call the preload method once loaded, the scripts with a lower priority, like the distance to their entity, first
+    Q_INVOKABLE void loadEntityScript(const EntityItemID& entityID, const QString& entityScript, bool forceRedownload = false,
+                                      float priority = 0.0f);
     Q_INVOKABLE void unloadEntityScript(const EntityItemID& entityID); // will call unload method
     Q_INVOKABLE void unloadAllEntityScripts();
     Q_INVOKABLE void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName, const QStringList& params = QStringList());
@@ -140,6 +186,20 @@ public:
     void setUserLoaded(bool isUserLoaded) { _isUserLoaded = isUserLoaded; }
     bool isUserLoaded() const { return _isUserLoaded; }
 
+    // the time each entity script gets in a budget window, 0 for no limit
+    void setEntityScriptBudgetUsecs(quint64 budgetUsecs) { _entityScriptBudgetUsecs = budgetUsecs; }
+    quint64 getEntityScriptBudgetUsecs() const { return _entityScriptBudgetUsecs; }
+
+    // the time spent in the calls to the entity script since it was loaded, 0 if it isn't
+    quint64 getEntityScriptCPUUsecs(const EntityItemID& entityID) const { return _entityScripts.value(entityID).cpuUsecs; }
+
+    // the time spent running the script by what for, and what it allocated, as of the last second. Unlike the rest of
+    // the engine this is safe to call from any thread
+    QVariantMap getProfileStats() const;
+
+    // samples the call stacks of the script into the profile stats, which slows the script down a little
+    Q_INVOKABLE void setSamplingProfilerEnabled(bool enabled);
+
     // NOTE - this is used by the TypedArray implemetation. we need to review this for thread safety
     ArrayBufferClass* getArrayBufferClass() { return _arrayBufferClass; }
 
@@ -168,23 +228,33 @@ protected:
     bool _isRunning;
     int _evaluatesPending = 0;
     bool _isInitialized;
-    QHash<QTimer*, QScriptValue> _timerFunctionMap;
+    QHash<ScriptTimerWheel::TimerID, QScriptValue> _timerFunctionMap;
+    ScriptTimerWheel _timerWheel;
+    std::vector<ScriptTimerWheel::TimerID> _dueTimers;
     QSet<QUrl> _includedURLs;
     bool _wantSignals = true;
     QHash<EntityItemID, EntityScriptDetails> _entityScripts;
+    quint64 _entityScriptBudgetUsecs { DEFAULT_ENTITY_SCRIPT_BUDGET_USECS };
 private:
     void init();
     QString getFilename() const;
     void waitTillDoneRunning();
     bool evaluatePending() const { return _evaluatesPending > 0; }
-    void timerFired();
+    void fireDueTimers();
+    void preloadReadyEntityScripts();
+    void loadEntityScriptContents(const EntityItemID& entityID, const QString& scriptOrURL, const QString& contents,
+                                  bool isURL);
+    QScriptValue evaluateProgram(const QScriptProgram& program);
+    void publishProfileStats();
     void stopAllTimers();
     void refreshFileScript(const EntityItemID& entityID);
+    void callEntityScriptFunction(const EntityItemID& entityID, QScriptValue function, const QScriptValue& thisObject,
+                                  const QScriptValueList& args, bool canBeSkipped = true);
 
     void setParentURL(const QString& parentURL) { _parentURL = parentURL; }
 
-    QObject* setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
-    void stopTimer(QTimer* timer);
+    int setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
+    void stopTimer(int timerID);
 
     QString _fileNameString;
     Quat _quatLibrary;
@@ -195,9 +265,19 @@ private:
 
     ArrayBufferClass* _arrayBufferClass;
 
+    ScriptProfile _profile;
+    ScriptSamplingProfiler* _samplingProfiler { nullptr };
+    quint64 _lastProfileStatsPublish { 0 };
+    mutable QMutex _profileStatsMutex;
+    QVariantMap _profileStats;
+
     QHash<EntityItemID, RegisteredEventHandlers> _registeredHandlers;
     void forwardHandlerCall(const EntityItemID& entityID, const QString& eventName, QScriptValueList eventHanderArgs);
-    Q_INVOKABLE void entityScriptContentAvailable(const EntityItemID& entityID, const QString& scriptOrURL, const QString& contents, bool isURL, bool success);
+    Q_INVOKABLE void entityScriptContentAvailable(const EntityItemID& entityID, quint64 loadSequence, const QString& scriptOrURL, const QString& contents, bool isURL, bool success);
+
+    QHash<EntityItemID, PendingEntityScript> _pendingEntityScripts;
+    std::priority_queue<ReadyEntityScript> _readyEntityScripts;
+    quint64 _lastEntityScriptLoadSequence { 0 };
 
     static QSet<ScriptEngine*> _allKnownScriptEngines;
     static QMutex _allScriptsMutex;
@@ -0,0 +1,126 @@
+//
+//  ScriptProfile.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptProfile.h"
+
+#include <algorithm>
+
+#include <QtCore/QtGlobal>
+
+#if defined(Q_OS_WIN)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(Q_OS_MAC)
+#include <mach/mach.h>
+#else
+#include <time.h>
+#endif
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+ScriptProfile::Section::Section(ScriptProfile& profile, Category category) :
+    _profile(profile),
+    _category(category),
+    _isOutermost(profile._depth++ == 0)
+{
+    if (_isOutermost) {
+        _startUsecs = usecTimestampNow();
+        _startCPUUsecs = getThreadCPUUsecs();
+    }
+}
+
+ScriptProfile::Section::~Section() {
+    --_profile._depth;
+    if (!_isOutermost) {
+        return;
+    }
+    quint64 wallUsecs = usecTimestampNow() - _startUsecs;
+    quint64 cpuUsecs = getThreadCPUUsecs();
+    CategoryStats& stats = _profile._stats[_category];
+    stats.calls++;
+    stats.wallUsecs += wallUsecs;
+    stats.cpuUsecs += cpuUsecs > _startCPUUsecs ? cpuUsecs - _startCPUUsecs : 0;
+    stats.maxWallUsecs = std::max(stats.maxWallUsecs, wallUsecs);
+}
+
+quint64 ScriptProfile::getThreadCPUUsecs() {
+#if defined(Q_OS_WIN)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    // in units of 100 nsecs
+    ULARGE_INTEGER kernel, user;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    return (kernel.QuadPart + user.QuadPart) / 10;
+#elif defined(Q_OS_MAC)
+    mach_port_t thread = mach_thread_self();
+    thread_basic_info_data_t info;
+    mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+    kern_return_t result = thread_info(thread, THREAD_BASIC_INFO, (thread_info_t)&info, &count);
+    mach_port_deallocate(mach_task_self(), thread);
+    if (result != KERN_SUCCESS) {
+        return 0;
+    }
+    return (quint64)(info.user_time.seconds + info.system_time.seconds) * USECS_PER_SECOND +
+        info.user_time.microseconds + info.system_time.microseconds;
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+        return 0;
+    }
+    return (quint64)time.tv_sec * USECS_PER_SECOND + (quint64)time.tv_nsec / NSECS_PER_USEC;
+#endif
+}
+
+QString ScriptProfile::getCategoryName(Category category) {
+    switch (category) {
+        case UPDATE:
+            return "update";
+        case TIMERS:
+            return "timers";
+        case ENTITY_EVENTS:
+            return "entity_events";
+        case LOADS:
+            return "loads";
+        default:
+            return "unknown";
+    }
+}
+
+void ScriptProfile::reset() {
+    for (int i = 0; i < NUM_CATEGORIES; i++) {
+        _stats[i] = CategoryStats();
+    }
+}
+
+QVariantMap ScriptProfile::toVariantMap() const {
+    QVariantMap result;
+    quint64 totalWallUsecs = 0;
+    quint64 totalCPUUsecs = 0;
+    for (int i = 0; i < NUM_CATEGORIES; i++) {
+        const CategoryStats& stats = _stats[i];
+        QVariantMap statsMap;
+        statsMap["calls"] = stats.calls;
+        statsMap["wall_usecs"] = stats.wallUsecs;
+        statsMap["cpu_usecs"] = stats.cpuUsecs;
+        statsMap["max_wall_usecs"] = stats.maxWallUsecs;
+        result[getCategoryName((Category)i)] = statsMap;
+        totalWallUsecs += stats.wallUsecs;
+        totalCPUUsecs += stats.cpuUsecs;
+    }
+    result["wall_usecs"] = totalWallUsecs;
+    result["cpu_usecs"] = totalCPUUsecs;
+    return result;
+}
@@ -0,0 +1,66 @@
+//
+//  ScriptProfile.h
+//  libraries/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptProfile_h
+#define hifi_ScriptProfile_h
+
+#include <QtCore/QVariantMap>
+
+/// The wall and CPU time a script engine spends running the script, by what it was running it for. The whole profile
+/// belongs to the thread of the engine, the engine publishes copies of it for the other threads.
+class ScriptProfile {
+public:
+    enum Category {
+        UPDATE = 0,
+        TIMERS,
+        ENTITY_EVENTS,
+        LOADS,
+        NUM_CATEGORIES
+    };
+
+    class CategoryStats {
+    public:
+        quint64 calls { 0 };
+        quint64 wallUsecs { 0 };
+        quint64 cpuUsecs { 0 };
+        quint64 maxWallUsecs { 0 };
+    };
+
+    /// times a call to the script for as long as it is in scope, a call made from inside another one is part of the
+    /// outer one, so that no time is counted twice
+    class Section {
+    public:
+        Section(ScriptProfile& profile, Category category);
+        ~Section();
+
+    private:
+        ScriptProfile& _profile;
+        Category _category;
+        bool _isOutermost;
+        quint64 _startUsecs { 0 };
+        quint64 _startCPUUsecs { 0 };
+    };
+
+    /// the CPU time of the calling thread, 0 where the platform doesn't keep it
+    static quint64 getThreadCPUUsecs();
+
+    static QString getCategoryName(Category category);
+
+    const CategoryStats& getStats(Category category) const { return _stats[category]; }
+    void reset();
+
+    QVariantMap toVariantMap() const;
+
+private:
+    CategoryStats _stats[NUM_CATEGORIES];
+    int _depth { 0 };
+};
+
+#endif // hifi_ScriptProfile_h
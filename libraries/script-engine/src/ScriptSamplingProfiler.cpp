@@ -0,0 +1,70 @@
+//
+//  ScriptSamplingProfiler.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptSamplingProfiler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtScript/QScriptContext>
+#include <QtScript/QScriptEngine>
+
+#include <SharedUtil.h>
+
+ScriptSamplingProfiler::ScriptSamplingProfiler(QScriptEngine* engine, quint64 sampleIntervalUsecs) :
+    QScriptEngineAgent(engine),
+    _sampleIntervalUsecs(sampleIntervalUsecs)
+{
+}
+
+void ScriptSamplingProfiler::positionChange(qint64 scriptId, int lineNumber, int columnNumber) {
+    if (++_statementsSinceClockCheck < STATEMENTS_PER_CLOCK_CHECK) {
+        return;
+    }
+    _statementsSinceClockCheck = 0;
+
+    quint64 now = usecTimestampNow();
+    if (now < _nextSampleUsecs) {
+        return;
+    }
+    _nextSampleUsecs = now + _sampleIntervalUsecs;
+
+    QStringList stack = engine()->currentContext()->backtrace();
+    if (stack.size() > MAX_STACK_DEPTH) {
+        stack.erase(stack.begin() + MAX_STACK_DEPTH, stack.end());
+    }
+    _stackSamples[stack.join("\n")]++;
+    _sampleCount++;
+}
+
+void ScriptSamplingProfiler::clear() {
+    _stackSamples.clear();
+    _sampleCount = 0;
+}
+
+QVariantList ScriptSamplingProfiler::getTopStacks(int count) const {
+    std::vector<std::pair<int, QString>> stacks;
+    stacks.reserve(_stackSamples.size());
+    for (auto it = _stackSamples.constBegin(); it != _stackSamples.constEnd(); it++) {
+        stacks.push_back(std::make_pair(it.value(), it.key()));
+    }
+    count = std::min(count, (int)stacks.size());
+    std::partial_sort(stacks.begin(), stacks.begin() + count, stacks.end(),
+        [](const std::pair<int, QString>& a, const std::pair<int, QString>& b) { return a.first > b.first; });
+
+    QVariantList result;
+    for (int i = 0; i < count; i++) {
+        QVariantMap stack;
+        stack["samples"] = stacks[i].first;
+        stack["stack"] = stacks[i].second.split("\n");
+        result.append(stack);
+    }
+    return result;
+}
@@ -0,0 +1,46 @@
+//
+//  ScriptSamplingProfiler.h
+//  libraries/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptSamplingProfiler_h
+#define hifi_ScriptSamplingProfiler_h
+
+#include <QtCore/QHash>
+#include <QtCore/QVariantList>
+#include <QtScript/QScriptEngineAgent>
+
+/// Samples the call stack of the script an engine is running, at most once per interval. Scripts only run on the
+/// thread of their engine, so the stack is sampled from the statements the engine reports as it runs them, and only
+/// every few of them look at the clock, which keeps the cost low enough to leave on while a domain is slow.
+class ScriptSamplingProfiler : public QScriptEngineAgent {
+public:
+    static const quint64 DEFAULT_SAMPLE_INTERVAL_USECS = 1000;
+    static const int MAX_STACK_DEPTH = 16;
+
+    ScriptSamplingProfiler(QScriptEngine* engine, quint64 sampleIntervalUsecs = DEFAULT_SAMPLE_INTERVAL_USECS);
+
+    virtual void positionChange(qint64 scriptId, int lineNumber, int columnNumber) override;
+
+    int getSampleCount() const { return _sampleCount; }
+    void clear();
+
+    /// the stacks that were sampled the most, from the innermost call out, with their number of samples
+    QVariantList getTopStacks(int count) const;
+
+private:
+    static const int STATEMENTS_PER_CLOCK_CHECK = 64;
+
+    quint64 _sampleIntervalUsecs;
+    quint64 _nextSampleUsecs { 0 };
+    int _statementsSinceClockCheck { 0 };
+    int _sampleCount { 0 };
+    QHash<QString, int> _stackSamples; // by the frames of the stack, one per line
+};
+
+#endif // hifi_ScriptSamplingProfiler_h
@@ -0,0 +1,137 @@
+//
+//  ScriptTimerWheel.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptTimerWheel.h"
+
+#include <limits>
+
+#include <QtGlobal>
+
+ScriptTimerWheel::TimerID ScriptTimerWheel::addTimer(quint64 nowMsecs, int intervalMS, bool isSingleShot) {
+    if (_timers.isEmpty()) {
+        // nothing is waiting, the wheel can jump to now instead of stepping through the ticks it missed
+        clear();
+        _nextTick = nowMsecs + 1;
+    }
+
+    do {
+        _lastTimerID = _lastTimerID < std::numeric_limits<TimerID>::max() ? _lastTimerID + 1 : INVALID_TIMER_ID + 1;
+    } while (_timers.contains(_lastTimerID));
+
+    Timer timer;
+    timer.intervalMS = qMax(intervalMS, 0);
+    timer.expiry = nowMsecs + timer.intervalMS;
+    timer.isSingleShot = isSingleShot;
+    _timers.insert(_lastTimerID, timer);
+    schedule(_lastTimerID, timer.expiry);
+    return _lastTimerID;
+}
+
+bool ScriptTimerWheel::removeTimer(TimerID timerID) {
+    // the id stays in its slot until the wheel gets there, and is skipped then
+    return _timers.remove(timerID) > 0;
+}
+
+void ScriptTimerWheel::clear() {
+    _timers.clear();
+    if (_scheduledCount > 0) {
+        for (auto& slot : _firstLevel) {
+            slot.clear();
+        }
+        for (auto& level : _levels) {
+            for (auto& slot : level) {
+                slot.clear();
+            }
+        }
+        _scheduledCount = 0;
+    }
+}
+
+void ScriptTimerWheel::schedule(TimerID timerID, quint64 expiry) {
+    // a timer further away than the wheel reaches waits in the last slot, and is scheduled again from there
+    quint64 tick = qMax(expiry, _nextTick);
+    quint64 ticks = qMin(tick - _nextTick, MAX_TICKS - 1);
+    tick = _nextTick + ticks;
+
+    ++_scheduledCount;
+    if (ticks < (quint64)FIRST_LEVEL_SIZE) {
+        _firstLevel[tick & (FIRST_LEVEL_SIZE - 1)].push_back(timerID);
+        return;
+    }
+    for (int level = 0; level < LEVEL_COUNT - 1; level++) {
+        int shift = FIRST_LEVEL_BITS + level * LEVEL_BITS;
+        if (ticks < (1ULL << (shift + LEVEL_BITS)) || level == LEVEL_COUNT - 2) {
+            _levels[level][(tick >> shift) & (LEVEL_SIZE - 1)].push_back(timerID);
+            return;
+        }
+    }
+}
+
+void ScriptTimerWheel::cascade(Slot& slot) {
+    _cascading.swap(slot);
+    _scheduledCount -= (int)_cascading.size();
+    for (TimerID timerID : _cascading) {
+        auto timer = _timers.constFind(timerID);
+        if (timer != _timers.constEnd()) {
+            schedule(timerID, timer->expiry);
+        }
+    }
+    _cascading.clear();
+}
+
+void ScriptTimerWheel::advance(quint64 nowMsecs, std::vector<TimerID>& dueTimers) {
+    if (_timers.isEmpty()) {
+        clear();
+        _nextTick = qMax(_nextTick, nowMsecs + 1);
+        return;
+    }
+
+    for (; _nextTick <= nowMsecs; ++_nextTick) {
+        int index = (int)(_nextTick & (FIRST_LEVEL_SIZE - 1));
+        if (index == 0) {
+            // the first level wrapped around, bring down the timers of the next 256 ticks, and so on up the levels
+            for (int level = 0; level < LEVEL_COUNT - 1; level++) {
+                int levelIndex = (int)((_nextTick >> (FIRST_LEVEL_BITS + level * LEVEL_BITS)) & (LEVEL_SIZE - 1));
+                cascade(_levels[level][levelIndex]);
+                if (levelIndex != 0) {
+                    break;
+                }
+            }
+        }
+
+        Slot& slot = _firstLevel[index];
+        if (slot.empty()) {
+            continue;
+        }
+        _cascading.swap(slot);
+        _scheduledCount -= (int)_cascading.size();
+        for (TimerID timerID : _cascading) {
+            auto timer = _timers.find(timerID);
+            if (timer == _timers.end()) {
+                continue;
+            }
+            if (timer->expiry > _nextTick) {
+                schedule(timerID, timer->expiry);
+                continue;
+            }
+            dueTimers.push_back(timerID);
+            if (timer->isSingleShot) {
+                _timers.erase(timer);
+                continue;
+            }
+            timer->expiry += timer->intervalMS;
+            if (timer->expiry <= nowMsecs) {
+                timer->expiry = nowMsecs + qMax(timer->intervalMS, 1);
+            }
+            schedule(timerID, timer->expiry);
+        }
+        _cascading.clear();
+    }
+}
@@ -0,0 +1,71 @@
+//
+//  ScriptTimerWheel.h
+//  libraries/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptTimerWheel_h
+#define hifi_ScriptTimerWheel_h
+
+#include <vector>
+
+#include <QtCore/QHash>
+
+/// The timers of a script, kept in a hierarchical timing wheel with a tick of one msec: the first level has a slot for
+/// each of the next 256 ticks, and each level after it has 64 slots as long as the whole level before it. Timers move
+/// down a level when the one below wraps around, so adding, clearing and firing a timer take constant time. The wheel
+/// doesn't run on its own, the script engine advances it once per frame and fires all the timers that came due.
+class ScriptTimerWheel {
+public:
+    using TimerID = int;
+
+    static const TimerID INVALID_TIMER_ID = 0;
+
+    /// adds a timer that comes due intervalMS after now, and every intervalMS after that unless it is single shot
+    TimerID addTimer(quint64 nowMsecs, int intervalMS, bool isSingleShot);
+
+    /// false if there was no such timer, single shot timers are gone once they came due
+    bool removeTimer(TimerID timerID);
+
+    bool hasTimer(TimerID timerID) const { return _timers.contains(timerID); }
+    bool isEmpty() const { return _timers.isEmpty(); }
+    void clear();
+
+    /// moves the wheel up to now and appends the timers that came due to dueTimers, in the order they came due, interval
+    /// timers come due once at most, and the next time is an interval after this one or after now if they fell behind
+    void advance(quint64 nowMsecs, std::vector<TimerID>& dueTimers);
+
+private:
+    struct Timer {
+        quint64 expiry;
+        int intervalMS;
+        bool isSingleShot;
+    };
+
+    static const int FIRST_LEVEL_BITS = 8;
+    static const int LEVEL_BITS = 6;
+    static const int LEVEL_COUNT = 4;
+    static const int FIRST_LEVEL_SIZE = 1 << FIRST_LEVEL_BITS;
+    static const int LEVEL_SIZE = 1 << LEVEL_BITS;
+    static const quint64 MAX_TICKS = 1ULL << (FIRST_LEVEL_BITS + (LEVEL_COUNT - 1) * LEVEL_BITS);
+
+    using Slot = std::vector<TimerID>;
+
+    void schedule(TimerID timerID, quint64 expiry);
+    void cascade(Slot& slot);
+
+    QHash<TimerID, Timer> _timers;
+    TimerID _lastTimerID { INVALID_TIMER_ID };
+    quint64 _nextTick { 0 }; // the first tick the wheel hasn't been advanced past
+    int _scheduledCount { 0 }; // the ids in the slots, including the ones of removed timers
+
+    Slot _firstLevel[FIRST_LEVEL_SIZE];
+    Slot _levels[LEVEL_COUNT - 1][LEVEL_SIZE];
+    Slot _cascading;
+};
+
+#endif // hifi_ScriptTimerWheel_h
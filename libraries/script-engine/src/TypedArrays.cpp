@@ -9,8 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <string.h>
+
 #include <glm/glm.hpp>
 
+#include <QtCore/QtEndian>
+
 #include "ScriptEngine.h"
 #include "TypedArrayPrototype.h"
 
@@ -196,30 +200,40 @@ void TypedArray::setBytesPerElement(quint32 bytesPerElement) {
 }
 
 // templated helper functions
+// the elements are big endian, they are read and written in place rather than through a QDataStream, so that reading
+// a buffer that is shared with native code never copies it, and writing to it only copies it the first time
+template<class T>
+bool isElementInBuffer(const QByteArray* arrayBuffer, uint id) {
+    return arrayBuffer && id + sizeof(T) <= (uint)arrayBuffer->size();
+}
+
+template<class T>
+T readElement(const QByteArray* arrayBuffer, uint id) {
+    return qFromBigEndian<T>(reinterpret_cast<const uchar*>(arrayBuffer->constData()) + id);
+}
+
+template<class T>
+void writeElement(QByteArray* arrayBuffer, uint id, T value) {
+    // data() detaches a buffer that is still shared, so that the script never writes to memory it doesn't own
+    qToBigEndian<T>(value, reinterpret_cast<uchar*>(arrayBuffer->data()) + id);
+}
+
 // don't work for floats as they require single precision settings
 template<class T>
 QScriptValue propertyHelper(const QByteArray* arrayBuffer, const QScriptString& name, uint id) {
     bool ok = false;
     name.toArrayIndex(&ok);
     
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        
-        T result;
-        stream >> result;
-        return result;
+    if (ok && isElementInBuffer<T>(arrayBuffer, id)) {
+        return readElement<T>(arrayBuffer, id);
     }
     return QScriptValue();
 }
 
 template<class T>
 void setPropertyHelper(QByteArray* arrayBuffer, const QScriptString& name, uint id, const QScriptValue& value) {
-    if (arrayBuffer && value.isNumber()) {
-        QDataStream stream(arrayBuffer, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        
-        stream << (T)value.toNumber();
+    if (isElementInBuffer<T>(arrayBuffer, id) && value.isNumber()) {
+        writeElement<T>(arrayBuffer, id, (T)value.toNumber());
     }
 }
 
@@ -268,15 +282,13 @@ QScriptValue Uint8ClampedArrayClass::property(const QScriptValue& object, const
 void Uint8ClampedArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
+    if (isElementInBuffer<quint8>(ba, id) && value.isNumber()) {
         if (value.toNumber() > 255) {
-            stream << (quint8)255;
+            writeElement<quint8>(ba, id, 255);
         } else if (value.toNumber() < 0) {
-            stream << (quint8)0;
+            writeElement<quint8>(ba, id, 0);
         } else {
-            stream << (quint8)glm::clamp(qRound(value.toNumber()), 0, 255);
+            writeElement<quint8>(ba, id, (quint8)glm::clamp(qRound(value.toNumber()), 0, 255));
         }
     }
 }
@@ -354,13 +366,10 @@ QScriptValue Float32ArrayClass::property(const QScriptValue& object, const QScri
     QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());bool ok = false;
     name.toArrayIndex(&ok);
     
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-        
+    if (ok && isElementInBuffer<quint32>(arrayBuffer, id)) {
+        quint32 bits = readElement<quint32>(arrayBuffer, id);
         float result;
-        stream >> result;
+        memcpy(&result, &bits, sizeof(result));
         if (isNaN(result)) {
             return QScriptValue();
         }
@@ -372,12 +381,11 @@ QScriptValue Float32ArrayClass::property(const QScriptValue& object, const QScri
 void Float32ArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-        
-        stream << (float)value.toNumber();
+    if (isElementInBuffer<quint32>(ba, id) && value.isNumber()) {
+        float result = (float)value.toNumber();
+        quint32 bits;
+        memcpy(&bits, &result, sizeof(bits));
+        writeElement<quint32>(ba, id, bits);
     }
 }
 
@@ -389,13 +397,10 @@ QScriptValue Float64ArrayClass::property(const QScriptValue& object, const QScri
     QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());bool ok = false;
     name.toArrayIndex(&ok);
     
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
-        
+    if (ok && isElementInBuffer<quint64>(arrayBuffer, id)) {
+        quint64 bits = readElement<quint64>(arrayBuffer, id);
         double result;
-        stream >> result;
+        memcpy(&result, &bits, sizeof(result));
         if (isNaN(result)) {
             return QScriptValue();
         }
@@ -407,12 +412,11 @@ QScriptValue Float64ArrayClass::property(const QScriptValue& object, const QScri
 void Float64ArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
-        
-        stream << (double)value.toNumber();
+    if (isElementInBuffer<quint64>(ba, id) && value.isNumber()) {
+        double result = (double)value.toNumber();
+        quint64 bits;
+        memcpy(&bits, &result, sizeof(bits));
+        writeElement<quint64>(ba, id, bits);
     }
 }
 
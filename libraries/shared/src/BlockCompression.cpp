@@ -0,0 +1,303 @@
+//
+//  BlockCompression.cpp
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+
+#include <glm/glm.hpp>
+
+using namespace BlockCompression;
+
+namespace {
+
+const int BLOCK_WIDTH = 4;
+const int BLOCK_PIXELS = BLOCK_WIDTH * BLOCK_WIDTH;
+
+const int POWER_ITERATIONS = 8;
+
+void fetchBlock(const QRgb* pixels, int width, int height, int pixelsPerLine, int x, int y, QRgb block[BLOCK_PIXELS]) {
+    for (int j = 0; j < BLOCK_WIDTH; j++) {
+        const QRgb* row = pixels + std::min(y + j, height - 1) * pixelsPerLine;
+        for (int i = 0; i < BLOCK_WIDTH; i++) {
+            block[j * BLOCK_WIDTH + i] = row[std::min(x + i, width - 1)];
+        }
+    }
+}
+
+void storeBlock(const QRgb block[BLOCK_PIXELS], int width, int height, int x, int y, QVector<QRgb>& pixels) {
+    for (int j = 0; j < BLOCK_WIDTH && y + j < height; j++) {
+        for (int i = 0; i < BLOCK_WIDTH && x + i < width; i++) {
+            pixels[(y + j) * width + x + i] = block[j * BLOCK_WIDTH + i];
+        }
+    }
+}
+
+uint16_t toRGB565(const glm::vec3& color) {
+    glm::ivec3 quantized = glm::clamp(glm::ivec3(color * glm::vec3(31.0f, 63.0f, 31.0f) / 255.0f + 0.5f),
+                                      glm::ivec3(0), glm::ivec3(31, 63, 31));
+    return (uint16_t)((quantized.r << 11) | (quantized.g << 5) | quantized.b);
+}
+
+glm::ivec3 fromRGB565(uint16_t color) {
+    int r = (color >> 11) & 31;
+    int g = (color >> 5) & 63;
+    int b = color & 31;
+    return glm::ivec3((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+void writeUInt16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+uint16_t readUInt16(const uint8_t* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+// The 4 colors of the block, the 3 colors and black when the first doesn't come above the second
+void evalColorPalette(uint16_t color0, uint16_t color1, bool alwaysFourColors, glm::ivec3 palette[4]) {
+    palette[0] = fromRGB565(color0);
+    palette[1] = fromRGB565(color1);
+    if (alwaysFourColors || color0 > color1) {
+        palette[2] = (2 * palette[0] + palette[1]) / 3;
+        palette[3] = (palette[0] + 2 * palette[1]) / 3;
+    } else {
+        palette[2] = (palette[0] + palette[1]) / 2;
+        palette[3] = glm::ivec3(0);
+    }
+}
+
+// The endpoints are the extremes of the colors along their principal axis, the indices pick the closest of the palette
+void compressColorBlock(const QRgb block[BLOCK_PIXELS], uint8_t* out) {
+    glm::vec3 colors[BLOCK_PIXELS];
+    glm::vec3 mean(0.0f);
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        colors[i] = glm::vec3(qRed(block[i]), qGreen(block[i]), qBlue(block[i]));
+        mean += colors[i];
+    }
+    mean /= (float)BLOCK_PIXELS;
+
+    glm::mat3 covariance(0.0f);
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        glm::vec3 offset = colors[i] - mean;
+        covariance += glm::outerProduct(offset, offset);
+    }
+    glm::vec3 axis(1.0f);
+    for (int i = 0; i < POWER_ITERATIONS; i++) {
+        glm::vec3 next = covariance * axis;
+        float length = glm::length(next);
+        if (length < 1.0e-6f) {
+            break;
+        }
+        axis = next / length;
+    }
+
+    float minProjection = FLT_MAX;
+    float maxProjection = -FLT_MAX;
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        float projection = glm::dot(colors[i] - mean, axis);
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+    uint16_t color0 = toRGB565(mean + maxProjection * axis);
+    uint16_t color1 = toRGB565(mean + minProjection * axis);
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+    writeUInt16(out, color0);
+    writeUInt16(out + 2, color1);
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        glm::ivec3 palette[4];
+        evalColorPalette(color0, color1, true, palette);
+        for (int i = 0; i < BLOCK_PIXELS; i++) {
+            int bestIndex = 0;
+            float bestDistance = FLT_MAX;
+            for (int j = 0; j < 4; j++) {
+                glm::vec3 offset = colors[i] - glm::vec3(palette[j]);
+                float distance = glm::dot(offset, offset);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    bestIndex = j;
+                }
+            }
+            indices |= (uint32_t)bestIndex << (2 * i);
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        out[4 + i] = (uint8_t)(indices >> (8 * i));
+    }
+}
+
+void decompressColorBlock(const uint8_t* in, bool alwaysFourColors, QRgb block[BLOCK_PIXELS]) {
+    uint16_t color0 = readUInt16(in);
+    uint16_t color1 = readUInt16(in + 2);
+    glm::ivec3 palette[4];
+    evalColorPalette(color0, color1, alwaysFourColors, palette);
+    bool hasTransparent = !alwaysFourColors && color0 <= color1;
+
+    uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | ((uint32_t)in[7] << 24);
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        int index = (indices >> (2 * i)) & 3;
+        int alpha = (hasTransparent && index == 3) ? 0 : 255;
+        block[i] = qRgba(palette[index].r, palette[index].g, palette[index].b, alpha);
+    }
+}
+
+// The 8 values of the block, or 6 and the two extremes when the first doesn't come above the second
+void evalChannelPalette(uint8_t value0, uint8_t value1, int palette[8]) {
+    palette[0] = value0;
+    palette[1] = value1;
+    if (value0 > value1) {
+        for (int i = 2; i < 8; i++) {
+            palette[i] = ((8 - i) * value0 + (i - 1) * value1) / 7;
+        }
+    } else {
+        for (int i = 2; i < 6; i++) {
+            palette[i] = ((6 - i) * value0 + (i - 1) * value1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void compressChannelBlock(const uint8_t values[BLOCK_PIXELS], uint8_t* out) {
+    uint8_t minValue = *std::min_element(values, values + BLOCK_PIXELS);
+    uint8_t maxValue = *std::max_element(values, values + BLOCK_PIXELS);
+    out[0] = maxValue;
+    out[1] = minValue;
+
+    uint64_t indices = 0;
+    if (maxValue != minValue) {
+        int palette[8];
+        evalChannelPalette(maxValue, minValue, palette);
+        for (int i = 0; i < BLOCK_PIXELS; i++) {
+            int bestIndex = 0;
+            int bestDistance = INT_MAX;
+            for (int j = 0; j < 8; j++) {
+                int distance = std::abs(values[i] - palette[j]);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    bestIndex = j;
+                }
+            }
+            indices |= (uint64_t)bestIndex << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        out[2 + i] = (uint8_t)(indices >> (8 * i));
+    }
+}
+
+void decompressChannelBlock(const uint8_t* in, uint8_t values[BLOCK_PIXELS]) {
+    int palette[8];
+    evalChannelPalette(in[0], in[1], palette);
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; i++) {
+        indices |= (uint64_t)in[2 + i] << (8 * i);
+    }
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        values[i] = (uint8_t)palette[(indices >> (3 * i)) & 7];
+    }
+}
+
+}
+
+int BlockCompression::getBlockSize(Format format) {
+    return (format == BC1) ? 8 : 16;
+}
+
+int BlockCompression::evalCompressedSize(Format format, int width, int height) {
+    return ((width + BLOCK_WIDTH - 1) / BLOCK_WIDTH) * ((height + BLOCK_WIDTH - 1) / BLOCK_WIDTH) * getBlockSize(format);
+}
+
+QByteArray BlockCompression::compress(Format format, const QRgb* pixels, int width, int height, int pixelsPerLine) {
+    QByteArray blocks(evalCompressedSize(format, width, height), 0);
+    uint8_t* out = (uint8_t*)blocks.data();
+
+    QRgb block[BLOCK_PIXELS];
+    uint8_t channel[BLOCK_PIXELS];
+    for (int y = 0; y < height; y += BLOCK_WIDTH) {
+        for (int x = 0; x < width; x += BLOCK_WIDTH) {
+            fetchBlock(pixels, width, height, pixelsPerLine, x, y, block);
+            switch (format) {
+                case BC1:
+                    compressColorBlock(block, out);
+                    break;
+
+                case BC3:
+                    for (int i = 0; i < BLOCK_PIXELS; i++) {
+                        channel[i] = (uint8_t)qAlpha(block[i]);
+                    }
+                    compressChannelBlock(channel, out);
+                    compressColorBlock(block, out + 8);
+                    break;
+
+                case BC5:
+                    for (int i = 0; i < BLOCK_PIXELS; i++) {
+                        channel[i] = (uint8_t)qRed(block[i]);
+                    }
+                    compressChannelBlock(channel, out);
+                    for (int i = 0; i < BLOCK_PIXELS; i++) {
+                        channel[i] = (uint8_t)qGreen(block[i]);
+                    }
+                    compressChannelBlock(channel, out + 8);
+                    break;
+            }
+            out += getBlockSize(format);
+        }
+    }
+    return blocks;
+}
+
+QVector<QRgb> BlockCompression::decompress(Format format, const QByteArray& blocks, int width, int height) {
+    QVector<QRgb> pixels(width * height);
+    if (blocks.size() < evalCompressedSize(format, width, height)) {
+        return pixels;
+    }
+    const uint8_t* in = (const uint8_t*)blocks.constData();
+
+    QRgb block[BLOCK_PIXELS];
+    uint8_t channel[BLOCK_PIXELS];
+    uint8_t secondChannel[BLOCK_PIXELS];
+    for (int y = 0; y < height; y += BLOCK_WIDTH) {
+        for (int x = 0; x < width; x += BLOCK_WIDTH) {
+            switch (format) {
+                case BC1:
+                    decompressColorBlock(in, false, block);
+                    break;
+
+                case BC3:
+                    decompressChannelBlock(in, channel);
+                    decompressColorBlock(in + 8, true, block);
+                    for (int i = 0; i < BLOCK_PIXELS; i++) {
+                        block[i] = qRgba(qRed(block[i]), qGreen(block[i]), qBlue(block[i]), channel[i]);
+                    }
+                    break;
+
+                case BC5:
+                    decompressChannelBlock(in, channel);
+                    decompressChannelBlock(in + 8, secondChannel);
+                    for (int i = 0; i < BLOCK_PIXELS; i++) {
+                        block[i] = qRgba(channel[i], secondChannel[i], 0, 255);
+                    }
+                    break;
+            }
+            storeBlock(block, width, height, x, y, pixels);
+            in += getBlockSize(format);
+        }
+    }
+    return pixels;
+}
@@ -0,0 +1,38 @@
+//
+//  BlockCompression.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BlockCompression_h
+#define hifi_BlockCompression_h
+
+#include <QByteArray>
+#include <QColor>
+#include <QVector>
+
+// Compression of images into the blocks of 4x4 pixels that the gpus sample directly. The blocks go row after row, the
+// ones on the right and bottom edges repeating the last column and row of the image.
+namespace BlockCompression {
+
+    enum Format {
+        BC1, // the colors in 8 bytes per block, no alpha
+        BC3, // the alpha in 8 bytes followed by the colors in 8 more
+        BC5, // the red then the green channel in 8 bytes each, for the normal maps
+    };
+
+    int getBlockSize(Format format);
+    int evalCompressedSize(Format format, int width, int height);
+
+    // Compress the pixels of the image, pixelsPerLine apart from row to row
+    QByteArray compress(Format format, const QRgb* pixels, int width, int height, int pixelsPerLine);
+
+    // Decode the blocks back to pixels, BC5 giving the two channels in red and green
+    QVector<QRgb> decompress(Format format, const QByteArray& blocks, int width, int height);
+}
+
+#endif // hifi_BlockCompression_h
@@ -0,0 +1,116 @@
+//
+//  CPUDetect.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CPUDetect_h
+#define hifi_CPUDetect_h
+
+#include <stdint.h>
+
+//
+// Runtime detection of the instruction sets beyond the SSE2 that every x86 build assumes, and of NEON on ARM
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#if defined(_MSC_VER)
+
+#include <intrin.h>
+
+static inline void cpuidex(int info[4], int function, int subfunction) {
+    __cpuidex(info, function, subfunction);
+}
+
+static inline uint64_t xgetbv(uint32_t index) {
+    return _xgetbv(index);
+}
+
+#else
+
+#include <cpuid.h>
+
+static inline void cpuidex(int info[4], int function, int subfunction) {
+    __cpuid_count(function, subfunction, info[0], info[1], info[2], info[3]);
+}
+
+static inline uint64_t xgetbv(uint32_t index) {
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+    return ((uint64_t)edx << 32) | eax;
+}
+
+#endif
+
+// AVX2 and FMA, and an OS that saves the YMM registers across context switches
+static inline bool cpuSupportsAVX2() {
+    const int OSXSAVE_BIT = 1 << 27;
+    const int AVX_BIT = 1 << 28;
+    const int FMA_BIT = 1 << 12;
+    const int AVX2_BIT = 1 << 5;
+    const uint64_t XMM_YMM_STATE = 0x6;
+
+    int info[4];
+    cpuidex(info, 0, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    cpuidex(info, 1, 0);
+    if ((info[2] & OSXSAVE_BIT) == 0 || (info[2] & AVX_BIT) == 0 || (info[2] & FMA_BIT) == 0) {
+        return false;
+    }
+    if ((xgetbv(0) & XMM_YMM_STATE) != XMM_YMM_STATE) {
+        return false;
+    }
+
+    cpuidex(info, 7, 0);
+    return (info[1] & AVX2_BIT) != 0;
+}
+
+static inline bool cpuSupportsNEON() {
+    return false;
+}
+
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON__) || defined(__ARM_NEON)
+
+static inline bool cpuSupportsAVX2() {
+    return false;
+}
+
+// part of ARMv8, and assumed by the 32-bit builds made for it
+static inline bool cpuSupportsNEON() {
+    return true;
+}
+
+#elif defined(__arm__) && defined(__linux__)
+
+#include <sys/auxv.h>
+
+static inline bool cpuSupportsAVX2() {
+    return false;
+}
+
+// armeabi-v7a does not guarantee NEON, the kernel reports it (Android included)
+static inline bool cpuSupportsNEON() {
+    const unsigned long HWCAP_NEON_BIT = 1 << 12;
+    return (getauxval(AT_HWCAP) & HWCAP_NEON_BIT) != 0;
+}
+
+#else
+
+static inline bool cpuSupportsAVX2() {
+    return false;
+}
+
+static inline bool cpuSupportsNEON() {
+    return false;
+}
+
+#endif
+
+#endif // hifi_CPUDetect_h
@@ -17,6 +17,7 @@
 #include <QSharedPointer>
 #include <QWeakPointer>
 
+#include <atomic>
 #include <functional>
 #include <typeinfo>
 
@@ -41,6 +42,7 @@ protected:
 
 // usage:
 //     auto instance = DependencyManager::get<T>();
+//     T* instance = DependencyManager::getRaw<T>(); // no reference is taken, for hot paths that don't keep it
 //     auto instance = DependencyManager::set<T>(Args... args);
 //     DependencyManager::destroy<T>();
 //     DependencyManager::registerInheritance<Base, Derived>();
@@ -48,6 +50,10 @@ class DependencyManager {
 public:
     template<typename T>
     static QSharedPointer<T> get();
+
+    // the instance without taking a reference to it, valid until it is set again or destroyed
+    template<typename T>
+    static T* getRaw();
     
     template<typename T, typename ...Args>
     static QSharedPointer<T> set(Args&&... args);
@@ -62,8 +68,20 @@ public:
     static void registerInheritance();
     
 private:
+    // The instance of a type as it was when the instances last changed. Every type has one, resolved again only on
+    // the first lookup after a set or destroy of any type, so lookups don't go through the hash.
+    template<typename T>
+    struct Slot {
+        std::atomic<int> generation { -1 };
+        std::atomic<T*> pointer { nullptr };
+        QWeakPointer<T> instance;
+    };
+
     static DependencyManager& manager();
 
+    template<typename T>
+    static Slot<T>& getSlot();
+
     template<typename T>
     size_t getHashCode();
     
@@ -71,22 +89,37 @@ private:
     
     QHash<size_t, QSharedPointer<Dependency>> _instanceHash;
     QHash<size_t, size_t> _inheritanceHash;
+    std::atomic<int> _generation { 0 }; // raised by every set and destroy
 };
 
 template <typename T>
-QSharedPointer<T> DependencyManager::get() {
+DependencyManager::Slot<T>& DependencyManager::getSlot() {
     static size_t hashCode = manager().getHashCode<T>();
-    static QWeakPointer<T> instance;
-    
-    if (instance.isNull()) {
-        instance = qSharedPointerCast<T>(manager().safeGet(hashCode));
-        
+    static Slot<T> slot;
+
+    int generation = manager()._generation.load(std::memory_order_acquire);
+    if (slot.generation.load(std::memory_order_acquire) != generation) {
+        QSharedPointer<T> instance = qSharedPointerCast<T>(manager().safeGet(hashCode));
+        slot.instance = instance;
+        slot.pointer.store(instance.data(), std::memory_order_relaxed);
+        slot.generation.store(generation, std::memory_order_release);
+
         if (instance.isNull()) {
             qWarning() << "DependencyManager::get(): No instance available for" << typeid(T).name();
         }
     }
-    
-    return instance.toStrongRef();
+
+    return slot;
+}
+
+template <typename T>
+QSharedPointer<T> DependencyManager::get() {
+    return getSlot<T>().instance.toStrongRef();
+}
+
+template <typename T>
+T* DependencyManager::getRaw() {
+    return getSlot<T>().pointer.load(std::memory_order_relaxed);
 }
 
 template <typename T, typename ...Args>
@@ -95,9 +128,11 @@ QSharedPointer<T> DependencyManager::set(Args&&... args) {
 
     QSharedPointer<Dependency>& instance = manager().safeGet(hashCode);
     instance.clear(); // Clear instance before creation of new one to avoid edge cases
+    manager()._generation.fetch_add(1, std::memory_order_release);
     QSharedPointer<T> newInstance(new T(args...), &T::customDeleter);
     QSharedPointer<Dependency> storedInstance = qSharedPointerCast<Dependency>(newInstance);
     instance.swap(storedInstance);
+    manager()._generation.fetch_add(1, std::memory_order_release);
 
     return newInstance;
 }
@@ -108,9 +143,11 @@ QSharedPointer<T> DependencyManager::set(Args&&... args) {
 
     QSharedPointer<Dependency>& instance = manager().safeGet(hashCode);
     instance.clear(); // Clear instance before creation of new one to avoid edge cases
+    manager()._generation.fetch_add(1, std::memory_order_release);
     QSharedPointer<T> newInstance(new I(args...), &I::customDeleter);
     QSharedPointer<Dependency> storedInstance = qSharedPointerCast<Dependency>(newInstance);
     instance.swap(storedInstance);
+    manager()._generation.fetch_add(1, std::memory_order_release);
 
     return newInstance;
 }
@@ -119,6 +156,7 @@ template <typename T>
 void DependencyManager::destroy() {
     static size_t hashCode = manager().getHashCode<T>();
     manager().safeGet(hashCode).clear();
+    manager()._generation.fetch_add(1, std::memory_order_release);
 }
 
 template<typename Base, typename Derived>
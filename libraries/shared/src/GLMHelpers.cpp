@@ -134,6 +134,67 @@ int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatO
     return sizeof(quatParts);
 }
 
+static const int SMALLEST_THREE_COMPONENT_BITS = 15;
+static const int SMALLEST_THREE_COMPONENT_MAX = (1 << SMALLEST_THREE_COMPONENT_BITS) - 1;
+static const int SMALLEST_THREE_NUM_BYTES = 6;
+static const float SQUARE_ROOT_OF_TWO = 1.41421356f;
+
+int packOrientationQuatToSixBytes(unsigned char* buffer, const glm::quat& quatInput) {
+    glm::quat quatNormalized = glm::normalize(quatInput);
+    float components[4] = { quatNormalized.x, quatNormalized.y, quatNormalized.z, quatNormalized.w };
+
+    int largestIndex = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(components[i]) > fabsf(components[largestIndex])) {
+            largestIndex = i;
+        }
+    }
+
+    // q and -q are the same rotation, so flip the quat to make the dropped component positive
+    float sign = (components[largestIndex] < 0.0f) ? -1.0f : 1.0f;
+
+    uint64_t packed = largestIndex;
+    int shift = 2;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float normalized = (sign * components[i] * SQUARE_ROOT_OF_TWO + 1.0f) * 0.5f;
+            uint64_t part = (uint64_t)glm::clamp((int)roundf(normalized * SMALLEST_THREE_COMPONENT_MAX), 0,
+                                                 SMALLEST_THREE_COMPONENT_MAX);
+            packed |= part << shift;
+            shift += SMALLEST_THREE_COMPONENT_BITS;
+        }
+    }
+
+    for (int i = 0; i < SMALLEST_THREE_NUM_BYTES; i++) {
+        buffer[i] = (unsigned char)(packed >> (8 * i));
+    }
+    return SMALLEST_THREE_NUM_BYTES;
+}
+
+int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& quatOutput) {
+    uint64_t packed = 0;
+    for (int i = 0; i < SMALLEST_THREE_NUM_BYTES; i++) {
+        packed |= (uint64_t)buffer[i] << (8 * i);
+    }
+
+    int largestIndex = packed & 3;
+    float components[4];
+    float sumOfSquares = 0.0f;
+    int shift = 2;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            int part = (packed >> shift) & SMALLEST_THREE_COMPONENT_MAX;
+            components[i] = ((part / (float)SMALLEST_THREE_COMPONENT_MAX) * 2.0f - 1.0f) / SQUARE_ROOT_OF_TWO;
+            sumOfSquares += components[i] * components[i];
+            shift += SMALLEST_THREE_COMPONENT_BITS;
+        }
+    }
+    components[largestIndex] = sqrtf(glm::max(0.0f, 1.0f - sumOfSquares));
+
+    quatOutput = glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+    return SMALLEST_THREE_NUM_BYTES;
+}
+
 //  Safe version of glm::eulerAngles; uses the factorization method described in David Eberly's
 //  http://www.geometrictools.com/Documentation/EulerAngles.pdf (via Clyde,
 // https://github.com/threerings/clyde/blob/master/src/main/java/com/threerings/math/Quaternion.java)
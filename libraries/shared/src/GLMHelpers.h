@@ -95,6 +95,11 @@ int unpackFloatAngleFromTwoByte(const uint16_t* byteAnglePointer, float* destina
 int packOrientationQuatToBytes(unsigned char* buffer, const glm::quat& quatInput);
 int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatOutput);
 
+// The largest component of a normalized quat can be rebuilt from the other three, which are between -1/sqrt(2) and
+// 1/sqrt(2), this allows us to encode the index of the largest and 15bits for each of the others in six bytes
+int packOrientationQuatToSixBytes(unsigned char* buffer, const glm::quat& quatInput);
+int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& quatOutput);
+
 // Ratios need the be highly accurate when less than 10, but not very accurate above 10, and they
 // are never greater than 1000 to 1, this allows us to encode each component in 16bits
 int packFloatRatioToTwoByte(unsigned char* buffer, float ratio);
@@ -11,12 +11,15 @@
 #define hifi_GenericQueueThread_h
 
 #include <stdint.h>
+#include <climits>
+#include <vector>
 
 #include <QQueue>
 #include <QMutex>
 #include <QWaitCondition>
 
 #include "GenericThread.h"
+#include "MPSCQueue.h"
 #include "NumericalConstants.h"
 
 template <typename T>
@@ -69,4 +72,58 @@ protected:
     QMutex _hasItemsMutex;
 };
 
+/// A GenericQueueThread whose producers queue items without taking a lock, and whose thread drains them in batches.
+/// Producers only take a lock to wake the thread when it is parked waiting for items.
+template <typename T>
+class LockFreeQueueThread : public GenericThread {
+public:
+    using Queue = std::vector<T>;
+    LockFreeQueueThread(QObject* parent = nullptr)
+        : GenericThread() {}
+
+    virtual ~LockFreeQueueThread() {}
+
+    void queueItem(const T& t) {
+        _items.push(t);
+        _parker.notify();
+    }
+
+    virtual void terminating() {
+        _parker.wakeAll();
+    }
+
+protected:
+    virtual uint32_t getMaxWait() {
+        return MSECS_PER_SECOND;
+    }
+
+    /// the most items handed to processQueueItems at once
+    virtual int getMaxBatchSize() {
+        return INT_MAX;
+    }
+
+    /// the times the thread checks for items before it parks, for threads that can't wait for the wake up
+    virtual int getSpinCount() {
+        return 0;
+    }
+
+    virtual bool process() {
+        if (!_parker.wait([this] { return !_items.isEmpty() || !isStillRunning(); }, getSpinCount(), getMaxWait())) {
+            return isStillRunning();
+        }
+
+        _batch.clear();
+        if (!_items.drain(_batch, getMaxBatchSize())) {
+            return isStillRunning();
+        }
+        return processQueueItems(_batch);
+    }
+
+    virtual bool processQueueItems(const Queue& items) = 0;
+
+    MPSCQueue<T> _items;
+    ConsumerParker _parker;
+    Queue _batch; // kept between batches for its capacity
+};
+
 #endif // hifi_GenericQueueThread_h
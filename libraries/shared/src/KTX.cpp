@@ -0,0 +1,121 @@
+//
+//  KTX.cpp
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "KTX.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace {
+
+const char IDENTIFIER[] = { '\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n' };
+const int IDENTIFIER_SIZE = sizeof(IDENTIFIER);
+
+const uint32_t ENDIANNESS = 0x04030201;
+
+// After the identifier: endianness, glType, glTypeSize, glFormat, glInternalFormat, glBaseInternalFormat,
+// pixelWidth, pixelHeight, pixelDepth, numberOfArrayElements, numberOfFaces, numberOfMipmapLevels, bytesOfKeyValueData
+const int NUM_HEADER_FIELDS = 13;
+const int HEADER_SIZE = IDENTIFIER_SIZE + NUM_HEADER_FIELDS * sizeof(uint32_t);
+
+// The compressed formats have no type and a type size of 1
+const uint32_t COMPRESSED_TYPE_SIZE = 1;
+
+const int ALIGNMENT = 4;
+
+void appendUInt32(QByteArray& data, uint32_t value) {
+    char bytes[sizeof(uint32_t)];
+    for (int i = 0; i < (int)sizeof(uint32_t); i++) {
+        bytes[i] = (char)((value >> (8 * i)) & 0xFF);
+    }
+    data.append(bytes, sizeof(uint32_t));
+}
+
+uint32_t readUInt32(const QByteArray& data, int offset) {
+    const uint8_t* bytes = (const uint8_t*)data.constData() + offset;
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+int evalPadding(int size) {
+    return (ALIGNMENT - size % ALIGNMENT) % ALIGNMENT;
+}
+
+}
+
+QByteArray KTX::write(const Image& image) {
+    QByteArray data;
+    data.append(IDENTIFIER, IDENTIFIER_SIZE);
+    appendUInt32(data, ENDIANNESS);
+    appendUInt32(data, 0); // glType
+    appendUInt32(data, COMPRESSED_TYPE_SIZE);
+    appendUInt32(data, 0); // glFormat
+    appendUInt32(data, image.glInternalFormat);
+    appendUInt32(data, image.glBaseInternalFormat);
+    appendUInt32(data, image.width);
+    appendUInt32(data, image.height);
+    appendUInt32(data, 0); // pixelDepth
+    appendUInt32(data, 0); // numberOfArrayElements
+    appendUInt32(data, 1); // numberOfFaces
+    appendUInt32(data, image.mips.size());
+    appendUInt32(data, 0); // bytesOfKeyValueData
+
+    const char PADDING[ALIGNMENT] = { 0 };
+    foreach (const QByteArray& mip, image.mips) {
+        appendUInt32(data, mip.size());
+        data.append(mip);
+        data.append(PADDING, evalPadding(mip.size()));
+    }
+    return data;
+}
+
+bool KTX::read(const QByteArray& data, Image& image) {
+    if (data.size() < HEADER_SIZE || memcmp(data.constData(), IDENTIFIER, IDENTIFIER_SIZE) != 0) {
+        return false;
+    }
+    uint32_t fields[NUM_HEADER_FIELDS];
+    for (int i = 0; i < NUM_HEADER_FIELDS; i++) {
+        fields[i] = readUInt32(data, IDENTIFIER_SIZE + i * sizeof(uint32_t));
+    }
+    uint32_t endianness = fields[0];
+    uint32_t glType = fields[1];
+    uint32_t glFormat = fields[3];
+    uint32_t pixelDepth = fields[8];
+    uint32_t numberOfArrayElements = fields[9];
+    uint32_t numberOfFaces = fields[10];
+    uint32_t numberOfMipmapLevels = fields[11];
+    uint32_t bytesOfKeyValueData = fields[12];
+    if (endianness != ENDIANNESS || glType != 0 || glFormat != 0 || pixelDepth != 0 ||
+            numberOfArrayElements != 0 || numberOfFaces != 1) {
+        return false;
+    }
+    image.glInternalFormat = fields[4];
+    image.glBaseInternalFormat = fields[5];
+    image.width = fields[6];
+    image.height = fields[7];
+
+    // no mip levels means the reader should generate them, there's still the full size
+    uint32_t numMips = std::max(numberOfMipmapLevels, (uint32_t)1);
+
+    int64_t offset = (int64_t)HEADER_SIZE + bytesOfKeyValueData;
+    image.mips.clear();
+    for (uint32_t i = 0; i < numMips; i++) {
+        if (offset + (int64_t)sizeof(uint32_t) > data.size()) {
+            return false;
+        }
+        int64_t mipSize = readUInt32(data, (int)offset);
+        offset += sizeof(uint32_t);
+        if (offset + mipSize > data.size()) {
+            return false;
+        }
+        image.mips.push_back(data.mid((int)offset, (int)mipSize));
+        offset += mipSize + evalPadding((int)mipSize);
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+//
+//  KTX.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_KTX_h
+#define hifi_KTX_h
+
+#include <stdint.h>
+
+#include <QByteArray>
+#include <QVector>
+
+// The KTX files holding the compressed mips of a 2D texture, as the gl takes them
+namespace KTX {
+
+    class Image {
+    public:
+        uint32_t glInternalFormat { 0 };
+        uint32_t glBaseInternalFormat { 0 };
+        uint32_t width { 0 };
+        uint32_t height { 0 };
+
+        // the compressed blocks of each mip, the full size first
+        QVector<QByteArray> mips;
+    };
+
+    QByteArray write(const Image& image);
+
+    // Read a file of compressed mips of a single 2D face, false for anything else or if truncated
+    bool read(const QByteArray& data, Image& image);
+}
+
+#endif // hifi_KTX_h
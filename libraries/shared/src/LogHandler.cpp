@@ -10,6 +10,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <chrono>
+
 #include <qcoreapplication.h>
 
 #include <QDateTime>
@@ -17,9 +19,12 @@
 #include <QTimer>
 #include <QThread>
 #include <QMutexLocker>
-#include <QRegExp>
+#include <QStringList>
 
 #include "LogHandler.h"
+#include "NumericalConstants.h"
+
+static const int WRITER_WAIT_MSECS = 50; // how long the writer waits for a wake up it may have missed
 
 LogHandler& LogHandler::getInstance() {
     static LogHandler staticInstance;
@@ -40,6 +45,15 @@ LogHandler::LogHandler() :
     printf("%s\n", qPrintable(timezoneString));
 }
 
+LogHandler::~LogHandler() {
+    _isWriterStopping = true;
+    _writerCondition.notify_one();
+    if (_writerThread.joinable()) {
+        _writerThread.join();
+    }
+    writeQueuedMessages();
+}
+
 const char* stringForLogType(LogMsgType msgType) {
     switch (msgType) {
         case LogDebug:
@@ -61,35 +75,152 @@ const char* stringForLogType(LogMsgType msgType) {
 const QString DATE_STRING_FORMAT = "MM/dd hh:mm:ss";
 
 void LogHandler::flushRepeatedMessages() {
-    QMutexLocker locker(&_repeatedMessageLock);
-    QHash<QString, int>::iterator message = _repeatMessageCountHash.begin();
-    while (message != _repeatMessageCountHash.end()) {
+    // printed once the locks are released
+    QStringList suppressedMessages;
 
-        if (message.value() > 0) {
-            QString repeatMessage = QString("%1 repeated log entries matching \"%2\" - Last entry: \"%3\"")
-            .arg(message.value()).arg(message.key()).arg(_lastRepeatedMessage.value(message.key()));
+    {
+        QMutexLocker locker(&_repeatedMessageLock);
+        QHash<QString, int>::iterator message = _repeatMessageCountHash.begin();
+        while (message != _repeatMessageCountHash.end()) {
+
+            if (message.value() > 0) {
+                suppressedMessages << QString("%1 repeated log entries matching \"%2\" - Last entry: \"%3\"")
+                    .arg(message.value()).arg(message.key()).arg(_lastRepeatedMessage.value(message.key()));
+            }
+
+            _lastRepeatedMessage.remove(message.key());
+            message = _repeatMessageCountHash.erase(message);
+        }
+    }
 
-            QMessageLogContext emptyContext;
-            printMessage(LogSuppressed, emptyContext, repeatMessage);
+    {
+        QMutexLocker locker(&_rateLock);
+        for (auto rate = _categoryRates.begin(); rate != _categoryRates.end(); ++rate) {
+            if (rate.value().dropped > 0) {
+                suppressedMessages << QString("%1 log entries in category \"%2\" dropped past %3 a second")
+                    .arg(rate.value().dropped).arg(rate.key()).arg(MAX_LOG_MESSAGES_PER_CATEGORY_PER_SECOND);
+                rate.value().dropped = 0;
+            }
         }
+    }
+
+    QMessageLogContext emptyContext;
+    foreach(const QString& suppressedMessage, suppressedMessages) {
+        printMessage(LogSuppressed, emptyContext, suppressedMessage);
+    }
+}
+
+bool LogHandler::isRateLimited(LogMsgType type, const QMessageLogContext& context) {
+    if (type != LogDebug && type != LogWarning) {
+        return false;
+    }
+
+    static const char* DEFAULT_CATEGORY = "default";
+    const char* category = context.category ? context.category : DEFAULT_CATEGORY;
+    qint64 second = QDateTime::currentMSecsSinceEpoch() / (qint64)MSECS_PER_SECOND;
+
+    QMutexLocker locker(&_rateLock);
+    CategoryRate& rate = _categoryRates[category];
+    if (rate.second != second) {
+        rate.second = second;
+        rate.count = 0;
+    }
+    if (rate.count >= MAX_LOG_MESSAGES_PER_CATEGORY_PER_SECOND) {
+        ++rate.dropped;
+        return true;
+    }
+    ++rate.count;
+    return false;
+}
 
-        _lastRepeatedMessage.remove(message.key());
-        message = _repeatMessageCountHash.erase(message);
+QString LogHandler::getTimestampString() {
+    qint64 msecs = QDateTime::currentMSecsSinceEpoch();
+    qint64 second = msecs / (qint64)MSECS_PER_SECOND;
+
+    // the timestamp only changes once a second, so it is only formatted that often
+    QMutexLocker locker(&_rateLock);
+    if (second != _timestampSecond) {
+        _timestampSecond = second;
+        _timestampString = QDateTime::fromMSecsSinceEpoch(msecs).toString(DATE_STRING_FORMAT);
+    }
+    return _timestampString;
+}
+
+void LogHandler::queueMessage(const QString& logMessage) {
+    if (_isWriterStopping) {
+        fprintf(stdout, "%s\n", qPrintable(logMessage));
+        return;
+    }
+
+    std::call_once(_writerStarted, [this] {
+        _writerThread = std::thread([this] { runWriter(); });
+    });
+
+    QueuedMessage* queuedMessage = new QueuedMessage { logMessage.toLocal8Bit(), nullptr };
+    QueuedMessage* head = _queuedMessages.load(std::memory_order_relaxed);
+    do {
+        queuedMessage->next = head;
+    } while (!_queuedMessages.compare_exchange_weak(head, queuedMessage, std::memory_order_release,
+                                                    std::memory_order_relaxed));
+
+    if (!head) {
+        _writerCondition.notify_one();
+    }
+}
+
+void LogHandler::writeQueuedMessages() {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+
+    // the queue has the newest message first
+    QueuedMessage* queuedMessage = _queuedMessages.exchange(nullptr, std::memory_order_acquire);
+    QueuedMessage* oldestMessage = nullptr;
+    while (queuedMessage) {
+        QueuedMessage* next = queuedMessage->next;
+        queuedMessage->next = oldestMessage;
+        oldestMessage = queuedMessage;
+        queuedMessage = next;
     }
+
+    if (!oldestMessage) {
+        return;
+    }
+
+    while (oldestMessage) {
+        fprintf(stdout, "%s\n", oldestMessage->text.constData());
+        QueuedMessage* next = oldestMessage->next;
+        delete oldestMessage;
+        oldestMessage = next;
+    }
+    fflush(stdout);
+}
+
+void LogHandler::runWriter() {
+    while (!_isWriterStopping) {
+        writeQueuedMessages();
+
+        std::unique_lock<std::mutex> lock(_writerMutex);
+        _writerCondition.wait_for(lock, std::chrono::milliseconds(WRITER_WAIT_MSECS), [this] {
+            return _isWriterStopping || _queuedMessages.load(std::memory_order_relaxed) != nullptr;
+        });
+    }
+}
+
+void LogHandler::flush() {
+    writeQueuedMessages();
 }
 
 QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
 
-    if (message.isEmpty()) {
+    if (message.isEmpty() || isRateLimited(type, context)) {
         return QString();
     }
 
     if (type == LogDebug) {
         // for debug messages, check if this matches any of our regexes for repeated log messages
         QMutexLocker locker(&_repeatedMessageLock);
-        foreach(const QString& regexString, getInstance()._repeatedMessageRegexes) {
-            QRegExp repeatRegex(regexString);
-            if (repeatRegex.indexIn(message) != -1) {
+        for (auto regex = _repeatedMessageRegexes.constBegin(); regex != _repeatedMessageRegexes.constEnd(); ++regex) {
+            const QString& regexString = regex.key();
+            if (regex.value().match(message).hasMatch()) {
 
                 if (!_repeatMessageCountHash.contains(regexString)) {
                     // we have a match but didn't have this yet - output the first one
@@ -111,9 +242,8 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
     if (type == LogDebug) {
         QMutexLocker locker(&_onlyOnceMessageLock);
         // see if this message is one we should only print once
-        foreach(const QString& regexString, getInstance()._onlyOnceMessageRegexes) {
-            QRegExp onlyOnceRegex(regexString);
-            if (onlyOnceRegex.indexIn(message) != -1) {
+        for (auto regex = _onlyOnceMessageRegexes.constBegin(); regex != _onlyOnceMessageRegexes.constEnd(); ++regex) {
+            if (regex.value().match(message).hasMatch()) {
                 if (!_onlyOnceMessageCountHash.contains(message)) {
                     // we have a match and haven't yet printed this message.
                     _onlyOnceMessageCountHash[message] = 1;
@@ -130,7 +260,7 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
     // log prefix is in the following format
     // [TIMESTAMP] [DEBUG] [PID] [TID] [TARGET] logged string
 
-    QString prefixString = QString("[%1]").arg(QDateTime::currentDateTime().toString(DATE_STRING_FORMAT));
+    QString prefixString = QString("[%1]").arg(getTimestampString());
 
     prefixString.append(QString(" [%1]").arg(stringForLogType(type)));
 
@@ -148,7 +278,15 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
     }
 
     QString logMessage = QString("%1 %2").arg(prefixString, message.split("\n").join("\n" + prefixString + " "));
-    fprintf(stdout, "%s\n", qPrintable(logMessage));
+
+    if (type == LogFatal) {
+        // the process aborts once this returns, so everything is written out now
+        flush();
+        fprintf(stdout, "%s\n", qPrintable(logMessage));
+        fflush(stdout);
+    } else {
+        queueMessage(logMessage);
+    }
     return logMessage;
 }
 
@@ -158,10 +296,14 @@ void LogHandler::verboseMessageHandler(QtMsgType type, const QMessageLogContext&
 
 const QString& LogHandler::addRepeatedMessageRegex(const QString& regexString) {
     QMutexLocker locker(&_repeatedMessageLock);
-    return *_repeatedMessageRegexes.insert(regexString);
+    QRegularExpression regex(regexString);
+    regex.optimize();
+    return _repeatedMessageRegexes.insert(regexString, regex).key();
 }
 
 const QString& LogHandler::addOnlyOnceMessageRegex(const QString& regexString) {
     QMutexLocker locker(&_onlyOnceMessageLock);
-    return *_onlyOnceMessageRegexes.insert(regexString);
+    QRegularExpression regex(regexString);
+    regex.optimize();
+    return _onlyOnceMessageRegexes.insert(regexString, regex).key();
 }
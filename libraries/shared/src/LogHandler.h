@@ -13,14 +13,22 @@
 #ifndef hifi_LogHandler_h
 #define hifi_LogHandler_h
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include <QHash>
 #include <QObject>
-#include <QSet>
+#include <QRegularExpression>
 #include <QString>
 #include <QMutex>
 
 const int VERBOSE_LOG_INTERVAL_SECONDS = 5;
 
+// debug and warning messages past this in a second of one category are dropped, and counted with the repeated ones
+const int MAX_LOG_MESSAGES_PER_CATEGORY_PER_SECOND = 200;
+
 enum LogMsgType {
     LogDebug = QtDebugMsg,
     LogWarning = QtWarningMsg,
@@ -29,7 +37,8 @@ enum LogMsgType {
     LogSuppressed
 };
 
-/// Handles custom message handling and sending of stats/logs to Logstash instance
+/// Handles custom message handling and sending of stats/logs to Logstash instance. Messages are formatted on the
+/// thread that logs them and written out by a thread of the handler, so a burst of logging doesn't hold up a frame.
 class LogHandler : public QObject {
     Q_OBJECT
 public:
@@ -42,8 +51,12 @@ public:
     void setShouldOutputProcessID(bool shouldOutputProcessID) { _shouldOutputProcessID = shouldOutputProcessID; }
     void setShouldOutputThreadID(bool shouldOutputThreadID) { _shouldOutputThreadID = shouldOutputThreadID; }
 
+    /// \return the message as it is written out, or an empty string if it was suppressed
     QString printMessage(LogMsgType type, const QMessageLogContext& context, const QString &message);
 
+    /// writes out the messages that are still queued, before returning
+    void flush();
+
     /// a qtMessageHandler that can be hooked up to a target that links to Qt
     /// prints various process, message type, and time information
     static void verboseMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString &message);
@@ -51,21 +64,55 @@ public:
     const QString& addRepeatedMessageRegex(const QString& regexString);
     const QString& addOnlyOnceMessageRegex(const QString& regexString);
 private:
+    // a written out message on its way to the writer thread
+    struct QueuedMessage {
+        QByteArray text;
+        QueuedMessage* next;
+    };
+
+    struct CategoryRate {
+        qint64 second { 0 };
+        int count { 0 };
+        int dropped { 0 };
+    };
+
     LogHandler();
+    ~LogHandler();
 
     void flushRepeatedMessages();
 
+    bool isRateLimited(LogMsgType type, const QMessageLogContext& context);
+    QString getTimestampString();
+
+    void queueMessage(const QString& logMessage);
+    void writeQueuedMessages();
+    void runWriter();
+
     QString _targetName;
     bool _shouldOutputProcessID;
     bool _shouldOutputThreadID;
-    QSet<QString> _repeatedMessageRegexes;
+    QHash<QString, QRegularExpression> _repeatedMessageRegexes;
     QHash<QString, int> _repeatMessageCountHash;
     QHash<QString, QString> _lastRepeatedMessage;
     QMutex _repeatedMessageLock;
 
-    QSet<QString> _onlyOnceMessageRegexes;
+    QHash<QString, QRegularExpression> _onlyOnceMessageRegexes;
     QHash<QString, int> _onlyOnceMessageCountHash;
     QMutex _onlyOnceMessageLock;
+
+    QHash<const char*, CategoryRate> _categoryRates; // by the category names, which live as long as the categories
+    qint64 _timestampSecond { -1 };
+    QString _timestampString;
+    QMutex _rateLock;
+
+    // pushed to by the logging threads without a lock, the writer takes all of them at once
+    std::atomic<QueuedMessage*> _queuedMessages { nullptr };
+    std::mutex _writeMutex; // held while messages are written, so they come out in order
+    std::mutex _writerMutex;
+    std::condition_variable _writerCondition;
+    std::thread _writerThread;
+    std::once_flag _writerStarted;
+    std::atomic<bool> _isWriterStopping { false };
 };
 
 #endif // hifi_LogHandler_h
@@ -0,0 +1,138 @@
+//
+//  MPSCQueue.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MPSCQueue_h
+#define hifi_MPSCQueue_h
+
+#include <atomic>
+#include <climits>
+#include <thread>
+
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+
+/// A queue that any number of threads push to without locking, and one thread drains in batches. Pushes go on the top
+/// of a lock-free stack, and the consumer takes the whole stack with one exchange and reverses it into the order the
+/// items were pushed in. Only the consumer thread may drain the queue or ask whether it is empty.
+template <typename T>
+class MPSCQueue {
+public:
+    MPSCQueue() { }
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    ~MPSCQueue() {
+        deleteNodes(_pushed.exchange(nullptr));
+        deleteNodes(_taken);
+    }
+
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* top = _pushed.load(std::memory_order_relaxed);
+        do {
+            node->next = top;
+        } while (!_pushed.compare_exchange_weak(top, node)); // seq_cst, see ConsumerParker
+    }
+
+    /// appends up to maxItems to items, in the order they were pushed, and returns how many it appended
+    template <typename Container>
+    int drain(Container& items, int maxItems = INT_MAX) {
+        int count = 0;
+        while (count < maxItems) {
+            if (!_taken && !takePushed()) {
+                break;
+            }
+            Node* node = _taken;
+            _taken = node->next;
+            items.push_back(std::move(node->value));
+            delete node;
+            ++count;
+        }
+        return count;
+    }
+
+    bool isEmpty() const { return !_taken && !_pushed.load(); }
+
+private:
+    struct Node {
+        Node(T&& value) : value(std::move(value)) { }
+        T value;
+        Node* next { nullptr };
+    };
+
+    bool takePushed() {
+        Node* node = _pushed.exchange(nullptr, std::memory_order_acquire);
+        Node* reversed = nullptr;
+        while (node) {
+            Node* next = node->next;
+            node->next = reversed;
+            reversed = node;
+            node = next;
+        }
+        _taken = reversed;
+        return _taken != nullptr;
+    }
+
+    static void deleteNodes(Node* node) {
+        while (node) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    std::atomic<Node*> _pushed { nullptr }; // newest first
+    Node* _taken { nullptr }; // oldest first, only touched by the consumer
+};
+
+/// Lets the consumer of a queue sleep until there is work, while producers only take the lock to wake it when they
+/// see it parked. The consumer marks itself parked before it checks for work one last time, and producers check the
+/// mark after they queue their work, both sequentially consistent, so either the consumer sees the work or the producer
+/// sees the mark.
+class ConsumerParker {
+public:
+    /// from the producers, after their work is queued
+    void notify() {
+        if (_isParked.load()) {
+            wakeAll();
+        }
+    }
+
+    void wakeAll() {
+        QMutexLocker locker(&_mutex);
+        _condition.wakeAll();
+    }
+
+    /// from the consumer, checks hasWork spinCount times before it parks for up to maxWaitMsecs
+    template <typename HasWork>
+    bool wait(HasWork hasWork, int spinCount, unsigned long maxWaitMsecs) {
+        for (int i = 0; i < spinCount; i++) {
+            if (hasWork()) {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+
+        QMutexLocker locker(&_mutex);
+        _isParked.store(true);
+        if (!hasWork()) {
+            _condition.wait(&_mutex, maxWaitMsecs);
+        }
+        _isParked.store(false);
+        return hasWork();
+    }
+
+private:
+    std::atomic<bool> _isParked { false };
+    QMutex _mutex;
+    QWaitCondition _condition;
+};
+
+#endif // hifi_MPSCQueue_h
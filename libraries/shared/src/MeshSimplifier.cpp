@@ -0,0 +1,370 @@
+//
+//  MeshSimplifier.cpp
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include <stdint.h>
+
+namespace {
+
+// the collapses that turn a triangle further than this, in cosine of the angle, get refused
+const float MIN_NORMAL_DOT = 0.2f;
+
+// A level has to remove at least a quarter of the triangles of the previous one
+const float MAX_LEVEL_TRIANGLES_RATIO = 0.75f;
+
+// The symmetric matrix of the sum of the squared distances to a set of planes
+class Quadric {
+public:
+    Quadric() { std::fill(_m, _m + NUM_COEFFICIENTS, 0.0); }
+
+    // of the plane dot(normal, p) + d = 0, with a normalized normal
+    Quadric(const glm::dvec3& normal, double d) {
+        _m[0] = normal.x * normal.x;
+        _m[1] = normal.x * normal.y;
+        _m[2] = normal.x * normal.z;
+        _m[3] = normal.x * d;
+        _m[4] = normal.y * normal.y;
+        _m[5] = normal.y * normal.z;
+        _m[6] = normal.y * d;
+        _m[7] = normal.z * normal.z;
+        _m[8] = normal.z * d;
+        _m[9] = d * d;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        for (int i = 0; i < NUM_COEFFICIENTS; i++) {
+            _m[i] += other._m[i];
+        }
+        return *this;
+    }
+
+    double evaluate(const glm::vec3& point) const {
+        double x = point.x;
+        double y = point.y;
+        double z = point.z;
+        return _m[0] * x * x + 2.0 * _m[1] * x * y + 2.0 * _m[2] * x * z + 2.0 * _m[3] * x +
+            _m[4] * y * y + 2.0 * _m[5] * y * z + 2.0 * _m[6] * y +
+            _m[7] * z * z + 2.0 * _m[8] * z +
+            _m[9];
+    }
+
+private:
+    static const int NUM_COEFFICIENTS = 10;
+    double _m[NUM_COEFFICIENTS];
+};
+
+// Moving the vertex from onto the vertex to
+class Collapse {
+public:
+    Collapse(double cost, int from, int to) : cost(cost), from(from), to(to) {}
+
+    double cost;
+    int from;
+    int to;
+
+    // so that the priority queue gives the cheapest collapse first
+    bool operator<(const Collapse& other) const { return cost > other.cost; }
+};
+
+class Simplifier {
+public:
+    Simplifier(const QVector<glm::vec3>& vertices, const QVector<QVector<int>>& partIndices);
+
+    int getNumTriangles() const { return _numTriangles; }
+
+    // Collapse the cheapest edges until there are no more than numTriangles left, or no edge can collapse
+    void collapseTo(int numTriangles);
+
+    MeshSimplifier::Level getLevel() const;
+
+private:
+    double getCost(int from, int to) const;
+    bool canCollapse(int from, int to) const;
+    void collapse(int from, int to);
+    void addCollapses(int vertex);
+
+    const QVector<glm::vec3>& _vertices;
+    int _numParts;
+
+    std::vector<glm::ivec3> _triangles;
+    std::vector<int> _triangleParts;
+    std::vector<bool> _isTriangleRemoved;
+    int _numTriangles { 0 };
+
+    std::vector<std::vector<int>> _vertexTriangles;
+    std::vector<Quadric> _quadrics;
+    std::vector<bool> _isLocked;
+    std::vector<bool> _isCollapsed;
+
+    std::priority_queue<Collapse> _collapses;
+    double _maxCost { 0.0 };
+};
+
+Simplifier::Simplifier(const QVector<glm::vec3>& vertices, const QVector<QVector<int>>& partIndices) :
+    _vertices(vertices),
+    _numParts(partIndices.size()),
+    _vertexTriangles(vertices.size()),
+    _quadrics(vertices.size()),
+    _isLocked(vertices.size(), false),
+    _isCollapsed(vertices.size(), false)
+{
+    int numVertices = vertices.size();
+    std::vector<int> vertexParts(numVertices, -1);
+    for (int part = 0; part < partIndices.size(); part++) {
+        const QVector<int>& indices = partIndices.at(part);
+        for (int i = 0; i + 2 < indices.size(); i += 3) {
+            glm::ivec3 triangle(indices.at(i), indices.at(i + 1), indices.at(i + 2));
+            if (glm::any(glm::lessThan(triangle, glm::ivec3(0))) ||
+                    glm::any(glm::greaterThanEqual(triangle, glm::ivec3(numVertices))) ||
+                    triangle.x == triangle.y || triangle.y == triangle.z || triangle.z == triangle.x) {
+                // the degenerate triangles are left out of the levels
+                continue;
+            }
+            int index = (int)_triangles.size();
+            _triangles.push_back(triangle);
+            _triangleParts.push_back(part);
+            for (int j = 0; j < 3; j++) {
+                int vertex = triangle[j];
+                _vertexTriangles[vertex].push_back(index);
+
+                // the vertices between parts keep the borders of the materials in place
+                if (vertexParts[vertex] == -1) {
+                    vertexParts[vertex] = part;
+                } else if (vertexParts[vertex] != part) {
+                    _isLocked[vertex] = true;
+                }
+            }
+        }
+    }
+    _numTriangles = (int)_triangles.size();
+    _isTriangleRemoved.resize(_triangles.size(), false);
+
+    std::unordered_map<uint64_t, int> edgeCounts;
+    for (auto& triangle : _triangles) {
+        glm::dvec3 p0(vertices.at(triangle.x));
+        glm::dvec3 normal = glm::cross(glm::dvec3(vertices.at(triangle.y)) - p0, glm::dvec3(vertices.at(triangle.z)) - p0);
+        double length = glm::length(normal);
+        if (length > 0.0) {
+            normal /= length;
+            Quadric plane(normal, -glm::dot(normal, p0));
+            for (int j = 0; j < 3; j++) {
+                _quadrics[triangle[j]] += plane;
+            }
+        }
+        for (int j = 0; j < 3; j++) {
+            uint64_t a = triangle[j];
+            uint64_t b = triangle[(j + 1) % 3];
+            edgeCounts[(std::min(a, b) << 32) | std::max(a, b)]++;
+        }
+    }
+
+    // The edges of a single triangle are on open borders or on seams, those of more than two are non manifold
+    for (auto& edgeCount : edgeCounts) {
+        if (edgeCount.second != 2) {
+            _isLocked[(int)(edgeCount.first >> 32)] = true;
+            _isLocked[(int)(edgeCount.first & 0xFFFFFFFF)] = true;
+        }
+    }
+
+    for (int vertex = 0; vertex < numVertices; vertex++) {
+        if (!_isLocked[vertex]) {
+            addCollapses(vertex);
+        }
+    }
+}
+
+double Simplifier::getCost(int from, int to) const {
+    Quadric quadric = _quadrics[from];
+    quadric += _quadrics[to];
+    return quadric.evaluate(_vertices.at(to));
+}
+
+void Simplifier::addCollapses(int vertex) {
+    for (int index : _vertexTriangles[vertex]) {
+        if (_isTriangleRemoved[index]) {
+            continue;
+        }
+        const glm::ivec3& triangle = _triangles[index];
+        for (int j = 0; j < 3; j++) {
+            int other = triangle[j];
+            if (other == vertex) {
+                continue;
+            }
+            if (!_isLocked[vertex]) {
+                _collapses.push(Collapse(getCost(vertex, other), vertex, other));
+            }
+            if (!_isLocked[other]) {
+                _collapses.push(Collapse(getCost(other, vertex), other, vertex));
+            }
+        }
+    }
+}
+
+bool Simplifier::canCollapse(int from, int to) const {
+    // The vertices next to both ends of the edge have to be the opposite corners of its triangles, anything else would
+    // pinch the surface
+    std::vector<int> fromNeighbors;
+    std::vector<int> toNeighbors;
+    int numSharedTriangles = 0;
+    for (int index : _vertexTriangles[from]) {
+        if (_isTriangleRemoved[index]) {
+            continue;
+        }
+        const glm::ivec3& triangle = _triangles[index];
+        if (triangle.x == to || triangle.y == to || triangle.z == to) {
+            numSharedTriangles++;
+        }
+        for (int j = 0; j < 3; j++) {
+            if (triangle[j] != from && triangle[j] != to) {
+                fromNeighbors.push_back(triangle[j]);
+            }
+        }
+    }
+    if (numSharedTriangles == 0) {
+        return false;
+    }
+    for (int index : _vertexTriangles[to]) {
+        if (_isTriangleRemoved[index]) {
+            continue;
+        }
+        const glm::ivec3& triangle = _triangles[index];
+        for (int j = 0; j < 3; j++) {
+            if (triangle[j] != from && triangle[j] != to) {
+                toNeighbors.push_back(triangle[j]);
+            }
+        }
+    }
+    std::sort(fromNeighbors.begin(), fromNeighbors.end());
+    fromNeighbors.erase(std::unique(fromNeighbors.begin(), fromNeighbors.end()), fromNeighbors.end());
+    std::sort(toNeighbors.begin(), toNeighbors.end());
+    toNeighbors.erase(std::unique(toNeighbors.begin(), toNeighbors.end()), toNeighbors.end());
+    std::vector<int> sharedNeighbors;
+    std::set_intersection(fromNeighbors.begin(), fromNeighbors.end(), toNeighbors.begin(), toNeighbors.end(),
+        std::back_inserter(sharedNeighbors));
+    if ((int)sharedNeighbors.size() != numSharedTriangles) {
+        return false;
+    }
+
+    // The triangles that stay must not flip nor fold
+    const glm::vec3& destination = _vertices.at(to);
+    for (int index : _vertexTriangles[from]) {
+        if (_isTriangleRemoved[index]) {
+            continue;
+        }
+        const glm::ivec3& triangle = _triangles[index];
+        if (triangle.x == to || triangle.y == to || triangle.z == to) {
+            continue;
+        }
+        glm::vec3 corners[3];
+        glm::vec3 movedCorners[3];
+        for (int j = 0; j < 3; j++) {
+            corners[j] = _vertices.at(triangle[j]);
+            movedCorners[j] = (triangle[j] == from) ? destination : corners[j];
+        }
+        glm::vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+        glm::vec3 movedNormal = glm::cross(movedCorners[1] - movedCorners[0], movedCorners[2] - movedCorners[0]);
+        float length = glm::length(normal);
+        float movedLength = glm::length(movedNormal);
+        if (movedLength == 0.0f || (length > 0.0f && glm::dot(normal, movedNormal) < MIN_NORMAL_DOT * length * movedLength)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Simplifier::collapse(int from, int to) {
+    std::vector<int>& toTriangles = _vertexTriangles[to];
+    for (int index : _vertexTriangles[from]) {
+        if (_isTriangleRemoved[index]) {
+            continue;
+        }
+        glm::ivec3& triangle = _triangles[index];
+        if (triangle.x == to || triangle.y == to || triangle.z == to) {
+            _isTriangleRemoved[index] = true;
+            _numTriangles--;
+        } else {
+            for (int j = 0; j < 3; j++) {
+                if (triangle[j] == from) {
+                    triangle[j] = to;
+                }
+            }
+            toTriangles.push_back(index);
+        }
+    }
+    _vertexTriangles[from].clear();
+    _isCollapsed[from] = true;
+    _quadrics[to] += _quadrics[from];
+
+    toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(), [&](int index) {
+        return _isTriangleRemoved[index];
+    }), toTriangles.end());
+
+    // the edges around the vertex now cost more, the queued collapses get their cost updated as they come out
+    addCollapses(to);
+}
+
+void Simplifier::collapseTo(int numTriangles) {
+    while (_numTriangles > numTriangles && !_collapses.empty()) {
+        Collapse next = _collapses.top();
+        _collapses.pop();
+        if (_isCollapsed[next.from] || _isCollapsed[next.to]) {
+            continue;
+        }
+        double cost = getCost(next.from, next.to);
+        if (cost > next.cost) {
+            _collapses.push(Collapse(cost, next.from, next.to));
+            continue;
+        }
+        if (canCollapse(next.from, next.to)) {
+            collapse(next.from, next.to);
+            _maxCost = std::max(_maxCost, cost);
+        }
+    }
+}
+
+MeshSimplifier::Level Simplifier::getLevel() const {
+    MeshSimplifier::Level level;
+    level.partIndices.resize(_numParts);
+    for (size_t i = 0; i < _triangles.size(); i++) {
+        if (!_isTriangleRemoved[i]) {
+            QVector<int>& indices = level.partIndices[_triangleParts[i]];
+            indices << _triangles[i].x << _triangles[i].y << _triangles[i].z;
+        }
+    }
+    level.numTriangles = _numTriangles;
+    // the planes of the quadric include those of the vertex, so this bounds its distance to each of them
+    level.error = (float)sqrt(std::max(_maxCost, 0.0));
+    return level;
+}
+
+}
+
+QVector<MeshSimplifier::Level> MeshSimplifier::simplify(const QVector<glm::vec3>& vertices,
+                                                        const QVector<QVector<int>>& partIndices, const QVector<float>& ratios) {
+    QVector<Level> levels;
+    Simplifier simplifier(vertices, partIndices);
+    int numTriangles = simplifier.getNumTriangles();
+    int previousNumTriangles = numTriangles;
+    foreach (float ratio, ratios) {
+        simplifier.collapseTo((int)(ratio * numTriangles));
+        if (simplifier.getNumTriangles() > MAX_LEVEL_TRIANGLES_RATIO * previousNumTriangles) {
+            break;
+        }
+        levels.push_back(simplifier.getLevel());
+        previousNumTriangles = simplifier.getNumTriangles();
+    }
+    return levels;
+}
@@ -0,0 +1,40 @@
+//
+//  MeshSimplifier.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MeshSimplifier_h
+#define hifi_MeshSimplifier_h
+
+#include <QVector>
+
+#include <glm/glm.hpp>
+
+// Quadric error simplification of triangle meshes by half edge collapses. A collapse moves a vertex onto one of its
+// neighbors, so the simplified triangles only index the original vertices and keep sharing their attributes, skinning
+// and blendshapes with the full mesh.
+namespace MeshSimplifier {
+
+    // One level of detail, the triangles of each part as triples of vertex indices
+    class Level {
+    public:
+        QVector<QVector<int>> partIndices;
+        int numTriangles { 0 };
+
+        // the largest distance the collapses moved the surface by, in the space of the vertices
+        float error { 0.0f };
+    };
+
+    // Simplify the parts down to each of the ratios of their triangles, in decreasing order, and return the levels
+    // reached. The open borders, the borders between parts and the seams where the vertices get split by their
+    // attributes don't move, a level that can't get below 3/4 of the triangles of the previous one isn't returned.
+    QVector<Level> simplify(const QVector<glm::vec3>& vertices, const QVector<QVector<int>>& partIndices,
+                            const QVector<float>& ratios);
+}
+
+#endif // hifi_MeshSimplifier_h
@@ -371,3 +371,36 @@ QString octalCodeToHexString(const unsigned char* octalCode) {
     return output;
 }
 
+
+OctalKey OctalKey::fromOctalCode(const unsigned char* octalCode) {
+    if (!octalCode || *octalCode > MAX_SECTIONS) {
+        return OctalKey(0);
+    }
+    int sections = *octalCode;
+    if (sections == 0) {
+        return OctalKey();
+    }
+    // the sections take 63 bits at most, so they fit in the top of one word read from the bytes after the length
+    size_t codeBytes = bytesRequiredForCodeLength(sections) - 1;
+    quint64 bits = 0;
+    for (size_t i = 0; i < sizeof(bits); i++) {
+        bits = (bits << BITS_IN_BYTE) | (i < codeBytes ? octalCode[1 + i] : 0);
+    }
+    int sectionBits = sections * BITS_IN_OCTAL;
+    return OctalKey((1ULL << sectionBits) | (bits >> (64 - sectionBits)));
+}
+
+unsigned char* OctalKey::toOctalCode() const {
+    int sections = getSections();
+    size_t codeBytes = bytesRequiredForCodeLength(sections);
+    unsigned char* octalCode = new unsigned char[codeBytes];
+    octalCode[0] = sections;
+    if (sections > 0) {
+        int sectionBits = sections * BITS_IN_OCTAL;
+        quint64 bits = (_key & ((1ULL << sectionBits) - 1)) << (64 - sectionBits);
+        for (size_t i = 1; i < codeBytes; i++) {
+            octalCode[i] = (unsigned char)(bits >> (64 - BITS_IN_BYTE * i));
+        }
+    }
+    return octalCode;
+}
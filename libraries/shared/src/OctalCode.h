@@ -15,6 +15,10 @@
 #include <string.h>
 #include <QString>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 const int BITS_IN_OCTAL = 3;
 const int NUMBER_OF_COLORS = 3; // RGB!
 const int SIZE_OF_COLOR_DATA = NUMBER_OF_COLORS * sizeof(unsigned char); // size in bytes
@@ -62,4 +66,60 @@ OctalCodeComparison compareOctalCodes(const unsigned char* code1, const unsigned
 QString octalCodeToHexString(const unsigned char* octalCode);
 unsigned char* hexStringToOctalCode(const QString& input);
 
+/// An octal code of up to 21 sections packed in 64 bits: a leading one bit, then three bits for each section from the
+/// root down. The parent, child and ancestor of a key are a shift away, and keys compare like compareOctalCodes does,
+/// shallower codes first and then by section. The tree walks through keys, the byte codes are still what the elements
+/// keep and what goes on the wire.
+class OctalKey {
+public:
+    static const int MAX_SECTIONS = 21;
+
+    /// the root
+    OctalKey() : _key(1) { }
+
+    /// an invalid key if the code is missing or longer than MAX_SECTIONS
+    static OctalKey fromOctalCode(const unsigned char* octalCode);
+    /// a new[] buffer for the code, like childOctalCode
+    unsigned char* toOctalCode() const;
+
+    /// the other calls need a valid key
+    bool isValid() const { return _key != 0; }
+    int getSections() const;
+
+    OctalKey getParent() const { return OctalKey(_key >> BITS_IN_OCTAL); }
+    /// invalid if the key already has MAX_SECTIONS
+    OctalKey getChild(int childIndex) const {
+        return getSections() < MAX_SECTIONS ? OctalKey((_key << BITS_IN_OCTAL) | (childIndex & 7)) : OctalKey(0);
+    }
+    /// the child index at the section, the first under the root is 0
+    int getSection(int section) const { return (int)(_key >> (BITS_IN_OCTAL * (getSections() - 1 - section))) & 7; }
+
+    /// also true for the key itself
+    bool isAncestorOf(OctalKey descendant) const {
+        int sectionsBelow = descendant.getSections() - getSections();
+        return sectionsBelow >= 0 && (descendant._key >> (BITS_IN_OCTAL * sectionsBelow)) == _key;
+    }
+
+    quint64 getKey() const { return _key; }
+
+    bool operator==(const OctalKey& other) const { return _key == other._key; }
+    bool operator!=(const OctalKey& other) const { return _key != other._key; }
+    bool operator<(const OctalKey& other) const { return _key < other._key; }
+
+private:
+    explicit OctalKey(quint64 key) : _key(key) { }
+
+    quint64 _key;
+};
+
+inline int OctalKey::getSections() const {
+#ifdef _MSC_VER
+    unsigned long highestBit;
+    _BitScanReverse64(&highestBit, _key);
+    return (int)highestBit / BITS_IN_OCTAL;
+#else
+    return (63 - __builtin_clzll(_key)) / BITS_IN_OCTAL;
+#endif
+}
+
 #endif // hifi_OctalCode_h
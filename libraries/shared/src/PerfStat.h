@@ -23,6 +23,7 @@
 #include <cstring>
 #include <string>
 #include <map>
+#include <mutex>
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
@@ -91,6 +92,7 @@ private:
     quint64 _start = 0;
     QString _name;
     static std::atomic<bool> _isActive;
+    static std::mutex _mutex; // timers run on the render job threads too
     static QHash<QThread*, QString> _fullNames;
     static QMap<QString, PerformanceTimerRecord> _records;
 };
@@ -0,0 +1,239 @@
+//
+//  RayIntersectionKernels.cpp
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <float.h>
+#include <math.h>
+
+#include "GeometryUtil.h"
+#include "NumericalConstants.h"
+
+#include "RayIntersectionKernels.h"
+
+using namespace RayIntersectionKernels;
+
+void BoxBatch::add(const glm::vec3& minimum, const glm::vec3& maximum) {
+    minX[numBoxes] = minimum.x;
+    minY[numBoxes] = minimum.y;
+    minZ[numBoxes] = minimum.z;
+    maxX[numBoxes] = maximum.x;
+    maxY[numBoxes] = maximum.y;
+    maxZ[numBoxes] = maximum.z;
+    ++numBoxes;
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// narrows the [near, far] range of ray distances of four boxes to where the ray is between their planes on one axis,
+// a ray parallel to the axis is only in range for the boxes the origin is between the planes of
+static inline void clipSlab(__m128 minimum, __m128 maximum, float origin, float direction,
+                            __m128& nearDistance, __m128& farDistance, __m128& valid) {
+    __m128 o = _mm_set1_ps(origin);
+
+    if (fabsf(direction) < EPSILON) {
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(o, minimum), _mm_cmple_ps(o, maximum)));
+        return;
+    }
+
+    __m128 inverse = _mm_set1_ps(1.0f / direction);
+    __m128 t0 = _mm_mul_ps(_mm_sub_ps(minimum, o), inverse);
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(maximum, o), inverse);
+
+    nearDistance = _mm_max_ps(nearDistance, _mm_min_ps(t0, t1));
+    farDistance = _mm_min_ps(farDistance, _mm_max_ps(t0, t1));
+}
+
+uint8_t RayIntersectionKernels::findRayBoxesIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                                         const BoxBatch& boxes, float* distances) {
+    int hits = 0;
+
+    // the lanes past numBoxes are computed too and masked out at the end
+    for (int i = 0; i < boxes.numBoxes; i += 4) {
+        __m128 nearDistance = _mm_set1_ps(-FLT_MAX);
+        __m128 farDistance = _mm_set1_ps(FLT_MAX);
+        __m128 valid = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        clipSlab(_mm_loadu_ps(&boxes.minX[i]), _mm_loadu_ps(&boxes.maxX[i]), origin.x, direction.x,
+                 nearDistance, farDistance, valid);
+        clipSlab(_mm_loadu_ps(&boxes.minY[i]), _mm_loadu_ps(&boxes.maxY[i]), origin.y, direction.y,
+                 nearDistance, farDistance, valid);
+        clipSlab(_mm_loadu_ps(&boxes.minZ[i]), _mm_loadu_ps(&boxes.maxZ[i]), origin.z, direction.z,
+                 nearDistance, farDistance, valid);
+
+        __m128 zero = _mm_setzero_ps();
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmple_ps(nearDistance, farDistance), _mm_cmpge_ps(farDistance, zero)));
+
+        _mm_storeu_ps(&distances[i], _mm_max_ps(nearDistance, zero));
+        hits |= _mm_movemask_ps(valid) << i;
+    }
+
+    return (uint8_t)(hits & ((1 << boxes.numBoxes) - 1));
+}
+
+// three packed vectors, one lane per triangle
+struct Vec3x4 {
+    __m128 x;
+    __m128 y;
+    __m128 z;
+};
+
+static inline Vec3x4 subtract(const Vec3x4& a, const Vec3x4& b) {
+    return { _mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z) };
+}
+
+static inline Vec3x4 cross(const Vec3x4& a, const Vec3x4& b) {
+    return {
+        _mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(a.z, b.y)),
+        _mm_sub_ps(_mm_mul_ps(a.z, b.x), _mm_mul_ps(a.x, b.z)),
+        _mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(a.y, b.x))
+    };
+}
+
+static inline __m128 dot(const Vec3x4& a, const Vec3x4& b) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+}
+
+static inline Vec3x4 splat(const glm::vec3& v) {
+    return { _mm_set1_ps(v.x), _mm_set1_ps(v.y), _mm_set1_ps(v.z) };
+}
+
+static inline Vec3x4 gather(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d) {
+    return { _mm_setr_ps(a.x, b.x, c.x, d.x), _mm_setr_ps(a.y, b.y, c.y, d.y), _mm_setr_ps(a.z, b.z, c.z, d.z) };
+}
+
+int RayIntersectionKernels::findRayTrianglesIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                                         const Triangle* triangles, int numTriangles, float& distance) {
+    int closestIndex = -1;
+    float closestDistance = FLT_MAX;
+
+    Vec3x4 o = splat(origin);
+    Vec3x4 d = splat(direction);
+    __m128 zero = _mm_setzero_ps();
+
+    int i = 0;
+    for (; i + 4 <= numTriangles; i += 4) {
+        const Triangle* t = &triangles[i];
+        Vec3x4 v0 = gather(t[0].v0, t[1].v0, t[2].v0, t[3].v0);
+        Vec3x4 v1 = gather(t[0].v1, t[1].v1, t[2].v1, t[3].v1);
+        Vec3x4 v2 = gather(t[0].v2, t[1].v2, t[2].v2, t[3].v2);
+
+        // the same steps as findRayTriangleIntersection(), four triangles at a time
+        Vec3x4 firstSide = subtract(v0, v1);
+        Vec3x4 secondSide = subtract(v2, v1);
+        Vec3x4 normal = cross(secondSide, firstSide);
+
+        __m128 dividend = _mm_sub_ps(dot(normal, v1), dot(o, normal));
+        __m128 divisor = dot(normal, d);
+        __m128 valid = _mm_and_ps(_mm_cmple_ps(dividend, zero), _mm_cmplt_ps(divisor, zero));
+        if (_mm_movemask_ps(valid) == 0) {
+            continue;
+        }
+
+        __m128 along = _mm_div_ps(dividend, divisor);
+        Vec3x4 point = {
+            _mm_add_ps(o.x, _mm_mul_ps(d.x, along)),
+            _mm_add_ps(o.y, _mm_mul_ps(d.y, along)),
+            _mm_add_ps(o.z, _mm_mul_ps(d.z, along))
+        };
+
+        Vec3x4 fromV1 = subtract(point, v1);
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(dot(normal, cross(fromV1, firstSide)), zero));
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(dot(normal, cross(secondSide, fromV1)), zero));
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(dot(normal, cross(subtract(point, v0), subtract(v2, v0))), zero));
+
+        int hits = _mm_movemask_ps(valid);
+        if (hits == 0) {
+            continue;
+        }
+
+        float distances[4];
+        _mm_storeu_ps(distances, along);
+        for (int lane = 0; lane < 4; ++lane) {
+            if ((hits & (1 << lane)) && distances[lane] < closestDistance) {
+                closestDistance = distances[lane];
+                closestIndex = i + lane;
+            }
+        }
+    }
+
+    for (; i < numTriangles; ++i) {
+        float triangleDistance;
+        if (findRayTriangleIntersection(origin, direction, triangles[i], triangleDistance) &&
+                triangleDistance < closestDistance) {
+            closestDistance = triangleDistance;
+            closestIndex = i;
+        }
+    }
+
+    if (closestIndex >= 0) {
+        distance = closestDistance;
+    }
+    return closestIndex;
+}
+
+#else
+
+uint8_t RayIntersectionKernels::findRayBoxesIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                                         const BoxBatch& boxes, float* distances) {
+    const float* minimums[3] = { boxes.minX, boxes.minY, boxes.minZ };
+    const float* maximums[3] = { boxes.maxX, boxes.maxY, boxes.maxZ };
+    int hits = 0;
+
+    for (int i = 0; i < boxes.numBoxes; ++i) {
+        float nearDistance = -FLT_MAX;
+        float farDistance = FLT_MAX;
+        bool valid = true;
+
+        for (int axis = 0; axis < 3 && valid; ++axis) {
+            if (fabsf(direction[axis]) < EPSILON) {
+                valid = origin[axis] >= minimums[axis][i] && origin[axis] <= maximums[axis][i];
+                continue;
+            }
+            float inverse = 1.0f / direction[axis];
+            float t0 = (minimums[axis][i] - origin[axis]) * inverse;
+            float t1 = (maximums[axis][i] - origin[axis]) * inverse;
+            nearDistance = glm::max(nearDistance, glm::min(t0, t1));
+            farDistance = glm::min(farDistance, glm::max(t0, t1));
+        }
+
+        if (valid && nearDistance <= farDistance && farDistance >= 0.0f) {
+            distances[i] = glm::max(nearDistance, 0.0f);
+            hits |= 1 << i;
+        }
+    }
+
+    return (uint8_t)hits;
+}
+
+int RayIntersectionKernels::findRayTrianglesIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                                         const Triangle* triangles, int numTriangles, float& distance) {
+    int closestIndex = -1;
+    float closestDistance = FLT_MAX;
+
+    for (int i = 0; i < numTriangles; ++i) {
+        float triangleDistance;
+        if (findRayTriangleIntersection(origin, direction, triangles[i], triangleDistance) &&
+                triangleDistance < closestDistance) {
+            closestDistance = triangleDistance;
+            closestIndex = i;
+        }
+    }
+
+    if (closestIndex >= 0) {
+        distance = closestDistance;
+    }
+    return closestIndex;
+}
+
+#endif
@@ -0,0 +1,51 @@
+//
+//  RayIntersectionKernels.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RayIntersectionKernels_h
+#define hifi_RayIntersectionKernels_h
+
+#include <stdint.h>
+
+#include <glm/glm.hpp>
+
+class Triangle;
+
+// Ray picking inner loops that test several boxes or triangles against the same ray at once.
+namespace RayIntersectionKernels {
+
+    const int BOX_BATCH_SIZE = 8;
+
+    // up to BOX_BATCH_SIZE boxes laid out one axis after the other, like the children of an octree element
+    class BoxBatch {
+    public:
+        void clear() { numBoxes = 0; }
+        void add(const glm::vec3& minimum, const glm::vec3& maximum);
+
+        float minX[BOX_BATCH_SIZE];
+        float minY[BOX_BATCH_SIZE];
+        float minZ[BOX_BATCH_SIZE];
+        float maxX[BOX_BATCH_SIZE];
+        float maxY[BOX_BATCH_SIZE];
+        float maxZ[BOX_BATCH_SIZE];
+        int numBoxes { 0 };
+    };
+
+    // returns a mask with bit i set if the ray hits box i, in which case distances[i] is where the ray enters the
+    // box, or 0 if the origin is inside it, distances must have room for BOX_BATCH_SIZE values
+    uint8_t findRayBoxesIntersection(const glm::vec3& origin, const glm::vec3& direction, const BoxBatch& boxes,
+                                     float* distances);
+
+    // returns the index of the closest triangle hit by the ray and its distance, or -1 if none is hit
+    // each triangle is tested like findRayTriangleIntersection() does
+    int findRayTrianglesIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                     const Triangle* triangles, int numTriangles, float& distance);
+}
+
+#endif // hifi_RayIntersectionKernels_h
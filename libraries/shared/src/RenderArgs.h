@@ -39,6 +39,7 @@ public:
         int _rendered = 0;
         int _outOfView = 0;
         int _tooSmall = 0;
+        int _occluded = 0;
     };
     
     int _materialSwitches = 0;
@@ -51,16 +52,18 @@ public:
     Item* _item = &_other;
     
     void pointTo(Type type) {
+        _item = &getItem(type);
+    }
+
+    // Unlike pointTo this leaves _item alone, so jobs culling different types of items can run at the same time
+    Item& getItem(Type type) {
         switch (type) {
             case OPAQUE_ITEM:
-                _item = &_opaque;
-                break;
+                return _opaque;
             case TRANSLUCENT_ITEM:
-                _item = &_translucent;
-                break;
-            case OTHER_ITEM:
-                _item = &_other;
-                break;
+                return _translucent;
+            default:
+                return _other;
         }
     }
 };
@@ -118,6 +121,9 @@ public:
     RenderDetails _details;
 
     float _alphaThreshold = 0.5f;
+
+    // The mesh parts that only differ by their transform get drawn as instances of one draw call
+    bool _enableInstancing = false;
 };
 
 #endif // hifi_RenderArgs_h
@@ -46,7 +46,7 @@ namespace Setting {
         Handle(const QString& key, const T& defaultValue) : Interface(key), _defaultValue(defaultValue) {}
         Handle(const QStringList& path, const T& defaultValue) : Handle(path.join("/"), defaultValue) {}
         
-        virtual ~Handle() { save(); }
+        virtual ~Handle() {}
         
         // Returns setting value, returns its default value if not found
         T get() { return get(_defaultValue); }
@@ -54,10 +54,11 @@ namespace Setting {
         T get(const T& other) { maybeInit(); return (_isSet) ? _value : other; }
         T getDefault() const { return _defaultValue; }
         
-        void set(const T& value) { maybeInit(); _value = value; _isSet = true; }
+        // the value is queued to be written to disk with the next save, which writes each key once
+        void set(const T& value) { maybeInit(); _value = value; _isSet = true; save(); }
         void reset() { set(_defaultValue); }
         
-        void remove() { maybeInit(); _isSet = false; }
+        void remove() { maybeInit(); _isSet = false; save(); }
         
     protected:
         virtual void setVariant(const QVariant& variant);
@@ -70,8 +71,10 @@ namespace Setting {
     
     template <typename T>
     void Handle<T>::setVariant(const QVariant& variant) {
+        // the value came from the manager, so it isn't saved back to it
         if (variant.canConvert<T>() || std::is_same<T, QVariant>::value) {
-            set(variant.value<T>());
+            _value = variant.value<T>();
+            _isSet = true;
         }
     }
 }
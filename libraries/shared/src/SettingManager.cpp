@@ -15,6 +15,12 @@
 #include "SettingManager.h"
 
 namespace Setting {
+    Manager::Manager() {
+        for (const QString& key : allKeys()) {
+            _values.insert(key, value(key));
+        }
+    }
+
     Manager::~Manager() {
         // Cleanup timer
         stopTimer();
@@ -28,6 +34,7 @@ namespace Setting {
     
     void Manager::registerHandle(Setting::Interface* handle) {
         QString key = handle->getKey();
+        QMutexLocker locker(&_valuesLock);
         if (_handles.contains(key)) {
             qWarning() << "Setting::Manager::registerHandle(): Key registered more than once, overriding: " << key;
         }
@@ -35,19 +42,30 @@ namespace Setting {
     }
     
     void Manager::removeHandle(const QString& key) {
+        QMutexLocker locker(&_valuesLock);
         _handles.remove(key);
     }
     
     void Manager::loadSetting(Interface* handle) {
-        handle->setVariant(value(handle->getKey()));
+        QVariant variant;
+        {
+            QMutexLocker locker(&_valuesLock);
+            variant = _values.value(handle->getKey());
+        }
+        handle->setVariant(variant);
     }
     
     void Manager::saveSetting(Interface* handle) {
+        QString key = handle->getKey();
+        QVariant variant = handle->isSet() ? handle->getVariant() : QVariant();
+
+        QMutexLocker locker(&_valuesLock);
         if (handle->isSet()) {
-            setValue(handle->getKey(), handle->getVariant());
+            _values.insert(key, variant);
         } else {
-            remove(handle->getKey());
+            _values.remove(key);
         }
+        _changedKeys.insert(key);
     }
     
     static const int SAVE_INTERVAL_MSEC = 5 * 1000; // 5 sec
@@ -69,8 +87,30 @@ namespace Setting {
     }
     
     void Manager::saveAll() {
-        for (auto handle : _handles) {
-            saveSetting(handle);
+        // take the changes, then write them without the lock
+        QHash<QString, QVariant> changedValues;
+        QSet<QString> removedKeys;
+        {
+            QMutexLocker locker(&_valuesLock);
+            for (const QString& key : _changedKeys) {
+                auto storedValue = _values.find(key);
+                if (storedValue != _values.end()) {
+                    changedValues.insert(key, storedValue.value());
+                } else {
+                    removedKeys.insert(key);
+                }
+            }
+            _changedKeys.clear();
+        }
+
+        if (!changedValues.isEmpty() || !removedKeys.isEmpty()) {
+            for (auto changedValue = changedValues.constBegin(); changedValue != changedValues.constEnd(); ++changedValue) {
+                setValue(changedValue.key(), changedValue.value());
+            }
+            for (const QString& key : removedKeys) {
+                remove(key);
+            }
+            sync();
         }
         
         // Restart timer
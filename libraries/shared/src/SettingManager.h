@@ -12,15 +12,22 @@
 #ifndef hifi_SettingManager_h
 #define hifi_SettingManager_h
 
+#include <QMutex>
 #include <QPointer>
+#include <QSet>
 #include <QSettings>
 #include <QTimer>
 
 namespace Setting {
     class Interface;
     
+    // Keeps the settings in memory for the handles of any thread, and writes the ones they changed to disk on its own
+    // thread every few seconds. Only that thread touches the QSettings, so a slow sync never holds up a handle.
     class Manager : public QSettings {
         Q_OBJECT
+    public:
+        Manager();
+
     protected:
         ~Manager();
         void registerHandle(Interface* handle);
@@ -38,6 +45,10 @@ namespace Setting {
     private:
         QHash<QString, Interface*> _handles;
         QPointer<QTimer> _saveTimer = nullptr;
+
+        QHash<QString, QVariant> _values; // the settings as the handles last saved them, read from disk at startup
+        QSet<QString> _changedKeys; // the keys set or removed since the last save, written once each
+        QMutex _valuesLock; // never held while the settings go to disk
         
         friend class Interface;
         friend void cleanupPrivateInstance();
@@ -23,6 +23,11 @@
 
 #ifdef __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
+#include <mach/mach.h>
+#endif
+
+#ifdef __linux__
+#include <unistd.h>
 #endif
 
 #include <QtCore/QDebug>
@@ -685,3 +690,25 @@ bool similarStrings(const QString& stringA, const QString& stringB) {
     return similarity >= SIMILAR_ENOUGH;
 }
 
+
+quint64 getResidentMemoryBytes() {
+#if defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS) {
+        return info.resident_size;
+    }
+#elif defined(__linux__)
+    // the second field of statm is the resident pages
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm) {
+        unsigned long long totalPages = 0, residentPages = 0;
+        int numRead = fscanf(statm, "%llu %llu", &totalPages, &residentPages);
+        fclose(statm);
+        if (numRead == 2) {
+            return residentPages * (quint64)sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return 0;
+}
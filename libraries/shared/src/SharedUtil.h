@@ -166,6 +166,9 @@ QString formatUsecTime(float usecs, int prec = 3);
 QString formatSecondsElapsed(float seconds);
 bool similarStrings(const QString& stringA, const QString& stringB);
 
+/// \return the bytes of this process's memory that are resident, or 0 where that isn't known
+quint64 getResidentMemoryBytes();
+
 template <typename T>
 uint qHash(const std::shared_ptr<T>& ptr, uint seed = 0)
 {
@@ -0,0 +1,73 @@
+//
+//  SipHash.cpp
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// the words are little endian whatever the platform, so that both ends of a connection get the same hash
+static inline uint64_t readLittleEndian(const unsigned char* bytes, size_t count) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; i++) {
+        value |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+static inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1;
+    v1 = rotateLeft(v1, 13);
+    v1 ^= v0;
+    v0 = rotateLeft(v0, 32);
+    v2 += v3;
+    v3 = rotateLeft(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotateLeft(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotateLeft(v1, 17);
+    v1 ^= v2;
+    v2 = rotateLeft(v2, 32);
+}
+
+uint64_t sipHash24(const unsigned char* key, const unsigned char* data, size_t size) {
+    const uint64_t k0 = readLittleEndian(key, 8);
+    const uint64_t k1 = readLittleEndian(key + 8, 8);
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+
+    const unsigned char* end = data + (size - size % 8);
+    for (const unsigned char* word = data; word != end; word += 8) {
+        uint64_t m = readLittleEndian(word, 8);
+        v3 ^= m;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    // the last word holds the bytes left over and the low byte of the size
+    uint64_t last = readLittleEndian(end, size % 8) | ((uint64_t)(size & 0xff) << 56);
+    v3 ^= last;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
@@ -0,0 +1,23 @@
+//
+//  SipHash.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+const size_t SIP_HASH_KEY_SIZE = 16;
+
+/// SipHash-2-4 of the data with a 128 bit key, a keyed hash with a 64 bit result that is quick to compute for short
+/// messages and that can't be forged without the key, so it can act as the MAC of a packet
+uint64_t sipHash24(const unsigned char* key, const unsigned char* data, size_t size);
+
+#endif // hifi_SipHash_h
@@ -0,0 +1,198 @@
+//
+//  Trace.cpp
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Trace.h"
+
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+
+std::atomic<bool> Trace::_isCapturing { false };
+
+struct TraceZoneRecord {
+    const char* name;
+    quint64 startUsecs;
+    quint64 durationUsecs;
+};
+
+// The zones of one thread. Only that thread writes them, it publishes each one by raising the count, and starts them
+// over the first time it adds one in a new capture.
+struct ThreadZones {
+    int threadID { 0 };
+    QString threadName;
+    std::vector<TraceZoneRecord> zones;
+    std::atomic<int> count { 0 };
+    std::atomic<int> capture { -1 };
+    std::atomic<int> dropped { 0 };
+};
+
+static std::atomic<int> currentCapture { 0 };
+static std::mutex threadsMutex;
+static std::vector<std::shared_ptr<ThreadZones>> allThreadZones; // kept after their threads end, for the last capture
+static QThreadStorage<std::shared_ptr<ThreadZones>> localThreadZones;
+
+static std::mutex namesMutex;
+static std::set<std::string> internedNames;
+
+static ThreadZones& getLocalThreadZones() {
+    if (!localThreadZones.hasLocalData()) {
+        auto threadZones = std::make_shared<ThreadZones>();
+        threadZones->zones.resize(Trace::MAX_ZONES_PER_THREAD);
+        QThread* thread = QThread::currentThread();
+        {
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            threadZones->threadID = (int)allThreadZones.size() + 1;
+            threadZones->threadName = (thread && !thread->objectName().isEmpty()) ? thread->objectName() :
+                QString("Thread %1").arg(threadZones->threadID);
+            allThreadZones.push_back(threadZones);
+        }
+        localThreadZones.setLocalData(threadZones);
+    }
+    return *localThreadZones.localData();
+}
+
+void Trace::startCapture() {
+    currentCapture.fetch_add(1, std::memory_order_release);
+    _isCapturing.store(true, std::memory_order_relaxed);
+}
+
+void Trace::stopCapture() {
+    _isCapturing.store(false, std::memory_order_relaxed);
+}
+
+void Trace::addZone(const char* name, quint64 startUsecs, quint64 endUsecs) {
+    ThreadZones& threadZones = getLocalThreadZones();
+    int capture = currentCapture.load(std::memory_order_acquire);
+    if (threadZones.capture.load(std::memory_order_relaxed) != capture) {
+        threadZones.count.store(0, std::memory_order_relaxed);
+        threadZones.dropped.store(0, std::memory_order_relaxed);
+        threadZones.capture.store(capture, std::memory_order_release);
+    }
+
+    int count = threadZones.count.load(std::memory_order_relaxed);
+    if (count >= MAX_ZONES_PER_THREAD) {
+        threadZones.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceZoneRecord& zone = threadZones.zones[count];
+    zone.name = name;
+    zone.startUsecs = startUsecs;
+    zone.durationUsecs = endUsecs - startUsecs;
+    threadZones.count.store(count + 1, std::memory_order_release);
+}
+
+const char* Trace::internName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    return internedNames.insert(name).first->c_str();
+}
+
+// the threads that added zones to the last capture
+static std::vector<std::shared_ptr<ThreadZones>> getCapturedThreadZones() {
+    std::vector<std::shared_ptr<ThreadZones>> capturedThreadZones;
+    int capture = currentCapture.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    for (auto& threadZones : allThreadZones) {
+        if (threadZones->capture.load(std::memory_order_acquire) == capture) {
+            capturedThreadZones.push_back(threadZones);
+        }
+    }
+    return capturedThreadZones;
+}
+
+static void appendJsonString(QByteArray& json, const QByteArray& value) {
+    json.append('"');
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            json.append('\\');
+            json.append(c);
+        } else if ((unsigned char)c < 0x20) {
+            json.append(QByteArray("\\u00") + QByteArray::number((int)c, 16).rightJustified(2, '0'));
+        } else {
+            json.append(c);
+        }
+    }
+    json.append('"');
+}
+
+QByteArray Trace::toChromeTrace() {
+    QByteArray processID = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool isFirstEvent = true;
+    for (auto& threadZones : getCapturedThreadZones()) {
+        QByteArray threadID = QByteArray::number(threadZones->threadID);
+        if (!isFirstEvent) {
+            json.append(',');
+        }
+        isFirstEvent = false;
+        json.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + processID + ",\"tid\":" + threadID +
+                    ",\"args\":{\"name\":");
+        appendJsonString(json, threadZones->threadName.toUtf8());
+        json.append("}}");
+
+        int count = threadZones->count.load(std::memory_order_acquire);
+        for (int i = 0; i < count; i++) {
+            const TraceZoneRecord& zone = threadZones->zones[i];
+            json.append(",{\"name\":");
+            appendJsonString(json, QByteArray(zone.name));
+            json.append(",\"ph\":\"X\",\"ts\":" + QByteArray::number(zone.startUsecs) +
+                        ",\"dur\":" + QByteArray::number(zone.durationUsecs) +
+                        ",\"pid\":" + processID + ",\"tid\":" + threadID + "}");
+        }
+    }
+    json.append("]}");
+    return json;
+}
+
+bool Trace::writeChromeTrace(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Unable to write the trace to" << path;
+        return false;
+    }
+    QByteArray trace = toChromeTrace();
+    return file.write(trace) == trace.size();
+}
+
+int Trace::getDroppedZoneCount() {
+    int dropped = 0;
+    for (auto& threadZones : getCapturedThreadZones()) {
+        dropped += threadZones->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+// HIFI_TRACE_FILE starts a capture with the process, and writes it to the file as the process exits
+static QString environmentTraceFile;
+
+static void writeEnvironmentTrace() {
+    Trace::stopCapture();
+    Trace::writeChromeTrace(environmentTraceFile);
+}
+
+static bool startEnvironmentCapture() {
+    QByteArray path = qgetenv("HIFI_TRACE_FILE");
+    if (path.isEmpty()) {
+        return false;
+    }
+    environmentTraceFile = QString::fromLocal8Bit(path);
+    Trace::startCapture();
+    std::atexit(writeEnvironmentTrace);
+    return true;
+}
+
+static const bool environmentCaptureStarted = startEnvironmentCapture();
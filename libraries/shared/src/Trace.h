@@ -0,0 +1,77 @@
+//
+//  Trace.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Trace_h
+#define hifi_Trace_h
+
+#include <atomic>
+#include <string>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include "SharedUtil.h"
+
+/// Records timed zones of code from any thread while a capture runs, and writes them out in the trace event JSON format
+/// of chrome://tracing and Perfetto. Every thread writes its zones to a buffer of its own without locking, and a zone
+/// costs a relaxed load when no capture runs, so zones can be left in the code of the servers. Setting HIFI_TRACE_FILE
+/// in the environment captures from the start of the process and writes the trace to that file when it exits.
+class Trace {
+public:
+    /// the zones a thread keeps in one capture, later ones are dropped
+    static const int MAX_ZONES_PER_THREAD = 1 << 16;
+
+    static bool isCapturing() { return _isCapturing.load(std::memory_order_relaxed); }
+
+    /// starts a new capture, the zones of the last one are dropped
+    static void startCapture();
+    static void stopCapture();
+
+    static void addZone(const char* name, quint64 startUsecs, quint64 endUsecs);
+
+    /// a copy of the name that lives as long as the process, for zones named by strings that don't
+    static const char* internName(const std::string& name);
+
+    /// the zones of the last capture, it should be stopped first, zones added while this runs may be left out
+    static QByteArray toChromeTrace();
+    static bool writeChromeTrace(const QString& path);
+
+    /// the zones that didn't fit in their thread's buffer in the last capture
+    static int getDroppedZoneCount();
+
+private:
+    static std::atomic<bool> _isCapturing;
+};
+
+class TraceZone {
+public:
+    TraceZone(const char* name) : _name(Trace::isCapturing() ? name : nullptr), _start(_name ? usecTimestampNow() : 0) { }
+    ~TraceZone() {
+        if (_name) {
+            Trace::addZone(_name, _start, usecTimestampNow());
+        }
+    }
+
+private:
+    const char* _name;
+    quint64 _start;
+};
+
+#define TRACE_ZONE_CONCAT_IMPL(a, b) a##b
+#define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT_IMPL(a, b)
+
+/// times the rest of the scope, the name has to outlive the process, like a string literal
+#define TRACE_ZONE(name) TraceZone TRACE_ZONE_CONCAT(traceZone, __LINE__)(name)
+
+/// times the rest of the scope under a name held in a std::string, which is only copied while a capture runs
+#define TRACE_ZONE_STRING(name) \
+    TraceZone TRACE_ZONE_CONCAT(traceZone, __LINE__)(Trace::isCapturing() ? Trace::internName(name) : nullptr)
+
+#endif // hifi_Trace_h
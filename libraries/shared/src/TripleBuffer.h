@@ -0,0 +1,55 @@
+//
+//  TripleBuffer.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TripleBuffer_h
+#define hifi_TripleBuffer_h
+
+#include <atomic>
+
+/// Hands the latest value from one writer thread to one reader thread without locking. The writer fills its own buffer
+/// and publishes it by swapping it with the middle one, the reader takes the middle one by swapping it with its own, so
+/// neither ever waits for the other and the reader skips the values it was too slow to see.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() { }
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /// only the writer thread may fill this buffer, it is not cleared by publish()
+    T& getWriteBuffer() { return _buffers[_writeIndex]; }
+
+    void publish() {
+        _writeIndex = _middle.exchange(_writeIndex | PUBLISHED_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /// \return true if a value was published since the last fetch, it is then in the read buffer
+    bool fetch() {
+        if (!(_middle.load(std::memory_order_relaxed) & PUBLISHED_BIT)) {
+            return false;
+        }
+        _readIndex = _middle.exchange(_readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /// only the reader thread may read this buffer, it holds the last value fetched
+    const T& getReadBuffer() const { return _buffers[_readIndex]; }
+
+private:
+    static const int PUBLISHED_BIT = 4;
+    static const int INDEX_MASK = 3;
+
+    T _buffers[3];
+    int _writeIndex { 0 };
+    std::atomic<int> _middle { 1 };
+    int _readIndex { 2 };
+};
+
+#endif // hifi_TripleBuffer_h
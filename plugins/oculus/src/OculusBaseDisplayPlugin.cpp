@@ -16,7 +16,12 @@ uvec2 OculusBaseDisplayPlugin::getRecommendedRenderSize() const {
 }
 
 void OculusBaseDisplayPlugin::preRender() {
+    updateHeadPose();
+}
+
+void OculusBaseDisplayPlugin::updateHeadPose() {
 #if (OVR_MAJOR_VERSION >= 6)
+    // predicted for when the frame will be on the display, the compositor's timewarp corrects the rest
     ovrFrameTiming ftiming = ovr_GetFrameTiming(_hmd, _frameIndex);
     _trackingState = ovr_GetTrackingState(_hmd, ftiming.DisplayMidpointSeconds);
 #endif
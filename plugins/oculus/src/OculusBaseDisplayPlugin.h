@@ -31,6 +31,7 @@ public:
     virtual void resetSensors() override final;
     virtual glm::mat4 getEyeToHeadTransform(Eye eye) const override final;
     virtual glm::mat4 getHeadPose() const override final;
+    virtual void updateHeadPose() override final;
     virtual void setEyeRenderPose(Eye eye, const glm::mat4& pose) override final; 
     virtual float getIPD() const override final;
 
@@ -65,6 +65,11 @@ glm::mat4 OculusLegacyDisplayPlugin::getHeadPose() const {
     return toGlm(_trackingState.HeadPose.ThePose);
 }
 
+// The eye poses handed to ovrHmd_EndFrame are the ones timewarp corrects from, so they're sampled again here
+void OculusLegacyDisplayPlugin::updateHeadPose() {
+    ovrHmd_GetEyePoses(_hmd, _frameIndex, _eyeOffsets, _eyePoses, &_trackingState);
+}
+
 
 bool OculusLegacyDisplayPlugin::isSupported() const {
     if (!ovr_Initialize(nullptr)) {
@@ -33,6 +33,7 @@ public:
     virtual void resetSensors() override;
     virtual glm::mat4 getEyeToHeadTransform(Eye eye) const override;
     virtual glm::mat4 getHeadPose() const override;
+    virtual void updateHeadPose() override;
 
 protected:
     virtual void customizeContext() override;
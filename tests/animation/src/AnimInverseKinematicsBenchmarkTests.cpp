@@ -0,0 +1,148 @@
+//
+//  AnimInverseKinematicsBenchmarkTests.cpp
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimInverseKinematicsBenchmarkTests.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <AnimInverseKinematics.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AnimInverseKinematicsBenchmarkTests)
+
+const int DEFAULT_NUM_FRAMES = 2000;
+const float FRAME_DT = 1.0f / 60.0f;
+
+struct BenchmarkResult {
+    int numSolves = 0;
+    quint64 solveTime = 0; // usecs
+    int numLoops = 0;
+    float totalError = 0.0f; // meters, summed over the hands of every frame
+};
+
+static int getNumFrames() {
+    bool ok = false;
+    int numFrames = qgetenv("HIFI_IK_BENCHMARK_FRAMES").toInt(&ok);
+    return (ok && numFrames > 0) ? numFrames : DEFAULT_NUM_FRAMES;
+}
+
+static void addJoint(std::vector<FBXJoint>& joints, const QString& name, int parentIndex, const glm::vec3& translation) {
+    FBXJoint joint;
+    joint.isFree = false;
+    joint.parentIndex = parentIndex;
+    joint.distanceToParent = glm::length(translation);
+    joint.translation = translation;
+    joint.preTransform = glm::mat4();
+    joint.preRotation = glm::quat();
+    joint.rotation = glm::quat();
+    joint.postRotation = glm::quat();
+    joint.postTransform = glm::mat4();
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.inverseDefaultRotation = glm::quat();
+    joint.inverseBindRotation = glm::quat();
+    joint.name = name;
+    joint.isSkeletonJoint = false;
+    joint.bindTransformFoundInCluster = false;
+    joints.push_back(joint);
+}
+
+// hips, a spine, a head and two arms, in meters
+static AnimSkeleton::Pointer makeUpperBodySkeleton() {
+    std::vector<FBXJoint> joints;
+    addJoint(joints, "Hips", -1, glm::vec3(0.0f, 1.0f, 0.0f));
+    addJoint(joints, "Spine", 0, glm::vec3(0.0f, 0.1f, 0.0f));
+    addJoint(joints, "Spine1", 1, glm::vec3(0.0f, 0.15f, 0.0f));
+    addJoint(joints, "Spine2", 2, glm::vec3(0.0f, 0.15f, 0.0f));
+    addJoint(joints, "Neck", 3, glm::vec3(0.0f, 0.15f, 0.0f));
+    addJoint(joints, "Head", 4, glm::vec3(0.0f, 0.1f, 0.0f));
+    int spine2 = 3;
+    const float SIDES[] = { 1.0f, -1.0f };
+    const char* PREFIXES[] = { "Left", "Right" };
+    for (int side = 0; side < 2; side++) {
+        int shoulder = (int)joints.size();
+        addJoint(joints, QString(PREFIXES[side]) + "Shoulder", spine2, glm::vec3(SIDES[side] * 0.05f, 0.1f, 0.0f));
+        addJoint(joints, QString(PREFIXES[side]) + "Arm", shoulder, glm::vec3(SIDES[side] * 0.1f, 0.0f, 0.0f));
+        addJoint(joints, QString(PREFIXES[side]) + "ForeArm", shoulder + 1, glm::vec3(SIDES[side] * 0.28f, 0.0f, 0.0f));
+        addJoint(joints, QString(PREFIXES[side]) + "Hand", shoulder + 2, glm::vec3(SIDES[side] * 0.26f, 0.0f, 0.0f));
+    }
+    return std::make_shared<AnimSkeleton>(joints, AnimPose(glm::vec3(1.0f), glm::quat(), glm::vec3(0.0f)));
+}
+
+static BenchmarkResult runSolver(AnimInverseKinematics::Solver solver, int numFrames) {
+    AnimSkeleton::Pointer skeleton = makeUpperBodySkeleton();
+    AnimInverseKinematics ik("ik");
+    ik.setSkeleton(skeleton);
+    ik.setSolver(solver);
+    ik.setTargetVars("LeftHand", "leftHandPosition", "leftHandRotation", "leftHandType");
+    ik.setTargetVars("RightHand", "rightHandPosition", "rightHandRotation", "rightHandType");
+
+    const AnimPoseVec& underPoses = skeleton->getRelativeBindPoses();
+    int leftHand = skeleton->nameToJointIndex("LeftHand");
+    int rightHand = skeleton->nameToJointIndex("RightHand");
+    glm::vec3 leftShoulder = skeleton->getAbsoluteBindPose(skeleton->nameToJointIndex("LeftArm")).trans;
+    glm::vec3 rightShoulder = skeleton->getAbsoluteBindPose(skeleton->nameToJointIndex("RightArm")).trans;
+
+    AnimVariantMap vars;
+    vars.set("leftHandType", (int)IKTarget::Type::RotationAndPosition);
+    vars.set("rightHandType", (int)IKTarget::Type::RotationAndPosition);
+    vars.set("leftHandRotation", skeleton->getAbsoluteBindPose(leftHand).rot);
+    vars.set("rightHandRotation", skeleton->getAbsoluteBindPose(rightHand).rot);
+
+    BenchmarkResult result;
+    AnimPoseVec absolutePoses;
+    for (int frame = 0; frame < numFrames; frame++) {
+        // the hands trace circles in front of the shoulders, within reach
+        float phase = frame * FRAME_DT * TWO_PI * 0.5f;
+        glm::vec3 leftPosition = leftShoulder + glm::vec3(0.2f + 0.1f * cosf(phase), 0.15f * sinf(phase), 0.35f);
+        glm::vec3 rightPosition = rightShoulder + glm::vec3(-0.2f + 0.1f * sinf(phase), 0.15f * cosf(phase), 0.35f);
+        vars.set("leftHandPosition", leftPosition);
+        vars.set("rightHandPosition", rightPosition);
+
+        AnimNode::Triggers triggers;
+        quint64 start = usecTimestampNow();
+        ik.overlay(vars, FRAME_DT, triggers, underPoses);
+        quint64 solveTime = usecTimestampNow() - start;
+
+        // the first frame only finds the joints of the targets
+        if (frame > 0) {
+            result.numSolves++;
+            result.solveTime += solveTime;
+            result.numLoops += ik.getNumSolverLoops();
+
+            ik.computeAbsolutePoses(absolutePoses);
+            result.totalError += glm::distance(absolutePoses[leftHand].trans, leftPosition);
+            result.totalError += glm::distance(absolutePoses[rightHand].trans, rightPosition);
+        }
+    }
+    return result;
+}
+
+void AnimInverseKinematicsBenchmarkTests::benchmarkSolvers() {
+    int numFrames = getNumFrames();
+    const char* NAMES[] = { "ccd", "fabrik" };
+    const AnimInverseKinematics::Solver SOLVERS[] = {
+        AnimInverseKinematics::Solver::CyclicCoordinateDescent,
+        AnimInverseKinematics::Solver::FABRIK
+    };
+
+    for (int i = 0; i < 2; i++) {
+        BenchmarkResult result = runSolver(SOLVERS[i], numFrames);
+        QVERIFY(result.numSolves > 0);
+
+        float meanError = result.totalError / (2.0f * result.numSolves);
+        QVERIFY(!glm::isnan(meanError));
+
+        qDebug() << NAMES[i] << "solver, two hand targets," << result.numSolves << "frames:"
+            << (float)result.solveTime / result.numSolves << "usecs per solve,"
+            << (float)result.numLoops / result.numSolves << "loops per solve,"
+            << meanError << "meters from the targets on average";
+    }
+}
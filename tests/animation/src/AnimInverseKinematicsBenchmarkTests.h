@@ -0,0 +1,27 @@
+//
+//  AnimInverseKinematicsBenchmarkTests.h
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimInverseKinematicsBenchmarkTests_h
+#define hifi_AnimInverseKinematicsBenchmarkTests_h
+
+#include <QtTest/QtTest>
+
+// Moves the hand targets of an upper body skeleton around in front of it, the way hand controllers do, and solves
+// them with each of the solvers of AnimInverseKinematics. Reports the solve time per frame, the iterations it took
+// and how far the hands ended up from their targets.
+//
+// HIFI_IK_BENCHMARK_FRAMES sets the number of frames.
+class AnimInverseKinematicsBenchmarkTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void benchmarkSolvers();
+};
+
+#endif // hifi_AnimInverseKinematicsBenchmarkTests_h
@@ -10,10 +10,12 @@
 #include "AnimTests.h"
 #include "AnimNodeLoader.h"
 #include "AnimClip.h"
+#include "AnimClipData.h"
 #include "AnimBlendLinear.h"
 #include "AnimationLogging.h"
 #include "AnimVariant.h"
 #include "AnimUtil.h"
+#include "GLMHelpers.h"
 
 #include <../QTestExtensions.h>
 
@@ -240,6 +242,47 @@ void AnimTests::testVariant() {
     QVERIFY(m[3].w == 16.0f);
 }
 
+void AnimTests::testVariantMapSlots() {
+    AnimVariantMap vars;
+    vars.set("slotsFloat", 2.0f);
+
+    // a key of a name the map was set with by name finds the same value, and the other way around
+    AnimVariantKey floatKey("slotsFloat");
+    QVERIFY(!floatKey.isEmpty());
+    QCOMPARE(AnimVariantKey::find("slotsFloat").getSlot(), floatKey.getSlot());
+    QCOMPARE(vars.lookup(floatKey, 0.0f), 2.0f);
+    vars.set(floatKey, 3.0f);
+    QCOMPARE(vars.lookup("slotsFloat", 0.0f), 3.0f);
+
+    // names that were never interned are not found, and looking them up doesn't intern them
+    QVERIFY(!vars.hasKey("slotsNeverSet"));
+    QVERIFY(AnimVariantKey::find("slotsNeverSet").isEmpty());
+    QCOMPARE(vars.lookup(AnimVariantKey(), 4.0f), 4.0f);
+
+    // a key interned after the map was filled lands past its slots
+    AnimVariantKey intKey("slotsInt");
+    QVERIFY(!vars.hasKey(intKey));
+    QCOMPARE(vars.lookup(intKey, 5), 5);
+    vars.set(intKey, 6);
+    QCOMPARE(vars.lookup(intKey, 5), 6);
+
+    AnimVariantKey triggerKey("slotsTrigger");
+    QVERIFY(!vars.lookup(triggerKey, false));
+    vars.setTrigger(triggerKey);
+    QVERIFY(vars.lookup(triggerKey, false));
+    vars.clearTriggers();
+    QVERIFY(!vars.lookup(triggerKey, false));
+
+    vars.unset("slotsFloat");
+    QVERIFY(!vars.hasKey(floatKey));
+    QCOMPARE(vars.lookup(floatKey, 1.0f), 1.0f);
+
+    AnimVariantMap copy;
+    copy.copyVariantsFrom(vars);
+    QCOMPARE(copy.lookup(intKey, 0), 6);
+    QVERIFY(!copy.hasKey(floatKey));
+}
+
 void AnimTests::testAccumulateTime() {
 
     float startFrame = 0.0f;
@@ -323,3 +366,89 @@ void AnimTests::testAccumulateTimeWithParameters(float startFrame, float endFram
     QVERIFY(!triggers.empty() && triggers[0] == "testNodeOnLoop");
     triggers.clear();
 }
+
+void AnimTests::testBlend() {
+    // enough poses for the four at a time and the ones left over, with opposite rotations that lerp to nothing
+    const int NUM_POSES = 7;
+    AnimPoseVec a(NUM_POSES);
+    AnimPoseVec b(NUM_POSES);
+    for (int i = 0; i < NUM_POSES; i++) {
+        float angle = 0.3f * (float)i;
+        a[i] = AnimPose(glm::vec3(1.0f + i), glm::angleAxis(angle, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3((float)i, 0.0f, 0.0f));
+        b[i] = AnimPose(glm::vec3(2.0f), glm::angleAxis(-angle, glm::vec3(1.0f, 0.0f, 0.0f)), glm::vec3(0.0f, (float)i, 0.0f));
+    }
+    b[2].rot = -a[2].rot;
+
+    const float ALPHA = 0.5f;
+    AnimPoseVec result(NUM_POSES);
+    ::blend(NUM_POSES, &a[0], &b[0], ALPHA, &result[0]);
+
+    for (int i = 0; i < NUM_POSES; i++) {
+        QCOMPARE_WITH_ABS_ERROR(result[i].scale, lerp(a[i].scale, b[i].scale, ALPHA), EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(result[i].trans, lerp(a[i].trans, b[i].trans, ALPHA), EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(result[i].rot, glm::normalize(glm::lerp(a[i].rot, b[i].rot, ALPHA)), EPSILON);
+    }
+
+    // the result may be one of the inputs
+    AnimPoseVec expected = result;
+    ::blend(NUM_POSES, &a[0], &b[0], ALPHA, &a[0]);
+    for (int i = 0; i < NUM_POSES; i++) {
+        QCOMPARE_WITH_ABS_ERROR(a[i].trans, expected[i].trans, EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(a[i].rot, expected[i].rot, EPSILON);
+    }
+}
+
+void AnimTests::testClipDataCompression() {
+    // a root and a child, the child turns at a steady rate while the root holds still
+    std::vector<FBXJoint> joints(2);
+    for (auto& joint : joints) {
+        joint.isFree = false;
+        joint.distanceToParent = 1.0f;
+        joint.preTransform = glm::mat4();
+        joint.postTransform = glm::mat4();
+        joint.isSkeletonJoint = false;
+        joint.bindTransformFoundInCluster = false;
+    }
+    joints[0].name = "A";
+    joints[0].parentIndex = -1;
+    joints[0].translation = glm::vec3(0.0f);
+    joints[1].name = "B";
+    joints[1].parentIndex = 0;
+    joints[1].translation = glm::vec3(1.0f, 0.0f, 0.0f);
+
+    AnimSkeleton skeleton(joints, AnimPose(glm::vec3(1.0f), glm::quat(), glm::vec3(0.0f)));
+    AnimSkeleton sameSkeleton(joints, AnimPose(glm::vec3(1.0f), glm::quat(), glm::vec3(0.0f)));
+
+    FBXGeometry geometry;
+    geometry.joints = QVector<FBXJoint>::fromStdVector(joints);
+    const int NUM_FRAMES = 300;
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        FBXAnimationFrame frame;
+        frame.rotations.push_back(glm::quat());
+        frame.rotations.push_back(glm::angleAxis(0.01f * (float)i, glm::vec3(0.0f, 0.0f, 1.0f)));
+        frame.translations.push_back(glm::vec3(0.0f));
+        frame.translations.push_back(glm::vec3(1.0f, 0.0f, 0.0f));
+        geometry.animationFrames.push_back(frame);
+    }
+
+    const QString URL("test://clipDataCompression.fbx");
+    AnimClipData::Pointer clipData = AnimClipData::get(URL, geometry, skeleton);
+    QCOMPARE(clipData->getFrameCount(), NUM_FRAMES);
+    QCOMPARE(clipData->getJointCount(), 2);
+
+    // the keys take less than the frames would with a full precision pose per joint
+    QVERIFY(clipData->getKeysSize() < (size_t)(NUM_FRAMES * 2 * (sizeof(glm::quat) + sizeof(glm::vec3))) / 4);
+
+    // and every frame comes back close to the original
+    AnimPoseVec poses(2);
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        clipData->sampleFrame(i, &poses[0]);
+        glm::quat expected = skeleton.getRelativeBindPose(1).rot * geometry.animationFrames[i].rotations[1];
+        QCOMPARE_WITH_ABS_ERROR(poses[1].rot, expected, 0.002f);
+        QCOMPARE_WITH_ABS_ERROR(poses[1].trans, skeleton.getRelativeBindPose(1).trans, EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(poses[0].rot, skeleton.getRelativeBindPose(0).rot, EPSILON);
+    }
+
+    // skeletons with the same joints share the data
+    QVERIFY(AnimClipData::get(URL, geometry, sameSkeleton) == clipData);
+}
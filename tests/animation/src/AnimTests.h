@@ -25,7 +25,10 @@ private slots:
     void testClipEvaulateWithVars();
     void testLoader();
     void testVariant();
+    void testVariantMapSlots();
     void testAccumulateTime();
+    void testBlend();
+    void testClipDataCompression();
 };
 
 #endif // hifi_AnimTests_h
@@ -0,0 +1,141 @@
+//
+//  AudioHRTFTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioHRTFTests.h"
+
+#include <AudioFFT.h>
+#include <AudioHRTF.h>
+
+QTEST_MAIN(AudioHRTFTests)
+
+using namespace AudioHRTFConstants;
+
+static void fillSamples(int16_t* samples, int numSamples, int amplitude) {
+    qsrand(1234);
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = (int16_t)((qrand() % (2 * amplitude)) - amplitude);
+    }
+}
+
+// the stereo frame of one source alone, heard from the direction through a filter kept by the caller
+static void mixFrame(const AudioHRTFTable& table, const int16_t* previousAndCurrentFrames, AudioHRTFFilter& filter,
+                     const glm::vec3& direction, int32_t* stereoMix) {
+    AudioHRTFTable::Complex spectrum[NUM_BINS];
+    table.transformInput(previousAndCurrentFrames, spectrum);
+
+    AudioHRTFMix mix;
+    mix.begin();
+    mix.addSource(table, spectrum, filter, direction, 1.0f, 1.0f);
+    memset(stereoMix, 0, 2 * FRAME_SAMPLES * sizeof(int32_t));
+    mix.render(table, stereoMix);
+}
+
+static int findPeak(const int32_t* stereoMix, int channel) {
+    int peak = 0;
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+        if (abs(stereoMix[2 * i + channel]) > abs(stereoMix[2 * peak + channel])) {
+            peak = i;
+        }
+    }
+    return peak;
+}
+
+void AudioHRTFTests::fftRoundTrip() {
+    AudioFFT fft(FFT_SIZE);
+
+    int16_t samples[FFT_SIZE];
+    fillSamples(samples, FFT_SIZE, 10000);
+
+    float input[FFT_SIZE];
+    for (int i = 0; i < FFT_SIZE; i++) {
+        input[i] = samples[i];
+    }
+
+    AudioFFT::Complex bins[NUM_BINS];
+    float output[FFT_SIZE];
+    fft.forward(input, bins);
+    fft.inverse(bins, output);
+
+    for (int i = 0; i < FFT_SIZE; i++) {
+        QVERIFY(fabsf(output[i] - input[i]) < 0.01f);
+    }
+
+    // the DC bin is the sum of the samples
+    float sum = 0.0f;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        sum += input[i];
+    }
+    QVERIFY(fabsf(bins[0].real() - sum) < 1.0f);
+}
+
+void AudioHRTFTests::mixMatchesDirectConvolution() {
+    AudioHRTFTable table;
+    const glm::vec3 DIRECTION = glm::normalize(glm::vec3(0.6f, 0.1f, -0.8f));
+    const int IMPULSE_AMPLITUDE = 10000;
+
+    // the impulse response, from an impulse at the start of the current frame
+    int16_t impulse[FFT_SIZE] = { 0 };
+    impulse[FRAME_SAMPLES] = IMPULSE_AMPLITUDE;
+    AudioHRTFFilter impulseFilter;
+    int32_t response[2 * FRAME_SAMPLES];
+    mixFrame(table, impulse, impulseFilter, DIRECTION, response);
+
+    // then noise through a filter that is kept from frame to frame, like the mixer does
+    const int NUM_FRAMES = 4;
+    int16_t noise[(NUM_FRAMES + 1) * FRAME_SAMPLES];
+    fillSamples(noise, (NUM_FRAMES + 1) * FRAME_SAMPLES, 1000);
+
+    AudioHRTFFilter filter;
+    int32_t stereoMix[2 * FRAME_SAMPLES];
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        mixFrame(table, noise + frame * FRAME_SAMPLES, filter, DIRECTION, stereoMix);
+    }
+
+    // the last frame is the convolution of the noise with the response, up to the rounding of both to integers
+    int lastFrameStart = NUM_FRAMES * FRAME_SAMPLES;
+    for (int channel = 0; channel < 2; channel++) {
+        for (int i = 0; i < FRAME_SAMPLES; i++) {
+            float expected = 0.0f;
+            for (int j = 0; j < FRAME_SAMPLES; j++) {
+                expected += (float)response[2 * j + channel] / IMPULSE_AMPLITUDE * noise[lastFrameStart + i - j];
+            }
+            QVERIFY(fabsf(stereoMix[2 * i + channel] - expected) < 20.0f);
+        }
+    }
+}
+
+void AudioHRTFTests::sourceOnTheRightIsLouderAndEarlierOnTheRight() {
+    AudioHRTFTable table;
+
+    int16_t impulse[FFT_SIZE] = { 0 };
+    impulse[FRAME_SAMPLES] = 10000;
+    AudioHRTFFilter filter;
+    int32_t stereoMix[2 * FRAME_SAMPLES];
+    mixFrame(table, impulse, filter, glm::vec3(1.0f, 0.0f, 0.0f), stereoMix);
+
+    int leftPeak = findPeak(stereoMix, 0);
+    int rightPeak = findPeak(stereoMix, 1);
+    QVERIFY(rightPeak < leftPeak);
+    QVERIFY(abs(stereoMix[2 * rightPeak + 1]) > 2 * abs(stereoMix[2 * leftPeak]));
+}
+
+void AudioHRTFTests::sourceAheadIsTheSameInBothEars() {
+    AudioHRTFTable table;
+
+    int16_t noise[FFT_SIZE];
+    fillSamples(noise, FFT_SIZE, 10000);
+    AudioHRTFFilter filter;
+    int32_t stereoMix[2 * FRAME_SAMPLES];
+    mixFrame(table, noise, filter, glm::vec3(0.0f, 0.0f, -1.0f), stereoMix);
+
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+        QVERIFY(abs(stereoMix[2 * i] - stereoMix[2 * i + 1]) <= 1);
+    }
+}
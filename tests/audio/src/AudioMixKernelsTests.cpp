@@ -0,0 +1,153 @@
+//
+//  AudioMixKernelsTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixKernelsTests.h"
+
+#include <AudioConstants.h>
+#include <AudioMixKernels.h>
+#include <CPUDetect.h>
+
+QTEST_MAIN(AudioMixKernelsTests)
+
+// odd on purpose, so that both the vector and the remainder paths are exercised
+const int NUM_SAMPLES = 1029;
+
+static void fillSamples(int16_t* samples, int numSamples) {
+    qsrand(1234);
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = (int16_t)((qrand() % 65536) - 32768);
+    }
+}
+
+static int16_t clampSample(int32_t sample) {
+    return (int16_t)qBound(AudioConstants::MIN_SAMPLE_VALUE, sample, AudioConstants::MAX_SAMPLE_VALUE);
+}
+
+void AudioMixKernelsTests::accumulateMatchesScalar() {
+    int16_t input[NUM_SAMPLES];
+    fillSamples(input, NUM_SAMPLES);
+
+    int32_t accumulator[NUM_SAMPLES];
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        accumulator[i] = i;
+    }
+
+    AudioMixKernels::accumulate(accumulator, input, NUM_SAMPLES);
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(accumulator[i], (int32_t)(i + input[i]));
+    }
+}
+
+void AudioMixKernelsTests::accumulateWithGainMatchesScalar() {
+    int16_t input[NUM_SAMPLES];
+    fillSamples(input, NUM_SAMPLES);
+
+    int32_t accumulator[NUM_SAMPLES] = { 0 };
+    const float GAIN = 0.37f;
+
+    AudioMixKernels::accumulateWithGain(accumulator, input, GAIN, NUM_SAMPLES);
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(accumulator[i], (int32_t)(input[i] * GAIN));
+    }
+}
+
+void AudioMixKernelsTests::accumulateMonoToStereoMatchesScalar() {
+    int16_t input[NUM_SAMPLES];
+    fillSamples(input, NUM_SAMPLES);
+
+    int32_t accumulator[2 * NUM_SAMPLES] = { 0 };
+    const float LEFT_GAIN = 0.81f;
+    const float RIGHT_GAIN = 0.29f;
+
+    AudioMixKernels::accumulateMonoToStereo(accumulator, input, LEFT_GAIN, RIGHT_GAIN, NUM_SAMPLES);
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(accumulator[2 * i], (int32_t)(input[i] * LEFT_GAIN));
+        QCOMPARE(accumulator[2 * i + 1], (int32_t)(input[i] * RIGHT_GAIN));
+    }
+}
+
+void AudioMixKernelsTests::applyGainSaturates() {
+    int16_t input[NUM_SAMPLES];
+    fillSamples(input, NUM_SAMPLES);
+
+    int16_t samples[NUM_SAMPLES];
+    memcpy(samples, input, sizeof(samples));
+
+    const float GAIN = 2.5f;
+    AudioMixKernels::applyGain(samples, GAIN, NUM_SAMPLES);
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(samples[i], clampSample((int32_t)(input[i] * GAIN)));
+    }
+}
+
+void AudioMixKernelsTests::saturateClampsOnce() {
+    int16_t input[NUM_SAMPLES];
+    fillSamples(input, NUM_SAMPLES);
+
+    // mix the same stream in several times so that the int32 mix leaves the int16 range
+    const int NUM_STREAMS = 5;
+    int32_t accumulator[NUM_SAMPLES] = { 0 };
+    for (int i = 0; i < NUM_STREAMS; i++) {
+        AudioMixKernels::accumulate(accumulator, input, NUM_SAMPLES);
+    }
+
+    int16_t output[NUM_SAMPLES];
+    AudioMixKernels::saturate(accumulator, output, NUM_SAMPLES);
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(output[i], clampSample(NUM_STREAMS * input[i]));
+    }
+}
+
+void AudioMixKernelsTests::applyGainToFloatMatchesScalar() {
+    int16_t input[NUM_SAMPLES];
+    fillSamples(input, NUM_SAMPLES);
+
+    float samples[NUM_SAMPLES];
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        samples[i] = input[i] / 32768.0f;
+    }
+
+    const float GAIN = 0.63f;
+    AudioMixKernels::applyGain(samples, GAIN, NUM_SAMPLES);
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(samples[i], (input[i] / 32768.0f) * GAIN);
+    }
+}
+
+// each iteration mixes 1 second of a stereo listener mix from mono streams, as the mixer and the Android client do
+void AudioMixKernelsTests::mixBenchmark() {
+    qDebug() << "AVX2 kernels:" << cpuSupportsAVX2() << "NEON kernels:" << cpuSupportsNEON();
+
+    const int NUM_STREAMS = 16;
+    const int NUM_FRAMES = AudioConstants::SAMPLE_RATE / AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+    int16_t input[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    fillSamples(input, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    int32_t accumulator[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    int16_t output[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    QBENCHMARK {
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            memset(accumulator, 0, sizeof(accumulator));
+            for (int i = 0; i < NUM_STREAMS; i++) {
+                AudioMixKernels::accumulateMonoToStereo(accumulator, input, 0.5f, 0.25f,
+                                                        AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            }
+            AudioMixKernels::saturate(accumulator, output, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+//
+//  AudioMixKernelsTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernelsTests_h
+#define hifi_AudioMixKernelsTests_h
+
+#include <QtTest/QtTest>
+
+class AudioMixKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void accumulateMatchesScalar();
+    void accumulateWithGainMatchesScalar();
+    void accumulateMonoToStereoMatchesScalar();
+    void applyGainSaturates();
+    void saturateClampsOnce();
+    void applyGainToFloatMatchesScalar();
+    void mixBenchmark();
+};
+
+#endif // hifi_AudioMixKernelsTests_h
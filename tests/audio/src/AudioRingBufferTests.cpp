@@ -11,6 +11,9 @@
 
 #include "AudioRingBufferTests.h"
 
+#include <thread>
+
+#include "AudioRingBufferPool.h"
 #include "SharedUtil.h"
 
 // Adds an implicit cast to make sure that actual and expected are of the same type.
@@ -125,3 +128,85 @@ void AudioRingBufferTests::runAllTests() {
         assertBufferSize(ringBuffer, 0);
     }
 }
+
+void AudioRingBufferTests::singleProducerSingleConsumerOverflow() {
+    AudioRingBuffer ringBuffer(10, false, 10);
+    ringBuffer.setSingleProducerSingleConsumer(true);
+
+    int16_t writeData[120];
+    for (int i = 0; i < 120; i++) {
+        writeData[i] = i;
+    }
+
+    // the writer can't move the read position, the samples that don't fit are dropped
+    QCOMPARE(ringBuffer.writeSamples(writeData, 90), 90);
+    QCOMPARE(ringBuffer.writeSamples(&writeData[90], 30), 10);
+    QCOMPARE(ringBuffer.getOverflowCount(), 1);
+    assertBufferSize(ringBuffer, 100);
+
+    int16_t readData[100];
+    QCOMPARE(ringBuffer.readSamples(readData, 100), 100);
+    for (int i = 0; i < 100; i++) {
+        QCOMPARE(readData[i], static_cast<int16_t>(i));
+    }
+}
+
+void AudioRingBufferTests::singleProducerSingleConsumerThreads() {
+    const int FRAME_SAMPLES = 64;
+    const int NUM_SAMPLES = 1 << 20;
+    AudioRingBuffer ringBuffer(FRAME_SAMPLES, false, 4);
+    ringBuffer.setSingleProducerSingleConsumer(true);
+
+    // the writer only writes what fits so nothing is dropped, and the reader has to get every sample in order
+    std::thread writer([&] {
+        int16_t frame[FRAME_SAMPLES];
+        int sample = 0;
+        while (sample < NUM_SAMPLES) {
+            int room = ringBuffer.getSampleCapacity() - ringBuffer.samplesAvailable();
+            int samplesToWrite = std::min(std::min(room, FRAME_SAMPLES), NUM_SAMPLES - sample);
+            for (int i = 0; i < samplesToWrite; i++) {
+                frame[i] = (int16_t)(sample + i);
+            }
+            sample += ringBuffer.writeSamples(frame, samplesToWrite);
+        }
+    });
+
+    int16_t readData[FRAME_SAMPLES / 2];
+    int sample = 0;
+    int outOfOrder = 0;
+    while (sample < NUM_SAMPLES) {
+        int samplesRead = ringBuffer.readSamples(readData, FRAME_SAMPLES / 2);
+        for (int i = 0; i < samplesRead; i++) {
+            if (readData[i] != (int16_t)(sample + i)) {
+                outOfOrder++;
+            }
+        }
+        sample += samplesRead;
+    }
+    writer.join();
+
+    QCOMPARE(outOfOrder, 0);
+    QCOMPARE(ringBuffer.getOverflowCount(), 0);
+    assertBufferSize(ringBuffer, 0);
+}
+
+void AudioRingBufferTests::pooledStorageReused() {
+    // an odd frame size no other test uses, so the buffers are only the ones made here
+    const int FRAME_SAMPLES = 97;
+    const int NUM_FRAMES = 3;
+
+    auto statsBefore = AudioRingBufferPool::getStats();
+    {
+        AudioRingBuffer ringBuffer(FRAME_SAMPLES, false, NUM_FRAMES);
+    }
+    auto statsAfterFirst = AudioRingBufferPool::getStats();
+    QCOMPARE(statsAfterFirst.bytesInUse, statsBefore.bytesInUse);
+
+    {
+        // a buffer of the same length reuses the storage of the one before
+        AudioRingBuffer ringBuffer(FRAME_SAMPLES, false, NUM_FRAMES);
+        QCOMPARE(AudioRingBufferPool::getStats().hits, statsAfterFirst.hits + 1);
+        QCOMPARE(AudioRingBufferPool::getStats().numBuffers, statsAfterFirst.numBuffers);
+    }
+    QCOMPARE(AudioRingBufferPool::getStats().bytesInUse, statsBefore.bytesInUse);
+}
@@ -21,6 +21,9 @@ class AudioRingBufferTests : public QObject {
     Q_OBJECT
 private slots:
     void runAllTests();
+    void singleProducerSingleConsumerOverflow();
+    void singleProducerSingleConsumerThreads();
+    void pooledStorageReused();
 private:
     void assertBufferSize(const AudioRingBuffer& buffer, int samples);
 };
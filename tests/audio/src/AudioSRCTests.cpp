@@ -0,0 +1,131 @@
+//
+//  AudioSRCTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSRCTests.h"
+
+#include <cmath>
+
+#include <AudioSRC.h>
+#include <CPUDetect.h>
+
+QTEST_MAIN(AudioSRCTests)
+
+// odd on purpose, so that both the vector and the remainder paths of the conversions are exercised
+const int BLOCK_FRAMES = 477;
+const int NUM_BLOCKS = 100;
+
+const float SINE_FREQUENCY = 440.0f;
+const float SINE_AMPLITUDE = 12000.0f;
+
+static void addRatePairs() {
+    QTest::addColumn<int>("inputRate");
+    QTest::addColumn<int>("outputRate");
+    QTest::addColumn<int>("numChannels");
+
+    // the device rates to and from the network rate, the last one takes the irrational path
+    const int RATE_PAIRS[][2] = {
+        { 48000, 24000 }, { 24000, 48000 }, { 44100, 24000 }, { 24000, 44100 }, { 44100, 48000 }, { 24000, 23999 }
+    };
+    for (const auto& rates : RATE_PAIRS) {
+        for (int numChannels = 1; numChannels <= AudioSRC::MAX_CHANNELS; numChannels++) {
+            QString name = QString("%1 to %2, %3 channel(s)").arg(rates[0]).arg(rates[1]).arg(numChannels);
+            QTest::newRow(name.toLatin1().constData()) << rates[0] << rates[1] << numChannels;
+        }
+    }
+}
+
+static QVector<int16_t> sine(int sampleRate, int numChannels, int numFrames) {
+    QVector<int16_t> samples(numFrames * numChannels);
+    for (int i = 0; i < numFrames; i++) {
+        for (int j = 0; j < numChannels; j++) {
+            samples[i * numChannels + j] = (int16_t)(SINE_AMPLITUDE * sinf(2.0f * (float)M_PI * SINE_FREQUENCY * i / sampleRate + j));
+        }
+    }
+    return samples;
+}
+
+void AudioSRCTests::outputFramesInRange_data() {
+    addRatePairs();
+}
+
+void AudioSRCTests::outputFramesInRange() {
+    QFETCH(int, inputRate);
+    QFETCH(int, outputRate);
+    QFETCH(int, numChannels);
+
+    AudioSRC resampler(inputRate, outputRate, numChannels);
+    QVector<int16_t> input = sine(inputRate, numChannels, BLOCK_FRAMES);
+    QVector<int16_t> output(resampler.getMaxOutput(BLOCK_FRAMES) * numChannels);
+
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        int numFrames = resampler.render(input.constData(), output.data(), BLOCK_FRAMES);
+        QVERIFY(numFrames >= resampler.getMinOutput(BLOCK_FRAMES));
+        QVERIFY(numFrames <= resampler.getMaxOutput(BLOCK_FRAMES));
+    }
+}
+
+void AudioSRCTests::sinePassesThrough_data() {
+    addRatePairs();
+}
+
+// a tone well inside the passband comes out with the same level, whichever kernels the CPU takes
+void AudioSRCTests::sinePassesThrough() {
+    QFETCH(int, inputRate);
+    QFETCH(int, outputRate);
+    QFETCH(int, numChannels);
+
+    AudioSRC resampler(inputRate, outputRate, numChannels);
+    QVector<int16_t> input = sine(inputRate, numChannels, BLOCK_FRAMES * NUM_BLOCKS);
+    QVector<int16_t> output(resampler.getMaxOutput(BLOCK_FRAMES * NUM_BLOCKS) * numChannels);
+
+    int numFrames = 0;
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        numFrames += resampler.render(input.constData() + i * BLOCK_FRAMES * numChannels,
+                                      output.data() + numFrames * numChannels, BLOCK_FRAMES);
+    }
+
+    // skip the start, where the filter is still filling up
+    int firstFrame = numFrames / 4;
+    double energy = 0.0;
+    for (int i = firstFrame * numChannels; i < numFrames * numChannels; i++) {
+        energy += (double)output[i] * output[i];
+    }
+    double rms = sqrt(energy / ((numFrames - firstFrame) * numChannels));
+
+    const double EXPECTED_RMS = SINE_AMPLITUDE / sqrt(2.0);
+    const double RMS_TOLERANCE = 0.01;
+    QVERIFY(fabs(rms - EXPECTED_RMS) < EXPECTED_RMS * RMS_TOLERANCE);
+}
+
+void AudioSRCTests::renderBenchmark_data() {
+    addRatePairs();
+}
+
+// each iteration resamples 1 second of input, so its time is the cost of a second of audio
+void AudioSRCTests::renderBenchmark() {
+    QFETCH(int, inputRate);
+    QFETCH(int, outputRate);
+    QFETCH(int, numChannels);
+
+    qDebug() << "AVX2 kernels:" << cpuSupportsAVX2() << "NEON kernels:" << cpuSupportsNEON();
+
+    AudioSRC resampler(inputRate, outputRate, numChannels);
+    int numBlocks = inputRate / BLOCK_FRAMES;
+    QVector<int16_t> input = sine(inputRate, numChannels, BLOCK_FRAMES);
+    QVector<int16_t> output(resampler.getMaxOutput(BLOCK_FRAMES) * numChannels);
+
+    int numFrames = 0;
+    QBENCHMARK {
+        for (int i = 0; i < numBlocks; i++) {
+            numFrames += resampler.render(input.constData(), output.data(), BLOCK_FRAMES);
+        }
+    }
+    QVERIFY(numFrames > 0);
+}
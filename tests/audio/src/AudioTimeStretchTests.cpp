@@ -0,0 +1,88 @@
+//
+//  AudioTimeStretchTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioTimeStretchTests.h"
+
+#include <cmath>
+
+#include <AudioConstants.h>
+#include <AudioTimeStretch.h>
+
+QTEST_MAIN(AudioTimeStretchTests)
+
+const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+const int NUM_CHANNELS = 2;
+
+// a period of 120 frames at 24kHz, which fits twice in a network frame
+const float SINE_FREQUENCY = 200.0f;
+const float SINE_AMPLITUDE = 8000.0f;
+const int SINE_PERIOD_FRAMES = 120;
+
+static void makeSine(int16_t* samples) {
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        float value = SINE_AMPLITUDE * sinf(2.0f * (float)M_PI * SINE_FREQUENCY * i / AudioConstants::SAMPLE_RATE);
+        samples[i * NUM_CHANNELS] = (int16_t)value;
+        samples[i * NUM_CHANNELS + 1] = (int16_t)(value / 2.0f);
+    }
+}
+
+void AudioTimeStretchTests::stretchByOnePeriod_data() {
+    QTest::addColumn<bool>("accelerate");
+    QTest::newRow("accelerate") << true;
+    QTest::newRow("expand") << false;
+}
+
+void AudioTimeStretchTests::stretchByOnePeriod() {
+    QFETCH(bool, accelerate);
+
+    int16_t input[NUM_FRAMES * NUM_CHANNELS];
+    makeSine(input);
+
+    QByteArray output;
+    bool stretched = accelerate ? AudioTimeStretch::accelerate(input, NUM_FRAMES, NUM_CHANNELS, output) :
+        AudioTimeStretch::expand(input, NUM_FRAMES, NUM_CHANNELS, output);
+    QVERIFY(stretched);
+
+    int numOutputFrames = output.size() / (NUM_CHANNELS * sizeof(int16_t));
+    QCOMPARE(numOutputFrames, NUM_FRAMES + (accelerate ? -SINE_PERIOD_FRAMES : SINE_PERIOD_FRAMES));
+
+    // both ends are kept so the frame still joins its neighbours, and there's no click in between
+    const int16_t* samples = reinterpret_cast<const int16_t*>(output.constData());
+    QCOMPARE(samples[0], input[0]);
+    QCOMPARE(samples[(numOutputFrames - 1) * NUM_CHANNELS], input[(NUM_FRAMES - 1) * NUM_CHANNELS]);
+
+    const float MAX_STEP = SINE_AMPLITUDE * 2.0f * (float)M_PI * SINE_FREQUENCY / AudioConstants::SAMPLE_RATE + 2.0f;
+    for (int i = 1; i < numOutputFrames; i++) {
+        QVERIFY(std::abs(samples[i * NUM_CHANNELS] - samples[(i - 1) * NUM_CHANNELS]) <= MAX_STEP);
+    }
+}
+
+void AudioTimeStretchTests::noiseIsLeftAlone() {
+    int16_t input[NUM_FRAMES * NUM_CHANNELS];
+    qsrand(1);
+    for (int i = 0; i < NUM_FRAMES * NUM_CHANNELS; i++) {
+        input[i] = (int16_t)(qrand() % 20000 - 10000);
+    }
+
+    QByteArray output;
+    QVERIFY(!AudioTimeStretch::accelerate(input, NUM_FRAMES, NUM_CHANNELS, output));
+    QVERIFY(!AudioTimeStretch::expand(input, NUM_FRAMES, NUM_CHANNELS, output));
+}
+
+void AudioTimeStretchTests::quietIsStretchedMost() {
+    int16_t input[NUM_FRAMES * NUM_CHANNELS];
+    for (int i = 0; i < NUM_FRAMES * NUM_CHANNELS; i++) {
+        input[i] = (int16_t)(i % 7 - 3);
+    }
+
+    QByteArray output;
+    QVERIFY(AudioTimeStretch::accelerate(input, NUM_FRAMES, NUM_CHANNELS, output));
+    QCOMPARE((int)(output.size() / (NUM_CHANNELS * sizeof(int16_t))), NUM_FRAMES / 2);
+}
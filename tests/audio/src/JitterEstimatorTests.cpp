@@ -0,0 +1,68 @@
+//
+//  JitterEstimatorTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JitterEstimatorTests.h"
+
+#include <AudioConstants.h>
+#include <JitterEstimator.h>
+
+QTEST_MAIN(JitterEstimatorTests)
+
+const int FRAME_USECS = AudioConstants::NETWORK_FRAME_USECS;
+
+// one packet in ten comes 4 frames late, and the ones held up behind it right after
+const int BURST_PERIOD = 10;
+const int BURST_FRAMES = 5;
+
+static void addSteadyPackets(JitterEstimator& estimator, int numPackets) {
+    for (int i = 0; i < numPackets; i++) {
+        estimator.packetArrived(FRAME_USECS);
+    }
+}
+
+static void addBurstyPackets(JitterEstimator& estimator, int numPackets) {
+    for (int i = 0; i < numPackets; i++) {
+        int position = i % BURST_PERIOD;
+        if (position == 0) {
+            estimator.packetArrived(BURST_FRAMES * FRAME_USECS);
+        } else if (position < BURST_FRAMES) {
+            estimator.packetArrived(0);
+        } else {
+            estimator.packetArrived(FRAME_USECS);
+        }
+    }
+}
+
+void JitterEstimatorTests::steadyStreamNeedsOneFrame() {
+    JitterEstimator estimator(FRAME_USECS);
+    addSteadyPackets(estimator, 1000);
+
+    QCOMPARE(estimator.getTargetFrames(), 1);
+    QCOMPARE(estimator.getJitterUsecs(), 0.0f);
+}
+
+void JitterEstimatorTests::growsWithLateBursts() {
+    JitterEstimator estimator(FRAME_USECS);
+    addSteadyPackets(estimator, 1000);
+    addBurstyPackets(estimator, 1000);
+
+    QCOMPARE(estimator.getTargetFrames(), BURST_FRAMES);
+    QVERIFY(estimator.getJitterUsecs() > FRAME_USECS / 2.0f);
+}
+
+void JitterEstimatorTests::shrinksBackWhenSteady() {
+    JitterEstimator estimator(FRAME_USECS);
+    addBurstyPackets(estimator, 1000);
+    QCOMPARE(estimator.getTargetFrames(), BURST_FRAMES);
+
+    // the bursts are forgotten in a few seconds, not held on to
+    addSteadyPackets(estimator, 500);
+    QCOMPARE(estimator.getTargetFrames(), 1);
+}
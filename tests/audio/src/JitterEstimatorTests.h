@@ -0,0 +1,24 @@
+//
+//  JitterEstimatorTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JitterEstimatorTests_h
+#define hifi_JitterEstimatorTests_h
+
+#include <QtTest/QtTest>
+
+class JitterEstimatorTests : public QObject {
+    Q_OBJECT
+private slots:
+    void steadyStreamNeedsOneFrame();
+    void growsWithLateBursts();
+    void shrinksBackWhenSteady();
+};
+
+#endif // hifi_JitterEstimatorTests_h
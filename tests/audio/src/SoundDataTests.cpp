@@ -0,0 +1,106 @@
+//
+//  SoundDataTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SoundDataTests.h"
+
+#include <cmath>
+
+#include <AudioConstants.h>
+#include <SoundData.h>
+
+QTEST_MAIN(SoundDataTests)
+
+// not a whole number of network frames, so the last one is padded
+const int NUM_FRAMES = 24000 * 3 + 123;
+
+const float SINE_FREQUENCY = 440.0f;
+const float SINE_AMPLITUDE = 12000.0f;
+
+// ADPCM follows a sine closely, but it isn't lossless
+const int MAX_SAMPLE_ERROR = 1024;
+
+static QByteArray makeSine(int numChannels) {
+    QByteArray samples(NUM_FRAMES * numChannels * sizeof(int16_t), 0);
+    int16_t* output = reinterpret_cast<int16_t*>(samples.data());
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        float phase = 2.0f * (float)M_PI * SINE_FREQUENCY * i / AudioConstants::SAMPLE_RATE;
+        for (int c = 0; c < numChannels; c++) {
+            output[i * numChannels + c] = (int16_t)(SINE_AMPLITUDE * sinf(phase * (c + 1)));
+        }
+    }
+    return samples;
+}
+
+static void addChannels() {
+    QTest::addColumn<int>("numChannels");
+    QTest::newRow("mono") << 1;
+    QTest::newRow("stereo") << 2;
+}
+
+void SoundDataTests::uncompressedReadsAsIs() {
+    QByteArray samples = makeSine(1);
+    SoundData data(samples);
+
+    QVERIFY(!data.isCompressed());
+    QCOMPARE(data.getNumBytes(), samples.size());
+    QCOMPARE(data.decodeAll(), samples);
+
+    QByteArray part(100, 0);
+    data.read(1001, part.size(), part.data());
+    QCOMPARE(part, samples.mid(1001, part.size()));
+}
+
+void SoundDataTests::compressedKeepsFewerBytes_data() {
+    addChannels();
+}
+
+void SoundDataTests::compressedKeepsFewerBytes() {
+    QFETCH(int, numChannels);
+
+    QByteArray samples = makeSine(numChannels);
+    SoundData data = SoundData::compress(samples, numChannels);
+
+    QVERIFY(data.isCompressed());
+    QCOMPARE(data.getNumBytes(), samples.size());
+    QVERIFY(data.getResidentBytes() < samples.size() / 3);
+
+    QByteArray decoded = data.decodeAll();
+    QCOMPARE(decoded.size(), samples.size());
+
+    const int16_t* input = reinterpret_cast<const int16_t*>(samples.constData());
+    const int16_t* output = reinterpret_cast<const int16_t*>(decoded.constData());
+    // the steps of ADPCM take a few samples to grow from silence, the first frame is left out
+    int maxError = 0;
+    for (int i = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * numChannels; i < NUM_FRAMES * numChannels; i++) {
+        maxError = std::max(maxError, std::abs(input[i] - output[i]));
+    }
+    QVERIFY2(maxError <= MAX_SAMPLE_ERROR, qPrintable(QString("max error %1").arg(maxError)));
+}
+
+void SoundDataTests::readMatchesDecodeAll_data() {
+    addChannels();
+}
+
+void SoundDataTests::readMatchesDecodeAll() {
+    QFETCH(int, numChannels);
+
+    SoundData data = SoundData::compress(makeSine(numChannels), numChannels);
+    QByteArray decoded = data.decodeAll();
+
+    // ranges within a frame, across frame boundaries, and up to the end of the padded last frame
+    int frameBytes = numChannels * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
+    const int OFFSETS[] = { 0, 2, frameBytes - 6, 5 * frameBytes + 100, decoded.size() - 300 };
+    for (int offset : OFFSETS) {
+        int numBytes = std::min(3 * frameBytes, decoded.size() - offset);
+        QByteArray part(numBytes, 0);
+        data.read(offset, numBytes, part.data());
+        QCOMPARE(part, decoded.mid(offset, numBytes));
+    }
+}
@@ -0,0 +1,26 @@
+//
+//  SoundDataTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SoundDataTests_h
+#define hifi_SoundDataTests_h
+
+#include <QtTest/QtTest>
+
+class SoundDataTests : public QObject {
+    Q_OBJECT
+private slots:
+    void uncompressedReadsAsIs();
+    void compressedKeepsFewerBytes_data();
+    void compressedKeepsFewerBytes();
+    void readMatchesDecodeAll_data();
+    void readMatchesDecodeAll();
+};
+
+#endif // hifi_SoundDataTests_h
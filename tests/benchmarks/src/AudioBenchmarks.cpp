@@ -0,0 +1,65 @@
+//
+//  AudioBenchmarks.cpp
+//  tests/benchmarks/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioBenchmarks.h"
+
+#include <cmath>
+#include <vector>
+
+#include <AudioConstants.h>
+#include <AudioRingBuffer.h>
+#include <AudioSRC.h>
+
+QTEST_MAIN(AudioBenchmarks)
+
+static std::vector<int16_t> makeSine(int numSamples) {
+    std::vector<int16_t> samples(numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        samples[i] = (int16_t)(16384.0f * sinf((float)i * 0.05f));
+    }
+    return samples;
+}
+
+void AudioBenchmarks::ringBufferBenchmark() {
+    const int FRAME_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+    AudioRingBuffer ringBuffer(FRAME_SAMPLES);
+    std::vector<int16_t> input = makeSine(FRAME_SAMPLES);
+    std::vector<int16_t> output(FRAME_SAMPLES);
+
+    _recorder.run("AudioRingBuffer write and read a frame", [&] {
+        ringBuffer.writeSamples(input.data(), FRAME_SAMPLES);
+        benchmarkSink += ringBuffer.readSamples(output.data(), FRAME_SAMPLES);
+    }, FRAME_SAMPLES);
+}
+
+void AudioBenchmarks::resamplerBenchmark() {
+    const int INPUT_RATE = 48000;
+    const int NUM_CHANNELS = 2;
+    const int INPUT_FRAMES = 480;
+
+    AudioSRC resampler(INPUT_RATE, AudioConstants::SAMPLE_RATE, NUM_CHANNELS);
+    std::vector<int16_t> input = makeSine(INPUT_FRAMES * NUM_CHANNELS);
+    std::vector<int16_t> output(resampler.getMaxOutput(INPUT_FRAMES) * NUM_CHANNELS);
+
+    _recorder.run("AudioSRC 48000 to 24000 stereo", [&] {
+        benchmarkSink += resampler.render(input.data(), output.data(), INPUT_FRAMES);
+    }, INPUT_FRAMES);
+
+    AudioSRC upsampler(44100, INPUT_RATE, NUM_CHANNELS);
+    std::vector<int16_t> upsampledOutput(upsampler.getMaxOutput(INPUT_FRAMES) * NUM_CHANNELS);
+
+    _recorder.run("AudioSRC 44100 to 48000 stereo", [&] {
+        benchmarkSink += upsampler.render(input.data(), upsampledOutput.data(), INPUT_FRAMES);
+    }, INPUT_FRAMES);
+}
+
+void AudioBenchmarks::cleanupTestCase() {
+    QVERIFY(_recorder.write("AudioBenchmarks"));
+}
@@ -0,0 +1,30 @@
+//
+//  AudioBenchmarks.h
+//  tests/benchmarks/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioBenchmarks_h
+#define hifi_AudioBenchmarks_h
+
+#include <QtTest/QtTest>
+
+#include "BenchmarkRecorder.h"
+
+class AudioBenchmarks : public QObject {
+    Q_OBJECT
+
+private slots:
+    void ringBufferBenchmark();
+    void resamplerBenchmark();
+    void cleanupTestCase();
+
+private:
+    BenchmarkRecorder _recorder;
+};
+
+#endif // hifi_AudioBenchmarks_h
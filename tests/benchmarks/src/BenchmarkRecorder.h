@@ -0,0 +1,88 @@
+//
+//  BenchmarkRecorder.h
+//  tests/benchmarks/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BenchmarkRecorder_h
+#define hifi_BenchmarkRecorder_h
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSysInfo>
+
+/// Times benchmarks and writes their results as JSON, so they can be compared across builds. A benchmark body runs in
+/// batches that double in size until one takes MIN_BATCH_MSECS, and the time per call is taken from that batch.
+/// The results go to <suite>.json in HIFI_BENCHMARK_DIR, or in the working directory if that isn't set.
+class BenchmarkRecorder {
+public:
+    static const qint64 MIN_BATCH_MSECS = 200;
+
+    /// \param itemsPerCall what one call of the body processes (samples, bytes, packets), for the items per second
+    template <typename Function>
+    void run(const QString& name, Function body, qint64 itemsPerCall = 1) {
+        body(); // warm up
+
+        qint64 calls = 1;
+        qint64 nsecs = 0;
+        QElapsedTimer timer;
+        for (;;) {
+            timer.start();
+            for (qint64 i = 0; i < calls; ++i) {
+                body();
+            }
+            nsecs = timer.nsecsElapsed();
+            if (nsecs >= MIN_BATCH_MSECS * 1000000) {
+                break;
+            }
+            calls *= 2;
+        }
+
+        double nsecsPerCall = (double)nsecs / (double)calls;
+        QJsonObject result;
+        result["name"] = name;
+        result["calls"] = (double)calls;
+        result["nsecs_per_call"] = nsecsPerCall;
+        result["items_per_second"] = (double)itemsPerCall * 1.0e9 / nsecsPerCall;
+        _results.append(result);
+
+        qDebug().noquote() << name << ":" << nsecsPerCall << "nsecs per call";
+    }
+
+    bool write(const QString& suiteName) const {
+        QJsonObject suite;
+        suite["suite"] = suiteName;
+        suite["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        suite["cpu_architecture"] = QSysInfo::currentCpuArchitecture();
+        suite["results"] = _results;
+
+        QString directory = QString::fromLocal8Bit(qgetenv("HIFI_BENCHMARK_DIR"));
+        if (directory.isEmpty()) {
+            directory = QDir::currentPath();
+        }
+        QFile file(QDir(directory).filePath(suiteName + ".json"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "Unable to write the benchmark results to" << file.fileName();
+            return false;
+        }
+        return file.write(QJsonDocument(suite).toJson()) > 0;
+    }
+
+private:
+    QJsonArray _results;
+};
+
+/// keeps the compiler from dropping the results of benchmark bodies
+static volatile quint64 benchmarkSink = 0;
+
+#endif // hifi_BenchmarkRecorder_h
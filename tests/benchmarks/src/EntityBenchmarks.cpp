@@ -0,0 +1,101 @@
+//
+//  EntityBenchmarks.cpp
+//  tests/benchmarks/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityBenchmarks.h"
+
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <NLPacket.h>
+#include <OctreeElementBag.h>
+#include <OctreePacketData.h>
+
+QTEST_MAIN(EntityBenchmarks)
+
+static const int NUM_TREE_ENTITIES = 2000;
+static const float WORLD_SIZE = 1000.0f;
+
+static float randomFloat(float low, float high) {
+    return low + (high - low) * (float)qrand() / (float)RAND_MAX;
+}
+
+static EntityItemProperties boxProperties() {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(glm::vec3(randomFloat(0.0f, WORLD_SIZE), randomFloat(0.0f, WORLD_SIZE),
+                                     randomFloat(0.0f, WORLD_SIZE)));
+    properties.setDimensions(glm::vec3(randomFloat(0.1f, 2.0f)));
+    properties.setRotation(glm::normalize(glm::quat(0.3f, -0.5f, 0.7f, 0.1f)));
+    properties.setVelocity(glm::vec3(3.7f, -12.3f, 0.05f));
+    properties.setColor({ 200, 100, 50 });
+    properties.setName("benchmark box");
+    properties.setLastEdited(usecTimestampNow());
+    return properties;
+}
+
+void EntityBenchmarks::propertiesEncodeBenchmark() {
+    EntityItemID entityID(QUuid::createUuid());
+    EntityItemProperties properties = boxProperties();
+    QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityEdit), 0);
+
+    _recorder.run("EntityItemProperties encode edit packet", [&] {
+        buffer.resize(NLPacket::maxPayloadSize(PacketType::EntityEdit));
+        benchmarkSink += EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, entityID, properties, buffer);
+    });
+}
+
+void EntityBenchmarks::propertiesDecodeBenchmark() {
+    EntityItemID entityID(QUuid::createUuid());
+    QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityEdit), 0);
+    QVERIFY(EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, entityID, boxProperties(), buffer));
+
+    _recorder.run("EntityItemProperties decode edit packet", [&] {
+        int processedBytes = 0;
+        EntityItemID decodedID;
+        EntityItemProperties decoded;
+        EntityItemProperties::decodeEntityEditPacket(reinterpret_cast<const unsigned char*>(buffer.constData()),
+                                                     buffer.size(), processedBytes, decodedID, decoded);
+        benchmarkSink += processedBytes;
+    }, buffer.size());
+}
+
+void EntityBenchmarks::encodeTreeBitstreamBenchmark() {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    for (int i = 0; i < NUM_TREE_ENTITIES; ++i) {
+        tree->addEntity(EntityItemID(QUuid::createUuid()), boxProperties());
+    }
+
+    OctreePacketData packetData;
+
+    // a full scene, as the octree server sends it to a new viewer without a view frustum
+    _recorder.run("Octree encodeTreeBitstream full scene", [&] {
+        OctreeElementBag bag;
+        OctreeElementExtraEncodeData extraEncodeData;
+        bag.insert(tree->getRoot());
+
+        const int MAX_PACKETS = 100000; // in case something never fits
+        int numPackets = 0;
+        while (!bag.isEmpty() && numPackets < MAX_PACKETS) {
+            OctreeElementPointer subTree = bag.extract();
+            EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, WANT_COLOR, WANT_EXISTS_BITS, 0, false,
+                                         IGNORE_VIEW_FRUSTUM, NO_OCCLUSION_CULLING, IGNORE_COVERAGE_MAP,
+                                         NO_BOUNDARY_ADJUST, DEFAULT_OCTREE_SIZE_SCALE, IGNORE_LAST_SENT, true,
+                                         IGNORE_SCENE_STATS, IGNORE_JURISDICTION_MAP, &extraEncodeData);
+            packetData.reset();
+            benchmarkSink += tree->encodeTreeBitstream(subTree, &packetData, bag, params);
+            ++numPackets;
+        }
+        tree->releaseSceneEncodeData(&extraEncodeData);
+    }, NUM_TREE_ENTITIES);
+}
+
+void EntityBenchmarks::cleanupTestCase() {
+    QVERIFY(_recorder.write("EntityBenchmarks"));
+}
@@ -0,0 +1,31 @@
+//
+//  EntityBenchmarks.h
+//  tests/benchmarks/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityBenchmarks_h
+#define hifi_EntityBenchmarks_h
+
+#include <QtTest/QtTest>
+
+#include "BenchmarkRecorder.h"
+
+class EntityBenchmarks : public QObject {
+    Q_OBJECT
+
+private slots:
+    void propertiesEncodeBenchmark();
+    void propertiesDecodeBenchmark();
+    void encodeTreeBitstreamBenchmark();
+    void cleanupTestCase();
+
+private:
+    BenchmarkRecorder _recorder;
+};
+
+#endif // hifi_EntityBenchmarks_h
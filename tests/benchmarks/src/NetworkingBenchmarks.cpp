@@ -0,0 +1,62 @@
+//
+//  NetworkingBenchmarks.cpp
+//  tests/benchmarks/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkingBenchmarks.h"
+
+#include <NLPacket.h>
+#include <SequenceNumberStats.h>
+#include <udt/Packet.h>
+
+QTEST_MAIN(NetworkingBenchmarks)
+
+void NetworkingBenchmarks::packetCreationBenchmark() {
+    const qint64 PAYLOAD_SIZE = 1024;
+    QByteArray payload(PAYLOAD_SIZE, 'x');
+
+    _recorder.run("udt::Packet create and write", [&] {
+        auto packet = udt::Packet::create();
+        benchmarkSink += packet->write(payload.constData(), PAYLOAD_SIZE);
+    }, PAYLOAD_SIZE);
+
+    _recorder.run("NLPacket create and write", [&] {
+        auto packet = NLPacket::create(PacketType::MixedAudio);
+        benchmarkSink += packet->write(payload.constData(), PAYLOAD_SIZE);
+    }, PAYLOAD_SIZE);
+}
+
+void NetworkingBenchmarks::sequenceNumberStatsBenchmark() {
+    const int SEQUENCE_NUMBERS_PER_CALL = 100;
+    SequenceNumberStats inOrderStats;
+    quint16 sequenceNumber = 0;
+
+    _recorder.run("SequenceNumberStats in order", [&] {
+        for (int i = 0; i < SEQUENCE_NUMBERS_PER_CALL; ++i) {
+            benchmarkSink += inOrderStats.sequenceNumberReceived(sequenceNumber++)._status;
+        }
+    }, SEQUENCE_NUMBERS_PER_CALL);
+
+    // the first two numbers of every ten arrive after the third
+    SequenceNumberStats reorderedStats;
+    quint16 base = 0;
+
+    _recorder.run("SequenceNumberStats reordered", [&] {
+        for (int i = 0; i < SEQUENCE_NUMBERS_PER_CALL; i += 10) {
+            for (int j = 0; j < 10; ++j) {
+                int offset = (j == 0) ? 2 : (j <= 2 ? j - 1 : j);
+                benchmarkSink += reorderedStats.sequenceNumberReceived((quint16)(base + offset))._status;
+            }
+            base += 10;
+        }
+    }, SEQUENCE_NUMBERS_PER_CALL);
+}
+
+void NetworkingBenchmarks::cleanupTestCase() {
+    QVERIFY(_recorder.write("NetworkingBenchmarks"));
+}
@@ -0,0 +1,30 @@
+//
+//  NetworkingBenchmarks.h
+//  tests/benchmarks/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkingBenchmarks_h
+#define hifi_NetworkingBenchmarks_h
+
+#include <QtTest/QtTest>
+
+#include "BenchmarkRecorder.h"
+
+class NetworkingBenchmarks : public QObject {
+    Q_OBJECT
+
+private slots:
+    void packetCreationBenchmark();
+    void sequenceNumberStatsBenchmark();
+    void cleanupTestCase();
+
+private:
+    BenchmarkRecorder _recorder;
+};
+
+#endif // hifi_NetworkingBenchmarks_h
@@ -0,0 +1,99 @@
+//
+//  SharedBenchmarks.cpp
+//  tests/benchmarks/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SharedBenchmarks.h"
+
+#include <GLMHelpers.h>
+#include <OctalCode.h>
+
+QTEST_MAIN(SharedBenchmarks)
+
+void SharedBenchmarks::packOrientationBenchmark() {
+    unsigned char buffer[8];
+    glm::quat orientation = glm::normalize(glm::quat(0.3f, -0.5f, 0.7f, 0.1f));
+    glm::quat unpacked;
+
+    _recorder.run("GLMHelpers pack and unpack quat to bytes", [&] {
+        packOrientationQuatToBytes(buffer, orientation);
+        benchmarkSink += unpackOrientationQuatFromBytes(buffer, unpacked);
+    });
+
+    _recorder.run("GLMHelpers pack and unpack quat to six bytes", [&] {
+        packOrientationQuatToSixBytes(buffer, orientation);
+        benchmarkSink += unpackOrientationQuatFromSixBytes(buffer, unpacked);
+    });
+}
+
+void SharedBenchmarks::packVec3Benchmark() {
+    unsigned char buffer[8];
+    glm::vec3 vector(12.5f, -3.25f, 7.0f);
+    glm::vec3 unpacked;
+    const int RADIX = 7;
+
+    _recorder.run("GLMHelpers pack and unpack vec3 to signed two byte fixed", [&] {
+        packFloatVec3ToSignedTwoByteFixed(buffer, vector, RADIX);
+        benchmarkSink += unpackFloatVec3FromSignedTwoByteFixed(buffer, unpacked, RADIX);
+    });
+}
+
+void SharedBenchmarks::packFloatBenchmark() {
+    unsigned char buffer[4];
+    float unpacked;
+
+    _recorder.run("GLMHelpers pack and unpack float ratio", [&] {
+        packFloatRatioToTwoByte(buffer, 1.75f);
+        benchmarkSink += unpackFloatRatioFromTwoByte(buffer, unpacked);
+    });
+
+    _recorder.run("GLMHelpers pack and unpack angle", [&] {
+        packFloatAngleToTwoByte(buffer, 137.5f);
+        benchmarkSink += unpackFloatAngleFromTwoByte(reinterpret_cast<const uint16_t*>(buffer), &unpacked);
+    });
+}
+
+void SharedBenchmarks::octalCodeBenchmark() {
+    const int DEPTH = 12;
+
+    // a code DEPTH levels down, its parent and one of its siblings
+    unsigned char* parent = nullptr;
+    for (int level = 0; level < DEPTH - 1; ++level) {
+        unsigned char* child = childOctalCode(parent, (char)(level % 8));
+        delete[] parent;
+        parent = child;
+    }
+    unsigned char* code = childOctalCode(parent, 2);
+    unsigned char* sibling = childOctalCode(parent, 7);
+
+    _recorder.run("OctalCode child code", [&] {
+        unsigned char* child = childOctalCode(code, 3);
+        benchmarkSink += child[0];
+        delete[] child;
+    });
+
+    _recorder.run("OctalCode length", [&] {
+        benchmarkSink += numberOfThreeBitSectionsInCode(code);
+    });
+
+    _recorder.run("OctalCode compare", [&] {
+        benchmarkSink += (int)compareOctalCodes(code, sibling);
+    });
+
+    _recorder.run("OctalCode is ancestor", [&] {
+        benchmarkSink += isAncestorOf(parent, code) ? 1 : 0;
+    });
+
+    delete[] code;
+    delete[] parent;
+    delete[] sibling;
+}
+
+void SharedBenchmarks::cleanupTestCase() {
+    QVERIFY(_recorder.write("SharedBenchmarks"));
+}
@@ -0,0 +1,32 @@
+//
+//  SharedBenchmarks.h
+//  tests/benchmarks/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SharedBenchmarks_h
+#define hifi_SharedBenchmarks_h
+
+#include <QtTest/QtTest>
+
+#include "BenchmarkRecorder.h"
+
+class SharedBenchmarks : public QObject {
+    Q_OBJECT
+
+private slots:
+    void packOrientationBenchmark();
+    void packVec3Benchmark();
+    void packFloatBenchmark();
+    void octalCodeBenchmark();
+    void cleanupTestCase();
+
+private:
+    BenchmarkRecorder _recorder;
+};
+
+#endif // hifi_SharedBenchmarks_h
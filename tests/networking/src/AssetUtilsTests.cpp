@@ -0,0 +1,35 @@
+//
+//  AssetUtilsTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetUtilsTests.h"
+
+#include <AssetUtils.h>
+
+QTEST_MAIN(AssetUtilsTests)
+
+static const QString HASH = QString(SHA256_HASH_HEX_LENGTH, 'a');
+
+void AssetUtilsTests::hullSourceExtensionTest() {
+    QVERIFY(isHullSourceExtension("fbx"));
+    QVERIFY(isHullSourceExtension("OBJ"));
+    QVERIFY(!isHullSourceExtension("png"));
+    QVERIFY(!isHullSourceExtension(HULL_ASSET_EXTENSION));
+}
+
+void AssetUtilsTests::hullUrlTest() {
+    QCOMPARE(getATPHullUrl(QUrl("atp:" + HASH + ".fbx")), QUrl("atp:" + HASH + "." + HULL_ASSET_EXTENSION));
+    QCOMPARE(getATPHullUrl(QUrl("atp:" + HASH + ".obj")), QUrl("atp:" + HASH + "." + HULL_ASSET_EXTENSION));
+
+    // only models on the asset-server have hulls made for them
+    QVERIFY(getATPHullUrl(QUrl("atp:" + HASH + ".png")).isEmpty());
+    QVERIFY(getATPHullUrl(QUrl("atp:" + HASH + "." + HULL_ASSET_EXTENSION)).isEmpty());
+    QVERIFY(getATPHullUrl(QUrl("atp:abc.fbx")).isEmpty());
+    QVERIFY(getATPHullUrl(QUrl("http://example.com/" + HASH + ".fbx")).isEmpty());
+}
@@ -0,0 +1,24 @@
+//
+//  AssetUtilsTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetUtilsTests_h
+#define hifi_AssetUtilsTests_h
+
+#include <QtTest/QtTest>
+
+class AssetUtilsTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void hullSourceExtensionTest();
+    void hullUrlTest();
+};
+
+#endif // hifi_AssetUtilsTests_h
@@ -0,0 +1,188 @@
+//
+//  CongestionControlTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CongestionControlTests.h"
+
+#include <deque>
+#include <random>
+#include <thread>
+
+#include <NumericalConstants.h>
+#include <udt/CongestionControl.h>
+#include <udt/Constants.h>
+
+QTEST_MAIN(CongestionControlTests)
+
+using namespace udt;
+using namespace std::chrono;
+
+namespace {
+
+const int LINK_CAPACITY = 2000; // packets per second
+const int LINK_ONE_WAY_DELAY_USECS = 25 * 1000;
+const int LINK_MAX_QUEUE_USECS = 100 * 1000; // packets that would wait longer than this at the bottleneck are dropped
+const auto SIMULATION_DURATION = seconds(3);
+
+// gives the simulation access to what the Connection would normally set on the control
+template <typename T>
+class SimulatedControl : public T {
+public:
+    using CongestionControl::setRTT;
+    using CongestionControl::setReceiveRate;
+    using CongestionControl::setBandwidth;
+    using CongestionControl::setSendCurrentSequenceNumber;
+    using CongestionControl::setMaxCongestionWindowSize;
+
+    double getPacketSendPeriod() const { return this->_packetSendPeriod; }
+    double getCongestionWindowSize() const { return this->_congestionWindowSize; }
+};
+
+struct LinkEvent {
+    p_high_resolution_clock::time_point time;
+    SequenceNumber sequenceNumber;
+    bool isLost; // for an event on the way back, this is a NAK
+};
+
+// returns the number of packets delivered per second
+template <typename T>
+double simulate(double lossRate) {
+    SimulatedControl<T> control;
+    control.setMaxCongestionWindowSize(CONNECTION_RECEIVE_BUFFER_SIZE_PACKETS);
+    control.setBandwidth(LINK_CAPACITY);
+    control.init();
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+    std::deque<LinkEvent> arrivals; // packets on their way to the receiver
+    std::deque<LinkEvent> acks; // ACKs and NAKs on their way back to the sender
+
+    SequenceNumber currentSequenceNumber;
+    SequenceNumber lastACK;
+    SequenceNumber receivedSequenceNumber;
+
+    const auto bottleneckServiceTime = microseconds(USECS_PER_SECOND / LINK_CAPACITY);
+    auto bottleneckFreeTime = p_high_resolution_clock::now();
+
+    int rtt = 0;
+    int receiveRate = 0;
+    int numDelivered = 0;
+    int numReceivedThisSync = 0;
+    double sendCredit = 0.0;
+
+    auto start = p_high_resolution_clock::now();
+    auto lastStep = start;
+    auto lastSync = start;
+
+    while (true) {
+        auto now = p_high_resolution_clock::now();
+        if (now - start > SIMULATION_DURATION) {
+            break;
+        }
+
+        // send what the pacing and the window allow
+        sendCredit += duration_cast<microseconds>(now - lastStep).count() / std::max(control.getPacketSendPeriod(), 1.0);
+        lastStep = now;
+
+        while (sendCredit >= 1.0 && seqoff(lastACK, currentSequenceNumber) < control.getCongestionWindowSize()) {
+            sendCredit -= 1.0;
+            ++currentSequenceNumber;
+
+            bottleneckFreeTime = std::max(bottleneckFreeTime, now) + bottleneckServiceTime;
+            bool isDropped = bottleneckFreeTime - now > microseconds(LINK_MAX_QUEUE_USECS);
+            if (isDropped) {
+                bottleneckFreeTime -= bottleneckServiceTime;
+            }
+
+            arrivals.push_back({ (isDropped ? now : bottleneckFreeTime) + microseconds(LINK_ONE_WAY_DELAY_USECS),
+                                 currentSequenceNumber, isDropped || distribution(generator) < lossRate });
+        }
+        sendCredit = std::min(sendCredit, 1.0);
+
+        // receive what made it across, losses are NAKed right away
+        while (!arrivals.empty() && arrivals.front().time <= now) {
+            LinkEvent arrival = arrivals.front();
+            arrivals.pop_front();
+
+            if (!arrival.isLost) {
+                ++numDelivered;
+                ++numReceivedThisSync;
+                receivedSequenceNumber = arrival.sequenceNumber;
+            }
+
+            arrival.time = now + microseconds(LINK_ONE_WAY_DELAY_USECS);
+            if (arrival.isLost) {
+                acks.push_back(arrival);
+            }
+        }
+
+        // the receiver ACKs once per sync interval
+        if (now - lastSync >= microseconds(control.synInterval())) {
+            double syncUsecs = (double) duration_cast<microseconds>(now - lastSync).count();
+            lastSync = now;
+
+            acks.push_back({ now + microseconds(LINK_ONE_WAY_DELAY_USECS), receivedSequenceNumber, false });
+
+            int rate = (int) (numReceivedThisSync * USECS_PER_SECOND / syncUsecs);
+            numReceivedThisSync = 0;
+            receiveRate = (receiveRate * 7 + rate) / 8;
+        }
+
+        // feed what came back to the control, the way the Connection does
+        while (!acks.empty() && acks.front().time <= now) {
+            LinkEvent ack = acks.front();
+            acks.pop_front();
+
+            control.setSendCurrentSequenceNumber(currentSequenceNumber);
+
+            if (ack.isLost) {
+                control.onLoss(ack.sequenceNumber, ack.sequenceNumber);
+            } else if (ack.sequenceNumber > lastACK) {
+                lastACK = ack.sequenceNumber;
+
+                int rttSample = 2 * LINK_ONE_WAY_DELAY_USECS
+                    + (int) duration_cast<microseconds>(bottleneckFreeTime - std::min(bottleneckFreeTime, now)).count();
+                rtt = rtt == 0 ? rttSample : (rtt * 7 + rttSample) / 8;
+
+                control.setRTT(rtt);
+                control.setReceiveRate(receiveRate);
+                control.onACK(lastACK);
+            }
+        }
+
+        std::this_thread::sleep_for(microseconds(500));
+    }
+
+    return numDelivered / (double) duration_cast<seconds>(SIMULATION_DURATION).count();
+}
+
+}
+
+void CongestionControlTests::cleanLinkTest() {
+    double defaultGoodput = simulate<DefaultCC>(0.0);
+    double bbrGoodput = simulate<BBRCC>(0.0);
+
+    qDebug() << "Clean link goodput (packets per second) - default:" << defaultGoodput << "BBR:" << bbrGoodput
+        << "capacity:" << LINK_CAPACITY;
+
+    QVERIFY(bbrGoodput > LINK_CAPACITY * 0.6);
+}
+
+void CongestionControlTests::lossyLinkTest() {
+    const double LOSS_RATE = 0.03;
+
+    double defaultGoodput = simulate<DefaultCC>(LOSS_RATE);
+    double bbrGoodput = simulate<BBRCC>(LOSS_RATE);
+
+    qDebug() << "Lossy link goodput (packets per second) - default:" << defaultGoodput << "BBR:" << bbrGoodput
+        << "capacity:" << LINK_CAPACITY;
+
+    QVERIFY(bbrGoodput > defaultGoodput);
+}
@@ -0,0 +1,30 @@
+//
+//  CongestionControlTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CongestionControlTests_h
+#define hifi_CongestionControlTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+// Runs the built-in congestion controls against a simulated bottleneck link, in real time since both controls pace
+// themselves on the clock, and compares the goodput they get out of it
+class CongestionControlTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the BBR control fills most of a clean link
+    void cleanLinkTest();
+
+    // Test that the BBR control keeps a higher rate than the default one when the link randomly drops packets
+    void lossyLinkTest();
+};
+
+#endif // hifi_CongestionControlTests_h
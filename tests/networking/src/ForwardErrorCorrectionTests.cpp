@@ -0,0 +1,126 @@
+//
+//  ForwardErrorCorrectionTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ForwardErrorCorrectionTests.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <udt/ControlPacket.h>
+#include <udt/ForwardErrorCorrection.h>
+#include <udt/Packet.h>
+
+QTEST_MAIN(ForwardErrorCorrectionTests)
+
+using namespace udt;
+
+static std::vector<std::unique_ptr<Packet>> createPackets(int numPackets) {
+    std::vector<std::unique_ptr<Packet>> packets;
+
+    for (int i = 0; i < numPackets; ++i) {
+        // give every packet a different size and content
+        auto packet = Packet::create();
+        for (int j = 0; j < 100 + 37 * i; ++j) {
+            packet->writePrimitive((uint8_t)(i * 7 + j));
+        }
+
+        packet->writeSequenceNumber(SequenceNumber(i + 1));
+        packets.push_back(std::move(packet));
+    }
+
+    return packets;
+}
+
+// feeds every packet to the encoder and the ones not in lostIndexes to the decoder
+// and collects the datagrams rebuilt from the parity
+static void sendGroup(FECEncoder& encoder, FECDecoder& decoder, const std::vector<std::unique_ptr<Packet>>& packets,
+                      const std::vector<int>& lostIndexes, std::vector<QByteArray>& rebuilt) {
+    for (int i = 0; i < (int)packets.size(); ++i) {
+        auto& packet = packets[i];
+        QVERIFY2(encoder.canProtect(*packet), "Could not protect packet");
+
+        auto parityPackets = encoder.addPacket(*packet);
+
+        if (std::find(lostIndexes.begin(), lostIndexes.end(), i) == lostIndexes.end()) {
+            QVERIFY(decoder.addReceivedPacket(packet->getSequenceNumber(),
+                                              packet->getData() + Packet::localHeaderSize(),
+                                              packet->getDataSize() - Packet::localHeaderSize()));
+        }
+
+        for (auto& parityPacket : parityPackets) {
+            QCOMPARE(parityPacket->getType(), ControlPacket::FECParity);
+
+            PacketBuffer buffer;
+            qint64 size = 0;
+            if (decoder.recover(*parityPacket, buffer, size)) {
+                rebuilt.push_back(QByteArray(buffer.get(), size));
+            }
+        }
+    }
+}
+
+static QByteArray datagram(const Packet& packet) {
+    return QByteArray(packet.getData(), packet.getDataSize());
+}
+
+void ForwardErrorCorrectionTests::singleLossTest() {
+    FECEncoder encoder(4, 1);
+    FECDecoder decoder;
+
+    auto packets = createPackets(4);
+    std::vector<QByteArray> rebuilt;
+    sendGroup(encoder, decoder, packets, { 2 }, rebuilt);
+
+    QCOMPARE(rebuilt.size(), (size_t)1);
+    QCOMPARE(rebuilt[0], datagram(*packets[2]));
+    QVERIFY(!encoder.hasPendingGroup());
+}
+
+void ForwardErrorCorrectionTests::burstLossTest() {
+    FECEncoder encoder(8, 2);
+    FECDecoder decoder;
+
+    auto packets = createPackets(8);
+    std::vector<QByteArray> rebuilt;
+    sendGroup(encoder, decoder, packets, { 4, 5 }, rebuilt);
+
+    QCOMPARE(rebuilt.size(), (size_t)2);
+    QCOMPARE(rebuilt[0], datagram(*packets[4]));
+    QCOMPARE(rebuilt[1], datagram(*packets[5]));
+}
+
+void ForwardErrorCorrectionTests::unrecoverableLossTest() {
+    FECEncoder encoder(8, 2);
+    FECDecoder decoder;
+
+    auto packets = createPackets(8);
+
+    // 1 and 3 are both covered by the second parity packet, 0 is covered by the first
+    std::vector<QByteArray> rebuilt;
+    sendGroup(encoder, decoder, packets, { 0, 1, 3 }, rebuilt);
+
+    QCOMPARE(rebuilt.size(), (size_t)1);
+    QCOMPARE(rebuilt[0], datagram(*packets[0]));
+}
+
+void ForwardErrorCorrectionTests::lateOriginalTest() {
+    FECEncoder encoder(4, 1);
+    FECDecoder decoder;
+
+    auto packets = createPackets(4);
+    std::vector<QByteArray> rebuilt;
+    sendGroup(encoder, decoder, packets, { 1 }, rebuilt);
+    QCOMPARE(rebuilt.size(), (size_t)1);
+
+    auto& lateOriginal = packets[1];
+    QVERIFY(!decoder.addReceivedPacket(lateOriginal->getSequenceNumber(),
+                                       lateOriginal->getData() + Packet::localHeaderSize(),
+                                       lateOriginal->getDataSize() - Packet::localHeaderSize()));
+}
@@ -0,0 +1,34 @@
+//
+//  ForwardErrorCorrectionTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ForwardErrorCorrectionTests_h
+#define hifi_ForwardErrorCorrectionTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ForwardErrorCorrectionTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a single lost packet is rebuilt byte for byte from the parity of its group
+    void singleLossTest();
+
+    // Test that interleaved parity rebuilds a burst of as many consecutive losses as there are parity packets
+    void burstLossTest();
+
+    // Test that a group with two losses under the same parity packet is not rebuilt into garbage
+    void unrecoverableLossTest();
+
+    // Test that the original of a rebuilt packet is reported as a duplicate when it arrives late
+    void lateOriginalTest();
+};
+
+#endif // hifi_ForwardErrorCorrectionTests_h
@@ -0,0 +1,58 @@
+//
+//  FrameSchedulerTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FrameSchedulerTests.h"
+
+#include <FrameScheduler.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(FrameSchedulerTests)
+
+const quint64 FRAME_USECS = 2000;
+
+void FrameSchedulerTests::fixedRateTest() {
+    const int NUM_FRAMES = 50;
+
+    FrameScheduler scheduler(FRAME_USECS);
+    QElapsedTimer timer;
+    timer.start();
+    scheduler.start();
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        scheduler.waitForNextFrame();
+    }
+
+    // the frames are due on a fixed schedule, so the time taken doesn't grow with the oversleeps of each frame
+    qint64 elapsedUsecs = timer.nsecsElapsed() / 1000;
+    QVERIFY(elapsedUsecs >= (qint64) (NUM_FRAMES * FRAME_USECS));
+    QVERIFY(elapsedUsecs < (qint64) ((NUM_FRAMES + 5) * FRAME_USECS));
+
+    QJsonObject stats = scheduler.takeStatsObject();
+    QCOMPARE(stats["frames"].toInt(), NUM_FRAMES);
+    QCOMPARE(stats["skipped_frames"].toInt(), 0);
+
+    // the stats start over once they are taken
+    QCOMPARE(scheduler.takeStatsObject()["frames"].toInt(), 0);
+}
+
+void FrameSchedulerTests::skipWhenFarBehindTest() {
+    FrameScheduler scheduler(FRAME_USECS);
+    scheduler.start();
+
+    // a frame ten frames long leaves the schedule too far behind to catch up
+    usleep(10 * FRAME_USECS);
+    QCOMPARE(scheduler.waitForNextFrame(), (quint64) 0);
+
+    QJsonObject stats = scheduler.takeStatsObject();
+    QCOMPARE(stats["late_frames"].toInt(), 1);
+    QVERIFY(stats["skipped_frames"].toInt() >= 10 - 1 - FrameScheduler::MAX_FRAMES_BEHIND);
+
+    // after the skip the schedule is back within a frame of now
+    QVERIFY(scheduler.waitForNextFrame() <= FRAME_USECS);
+}
@@ -0,0 +1,24 @@
+//
+//  FrameSchedulerTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FrameSchedulerTests_h
+#define hifi_FrameSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class FrameSchedulerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void fixedRateTest();
+    void skipWhenFarBehindTest();
+};
+
+#endif // hifi_FrameSchedulerTests_h
@@ -0,0 +1,77 @@
+//
+//  LatencyHistogramTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LatencyHistogramTests.h"
+
+#include <udt/LatencyHistogram.h>
+
+QTEST_MAIN(LatencyHistogramTests)
+
+using namespace udt;
+
+void LatencyHistogramTests::smallValuesTest() {
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.getPercentile(50.0), (quint64)0);
+
+    for (quint64 value = 0; value < 10; ++value) {
+        histogram.record(value);
+    }
+
+    QCOMPARE(histogram.getCount(), 10);
+    QCOMPARE(histogram.getMax(), (quint64)9);
+    QCOMPARE(histogram.getPercentile(0.0), (quint64)0);
+    QCOMPARE(histogram.getPercentile(50.0), (quint64)4);
+    QCOMPARE(histogram.getPercentile(90.0), (quint64)8);
+    QCOMPARE(histogram.getPercentile(100.0), (quint64)9);
+}
+
+void LatencyHistogramTests::percentileTest() {
+    LatencyHistogram histogram;
+
+    static const quint64 NUM_VALUES = 100000;
+    for (quint64 value = 1; value <= NUM_VALUES; ++value) {
+        histogram.record(value);
+    }
+
+    static const double MAX_RELATIVE_ERROR = 1.0 / LatencyHistogram::SUB_BUCKET_COUNT;
+
+    static const double PERCENTILES[] = { 1.0, 50.0, 90.0, 99.0, 99.9 };
+    for (double percentile : PERCENTILES) {
+        double expected = percentile / 100.0 * NUM_VALUES;
+        double found = (double)histogram.getPercentile(percentile);
+
+        // values are reported at the top of their bucket, never below the real one
+        QVERIFY(found >= expected);
+        QVERIFY(found <= expected * (1.0 + MAX_RELATIVE_ERROR));
+    }
+
+    QCOMPARE(histogram.getPercentile(100.0), NUM_VALUES);
+}
+
+void LatencyHistogramTests::clampAndMergeTest() {
+    LatencyHistogram first;
+    LatencyHistogram second;
+
+    // QCOMPARE takes references, so don't hand it the class constant
+    quint64 maxValue = LatencyHistogram::MAX_VALUE;
+
+    first.record(100);
+    second.record(maxValue * 2);
+
+    QCOMPARE(second.getMax(), maxValue);
+    QCOMPARE(second.getPercentile(100.0), maxValue);
+
+    first.merge(second);
+
+    QCOMPARE(first.getCount(), 2);
+    QCOMPARE(first.getMax(), maxValue);
+    QVERIFY(first.getPercentile(50.0) >= 100 && first.getPercentile(50.0) < 100 * 2);
+    QCOMPARE(first.getPercentile(100.0), maxValue);
+}
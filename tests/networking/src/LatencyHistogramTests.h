@@ -0,0 +1,31 @@
+//
+//  LatencyHistogramTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LatencyHistogramTests_h
+#define hifi_LatencyHistogramTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class LatencyHistogramTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that small values are kept exactly
+    void smallValuesTest();
+
+    // Test that percentiles of a wide distribution are found within the bucket precision
+    void percentileTest();
+
+    // Test that values above the maximum are clamped and that merging adds up both histograms
+    void clampAndMergeTest();
+};
+
+#endif // hifi_LatencyHistogramTests_h
@@ -0,0 +1,85 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+
+#include <udt/ControlPacket.h>
+#include <udt/LossList.h>
+
+QTEST_MAIN(LossListTests)
+
+using namespace udt;
+
+static std::unique_ptr<ControlPacket> writeAndRewind(LossList& lossList, int maxBytes, int& writtenBytes) {
+    auto packet = ControlPacket::create(ControlPacket::TimeoutNAK, ControlPacket::maxPayloadSize());
+    writtenBytes = lossList.write(*packet, maxBytes);
+    packet->seek(0);
+    return packet;
+}
+
+void LossListTests::compactRoundTripTest() {
+    LossList lossList;
+    SequenceNumber start { SequenceNumber::MAX - 3 };
+
+    lossList.append(start);
+    lossList.append(start + 2, start + 5);
+    lossList.append(start + 200);
+    lossList.append(start + 100000, start + 100500);
+
+    int writtenBytes;
+    auto packet = writeAndRewind(lossList, ControlPacket::maxPayloadSize(), writtenBytes);
+
+    QVERIFY(writtenBytes > 0);
+    QVERIFY(writtenBytes <= lossList.getMaxWriteSize());
+
+    // the 4 ranges fit in far less than the 32 bytes it takes to send them as pairs of sequence numbers
+    QVERIFY(writtenBytes < 4 * 2 * (int)sizeof(SequenceNumber));
+
+    LossList readList;
+    readList.read(*packet, writtenBytes);
+
+    QCOMPARE(packet->pos(), (qint64)writtenBytes);
+    QCOMPARE(readList.getLength(), lossList.getLength());
+    QCOMPARE(readList.getNumRanges(), lossList.getNumRanges());
+
+    while (!lossList.isEmpty()) {
+        QCOMPARE(readList.popFirstSequenceNumber(), lossList.popFirstSequenceNumber());
+    }
+}
+
+void LossListTests::compactTruncationTest() {
+    LossList lossList;
+
+    static const int NUM_RANGES = 1000;
+    for (int i = 0; i < NUM_RANGES; ++i) {
+        lossList.append(SequenceNumber(i * 1000), SequenceNumber(i * 1000 + i));
+    }
+
+    static const int MAX_BYTES = 64;
+
+    int writtenBytes;
+    auto packet = writeAndRewind(lossList, MAX_BYTES, writtenBytes);
+
+    QVERIFY(writtenBytes <= MAX_BYTES);
+
+    LossList readList;
+    readList.read(*packet, writtenBytes);
+
+    int numReadRanges = readList.getNumRanges();
+    QVERIFY(numReadRanges > 0);
+    QVERIFY(numReadRanges < NUM_RANGES);
+
+    // every range that was read is whole
+    while (!readList.isEmpty()) {
+        QCOMPARE(readList.popFirstSequenceNumber(), lossList.popFirstSequenceNumber());
+    }
+
+    QCOMPARE(lossList.getFirstSequenceNumber(), SequenceNumber(numReadRanges * 1000));
+}
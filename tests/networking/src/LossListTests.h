@@ -0,0 +1,28 @@
+//
+//  LossListTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LossListTests_h
+#define hifi_LossListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class LossListTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a loss list with single losses and ranges, wrapping around the sequence numbers, reads back the same
+    void compactRoundTripTest();
+
+    // Test that a loss list too large for the packet is cut at a range boundary
+    void compactTruncationTest();
+};
+
+#endif // hifi_LossListTests_h
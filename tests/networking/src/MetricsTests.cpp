@@ -0,0 +1,92 @@
+//
+//  MetricsTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MetricsTests.h"
+
+#include <Metrics.h>
+
+QTEST_MAIN(MetricsTests)
+
+void MetricsTests::counterTest() {
+    MetricCounter counter;
+    QCOMPARE(counter.get(), (quint64)0);
+
+    counter.increment();
+    counter.increment(4);
+    QCOMPARE(counter.get(), (quint64)5);
+}
+
+void MetricsTests::gaugeTest() {
+    MetricGauge gauge;
+    QCOMPARE(gauge.get(), 0.0);
+
+    gauge.set(12.5);
+    QCOMPARE(gauge.get(), 12.5);
+    gauge.set(3.0);
+    QCOMPARE(gauge.get(), 3.0);
+}
+
+void MetricsTests::histogramTest() {
+    MetricHistogram histogram({ 1.0, 5.0, 10.0 });
+
+    // values on a bound go in its bucket
+    histogram.observe(0.5);
+    histogram.observe(1.0);
+    histogram.observe(3.0);
+    histogram.observe(10.0);
+    histogram.observe(20.0);
+    histogram.observe(30.0);
+
+    QCOMPARE(histogram.getBucketCount(0), (quint64)2);
+    QCOMPARE(histogram.getBucketCount(1), (quint64)1);
+    QCOMPARE(histogram.getBucketCount(2), (quint64)1);
+    QCOMPARE(histogram.getBucketCount(3), (quint64)2);
+    QCOMPARE(histogram.getCount(), (quint64)6);
+    QCOMPARE(histogram.getSum(), 64.5);
+}
+
+void MetricsTests::registryTest() {
+    auto counter = MetricsRegistry::counter("metrics_tests_registry_total", "A counter.");
+    auto sameCounter = MetricsRegistry::counter("metrics_tests_registry_total", "A counter.");
+    QVERIFY(counter == sameCounter);
+
+    // a name registered with another type gives a metric that isn't exported
+    auto gauge = MetricsRegistry::gauge("metrics_tests_registry_total", "A gauge.");
+    QVERIFY(gauge != nullptr);
+    gauge->set(7.0);
+    QVERIFY(!MetricsRegistry::toPrometheusText().contains("metrics_tests_registry_total 7"));
+}
+
+void MetricsTests::prometheusTextTest() {
+    auto counter = MetricsRegistry::counter("metrics_tests_text_total", "Things counted.");
+    counter->increment(3);
+    auto gauge = MetricsRegistry::gauge("metrics_tests_text_value", "A value.");
+    gauge->set(1.5);
+    auto histogram = MetricsRegistry::histogram("metrics_tests_text_msecs", "Times taken.", { 1.0, 5.0 });
+    histogram->observe(0.5);
+    histogram->observe(2.0);
+    histogram->observe(8.0);
+
+    QByteArray text = MetricsRegistry::toPrometheusText();
+
+    QVERIFY(text.contains("# HELP metrics_tests_text_total Things counted.\n"
+                          "# TYPE metrics_tests_text_total counter\n"
+                          "metrics_tests_text_total 3\n"));
+    QVERIFY(text.contains("# TYPE metrics_tests_text_value gauge\n"
+                          "metrics_tests_text_value 1.5\n"));
+
+    // the exported buckets are cumulative
+    QVERIFY(text.contains("# TYPE metrics_tests_text_msecs histogram\n"
+                          "metrics_tests_text_msecs_bucket{le=\"1\"} 1\n"
+                          "metrics_tests_text_msecs_bucket{le=\"5\"} 2\n"
+                          "metrics_tests_text_msecs_bucket{le=\"+Inf\"} 3\n"
+                          "metrics_tests_text_msecs_sum 10.5\n"
+                          "metrics_tests_text_msecs_count 3\n"));
+}
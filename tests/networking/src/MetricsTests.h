@@ -0,0 +1,27 @@
+//
+//  MetricsTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MetricsTests_h
+#define hifi_MetricsTests_h
+
+#include <QtTest/QtTest>
+
+class MetricsTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void counterTest();
+    void gaugeTest();
+    void histogramTest();
+    void registryTest();
+    void prometheusTextTest();
+};
+
+#endif // hifi_MetricsTests_h
@@ -0,0 +1,101 @@
+//
+//  NativeSocketTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NativeSocketTests.h"
+
+#include <QtNetwork/QUdpSocket>
+
+#include <udt/NativeSocket.h>
+
+QTEST_MAIN(NativeSocketTests)
+
+using namespace udt;
+
+// writes numDatagrams small datagrams to a local socket and checks that they are all read back, in order
+static void roundTrip(int numDatagrams) {
+    if (!NativeSocket::isSupported()) {
+        QSKIP("Batched native datagram I/O is not supported on this platform");
+    }
+
+    QUdpSocket udpSocket;
+    QVERIFY(udpSocket.bind(QHostAddress::LocalHost, 0));
+
+    NativeSocket nativeSocket;
+    QVERIFY(nativeSocket.open(udpSocket.socketDescriptor()));
+
+    HifiSockAddr localSockAddr(QHostAddress::LocalHost, udpSocket.localPort());
+
+    std::vector<QByteArray> payloads;
+    std::vector<NativeSocket::Datagram> datagrams;
+    for (int i = 0; i < numDatagrams; ++i) {
+        payloads.push_back(QByteArray::number(i));
+    }
+    for (auto& payload : payloads) {
+        datagrams.emplace_back(payload.constData(), payload.size());
+    }
+
+    qint64 expectedBytes = 0;
+    for (auto& payload : payloads) {
+        expectedBytes += payload.size();
+    }
+    QCOMPARE(nativeSocket.writeDatagrams(datagrams, localSockAddr), expectedBytes);
+
+    int numReceived = 0;
+    int numInBatch = 0;
+    while ((numInBatch = nativeSocket.receiveBatch()) > 0) {
+        QVERIFY(numInBatch <= NativeSocket::MAX_DATAGRAMS_PER_BATCH);
+
+        for (int i = 0; i < numInBatch; ++i) {
+            qint64 size = nativeSocket.getDatagramSize(i);
+            auto buffer = nativeSocket.takeDatagram(i);
+
+            QCOMPARE(QByteArray(buffer.get(), size), payloads[numReceived]);
+            QCOMPARE(nativeSocket.getDatagramSender(i).getPort(), udpSocket.localPort());
+            ++numReceived;
+        }
+    }
+
+    QCOMPARE(numInBatch, 0);
+    QCOMPARE(numReceived, numDatagrams);
+}
+
+void NativeSocketTests::batchRoundTripTest() {
+    roundTrip(8);
+}
+
+void NativeSocketTests::largeBatchTest() {
+    roundTrip(NativeSocket::MAX_DATAGRAMS_PER_BATCH * 2 + 3);
+}
+
+void NativeSocketTests::jumboDatagramTest() {
+    if (!NativeSocket::isSupported()) {
+        QSKIP("Batched native datagram I/O is not supported on this platform");
+    }
+
+    QUdpSocket udpSocket;
+    QVERIFY(udpSocket.bind(QHostAddress::LocalHost, 0));
+
+    NativeSocket nativeSocket;
+    QVERIFY(nativeSocket.open(udpSocket.socketDescriptor()));
+
+    HifiSockAddr localSockAddr(QHostAddress::LocalHost, udpSocket.localPort());
+
+    QByteArray payload(MAX_JUMBO_PACKET_SIZE, 0);
+    for (int i = 0; i < payload.size(); ++i) {
+        payload[i] = (char)(i % 251);
+    }
+    QCOMPARE(nativeSocket.writeUnfragmentedDatagram(payload.constData(), payload.size(), localSockAddr),
+             (qint64)payload.size());
+
+    QCOMPARE(nativeSocket.receiveBatch(), 1);
+    QCOMPARE(nativeSocket.getDatagramSize(0), (qint64)payload.size());
+    auto buffer = nativeSocket.takeDatagram(0);
+    QCOMPARE(QByteArray(buffer.get(), payload.size()), payload);
+}
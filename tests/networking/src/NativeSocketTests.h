@@ -0,0 +1,31 @@
+//
+//  NativeSocketTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NativeSocketTests_h
+#define hifi_NativeSocketTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class NativeSocketTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a batch written to ourselves is received in order
+    void batchRoundTripTest();
+
+    // Test that batches larger than MAX_DATAGRAMS_PER_BATCH are split
+    void largeBatchTest();
+
+    // Test that a datagram larger than MAX_PACKET_SIZE, written without fragmentation over loopback, is read whole
+    void jumboDatagramTest();
+};
+
+#endif // hifi_NativeSocketTests_h
@@ -0,0 +1,117 @@
+//
+//  NetworkShaperTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkShaperTests.h"
+
+#include <vector>
+
+#include <udt/NetworkShaper.h>
+
+QTEST_MAIN(NetworkShaperTests)
+
+using namespace udt;
+
+static const qint64 DATAGRAM_SIZE = 16;
+static const HifiSockAddr SENDER { QHostAddress::LocalHost, 4000 };
+
+// a datagram that starts with its index, to tell them apart once released
+static PacketBuffer makeDatagram(int index) {
+    auto buffer = PacketBufferPool::allocate(DATAGRAM_SIZE);
+    memcpy(buffer.get(), &index, sizeof(index));
+    return buffer;
+}
+
+static std::vector<int> release(NetworkShaper& shaper, quint64 now) {
+    std::vector<int> indices;
+    shaper.releaseDatagrams(now, [&](PacketBuffer buffer, qint64 size, const HifiSockAddr& sender) {
+        QCOMPARE(size, DATAGRAM_SIZE);
+        QCOMPARE(sender, SENDER);
+        int index;
+        memcpy(&index, buffer.get(), sizeof(index));
+        indices.push_back(index);
+    });
+    return indices;
+}
+
+void NetworkShaperTests::idealTest() {
+    NetworkShaper shaper;
+    QVERIFY(!shaper.isShaping());
+
+    NetworkConditions conditions;
+    shaper.setConditions(conditions);
+    QVERIFY(!shaper.isShaping());
+    QCOMPARE(shaper.getNextReleaseTime(), (quint64)0);
+}
+
+void NetworkShaperTests::latencyTest() {
+    NetworkShaper shaper;
+    NetworkConditions conditions;
+    conditions.latencyUsecs = 1000;
+    shaper.setConditions(conditions);
+    QVERIFY(shaper.isShaping());
+
+    QVERIFY(shaper.addDatagram(makeDatagram(0), DATAGRAM_SIZE, SENDER, 100));
+    QVERIFY(shaper.addDatagram(makeDatagram(1), DATAGRAM_SIZE, SENDER, 200));
+    QCOMPARE(shaper.getNextReleaseTime(), (quint64)1100);
+
+    QVERIFY(release(shaper, 1099).empty());
+    QCOMPARE(release(shaper, 1100), std::vector<int>({ 0 }));
+    QCOMPARE(release(shaper, 5000), std::vector<int>({ 1 }));
+    QCOMPARE(shaper.getNextReleaseTime(), (quint64)0);
+}
+
+void NetworkShaperTests::jitterTest() {
+    static const int NUM_DATAGRAMS = 100;
+    static const quint64 LATENCY = 1000;
+    static const quint64 JITTER = 500;
+
+    NetworkShaper shaper;
+    NetworkConditions conditions;
+    conditions.latencyUsecs = LATENCY;
+    conditions.jitterUsecs = JITTER;
+    shaper.setConditions(conditions);
+
+    for (int i = 0; i < NUM_DATAGRAMS; i++) {
+        QVERIFY(shaper.addDatagram(makeDatagram(i), DATAGRAM_SIZE, SENDER, 0));
+    }
+
+    // nothing comes before the latency, everything by the end of the jitter
+    QVERIFY(shaper.getNextReleaseTime() >= LATENCY);
+    QVERIFY(release(shaper, LATENCY - 1).empty());
+    QCOMPARE((int)release(shaper, LATENCY + JITTER).size(), NUM_DATAGRAMS);
+}
+
+void NetworkShaperTests::lossTest() {
+    static const int NUM_DATAGRAMS = 10000;
+    static const double LOSS_RATE = 0.1;
+
+    NetworkShaper shaper;
+    NetworkConditions conditions;
+    conditions.lossRate = LOSS_RATE;
+    shaper.setConditions(conditions);
+
+    int numAdded = 0;
+    for (int i = 0; i < NUM_DATAGRAMS; i++) {
+        if (shaper.addDatagram(makeDatagram(i), DATAGRAM_SIZE, SENDER, 0)) {
+            numAdded++;
+        }
+    }
+    QCOMPARE(numAdded + shaper.getNumDroppedDatagrams(), NUM_DATAGRAMS);
+    QVERIFY(qAbs(shaper.getNumDroppedDatagrams() - LOSS_RATE * NUM_DATAGRAMS) < 0.02 * NUM_DATAGRAMS);
+
+    // the same seed drops the same datagrams
+    NetworkShaper replayShaper;
+    replayShaper.setConditions(conditions);
+    for (int i = 0; i < NUM_DATAGRAMS; i++) {
+        replayShaper.addDatagram(makeDatagram(i), DATAGRAM_SIZE, SENDER, 0);
+    }
+    QCOMPARE(replayShaper.getNumDroppedDatagrams(), shaper.getNumDroppedDatagrams());
+    QCOMPARE(release(replayShaper, 0), release(shaper, 0));
+}
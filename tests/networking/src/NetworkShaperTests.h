@@ -0,0 +1,26 @@
+//
+//  NetworkShaperTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkShaperTests_h
+#define hifi_NetworkShaperTests_h
+
+#include <QtTest/QtTest>
+
+class NetworkShaperTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void idealTest();
+    void latencyTest();
+    void jitterTest();
+    void lossTest();
+};
+
+#endif // hifi_NetworkShaperTests_h
@@ -0,0 +1,78 @@
+//
+//  PacketBufferPoolTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPoolTests.h"
+
+#include <thread>
+#include <vector>
+
+#include <udt/PacketBufferPool.h>
+
+QTEST_MAIN(PacketBufferPoolTests)
+
+using namespace udt;
+
+void PacketBufferPoolTests::recycleTest() {
+    char* firstBuffer = nullptr;
+
+    {
+        auto buffer = PacketBufferPool::allocate(PacketBufferPool::BUFFER_SIZE);
+        firstBuffer = buffer.get();
+    }
+
+    auto statsBefore = PacketBufferPool::getStats();
+
+    auto buffer = PacketBufferPool::allocate(1);
+    QCOMPARE(buffer.get(), firstBuffer);
+
+    auto statsAfter = PacketBufferPool::getStats();
+    QCOMPARE(statsAfter.hits, statsBefore.hits + 1);
+    QCOMPARE(statsAfter.misses, statsBefore.misses);
+}
+
+void PacketBufferPoolTests::oversizedBufferTest() {
+    auto statsBefore = PacketBufferPool::getStats();
+
+    {
+        auto buffer = PacketBufferPool::allocate(PacketBufferPool::BUFFER_SIZE * 2);
+        QVERIFY(buffer);
+        memset(buffer.get(), 0, PacketBufferPool::BUFFER_SIZE * 2);
+    }
+
+    auto statsAfter = PacketBufferPool::getStats();
+    QCOMPARE(statsAfter.hits, statsBefore.hits);
+    QCOMPARE(statsAfter.misses, statsBefore.misses);
+    QCOMPARE(statsAfter.numBuffers, statsBefore.numBuffers);
+}
+
+void PacketBufferPoolTests::crossThreadTest() {
+    const int NUM_BUFFERS = 1024;
+
+    std::vector<PacketBuffer> buffers;
+    for (int i = 0; i < NUM_BUFFERS; ++i) {
+        buffers.push_back(PacketBufferPool::allocate(PacketBufferPool::BUFFER_SIZE));
+    }
+
+    // free every buffer on a thread that never allocates, its surplus has to be shared
+    std::thread releaseThread([&] {
+        buffers.clear();
+    });
+    releaseThread.join();
+
+    auto statsBefore = PacketBufferPool::getStats();
+
+    for (int i = 0; i < NUM_BUFFERS / 2; ++i) {
+        buffers.push_back(PacketBufferPool::allocate(PacketBufferPool::BUFFER_SIZE));
+    }
+
+    auto statsAfter = PacketBufferPool::getStats();
+    QCOMPARE(statsAfter.misses, statsBefore.misses);
+    QVERIFY(statsAfter.numBuffers <= statsAfter.highWaterMark);
+}
@@ -0,0 +1,31 @@
+//
+//  PacketBufferPoolTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBufferPoolTests_h
+#define hifi_PacketBufferPoolTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketBufferPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a released buffer is handed out again
+    void recycleTest();
+
+    // Test that buffers larger than the pool's are allocated but not counted
+    void oversizedBufferTest();
+
+    // Test that buffers freed on another thread come back through the shared queue
+    void crossThreadTest();
+};
+
+#endif // hifi_PacketBufferPoolTests_h
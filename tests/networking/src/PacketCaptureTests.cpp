@@ -0,0 +1,87 @@
+//
+//  PacketCaptureTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketCaptureTests.h"
+
+#include <udt/PacketCapture.h>
+
+QTEST_MAIN(PacketCaptureTests)
+
+using namespace udt;
+
+static const HifiSockAddr FIRST_SENDER { QHostAddress::LocalHost, 4000 };
+static const HifiSockAddr SECOND_SENDER { QHostAddress("10.0.0.2"), 40102 };
+
+void PacketCaptureTests::roundTripTest() {
+    QString path = _directory.filePath("roundTrip.capture");
+    QByteArray first = "first datagram";
+    QByteArray second(1400, 'x');
+
+    PacketCaptureWriter writer;
+    QVERIFY(writer.open(path));
+    QVERIFY(writer.isOpen());
+    writer.addDatagram(first.constData(), first.size(), FIRST_SENDER, 1000000);
+    writer.addDatagram(second.constData(), second.size(), SECOND_SENDER, 1002500);
+    writer.close();
+    QVERIFY(!writer.isOpen());
+
+    PacketCaptureReader reader;
+    QVERIFY(reader.open(path));
+
+    // the times are from the first datagram
+    PacketCaptureReader::Datagram datagram;
+    QVERIFY(reader.readNext(datagram));
+    QCOMPARE(datagram.timeUsecs, (quint64)0);
+    QCOMPARE(datagram.senderSockAddr, FIRST_SENDER);
+    QCOMPARE(datagram.data, first);
+
+    QVERIFY(reader.readNext(datagram));
+    QCOMPARE(datagram.timeUsecs, (quint64)2500);
+    QCOMPARE(datagram.senderSockAddr, SECOND_SENDER);
+    QCOMPARE(datagram.data, second);
+
+    QVERIFY(!reader.readNext(datagram));
+}
+
+void PacketCaptureTests::truncatedTest() {
+    QString path = _directory.filePath("truncated.capture");
+    QByteArray data(100, 'y');
+
+    PacketCaptureWriter writer;
+    QVERIFY(writer.open(path));
+    writer.addDatagram(data.constData(), data.size(), FIRST_SENDER, 1000);
+    writer.addDatagram(data.constData(), data.size(), FIRST_SENDER, 2000);
+    writer.close();
+
+    // a server that was killed mid-write leaves half a datagram at the end
+    QFile file { path };
+    QVERIFY(file.resize(file.size() - 10));
+
+    PacketCaptureReader reader;
+    QVERIFY(reader.open(path));
+    PacketCaptureReader::Datagram datagram;
+    QVERIFY(reader.readNext(datagram));
+    QCOMPARE(datagram.data, data);
+    QVERIFY(!reader.readNext(datagram));
+}
+
+void PacketCaptureTests::notACaptureTest() {
+    QString path = _directory.filePath("notACapture.capture");
+    QFile file { path };
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("certainly not a capture");
+    file.close();
+
+    PacketCaptureReader reader;
+    QVERIFY(!reader.open(path));
+
+    PacketCaptureReader::Datagram datagram;
+    QVERIFY(!reader.readNext(datagram));
+}
@@ -0,0 +1,29 @@
+//
+//  PacketCaptureTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketCaptureTests_h
+#define hifi_PacketCaptureTests_h
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+class PacketCaptureTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTripTest();
+    void truncatedTest();
+    void notACaptureTest();
+
+private:
+    QTemporaryDir _directory;
+};
+
+#endif // hifi_PacketCaptureTests_h
@@ -0,0 +1,64 @@
+//
+//  PacketListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketListTests.h"
+
+#include <udt/PacketList.h>
+
+QTEST_MAIN(PacketListTests)
+
+using namespace udt;
+
+static QByteArray createMessage(int size) {
+    QByteArray message(size, 0);
+    for (int i = 0; i < size; ++i) {
+        message[i] = (char)(i % 251);
+    }
+    return message;
+}
+
+void PacketListTests::resizePacketsTest() {
+    static const int MESSAGE_SIZE = 100000;
+    QByteArray message = createMessage(MESSAGE_SIZE);
+
+    auto packetList = PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+    packetList->write(message);
+    packetList->closeCurrentPacket();
+    int numPackets = packetList->getNumPackets();
+
+    packetList->resizePackets(MAX_JUMBO_PACKET_SIZE);
+
+    int jumboPayloadSize = MAX_JUMBO_PACKET_SIZE - Packet::totalHeaderSize(true);
+    QCOMPARE(packetList->getNumPackets(), (MESSAGE_SIZE + jumboPayloadSize - 1) / jumboPayloadSize);
+    QVERIFY(packetList->getNumPackets() < numPackets);
+    QCOMPARE(packetList->getMessageSize(), (size_t)MESSAGE_SIZE);
+    QCOMPARE(packetList->getMessage(), message);
+}
+
+void PacketListTests::resizeUnsupportedTest() {
+    static const int MESSAGE_SIZE = 10000;
+    QByteArray message = createMessage(MESSAGE_SIZE);
+
+    auto unorderedList = PacketList::create(PacketType::Unknown, QByteArray(), true, false);
+    for (int i = 0; i < MESSAGE_SIZE; i += 100) {
+        unorderedList->write(message.mid(i, 100));
+    }
+    unorderedList->closeCurrentPacket();
+    int numUnorderedPackets = unorderedList->getNumPackets();
+    unorderedList->resizePackets(MAX_JUMBO_PACKET_SIZE);
+    QCOMPARE(unorderedList->getNumPackets(), numUnorderedPackets);
+
+    auto headerList = PacketList::create(PacketType::Unknown, QByteArray("header"), true, true);
+    headerList->write(message);
+    headerList->closeCurrentPacket();
+    int numHeaderPackets = headerList->getNumPackets();
+    headerList->resizePackets(MAX_JUMBO_PACKET_SIZE);
+    QCOMPARE(headerList->getNumPackets(), numHeaderPackets);
+}
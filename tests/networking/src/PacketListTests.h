@@ -0,0 +1,28 @@
+//
+//  PacketListTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketListTests_h
+#define hifi_PacketListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketListTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that an ordered list cut again into jumbo packets carries the same message in fewer packets
+    void resizePacketsTest();
+
+    // Test that unordered lists and lists with an extended header keep their packets
+    void resizeUnsupportedTest();
+};
+
+#endif // hifi_PacketListTests_h
@@ -0,0 +1,82 @@
+//
+//  PacketQueueTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketQueueTests.h"
+
+#include <udt/PacketList.h>
+#include <udt/PacketQueue.h>
+
+QTEST_MAIN(PacketQueueTests)
+
+using namespace udt;
+
+static std::unique_ptr<PacketList> createList(int numPackets, PacketList::Priority priority) {
+    auto packetList = PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+    packetList->setPriority(priority);
+    packetList->write(QByteArray(numPackets * Packet::maxPayloadSize(true), 'x'));
+    packetList->closeCurrentPacket();
+    return packetList;
+}
+
+void PacketQueueTests::singlePacketsPreemptListTest() {
+    static const int NUM_LIST_PACKETS = 40;
+    static const int NUM_SINGLE_PACKETS = 3;
+
+    PacketQueue queue;
+    auto packetList = createList(NUM_LIST_PACKETS, PacketList::Priority::Bulk);
+    QCOMPARE(packetList->getNumPackets(), NUM_LIST_PACKETS);
+    queue.queuePacketList(std::move(packetList));
+    for (int i = 0; i < NUM_SINGLE_PACKETS; i++) {
+        queue.queuePacket(Packet::create(-1, true));
+    }
+
+    int lastSinglePacketPosition = -1;
+    int numListPackets = 0;
+    for (int i = 0; !queue.isEmpty(); i++) {
+        auto packet = queue.takePacket();
+        QVERIFY(packet);
+        if (packet->isPartOfMessage()) {
+            // the list still goes in order
+            QCOMPARE((int)packet->getMessagePartNumber(), numListPackets);
+            numListPackets++;
+        } else {
+            lastSinglePacketPosition = i;
+        }
+    }
+    QCOMPARE(numListPackets, NUM_LIST_PACKETS);
+    QVERIFY(lastSinglePacketPosition >= 0);
+    QVERIFY(lastSinglePacketPosition <= NUM_SINGLE_PACKETS);
+    QVERIFY(!queue.takePacket());
+}
+
+void PacketQueueTests::listPriorityTest() {
+    static const int NUM_LIST_PACKETS = 20;
+    static const int NUM_TAKEN_PACKETS = 10;
+
+    PacketQueue queue;
+    queue.queuePacketList(createList(NUM_LIST_PACKETS, PacketList::Priority::Normal));
+    queue.queuePacketList(createList(NUM_LIST_PACKETS, PacketList::Priority::Bulk));
+
+    std::map<Packet::MessageNumber, int> numTakenPackets;
+    for (int i = 0; i < NUM_TAKEN_PACKETS; i++) {
+        auto packet = queue.takePacket();
+        QVERIFY(packet);
+        auto& numTaken = numTakenPackets[packet->getMessageNumber()];
+        QCOMPARE((int)packet->getMessagePartNumber(), numTaken);
+        numTaken++;
+    }
+    QCOMPARE((int)numTakenPackets.size(), 2);
+
+    // each turn of the bulk list takes one packet, each turn of the other takes four
+    int numNormalPackets = numTakenPackets.begin()->second;
+    int numBulkPackets = numTakenPackets.rbegin()->second;
+    QCOMPARE(numNormalPackets + numBulkPackets, NUM_TAKEN_PACKETS);
+    QCOMPARE(numNormalPackets, 4 * numBulkPackets);
+}
@@ -0,0 +1,28 @@
+//
+//  PacketQueueTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketQueueTests_h
+#define hifi_PacketQueueTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketQueueTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that single packets queued after a bulk packet list are not held back until the list is sent
+    void singlePacketsPreemptListTest();
+
+    // Test that packet lists are sent in turn according to their priority, each in order
+    void listPriorityTest();
+};
+
+#endif // hifi_PacketQueueTests_h
@@ -0,0 +1,98 @@
+//
+//  ResourceDiskCacheTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceDiskCacheTests.h"
+
+#include <ResourceDiskCache.h>
+
+QTEST_MAIN(ResourceDiskCacheTests)
+
+const qint64 MAXIMUM_SIZE = 1024 * 1024;
+
+static ResourceDiskCache::Validators makeValidators(const QByteArray& eTag, int secondsToExpire) {
+    ResourceDiskCache::Validators validators;
+    validators.eTag = eTag;
+    validators.expiration = QDateTime::currentDateTimeUtc().addSecs(secondsToExpire);
+    return validators;
+}
+
+void ResourceDiskCacheTests::init() {
+    ResourceDiskCache::setMaximumSize(MAXIMUM_SIZE);
+    ResourceDiskCache::setCacheDirectory(_directory.path());
+    ResourceDiskCache::clear();
+}
+
+void ResourceDiskCacheTests::storeLoadTest() {
+    QUrl url("http://example.com/model.fbx");
+    QByteArray data(1000, 'm');
+    ResourceDiskCache::store(url, data, makeValidators("\"abc\"", 60));
+
+    ResourceDiskCache::Validators validators;
+    QVERIFY(ResourceDiskCache::getValidators(url, validators));
+    QCOMPARE(validators.eTag, QByteArray("\"abc\""));
+    QVERIFY(ResourceDiskCache::isFresh(url));
+
+    QByteArray loaded;
+    QVERIFY(ResourceDiskCache::load(url, loaded));
+    QCOMPARE(loaded, data);
+
+    QVERIFY(!ResourceDiskCache::load(QUrl("http://example.com/other.fbx"), loaded));
+}
+
+void ResourceDiskCacheTests::persistenceTest() {
+    QUrl url("http://example.com/texture.png");
+    QByteArray data(2000, 't');
+    ResourceDiskCache::store(url, data, makeValidators("\"def\"", 60));
+    qint64 size = ResourceDiskCache::getSize();
+
+    ResourceDiskCache::setCacheDirectory(_directory.path());
+    QCOMPARE(ResourceDiskCache::getSize(), size);
+    QVERIFY(ResourceDiskCache::isFresh(url));
+
+    QByteArray loaded;
+    QVERIFY(ResourceDiskCache::load(url, loaded));
+    QCOMPARE(loaded, data);
+}
+
+void ResourceDiskCacheTests::evictionTest() {
+    const int ENTRY_SIZE = MAXIMUM_SIZE / 3;
+    QUrl first("http://example.com/1");
+    QUrl second("http://example.com/2");
+    QUrl third("http://example.com/3");
+    ResourceDiskCache::store(first, QByteArray(ENTRY_SIZE, '1'), makeValidators("1", 60));
+    QTest::qWait(2);
+    ResourceDiskCache::store(second, QByteArray(ENTRY_SIZE, '2'), makeValidators("2", 60));
+    QTest::qWait(2);
+
+    // using the first makes the second the least recently used
+    QByteArray loaded;
+    QVERIFY(ResourceDiskCache::load(first, loaded));
+    QTest::qWait(2);
+    ResourceDiskCache::store(third, QByteArray(ENTRY_SIZE, '3'), makeValidators("3", 60));
+
+    ResourceDiskCache::Validators validators;
+    QVERIFY(ResourceDiskCache::getValidators(first, validators));
+    QVERIFY(!ResourceDiskCache::getValidators(second, validators));
+    QVERIFY(ResourceDiskCache::getValidators(third, validators));
+    QVERIFY(ResourceDiskCache::getSize() <= MAXIMUM_SIZE);
+}
+
+void ResourceDiskCacheTests::revalidationTest() {
+    QUrl url("http://example.com/script.js");
+    ResourceDiskCache::store(url, QByteArray("print('hi');"), makeValidators("\"ghi\"", -1));
+    QVERIFY(!ResourceDiskCache::isFresh(url));
+
+    ResourceDiskCache::revalidate(url, QDateTime::currentDateTimeUtc().addSecs(60));
+    QVERIFY(ResourceDiskCache::isFresh(url));
+
+    // the new expiration is on disk too
+    ResourceDiskCache::setCacheDirectory(_directory.path());
+    QVERIFY(ResourceDiskCache::isFresh(url));
+}
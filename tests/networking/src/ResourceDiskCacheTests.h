@@ -0,0 +1,40 @@
+//
+//  ResourceDiskCacheTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceDiskCacheTests_h
+#define hifi_ResourceDiskCacheTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+class ResourceDiskCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+
+    // Test that a stored entry comes back with its validators
+    void storeLoadTest();
+
+    // Test that the entries are still there once the directory is loaded again
+    void persistenceTest();
+
+    // Test that the least recently used entries go first past the size limit
+    void evictionTest();
+
+    // Test that an expired entry is stale until revalidated
+    void revalidationTest();
+
+private:
+    QTemporaryDir _directory;
+};
+
+#endif // hifi_ResourceDiskCacheTests_h
@@ -7,6 +7,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cfloat>
+
 #include <QNetworkDiskCache>
 
 #include "ResourceCache.h"
@@ -93,3 +95,28 @@ void ResourceTests::downloadAgain() {
     QVERIFY(resource->isLoaded());
 
 }
+
+void ResourceTests::loadPriority() {
+    Resource* delayedResource = new Resource(QUrl("http://localhost/priority.fst"), true);
+
+    QObject* owner = new QObject();
+    QObject* movingOwner = new QObject();
+    float movingPriority = 1.0f;
+    delayedResource->setLoadPriority(owner, 2.0f);
+    delayedResource->setLoadPriorityOperator(movingOwner, [&]() { return movingPriority; });
+    QCOMPARE(delayedResource->getLoadPriority(), 2.0f);
+
+    // the operators get evaluated each time
+    movingPriority = 3.0f;
+    QCOMPARE(delayedResource->getLoadPriority(), 3.0f);
+
+    // and dropped with their owner
+    delete movingOwner;
+    QCOMPARE(delayedResource->getLoadPriority(), 2.0f);
+
+    delayedResource->clearLoadPriority(owner);
+    QCOMPARE(delayedResource->getLoadPriority(), -FLT_MAX);
+
+    delete owner;
+    delete delayedResource;
+}
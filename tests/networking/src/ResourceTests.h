@@ -18,6 +18,7 @@ private slots:
     void initTestCase();
     void downloadFirst();
     void downloadAgain();
+    void loadPriority();
 };
 
 #endif // hifi_ResourceTests_h
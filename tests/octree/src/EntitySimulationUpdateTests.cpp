@@ -0,0 +1,132 @@
+//
+//  EntitySimulationUpdateTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySimulationUpdateTests.h"
+
+#include <GLMHelpers.h>
+#include <EntityItemProperties.h>
+#include <EntitySimulationUpdate.h>
+#include <NLPacket.h>
+
+QTEST_MAIN(EntitySimulationUpdateTests)
+
+static const glm::vec3 GRAVITY(0.0f, -9.8f, 0.0f);
+static const float VELOCITY_TOLERANCE = 0.001f; // meters per second
+static const float ANGULAR_VELOCITY_TOLERANCE = 0.0005f; // radians per second
+static const float ROTATION_TOLERANCE = 0.0001f;
+
+static float randomFloat(float low, float high) {
+    return low + (high - low) * (float)qrand() / (float)RAND_MAX;
+}
+
+static glm::quat randomRotation() {
+    glm::quat rotation(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f),
+                       randomFloat(-1.0f, 1.0f));
+    return glm::normalize(rotation);
+}
+
+// q and -q are the same rotation
+static float rotationDifference(const glm::quat& a, const glm::quat& b) {
+    return 1.0f - fabsf(glm::dot(a, b));
+}
+
+static EntityItemProperties physicsUpdate() {
+    EntityItemProperties properties;
+    properties.setPosition(glm::vec3(1234.5f, -17.25f, 88.125f));
+    properties.setRotation(randomRotation());
+    properties.setVelocity(glm::vec3(3.7f, -12.3f, 0.05f));
+    properties.setAcceleration(GRAVITY);
+    properties.setAngularVelocity(glm::vec3(-1.3f, 0.2f, 7.9f));
+    properties.setActionData(QByteArray("action data"));
+    properties.setSimulationOwner(QUuid::createUuid(), 10);
+    properties.setLastEdited(usecTimestampNow());
+    return properties;
+}
+
+void EntitySimulationUpdateTests::roundTripTest() {
+    EntityItemID entityID(QUuid::createUuid());
+    EntityItemProperties sent = physicsUpdate();
+    QVERIFY(EntitySimulationUpdate::canEncode(sent, GRAVITY));
+
+    QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntitySimulationUpdate), 0);
+    QVERIFY(EntitySimulationUpdate::encode(entityID, sent, buffer));
+
+    QByteArray editBuffer(NLPacket::maxPayloadSize(PacketType::EntityEdit), 0);
+    QVERIFY(EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, entityID, sent, editBuffer));
+    QVERIFY(buffer.size() < editBuffer.size());
+
+    EntityItemID decodedID;
+    EntityItemProperties decoded;
+    bool accelerationIsGravity = false;
+    int processedBytes = 0;
+    QVERIFY(EntitySimulationUpdate::decode(reinterpret_cast<const unsigned char*>(buffer.constData()), buffer.size(),
+                                           processedBytes, decodedID, decoded, accelerationIsGravity));
+
+    QCOMPARE(processedBytes, buffer.size());
+    QCOMPARE(decodedID, entityID);
+    QCOMPARE(decoded.getLastEdited(), sent.getLastEdited());
+    QCOMPARE(decoded.getPosition(), sent.getPosition());
+    QVERIFY(rotationDifference(decoded.getRotation(), sent.getRotation()) < ROTATION_TOLERANCE);
+    QVERIFY(glm::length(decoded.getVelocity() - sent.getVelocity()) < VELOCITY_TOLERANCE * 2.0f);
+    QVERIFY(glm::length(decoded.getAngularVelocity() - sent.getAngularVelocity()) < ANGULAR_VELOCITY_TOLERANCE * 2.0f);
+    QVERIFY(accelerationIsGravity);
+    QVERIFY(!decoded.accelerationChanged());
+    QCOMPARE(decoded.getActionData(), sent.getActionData());
+    QCOMPARE(decoded.getSimulationOwner().getID(), sent.getSimulationOwner().getID());
+    QCOMPARE(decoded.getSimulationOwner().getPriority(), sent.getSimulationOwner().getPriority());
+
+    // the sender predicts the values the receiver decodes
+    QCOMPARE(EntitySimulationUpdate::quantizeVelocity(sent.getVelocity()), decoded.getVelocity());
+    QCOMPARE(EntitySimulationUpdate::quantizeAngularVelocity(sent.getAngularVelocity()), decoded.getAngularVelocity());
+
+    // a truncated message is rejected
+    QVERIFY(!EntitySimulationUpdate::decode(reinterpret_cast<const unsigned char*>(buffer.constData()),
+                                            buffer.size() - 1, processedBytes, decodedID, decoded,
+                                            accelerationIsGravity));
+}
+
+void EntitySimulationUpdateTests::canEncodeTest() {
+    EntityItemProperties properties = physicsUpdate();
+    properties.setAcceleration(glm::vec3(0.0f));
+    QVERIFY(EntitySimulationUpdate::canEncode(properties, GRAVITY));
+
+    EntityItemProperties otherAcceleration = physicsUpdate();
+    otherAcceleration.setAcceleration(glm::vec3(1.0f, 0.0f, 0.0f));
+    QVERIFY(!EntitySimulationUpdate::canEncode(otherAcceleration, GRAVITY));
+
+    EntityItemProperties fast = physicsUpdate();
+    fast.setVelocity(glm::vec3(0.0f, -40.0f, 0.0f));
+    QVERIFY(!EntitySimulationUpdate::canEncode(fast, GRAVITY));
+
+    EntityItemProperties spinning = physicsUpdate();
+    spinning.setAngularVelocity(glm::vec3(20.0f, 0.0f, 0.0f));
+    QVERIFY(!EntitySimulationUpdate::canEncode(spinning, GRAVITY));
+
+    EntityItemProperties resized = physicsUpdate();
+    resized.setDimensions(glm::vec3(2.0f));
+    QVERIFY(!EntitySimulationUpdate::canEncode(resized, GRAVITY));
+}
+
+void EntitySimulationUpdateTests::smallestThreeRotationTest() {
+    const int NUM_ROTATIONS = 10000;
+    for (int i = 0; i < NUM_ROTATIONS; ++i) {
+        glm::quat rotation = randomRotation();
+        unsigned char buffer[6];
+        QCOMPARE(packOrientationQuatToSixBytes(buffer, rotation), 6);
+
+        glm::quat unpacked;
+        QCOMPARE(unpackOrientationQuatFromSixBytes(buffer, unpacked), 6);
+        QVERIFY(rotationDifference(unpacked, rotation) < ROTATION_TOLERANCE);
+    }
+
+    // the identity, where the dropped component is exactly one
+    glm::quat identity;
+    QVERIFY(rotationDifference(EntitySimulationUpdate::quantizeRotation(identity), identity) < ROTATION_TOLERANCE);
+}
@@ -0,0 +1,30 @@
+//
+//  EntitySimulationUpdateTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySimulationUpdateTests_h
+#define hifi_EntitySimulationUpdateTests_h
+
+#include <QtTest/QtTest>
+
+class EntitySimulationUpdateTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a physics update decodes to what was sent, within the precision of the format, and is smaller than
+    // the same update sent as EntityEdit
+    void roundTripTest();
+
+    // Test that updates the format can't carry are left to EntityEdit
+    void canEncodeTest();
+
+    // Test that rotations packed as their three smallest components unpack close to the original
+    void smallestThreeRotationTest();
+};
+
+#endif // hifi_EntitySimulationUpdateTests_h
@@ -0,0 +1,154 @@
+//
+//  EntitySpatialHashTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySpatialHashTests.h"
+
+#include <AABox.h>
+#include <AACube.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+
+QTEST_MAIN(EntitySpatialHashTests)
+
+static const int NUM_ENTITIES = 5000;
+static const float WORLD_SIZE = 1000.0f; // meters
+static const int NUM_QUERIES = 200;
+static const float QUERY_RADIUS = 5.0f; // meters
+
+static float randomFloat(float low, float high) {
+    return low + (high - low) * (float)qrand() / (float)RAND_MAX;
+}
+
+static glm::vec3 randomPosition() {
+    return glm::vec3(randomFloat(0.0f, WORLD_SIZE), randomFloat(0.0f, WORLD_SIZE), randomFloat(0.0f, WORLD_SIZE));
+}
+
+static EntityTreePointer createTree(QVector<EntityItemID>& entityIDs) {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    for (int i = 0; i < NUM_ENTITIES; ++i) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(randomPosition());
+
+        // mostly small entities, with a few big enough to sit high in the tree
+        float size = (i % 100 == 0) ? randomFloat(20.0f, 100.0f) : randomFloat(0.1f, 2.0f);
+        properties.setDimensions(glm::vec3(size));
+
+        EntityItemID entityID(QUuid::createUuid());
+        if (tree->addEntity(entityID, properties)) {
+            entityIDs << entityID;
+        }
+    }
+
+    return tree;
+}
+
+static QSet<EntityItemPointer> toSet(const QVector<EntityItemPointer>& entities) {
+    QSet<EntityItemPointer> result;
+    foreach (EntityItemPointer entity, entities) {
+        result.insert(entity);
+    }
+    return result;
+}
+
+static void compareQueries(EntityTreePointer tree) {
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        glm::vec3 center = randomPosition();
+        float radius = (i % 10 == 0) ? randomFloat(50.0f, 200.0f) : randomFloat(0.5f, QUERY_RADIUS);
+
+        QVector<EntityItemPointer> recursed;
+        QVector<EntityItemPointer> hashed;
+
+        tree->setUseSpatialHash(false);
+        tree->findEntities(center, radius, recursed);
+        tree->setUseSpatialHash(true);
+        tree->findEntities(center, radius, hashed);
+        QCOMPARE(hashed.size(), recursed.size());
+        QCOMPARE(toSet(hashed), toSet(recursed));
+
+        AACube cube(center - glm::vec3(radius), 2.0f * radius);
+        tree->setUseSpatialHash(false);
+        tree->findEntities(cube, recursed);
+        tree->setUseSpatialHash(true);
+        tree->findEntities(cube, hashed);
+        QCOMPARE(toSet(hashed), toSet(recursed));
+
+        AABox box(center, glm::vec3(radius, 2.0f * radius, 0.5f * radius));
+        tree->setUseSpatialHash(false);
+        tree->findEntities(box, recursed);
+        tree->setUseSpatialHash(true);
+        tree->findEntities(box, hashed);
+        QCOMPARE(toSet(hashed), toSet(recursed));
+
+        tree->setUseSpatialHash(false);
+        EntityItemPointer recursedClosest = tree->findClosestEntity(center, radius);
+        tree->setUseSpatialHash(true);
+        EntityItemPointer hashedClosest = tree->findClosestEntity(center, radius);
+        QCOMPARE(hashedClosest, recursedClosest);
+    }
+}
+
+void EntitySpatialHashTests::matchesOctreeRecursionTest() {
+    qsrand(1);
+
+    QVector<EntityItemID> entityIDs;
+    auto tree = createTree(entityIDs);
+    QVERIFY(!entityIDs.isEmpty());
+
+    compareQueries(tree);
+
+    // move a third of the entities, going to other elements
+    for (int i = 0; i < entityIDs.size(); i += 3) {
+        EntityItemProperties properties;
+        properties.setPosition(randomPosition());
+        QVERIFY(tree->updateEntity(entityIDs[i], properties));
+    }
+    compareQueries(tree);
+
+    // delete another third
+    for (int i = 1; i < entityIDs.size(); i += 3) {
+        tree->deleteEntity(entityIDs[i], true);
+    }
+    compareQueries(tree);
+}
+
+void EntitySpatialHashTests::findEntitiesBenchmark_data() {
+    QTest::addColumn<bool>("useSpatialHash");
+
+    QTest::newRow("octree recursion") << false;
+    QTest::newRow("spatial hash") << true;
+}
+
+void EntitySpatialHashTests::findEntitiesBenchmark() {
+    QFETCH(bool, useSpatialHash);
+
+    qsrand(2);
+
+    QVector<EntityItemID> entityIDs;
+    auto tree = createTree(entityIDs);
+    tree->setUseSpatialHash(useSpatialHash);
+
+    QVector<glm::vec3> centers;
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        centers << randomPosition();
+    }
+
+    int numFound = 0;
+    QBENCHMARK {
+        QVector<EntityItemPointer> foundEntities;
+        foreach (const glm::vec3& center, centers) {
+            tree->findEntities(center, QUERY_RADIUS, foundEntities);
+            numFound += foundEntities.size();
+        }
+    }
+    QVERIFY(numFound >= 0);
+}
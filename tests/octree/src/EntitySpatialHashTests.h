@@ -0,0 +1,28 @@
+//
+//  EntitySpatialHashTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialHashTests_h
+#define hifi_EntitySpatialHashTests_h
+
+#include <QtTest/QtTest>
+
+class EntitySpatialHashTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that sphere, cube and box queries find the same entities with and without the spatial hash, also after
+    // entities were moved and deleted
+    void matchesOctreeRecursionTest();
+
+    // Compare small sphere queries recursing the octree with the same queries answered by the spatial hash
+    void findEntitiesBenchmark_data();
+    void findEntitiesBenchmark();
+};
+
+#endif // hifi_EntitySpatialHashTests_h
@@ -0,0 +1,99 @@
+//
+//  InterestVolumeTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "InterestVolumeTests.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <InterestVolume.h>
+#include <NumericalConstants.h>
+#include <ViewFrustum.h>
+
+QTEST_MAIN(InterestVolumeTests)
+
+void InterestVolumeTests::containmentTest() {
+    InterestVolume sphere(glm::vec3(10.0f), 2.0f);
+    QCOMPARE(sphere.getShape(), InterestVolume::SPHERE);
+    QVERIFY(sphere.contains(glm::vec3(11.0f, 10.0f, 10.0f)));
+    QVERIFY(!sphere.contains(glm::vec3(11.5f, 11.5f, 11.5f)));
+    QVERIFY(sphere.contains(AABox(glm::vec3(9.5f), 1.0f)));
+    QVERIFY(!sphere.contains(AABox(glm::vec3(8.5f), 3.0f)));
+    QVERIFY(sphere.touches(AABox(glm::vec3(8.5f), 3.0f)));
+    // in the bounding box of the sphere, but not in the sphere
+    QVERIFY(!sphere.touches(AABox(glm::vec3(11.6f), 0.3f)));
+    QVERIFY(sphere.containsSphere(glm::vec3(10.5f, 10.0f, 10.0f), 1.0f));
+    QVERIFY(sphere.touchesSphere(glm::vec3(13.0f, 10.0f, 10.0f), 1.5f));
+    QVERIFY(!sphere.touchesSphere(glm::vec3(13.0f, 10.0f, 10.0f), 0.5f));
+
+    InterestVolume box(AABox(glm::vec3(0.0f), glm::vec3(4.0f, 2.0f, 1.0f)));
+    QCOMPARE(box.getShape(), InterestVolume::BOX);
+    QVERIFY(box.contains(glm::vec3(3.0f, 1.0f, 0.5f)));
+    QVERIFY(!box.contains(glm::vec3(3.0f, 3.0f, 0.5f)));
+    QVERIFY(box.contains(AABox(glm::vec3(1.0f, 0.5f, 0.25f), 0.5f)));
+    QVERIFY(box.touches(AABox(glm::vec3(3.0f, 1.0f, 0.5f), 2.0f)));
+    QVERIFY(!box.touches(AABox(glm::vec3(5.0f, 0.0f, 0.0f), 1.0f)));
+    QVERIFY(box.containsSphere(glm::vec3(2.0f, 1.0f, 0.5f), 0.25f));
+    QVERIFY(box.touchesSphere(glm::vec3(5.0f, 1.0f, 0.5f), 1.5f));
+    QVERIFY(!box.touchesSphere(glm::vec3(5.0f, 3.0f, 0.5f), 1.0f));
+}
+
+void InterestVolumeTests::packTest() {
+    unsigned char buffer[64];
+
+    InterestVolume sphere(glm::vec3(1.0f, -2.0f, 3.0f), 4.0f, 2.0f);
+    int bytesPacked = sphere.pack(buffer);
+    InterestVolume unpackedSphere;
+    QCOMPARE(unpackedSphere.unpack(buffer, bytesPacked), bytesPacked);
+    QVERIFY(unpackedSphere == sphere);
+
+    InterestVolume box(AABox(glm::vec3(-5.0f, 0.0f, 5.0f), glm::vec3(1.0f, 2.0f, 3.0f)), 0.5f);
+    bytesPacked = box.pack(buffer);
+    InterestVolume unpackedBox;
+    QCOMPARE(unpackedBox.unpack(buffer, bytesPacked), bytesPacked);
+    QVERIFY(unpackedBox == box);
+
+    // truncated data and unknown shapes are refused
+    QCOMPARE(unpackedBox.unpack(buffer, bytesPacked - 1), 0);
+    buffer[0] = 0xff;
+    QCOMPARE(unpackedBox.unpack(buffer, bytesPacked), 0);
+}
+
+void InterestVolumeTests::frustumTest() {
+    ViewFrustum frustum;
+    frustum.setPosition(glm::vec3(0.0f));
+    frustum.setOrientation(glm::quat());
+    frustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                           DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
+    frustum.calculate();
+
+    // behind the camera and well outside of the keyhole
+    AACube behind(glm::vec3(-0.5f, -0.5f, 50.0f), 1.0f);
+    glm::vec3 behindCenter = behind.calcCenter();
+    QCOMPARE(frustum.cubeInFrustum(behind), ViewFrustum::OUTSIDE);
+    QCOMPARE(frustum.pointInFrustum(behindCenter), ViewFrustum::OUTSIDE);
+    float distance = frustum.distanceToCamera(behindCenter);
+
+    ViewFrustum interested = frustum;
+    QVector<InterestVolume> volumes;
+    volumes.push_back(InterestVolume(glm::vec3(0.0f, 0.0f, 50.0f), 5.0f, 2.0f));
+    interested.setInterestVolumes(volumes);
+    QVERIFY(!interested.isVerySimilar(frustum));
+
+    QCOMPARE(interested.cubeInFrustum(behind), ViewFrustum::INSIDE);
+    QCOMPARE(interested.boxInFrustum(AABox(behind)), ViewFrustum::INSIDE);
+    QCOMPARE(interested.sphereInFrustum(behindCenter, 1.0f), ViewFrustum::INSIDE);
+    QCOMPARE(interested.pointInFrustum(behindCenter), ViewFrustum::INSIDE);
+    QCOMPARE(interested.cubeInFrustum(AACube(glm::vec3(-0.5f, -0.5f, 54.0f), 2.0f)), ViewFrustum::INTERSECT);
+    QCOMPARE(interested.cubeInFrustum(AACube(glm::vec3(-0.5f, -0.5f, 60.0f), 1.0f)), ViewFrustum::OUTSIDE);
+
+    // the volume is closer than the camera, and its priority brings it closer still
+    QVERIFY(interested.distanceToCamera(behindCenter) < distance);
+    QVERIFY(interested.distanceToCamera(glm::vec3(0.0f, 0.0f, 52.0f)) <= 1.0f + EPSILON);
+}
@@ -0,0 +1,29 @@
+//
+//  InterestVolumeTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_InterestVolumeTests_h
+#define hifi_InterestVolumeTests_h
+
+#include <QtTest/QtTest>
+
+class InterestVolumeTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test whether spheres and boxes contain and touch other boxes and spheres
+    void containmentTest();
+
+    // Test that volumes unpack to what was packed and that bad data is refused
+    void packTest();
+
+    // Test that a view frustum counts what is in its interest volumes as in view, with their level of detail
+    void frustumTest();
+};
+
+#endif // hifi_InterestVolumeTests_h
@@ -0,0 +1,65 @@
+//
+//  JurisdictionMapTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JurisdictionMapTests.h"
+
+#include <JurisdictionMap.h>
+#include <OctalCode.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(JurisdictionMapTests)
+
+// the first octant of the tree, the corner at -HALF_TREE_SCALE in meters
+static unsigned char* firstOctantOctalCode() {
+    return pointToOctalCode(0.0f, 0.0f, 0.0f, 0.5f);
+}
+
+void JurisdictionMapTests::routingOctalCodeTest() {
+    unsigned char* octalCode = JurisdictionMap::routingOctalCodeForPosition(glm::vec3(-100.0f));
+    QCOMPARE(numberOfThreeBitSectionsInCode(octalCode), ROUTING_OCTAL_CODE_DEPTH);
+    unsigned char* octant = firstOctantOctalCode();
+    QVERIFY(isAncestorOf(octant, octalCode));
+    delete[] octalCode;
+
+    octalCode = JurisdictionMap::routingOctalCodeForPosition(glm::vec3(100.0f));
+    QVERIFY(!isAncestorOf(octant, octalCode));
+    delete[] octalCode;
+
+    // positions outside of the tree are routed to its edge
+    octalCode = JurisdictionMap::routingOctalCodeForPosition(glm::vec3(-1.0e6f));
+    QCOMPARE(numberOfThreeBitSectionsInCode(octalCode), ROUTING_OCTAL_CODE_DEPTH);
+    QVERIFY(isAncestorOf(octant, octalCode));
+    delete[] octalCode;
+    delete[] octant;
+}
+
+void JurisdictionMapTests::positionJurisdictionTest() {
+    // the first octant, and the rest of the tree
+    JurisdictionMap octantMap(firstOctantOctalCode(), std::vector<unsigned char*>());
+    std::vector<unsigned char*> endNodes;
+    endNodes.push_back(firstOctantOctalCode());
+    JurisdictionMap restMap(pointToOctalCode(0.0f, 0.0f, 0.0f, 1.0f), endNodes);
+
+    glm::vec3 inOctant(-100.0f, -2000.0f, -5.0f);
+    QCOMPARE(octantMap.isMyJurisdiction(inOctant), JurisdictionMap::WITHIN);
+    QCOMPARE(restMap.isMyJurisdiction(inOctant), JurisdictionMap::BELOW);
+
+    glm::vec3 outOfOctant(-100.0f, 2000.0f, -5.0f);
+    QCOMPARE(octantMap.isMyJurisdiction(outOfOctant), JurisdictionMap::BELOW);
+    QCOMPARE(restMap.isMyJurisdiction(outOfOctant), JurisdictionMap::WITHIN);
+}
+
+void JurisdictionMapTests::rootOctalCodeTest() {
+    JurisdictionMap octantMap(firstOctantOctalCode(), std::vector<unsigned char*>());
+    unsigned char* rootOctalCode = pointToOctalCode(0.0f, 0.0f, 0.0f, 1.0f);
+    QCOMPARE(numberOfThreeBitSectionsInCode(rootOctalCode), 0);
+    QVERIFY(octantMap.isMyJurisdiction(rootOctalCode, CHECK_NODE_ONLY) != JurisdictionMap::BELOW);
+    delete[] rootOctalCode;
+}
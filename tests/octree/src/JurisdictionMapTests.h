@@ -0,0 +1,29 @@
+//
+//  JurisdictionMapTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JurisdictionMapTests_h
+#define hifi_JurisdictionMapTests_h
+
+#include <QtTest/QtTest>
+
+class JurisdictionMapTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the routing octal codes of positions are cells of the routing depth
+    void routingOctalCodeTest();
+
+    // Test that a position is within exactly one of two jurisdictions that split the tree
+    void positionJurisdictionTest();
+
+    // Test that the root octal code reaches every jurisdiction
+    void rootOctalCodeTest();
+};
+
+#endif // hifi_JurisdictionMapTests_h
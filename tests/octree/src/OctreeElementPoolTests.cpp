@@ -0,0 +1,85 @@
+//
+//  OctreeElementPoolTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeElementPoolTests.h"
+
+#include <EntityTree.h>
+#include <OctreeElementPool.h>
+
+QTEST_MAIN(OctreeElementPoolTests)
+
+void OctreeElementPoolTests::reuseTest() {
+    const size_t BLOCK_SIZE = 40;
+    OctreeElementPool pool(BLOCK_SIZE);
+
+    void* first = pool.allocate(BLOCK_SIZE);
+    QCOMPARE(pool.getSlabCount(), 1);
+    QCOMPARE(pool.getFreeBlockCount(), OctreeElementPool::BLOCKS_PER_SLAB - 1);
+
+    pool.release(first, BLOCK_SIZE);
+    QCOMPARE(pool.getFreeBlockCount(), OctreeElementPool::BLOCKS_PER_SLAB);
+    QCOMPARE(pool.allocate(BLOCK_SIZE), first);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < OctreeElementPool::BLOCKS_PER_SLAB; i++) {
+        blocks.push_back(pool.allocate(BLOCK_SIZE));
+    }
+    QCOMPARE(pool.getSlabCount(), 2);
+
+    // other sizes are not pooled
+    void* other = pool.allocate(BLOCK_SIZE * 2);
+    QCOMPARE(pool.getFreeBlockCount(), OctreeElementPool::BLOCKS_PER_SLAB - 1);
+    pool.release(other, BLOCK_SIZE * 2);
+
+    for (void* block : blocks) {
+        pool.release(block, BLOCK_SIZE);
+    }
+    pool.release(first, BLOCK_SIZE);
+    QCOMPARE(pool.getFreeBlockCount(), 2 * OctreeElementPool::BLOCKS_PER_SLAB);
+}
+
+void OctreeElementPoolTests::alignmentTest() {
+    const size_t BLOCK_SIZE = 13;
+    OctreeElementPool pool(BLOCK_SIZE);
+
+    std::vector<char*> blocks;
+    for (int i = 0; i < OctreeElementPool::BLOCKS_PER_SLAB; i++) {
+        char* block = static_cast<char*>(pool.allocate(BLOCK_SIZE));
+        QCOMPARE(reinterpret_cast<quintptr>(block) % 16, (quintptr)0);
+        memset(block, i, BLOCK_SIZE);
+        blocks.push_back(block);
+    }
+    for (int i = 0; i < OctreeElementPool::BLOCKS_PER_SLAB; i++) {
+        QCOMPARE(blocks[i][0], (char)i);
+        QCOMPARE(blocks[i][BLOCK_SIZE - 1], (char)i);
+        pool.release(blocks[i], BLOCK_SIZE);
+    }
+}
+
+void OctreeElementPoolTests::entityTreeTest() {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    const int NUM_ENTITIES = 500;
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(glm::vec3((float)(i % 10) * 30.0f, (float)(i / 10 % 10) * 30.0f, (float)(i / 100) * 30.0f));
+        properties.setDimensions(glm::vec3(0.5f));
+        tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+    }
+    QVERIFY(OctreeElement::getNodeCount() > 1);
+
+    // the elements of the tree go back to the pool and are handed out again for a new one
+    tree->eraseAllOctreeElements(false);
+    QCOMPARE(OctreeElement::getNodeCount(), (unsigned long)0);
+    tree->createRootElement();
+    QCOMPARE(OctreeElement::getNodeCount(), (unsigned long)1);
+}
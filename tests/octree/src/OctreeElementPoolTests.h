@@ -0,0 +1,29 @@
+//
+//  OctreeElementPoolTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeElementPoolTests_h
+#define hifi_OctreeElementPoolTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeElementPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that freed blocks are handed out again before a new slab is made
+    void reuseTest();
+
+    // Test that the blocks are aligned and don't overlap
+    void alignmentTest();
+
+    // Test that an entity tree built and erased gives its elements back to the pool
+    void entityTreeTest();
+};
+
+#endif // hifi_OctreeElementPoolTests_h
@@ -0,0 +1,67 @@
+//
+//  OctreePacketDataTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreePacketDataTests.h"
+
+#include <OctreePacketData.h>
+
+QTEST_MAIN(OctreePacketDataTests)
+
+static void appendEntityLikeContent(OctreePacketData& packetData, int entities) {
+    for (int i = 0; i < entities; i++) {
+        packetData.appendValue(QUuid::createUuid());
+        packetData.appendValue(QString("http://hifi-public.s3.amazonaws.com/models/chair%1.fbx").arg(i));
+        packetData.appendValue(QString("{\"grabbableKey\":{\"grabbable\":false}}"));
+        packetData.appendValue(glm::vec3(1.0f));
+        packetData.appendValue(glm::vec3(0.0f, -9.8f, 0.0f));
+    }
+}
+
+void OctreePacketDataTests::compressedRoundTripTest() {
+    OctreePacketData packetData(true);
+    appendEntityLikeContent(packetData, 4);
+    int uncompressedSize = packetData.getUncompressedSize();
+    QByteArray uncompressed((const char*)packetData.getUncompressedData(), uncompressedSize);
+
+    int finalizedSize = packetData.getFinalizedSize();
+    QVERIFY(finalizedSize > 0);
+    QVERIFY(finalizedSize < uncompressedSize);
+
+    OctreePacketData decoded(true);
+    decoded.loadFinalizedContent(packetData.getFinalizedData(), finalizedSize);
+    QCOMPARE(decoded.getUncompressedSize(), uncompressedSize);
+    QCOMPARE(QByteArray((const char*)decoded.getUncompressedData(), decoded.getUncompressedSize()), uncompressed);
+}
+
+void OctreePacketDataTests::reuseTest() {
+    // the deflate stream is kept from packet to packet, each packet decodes on its own
+    OctreePacketData packetData(true);
+    for (int entities = 1; entities <= 3; entities++) {
+        packetData.reset();
+        appendEntityLikeContent(packetData, entities);
+        QByteArray uncompressed((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+
+        OctreePacketData decoded(true);
+        decoded.loadFinalizedContent(packetData.getFinalizedData(), packetData.getFinalizedSize());
+        QCOMPARE(QByteArray((const char*)decoded.getUncompressedData(), decoded.getUncompressedSize()), uncompressed);
+    }
+}
+
+void OctreePacketDataTests::corruptedTest() {
+    OctreePacketData packetData(true);
+    appendEntityLikeContent(packetData, 2);
+    QByteArray finalized((const char*)packetData.getFinalizedData(), packetData.getFinalizedSize());
+    finalized.truncate(finalized.size() / 2);
+
+    // a section that does not decode is empty
+    OctreePacketData decoded(true);
+    decoded.loadFinalizedContent((const unsigned char*)finalized.constData(), finalized.size());
+    QCOMPARE(decoded.getUncompressedSize(), 0);
+}
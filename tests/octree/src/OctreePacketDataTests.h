@@ -0,0 +1,25 @@
+//
+//  OctreePacketDataTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePacketDataTests_h
+#define hifi_OctreePacketDataTests_h
+
+#include <QtTest/QtTest>
+
+class OctreePacketDataTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void compressedRoundTripTest();
+    void reuseTest();
+    void corruptedTest();
+};
+
+#endif // hifi_OctreePacketDataTests_h
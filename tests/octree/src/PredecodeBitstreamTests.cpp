@@ -0,0 +1,135 @@
+//
+//  PredecodeBitstreamTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PredecodeBitstreamTests.h"
+
+#include <vector>
+
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <OctreeElementBag.h>
+#include <OctreePacketData.h>
+
+QTEST_MAIN(PredecodeBitstreamTests)
+
+static const int NUM_ENTITIES = 300;
+
+static EntityTreePointer createSourceTree(std::vector<EntityItemID>& entityIDs) {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(glm::vec3((float)(i % 10) * 30.0f, (float)(i / 10 % 10) * 30.0f, (float)(i / 100) * 30.0f));
+        properties.setDimensions(glm::vec3(0.5f + (float)(i % 3)));
+        properties.setName(QString("box %1").arg(i));
+        EntityItemID entityID(QUuid::createUuid());
+        tree->addEntity(entityID, properties);
+        entityIDs.push_back(entityID);
+    }
+    return tree;
+}
+
+// the uncompressed bitstreams of the whole tree, as the entity server sends it to a viewer without a view frustum
+static std::vector<QByteArray> encodeTree(const EntityTreePointer& tree) {
+    std::vector<QByteArray> bitstreams;
+    OctreePacketData packetData(false);
+    OctreeElementBag bag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    bag.insert(tree->getRoot());
+
+    const int MAX_PACKETS = 10000; // in case something never fits
+    while (!bag.isEmpty() && (int)bitstreams.size() < MAX_PACKETS) {
+        OctreeElementPointer subTree = bag.extract();
+        EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, WANT_COLOR, WANT_EXISTS_BITS, 0, false,
+                                     IGNORE_VIEW_FRUSTUM, NO_OCCLUSION_CULLING, IGNORE_COVERAGE_MAP,
+                                     NO_BOUNDARY_ADJUST, DEFAULT_OCTREE_SIZE_SCALE, IGNORE_LAST_SENT, true,
+                                     IGNORE_SCENE_STATS, IGNORE_JURISDICTION_MAP, &extraEncodeData);
+        packetData.reset();
+        if (tree->encodeTreeBitstream(subTree, &packetData, bag, params) > 0) {
+            bitstreams.push_back(QByteArray(reinterpret_cast<const char*>(packetData.getUncompressedData()),
+                                            packetData.getUncompressedSize()));
+        }
+    }
+    tree->releaseSceneEncodeData(&extraEncodeData);
+    return bitstreams;
+}
+
+static ReadBitstreamToTreeParams readParams() {
+    return ReadBitstreamToTreeParams(WANT_COLOR, WANT_EXISTS_BITS, NULL, QUuid(), SharedNodePointer(), false,
+                                     versionForPacketType(PacketType::EntityData));
+}
+
+// reads the bitstream with what was read ahead of the tree, and returns the read ahead items left unused
+static int readAhead(const EntityTreePointer& tree, const QByteArray& bitstream, int& entitiesRead) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(bitstream.constData());
+    ReadBitstreamToTreeParams args = readParams();
+    args.predecoded = tree->predecodeBitstream(data, bitstream.size(), args);
+    tree->readBitstreamToTree(data, bitstream.size(), args);
+    entitiesRead = args.entitiesPerPacket;
+
+    auto predecoded = static_cast<PredecodedEntities*>(args.predecoded.get());
+    return predecoded ? predecoded->entities.size() : 0;
+}
+
+void PredecodeBitstreamTests::initTestCase() {
+    DependencyManager::set<NodeList>(NodeType::Unassigned);
+}
+
+void PredecodeBitstreamTests::newEntitiesTest() {
+    std::vector<EntityItemID> entityIDs;
+    std::vector<QByteArray> bitstreams = encodeTree(createSourceTree(entityIDs));
+    QVERIFY(!bitstreams.empty());
+
+    auto directTree = std::make_shared<EntityTree>();
+    directTree->createRootElement();
+    auto readAheadTree = std::make_shared<EntityTree>();
+    readAheadTree->createRootElement();
+
+    for (auto& bitstream : bitstreams) {
+        ReadBitstreamToTreeParams args = readParams();
+        directTree->readBitstreamToTree(reinterpret_cast<const unsigned char*>(bitstream.constData()), bitstream.size(),
+                                        args);
+
+        int entitiesRead = 0;
+        QCOMPARE(readAhead(readAheadTree, bitstream, entitiesRead), 0);
+        QCOMPARE(entitiesRead, args.entitiesPerPacket);
+    }
+
+    for (auto& entityID : entityIDs) {
+        EntityItemPointer directEntity = directTree->findEntityByEntityItemID(entityID);
+        EntityItemPointer readAheadEntity = readAheadTree->findEntityByEntityItemID(entityID);
+        QVERIFY(directEntity);
+        QVERIFY(readAheadEntity);
+        QCOMPARE(readAheadEntity->getPosition(), directEntity->getPosition());
+        QCOMPARE(readAheadEntity->getDimensions(), directEntity->getDimensions());
+        QCOMPARE(readAheadEntity->getName(), directEntity->getName());
+    }
+}
+
+void PredecodeBitstreamTests::existingEntitiesTest() {
+    std::vector<EntityItemID> entityIDs;
+    std::vector<QByteArray> bitstreams = encodeTree(createSourceTree(entityIDs));
+
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    int entitiesRead = 0;
+    for (auto& bitstream : bitstreams) {
+        readAhead(tree, bitstream, entitiesRead);
+    }
+
+    // reading the same bitstreams again updates the entities in the tree, the read ahead items go unused
+    for (auto& bitstream : bitstreams) {
+        QCOMPARE(readAhead(tree, bitstream, entitiesRead), entitiesRead);
+    }
+    for (auto& entityID : entityIDs) {
+        QVERIFY(tree->findEntityByEntityItemID(entityID));
+    }
+}
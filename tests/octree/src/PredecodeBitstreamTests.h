@@ -0,0 +1,28 @@
+//
+//  PredecodeBitstreamTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PredecodeBitstreamTests_h
+#define hifi_PredecodeBitstreamTests_h
+
+#include <QtTest/QtTest>
+
+class PredecodeBitstreamTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    // Test that a tree reading the entities it read ahead ends up the same as one reading them directly
+    void newEntitiesTest();
+
+    // Test that entities the tree already has are read from the bitstream and not from the read ahead items
+    void existingEntitiesTest();
+};
+
+#endif // hifi_PredecodeBitstreamTests_h
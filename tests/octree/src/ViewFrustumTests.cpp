@@ -0,0 +1,123 @@
+//
+//  ViewFrustumTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ViewFrustumTests.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <ViewFrustum.h>
+
+QTEST_MAIN(ViewFrustumTests)
+
+using namespace RayIntersectionKernels;
+
+static ViewFrustum makeFrustum(float keyholeRadius) {
+    ViewFrustum frustum;
+    frustum.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    frustum.setOrientation(glm::angleAxis(0.7f, glm::normalize(glm::vec3(0.2f, 1.0f, 0.1f))));
+    frustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                           DEFAULT_NEAR_CLIP, 100.0f));
+    frustum.setKeyholeRadius(keyholeRadius);
+    frustum.calculate();
+    return frustum;
+}
+
+static float randomFloat(float low, float high) {
+    return low + (high - low) * (float)qrand() / (float)RAND_MAX;
+}
+
+static AABox randomBox() {
+    glm::vec3 corner(randomFloat(-120.0f, 120.0f), randomFloat(-120.0f, 120.0f), randomFloat(-120.0f, 120.0f));
+    return AABox(corner, glm::vec3(randomFloat(0.1f, 30.0f), randomFloat(0.1f, 30.0f), randomFloat(0.1f, 30.0f)));
+}
+
+static void checkBatches(const ViewFrustum& frustum) {
+    int counts[3] = { 0, 0, 0 };
+    for (int batchIndex = 0; batchIndex < 500; batchIndex++) {
+        BoxBatch batch;
+        AABox boxes[BOX_BATCH_SIZE];
+        int numBoxes = 1 + qrand() % BOX_BATCH_SIZE;
+        for (int i = 0; i < numBoxes; i++) {
+            boxes[i] = randomBox();
+            batch.add(boxes[i].getMinimumPoint(), boxes[i].getMaximumPoint());
+        }
+
+        ViewFrustum::location locations[BOX_BATCH_SIZE];
+        frustum.boxesInFrustum(batch, ViewFrustum::ALL_PLANES, locations);
+        for (int i = 0; i < numBoxes; i++) {
+            QCOMPARE(locations[i], frustum.boxInFrustum(boxes[i]));
+            counts[locations[i]]++;
+        }
+    }
+    // the boxes should have landed on all sides
+    QVERIFY(counts[ViewFrustum::OUTSIDE] > 0);
+    QVERIFY(counts[ViewFrustum::INTERSECT] > 0);
+    QVERIFY(counts[ViewFrustum::INSIDE] > 0);
+}
+
+void ViewFrustumTests::batchTest() {
+    qsrand(1);
+    checkBatches(makeFrustum(-1.0f));
+}
+
+void ViewFrustumTests::planeMaskTest() {
+    qsrand(2);
+    ViewFrustum frustum = makeFrustum(-1.0f);
+
+    int narrowed = 0;
+    for (int i = 0; i < 2000; i++) {
+        AACube cube(glm::vec3(randomFloat(-80.0f, 80.0f), randomFloat(-80.0f, 80.0f), randomFloat(-80.0f, 80.0f)),
+                    randomFloat(1.0f, 40.0f));
+        ViewFrustum::PlaneMask planeMask = ViewFrustum::ALL_PLANES;
+        ViewFrustum::location location = frustum.cubeInFrustum(cube, planeMask);
+        QCOMPARE(location, frustum.cubeInFrustum(cube));
+        if (location != ViewFrustum::INTERSECT) {
+            continue;
+        }
+        if (planeMask != ViewFrustum::ALL_PLANES) {
+            narrowed++;
+        }
+
+        // the eight children of the cube, like the ones of an octree element
+        BoxBatch children;
+        AACube childCubes[8];
+        float childScale = cube.getScale() / 2.0f;
+        for (int child = 0; child < 8; child++) {
+            glm::vec3 offset((child & 4) ? childScale : 0.0f, (child & 2) ? childScale : 0.0f,
+                             (child & 1) ? childScale : 0.0f);
+            childCubes[child] = AACube(cube.getCorner() + offset, childScale);
+            children.add(childCubes[child].getMinimumPoint(), childCubes[child].getMaximumPoint());
+        }
+        ViewFrustum::location locations[BOX_BATCH_SIZE];
+        frustum.boxesInFrustum(children, planeMask, locations);
+        for (int child = 0; child < 8; child++) {
+            QCOMPARE(locations[child], frustum.cubeInFrustum(childCubes[child]));
+
+            ViewFrustum::PlaneMask childPlaneMask = planeMask;
+            QCOMPARE(frustum.cubeInFrustum(childCubes[child], childPlaneMask), locations[child]);
+            QCOMPARE((int)(childPlaneMask & ~planeMask), 0);
+        }
+    }
+    QVERIFY(narrowed > 0);
+}
+
+void ViewFrustumTests::keyholeBatchTest() {
+    qsrand(3);
+    ViewFrustum frustum = makeFrustum(40.0f);
+    checkBatches(frustum);
+
+    // behind the camera, but in the keyhole
+    AABox behind(frustum.getPosition() - frustum.getDirection() * 5.0f - glm::vec3(0.5f), 1.0f);
+    BoxBatch batch;
+    batch.add(behind.getMinimumPoint(), behind.getMaximumPoint());
+    ViewFrustum::location locations[BOX_BATCH_SIZE];
+    frustum.boxesInFrustum(batch, ViewFrustum::ALL_PLANES, locations);
+    QCOMPARE(locations[0], ViewFrustum::INSIDE);
+}
@@ -0,0 +1,29 @@
+//
+//  ViewFrustumTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ViewFrustumTests_h
+#define hifi_ViewFrustumTests_h
+
+#include <QtTest/QtTest>
+
+class ViewFrustumTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a batch of boxes is located the same as each box on its own
+    void batchTest();
+
+    // Test that the boxes within a box get the same location from the planes the outer box crosses as from all of them
+    void planeMaskTest();
+
+    // Test that a batch counts the boxes in the keyhole as in view
+    void keyholeBatchTest();
+};
+
+#endif // hifi_ViewFrustumTests_h
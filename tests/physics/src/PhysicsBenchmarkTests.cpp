@@ -0,0 +1,231 @@
+//
+//  PhysicsBenchmarkTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PhysicsBenchmarkTests.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include <QCryptographicHash>
+
+#include <EntityEditPacketSender.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <PhysicalEntitySimulation.h>
+#include <PhysicsEngine.h>
+#include <PhysicsHelpers.h>
+#include <ShapeManager.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(PhysicsBenchmarkTests)
+
+const int DEFAULT_NUM_STEPS = 600;
+
+// the generated scene: layers of boxes on a floor, each layer shifted so that the stacks topple
+const int NUM_BOX_COLUMNS = 8;
+const int NUM_BOX_LAYERS = 4;
+const float BOX_SIZE = 1.0f; // meters
+const float BOX_SPACING = 1.1f; // meters
+const float LAYER_SHIFT = 0.2f; // meters
+const glm::vec3 SCENE_ORIGIN(100.0f, 100.0f, 100.0f);
+
+struct BenchmarkResult {
+    int numBodies = 0;
+    int numSteps = 0;
+    quint64 totalTime = 0; // usecs
+    quint64 addObjectsTime = 0;
+    quint64 stepSimulationTime = 0;
+    float updateContactMapTime = 0.0f; // msecs, as Bullet's profiler reports it
+    quint64 handleOutgoingChangesTime = 0;
+    QByteArray stateHash;
+};
+
+static int getNumSteps() {
+    bool ok = false;
+    int numSteps = qgetenv("HIFI_PHYSICS_BENCHMARK_STEPS").toInt(&ok);
+    return (ok && numSteps > 0) ? numSteps : DEFAULT_NUM_STEPS;
+}
+
+static void addGeneratedEntities(EntityTreePointer tree) {
+    uint entityIndex = 0;
+
+    EntityItemProperties floor;
+    floor.setType(EntityTypes::Box);
+    floor.setPosition(SCENE_ORIGIN);
+    floor.setDimensions(glm::vec3(4.0f * NUM_BOX_COLUMNS * BOX_SPACING, BOX_SIZE, 4.0f * NUM_BOX_COLUMNS * BOX_SPACING));
+    tree->addEntity(EntityItemID(QUuid(++entityIndex, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)), floor);
+
+    for (int layer = 0; layer < NUM_BOX_LAYERS; ++layer) {
+        for (int i = 0; i < NUM_BOX_COLUMNS; ++i) {
+            for (int j = 0; j < NUM_BOX_COLUMNS; ++j) {
+                EntityItemProperties box;
+                box.setType(EntityTypes::Box);
+                box.setPosition(SCENE_ORIGIN + glm::vec3(i * BOX_SPACING + layer * LAYER_SHIFT,
+                                                         (layer + 1) * BOX_SPACING, j * BOX_SPACING));
+                box.setDimensions(glm::vec3(BOX_SIZE));
+                box.setCollisionsWillMove(true);
+                box.setGravity(glm::vec3(0.0f, -9.8f, 0.0f));
+                tree->addEntity(EntityItemID(QUuid(++entityIndex, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)), box);
+            }
+        }
+    }
+}
+
+// the insertion order of the bodies decides the order in which Bullet solves them
+static void sortByID(VectorOfMotionStates& motionStates) {
+    std::sort(motionStates.begin(), motionStates.end(), [](ObjectMotionState* a, ObjectMotionState* b) {
+        return a->getObjectID() < b->getObjectID();
+    });
+}
+
+// \return the total time of the profile nodes called name, below the current node of iterator
+static float getProfileTime(CProfileIterator* iterator, const char* name) {
+    float time = 0.0f;
+    int numChildren = 0;
+    for (iterator->First(); !iterator->Is_Done(); iterator->Next()) {
+        ++numChildren;
+    }
+    for (int i = 0; i < numChildren; ++i) {
+        iterator->First();
+        for (int j = 0; j < i; ++j) {
+            iterator->Next();
+        }
+        if (strcmp(iterator->Get_Current_Name(), name) == 0) {
+            time += iterator->Get_Current_Total_Time();
+        } else {
+            iterator->Enter_Child(i);
+            time += getProfileTime(iterator, name);
+            iterator->Enter_Parent();
+        }
+    }
+    return time;
+}
+
+static QByteArray hashStates(const VectorOfMotionStates& motionStates) {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    foreach (ObjectMotionState* motionState, motionStates) {
+        glm::vec3 position = motionState->getObjectPosition();
+        glm::quat rotation = motionState->getObjectRotation();
+        glm::vec3 velocity = motionState->getObjectLinearVelocity();
+        glm::vec3 angularVelocity = motionState->getObjectAngularVelocity();
+        hash.addData(reinterpret_cast<const char*>(&position), sizeof(position));
+        hash.addData(reinterpret_cast<const char*>(&rotation), sizeof(rotation));
+        hash.addData(reinterpret_cast<const char*>(&velocity), sizeof(velocity));
+        hash.addData(reinterpret_cast<const char*>(&angularVelocity), sizeof(angularVelocity));
+    }
+    return hash.result().toHex();
+}
+
+// runs the frames the way Application::update does, with one fixed substep each
+static BenchmarkResult runBenchmark(int numSteps) {
+    BenchmarkResult result;
+
+    ShapeManager shapeManager;
+    shapeManager.setBuildInBackground(false);
+    ObjectMotionState::setShapeManager(&shapeManager);
+
+    PhysicsEnginePointer engine = std::make_shared<PhysicsEngine>(glm::vec3(0.0f));
+    engine->init();
+
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    EntityEditPacketSender packetSender;
+    PhysicalEntitySimulation simulation;
+    simulation.init(tree, engine, &packetSender);
+    tree->setSimulation(&simulation);
+
+    QString fileName = qgetenv("HIFI_PHYSICS_BENCHMARK_FILE");
+    if (fileName.isEmpty()) {
+        addGeneratedEntities(tree);
+    } else if (!tree->readFromFile(qPrintable(fileName))) {
+        qWarning() << "Could not read entities from" << fileName;
+    }
+
+    VectorOfMotionStates bodies;
+    VectorOfMotionStates motionStates;
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < numSteps; ++i) {
+        simulation.getObjectsToDelete(motionStates);
+        engine->deleteObjects(motionStates);
+
+        quint64 phaseStart = usecTimestampNow();
+        tree->withWriteLock([&] {
+            simulation.getObjectsToAdd(motionStates);
+            sortByID(motionStates);
+            engine->addObjects(motionStates);
+        });
+        result.addObjectsTime += usecTimestampNow() - phaseStart;
+        bodies << motionStates;
+
+        tree->withWriteLock([&] {
+            simulation.getObjectsToChange(motionStates);
+            sortByID(motionStates);
+            VectorOfMotionStates stillNeedChange = engine->changeObjects(motionStates);
+            simulation.setObjectsToChange(stillNeedChange);
+        });
+        simulation.applyActionChanges();
+
+        phaseStart = usecTimestampNow();
+        tree->withWriteLock([&] {
+            engine->stepSimulation(PHYSICS_ENGINE_FIXED_SUBSTEP);
+        });
+        result.stepSimulationTime += usecTimestampNow() - phaseStart;
+
+        CProfileIterator* iterator = CProfileManager::Get_Iterator();
+        result.updateContactMapTime += getProfileTime(iterator, "updateContactMap");
+        CProfileManager::Release_Iterator(iterator);
+
+        if (engine->hasOutgoingChanges()) {
+            phaseStart = usecTimestampNow();
+            tree->withWriteLock([&] {
+                simulation.handleOutgoingChanges(engine->getOutgoingChanges(), engine->getSessionID());
+            });
+            result.handleOutgoingChangesTime += usecTimestampNow() - phaseStart;
+
+            simulation.handleCollisionEvents(engine->getCollisionEvents());
+            tree->update();
+        }
+    }
+    result.totalTime = usecTimestampNow() - start;
+    result.numSteps = numSteps;
+    result.numBodies = bodies.size();
+
+    tree->withReadLock([&] {
+        sortByID(bodies);
+        result.stateHash = hashStates(bodies);
+    });
+
+    // removes the bodies from the engine before it goes away
+    tree->setSimulation(nullptr);
+    return result;
+}
+
+void PhysicsBenchmarkTests::benchmarkSimulation() {
+    BenchmarkResult result = runBenchmark(getNumSteps());
+    QVERIFY(result.numBodies > 0);
+
+    float seconds = (float)result.totalTime / (float)USECS_PER_SECOND;
+    float numSteps = (float)result.numSteps;
+    qDebug() << "bodies:" << result.numBodies << "steps:" << result.numSteps;
+    qDebug() << "steps per second:" << (seconds > 0.0f ? numSteps / seconds : 0.0f);
+    qDebug() << "usecs per step -- addObjects:" << (float)result.addObjectsTime / numSteps
+        << "stepSimulation:" << (float)result.stepSimulationTime / numSteps
+        << "updateContactMap:" << (float)USECS_PER_MSEC * result.updateContactMapTime / numSteps
+        << "handleOutgoingChanges:" << (float)result.handleOutgoingChangesTime / numSteps;
+    qDebug() << "state hash:" << result.stateHash;
+}
+
+void PhysicsBenchmarkTests::testDeterminism() {
+    const int NUM_STEPS = 200;
+    BenchmarkResult firstRun = runBenchmark(NUM_STEPS);
+    BenchmarkResult secondRun = runBenchmark(NUM_STEPS);
+    QCOMPARE(firstRun.numBodies, secondRun.numBodies);
+    QCOMPARE(firstRun.stateHash, secondRun.stateHash);
+}
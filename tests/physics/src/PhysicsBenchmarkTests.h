@@ -0,0 +1,32 @@
+//
+//  PhysicsBenchmarkTests.h
+//  tests/physics/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsBenchmarkTests_h
+#define hifi_PhysicsBenchmarkTests_h
+
+#include <QtTest/QtTest>
+
+// Runs the entities of a saved entity tree through PhysicalEntitySimulation and PhysicsEngine the way the interface
+// does, one fixed substep per frame, and reports steps per second, the time of each phase and a hash of the final
+// states of the bodies.
+//
+// HIFI_PHYSICS_BENCHMARK_FILE names the entity file to load (a generated stack of boxes by default), and
+// HIFI_PHYSICS_BENCHMARK_STEPS the number of steps.
+class PhysicsBenchmarkTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void benchmarkSimulation();
+
+    // Test that two runs of the same entities end in the same states
+    void testDeterminism();
+};
+
+#endif // hifi_PhysicsBenchmarkTests_h
@@ -0,0 +1,44 @@
+//
+//  PhysicsThreadPoolTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PhysicsThreadPoolTests.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include <PhysicsThreadPool.h>
+
+QTEST_MAIN(PhysicsThreadPoolTests)
+
+void PhysicsThreadPoolTests::testRunsEachTaskOnce() {
+    PhysicsThreadPool pool;
+    QCOMPARE(pool.getNumThreads(), 1);
+
+    const int NUM_RUNS = 1000;
+    const int threadCounts[] = { 1, 4, 2, MAX_PHYSICS_THREADS + 1 };
+    for (int numThreads : threadCounts) {
+        pool.setNumThreads(numThreads);
+        int expectedThreads = std::min(numThreads, MAX_PHYSICS_THREADS);
+        QCOMPARE(pool.getNumThreads(), expectedThreads);
+
+        std::vector<std::atomic<int>> runs(expectedThreads);
+        for (auto& count : runs) {
+            count = 0;
+        }
+        for (int i = 0; i < NUM_RUNS; ++i) {
+            pool.run([&](int index) {
+                ++runs[index];
+            });
+        }
+        for (auto& count : runs) {
+            QCOMPARE(count.load(), NUM_RUNS);
+        }
+    }
+}
@@ -0,0 +1,24 @@
+//
+//  PhysicsThreadPoolTests.h
+//  tests/physics/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsThreadPoolTests_h
+#define hifi_PhysicsThreadPoolTests_h
+
+#include <QtTest/QtTest>
+
+class PhysicsThreadPoolTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    // Test that each thread runs its task once for each run, also after the number of threads changes
+    void testRunsEachTaskOnce();
+};
+
+#endif // hifi_PhysicsThreadPoolTests_h
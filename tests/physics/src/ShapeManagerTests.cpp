@@ -10,6 +10,9 @@
 //
 
 #include <iostream>
+
+#include <QThreadPool>
+
 #include <ShapeManager.h>
 #include <StreamUtils.h>
 
@@ -183,3 +186,44 @@ void ShapeManagerTests::addCapsuleShape() {
     QCOMPARE(shape, otherShape);
     */
 }
+
+void ShapeManagerTests::buildHullShapeInBackground() {
+    // the corners of a cube, and many points inside it
+    QVector<glm::vec3> points;
+    for (int i = 0; i < 8; ++i) {
+        points.push_back(glm::vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f));
+    }
+    const int NUM_INSIDE_POINTS = 500;
+    for (int i = 0; i < NUM_INSIDE_POINTS; ++i) {
+        float t = (float)i / (float)NUM_INSIDE_POINTS;
+        points.push_back(glm::vec3(0.9f * t, 0.5f - 0.8f * t, 0.3f * t - 0.2f));
+    }
+    QVector<QVector<glm::vec3>> hulls;
+    hulls.push_back(points);
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_COMPOUND, glm::vec3(1.0f));
+    info.setConvexHulls(hulls);
+
+    ShapeManager shapeManager;
+    btCollisionShape* placeholder = shapeManager.getShape(info);
+    QCOMPARE(placeholder != nullptr, true);
+    QCOMPARE(shapeManager.getNumPlaceholders(), 1);
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+    QCOMPARE(shapeManager.getShape(info), placeholder);
+
+    QThreadPool::globalInstance()->waitForDone();
+    QCOMPARE(shapeManager.collectBuiltShapes(), true);
+    QCOMPARE(shapeManager.isOutdatedPlaceholder(placeholder), true);
+
+    // only the corners are left in the hull
+    btCollisionShape* shape = shapeManager.getShape(info);
+    QCOMPARE(shape != placeholder, true);
+    QCOMPARE(shape->getShapeType(), (int)CONVEX_HULL_SHAPE_PROXYTYPE);
+    QCOMPARE(static_cast<btConvexHullShape*>(shape)->getNumPoints(), 8);
+
+    // the placeholder goes away with its last reference
+    QCOMPARE(shapeManager.releaseShape(placeholder), true);
+    QCOMPARE(shapeManager.releaseShape(placeholder), true);
+    QCOMPARE(shapeManager.getNumPlaceholders(), 0);
+    QCOMPARE(shapeManager.getNumShapes(), 1);
+}
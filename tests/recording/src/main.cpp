@@ -1,5 +1,13 @@
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
 #include <QtGlobal>
 #include <QtTest/QtTest>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtCore/QTemporaryFile>
 #include <QtCore/QString>
 
@@ -9,6 +17,7 @@
 
 #include <recording/Clip.h>
 #include <recording/Frame.h>
+#include <recording/impl/DeltaFrameCodec.h>
 
 #include "Constants.h"
 
@@ -79,6 +88,41 @@ void testFilePersist() {
     QVERIFY(readClip->duration() == 5.0f);
 }
 
+void testFileIndex() {
+    QTemporaryFile file;
+    QString fileName;
+    if (file.open()) {
+        fileName = file.fileName();
+        file.close();
+    }
+
+    // enough frames for the index to take more than one index frame
+    const int FRAME_COUNT = 10000;
+    const Time FRAME_INTERVAL = 16;
+    auto writeClip = Clip::newClip();
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        writeClip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)(i * FRAME_INTERVAL), QByteArray(i % 50, 'a' + i % 26)));
+    }
+    Clip::toFile(fileName, writeClip);
+
+    auto readClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() == FRAME_COUNT);
+    QVERIFY(readClip->duration() == (FRAME_COUNT - 1) * FRAME_INTERVAL);
+
+    const int SEEK_FRAME = 7777;
+    readClip->seek(SEEK_FRAME * FRAME_INTERVAL - 1);
+    QVERIFY(readClip->position() == SEEK_FRAME * FRAME_INTERVAL);
+    for (int i = SEEK_FRAME; i < FRAME_COUNT; ++i) {
+        auto readFrame = readClip->nextFrame();
+        QVERIFY(readFrame);
+        QVERIFY(readFrame->type == TEST_FRAME_TYPE);
+        QVERIFY(readFrame->timeOffset == i * FRAME_INTERVAL);
+        QVERIFY(readFrame->data == QByteArray(i % 50, 'a' + i % 26));
+    }
+    QVERIFY(!readClip->nextFrame());
+}
+
 void testClipOrdering() {
     auto writeClip = Clip::newClip();
     // simulate our of order addition of frames
@@ -97,6 +141,84 @@ void testClipOrdering() {
     Q_UNUSED(lastFrameTimeOffset); // FIXME - Unix build not yet upgraded to Qt 5.5.1 we can remove this once it is
 }
 
+// a frame shaped like a recorded avatar, binary JSON with a rotation for each joint, moving a little every frame
+QByteArray makeAvatarLikeFrame(int frame) {
+    const int NUM_JOINTS = 60;
+    QJsonArray joints;
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        float angle = 0.01f * frame + 0.1f * i;
+        QJsonArray rotation;
+        rotation.push_back(0.0f);
+        rotation.push_back(sinf(angle * 0.5f));
+        rotation.push_back(0.0f);
+        rotation.push_back(cosf(angle * 0.5f));
+        QJsonObject joint;
+        joint["rotation"] = rotation;
+        joint["rotationSet"] = true;
+        joints.push_back(joint);
+    }
+    QJsonObject root;
+    root["displayName"] = QString("Benchmark");
+    root["jointArray"] = joints;
+    return QJsonDocument(root).toBinaryData();
+}
+
+void benchmarkFrameCodec() {
+    // HIFI_RECORDING_BENCHMARK_FRAMES sets how many 60 Hz frames are encoded, one minute of them by default
+    const int DEFAULT_FRAMES = 60 * 60;
+    bool ok = false;
+    int numFrames = qgetenv("HIFI_RECORDING_BENCHMARK_FRAMES").toInt(&ok);
+    if (!ok || numFrames <= 0) {
+        numFrames = DEFAULT_FRAMES;
+    }
+    const float FRAMES_PER_SECOND = 60.0f;
+
+    std::vector<QByteArray> frames;
+    frames.reserve(numFrames);
+    for (int i = 0; i < numFrames; ++i) {
+        frames.push_back(makeAvatarLikeFrame(i));
+    }
+
+    std::vector<QByteArray> encodedFrames(numFrames);
+    std::vector<int> keyFrameIndices(numFrames);
+    size_t rawBytes = 0;
+    size_t encodedBytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    int keyFrameIndex = 0;
+    int framesSinceKeyFrame = DeltaFrameCodec::KEY_FRAME_INTERVAL;
+    for (int i = 0; i < numFrames; ++i) {
+        if (framesSinceKeyFrame < DeltaFrameCodec::KEY_FRAME_INTERVAL &&
+            DeltaFrameCodec::encodeDelta(frames[keyFrameIndex], frames[i], encodedFrames[i])) {
+            ++framesSinceKeyFrame;
+        } else {
+            DeltaFrameCodec::encodeKeyFrame(frames[i], encodedFrames[i]);
+            keyFrameIndex = i;
+            framesSinceKeyFrame = 0;
+        }
+        keyFrameIndices[i] = keyFrameIndex;
+        rawBytes += frames[i].size();
+        encodedBytes += encodedFrames[i].size();
+    }
+    qint64 encodeNsecs = timer.nsecsElapsed();
+
+    timer.restart();
+    QByteArray decoded;
+    for (int i = 0; i < numFrames; ++i) {
+        DeltaFrameCodec::decode(frames[keyFrameIndices[i]], encodedFrames[i].constData(), encodedFrames[i].size(), decoded);
+        Q_ASSERT(decoded == frames[i]);
+    }
+    qint64 decodeNsecs = timer.nsecsElapsed();
+
+    float seconds = numFrames / FRAMES_PER_SECOND;
+    qDebug() << "Frame codec over" << numFrames << "frames:"
+        << "raw" << (rawBytes / seconds) << "bytes/s,"
+        << "encoded" << (encodedBytes / seconds) << "bytes/s,"
+        << "ratio" << ((float)encodedBytes / (float)rawBytes);
+    qDebug() << "    encode" << (rawBytes * 1000.0 / (double)std::max(encodeNsecs, (qint64)1)) << "MB/s,"
+        << "decode" << (rawBytes * 1000.0 / (double)std::max(decodeNsecs, (qint64)1)) << "MB/s";
+}
+
 #ifdef Q_OS_WIN32
 void myMessageHandler(QtMsgType type, const QMessageLogContext & context, const QString & msg) {
     OutputDebugStringA(msg.toLocal8Bit().toStdString().c_str());
@@ -110,5 +232,7 @@ int main(int, const char**) {
 #endif
     testFrameTypeRegistration();
     testFilePersist();
+    testFileIndex();
     testClipOrdering();
+    benchmarkFrameCodec();
 }
\ No newline at end of file
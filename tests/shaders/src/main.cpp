@@ -82,6 +82,7 @@
 #include "gaussian_blur_horizontal_vert.h"
 #include "gaussian_blur_frag.h"
 #include "occlusion_blend_frag.h"
+#include "occlusion_temporal_frag.h"
 
 #include "hit_effect_vert.h"
 #include "hit_effect_frag.h"
@@ -234,6 +235,7 @@ void QTestWindow::draw() {
         testShaderBuild(gaussian_blur_horizontal_vert, gaussian_blur_frag);
         testShaderBuild(ambient_occlusion_vert, ambient_occlusion_frag);
         testShaderBuild(ambient_occlusion_vert, occlusion_blend_frag);
+        testShaderBuild(ambient_occlusion_vert, occlusion_temporal_frag);
         
         testShaderBuild(hit_effect_vert, hit_effect_frag);
 
@@ -0,0 +1,80 @@
+//
+//  BlockCompressionTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlockCompressionTests.h"
+
+#include <BlockCompression.h>
+
+QTEST_MAIN(BlockCompressionTests)
+
+using namespace BlockCompression;
+
+// the largest difference between the pixels over the given channels
+static int maxDifference(const QVector<QRgb>& pixels, const QVector<QRgb>& decoded, bool colors, bool alpha) {
+    int difference = 0;
+    for (int i = 0; i < pixels.size(); i++) {
+        if (colors) {
+            difference = std::max(difference, std::abs(qRed(pixels[i]) - qRed(decoded[i])));
+            difference = std::max(difference, std::abs(qGreen(pixels[i]) - qGreen(decoded[i])));
+            difference = std::max(difference, std::abs(qBlue(pixels[i]) - qBlue(decoded[i])));
+        }
+        if (alpha) {
+            difference = std::max(difference, std::abs(qAlpha(pixels[i]) - qAlpha(decoded[i])));
+        }
+    }
+    return difference;
+}
+
+void BlockCompressionTests::flatColorTest() {
+    QVector<QRgb> pixels(16, qRgb(10, 200, 30));
+    for (auto format : { BC1, BC3 }) {
+        QVector<QRgb> decoded = decompress(format, compress(format, pixels.data(), 4, 4, 4), 4, 4);
+        QVERIFY(maxDifference(pixels, decoded, true, false) <= 4);
+        QCOMPARE(qAlpha(decoded[0]), 255);
+    }
+}
+
+void BlockCompressionTests::gradientTest() {
+    const int WIDTH = 37;
+    const int HEIGHT = 23;
+    QVector<QRgb> pixels(WIDTH * HEIGHT);
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            pixels[y * WIDTH + x] = qRgba(x * 255 / WIDTH, y * 255 / HEIGHT, 128, (x + y) * 255 / (WIDTH + HEIGHT));
+        }
+    }
+
+    // the colors interpolate between endpoints of 5 and 6 bits, the single channels between 8 bit ones
+    const int MAX_COLOR_DIFFERENCE = 16;
+    const int MAX_CHANNEL_DIFFERENCE = 2;
+
+    QVector<QRgb> decoded = decompress(BC1, compress(BC1, pixels.data(), WIDTH, HEIGHT, WIDTH), WIDTH, HEIGHT);
+    QVERIFY(maxDifference(pixels, decoded, true, false) <= MAX_COLOR_DIFFERENCE);
+
+    decoded = decompress(BC3, compress(BC3, pixels.data(), WIDTH, HEIGHT, WIDTH), WIDTH, HEIGHT);
+    QVERIFY(maxDifference(pixels, decoded, true, false) <= MAX_COLOR_DIFFERENCE);
+    QVERIFY(maxDifference(pixels, decoded, false, true) <= MAX_CHANNEL_DIFFERENCE);
+
+    decoded = decompress(BC5, compress(BC5, pixels.data(), WIDTH, HEIGHT, WIDTH), WIDTH, HEIGHT);
+    for (int i = 0; i < pixels.size(); i++) {
+        QVERIFY(std::abs(qRed(pixels[i]) - qRed(decoded[i])) <= MAX_CHANNEL_DIFFERENCE);
+        QVERIFY(std::abs(qGreen(pixels[i]) - qGreen(decoded[i])) <= MAX_CHANNEL_DIFFERENCE);
+    }
+}
+
+void BlockCompressionTests::compressedSizeTest() {
+    QCOMPARE(evalCompressedSize(BC1, 4, 4), 8);
+    QCOMPARE(evalCompressedSize(BC3, 4, 4), 16);
+    QCOMPARE(evalCompressedSize(BC5, 1, 1), 16);
+    QCOMPARE(evalCompressedSize(BC1, 37, 23), 10 * 6 * 8);
+
+    QVector<QRgb> pixels(37 * 23, qRgb(0, 0, 0));
+    QCOMPARE(compress(BC3, pixels.data(), 37, 23, 37).size(), evalCompressedSize(BC3, 37, 23));
+}
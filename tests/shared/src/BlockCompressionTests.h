@@ -0,0 +1,29 @@
+//
+//  BlockCompressionTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BlockCompressionTests_h
+#define hifi_BlockCompressionTests_h
+
+#include <QtTest/QtTest>
+
+class BlockCompressionTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a flat color comes back within the precision of the 565 endpoints
+    void flatColorTest();
+
+    // Test that smooth gradients come back close, in all the formats, on an image not a multiple of the blocks
+    void gradientTest();
+
+    // Test the number of bytes of the blocks
+    void compressedSizeTest();
+};
+
+#endif // hifi_BlockCompressionTests_h
@@ -0,0 +1,81 @@
+//
+//  DependencyManagerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DependencyManagerTests.h"
+
+#include <DependencyManager.h>
+
+QTEST_MAIN(DependencyManagerTests)
+
+class TestDependency : public Dependency {
+    SINGLETON_DEPENDENCY
+public:
+    TestDependency(int value = 0) : value(value) { }
+    int value;
+};
+
+class OtherTestDependency : public Dependency {
+    SINGLETON_DEPENDENCY
+};
+
+class BaseTestDependency : public Dependency {
+    SINGLETON_DEPENDENCY
+public:
+    virtual int getValue() const { return 1; }
+};
+
+class DerivedTestDependency : public BaseTestDependency {
+    SINGLETON_DEPENDENCY
+public:
+    virtual int getValue() const { return 2; }
+};
+
+void DependencyManagerTests::getRawTest() {
+    auto instance = DependencyManager::set<TestDependency>(1);
+    QCOMPARE(DependencyManager::getRaw<TestDependency>(), instance.data());
+    QCOMPARE(DependencyManager::get<TestDependency>().data(), instance.data());
+    DependencyManager::destroy<TestDependency>();
+}
+
+void DependencyManagerTests::setAgainTest() {
+    DependencyManager::set<TestDependency>(1);
+    QCOMPARE(DependencyManager::getRaw<TestDependency>()->value, 1);
+
+    // setting another type doesn't change the instance
+    DependencyManager::set<OtherTestDependency>();
+    QCOMPARE(DependencyManager::getRaw<TestDependency>()->value, 1);
+
+    auto instance = DependencyManager::set<TestDependency>(2);
+    QCOMPARE(DependencyManager::getRaw<TestDependency>(), instance.data());
+    QCOMPARE(DependencyManager::getRaw<TestDependency>()->value, 2);
+
+    DependencyManager::destroy<TestDependency>();
+    DependencyManager::destroy<OtherTestDependency>();
+}
+
+void DependencyManagerTests::destroyTest() {
+    DependencyManager::set<TestDependency>();
+    QVERIFY(DependencyManager::getRaw<TestDependency>() != nullptr);
+
+    DependencyManager::destroy<TestDependency>();
+    QVERIFY(DependencyManager::getRaw<TestDependency>() == nullptr);
+    QVERIFY(DependencyManager::get<TestDependency>().isNull());
+}
+
+void DependencyManagerTests::inheritanceTest() {
+    DependencyManager::registerInheritance<BaseTestDependency, DerivedTestDependency>();
+    auto instance = DependencyManager::set<DerivedTestDependency>();
+
+    QCOMPARE(DependencyManager::getRaw<BaseTestDependency>(), static_cast<BaseTestDependency*>(instance.data()));
+    QCOMPARE(DependencyManager::getRaw<BaseTestDependency>()->getValue(), 2);
+
+    DependencyManager::destroy<DerivedTestDependency>();
+    QVERIFY(DependencyManager::getRaw<BaseTestDependency>() == nullptr);
+}
@@ -0,0 +1,47 @@
+//
+//  KTXTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "KTXTests.h"
+
+#include <KTX.h>
+
+QTEST_MAIN(KTXTests)
+
+static KTX::Image makeImage() {
+    KTX::Image image;
+    image.glInternalFormat = 0x83F0; // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    image.glBaseInternalFormat = 0x1907; // GL_RGB
+    image.width = 5;
+    image.height = 3;
+    image.mips.push_back(QByteArray(16, 'a'));
+    image.mips.push_back(QByteArray(6, 'b'));
+    image.mips.push_back(QByteArray(8, 'c'));
+    return image;
+}
+
+void KTXTests::roundTripTest() {
+    KTX::Image image = makeImage();
+    KTX::Image result;
+    QVERIFY(KTX::read(KTX::write(image), result));
+
+    QCOMPARE(result.glInternalFormat, image.glInternalFormat);
+    QCOMPARE(result.glBaseInternalFormat, image.glBaseInternalFormat);
+    QCOMPARE(result.width, image.width);
+    QCOMPARE(result.height, image.height);
+    QCOMPARE(result.mips, image.mips);
+}
+
+void KTXTests::invalidDataTest() {
+    QByteArray data = KTX::write(makeImage());
+    KTX::Image result;
+    QVERIFY(!KTX::read(data.left(data.size() - 4), result));
+    QVERIFY(!KTX::read(data.left(20), result));
+    QVERIFY(!KTX::read(QByteArray(data.size(), 'x'), result));
+}
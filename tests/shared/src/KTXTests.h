@@ -0,0 +1,26 @@
+//
+//  KTXTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_KTXTests_h
+#define hifi_KTXTests_h
+
+#include <QtTest/QtTest>
+
+class KTXTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the header and mips read back as written, with mips not a multiple of 4 bytes
+    void roundTripTest();
+
+    // Test that truncated and foreign data get rejected
+    void invalidDataTest();
+};
+
+#endif // hifi_KTXTests_h
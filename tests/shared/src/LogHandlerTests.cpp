@@ -0,0 +1,64 @@
+//
+//  LogHandlerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LogHandlerTests.h"
+
+#include <LogHandler.h>
+
+QTEST_MAIN(LogHandlerTests)
+
+void LogHandlerTests::repeatedMessageTest() {
+    LogHandler& logHandler = LogHandler::getInstance();
+    logHandler.addRepeatedMessageRegex("^Repeated message [0-9]+");
+
+    QMessageLogContext context(nullptr, 0, nullptr, "repeated");
+    QVERIFY(!logHandler.printMessage(LogDebug, context, "Repeated message 1").isEmpty());
+    QVERIFY(logHandler.printMessage(LogDebug, context, "Repeated message 2").isEmpty());
+    QVERIFY(logHandler.printMessage(LogDebug, context, "Repeated message 3").isEmpty());
+
+    // warnings are never folded into the repeats
+    QVERIFY(!logHandler.printMessage(LogWarning, context, "Repeated message 4").isEmpty());
+    QVERIFY(!logHandler.printMessage(LogDebug, context, "Another message").isEmpty());
+    logHandler.flush();
+}
+
+void LogHandlerTests::onlyOnceMessageTest() {
+    LogHandler& logHandler = LogHandler::getInstance();
+    logHandler.addOnlyOnceMessageRegex("^Once message");
+
+    QMessageLogContext context(nullptr, 0, nullptr, "once");
+    QVERIFY(!logHandler.printMessage(LogDebug, context, "Once message A").isEmpty());
+    QVERIFY(logHandler.printMessage(LogDebug, context, "Once message A").isEmpty());
+    QVERIFY(!logHandler.printMessage(LogDebug, context, "Once message B").isEmpty());
+    logHandler.flush();
+}
+
+void LogHandlerTests::rateLimitTest() {
+    LogHandler& logHandler = LogHandler::getInstance();
+
+    QMessageLogContext context(nullptr, 0, nullptr, "rate");
+    QMessageLogContext otherContext(nullptr, 0, nullptr, "other rate");
+
+    // the messages go out within a second or two, so at most two seconds worth are printed
+    const int NUM_MESSAGES = 3 * MAX_LOG_MESSAGES_PER_CATEGORY_PER_SECOND;
+    int numPrinted = 0;
+    for (int i = 0; i < NUM_MESSAGES; ++i) {
+        if (!logHandler.printMessage(LogWarning, context, QString("Rate message %1").arg(i)).isEmpty()) {
+            ++numPrinted;
+        }
+    }
+    QVERIFY(numPrinted >= MAX_LOG_MESSAGES_PER_CATEGORY_PER_SECOND);
+    QVERIFY(numPrinted <= 2 * MAX_LOG_MESSAGES_PER_CATEGORY_PER_SECOND);
+
+    // other categories and critical messages still get through
+    QVERIFY(!logHandler.printMessage(LogWarning, otherContext, "Other rate message").isEmpty());
+    QVERIFY(!logHandler.printMessage(LogCritical, context, "Critical rate message").isEmpty());
+    logHandler.flush();
+}
@@ -0,0 +1,111 @@
+//
+//  MPSCQueueTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MPSCQueueTests.h"
+
+#include <thread>
+#include <vector>
+
+#include <MPSCQueue.h>
+
+QTEST_MAIN(MPSCQueueTests)
+
+void MPSCQueueTests::orderTest() {
+    MPSCQueue<int> queue;
+    QVERIFY(queue.isEmpty());
+    for (int i = 0; i < 100; i++) {
+        queue.push(i);
+    }
+    QVERIFY(!queue.isEmpty());
+
+    std::vector<int> items;
+    QCOMPARE(queue.drain(items), 100);
+    QVERIFY(queue.isEmpty());
+    for (int i = 0; i < 100; i++) {
+        QCOMPARE(items[i], i);
+    }
+    QCOMPARE(queue.drain(items), 0);
+}
+
+void MPSCQueueTests::batchTest() {
+    MPSCQueue<int> queue;
+    for (int i = 0; i < 10; i++) {
+        queue.push(i);
+    }
+
+    // items pushed between batches come after the ones left from the last one
+    std::vector<int> items;
+    QCOMPARE(queue.drain(items, 4), 4);
+    queue.push(10);
+    QCOMPARE(queue.drain(items, 4), 4);
+    QCOMPARE(queue.drain(items), 3);
+    for (int i = 0; i <= 10; i++) {
+        QCOMPARE(items[i], i);
+    }
+    QVERIFY(queue.isEmpty());
+}
+
+void MPSCQueueTests::producersTest() {
+    const int PRODUCER_COUNT = 4;
+    const int ITEMS_PER_PRODUCER = 20000;
+    MPSCQueue<int> queue;
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < PRODUCER_COUNT; producer++) {
+        producers.emplace_back([&queue, producer, ITEMS_PER_PRODUCER] {
+            for (int i = 0; i < ITEMS_PER_PRODUCER; i++) {
+                queue.push(producer * ITEMS_PER_PRODUCER + i);
+            }
+        });
+    }
+
+    // every item comes out once, and in order with the others of its producer
+    std::vector<int> items;
+    std::vector<int> nextItems(PRODUCER_COUNT, 0);
+    int drainedCount = 0;
+    while (drainedCount < PRODUCER_COUNT * ITEMS_PER_PRODUCER) {
+        items.clear();
+        drainedCount += queue.drain(items, 1000);
+        for (int item : items) {
+            int producer = item / ITEMS_PER_PRODUCER;
+            QCOMPARE(item % ITEMS_PER_PRODUCER, nextItems[producer]);
+            nextItems[producer]++;
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    QVERIFY(queue.isEmpty());
+}
+
+void MPSCQueueTests::parkerTest() {
+    const int ITEM_COUNT = 1000;
+    MPSCQueue<int> queue;
+    ConsumerParker parker;
+
+    // a consumer that parks without a timeout still sees every item
+    std::thread producer([&] {
+        for (int i = 0; i < ITEM_COUNT; i++) {
+            queue.push(i);
+            parker.notify();
+            if (i % 100 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<int> items;
+    while ((int)items.size() < ITEM_COUNT) {
+        QVERIFY(parker.wait([&] { return !queue.isEmpty(); }, 0, ULONG_MAX));
+        queue.drain(items);
+    }
+    producer.join();
+    QCOMPARE((int)items.size(), ITEM_COUNT);
+}
@@ -0,0 +1,26 @@
+//
+//  MPSCQueueTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MPSCQueueTests_h
+#define hifi_MPSCQueueTests_h
+
+#include <QtTest/QtTest>
+
+class MPSCQueueTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void orderTest();
+    void batchTest();
+    void producersTest();
+    void parkerTest();
+};
+
+#endif // hifi_MPSCQueueTests_h
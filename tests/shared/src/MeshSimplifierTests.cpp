@@ -0,0 +1,169 @@
+//
+//  MeshSimplifierTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MeshSimplifierTests.h"
+
+#include <QSet>
+
+#include <MeshSimplifier.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(MeshSimplifierTests)
+
+static const QVector<float> RATIOS = { 0.5f, 0.25f };
+
+// a grid of size by size quads in the xy plane, split along x > size / 2 into two parts when split is set
+static void makeGrid(int size, bool split, QVector<glm::vec3>& vertices, QVector<QVector<int>>& partIndices) {
+    for (int i = 0; i <= size; ++i) {
+        for (int j = 0; j <= size; ++j) {
+            vertices.push_back(glm::vec3((float)i, (float)j, 0.0f));
+        }
+    }
+    partIndices.resize(split ? 2 : 1);
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            int corner = i * (size + 1) + j;
+            QVector<int>& indices = partIndices[(split && i >= size / 2) ? 1 : 0];
+            indices << corner << corner + size + 1 << corner + 1;
+            indices << corner + 1 << corner + size + 1 << corner + size + 2;
+        }
+    }
+}
+
+// a unit sphere of rings by segments quads, the poles closing it
+static void makeSphere(int rings, int segments, QVector<glm::vec3>& vertices, QVector<QVector<int>>& partIndices) {
+    vertices.push_back(glm::vec3(0.0f, 0.0f, 1.0f));
+    for (int ring = 1; ring < rings; ++ring) {
+        float theta = PI * ring / rings;
+        for (int segment = 0; segment < segments; ++segment) {
+            float phi = TWO_PI * segment / segments;
+            vertices.push_back(glm::vec3(sinf(theta) * cosf(phi), sinf(theta) * sinf(phi), cosf(theta)));
+        }
+    }
+    vertices.push_back(glm::vec3(0.0f, 0.0f, -1.0f));
+    int southPole = vertices.size() - 1;
+    auto index = [&](int ring, int segment) { return 1 + (ring - 1) * segments + segment % segments; };
+
+    partIndices.resize(1);
+    QVector<int>& indices = partIndices[0];
+    for (int segment = 0; segment < segments; ++segment) {
+        indices << 0 << index(1, segment) << index(1, segment + 1);
+        indices << index(rings - 1, segment) << southPole << index(rings - 1, segment + 1);
+    }
+    for (int ring = 1; ring < rings - 1; ++ring) {
+        for (int segment = 0; segment < segments; ++segment) {
+            indices << index(ring, segment) << index(ring + 1, segment) << index(ring + 1, segment + 1);
+            indices << index(ring, segment) << index(ring + 1, segment + 1) << index(ring, segment + 1);
+        }
+    }
+}
+
+static int countTriangles(const QVector<QVector<int>>& partIndices) {
+    int numTriangles = 0;
+    foreach (const QVector<int>& indices, partIndices) {
+        numTriangles += indices.size() / 3;
+    }
+    return numTriangles;
+}
+
+static QSet<int> usedVertices(const QVector<int>& indices) {
+    QSet<int> vertices;
+    foreach (int index, indices) {
+        vertices.insert(index);
+    }
+    return vertices;
+}
+
+void MeshSimplifierTests::flatGridTest() {
+    const int SIZE = 20;
+    QVector<glm::vec3> vertices;
+    QVector<QVector<int>> partIndices;
+    makeGrid(SIZE, false, vertices, partIndices);
+    int numTriangles = countTriangles(partIndices);
+
+    QVector<MeshSimplifier::Level> levels = MeshSimplifier::simplify(vertices, partIndices, RATIOS);
+    QCOMPARE(levels.size(), RATIOS.size());
+    for (int i = 0; i < levels.size(); ++i) {
+        const MeshSimplifier::Level& level = levels.at(i);
+        QCOMPARE(countTriangles(level.partIndices), level.numTriangles);
+        QVERIFY(level.numTriangles <= (int)(RATIOS.at(i) * numTriangles));
+        QCOMPARE(level.error, 0.0f);
+
+        QSet<int> used = usedVertices(level.partIndices.at(0));
+        for (int j = 0; j <= SIZE; ++j) {
+            QVERIFY(used.contains(j));
+            QVERIFY(used.contains(SIZE * (SIZE + 1) + j));
+            QVERIFY(used.contains(j * (SIZE + 1)));
+            QVERIFY(used.contains(j * (SIZE + 1) + SIZE));
+        }
+    }
+}
+
+void MeshSimplifierTests::sphereTest() {
+    QVector<glm::vec3> vertices;
+    QVector<QVector<int>> partIndices;
+    makeSphere(32, 32, vertices, partIndices);
+    int numTriangles = countTriangles(partIndices);
+
+    QVector<MeshSimplifier::Level> levels = MeshSimplifier::simplify(vertices, partIndices, RATIOS);
+    QCOMPARE(levels.size(), RATIOS.size());
+    float previousError = 0.0f;
+    for (int i = 0; i < levels.size(); ++i) {
+        const MeshSimplifier::Level& level = levels.at(i);
+        QVERIFY(level.numTriangles <= (int)(RATIOS.at(i) * numTriangles));
+        QVERIFY(level.error > 0.0f);
+        QVERIFY(level.error >= previousError);
+        previousError = level.error;
+
+        const QVector<int>& indices = level.partIndices.at(0);
+        QCOMPARE(indices.size(), level.numTriangles * 3);
+        for (int j = 0; j < indices.size(); j += 3) {
+            for (int k = 0; k < 3; ++k) {
+                QVERIFY(indices.at(j + k) >= 0 && indices.at(j + k) < vertices.size());
+            }
+            QVERIFY(indices.at(j) != indices.at(j + 1) && indices.at(j + 1) != indices.at(j + 2) &&
+                indices.at(j + 2) != indices.at(j));
+
+            // the triangles of a sphere around the origin all face away from it
+            glm::vec3 first = vertices.at(indices.at(j));
+            glm::vec3 normal = glm::cross(vertices.at(indices.at(j + 1)) - first, vertices.at(indices.at(j + 2)) - first);
+            QVERIFY(glm::dot(normal, first) > 0.0f);
+        }
+    }
+}
+
+void MeshSimplifierTests::partBorderTest() {
+    const int SIZE = 20;
+    QVector<glm::vec3> vertices;
+    QVector<QVector<int>> partIndices;
+    makeGrid(SIZE, true, vertices, partIndices);
+
+    QVector<MeshSimplifier::Level> levels = MeshSimplifier::simplify(vertices, partIndices, RATIOS);
+    QVERIFY(!levels.isEmpty());
+    foreach (const MeshSimplifier::Level& level, levels) {
+        QCOMPARE(level.partIndices.size(), 2);
+        QSet<int> firstUsed = usedVertices(level.partIndices.at(0));
+        QSet<int> secondUsed = usedVertices(level.partIndices.at(1));
+        for (int j = 0; j <= SIZE; ++j) {
+            int border = (SIZE / 2) * (SIZE + 1) + j;
+            QVERIFY(firstUsed.contains(border));
+            QVERIFY(secondUsed.contains(border));
+        }
+    }
+}
+
+void MeshSimplifierTests::tooFewTrianglesTest() {
+    QVector<glm::vec3> vertices;
+    QVector<QVector<int>> partIndices;
+    makeGrid(1, false, vertices, partIndices);
+
+    QVector<MeshSimplifier::Level> levels = MeshSimplifier::simplify(vertices, partIndices, RATIOS);
+    QVERIFY(levels.isEmpty());
+}
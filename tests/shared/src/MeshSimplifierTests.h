@@ -0,0 +1,32 @@
+//
+//  MeshSimplifierTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MeshSimplifierTests_h
+#define hifi_MeshSimplifierTests_h
+
+#include <QtTest/QtTest>
+
+class MeshSimplifierTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a flat grid loses its triangles without moving, and keeps its open border
+    void flatGridTest();
+
+    // Test that the levels of a sphere reach their ratios, keep valid indices, don't flip and grow in error
+    void sphereTest();
+
+    // Test that the vertices between two parts stay in both
+    void partBorderTest();
+
+    // Test that a mesh too small to simplify gets no levels
+    void tooFewTrianglesTest();
+};
+
+#endif // hifi_MeshSimplifierTests_h
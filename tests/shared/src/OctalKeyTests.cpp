@@ -0,0 +1,108 @@
+//
+//  OctalKeyTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctalKeyTests.h"
+
+#include <OctalCode.h>
+
+QTEST_MAIN(OctalKeyTests)
+
+// a byte code with the sections, built by childOctalCode
+static unsigned char* buildOctalCode(const QVector<int>& sections) {
+    unsigned char* octalCode = new unsigned char[1];
+    *octalCode = 0;
+    for (int section : sections) {
+        unsigned char* childCode = childOctalCode(octalCode, section);
+        delete[] octalCode;
+        octalCode = childCode;
+    }
+    return octalCode;
+}
+
+static QVector<int> randomSections(int count) {
+    QVector<int> sections;
+    for (int i = 0; i < count; i++) {
+        sections.push_back(qrand() % 8);
+    }
+    return sections;
+}
+
+void OctalKeyTests::roundTripTest() {
+    qsrand(1);
+    for (int sectionCount = 0; sectionCount <= OctalKey::MAX_SECTIONS; sectionCount++) {
+        QVector<int> sections = randomSections(sectionCount);
+        unsigned char* octalCode = buildOctalCode(sections);
+
+        OctalKey key = OctalKey::fromOctalCode(octalCode);
+        QVERIFY(key.isValid());
+        QCOMPARE(key.getSections(), sectionCount);
+        for (int i = 0; i < sectionCount; i++) {
+            QCOMPARE(key.getSection(i), sections[i]);
+        }
+
+        unsigned char* keyCode = key.toOctalCode();
+        QCOMPARE(memcmp(keyCode, octalCode, bytesRequiredForCodeLength(sectionCount)), 0);
+        delete[] keyCode;
+        delete[] octalCode;
+    }
+}
+
+void OctalKeyTests::familyTest() {
+    OctalKey root;
+    QCOMPARE(root.getSections(), 0);
+
+    OctalKey key = root.getChild(5).getChild(2).getChild(7);
+    QCOMPARE(key.getSections(), 3);
+    QCOMPARE(key.getParent(), root.getChild(5).getChild(2));
+    QCOMPARE(key.getParent().getParent().getParent(), root);
+
+    QVERIFY(root.isAncestorOf(key));
+    QVERIFY(root.getChild(5).isAncestorOf(key));
+    QVERIFY(key.isAncestorOf(key));
+    QVERIFY(!root.getChild(4).isAncestorOf(key));
+    QVERIFY(!key.isAncestorOf(key.getParent()));
+
+    unsigned char* octalCode = key.toOctalCode();
+    unsigned char* ancestorCode = root.getChild(5).toOctalCode();
+    QCOMPARE(isAncestorOf(ancestorCode, octalCode), root.getChild(5).isAncestorOf(key));
+    delete[] ancestorCode;
+    delete[] octalCode;
+}
+
+void OctalKeyTests::compareTest() {
+    qsrand(2);
+    for (int i = 0; i < 1000; i++) {
+        unsigned char* codeA = buildOctalCode(randomSections(qrand() % (OctalKey::MAX_SECTIONS + 1)));
+        unsigned char* codeB = buildOctalCode(randomSections(qrand() % (OctalKey::MAX_SECTIONS + 1)));
+        OctalKey keyA = OctalKey::fromOctalCode(codeA);
+        OctalKey keyB = OctalKey::fromOctalCode(codeB);
+
+        OctalCodeComparison comparison = compareOctalCodes(codeA, codeB);
+        QCOMPARE(keyA < keyB, comparison == LESS_THAN);
+        QCOMPARE(keyA == keyB, comparison == EXACT_MATCH);
+        delete[] codeA;
+        delete[] codeB;
+    }
+}
+
+void OctalKeyTests::tooDeepTest() {
+    QVERIFY(!OctalKey::fromOctalCode(nullptr).isValid());
+
+    unsigned char* octalCode = buildOctalCode(randomSections(OctalKey::MAX_SECTIONS + 1));
+    QVERIFY(!OctalKey::fromOctalCode(octalCode).isValid());
+    delete[] octalCode;
+
+    OctalKey deepest;
+    for (int i = 0; i < OctalKey::MAX_SECTIONS; i++) {
+        deepest = deepest.getChild(i % 8);
+    }
+    QVERIFY(deepest.isValid());
+    QVERIFY(!deepest.getChild(0).isValid());
+}
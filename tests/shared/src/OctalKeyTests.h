@@ -0,0 +1,26 @@
+//
+//  OctalKeyTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctalKeyTests_h
+#define hifi_OctalKeyTests_h
+
+#include <QtTest/QtTest>
+
+class OctalKeyTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTripTest();
+    void familyTest();
+    void compareTest();
+    void tooDeepTest();
+};
+
+#endif // hifi_OctalKeyTests_h
@@ -0,0 +1,210 @@
+//
+//  RayIntersectionKernelsTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RayIntersectionKernelsTests.h"
+
+#include <float.h>
+
+#include <AABox.h>
+#include <GeometryUtil.h>
+#include <RayIntersectionKernels.h>
+
+QTEST_MAIN(RayIntersectionKernelsTests)
+
+using namespace RayIntersectionKernels;
+
+static const int NUM_RAYS = 1000;
+static const int NUM_TRIANGLES = 1000;
+
+static float randomFloat(float low, float high) {
+    return low + (high - low) * (float)qrand() / (float)RAND_MAX;
+}
+
+static glm::vec3 randomVector(float low, float high) {
+    return glm::vec3(randomFloat(low, high), randomFloat(low, high), randomFloat(low, high));
+}
+
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+static QVector<Ray> randomRays() {
+    QVector<Ray> rays;
+    for (int i = 0; i < NUM_RAYS; ++i) {
+        rays.push_back({ randomVector(-2.0f, 2.0f), glm::normalize(randomVector(-1.0f, 1.0f)) });
+    }
+    // axis aligned rays take the parallel slab path
+    rays.push_back({ glm::vec3(0.5f, 0.5f, -2.0f), glm::vec3(0.0f, 0.0f, 1.0f) });
+    rays.push_back({ glm::vec3(0.25f, -2.0f, 0.75f), glm::vec3(0.0f, 1.0f, 0.0f) });
+    return rays;
+}
+
+// the eight children of the unit cube
+static void childBoxes(QVector<AABox>& boxes, BoxBatch& batch) {
+    batch.clear();
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 corner((i & 4) ? 0.5f : 0.0f, (i & 2) ? 0.5f : 0.0f, (i & 1) ? 0.5f : 0.0f);
+        boxes.push_back(AABox(corner, 0.5f));
+        batch.add(corner, corner + glm::vec3(0.5f));
+    }
+}
+
+static QVector<Triangle> randomTriangles() {
+    QVector<Triangle> triangles;
+    for (int i = 0; i < NUM_TRIANGLES; ++i) {
+        glm::vec3 center = randomVector(-1.0f, 1.0f);
+        triangles.push_back({ center + randomVector(-0.1f, 0.1f), center + randomVector(-0.1f, 0.1f),
+                              center + randomVector(-0.1f, 0.1f) });
+    }
+    return triangles;
+}
+
+void RayIntersectionKernelsTests::boxBatchTest() {
+    qsrand(1);
+
+    QVector<AABox> boxes;
+    BoxBatch batch;
+    childBoxes(boxes, batch);
+
+    // a batch that isn't full
+    BoxBatch partialBatch;
+    for (int i = 0; i < 5; ++i) {
+        partialBatch.add(boxes[i].getMinimumPoint(), boxes[i].getMaximumPoint());
+    }
+
+    int numHits = 0;
+    foreach (const Ray& ray, randomRays()) {
+        float distances[BOX_BATCH_SIZE];
+        uint8_t hits = findRayBoxesIntersection(ray.origin, ray.direction, batch, distances);
+
+        float partialDistances[BOX_BATCH_SIZE];
+        uint8_t partialHits = findRayBoxesIntersection(ray.origin, ray.direction, partialBatch, partialDistances);
+        QCOMPARE((int)partialHits, hits & 0x1f);
+
+        for (int i = 0; i < boxes.size(); ++i) {
+            float distance;
+            BoxFace face;
+            glm::vec3 surfaceNormal;
+            bool hit = boxes[i].findRayIntersection(ray.origin, ray.direction, distance, face, surfaceNormal);
+
+            QCOMPARE((bool)(hits & (1 << i)), hit);
+            if (hit) {
+                ++numHits;
+                float expected = boxes[i].contains(ray.origin) ? 0.0f : distance;
+                QVERIFY(fabsf(distances[i] - expected) < 0.0001f);
+            }
+        }
+    }
+    QVERIFY(numHits > 0);
+}
+
+void RayIntersectionKernelsTests::triangleBatchTest() {
+    qsrand(2);
+
+    QVector<Triangle> triangles = randomTriangles();
+
+    int numHits = 0;
+    foreach (const Ray& ray, randomRays()) {
+        // every size, so the tail after the groups of four is covered too
+        int numTriangles = ray.origin.x > 0.0f ? triangles.size() : (int)(randomFloat(0.0f, 7.0f));
+
+        int expectedIndex = -1;
+        float expectedDistance = FLT_MAX;
+        for (int i = 0; i < numTriangles; ++i) {
+            float distance;
+            if (findRayTriangleIntersection(ray.origin, ray.direction, triangles[i], distance) &&
+                    distance < expectedDistance) {
+                expectedDistance = distance;
+                expectedIndex = i;
+            }
+        }
+
+        float distance;
+        int index = findRayTrianglesIntersection(ray.origin, ray.direction, triangles.constData(), numTriangles,
+                                                 distance);
+        QCOMPARE(index, expectedIndex);
+        if (index >= 0) {
+            ++numHits;
+            QVERIFY(fabsf(distance - expectedDistance) < 0.0001f);
+        }
+    }
+    QVERIFY(numHits > 0);
+}
+
+void RayIntersectionKernelsTests::boxPickBenchmark_data() {
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("AABox") << false;
+    QTest::newRow("BoxBatch") << true;
+}
+
+// each iteration picks the children of an element with NUM_RAYS rays
+void RayIntersectionKernelsTests::boxPickBenchmark() {
+    QFETCH(bool, batched);
+
+    qsrand(3);
+
+    QVector<AABox> boxes;
+    BoxBatch batch;
+    childBoxes(boxes, batch);
+    QVector<Ray> rays = randomRays();
+
+    int numHits = 0;
+    QBENCHMARK {
+        foreach (const Ray& ray, rays) {
+            if (batched) {
+                float distances[BOX_BATCH_SIZE];
+                numHits += findRayBoxesIntersection(ray.origin, ray.direction, batch, distances) != 0;
+            } else {
+                foreach (const AABox& box, boxes) {
+                    float distance;
+                    BoxFace face;
+                    glm::vec3 surfaceNormal;
+                    numHits += box.findRayIntersection(ray.origin, ray.direction, distance, face, surfaceNormal);
+                }
+            }
+        }
+    }
+    QVERIFY(numHits > 0);
+}
+
+void RayIntersectionKernelsTests::trianglePickBenchmark_data() {
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("findRayTriangleIntersection") << false;
+    QTest::newRow("findRayTrianglesIntersection") << true;
+}
+
+// each iteration picks a mesh of NUM_TRIANGLES triangles with NUM_RAYS rays
+void RayIntersectionKernelsTests::trianglePickBenchmark() {
+    QFETCH(bool, batched);
+
+    qsrand(4);
+
+    QVector<Triangle> triangles = randomTriangles();
+    QVector<Ray> rays = randomRays();
+
+    int numHits = 0;
+    QBENCHMARK {
+        foreach (const Ray& ray, rays) {
+            float distance;
+            if (batched) {
+                numHits += findRayTrianglesIntersection(ray.origin, ray.direction, triangles.constData(),
+                                                        triangles.size(), distance) >= 0;
+            } else {
+                foreach (const Triangle& triangle, triangles) {
+                    numHits += findRayTriangleIntersection(ray.origin, ray.direction, triangle, distance);
+                }
+            }
+        }
+    }
+    QVERIFY(numHits > 0);
+}
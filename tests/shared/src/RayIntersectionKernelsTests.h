@@ -0,0 +1,32 @@
+//
+//  RayIntersectionKernelsTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RayIntersectionKernelsTests_h
+#define hifi_RayIntersectionKernelsTests_h
+
+#include <QtTest/QtTest>
+
+class RayIntersectionKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the box batch hits the same boxes as AABox::findRayIntersection, at the same distances
+    void boxBatchTest();
+
+    // Test that the triangle batch finds the same closest triangle as findRayTriangleIntersection
+    void triangleBatchTest();
+
+    // Compare picks per second of one box or triangle at a time against the batches
+    void boxPickBenchmark_data();
+    void boxPickBenchmark();
+    void trianglePickBenchmark_data();
+    void trianglePickBenchmark();
+};
+
+#endif // hifi_RayIntersectionKernelsTests_h
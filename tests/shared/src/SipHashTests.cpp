@@ -0,0 +1,44 @@
+//
+//  SipHashTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHashTests.h"
+
+#include <SipHash.h>
+
+QTEST_MAIN(SipHashTests)
+
+// the key and messages of the reference vectors, the bytes counting up from zero
+static void fillCounting(unsigned char* bytes, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (unsigned char)i;
+    }
+}
+
+void SipHashTests::referenceVectorsTest() {
+    unsigned char key[SIP_HASH_KEY_SIZE];
+    unsigned char message[64];
+    fillCounting(key, sizeof(key));
+    fillCounting(message, sizeof(message));
+
+    QCOMPARE(sipHash24(key, message, 0), (uint64_t)0x726fdb47dd0e0e31ULL);
+    QCOMPARE(sipHash24(key, message, 15), (uint64_t)0xa129ca6149be45e5ULL);
+    QCOMPARE(sipHash24(key, message, 63), (uint64_t)0x958a324ceb064572ULL);
+}
+
+void SipHashTests::keyTest() {
+    unsigned char key[SIP_HASH_KEY_SIZE];
+    unsigned char message[64];
+    fillCounting(key, sizeof(key));
+    fillCounting(message, sizeof(message));
+
+    uint64_t hash = sipHash24(key, message, sizeof(message));
+    key[SIP_HASH_KEY_SIZE - 1] ^= 1;
+    QVERIFY(sipHash24(key, message, sizeof(message)) != hash);
+}
@@ -0,0 +1,104 @@
+//
+//  TraceTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TraceTests.h"
+
+#include <thread>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <Trace.h>
+
+QTEST_MAIN(TraceTests)
+
+// the complete events of the trace, the zones
+static QList<QJsonObject> getZones(const QByteArray& trace) {
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(trace, &error);
+    QList<QJsonObject> zones;
+    if (error.error != QJsonParseError::NoError) {
+        return zones;
+    }
+    for (const QJsonValue& event : document.object()["traceEvents"].toArray()) {
+        if (event.toObject()["ph"].toString() == "X") {
+            zones.append(event.toObject());
+        }
+    }
+    return zones;
+}
+
+void TraceTests::captureTest() {
+    Trace::startCapture();
+    {
+        TRACE_ZONE("main");
+    }
+    std::thread worker([] {
+        TRACE_ZONE("worker");
+    });
+    worker.join();
+    Trace::stopCapture();
+
+    QByteArray trace = Trace::toChromeTrace();
+    QList<QJsonObject> zones = getZones(trace);
+    QCOMPARE(zones.size(), 2);
+    QCOMPARE(zones[0]["name"].toString(), QString("main"));
+    QCOMPARE(zones[1]["name"].toString(), QString("worker"));
+    QVERIFY(zones[0]["tid"].toInt() != zones[1]["tid"].toInt());
+    QVERIFY(zones[0]["dur"].toDouble() >= 0.0);
+    QVERIFY(trace.contains("\"thread_name\""));
+}
+
+void TraceTests::notCapturingTest() {
+    Trace::startCapture();
+    Trace::stopCapture();
+    {
+        TRACE_ZONE("ignored");
+    }
+    QVERIFY(!Trace::isCapturing());
+    QCOMPARE(getZones(Trace::toChromeTrace()).size(), 0);
+}
+
+void TraceTests::newCaptureTest() {
+    Trace::startCapture();
+    {
+        TRACE_ZONE("old");
+    }
+    Trace::startCapture();
+    {
+        TRACE_ZONE("new");
+    }
+    Trace::stopCapture();
+
+    QList<QJsonObject> zones = getZones(Trace::toChromeTrace());
+    QCOMPARE(zones.size(), 1);
+    QCOMPARE(zones[0]["name"].toString(), QString("new"));
+}
+
+void TraceTests::droppedZonesTest() {
+    const int EXTRA_ZONES = 10;
+    Trace::startCapture();
+    for (int i = 0; i < Trace::MAX_ZONES_PER_THREAD + EXTRA_ZONES; i++) {
+        Trace::addZone("zone", i, i + 1);
+    }
+    Trace::stopCapture();
+
+    QCOMPARE(Trace::getDroppedZoneCount(), EXTRA_ZONES);
+    QCOMPARE(getZones(Trace::toChromeTrace()).size(), Trace::MAX_ZONES_PER_THREAD);
+}
+
+void TraceTests::internNameTest() {
+    std::string name = "job";
+    const char* interned = Trace::internName(name);
+    QCOMPARE(QString(interned), QString("job"));
+    QCOMPARE(Trace::internName(std::string("job")), interned);
+    QVERIFY(Trace::internName(std::string("other job")) != interned);
+}
@@ -0,0 +1,27 @@
+//
+//  TraceTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TraceTests_h
+#define hifi_TraceTests_h
+
+#include <QtTest/QtTest>
+
+class TraceTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void captureTest();
+    void notCapturingTest();
+    void newCaptureTest();
+    void droppedZonesTest();
+    void internNameTest();
+};
+
+#endif // hifi_TraceTests_h
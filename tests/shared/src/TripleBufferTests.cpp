@@ -0,0 +1,73 @@
+//
+//  TripleBufferTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TripleBufferTests.h"
+
+#include <thread>
+
+#include <TripleBuffer.h>
+
+QTEST_MAIN(TripleBufferTests)
+
+void TripleBufferTests::latestTest() {
+    TripleBuffer<int> buffer;
+    QVERIFY(!buffer.fetch());
+
+    buffer.getWriteBuffer() = 1;
+    buffer.publish();
+    QVERIFY(buffer.fetch());
+    QCOMPARE(buffer.getReadBuffer(), 1);
+    QVERIFY(!buffer.fetch());
+    QCOMPARE(buffer.getReadBuffer(), 1);
+
+    // the reader only sees the last of the values published since it last fetched
+    for (int i = 2; i <= 5; i++) {
+        buffer.getWriteBuffer() = i;
+        buffer.publish();
+    }
+    QVERIFY(buffer.fetch());
+    QCOMPARE(buffer.getReadBuffer(), 5);
+    QVERIFY(!buffer.fetch());
+}
+
+void TripleBufferTests::threadsTest() {
+    struct Value {
+        int first { 0 };
+        int second { 0 };
+    };
+    const int VALUE_COUNT = 100000;
+    TripleBuffer<Value> buffer;
+
+    std::thread writer([&] {
+        for (int i = 1; i <= VALUE_COUNT; i++) {
+            Value& value = buffer.getWriteBuffer();
+            value.first = i;
+            value.second = -i;
+            buffer.publish();
+        }
+    });
+
+    // the values are never torn and never go back in time
+    int last = 0;
+    bool torn = false;
+    bool backwards = false;
+    while (last < VALUE_COUNT) {
+        if (buffer.fetch()) {
+            const Value& value = buffer.getReadBuffer();
+            torn = torn || value.second != -value.first;
+            backwards = backwards || value.first <= last;
+            last = value.first;
+        }
+    }
+    writer.join();
+    QVERIFY(!torn);
+    QVERIFY(!backwards);
+    QCOMPARE(last, VALUE_COUNT);
+}
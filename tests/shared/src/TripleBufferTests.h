@@ -0,0 +1,24 @@
+//
+//  TripleBufferTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TripleBufferTests_h
+#define hifi_TripleBufferTests_h
+
+#include <QtTest/QtTest>
+
+class TripleBufferTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void latestTest();
+    void threadsTest();
+};
+
+#endif // hifi_TripleBufferTests_h
@@ -0,0 +1,326 @@
+//
+//  AudioLoadTest.cpp
+//  tools/audio-load-test/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioLoadTest.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTimer>
+#include <QtNetwork/QNetworkRequest>
+
+#include <DomainHandler.h>
+#include <LogHandler.h>
+#include <NetworkAccessManager.h>
+#include <NumericalConstants.h>
+#include <UUID.h>
+
+#include "AudioLoadTestClient.h"
+
+const QCommandLineOption CLIENTS_OPTION {
+    "clients", "number of synthetic audio clients to spawn (default is 10)", "count"
+};
+const QCommandLineOption DOMAIN_OPTION {
+    "domain", "domain-server the clients connect to (default is localhost)", "HOSTNAME[:PORT]"
+};
+const QCommandLineOption DOMAIN_HTTP_PORT_OPTION {
+    "domain-http-port", "port of the domain-server web interface the mixer stats are read from (default is 40100)", "port"
+};
+const QCommandLineOption DOMAIN_HTTP_AUTH_OPTION {
+    "domain-http-auth", "credentials for the domain-server web interface, if it asks for them", "USERNAME:PASSWORD"
+};
+const QCommandLineOption RADIUS_OPTION {
+    "radius", "meters from the origin of the domain within which the clients move (default is 10)", "meters"
+};
+const QCommandLineOption DURATION_OPTION {
+    "duration", "seconds to run before stopping the clients (default is until interrupted)", "seconds"
+};
+const QCommandLineOption STATS_INTERVAL {
+    "stats-interval", "stats output interval (default is 1000ms)", "milliseconds"
+};
+const QCommandLineOption VERBOSE_OPTION {
+    "verbose", "output the log of the spawned clients"
+};
+const QCommandLineOption CLIENT_INDEX_OPTION {
+    "client-index", "run as the synthetic client with this index, the load test spawns its clients this way", "index"
+};
+
+const QStringList STATS_TABLE_HEADERS {
+    "Clients", "Mix (us/frame)", "Max mix (us)", "Per listener (us)", "Sleep (%)",
+    "Up dropped", "Up starves", "Up lost", "Down dropped", "Down starves", "Down lost",
+    "Latency (ms)", "Max latency (ms)"
+};
+
+AudioLoadTest::AudioLoadTest(int& argc, char** argv) :
+    QCoreApplication(argc, argv),
+    _domainHostname("localhost"),
+    _domainPort(DEFAULT_DOMAIN_SERVER_PORT),
+    _domainHTTPPort(DOMAIN_SERVER_HTTP_PORT)
+{
+    qInstallMessageHandler(LogHandler::verboseMessageHandler);
+
+    parseArguments();
+
+    if (_argumentParser.isSet(DOMAIN_OPTION)) {
+        QString hostnamePortString = _argumentParser.value(DOMAIN_OPTION);
+        int colonIndex = hostnamePortString.indexOf(':');
+        _domainHostname = hostnamePortString.left(colonIndex);
+        if (colonIndex != -1) {
+            _domainPort = (quint16) hostnamePortString.mid(colonIndex + 1).toUInt();
+        }
+
+        if (_domainHostname.isEmpty() || _domainPort == 0) {
+            qCritical() << "Could not parse a hostname and port combination from" << hostnamePortString;
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        }
+    }
+
+    if (_argumentParser.isSet(RADIUS_OPTION)) {
+        _radius = _argumentParser.value(RADIUS_OPTION).toFloat();
+    }
+
+    if (_argumentParser.isSet(STATS_INTERVAL)) {
+        _statsInterval = _argumentParser.value(STATS_INTERVAL).toInt();
+    }
+
+    if (_argumentParser.isSet(CLIENT_INDEX_OPTION)) {
+        // we are one of the clients, the load test that spawned us reads our stats
+        _client = new AudioLoadTestClient(_argumentParser.value(CLIENT_INDEX_OPTION).toInt(), _domainHostname,
+                                          _domainPort, _radius, _statsInterval, this);
+        return;
+    }
+
+    if (_argumentParser.isSet(CLIENTS_OPTION)) {
+        _numClients = _argumentParser.value(CLIENTS_OPTION).toInt();
+    }
+
+    if (_argumentParser.isSet(DOMAIN_HTTP_PORT_OPTION)) {
+        _domainHTTPPort = (quint16) _argumentParser.value(DOMAIN_HTTP_PORT_OPTION).toUInt();
+    }
+
+    startClients();
+
+    QTimer* statsTimer = new QTimer(this);
+    connect(statsTimer, &QTimer::timeout, this, &AudioLoadTest::sampleStats);
+    statsTimer->start(_statsInterval);
+
+    if (_argumentParser.isSet(DURATION_OPTION)) {
+        QTimer::singleShot(_argumentParser.value(DURATION_OPTION).toInt() * (int) MSECS_PER_SECOND, this,
+                           SLOT(finish()));
+    }
+
+    // don't leave clients behind when we are stopped with a signal or by the duration
+    connect(this, &QCoreApplication::aboutToQuit, this, [this] {
+        foreach (QProcess* process, _clientProcesses) {
+            process->kill();
+            process->waitForFinished();
+        }
+    });
+}
+
+void AudioLoadTest::parseArguments() {
+    // use a QCommandLineParser to setup command line arguments and give helpful output
+    _argumentParser.setApplicationDescription("High Fidelity Audio Mixer Load Test");
+
+    const QCommandLineOption helpOption = _argumentParser.addHelpOption();
+
+    _argumentParser.addOptions({
+        CLIENTS_OPTION, DOMAIN_OPTION, DOMAIN_HTTP_PORT_OPTION, DOMAIN_HTTP_AUTH_OPTION, RADIUS_OPTION,
+        DURATION_OPTION, STATS_INTERVAL, VERBOSE_OPTION, CLIENT_INDEX_OPTION
+    });
+
+    if (!_argumentParser.parse(arguments())) {
+        qCritical() << _argumentParser.errorText();
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (_argumentParser.isSet(helpOption)) {
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+}
+
+void AudioLoadTest::startClients() {
+    _clientStats.resize(_numClients);
+
+    QString domain = QString("%1:%2").arg(_domainHostname).arg(_domainPort);
+
+    for (int i = 0; i < _numClients; ++i) {
+        QProcess* process = new QProcess(this);
+        connect(process, &QProcess::readyReadStandardOutput, this, &AudioLoadTest::readClientStats);
+
+        process->start(applicationFilePath(), QStringList()
+                       << "--" + CLIENT_INDEX_OPTION.names().first() << QString::number(i)
+                       << "--" + DOMAIN_OPTION.names().first() << domain
+                       << "--" + RADIUS_OPTION.names().first() << QString::number(_radius)
+                       << "--" + STATS_INTERVAL.names().first() << QString::number(_statsInterval));
+
+        _clientProcesses.push_back(process);
+    }
+
+    qDebug() << "Started" << _numClients << "synthetic audio clients for the domain at" << domain;
+}
+
+void AudioLoadTest::readClientStats() {
+    QProcess* process = qobject_cast<QProcess*>(sender());
+    if (!process) {
+        return;
+    }
+
+    static const QByteArray STATS_PREFIX = AUDIO_LOAD_TEST_STATS_PREFIX;
+
+    while (process->canReadLine()) {
+        QByteArray line = process->readLine().trimmed();
+
+        if (line.startsWith(STATS_PREFIX)) {
+            QJsonObject stats = QJsonDocument::fromJson(line.mid(STATS_PREFIX.size())).object();
+            int index = stats["index"].toInt(-1);
+            if (index >= 0 && index < _clientStats.size()) {
+                _clientStats[index] = stats;
+            }
+        } else if (_argumentParser.isSet(VERBOSE_OPTION)) {
+            qDebug() << "Client" << _clientProcesses.indexOf(process) << ":" << line.constData();
+        }
+    }
+}
+
+void AudioLoadTest::requestMixerStats() {
+    // the domain-server lists the nodes first, once we know which one is the mixer we ask for its stats
+    QUrl url;
+    url.setScheme("http");
+    url.setHost(_domainHostname);
+    url.setPort(_domainHTTPPort);
+    url.setPath(_mixerUUID.isNull() ? "/nodes.json" : "/nodes/" + uuidStringWithoutCurlyBraces(_mixerUUID) + ".json");
+
+    QNetworkRequest request(url);
+    if (_argumentParser.isSet(DOMAIN_HTTP_AUTH_OPTION)) {
+        request.setRawHeader("Authorization", "Basic " + _argumentParser.value(DOMAIN_HTTP_AUTH_OPTION).toUtf8().toBase64());
+    }
+
+    QNetworkReply* reply = NetworkAccessManager::getInstance().get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply] { handleMixerStatsReply(reply); });
+}
+
+void AudioLoadTest::handleMixerStatsReply(QNetworkReply* reply) {
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        if (!_mixerUUID.isNull()) {
+            // the mixer went away, it is looked up again with the next stats
+            qDebug() << "Lost the stats of the audio mixer -" << reply->errorString();
+            _mixerUUID = QUuid();
+            _mixerStats = QJsonObject();
+        } else {
+            qDebug() << "Could not list the nodes of the domain -" << reply->errorString();
+        }
+        return;
+    }
+
+    QJsonObject replyObject = QJsonDocument::fromJson(reply->readAll()).object();
+
+    if (_mixerUUID.isNull()) {
+        foreach (const QJsonValue& node, replyObject["nodes"].toArray()) {
+            if (node.toObject()["type"].toString() == "audio-mixer") {
+                _mixerUUID = QUuid(node.toObject()["uuid"].toString());
+                qDebug() << "Reading the stats of the audio mixer" << _mixerUUID;
+                break;
+            }
+        }
+    } else {
+        _mixerStats = replyObject;
+    }
+}
+
+void AudioLoadTest::sampleStats() {
+    static bool first = true;
+
+    if (first) {
+        // output the headers for stats for our table
+        qDebug() << qPrintable(STATS_TABLE_HEADERS.join(" | "));
+        first = false;
+    }
+
+    requestMixerStats();
+
+    // the workers mix their listeners in parallel, the slowest of them is the time a frame takes
+    float frameUsecs = 0.0f;
+    float maxFrameUsecs = 0.0f;
+    float sumWorkerUsecs = 0.0f;
+    float sumWorkerListeners = 0.0f;
+    QJsonObject workersStats = _mixerStats["mix_workers"].toObject();
+    for (auto it = workersStats.constBegin(); it != workersStats.constEnd(); ++it) {
+        QJsonObject workerStats = it.value().toObject();
+        float averageUsecs = workerStats["average_mix_usecs_per_frame"].toDouble();
+        frameUsecs = std::max(frameUsecs, averageUsecs);
+        maxFrameUsecs = std::max(maxFrameUsecs, (float) workerStats["max_mix_usecs_per_frame"].toDouble());
+        sumWorkerUsecs += averageUsecs;
+        sumWorkerListeners += workerStats["average_listeners_per_frame"].toDouble();
+    }
+    float listenerUsecs = sumWorkerListeners > 0.0f ? sumWorkerUsecs / sumWorkerListeners : 0.0f;
+
+    int numConnected = 0;
+    double upstreamDropped = 0.0, upstreamStarves = 0.0, upstreamLost = 0.0;
+    double downstreamDropped = 0.0, downstreamStarves = 0.0, downstreamLost = 0.0;
+    float sumLatencyMsecs = 0.0f;
+    float maxLatencyMsecs = 0.0f;
+    foreach (const QJsonObject& stats, _clientStats) {
+        if (!stats["connected"].toBool()) {
+            continue;
+        }
+        numConnected++;
+        upstreamDropped += stats["upstream_frames_dropped"].toDouble();
+        upstreamStarves += stats["upstream_starves"].toDouble();
+        upstreamLost += stats["upstream_packets_lost"].toDouble();
+        downstreamDropped += stats["downstream_frames_dropped"].toDouble();
+        downstreamStarves += stats["downstream_starves"].toDouble();
+        downstreamLost += stats["downstream_packets_lost"].toDouble();
+
+        float latencyMsecs = stats["latency_msecs"].toDouble();
+        sumLatencyMsecs += latencyMsecs;
+        maxLatencyMsecs = std::max(maxLatencyMsecs, latencyMsecs);
+    }
+    float averageLatencyMsecs = numConnected > 0 ? sumLatencyMsecs / numConnected : 0.0f;
+
+    _peakFrameUsecs = std::max(_peakFrameUsecs, maxFrameUsecs);
+    _peakListenerUsecs = std::max(_peakListenerUsecs, listenerUsecs);
+    _peakLatencyMsecs = std::max(_peakLatencyMsecs, maxLatencyMsecs);
+
+    int headerIndex = -1;
+
+    // setup a list of left justified values
+    QStringList values {
+        QString("%1/%2").arg(numConnected).arg(_numClients).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(frameUsecs, 'f', 0).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(maxFrameUsecs, 'f', 0).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(listenerUsecs, 'f', 1).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(_mixerStats["trailing_sleep_percentage"].toDouble(), 'f', 1).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(upstreamDropped, 'f', 0).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(upstreamStarves, 'f', 0).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(upstreamLost, 'f', 0).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(downstreamDropped, 'f', 0).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(downstreamStarves, 'f', 0).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(downstreamLost, 'f', 0).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(averageLatencyMsecs, 'f', 1).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size()),
+        QString::number(maxLatencyMsecs, 'f', 1).rightJustified(STATS_TABLE_HEADERS[++headerIndex].size())
+    };
+
+    // output this line of values
+    qDebug() << qPrintable(values.join(" | "));
+}
+
+void AudioLoadTest::finish() {
+    qDebug() << "Load test of" << _numClients << "clients done - worst mix of a frame" << _peakFrameUsecs << "us,"
+        << "worst mix per listener" << _peakListenerUsecs << "us, worst latency" << _peakLatencyMsecs << "ms";
+    quit();
+}
@@ -0,0 +1,68 @@
+//
+//  AudioLoadTest.h
+//  tools/audio-load-test/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AudioLoadTest_h
+#define hifi_AudioLoadTest_h
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonObject>
+#include <QtCore/QProcess>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+#include <QtNetwork/QNetworkReply>
+
+class AudioLoadTestClient;
+
+/// Spawns synthetic audio clients against a running domain and reports how the audio mixer holds up under them.
+/// A NodeList is one per process, so every client is a process of its own, started from this same executable with
+/// --client-index. The stats of the mixer come from the domain-server, which keeps the last stats of every node.
+class AudioLoadTest : public QCoreApplication {
+    Q_OBJECT
+public:
+    AudioLoadTest(int& argc, char** argv);
+
+private slots:
+    void readClientStats();
+    void sampleStats();
+    void handleMixerStatsReply(QNetworkReply* reply);
+    void finish();
+
+private:
+    void parseArguments();
+    void startClients();
+    void requestMixerStats();
+
+    QCommandLineParser _argumentParser;
+
+    QString _domainHostname;
+    quint16 _domainPort;
+    quint16 _domainHTTPPort;
+    int _numClients { 10 };
+    float _radius { 10.0f };
+    int _statsInterval { 1000 }; // milliseconds
+
+    AudioLoadTestClient* _client { nullptr }; // only when we are one of the clients
+
+    QVector<QProcess*> _clientProcesses;
+    QVector<QJsonObject> _clientStats; // the last stats line of each client
+
+    QUuid _mixerUUID;
+    QJsonObject _mixerStats;
+
+    // the worst of each over the whole run, for the summary
+    float _peakFrameUsecs { 0.0f };
+    float _peakListenerUsecs { 0.0f };
+    float _peakLatencyMsecs { 0.0f };
+};
+
+#endif // hifi_AudioLoadTest_h
@@ -0,0 +1,224 @@
+//
+//  AudioLoadTestClient.cpp
+//  tools/audio-load-test/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioLoadTestClient.h"
+
+#include <stdio.h>
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AddressManager.h>
+#include <AudioConstants.h>
+#include <GLMHelpers.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <PositionalAudioStream.h>
+#include <udt/PacketHeaders.h>
+
+static const int RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES = 100;
+
+// the seconds it takes a client to go once around its circle, and twice in and out of it
+static const float ORBIT_PERIOD_SECS = 20.0f;
+
+// spreads the clients around the circle, no two ever start at the same place
+static const float START_PHASE_STEP = 0.618034f;
+
+// the gain of the sources, the same as the injected sources of the interface
+static const float SOURCE_GAIN = 0.05f;
+
+AudioLoadTestClient::AudioLoadTestClient(int index, const QString& domainHostname, quint16 domainPort, float radius,
+                                         int statsInterval, QObject* parent) :
+    QObject(parent),
+    _index(index),
+    _radius(radius),
+    _isNoise(index % 2 == 1),
+    _frameBuffer(AudioConstants::MONO, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL),
+    _receivedAudioStream(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES,
+                         InboundAudioStream::Settings())
+{
+    // half the clients are a tone, each a little higher than the last, so every voice in a mix can be told apart
+    const float BASE_FREQUENCY = 220.0f;
+    const float FREQUENCY_STEP = 20.0f;
+    _toneSource.initialize();
+    float sampleRate, frequency, amplitude;
+    _toneSource.getParameters(sampleRate, frequency, amplitude);
+    _toneSource.setParameters(sampleRate, BASE_FREQUENCY + FREQUENCY_STEP * (index / 2), amplitude);
+    _noiseSource.initialize();
+    _sourceGain.initialize();
+    _sourceGain.setParameters(SOURCE_GAIN, 0.0f);
+
+    DependencyManager::set<AddressManager>();
+    auto nodeList = DependencyManager::set<NodeList>(NodeType::Agent, 0);
+
+    auto& packetReceiver = nodeList->getPacketReceiver();
+    packetReceiver.registerListener(PacketType::MixedAudio, this, "handleMixedAudioPacket");
+    packetReceiver.registerListener(PacketType::SilentAudioFrame, this, "handleMixedAudioPacket");
+    packetReceiver.registerListener(PacketType::AudioStreamStats, this, "handleStreamStatsPacket");
+    connect(nodeList.data(), &NodeList::nodeKilled, this, &AudioLoadTestClient::nodeKilled);
+    connect(nodeList.data(), &NodeList::limitOfSilentDomainCheckInsReached, nodeList.data(), &NodeList::reset);
+
+    nodeList->addSetOfNodeTypesToNodeInterestSet(NodeSet() << NodeType::AudioMixer);
+    nodeList->getDomainHandler().setHostnameAndPort(domainHostname, domainPort);
+
+    QTimer* domainCheckInTimer = new QTimer(this);
+    connect(domainCheckInTimer, &QTimer::timeout, nodeList.data(), &NodeList::sendDomainServerCheckIn);
+    domainCheckInTimer->start(DOMAIN_SERVER_CHECK_IN_MSECS);
+
+    // the ping of the mixer is part of the latency we report
+    QTimer* pingTimer = new QTimer(this);
+    connect(pingTimer, &QTimer::timeout, nodeList.data(), &NodeList::sendPingPackets);
+    pingTimer->start(MSECS_PER_SECOND);
+
+    // the timer only wakes us up, the frames are sent from the time elapsed so they don't drift with it
+    _frameClock.start();
+    QTimer* frameTimer = new QTimer(this);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &AudioLoadTestClient::sendFrames);
+    frameTimer->start((int)(AudioConstants::NETWORK_FRAME_MSECS / 2.0f));
+
+    QTimer* statsTimer = new QTimer(this);
+    connect(statsTimer, &QTimer::timeout, this, &AudioLoadTestClient::sendStats);
+    statsTimer->start(statsInterval);
+}
+
+glm::vec3 AudioLoadTestClient::getPositionAtFrame(quint64 frame) const {
+    // every client goes around the same circle from its own start, drifting in and out of it, so the distances
+    // between them keep changing like those of avatars walking about
+    float secs = frame * AudioConstants::NETWORK_FRAME_MSECS / MSECS_PER_SECOND;
+    float phase = TWO_PI * (secs / ORBIT_PERIOD_SECS + _index * START_PHASE_STEP);
+    float distance = _radius * (0.5f + 0.5f * sinf(2.0f * phase + _index));
+    return glm::vec3(distance * sinf(phase), 0.0f, distance * cosf(phase));
+}
+
+void AudioLoadTestClient::sendFrames() {
+    quint64 framesDue = _frameClock.nsecsElapsed() / NSECS_PER_USEC / AudioConstants::NETWORK_FRAME_USECS;
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+
+    while (_framesSent < framesDue) {
+        if (audioMixer && audioMixer->getActiveSocket()) {
+            sendFrame(*audioMixer);
+        }
+
+        // play a frame of the mix at the same pace, like the output device of an interface
+        _receivedAudioStream.popFrames(1, true);
+
+        _framesSent++;
+    }
+}
+
+void AudioLoadTestClient::sendFrame(const Node& audioMixer) {
+    if (_isNoise) {
+        _noiseSource.render(_frameBuffer);
+    } else {
+        _toneSource.render(_frameBuffer);
+    }
+    _sourceGain.render(_frameBuffer);
+
+    auto audioPacket = NLPacket::create(PacketType::MicrophoneAudioNoEcho);
+
+    glm::vec3 position = getPositionAtFrame(_framesSent);
+    glm::quat orientation = glm::angleAxis(atan2f(position.x, position.z), Vectors::UP); // facing the middle
+    quint8 isStereo = 0;
+
+    audioPacket->writePrimitive(_outgoingSequenceNumber);
+    audioPacket->writePrimitive(isStereo);
+    audioPacket->writePrimitive(position);
+    audioPacket->writePrimitive(orientation);
+
+    // no codec is negotiated, the mixer takes raw samples
+    int16_t* samples = reinterpret_cast<int16_t*>(audioPacket->getPayload() + audioPacket->getPayloadSize());
+    _frameBuffer.copyFrames(AudioConstants::MONO, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, samples, true);
+    audioPacket->setPayloadSize(audioPacket->getPayloadSize() + AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL);
+
+    DependencyManager::get<NodeList>()->sendUnreliablePacket(*audioPacket, audioMixer);
+    _outgoingSequenceNumber++;
+}
+
+void AudioLoadTestClient::handleMixedAudioPacket(QSharedPointer<NLPacket> packet) {
+    _receivedAudioStream.parseData(*packet);
+}
+
+void AudioLoadTestClient::handleStreamStatsPacket(QSharedPointer<NLPacket> packet) {
+    quint8 appendFlag;
+    packet->readPrimitive(&appendFlag);
+
+    quint16 numStreamStats;
+    packet->readPrimitive(&numStreamStats);
+
+    // we have no injectors, only the stats of our microphone stream are of interest
+    AudioStreamStats streamStats;
+    for (quint16 i = 0; i < numStreamStats; i++) {
+        packet->readPrimitive(&streamStats);
+        if (streamStats._streamType == PositionalAudioStream::Microphone) {
+            _mixerStreamStats = streamStats;
+        }
+    }
+}
+
+void AudioLoadTestClient::nodeKilled(SharedNodePointer node) {
+    if (node->getType() == NodeType::AudioMixer) {
+        _receivedAudioStream.reset();
+        _mixerStreamStats = AudioStreamStats();
+        _outgoingSequenceNumber = 0;
+    }
+}
+
+void AudioLoadTestClient::sendStats() {
+    _receivedAudioStream.perSecondCallbackForUpdatingStats();
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+    AudioStreamStats downstreamStats = _receivedAudioStream.getAudioStreamStats();
+
+    if (audioMixer) {
+        // the mixer keeps our downstream stats with the rest of its listener stats
+        quint8 appendFlag = 0;
+        quint16 numStreamStatsToPack = 1;
+        auto statsPacket = NLPacket::create(PacketType::AudioStreamStats,
+                                            sizeof(appendFlag) + sizeof(numStreamStatsToPack) + sizeof(downstreamStats));
+        statsPacket->writePrimitive(appendFlag);
+        statsPacket->writePrimitive(numStreamStatsToPack);
+        statsPacket->writePrimitive(downstreamStats);
+        nodeList->sendPacket(std::move(statsPacket), *audioMixer);
+    }
+
+    bool isConnected = audioMixer && audioMixer->getActiveSocket();
+    int pingMsecs = isConnected ? audioMixer->getPingMs() : 0;
+
+    // from our microphone to the ear of another client: half a ping up, the jitter buffer of the mixer, a frame of
+    // mixing, half a ping down and our own jitter buffer, the other client's being much like ours
+    float latencyMsecs = pingMsecs + _mixerStreamStats._latencyMsecs + AudioConstants::NETWORK_FRAME_MSECS +
+        downstreamStats._latencyMsecs;
+
+    QJsonObject statsObject;
+    statsObject["index"] = _index;
+    statsObject["connected"] = isConnected;
+    statsObject["ping_msecs"] = pingMsecs;
+    statsObject["upstream_frames_dropped"] = (double)_mixerStreamStats._framesDropped;
+    statsObject["upstream_starves"] = (double)_mixerStreamStats._starveCount;
+    statsObject["upstream_packets_lost"] = (double)_mixerStreamStats._packetStreamStats._lost;
+    statsObject["upstream_latency_msecs"] = _mixerStreamStats._latencyMsecs;
+    statsObject["downstream_frames_dropped"] = (double)downstreamStats._framesDropped;
+    statsObject["downstream_starves"] = (double)downstreamStats._starveCount;
+    statsObject["downstream_packets_lost"] = (double)downstreamStats._packetStreamStats._lost;
+    statsObject["downstream_latency_msecs"] = downstreamStats._latencyMsecs;
+    statsObject["latency_msecs"] = isConnected ? latencyMsecs : 0.0f;
+
+    // the log goes to stdout as well, the prefix tells our lines apart from it
+    QByteArray line = AUDIO_LOAD_TEST_STATS_PREFIX + QJsonDocument(statsObject).toJson(QJsonDocument::Compact) + '\n';
+    fwrite(line.constData(), 1, line.size(), stdout);
+    fflush(stdout);
+}
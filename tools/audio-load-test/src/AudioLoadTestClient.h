@@ -0,0 +1,71 @@
+//
+//  AudioLoadTestClient.h
+//  tools/audio-load-test/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AudioLoadTestClient_h
+#define hifi_AudioLoadTestClient_h
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+
+#include <glm/glm.hpp>
+
+#include <AudioBuffer.h>
+#include <AudioGain.h>
+#include <AudioSourceNoise.h>
+#include <AudioSourceTone.h>
+#include <AudioStreamStats.h>
+#include <MixedAudioStream.h>
+#include <NLPacket.h>
+#include <Node.h>
+
+// the lines a client writes to stdout begin with this, the rest is its stats as JSON
+const char AUDIO_LOAD_TEST_STATS_PREFIX[] = "STATS ";
+
+/// One synthetic audio client, which connects to the domain like an interface does, sends a tone or pink noise as its
+/// microphone from a position that moves around, and plays out the mixes it gets back like an output device would.
+/// Its stats are written to stdout as one JSON line per interval, for the AudioLoadTest that spawned it.
+class AudioLoadTestClient : public QObject {
+    Q_OBJECT
+public:
+    AudioLoadTestClient(int index, const QString& domainHostname, quint16 domainPort, float radius, int statsInterval,
+                        QObject* parent = nullptr);
+
+private slots:
+    void sendFrames(); // sends the frames that are due since the last call, one per network frame of time
+    void sendStats(); // reports our stats and sends the downstream stats to the mixer, like an interface does
+
+    void handleMixedAudioPacket(QSharedPointer<NLPacket> packet);
+    void handleStreamStatsPacket(QSharedPointer<NLPacket> packet);
+    void nodeKilled(SharedNodePointer node);
+
+private:
+    void sendFrame(const Node& audioMixer);
+    glm::vec3 getPositionAtFrame(quint64 frame) const;
+
+    int _index;
+    float _radius;
+
+    bool _isNoise;
+    AudioSourceTone _toneSource;
+    AudioSourcePinkNoise _noiseSource;
+    AudioGain _sourceGain;
+    AudioBufferFloat32 _frameBuffer;
+
+    QElapsedTimer _frameClock;
+    quint64 _framesSent { 0 };
+    quint16 _outgoingSequenceNumber { 0 };
+
+    MixedAudioStream _receivedAudioStream;
+    AudioStreamStats _mixerStreamStats; // the mixer's stats of our microphone stream
+};
+
+#endif // hifi_AudioLoadTestClient_h
@@ -0,0 +1,16 @@
+//
+//  main.cpp
+//  tools/audio-load-test/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioLoadTest.h"
+
+int main(int argc, char* argv[]) {
+    AudioLoadTest app(argc, argv);
+    return app.exec();
+}
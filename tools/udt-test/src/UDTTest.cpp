@@ -11,17 +11,23 @@
 
 #include "UDTTest.h"
 
+#include <cstdio>
+
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
 
 #include <udt/Constants.h>
 #include <udt/Packet.h>
 #include <udt/PacketList.h>
 
 #include <LogHandler.h>
+#include <NumericalConstants.h>
 
 const QCommandLineOption PORT_OPTION { "p", "listening port for socket (defaults to random)", "port", 0 };
 const QCommandLineOption TARGET_OPTION {
-    "target", "target for sent packets (default is listen only)",
+    "target", "target for sent packets, can be repeated to fan out to several (default is listen only)",
     "IP:PORT or HOSTNAME:PORT"
 };
 const QCommandLineOption PACKET_SIZE {
@@ -56,6 +62,28 @@ const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
 
+const QCommandLineOption LOSS_OPTION {
+    "loss", "percentage of the received datagrams to drop, set it on both ends to shape both ways (default is 0)", "percent"
+};
+const QCommandLineOption LATENCY_OPTION {
+    "latency", "delay added to every received datagram (default is 0)", "milliseconds"
+};
+const QCommandLineOption JITTER_OPTION {
+    "jitter", "most delay randomly added on top of the latency, which reorders datagrams (default is 0)", "milliseconds"
+};
+const QCommandLineOption SHAPING_SEED {
+    "shaping-seed", "seed used for the simulated loss and jitter so a run can be repeated (default is 742272)", "integer"
+};
+const QCommandLineOption CONGESTION_CONTROL {
+    "congestion-control", "congestion control of the connections, default or bbr (default is default)", "name"
+};
+const QCommandLineOption DURATION {
+    "duration", "seconds to run before stopping (default is until killed)", "seconds"
+};
+const QCommandLineOption JSON_RESULTS {
+    "json", "file to write the throughput and latency of the run to as JSON when it stops, - for stdout", "path"
+};
+
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (P/s)", "Est. Max (P/s)", "RTT (ms)", "CW (P)", "Period (us)",
     "Recv ACK", "Procd ACK", "Recv LACK", "Recv NAK", "Recv TNAK",
@@ -81,10 +109,40 @@ UDTTest::UDTTest(int& argc, char** argv) :
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
     
-    if (_argumentParser.isSet(TARGET_OPTION)) {
-        // parse the IP and port combination for this target
-        QString hostnamePortString = _argumentParser.value(TARGET_OPTION);
+    // the congestion control has to be picked before the first connection is made
+    if (_argumentParser.isSet(CONGESTION_CONTROL)) {
+        _congestionControlName = _argumentParser.value(CONGESTION_CONTROL).toLower();
+    }
+    
+    if (_congestionControlName == "bbr") {
+        _socket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+            new udt::CongestionControlFactory<udt::BBRCC>()));
+    } else if (_congestionControlName != "default") {
+        qCritical() << "Unknown congestion control" << _congestionControlName << "- use default or bbr.";
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
+    
+    if (_argumentParser.isSet(LOSS_OPTION) || _argumentParser.isSet(LATENCY_OPTION) || _argumentParser.isSet(JITTER_OPTION)) {
+        static const double PERCENT = 100.0;
         
+        _networkConditions.lossRate = _argumentParser.value(LOSS_OPTION).toDouble() / PERCENT;
+        _networkConditions.latencyUsecs = _argumentParser.value(LATENCY_OPTION).toDouble() * USECS_PER_MSEC;
+        _networkConditions.jitterUsecs = _argumentParser.value(JITTER_OPTION).toDouble() * USECS_PER_MSEC;
+        
+        uint32_t shapingSeed = udt::NetworkShaper::DEFAULT_SEED;
+        if (_argumentParser.isSet(SHAPING_SEED)) {
+            shapingSeed = _argumentParser.value(SHAPING_SEED).toUInt();
+        }
+        
+        _socket.setNetworkConditions(_networkConditions, shapingSeed);
+        
+        qDebug() << "Received datagrams are shaped with" << _networkConditions.lossRate * PERCENT << "% loss,"
+            << _networkConditions.latencyUsecs / USECS_PER_MSEC << "ms latency and"
+            << _networkConditions.jitterUsecs / USECS_PER_MSEC << "ms jitter";
+    }
+    
+    for (const QString& hostnamePortString : _argumentParser.values(TARGET_OPTION)) {
+        // parse the IP and port combination for this target
         QHostAddress address { hostnamePortString.left(hostnamePortString.indexOf(':')) };
         quint16 port { (quint16) hostnamePortString.mid(hostnamePortString.indexOf(':') + 1).toUInt() };
         
@@ -94,8 +152,8 @@ UDTTest::UDTTest(int& argc, char** argv) :
             
             QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
         } else {
-            _target = HifiSockAddr(address, port);
-            qDebug() << "Packets will be sent to" << _target;
+            _targets.emplace_back(address, port);
+            qDebug() << "Packets will be sent to" << _targets.back();
         }
     }
     
@@ -145,6 +203,12 @@ UDTTest::UDTTest(int& argc, char** argv) :
 
     if (_argumentParser.isSet(ORDERED_PACKETS)) {
         _sendOrdered = true;
+        
+        if (_targets.size() > 1) {
+            // every receiver checks the messages against its own copy of the seeded generator
+            qCritical() << "Cannot send ordered packets to more than one target.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
     }
     
     if (_argumentParser.isSet(MESSAGE_SIZE)) {
@@ -171,7 +235,18 @@ UDTTest::UDTTest(int& argc, char** argv) :
     // seed the generator with a value that the receiver will also use when verifying the ordered message
     _generator.seed(messageSeed);
     
-    if (!_target.isNull()) {
+    if (_argumentParser.isSet(JSON_RESULTS)) {
+        _resultsPath = _argumentParser.value(JSON_RESULTS);
+    }
+    
+    _runTimer.start();
+    
+    if (_argumentParser.isSet(DURATION)) {
+        static const int MSECS_PER_SECOND = 1000;
+        QTimer::singleShot((int)(_argumentParser.value(DURATION).toDouble() * MSECS_PER_SECOND), this, &UDTTest::finish);
+    }
+    
+    if (!_targets.empty()) {
         sendInitialPackets();
     } else {
         // this is a receiver - in case there are ordered packets (messages) being sent to us make sure that we handle them
@@ -201,7 +276,8 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, LOSS_OPTION, LATENCY_OPTION, JITTER_OPTION, SHAPING_SEED,
+        CONGESTION_CONTROL, DURATION, JSON_RESULTS
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -221,17 +297,19 @@ void UDTTest::sendInitialPackets() {
     
     int numPackets = std::max(NUM_INITIAL_PACKETS, _maxSendPackets);
     
-    for (int i = 0; i < numPackets; ++i) {
-        sendPacket();
-    }
-    
-    if (numPackets == NUM_INITIAL_PACKETS) {
-        // we've put 500 initial packets in the queue, everytime we hear one has gone out we should add a new one
-        _socket.connectToSendSignal(_target, this, SLOT(refillPacket()));
+    for (const auto& target : _targets) {
+        for (int i = 0; i < numPackets; ++i) {
+            sendPacket(target);
+        }
+        
+        if (numPackets == NUM_INITIAL_PACKETS) {
+            // we've put 500 initial packets in the queue, everytime we hear one has gone out we should add a new one
+            _socket.connectToSendSignal(target, this, [this, target] { sendPacket(target); });
+        }
     }
 }
 
-void UDTTest::sendPacket() {
+void UDTTest::sendPacket(const HifiSockAddr& target) {
     
     if (_maxSendPackets != -1 && _totalQueuedPackets > _maxSendPackets) {
         // don't send more packets, we've hit max
@@ -287,7 +365,7 @@ void UDTTest::sendPacket() {
             _totalQueuedBytes += packetList->getDataSize();
             _totalQueuedPackets += packetList->getNumPackets();
             
-            _socket.writePacketList(std::move(packetList), _target);
+            _socket.writePacketList(std::move(packetList), target);
         }
         
     } else {
@@ -298,9 +376,9 @@ void UDTTest::sendPacket() {
         
         // queue or send this packet by calling write packet on the socket for our target
         if (_sendReliable) {
-            _socket.writePacket(std::move(newPacket), _target);
+            _socket.writePacket(std::move(newPacket), target);
         } else {
-            _socket.writePacket(*newPacket, _target);
+            _socket.writePacket(*newPacket, target);
         }
         
         ++_totalQueuedPackets;
@@ -334,18 +412,41 @@ void UDTTest::handlePacketList(std::unique_ptr<udt::PacketList> packetList) {
     }
 }
 
+udt::ConnectionStats::Stats UDTTest::sampleAndAccumulate(const HifiSockAddr& sockAddr) {
+    udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(sockAddr);
+    
+    auto& totals = _totals[sockAddr];
+    totals.sentPackets += stats.sentPackets;
+    totals.receivedPackets += stats.receivedPackets;
+    totals.sentBytes += stats.sentBytes;
+    totals.receivedBytes += stats.receivedBytes;
+    totals.retransmissions += stats.events[udt::ConnectionStats::Stats::Retransmission];
+    totals.duplicates += stats.events[udt::ConnectionStats::Stats::Duplicate];
+    totals.sentNAKs += stats.events[udt::ConnectionStats::Stats::SentNAK];
+    totals.receivedNAKs += stats.events[udt::ConnectionStats::Stats::ReceivedNAK];
+    totals.sendQueueLatency.merge(stats.sendQueueLatency);
+    totals.rttLatency.merge(stats.rttLatency);
+    totals.receiveLatency.merge(stats.receiveLatency);
+    
+    return stats;
+}
+
 void UDTTest::sampleStats() {
     static bool first = true;
     static const double USECS_PER_MSEC = 1000.0;
     
-    if (!_target.isNull()) {
+    if (!_targets.empty()) {
         if (first) {
             // output the headers for stats for our table
             qDebug() << qPrintable(CLIENT_STATS_TABLE_HEADERS.join(" | "));
             first = false;
         }
         
-        udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(_target);
+        // the table shows the first target, the others are only in the results
+        for (size_t i = 1; i < _targets.size(); ++i) {
+            sampleAndAccumulate(_targets[i]);
+        }
+        udt::ConnectionStats::Stats stats = sampleAndAccumulate(_targets.front());
         
         int headerIndex = -1;
         
@@ -376,8 +477,11 @@ void UDTTest::sampleStats() {
         }
         
         auto sockets = _socket.getConnectionSockAddrs();
+        for (size_t i = 1; i < sockets.size(); ++i) {
+            sampleAndAccumulate(sockets[i]);
+        }
         if (sockets.size() > 0) {
-            udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(sockets.front());
+            udt::ConnectionStats::Stats stats = sampleAndAccumulate(sockets.front());
             
             int headerIndex = -1;
             
@@ -406,3 +510,91 @@ void UDTTest::sampleStats() {
         }
     }
 }
+
+static QString sockAddrToString(const HifiSockAddr& sockAddr) {
+    return sockAddr.getAddress().toString() + ":" + QString::number(sockAddr.getPort());
+}
+
+QJsonObject UDTTest::resultsToJson() const {
+    static const double MEGABITS_PER_BYTE = 8.0 / 1000000.0;
+    static const double MSECS_PER_SECOND = 1000.0;
+    static const double MEDIAN_PERCENTILE = 50.0;
+    static const double TAIL_PERCENTILE = 99.0;
+    
+    double seconds = _runTimer.elapsed() / MSECS_PER_SECOND;
+    
+    QJsonObject configuration;
+    configuration["minPacketSize"] = _minPacketSize;
+    configuration["maxPacketSize"] = _maxPacketSize;
+    configuration["reliable"] = _sendReliable;
+    configuration["ordered"] = _sendOrdered;
+    configuration["messageSize"] = _messageSize;
+    configuration["congestionControl"] = _congestionControlName;
+    configuration["lossRate"] = _networkConditions.lossRate;
+    configuration["latencyUsecs"] = (double)_networkConditions.latencyUsecs;
+    configuration["jitterUsecs"] = (double)_networkConditions.jitterUsecs;
+    QJsonArray targets;
+    for (const auto& target : _targets) {
+        targets.append(sockAddrToString(target));
+    }
+    configuration["targets"] = targets;
+    
+    auto latencyToJson = [](const udt::LatencyHistogram& histogram) {
+        QJsonObject latency;
+        latency["count"] = histogram.getCount();
+        latency["p50Usecs"] = (double)histogram.getPercentile(MEDIAN_PERCENTILE);
+        latency["p99Usecs"] = (double)histogram.getPercentile(TAIL_PERCENTILE);
+        latency["maxUsecs"] = (double)histogram.getMax();
+        return latency;
+    };
+    
+    QJsonArray connections;
+    for (const auto& totalsPair : _totals) {
+        const ConnectionTotals& totals = totalsPair.second;
+        
+        QJsonObject connection;
+        connection["address"] = sockAddrToString(totalsPair.first);
+        connection["sentPackets"] = (double)totals.sentPackets;
+        connection["receivedPackets"] = (double)totals.receivedPackets;
+        connection["sentBytes"] = (double)totals.sentBytes;
+        connection["receivedBytes"] = (double)totals.receivedBytes;
+        connection["sendMbps"] = seconds > 0.0 ? totals.sentBytes * MEGABITS_PER_BYTE / seconds : 0.0;
+        connection["receiveMbps"] = seconds > 0.0 ? totals.receivedBytes * MEGABITS_PER_BYTE / seconds : 0.0;
+        connection["retransmissions"] = (double)totals.retransmissions;
+        connection["duplicates"] = (double)totals.duplicates;
+        connection["sentNAKs"] = (double)totals.sentNAKs;
+        connection["receivedNAKs"] = (double)totals.receivedNAKs;
+        connection["sendQueueLatency"] = latencyToJson(totals.sendQueueLatency);
+        connection["rttLatency"] = latencyToJson(totals.rttLatency);
+        connection["receiveLatency"] = latencyToJson(totals.receiveLatency);
+        connections.append(connection);
+    }
+    
+    QJsonObject results;
+    results["configuration"] = configuration;
+    results["seconds"] = seconds;
+    results["shapingDroppedDatagrams"] = _socket.getNumShapingDroppedDatagrams();
+    results["connections"] = connections;
+    return results;
+}
+
+void UDTTest::finish() {
+    // the last interval, which the totals would otherwise miss
+    sampleStats();
+    
+    if (!_resultsPath.isEmpty()) {
+        QByteArray json = QJsonDocument(resultsToJson()).toJson();
+        
+        if (_resultsPath == "-") {
+            fprintf(stdout, "%s", json.constData());
+            fflush(stdout);
+        } else {
+            QFile resultsFile { _resultsPath };
+            if (!resultsFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || resultsFile.write(json) != json.size()) {
+                qCritical() << "Could not write the results to" << _resultsPath;
+            }
+        }
+    }
+    
+    quit();
+}
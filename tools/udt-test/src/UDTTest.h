@@ -16,11 +16,16 @@
 
 
 #include <random>
+#include <unordered_map>
+#include <vector>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
 
 #include <udt/Constants.h>
+#include <udt/LatencyHistogram.h>
 #include <udt/Socket.h>
 
 class UDTTest : public QCoreApplication {
@@ -29,20 +34,38 @@ public:
     UDTTest(int& argc, char** argv);
 
 public slots:
-    void refillPacket() { sendPacket(); } // adds a new packet to the queue when we are told one is sent
     void sampleStats();
+    void finish(); // writes the results, if asked to, and quits
     
 private:
+    // what a connection did over the whole run, summed from the stats sampled at every interval
+    struct ConnectionTotals {
+        quint64 sentPackets { 0 };
+        quint64 receivedPackets { 0 };
+        quint64 sentBytes { 0 };
+        quint64 receivedBytes { 0 };
+        quint64 retransmissions { 0 };
+        quint64 duplicates { 0 };
+        quint64 sentNAKs { 0 };
+        quint64 receivedNAKs { 0 };
+        udt::LatencyHistogram sendQueueLatency;
+        udt::LatencyHistogram rttLatency;
+        udt::LatencyHistogram receiveLatency;
+    };
+    
     void parseArguments();
     void handlePacketList(std::unique_ptr<udt::PacketList> packetList);
     
     void sendInitialPackets(); // fills the queue with packets to start
-    void sendPacket(); // constructs and sends a packet according to the test parameters
+    void sendPacket(const HifiSockAddr& target); // constructs and sends a packet according to the test parameters
+    
+    udt::ConnectionStats::Stats sampleAndAccumulate(const HifiSockAddr& sockAddr);
+    QJsonObject resultsToJson() const;
     
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
     
-    HifiSockAddr _target; // the target for sent packets
+    std::vector<HifiSockAddr> _targets; // the targets for sent packets, the packets fan out to all of them
     
     int _minPacketSize { udt::MAX_PACKET_SIZE };
     int _maxPacketSize { udt::MAX_PACKET_SIZE };
@@ -62,6 +85,13 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+    
+    QString _congestionControlName { "default" };
+    udt::NetworkConditions _networkConditions;
+    
+    QString _resultsPath; // where the JSON results go when the run ends, - for the standard output
+    QElapsedTimer _runTimer;
+    std::unordered_map<HifiSockAddr, ConnectionTotals> _totals;
 };
 
 #endif // hifi_UDTTest_h